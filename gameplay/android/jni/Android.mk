@@ -26,6 +26,7 @@ LOCAL_SRC_FILES := \
     AnimationController.cpp \
     AnimationTarget.cpp \
     AnimationValue.cpp \
+    AssetLoader.cpp \
     AudioBuffer.cpp \
     AudioController.cpp \
     AudioListener.cpp \
@@ -36,6 +37,7 @@ LOCAL_SRC_FILES := \
     Button.cpp \
     Camera.cpp \
     CheckBox.cpp \
+    CommandBuffer.cpp \
     Container.cpp \
     Control.cpp \
     ControlFactory.cpp \
@@ -43,23 +45,33 @@ LOCAL_SRC_FILES := \
     DebugNew.cpp \
     DepthStencilTarget.cpp \
     Drawable.cpp \
+    DynamicResolution.cpp \
     Effect.cpp \
     FileSystem.cpp \
     FlowLayout.cpp \
     Font.cpp \
     Form.cpp \
+    FrameAllocator.cpp \
     FrameBuffer.cpp \
     Frustum.cpp \
     Game.cpp \
     Gamepad.cpp \
+    GlyphCache.cpp \
+    GLHeadless.cpp \
     HeightField.cpp \
     Image.cpp \
     ImageControl.cpp \
+    Impostor.cpp \
+    InstanceCuller.cpp \
+    IOQueue.cpp \
+    JobController.cpp \
     Joint.cpp \
     JoystickControl.cpp \
     Label.cpp \
     Layout.cpp \
     Light.cpp \
+    LightClusters.cpp \
+    ListView.cpp \
     Logger.cpp \
     Material.cpp \
     MaterialParameter.cpp \
@@ -67,10 +79,20 @@ LOCAL_SRC_FILES := \
     Matrix.cpp \
     Mesh.cpp \
     MeshBatch.cpp \
+    MeshBuffer.cpp \
+    MeshBVH.cpp \
     MeshPart.cpp \
     MeshSkin.cpp \
+    MemoryTracker.cpp \
+    InputQueue.cpp \
+    InputRecorder.cpp \
     Model.cpp \
+    NavigationMesh.cpp \
     Node.cpp \
+    NodeIndex.cpp \
+    ObjectPool.cpp \
+    OcclusionBuffer.cpp \
+    OcclusionCuller.cpp \
     ParticleEmitter.cpp \
     Pass.cpp \
     PhysicsCharacter.cpp \
@@ -88,41 +110,63 @@ LOCAL_SRC_FILES := \
     PhysicsVehicle.cpp \
     PhysicsVehicleWheel.cpp \
     Plane.cpp \
+    PlanarReflection.cpp \
     Platform.cpp \
     PlatformAndroid.cpp \
+    PlatformHeadless.cpp \
+    PostProcess.cpp \
+    Prefab.cpp \
+    Profiler.cpp \
     Properties.cpp \
     Quaternion.cpp \
     RadioButton.cpp \
     Ray.cpp \
     Rectangle.cpp \
     Ref.cpp \
+    RenderQueue.cpp \
     RenderState.cpp \
+    RenderStats.cpp \
     RenderTarget.cpp \
+    ResourceManager.cpp \
     Scene.cpp \
     SceneLoader.cpp \
+    SceneSnapshot.cpp \
     ScreenDisplayer.cpp \
     Script.cpp \
+    ScriptContext.cpp \
+    ScriptProfiler.cpp \
     ScriptController.cpp \
     ScriptTarget.cpp \
+    ShadowMaps.cpp \
+    SharedSkeleton.cpp \
     Slider.cpp \
+    SpatialIndex.cpp \
     Sprite.cpp \
     SpriteBatch.cpp \
+    StringPool.cpp \
     Technique.cpp \
     Terrain.cpp \
     TerrainPatch.cpp \
     Text.cpp \
     TextBox.cpp \
+    TextLayout.cpp \
     Texture.cpp \
+    TextureAtlas.cpp \
+    TextureStreamer.cpp \
     Theme.cpp \
     ThemeStyle.cpp \
+    TimerWheel.cpp \
+    TiledTerrain.cpp \
     TileSet.cpp \
     Transform.cpp \
+    TransformHierarchy.cpp \
     Vector2.cpp \
     Vector3.cpp \
     Vector4.cpp \
     VertexAttributeBinding.cpp \
     VertexFormat.cpp \
     VerticalLayout.cpp \
+    World.cpp \
     lua/lua_AbsoluteLayout.cpp \
     lua/lua_AIAgent.cpp \
     lua/lua_AIAgentListener.cpp \
@@ -138,6 +182,8 @@ LOCAL_SRC_FILES := \
     lua/lua_AnimationController.cpp \
     lua/lua_AnimationTarget.cpp \
     lua/lua_AnimationValue.cpp \
+    lua/lua_AssetLoader.cpp \
+    lua/lua_AssetLoaderRequest.cpp \
     lua/lua_AudioBuffer.cpp \
     lua/lua_AudioController.cpp \
     lua/lua_AudioListener.cpp \
@@ -175,6 +221,7 @@ LOCAL_SRC_FILES := \
     lua/lua_Label.cpp \
     lua/lua_Layout.cpp \
     lua/lua_Light.cpp \
+    lua/lua_ListView.cpp \
     lua/lua_Logger.cpp \
     lua/lua_Material.cpp \
     lua/lua_MaterialParameter.cpp \
@@ -186,6 +233,7 @@ LOCAL_SRC_FILES := \
     lua/lua_MeshSkin.cpp \
     lua/lua_Model.cpp \
     lua/lua_Mouse.cpp \
+    lua/lua_NavigationMesh.cpp \
     lua/lua_Node.cpp \
     lua/lua_NodeCloneContext.cpp \
     lua/lua_ParticleEmitter.cpp \
@@ -221,10 +269,13 @@ LOCAL_SRC_FILES := \
     lua/lua_Ref.cpp \
     lua/lua_RenderState.cpp \
     lua/lua_RenderStateStateBlock.cpp \
+    lua/lua_RenderStats.cpp \
     lua/lua_RenderTarget.cpp \
+    lua/lua_ResourceManager.cpp \
     lua/lua_Scene.cpp \
     lua/lua_ScreenDisplayer.cpp \
     lua/lua_Script.cpp \
+    lua/lua_ScriptContext.cpp \
     lua/lua_ScriptController.cpp \
     lua/lua_ScriptTarget.cpp \
     lua/lua_ScriptTargetEvent.cpp \
@@ -238,8 +289,11 @@ LOCAL_SRC_FILES := \
     lua/lua_TerrainPatch.cpp \
     lua/lua_Text.cpp \
     lua/lua_TextBox.cpp \
+    lua/lua_TextLayout.cpp \
     lua/lua_Texture.cpp \
+    lua/lua_TextureAtlas.cpp \
     lua/lua_TextureSampler.cpp \
+    lua/lua_TextureStreamer.cpp \
     lua/lua_Theme.cpp \
     lua/lua_ThemeSideRegions.cpp \
     lua/lua_ThemeStyle.cpp \
@@ -22,6 +22,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/AnimationController.cpp \
     src/AnimationTarget.cpp \
     src/AnimationValue.cpp \
+    src/AssetLoader.cpp \
     src/AudioBuffer.cpp \
     src/AudioController.cpp \
     src/AudioListener.cpp \
@@ -34,46 +35,69 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/Button.cpp \
     src/Camera.cpp \
     src/CheckBox.cpp \
+    src/CommandBuffer.cpp \
     src/Container.cpp \
     src/Control.cpp \
     src/ControlFactory.cpp \
     src/Curve.cpp \
     src/DepthStencilTarget.cpp \
     src/Drawable.cpp \
+    src/DynamicResolution.cpp \
     src/Effect.cpp \
     src/FileSystem.cpp \
     src/FlowLayout.cpp \
     src/Font.cpp \
     src/Form.cpp \
+    src/FrameAllocator.cpp \
+    src/FrameAllocator.inl \
     src/FrameBuffer.cpp \
     src/Frustum.cpp \
     src/Game.cpp \
     src/Game.inl \
     src/Gamepad.cpp \
+    src/GlyphCache.cpp \
+    src/GLHeadless.cpp \
     src/HeightField.cpp \
     src/Image.cpp \
     src/Image.inl \
     src/ImageControl.cpp \
+    src/Impostor.cpp \
+    src/InstanceCuller.cpp \
+    src/IOQueue.cpp \
+    src/JobController.cpp \
     src/Joint.cpp \
     src/JoystickControl.cpp \
     src/Label.cpp \
     src/Layout.cpp \
     src/Light.cpp \
+    src/LightClusters.cpp \
+    src/ListView.cpp \
     src/Logger.cpp \
     src/Material.cpp \
     src/MaterialParameter.cpp \
     src/MathUtil.cpp \
     src/MathUtil.inl \
     src/MathUtilNeon.inl \
+    src/MathUtilSSE.inl \
     src/Matrix.cpp \
     src/Matrix.inl \
     src/Mesh.cpp \
     src/MeshBatch.cpp \
+    src/MeshBuffer.cpp \
+    src/MeshBVH.cpp \
     src/MeshBatch.inl \
     src/MeshPart.cpp \
     src/MeshSkin.cpp \
+    src/MemoryTracker.cpp \
+    src/InputQueue.cpp \
+    src/InputRecorder.cpp \
     src/Model.cpp \
+    src/NavigationMesh.cpp \
     src/Node.cpp \
+    src/NodeIndex.cpp \
+    src/ObjectPool.cpp \
+    src/OcclusionBuffer.cpp \
+    src/OcclusionCuller.cpp \
     src/ParticleEmitter.cpp \
     src/Pass.cpp \
     src/PhysicsCharacter.cpp \
@@ -96,8 +120,12 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/PhysicsVehicle.cpp \
     src/PhysicsVehicleWheel.cpp \
     src/Plane.cpp \
+    src/PlanarReflection.cpp \
     src/Plane.inl \
     src/Platform.cpp \
+    src/PostProcess.cpp \
+    src/Prefab.cpp \
+    src/Profiler.cpp \
     src/Properties.cpp \
     src/Quaternion.cpp \
     src/Quaternion.inl \
@@ -106,28 +134,44 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/Ray.inl \
     src/Rectangle.cpp \
     src/Ref.cpp \
+    src/RenderQueue.cpp \
     src/RenderState.cpp \
+    src/RenderStats.cpp \
     src/RenderTarget.cpp \
+    src/ResourceManager.cpp \
     src/Scene.cpp \
     src/SceneLoader.cpp \
+    src/SceneSnapshot.cpp \
     src/ScreenDisplayer.cpp \
     src/Script.cpp \
+    src/ScriptContext.cpp \
+    src/ScriptProfiler.cpp \
     src/ScriptController.cpp \
     src/ScriptController.inl \
     src/ScriptTarget.cpp \
+    src/ShadowMaps.cpp \
+    src/SharedSkeleton.cpp \
     src/Slider.cpp \
+    src/SpatialIndex.cpp \
     src/Sprite.cpp \
     src/SpriteBatch.cpp \
+    src/StringPool.cpp \
     src/Technique.cpp \
     src/Terrain.cpp \
     src/TerrainPatch.cpp \
     src/Text.cpp \
     src/TextBox.cpp \
+    src/TextLayout.cpp \
     src/Texture.cpp \
+    src/TextureAtlas.cpp \
+    src/TextureStreamer.cpp \
     src/Theme.cpp \
     src/ThemeStyle.cpp \
+    src/TimerWheel.cpp \
+    src/TiledTerrain.cpp \
     src/TileSet.cpp \
     src/Transform.cpp \
+    src/TransformHierarchy.cpp \
     src/Vector2.cpp \
     src/Vector2.inl \
     src/Vector3.cpp \
@@ -137,6 +181,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/VertexAttributeBinding.cpp \
     src/VertexFormat.cpp \
     src/VerticalLayout.cpp \
+    src/World.cpp \
     src/lua/lua_all_bindings.cpp \
     src/lua/lua_AbsoluteLayout.cpp \
     src/lua/lua_AIAgent.cpp \
@@ -152,6 +197,8 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/lua/lua_AnimationController.cpp \
     src/lua/lua_AnimationTarget.cpp \
     src/lua/lua_AnimationValue.cpp \
+    src/lua/lua_AssetLoader.cpp \
+    src/lua/lua_AssetLoaderRequest.cpp \
     src/lua/lua_AudioBuffer.cpp \
     src/lua/lua_AudioController.cpp \
     src/lua/lua_AudioListener.cpp \
@@ -189,6 +236,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/lua/lua_Label.cpp \
     src/lua/lua_Layout.cpp \
     src/lua/lua_Light.cpp \
+    src/lua/lua_ListView.cpp \
     src/lua/lua_Logger.cpp \
     src/lua/lua_Material.cpp \
     src/lua/lua_MaterialParameter.cpp \
@@ -200,6 +248,7 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/lua/lua_MeshSkin.cpp \
     src/lua/lua_Model.cpp \
     src/lua/lua_Mouse.cpp \
+    src/lua/lua_NavigationMesh.cpp \
     src/lua/lua_Node.cpp \
     src/lua/lua_NodeCloneContext.cpp \
     src/lua/lua_ParticleEmitter.cpp \
@@ -235,10 +284,13 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/lua/lua_Ref.cpp \
     src/lua/lua_RenderState.cpp \
     src/lua/lua_RenderStateStateBlock.cpp \
+    src/lua/lua_RenderStats.cpp \
     src/lua/lua_RenderTarget.cpp \
+    src/lua/lua_ResourceManager.cpp \
     src/lua/lua_Scene.cpp \
     src/lua/lua_ScreenDisplayer.cpp \
     src/lua/lua_Script.cpp \
+    src/lua/lua_ScriptContext.cpp \
     src/lua/lua_ScriptController.cpp \
     src/lua/lua_ScriptTarget.cpp \
     src/lua/lua_ScriptTargetEvent.cpp \
@@ -252,8 +304,11 @@ SOURCES += src/AbsoluteLayout.cpp \
     src/lua/lua_TerrainPatch.cpp \
     src/lua/lua_Text.cpp \
     src/lua/lua_TextBox.cpp \
+    src/lua/lua_TextLayout.cpp \
     src/lua/lua_Texture.cpp \
+    src/lua/lua_TextureAtlas.cpp \
     src/lua/lua_TextureSampler.cpp \
+    src/lua/lua_TextureStreamer.cpp \
     src/lua/lua_Theme.cpp \
     src/lua/lua_ThemeSideRegions.cpp \
     src/lua/lua_ThemeStyle.cpp \
@@ -283,6 +338,7 @@ HEADERS += src/AbsoluteLayout.h \
     src/AnimationController.h \
     src/AnimationTarget.h \
     src/AnimationValue.h \
+    src/AssetLoader.h \
     src/AudioBuffer.h \
     src/AudioController.h \
     src/AudioListener.h \
@@ -294,32 +350,43 @@ HEADERS += src/AbsoluteLayout.h \
     src/Button.h \
     src/Camera.h \
     src/CheckBox.h \
+    src/CommandBuffer.h \
     src/Container.h \
     src/Control.h \
     src/ControlFactory.h \
     src/Curve.h \
     src/DepthStencilTarget.h \
     src/Drawable.h \
+    src/DynamicResolution.h \
     src/Effect.h \
     src/FileSystem.h \
     src/FlowLayout.h \
     src/Font.h \
     src/Form.h \
+    src/FrameAllocator.h \
     src/FrameBuffer.h \
     src/Frustum.h \
     src/Game.h \
     src/Gamepad.h \
     src/gameplay.h \
     src/Gesture.h \
+    src/GlyphCache.h \
+    src/GLHeadless.h \
     src/HeightField.h \
     src/Image.h \
     src/ImageControl.h \
+    src/Impostor.h \
+    src/InstanceCuller.h \
+    src/IOQueue.h \
+    src/JobController.h \
     src/Joint.h \
     src/JoystickControl.h \
     src/Keyboard.h \
     src/Label.h \
     src/Layout.h \
     src/Light.h \
+    src/LightClusters.h \
+    src/ListView.h \
     src/Logger.h \
     src/Material.h \
     src/MaterialParameter.h \
@@ -327,11 +394,21 @@ HEADERS += src/AbsoluteLayout.h \
     src/Matrix.h \
     src/Mesh.h \
     src/MeshBatch.h \
+    src/MeshBuffer.h \
+    src/MeshBVH.h \
     src/MeshPart.h \
     src/MeshSkin.h \
+    src/MemoryTracker.h \
+    src/InputQueue.h \
+    src/InputRecorder.h \
     src/Model.h \
     src/Mouse.h \
+    src/NavigationMesh.h \
     src/Node.h \
+    src/NodeIndex.h \
+    src/ObjectPool.h \
+    src/OcclusionBuffer.h \
+    src/OcclusionCuller.h \
     src/ParticleEmitter.h \
     src/Pass.h \
     src/PhysicsCharacter.h \
@@ -349,43 +426,64 @@ HEADERS += src/AbsoluteLayout.h \
     src/PhysicsVehicle.h \
     src/PhysicsVehicleWheel.h \
     src/Plane.h \
+    src/PlanarReflection.h \
     src/Platform.h \
+    src/PostProcess.h \
+    src/Prefab.h \
+    src/Profiler.h \
     src/Properties.h \
     src/Quaternion.h \
     src/RadioButton.h \
     src/Ray.h \
     src/Rectangle.h \
     src/Ref.h \
+    src/RenderQueue.h \
     src/RenderState.h \
+    src/RenderStats.h \
     src/RenderTarget.h \
+    src/ResourceManager.h \
     src/Scene.h \
     src/SceneLoader.h \
+    src/SceneSnapshot.h \
     src/ScreenDisplayer.h \
     src/Script.h \
+    src/ScriptContext.h \
+    src/ScriptProfiler.h \
     src/ScriptController.h \
     src/ScriptTarget.h \
+    src/ShadowMaps.h \
+    src/SharedSkeleton.h \
     src/Slider.h \
+    src/SpatialIndex.h \
     src/Sprite.h \
     src/SpriteBatch.h \
+    src/StringPool.h \
     src/Stream.h \
     src/Technique.h \
     src/Terrain.h \
     src/TerrainPatch.h \
     src/Text.h \
     src/TextBox.h \
+    src/TextLayout.h \
     src/Texture.h \
+    src/TextureAtlas.h \
+    src/TextureStreamer.h \
     src/Theme.h \
     src/ThemeStyle.h \
+    src/TimerWheel.h \
+    src/TiledTerrain.h \
     src/TileSet.h \
     src/TimeListener.h \
     src/Touch.h \
     src/Transform.h \
+    src/TransformHierarchy.h \
     src/Vector2.h \
     src/Vector3.h \
     src/Vector4.h \
     src/VertexAttributeBinding.h \
     src/VertexFormat.h \
     src/VerticalLayout.h \
+    src/World.h \
     src/lua/lua_AbsoluteLayout.h \
     src/lua/lua_AIAgent.h \
     src/lua/lua_AIAgentListener.h \
@@ -401,6 +499,8 @@ HEADERS += src/AbsoluteLayout.h \
     src/lua/lua_AnimationController.h \
     src/lua/lua_AnimationTarget.h \
     src/lua/lua_AnimationValue.h \
+    src/lua/lua_AssetLoader.h \
+    src/lua/lua_AssetLoaderRequest.h \
     src/lua/lua_AudioBuffer.h \
     src/lua/lua_AudioController.h \
     src/lua/lua_AudioListener.h \
@@ -439,6 +539,7 @@ HEADERS += src/AbsoluteLayout.h \
     src/lua/lua_Label.h \
     src/lua/lua_Layout.h \
     src/lua/lua_Light.h \
+    src/lua/lua_ListView.h \
     src/lua/lua_Logger.h \
     src/lua/lua_Material.h \
     src/lua/lua_MaterialParameter.h \
@@ -450,6 +551,7 @@ HEADERS += src/AbsoluteLayout.h \
     src/lua/lua_MeshSkin.h \
     src/lua/lua_Model.h \
     src/lua/lua_Mouse.h \
+    src/lua/lua_NavigationMesh.h \
     src/lua/lua_Node.h \
     src/lua/lua_NodeCloneContext.h \
     src/lua/lua_ParticleEmitter.h \
@@ -485,10 +587,13 @@ HEADERS += src/AbsoluteLayout.h \
     src/lua/lua_Rectangle.h \
     src/lua/lua_Ref.h \
     src/lua/lua_RenderState.h \
+    src/lua/lua_RenderStats.h \
     src/lua/lua_RenderTarget.h \
+    src/lua/lua_ResourceManager.h \
     src/lua/lua_Scene.h \
     src/lua/lua_ScreenDisplayer.h \
     src/lua/lua_Script.h \
+    src/lua/lua_ScriptContext.h \
     src/lua/lua_ScriptController.h \
     src/lua/lua_ScriptTarget.h \
     src/lua/lua_ScriptTargetEvent.h \
@@ -502,8 +607,11 @@ HEADERS += src/AbsoluteLayout.h \
     src/lua/lua_TerrainPatch.h \
     src/lua/lua_Text.h \
     src/lua/lua_TextBox.h \
+    src/lua/lua_TextLayout.h \
     src/lua/lua_Texture.h \
+    src/lua/lua_TextureAtlas.h \
     src/lua/lua_TextureSampler.h \
+    src/lua/lua_TextureStreamer.h \
     src/lua/lua_Theme.h \
     src/lua/lua_ThemeSideRegions.h \
     src/lua/lua_ThemeStyle.h \
@@ -529,6 +637,8 @@ DEFINES += GP_USE_GAMEPAD
 
 linux: SOURCES += src/PlatformLinux.cpp
 linux: SOURCES += src/gameplay-main-linux.cpp
+linux: SOURCES += src/PlatformHeadless.cpp
+linux: SOURCES += src/gameplay-main-headless.cpp
 linux: QMAKE_CXXFLAGS += -lstdc++ -pthread -w
 linux: DEFINES += __linux__
 linux: INCLUDEPATH += /usr/include/gtk-2.0
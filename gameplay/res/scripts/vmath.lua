@@ -0,0 +1,749 @@
+-- Value types for the math classes of gameplay, for scripts run on LuaJIT.
+--
+-- The bindings of Vector2, Vector3, Vector4, Quaternion and Matrix wrap each object in a
+-- userdata and call into C++ for every operation. The types of this module are FFI structs with
+-- the memory layout of those classes, whose operations are compiled with the rest of the
+-- script, and which the compiler keeps out of the heap when they do not escape a loop.
+--
+-- The module needs the FFI of LuaJIT, which the engine runs scripts on when built with the
+-- GP_USE_LUAJIT option. Copy it into the res/scripts folder of the game, like the shaders, and
+-- load it with:
+--
+--     local vmath = dofile("res/scripts/vmath.lua")
+--
+-- The constructors take the components of the value, or nothing for zero (and for the
+-- identity quaternion and matrix):
+--
+--     local velocity = vmath.Vector3(0, 1, 0)
+--     local offset = velocity * elapsedTime + vmath.Vector3(1, 0, 0)
+--
+-- Like the methods of the C++ classes, methods such as add, normalize and multiply change the
+-- value they are called on and allocate nothing, while the operators return new values.
+--
+-- vmath.ref returns a pointer to the C++ object of a bound math object, which reads and changes
+-- the object in place. Objects owned by the engine, such as the translation returned by
+-- Node:getTranslation, must only be changed through their setters, so that the engine notices:
+--
+--     local translation = Vector3.new()
+--     local t = vmath.ref(translation)
+--
+--     function update(elapsedTime)
+--         t:set(vmath.ref(node:getTranslation()))
+--         t:add(velocity * elapsedTime)
+--         node:setTranslation(translation)
+--     end
+
+if package.loaded.vmath then
+    return package.loaded.vmath
+end
+
+local ffi = require("ffi")
+
+ffi.cdef[[
+typedef struct { float x, y; } gameplay_Vector2;
+typedef struct { float x, y, z; } gameplay_Vector3;
+typedef struct { float x, y, z, w; } gameplay_Vector4;
+typedef struct { float x, y, z, w; } gameplay_Quaternion;
+typedef struct { float m[16]; } gameplay_Matrix;
+typedef struct { void* instance; bool owns; } gameplay_LuaObject;
+]]
+
+local sqrt = math.sqrt
+local sin = math.sin
+local cos = math.cos
+local acos = math.acos
+local abs = math.abs
+local min = math.min
+local max = math.max
+
+-- The tolerance of the comparisons of the C++ classes (MATH_TOLERANCE).
+local TOLERANCE = 2e-37
+-- The tolerance under which rotations are treated as zero (MATH_EPSILON).
+local EPSILON = 0.000001
+
+local vmath = {}
+
+local Vector2, Vector3, Vector4, Quaternion, Matrix
+
+--------------------------------------------------------------------------------
+-- Vector2
+--------------------------------------------------------------------------------
+
+local Vector2Methods = {}
+
+function Vector2Methods:set(x, y)
+    if type(x) == "number" then
+        self.x, self.y = x, y
+    else
+        self.x, self.y = x.x, x.y
+    end
+    return self
+end
+
+function Vector2Methods:add(v)
+    self.x, self.y = self.x + v.x, self.y + v.y
+    return self
+end
+
+function Vector2Methods:subtract(v)
+    self.x, self.y = self.x - v.x, self.y - v.y
+    return self
+end
+
+function Vector2Methods:scale(s)
+    self.x, self.y = self.x * s, self.y * s
+    return self
+end
+
+function Vector2Methods:negate()
+    self.x, self.y = -self.x, -self.y
+    return self
+end
+
+function Vector2Methods:dot(v)
+    return self.x * v.x + self.y * v.y
+end
+
+function Vector2Methods:lengthSquared()
+    return self.x * self.x + self.y * self.y
+end
+
+function Vector2Methods:length()
+    return sqrt(self.x * self.x + self.y * self.y)
+end
+
+function Vector2Methods:distanceSquared(v)
+    local dx, dy = v.x - self.x, v.y - self.y
+    return dx * dx + dy * dy
+end
+
+function Vector2Methods:distance(v)
+    return sqrt(self:distanceSquared(v))
+end
+
+function Vector2Methods:normalize()
+    local n = self.x * self.x + self.y * self.y
+    if n ~= 1 and n >= TOLERANCE then
+        local s = 1 / sqrt(n)
+        self.x, self.y = self.x * s, self.y * s
+    end
+    return self
+end
+
+function Vector2Methods:isZero()
+    return self.x == 0 and self.y == 0
+end
+
+Vector2 = ffi.metatype("gameplay_Vector2", {
+    __index = Vector2Methods,
+    __add = function(a, b) return Vector2(a.x + b.x, a.y + b.y) end,
+    __sub = function(a, b) return Vector2(a.x - b.x, a.y - b.y) end,
+    __mul = function(a, b)
+        if type(a) == "number" then
+            return Vector2(b.x * a, b.y * a)
+        end
+        return Vector2(a.x * b, a.y * b)
+    end,
+    __div = function(a, s) return Vector2(a.x / s, a.y / s) end,
+    __unm = function(a) return Vector2(-a.x, -a.y) end,
+    __tostring = function(a) return "Vector2(" .. a.x .. ", " .. a.y .. ")" end
+})
+
+--------------------------------------------------------------------------------
+-- Vector3
+--------------------------------------------------------------------------------
+
+local Vector3Methods = {}
+
+function Vector3Methods:set(x, y, z)
+    if type(x) == "number" then
+        self.x, self.y, self.z = x, y, z
+    else
+        self.x, self.y, self.z = x.x, x.y, x.z
+    end
+    return self
+end
+
+function Vector3Methods:add(v)
+    self.x, self.y, self.z = self.x + v.x, self.y + v.y, self.z + v.z
+    return self
+end
+
+function Vector3Methods:subtract(v)
+    self.x, self.y, self.z = self.x - v.x, self.y - v.y, self.z - v.z
+    return self
+end
+
+function Vector3Methods:scale(s)
+    self.x, self.y, self.z = self.x * s, self.y * s, self.z * s
+    return self
+end
+
+function Vector3Methods:negate()
+    self.x, self.y, self.z = -self.x, -self.y, -self.z
+    return self
+end
+
+function Vector3Methods:clamp(lower, upper)
+    self.x = min(max(self.x, lower.x), upper.x)
+    self.y = min(max(self.y, lower.y), upper.y)
+    self.z = min(max(self.z, lower.z), upper.z)
+    return self
+end
+
+function Vector3Methods:dot(v)
+    return self.x * v.x + self.y * v.y + self.z * v.z
+end
+
+function Vector3Methods:cross(v)
+    self.x, self.y, self.z = self.y * v.z - self.z * v.y,
+                             self.z * v.x - self.x * v.z,
+                             self.x * v.y - self.y * v.x
+    return self
+end
+
+function Vector3Methods:lengthSquared()
+    return self.x * self.x + self.y * self.y + self.z * self.z
+end
+
+function Vector3Methods:length()
+    return sqrt(self.x * self.x + self.y * self.y + self.z * self.z)
+end
+
+function Vector3Methods:distanceSquared(v)
+    local dx, dy, dz = v.x - self.x, v.y - self.y, v.z - self.z
+    return dx * dx + dy * dy + dz * dz
+end
+
+function Vector3Methods:distance(v)
+    return sqrt(self:distanceSquared(v))
+end
+
+function Vector3Methods:normalize()
+    local n = self.x * self.x + self.y * self.y + self.z * self.z
+    if n ~= 1 and n >= TOLERANCE then
+        local s = 1 / sqrt(n)
+        self.x, self.y, self.z = self.x * s, self.y * s, self.z * s
+    end
+    return self
+end
+
+function Vector3Methods:isZero()
+    return self.x == 0 and self.y == 0 and self.z == 0
+end
+
+Vector3 = ffi.metatype("gameplay_Vector3", {
+    __index = Vector3Methods,
+    __add = function(a, b) return Vector3(a.x + b.x, a.y + b.y, a.z + b.z) end,
+    __sub = function(a, b) return Vector3(a.x - b.x, a.y - b.y, a.z - b.z) end,
+    __mul = function(a, b)
+        if type(a) == "number" then
+            return Vector3(b.x * a, b.y * a, b.z * a)
+        end
+        return Vector3(a.x * b, a.y * b, a.z * b)
+    end,
+    __div = function(a, s) return Vector3(a.x / s, a.y / s, a.z / s) end,
+    __unm = function(a) return Vector3(-a.x, -a.y, -a.z) end,
+    __tostring = function(a) return "Vector3(" .. a.x .. ", " .. a.y .. ", " .. a.z .. ")" end
+})
+
+--------------------------------------------------------------------------------
+-- Vector4
+--------------------------------------------------------------------------------
+
+local Vector4Methods = {}
+
+function Vector4Methods:set(x, y, z, w)
+    if type(x) == "number" then
+        self.x, self.y, self.z, self.w = x, y, z, w
+    else
+        self.x, self.y, self.z, self.w = x.x, x.y, x.z, x.w
+    end
+    return self
+end
+
+function Vector4Methods:add(v)
+    self.x, self.y, self.z, self.w = self.x + v.x, self.y + v.y, self.z + v.z, self.w + v.w
+    return self
+end
+
+function Vector4Methods:subtract(v)
+    self.x, self.y, self.z, self.w = self.x - v.x, self.y - v.y, self.z - v.z, self.w - v.w
+    return self
+end
+
+function Vector4Methods:scale(s)
+    self.x, self.y, self.z, self.w = self.x * s, self.y * s, self.z * s, self.w * s
+    return self
+end
+
+function Vector4Methods:negate()
+    self.x, self.y, self.z, self.w = -self.x, -self.y, -self.z, -self.w
+    return self
+end
+
+function Vector4Methods:dot(v)
+    return self.x * v.x + self.y * v.y + self.z * v.z + self.w * v.w
+end
+
+function Vector4Methods:lengthSquared()
+    return self:dot(self)
+end
+
+function Vector4Methods:length()
+    return sqrt(self:dot(self))
+end
+
+function Vector4Methods:distanceSquared(v)
+    local dx, dy, dz, dw = v.x - self.x, v.y - self.y, v.z - self.z, v.w - self.w
+    return dx * dx + dy * dy + dz * dz + dw * dw
+end
+
+function Vector4Methods:distance(v)
+    return sqrt(self:distanceSquared(v))
+end
+
+function Vector4Methods:normalize()
+    local n = self:dot(self)
+    if n ~= 1 and n >= TOLERANCE then
+        self:scale(1 / sqrt(n))
+    end
+    return self
+end
+
+function Vector4Methods:isZero()
+    return self.x == 0 and self.y == 0 and self.z == 0 and self.w == 0
+end
+
+Vector4 = ffi.metatype("gameplay_Vector4", {
+    __index = Vector4Methods,
+    __add = function(a, b) return Vector4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w) end,
+    __sub = function(a, b) return Vector4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w) end,
+    __mul = function(a, b)
+        if type(a) == "number" then
+            return Vector4(b.x * a, b.y * a, b.z * a, b.w * a)
+        end
+        return Vector4(a.x * b, a.y * b, a.z * b, a.w * b)
+    end,
+    __div = function(a, s) return Vector4(a.x / s, a.y / s, a.z / s, a.w / s) end,
+    __unm = function(a) return Vector4(-a.x, -a.y, -a.z, -a.w) end,
+    __tostring = function(a) return "Vector4(" .. a.x .. ", " .. a.y .. ", " .. a.z .. ", " .. a.w .. ")" end
+})
+
+--------------------------------------------------------------------------------
+-- Quaternion
+--------------------------------------------------------------------------------
+
+local QuaternionMethods = {}
+
+function QuaternionMethods:set(x, y, z, w)
+    if type(x) == "number" then
+        self.x, self.y, self.z, self.w = x, y, z, w
+    else
+        self.x, self.y, self.z, self.w = x.x, x.y, x.z, x.w
+    end
+    return self
+end
+
+function QuaternionMethods:setIdentity()
+    self.x, self.y, self.z, self.w = 0, 0, 0, 1
+    return self
+end
+
+function QuaternionMethods:isIdentity()
+    return self.x == 0 and self.y == 0 and self.z == 0 and self.w == 1
+end
+
+function QuaternionMethods:isZero()
+    return self.x == 0 and self.y == 0 and self.z == 0 and self.w == 0
+end
+
+function QuaternionMethods:conjugate()
+    self.x, self.y, self.z = -self.x, -self.y, -self.z
+    return self
+end
+
+-- Inverts the quaternion, returning false and leaving it unchanged if it cannot be inverted.
+function QuaternionMethods:inverse()
+    local n = self.x * self.x + self.y * self.y + self.z * self.z + self.w * self.w
+    if n < TOLERANCE then
+        return false
+    end
+    n = 1 / n
+    self.x, self.y, self.z, self.w = -self.x * n, -self.y * n, -self.z * n, self.w * n
+    return true
+end
+
+function QuaternionMethods:normalize()
+    local n = self.x * self.x + self.y * self.y + self.z * self.z + self.w * self.w
+    if n ~= 1 and n >= TOLERANCE then
+        local s = 1 / sqrt(n)
+        self.x, self.y, self.z, self.w = self.x * s, self.y * s, self.z * s, self.w * s
+    end
+    return self
+end
+
+-- Multiplies the quaternion by another, this * q, like Quaternion::multiply.
+function QuaternionMethods:multiply(q)
+    local x1, y1, z1, w1 = self.x, self.y, self.z, self.w
+    local x2, y2, z2, w2 = q.x, q.y, q.z, q.w
+    self.x = w1 * x2 + x1 * w2 + y1 * z2 - z1 * y2
+    self.y = w1 * y2 - x1 * z2 + y1 * w2 + z1 * x2
+    self.z = w1 * z2 + x1 * y2 - y1 * x2 + z1 * w2
+    self.w = w1 * w2 - x1 * x2 - y1 * y2 - z1 * z2
+    return self
+end
+
+-- Rotates a point by the quaternion, which must be normalized, into dst (or into point).
+function QuaternionMethods:rotatePoint(point, dst)
+    dst = dst or point
+    local qx, qy, qz, qw = self.x, self.y, self.z, self.w
+    local px, py, pz = point.x, point.y, point.z
+
+    -- p + 2w(q x p) + 2q x (q x p)
+    local tx = 2 * (qy * pz - qz * py)
+    local ty = 2 * (qz * px - qx * pz)
+    local tz = 2 * (qx * py - qy * px)
+    dst.x = px + qw * tx + (qy * tz - qz * ty)
+    dst.y = py + qw * ty + (qz * tx - qx * tz)
+    dst.z = pz + qw * tz + (qx * ty - qy * tx)
+    return dst
+end
+
+-- Returns the angle of the rotation, and sets axis to its axis.
+function QuaternionMethods:toAxisAngle(axis)
+    local q = Quaternion(self.x, self.y, self.z, self.w):normalize()
+    axis.x, axis.y, axis.z = q.x, q.y, q.z
+    axis:normalize()
+    return 2 * acos(q.w)
+end
+
+Quaternion = ffi.metatype("gameplay_Quaternion", {
+    __new = function(ct, x, y, z, w)
+        if x == nil then
+            return ffi.new(ct, 0, 0, 0, 1)
+        end
+        return ffi.new(ct, x, y, z, w)
+    end,
+    __index = QuaternionMethods,
+    __mul = function(a, b)
+        if ffi.istype(Vector3, b) then
+            return a:rotatePoint(b, Vector3())
+        end
+        return Quaternion(a.x, a.y, a.z, a.w):multiply(b)
+    end,
+    __tostring = function(a) return "Quaternion(" .. a.x .. ", " .. a.y .. ", " .. a.z .. ", " .. a.w .. ")" end
+})
+
+-- Sets dst (or a new quaternion) to the rotation of angle radians around axis.
+function vmath.quaternionFromAxisAngle(axis, angle, dst)
+    dst = dst or Quaternion()
+    local n = Vector3(axis.x, axis.y, axis.z):normalize()
+    local s = sin(angle * 0.5)
+    dst.x, dst.y, dst.z, dst.w = n.x * s, n.y * s, n.z * s, cos(angle * 0.5)
+    return dst
+end
+
+-- Sets dst (or a new quaternion) to the linear interpolation of q1 and q2, like Quaternion::lerp.
+function vmath.lerp(q1, q2, t, dst)
+    dst = dst or Quaternion()
+    local t1 = 1 - t
+    dst.x = t1 * q1.x + t * q2.x
+    dst.y = t1 * q1.y + t * q2.y
+    dst.z = t1 * q1.z + t * q2.z
+    dst.w = t1 * q1.w + t * q2.w
+    return dst
+end
+
+-- Sets dst (or a new quaternion) to the spherical interpolation of q1 and q2, along the shortest arc.
+function vmath.slerp(q1, q2, t, dst)
+    dst = dst or Quaternion()
+    local x2, y2, z2, w2 = q2.x, q2.y, q2.z, q2.w
+    local c = q1.x * x2 + q1.y * y2 + q1.z * z2 + q1.w * w2
+    if c < 0 then
+        c, x2, y2, z2, w2 = -c, -x2, -y2, -z2, -w2
+    end
+
+    local s1, s2
+    if 1 - c > EPSILON then
+        local omega = acos(c)
+        local s = 1 / sin(omega)
+        s1, s2 = sin((1 - t) * omega) * s, sin(t * omega) * s
+    else
+        -- The rotations are too close to divide by the sine of their angle.
+        s1, s2 = 1 - t, t
+    end
+    dst.x = s1 * q1.x + s2 * x2
+    dst.y = s1 * q1.y + s2 * y2
+    dst.z = s1 * q1.z + s2 * z2
+    dst.w = s1 * q1.w + s2 * w2
+    return dst
+end
+
+--------------------------------------------------------------------------------
+-- Matrix
+--
+-- The 16 elements are in column-major order like in the Matrix class, with the translation
+-- in elements 12, 13 and 14.
+--------------------------------------------------------------------------------
+
+local MatrixMethods = {}
+
+function MatrixMethods:set(m)
+    ffi.copy(self.m, m.m, 64)
+    return self
+end
+
+function MatrixMethods:setIdentity()
+    local m = self.m
+    ffi.fill(m, 64)
+    m[0], m[5], m[10], m[15] = 1, 1, 1, 1
+    return self
+end
+
+function MatrixMethods:isIdentity()
+    local m = self.m
+    for i = 0, 15 do
+        if m[i] ~= ((i % 5 == 0) and 1 or 0) then
+            return false
+        end
+    end
+    return true
+end
+
+-- Multiplies the matrix by another, this * b, like Matrix::multiply.
+function MatrixMethods:multiply(b)
+    local a, n = self.m, b.m
+    local a0, a1, a2, a3 = a[0], a[1], a[2], a[3]
+    local a4, a5, a6, a7 = a[4], a[5], a[6], a[7]
+    local a8, a9, a10, a11 = a[8], a[9], a[10], a[11]
+    local a12, a13, a14, a15 = a[12], a[13], a[14], a[15]
+    for c = 0, 12, 4 do
+        local b0, b1, b2, b3 = n[c], n[c + 1], n[c + 2], n[c + 3]
+        a[c] = a0 * b0 + a4 * b1 + a8 * b2 + a12 * b3
+        a[c + 1] = a1 * b0 + a5 * b1 + a9 * b2 + a13 * b3
+        a[c + 2] = a2 * b0 + a6 * b1 + a10 * b2 + a14 * b3
+        a[c + 3] = a3 * b0 + a7 * b1 + a11 * b2 + a15 * b3
+    end
+    return self
+end
+
+function MatrixMethods:transpose()
+    local m = self.m
+    m[1], m[4] = m[4], m[1]
+    m[2], m[8] = m[8], m[2]
+    m[3], m[12] = m[12], m[3]
+    m[6], m[9] = m[9], m[6]
+    m[7], m[13] = m[13], m[7]
+    m[11], m[14] = m[14], m[11]
+    return self
+end
+
+function MatrixMethods:determinant()
+    local m = self.m
+    local a0 = m[0] * m[5] - m[1] * m[4]
+    local a1 = m[0] * m[6] - m[2] * m[4]
+    local a2 = m[0] * m[7] - m[3] * m[4]
+    local a3 = m[1] * m[6] - m[2] * m[5]
+    local a4 = m[1] * m[7] - m[3] * m[5]
+    local a5 = m[2] * m[7] - m[3] * m[6]
+    local b0 = m[8] * m[13] - m[9] * m[12]
+    local b1 = m[8] * m[14] - m[10] * m[12]
+    local b2 = m[8] * m[15] - m[11] * m[12]
+    local b3 = m[9] * m[14] - m[10] * m[13]
+    local b4 = m[9] * m[15] - m[11] * m[13]
+    local b5 = m[10] * m[15] - m[11] * m[14]
+    return a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0
+end
+
+-- Inverts the matrix, returning false and leaving it unchanged if it cannot be inverted.
+function MatrixMethods:invert()
+    local m = self.m
+    local m0, m1, m2, m3, m4, m5, m6, m7 = m[0], m[1], m[2], m[3], m[4], m[5], m[6], m[7]
+    local m8, m9, m10, m11, m12, m13, m14, m15 = m[8], m[9], m[10], m[11], m[12], m[13], m[14], m[15]
+    local a0 = m0 * m5 - m1 * m4
+    local a1 = m0 * m6 - m2 * m4
+    local a2 = m0 * m7 - m3 * m4
+    local a3 = m1 * m6 - m2 * m5
+    local a4 = m1 * m7 - m3 * m5
+    local a5 = m2 * m7 - m3 * m6
+    local b0 = m8 * m13 - m9 * m12
+    local b1 = m8 * m14 - m10 * m12
+    local b2 = m8 * m15 - m11 * m12
+    local b3 = m9 * m14 - m10 * m13
+    local b4 = m9 * m15 - m11 * m13
+    local b5 = m10 * m15 - m11 * m14
+
+    local det = a0 * b5 - a1 * b4 + a2 * b3 + a3 * b2 - a4 * b1 + a5 * b0
+    if abs(det) <= TOLERANCE then
+        return false
+    end
+    local s = 1 / det
+
+    m[0] = (m5 * b5 - m6 * b4 + m7 * b3) * s
+    m[1] = (-m1 * b5 + m2 * b4 - m3 * b3) * s
+    m[2] = (m13 * a5 - m14 * a4 + m15 * a3) * s
+    m[3] = (-m9 * a5 + m10 * a4 - m11 * a3) * s
+
+    m[4] = (-m4 * b5 + m6 * b2 - m7 * b1) * s
+    m[5] = (m0 * b5 - m2 * b2 + m3 * b1) * s
+    m[6] = (-m12 * a5 + m14 * a2 - m15 * a1) * s
+    m[7] = (m8 * a5 - m10 * a2 + m11 * a1) * s
+
+    m[8] = (m4 * b4 - m5 * b2 + m7 * b0) * s
+    m[9] = (-m0 * b4 + m1 * b2 - m3 * b0) * s
+    m[10] = (m12 * a4 - m13 * a2 + m15 * a0) * s
+    m[11] = (-m8 * a4 + m9 * a2 - m11 * a0) * s
+
+    m[12] = (-m4 * b3 + m5 * b1 - m6 * b0) * s
+    m[13] = (m0 * b3 - m1 * b1 + m2 * b0) * s
+    m[14] = (-m12 * a3 + m13 * a1 - m14 * a0) * s
+    m[15] = (m8 * a3 - m9 * a1 + m10 * a0) * s
+    return true
+end
+
+-- Post-multiplies the matrix by a translation, like Matrix::translate.
+function MatrixMethods:translate(x, y, z)
+    if type(x) ~= "number" then
+        x, y, z = x.x, x.y, x.z
+    end
+    local m = self.m
+    m[12] = m[0] * x + m[4] * y + m[8] * z + m[12]
+    m[13] = m[1] * x + m[5] * y + m[9] * z + m[13]
+    m[14] = m[2] * x + m[6] * y + m[10] * z + m[14]
+    m[15] = m[3] * x + m[7] * y + m[11] * z + m[15]
+    return self
+end
+
+-- Post-multiplies the matrix by the rotation of a quaternion, like Matrix::rotate.
+function MatrixMethods:rotate(q)
+    return self:multiply(vmath.matrixFromRotation(q))
+end
+
+-- Post-multiplies the matrix by a scale, like Matrix::scale.
+function MatrixMethods:scale(x, y, z)
+    if type(x) ~= "number" then
+        x, y, z = x.x, x.y, x.z
+    elseif y == nil then
+        y, z = x, x
+    end
+    local m = self.m
+    m[0], m[1], m[2], m[3] = m[0] * x, m[1] * x, m[2] * x, m[3] * x
+    m[4], m[5], m[6], m[7] = m[4] * y, m[5] * y, m[6] * y, m[7] * y
+    m[8], m[9], m[10], m[11] = m[8] * z, m[9] * z, m[10] * z, m[11] * z
+    return self
+end
+
+-- Transforms a point (w = 1) by the matrix into dst (or into point).
+function MatrixMethods:transformPoint(point, dst)
+    dst = dst or point
+    local m = self.m
+    local x, y, z = point.x, point.y, point.z
+    dst.x = x * m[0] + y * m[4] + z * m[8] + m[12]
+    dst.y = x * m[1] + y * m[5] + z * m[9] + m[13]
+    dst.z = x * m[2] + y * m[6] + z * m[10] + m[14]
+    return dst
+end
+
+-- Transforms a direction (w = 0) by the matrix into dst (or into vector).
+function MatrixMethods:transformVector(vector, dst)
+    dst = dst or vector
+    local m = self.m
+    local x, y, z = vector.x, vector.y, vector.z
+    dst.x = x * m[0] + y * m[4] + z * m[8]
+    dst.y = x * m[1] + y * m[5] + z * m[9]
+    dst.z = x * m[2] + y * m[6] + z * m[10]
+    return dst
+end
+
+function MatrixMethods:getTranslation(dst)
+    dst = dst or Vector3()
+    dst.x, dst.y, dst.z = self.m[12], self.m[13], self.m[14]
+    return dst
+end
+
+Matrix = ffi.metatype("gameplay_Matrix", {
+    __new = function(ct, ...)
+        if select("#", ...) == 0 then
+            local matrix = ffi.new(ct)
+            local m = matrix.m
+            m[0], m[5], m[10], m[15] = 1, 1, 1, 1
+            return matrix
+        end
+        return ffi.new(ct, {...})
+    end,
+    __index = MatrixMethods,
+    __mul = function(a, b)
+        return ffi.new(Matrix):set(a):multiply(b)
+    end,
+    __tostring = function(a)
+        local m = a.m
+        local s = {}
+        for i = 0, 15 do
+            s[i + 1] = m[i]
+        end
+        return "Matrix(" .. table.concat(s, ", ") .. ")"
+    end
+})
+
+-- Sets dst (or a new matrix) to a translation.
+function vmath.matrixFromTranslation(x, y, z, dst)
+    if type(x) ~= "number" then
+        x, y, z, dst = x.x, x.y, x.z, y
+    end
+    dst = dst or Matrix()
+    dst:setIdentity()
+    dst.m[12], dst.m[13], dst.m[14] = x, y, z
+    return dst
+end
+
+-- Sets dst (or a new matrix) to the rotation of a quaternion, like Matrix::createRotation.
+function vmath.matrixFromRotation(q, dst)
+    dst = dst or Matrix()
+    local m = dst.m
+    local x2, y2, z2 = q.x + q.x, q.y + q.y, q.z + q.z
+    local xx2, yy2, zz2 = q.x * x2, q.y * y2, q.z * z2
+    local xy2, xz2, yz2 = q.x * y2, q.x * z2, q.y * z2
+    local wx2, wy2, wz2 = q.w * x2, q.w * y2, q.w * z2
+
+    m[0], m[1], m[2], m[3] = 1 - yy2 - zz2, xy2 + wz2, xz2 - wy2, 0
+    m[4], m[5], m[6], m[7] = xy2 - wz2, 1 - xx2 - zz2, yz2 + wx2, 0
+    m[8], m[9], m[10], m[11] = xz2 + wy2, yz2 - wx2, 1 - xx2 - yy2, 0
+    m[12], m[13], m[14], m[15] = 0, 0, 0, 1
+    return dst
+end
+
+--------------------------------------------------------------------------------
+-- Bound objects
+--------------------------------------------------------------------------------
+
+local LuaObjectPointer = ffi.typeof("gameplay_LuaObject*")
+
+-- The pointer types of the bound math classes, by the metatable of their bindings.
+local refTypes = {}
+local registry = debug.getregistry()
+refTypes[registry.Vector2 or false] = ffi.typeof("gameplay_Vector2*")
+refTypes[registry.Vector3 or false] = ffi.typeof("gameplay_Vector3*")
+refTypes[registry.Vector4 or false] = ffi.typeof("gameplay_Vector4*")
+refTypes[registry.Quaternion or false] = ffi.typeof("gameplay_Quaternion*")
+refTypes[registry.Matrix or false] = ffi.typeof("gameplay_Matrix*")
+refTypes[false] = nil
+
+-- Returns a pointer to the C++ object of a bound Vector2, Vector3, Vector4, Quaternion or
+-- Matrix, which has the methods of the value type and stays valid while the object exists.
+function vmath.ref(object)
+    local refType = refTypes[getmetatable(object) or false]
+    if refType == nil then
+        error("vmath.ref expects a bound Vector2, Vector3, Vector4, Quaternion or Matrix.", 2)
+    end
+    return ffi.cast(refType, ffi.cast(LuaObjectPointer, object).instance)
+end
+
+vmath.Vector2 = Vector2
+vmath.Vector3 = Vector3
+vmath.Vector4 = Vector4
+vmath.Quaternion = Quaternion
+vmath.Matrix = Matrix
+
+package.loaded.vmath = vmath
+return vmath
@@ -15,7 +15,10 @@ precision mediump float;
 #ifndef POINT_LIGHT_COUNT
 #define POINT_LIGHT_COUNT 0
 #endif
-#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#ifndef SHADOW_CASCADE_COUNT
+#define SHADOW_CASCADE_COUNT 1
+#endif
+#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING)
 #define LIGHTING
 #endif
 
@@ -49,6 +52,18 @@ uniform float u_spotLightInnerAngleCos[SPOT_LIGHT_COUNT];
 uniform float u_spotLightOuterAngleCos[SPOT_LIGHT_COUNT];
 #endif
 
+#if defined(CLUSTERED_LIGHTING)
+uniform sampler2D u_lightClusterTexture;
+uniform vec4 u_lightClusterParameters[4];
+#endif
+
+#if defined(SHADOWS)
+uniform sampler2D u_shadowMapTexture;
+uniform mat4 u_shadowMatrices[SHADOW_CASCADE_COUNT];
+uniform vec4 u_shadowCascadeSplits;
+uniform vec4 u_shadowParameters;
+#endif
+
 #if defined(SPECULAR)
 uniform float u_specularExponent;
 #endif
@@ -93,10 +108,18 @@ varying vec3 v_vertexToSpotLightDirection[SPOT_LIGHT_COUNT];
 varying vec3 v_cameraDirection; 
 #endif
 
+#if defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
+varying vec3 v_positionViewSpace;
+#endif
+
 #include "lighting.frag"
 
 #endif
 
+#if defined(INSTANCING)
+varying vec4 v_instanceColor;
+#endif
+
 #if defined(CLIP_PLANE)
 varying float v_clipDistance;
 #endif
@@ -107,7 +130,12 @@ void main()
     if(v_clipDistance < 0.0) discard;
     #endif
  
-    #if defined(LIGHTING)
+    #if defined(DEPTH_PASS)
+
+    // Only depth is written before shading.
+    gl_FragColor = vec4(0.0);
+
+    #elif defined(LIGHTING)
 
     #if defined(VERTEX_COLOR)
 	_baseColor.rgb = v_color;
@@ -134,6 +162,10 @@ void main()
 	gl_FragColor.rgb *= lightColor.rgb;
 	#endif
 
+    #if defined(INSTANCING)
+    gl_FragColor *= v_instanceColor;
+    #endif
+
 	#if defined(MODULATE_COLOR)
     gl_FragColor *= u_modulateColor;
     #endif
@@ -7,7 +7,7 @@
 #ifndef POINT_LIGHT_COUNT
 #define POINT_LIGHT_COUNT 0
 #endif
-#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING)
 #define LIGHTING
 #endif
 
@@ -18,6 +18,14 @@ attribute vec4 a_position;
 #if defined(SKINNING)
 attribute vec4 a_blendWeights;
 attribute vec4 a_blendIndices;
+#if defined(SKINNING_POSE_TEXTURE)
+attribute float a_instancePose;
+#endif
+#endif
+
+#if defined(INSTANCING)
+attribute mat4 a_instanceMatrix;
+attribute vec4 a_instanceColor;
 #endif
 
 #if defined(LIGHTMAP)
@@ -37,13 +45,20 @@ attribute vec3 a_color;
 uniform mat4 u_worldViewProjectionMatrix;
 
 #if defined(SKINNING)
+#if defined(SKINNING_DUAL_QUATERNION)
+uniform vec4 u_dualQuaternionPalette[SKINNING_JOINT_COUNT * 2];
+#elif defined(SKINNING_POSE_TEXTURE)
+uniform sampler2D u_posePalette;
+uniform vec2 u_posePaletteTexelSize;
+#else
 uniform vec4 u_matrixPalette[SKINNING_JOINT_COUNT * 3];
 #endif
+#endif
 
 #if defined(LIGHTING)
 uniform mat4 u_inverseTransposeWorldViewMatrix;
 
-#if (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(SPECULAR)
+#if (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(SPECULAR) || defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
 uniform mat4 u_worldViewMatrix;
 #endif
 
@@ -71,6 +86,10 @@ uniform mat4 u_worldMatrix;
 uniform vec4 u_clipPlane;
 #endif
 
+#if defined(LIGHTMAP_SCALE_OFFSET)
+uniform vec4 u_lightmapScaleOffset;
+#endif
+
 ///////////////////////////////////////////////////////////
 // Varyings
 #if defined(LIGHTMAP)
@@ -101,6 +120,10 @@ varying vec3 v_vertexToSpotLightDirection[SPOT_LIGHT_COUNT];
 varying vec3 v_cameraDirection;
 #endif
 
+#if defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
+varying vec3 v_positionViewSpace;
+#endif
+
 #include "lighting.vert"
 
 #endif
@@ -111,6 +134,10 @@ varying vec3 v_cameraDirection;
 #include "skinning-none.vert" 
 #endif
 
+#if defined(INSTANCING)
+varying vec4 v_instanceColor;
+#endif
+
 #if defined(CLIP_PLANE)
 varying float v_clipDistance;
 #endif
@@ -131,11 +158,19 @@ void main()
     // Apply light.
     applyLight(position);
 
+    #if defined(SHADOWS) && !defined(CLUSTERED_LIGHTING)
+    // Shadows are looked up per pixel, in view space.
+    v_positionViewSpace = (u_worldViewMatrix * position).xyz;
+    #endif
+
     #endif
 
     // Pass the lightmap texture coordinate
     #if defined(LIGHTMAP)
     v_texCoord1 = a_texCoord1;
+    #if defined(LIGHTMAP_SCALE_OFFSET)
+    v_texCoord1 = v_texCoord1 * u_lightmapScaleOffset.xy + u_lightmapScaleOffset.zw;
+    #endif
     #endif
     
     // Pass the vertex color
@@ -146,4 +181,8 @@ void main()
     #if defined(CLIP_PLANE)
     v_clipDistance = dot(u_worldMatrix * position, u_clipPlane);
     #endif    
+
+    #if defined(INSTANCING)
+    v_instanceColor = a_instanceColor;
+    #endif
 }
@@ -26,6 +26,146 @@ vec3 computeLighting(vec3 normalVector, vec3 lightDirection, vec3 lightColor, fl
     #endif
 }
 
+#if defined(SHADOWS)
+
+// Returns how much of the light that casts the shadow maps reaches the pixel, from 0 to 1.
+float getShadow()
+{
+    float depth = -v_positionViewSpace.z;
+    if (depth >= u_shadowParameters.w)
+        return 1.0;
+
+    // Select the cascade that the pixel is in by its view depth.
+    vec4 position = vec4(v_positionViewSpace, 1.0);
+    vec4 shadowPosition = u_shadowMatrices[0] * position;
+    float cascade = 0.0;
+    #if (SHADOW_CASCADE_COUNT > 1)
+    for (int i = 1; i < SHADOW_CASCADE_COUNT; ++i)
+    {
+        if (depth > u_shadowCascadeSplits[i - 1])
+        {
+            shadowPosition = u_shadowMatrices[i] * position;
+            cascade = float(i);
+        }
+    }
+    #endif
+    shadowPosition.xyz /= shadowPosition.w;
+
+    // Pixels outside of the map of their cascade, which a cached cascade may not cover yet, are lit.
+    float column = shadowPosition.x * u_shadowParameters.y / u_shadowParameters.x - cascade;
+    if (column < 0.0 || column > 1.0 || shadowPosition.y < 0.0 || shadowPosition.y > 1.0 || shadowPosition.z > 1.0)
+        return 1.0;
+
+    // Filter the depth comparison over 3x3 texels.
+    float receiverDepth = shadowPosition.z - u_shadowParameters.z;
+    float lit = 0.0;
+    for (int x = -1; x <= 1; ++x)
+    {
+        for (int y = -1; y <= 1; ++y)
+        {
+            vec2 offset = vec2(float(x), float(y)) * u_shadowParameters.xy;
+            lit += step(receiverDepth, texture2D(u_shadowMapTexture, shadowPosition.xy + offset).r);
+        }
+    }
+    return lit / 9.0;
+}
+
+#endif
+
+#if defined(CLUSTERED_LIGHTING)
+
+#ifndef MAX_DIRECTIONAL_LIGHTS
+#define MAX_DIRECTIONAL_LIGHTS 4
+#endif
+#ifndef MAX_CLUSTER_LIGHTS
+#define MAX_CLUSTER_LIGHTS 64
+#endif
+
+// Fetches a texel of the light cluster texture by its index, counting along rows.
+vec4 getLightClusterTexel(float index)
+{
+    float row = floor(index * u_lightClusterParameters[3].y);
+    float column = index - row * u_lightClusterParameters[3].x;
+    return texture2D(u_lightClusterTexture, vec2((column + 0.5) * u_lightClusterParameters[3].y, (row + 0.5) * u_lightClusterParameters[3].z));
+}
+
+vec3 getLitPixel()
+{
+    #if defined(BUMPED)
+    
+    vec3 normalVector = texture2D(u_normalmapTexture, v_texCoord).rgb * 2.0 - 1.0;
+    normalVector = normalize(mat3(v_tangentVector, v_binormalVector, v_normalVector) * normalVector);
+    
+    #else
+    
+    vec3 normalVector = normalize(v_normalVector);
+    
+    #endif
+    
+    vec3 ambientColor = _baseColor.rgb * u_ambientColor;
+    vec3 combinedColor = ambientColor;
+
+    #if defined(SHADOWS)
+    float shadow = getShadow();
+    #endif
+
+    // Directional lights are stored first and light every cluster.
+    for (int i = 0; i < MAX_DIRECTIONAL_LIGHTS; ++i)
+    {
+        float light = float(i);
+        if (light >= u_lightClusterParameters[0].w)
+            break;
+
+        vec3 lightDirection = normalize(getLightClusterTexel(light * 3.0).xyz);
+        vec3 lightColor = getLightClusterTexel(light * 3.0 + 1.0).rgb;
+        float attenuation = 1.0;
+        #if defined(SHADOWS) && !defined(SPOT_SHADOWS)
+        if (i == 0)
+            attenuation = shadow;
+        #endif
+        combinedColor += computeLighting(normalVector, -lightDirection, lightColor, attenuation);
+    }
+
+    // Find the cluster of the pixel from its window position and the log of its view depth.
+    vec2 tile = clamp(floor(gl_FragCoord.xy * u_lightClusterParameters[1].xy + u_lightClusterParameters[1].zw), vec2(0.0), u_lightClusterParameters[0].xy - 1.0);
+    float slice = clamp(floor(log(max(-v_positionViewSpace.z, 0.0001)) * u_lightClusterParameters[2].x + u_lightClusterParameters[2].y), 0.0, u_lightClusterParameters[0].z - 1.0);
+    float cluster = (slice * u_lightClusterParameters[0].y + tile.y) * u_lightClusterParameters[0].x + tile.x;
+    vec4 lightList = getLightClusterTexel(u_lightClusterParameters[2].z + cluster);
+
+    // Point and spot light contribution. Point lights are stored with a cone that covers the whole sphere.
+    for (int i = 0; i < MAX_CLUSTER_LIGHTS; ++i)
+    {
+        float entry = float(i);
+        if (entry >= lightList.y)
+            break;
+
+        // Each texel of the light lists holds four light indices.
+        entry += lightList.x;
+        float texel = floor(entry * 0.25);
+        vec4 indices = getLightClusterTexel(u_lightClusterParameters[2].w + texel);
+        float light = dot(indices, vec4(equal(vec4(entry - texel * 4.0), vec4(0.0, 1.0, 2.0, 3.0)))) * 3.0;
+
+        vec4 lightPosition = getLightClusterTexel(light);
+        vec4 lightColor = getLightClusterTexel(light + 1.0);
+        vec4 spotLightDirection = getLightClusterTexel(light + 2.0);
+
+        // Compute range attenuation
+        vec3 vertexToLightDirection = lightPosition.xyz - v_positionViewSpace;
+        vec3 ldir = vertexToLightDirection * lightPosition.w;
+        float attenuation = clamp(1.0 - dot(ldir, ldir), 0.0, 1.0);
+        vertexToLightDirection = normalize(vertexToLightDirection);
+
+        // Apply spot attenuation
+        float spotCurrentAngleCos = dot(spotLightDirection.xyz, -vertexToLightDirection);
+        attenuation *= smoothstep(lightColor.w, spotLightDirection.w, spotCurrentAngleCos);
+        combinedColor += computeLighting(normalVector, vertexToLightDirection, lightColor.rgb, attenuation);
+    }
+
+    return combinedColor;
+}
+
+#else
+
 vec3 getLitPixel()
 {
     #if defined(BUMPED)
@@ -41,6 +181,10 @@ vec3 getLitPixel()
     vec3 ambientColor = _baseColor.rgb * u_ambientColor;
     vec3 combinedColor = ambientColor;
 
+    #if defined(SHADOWS)
+    float shadow = getShadow();
+    #endif
+
     // Directional light contribution
     #if (DIRECTIONAL_LIGHT_COUNT > 0)
     for (int i = 0; i < DIRECTIONAL_LIGHT_COUNT; ++i)
@@ -50,7 +194,12 @@ vec3 getLitPixel()
         #else
         vec3 lightDirection = normalize(u_directionalLightDirection[i] * 2.0);
         #endif 
-        combinedColor += computeLighting(normalVector, -lightDirection, u_directionalLightColor[i], 1.0);
+        float attenuation = 1.0;
+        #if defined(SHADOWS) && !defined(SPOT_SHADOWS)
+        if (i == 0)
+            attenuation = shadow;
+        #endif
+        combinedColor += computeLighting(normalVector, -lightDirection, u_directionalLightColor[i], attenuation);
     }
     #endif
 
@@ -84,9 +233,15 @@ vec3 getLitPixel()
 
 		// Apply spot attenuation
         attenuation *= smoothstep(u_spotLightOuterAngleCos[i], u_spotLightInnerAngleCos[i], spotCurrentAngleCos);
+        #if defined(SHADOWS) && defined(SPOT_SHADOWS)
+        if (i == 0)
+            attenuation *= shadow;
+        #endif
         combinedColor += computeLighting(normalVector, vertexToSpotLightDirection, u_spotLightColor[i], attenuation);
     }
     #endif
 
     return combinedColor;
 }
+
+#endif
@@ -1,5 +1,16 @@
 
-#if defined(BUMPED)
+#if defined(CLUSTERED_LIGHTING)
+void applyLight(vec4 position)
+{
+    // Clustered lights are read per pixel, in view space.
+    vec4 positionWorldViewSpace = u_worldViewMatrix * position;
+    v_positionViewSpace = positionWorldViewSpace.xyz;
+
+    #if defined(SPECULAR)
+    v_cameraDirection = u_cameraPosition - positionWorldViewSpace.xyz;
+    #endif
+}
+#elif defined(BUMPED)
 void applyLight(vec4 position, mat3 tangentSpaceTransformMatrix)
 {
     #if (defined(SPECULAR) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0))
@@ -0,0 +1,33 @@
+///////////////////////////////////////////////////////////
+// Attributes
+attribute vec2 a_position;
+attribute vec4 a_positionSize;
+attribute vec4 a_color;
+attribute vec2 a_angleFrame;
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform mat4 u_viewProjectionMatrix;
+uniform vec3 u_cameraRight;
+uniform vec3 u_cameraUp;
+uniform vec4 u_frameCoords[64];
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+varying vec4 v_color;
+
+
+void main()
+{
+    // Rotate the corner around the center of the particle, then face the camera.
+    float c = cos(a_angleFrame.x);
+    float s = sin(a_angleFrame.x);
+    vec2 corner = vec2(a_position.x * c - a_position.y * s, a_position.x * s + a_position.y * c) * a_positionSize.w;
+    vec3 position = a_positionSize.xyz + u_cameraRight * corner.x + u_cameraUp * corner.y;
+    gl_Position = u_viewProjectionMatrix * vec4(position, 1.0);
+
+    vec4 coords = u_frameCoords[int(a_angleFrame.y)];
+    v_texCoord = mix(coords.xy, coords.zw, a_position + 0.5);
+    v_color = a_color;
+}
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////
+// Attributes
+in vec4 a_positionEnergy;
+in vec4 a_velocityLifetime;
+in vec4 a_accelerationAngle;
+in vec4 a_seed;
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform float u_elapsedTime;
+uniform float u_time;
+uniform int u_emitStart;
+uniform int u_emitCount;
+uniform int u_particleCountMax;
+uniform vec3 u_position;
+uniform vec3 u_positionVar;
+uniform vec3 u_velocity;
+uniform vec3 u_velocityVar;
+uniform vec3 u_acceleration;
+uniform vec3 u_accelerationVar;
+uniform vec2 u_energy;
+uniform vec2 u_rotationPerParticleSpeed;
+uniform vec4 u_size;
+uniform int u_ellipsoid;
+uniform vec3 u_orbit;
+uniform mat4 u_worldMatrix;
+
+///////////////////////////////////////////////////////////
+// Varyings
+out vec4 v_positionEnergy;
+out vec4 v_velocityLifetime;
+out vec4 v_accelerationAngle;
+out vec4 v_seed;
+
+///////////////////////////////////////////////////////////
+// Variables
+float _random;
+
+
+// Returns a pseudo random number between 0 and 1.
+float random()
+{
+    _random = fract(sin(_random * 12.9898 + 78.233) * 43758.5453);
+    return _random;
+}
+
+// Returns a pseudo random number between -1 and 1.
+float randomMinus1To1()
+{
+    return random() * 2.0 - 1.0;
+}
+
+vec3 generateVector(vec3 base, vec3 variance)
+{
+    return base + variance * vec3(randomMinus1To1(), randomMinus1To1(), randomMinus1To1());
+}
+
+vec3 generateVectorInEllipsoid(vec3 center, vec3 scale)
+{
+    // Pick a random direction and a distance such that points are uniformly distributed in the unit sphere.
+    float z = randomMinus1To1();
+    float a = random() * 6.2831853;
+    float r = sqrt(1.0 - z * z);
+    vec3 direction = vec3(r * cos(a), r * sin(a), z);
+    return center + direction * pow(random(), 1.0 / 3.0) * scale;
+}
+
+void emit()
+{
+    vec3 position = u_ellipsoid != 0 ? generateVectorInEllipsoid(u_position, u_positionVar) : generateVector(u_position, u_positionVar);
+    vec3 velocity = generateVector(u_velocity, u_velocityVar);
+    vec3 acceleration = generateVector(u_acceleration, u_accelerationVar);
+
+    // Initial position, velocity and acceleration can all be relative to the emitter's transform.
+    mat3 rotation = mat3(u_worldMatrix);
+    if (u_orbit.x != 0.0)
+        position = rotation * position;
+    if (u_orbit.y != 0.0)
+        velocity = rotation * velocity;
+    if (u_orbit.z != 0.0)
+        acceleration = rotation * acceleration;
+    position += u_worldMatrix[3].xyz;
+
+    float energy = max(mix(u_energy.x, u_energy.y, random()), 1.0);
+    float rotationSpeed = mix(u_rotationPerParticleSpeed.x, u_rotationPerParticleSpeed.y, random());
+    float angle = rotationSpeed * random();
+
+    v_positionEnergy = vec4(position, energy);
+    v_velocityLifetime = vec4(velocity, energy);
+    v_accelerationAngle = vec4(acceleration, angle);
+    v_seed = vec4(rotationSpeed, mix(u_size.x, u_size.y, random()), mix(u_size.z, u_size.w, random()), random());
+}
+
+void main()
+{
+    // New particles take the slots following the last emitted particle, wrapping around the buffer.
+    int offset = gl_VertexID - u_emitStart;
+    if (offset < 0)
+        offset += u_particleCountMax;
+
+    if (offset < u_emitCount)
+    {
+        _random = fract(u_time * 0.1234 + float(gl_VertexID) * 0.000731);
+        emit();
+    }
+    else if (a_positionEnergy.w > 0.0)
+    {
+        float elapsedSecs = u_elapsedTime * 0.001;
+        vec3 velocity = a_velocityLifetime.xyz + a_accelerationAngle.xyz * elapsedSecs;
+        v_positionEnergy = vec4(a_positionEnergy.xyz + velocity * elapsedSecs, a_positionEnergy.w - u_elapsedTime);
+        v_velocityLifetime = vec4(velocity, a_velocityLifetime.w);
+        v_accelerationAngle = vec4(a_accelerationAngle.xyz, a_accelerationAngle.w + a_seed.x * elapsedSecs);
+        v_seed = a_seed;
+    }
+    else
+    {
+        v_positionEnergy = a_positionEnergy;
+        v_velocityLifetime = a_velocityLifetime;
+        v_accelerationAngle = a_accelerationAngle;
+        v_seed = a_seed;
+    }
+}
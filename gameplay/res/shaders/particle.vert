@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////
+// Attributes
+attribute vec2 a_position;
+attribute vec4 a_positionEnergy;
+attribute vec4 a_velocityLifetime;
+attribute vec4 a_accelerationAngle;
+attribute vec4 a_seed;
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform mat4 u_viewProjectionMatrix;
+uniform vec3 u_cameraRight;
+uniform vec3 u_cameraUp;
+uniform vec4 u_colorStart;
+uniform vec4 u_colorStartVar;
+uniform vec4 u_colorEnd;
+uniform vec4 u_colorEndVar;
+uniform vec4 u_frameCoords[64];
+uniform float u_frameCount;
+uniform float u_frameRandomOffset;
+uniform float u_frameDuration;
+uniform float u_animation;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+varying vec4 v_color;
+
+
+// Returns a vector of pseudo random numbers between -1 and 1 derived from a seed.
+vec4 random(float seed)
+{
+    return fract(sin(vec4(seed) * vec4(12.9898, 78.233, 45.164, 94.673)) * 43758.5453) * 2.0 - 1.0;
+}
+
+void main()
+{
+    float energy = a_positionEnergy.w;
+    if (energy <= 0.0)
+    {
+        // Dead particles are moved outside of the clip volume.
+        gl_Position = vec4(0.0, 0.0, 2.0, 1.0);
+        v_texCoord = vec2(0.0);
+        v_color = vec4(0.0);
+        return;
+    }
+
+    // Simple linear interpolation of color and size.
+    float lifetime = a_velocityLifetime.w;
+    float percent = 1.0 - energy / lifetime;
+    vec4 colorStart = u_colorStart + u_colorStartVar * random(a_seed.w);
+    vec4 colorEnd = u_colorEnd + u_colorEndVar * random(a_seed.w + 0.5);
+    v_color = mix(colorStart, colorEnd, percent);
+    float size = mix(a_seed.y, a_seed.z, percent);
+
+    // Rotate the corner around the center of the particle, then face the camera.
+    float angle = a_accelerationAngle.w;
+    float c = cos(angle);
+    float s = sin(angle);
+    vec2 corner = vec2(a_position.x * c - a_position.y * s, a_position.x * s + a_position.y * c) * size;
+    vec3 position = a_positionEnergy.xyz + u_cameraRight * corner.x + u_cameraUp * corner.y;
+    gl_Position = u_viewProjectionMatrix * vec4(position, 1.0);
+
+    // Sprite animation.
+    float frame = floor(fract(a_seed.w * 7.31) * u_frameRandomOffset);
+    if (u_animation == 1.0)
+    {
+        // The last frame finishes exactly when the particle dies.
+        frame = min(max(frame, floor(percent * u_frameCount)), u_frameCount - 1.0);
+    }
+    else if (u_animation == 2.0)
+    {
+        // The animation repeats indefinitely.
+        frame = mod(frame + floor((lifetime - energy) * 0.001 / u_frameDuration), u_frameCount);
+    }
+    vec4 coords = u_frameCoords[int(frame)];
+    v_texCoord = mix(coords.xy, coords.zw, a_position + 0.5);
+}
@@ -0,0 +1,25 @@
+#ifdef OPENGL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform sampler2D u_texture;
+uniform sampler2D u_bloomTexture;
+uniform float u_intensity;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+
+
+void main()
+{
+    vec4 color = texture2D(u_texture, v_texCoord);
+    vec3 bloom = texture2D(u_bloomTexture, v_texCoord).rgb;
+    gl_FragColor = vec4(color.rgb + bloom * u_intensity, color.a);
+}
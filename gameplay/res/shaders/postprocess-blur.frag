@@ -0,0 +1,33 @@
+#ifdef OPENGL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform sampler2D u_texture;
+uniform vec2 u_texelSize;
+uniform vec2 u_direction;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+
+
+void main()
+{
+    // A 9 tap gaussian blur along one direction, which takes 5 samples by placing the outer
+    // samples between two texels and letting the linear filter weigh them.
+    vec2 offset1 = u_direction * u_texelSize * 1.3846153846;
+    vec2 offset2 = u_direction * u_texelSize * 3.2307692308;
+
+    vec3 color = texture2D(u_texture, v_texCoord).rgb * 0.2270270270;
+    color += texture2D(u_texture, v_texCoord + offset1).rgb * 0.3162162162;
+    color += texture2D(u_texture, v_texCoord - offset1).rgb * 0.3162162162;
+    color += texture2D(u_texture, v_texCoord + offset2).rgb * 0.0702702703;
+    color += texture2D(u_texture, v_texCoord - offset2).rgb * 0.0702702703;
+    gl_FragColor = vec4(color, 1.0);
+}
@@ -0,0 +1,27 @@
+#ifdef OPENGL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform sampler2D u_texture;
+uniform float u_threshold;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+
+
+void main()
+{
+    vec3 color = texture2D(u_texture, v_texCoord).rgb;
+
+    // Keep the part of the color above the threshold, scaled by how far the brightest channel exceeds it.
+    float brightness = max(color.r, max(color.g, color.b));
+    float excess = max(brightness - u_threshold, 0.0);
+    gl_FragColor = vec4(color * (excess / max(brightness, 0.0001)), 1.0);
+}
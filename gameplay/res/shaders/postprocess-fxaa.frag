@@ -0,0 +1,61 @@
+#ifdef OPENGL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform sampler2D u_texture;
+uniform vec2 u_texelSize;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+
+#define FXAA_REDUCE_MIN (1.0 / 128.0)
+#define FXAA_REDUCE_MUL (1.0 / 8.0)
+#define FXAA_SPAN_MAX 8.0
+
+float luma(vec3 color)
+{
+    return dot(color, vec3(0.299, 0.587, 0.114));
+}
+
+
+void main()
+{
+    vec3 rgbNW = texture2D(u_texture, v_texCoord + vec2(-1.0, -1.0) * u_texelSize).rgb;
+    vec3 rgbNE = texture2D(u_texture, v_texCoord + vec2(1.0, -1.0) * u_texelSize).rgb;
+    vec3 rgbSW = texture2D(u_texture, v_texCoord + vec2(-1.0, 1.0) * u_texelSize).rgb;
+    vec3 rgbSE = texture2D(u_texture, v_texCoord + vec2(1.0, 1.0) * u_texelSize).rgb;
+    vec4 rgbaM = texture2D(u_texture, v_texCoord);
+
+    float lumaNW = luma(rgbNW);
+    float lumaNE = luma(rgbNE);
+    float lumaSW = luma(rgbSW);
+    float lumaSE = luma(rgbSE);
+    float lumaM = luma(rgbaM.rgb);
+    float lumaMin = min(lumaM, min(min(lumaNW, lumaNE), min(lumaSW, lumaSE)));
+    float lumaMax = max(lumaM, max(max(lumaNW, lumaNE), max(lumaSW, lumaSE)));
+
+    // Blur along the edge, which runs across the luma gradient.
+    vec2 dir = vec2(-((lumaNW + lumaNE) - (lumaSW + lumaSE)), (lumaNW + lumaSW) - (lumaNE + lumaSE));
+    float dirReduce = max((lumaNW + lumaNE + lumaSW + lumaSE) * (0.25 * FXAA_REDUCE_MUL), FXAA_REDUCE_MIN);
+    float rcpDirMin = 1.0 / (min(abs(dir.x), abs(dir.y)) + dirReduce);
+    dir = clamp(dir * rcpDirMin, vec2(-FXAA_SPAN_MAX), vec2(FXAA_SPAN_MAX)) * u_texelSize;
+
+    vec3 rgbA = 0.5 * (texture2D(u_texture, v_texCoord + dir * (1.0 / 3.0 - 0.5)).rgb +
+                       texture2D(u_texture, v_texCoord + dir * (2.0 / 3.0 - 0.5)).rgb);
+    vec3 rgbB = rgbA * 0.5 + 0.25 * (texture2D(u_texture, v_texCoord + dir * -0.5).rgb +
+                                     texture2D(u_texture, v_texCoord + dir * 0.5).rgb);
+
+    // Fall back to the narrower blur when the wider one reaches past the local contrast.
+    float lumaB = luma(rgbB);
+    if (lumaB < lumaMin || lumaB > lumaMax)
+        gl_FragColor = vec4(rgbA, rgbaM.a);
+    else
+        gl_FragColor = vec4(rgbB, rgbaM.a);
+}
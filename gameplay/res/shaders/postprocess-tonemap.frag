@@ -0,0 +1,27 @@
+#ifdef OPENGL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform sampler2D u_texture;
+uniform float u_exposure;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+
+
+void main()
+{
+    vec4 color = texture2D(u_texture, v_texCoord);
+
+    // The filmic curve fitted to ACES by Krzysztof Narkowicz.
+    vec3 x = color.rgb * u_exposure;
+    vec3 mapped = clamp((x * (2.51 * x + 0.03)) / (x * (2.43 * x + 0.59) + 0.14), 0.0, 1.0);
+    gl_FragColor = vec4(mapped, color.a);
+}
@@ -0,0 +1,24 @@
+#ifdef OPENGL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+///////////////////////////////////////////////////////////
+// Uniforms
+uniform sampler2D u_texture;
+uniform vec2 u_textureScale;
+uniform vec2 u_textureMax;
+
+///////////////////////////////////////////////////////////
+// Varyings
+varying vec2 v_texCoord;
+
+
+void main()
+{
+    // Sample the drawn part of the texture, without filtering in texels outside of it.
+    gl_FragColor = texture2D(u_texture, min(v_texCoord * u_textureScale, u_textureMax));
+}
@@ -1,12 +1,110 @@
+#if defined(INSTANCING)
+
+// Skinned instances are posed in model space first and then placed by their instance transform.
+vec4 transformInstancePosition(vec4 position)
+{
+    return a_instanceMatrix * position;
+}
+
+vec3 transformInstanceVector(vec3 vector)
+{
+    // Assumes that instances are scaled uniformly.
+    return mat3(a_instanceMatrix[0].xyz, a_instanceMatrix[1].xyz, a_instanceMatrix[2].xyz) * vector;
+}
+
+#else
+
+vec4 transformInstancePosition(vec4 position)
+{
+    return position;
+}
+
+vec3 transformInstanceVector(vec3 vector)
+{
+    return vector;
+}
+
+#endif
+
+#if defined(SKINNING_DUAL_QUATERNION)
+
+vec4 _skinnedReal;
+vec4 _skinnedDual;
+
+void blendDualQuaternion(float blendWeight, int index)
+{
+    vec4 real = u_dualQuaternionPalette[index];
+
+    // Blend along the shortest path between the rotations.
+    if (dot(real, _skinnedReal) < 0.0)
+        blendWeight = -blendWeight;
+    _skinnedReal += blendWeight * real;
+    _skinnedDual += blendWeight * u_dualQuaternionPalette[index + 1];
+}
+
+void blendDualQuaternions()
+{
+    _skinnedReal = vec4(0.0);
+    _skinnedDual = vec4(0.0);
+    blendDualQuaternion(a_blendWeights[0], int(a_blendIndices[0]) * 2);
+    blendDualQuaternion(a_blendWeights[1], int(a_blendIndices[1]) * 2);
+    blendDualQuaternion(a_blendWeights[2], int(a_blendIndices[2]) * 2);
+    blendDualQuaternion(a_blendWeights[3], int(a_blendIndices[3]) * 2);
+    float len = length(_skinnedReal);
+    _skinnedReal /= len;
+    _skinnedDual /= len;
+}
+
+vec3 rotateByQuaternion(vec4 q, vec3 v)
+{
+    return v + 2.0 * cross(q.xyz, cross(q.xyz, v) + q.w * v);
+}
+
+vec4 getPosition()
+{
+    blendDualQuaternions();
+    vec3 translation = 2.0 * (_skinnedReal.w * _skinnedDual.xyz - _skinnedDual.w * _skinnedReal.xyz + cross(_skinnedReal.xyz, _skinnedDual.xyz));
+    return transformInstancePosition(vec4(rotateByQuaternion(_skinnedReal, a_position.xyz) + translation * a_position.w, a_position.w));
+}
+
+#if defined(LIGHTING)
+
+vec3 getTangentSpaceVector(vec3 vector)
+{
+    blendDualQuaternions();
+    return transformInstanceVector(rotateByQuaternion(_skinnedReal, vector));
+}
+
+#endif
+
+#else
+
+#if defined(SKINNING_POSE_TEXTURE)
+
+// Each row of the palette texture holds the matrix palette of one pose, one texel per palette row.
+vec4 getMatrixPaletteRow(int index)
+{
+    vec2 coord = vec2((float(index) + 0.5) * u_posePaletteTexelSize.x, (a_instancePose + 0.5) * u_posePaletteTexelSize.y);
+    return texture2DLod(u_posePalette, coord, 0.0);
+}
+
+#else
+
+vec4 getMatrixPaletteRow(int index)
+{
+    return u_matrixPalette[index];
+}
+
+#endif
 
 vec4 _skinnedPosition;
 
 void skinPosition(float blendWeight, int matrixIndex)
 {
     vec4 tmp;
-    tmp.x = dot(a_position, u_matrixPalette[matrixIndex]);
-    tmp.y = dot(a_position, u_matrixPalette[matrixIndex + 1]);
-    tmp.z = dot(a_position, u_matrixPalette[matrixIndex + 2]);
+    tmp.x = dot(a_position, getMatrixPaletteRow(matrixIndex));
+    tmp.y = dot(a_position, getMatrixPaletteRow(matrixIndex + 1));
+    tmp.z = dot(a_position, getMatrixPaletteRow(matrixIndex + 2));
     tmp.w = a_position.w;
     _skinnedPosition += blendWeight * tmp;
 }
@@ -26,7 +124,7 @@ vec4 getPosition()
     blendWeight = a_blendWeights[3];
     matrixIndex = int(a_blendIndices[3]) * 3;
     skinPosition(blendWeight, matrixIndex);
-    return _skinnedPosition;    
+    return transformInstancePosition(_skinnedPosition);
 }
 
 #if defined(LIGHTING)
@@ -36,9 +134,9 @@ vec3 _skinnedNormal;
 void skinTangentSpaceVector(vec3 vector, float blendWeight, int matrixIndex)
 {
     vec3 tmp;
-    tmp.x = dot(vector, u_matrixPalette[matrixIndex].xyz);
-    tmp.y = dot(vector, u_matrixPalette[matrixIndex + 1].xyz);
-    tmp.z = dot(vector, u_matrixPalette[matrixIndex + 2].xyz);
+    tmp.x = dot(vector, getMatrixPaletteRow(matrixIndex).xyz);
+    tmp.y = dot(vector, getMatrixPaletteRow(matrixIndex + 1).xyz);
+    tmp.z = dot(vector, getMatrixPaletteRow(matrixIndex + 2).xyz);
     _skinnedNormal += blendWeight * tmp;
 }
 
@@ -58,9 +156,15 @@ vec3 getTangentSpaceVector(vec3 vector)
     blendWeight = a_blendWeights[3];
     matrixIndex = int(a_blendIndices[3]) * 3;
     skinTangentSpaceVector(vector, blendWeight, matrixIndex);
-    return _skinnedNormal;
+    return transformInstanceVector(_skinnedNormal);
 }
 
+#endif
+
+#endif
+
+#if defined(LIGHTING)
+
 vec3 getNormal()
 {
     return getTangentSpaceVector(a_normal);
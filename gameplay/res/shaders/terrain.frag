@@ -15,7 +15,10 @@ precision mediump float;
 #ifndef POINT_LIGHT_COUNT
 #define POINT_LIGHT_COUNT 0
 #endif
-#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#ifndef SHADOW_CASCADE_COUNT
+#define SHADOW_CASCADE_COUNT 1
+#endif
+#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING)
 #define LIGHTING
 #endif
 
@@ -44,6 +47,18 @@ uniform float u_spotLightInnerAngleCos[SPOT_LIGHT_COUNT];
 uniform float u_spotLightOuterAngleCos[SPOT_LIGHT_COUNT];
 #endif
 
+#if defined(CLUSTERED_LIGHTING)
+uniform sampler2D u_lightClusterTexture;
+uniform vec4 u_lightClusterParameters[4];
+#endif
+
+#if defined(SHADOWS)
+uniform sampler2D u_shadowMapTexture;
+uniform mat4 u_shadowMatrices[SHADOW_CASCADE_COUNT];
+uniform vec4 u_shadowCascadeSplits;
+uniform vec4 u_shadowParameters;
+#endif
+
 #if defined (NORMAL_MAP)
 uniform sampler2D u_normalMap;
 uniform mat4 u_normalMatrix;
@@ -60,6 +75,13 @@ uniform float u_column;
 uniform sampler2D u_surfaceLayerMaps[SAMPLER_COUNT];
 #endif
 
+#if defined(SPLAT_LAYER_COUNT)
+uniform sampler2D u_layerAtlas;
+uniform sampler2D u_splatMap;
+uniform vec4 u_layerRects[SPLAT_LAYER_COUNT];
+uniform vec2 u_layerRepeats[SPLAT_LAYER_COUNT];
+#endif
+
 ///////////////////////////////////////////////////////////
 // Variables
 vec4 _baseColor;
@@ -106,6 +128,15 @@ void blendLayer(sampler2D textureMap, vec2 texCoord, float alphaBlend)
 }
 #endif
 
+#if defined(SPLAT_LAYER_COUNT)
+// Samples a layer from its cell of the atlas, which must be indexed with a constant.
+#define SPLAT_LAYER(i) texture2D(u_layerAtlas, u_layerRects[i].xy + fract(v_texCoord0 * u_layerRepeats[i]) * u_layerRects[i].zw).rgb
+#endif
+
+#if defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
+varying vec3 v_positionViewSpace;
+#endif
+
 #if defined(LIGHTING)
 #include "lighting.frag"
 #endif
@@ -113,7 +144,29 @@ void blendLayer(sampler2D textureMap, vec2 texCoord, float alphaBlend)
 
 void main()
 {
-    #if (LAYER_COUNT > 0)
+    #if defined(DEPTH_PASS)
+    // Only depth is written before shading, so the layers are not sampled.
+    gl_FragColor = vec4(0.0);
+    #else
+
+    #if defined(SPLAT_LAYER_COUNT)
+    // Blend the layers of the atlas with the weights of the splat map
+    _baseColor.rgb = SPLAT_LAYER(0);
+    _baseColor.a = 1.0;
+    #if (SPLAT_LAYER_COUNT > 1)
+    vec4 splat = texture2D(u_splatMap, v_texCoord0);
+    _baseColor.rgb = mix(_baseColor.rgb, SPLAT_LAYER(1), splat.r);
+    #endif
+    #if (SPLAT_LAYER_COUNT > 2)
+    _baseColor.rgb = mix(_baseColor.rgb, SPLAT_LAYER(2), splat.g);
+    #endif
+    #if (SPLAT_LAYER_COUNT > 3)
+    _baseColor.rgb = mix(_baseColor.rgb, SPLAT_LAYER(3), splat.b);
+    #endif
+    #if (SPLAT_LAYER_COUNT > 4)
+    _baseColor.rgb = mix(_baseColor.rgb, SPLAT_LAYER(4), splat.a);
+    #endif
+    #elif (LAYER_COUNT > 0)
     // Sample base texture
 	_baseColor.rgb = texture2D(u_surfaceLayerMaps[TEXTURE_INDEX_0], mod(v_texCoordLayer0, vec2(1,1))).rgb;
     _baseColor.a = 1.0;
@@ -149,4 +202,5 @@ void main()
     gl_FragColor.rgb = _baseColor.rgb;
 
     #endif
+    #endif
 }
@@ -7,17 +7,19 @@
 #ifndef POINT_LIGHT_COUNT
 #define POINT_LIGHT_COUNT 0
 #endif
-#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING)
 #define LIGHTING
 #endif
 
 ///////////////////////////////////////////////////////////
 // Attributes
 attribute vec4 a_position;
+#if !defined(GEOMORPHING)
 #if !defined(NORMAL_MAP) && defined(LIGHTING)
 attribute vec3 a_normal;
 #endif
 attribute vec2 a_texCoord0;
+#endif
 
 ///////////////////////////////////////////////////////////
 // Uniforms
@@ -26,11 +28,24 @@ uniform mat4 u_worldViewProjectionMatrix;
 uniform mat4 u_normalMatrix;
 #endif
 
+#if defined(GEOMORPHING)
+uniform sampler2D u_heightMap;
+uniform vec2 u_heightMapSize;
+uniform vec2 u_heightRange;
+uniform vec3 u_terrainScale;
+uniform vec2 u_terrainOffset;
+uniform vec4 u_patchBounds;
+uniform float u_gridStep;
+uniform vec2 u_morphRange;
+uniform mat4 u_worldMatrix;
+uniform vec3 u_cameraPosition;
+#endif
+
 #if defined(LIGHTING)
 
 uniform mat4 u_inverseTransposeWorldViewMatrix;
 
-#if (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#if (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
 uniform mat4 u_worldViewMatrix;
 #endif
 
@@ -67,6 +82,10 @@ varying vec3 v_vertexToPointLightDirection[POINT_LIGHT_COUNT];
 varying vec3 v_vertexToSpotLightDirection[SPOT_LIGHT_COUNT];
 #endif
 
+#if defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
+varying vec3 v_positionViewSpace;
+#endif
+
 #include "lighting.vert"
 
 #endif
@@ -82,33 +101,87 @@ varying vec2 v_texCoordLayer1;
 varying vec2 v_texCoordLayer2;
 #endif
 
+#if defined(GEOMORPHING)
+
+// Returns the height of the given heightfield sample, which is stored as a 16 bit value in the red and green channels.
+float getHeight(vec2 coord)
+{
+    vec4 texel = texture2DLod(u_heightMap, (coord + 0.5) / u_heightMapSize, 0.0);
+    return u_heightRange.x + (texel.r * 65280.0 + texel.g * 255.0) / 65535.0 * u_heightRange.y;
+}
+
+vec4 getPosition(vec2 coord)
+{
+    return vec4((coord.x + u_terrainOffset.x) * u_terrainScale.x, getHeight(coord), (coord.y + u_terrainOffset.y) * u_terrainScale.z, 1.0);
+}
+
+#endif
 
 void main()
 {
+    #if defined(GEOMORPHING)
+
+    // The grid holds the offsets of the vertices from the first sample of the patch, which are
+    // clamped to the patch since the last patches of the terrain may be smaller.
+    vec2 coord = min(u_patchBounds.xy + a_position.xy, u_patchBounds.zw);
+    vec4 position = getPosition(coord);
+    float cameraDistance = length((u_worldMatrix * position).xyz - u_cameraPosition);
+    float morph = clamp((cameraDistance - u_morphRange.x) * u_morphRange.y, 0.0, 1.0);
+
+    // Move the vertices that are not part of the grid of the next level onto their neighbour
+    // on that grid as the distance approaches the end of the range of this level.
+    vec2 odd = a_position.xy - floor(a_position.xy / (u_gridStep * 2.0)) * (u_gridStep * 2.0);
+    vec2 coarseCoord = min(u_patchBounds.xy + a_position.xy - odd, u_patchBounds.zw);
+    position = mix(position, getPosition(coarseCoord), morph);
+    coord = mix(coord, coarseCoord, morph);
+    vec2 texCoord = vec2(coord.x / (u_heightMapSize.x - 1.0), 1.0 - coord.y / (u_heightMapSize.y - 1.0));
+
+    #else
+
+    vec4 position = a_position;
+    vec2 texCoord = a_texCoord0;
+
+    #endif
+
     // Transform position to clip space.
-    gl_Position = u_worldViewProjectionMatrix * a_position;
+    gl_Position = u_worldViewProjectionMatrix * position;
 
     #if defined(LIGHTING)
 
     #if !defined(NORMAL_MAP) 
-    v_normalVector = normalize((u_normalMatrix * vec4(a_normal.x, a_normal.y, a_normal.z, 0)).xyz);
+    #if defined(GEOMORPHING)
+    vec2 maxSample = u_heightMapSize - 1.0;
+    float heightWest = getHeight(max(coord - vec2(1.0, 0.0), vec2(0.0)));
+    float heightEast = getHeight(min(coord + vec2(1.0, 0.0), maxSample));
+    float heightNorth = getHeight(max(coord - vec2(0.0, 1.0), vec2(0.0)));
+    float heightSouth = getHeight(min(coord + vec2(0.0, 1.0), maxSample));
+    vec3 normal = normalize(vec3((heightWest - heightEast) / (2.0 * u_terrainScale.x), 1.0, (heightNorth - heightSouth) / (2.0 * u_terrainScale.z)));
+    #else
+    vec3 normal = a_normal;
+    #endif
+    v_normalVector = normalize((u_normalMatrix * vec4(normal.x, normal.y, normal.z, 0)).xyz);
     #endif
 
-    applyLight(a_position);
+    applyLight(position);
+
+    #if defined(SHADOWS) && !defined(CLUSTERED_LIGHTING)
+    // Shadows are looked up per pixel, in view space.
+    v_positionViewSpace = (u_worldViewMatrix * position).xyz;
+    #endif
 
     #endif
 
     // Pass base texture coord
-    v_texCoord0 = a_texCoord0;
+    v_texCoord0 = texCoord;
 
     // Pass repeated texture coordinates for each layer
     #if LAYER_COUNT > 0
-    v_texCoordLayer0 = a_texCoord0 * TEXTURE_REPEAT_0;
+    v_texCoordLayer0 = texCoord * TEXTURE_REPEAT_0;
     #endif
     #if LAYER_COUNT > 1
-    v_texCoordLayer1 = a_texCoord0 * TEXTURE_REPEAT_1;
+    v_texCoordLayer1 = texCoord * TEXTURE_REPEAT_1;
     #endif
     #if LAYER_COUNT > 2
-    v_texCoordLayer2 = a_texCoord0 * TEXTURE_REPEAT_2;
+    v_texCoordLayer2 = texCoord * TEXTURE_REPEAT_2;
     #endif
 }
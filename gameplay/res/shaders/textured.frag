@@ -15,7 +15,10 @@ precision mediump float;
 #ifndef POINT_LIGHT_COUNT
 #define POINT_LIGHT_COUNT 0
 #endif
-#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#ifndef SHADOW_CASCADE_COUNT
+#define SHADOW_CASCADE_COUNT 1
+#endif
+#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING)
 #define LIGHTING
 #endif
 
@@ -58,6 +61,18 @@ uniform vec3 u_spotLightDirection[SPOT_LIGHT_COUNT];
 #endif
 #endif
 
+#if defined(CLUSTERED_LIGHTING)
+uniform sampler2D u_lightClusterTexture;
+uniform vec4 u_lightClusterParameters[4];
+#endif
+
+#if defined(SHADOWS)
+uniform sampler2D u_shadowMapTexture;
+uniform mat4 u_shadowMatrices[SHADOW_CASCADE_COUNT];
+uniform vec4 u_shadowCascadeSplits;
+uniform vec4 u_shadowParameters;
+#endif
+
 #if defined(SPECULAR)
 uniform float u_specularExponent;
 #endif
@@ -86,7 +101,7 @@ varying vec2 v_texCoord1;
 
 #if defined(LIGHTING)
 
-#if !defined(BUMPED)
+#if !defined(BUMPED) || defined(CLUSTERED_LIGHTING)
 varying vec3 v_normalVector;
 #endif
 
@@ -109,10 +124,23 @@ varying vec3 v_spotLightDirection[SPOT_LIGHT_COUNT];
 varying vec3 v_cameraDirection; 
 #endif
 
+#if defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
+varying vec3 v_positionViewSpace;
+#endif
+
+#if defined(CLUSTERED_LIGHTING) && defined(BUMPED)
+varying vec3 v_tangentVector;
+varying vec3 v_binormalVector;
+#endif
+
 #include "lighting.frag"
 
 #endif
 
+#if defined(INSTANCING)
+varying vec4 v_instanceColor;
+#endif
+
 #if defined(CLIP_PLANE)
 varying float v_clipDistance;
 #endif
@@ -133,7 +161,10 @@ void main()
         discard;
     #endif
 
-    #if defined(LIGHTING)
+    #if defined(DEPTH_PASS)
+    // Only depth, and the alpha test, matter before shading.
+    gl_FragColor.rgb = vec3(0.0);
+    #elif defined(LIGHTING)
 
     gl_FragColor.rgb = getLitPixel();
     #else
@@ -145,6 +176,10 @@ void main()
 	gl_FragColor.rgb *= lightColor.rgb;
 	#endif
 
+    #if defined(INSTANCING)
+    gl_FragColor *= v_instanceColor;
+    #endif
+
     #if defined(MODULATE_COLOR)
     gl_FragColor *= u_modulateColor;
     #endif
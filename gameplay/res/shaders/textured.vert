@@ -7,7 +7,7 @@
 #ifndef POINT_LIGHT_COUNT
 #define POINT_LIGHT_COUNT 0
 #endif
-#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#if (DIRECTIONAL_LIGHT_COUNT > 0) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING)
 #define LIGHTING
 #endif
 
@@ -18,6 +18,14 @@ attribute vec4 a_position;
 #if defined(SKINNING)
 attribute vec4 a_blendWeights;
 attribute vec4 a_blendIndices;
+#if defined(SKINNING_POSE_TEXTURE)
+attribute float a_instancePose;
+#endif
+#endif
+
+#if defined(INSTANCING)
+attribute mat4 a_instanceMatrix;
+attribute vec4 a_instanceColor;
 #endif
 
 attribute vec2 a_texCoord;
@@ -40,13 +48,20 @@ attribute vec3 a_binormal;
 // Uniforms
 uniform mat4 u_worldViewProjectionMatrix;
 #if defined(SKINNING)
+#if defined(SKINNING_DUAL_QUATERNION)
+uniform vec4 u_dualQuaternionPalette[SKINNING_JOINT_COUNT * 2];
+#elif defined(SKINNING_POSE_TEXTURE)
+uniform sampler2D u_posePalette;
+uniform vec2 u_posePaletteTexelSize;
+#else
 uniform vec4 u_matrixPalette[SKINNING_JOINT_COUNT * 3];
 #endif
+#endif
 
 #if defined(LIGHTING)
 uniform mat4 u_inverseTransposeWorldViewMatrix;
 
-#if defined(SPECULAR) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0)
+#if defined(SPECULAR) || (POINT_LIGHT_COUNT > 0) || (SPOT_LIGHT_COUNT > 0) || defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
 uniform mat4 u_worldViewMatrix;
 #endif
 
@@ -84,6 +99,10 @@ uniform mat4 u_worldMatrix;
 uniform vec4 u_clipPlane;
 #endif
 
+#if defined(LIGHTMAP_SCALE_OFFSET)
+uniform vec4 u_lightmapScaleOffset;
+#endif
+
 ///////////////////////////////////////////////////////////
 // Varyings
 varying vec2 v_texCoord;
@@ -94,7 +113,7 @@ varying vec2 v_texCoord1;
 
 #if defined(LIGHTING)
 
-#if !defined(BUMPED)
+#if !defined(BUMPED) || defined(CLUSTERED_LIGHTING)
 varying vec3 v_normalVector;
 #endif
 
@@ -117,6 +136,15 @@ varying vec3 v_spotLightDirection[SPOT_LIGHT_COUNT];
 varying vec3 v_cameraDirection;
 #endif
 
+#if defined(CLUSTERED_LIGHTING) || defined(SHADOWS)
+varying vec3 v_positionViewSpace;
+#endif
+
+#if defined(CLUSTERED_LIGHTING) && defined(BUMPED)
+varying vec3 v_tangentVector;
+varying vec3 v_binormalVector;
+#endif
+
 #include "lighting.vert"
 
 #endif
@@ -127,6 +155,10 @@ varying vec3 v_cameraDirection;
 #include "skinning-none.vert" 
 #endif
 
+#if defined(INSTANCING)
+varying vec4 v_instanceColor;
+#endif
+
 #if defined(CLIP_PLANE)
 varying float v_clipDistance;
 #endif
@@ -148,8 +180,16 @@ void main()
     vec3 binormal = getBinormal();
     vec3 tangentVector  = normalize(inverseTransposeWorldViewMatrix * tangent);
     vec3 binormalVector = normalize(inverseTransposeWorldViewMatrix * binormal);
+    #if defined(CLUSTERED_LIGHTING)
+    // Clustered lights are in view space, so the normal map is transformed to view space per pixel.
+    v_normalVector = normalVector;
+    v_tangentVector = tangentVector;
+    v_binormalVector = binormalVector;
+    applyLight(position);
+    #else
     mat3 tangentSpaceTransformMatrix = mat3(tangentVector.x, binormalVector.x, normalVector.x, tangentVector.y, binormalVector.y, normalVector.y, tangentVector.z, binormalVector.z, normalVector.z);
     applyLight(position, tangentSpaceTransformMatrix);
+    #endif
     
     #else
     
@@ -157,6 +197,11 @@ void main()
     applyLight(position);
     
     #endif
+
+    #if defined(SHADOWS) && !defined(CLUSTERED_LIGHTING)
+    // Shadows are looked up per pixel, in view space.
+    v_positionViewSpace = (u_worldViewMatrix * position).xyz;
+    #endif
     
     #endif 
     
@@ -172,9 +217,16 @@ void main()
     
     #if defined(LIGHTMAP)
     v_texCoord1 = a_texCoord1;
+    #if defined(LIGHTMAP_SCALE_OFFSET)
+    v_texCoord1 = v_texCoord1 * u_lightmapScaleOffset.xy + u_lightmapScaleOffset.zw;
+    #endif
     #endif
     
     #if defined(CLIP_PLANE)
     v_clipDistance = dot(u_worldMatrix * position, u_clipPlane);
     #endif
+
+    #if defined(INSTANCING)
+    v_instanceColor = a_instanceColor;
+    #endif
 }
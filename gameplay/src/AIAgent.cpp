@@ -6,7 +6,8 @@ namespace gameplay
 {
 
 AIAgent::AIAgent()
-    : _stateMachine(NULL), _node(NULL), _enabled(true), _listener(NULL), _next(NULL)
+    : _stateMachine(NULL), _node(NULL), _enabled(true), _listener(NULL), _next(NULL),
+      _importance(1.0f), _parallel(false), _pendingTime(0.0f), _pendingFrames(0)
 {
     _stateMachine = new AIStateMachine(this);
 }
@@ -54,6 +55,27 @@ void AIAgent::setEnabled(bool enabled)
     _enabled = enabled;
 }
 
+float AIAgent::getImportance() const
+{
+    return _importance;
+}
+
+void AIAgent::setImportance(float importance)
+{
+    GP_ASSERT(importance > 0.0f);
+    _importance = importance;
+}
+
+bool AIAgent::isParallel() const
+{
+    return _parallel;
+}
+
+void AIAgent::setParallel(bool parallel)
+{
+    _parallel = parallel;
+}
+
 void AIAgent::setListener(Listener* listener)
 {
     _listener = listener;
@@ -111,6 +111,51 @@ public:
      */
     void setEnabled(bool enabled);
 
+    /**
+     * Returns the importance of this AIAgent.
+     *
+     * @return The importance of the agent.
+     * @see setImportance(float)
+     */
+    float getImportance() const;
+
+    /**
+     * Sets the importance of this AIAgent, which is 1 by default.
+     *
+     * When the AIController updates distant agents less often (see
+     * AIController::setLodDistance), the distance of an agent is divided by its
+     * importance, so important agents keep updating every frame further away
+     * from the camera. When the AIController cannot update every agent within
+     * its update budget, the agents that have waited the longest, weighted by
+     * their importance, are updated first.
+     *
+     * @param importance The importance of the agent, which must be greater than zero.
+     */
+    void setImportance(float importance);
+
+    /**
+     * Determines if the state machine of this AIAgent may be updated on a worker thread.
+     *
+     * @return true if the agent may be updated in parallel with other agents, false otherwise.
+     * @see setParallel(bool)
+     */
+    bool isParallel() const;
+
+    /**
+     * Sets whether the state machine of this AIAgent may be updated on a worker thread,
+     * in parallel with the updates of other agents.
+     *
+     * The AIState::Listener::stateUpdate method of the states of a parallel agent
+     * must only access the agent itself and data that no other agent modifies, and
+     * must not call into other systems of the engine. Messages that it sends through
+     * the AIController are delivered once every parallel agent has been updated.
+     * Agents whose node has script callbacks for the stateUpdate event are always
+     * updated on the main thread. Agents are not parallel by default.
+     *
+     * @param parallel true if the agent may be updated in parallel, false otherwise.
+     */
+    void setParallel(bool parallel);
+
     /**
      * Sets an event listener for this AIAgent.
      *
@@ -157,7 +202,10 @@ private:
     bool processMessage(AIMessage* message);
 
     /**
-     * Called once per frame by the AIController to update the agent.
+     * Called by the AIController to update the agent.
+     *
+     * @param elapsedTime The time elapsed since the last update of the agent, which
+     *      spans several frames when the agent is not updated every frame.
      */
     void update(float elapsedTime);
 
@@ -166,6 +214,10 @@ private:
     bool _enabled;
     Listener* _listener;
     AIAgent* _next;
+    float _importance;
+    bool _parallel;
+    float _pendingTime;
+    unsigned int _pendingFrames;
 
 };
 
@@ -1,12 +1,15 @@
 #include "Base.h"
 #include "AIController.h"
 #include "Game.h"
+#include "Scene.h"
+#include "NavigationMesh.h"
 
 namespace gameplay
 {
 
 AIController::AIController()
-    : _paused(false), _firstMessage(NULL), _firstAgent(NULL)
+    : _paused(false), _messageSequence(0), _firstAgent(NULL), _agentIndexDirty(true),
+      _updateBudget(0.0f), _lodDistance(0.0f), _maxUpdateInterval(8), _parallelUpdate(false)
 {
 }
 
@@ -30,15 +33,15 @@ void AIController::finalize()
     }
     _firstAgent = NULL;
 
+    _agentIndex.clear();
+    _agentIndexDirty = true;
+
+    _navigationMeshes.clear();
+
     // Remove all messages
-    AIMessage* message = _firstMessage;
-    while (message)
-    {
-        AIMessage* temp = message;
-        message = message->_next;
-        AIMessage::destroy(temp);
-    }
-    _firstMessage = NULL;
+    for (size_t i = 0, count = _messages.size(); i < count; ++i)
+        AIMessage::destroy(_messages[i].message);
+    _messages.clear();
 }
 
 void AIController::pause()
@@ -53,86 +56,225 @@ void AIController::resume()
 
 void AIController::sendMessage(AIMessage* message, float delay)
 {
+    GP_ASSERT(message);
+
+    if (_parallelUpdate)
+    {
+        // Sent by a parallel agent, so deliver or queue it once the parallel updates complete
+        std::lock_guard<std::mutex> lock(_deferredMutex);
+        _deferredMessages.push_back(std::make_pair(message, delay));
+        return;
+    }
+
     if (delay <= 0)
     {
         // Send instantly
-        if (message->getReceiver() == NULL || strlen(message->getReceiver()) == 0)
-        {
-            // Broadcast message to all agents
-            AIAgent* agent = _firstAgent;
-            while (agent)
-            {
-                if (agent->processMessage(message))
-                    break; // message consumed by this agent - stop bubbling
-                agent = agent->_next;
-            }
-        }
-        else
-        {
-            // Single recipient
-            AIAgent* agent = findAgent(message->getReceiver());
-            if (agent)
-            {
-                agent->processMessage(message);
-            }
-            else
-            {
-                GP_WARN("Failed to locate AIAgent for message recipient: %s", message->getReceiver());
-            }
-        }
-
-        // Delete the message, since it is finished being processed
-        AIMessage::destroy(message);
+        deliverMessage(message);
     }
     else
     {
-        // Queue for later delivery
-        if (_firstMessage)
-            message->_next = _firstMessage;
-        _firstMessage = message;
+        // Queue for later delivery, in the heap of pending messages ordered by delivery time
+        PendingMessage pending;
+        pending.message = message;
+        pending.deliveryTime = Game::getInstance()->getGameTime() + delay;
+        pending.sequence = _messageSequence++;
+        message->_deliveryTime = pending.deliveryTime;
+        _messages.push_back(pending);
+        std::push_heap(_messages.begin(), _messages.end());
     }
 }
 
 void AIController::update(float elapsedTime)
 {
+    GP_PROFILE("AIController::update");
+
     if (_paused)
         return;
 
     static Game* game = Game::getInstance();
 
-    // Send all pending messages that have expired
-    AIMessage* prevMsg = NULL;
-    AIMessage* msg = _firstMessage;
-    while (msg)
+    // Take all pending messages that have expired off the heap, in delivery order, and
+    // deliver them as a batch. Messages sent while the batch is delivered are delivered
+    // in a later frame, even if they are already due.
+    double gameTime = game->getGameTime();
+    while (!_messages.empty() && _messages.front().deliveryTime <= gameTime)
     {
-        // If the message delivery time has expired, send it (this also deletes it)
-        if (msg->getDeliveryTime() >= game->getGameTime())
+        _deliveries.push_back(_messages.front().message);
+        std::pop_heap(_messages.begin(), _messages.end());
+        _messages.pop_back();
+    }
+    for (size_t i = 0, count = _deliveries.size(); i < count; ++i)
+        deliverMessage(_deliveries[i]);
+    _deliveries.clear();
+
+    // Send the paths that were found for the agents since the last update
+    for (size_t i = 0; i < _navigationMeshes.size(); ++i)
+        _navigationMeshes[i]->updateQueries();
+
+    updateAgents(elapsedTime);
+}
+
+void AIController::updateAgents(float elapsedTime)
+{
+    // Find the agents that are due to update, which hold a reference until they are updated
+    // in case the update of another agent removes them.
+    for (AIAgent* agent = _firstAgent; agent; agent = agent->_next)
+    {
+        if (!agent->isEnabled())
+            continue;
+
+        agent->_pendingTime += elapsedTime;
+        if (++agent->_pendingFrames < getUpdateInterval(agent))
+            continue;
+
+        Node* node = agent->getNode();
+        if (agent->isParallel() && !node->hasScriptListener(GP_GET_SCRIPT_EVENT(Node, stateUpdate)))
+            _parallelAgents.push_back(agent);
+        else
+            _dueAgents.push_back(agent);
+        agent->addRef();
+    }
+
+    if (!_parallelAgents.empty())
+    {
+        _parallelUpdate = true;
+        std::vector<AIAgent*>& agents = _parallelAgents;
+        Game::getInstance()->getJobController()->parallelFor((unsigned int)agents.size(), [&agents](unsigned int first, unsigned int end, unsigned int worker)
         {
-            // Link the message out of our list
-            if (prevMsg)
-                prevMsg->_next = msg->_next;
-
-            AIMessage* temp = msg;
-            msg = msg->_next;
-            temp->_next = NULL;
-            sendMessage(temp);
+            for (unsigned int i = first; i < end; ++i)
+                updateAgent(agents[i]);
+        }, 4);
+        _parallelUpdate = false;
+
+        for (size_t i = 0, count = _parallelAgents.size(); i < count; ++i)
+            _parallelAgents[i]->release();
+        _parallelAgents.clear();
+
+        // Send the messages of the parallel agents in the order they were sent
+        for (size_t i = 0, count = _deferredMessages.size(); i < count; ++i)
+            sendMessage(_deferredMessages[i].first, _deferredMessages[i].second);
+        _deferredMessages.clear();
+    }
+
+    if (_updateBudget > 0.0f && _dueAgents.size() > 1)
+        std::sort(_dueAgents.begin(), _dueAgents.end(), &AIController::compareAgentUrgency);
+
+    double start = Game::getAbsoluteTime();
+    size_t index = 0;
+    for (size_t count = _dueAgents.size(); index < count; ++index)
+    {
+        if (index > 0 && _updateBudget > 0.0f && Game::getAbsoluteTime() - start >= _updateBudget)
+            break;
+
+        AIAgent* agent = _dueAgents[index];
+        if (agent->isEnabled())
+            updateAgent(agent);
+        agent->release();
+    }
+
+    // The agents left over the budget update first in the next frame, which they are still due to
+    for (size_t count = _dueAgents.size(); index < count; ++index)
+        _dueAgents[index]->release();
+    _dueAgents.clear();
+}
+
+unsigned int AIController::getUpdateInterval(AIAgent* agent) const
+{
+    if (_lodDistance <= 0.0f)
+        return 1;
+
+    Node* node = agent->getNode();
+    Scene* scene = node->getScene();
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (!camera || !camera->getNode())
+        return 1;
+
+    float distance = node->getTranslationWorld().distance(camera->getNode()->getTranslationWorld());
+    float interval = 1.0f + distance / (_lodDistance * agent->getImportance());
+    return interval < (float)_maxUpdateInterval ? (unsigned int)interval : _maxUpdateInterval;
+}
+
+void AIController::updateAgent(AIAgent* agent)
+{
+    float elapsedTime = agent->_pendingTime;
+    agent->_pendingTime = 0.0f;
+    agent->_pendingFrames = 0;
+    agent->update(elapsedTime);
+}
+
+bool AIController::compareAgentUrgency(AIAgent* a, AIAgent* b)
+{
+    return a->_pendingFrames * a->getImportance() > b->_pendingFrames * b->getImportance();
+}
+
+void AIController::deliverMessage(AIMessage* message)
+{
+    if (message->getReceiver() == NULL || strlen(message->getReceiver()) == 0)
+    {
+        // Broadcast message to all agents
+        AIAgent* agent = _firstAgent;
+        while (agent)
+        {
+            if (agent->processMessage(message))
+                break; // message consumed by this agent - stop bubbling
+            agent = agent->_next;
+        }
+    }
+    else
+    {
+        // Single recipient
+        AIAgent* agent = findReceiver(message->getReceiver());
+        if (agent)
+        {
+            agent->processMessage(message);
         }
         else
         {
-            prevMsg = msg;
-            msg = msg->_next;
+            GP_WARN("Failed to locate AIAgent for message recipient: %s", message->getReceiver());
         }
     }
 
-    // Update all enabled agents
-    AIAgent* agent = _firstAgent;
-    while (agent)
-    {
-        if (agent->isEnabled())
-            agent->update(elapsedTime);
+    // Delete the message, since it is finished being processed
+    message->_deliveryTime = 0;
+    AIMessage::destroy(message);
+}
 
-        agent = agent->_next;
+AIAgent* AIController::findReceiver(const char* id)
+{
+    GP_ASSERT(id);
+
+    // The index is rebuilt when agents were added or removed since it was built, rather than
+    // updated on every change, since agents are usually added in bulk when a scene loads.
+    if (_agentIndexDirty)
+    {
+        _agentIndex.clear();
+        for (AIAgent* agent = _firstAgent; agent; agent = agent->_next)
+        {
+            // The first agent with an ID receives its messages, like findAgent.
+            _agentIndex.insert(std::make_pair(std::string(agent->getId()), agent));
+        }
+        _agentIndexDirty = false;
     }
+
+    std::unordered_map<std::string, AIAgent*>::const_iterator itr = _agentIndex.find(id);
+    AIAgent* agent = itr != _agentIndex.end() ? itr->second : NULL;
+
+    if (agent && strcmp(id, agent->getId()) == 0)
+        return agent;
+
+    // The ID of an agent is that of its node, which can change after the index was built.
+    bool stale = agent != NULL;
+    agent = findAgent(id);
+    if (stale || agent)
+        _agentIndexDirty = true;
+    return agent;
+}
+
+bool AIController::PendingMessage::operator<(const PendingMessage& other) const
+{
+    if (deliveryTime != other.deliveryTime)
+        return deliveryTime > other.deliveryTime;
+    return sequence > other.sequence;
 }
 
 void AIController::addAgent(AIAgent* agent)
@@ -143,6 +285,7 @@ void AIController::addAgent(AIAgent* agent)
         agent->_next = _firstAgent;
 
     _firstAgent = agent;
+    _agentIndexDirty = true;
 }
 
 void AIController::removeAgent(AIAgent* agent)
@@ -160,6 +303,7 @@ void AIController::removeAgent(AIAgent* agent)
                 _firstAgent = agent->_next;
 
             agent->_next = NULL;
+            _agentIndexDirty = true;
             agent->release();
             break;
         }
@@ -169,6 +313,51 @@ void AIController::removeAgent(AIAgent* agent)
     }
 }
 
+void AIController::addNavigationMesh(NavigationMesh* mesh)
+{
+    GP_ASSERT(mesh);
+
+    if (std::find(_navigationMeshes.begin(), _navigationMeshes.end(), mesh) == _navigationMeshes.end())
+        _navigationMeshes.push_back(mesh);
+}
+
+void AIController::removeNavigationMesh(NavigationMesh* mesh)
+{
+    std::vector<NavigationMesh*>::iterator itr = std::find(_navigationMeshes.begin(), _navigationMeshes.end(), mesh);
+    if (itr != _navigationMeshes.end())
+        _navigationMeshes.erase(itr);
+}
+
+float AIController::getUpdateBudget() const
+{
+    return _updateBudget;
+}
+
+void AIController::setUpdateBudget(float budget)
+{
+    _updateBudget = budget > 0.0f ? budget : 0.0f;
+}
+
+float AIController::getLodDistance() const
+{
+    return _lodDistance;
+}
+
+void AIController::setLodDistance(float distance)
+{
+    _lodDistance = distance > 0.0f ? distance : 0.0f;
+}
+
+unsigned int AIController::getMaxUpdateInterval() const
+{
+    return _maxUpdateInterval;
+}
+
+void AIController::setMaxUpdateInterval(unsigned int interval)
+{
+    _maxUpdateInterval = interval > 0 ? interval : 1;
+}
+
 AIAgent* AIController::findAgent(const char* id) const
 {
     GP_ASSERT(id);
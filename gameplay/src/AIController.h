@@ -7,6 +7,8 @@
 namespace gameplay
 {
 
+class NavigationMesh;
+
 /**
  * Defines and facilitates the state machine execution and message passing
  * between AI objects in the game. This class is generally not interfaced
@@ -15,7 +17,9 @@ namespace gameplay
 class AIController
 {
     friend class Game;
+    friend class World;
     friend class Node;
+    friend class NavigationMesh;
 
 public:
 
@@ -43,6 +47,63 @@ public:
      */
     AIAgent* findAgent(const char* id) const;
 
+    /**
+     * Returns the time budget of the agent updates of each frame.
+     *
+     * @return The update budget, in milliseconds, or 0 if it is unlimited.
+     * @see setUpdateBudget(float)
+     */
+    float getUpdateBudget() const;
+
+    /**
+     * Sets the time budget of the agent updates of each frame.
+     *
+     * The agents that are due to update on the main thread are updated until the
+     * budget is spent, and the remaining agents are updated in the following frames,
+     * with the time elapsed since their last update. At least one agent is updated
+     * every frame. The budget is unlimited by default, and can be set with the
+     * 'aiUpdateBudget' property of the game configuration.
+     *
+     * @param budget The update budget, in milliseconds, or 0 for an unlimited budget.
+     */
+    void setUpdateBudget(float budget);
+
+    /**
+     * Returns the distance from the camera at which agents update every other frame.
+     *
+     * @return The LOD distance, or 0 if every agent updates every frame.
+     * @see setLodDistance(float)
+     */
+    float getLodDistance() const;
+
+    /**
+     * Sets the distance from the active camera of their scene at which agents update
+     * every other frame.
+     *
+     * Agents update once every 1 + distance / (lodDistance * importance) frames, up
+     * to the maximum update interval, where importance is AIAgent::getImportance.
+     * The distance is 0 by default, which updates every agent every frame, and can be
+     * set with the 'aiLodDistance' property of the game configuration.
+     *
+     * @param distance The LOD distance, or 0 to update every agent every frame.
+     */
+    void setLodDistance(float distance);
+
+    /**
+     * Returns the maximum number of frames between the updates of an agent.
+     *
+     * @return The maximum update interval, in frames.
+     */
+    unsigned int getMaxUpdateInterval() const;
+
+    /**
+     * Sets the maximum number of frames between the updates of an agent that is
+     * updated less often because of its distance from the camera, which is 8 by default.
+     *
+     * @param interval The maximum update interval, in frames, which is at least 1.
+     */
+    void setMaxUpdateInterval(unsigned int interval);
+
 private:
 
     /**
@@ -96,9 +157,100 @@ private:
 
     void removeAgent(AIAgent* agent);
 
+    /**
+     * Registers a navigation mesh whose requested paths are sent during each update.
+     *
+     * @param mesh The navigation mesh.
+     */
+    void addNavigationMesh(NavigationMesh* mesh);
+
+    /**
+     * Unregisters a navigation mesh.
+     *
+     * @param mesh The navigation mesh.
+     */
+    void removeNavigationMesh(NavigationMesh* mesh);
+
+    /**
+     * Updates the agents that are due to update in this frame, in parallel and then
+     * within the update budget.
+     *
+     * @param elapsedTime The elapsed time, in milliseconds.
+     */
+    void updateAgents(float elapsedTime);
+
+    /**
+     * Returns the number of frames between the updates of an agent.
+     *
+     * @param agent The agent.
+     *
+     * @return The update interval of the agent, in frames.
+     */
+    unsigned int getUpdateInterval(AIAgent* agent) const;
+
+    /**
+     * Updates an agent with the time elapsed since its last update.
+     *
+     * @param agent The agent to update.
+     */
+    static void updateAgent(AIAgent* agent);
+
+    /**
+     * Orders agents so that those that have waited the longest for their update,
+     * weighted by their importance, come first.
+     */
+    static bool compareAgentUrgency(AIAgent* a, AIAgent* b);
+
+    /**
+     * Delivers a message to its recipient(s) and destroys it.
+     *
+     * @param message The message to deliver.
+     */
+    void deliverMessage(AIMessage* message);
+
+    /**
+     * Returns the agent that a message is addressed to, looking it up by ID
+     * among the agents indexed for the messages delivered in this frame.
+     *
+     * @param id ID of the agent to find.
+     *
+     * @return The agent matching the specified ID, or NULL if no matching agent could be found.
+     */
+    AIAgent* findReceiver(const char* id);
+
+    /**
+     * A message queued for delivery.
+     */
+    struct PendingMessage
+    {
+        /**
+         * Orders messages so that the heap of pending messages has the earliest
+         * message on top, and messages of the same delivery time in the order
+         * they were sent.
+         */
+        bool operator<(const PendingMessage& other) const;
+
+        AIMessage* message;
+        double deliveryTime;
+        unsigned int sequence;
+    };
+
     bool _paused;
-    AIMessage* _firstMessage;
+    std::vector<PendingMessage> _messages;
+    std::vector<AIMessage*> _deliveries;
+    unsigned int _messageSequence;
     AIAgent* _firstAgent;
+    std::unordered_map<std::string, AIAgent*> _agentIndex;
+    bool _agentIndexDirty;
+    float _updateBudget;
+    float _lodDistance;
+    unsigned int _maxUpdateInterval;
+    std::vector<AIAgent*> _dueAgents;
+    std::vector<AIAgent*> _parallelAgents;
+    bool _parallelUpdate;
+    std::mutex _deferredMutex;
+    std::vector<std::pair<AIMessage*, float> > _deferredMessages;
+    std::vector<NavigationMesh*> _navigationMeshes;
 
 };
 
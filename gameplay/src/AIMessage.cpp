@@ -5,13 +5,14 @@ namespace gameplay
 {
 
 AIMessage::AIMessage()
-    : _id(0), _deliveryTime(0), _parameters(NULL), _parameterCount(0), _messageType(MESSAGE_TYPE_CUSTOM), _next(NULL)
+    : _id(0), _deliveryTime(0), _parameters(NULL), _parameterCount(0), _messageType(MESSAGE_TYPE_CUSTOM)
 {
 }
 
 AIMessage::~AIMessage()
 {
-    SAFE_DELETE_ARRAY(_parameters);
+    if (_parameters != _inlineParameters)
+        SAFE_DELETE_ARRAY(_parameters);
 }
 
 AIMessage* AIMessage::create(unsigned int id, const char* sender, const char* receiver, unsigned int parameterCount)
@@ -21,8 +22,10 @@ AIMessage* AIMessage::create(unsigned int id, const char* sender, const char* re
     message->_sender = sender;
     message->_receiver = receiver;
     message->_parameterCount = parameterCount;
-    if (parameterCount > 0)
+    if (parameterCount > AI_MESSAGE_INLINE_PARAMETER_COUNT)
         message->_parameters = new AIMessage::Parameter[parameterCount];
+    else if (parameterCount > 0)
+        message->_parameters = message->_inlineParameters;
     return message;
 }
 
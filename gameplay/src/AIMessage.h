@@ -1,6 +1,11 @@
 #ifndef AIMESSAGE_H_
 #define AIMESSAGE_H_
 
+#include "ObjectPool.h"
+
+// The number of parameters stored in messages themselves, without allocating them.
+#define AI_MESSAGE_INLINE_PARAMETER_COUNT 4
+
 namespace gameplay
 {
 
@@ -20,6 +25,8 @@ class AIMessage
 
 public:
 
+    GP_POOLED_OBJECT(AIMessage);
+
     /**
      * Enumeration of supported AIMessage parameter types.
      */
@@ -274,7 +281,7 @@ private:
     Parameter* _parameters;
     unsigned int _parameterCount;
     MessageType _messageType;
-    AIMessage* _next;
+    Parameter _inlineParameters[AI_MESSAGE_INLINE_PARAMETER_COUNT];
 
 };
 
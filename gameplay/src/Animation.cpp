@@ -75,7 +75,8 @@ Animation::~Animation()
 }
 
 Animation::Channel::Channel(Animation* animation, AnimationTarget* target, int propertyId, Curve* curve, unsigned long duration)
-    : _animation(animation), _target(target), _propertyId(propertyId), _curve(curve), _duration(duration)
+    : _animation(animation), _target(target), _propertyId(propertyId), _curve(curve), _duration(duration),
+      _poseSlot(0), _poseGeneration(0)
 {
     GP_ASSERT(_animation);
     GP_ASSERT(_target);
@@ -89,7 +90,8 @@ Animation::Channel::Channel(Animation* animation, AnimationTarget* target, int p
 }
 
 Animation::Channel::Channel(const Channel& copy, Animation* animation, AnimationTarget* target)
-    : _animation(animation), _target(target), _propertyId(copy._propertyId), _curve(copy._curve), _duration(copy._duration)
+    : _animation(animation), _target(target), _propertyId(copy._propertyId), _curve(copy._curve), _duration(copy._duration),
+      _poseSlot(0), _poseGeneration(0)
 {
     GP_ASSERT(_curve);
     GP_ASSERT(_target);
@@ -135,9 +137,28 @@ void Animation::createClips(const char* url)
 
     createClips(pAnimation, (unsigned int)frameCount);
 
+    // Baking is opt-in, since it trades some precision for faster evaluation.
+    float bakeRate = pAnimation->getFloat("bakeRate");
+    if (bakeRate > 0.0f)
+        bake(bakeRate);
+
     SAFE_DELETE(properties);
 }
 
+void Animation::bake(float sampleRate)
+{
+    GP_ASSERT(sampleRate > 0.0f);
+
+    for (size_t i = 0, count = _channels.size(); i < count; i++)
+    {
+        Channel* channel = _channels[i];
+        GP_ASSERT(channel && channel->_curve);
+
+        unsigned int sampleCount = (unsigned int)(channel->_duration * 0.001f * sampleRate + 0.5f) + 1;
+        channel->_curve->bake(std::max(sampleCount, 2u));
+    }
+}
+
 AnimationClip* Animation::createClip(const char* id, unsigned long begin, unsigned long end)
 {
     AnimationClip* clip = new AnimationClip(id, this, begin, end);
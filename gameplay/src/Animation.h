@@ -25,6 +25,7 @@ class AnimationClip;
 class Animation : public Ref
 {
     friend class AnimationClip;
+    friend class AnimationController;
     friend class AnimationTarget;
     friend class Bundle;
 
@@ -107,6 +108,20 @@ public:
      */
     void pause(const char* clipId = NULL);
 
+    /**
+     * Bakes the curves of all channels of this animation into uniformly spaced samples.
+     *
+     * Baked channels are evaluated with a constant time fetch and linear blend of two
+     * quantized samples instead of searching and interpolating the original keys.
+     * Baking can also be enabled when loading clips by setting the bakeRate property
+     * of the animation namespace in the .animation file.
+     *
+     * @param sampleRate The number of samples per second to take (for example 30).
+     *
+     * @see Curve::bake
+     */
+    void bake(float sampleRate);
+
     /**
      * Returns true if this animation targets the given AnimationTarget.
      */
@@ -125,6 +140,8 @@ private:
         friend class AnimationClip;
         friend class Animation;
         friend class AnimationTarget;
+        friend class AnimationController;
+        friend class SceneSnapshot;
 
     private:
 
@@ -140,6 +157,8 @@ private:
         int _propertyId;                      // The target property this channel targets.
         Curve* _curve;                        // The curve used to represent the animation data.
         unsigned long _duration;              // The length of the animation (in milliseconds).
+        unsigned int _poseSlot;               // The slot of the target property in the pose of the AnimationController.
+        unsigned int _poseGeneration;         // The generation of the pose that the slot belongs to.
     };
 
     /**
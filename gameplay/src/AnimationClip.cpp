@@ -14,7 +14,7 @@ extern void splitURL(const std::string& url, std::string* file, std::string* id)
 AnimationClip::AnimationClip(const char* id, Animation* animation, unsigned long startTime, unsigned long endTime)
     : _id(id), _animation(animation), _startTime(startTime), _endTime(endTime), _duration(_endTime - _startTime), 
       _stateBits(0x00), _repeatCount(1.0f), _loopBlendTime(0), _activeDuration(_duration * _repeatCount), _speed(1.0f), _timeStarted(0), 
-      _elapsedTime(0), _crossFadeToClip(NULL), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f),
+      _elapsedTime(0), _crossFadeToClip(NULL), _crossFadeOutElapsed(0), _crossFadeOutDuration(0), _blendWeight(1.0f), _lodElapsedTime(0.0f),
       _beginListeners(NULL), _endListeners(NULL), _listeners(NULL), _listenerItr(NULL)
 {
     GP_REGISTER_SCRIPT_EVENTS();
@@ -551,7 +551,39 @@ bool AnimationClip::update(float elapsedTime)
         }
     }
     
-    // Evaluate this clip.
+    // Evaluate this clip into the pose of the controller.
+    apply(percentComplete, _blendWeight, _animation->_controller);
+
+    // When ended. Probably should move to it's own method so we can call it when the clip is ended early.
+    if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT) || !isClipStateBitSet(CLIP_IS_STARTED_BIT))
+    {
+        onEnd();
+        return true;
+    }
+
+    return false;
+}
+
+void AnimationClip::evaluate(float time)
+{
+    GP_ASSERT(_animation);
+
+    float percentComplete = 1.0f;
+    if (_duration > 0)
+    {
+        float loopDuration = (float)_duration + _loopBlendTime;
+        float currentTime = fmodf(time, loopDuration);
+        if (currentTime < 0.0f)
+            currentTime += loopDuration;
+        percentComplete = currentTime / (float)_duration;
+        if (_loopBlendTime == 0.0f)
+            percentComplete = MATH_CLAMP(percentComplete, 0.0f, 1.0f);
+    }
+    apply(percentComplete, 1.0f);
+}
+
+void AnimationClip::apply(float percentComplete, float blendWeight, AnimationController* controller)
+{
     Animation::Channel* channel = NULL;
     AnimationValue* value = NULL;
     AnimationTarget* target = NULL;
@@ -573,17 +605,11 @@ bool AnimationClip::update(float elapsedTime)
         channel->getCurve()->evaluate(percentComplete, percentageStart, percentageEnd, percentageBlend, value->_value);
 
         // Set the animation value on the target property.
-        target->setAnimationPropertyValue(channel->_propertyId, value, _blendWeight);
-    }
-
-    // When ended. Probably should move to it's own method so we can call it when the clip is ended early.
-    if (isClipStateBitSet(CLIP_IS_MARKED_FOR_REMOVAL_BIT) || !isClipStateBitSet(CLIP_IS_STARTED_BIT))
-    {
-        onEnd();
-        return true;
+        if (controller)
+            controller->blend(channel, value, blendWeight);
+        else
+            target->setAnimationPropertyValue(channel->_propertyId, value, blendWeight);
     }
-
-    return false;
 }
 
 void AnimationClip::onBegin()
@@ -5,12 +5,14 @@
 #include "Curve.h"
 #include "Animation.h"
 #include "ScriptTarget.h"
+#include "ObjectPool.h"
 
 namespace gameplay
 {
 
 class Animation;
 class AnimationValue;
+class AnimationController;
 
 /**
  * Defines the runtime session of an Animation to be played.
@@ -19,6 +21,7 @@ class AnimationClip : public Ref, public ScriptTarget
 {
     friend class AnimationController;
     friend class Animation;
+    friend class SceneSnapshot;
 
     GP_SCRIPT_EVENTS_START();
     GP_SCRIPT_EVENT(clipBegin, "<AnimationClip>");
@@ -28,6 +31,8 @@ class AnimationClip : public Ref, public ScriptTarget
 
 public:
 
+    GP_POOLED_OBJECT(AnimationClip);
+
     /**
      * Defines a constant for indefinitely repeating an AnimationClip.
      */
@@ -229,6 +234,19 @@ public:
      */
     void pause();
 
+    /**
+     * Applies the pose of this clip at the given time to its animation targets,
+     * without affecting the playback state of the clip.
+     *
+     * This is used to sample a clip that isn't playing, for example to evaluate
+     * several time offset poses of the same skeleton in a single frame. The time
+     * wraps around the duration of the clip, so any time can be passed for a looping
+     * clip. Listeners and script events are not notified.
+     *
+     * @param time The time within the clip to evaluate, in milliseconds.
+     */
+    void evaluate(float time);
+
     /**
      * Fades this clip out, and the specified clip in over the given duration.
      *
@@ -352,6 +370,15 @@ private:
      */
     bool update(float elapsedTime);
 
+    /**
+     * Evaluates every channel of the animation at the given percentage of this clip
+     * and applies the values to the targets with the given blend weight.
+     *
+     * If a controller is given, the values are blended into its pose instead, which
+     * it applies to the targets once all of the running clips are evaluated.
+     */
+    void apply(float percentComplete, float blendWeight, AnimationController* controller = NULL);
+
     /**
      * Handles when the AnimationClip begins.
      */
@@ -402,6 +429,7 @@ private:
     float _crossFadeOutElapsed;                         // The amount of time that has elapsed for the crossfade.
     unsigned long _crossFadeOutDuration;                // The duration of the cross fade.
     float _blendWeight;                                 // The clip's blendweight.
+    float _lodElapsedTime;                              // Time elapsed since the clip was last updated by the AnimationController.
     std::vector<AnimationValue*> _values;               // AnimationValue holder.
     std::vector<Listener*>* _beginListeners;            // Collection of begin listeners on the clip.
     std::vector<Listener*>* _endListeners;              // Collection of end listeners on the clip.
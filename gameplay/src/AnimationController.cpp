@@ -2,31 +2,89 @@
 #include "AnimationController.h"
 #include "Game.h"
 #include "Curve.h"
+#include "Quaternion.h"
+#include "Joint.h"
+#include "MeshSkin.h"
+#include "Model.h"
+#include "Scene.h"
 
 namespace gameplay
 {
 
+// Blends the value in dst towards the value in to, interpolating rotations spherically.
+static void blendValue(float* dst, const float* to, unsigned int componentCount, int quaternionOffset, float blendWeight)
+{
+    for (unsigned int i = 0; i < componentCount; i++)
+    {
+        if ((int)i == quaternionOffset)
+        {
+            Quaternion from(dst + i);
+            Quaternion rotation;
+            Quaternion::slerp(from, Quaternion(const_cast<float*>(to + i)), blendWeight, &rotation);
+            dst[i] = rotation.x;
+            dst[i + 1] = rotation.y;
+            dst[i + 2] = rotation.z;
+            dst[i + 3] = rotation.w;
+            i += 3;
+        }
+        else
+        {
+            dst[i] = Curve::lerp(blendWeight, dst[i], to[i]);
+        }
+    }
+}
+
 AnimationController::AnimationController()
-    : _state(STOPPED)
+    : _state(STOPPED), _poseGeneration(1), _frame(0), _poseDirty(false), _updating(false),
+      _lodScreenSize(0.0f), _lodUpdateInterval(0.0f), _offscreenUpdateInterval(0.0f)
 {
 }
 
 AnimationController::~AnimationController()
 {
+    clearPose();
 }
 
 void AnimationController::stopAllAnimations() 
 {
-    std::list<AnimationClip*>::iterator clipIter = _runningClips.begin();
-    while (clipIter != _runningClips.end())
+    for (size_t i = 0; i < _runningClips.size(); i++)
     {
-        AnimationClip* clip = *clipIter;
-        GP_ASSERT(clip);
-        clip->stop();
-        clipIter++;
+        AnimationClip* clip = _runningClips[i];
+        if (clip)
+            clip->stop();
     }
 }
 
+void AnimationController::setLodScreenSize(float screenSize)
+{
+    _lodScreenSize = screenSize;
+}
+
+float AnimationController::getLodScreenSize() const
+{
+    return _lodScreenSize;
+}
+
+void AnimationController::setLodUpdateInterval(float interval)
+{
+    _lodUpdateInterval = interval;
+}
+
+float AnimationController::getLodUpdateInterval() const
+{
+    return _lodUpdateInterval;
+}
+
+void AnimationController::setOffscreenUpdateInterval(float interval)
+{
+    _offscreenUpdateInterval = interval;
+}
+
+float AnimationController::getOffscreenUpdateInterval() const
+{
+    return _offscreenUpdateInterval;
+}
+
 AnimationController::State AnimationController::getState() const
 {
     return _state;
@@ -39,13 +97,13 @@ void AnimationController::initialize()
 
 void AnimationController::finalize()
 {
-    std::list<AnimationClip*>::iterator itr = _runningClips.begin();
-    for ( ; itr != _runningClips.end(); itr++)
+    for (size_t i = 0; i < _runningClips.size(); i++)
     {
-        AnimationClip* clip = *itr;
+        AnimationClip* clip = _runningClips[i];
         SAFE_RELEASE(clip);
     }
     _runningClips.clear();
+    clearPose();
     _state = STOPPED;
 }
 
@@ -72,21 +130,21 @@ void AnimationController::schedule(AnimationClip* clip)
     GP_ASSERT(clip);
     clip->addRef();
     _runningClips.push_back(clip);
+    _poseDirty = true;
 }
 
 void AnimationController::unschedule(AnimationClip* clip)
 {
-    std::list<AnimationClip*>::iterator clipItr = _runningClips.begin();
-    while (clipItr != _runningClips.end())
+    std::vector<AnimationClip*>::iterator clipItr = std::find(_runningClips.begin(), _runningClips.end(), clip);
+    if (clipItr != _runningClips.end())
     {
-        AnimationClip* rClip = (*clipItr);
-        if (rClip == clip)
-        {
+        // Clips are only removed from the list once the update that is in progress is done.
+        if (_updating)
+            *clipItr = NULL;
+        else
             _runningClips.erase(clipItr);
-            SAFE_RELEASE(clip);
-            break;
-        }
-        clipItr++;
+        SAFE_RELEASE(clip);
+        _poseDirty = true;
     }
 
     if (_runningClips.empty())
@@ -95,37 +153,76 @@ void AnimationController::unschedule(AnimationClip* clip)
 
 void AnimationController::update(float elapsedTime)
 {
+    GP_PROFILE("AnimationController::update");
+
     if (_state != RUNNING)
         return;
-    
+
+    // Slots of clips that are no longer running are dropped before the pose is rebuilt.
+    if (_poseDirty)
+    {
+        clearPose();
+        _poseDirty = false;
+    }
+    _frame++;
+
     Transform::suspendTransformChanged();
 
-    // Loop through running clips and call update() on them.
-    std::list<AnimationClip*>::iterator clipIter = _runningClips.begin();
-    while (clipIter != _runningClips.end())
+    // Clips evaluate their channels into the pose. Clips that are restarted or
+    // scheduled during the update are appended and evaluated in the same update.
+    _updating = true;
+    for (size_t i = 0; i < _runningClips.size(); i++)
     {
-        AnimationClip* clip = (*clipIter);
-        GP_ASSERT(clip);
+        AnimationClip* clip = _runningClips[i];
+        if (!clip)
+            continue;
+
+        // Clips that are starting, stopping or paused are always updated, so that
+        // their listeners are notified on time.
+        float clipElapsedTime = elapsedTime;
+        if (clip->isClipStateBitSet(AnimationClip::CLIP_IS_STARTED_BIT) &&
+            !clip->isClipStateBitSet(AnimationClip::CLIP_IS_PAUSED_BIT) &&
+            !clip->isClipStateBitSet(AnimationClip::CLIP_IS_RESTARTED_BIT) &&
+            !clip->isClipStateBitSet(AnimationClip::CLIP_IS_MARKED_FOR_REMOVAL_BIT))
+        {
+            float interval = getUpdateInterval(clip);
+            if (interval != 0.0f)
+            {
+                clip->_lodElapsedTime += elapsedTime;
+                if (interval < 0.0f || clip->_lodElapsedTime < interval)
+                    continue;
+                clipElapsedTime = clip->_lodElapsedTime;
+            }
+        }
+        clip->_lodElapsedTime = 0.0f;
+
         clip->addRef();
         if (clip->isClipStateBitSet(AnimationClip::CLIP_IS_RESTARTED_BIT))
         {   // If the CLIP_IS_RESTARTED_BIT is set, we should end the clip and 
             // move it from where it is in the running clips list to the back.
             clip->onEnd();
             clip->setClipStateBit(AnimationClip::CLIP_IS_PLAYING_BIT);
+            _runningClips[i] = NULL;
             _runningClips.push_back(clip);
-            clipIter = _runningClips.erase(clipIter);
         }
-        else if (clip->update(elapsedTime))
+        else if (clip->update(clipElapsedTime))
         {
             clip->release();
-            clipIter = _runningClips.erase(clipIter);
-        }
-        else
-        {
-            clipIter++;
+            _runningClips[i] = NULL;
+            _poseDirty = true;
         }
         clip->release();
     }
+    _updating = false;
+    _runningClips.erase(std::remove(_runningClips.begin(), _runningClips.end(), (AnimationClip*)NULL), _runningClips.end());
+
+    // Apply the pose once per target property.
+    for (size_t i = 0, count = _pose.size(); i < count; i++)
+    {
+        PoseSlot& slot = _pose[i];
+        if (slot.frame == _frame)
+            slot.target->setAnimationPropertyValue(slot.propertyId, slot.value, slot.blendWeight);
+    }
 
     Transform::resumeTransformChanged();
 
@@ -133,4 +230,129 @@ void AnimationController::update(float elapsedTime)
         _state = IDLE;
 }
 
+float AnimationController::getUpdateInterval(AnimationClip* clip) const
+{
+    if (_offscreenUpdateInterval == 0.0f && (_lodScreenSize <= 0.0f || _lodUpdateInterval <= 0.0f))
+        return 0.0f;
+
+    // Find the node that the clip animates, using the node of the model for joints.
+    GP_ASSERT(clip && clip->_animation);
+    Node* node = NULL;
+    std::vector<Animation::Channel*>& channels = clip->_animation->_channels;
+    for (size_t i = 0, count = channels.size(); i < count && !node; i++)
+    {
+        if (channels[i]->_target->_targetType == AnimationTarget::TRANSFORM)
+            node = dynamic_cast<Node*>(channels[i]->_target);
+    }
+    if (node && node->getType() == Node::JOINT)
+    {
+        Joint* joint = static_cast<Joint*>(node);
+        MeshSkin* skin = joint->_skin.skin;
+        node = (skin && skin->getModel()) ? skin->getModel()->getNode() : NULL;
+    }
+    Scene* scene = node ? node->getScene() : NULL;
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (!camera)
+        return 0.0f;
+
+    const BoundingSphere& bounds = node->getBoundingSphere();
+    if (!bounds.intersects(camera->getFrustum()))
+        return _offscreenUpdateInterval;
+
+    if (_lodScreenSize > 0.0f && _lodUpdateInterval > 0.0f)
+    {
+        // Project the diameter of the bounds onto the height of the view.
+        float viewHeight;
+        if (camera->getCameraType() == Camera::PERSPECTIVE)
+        {
+            Node* cameraNode = camera->getNode();
+            float distance = cameraNode ? cameraNode->getTranslationWorld().distance(bounds.center) : 0.0f;
+            viewHeight = 2.0f * distance * tanf(MATH_DEG_TO_RAD(camera->getFieldOfView()) * 0.5f);
+        }
+        else
+        {
+            viewHeight = camera->getZoomY();
+        }
+        if (viewHeight > 0.0f && 2.0f * bounds.radius < _lodScreenSize * viewHeight)
+            return _lodUpdateInterval;
+    }
+    return 0.0f;
+}
+
+void AnimationController::blend(Animation::Channel* channel, AnimationValue* value, float blendWeight)
+{
+    GP_ASSERT(channel);
+    GP_ASSERT(value);
+
+    PoseSlot& slot = _pose[getPoseSlot(channel)];
+    GP_ASSERT(slot.value->_componentCount == value->_componentCount);
+    if (slot.frame != _frame)
+    {
+        // The first clip to drive the property is applied with its own weight, exactly
+        // as if no other clip was running.
+        slot.frame = _frame;
+        slot.clipCount = 1;
+        slot.blendWeight = blendWeight;
+        memcpy(slot.value->_value, value->_value, value->_componentSize);
+        return;
+    }
+
+    if (slot.clipCount == 1 && slot.blendWeight < 1.0f)
+    {
+        // Another clip drives the same property, so the first clip is blended with the
+        // current value of the target before the value of this clip is blended in.
+        AnimationValue current(value->_componentCount);
+        slot.target->getAnimationPropertyValue(slot.propertyId, &current);
+        blendValue(current._value, slot.value->_value, value->_componentCount, slot.quaternionOffset, slot.blendWeight);
+        memcpy(slot.value->_value, current._value, value->_componentSize);
+    }
+    blendValue(slot.value->_value, value->_value, value->_componentCount, slot.quaternionOffset, blendWeight);
+    slot.clipCount++;
+    slot.blendWeight = 1.0f;
+}
+
+unsigned int AnimationController::getPoseSlot(Animation::Channel* channel)
+{
+    if (channel->_poseGeneration == _poseGeneration)
+        return channel->_poseSlot;
+
+    // Channels of different animations (or clips) that drive the same target property share a slot.
+    std::pair<AnimationTarget*, int> key(channel->_target, channel->_propertyId);
+    std::map<std::pair<AnimationTarget*, int>, unsigned int>::iterator itr = _poseSlots.find(key);
+    unsigned int index;
+    if (itr != _poseSlots.end())
+    {
+        index = itr->second;
+    }
+    else
+    {
+        GP_ASSERT(channel->_curve);
+        PoseSlot slot;
+        slot.target = channel->_target;
+        slot.propertyId = channel->_propertyId;
+        slot.quaternionOffset = channel->_curve->_quaternionOffset ? (int)*channel->_curve->_quaternionOffset : -1;
+        slot.frame = 0;
+        slot.clipCount = 0;
+        slot.blendWeight = 1.0f;
+        slot.value = new AnimationValue(channel->_curve->getComponentCount());
+        index = (unsigned int)_pose.size();
+        _pose.push_back(slot);
+        _poseSlots[key] = index;
+    }
+    channel->_poseSlot = index;
+    channel->_poseGeneration = _poseGeneration;
+    return index;
+}
+
+void AnimationController::clearPose()
+{
+    for (size_t i = 0, count = _pose.size(); i < count; i++)
+    {
+        SAFE_DELETE(_pose[i].value);
+    }
+    _pose.clear();
+    _poseSlots.clear();
+    _poseGeneration++;
+}
+
 }
@@ -11,10 +11,22 @@ namespace gameplay
 
 /**
  * Defines a class for controlling game animation.
+ *
+ * Running clips are evaluated into a pose with one slot per animated target
+ * property before anything is applied to the targets. Clips that drive the same
+ * property (for example while cross fading) are blended in the pose, so every
+ * target property is only set once per update no matter how many clips drive it.
+ *
+ * An optional level of detail policy reduces how often clips are updated when the
+ * node they animate is not visible to the active camera of its scene or is small on
+ * screen. Such clips are updated less often, with the time that passed in between,
+ * so they stay in sync with the clips that are updated every frame. For skinned
+ * models the visibility of the node of the model is used rather than its joints.
  */
 class AnimationController
 {
     friend class Game;
+    friend class World;
     friend class Animation;
     friend class AnimationClip;
     friend class SceneLoader;
@@ -25,6 +37,59 @@ public:
      * Stops all AnimationClips currently playing on the AnimationController.
      */
     void stopAllAnimations();
+
+    /**
+     * Sets the projected size below which clips are updated at the reduced rate
+     * set with setLodUpdateInterval.
+     *
+     * The size is the diameter of the bounding sphere of the animated node as a
+     * fraction of the height of the view of the active camera. The default of zero
+     * updates visible clips every frame regardless of their size.
+     *
+     * @param screenSize The projected size, between 0.0 and 1.0.
+     */
+    void setLodScreenSize(float screenSize);
+
+    /**
+     * Returns the projected size below which clips are updated at a reduced rate.
+     *
+     * @return The projected size.
+     */
+    float getLodScreenSize() const;
+
+    /**
+     * Sets the time between updates of clips that animate nodes that are smaller
+     * on screen than the size set with setLodScreenSize.
+     *
+     * @param interval The time between updates, in milliseconds.
+     */
+    void setLodUpdateInterval(float interval);
+
+    /**
+     * Returns the time between updates of clips that animate small nodes.
+     *
+     * @return The time between updates, in milliseconds.
+     */
+    float getLodUpdateInterval() const;
+
+    /**
+     * Sets the time between updates of clips that animate nodes that are outside
+     * the view frustum of the active camera of their scene.
+     *
+     * The default of zero updates these clips every frame. A negative interval does
+     * not update the clips at all until their node is visible again, at which point
+     * they catch up with all the time that passed.
+     *
+     * @param interval The time between updates, in milliseconds.
+     */
+    void setOffscreenUpdateInterval(float interval);
+
+    /**
+     * Returns the time between updates of clips that animate nodes outside the view frustum.
+     *
+     * @return The time between updates, in milliseconds.
+     */
+    float getOffscreenUpdateInterval() const;
        
 private:
 
@@ -95,9 +160,53 @@ private:
      * Callback for when the controller receives a frame update event.
      */
     void update(float elapsedTime);
-    
+
+    /**
+     * Returns the time between updates of the given clip under the level of detail
+     * policy, or zero if it is updated every frame.
+     */
+    float getUpdateInterval(AnimationClip* clip) const;
+
+    /**
+     * Blends the value of a channel evaluated by a running clip into the pose.
+     */
+    void blend(Animation::Channel* channel, AnimationValue* value, float blendWeight);
+
+    /**
+     * Returns the slot of the pose for the target property of the given channel.
+     */
+    unsigned int getPoseSlot(Animation::Channel* channel);
+
+    /**
+     * Removes all slots from the pose.
+     */
+    void clearPose();
+
+    /**
+     * A target property in the pose, with the value blended from all clips that drive it.
+     */
+    struct PoseSlot
+    {
+        AnimationTarget* target;
+        int propertyId;
+        int quaternionOffset;           // Offset of the rotation components of the value, or -1.
+        unsigned int frame;             // The update that the value was last written in.
+        unsigned int clipCount;         // The number of clips that wrote the value in that update.
+        float blendWeight;              // The weight to apply the value with.
+        AnimationValue* value;
+    };
+
     State _state;                                 // The current state of the AnimationController.
-    std::list<AnimationClip*> _runningClips;      // A list of running AnimationClips.
+    std::vector<AnimationClip*> _runningClips;    // The running AnimationClips, in the order they are blended.
+    std::vector<PoseSlot> _pose;                  // The evaluated target properties of the current update.
+    std::map<std::pair<AnimationTarget*, int>, unsigned int> _poseSlots; // The pose slot of each target property.
+    unsigned int _poseGeneration;                 // Incremented whenever the pose is cleared.
+    unsigned int _frame;                          // The number of updates.
+    bool _poseDirty;                              // Whether the running clips changed since the pose was built.
+    bool _updating;                               // Whether the running clips are being updated.
+    float _lodScreenSize;                         // The projected size below which clips are updated at a reduced rate.
+    float _lodUpdateInterval;                     // The time between updates of clips that animate small nodes.
+    float _offscreenUpdateInterval;               // The time between updates of clips that animate nodes outside the view.
 };
 
 }
@@ -19,6 +19,8 @@ class AnimationTarget
 {
     friend class Animation;
     friend class AnimationClip;
+    friend class AnimationController;
+    friend class SceneSnapshot;
 
 public:
 
@@ -0,0 +1,563 @@
+#include "Base.h"
+#include "AssetLoader.h"
+#include "AudioSource.h"
+#include "Bundle.h"
+#include "Effect.h"
+#include "FileSystem.h"
+#include "Game.h"
+#include "Image.h"
+#include "Properties.h"
+#include "Scene.h"
+#include "SceneLoader.h"
+#include "Texture.h"
+
+// The default time in milliseconds that each frame may spend creating assets.
+#define ASSET_LOADER_TIME_BUDGET 4.0f
+
+namespace gameplay
+{
+
+// Returns the namespace of a properties file that holds a single object, like scene and audio files.
+static Properties* getRootNamespace(Properties* properties)
+{
+    GP_ASSERT(properties);
+    return (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
+}
+
+AssetLoader::AssetLoader()
+    : _timeBudget(ASSET_LOADER_TIME_BUDGET)
+{
+}
+
+AssetLoader::~AssetLoader()
+{
+}
+
+void AssetLoader::initialize()
+{
+}
+
+void AssetLoader::finalize()
+{
+    // Workers may still be decoding, so every request is waited for before it is released.
+    JobController* jobs = Game::getInstance()->getJobController();
+    for (size_t i = 0, count = _requests.size(); i < count; ++i)
+    {
+        jobs->wait(&_requests[i]->_group);
+        SAFE_RELEASE(_requests[i]);
+    }
+    _requests.clear();
+}
+
+AssetLoader::Request* AssetLoader::load(const char* path, Type type)
+{
+    GP_ASSERT(path);
+
+    if (type == UNKNOWN)
+    {
+        std::string ext = FileSystem::getExtension(path);
+        if (ext == ".PNG" || ext == ".DDS" || ext == ".PVR" || ext == ".KTX")
+            type = TEXTURE;
+        else if (ext == ".WAV" || ext == ".OGG" || ext == ".AUDIO")
+            type = AUDIO_SOURCE;
+        else if (ext == ".SCENE" || ext == ".GPB")
+            type = SCENE;
+        else
+            type = PROPERTIES;
+    }
+    if (type == EFFECT)
+    {
+        GP_WARN("Effects must be loaded with AssetLoader::loadEffect: %s", path);
+        return NULL;
+    }
+
+    return submit(new Request(type, path));
+}
+
+AssetLoader::Request* AssetLoader::loadTexture(const char* path, bool generateMipmaps)
+{
+    GP_ASSERT(path);
+
+    Request* request = new Request(TEXTURE, path);
+    request->_generateMipmaps = generateMipmaps;
+    return submit(request);
+}
+
+AssetLoader::Request* AssetLoader::loadEffect(const char* vshPath, const char* fshPath, const char* defines)
+{
+    GP_ASSERT(vshPath);
+    GP_ASSERT(fshPath);
+
+    Request* request = new Request(EFFECT, vshPath);
+    request->_fshPath = fshPath;
+    if (defines)
+        request->_defines = defines;
+    return submit(request);
+}
+
+AssetLoader::Request* AssetLoader::loadNode(Bundle* bundle, const char* id)
+{
+    GP_ASSERT(bundle);
+    GP_ASSERT(id);
+
+    Request* request = new Request(NODE, id);
+    request->_bundle = bundle;
+    bundle->addRef();
+    return submit(request);
+}
+
+AssetLoader::Request* AssetLoader::loadMesh(Bundle* bundle, const char* id)
+{
+    GP_ASSERT(bundle);
+    GP_ASSERT(id);
+
+    Request* request = new Request(MESH, id);
+    request->_bundle = bundle;
+    bundle->addRef();
+    return submit(request);
+}
+
+AssetLoader::Request* AssetLoader::submit(Request* request)
+{
+    GP_ASSERT(request);
+
+    // The loader keeps a reference until the request has completed and notified its callbacks.
+    request->addRef();
+    _requests.push_back(request);
+    Game::getInstance()->getJobController()->submit(&request->_job, &request->_group);
+    return request;
+}
+
+void AssetLoader::finish(Request* request)
+{
+    GP_ASSERT(request);
+
+    if (request->_state == Request::LOADING)
+    {
+        Game::getInstance()->getJobController()->wait(&request->_group);
+        request->create(FLT_MAX);
+    }
+
+    // The request stays queued until the next update releases it, since this may be called from a callback.
+    request->notify();
+}
+
+unsigned int AssetLoader::getPendingCount() const
+{
+    unsigned int count = 0;
+    for (size_t i = 0, size = _requests.size(); i < size; ++i)
+    {
+        if (_requests[i] && _requests[i]->_state == Request::LOADING)
+            ++count;
+    }
+    return count;
+}
+
+void AssetLoader::setTimeBudget(float milliseconds)
+{
+    _timeBudget = milliseconds;
+}
+
+float AssetLoader::getTimeBudget() const
+{
+    return _timeBudget;
+}
+
+void AssetLoader::update()
+{
+    if (_requests.empty())
+        return;
+
+    GP_PROFILE("AssetLoader::update");
+
+    double start = Game::getAbsoluteTime();
+    bool created = false;
+    size_t kept = 0;
+    size_t count = _requests.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        Request* request = _requests[i];
+        if (request->_state == Request::LOADING)
+        {
+            // Requests wait for their files, and for the budget of the next frame once this
+            // one's is used up, but always create at least one asset per frame.
+            float elapsed = (float)(Game::getAbsoluteTime() - start);
+            bool overBudget = created && elapsed >= _timeBudget;
+            if (overBudget || !request->_group.isComplete())
+            {
+                _requests[kept++] = request;
+                continue;
+            }
+
+            // Scenes that need more time continue with the budget of the next frame.
+            bool complete = request->create(std::max(_timeBudget - elapsed, 0.0f));
+            created = true;
+            if (!complete)
+            {
+                _requests[kept++] = request;
+                continue;
+            }
+        }
+
+        // Callbacks may load more requests, which are appended and only picked up in the next
+        // frame, or set another callback on their request, which then stays for another frame.
+        _requests[i] = NULL;
+        request->notify();
+        if (request->_callback || !request->_function.empty())
+            _requests[kept++] = request;
+        else
+            request->release();
+    }
+
+    _requests.erase(_requests.begin() + kept, _requests.begin() + count);
+}
+
+AssetLoader::Request::DecodeJob::DecodeJob(Request* request)
+    : _request(request)
+{
+}
+
+void AssetLoader::Request::DecodeJob::execute(unsigned int worker)
+{
+    _request->decode();
+}
+
+AssetLoader::Request::Request(Type type, const char* path)
+    : _type(type), _path(path), _generateMipmaps(false), _state(LOADING), _job(this), _image(NULL), _soundDecoded(false),
+      _properties(NULL), _sceneLoader(NULL), _bundle(NULL), _preloaded(false), _asset(NULL)
+{
+}
+
+AssetLoader::Request::~Request()
+{
+    SAFE_RELEASE(_image);
+    SAFE_DELETE(_properties);
+    SAFE_DELETE(_sceneLoader);
+    SAFE_RELEASE(_bundle);
+    SAFE_RELEASE(_asset);
+    for (size_t i = 0, count = _soundBuffers.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_soundBuffers[i]);
+    }
+}
+
+AssetLoader::Type AssetLoader::Request::getType() const
+{
+    return _type;
+}
+
+const char* AssetLoader::Request::getPath() const
+{
+    return _path.c_str();
+}
+
+AssetLoader::Request::State AssetLoader::Request::getState() const
+{
+    return (State)_state.load();
+}
+
+bool AssetLoader::Request::isComplete() const
+{
+    return _state != LOADING;
+}
+
+float AssetLoader::Request::getProgress() const
+{
+    if (isComplete())
+        return 1.0f;
+    return _sceneLoader ? _sceneLoader->getProgress() : 0.0f;
+}
+
+Texture* AssetLoader::Request::getTexture() const
+{
+    return _type == TEXTURE && _state == COMPLETE ? static_cast<Texture*>(_asset) : NULL;
+}
+
+Effect* AssetLoader::Request::getEffect() const
+{
+    return _type == EFFECT && _state == COMPLETE ? static_cast<Effect*>(_asset) : NULL;
+}
+
+AudioSource* AssetLoader::Request::getAudioSource() const
+{
+    return _type == AUDIO_SOURCE && _state == COMPLETE ? static_cast<AudioSource*>(_asset) : NULL;
+}
+
+Scene* AssetLoader::Request::getScene() const
+{
+    return _type == SCENE && _state == COMPLETE ? static_cast<Scene*>(_asset) : NULL;
+}
+
+Properties* AssetLoader::Request::getProperties() const
+{
+    return _type == PROPERTIES && _state == COMPLETE ? _properties : NULL;
+}
+
+Node* AssetLoader::Request::getNode() const
+{
+    return _type == NODE && _state == COMPLETE ? static_cast<Node*>(_asset) : NULL;
+}
+
+Mesh* AssetLoader::Request::getMesh() const
+{
+    return _type == MESH && _state == COMPLETE ? static_cast<Mesh*>(_asset) : NULL;
+}
+
+unsigned int AssetLoader::Request::getSoundCount() const
+{
+    if (_type != SOUND_BANK || _state != COMPLETE)
+        return 0;
+
+    return (unsigned int)_soundBuffers.size();
+}
+
+void AssetLoader::Request::setCallback(const std::function<void(Request*)>& callback)
+{
+    _callback = callback;
+
+    // Completed requests have left the loader, which takes them back to call the new callback.
+    AssetLoader* loader = Game::getInstance()->getAssetLoader();
+    if (isComplete() && std::find(loader->_requests.begin(), loader->_requests.end(), this) == loader->_requests.end())
+    {
+        addRef();
+        loader->_requests.push_back(this);
+    }
+}
+
+void AssetLoader::Request::setCallback(const char* function)
+{
+    _function = function ? function : "";
+
+    AssetLoader* loader = Game::getInstance()->getAssetLoader();
+    if (isComplete() && std::find(loader->_requests.begin(), loader->_requests.end(), this) == loader->_requests.end())
+    {
+        addRef();
+        loader->_requests.push_back(this);
+    }
+}
+
+void AssetLoader::Request::decode()
+{
+    const char* path = _path.c_str();
+    switch (_type)
+    {
+    case TEXTURE:
+        // Compressed textures are uploaded as they are read, so only their file is prefetched.
+        if (FileSystem::getExtension(path) == ".PNG")
+            _image = Image::create(path);
+        else
+            FileSystem::prefetch(path);
+        break;
+
+    case EFFECT:
+        {
+            char* source = FileSystem::readAll(path);
+            if (source)
+                _vshSource = source;
+            SAFE_DELETE_ARRAY(source);
+            source = FileSystem::readAll(_fshPath.c_str());
+            if (source)
+                _fshSource = source;
+            SAFE_DELETE_ARRAY(source);
+        }
+        break;
+
+    case AUDIO_SOURCE:
+        if (FileSystem::getExtension(path) == ".AUDIO")
+        {
+            // Streamed sounds are decoded as they play, so only their file is prefetched.
+            _properties = Properties::create(path);
+            Properties* audio = _properties ? getRootNamespace(_properties) : NULL;
+            if (audio && audio->getPath("path", &_soundPath))
+            {
+                if (audio->exists("streamed") && audio->getBool("streamed"))
+                    FileSystem::prefetch(_soundPath.c_str());
+                else
+                    _soundDecoded = AudioBuffer::decode(_soundPath.c_str(), &_sound);
+            }
+        }
+        else
+        {
+            _soundPath = _path;
+            _soundDecoded = AudioBuffer::decode(path, &_sound);
+        }
+        break;
+
+    case SCENE:
+        if (FileSystem::getExtension(path) == ".GPB")
+        {
+            FileSystem::prefetch(path);
+        }
+        else
+        {
+            _properties = Properties::create(path);
+            Properties* scene = _properties ? getRootNamespace(_properties) : NULL;
+            std::string bundlePath;
+            if (scene && scene->getPath("path", &bundlePath))
+                FileSystem::prefetch(bundlePath.c_str());
+        }
+        break;
+
+    case PROPERTIES:
+        _properties = Properties::create(path);
+        break;
+
+    case NODE:
+        _preloaded = _bundle->preloadNode(path);
+        break;
+
+    case MESH:
+        _preloaded = _bundle->preloadMesh(path);
+        break;
+
+    case SOUND_BANK:
+        {
+            _properties = Properties::create(path);
+            Properties* bank = _properties ? getRootNamespace(_properties) : NULL;
+            const char* name;
+            while (bank && (name = bank->getNextProperty()) != NULL)
+            {
+                std::string soundPath;
+                if (!bank->getPath(name, &soundPath))
+                {
+                    GP_WARN("Sound '%s' of sound bank '%s' has no valid path.", name, path);
+                    continue;
+                }
+
+                // Audio files name the sound they play, and streamed ones are decoded as they play.
+                if (FileSystem::getExtension(soundPath.c_str()) == ".AUDIO")
+                {
+                    std::unique_ptr<Properties> properties(Properties::create(soundPath.c_str()));
+                    Properties* audio = properties.get() ? getRootNamespace(properties.get()) : NULL;
+                    if (!audio || !audio->getPath("path", &soundPath) || (audio->exists("streamed") && audio->getBool("streamed")))
+                        continue;
+                }
+
+                _soundPaths.push_back(soundPath);
+                _sounds.push_back(AudioBuffer::DecodedData());
+                if (!AudioBuffer::decode(soundPath.c_str(), &_sounds.back()))
+                {
+                    _soundPaths.pop_back();
+                    _sounds.pop_back();
+                }
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+}
+
+bool AssetLoader::Request::create(float milliseconds)
+{
+    GP_ASSERT(_state == LOADING);
+
+    const char* path = _path.c_str();
+    switch (_type)
+    {
+    case TEXTURE:
+        _asset = Texture::createCached(path, _image, _generateMipmaps);
+        SAFE_RELEASE(_image);
+        break;
+
+    case EFFECT:
+        if (_vshSource.empty() || _fshSource.empty())
+            GP_WARN("Failed to read shaders '%s', '%s'.", path, _fshPath.c_str());
+        else
+            _asset = Effect::createCached(path, _fshPath.c_str(), _defines.empty() ? NULL : _defines.c_str(), _vshSource.c_str(), _fshSource.c_str());
+        break;
+
+    case AUDIO_SOURCE:
+        {
+            // Once the decoded sound is in the buffer cache, creating the source finds it there.
+            AudioBuffer* buffer = _soundDecoded ? AudioBuffer::createCached(_soundPath.c_str(), _sound) : NULL;
+            if (_properties)
+                _asset = AudioSource::create(getRootNamespace(_properties));
+            else if (_soundDecoded)
+                _asset = AudioSource::create(path);
+            SAFE_RELEASE(buffer);
+            _sound.data.clear();
+            SAFE_DELETE(_properties);
+        }
+        break;
+
+    case SCENE:
+        if (FileSystem::getExtension(path) == ".GPB")
+        {
+            _asset = Scene::load(path);
+        }
+        else if (_properties || _sceneLoader)
+        {
+            // The scene loader takes over the parsed properties.
+            if (!_sceneLoader)
+            {
+                _sceneLoader = SceneLoader::create(path, _properties);
+                _properties = NULL;
+            }
+            if (!_sceneLoader->update(milliseconds))
+                return false;
+
+            _asset = _sceneLoader->getScene();
+            if (_asset)
+                _asset->addRef();
+            SAFE_DELETE(_sceneLoader);
+        }
+        break;
+
+    case NODE:
+        if (_preloaded)
+            _asset = _bundle->loadNode(path);
+        break;
+
+    case MESH:
+        if (_preloaded)
+            _asset = _bundle->loadMesh(path);
+        break;
+
+    case SOUND_BANK:
+        {
+            // A bank can hold many sounds, so their buffers are created within the time budget.
+            double start = Game::getAbsoluteTime();
+            while (_soundBuffers.size() < _sounds.size())
+            {
+                size_t i = _soundBuffers.size();
+                _soundBuffers.push_back(AudioBuffer::createCached(_soundPaths[i].c_str(), _sounds[i]));
+                std::vector<char>().swap(_sounds[i].data);
+                if (_soundBuffers.size() < _sounds.size() && Game::getAbsoluteTime() - start >= milliseconds)
+                    return false;
+            }
+            _soundBuffers.erase(std::remove(_soundBuffers.begin(), _soundBuffers.end(), (AudioBuffer*)NULL), _soundBuffers.end());
+            _sounds.clear();
+            SAFE_DELETE(_properties);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    bool loaded = _type == PROPERTIES ? _properties != NULL : _type == SOUND_BANK ? !_soundBuffers.empty() : _asset != NULL;
+    if (!loaded)
+        GP_WARN("Failed to load asset '%s'.", path);
+    _state = loaded ? COMPLETE : FAILED;
+    return true;
+}
+
+void AssetLoader::Request::notify()
+{
+    if (_callback)
+    {
+        std::function<void(Request*)> callback = _callback;
+        _callback = nullptr;
+        callback(this);
+    }
+    if (!_function.empty())
+    {
+        std::string function = _function;
+        _function.clear();
+        Game::getInstance()->getScriptController()->executeFunction<void>(function.c_str(), "<AssetLoader::Request>", NULL, this);
+    }
+}
+
+}
@@ -0,0 +1,447 @@
+#ifndef ASSETLOADER_H_
+#define ASSETLOADER_H_
+
+#include "Ref.h"
+#include "JobController.h"
+#include "AudioBuffer.h"
+
+namespace gameplay
+{
+
+class AudioSource;
+class Bundle;
+class Effect;
+class Image;
+class Mesh;
+class Node;
+class Properties;
+class Scene;
+class SceneLoader;
+class Texture;
+
+/**
+ * Defines a service that loads assets in the background while the game keeps running.
+ *
+ * Loading an asset is split into two stages. The first stage reads the files of the asset
+ * and decodes them on a worker thread of the job controller: images are decoded from PNG,
+ * sounds from WAV or OGG, shader sources are read, properties and scene files are parsed,
+ * and bundles are paged into memory so that loading them later doesn't wait for the disk.
+ * Nodes and meshes of an open bundle have their mesh data read on the worker.
+ * The second stage creates the OpenGL and OpenAL objects of the asset on the main thread,
+ * which includes parsing bundles, since they create meshes while they are read. Scene files
+ * are created incrementally with a SceneLoader, over as many frames as they need.
+ * At the start of each frame, the loader finishes the assets whose first stage has
+ * completed, in the order they were requested, for at most the time budget of the frame,
+ * so that loading a level doesn't stall the frames drawn meanwhile.
+ *
+ * Each load returns a request that completes once the asset has been created, or has failed
+ * to load. Requests can be polled, or be given a callback that is called on the main thread
+ * when they complete. Assets that are already cached, such as textures and effects that were
+ * loaded before, are returned from their cache like their synchronous create methods would.
+ *
+ * Sound banks decode the sound effects of a level ahead of time, so that the audio sources
+ * created from them later find their buffers in the cache instead of decoding them when they
+ * are first played. A sound bank is a properties file whose values are the paths of the sounds,
+ * or of .audio files, to decode, and is loaded with the SOUND_BANK type:
+ *
+ * \code
+ * sounds weapons
+ * {
+ *     rifle = res/sfx/rifle.ogg
+ *     reload = res/sfx/reload.wav
+ *     explosion = res/sfx/explosion.audio
+ * }
+ * \endcode
+ *
+ * The request holds its sounds until it is released. From then on, the sounds that no source
+ * uses stay cached while the audio buffers fit their budget in the ResourceManager, and those
+ * that sources were least recently created from are unloaded first.
+ *
+ * \code
+ * AssetLoader::Request* request = getAssetLoader()->load("res/level.scene");
+ * request->setCallback([this](AssetLoader::Request* request)
+ * {
+ *     _scene = request->getScene();
+ *     _scene->addRef();
+ * });
+ * request->release();
+ * \endcode
+ */
+class AssetLoader
+{
+    friend class Game;
+
+public:
+
+    /**
+     * The types of assets that can be loaded.
+     */
+    enum Type
+    {
+        UNKNOWN,
+        TEXTURE,
+        EFFECT,
+        AUDIO_SOURCE,
+        SCENE,
+        PROPERTIES,
+        NODE,
+        MESH,
+        SOUND_BANK
+    };
+
+    /**
+     * Defines the request to load an asset, which is a handle to the asset once it completes.
+     */
+    class Request : public Ref
+    {
+        friend class AssetLoader;
+
+    public:
+
+        /**
+         * The states of a request.
+         */
+        enum State
+        {
+            LOADING,
+            COMPLETE,
+            FAILED
+        };
+
+        /**
+         * Returns the type of asset the request loads.
+         *
+         * @return The type of asset.
+         */
+        Type getType() const;
+
+        /**
+         * Returns the path of the asset, which is the path of the vertex shader for effects
+         * and the ID of the object in its bundle for nodes and meshes.
+         *
+         * @return The path of the asset.
+         */
+        const char* getPath() const;
+
+        /**
+         * Returns the state of the request.
+         *
+         * @return The state of the request.
+         */
+        State getState() const;
+
+        /**
+         * Determines if the request has completed, whether or not the asset was loaded.
+         *
+         * @return true if the request has completed or failed, false while it is still loading.
+         */
+        bool isComplete() const;
+
+        /**
+         * Returns the progress of the request, which goes up in steps while a scene file
+         * is created incrementally and otherwise jumps to 1 once the request completes.
+         *
+         * @return The progress between 0 and 1.
+         */
+        float getProgress() const;
+
+        /**
+         * Returns the loaded texture, which is owned by the request.
+         *
+         * @return The texture, or NULL if the request hasn't completed or doesn't load a texture.
+         */
+        Texture* getTexture() const;
+
+        /**
+         * Returns the loaded effect, which is owned by the request.
+         *
+         * @return The effect, or NULL if the request hasn't completed or doesn't load an effect.
+         */
+        Effect* getEffect() const;
+
+        /**
+         * Returns the loaded audio source, which is owned by the request.
+         *
+         * @return The audio source, or NULL if the request hasn't completed or doesn't load an audio source.
+         */
+        AudioSource* getAudioSource() const;
+
+        /**
+         * Returns the loaded scene, which is owned by the request.
+         *
+         * @return The scene, or NULL if the request hasn't completed or doesn't load a scene.
+         */
+        Scene* getScene() const;
+
+        /**
+         * Returns the loaded properties, which are owned by the request.
+         *
+         * @return The properties, or NULL if the request hasn't completed or doesn't load properties.
+         */
+        Properties* getProperties() const;
+
+        /**
+         * Returns the loaded node, which is owned by the request.
+         *
+         * @return The node, or NULL if the request hasn't completed or doesn't load a node.
+         */
+        Node* getNode() const;
+
+        /**
+         * Returns the loaded mesh, which is owned by the request.
+         *
+         * @return The mesh, or NULL if the request hasn't completed or doesn't load a mesh.
+         */
+        Mesh* getMesh() const;
+
+        /**
+         * Returns the number of sounds of a sound bank that were decoded and cached.
+         *
+         * @return The number of sounds, or zero if the request hasn't completed or doesn't load a sound bank.
+         */
+        unsigned int getSoundCount() const;
+
+        /**
+         * Sets the function called on the main thread when the request completes or fails.
+         *
+         * The function is called during the next update of the loader if the request has
+         * already completed.
+         *
+         * @param callback The function to call with the request.
+         * @script{ignore}
+         */
+        void setCallback(const std::function<void(Request*)>& callback);
+
+        /**
+         * Sets the global script function called on the main thread when the request completes or fails.
+         *
+         * The function is called with the request as its only argument.
+         *
+         * @param function The name of the script function to call.
+         */
+        void setCallback(const char* function);
+
+    private:
+
+        /**
+         * Runs the first stage of the request on a worker thread.
+         */
+        class DecodeJob : public JobController::Job
+        {
+        public:
+            DecodeJob(Request* request);
+            void execute(unsigned int worker);
+        private:
+            Request* _request;
+        };
+
+        /**
+         * Constructor.
+         */
+        Request(Type type, const char* path);
+
+        /**
+         * Destructor.
+         */
+        ~Request();
+
+        /**
+         * Hidden copy constructor.
+         */
+        Request(const Request&);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Request& operator=(const Request&);
+
+        /**
+         * Reads and decodes the files of the asset on a worker thread.
+         */
+        void decode();
+
+        /**
+         * Creates the asset from the decoded data on the main thread, for at most the given
+         * time if it is created incrementally, and for at least one step.
+         *
+         * @return true if the request is complete, false if it needs more time.
+         */
+        bool create(float milliseconds);
+
+        /**
+         * Calls the callbacks of the request and clears them.
+         */
+        void notify();
+
+        Type _type;
+        std::string _path;
+        std::string _fshPath;
+        std::string _defines;
+        bool _generateMipmaps;
+        std::atomic<int> _state;
+        JobController::Group _group;
+        DecodeJob _job;
+        Image* _image;
+        std::string _vshSource;
+        std::string _fshSource;
+        std::string _soundPath;
+        AudioBuffer::DecodedData _sound;
+        bool _soundDecoded;
+        std::vector<std::string> _soundPaths;
+        std::vector<AudioBuffer::DecodedData> _sounds;
+        std::vector<AudioBuffer*> _soundBuffers;
+        Properties* _properties;
+        SceneLoader* _sceneLoader;
+        Bundle* _bundle;
+        bool _preloaded;
+        Ref* _asset;
+        std::function<void(Request*)> _callback;
+        std::string _function;
+    };
+
+    /**
+     * Starts loading the asset at the given path.
+     *
+     * Textures, sounds, scenes and bundles are recognized by the extension of the path
+     * and every other file is loaded as properties. Bundles are loaded as scenes.
+     *
+     * @param path The path of the asset.
+     * @param type The type of the asset, or UNKNOWN to determine it from the extension.
+     *
+     * @return The new request, which the caller must release.
+     * @script{create}
+     */
+    Request* load(const char* path, Type type = UNKNOWN);
+
+    /**
+     * Starts loading the texture at the given path.
+     *
+     * @param path The path of the texture file.
+     * @param generateMipmaps true to auto-generate a full mipmap chain, false otherwise.
+     *
+     * @return The new request, which the caller must release.
+     * @script{create}
+     */
+    Request* loadTexture(const char* path, bool generateMipmaps = false);
+
+    /**
+     * Starts loading the effect with the given shader files.
+     *
+     * @param vshPath The path to the vertex shader file.
+     * @param fshPath The path to the fragment shader file.
+     * @param defines A new-line delimited list of preprocessor defines.
+     *
+     * @return The new request, which the caller must release.
+     * @script{create}
+     */
+    Request* loadEffect(const char* vshPath, const char* fshPath, const char* defines = NULL);
+
+    /**
+     * Starts loading the node with the given ID from an open bundle, such as a part of a
+     * level that the camera approaches.
+     *
+     * The mesh data of the node and its children is read on a worker thread, and the node is
+     * created with Bundle::loadNode on the main thread. The request keeps a reference to the bundle.
+     *
+     * @param bundle The bundle that holds the node.
+     * @param id The ID of the node in the bundle.
+     *
+     * @return The new request, which the caller must release.
+     * @script{create}
+     */
+    Request* loadNode(Bundle* bundle, const char* id);
+
+    /**
+     * Starts loading the mesh with the given ID from an open bundle.
+     *
+     * The mesh data is read on a worker thread, and the mesh is created with Bundle::loadMesh
+     * on the main thread. The request keeps a reference to the bundle.
+     *
+     * @param bundle The bundle that holds the mesh.
+     * @param id The ID of the mesh in the bundle.
+     *
+     * @return The new request, which the caller must release.
+     * @script{create}
+     */
+    Request* loadMesh(Bundle* bundle, const char* id);
+
+    /**
+     * Completes the given request on the calling thread, which must be the main thread,
+     * without waiting for the time budget of later frames.
+     *
+     * @param request The request to complete.
+     */
+    void finish(Request* request);
+
+    /**
+     * Returns the number of requests that have not completed yet.
+     *
+     * @return The number of pending requests.
+     */
+    unsigned int getPendingCount() const;
+
+    /**
+     * Sets the time in milliseconds that each frame may spend creating the assets of completed requests.
+     *
+     * At least one asset is created per frame, however long it takes.
+     *
+     * @param milliseconds The time budget per frame.
+     */
+    void setTimeBudget(float milliseconds);
+
+    /**
+     * Returns the time in milliseconds that each frame may spend creating the assets of completed requests.
+     *
+     * @return The time budget per frame.
+     */
+    float getTimeBudget() const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    AssetLoader();
+
+    /**
+     * Destructor.
+     */
+    ~AssetLoader();
+
+    /**
+     * Hidden copy constructor.
+     */
+    AssetLoader(const AssetLoader&);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    AssetLoader& operator=(const AssetLoader&);
+
+    /**
+     * Called during startup to initialize the loader.
+     */
+    void initialize();
+
+    /**
+     * Called during shutdown to wait for the pending requests and release them.
+     */
+    void finalize();
+
+    /**
+     * Called once per frame to create the assets of the requests whose files have been decoded.
+     */
+    void update();
+
+    /**
+     * Queues the given request and submits its first stage to the job controller.
+     */
+    Request* submit(Request* request);
+
+    std::vector<Request*> _requests;
+    float _timeBudget;
+};
+
+}
+
+#endif
@@ -1,12 +1,19 @@
 #include "Base.h"
 #include "AudioBuffer.h"
 #include "FileSystem.h"
+#include "ResourceManager.h"
+#include "MemoryTracker.h"
 
 namespace gameplay
 {
 
-// Audio buffer cache
-static std::vector<AudioBuffer*> __buffers;
+// Returns the size of the sound data held by an OpenAL buffer.
+static size_t getMemorySize(ALuint buffer)
+{
+    ALint size = 0;
+    AL_CHECK(alGetBufferi(buffer, AL_SIZE, &size));
+    return size > 0 ? (size_t)size : 0;
+}
 
 // Callbacks for loading an ogg file using Stream
 static size_t readStream(void* ptr, size_t size, size_t nmemb, void* datasource)
@@ -39,29 +46,28 @@ static long tellStream(void* datasource)
 }
 
 AudioBuffer::AudioBuffer(const char* path, ALuint* buffer, bool streamed)
-: _filePath(path), _streamed(streamed), _buffersNeededCount(0)
+: _filePath(path), _streamed(streamed), _memorySize(0), _buffersNeededCount(0), _streamRead(0), _streamWrite(0), _streamEnded(false)
 {
     memcpy(_alBufferQueue, buffer, sizeof(_alBufferQueue));
+    memset(_streamBlockSizes, 0, sizeof(_streamBlockSizes));
+    if (streamed)
+    {
+        _streamBlocks.reset(new char[STREAMING_RING_SIZE * STREAMING_BUFFER_SIZE]);
+
+        // The queued buffers are refilled with blocks of up to the same size.
+        _memorySize = (STREAMING_RING_SIZE + STREAMING_BUFFER_QUEUE_SIZE) * STREAMING_BUFFER_SIZE;
+    }
+    else
+    {
+        // The data of a buffer that isn't streamed is loaded before it is created.
+        _memorySize = getMemorySize(_alBufferQueue[0]);
+    }
+    MemoryTracker::add(MemoryTracker::AUDIO, _memorySize);
 }
 
 AudioBuffer::~AudioBuffer()
 {
-    // Remove the buffer from the cache.
-    unsigned int bufferCount = (unsigned int)__buffers.size();
-
-    if (!_streamed)
-    {
-        unsigned int bufferCount = (unsigned int)__buffers.size();
-        for (unsigned int i = 0; i < bufferCount; i++)
-        {
-            if (this == __buffers[i])
-            {
-                __buffers.erase(__buffers.begin() + i);
-                break;
-            }
-        }
-    }
-    else if (_streamStateOgg.get())
+    if (_streamed && _streamStateOgg.get())
     {
         ov_clear(&_streamStateOgg->oggFile);
     }
@@ -74,26 +80,20 @@ AudioBuffer::~AudioBuffer()
             _alBufferQueue[i] = 0;
         }
     }
+    MemoryTracker::remove(MemoryTracker::AUDIO, _memorySize);
 }
 
 AudioBuffer* AudioBuffer::create(const char* path, bool streamed)
 {
     GP_ASSERT(path);
 
+    // Streamed buffers hold the playback position of their source, so only the others are shared.
     AudioBuffer* buffer = NULL;
     if (!streamed)
     {
-        unsigned int bufferCount = (unsigned int)__buffers.size();
-        for (unsigned int i = 0; i < bufferCount; i++)
-        {
-            buffer = __buffers[i];
-            GP_ASSERT(buffer);
-            if (buffer->_filePath.compare(path) == 0)
-            {
-                buffer->addRef();
-                return buffer;
-            }
-        }
+        buffer = static_cast<AudioBuffer*>(ResourceManager::find(ResourceManager::AUDIO_BUFFER, path));
+        if (buffer)
+            return buffer;
     }
     ALuint alBuffer[STREAMING_BUFFER_QUEUE_SIZE];
     memset(alBuffer, 0, sizeof(alBuffer));
@@ -169,7 +169,7 @@ AudioBuffer* AudioBuffer::create(const char* path, bool streamed)
         buffer->_buffersNeededCount = (buffer->_streamStateOgg->dataSize + STREAMING_BUFFER_SIZE - 1) / STREAMING_BUFFER_SIZE;
 
     if (!streamed)
-        __buffers.push_back(buffer);
+        ResourceManager::add(ResourceManager::AUDIO_BUFFER, path, buffer, getMemorySize(alBuffer[0]));
 
     return buffer;
     
@@ -182,7 +182,75 @@ cleanup:
     return NULL;
 }
 
-bool AudioBuffer::loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateWav* streamState)
+bool AudioBuffer::decode(const char* path, DecodedData* decoded)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(decoded);
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path));
+    if (stream.get() == NULL || !stream->canRead())
+    {
+        GP_WARN("Failed to load audio file %s.", path);
+        return false;
+    }
+
+    char header[12];
+    if (stream->read(header, 1, 12) != 12)
+    {
+        GP_WARN("Invalid header for audio file %s.", path);
+        return false;
+    }
+
+    if (memcmp(header, "RIFF", 4) == 0)
+    {
+        AudioStreamStateWav streamState;
+        if (!loadWav(stream.get(), 0, false, &streamState, decoded))
+        {
+            GP_WARN("Invalid wave file: %s", path);
+            return false;
+        }
+    }
+    else if (memcmp(header, "OggS", 4) == 0)
+    {
+        AudioStreamStateOgg streamState;
+        if (!loadOgg(stream.get(), 0, false, &streamState, decoded))
+        {
+            GP_WARN("Invalid ogg file: %s", path);
+            return false;
+        }
+    }
+    else
+    {
+        GP_WARN("Unsupported audio file: %s", path);
+        return false;
+    }
+    return true;
+}
+
+AudioBuffer* AudioBuffer::createCached(const char* path, const DecodedData& decoded)
+{
+    GP_ASSERT(path);
+
+    AudioBuffer* buffer = static_cast<AudioBuffer*>(ResourceManager::find(ResourceManager::AUDIO_BUFFER, path));
+    if (buffer)
+        return buffer;
+
+    ALuint alBuffer[STREAMING_BUFFER_QUEUE_SIZE];
+    memset(alBuffer, 0, sizeof(alBuffer));
+    AL_CHECK(alGenBuffers(1, &alBuffer[0]));
+    if (AL_LAST_ERROR())
+    {
+        GP_ERROR("Failed to create OpenAL buffer; alGenBuffers error: %d", AL_LAST_ERROR());
+        return NULL;
+    }
+    AL_CHECK(alBufferData(alBuffer[0], decoded.format, decoded.data.empty() ? NULL : &decoded.data[0], (ALsizei)decoded.data.size(), decoded.frequency));
+
+    buffer = new AudioBuffer(path, alBuffer, false);
+    ResourceManager::add(ResourceManager::AUDIO_BUFFER, path, buffer, decoded.data.size());
+    return buffer;
+}
+
+bool AudioBuffer::loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateWav* streamState, DecodedData* decoded)
 {
     GP_ASSERT(stream);
 
@@ -334,7 +402,16 @@ bool AudioBuffer::loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStr
                 return false;
             }
 
-            AL_CHECK( alBufferData(buffer, format, data, dataSize, frequency) );
+            if (decoded)
+            {
+                decoded->data.assign(data, data + dataSize);
+                decoded->format = format;
+                decoded->frequency = frequency;
+            }
+            else
+            {
+                AL_CHECK( alBufferData(buffer, format, data, dataSize, frequency) );
+            }
             SAFE_DELETE_ARRAY(data);
 
             // We've read the data, so return now.
@@ -381,7 +458,7 @@ bool AudioBuffer::loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStr
     return false;
 }
 
-bool AudioBuffer::loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateOgg* streamState)
+bool AudioBuffer::loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateOgg* streamState, DecodedData* decoded)
 {
     GP_ASSERT(stream);
 
@@ -456,7 +533,16 @@ bool AudioBuffer::loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStr
         return false;
     }
 
-    AL_CHECK(alBufferData(buffer, format, data, size, info->rate));
+    if (decoded)
+    {
+        decoded->data.assign(data, data + size);
+        decoded->format = format;
+        decoded->frequency = info->rate;
+    }
+    else
+    {
+        AL_CHECK(alBufferData(buffer, format, data, size, info->rate));
+    }
 
     SAFE_DELETE_ARRAY(data);
 
@@ -466,32 +552,32 @@ bool AudioBuffer::loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStr
     return true;
 }
 
-bool AudioBuffer::streamData(ALuint buffer, bool looped)
+bool AudioBuffer::decodeStreamData(bool looped)
 {
-    static char buffers[STREAMING_BUFFER_SIZE];
-    
+    // The writer owns the write index, and only reads the read index to know if there is room.
+    unsigned int write = _streamWrite.load(std::memory_order_relaxed);
+    if (write - _streamRead.load(std::memory_order_acquire) >= STREAMING_RING_SIZE || _streamEnded.load(std::memory_order_relaxed))
+        return false;
+
+    char* block = &_streamBlocks[(write % STREAMING_RING_SIZE) * STREAMING_BUFFER_SIZE];
+    ALsizei bytesRead = 0;
     if (_streamStateWav.get())
     {
-        ALsizei bytesRead = _fileStream->read(buffers, sizeof(char), STREAMING_BUFFER_SIZE);
+        bytesRead = (ALsizei)_fileStream->read(block, sizeof(char), STREAMING_BUFFER_SIZE);
         if (bytesRead != STREAMING_BUFFER_SIZE)
         {
             if (looped)
                 _fileStream->seek(_streamStateWav->dataStart, SEEK_SET);
         }
-        if (bytesRead > 0)
-            AL_CHECK(alBufferData(buffer, _streamStateWav->format, buffers, bytesRead, _streamStateWav->frequency));
-        
-        return bytesRead > 0 || looped;
     }
     else if (_streamStateOgg.get())
     {
         int section;
         int result = 0;
-        ALsizei bytesRead = 0;
 
         while (bytesRead < STREAMING_BUFFER_SIZE)
         {
-            result = ov_read(&_streamStateOgg->oggFile, buffers + bytesRead, STREAMING_BUFFER_SIZE - bytesRead, 0, 2, 1, &section);
+            result = ov_read(&_streamStateOgg->oggFile, block + bytesRead, STREAMING_BUFFER_SIZE - bytesRead, 0, 2, 1, &section);
             if (result > 0)
             {
                 bytesRead += result;
@@ -503,14 +589,45 @@ bool AudioBuffer::streamData(ALuint buffer, bool looped)
                 break;
             }
         }
+    }
 
-        if (bytesRead > 0)
-            AL_CHECK(alBufferData(buffer, _streamStateOgg->format, buffers, bytesRead, _streamStateOgg->frequency));
-        
-        return (bytesRead > 0) || looped;
+    if (bytesRead > 0)
+    {
+        _streamBlockSizes[write % STREAMING_RING_SIZE] = bytesRead;
+        _streamWrite.store(write + 1, std::memory_order_release);
+        return true;
     }
-    
+    if (!looped)
+        _streamEnded.store(true, std::memory_order_release);
     return false;
 }
 
+bool AudioBuffer::streamData(ALuint buffer)
+{
+    unsigned int read = _streamRead.load(std::memory_order_relaxed);
+    if (read == _streamWrite.load(std::memory_order_acquire))
+        return false;
+
+    const char* block = &_streamBlocks[(read % STREAMING_RING_SIZE) * STREAMING_BUFFER_SIZE];
+    ALsizei size = _streamBlockSizes[read % STREAMING_RING_SIZE];
+    if (_streamStateWav.get())
+        AL_CHECK(alBufferData(buffer, _streamStateWav->format, block, size, _streamStateWav->frequency));
+    else if (_streamStateOgg.get())
+        AL_CHECK(alBufferData(buffer, _streamStateOgg->format, block, size, _streamStateOgg->frequency));
+
+    // The block can be decoded into again once the read index has moved past it.
+    _streamRead.store(read + 1, std::memory_order_release);
+    return true;
+}
+
+bool AudioBuffer::hasStreamData() const
+{
+    return _streamRead.load(std::memory_order_relaxed) != _streamWrite.load(std::memory_order_acquire);
+}
+
+bool AudioBuffer::isStreamEnded() const
+{
+    return _streamEnded.load(std::memory_order_acquire) && !hasStreamData();
+}
+
 }
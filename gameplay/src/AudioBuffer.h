@@ -17,6 +17,8 @@ class AudioSource;
 class AudioBuffer : public Ref
 {
     friend class AudioSource;
+    friend class AudioController;
+    friend class AssetLoader;
 
 private:
     
@@ -61,22 +63,83 @@ private:
         OggVorbis_File oggFile;
     };
 
+    /**
+     * Sound data that was decoded from a file but not loaded into an OpenAL buffer yet.
+     */
+    struct DecodedData
+    {
+        std::vector<char> data;
+        ALuint format;
+        ALuint frequency;
+    };
+
     enum { STREAMING_BUFFER_QUEUE_SIZE = 3 };
     enum { STREAMING_BUFFER_SIZE = 48000 };
+    enum { STREAMING_RING_SIZE = 8 };
+
+    /**
+     * Decodes the entire sound file at the given path without calling into OpenAL, so
+     * that it can be done on any thread.
+     *
+     * @param path The path to the sound file.
+     * @param decoded The decoded sound data.
+     *
+     * @return true if the file was decoded.
+     */
+    static bool decode(const char* path, DecodedData* decoded);
+
+    /**
+     * Returns the cached buffer for the given path, or creates it from the decoded sound
+     * data and adds it to the cache.
+     */
+    static AudioBuffer* createCached(const char* path, const DecodedData& decoded);
 
-    static bool loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateWav* streamState);
+    static bool loadWav(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateWav* streamState, DecodedData* decoded = NULL);
     
-    static bool loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateOgg* streamState);
+    static bool loadOgg(Stream* stream, ALuint buffer, bool streamed, AudioStreamStateOgg* streamState, DecodedData* decoded = NULL);
+
+    /**
+     * Decodes the next block of a streamed buffer into its ring of decoded blocks, if the ring
+     * isn't full. Called by the decoding thread of the audio controller, which is the only one
+     * writing to the ring.
+     *
+     * @param looped Whether the stream starts over once it reaches its end.
+     *
+     * @return true if a block was decoded.
+     */
+    bool decodeStreamData(bool looped);
+
+    /**
+     * Loads the oldest decoded block of a streamed buffer into an OpenAL buffer. Called by the
+     * streaming thread of the audio controller, which is the only one reading from the ring.
+     *
+     * @return true if a block was loaded, false if none has been decoded yet.
+     */
+    bool streamData(ALuint buffer);
+
+    /**
+     * Returns whether a decoded block of a streamed buffer is ready to be loaded.
+     */
+    bool hasStreamData() const;
 
-    bool streamData(ALuint buffer, bool looped);
+    /**
+     * Returns whether every block of a streamed buffer that isn't looped has been loaded.
+     */
+    bool isStreamEnded() const;
 
     ALuint _alBufferQueue[STREAMING_BUFFER_QUEUE_SIZE];
     std::string _filePath;
     bool _streamed;
+    size_t _memorySize;
     std::unique_ptr<Stream> _fileStream;
     std::unique_ptr<AudioStreamStateWav> _streamStateWav;
     std::unique_ptr<AudioStreamStateOgg> _streamStateOgg;
     int _buffersNeededCount;
+    std::unique_ptr<char[]> _streamBlocks;
+    ALsizei _streamBlockSizes[STREAMING_RING_SIZE];
+    std::atomic<unsigned int> _streamRead;
+    std::atomic<unsigned int> _streamWrite;
+    std::atomic<bool> _streamEnded;
 };
 
 }
@@ -3,12 +3,62 @@
 #include "AudioListener.h"
 #include "AudioBuffer.h"
 #include "AudioSource.h"
+#include "Node.h"
+#include "Game.h"
+#include "ResourceManager.h"
+
+// The default number of voices that audio sources are played with.
+#define AUDIO_MAX_VOICES 32
+
+// The distance that a playing source must move before its position is updated, which is too small to be heard.
+#define AUDIO_POSITION_THRESHOLD 0.01f
+
+// The number of milliseconds between the refills of the queues of streamed sources.
+#define AUDIO_STREAMING_INTERVAL 10
+
+// The number of milliseconds that the decoding thread waits once the rings of every stream are full.
+#define AUDIO_DECODING_INTERVAL 20
 
 namespace gameplay
 {
 
+/**
+ * A playing audio source competing for a voice.
+ */
+struct AudioVoice
+{
+    AudioSource* source;
+    float distance;
+    bool audible;
+};
+
+static bool compareVoices(const AudioVoice& a, const AudioVoice& b)
+{
+    if (a.audible != b.audible)
+        return a.audible;
+    if (a.source->getPriority() != b.source->getPriority())
+        return a.source->getPriority() > b.source->getPriority();
+    return a.distance < b.distance;
+}
+
+// Returns the distance of a source from the listener, or zero if it isn't attached to a node.
+static float getListenerDistance(const AudioSource* source)
+{
+    AudioListener* listener = AudioListener::getInstance();
+    Node* node = source->getNode();
+    if (listener == NULL || node == NULL)
+        return 0.0f;
+    return node->getTranslationWorld().distance(listener->getPosition());
+}
+
+static bool isAudible(const AudioSource* source, float distance)
+{
+    return source->getMaxDistance() <= 0.0f || distance <= source->getMaxDistance();
+}
+
 AudioController::AudioController() 
-: _alcDevice(NULL), _alcContext(NULL), _pausingSource(NULL), _streamingThreadActive(true)
+: _alcDevice(NULL), _alcContext(NULL), _pausingSource(NULL), _voiceCount(0), _maxVoices(AUDIO_MAX_VOICES), _streamingThreadActive(true),
+  _decodingSource(NULL)
 {
 }
 
@@ -18,6 +68,11 @@ AudioController::~AudioController()
 
 void AudioController::initialize()
 {
+#ifdef GP_HEADLESS
+    // Headless builds have no audio device, and audio sources are never created.
+    return;
+#endif
+
     _alcDevice = alcOpenDevice(NULL);
     if (!_alcDevice)
     {
@@ -41,6 +96,17 @@ void AudioController::initialize()
         GP_ERROR("Unable to make OpenAL context current. Error: %d\n", alcErr);
     }
     _streamingMutex.reset(new std::mutex());
+
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("audio", true);
+    if (config && config->exists("maxVoices"))
+    {
+        _maxVoices = (unsigned int)std::max(config->getInt("maxVoices"), 0);
+    }
+    if (config && config->exists("memoryBudget"))
+    {
+        // Decoded sounds stay cached within the budget once nothing plays them.
+        ResourceManager::setMemoryBudget(ResourceManager::AUDIO_BUFFER, (size_t)(std::max(config->getFloat("memoryBudget"), 0.0f) * 1024.0f * 1024.0f));
+    }
 }
 
 void AudioController::finalize()
@@ -51,6 +117,14 @@ void AudioController::finalize()
         _streamingThreadActive = false;
         _streamingThread->join();
         _streamingThread.reset(NULL);
+        _decodingThread->join();
+        _decodingThread.reset(NULL);
+    }
+
+    if (!_freeVoices.empty())
+    {
+        AL_CHECK( alDeleteSources((ALsizei)_freeVoices.size(), &_freeVoices[0]) );
+        _freeVoices.clear();
     }
 
     alcMakeContextCurrent(NULL);
@@ -68,6 +142,10 @@ void AudioController::finalize()
 
 void AudioController::pause()
 {
+#ifdef GP_HEADLESS
+    return;
+#endif
+
     std::set<AudioSource*>::iterator itr = _playingSources.begin();
 
     // For each source that is playing, pause it.
@@ -88,6 +166,10 @@ void AudioController::pause()
 
 void AudioController::resume()
 {   
+#ifdef GP_HEADLESS
+    return;
+#endif
+
     alcMakeContextCurrent(_alcContext);
 #ifdef ALC_SOFT_pause_device
     alcDeviceResumeSOFT(_alcDevice);
@@ -108,6 +190,17 @@ void AudioController::resume()
 
 void AudioController::update(float elapsedTime)
 {
+    GP_PROFILE("AudioController::update");
+
+#ifdef GP_HEADLESS
+    return;
+#endif
+
+    // The changes of the frame are applied together by the mixer, when the implementation supports it.
+#ifdef AL_SOFT_deferred_updates
+    alDeferUpdatesSOFT();
+#endif
+
     AudioListener* listener = AudioListener::getInstance();
     if (listener)
     {
@@ -116,6 +209,47 @@ void AudioController::update(float elapsedTime)
         AL_CHECK( alListenerfv(AL_VELOCITY, (ALfloat*)&listener->getVelocity()) );
         AL_CHECK( alListenerfv(AL_POSITION, (ALfloat*)&listener->getPosition()) );
     }
+
+    // The sources whose nodes moved during the frame are updated once, after every transform change.
+    for (std::set<AudioSource*>::iterator itr = _playingSources.begin(); itr != _playingSources.end(); ++itr)
+    {
+        AudioSource* source = *itr;
+        if (source->_positionDirty)
+            source->updatePosition(AUDIO_POSITION_THRESHOLD);
+    }
+
+    updateVoices(elapsedTime);
+
+#ifdef AL_SOFT_deferred_updates
+    alProcessUpdatesSOFT();
+#endif
+}
+
+void AudioController::setMaxVoices(unsigned int count)
+{
+    // The voices in use beyond the limit are released by the next update.
+    _maxVoices = count;
+}
+
+unsigned int AudioController::getMaxVoices() const
+{
+    return _maxVoices;
+}
+
+unsigned int AudioController::getVoiceCount() const
+{
+    return _voiceCount;
+}
+
+unsigned int AudioController::getVirtualCount() const
+{
+    unsigned int count = 0;
+    for (std::set<AudioSource*>::const_iterator itr = _playingSources.begin(); itr != _playingSources.end(); ++itr)
+    {
+        if ((*itr)->isVirtual())
+            ++count;
+    }
+    return count;
 }
 
 void AudioController::addPlayingSource(AudioSource* source)
@@ -133,9 +267,15 @@ void AudioController::addPlayingSource(AudioSource* source)
             _streamingMutex->unlock();
 
             if (startThread)
+            {
                 _streamingThread.reset(new std::thread(&streamingThreadProc, this));
+                _decodingThread.reset(new std::thread(&decodingThreadProc, this));
+            }
         }
     }
+
+    if (!source->isStreamed() && source->_alSource == 0 && source->_state == AudioSource::PLAYING)
+        assignVoice(source);
 }
 
 void AudioController::removePlayingSource(AudioSource* source)
@@ -146,6 +286,9 @@ void AudioController::removePlayingSource(AudioSource* source)
         if (iter != _playingSources.end())
         {
             _playingSources.erase(iter);
+
+            if (!source->isStreamed() && source->_alSource)
+                releaseVoice(source);
  
             if (source->isStreamed())
             {
@@ -153,11 +296,160 @@ void AudioController::removePlayingSource(AudioSource* source)
                 _streamingMutex->lock();
                 _streamingSources.erase(source);
                 _streamingMutex->unlock();
+
+                // The decoding thread no longer starts on the source, but may be decoding its next block.
+                while (_decodingSource.load() == source)
+                    std::this_thread::yield();
             }
         }
     } 
 }
 
+ALuint AudioController::acquireVoice()
+{
+    if (_voiceCount >= _maxVoices)
+        return 0;
+
+    ALuint voice = 0;
+    if (!_freeVoices.empty())
+    {
+        voice = _freeVoices.back();
+        _freeVoices.pop_back();
+    }
+    else
+    {
+        // Running out of sources is expected on some devices, so it isn't checked with AL_CHECK.
+        while (alGetError() != AL_NO_ERROR) ;
+        alGenSources(1, &voice);
+        if (alGetError() != AL_NO_ERROR || voice == 0)
+        {
+            GP_WARN("Unable to create more than %u audio voices.", _voiceCount);
+            _maxVoices = _voiceCount;
+            return 0;
+        }
+    }
+    ++_voiceCount;
+    return voice;
+}
+
+void AudioController::assignVoice(AudioSource* source)
+{
+    GP_ASSERT(source && !source->isStreamed() && source->_alSource == 0);
+
+    if (!isAudible(source, getListenerDistance(source)))
+        return;
+
+    ALuint voice = acquireVoice();
+    if (voice == 0)
+    {
+        // Take the voice of the source with the lowest priority, if it is lower than that of the source.
+        AudioSource* lowest = NULL;
+        for (std::set<AudioSource*>::iterator itr = _playingSources.begin(); itr != _playingSources.end(); ++itr)
+        {
+            AudioSource* s = *itr;
+            if (!s->isStreamed() && s->_alSource && s->_priority < source->_priority && (lowest == NULL || s->_priority < lowest->_priority))
+                lowest = s;
+        }
+        if (lowest == NULL)
+            return;
+        voice = lowest->unbindVoice();
+    }
+    source->bindVoice(voice);
+}
+
+void AudioController::releaseVoice(AudioSource* source)
+{
+    GP_ASSERT(source && source->_alSource);
+
+    _freeVoices.push_back(source->unbindVoice());
+    --_voiceCount;
+}
+
+void AudioController::updateVoices(float elapsedTime)
+{
+    std::vector<AudioVoice> voices;
+    std::vector<AudioSource*> ended;
+    float seconds = elapsedTime * 0.001f;
+    for (std::set<AudioSource*>::iterator itr = _playingSources.begin(); itr != _playingSources.end(); ++itr)
+    {
+        AudioSource* source = *itr;
+        if (source->isStreamed())
+            continue;
+
+        if (source->_alSource)
+        {
+            ALint state;
+            AL_CHECK( alGetSourcei(source->_alSource, AL_SOURCE_STATE, &state) );
+            if (state == AL_STOPPED)
+            {
+                ended.push_back(source);
+                continue;
+            }
+            // Sources paused with the controller keep their voice.
+            if (state != AL_PLAYING)
+                continue;
+        }
+        else
+        {
+            if (source->_state != AudioSource::PLAYING)
+                continue;
+
+            // Virtual sources move through their sound as if they were heard.
+            source->_offset += seconds * source->_pitch;
+            if (source->_offset >= source->_duration)
+            {
+                if (!source->_looped || source->_duration <= 0.0f)
+                {
+                    ended.push_back(source);
+                    continue;
+                }
+                source->_offset = fmod(source->_offset, source->_duration);
+            }
+        }
+
+        AudioVoice voice;
+        voice.source = source;
+        voice.distance = getListenerDistance(source);
+        voice.audible = isAudible(source, voice.distance);
+        voices.push_back(voice);
+    }
+
+    for (size_t i = 0, count = ended.size(); i < count; ++i)
+    {
+        AudioSource* source = ended[i];
+        source->_state = AudioSource::STOPPED;
+        removePlayingSource(source);
+        source->_offset = 0.0f;
+    }
+
+    // Release the voices of the sources that shouldn't be heard before giving them to those that should.
+    std::sort(voices.begin(), voices.end(), compareVoices);
+    for (size_t i = 0, count = voices.size(); i < count; ++i)
+    {
+        AudioSource* source = voices[i].source;
+        if (source->_alSource && (!voices[i].audible || i >= _maxVoices))
+            releaseVoice(source);
+    }
+    for (size_t i = 0, count = std::min(voices.size(), (size_t)_maxVoices); i < count && voices[i].audible; ++i)
+    {
+        AudioSource* source = voices[i].source;
+        if (source->_alSource == 0)
+        {
+            ALuint voice = acquireVoice();
+            if (voice == 0)
+                break;
+            source->bindVoice(voice);
+        }
+    }
+
+    // Free voices beyond the limit are given back to the device.
+    while (!_freeVoices.empty() && _voiceCount + _freeVoices.size() > _maxVoices)
+    {
+        AL_CHECK( alDeleteSources(1, &_freeVoices.back()) );
+        _freeVoices.pop_back();
+    }
+}
+
 void AudioController::streamingThreadProc(void* arg)
 {
     AudioController* controller = (AudioController*)arg;
@@ -170,7 +462,41 @@ void AudioController::streamingThreadProc(void* arg)
         
         controller->_streamingMutex->unlock();
    
-        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_STREAMING_INTERVAL));
+    }
+}
+
+void AudioController::decodingThreadProc(void* arg)
+{
+    AudioController* controller = (AudioController*)arg;
+
+    std::vector<AudioSource*> sources;
+    while (controller->_streamingThreadActive)
+    {
+        controller->_streamingMutex->lock();
+        sources.assign(controller->_streamingSources.begin(), controller->_streamingSources.end());
+        controller->_streamingMutex->unlock();
+
+        // Decoding happens without the lock, so that the streaming thread and the game never wait for it.
+        // A source is only decoded if it is still streamed once it is marked as being decoded, which
+        // makes removing it wait for the end of the block.
+        bool decoded = false;
+        for (size_t i = 0, count = sources.size(); i < count; ++i)
+        {
+            AudioSource* source = sources[i];
+            controller->_decodingSource.store(source);
+
+            controller->_streamingMutex->lock();
+            bool streamed = controller->_streamingSources.find(source) != controller->_streamingSources.end();
+            controller->_streamingMutex->unlock();
+
+            if (streamed && source->_buffer->decodeStreamData(source->_looped))
+                decoded = true;
+            controller->_decodingSource.store(NULL);
+        }
+
+        if (!decoded)
+            std::this_thread::sleep_for(std::chrono::milliseconds(AUDIO_DECODING_INTERVAL));
     }
 }
 
@@ -9,6 +9,21 @@ class AudioSource;
 
 /**
  * Defines a class for controlling game audio.
+ *
+ * The audio sources that aren't streamed are played with a pool of voices, which are OpenAL
+ * sources shared by every audio source. The number of voices is limited, since mobile devices
+ * only provide a few dozen sources and the cost of mixing grows with each one. Every frame,
+ * the playing sources that are within their maximum distance from the listener get the voices,
+ * by decreasing priority and then by increasing distance, and the others are virtual.
+ *
+ * The maximum number of voices is set by the 'maxVoices' property of the 'audio' namespace
+ * of the game configuration file, and the 'memoryBudget' property (in megabytes) sets the
+ * budget of the audio buffers cached by the ResourceManager.
+ *
+ * Streamed sources are decoded ahead of time by a decoding thread into a ring of blocks, which
+ * a streaming thread loads into the OpenAL buffers queued by the sources as they are played.
+ * Neither thread runs on the game frame, so decoding doesn't cause spikes in the frame time,
+ * and streaming keeps up when the frame rate drops.
  */
 class AudioController
 {
@@ -22,6 +37,34 @@ public:
      */
     virtual ~AudioController();
 
+    /**
+     * Sets the maximum number of voices that audio sources are played with.
+     *
+     * @param count The maximum number of voices.
+     */
+    void setMaxVoices(unsigned int count);
+
+    /**
+     * Returns the maximum number of voices that audio sources are played with.
+     *
+     * @return The maximum number of voices.
+     */
+    unsigned int getMaxVoices() const;
+
+    /**
+     * Returns the number of audio sources that are played with a voice.
+     *
+     * @return The number of voices in use.
+     */
+    unsigned int getVoiceCount() const;
+
+    /**
+     * Returns the number of audio sources that are playing without a voice.
+     *
+     * @return The number of virtual sources.
+     */
+    unsigned int getVirtualCount() const;
+
 private:
     
     /**
@@ -58,17 +101,45 @@ private:
     
     void removePlayingSource(AudioSource* source);
 
+    /**
+     * Returns a free voice, or zero if every voice is in use.
+     */
+    ALuint acquireVoice();
+
+    /**
+     * Gives a voice to a source that has just started playing, taking the voice of a source
+     * with a lower priority if there is no free voice.
+     */
+    void assignVoice(AudioSource* source);
+
+    /**
+     * Returns the voice of a source to the pool.
+     */
+    void releaseVoice(AudioSource* source);
+
+    /**
+     * Stops the sources that reached their end and gives the voices to the sources that should be heard.
+     */
+    void updateVoices(float elapsedTime);
+
     static void streamingThreadProc(void* arg);
 
+    static void decodingThreadProc(void* arg);
+
     ALCdevice* _alcDevice;
     ALCcontext* _alcContext;
     std::set<AudioSource*> _playingSources;
     std::set<AudioSource*> _streamingSources;
     AudioSource* _pausingSource;
+    std::vector<ALuint> _freeVoices;
+    unsigned int _voiceCount;
+    unsigned int _maxVoices;
 
     bool _streamingThreadActive;
     std::unique_ptr<std::thread> _streamingThread;
+    std::unique_ptr<std::thread> _decodingThread;
     std::unique_ptr<std::mutex> _streamingMutex;
+    std::atomic<AudioSource*> _decodingSource;
 };
 
 }
@@ -10,20 +10,31 @@ namespace gameplay
 {
 
 AudioSource::AudioSource(AudioBuffer* buffer, ALuint source) 
-    : _alSource(source), _buffer(buffer), _looped(false), _gain(1.0f), _pitch(1.0f), _node(NULL)
+    : _alSource(source), _buffer(buffer), _looped(false), _gain(1.0f), _pitch(1.0f), _node(NULL),
+    _priority(0), _maxDistance(0.0f), _state(INITIAL), _offset(0.0f), _duration(0.0f), _positionDirty(false)
 {
     GP_ASSERT(buffer);
 
     if (isStreamed())
+    {
+        GP_ASSERT(_alSource);
         AL_CHECK(alSourceQueueBuffers(_alSource, 1, &buffer->_alBufferQueue[0]));
+        AL_CHECK(alSourcei(_alSource, AL_LOOPING, AL_FALSE));
+        AL_CHECK( alSourcef(_alSource, AL_PITCH, _pitch) );
+        AL_CHECK( alSourcef(_alSource, AL_GAIN, _gain) );
+        AL_CHECK( alSourcefv(_alSource, AL_VELOCITY, (const ALfloat*)&_velocity) );
+    }
     else
-        AL_CHECK(alSourcei(_alSource, AL_BUFFER, buffer->_alBufferQueue[0]));
-    
-    AL_CHECK(alSourcei(_alSource, AL_LOOPING, _looped && !isStreamed()));
-    
-    AL_CHECK( alSourcef(_alSource, AL_PITCH, _pitch) );
-    AL_CHECK( alSourcef(_alSource, AL_GAIN, _gain) );
-    AL_CHECK( alSourcefv(_alSource, AL_VELOCITY, (const ALfloat*)&_velocity) );
+    {
+        // The duration is used to keep track of the position of the source while it is virtual.
+        ALint size = 0, frequency = 0, channels = 0, bits = 0;
+        AL_CHECK( alGetBufferi(buffer->_alBufferQueue[0], AL_SIZE, &size) );
+        AL_CHECK( alGetBufferi(buffer->_alBufferQueue[0], AL_FREQUENCY, &frequency) );
+        AL_CHECK( alGetBufferi(buffer->_alBufferQueue[0], AL_CHANNELS, &channels) );
+        AL_CHECK( alGetBufferi(buffer->_alBufferQueue[0], AL_BITS, &bits) );
+        if (frequency > 0 && channels > 0 && bits > 0)
+            _duration = (float)size / (float)(frequency * channels * (bits / 8));
+    }
 }
 
 AudioSource::~AudioSource()
@@ -38,7 +49,10 @@ AudioSource::~AudioSource()
         AudioController* audioController = Game::getInstance()->getAudioController();
         GP_ASSERT(audioController);
         audioController->removePlayingSource(this);
-
+    }
+    if (_alSource)
+    {
+        // Only streamed sources own their OpenAL source; the voices of others go back to the controller.
         AL_CHECK(alDeleteSources(1, &_alSource));
         _alSource = 0;
     }
@@ -47,6 +61,11 @@ AudioSource::~AudioSource()
 
 AudioSource* AudioSource::create(const char* url, bool streamed)
 {
+#ifdef GP_HEADLESS
+    GP_WARN("Audio source '%s' is not created in a headless build.", url);
+    return NULL;
+#endif
+
     // Load from a .audio file.
     std::string pathStr = url;
     if (pathStr.find(".audio") != std::string::npos)
@@ -68,15 +87,17 @@ AudioSource* AudioSource::create(const char* url, bool streamed)
     if (buffer == NULL)
         return NULL;
 
-    // Load the audio source.
+    // Streamed sources keep their own OpenAL source, others are played with the voices of the controller.
     ALuint alSource = 0;
-
-    AL_CHECK( alGenSources(1, &alSource) );
-    if (AL_LAST_ERROR())
+    if (streamed)
     {
-        SAFE_RELEASE(buffer);
-        GP_ERROR("Error generating audio source.");
-        return NULL;
+        AL_CHECK( alGenSources(1, &alSource) );
+        if (AL_LAST_ERROR())
+        {
+            SAFE_RELEASE(buffer);
+            GP_ERROR("Error generating audio source.");
+            return NULL;
+        }
     }
     
     return new AudioSource(buffer, alSource);
@@ -84,6 +105,10 @@ AudioSource* AudioSource::create(const char* url, bool streamed)
 
 AudioSource* AudioSource::create(Properties* properties)
 {
+#ifdef GP_HEADLESS
+    return NULL;
+#endif
+
     // Check if the properties is valid and has a valid namespace.
     GP_ASSERT(properties);
     if (!properties || !(strcmp(properties->getNamespace(), "audio") == 0))
@@ -131,12 +156,24 @@ AudioSource* AudioSource::create(Properties* properties)
     {
         audio->setVelocity(v);
     }
+    if (properties->exists("priority"))
+    {
+        audio->setPriority(properties->getInt("priority"));
+    }
+    if (properties->exists("maxDistance"))
+    {
+        audio->setMaxDistance(properties->getFloat("maxDistance"));
+    }
 
     return audio;
 }
 
 AudioSource::State AudioSource::getState() const
 {
+    // Sources without a voice keep their own state.
+    if (_alSource == 0)
+        return _state;
+
     ALint state;
     AL_CHECK( alGetSourcei(_alSource, AL_SOURCE_STATE, &state) );
 
@@ -162,7 +199,20 @@ bool AudioSource::isStreamed() const
 
 void AudioSource::play()
 {
-    AL_CHECK( alSourcePlay(_alSource) );
+    if (!isStreamed())
+    {
+        // Playing a source that isn't paused restarts it.
+        if (_state != PAUSED)
+            _offset = 0.0f;
+        _state = PLAYING;
+    }
+    if (_alSource)
+    {
+        // The position is only updated for playing sources, so those that start are brought up to date.
+        if (_positionDirty)
+            updatePosition(0.0f);
+        AL_CHECK( alSourcePlay(_alSource) );
+    }
 
     // Add the source to the controller's list of currently playing sources.
     AudioController* audioController = Game::getInstance()->getAudioController();
@@ -172,13 +222,20 @@ void AudioSource::play()
 
 void AudioSource::pause()
 {
-    AL_CHECK( alSourcePause(_alSource) );
+    if (_state == PLAYING)
+        _state = PAUSED;
 
     // Remove the source from the controller's set of currently playing sources
     // if the source is being paused by the user and not the controller itself.
+    // This is done first so that the streaming thread no longer refills it.
     AudioController* audioController = Game::getInstance()->getAudioController();
     GP_ASSERT(audioController);
     audioController->removePlayingSource(this);
+
+    if (_alSource)
+    {
+        AL_CHECK( alSourcePause(_alSource) );
+    }
 }
 
 void AudioSource::resume()
@@ -191,17 +248,34 @@ void AudioSource::resume()
 
 void AudioSource::stop()
 {
-    AL_CHECK( alSourceStop(_alSource) );
+    _state = STOPPED;
 
-    // Remove the source from the controller's set of currently playing sources.
+    // Remove the source from the controller's set of currently playing sources first,
+    // since the streaming thread plays the streamed sources it finds stopped again.
     AudioController* audioController = Game::getInstance()->getAudioController();
     GP_ASSERT(audioController);
     audioController->removePlayingSource(this);
+
+    if (_alSource)
+    {
+        AL_CHECK( alSourceStop(_alSource) );
+    }
+    _offset = 0.0f;
 }
 
 void AudioSource::rewind()
 {
-    AL_CHECK( alSourceRewind(_alSource) );
+    if (_alSource)
+    {
+        AL_CHECK( alSourceRewind(_alSource) );
+    }
+    _state = INITIAL;
+    _offset = 0.0f;
+
+    // A rewound source is no longer playing.
+    AudioController* audioController = Game::getInstance()->getAudioController();
+    GP_ASSERT(audioController);
+    audioController->removePlayingSource(this);
 }
 
 bool AudioSource::isLooped() const
@@ -211,10 +285,13 @@ bool AudioSource::isLooped() const
 
 void AudioSource::setLooped(bool looped)
 {
-    AL_CHECK(alSourcei(_alSource, AL_LOOPING, (looped && !isStreamed()) ? AL_TRUE : AL_FALSE));
-    if (AL_LAST_ERROR())
+    if (_alSource)
     {
-        GP_ERROR("Failed to set audio source's looped attribute with error: %d", AL_LAST_ERROR());
+        AL_CHECK(alSourcei(_alSource, AL_LOOPING, (looped && !isStreamed()) ? AL_TRUE : AL_FALSE));
+        if (AL_LAST_ERROR())
+        {
+            GP_ERROR("Failed to set audio source's looped attribute with error: %d", AL_LAST_ERROR());
+        }
     }
     _looped = looped;
 }
@@ -226,7 +303,10 @@ float AudioSource::getGain() const
 
 void AudioSource::setGain(float gain)
 {
-    AL_CHECK( alSourcef(_alSource, AL_GAIN, gain) );
+    if (_alSource)
+    {
+        AL_CHECK( alSourcef(_alSource, AL_GAIN, gain) );
+    }
     _gain = gain;
 }
 
@@ -237,7 +317,10 @@ float AudioSource::getPitch() const
 
 void AudioSource::setPitch(float pitch)
 {
-    AL_CHECK( alSourcef(_alSource, AL_PITCH, pitch) );
+    if (_alSource)
+    {
+        AL_CHECK( alSourcef(_alSource, AL_PITCH, pitch) );
+    }
     _pitch = pitch;
 }
 
@@ -248,7 +331,10 @@ const Vector3& AudioSource::getVelocity() const
 
 void AudioSource::setVelocity(const Vector3& velocity)
 {
-    AL_CHECK( alSourcefv(_alSource, AL_VELOCITY, (ALfloat*)&velocity) );
+    if (_alSource)
+    {
+        AL_CHECK( alSourcefv(_alSource, AL_VELOCITY, (ALfloat*)&velocity) );
+    }
     _velocity = velocity;
 }
 
@@ -257,6 +343,31 @@ void AudioSource::setVelocity(float x, float y, float z)
     setVelocity(Vector3(x, y, z));
 }
 
+int AudioSource::getPriority() const
+{
+    return _priority;
+}
+
+void AudioSource::setPriority(int priority)
+{
+    _priority = priority;
+}
+
+float AudioSource::getMaxDistance() const
+{
+    return _maxDistance;
+}
+
+void AudioSource::setMaxDistance(float distance)
+{
+    _maxDistance = std::max(distance, 0.0f);
+}
+
+bool AudioSource::isVirtual() const
+{
+    return _alSource == 0 && _state == PLAYING;
+}
+
 Node* AudioSource::getNode() const
 {
     return _node;
@@ -286,11 +397,22 @@ void AudioSource::setNode(Node* node)
 
 void AudioSource::transformChanged(Transform* transform, long cookie)
 {
-    if (_node)
-    {
-        Vector3 translation = _node->getTranslationWorld();
-        AL_CHECK( alSourcefv(_alSource, AL_POSITION, (const ALfloat*)&translation.x) );
-    }
+    // Nodes can move several times per frame, so the position is set once by the audio controller.
+    _positionDirty = true;
+}
+
+void AudioSource::updatePosition(float threshold)
+{
+    _positionDirty = false;
+    if (_alSource == 0)
+        return;
+
+    Vector3 translation = _node ? _node->getTranslationWorld() : Vector3::zero();
+    if (threshold > 0.0f && translation.distanceSquared(_position) < threshold * threshold)
+        return;
+
+    _position = translation;
+    AL_CHECK( alSourcefv(_alSource, AL_POSITION, (const ALfloat*)&_position.x) );
 }
 
 AudioSource* AudioSource::clone(NodeCloneContext& context)
@@ -298,11 +420,14 @@ AudioSource* AudioSource::clone(NodeCloneContext& context)
     GP_ASSERT(_buffer);
 
     ALuint alSource = 0;
-    AL_CHECK( alGenSources(1, &alSource) );
-    if (AL_LAST_ERROR())
+    if (isStreamed())
     {
-        GP_ERROR("Unable to cloning audio.");
-        return NULL;
+        AL_CHECK( alGenSources(1, &alSource) );
+        if (AL_LAST_ERROR())
+        {
+            GP_ERROR("Unable to cloning audio.");
+            return NULL;
+        }
     }
     AudioSource* audioClone = new AudioSource(_buffer, alSource);
 
@@ -311,6 +436,8 @@ AudioSource* AudioSource::clone(NodeCloneContext& context)
     audioClone->setGain(getGain());
     audioClone->setPitch(getPitch());
     audioClone->setVelocity(getVelocity());
+    audioClone->setPriority(getPriority());
+    audioClone->setMaxDistance(getMaxDistance());
     if (Node* node = getNode())
     {
         Node* clonedNode = context.findClonedNode(node);
@@ -325,22 +452,27 @@ AudioSource* AudioSource::clone(NodeCloneContext& context)
 bool AudioSource::streamDataIfNeeded()
 {
     GP_ASSERT( isStreamed() );
-    if( getState() != PLAYING )
+    State state = getState();
+    if (state != PLAYING && state != STOPPED)
+        return false;
+
+    // A source whose queue ran dry before the decoder caught up has stopped,
+    // and plays again once the decoded blocks are queued.
+    if (state == STOPPED && !_buffer->hasStreamData())
         return false;
 
     int queuedBuffers;
     alGetSourcei(_alSource, AL_BUFFERS_QUEUED, &queuedBuffers);
  
+    bool streamed = false;
     int buffersNeeded = std::min<int>(_buffer->_buffersNeededCount, AudioBuffer::STREAMING_BUFFER_QUEUE_SIZE);
     if (queuedBuffers < buffersNeeded)
     {
-        while (queuedBuffers < buffersNeeded)
+        while (queuedBuffers < buffersNeeded && _buffer->streamData(_buffer->_alBufferQueue[queuedBuffers]))
         {
-            if (!_buffer->streamData(_buffer->_alBufferQueue[queuedBuffers], _looped))
-                return false;
-            
             AL_CHECK( alSourceQueueBuffers(_alSource, 1, &_buffer->_alBufferQueue[queuedBuffers]) );
             queuedBuffers++;
+            streamed = true;
         }
     }
     else
@@ -348,17 +480,54 @@ bool AudioSource::streamDataIfNeeded()
         int processedBuffers;
         alGetSourcei(_alSource, AL_BUFFERS_PROCESSED, &processedBuffers);
  
-        while (processedBuffers-- > 0)
+        // Buffers are only unqueued when there is a decoded block to refill them with.
+        while (processedBuffers-- > 0 && _buffer->hasStreamData())
         {
             ALuint bufferID;
             AL_CHECK( alSourceUnqueueBuffers(_alSource, 1, &bufferID) );
-            if (!_buffer->streamData(bufferID, _looped))
-                return false;
-            
+            _buffer->streamData(bufferID);
             AL_CHECK( alSourceQueueBuffers(_alSource, 1, &bufferID) );
+            streamed = true;
         }
     }
-    return true;
+
+    if (state == STOPPED && streamed)
+    {
+        AL_CHECK( alSourcePlay(_alSource) );
+    }
+    return streamed;
+}
+
+void AudioSource::bindVoice(ALuint voice)
+{
+    GP_ASSERT(!isStreamed() && _alSource == 0 && voice);
+
+    _alSource = voice;
+    AL_CHECK( alSourcei(_alSource, AL_BUFFER, _buffer->_alBufferQueue[0]) );
+    AL_CHECK( alSourcei(_alSource, AL_LOOPING, _looped ? AL_TRUE : AL_FALSE) );
+    AL_CHECK( alSourcef(_alSource, AL_PITCH, _pitch) );
+    AL_CHECK( alSourcef(_alSource, AL_GAIN, _gain) );
+    AL_CHECK( alSourcefv(_alSource, AL_VELOCITY, (const ALfloat*)&_velocity) );
+    updatePosition(0.0f);
+
+    // The offset of a source that isn't playing is applied when it starts playing.
+    AL_CHECK( alSourcef(_alSource, AL_SEC_OFFSET, _offset) );
+    AL_CHECK( alSourcePlay(_alSource) );
+}
+
+ALuint AudioSource::unbindVoice()
+{
+    GP_ASSERT(_alSource);
+
+    ALfloat offset = 0.0f;
+    AL_CHECK( alGetSourcef(_alSource, AL_SEC_OFFSET, &offset) );
+    _offset = offset;
+    AL_CHECK( alSourceStop(_alSource) );
+    AL_CHECK( alSourcei(_alSource, AL_BUFFER, 0) );
+
+    ALuint voice = _alSource;
+    _alSource = 0;
+    return voice;
 }
 
 }
@@ -17,6 +17,13 @@ class NodeCloneContext;
  *
  * This can be attached to a Node for applying its 3D transformation.
  *
+ * Sources that aren't streamed are played with one of the voices of the audio controller,
+ * which mixes a limited number of them. When more sources play than there are voices, or
+ * when a source is further from the listener than its maximum distance, the source becomes
+ * virtual: it keeps playing silently and is heard again, from where it would be, once it
+ * gets a voice back. Sources with a higher priority get voices first, and the nearest ones
+ * get them among sources of the same priority.
+ *
  * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-Audio
  */
 class AudioSource : public Ref, public Transform::Listener
@@ -162,6 +169,44 @@ public:
      */
     void setVelocity(float x, float y, float z);
 
+    /**
+     * Returns the priority of the audio source.
+     *
+     * @return The priority.
+     */
+    int getPriority() const;
+
+    /**
+     * Sets the priority of the audio source. Sources with a higher priority get the voices
+     * of the audio controller before those with a lower one, and take them from those that
+     * play when no voice is left. The default priority is zero.
+     *
+     * @param priority The priority of the source.
+     */
+    void setPriority(int priority);
+
+    /**
+     * Returns the distance from the listener beyond which the audio source is virtual.
+     *
+     * @return The maximum distance, or zero if the source is heard at any distance.
+     */
+    float getMaxDistance() const;
+
+    /**
+     * Sets the distance from the listener beyond which the audio source is virtual, which
+     * is only used for sources attached to a node.
+     *
+     * @param distance The maximum distance, or zero for the source to be heard at any distance.
+     */
+    void setMaxDistance(float distance);
+
+    /**
+     * Determines whether the audio source is playing without a voice, and isn't heard.
+     *
+     * @return true if the source is virtual, false if not.
+     */
+    bool isVirtual() const;
+
     /**
      * Gets the node that this source is attached to.
      * 
@@ -172,7 +217,7 @@ public:
 private:
 
     /**
-     * Constructor that takes an AudioBuffer.
+     * Constructor that takes an AudioBuffer, and the OpenAL source of streamed sources.
      */
     AudioSource(AudioBuffer* buffer, ALuint source);
 
@@ -192,10 +237,18 @@ private:
     void setNode(Node* node);
 
     /**
+     * Marks the position of the source to be updated by the next update of the audio controller.
+     *
      * @see Transform::Listener::transformChanged
      */
     void transformChanged(Transform* transform, long cookie);
 
+    /**
+     * Sets the position of the voice of the source to that of its node, unless it has moved
+     * less than the given distance since it was last set.
+     */
+    void updatePosition(float threshold);
+
     /**
      * Clones the audio source and returns a new audio source.
      * 
@@ -206,6 +259,16 @@ private:
 
     bool streamDataIfNeeded();
 
+    /**
+     * Plays the source with the given voice from the position it is at.
+     */
+    void bindVoice(ALuint voice);
+
+    /**
+     * Stops the voice of the source, keeping the position it is at, and returns the voice.
+     */
+    ALuint unbindVoice();
+
     ALuint _alSource;
     AudioBuffer* _buffer;
     bool _looped;
@@ -213,6 +276,13 @@ private:
     float _pitch;
     Vector3 _velocity;
     Node* _node;
+    int _priority;
+    float _maxDistance;
+    State _state;
+    float _offset;
+    float _duration;
+    Vector3 _position;
+    bool _positionDirty;
 };
 
 }
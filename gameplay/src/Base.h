@@ -31,8 +31,11 @@
 #include <typeinfo>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <chrono>
 #include "Logger.h"
+#include "Profiler.h"
 
 // Bring common functions from C into global namespace
 using std::memcpy;
@@ -129,6 +132,65 @@ extern int strcmpnocase(const char* s1, const char* s2);
 #define BV(v) (btVector3((v).x, (v).y, (v).z))
 #define BQ(q) (btQuaternion((q).x, (q).y, (q).z, (q).w))
 
+// Math alignment. When built with GP_USE_ALIGNED_MATH, Matrix, Vector4 and Quaternion are
+// 16-byte aligned so that the SIMD paths of MathUtil can use aligned loads and stores.
+// The objects that hold them must then be allocated aligned, which the heap of 64-bit platforms
+// always is, and which Transform (and so Node) is on any platform by its own new operators.
+#ifdef GP_USE_ALIGNED_MATH
+    #define GP_MATH_ALIGNMENT 16
+    #ifdef _MSC_VER
+        #include <malloc.h>
+        #define GP_MATH_ALIGN __declspec(align(16))
+    #else
+        #define GP_MATH_ALIGN __attribute__((aligned(16)))
+    #endif
+#else
+    #define GP_MATH_ALIGNMENT 4
+    #define GP_MATH_ALIGN
+#endif
+
+namespace gameplay
+{
+/**
+ * Allocates memory that is aligned to the given alignment, which must be a power of two
+ * that is a multiple of the size of a pointer.
+ *
+ * @return The allocated memory, or NULL if it could not be allocated.
+ * @script{ignore}
+ */
+inline void* alignedMalloc(size_t size, size_t alignment)
+{
+#ifdef _MSC_VER
+    return _aligned_malloc(size, alignment);
+#else
+    void* ptr = NULL;
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : NULL;
+#endif
+}
+
+/**
+ * Frees memory that was allocated with alignedMalloc.
+ * @script{ignore}
+ */
+inline void alignedFree(void* ptr)
+{
+#ifdef _MSC_VER
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+}
+
+// Quaternion interpolation. By default, Quaternion::slerp evaluates a series expansion that
+// needs no trig. When built with GP_USE_FAST_SLERP, it is a normalized lerp with a corrected
+// coefficient, which is batched with SIMD over arrays of quaternions, and squad uses polynomial
+// approximations of acos and sin. When built with GP_USE_EXACT_SLERP, precision-sensitive
+// builds such as tools get the exact acos and sin formula instead.
+#if defined(GP_USE_FAST_SLERP) && defined(GP_USE_EXACT_SLERP)
+    #error "GP_USE_FAST_SLERP and GP_USE_EXACT_SLERP cannot both be defined."
+#endif
+
 // Debug new for memory leak detection
 #include "DebugNew.h"
 
@@ -205,12 +267,29 @@ extern int strcmpnocase(const char* s1, const char* s2);
 
 // Scripting
 using std::va_list;
-#include <lua/lua.hpp>
+#ifdef GP_USE_LUAJIT
+    // LuaJIT implements the Lua 5.1 API, with the parts of the Lua 5.2 API that the bindings
+    // use defined in terms of it.
+    #include <luajit-2.1/lua.hpp>
+    typedef unsigned int lua_Unsigned;
+    #define lua_pushunsigned(L, n) lua_pushnumber(L, (lua_Number)(n))
+    #define luaL_checkunsigned(L, n) ((lua_Unsigned)luaL_checknumber(L, n))
+    #define lua_pushglobaltable(L) lua_pushvalue(L, LUA_GLOBALSINDEX)
+    #define lua_len(L, i) lua_pushinteger(L, (lua_Integer)lua_objlen(L, i))
+    #ifndef LUA_OK
+        #define LUA_OK 0
+    #endif
+#else
+    #include <lua/lua.hpp>
+#endif
 
 #define WINDOW_VSYNC        1
 
 // Graphics (OpenGL)
-#ifdef __ANDROID__
+#ifdef GP_HEADLESS
+    #include "GLHeadless.h"
+    #define GP_USE_VAO
+#elif __ANDROID__
     #include <EGL/egl.h>
     #include <GLES2/gl2.h>
     #include <GLES2/gl2ext.h>
@@ -220,20 +299,48 @@ using std::va_list;
     extern PFNGLISVERTEXARRAYOESPROC glIsVertexArray;
     extern PFNGLMAPBUFFEROESPROC glMapBuffer;
     extern PFNGLUNMAPBUFFEROESPROC glUnmapBuffer;
+    extern PFNGLDRAWARRAYSINSTANCEDEXTPROC glDrawArraysInstanced;
+    extern PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstanced;
+    extern PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor;
+    extern PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinary;
+    extern PFNGLPROGRAMBINARYOESPROC glProgramBinary;
+    extern PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebuffer;
+    #ifdef GL_EXT_disjoint_timer_query
+    extern PFNGLGENQUERIESEXTPROC glGenQueries;
+    extern PFNGLDELETEQUERIESEXTPROC glDeleteQueries;
+    extern PFNGLBEGINQUERYEXTPROC glBeginQuery;
+    extern PFNGLENDQUERYEXTPROC glEndQuery;
+    extern PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuiv;
+    extern PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64v;
+    #define GL_TIME_ELAPSED GL_TIME_ELAPSED_EXT
+    #define GL_QUERY_RESULT GL_QUERY_RESULT_EXT
+    #define GL_QUERY_RESULT_AVAILABLE GL_QUERY_RESULT_AVAILABLE_EXT
+    #define GP_USE_TIMER_QUERIES
+    #endif
+    #ifdef GL_KHR_parallel_shader_compile
+    extern PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR;
+    #endif
     #define GL_WRITE_ONLY GL_WRITE_ONLY_OES
+    #define GL_PROGRAM_BINARY_LENGTH GL_PROGRAM_BINARY_LENGTH_OES
     #define GL_DEPTH24_STENCIL8 GL_DEPTH24_STENCIL8_OES
     #define glClearDepth glClearDepthf
     #define OPENGL_ES
     #define GP_USE_VAO
+    #define GP_USE_PROGRAM_BINARY
+    #define GP_USE_DISCARD_FRAMEBUFFER
 #elif WIN32
         #define WIN32_LEAN_AND_MEAN
         #define GLEW_STATIC
         #include <GL/glew.h>
         #define GP_USE_VAO
+        #define GP_USE_UNIFORM_BUFFERS
+        #define GP_USE_PROGRAM_BINARY
 #elif __linux__
         #define GLEW_STATIC
         #include <GL/glew.h>
         #define GP_USE_VAO
+        #define GP_USE_UNIFORM_BUFFERS
+        #define GP_USE_PROGRAM_BINARY
 #elif __APPLE__
     #include "TargetConditionals.h"
     #if TARGET_OS_IPHONE || TARGET_IPHONE_SIMULATOR
@@ -245,11 +352,16 @@ using std::va_list;
         #define glIsVertexArray glIsVertexArrayOES
         #define glMapBuffer glMapBufferOES
         #define glUnmapBuffer glUnmapBufferOES
+        #define glDrawArraysInstanced glDrawArraysInstancedEXT
+        #define glDrawElementsInstanced glDrawElementsInstancedEXT
+        #define glVertexAttribDivisor glVertexAttribDivisorEXT
+        #define glDiscardFramebuffer glDiscardFramebufferEXT
         #define GL_WRITE_ONLY GL_WRITE_ONLY_OES
         #define GL_DEPTH24_STENCIL8 GL_DEPTH24_STENCIL8_OES
         #define glClearDepth glClearDepthf
         #define OPENGL_ES
         #define GP_USE_VAO
+        #define GP_USE_DISCARD_FRAMEBUFFER
     #elif TARGET_OS_MAC
         #include <OpenGL/gl.h>
         #include <OpenGL/glext.h>
@@ -257,12 +369,59 @@ using std::va_list;
         #define glDeleteVertexArrays glDeleteVertexArraysAPPLE
         #define glGenVertexArrays glGenVertexArraysAPPLE
         #define glIsVertexArray glIsVertexArrayAPPLE
+        #define glDrawArraysInstanced glDrawArraysInstancedARB
+        #define glDrawElementsInstanced glDrawElementsInstancedARB
+        #define glVertexAttribDivisor glVertexAttribDivisorARB
         #define GP_USE_VAO
     #else
         #error "Unsupported Apple Device"
     #endif
 #endif
 
+// Vertex element types that the OpenGL ES 2.0 headers only define as extensions.
+#ifdef OPENGL_ES
+    #if !defined(GL_HALF_FLOAT) && defined(GL_HALF_FLOAT_OES)
+        #define GL_HALF_FLOAT GL_HALF_FLOAT_OES
+    #endif
+    #ifndef GL_HALF_FLOAT
+        #define GL_HALF_FLOAT 0x140B
+    #endif
+    #ifndef GL_INT_2_10_10_10_REV
+        #define GL_INT_2_10_10_10_REV 0x8D9F
+    #endif
+#endif
+
+// Particles can be simulated on the GPU with transform feedback on desktop OpenGL 3.0 and later.
+#if (defined(WIN32) || (defined(__linux__) && !defined(__ANDROID__))) && !defined(GP_HEADLESS)
+    #define GP_USE_TRANSFORM_FEEDBACK
+#endif
+
+// Compute shaders, shader storage buffers and indirect draws are core in desktop OpenGL 4.3.
+#if (defined(WIN32) || (defined(__linux__) && !defined(__ANDROID__))) && !defined(GP_HEADLESS)
+    #define GP_USE_COMPUTE_SHADERS
+#endif
+
+// Occlusion queries are core in desktop OpenGL, but optional in OpenGL ES 2.0.
+#if !defined(OPENGL_ES) && !defined(GP_HEADLESS)
+    #define GP_USE_OCCLUSION_QUERIES
+#endif
+
+// GPU time can be measured with timer queries on desktop OpenGL 3.3 or ARB_timer_query, and
+// with EXT_disjoint_timer_query on Android.
+#if (defined(WIN32) || (defined(__linux__) && !defined(__ANDROID__))) && !defined(GP_HEADLESS)
+    #define GP_USE_TIMER_QUERIES
+#endif
+
+// Sampler state can be kept in sampler objects on desktop OpenGL 3.3 or ARB_sampler_objects.
+#if (defined(WIN32) || (defined(__linux__) && !defined(__ANDROID__))) && !defined(GP_HEADLESS)
+    #define GP_USE_SAMPLER_OBJECTS
+#endif
+
+// Shaders can be compiled in the background where the driver exposes KHR_parallel_shader_compile.
+#ifdef GL_KHR_parallel_shader_compile
+    #define GP_USE_PARALLEL_SHADER_COMPILE
+#endif
+
 // Graphics (GLSL)
 #define VERTEX_ATTRIBUTE_POSITION_NAME              "a_position"
 #define VERTEX_ATTRIBUTE_NORMAL_NAME                "a_normal"
@@ -272,6 +431,13 @@ using std::va_list;
 #define VERTEX_ATTRIBUTE_BLENDWEIGHTS_NAME          "a_blendWeights"
 #define VERTEX_ATTRIBUTE_BLENDINDICES_NAME          "a_blendIndices"
 #define VERTEX_ATTRIBUTE_TEXCOORD_PREFIX_NAME       "a_texCoord"
+#define VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME       "a_instanceMatrix"
+#define VERTEX_ATTRIBUTE_INSTANCE_COLOR_NAME        "a_instanceColor"
+#define VERTEX_ATTRIBUTE_INSTANCE_POSE_NAME         "a_instancePose"
+#define UNIFORM_BLOCK_FRAME_NAME                    "FrameBlock"
+#define UNIFORM_BLOCK_OBJECT_NAME                   "ObjectBlock"
+#define UNIFORM_BLOCK_FRAME_BINDING                 0
+#define UNIFORM_BLOCK_OBJECT_BINDING                1
 
 // Hardware buffer
 namespace gameplay
@@ -288,6 +454,8 @@ typedef GLuint TextureHandle;
 typedef GLuint FrameBufferHandle;
 /** Render buffer handle. */
 typedef GLuint RenderBufferHandle;
+/** Query handle. */
+typedef GLuint QueryHandle;
 
 /** Gamepad handle */
 #ifdef __ANDROID__
@@ -2,6 +2,7 @@
 #include "BoundingBox.h"
 #include "BoundingSphere.h"
 #include "Plane.h"
+#include "MathUtil.h"
 
 namespace gameplay
 {
@@ -346,4 +347,11 @@ void BoundingBox::transform(const Matrix& matrix)
     this->max.z = newMax.z;
 }
 
+void BoundingBox::transform(const Matrix& matrix, const BoundingBox* boxes, unsigned int count, BoundingBox* dst, unsigned int stride, unsigned int dstStride)
+{
+    GP_ASSERT(count == 0 || (boxes && dst));
+
+    MathUtil::transformBoxes(matrix.m, (const float*)boxes, stride, (float*)dst, dstStride, count);
+}
+
 }
@@ -208,6 +208,24 @@ public:
      */
     void transform(const Matrix& matrix);
 
+    /**
+     * Transforms an array of bounding boxes by the given affine transformation matrix,
+     * and stores the resulting boxes in dst.
+     *
+     * The boxes are transformed by their center and extents, which gives the same boxes
+     * as transforming their corners when the matrix has no projection.
+     *
+     * @param matrix The transformation matrix to transform by.
+     * @param boxes The first bounding box to transform.
+     * @param count The number of bounding boxes to transform.
+     * @param dst The first bounding box to store the results in, which can be boxes.
+     * @param stride The number of bytes from one box to the next in boxes.
+     * @param dstStride The number of bytes from one box to the next in dst.
+     * @script{ignore}
+     */
+    static void transform(const Matrix& matrix, const BoundingBox* boxes, unsigned int count, BoundingBox* dst,
+                          unsigned int stride = sizeof(BoundingBox), unsigned int dstStride = sizeof(BoundingBox));
+
     /**
      * Transforms this bounding box by the given matrix.
      * 
@@ -4,6 +4,8 @@
 #include "MeshPart.h"
 #include "Scene.h"
 #include "Joint.h"
+#include "RenderStats.h"
+#include "StringPool.h"
 
 // Minimum version numbers supported
 #define BUNDLE_VERSION_MAJOR_REQUIRED   1 
@@ -30,13 +32,48 @@
 #define BUNDLE_VERSION_MAJOR_FONT_FORMAT  1
 #define BUNDLE_VERSION_MINOR_FONT_FORMAT  5
 
+// Vertex, index and animation data is aligned within the file from this version on,
+// so that it can be used in place from a mapping of the file.
+#define BUNDLE_VERSION_MAJOR_ALIGNED_DATA 1
+#define BUNDLE_VERSION_MINOR_ALIGNED_DATA 7
+#define BUNDLE_MESH_DATA_ALIGNMENT        16
+#define BUNDLE_ARRAY_DATA_ALIGNMENT       4
+
+// Vertex elements have a data type and normalization from this version on.
+#define BUNDLE_VERSION_MAJOR_VERTEX_TYPES 1
+#define BUNDLE_VERSION_MINOR_VERTEX_TYPES 8
+
+// Mesh skins have a joint palette for each mesh part from this version on.
+#define BUNDLE_VERSION_MAJOR_PART_PALETTES 1
+#define BUNDLE_VERSION_MINOR_PART_PALETTES 9
+
+// Mesh skins have the bounds of the vertices of each joint from this version on.
+#define BUNDLE_VERSION_MAJOR_JOINT_BOUNDS 1
+#define BUNDLE_VERSION_MINOR_JOINT_BOUNDS 10
+
+// Strings are indices into a string table from this version on, whose offset follows the version.
+#define BUNDLE_VERSION_MAJOR_STRING_TABLE 1
+#define BUNDLE_VERSION_MINOR_STRING_TABLE 11
+
+// Models have the path, scale and offset of a baked lightmap from this version on.
+#define BUNDLE_VERSION_MAJOR_LIGHTMAPS 1
+#define BUNDLE_VERSION_MINOR_LIGHTMAPS 12
+
 namespace gameplay
 {
 
 static std::vector<Bundle*> __bundleCache;
 
+// Reads a byte of every page of the given data, so that a mapping of it is faulted in.
+static void touchPages(const unsigned char* data, size_t length)
+{
+    volatile unsigned char sum = 0;
+    for (size_t i = 0; i < length; i += 4096)
+        sum += data[i];
+}
+
 Bundle::Bundle(const char* path) :
-    _path(path), _referenceCount(0), _references(NULL), _stream(NULL), _trackedNodes(NULL)
+    _path(path), _referenceCount(0), _references(NULL), _stream(NULL), _data(NULL), _trackedNodes(NULL)
 {
 }
 
@@ -53,6 +90,11 @@ Bundle::~Bundle()
 
     SAFE_DELETE_ARRAY(_references);
 
+    for (std::map<std::string, MeshData*>::iterator itr = _preloadedMeshes.begin(); itr != _preloadedMeshes.end(); ++itr)
+    {
+        SAFE_DELETE(itr->second);
+    }
+
     if (_stream)
     {
         SAFE_DELETE(_stream);
@@ -117,6 +159,79 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values)
     return true;
 }
 
+template <class T>
+bool Bundle::readArray(unsigned int* length, const T** ptr, std::vector<T>* values)
+{
+    GP_ASSERT(length);
+    GP_ASSERT(ptr);
+    GP_ASSERT(values);
+    GP_ASSERT(_stream);
+
+    *ptr = NULL;
+    if (!read(length))
+    {
+        GP_ERROR("Failed to read the length of an array of data (to be read in place).");
+        return false;
+    }
+    if (!skipPadding(BUNDLE_ARRAY_DATA_ALIGNMENT))
+    {
+        GP_ERROR("Failed to skip the padding of an array of data (to be read in place).");
+        return false;
+    }
+    if (*length > 0)
+    {
+        *ptr = (const T*)readMapped(sizeof(T) * *length, sizeof(T) < 4 ? sizeof(T) : 4);
+        if (*ptr == NULL)
+        {
+            values->resize(*length);
+            if (_stream->read(&(*values)[0], sizeof(T), *length) != *length)
+            {
+                GP_ERROR("Failed to read an array of data from bundle (to be read in place).");
+                return false;
+            }
+            *ptr = &(*values)[0];
+        }
+    }
+    return true;
+}
+
+bool Bundle::skipPadding(unsigned int alignment)
+{
+    GP_ASSERT(_stream);
+    GP_ASSERT(alignment > 0);
+
+    if (getVersionMajor() < BUNDLE_VERSION_MAJOR_ALIGNED_DATA ||
+        (getVersionMajor() == BUNDLE_VERSION_MAJOR_ALIGNED_DATA && getVersionMinor() < BUNDLE_VERSION_MINOR_ALIGNED_DATA))
+    {
+        return true;
+    }
+
+    long int position = _stream->position();
+    if (position < 0)
+        return false;
+    long int padding = (alignment - (unsigned int)(position % alignment)) % alignment;
+    return padding == 0 || _stream->seek(padding, SEEK_CUR);
+}
+
+const void* Bundle::readMapped(size_t byteCount, size_t alignment)
+{
+    GP_ASSERT(_stream);
+
+    if (!_data)
+        return NULL;
+    long int position = _stream->position();
+    if (position < 0 || (size_t)position + byteCount > _stream->length())
+        return NULL;
+
+    // Values that are out of alignment would fault on some processors, so they are copied.
+    const unsigned char* data = _data + position;
+    if (alignment > 1 && ((size_t)data % alignment) != 0)
+        return NULL;
+    if (!_stream->seek((long int)byteCount, SEEK_CUR))
+        return NULL;
+    return data;
+}
+
 template <class T>
 bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned int readSize)
 {
@@ -141,7 +256,12 @@ bool Bundle::readArray(unsigned int* length, std::vector<T>* values, unsigned in
     return true;
 }
 
-static std::string readString(Stream* stream)
+/**
+ * Reads a string stored as its length and characters, and interns it.
+ *
+ * The characters of a mapped file are interned in place, without an intermediate copy.
+ */
+static const char* readInlineString(Stream* stream, const unsigned char* data)
 {
     GP_ASSERT(stream);
 
@@ -149,23 +269,46 @@ static std::string readString(Stream* stream)
     if (stream->read(&length, 4, 1) != 1)
     {
         GP_ERROR("Failed to read the length of a string from a bundle.");
-        return std::string();
+        return "";
     }
 
     // Sanity check to detect if string length is far too big.
     GP_ASSERT(length < BUNDLE_MAX_STRING_LENGTH);
+    if (length == 0)
+        return StringPool::intern("", 0);
 
-    std::string str;
-    if (length > 0)
+    if (data)
     {
-        str.resize(length);
-        if (stream->read(&str[0], 1, length) != length)
+        const char* str = (const char*)data + stream->position();
+        if (stream->seek(length, SEEK_CUR) == false)
         {
             GP_ERROR("Failed to read string from bundle.");
-            return std::string();
+            return "";
         }
+        return StringPool::intern(str, length);
+    }
+
+    char str[BUNDLE_MAX_STRING_LENGTH];
+    if (length >= BUNDLE_MAX_STRING_LENGTH || stream->read(str, 1, length) != length)
+    {
+        GP_ERROR("Failed to read string from bundle.");
+        return "";
     }
-    return str;
+    return StringPool::intern(str, length);
+}
+
+const char* Bundle::readString()
+{
+    if (_strings.empty())
+        return readInlineString(_stream, _data);
+
+    unsigned int index;
+    if (!read(&index) || index >= _strings.size())
+    {
+        GP_ERROR("Failed to read the index of a string in bundle '%s'.", _path.c_str());
+        return "";
+    }
+    return _strings[index];
 }
 
 Bundle* Bundle::create(const char* path)
@@ -185,8 +328,9 @@ Bundle* Bundle::create(const char* path)
         }
     }
 
-    // Open the bundle.
-    Stream* stream = FileSystem::open(path);
+    // Open the bundle, mapped into memory where possible so that mesh and animation data
+    // go straight from the file to the GPU or the curves without an intermediate copy.
+    Stream* stream = FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED);
     if (!stream)
     {
         GP_WARN("Failed to open file '%s'.", path);
@@ -218,38 +362,71 @@ Bundle* Bundle::create(const char* path)
         return NULL;
     }
 
+    // Keep file open for faster reading later.
+    Bundle* bundle = new Bundle(path);
+    bundle->_version[0] = version[0];
+    bundle->_version[1] = version[1];
+    bundle->_stream = stream;
+    bundle->_data = (const unsigned char*)stream->getData();
+
+    // Read the string table, which the first string of is always empty, so that all strings
+    // of the bundle are interned once and then read as indices.
+    if (version[0] > BUNDLE_VERSION_MAJOR_STRING_TABLE ||
+        (version[0] == BUNDLE_VERSION_MAJOR_STRING_TABLE && version[1] >= BUNDLE_VERSION_MINOR_STRING_TABLE))
+    {
+        unsigned int tableOffset;
+        if (stream->read(&tableOffset, 4, 1) != 1)
+        {
+            GP_WARN("Failed to read the string table offset for bundle '%s'.", path);
+            SAFE_DELETE(bundle);
+            return NULL;
+        }
+
+        // Fonts written without a string table store their strings inline.
+        if (tableOffset > 0)
+        {
+            long position = stream->position();
+            unsigned int stringCount;
+            if (stream->seek(tableOffset, SEEK_SET) == false || stream->read(&stringCount, 4, 1) != 1 || stringCount == 0)
+            {
+                GP_WARN("Failed to read the string table for bundle '%s'.", path);
+                SAFE_DELETE(bundle);
+                return NULL;
+            }
+            bundle->_strings.reserve(stringCount);
+            for (unsigned int i = 0; i < stringCount; ++i)
+            {
+                bundle->_strings.push_back(readInlineString(stream, bundle->_data));
+            }
+            stream->seek(position, SEEK_SET);
+        }
+    }
+
     // Read ref table.
     unsigned int refCount;
     if (stream->read(&refCount, 4, 1) != 1)
     {
-        SAFE_DELETE(stream);
         GP_WARN("Failed to read ref table for bundle '%s'.", path);
+        SAFE_DELETE(bundle);
         return NULL;
     }
 
     // Read all refs.
     Reference* refs = new Reference[refCount];
+    bundle->_referenceCount = refCount;
+    bundle->_references = refs;
     for (unsigned int i = 0; i < refCount; ++i)
     {
-        if ((refs[i].id = readString(stream)).empty() ||
+        if (*(refs[i].id = bundle->readString()) == '\0' ||
             stream->read(&refs[i].type, 4, 1) != 1 ||
             stream->read(&refs[i].offset, 4, 1) != 1)
         {
-            SAFE_DELETE(stream);
             GP_WARN("Failed to read ref number %d for bundle '%s'.", i, path);
-            SAFE_DELETE_ARRAY(refs);
+            SAFE_DELETE(bundle);
             return NULL;
         }
     }
 
-    // Keep file open for faster reading later.
-    Bundle* bundle = new Bundle(path);
-    bundle->_version[0] = version[0];
-    bundle->_version[1] = version[1];
-    bundle->_referenceCount = refCount;
-    bundle->_references = refs;
-    bundle->_stream = stream;
-
     return bundle;
 }
 
@@ -258,10 +435,15 @@ Bundle::Reference* Bundle::find(const char* id) const
     GP_ASSERT(id);
     GP_ASSERT(_references);
 
+    // The ids of the ref table are interned, so an id that isn't interned isn't in it.
+    const char* interned = StringPool::find(id);
+    if (interned == NULL)
+        return NULL;
+
     // Search the ref table for the given id (case-sensitive).
     for (unsigned int i = 0; i < _referenceCount; ++i)
     {
-        if (_references[i].id == id)
+        if (_references[i].id == interned)
         {
             // Found a match
             return &_references[i];
@@ -294,9 +476,9 @@ const char* Bundle::getIdFromOffset(unsigned int offset) const
         GP_ASSERT(_references);
         for (unsigned int i = 0; i < _referenceCount; ++i)
         {
-            if (_references[i].offset == offset && _references[i].id.length() > 0)
+            if (_references[i].offset == offset && _references[i].id[0] != '\0')
             {
-                return _references[i].id.c_str();
+                return _references[i].id;
             }
         }
     }
@@ -360,7 +542,7 @@ Bundle::Reference* Bundle::seekToFirstType(unsigned int type)
             // Found a match.
             if (_stream->seek(ref->offset, SEEK_SET) == false)
             {
-                GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
+                GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id, _path.c_str());
                 return NULL;
             }
             return ref;
@@ -391,6 +573,8 @@ bool Bundle::readMatrix(float* m)
 
 Scene* Bundle::loadScene(const char* id)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     clearLoadSession();
 
     Reference* ref = NULL;
@@ -437,10 +621,10 @@ Scene* Bundle::loadScene(const char* id)
         }
     }
     // Read active camera.
-    std::string xref = readString(_stream);
-    if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
+    const char* xref = readString();
+    if (xref[0] == '#' && xref[1] != '\0') // TODO: Handle full xrefs
     {
-        Node* node = scene->findNode(xref.c_str() + 1, true);
+        Node* node = scene->findNode(xref + 1, true);
         GP_ASSERT(node);
         Camera* camera = node->getCamera();
         GP_ASSERT(camera);
@@ -480,7 +664,7 @@ Scene* Bundle::loadScene(const char* id)
             // Found a match.
             if (_stream->seek(ref->offset, SEEK_SET) == false)
             {
-                GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
+                GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id, _path.c_str());
                 return NULL;
             }
             readAnimations(scene);
@@ -503,10 +687,12 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
     GP_ASSERT(_references);
     GP_ASSERT(_stream);
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     clearLoadSession();
 
     // Load the node and any referenced joints with node tracking enabled.
-    _trackedNodes = new std::map<std::string, Node*>();
+    _trackedNodes = new std::map<const char*, Node*>();
     Node* node = loadNode(id, sceneContext, NULL);
     if (node)
         resolveJointReferences(sceneContext, node);
@@ -519,7 +705,7 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
         {
             if (_stream->seek(ref->offset, SEEK_SET) == false)
             {
-                GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id.c_str(), _path.c_str());
+                GP_ERROR("Failed to seek to object '%s' in bundle '%s'.", ref->id, _path.c_str());
                 SAFE_DELETE(_trackedNodes);
                 return NULL;
             }
@@ -528,20 +714,20 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
             unsigned int animationCount;
             if (!read(&animationCount))
             {
-                GP_ERROR("Failed to read the number of animations for object '%s'.", ref->id.c_str());
+                GP_ERROR("Failed to read the number of animations for object '%s'.", ref->id);
                 SAFE_DELETE(_trackedNodes);
                 return NULL;
             }
 
             for (unsigned int j = 0; j < animationCount; j++)
             {
-                const std::string id = readString(_stream);
+                const char* id = readString();
 
                 // Read the number of animation channels in this animation.
                 unsigned int animationChannelCount;
                 if (!read(&animationChannelCount))
                 {
-                    GP_ERROR("Failed to read the number of animation channels for animation '%s'.", "animationChannelCount", id.c_str());
+                    GP_ERROR("Failed to read the number of animation channels for animation '%s'.", "animationChannelCount", id);
                     SAFE_DELETE(_trackedNodes);
                     return NULL;
                 }
@@ -550,23 +736,24 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
                 for (unsigned int k = 0; k < animationChannelCount; k++)
                 {
                     // Read target id.
-                    std::string targetId = readString(_stream);
-                    if (targetId.empty())
+                    const char* targetId = readString();
+                    if (*targetId == '\0')
                     {
-                        GP_ERROR("Failed to read target id for animation '%s'.", id.c_str());
+                        GP_ERROR("Failed to read target id for animation '%s'.", id);
                         SAFE_DELETE(_trackedNodes);
                         return NULL;
                     }
 
                     // If the target is one of the loaded nodes/joints, then load the animation.
-                    std::map<std::string, Node*>::iterator iter = _trackedNodes->find(targetId);
+                    // The ids of both are interned, so they are compared by pointer.
+                    std::map<const char*, Node*>::iterator iter = _trackedNodes->find(targetId);
                     if (iter != _trackedNodes->end())
                     {
                         // Read target attribute.
                         unsigned int targetAttribute;
                         if (!read(&targetAttribute))
                         {
-                            GP_ERROR("Failed to read target attribute for animation '%s'.", id.c_str());
+                            GP_ERROR("Failed to read target attribute for animation '%s'.", id);
                             SAFE_DELETE(_trackedNodes);
                             return NULL;
                         }
@@ -574,12 +761,12 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
                         AnimationTarget* target = iter->second;
                         if (!target)
                         {
-                            GP_ERROR("Failed to read %s for %s: %s", "animation target", targetId.c_str(), id.c_str());
+                            GP_ERROR("Failed to read %s for %s: %s", "animation target", targetId, id);
                             SAFE_DELETE(_trackedNodes);
                             return NULL;
                         }
 
-                        animation = readAnimationChannelData(animation, id.c_str(), target, targetAttribute);
+                        animation = readAnimationChannelData(animation, id, target, targetAttribute);
                     }
                     else
                     {
@@ -587,14 +774,14 @@ Node* Bundle::loadNode(const char* id, Scene* sceneContext)
                         unsigned int data;
                         if (!read(&data))
                         {
-                            GP_ERROR("Failed to skip over target attribute for animation '%s'.", id.c_str());
+                            GP_ERROR("Failed to skip over target attribute for animation '%s'.", id);
                             SAFE_DELETE(_trackedNodes);
                             return NULL;
                         }
 
                         // Skip the animation channel (passing a target attribute of
                         // 0 causes the animation to not be created).
-                        readAnimationChannelData(NULL, id.c_str(), NULL, 0);
+                        readAnimationChannelData(NULL, id, NULL, 0);
                     }
                 }
             }
@@ -661,7 +848,7 @@ bool Bundle::skipNode()
         GP_ERROR("Failed to skip over node transform for node '%s'.", id);
         return false;
     }
-    readString(_stream);
+    readString();
 
     // Skip over the node's children.
     unsigned int childrenCount;
@@ -699,7 +886,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
     // If we are tracking nodes and it's not in the set yet, add it.
     if (_trackedNodes)
     {
-        std::map<std::string, Node*>::iterator iter = _trackedNodes->find(id);
+        std::map<const char*, Node*>::iterator iter = _trackedNodes->find(id);
         if (iter != _trackedNodes->end())
         {
             // Skip over this node since we previously read it
@@ -755,7 +942,7 @@ Node* Bundle::readNode(Scene* sceneContext, Node* nodeContext)
     setTransform(transform, node);
 
     // Skip the parent ID.
-    readString(_stream);
+    readString();
 
     // Read children.
     unsigned int childrenCount;
@@ -972,10 +1159,10 @@ Light* Bundle::readLight()
 
 Model* Bundle::readModel(const char* nodeId)
 {
-    std::string xref = readString(_stream);
-    if (xref.length() > 1 && xref[0] == '#') // TODO: Handle full xrefs
+    const char* xref = readString();
+    if (xref[0] == '#' && xref[1] != '\0') // TODO: Handle full xrefs
     {
-        Mesh* mesh = loadMesh(xref.c_str() + 1, nodeId);
+        Mesh* mesh = loadMesh(xref + 1, nodeId);
         if (mesh)
         {
             Model* model = Model::create(mesh);
@@ -985,7 +1172,7 @@ Model* Bundle::readModel(const char* nodeId)
             unsigned char hasSkin;
             if (!read(&hasSkin))
             {
-                GP_ERROR("Failed to load whether model with mesh '%s' has a mesh skin in bundle '%s'.", xref.c_str() + 1, _path.c_str());
+                GP_ERROR("Failed to load whether model with mesh '%s' has a mesh skin in bundle '%s'.", xref + 1, _path.c_str());
                 return NULL;
             }
             if (hasSkin)
@@ -1000,14 +1187,14 @@ Model* Bundle::readModel(const char* nodeId)
             unsigned int materialCount;
             if (!read(&materialCount))
             {
-                GP_ERROR("Failed to load material count for model with mesh '%s' in bundle '%s'.", xref.c_str() + 1, _path.c_str());
+                GP_ERROR("Failed to load material count for model with mesh '%s' in bundle '%s'.", xref + 1, _path.c_str());
                 return NULL;
             }
             if (materialCount > 0)
             {
                 for (unsigned int i = 0; i < materialCount; ++i)
                 {
-                    std::string materialName = readString(_stream);
+                    const char* materialName = readString();
                     std::string materialPath = getMaterialPath();
                     if (materialPath.length() > 0)
                     {
@@ -1023,6 +1210,66 @@ Model* Bundle::readModel(const char* nodeId)
                     }
                 }
             }
+            if (getVersionMajor() >= 1 && getVersionMinor() >= 6)
+            {
+                // Read levels of detail.
+                unsigned int lodCount;
+                if (!read(&lodCount))
+                {
+                    GP_ERROR("Failed to load level of detail count for model with mesh '%s' in bundle '%s'.", xref + 1, _path.c_str());
+                    SAFE_RELEASE(model);
+                    return NULL;
+                }
+                for (unsigned int i = 0; i < lodCount; ++i)
+                {
+                    const char* lodXref = readString();
+                    float screenSize;
+                    if (!read(&screenSize))
+                    {
+                        GP_ERROR("Failed to load level of detail screen size for model with mesh '%s' in bundle '%s'.", xref + 1, _path.c_str());
+                        SAFE_RELEASE(model);
+                        return NULL;
+                    }
+                    if (lodXref[0] == '#' && lodXref[1] != '\0')
+                    {
+                        Mesh* lodMesh = loadMesh(lodXref + 1, nodeId);
+                        if (lodMesh)
+                        {
+                            model->addLOD(lodMesh, screenSize);
+                            SAFE_RELEASE(lodMesh);
+                        }
+                    }
+                }
+            }
+            if (getVersionMajor() > BUNDLE_VERSION_MAJOR_LIGHTMAPS ||
+                (getVersionMajor() == BUNDLE_VERSION_MAJOR_LIGHTMAPS && getVersionMinor() >= BUNDLE_VERSION_MINOR_LIGHTMAPS))
+            {
+                // Read the lightmap, whose path is empty for models without one.
+                std::string lightmapPath = readString();
+                Vector4 scaleOffset;
+                if (!read(&scaleOffset.x) || !read(&scaleOffset.y) || !read(&scaleOffset.z) || !read(&scaleOffset.w))
+                {
+                    GP_ERROR("Failed to load lightmap scale and offset for model with mesh '%s' in bundle '%s'.", xref + 1, _path.c_str());
+                    SAFE_RELEASE(model);
+                    return NULL;
+                }
+                if (!lightmapPath.empty())
+                {
+                    Texture::Sampler* lightmap = Texture::Sampler::create(lightmapPath.c_str(), true);
+                    if (lightmap)
+                    {
+                        lightmap->setFilterMode(Texture::LINEAR_MIPMAP_LINEAR, Texture::LINEAR);
+                        lightmap->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+                        model->setLightmap(lightmap);
+                        model->setLightmapScaleOffset(scaleOffset);
+                        SAFE_RELEASE(lightmap);
+                    }
+                    else
+                    {
+                        GP_WARN("Failed to load lightmap '%s' for model with mesh '%s' in bundle '%s'.", lightmapPath.c_str(), xref + 1, _path.c_str());
+                    }
+                }
+            }
             return model;
         }
     }
@@ -1068,7 +1315,7 @@ MeshSkin* Bundle::readMeshSkin()
     // Read joint xref strings for all joints in the list.
     for (unsigned int i = 0; i < jointCount; i++)
     {
-        skinData->joints.push_back(readString(_stream));
+        skinData->joints.push_back(readString());
     }
 
     // Read bind poses.
@@ -1097,6 +1344,72 @@ MeshSkin* Bundle::readMeshSkin()
         }
     }
 
+    // Read the joints of the palette of each mesh part.
+    if (getVersionMajor() > BUNDLE_VERSION_MAJOR_PART_PALETTES ||
+        (getVersionMajor() == BUNDLE_VERSION_MAJOR_PART_PALETTES && getVersionMinor() >= BUNDLE_VERSION_MINOR_PART_PALETTES))
+    {
+        unsigned int partCount;
+        if (!read(&partCount))
+        {
+            GP_ERROR("Failed to load number of part palettes in bundle '%s'.", _path.c_str());
+            SAFE_DELETE(meshSkin);
+            SAFE_DELETE(skinData);
+            return NULL;
+        }
+        std::vector<std::vector<unsigned int> > partJoints(partCount);
+        for (unsigned int i = 0; i < partCount; ++i)
+        {
+            unsigned int partJointCount;
+            if (!read(&partJointCount) || partJointCount > jointCount)
+            {
+                GP_ERROR("Failed to load number of joints in the palette of part %u in bundle '%s'.", i, _path.c_str());
+                SAFE_DELETE(meshSkin);
+                SAFE_DELETE(skinData);
+                return NULL;
+            }
+            partJoints[i].resize(partJointCount);
+            if (partJointCount > 0 && _stream->read(&partJoints[i][0], sizeof(unsigned int), partJointCount) != partJointCount)
+            {
+                GP_ERROR("Failed to load the joints of the palette of part %u in bundle '%s'.", i, _path.c_str());
+                SAFE_DELETE(meshSkin);
+                SAFE_DELETE(skinData);
+                return NULL;
+            }
+        }
+        meshSkin->setPartPalettes(partJoints);
+    }
+
+    // Read the bounds of the vertices of each joint.
+    if (getVersionMajor() > BUNDLE_VERSION_MAJOR_JOINT_BOUNDS ||
+        (getVersionMajor() == BUNDLE_VERSION_MAJOR_JOINT_BOUNDS && getVersionMinor() >= BUNDLE_VERSION_MINOR_JOINT_BOUNDS))
+    {
+        unsigned int boundsCount;
+        if (!read(&boundsCount) || (boundsCount > 0 && boundsCount != jointCount))
+        {
+            GP_ERROR("Failed to load number of joint bounds in bundle '%s'.", _path.c_str());
+            SAFE_DELETE(meshSkin);
+            SAFE_DELETE(skinData);
+            return NULL;
+        }
+        if (boundsCount > 0)
+        {
+            std::vector<BoundingBox> jointBounds(boundsCount);
+            for (unsigned int i = 0; i < boundsCount; ++i)
+            {
+                BoundingBox& box = jointBounds[i];
+                if (!read(&box.min.x) || !read(&box.min.y) || !read(&box.min.z) ||
+                    !read(&box.max.x) || !read(&box.max.y) || !read(&box.max.z))
+                {
+                    GP_ERROR("Failed to load the bounds of joint %u in bundle '%s'.", i, _path.c_str());
+                    SAFE_DELETE(meshSkin);
+                    SAFE_DELETE(skinData);
+                    return NULL;
+                }
+            }
+            meshSkin->setJointBounds(jointBounds);
+        }
+    }
+
     // Store the MeshSkinData so we can go back and resolve all joint references later.
     _meshSkins.push_back(skinData);
 
@@ -1118,12 +1431,10 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
         for (size_t j = 0; j < jointCount; ++j)
         {
             // TODO: Handle full xrefs (not just local # xrefs).
-            std::string jointId = skinData->joints[j];
-            if (jointId.length() > 1 && jointId[0] == '#')
+            const char* jointId = skinData->joints[j];
+            if (jointId[0] == '#' && jointId[1] != '\0')
             {
-                jointId = jointId.substr(1, jointId.length() - 1);
-
-                Node* n = loadNode(jointId.c_str(), sceneContext, nodeContext);
+                Node* n = loadNode(jointId + 1, sceneContext, nodeContext);
                 if (n && n->getType() == Node::JOINT)
                 {
                     Joint* joint = static_cast<Joint*>(n);
@@ -1161,37 +1472,37 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
                     // No parent currently set for this joint.
                     // Lookup its parentID in case it references a node that was not yet loaded as part
                     // of the mesh skin's joint list.
-                    std::string nodeId = node->getId();
+                    const char* nodeId = node->getId();
 
                     while (true)
                     {
                         // Get the node's type.
-                        Reference* ref = find(nodeId.c_str());
+                        Reference* ref = find(nodeId);
                         if (ref == NULL)
                         {
-                            GP_ERROR("No object with name '%s' in bundle '%s'.", nodeId.c_str(), _path.c_str());
+                            GP_ERROR("No object with name '%s' in bundle '%s'.", nodeId, _path.c_str());
                             return;
                         }
 
                         // Seek to the current node in the file so we can get it's parent ID.
-                        seekTo(nodeId.c_str(), ref->type);
+                        seekTo(nodeId, ref->type);
 
                         // Skip over the node type (1 unsigned int) and transform (16 floats) and read the parent id.
                         if (_stream->seek(sizeof(unsigned int) + sizeof(float)*16, SEEK_CUR) == false)
                         {
-                            GP_ERROR("Failed to skip over node type and transform for node '%s' in bundle '%s'.", nodeId.c_str(), _path.c_str());
+                            GP_ERROR("Failed to skip over node type and transform for node '%s' in bundle '%s'.", nodeId, _path.c_str());
                             return;
                         }
-                        std::string parentID = readString(_stream);
+                        const char* parentID = readString();
 
-                        if (!parentID.empty())
+                        if (*parentID != '\0')
                             nodeId = parentID;
                         else
                             break;
                     }
 
-                    if (nodeId != rootJoint->getId())
-                        loadedNodes.push_back(loadNode(nodeId.c_str(), sceneContext, nodeContext));
+                    if (strcmp(nodeId, rootJoint->getId()) != 0)
+                        loadedNodes.push_back(loadNode(nodeId, sceneContext, nodeContext));
 
                     break;
                 }
@@ -1218,20 +1529,20 @@ void Bundle::resolveJointReferences(Scene* sceneContext, Node* nodeContext)
 
 void Bundle::readAnimation(Scene* scene)
 {
-    const std::string animationId = readString(_stream);
+    const char* animationId = readString();
 
     // Read the number of animation channels in this animation.
     unsigned int animationChannelCount;
     if (!read(&animationChannelCount))
     {
-        GP_ERROR("Failed to read animation channel count for animation '%s'.", animationId.c_str());
+        GP_ERROR("Failed to read animation channel count for animation '%s'.", animationId);
         return;
     }
 
     Animation* animation = NULL;
     for (unsigned int i = 0; i < animationChannelCount; i++)
     {
-        animation = readAnimationChannel(scene, animation, animationId.c_str());
+        animation = readAnimationChannel(scene, animation, animationId);
     }
 }
 
@@ -1256,8 +1567,8 @@ Animation* Bundle::readAnimationChannel(Scene* scene, Animation* animation, cons
     GP_ASSERT(animationId);
 
     // Read target id.
-    std::string targetId = readString(_stream);
-    if (targetId.empty())
+    const char* targetId = readString();
+    if (*targetId == '\0')
     {
         GP_ERROR("Failed to read target id for animation '%s'.", animationId);
         return NULL;
@@ -1276,10 +1587,10 @@ Animation* Bundle::readAnimationChannel(Scene* scene, Animation* animation, cons
     // Search for a node that matches the target.
     if (!target)
     {
-        target = scene->findNode(targetId.c_str());
+        target = scene->findNode(targetId);
         if (!target)
         {
-            GP_ERROR("Failed to find the animation target (with id '%s') for animation '%s'.", targetId.c_str(), animationId);
+            GP_ERROR("Failed to find the animation target (with id '%s') for animation '%s'.", targetId, animationId);
             return NULL;
         }
     }
@@ -1291,11 +1602,17 @@ Animation* Bundle::readAnimationChannelData(Animation* animation, const char* id
 {
     GP_ASSERT(id);
 
+    // The arrays are only filled when their data can't be used in place in the bundle.
     std::vector<unsigned int> keyTimes;
     std::vector<float> values;
     std::vector<float> tangentsIn;
     std::vector<float> tangentsOut;
     std::vector<unsigned int> interpolation;
+    const unsigned int* keyTimesData;
+    const float* valuesData;
+    const float* tangentsInData;
+    const float* tangentsOutData;
+    const unsigned int* interpolationData;
 
     // Length of the arrays.
     unsigned int keyTimesCount;
@@ -1305,35 +1622,35 @@ Animation* Bundle::readAnimationChannelData(Animation* animation, const char* id
     unsigned int interpolationCount;
 
     // Read key times.
-    if (!readArray(&keyTimesCount, &keyTimes, sizeof(unsigned int)))
+    if (!readArray(&keyTimesCount, &keyTimesData, &keyTimes))
     {
         GP_ERROR("Failed to read key times for animation '%s'.", id);
         return NULL;
     }
 
     // Read key values.
-    if (!readArray(&valuesCount, &values))
+    if (!readArray(&valuesCount, &valuesData, &values))
     {
         GP_ERROR("Failed to read key values for animation '%s'.", id);
         return NULL;
     }
 
     // Read in-tangents.
-    if (!readArray(&tangentsInCount, &tangentsIn))
+    if (!readArray(&tangentsInCount, &tangentsInData, &tangentsIn))
     {
         GP_ERROR("Failed to read in tangents for animation '%s'.", id);
         return NULL;
     }
 
     // Read out-tangents.
-    if (!readArray(&tangentsOutCount, &tangentsOut))
+    if (!readArray(&tangentsOutCount, &tangentsOutData, &tangentsOut))
     {
         GP_ERROR("Failed to read out tangents for animation '%s'.", id);
         return NULL;
     }
 
     // Read interpolations.
-    if (!readArray(&interpolationCount, &interpolation, sizeof(unsigned int)))
+    if (!readArray(&interpolationCount, &interpolationData, &interpolation))
     {
         GP_ERROR("Failed to read the interpolation values for animation '%s'.", id);
         return NULL;
@@ -1342,15 +1659,19 @@ Animation* Bundle::readAnimationChannelData(Animation* animation, const char* id
     if (targetAttribute > 0)
     {
         GP_ASSERT(target);
-        GP_ASSERT(keyTimes.size() > 0 && values.size() > 0);
+        GP_ASSERT(keyTimesData && valuesData);
+
+        // The curves copy the keys, so the data in the bundle is only read.
+        unsigned int* times = const_cast<unsigned int*>(keyTimesData);
+        float* keyValues = const_cast<float*>(valuesData);
         if (animation == NULL)
         {
             // TODO: This code currently assumes LINEAR only.
-            animation = target->createAnimation(id, targetAttribute, keyTimesCount, &keyTimes[0], &values[0], Curve::LINEAR);
+            animation = target->createAnimation(id, targetAttribute, keyTimesCount, times, keyValues, Curve::LINEAR);
         }
         else
         {
-            animation->createChannel(target, targetAttribute, keyTimesCount, &keyTimes[0], &values[0], Curve::LINEAR);
+            animation->createChannel(target, targetAttribute, keyTimesCount, times, keyValues, Curve::LINEAR);
         }
     }
 
@@ -1359,6 +1680,7 @@ Animation* Bundle::readAnimationChannelData(Animation* animation, const char* id
 
 Mesh* Bundle::loadMesh(const char* id)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     return loadMesh(id, NULL);
 }
 
@@ -1375,20 +1697,31 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
         return NULL;
     }
 
-    // Seek to the specified mesh.
-    Reference* ref = seekTo(id, BUNDLE_TYPE_MESH);
-    if (ref == NULL)
+    // Use the mesh data if it was preloaded, otherwise read it.
+    MeshData* meshData = NULL;
+    std::map<std::string, MeshData*>::iterator itr = _preloadedMeshes.find(id);
+    if (itr != _preloadedMeshes.end())
     {
-        GP_ERROR("Failed to locate ref for mesh '%s'.", id);
-        return NULL;
+        meshData = itr->second;
+        _preloadedMeshes.erase(itr);
     }
-
-    // Read mesh data.
-    MeshData* meshData = readMeshData();
-    if (meshData == NULL)
+    else
     {
-        GP_ERROR("Failed to load mesh data for mesh '%s'.", id);
-        return NULL;
+        // Seek to the specified mesh.
+        Reference* ref = seekTo(id, BUNDLE_TYPE_MESH);
+        if (ref == NULL)
+        {
+            GP_ERROR("Failed to locate ref for mesh '%s'.", id);
+            return NULL;
+        }
+
+        // Read mesh data, in place when the bundle is mapped since it is uploaded right away.
+        meshData = readMeshData(true);
+        if (meshData == NULL)
+        {
+            GP_ERROR("Failed to load mesh data for mesh '%s'.", id);
+            return NULL;
+        }
     }
 
     // Create mesh.
@@ -1403,6 +1736,7 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
     mesh->_url = _path;
     mesh->_url += "#";
     mesh->_url += id;
+    RenderStats::setMemoryName(mesh, mesh->_url.c_str());
 
     mesh->setVertexData((float*)meshData->vertexData, 0, meshData->vertexCount);
 
@@ -1437,7 +1771,174 @@ Mesh* Bundle::loadMesh(const char* id, const char* nodeId)
     return mesh;
 }
 
-Bundle::MeshData* Bundle::readMeshData()
+bool Bundle::preloadNode(const char* id)
+{
+    GP_ASSERT(id);
+    GP_ASSERT(_stream);
+
+    // The node is only read for the IDs of its meshes, which are then preloaded one at a
+    // time, so that loads on the main thread wait for at most one mesh.
+    std::vector<std::string> meshIds;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (seekTo(id, BUNDLE_TYPE_NODE) == NULL || !readNodeMeshIds(&meshIds))
+        {
+            GP_WARN("Failed to preload node '%s' in bundle '%s'.", id, _path.c_str());
+            return false;
+        }
+    }
+
+    bool preloaded = true;
+    for (size_t i = 0, count = meshIds.size(); i < count; ++i)
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        preloaded &= preloadMeshData(meshIds[i].c_str());
+    }
+    return preloaded;
+}
+
+bool Bundle::preloadMesh(const char* id)
+{
+    GP_ASSERT(id);
+    GP_ASSERT(_stream);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    return preloadMeshData(id);
+}
+
+bool Bundle::preloadMeshData(const char* id)
+{
+    GP_ASSERT(id);
+
+    if (_preloadedMeshes.find(id) != _preloadedMeshes.end())
+        return true;
+
+    if (seekTo(id, BUNDLE_TYPE_MESH) == NULL)
+    {
+        GP_WARN("Failed to locate ref for mesh '%s' in bundle '%s'.", id, _path.c_str());
+        return false;
+    }
+
+    // Data read in place from a mapping is only paged in from the disk once it is touched.
+    MeshData* meshData = readMeshData(true);
+    if (meshData == NULL)
+    {
+        GP_WARN("Failed to preload mesh data for mesh '%s' in bundle '%s'.", id, _path.c_str());
+        return false;
+    }
+    if (meshData->mapped)
+        touchPages(meshData->vertexData, meshData->vertexCount * meshData->vertexFormat.getVertexSize());
+    for (size_t i = 0, count = meshData->parts.size(); i < count; ++i)
+    {
+        MeshPartData* partData = meshData->parts[i];
+        if (partData->mapped)
+        {
+            unsigned int indexSize = partData->indexFormat == Mesh::INDEX32 ? 4 : (partData->indexFormat == Mesh::INDEX16 ? 2 : 1);
+            touchPages(partData->indexData, partData->indexCount * indexSize);
+        }
+    }
+
+    _preloadedMeshes[id] = meshData;
+    return true;
+}
+
+bool Bundle::readNodeMeshIds(std::vector<std::string>* ids)
+{
+    GP_ASSERT(ids);
+    GP_ASSERT(_stream);
+
+    // Skip the node's type, transform and parent ID.
+    if (_stream->seek(sizeof(unsigned int) + sizeof(float) * 16, SEEK_CUR) == false)
+        return false;
+    readString();
+
+    // Read the node's children.
+    unsigned int childrenCount;
+    if (!read(&childrenCount))
+        return false;
+    for (unsigned int i = 0; i < childrenCount; i++)
+    {
+        if (!readNodeMeshIds(ids))
+            return false;
+    }
+
+    // Skip the camera and the light, which are a type followed by their floats.
+    unsigned char type;
+    if (!read(&type))
+        return false;
+    if (type != 0)
+    {
+        unsigned int floatCount = 3 + (type == Camera::PERSPECTIVE ? 1 : (type == Camera::ORTHOGRAPHIC ? 2 : 0));
+        if (_stream->seek(sizeof(float) * floatCount, SEEK_CUR) == false)
+            return false;
+    }
+    if (!read(&type))
+        return false;
+    if (type != 0)
+    {
+        unsigned int floatCount = 3 + (type == Light::POINT ? 1 : (type == Light::SPOT ? 3 : 0));
+        if (_stream->seek(sizeof(float) * floatCount, SEEK_CUR) == false)
+            return false;
+    }
+
+    // Read the model's mesh, and skip its skin and materials.
+    const char* xref = readString();
+    if (xref[0] == '#' && xref[1] != '\0')
+    {
+        ids->push_back(xref + 1);
+
+        unsigned char hasSkin;
+        if (!read(&hasSkin))
+            return false;
+        if (hasSkin)
+        {
+            unsigned int jointCount;
+            if (_stream->seek(sizeof(float) * 16, SEEK_CUR) == false || !read(&jointCount))
+                return false;
+            for (unsigned int i = 0; i < jointCount; i++)
+                readString();
+            unsigned int jointsBindPosesCount;
+            if (!read(&jointsBindPosesCount))
+                return false;
+            if (jointsBindPosesCount > 0 && _stream->seek(sizeof(float) * 16 * jointCount, SEEK_CUR) == false)
+                return false;
+        }
+
+        unsigned int materialCount;
+        if (!read(&materialCount))
+            return false;
+        for (unsigned int i = 0; i < materialCount; i++)
+            readString();
+
+        if (getVersionMajor() >= 1 && getVersionMinor() >= 6)
+        {
+            unsigned int lodCount;
+            if (!read(&lodCount))
+                return false;
+            for (unsigned int i = 0; i < lodCount; i++)
+            {
+                const char* lodXref = readString();
+                float screenSize;
+                if (!read(&screenSize))
+                    return false;
+                if (lodXref[0] == '#' && lodXref[1] != '\0')
+                    ids->push_back(lodXref + 1);
+            }
+        }
+
+        if (getVersionMajor() > BUNDLE_VERSION_MAJOR_LIGHTMAPS ||
+            (getVersionMajor() == BUNDLE_VERSION_MAJOR_LIGHTMAPS && getVersionMinor() >= BUNDLE_VERSION_MINOR_LIGHTMAPS))
+        {
+            readString();
+            if (_stream->seek(sizeof(float) * 4, SEEK_CUR) == false)
+                return false;
+        }
+    }
+
+    return true;
+}
+
+Bundle::MeshData* Bundle::readMeshData(bool mapped)
 {
     // Read vertex format/elements.
     unsigned int vertexElementCount;
@@ -1471,6 +1972,26 @@ Bundle::MeshData* Bundle::readMeshData()
 
         vertexElements[i].usage = (VertexFormat::Usage)vUsage;
         vertexElements[i].size = vSize;
+
+        if (getVersionMajor() > BUNDLE_VERSION_MAJOR_VERTEX_TYPES ||
+            (getVersionMajor() == BUNDLE_VERSION_MAJOR_VERTEX_TYPES && getVersionMinor() >= BUNDLE_VERSION_MINOR_VERTEX_TYPES))
+        {
+            unsigned int vType, vNormalized;
+            if (_stream->read(&vType, 4, 1) != 1 || _stream->read(&vNormalized, 4, 1) != 1)
+            {
+                GP_ERROR("Failed to load vertex type.");
+                SAFE_DELETE_ARRAY(vertexElements);
+                return NULL;
+            }
+            if (vType > VertexFormat::INT_2_10_10_10_REV || (vType == VertexFormat::INT_2_10_10_10_REV && vSize != 4))
+            {
+                GP_ERROR("Failed to load mesh data; invalid vertex type %u.", vType);
+                SAFE_DELETE_ARRAY(vertexElements);
+                return NULL;
+            }
+            vertexElements[i].type = (VertexFormat::Type)vType;
+            vertexElements[i].normalized = vNormalized != 0;
+        }
     }
 
     MeshData* meshData = new MeshData(VertexFormat(vertexElements, vertexElementCount));
@@ -1493,8 +2014,17 @@ Bundle::MeshData* Bundle::readMeshData()
 
     GP_ASSERT(meshData->vertexFormat.getVertexSize());
     meshData->vertexCount = vertexByteCount / meshData->vertexFormat.getVertexSize();
-    meshData->vertexData = new unsigned char[vertexByteCount];
-    if (_stream->read(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
+    if (!skipPadding(BUNDLE_MESH_DATA_ALIGNMENT))
+    {
+        GP_ERROR("Failed to skip the padding of vertex data.");
+        SAFE_DELETE(meshData);
+        return NULL;
+    }
+    meshData->vertexData = mapped ? (unsigned char*)readMapped(vertexByteCount, 1) : NULL;
+    meshData->mapped = meshData->vertexData != NULL;
+    if (!meshData->mapped)
+        meshData->vertexData = new unsigned char[vertexByteCount];
+    if (!meshData->mapped && _stream->read(meshData->vertexData, 1, vertexByteCount) != vertexByteCount)
     {
         GP_ERROR("Failed to load vertex data.");
         SAFE_DELETE(meshData);
@@ -1571,9 +2101,18 @@ Bundle::MeshData* Bundle::readMeshData()
 
         GP_ASSERT(indexSize);
         partData->indexCount = iByteCount / indexSize;
+        if (!skipPadding(BUNDLE_MESH_DATA_ALIGNMENT))
+        {
+            GP_ERROR("Failed to skip the padding of index data for mesh part with index %d.", i);
+            SAFE_DELETE(meshData);
+            return NULL;
+        }
 
-        partData->indexData = new unsigned char[iByteCount];
-        if (_stream->read(partData->indexData, 1, iByteCount) != iByteCount)
+        partData->indexData = mapped ? (unsigned char*)readMapped(iByteCount, 1) : NULL;
+        partData->mapped = partData->indexData != NULL;
+        if (!partData->mapped)
+            partData->indexData = new unsigned char[iByteCount];
+        if (!partData->mapped && _stream->read(partData->indexData, 1, iByteCount) != iByteCount)
         {
             GP_ERROR("Failed to read index data for mesh part with index %d.", i);
             SAFE_DELETE(meshData);
@@ -1616,6 +2155,7 @@ Bundle::MeshData* Bundle::readMeshData(const char* url)
     }
 
     // Seek to mesh with specified ID in bundle.
+    std::unique_lock<std::mutex> lock(bundle->_mutex);
     Reference* ref = bundle->seekTo(id.c_str(), BUNDLE_TYPE_MESH);
     if (ref == NULL)
     {
@@ -1625,6 +2165,7 @@ Bundle::MeshData* Bundle::readMeshData(const char* url)
 
     // Read mesh data from current file position.
     MeshData* meshData = bundle->readMeshData();
+    lock.unlock();
 
     SAFE_RELEASE(bundle);
 
@@ -1636,6 +2177,8 @@ Font* Bundle::loadFont(const char* id)
     GP_ASSERT(id);
     GP_ASSERT(_stream);
 
+    std::lock_guard<std::mutex> lock(_mutex);
+
     // Seek to the specified font.
     Reference* ref = seekTo(id, BUNDLE_TYPE_FONT);
     if (ref == NULL)
@@ -1645,8 +2188,8 @@ Font* Bundle::loadFont(const char* id)
     }
 
     // Read font family.
-    std::string family = readString(_stream);
-    if (family.empty())
+    const char* family = readString();
+    if (*family == '\0')
     {
         GP_ERROR("Failed to read font family for font '%s'.", id);
         return NULL;
@@ -1683,8 +2226,8 @@ Font* Bundle::loadFont(const char* id)
             return NULL;
         }
 
-        // Read character set.
-        std::string charset = readString(_stream);
+        // Skip the character set.
+        readString();
 
         // Read font glyphs.
         unsigned int glyphCount;
@@ -1808,7 +2351,7 @@ Font* Bundle::loadFont(const char* id)
         }
 
         // Create the font for this size
-        Font* font = Font::create(family.c_str(), Font::PLAIN, size, glyphs, glyphCount, texture, (Font::Format)format);
+        Font* font = Font::create(family, Font::PLAIN, size, glyphs, glyphCount, texture, (Font::Format)format);
 
         // Free the glyph array.
         SAFE_DELETE_ARRAY(glyphs);
@@ -1858,11 +2401,11 @@ unsigned int Bundle::getObjectCount() const
 const char* Bundle::getObjectId(unsigned int index) const
 {
     GP_ASSERT(_references);
-    return (index >= _referenceCount ? NULL : _references[index].id.c_str());
+    return (index >= _referenceCount ? NULL : _references[index].id);
 }
 
 Bundle::Reference::Reference()
-    : type(0), offset(0)
+    : id(""), type(0), offset(0)
 {
 }
 
@@ -1871,23 +2414,25 @@ Bundle::Reference::~Reference()
 }
 
 Bundle::MeshPartData::MeshPartData() :
-		primitiveType(Mesh::TRIANGLES), indexFormat(Mesh::INDEX32), indexCount(0), indexData(NULL)
+		primitiveType(Mesh::TRIANGLES), indexFormat(Mesh::INDEX32), indexCount(0), indexData(NULL), mapped(false)
 {
 }
 
 Bundle::MeshPartData::~MeshPartData()
 {
-    SAFE_DELETE_ARRAY(indexData);
+    if (!mapped)
+        SAFE_DELETE_ARRAY(indexData);
 }
 
 Bundle::MeshData::MeshData(const VertexFormat& vertexFormat)
-    : vertexFormat(vertexFormat), vertexCount(0), vertexData(NULL), primitiveType(Mesh::TRIANGLES)
+    : vertexFormat(vertexFormat), vertexCount(0), vertexData(NULL), mapped(false), primitiveType(Mesh::TRIANGLES)
 {
 }
 
 Bundle::MeshData::~MeshData()
 {
-    SAFE_DELETE_ARRAY(vertexData);
+    if (!mapped)
+        SAFE_DELETE_ARRAY(vertexData);
 
     for (unsigned int i = 0; i < parts.size(); ++i)
     {
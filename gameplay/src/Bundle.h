@@ -13,11 +13,16 @@ namespace gameplay
 /**
  * Defines a gameplay bundle file (.gpb) that contains a
  * collection of binary game assets that can be loaded.
+ *
+ * The ids that a bundle refers to its objects by are interned in the StringPool as
+ * they are read, so that they are compared by pointer. Bundles from version 1.11 on
+ * hold all their strings in a table that is read once when the bundle is opened.
  */
 class Bundle : public Ref
 {
     friend class PhysicsController;
     friend class SceneLoader;
+    friend class Mesh;
 
 public:
 
@@ -67,6 +72,36 @@ public:
      */
     Mesh* loadMesh(const char* id);
 
+    /**
+     * Reads the vertex and index data of the meshes of the node with the given ID, including
+     * those of its children, so that loading the node later only creates its objects and
+     * uploads the data.
+     *
+     * This method may be called from any thread, such as a worker of the job controller,
+     * while the bundle stays open on the main thread. The reference table of the bundle is
+     * always resident, but the data of its meshes stays on disk until it is loaded or preloaded.
+     * The preloaded data is kept until the meshes are loaded or the bundle is destroyed.
+     *
+     * @param id The ID of the node in the bundle.
+     *
+     * @return true if the meshes of the node were preloaded, false otherwise.
+     * @script{ignore}
+     */
+    bool preloadNode(const char* id);
+
+    /**
+     * Reads the vertex and index data of the mesh with the given ID, so that loading the
+     * mesh later only uploads the data.
+     *
+     * This method may be called from any thread, like preloadNode.
+     *
+     * @param id The ID of the mesh in the bundle.
+     *
+     * @return true if the mesh was preloaded, false otherwise.
+     * @script{ignore}
+     */
+    bool preloadMesh(const char* id);
+
     /**
      * Loads a font with the specified ID from the bundle.
      *
@@ -119,7 +154,7 @@ private:
     class Reference
     {
     public:
-        std::string id;
+        const char* id;
         unsigned int type;
         unsigned int offset;
 
@@ -137,7 +172,7 @@ private:
     struct MeshSkinData
     {
         MeshSkin* skin;
-        std::vector<std::string> joints;
+        std::vector<const char*> joints;
         std::vector<Matrix> inverseBindPoseMatrices;
     };
 
@@ -150,6 +185,7 @@ private:
         Mesh::IndexFormat indexFormat;
         unsigned int indexCount;
         unsigned char* indexData;
+        bool mapped;
     };
 
     struct MeshData
@@ -160,6 +196,7 @@ private:
         VertexFormat vertexFormat;
         unsigned int vertexCount;
         unsigned char* vertexData;
+        bool mapped;
         BoundingBox boundingBox;
         BoundingSphere boundingSphere;
         Mesh::PrimitiveType primitiveType;
@@ -282,6 +319,13 @@ private:
      */
     bool read(float* ptr);
 
+    /**
+     * Reads a string from the current file position.
+     *
+     * @return The string, interned in the StringPool, or an empty string if an error occurred.
+     */
+    const char* readString();
+
     /**
      * Reads an array of values and the array length from the current file position.
      * 
@@ -315,6 +359,40 @@ private:
      */
     template <class T>
     bool readArray(unsigned int* length, std::vector<T>* values, unsigned int readSize);
+
+    /**
+     * Reads an array of values and the array length from the current file position, in
+     * place when the bundle is mapped into memory.
+     *
+     * @param length A pointer to where the length of the array will be copied to.
+     * @param ptr A pointer to where a pointer to the values will be copied to, which is NULL for an empty array.
+     * @param values The vector that the values are copied to when they can't be used in place.
+     *
+     * @return True if successful, false if an error occurred.
+     */
+    template <class T>
+    bool readArray(unsigned int* length, const T** ptr, std::vector<T>* values);
+
+    /**
+     * Skips over the given number of bytes from the current file position and returns them
+     * in place, when the bundle is mapped into memory and they are suitably aligned.
+     *
+     * @param byteCount The number of bytes to skip over.
+     * @param alignment The alignment in bytes the data must have to be used in place.
+     *
+     * @return The data within the mapping, or NULL if it must be read into a copy instead.
+     */
+    const void* readMapped(size_t byteCount, size_t alignment);
+
+    /**
+     * Skips over the padding that aligns the data at the current file position to the given
+     * number of bytes. Bundles older than version 1.7 have no padding.
+     *
+     * @param alignment The alignment of the data in bytes.
+     *
+     * @return True if successful, false if an error occurred.
+     */
+    bool skipPadding(unsigned int alignment);
     
     /**
      * Reads 16 floats from the current file position.
@@ -365,8 +443,11 @@ private:
 
     /**
      * Reads mesh data from the current file position.
+     *
+     * @param mapped True to point the vertex and index data into the mapping of the bundle
+     *      where possible, so that it is not copied. Such data is only valid while the bundle is.
      */
-    MeshData* readMeshData();
+    MeshData* readMeshData(bool mapped = false);
 
     /**
      * Reads mesh data for the specified URL.
@@ -450,15 +531,34 @@ private:
      */
     bool skipNode();
 
+    /**
+     * Reads over a Node's data within a bundle, without creating any objects, and adds the IDs
+     * of the meshes of its models and those of its children to the given list.
+     *
+     * @return True if the Node was successfully read; false otherwise.
+     */
+    bool readNodeMeshIds(std::vector<std::string>* ids);
+
+    /**
+     * Reads the data of the mesh with the given ID into the preloaded meshes, unless it is already there.
+     * The caller must hold the lock of the bundle.
+     */
+    bool preloadMeshData(const char* id);
+
     unsigned char _version[2];
     std::string _path;
     std::string _materialPath;
     unsigned int _referenceCount;
     Reference* _references;
     Stream* _stream;
+    const unsigned char* _data;
 
     std::vector<MeshSkinData*> _meshSkins;
-    std::map<std::string, Node*>* _trackedNodes;
+    std::vector<const char*> _strings;
+    std::map<const char*, Node*>* _trackedNodes;
+    std::map<std::string, MeshData*> _preloadedMeshes;
+    // Serializes the use of the stream between the main thread and preloads on other threads.
+    std::mutex _mutex;
 };
 
 }
@@ -22,13 +22,13 @@ namespace gameplay
 
 Camera::Camera(float fieldOfView, float aspectRatio, float nearPlane, float farPlane)
     : _type(PERSPECTIVE), _fieldOfView(fieldOfView), _aspectRatio(aspectRatio), _nearPlane(nearPlane), _farPlane(farPlane),
-    _bits(CAMERA_DIRTY_ALL), _node(NULL), _listeners(NULL)
+    _bits(CAMERA_DIRTY_ALL), _viewVersion(0), _node(NULL), _listeners(NULL)
 {
 }
 
 Camera::Camera(float zoomX, float zoomY, float aspectRatio, float nearPlane, float farPlane)
     : _type(ORTHOGRAPHIC), _aspectRatio(aspectRatio), _nearPlane(nearPlane), _farPlane(farPlane),
-	_bits(CAMERA_DIRTY_ALL), _node(NULL), _listeners(NULL)
+	_bits(CAMERA_DIRTY_ALL), _viewVersion(0), _node(NULL), _listeners(NULL)
 {
     // Orthographic camera.
     _zoom[0] = zoomX;
@@ -230,6 +230,7 @@ void Camera::setNode(Node* node)
         }
 
         _bits |= CAMERA_DIRTY_VIEW | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_INV_VIEW | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+        ++_viewVersion;
         cameraChanged();
     }
 }
@@ -241,7 +242,7 @@ const Matrix& Camera::getViewMatrix() const
         if (_node)
         {
             // The view matrix is the inverse of our transform matrix.
-            _node->getWorldMatrix().invert(&_view);
+            _node->getWorldMatrix().invertAffine(&_view);
         }
         else
         {
@@ -258,7 +259,7 @@ const Matrix& Camera::getInverseViewMatrix() const
 {
     if (_bits & CAMERA_DIRTY_INV_VIEW)
     {
-        getViewMatrix().invert(&_inverseView);
+        getViewMatrix().invertAffine(&_inverseView);
 
         _bits &= ~CAMERA_DIRTY_INV_VIEW;
     }
@@ -453,6 +454,7 @@ Camera* Camera::clone(NodeCloneContext& context)
 void Camera::transformChanged(Transform* transform, long cookie)
 {
     _bits |= CAMERA_DIRTY_VIEW | CAMERA_DIRTY_INV_VIEW | CAMERA_DIRTY_INV_VIEW_PROJ | CAMERA_DIRTY_VIEW_PROJ | CAMERA_DIRTY_BOUNDS;
+    ++_viewVersion;
 
     cameraChanged();
 }
@@ -373,6 +373,7 @@ private:
     mutable Matrix _inverseViewProjection;
     mutable Frustum _bounds;
     mutable int _bits;
+    unsigned int _viewVersion;
     Node* _node;
     std::list<Camera::Listener*>* _listeners;
 };
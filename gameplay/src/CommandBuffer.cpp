@@ -0,0 +1,193 @@
+#include "Base.h"
+#include "CommandBuffer.h"
+#include "Game.h"
+#include "Scene.h"
+#include "Node.h"
+#include "Model.h"
+#include "MeshPart.h"
+#include "Technique.h"
+#include "Pass.h"
+
+namespace gameplay
+{
+
+CommandBuffer::CommandBuffer()
+    : _frustum(NULL), _view(NULL), _viewProjection(NULL)
+{
+}
+
+CommandBuffer::~CommandBuffer()
+{
+}
+
+CommandBuffer* CommandBuffer::create()
+{
+    return new CommandBuffer();
+}
+
+void CommandBuffer::add(Node* node)
+{
+    GP_ASSERT(node);
+
+    Scene* scene = node->getScene();
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (camera)
+        record(node, &camera->getViewMatrix(), &camera->getViewProjectionMatrix(), &_recording);
+    else
+        record(node, &Matrix::identity(), &Matrix::identity(), &_recording);
+}
+
+void CommandBuffer::add(Scene* scene, bool cull)
+{
+    GP_ASSERT(scene);
+
+    // The active camera is resolved by visitParallel before any node is recorded,
+    // so its matrices and frustum are only read by the worker threads.
+    Camera* camera = scene->getActiveCamera();
+    _view = camera ? &camera->getViewMatrix() : &Matrix::identity();
+    _viewProjection = camera ? &camera->getViewProjectionMatrix() : &Matrix::identity();
+    _frustum = (cull && camera) ? &camera->getFrustum() : NULL;
+
+    std::vector<Recording> recordings;
+    scene->visitParallel(this, &CommandBuffer::recordNode, recordings);
+
+    for (size_t i = 0, count = recordings.size(); i < count; ++i)
+    {
+        Recording& recording = recordings[i];
+        int offset = (int)_recording.uniforms.size();
+        for (size_t j = 0, commandCount = recording.commands.size(); j < commandCount; ++j)
+        {
+            Command command = recording.commands[j];
+            if (command.uniforms >= 0)
+                command.uniforms += offset;
+            _recording.commands.push_back(command);
+        }
+        _recording.uniforms.insert(_recording.uniforms.end(), recording.uniforms.begin(), recording.uniforms.end());
+    }
+
+    _frustum = NULL;
+    _view = NULL;
+    _viewProjection = NULL;
+}
+
+void CommandBuffer::append(const CommandBuffer* buffer)
+{
+    GP_ASSERT(buffer);
+
+    int offset = (int)_recording.uniforms.size();
+    for (size_t i = 0, count = buffer->_recording.commands.size(); i < count; ++i)
+    {
+        Command command = buffer->_recording.commands[i];
+        if (command.uniforms >= 0)
+            command.uniforms += offset;
+        _recording.commands.push_back(command);
+    }
+    _recording.uniforms.insert(_recording.uniforms.end(), buffer->_recording.uniforms.begin(), buffer->_recording.uniforms.end());
+}
+
+unsigned int CommandBuffer::getCommandCount() const
+{
+    return (unsigned int)_recording.commands.size();
+}
+
+unsigned int CommandBuffer::execute(bool wireframe)
+{
+    for (size_t i = 0, count = _recording.commands.size(); i < count; ++i)
+    {
+        const Command& command = _recording.commands[i];
+        if (command.model == NULL)
+        {
+            command.drawable->draw(wireframe);
+            continue;
+        }
+
+        // Techniques are resolved here rather than while recording, since checking
+        // whether an effect finished compiling may have to call into OpenGL.
+        Technique* technique = command.material->getReadyTechnique();
+        if (technique == NULL)
+            continue;
+
+        RenderState::_objectBlockData = command.uniforms >= 0 ? &_recording.uniforms[command.uniforms] : NULL;
+        for (unsigned int j = 0, passCount = technique->getPassCount(); j < passCount; ++j)
+        {
+            Pass* pass = technique->getPassByIndex(j);
+            GP_ASSERT(pass);
+            command.model->drawPass(command.part, pass, wireframe);
+        }
+        RenderState::_objectBlockData = NULL;
+    }
+    return (unsigned int)_recording.commands.size();
+}
+
+void CommandBuffer::clear()
+{
+    _recording.commands.clear();
+    _recording.uniforms.clear();
+}
+
+void CommandBuffer::record(Node* node, const Matrix* view, const Matrix* viewProjection, Recording* recording)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(recording);
+
+    Drawable* drawable = node->getDrawable();
+    if (!drawable)
+        return;
+
+    Command command;
+    command.drawable = drawable;
+    command.model = dynamic_cast<Model*>(drawable);
+    command.part = NULL;
+    command.material = NULL;
+    command.uniforms = -1;
+    if (command.model == NULL)
+    {
+        recording->commands.push_back(command);
+        return;
+    }
+
+#ifdef GP_USE_UNIFORM_BUFFERS
+    // All parts of a model share the transform uniforms of its node.
+    command.uniforms = (int)recording->uniforms.size();
+    recording->uniforms.resize(recording->uniforms.size() + RenderState::OBJECT_BLOCK_FLOAT_COUNT);
+    RenderState::computeObjectBlock(node->getWorldMatrix(), *view, *viewProjection, &recording->uniforms[command.uniforms]);
+#endif
+
+    // Each model is only recorded by the worker that visits its node, so the level of
+    // detail can be selected while recording.
+    Mesh* mesh = command.model->selectLOD(NULL);
+    GP_ASSERT(mesh);
+    unsigned int partCount = mesh->getPartCount();
+    if (partCount == 0)
+    {
+        command.material = command.model->getMaterial();
+        if (command.material)
+            recording->commands.push_back(command);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < partCount; ++i)
+        {
+            command.part = mesh->getPart(i);
+            command.material = command.model->getMaterial(i);
+            if (command.material)
+                recording->commands.push_back(command);
+        }
+    }
+}
+
+bool CommandBuffer::recordNode(Node* node, Recording* recording)
+{
+    GP_ASSERT(node);
+
+    if (!node->isEnabled())
+        return false;
+
+    if (node->getDrawable() && (_frustum == NULL || node->getBoundingSphere().intersects(*_frustum)))
+    {
+        record(node, _view, _viewProjection, recording);
+    }
+    return true;
+}
+
+}
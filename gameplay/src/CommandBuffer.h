@@ -0,0 +1,161 @@
+#ifndef COMMANDBUFFER_H_
+#define COMMANDBUFFER_H_
+
+#include "Frustum.h"
+#include "Matrix.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+class Drawable;
+class Model;
+class MeshPart;
+class Material;
+
+/**
+ * Defines a buffer of recorded draw commands that is replayed on the render thread.
+ *
+ * Recording a node into a command buffer does not call into OpenGL: it only stores which
+ * mesh parts are drawn with which materials, along with a snapshot of the per-object
+ * transform uniforms of the node. This allows scenes to be recorded on the worker threads
+ * of the game's job controller, while the OpenGL calls are issued by replaying the flat
+ * array of commands from the render thread with execute().
+ *
+ * When an effect declares the per-object uniform block (see RenderState), replaying a
+ * command uploads the recorded uniform data instead of computing it from the node again.
+ * Drawables other than models, such as terrains, forms, text and particle emitters,
+ * bind their own state and are recorded as a single command that draws them as a whole.
+ *
+ * The buffer does not hold references to the nodes, drawables or materials it records,
+ * so it should be recorded, executed and cleared within a single frame.
+ *
+ * @see RenderQueue
+ * @script{ignore}
+ */
+class CommandBuffer
+{
+public:
+
+    /**
+     * Creates a new, empty command buffer.
+     *
+     * @return A new command buffer.
+     */
+    static CommandBuffer* create();
+
+    /**
+     * Destructor.
+     */
+    ~CommandBuffer();
+
+    /**
+     * Records the drawable attached to the given node.
+     *
+     * Nothing is recorded if the node has no drawable. The node is not culled.
+     *
+     * @param node The node to record.
+     */
+    void add(Node* node);
+
+    /**
+     * Records the drawables of all enabled nodes of the given scene using the worker
+     * threads of the game's job controller.
+     *
+     * The scene is visited with Scene::visitParallel, so transforms and the active camera
+     * of the scene are resolved before recording starts.
+     *
+     * @param scene The scene to record.
+     * @param cull True to skip nodes that are outside of the view frustum of the active camera.
+     */
+    void add(Scene* scene, bool cull = true);
+
+    /**
+     * Appends the commands of another command buffer to this buffer.
+     *
+     * @param buffer The command buffer to append.
+     */
+    void append(const CommandBuffer* buffer);
+
+    /**
+     * Returns the number of commands in the buffer.
+     *
+     * @return The number of commands.
+     */
+    unsigned int getCommandCount() const;
+
+    /**
+     * Replays all commands in the buffer in the order in which they were recorded.
+     *
+     * This method must be called from the render thread. The commands remain in the
+     * buffer, so the same commands can be executed again.
+     *
+     * @param wireframe True to draw meshes with wireframe, if supported.
+     *
+     * @return The number of commands executed.
+     */
+    unsigned int execute(bool wireframe = false);
+
+    /**
+     * Removes all commands from the buffer.
+     */
+    void clear();
+
+private:
+
+    /**
+     * A mesh part of a model drawn with a material, or a whole drawable if the model is NULL.
+     */
+    struct Command
+    {
+        Drawable* drawable;
+        Model* model;
+        MeshPart* part;
+        Material* material;
+        int uniforms;
+    };
+
+    /**
+     * The commands and uniform data recorded by a single worker thread.
+     */
+    struct Recording
+    {
+        std::vector<Command> commands;
+        std::vector<float> uniforms;
+    };
+
+    /**
+     * Constructor.
+     */
+    CommandBuffer();
+
+    /**
+     * Hidden copy constructor.
+     */
+    CommandBuffer(const CommandBuffer& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    CommandBuffer& operator=(const CommandBuffer&);
+
+    /**
+     * Records the drawable of the given node into the given recording.
+     */
+    static void record(Node* node, const Matrix* view, const Matrix* viewProjection, Recording* recording);
+
+    /**
+     * Visits the nodes of a scene being recorded in parallel.
+     */
+    bool recordNode(Node* node, Recording* recording);
+
+    Recording _recording;
+    const Frustum* _frustum;
+    const Matrix* _view;
+    const Matrix* _viewProjection;
+};
+
+}
+
+#endif
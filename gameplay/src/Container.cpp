@@ -57,7 +57,8 @@ Container::Container()
       _scrollingMouseVertically(false), _scrollingMouseHorizontally(false),
       _scrollBarOpacityClip(NULL), _zIndexDefault(0),
       _selectButtonDown(false), _lastFrameTime(0), _totalWidth(0), _totalHeight(0),
-      _initializedWithScroll(false), _scrollWheelRequiresFocus(false)
+      _initializedWithScroll(false), _scrollWheelRequiresFocus(false), _cached(false), _refreshInterval(0.0f),
+      _cacheDirty(true), _cacheDrawing(false), _cacheTime(0.0), _cacheFrameBuffer(NULL), _cacheBatch(NULL)
 {
 	clearContacts();
 }
@@ -71,6 +72,7 @@ Container::~Container()
         SAFE_RELEASE((*it));
     }
     SAFE_RELEASE(_layout);
+    releaseCache();
 }
 
 Container* Container::create(const char* id, Theme::Style* style, Layout::Type layout)
@@ -127,6 +129,9 @@ void Container::initialize(const char* typeName, Theme::Style* style, Properties
 			_scrollingFriction = properties->getFloat("scrollingFriction");
 		if (properties->exists("scrollWheelSpeed"))
 			_scrollWheelSpeed = properties->getFloat("scrollWheelSpeed");
+		_cached = properties->getBool("cached");
+		if (properties->exists("refreshInterval"))
+			_refreshInterval = properties->getFloat("refreshInterval");
 
 		addControls(properties);
 
@@ -246,7 +251,8 @@ unsigned int Container::addControl(Control* control)
 	control->_parent = this;
 
 	sortControls();
-    setDirty(Control::DIRTY_BOUNDS);
+    setDirty(Control::DIRTY_BOUNDS | Control::DIRTY_CHILDREN);
+    setHitGridDirty();
 
 	return (unsigned int)( _controls.size() - 1 );
 }
@@ -266,7 +272,8 @@ void Container::insertControl(Control* control, unsigned int index)
         _controls.insert(it, control);
         control->addRef();
         control->_parent = this;
-        setDirty(Control::DIRTY_BOUNDS);
+        setDirty(Control::DIRTY_BOUNDS | Control::DIRTY_CHILDREN);
+        setHitGridDirty();
     }
 }
 
@@ -279,6 +286,7 @@ void Container::removeControl(unsigned int index)
     _controls.erase(it);
     control->_parent = NULL;
     setDirty(Control::DIRTY_BOUNDS);
+    setHitGridDirty();
 
     if (_activeControl == control)
         _activeControl = NULL;
@@ -425,8 +433,8 @@ const Vector2& Container::getScrollPosition() const
 void Container::setScrollPosition(const Vector2& scrollPosition)
 {
     _scrollPosition = scrollPosition;
-    setDirty(DIRTY_BOUNDS);
-    setChildrenDirty(DIRTY_BOUNDS, true);
+    setDirty(DIRTY_ABSOLUTE_BOUNDS);
+    setChildrenDirty(DIRTY_ABSOLUTE_BOUNDS, false);
 }
 
 Animation* Container::getAnimation(const char* id) const
@@ -629,13 +637,16 @@ bool Container::updateChildBounds()
         Control* ctrl = _controls[i];
         GP_ASSERT(ctrl);
 
-        if (ctrl->isVisible())
+        // Clean children, and the branches below them, have nothing to update.
+        if (ctrl->isVisible() && ctrl->_dirtyBits != 0)
         {
+            Rectangle oldBounds(ctrl->_bounds);
             bool changed = ctrl->updateBoundsInternal(_scrollPosition);
 
-            // If the child bounds have changed, dirty our bounds and all of our
-            // parent bounds so that our layout and/or bounds are recomputed.
-            if (changed)
+            // If the child was resized or moved within us, dirty our bounds and all of our
+            // parent bounds so that our layout and/or bounds are recomputed. Children that
+            // only scrolled or moved along with us leave them as they are.
+            if (ctrl->_bounds != oldBounds)
             {
                 Control* parent = this;
                 while (parent && (parent->_autoSize != AUTO_SIZE_NONE || static_cast<Container *>(parent)->getLayout()->getType() != Layout::LAYOUT_ABSOLUTE))
@@ -657,6 +668,16 @@ unsigned int Container::draw(Form* form, const Rectangle& clip)
     if (!_visible)
         return 0;
 
+    // Draw the contents of a cached container from its frame buffer, unless they are being drawn into it
+    if (_cacheBatch && !_cacheDrawing)
+    {
+        startBatch(form, _cacheBatch);
+        _cacheBatch->draw(_absoluteBounds.x, _absoluteBounds.y, (float)_cacheFrameBuffer->getWidth(), (float)_cacheFrameBuffer->getHeight(),
+            0.0f, 1.0f, 1.0f, 0.0f, Vector4::one(), _absoluteClipBounds);
+        finishBatch(form, _cacheBatch);
+        return 1;
+    }
+
     // Draw container skin
     unsigned int drawCalls = Control::draw(form, clip);
 
@@ -1082,30 +1103,7 @@ void Container::updateScroll()
     const Theme::Padding& containerPadding = getPadding();
 
     // Calculate total width and height.
-    _totalWidth = _totalHeight = 0.0f;
-    std::vector<Control*> controls = getControls();
-    for (size_t i = 0, count = controls.size(); i < count; ++i)
-    {
-        Control* control = _controls[i];
-
-        if (!control->isVisible())
-            continue;
-
-        const Rectangle& bounds = control->getBounds();
-        const Theme::Margin& margin = control->getMargin();
-
-        float newWidth = bounds.x + bounds.width + margin.right;
-        if (newWidth > _totalWidth)
-        {
-            _totalWidth = newWidth;
-        }
-
-        float newHeight = bounds.y + bounds.height + margin.bottom;
-        if (newHeight > _totalHeight)
-        {
-            _totalHeight = newHeight;
-        }
-    }
+    measureContents(&_totalWidth, &_totalHeight);
 
     float vWidth = getImageRegion("verticalScrollBar", state).width;
     float hHeight = getImageRegion("horizontalScrollBar", state).height;
@@ -1197,8 +1195,37 @@ void Container::updateScroll()
     // absolute bounds offset will need to be updated.
     if (dirty)
     {
-        setDirty(DIRTY_BOUNDS);
-        setChildrenDirty(DIRTY_BOUNDS, true);
+        setDirty(DIRTY_ABSOLUTE_BOUNDS);
+        setChildrenDirty(DIRTY_ABSOLUTE_BOUNDS, false);
+    }
+}
+
+void Container::measureContents(float* width, float* height)
+{
+    GP_ASSERT(width && height);
+
+    *width = *height = 0.0f;
+    for (size_t i = 0, count = _controls.size(); i < count; ++i)
+    {
+        Control* control = _controls[i];
+
+        if (!control->isVisible())
+            continue;
+
+        const Rectangle& bounds = control->getBounds();
+        const Theme::Margin& margin = control->getMargin();
+
+        float newWidth = bounds.x + bounds.width + margin.right;
+        if (newWidth > *width)
+        {
+            *width = newWidth;
+        }
+
+        float newHeight = bounds.y + bounds.height + margin.bottom;
+        if (newHeight > *height)
+        {
+            *height = newHeight;
+        }
     }
 }
 
@@ -1207,9 +1234,17 @@ void Container::sortControls()
     if (_layout->getType() == Layout::LAYOUT_ABSOLUTE)
     {
         std::sort(_controls.begin(), _controls.end(), &sortControlsByZOrder);
+        setHitGridDirty();
     }
 }
 
+void Container::setHitGridDirty()
+{
+    Form* form = getTopLevelForm();
+    if (form)
+        form->_hitGridDirty = true;
+}
+
 bool Container::touchEventScroll(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
 {
     switch (evt)
@@ -1295,8 +1330,8 @@ bool Container::touchEventScroll(Touch::TouchEvent evt, int x, int y, unsigned i
                 _scrollingStartTimeY = gameTime;
 
             _scrollingLastTime = gameTime;
-            setDirty(DIRTY_BOUNDS);
-            setChildrenDirty(DIRTY_BOUNDS, true);
+            setDirty(DIRTY_ABSOLUTE_BOUNDS);
+            setChildrenDirty(DIRTY_ABSOLUTE_BOUNDS, false);
             updateScroll();
             return false;
         }
@@ -1430,8 +1465,8 @@ bool Container::mouseEventScroll(Mouse::MouseEvent evt, int x, int y, int wheelD
 
             if (dirty)
             {
-                setDirty(DIRTY_BOUNDS);
-                setChildrenDirty(DIRTY_BOUNDS, true);
+                setDirty(DIRTY_ABSOLUTE_BOUNDS);
+                setChildrenDirty(DIRTY_ABSOLUTE_BOUNDS, false);
             }
 
             return touchEventScroll(Touch::TOUCH_PRESS, x, y, 0);
@@ -1526,6 +1561,108 @@ void Container::setScrollWheelSpeed(float speed)
     _scrollWheelSpeed = speed;
 }
 
+bool Container::isCached() const
+{
+    return _cached;
+}
+
+void Container::setCached(bool cached)
+{
+    if (cached != _cached)
+    {
+        _cached = cached;
+        if (!cached)
+            releaseCache();
+        setGeometryDirty();
+    }
+}
+
+float Container::getRefreshInterval() const
+{
+    return _refreshInterval;
+}
+
+void Container::setRefreshInterval(float interval)
+{
+    _refreshInterval = interval;
+}
+
+void Container::updateCache(Form* form)
+{
+    GP_ASSERT(form);
+
+    if (!_visible)
+        return;
+
+    for (size_t i = 0, count = _controls.size(); i < count; ++i)
+    {
+        if (_controls[i]->isContainer())
+            static_cast<Container*>(_controls[i])->updateCache(form);
+    }
+
+    if (!_cached || isForm())
+        return;
+    if (_cacheBatch && !_cacheDirty && (_refreshInterval <= 0.0f || Game::getGameTime() - _cacheTime < _refreshInterval))
+        return;
+
+    // The frame buffer covers the bounds of the container, which hold everything it draws.
+    unsigned int width = (unsigned int)ceilf(_absoluteBounds.width);
+    unsigned int height = (unsigned int)ceilf(_absoluteBounds.height);
+    if (width == 0 || height == 0)
+    {
+        releaseCache();
+        return;
+    }
+    if (!_cacheFrameBuffer || _cacheFrameBuffer->getWidth() != width || _cacheFrameBuffer->getHeight() != height)
+    {
+        releaseCache();
+        _cacheFrameBuffer = FrameBuffer::create(_id.c_str(), width, height);
+        if (!_cacheFrameBuffer)
+            return;
+
+        _cacheBatch = SpriteBatch::create(_cacheFrameBuffer->getRenderTarget()->getTexture());
+        _cacheBatch->getSampler()->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+        _cacheBatch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+
+        // The frame buffer holds contents that have already been multiplied by their alpha.
+        _cacheBatch->getStateBlock()->setBlendSrc(RenderState::BLEND_ONE);
+    }
+
+    Game* game = Game::getInstance();
+    FrameBuffer* previousFrameBuffer = _cacheFrameBuffer->bind();
+    Rectangle previousViewport = game->getViewport();
+    game->setViewport(Rectangle((float)width, (float)height));
+    game->clear(Game::CLEAR_COLOR, Vector4::zero(), 1.0f, 0);
+
+    // Draw the contents through the batches of the form, with a projection that maps the
+    // bounds of the container to the frame buffer.
+    Matrix projectionMatrix(form->_projectionMatrix);
+    Matrix::createOrthographicOffCenter(_absoluteBounds.x, _absoluteBounds.x + width, _absoluteBounds.y + height, _absoluteBounds.y, 0, 1, &form->_projectionMatrix);
+    _cacheDrawing = true;
+    draw(form, _absoluteClipBounds);
+    _cacheDrawing = false;
+    for (size_t i = 0, count = form->_batches.size(); i < count; ++i)
+        form->_batches[i]->finish();
+    form->_batches.clear();
+    form->_projectionMatrix = projectionMatrix;
+
+    previousFrameBuffer->bind();
+    game->setViewport(previousViewport);
+    _cacheDirty = false;
+    _cacheTime = Game::getGameTime();
+
+    // Cached containers around this one hold its previous contents.
+    for (Container* parent = _parent; parent; parent = parent->_parent)
+        parent->_cacheDirty = true;
+}
+
+void Container::releaseCache()
+{
+    SAFE_DELETE(_cacheBatch);
+    SAFE_RELEASE(_cacheFrameBuffer);
+    _cacheDirty = true;
+}
+
 static bool sortControlsByZOrder(Control* c1, Control* c2)
 {
     if (c1->getZIndex() < c2->getZIndex())
@@ -1568,6 +1705,7 @@ void Container::setAnimationPropertyValue(int propertyId, AnimationValue* value,
     {
     case ANIMATE_SCROLLBAR_OPACITY:
         _scrollBarOpacity = Curve::lerp(blendWeight, _opacity, value->getFloat(0));
+        setGeometryDirty();
         break;
     default:
         Control::setAnimationPropertyValue(propertyId, value, blendWeight);
@@ -4,6 +4,7 @@
 #include "Control.h"
 #include "Layout.h"
 #include "TimeListener.h"
+#include "FrameBuffer.h"
 
 namespace gameplay
 {
@@ -223,6 +224,46 @@ public:
      */
     void setScrollWheelSpeed(float speed);
 
+    /**
+     * Determines whether this container draws its contents from a texture.
+     *
+     * @return True if this container draws its contents from a texture, false otherwise.
+     */
+    bool isCached() const;
+
+    /**
+     * Sets whether this container draws its contents from a texture.
+     *
+     * A cached container draws itself and its children into a frame buffer the size of its
+     * bounds, and then draws a single quad of the frame buffer for as long as none of them
+     * has changed, or until its refresh interval has elapsed. Caching suits containers that
+     * hold many controls that seldom change, such as inventory grids and scoreboards.
+     *
+     * Since the contents are blended into the frame buffer before the frame buffer is blended
+     * into the form, translucent contents show slightly more of what is behind the container.
+     * Caching has no effect on forms.
+     *
+     * @param cached True to draw the contents of this container from a texture, false otherwise (default).
+     */
+    void setCached(bool cached);
+
+    /**
+     * Returns the interval at which a cached container draws its contents again even though
+     * none of them has changed.
+     *
+     * @return The refresh interval in milliseconds, or zero if the contents are only drawn again when they change.
+     */
+    float getRefreshInterval() const;
+
+    /**
+     * Sets the interval at which a cached container draws its contents again even though
+     * none of them has changed, for contents that change without the container knowing,
+     * such as the styles of its theme.
+     *
+     * @param interval The refresh interval in milliseconds, or zero to only draw the contents again when they change (default).
+     */
+    void setRefreshInterval(float interval);
+
     /**
      * Get an offset of how far this layout has been scrolled in each direction.
      */
@@ -397,6 +438,15 @@ protected:
      */
     void updateScroll();
 
+    /**
+     * Computes the size of the contents that the container scrolls over, which is the extent
+     * of its visible children by default.
+     *
+     * @param width Set to the width of the contents.
+     * @param height Set to the height of the contents.
+     */
+    virtual void measureContents(float* width, float* height);
+
     /**
      * Sorts controls by Z-Order (for absolute layouts only).
      * This method is used by controls to notify their parent container when
@@ -404,6 +454,11 @@ protected:
      */
     void sortControls();
 
+    /**
+     * Marks the hit grid of the form of the container for a rebuild, after its children changed.
+     */
+    void setHitGridDirty();
+
     /**
      * Applies touch events to scroll state.
      *
@@ -584,6 +639,17 @@ private:
     void clearContacts();
     bool inContact();
 
+    /**
+     * Draws the contents of the cached containers under this container that need it into their
+     * frame buffers, innermost first. Called by the form before drawing its controls.
+     */
+    void updateCache(Form* form);
+
+    /**
+     * Releases the frame buffer of this container.
+     */
+    void releaseCache();
+
     AnimationClip* _scrollBarOpacityClip;
     int _zIndexDefault;
     bool _selectButtonDown;
@@ -594,6 +660,13 @@ private:
     bool _contactIndices[MAX_CONTACT_INDICES];
     bool _initializedWithScroll;
     bool _scrollWheelRequiresFocus;
+    bool _cached;
+    float _refreshInterval;
+    bool _cacheDirty;
+    bool _cacheDrawing;
+    double _cacheTime;
+    FrameBuffer* _cacheFrameBuffer;
+    SpriteBatch* _cacheBatch;
 };
 
 }
@@ -599,7 +599,7 @@ void Control::setSkinRegion(const Rectangle& region, unsigned char states)
     for (int i = 0; i < Theme::Style::OVERLAY_MAX; ++i)
     {
         if( overlays[i] )
-            overlays[i]->setSkinRegion(region, _style->_tw, _style->_th);
+            overlays[i]->setSkinRegion(region, _style->_tw, _style->_th, _style->_theme->_origin);
     }
 }
 
@@ -667,7 +667,7 @@ void Control::setImageRegion(const char* id, const Rectangle& region, unsigned c
     for (int i = 0; i < Theme::Style::OVERLAY_MAX; ++i)
     {
         if( overlays[i] )
-            overlays[i]->setImageRegion(id, region, _style->_tw, _style->_th);
+            overlays[i]->setImageRegion(id, region, _style->_tw, _style->_th, _style->_theme->_origin);
     }
 }
 
@@ -714,7 +714,7 @@ void Control::setCursorRegion(const Rectangle& region, unsigned char states)
     for (int i = 0; i < Theme::Style::OVERLAY_MAX; ++i)
     {
         if( overlays[i] )
-            overlays[i]->setCursorRegion(region, _style->_tw, _style->_th);
+            overlays[i]->setCursorRegion(region, _style->_tw, _style->_th, _style->_theme->_origin);
     }
 }
 
@@ -1090,6 +1090,9 @@ void Control::controlEvent(Control::Listener::EventType evt)
 void Control::setDirty(int bits)
 {
     _dirtyBits |= bits;
+    for (Control* parent = _parent; parent != NULL; parent = parent->_parent)
+        parent->_dirtyBits |= DIRTY_CHILDREN;
+    setGeometryDirty();
 }
 
 bool Control::isDirty(int bit) const
@@ -1097,6 +1100,22 @@ bool Control::isDirty(int bit) const
     return (_dirtyBits & bit) == bit;
 }
 
+void Control::setGeometryDirty()
+{
+    // Cached containers draw their contents again, as do forms in retained mode.
+    Control* control = this;
+    while (true)
+    {
+        if (control->isContainer())
+            static_cast<Container*>(control)->_cacheDirty = true;
+        if (control->_parent == NULL)
+            break;
+        control = control->_parent;
+    }
+    if (control->isContainer() && static_cast<Container*>(control)->isForm())
+        static_cast<Form*>(control)->_geometryDirty = true;
+}
+
 void Control::update(float elapsedTime)
 {
     State state = getState();
@@ -1107,9 +1126,14 @@ void Control::update(float elapsedTime)
 
     // Since opacity is pre-multiplied, we compute it every frame so that we don't need to
     // dirty the entire hierarchy any time a state changes (which could affect opacity).
-    _opacity = getOpacity(state);
+    float opacity = getOpacity(state);
     if (_parent)
-        _opacity *= _parent->_opacity;
+        opacity *= _parent->_opacity;
+    if (opacity != _opacity)
+    {
+        _opacity = opacity;
+        setGeometryDirty();
+    }
 }
 
 void Control::updateState(State state)
@@ -1132,16 +1156,21 @@ bool Control::updateBoundsInternal(const Vector2& offset)
         _dirtyBits &= ~DIRTY_STATE;
     }
 
-    // If we are a container, always update child bounds first
+    // If we are a container, update the bounds of our dirty children first, since our own
+    // bounds may depend on their sizes.
     bool changed = false;
-    if (isContainer())
+    if (isContainer() && (_dirtyBits & DIRTY_CHILDREN))
+    {
+        _dirtyBits &= ~DIRTY_CHILDREN;
         changed = static_cast<Container*>(this)->updateChildBounds();
+    }
 
-    // Clear our dirty bounds bit
+    // Clear our dirty bounds bits
     bool dirtyBounds = (_dirtyBits & DIRTY_BOUNDS) != 0;
-    _dirtyBits &= ~DIRTY_BOUNDS;
+    bool dirtyAbsoluteBounds = dirtyBounds || (_dirtyBits & DIRTY_ABSOLUTE_BOUNDS) != 0;
+    _dirtyBits &= ~(DIRTY_BOUNDS | DIRTY_ABSOLUTE_BOUNDS);
 
-    if (dirtyBounds)
+    if (dirtyAbsoluteBounds)
     {
         // Store old bounds so we can determine if they change
         Rectangle oldAbsoluteBounds(_absoluteBounds);
@@ -1149,7 +1178,9 @@ bool Control::updateBoundsInternal(const Vector2& offset)
         Rectangle oldViewportBounds(_viewportBounds);
         Rectangle oldViewportClipBounds(_viewportClipBounds);
 
-        updateBounds();
+        // Controls that only moved keep their local bounds.
+        if (dirtyBounds)
+            updateBounds();
         updateAbsoluteBounds(offset);
 
         if (_absoluteBounds != oldAbsoluteBounds ||
@@ -1157,12 +1188,26 @@ bool Control::updateBoundsInternal(const Vector2& offset)
             _viewportBounds != oldViewportBounds ||
             _viewportClipBounds != oldViewportClipBounds)
         {
+            // Children only need to be measured again when our size changes, since their
+            // percentages and alignment are relative to it; otherwise they are only moved.
             if (isContainer())
-                static_cast<Container*>(this)->setChildrenDirty(DIRTY_BOUNDS, true);
+            {
+                bool resized = _absoluteBounds.width != oldAbsoluteBounds.width || _absoluteBounds.height != oldAbsoluteBounds.height ||
+                    _viewportBounds.width != oldViewportBounds.width || _viewportBounds.height != oldViewportBounds.height;
+                static_cast<Container*>(this)->setChildrenDirty(resized ? DIRTY_BOUNDS : DIRTY_ABSOLUTE_BOUNDS, false);
+            }
             changed = true;
         }
     }
 
+    // Arrange the children that our layout, scrolling or new bounds dirtied, now that our own
+    // absolute bounds are up to date.
+    if (isContainer() && (_dirtyBits & DIRTY_CHILDREN))
+    {
+        _dirtyBits &= ~DIRTY_CHILDREN;
+        changed = static_cast<Container*>(this)->updateChildBounds() || changed;
+    }
+
     return changed;
 }
 
@@ -1659,6 +1704,9 @@ Theme::Style::Overlay* Control::getOverlay(State state) const
 
 void Control::overrideStyle()
 {
+    // Styles are only overridden to be changed, which changes what the control draws.
+    setGeometryDirty();
+
     if (_styleOverridden)
     {
         return;
@@ -997,6 +997,18 @@ protected:
      */
     static const int DIRTY_STATE = 2;
 
+    /**
+     * Indicates that the absolute bounds of the control are dirty, while its local bounds are
+     * not, such as when its container moves or scrolls without being resized.
+     */
+    static const int DIRTY_ABSOLUTE_BOUNDS = 4;
+
+    /**
+     * Indicates that controls below this container are dirty, so that bounds updates only walk
+     * down the branches of a form that hold dirty controls.
+     */
+    static const int DIRTY_CHILDREN = 8;
+
     /**
      * Indicates that the x position of the control is a percentage.
      */
@@ -1180,6 +1192,9 @@ protected:
     /**
      * Updates the local bounds for this control and its children.
      *
+     * This is the measure pass of the layout, which only runs for controls whose bounds are
+     * dirty, after the bounds of their own children are up to date.
+     *
      * Child controls that need to customize their bounds calculation should override this method.
      */
     virtual void updateBounds();
@@ -1187,6 +1202,9 @@ protected:
     /**
      * Updates the absolute bounds for this control and its children.
      *
+     * This is the arrange pass of the layout, which runs for controls whose bounds or absolute
+     * bounds are dirty, and again for the children of the controls whose absolute bounds change.
+     *
      * @param offset Offset to add to the control's position (most often used for scrolling).
      */
     virtual void updateAbsoluteBounds(const Vector2& offset);
@@ -1329,6 +1347,15 @@ protected:
      */
     bool isDirty(int bit) const;
 
+    /**
+     * Marks the geometry cached by the form of this control, and the contents of the cached
+     * containers around it, as out of date, for changes to what the control draws that affect
+     * neither its bounds nor its state.
+     *
+     * Setting dirty bits also marks the geometry as out of date.
+     */
+    void setGeometryDirty();
+
     /**
      * Gets the Alignment by string.
      *
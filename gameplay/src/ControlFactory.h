@@ -18,6 +18,7 @@ class ControlFactory
 {
     friend class Game;
 	friend class Container;
+	friend class ListView;
 
 public:
 
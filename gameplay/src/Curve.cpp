@@ -1,4 +1,16 @@
 // Purposely not including Base.h here, or any other gameplay dependencies, so it can be reused between gameplay and gameplay-encoder.
+// The math alignment that Base.h declares Quaternion with is mirrored instead.
+#ifndef GP_MATH_ALIGN
+#ifdef GP_USE_ALIGNED_MATH
+#ifdef _MSC_VER
+#define GP_MATH_ALIGN __declspec(align(16))
+#else
+#define GP_MATH_ALIGN __attribute__((aligned(16)))
+#endif
+#else
+#define GP_MATH_ALIGN
+#endif
+#endif
 #include "Curve.h"
 #include "Quaternion.h"
 #include <cassert>
@@ -80,6 +92,19 @@ static inline float lerpInl(float s, float from, float to)
     return from + (to - from) * s;
 }
 
+static inline void normalizeQuaternion(float* q)
+{
+    float n = q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3];
+    if (n > 0.0f)
+    {
+        n = 1.0f / sqrt(n);
+        q[0] *= n;
+        q[1] *= n;
+        q[2] *= n;
+        q[3] *= n;
+    }
+}
+
 namespace gameplay
 {
 
@@ -89,7 +114,8 @@ Curve* Curve::create(unsigned int pointCount, unsigned int componentCount)
 }
 
 Curve::Curve(unsigned int pointCount, unsigned int componentCount)
-    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL)
+    : _pointCount(pointCount), _componentCount(componentCount), _componentSize(sizeof(float)*componentCount), _quaternionOffset(NULL), _points(NULL),
+      _samples(NULL), _sampleMin(NULL), _sampleScale(NULL), _evaluator(NULL)
 {
     _points = new Point[_pointCount];
     for (unsigned int i = 0; i < _pointCount; i++)
@@ -101,12 +127,16 @@ Curve::Curve(unsigned int pointCount, unsigned int componentCount)
         _points[i].type = LINEAR;
     }
     _points[_pointCount - 1].time = 1.0f;
+    selectEvaluator();
 }
 
 Curve::~Curve()
 {
     SAFE_DELETE_ARRAY(_points);
     SAFE_DELETE_ARRAY(_quaternionOffset);
+    SAFE_DELETE_ARRAY(_samples);
+    SAFE_DELETE_ARRAY(_sampleMin);
+    SAFE_DELETE_ARRAY(_sampleScale);
 }
 
 Curve::Point::Point()
@@ -133,17 +163,19 @@ unsigned int Curve::getComponentCount() const
 
 float Curve::getStartTime() const
 {
-    return _points[0].time;
+    return _samples ? 0.0f : _points[0].time;
 }
 
 float Curve::getEndTime() const
 {
-    return _points[_pointCount-1].time;
+    return _samples ? 1.0f : _points[_pointCount-1].time;
 }
 
 float Curve::getPointTime(unsigned int index) const
 {
     assert(index < _pointCount);
+    if (_samples)
+        return (float)index / (float)(_pointCount - 1);
     return _points[index].time;
 }
 
@@ -151,12 +183,30 @@ float Curve::getPointTime(unsigned int index) const
 Curve::InterpolationType Curve::getPointInterpolation(unsigned int index) const
 {
     assert(index < _pointCount);
+    if (_samples)
+        return LINEAR;
     return _points[index].type;;
 }
 
 void Curve::getPointValues(unsigned int index, float* value, float* inValue, float* outValue) const
 {
     assert(index < _pointCount);
+
+    if (_samples)
+    {
+        // Baked curves are linear, so the tangents are flat.
+        const unsigned short* sample = _samples + index * _componentCount;
+        for (unsigned int i = 0; i < _componentCount; i++)
+        {
+            if (value)
+                value[i] = _sampleMin[i] + _sampleScale[i] * sample[i];
+            if (inValue)
+                inValue[i] = 0.0f;
+            if (outValue)
+                outValue[i] = 0.0f;
+        }
+        return;
+    }
     
     if (value)
         memcpy(value, _points[index].value, _componentSize);
@@ -175,6 +225,7 @@ void Curve::setPoint(unsigned int index, float time, float* value, Interpolation
 
 void Curve::setPoint(unsigned int index, float time, float* value, InterpolationType type, float* inValue, float* outValue)
 {
+    assert(!_samples);
     assert(index < _pointCount && time >= 0.0f && time <= 1.0f && !(_pointCount > 1 && index == 0 && time != 0.0f) && !(_pointCount != 1 && index == _pointCount - 1 && time != 1.0f));
 
     _points[index].time = time;
@@ -192,6 +243,7 @@ void Curve::setPoint(unsigned int index, float time, float* value, Interpolation
 
 void Curve::setTangent(unsigned int index, InterpolationType type, float* inValue, float* outValue)
 {
+    assert(!_samples);
     assert(index < _pointCount);
 
     _points[index].type = type;
@@ -214,6 +266,12 @@ void Curve::evaluate(float time, float startTime, float endTime, float loopBlend
 {
     assert(dst && startTime >= 0.0f && startTime <= endTime && endTime <= 1.0f && loopBlendTime >= 0.0f);
 
+    if (_samples)
+    {
+        evaluateBaked(time, startTime, endTime, loopBlendTime, dst);
+        return;
+    }
+
     // If there's only one point on the curve, return its value.
     if (_pointCount == 1)
     {
@@ -828,6 +886,148 @@ void Curve::evaluate(float time, float startTime, float endTime, float loopBlend
     interpolateLinear(t, from, to, dst);
 }
 
+void Curve::bake(unsigned int sampleCount)
+{
+    assert(sampleCount >= 2);
+
+    if (_samples || _pointCount < 2)
+        return;
+
+    // Sample the curve with its own interpolation.
+    float* values = new float[sampleCount * _componentCount];
+    for (unsigned int i = 0; i < sampleCount; i++)
+    {
+        float* value = values + i * _componentCount;
+        evaluate((float)i / (float)(sampleCount - 1), value);
+
+        // Keep consecutive rotations in the same hemisphere so that blending two samples
+        // always takes the shortest path.
+        if (_quaternionOffset && i > 0)
+        {
+            float* q = value + *_quaternionOffset;
+            const float* p = q - _componentCount;
+            if (q[0] * p[0] + q[1] * p[1] + q[2] * p[2] + q[3] * p[3] < 0.0f)
+            {
+                q[0] = -q[0];
+                q[1] = -q[1];
+                q[2] = -q[2];
+                q[3] = -q[3];
+            }
+        }
+    }
+
+    // Quantize every component within its own range.
+    _sampleMin = new float[_componentCount];
+    _sampleScale = new float[_componentCount];
+    _samples = new unsigned short[sampleCount * _componentCount];
+    for (unsigned int c = 0; c < _componentCount; c++)
+    {
+        float min = values[c];
+        float max = values[c];
+        for (unsigned int i = 1; i < sampleCount; i++)
+        {
+            float v = values[i * _componentCount + c];
+            if (v < min)
+                min = v;
+            else if (v > max)
+                max = v;
+        }
+        _sampleMin[c] = min;
+        _sampleScale[c] = (max - min) / 65535.0f;
+
+        float invScale = _sampleScale[c] > 0.0f ? 1.0f / _sampleScale[c] : 0.0f;
+        for (unsigned int i = 0; i < sampleCount; i++)
+        {
+            float q = (values[i * _componentCount + c] - min) * invScale + 0.5f;
+            _samples[i * _componentCount + c] = (unsigned short)(q > 65535.0f ? 65535.0f : q);
+        }
+    }
+    SAFE_DELETE_ARRAY(values);
+
+    SAFE_DELETE_ARRAY(_points);
+    _pointCount = sampleCount;
+}
+
+bool Curve::isBaked() const
+{
+    return _samples != NULL;
+}
+
+void Curve::evaluateBaked(float time, float startTime, float endTime, float loopBlendTime, float* dst) const
+{
+    float localTime = startTime + (endTime - startTime) * time;
+
+    if (loopBlendTime == 0.0f)
+    {
+        // If no loop blend time is specified, clamp time to end points
+        if (localTime < startTime)
+            localTime = startTime;
+        else if (localTime > endTime)
+            localTime = endTime;
+    }
+
+    if (localTime > endTime || localTime < startTime)
+    {
+        // Looping between the end points of the subregion.
+        float fromTime = localTime > endTime ? endTime : startTime;
+        float toTime = localTime > endTime ? startTime : endTime;
+        float t = fabs(localTime - fromTime) / loopBlendTime;
+        for (unsigned int i = 0; i < _componentCount; i++)
+        {
+            dst[i] = lerpInl(t, getBakedValue(fromTime, i), getBakedValue(toTime, i));
+        }
+
+        if (_quaternionOffset)
+        {
+            // The end points may be far apart, so the rotation is blended along the shortest path.
+            unsigned int offset = *_quaternionOffset;
+            float from[4];
+            float to[4];
+            for (unsigned int i = 0; i < 4; i++)
+            {
+                from[i] = getBakedValue(fromTime, offset + i);
+                to[i] = getBakedValue(toTime, offset + i);
+            }
+            float sign = (from[0] * to[0] + from[1] * to[1] + from[2] * to[2] + from[3] * to[3]) < 0.0f ? -1.0f : 1.0f;
+            for (unsigned int i = 0; i < 4; i++)
+            {
+                dst[offset + i] = lerpInl(t, from[i], to[i] * sign);
+            }
+            normalizeQuaternion(dst + offset);
+        }
+        return;
+    }
+
+    // Fetch the two samples around the time and blend them.
+    float position = localTime * (_pointCount - 1);
+    unsigned int index = (unsigned int)position;
+    if (index > _pointCount - 2)
+        index = _pointCount - 2;
+    float t = position - (float)index;
+
+    const unsigned short* from = _samples + index * _componentCount;
+    const unsigned short* to = from + _componentCount;
+    for (unsigned int i = 0; i < _componentCount; i++)
+    {
+        dst[i] = _sampleMin[i] + _sampleScale[i] * lerpInl(t, (float)from[i], (float)to[i]);
+    }
+
+    if (_quaternionOffset)
+        normalizeQuaternion(dst + *_quaternionOffset);
+}
+
+float Curve::getBakedValue(float time, unsigned int component) const
+{
+    float position = time * (_pointCount - 1);
+    unsigned int index = (unsigned int)position;
+    if (index > _pointCount - 2)
+        index = _pointCount - 2;
+    float t = position - (float)index;
+
+    const unsigned short* from = _samples + index * _componentCount + component;
+    return _sampleMin[component] + _sampleScale[component] * lerpInl(t, (float)from[0], (float)from[_componentCount]);
+}
+
 float Curve::lerp(float t, float from, float to)
 {
     return lerpInl(t, from, to);
@@ -841,6 +1041,69 @@ void Curve::setQuaternionOffset(unsigned int offset)
         _quaternionOffset = new unsigned int[1];
     
     *_quaternionOffset = offset;
+    selectEvaluator();
+}
+
+void Curve::selectEvaluator()
+{
+    // The layouts of the animation properties of transforms and of scalar values, vectors and colors.
+    static const unsigned int layouts[][2] =
+    {
+        { 1, 0 }, { 2, 0 }, { 3, 0 }, { 4, 0 }, { 4, 1 }, { 7, 1 }, { 7, 4 }, { 10, 4 }
+    };
+    static const Evaluator evaluators[] =
+    {
+        { &interpolateLinear<1, -1>, &interpolateCubic<1, -1> },
+        { &interpolateLinear<2, -1>, &interpolateCubic<2, -1> },
+        { &interpolateLinear<3, -1>, &interpolateCubic<3, -1> },
+        { &interpolateLinear<4, -1>, &interpolateCubic<4, -1> },
+        { &interpolateLinear<4, 0>, &interpolateCubic<4, 0> },
+        { &interpolateLinear<7, 0>, &interpolateCubic<7, 0> },
+        { &interpolateLinear<7, 3>, &interpolateCubic<7, 3> },
+        { &interpolateLinear<10, 3>, &interpolateCubic<10, 3> }
+    };
+
+    // The quaternion offset is stored plus one in the layouts, where zero is no quaternion.
+    unsigned int offset = _quaternionOffset ? *_quaternionOffset + 1 : 0;
+    _evaluator = NULL;
+    for (unsigned int i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++)
+    {
+        if (layouts[i][0] == _componentCount && layouts[i][1] == offset)
+        {
+            _evaluator = &evaluators[i];
+            return;
+        }
+    }
+}
+
+template <unsigned int N, int Q>
+void Curve::interpolateLinear(float s, const float* from, const float* to, float* dst)
+{
+    // The loop is unrolled for the component count, and selecting the from value of
+    // unchanging components compiles to a blend instead of a branch.
+    for (unsigned int i = 0; i < N; i++)
+    {
+        if (Q < 0 || i < (unsigned int)Q || i >= (unsigned int)Q + 4)
+            dst[i] = from[i] == to[i] ? from[i] : lerpInl(s, from[i], to[i]);
+    }
+    if (Q >= 0)
+        interpolateQuaternion(s, from + Q, to + Q, dst + Q);
+}
+
+template <unsigned int N, int Q>
+void Curve::interpolateCubic(const float* w, const float* p0, const float* p1, const float* p2, const float* p3, const float* a, const float* b, float qs, float* dst)
+{
+    float w0 = w[0];
+    float w1 = w[1];
+    float w2 = w[2];
+    float w3 = w[3];
+    for (unsigned int i = 0; i < N; i++)
+    {
+        if (Q < 0 || i < (unsigned int)Q || i >= (unsigned int)Q + 4)
+            dst[i] = a[i] == b[i] ? a[i] : p0[i] * w0 + p1[i] * w1 + p2[i] * w2 + p3[i] * w3;
+    }
+    if (Q >= 0)
+        interpolateQuaternion(qs, a + Q, b + Q, dst + Q);
 }
 
 void Curve::interpolateBezier(float s, Point* from, Point* to, float* dst) const
@@ -858,6 +1121,13 @@ void Curve::interpolateBezier(float s, Point* from, Point* to, float* dst) const
     float* outValue = from->outValue;
     float* inValue = to->inValue;
 
+    if (_evaluator)
+    {
+        float w[4] = { eq1, eq2, eq3, eq4 };
+        float qs = _quaternionOffset ? bezier(eq1, eq2, eq3, eq4, from->time, outValue[*_quaternionOffset], to->time, inValue[*_quaternionOffset]) : 0.0f;
+        _evaluator->cubic(w, fromValue, outValue, inValue, toValue, fromValue, toValue, qs, dst);
+        return;
+    }
 
     if (!_quaternionOffset)
     {
@@ -911,6 +1181,13 @@ void Curve::interpolateBSpline(float s, Point* c0, Point* c1, Point* c2, Point*
     float* c2Value = c2->value;
     float* c3Value = c3->value;
 
+    if (_evaluator)
+    {
+        float w[4] = { eq0, eq1, eq2, eq3 };
+        _evaluator->cubic(w, c0Value, c1Value, c2Value, c3Value, c1Value, c2Value, s, dst);
+        return;
+    }
+
     if (!_quaternionOffset)
     {
         for (unsigned int i = 0; i < _componentCount; i++)
@@ -970,6 +1247,14 @@ void Curve::interpolateHermite(float s, Point* from, Point* to, float* dst) cons
     float* outValue = from->outValue;
     float* inValue = to->inValue;
 
+    if (_evaluator)
+    {
+        float w[4] = { h00, h01, h10, h11 };
+        float qs = _quaternionOffset ? hermite(h00, h01, h10, h11, from->time, outValue[*_quaternionOffset], to->time, inValue[*_quaternionOffset]) : 0.0f;
+        _evaluator->cubic(w, fromValue, toValue, outValue, inValue, fromValue, toValue, qs, dst);
+        return;
+    }
+
     if (!_quaternionOffset)
     {
         for (unsigned int i = 0; i < _componentCount; i++)
@@ -1201,6 +1486,12 @@ void Curve::interpolateLinear(float s, Point* from, Point* to, float* dst) const
     float* fromValue = from->value;
     float* toValue = to->value;
 
+    if (_evaluator)
+    {
+        _evaluator->linear(s, fromValue, toValue, dst);
+        return;
+    }
+
     if (!_quaternionOffset)
     {
         for (unsigned int i = 0; i < _componentCount; i++)
@@ -1238,7 +1529,7 @@ void Curve::interpolateLinear(float s, Point* from, Point* to, float* dst) const
     }
 }
 
-void Curve::interpolateQuaternion(float s, float* from, float* to, float* dst) const
+void Curve::interpolateQuaternion(float s, const float* from, const float* to, float* dst)
 {
     // Evaluate.
     if (s >= 0)
@@ -414,6 +414,34 @@ public:
      */
     void evaluate(float time, float startTime, float endTime, float loopBlendTime, float* dst) const;
 
+    /**
+     * Replaces the points of this curve with uniformly spaced samples of the curve.
+     *
+     * Evaluating a baked curve fetches and linearly interpolates the two samples around
+     * the given time instead of searching for the points and running the interpolation
+     * of each point, which makes evaluation cost independent of the number of points and
+     * of their interpolation types. Rotation components are blended and renormalized.
+     *
+     * Samples are quantized to 16 bits per component within the range of each component,
+     * so a baked curve usually also uses much less memory than its points and tangents.
+     * After baking, the curve behaves as a linear curve through its samples and its
+     * points can no longer be changed. Curves that are already baked or that only have
+     * a single point are left unchanged.
+     *
+     * Subregions of a baked curve are mapped linearly to the samples, and are no
+     * longer snapped to the points that existed at the start and end of the subregion.
+     *
+     * @param sampleCount The number of samples to take over the whole curve (at least 2).
+     */
+    void bake(unsigned int sampleCount);
+
+    /**
+     * Determines if this curve has been baked into uniformly spaced samples.
+     *
+     * @return True if the curve is baked, false otherwise.
+     */
+    bool isBaked() const;
+
     /**
      * Linear interpolation function.
      */
@@ -455,6 +483,18 @@ private:
         Point& operator=(const Point&);
     };
 
+    /**
+     * The interpolation functions of a curve, specialized for its component count and
+     * quaternion offset so that their component loops are unrolled at compile time.
+     */
+    struct Evaluator
+    {
+        /** Interpolates linearly between the from and to values. */
+        void (*linear)(float s, const float* from, const float* to, float* dst);
+        /** Sums the four weighted values, unless the values a and b are equal, and slerps from a to b with qs. */
+        void (*cubic)(const float* w, const float* p0, const float* p1, const float* p2, const float* p3, const float* a, const float* b, float qs, float* dst);
+    };
+
     /**
      * Constructor.
      */
@@ -516,7 +556,31 @@ private:
     /**
      * Quaternion interpolation function.
      */
-    void interpolateQuaternion(float s, float* from, float* to, float* dst) const;
+    static void interpolateQuaternion(float s, const float* from, const float* to, float* dst);
+
+    /**
+     * Linear interpolation function, specialized for N components with a quaternion at offset Q,
+     * or none if Q is negative.
+     */
+    template <unsigned int N, int Q>
+    static void interpolateLinear(float s, const float* from, const float* to, float* dst);
+
+    /**
+     * Weighted interpolation function of Bezier, BSpline and Hermite curves, specialized for
+     * N components with a quaternion at offset Q, or none if Q is negative.
+     */
+    template <unsigned int N, int Q>
+    static void interpolateCubic(const float* w, const float* p0, const float* p1, const float* p2, const float* p3, const float* a, const float* b, float qs, float* dst);
+
+    /**
+     * Evaluates a baked curve.
+     */
+    void evaluateBaked(float time, float startTime, float endTime, float loopBlendTime, float* dst) const;
+
+    /**
+     * Returns a component of a baked curve at the given time (between 0.0 - 1.0).
+     */
+    float getBakedValue(float time, unsigned int component) const;
 
     /**
      * Determines the current keyframe to interpolate from based on the specified time.
@@ -533,6 +597,12 @@ private:
      */
     void setQuaternionOffset(unsigned int index);
 
+    /**
+     * Selects the evaluator that is specialized for the component count and quaternion offset
+     * of the curve, or none if the curve has a layout that is not specialized.
+     */
+    void selectEvaluator();
+
     /**
      * Gets the InterpolationType value for the given string ID
      *
@@ -546,6 +616,10 @@ private:
     unsigned int _componentSize;        // The component size (in bytes).
     unsigned int* _quaternionOffset;    // Offset for the rotation component.
     Point* _points;                     // The points on the curve.
+    unsigned short* _samples;           // The quantized samples of a baked curve.
+    float* _sampleMin;                  // The minimum value of each component of a baked curve.
+    float* _sampleScale;                // The quantization step of each component of a baked curve.
+    const Evaluator* _evaluator;        // The specialized interpolation functions, or NULL.
 };
 
 }
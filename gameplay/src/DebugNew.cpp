@@ -22,6 +22,7 @@ struct MemoryAllocationRecord
     unsigned int size;              // size of the allocation request
     const char* file;               // source file of allocation request
     int line;                       // source line of the allocation request
+    int tag;                        // memory tracker tag the allocation is counted under
     MemoryAllocationRecord* next;
     MemoryAllocationRecord* prev;
 #ifdef WIN32
@@ -102,16 +103,29 @@ void operator delete[] (void* p, const char* file, int line) throw()
 
 // Include Base.h (needed for logging macros) AFTER new operator impls
 #include "Base.h"
+#include "MemoryTracker.h"
+
+// The record is padded to a multiple of the math alignment, so that the allocations that follow it
+// are aligned for Matrix, Vector4 and Quaternion when built with GP_USE_ALIGNED_MATH.
+#define MEMORY_RECORD_SIZE ((sizeof(MemoryAllocationRecord) + GP_MATH_ALIGNMENT - 1) & ~(GP_MATH_ALIGNMENT - 1))
 
 void* debugAlloc(std::size_t size, const char* file, int line)
 {
     // Allocate memory + size for a MemoryAlloctionRecord
-    unsigned char* mem = (unsigned char*)malloc(size + sizeof(MemoryAllocationRecord));
+#ifdef GP_USE_ALIGNED_MATH
+    unsigned char* mem = (unsigned char*)gameplay::alignedMalloc(size + MEMORY_RECORD_SIZE, GP_MATH_ALIGNMENT);
+#else
+    unsigned char* mem = (unsigned char*)malloc(size + MEMORY_RECORD_SIZE);
+#endif
 
     MemoryAllocationRecord* rec = (MemoryAllocationRecord*)mem;
 
     // Move memory pointer past record
-    mem += sizeof(MemoryAllocationRecord);
+    mem += MEMORY_RECORD_SIZE;
+
+    // Count the allocation before locking, since warning about a budget allocates as well.
+    rec->tag = gameplay::MemoryTracker::getCurrentTag();
+    gameplay::MemoryTracker::add((gameplay::MemoryTracker::Tag)rec->tag, size);
 
     std::lock_guard<std::mutex> lock(getMemoryAllocationMutex());
     rec->address = (unsigned long)mem;
@@ -191,7 +205,7 @@ void debugFree(void* p)
         return;
 
     // Backup passed in pointer to access memory allocation record
-    void* mem = ((unsigned char*)p) - sizeof(MemoryAllocationRecord);
+    void* mem = ((unsigned char*)p) - MEMORY_RECORD_SIZE;
 
     MemoryAllocationRecord* rec = (MemoryAllocationRecord*)mem;
 
@@ -202,6 +216,8 @@ void debugFree(void* p)
         return;
     }
 
+    gameplay::MemoryTracker::remove((gameplay::MemoryTracker::Tag)rec->tag, rec->size);
+
     // Link this item out
     std::lock_guard<std::mutex> lock(getMemoryAllocationMutex());
     if (__memoryAllocations == rec)
@@ -213,7 +229,11 @@ void debugFree(void* p)
     --__memoryAllocationCount;
 
     // Free the address from the original alloc location (before mem allocation record)
+#ifdef GP_USE_ALIGNED_MATH
+    gameplay::alignedFree(mem);
+#else
     free(mem);
+#endif
 }
 
 #ifdef WIN32
@@ -1,5 +1,6 @@
 #include "Base.h"
 #include "DepthStencilTarget.h"
+#include "RenderStats.h"
 
 #ifndef GL_DEPTH24_STENCIL8_OES
 #define GL_DEPTH24_STENCIL8_OES 0x88F0
@@ -13,6 +14,12 @@ namespace gameplay
 
 static std::vector<DepthStencilTarget*> __depthStencilTargets;
 
+// Estimates the memory of the render buffers, assuming 32 bit depth storage and 8 bit separate stencil storage.
+static size_t getMemorySize(unsigned int width, unsigned int height, bool separateStencil)
+{
+    return (size_t)width * height * (separateStencil ? 5 : 4);
+}
+
 DepthStencilTarget::DepthStencilTarget(const char* id, Format format, unsigned int width, unsigned int height)
     : _id(id ? id : ""), _format(format), _depthBuffer(0), _stencilBuffer(0), _width(width), _height(height), _packed(false)
 {
@@ -21,6 +28,8 @@ DepthStencilTarget::DepthStencilTarget(const char* id, Format format, unsigned i
 DepthStencilTarget::~DepthStencilTarget()
 {
     // Destroy GL resources.
+    if (_depthBuffer)
+        RenderStats::removeMemory(RenderStats::RENDER_BUFFER_MEMORY, getMemorySize(_width, _height, _stencilBuffer != 0), this);
     if (_depthBuffer)
         GL_ASSERT( glDeleteRenderbuffers(1, &_depthBuffer) );
     if (_stencilBuffer)
@@ -81,6 +90,8 @@ DepthStencilTarget* DepthStencilTarget::create(const char* id, Format format, un
         depthStencilTarget->_packed = true;
     }
 
+    RenderStats::addMemory(RenderStats::RENDER_BUFFER_MEMORY, getMemorySize(width, height, depthStencilTarget->_stencilBuffer != 0), depthStencilTarget, id);
+
     // Add it to the cache.
     __depthStencilTargets.push_back(depthStencilTarget);
 
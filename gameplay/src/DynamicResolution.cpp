@@ -0,0 +1,329 @@
+#include "Base.h"
+#include "DynamicResolution.h"
+#include "Game.h"
+#include "FrameBuffer.h"
+#include "DepthStencilTarget.h"
+#include "Material.h"
+#include "Model.h"
+
+#define DYNAMIC_RESOLUTION_ID "org.gameplay3d.dynamicresolution"
+
+// The number of frames between changes of the scale.
+#define DYNAMIC_RESOLUTION_INTERVAL 15
+
+// The weight of each new sample in the smoothed time.
+#define DYNAMIC_RESOLUTION_SMOOTHING 0.2f
+
+// The fraction of the target below which the scale is raised, and the fraction it is raised towards.
+#define DYNAMIC_RESOLUTION_RAISE_THRESHOLD 0.8f
+#define DYNAMIC_RESOLUTION_RAISE_TARGET 0.9f
+
+// The largest change of the scale per interval.
+#define DYNAMIC_RESOLUTION_MAX_STEP 0.1f
+
+// Without GPU time, frames later than this fraction of the target lower the scale, and the scale is
+// raised by a small step once frames have been on time for a number of intervals.
+#define DYNAMIC_RESOLUTION_LATE_THRESHOLD 1.1f
+#define DYNAMIC_RESOLUTION_ON_TIME_INTERVALS 8
+#define DYNAMIC_RESOLUTION_PROBE_STEP 0.025f
+
+namespace gameplay
+{
+
+DynamicResolution::DynamicResolution(float targetFrameTime, Texture::Format format)
+    : _targetFrameTime(targetFrameTime), _format(format), _minScale(0.5f), _maxScale(1.0f), _scale(1.0f),
+      _adaptive(true), _measuredTime(0.0f), _sampleCount(0), _onTimeIntervals(0), _width(0), _height(0),
+      _renderWidth(0), _renderHeight(0), _frameBuffer(NULL), _sampler(NULL), _quad(NULL), _previousBuffer(NULL),
+      _lastFrameTime(0.0), _nextQuery(0), _queryActive(false)
+{
+    memset(_queries, 0, sizeof(_queries));
+    memset(_queryPending, 0, sizeof(_queryPending));
+
+    Material* material = Material::create("res/shaders/postprocess.vert", "res/shaders/postprocess-upscale.frag");
+    if (material)
+    {
+        RenderState::StateBlock* stateBlock = material->getStateBlock();
+        stateBlock->setDepthTest(false);
+        stateBlock->setDepthWrite(false);
+        stateBlock->setCullFace(false);
+        stateBlock->setBlend(false);
+
+        Mesh* mesh = Mesh::createQuadFullscreen();
+        _quad = Model::create(mesh);
+        _quad->setMaterial(material);
+        SAFE_RELEASE(mesh);
+        SAFE_RELEASE(material);
+    }
+}
+
+DynamicResolution::~DynamicResolution()
+{
+#ifdef GP_USE_TIMER_QUERIES
+    if (_queries[0])
+        GL_ASSERT( glDeleteQueries(DYNAMIC_RESOLUTION_QUERY_COUNT, _queries) );
+#endif
+    SAFE_RELEASE(_quad);
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_frameBuffer);
+}
+
+DynamicResolution* DynamicResolution::create(float targetFrameTime, Texture::Format format)
+{
+    GP_ASSERT(targetFrameTime > 0.0f);
+    return new DynamicResolution(targetFrameTime, format);
+}
+
+bool DynamicResolution::isGpuTimingSupported()
+{
+#if defined(GP_USE_TIMER_QUERIES) && defined(__ANDROID__)
+    return glGenQueries != NULL;
+#elif defined(GP_USE_TIMER_QUERIES)
+    static int supported = -1;
+    if (supported < 0)
+    {
+        // Timer queries are core in OpenGL 3.3 and are otherwise provided by ARB_timer_query.
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        supported = (major > 3 || (major == 3 && minor >= 3) || (extensions && strstr(extensions, "GL_ARB_timer_query"))) ? 1 : 0;
+        glGetError();
+    }
+    return supported == 1;
+#else
+    return false;
+#endif
+}
+
+void DynamicResolution::setTargetFrameTime(float time)
+{
+    GP_ASSERT(time > 0.0f);
+    _targetFrameTime = time;
+}
+
+float DynamicResolution::getTargetFrameTime() const
+{
+    return _targetFrameTime;
+}
+
+void DynamicResolution::setScaleRange(float minScale, float maxScale)
+{
+    GP_ASSERT(minScale > 0.0f && minScale <= maxScale);
+    _minScale = minScale;
+    if (maxScale != _maxScale)
+    {
+        // The frame buffer is recreated for the new largest scale by the next frame.
+        _maxScale = maxScale;
+        _width = 0;
+        _height = 0;
+    }
+    _scale = MATH_CLAMP(_scale, _minScale, _maxScale);
+}
+
+float DynamicResolution::getMinScale() const
+{
+    return _minScale;
+}
+
+float DynamicResolution::getMaxScale() const
+{
+    return _maxScale;
+}
+
+void DynamicResolution::setScale(float scale)
+{
+    _scale = MATH_CLAMP(scale, _minScale, _maxScale);
+}
+
+float DynamicResolution::getScale() const
+{
+    return _scale;
+}
+
+void DynamicResolution::setAdaptive(bool adaptive)
+{
+    _adaptive = adaptive;
+    _sampleCount = 0;
+    _onTimeIntervals = 0;
+}
+
+bool DynamicResolution::isAdaptive() const
+{
+    return _adaptive;
+}
+
+float DynamicResolution::getMeasuredTime() const
+{
+    return _measuredTime;
+}
+
+FrameBuffer* DynamicResolution::begin()
+{
+    Game* game = Game::getInstance();
+    _previousViewport = game->getViewport();
+    unsigned int width = std::max((unsigned int)_previousViewport.width, 1u);
+    unsigned int height = std::max((unsigned int)_previousViewport.height, 1u);
+    if (width != _width || height != _height)
+        resize(width, height);
+
+    _renderWidth = std::min(std::max((unsigned int)(width * _scale + 0.5f), 1u), _frameBuffer->getWidth());
+    _renderHeight = std::min(std::max((unsigned int)(height * _scale + 0.5f), 1u), _frameBuffer->getHeight());
+
+    _previousBuffer = _frameBuffer->bind();
+    game->setViewport(Rectangle((float)_renderWidth, (float)_renderHeight));
+
+    if (isGpuTimingSupported())
+    {
+#ifdef GP_USE_TIMER_QUERIES
+        if (!_queries[0])
+            GL_ASSERT( glGenQueries(DYNAMIC_RESOLUTION_QUERY_COUNT, _queries) );
+        readQueries();
+
+        // Skip measuring this frame if the GPU is so far behind that every query is still pending.
+        if (!_queryPending[_nextQuery])
+        {
+            GL_ASSERT( glBeginQuery(GL_TIME_ELAPSED, _queries[_nextQuery]) );
+            _queryActive = true;
+        }
+#endif
+    }
+    else
+    {
+        double time = Game::getAbsoluteTime();
+        if (_lastFrameTime > 0.0)
+            addSample((float)(time - _lastFrameTime), false);
+        _lastFrameTime = time;
+    }
+
+    return _frameBuffer;
+}
+
+void DynamicResolution::end()
+{
+    GP_ASSERT(_previousBuffer);
+
+#ifdef GP_USE_TIMER_QUERIES
+    if (_queryActive)
+    {
+        GL_ASSERT( glEndQuery(GL_TIME_ELAPSED) );
+        _queryPending[_nextQuery] = true;
+        _nextQuery = (_nextQuery + 1) % DYNAMIC_RESOLUTION_QUERY_COUNT;
+        _queryActive = false;
+    }
+#endif
+
+    // The depth and stencil of the frame buffer are discarded as it is unbound.
+    _previousBuffer->bind();
+    Game::getInstance()->setViewport(_previousViewport);
+
+    if (_quad)
+    {
+        // Only the drawn part of the frame buffer is sampled, clamped half a texel inside of
+        // it so that linear filtering doesn't blend in the undrawn part.
+        float textureWidth = (float)_frameBuffer->getWidth();
+        float textureHeight = (float)_frameBuffer->getHeight();
+        Material* material = _quad->getMaterial();
+        material->getParameter("u_texture")->setValue(_sampler);
+        material->getParameter("u_textureScale")->setValue(Vector2(_renderWidth / textureWidth, _renderHeight / textureHeight));
+        material->getParameter("u_textureMax")->setValue(Vector2((_renderWidth - 0.5f) / textureWidth, (_renderHeight - 0.5f) / textureHeight));
+        _quad->draw();
+    }
+
+    _previousBuffer = NULL;
+}
+
+void DynamicResolution::resize(unsigned int width, unsigned int height)
+{
+    _width = width;
+    _height = height;
+
+    unsigned int bufferWidth = std::max((unsigned int)ceilf(width * _maxScale), 1u);
+    unsigned int bufferHeight = std::max((unsigned int)ceilf(height * _maxScale), 1u);
+
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_frameBuffer);
+    _frameBuffer = FrameBuffer::create(DYNAMIC_RESOLUTION_ID, bufferWidth, bufferHeight, _format);
+    DepthStencilTarget* depthStencil = DepthStencilTarget::create(DYNAMIC_RESOLUTION_ID, DepthStencilTarget::DEPTH_STENCIL, bufferWidth, bufferHeight);
+    _frameBuffer->setDepthStencilTarget(depthStencil);
+    _frameBuffer->setDiscardOnUnbind(FrameBuffer::ATTACHMENT_DEPTH_STENCIL);
+    SAFE_RELEASE(depthStencil);
+
+    _sampler = Texture::Sampler::create(_frameBuffer->getRenderTarget()->getTexture());
+    _sampler->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+    _sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+}
+
+void DynamicResolution::readQueries()
+{
+#ifdef GP_USE_TIMER_QUERIES
+#if defined(__ANDROID__) && defined(GL_GPU_DISJOINT_EXT)
+    // Results that span a disjoint event, such as a change of the GPU clock, are meaningless.
+    GLint disjoint = 0;
+    glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjoint);
+#else
+    GLint disjoint = 0;
+#endif
+
+    // Read the queries from the oldest, stopping at the first one that is not available yet.
+    for (unsigned int i = 0; i < DYNAMIC_RESOLUTION_QUERY_COUNT; ++i)
+    {
+        unsigned int index = (_nextQuery + i) % DYNAMIC_RESOLUTION_QUERY_COUNT;
+        if (!_queryPending[index])
+            continue;
+
+        GLuint available = 0;
+        GL_ASSERT( glGetQueryObjectuiv(_queries[index], GL_QUERY_RESULT_AVAILABLE, &available) );
+        if (!available)
+            break;
+
+        GLuint64 elapsed = 0;
+        GL_ASSERT( glGetQueryObjectui64v(_queries[index], GL_QUERY_RESULT, &elapsed) );
+        _queryPending[index] = false;
+        if (!disjoint)
+            addSample((float)((double)elapsed / 1000000.0), true);
+    }
+#endif
+}
+
+void DynamicResolution::addSample(float time, bool gpu)
+{
+    if (_measuredTime <= 0.0f)
+        _measuredTime = time;
+    else
+        _measuredTime += (time - _measuredTime) * DYNAMIC_RESOLUTION_SMOOTHING;
+
+    if (!_adaptive || ++_sampleCount < DYNAMIC_RESOLUTION_INTERVAL)
+        return;
+    _sampleCount = 0;
+
+    // The drawn area, which the time roughly follows, grows with the square of the scale.
+    float ratio = 1.0f;
+    if (gpu)
+    {
+        if (_measuredTime > _targetFrameTime)
+            ratio = sqrt(_targetFrameTime / _measuredTime);
+        else if (_measuredTime < _targetFrameTime * DYNAMIC_RESOLUTION_RAISE_THRESHOLD)
+            ratio = sqrt(_targetFrameTime * DYNAMIC_RESOLUTION_RAISE_TARGET / _measuredTime);
+    }
+    else
+    {
+        // Frame times are limited by the display, so they only tell that frames are late. The
+        // scale is raised in small steps while frames are on time and lowered again if that
+        // made them late.
+        if (_measuredTime > _targetFrameTime * DYNAMIC_RESOLUTION_LATE_THRESHOLD)
+        {
+            ratio = sqrt(_targetFrameTime / _measuredTime);
+            _onTimeIntervals = 0;
+        }
+        else if (++_onTimeIntervals >= DYNAMIC_RESOLUTION_ON_TIME_INTERVALS)
+        {
+            ratio = 1.0f + DYNAMIC_RESOLUTION_PROBE_STEP;
+            _onTimeIntervals = 0;
+        }
+    }
+
+    ratio = MATH_CLAMP(ratio, 1.0f - DYNAMIC_RESOLUTION_MAX_STEP, 1.0f + DYNAMIC_RESOLUTION_MAX_STEP);
+    _scale = MATH_CLAMP(_scale * ratio, _minScale, _maxScale);
+}
+
+}
@@ -0,0 +1,208 @@
+#ifndef DYNAMICRESOLUTION_H_
+#define DYNAMICRESOLUTION_H_
+
+#include "Ref.h"
+#include "Texture.h"
+#include "Rectangle.h"
+
+// The number of GPU timer queries kept in flight, so that results are read without waiting.
+#define DYNAMIC_RESOLUTION_QUERY_COUNT 4
+
+namespace gameplay
+{
+
+class FrameBuffer;
+class Model;
+
+/**
+ * Defines a frame buffer that a scene is drawn into at a resolution that adapts to how long
+ * the GPU takes to draw it.
+ *
+ * The scene is drawn between begin() and end(). begin() binds a frame buffer and sets the
+ * viewport to the current scale of the viewport that was set before, and end() draws the
+ * scene upscaled into the frame buffer and viewport that were bound before begin(), which
+ * are bound again. Anything drawn after end(), such as forms, is drawn at full resolution.
+ *
+ * The time the GPU spends between begin() and end() is measured with timer queries where the
+ * platform supports them, which are ARB_timer_query on desktop OpenGL and
+ * EXT_disjoint_timer_query on OpenGL ES. Otherwise the time between frames is used, which
+ * can only tell that frames are late. The measured time is smoothed, and at regular intervals
+ * the scale is lowered when it is above the target frame time and raised when it is well
+ * below it, which changes the drawn area in proportion to the measured time.
+ *
+ * The frame buffer is allocated for the largest scale, and lower scales only draw to a part
+ * of it, so the scale changes without reallocating it.
+ *
+ * @script{ignore}
+ */
+class DynamicResolution : public Ref
+{
+public:
+
+    /**
+     * Creates a dynamic resolution frame buffer.
+     *
+     * @param targetFrameTime The GPU time to keep the scene under, in milliseconds.
+     * @param format The format of the frame buffer.
+     *
+     * @return The new dynamic resolution frame buffer.
+     */
+    static DynamicResolution* create(float targetFrameTime = 14.0f, Texture::Format format = Texture::RGBA);
+
+    /**
+     * Returns whether GPU time can be measured on this platform.
+     *
+     * @return true if GPU timer queries are supported.
+     */
+    static bool isGpuTimingSupported();
+
+    /**
+     * Sets the GPU time to keep the scene under.
+     *
+     * @param time The target frame time, in milliseconds.
+     */
+    void setTargetFrameTime(float time);
+
+    /**
+     * Returns the GPU time to keep the scene under.
+     *
+     * @return The target frame time, in milliseconds.
+     */
+    float getTargetFrameTime() const;
+
+    /**
+     * Sets the range of the scale of the resolution.
+     *
+     * @param minScale The lowest scale, greater than 0.
+     * @param maxScale The highest scale, at least minScale. Scales above 1 supersample the scene.
+     */
+    void setScaleRange(float minScale, float maxScale);
+
+    /**
+     * Returns the lowest scale of the resolution.
+     *
+     * @return The lowest scale.
+     */
+    float getMinScale() const;
+
+    /**
+     * Returns the highest scale of the resolution.
+     *
+     * @return The highest scale.
+     */
+    float getMaxScale() const;
+
+    /**
+     * Sets the scale of the resolution, which is clamped to the scale range.
+     *
+     * @param scale The scale of the width and height of the viewport.
+     */
+    void setScale(float scale);
+
+    /**
+     * Returns the scale of the resolution that the next frame is drawn at.
+     *
+     * @return The scale of the width and height of the viewport.
+     */
+    float getScale() const;
+
+    /**
+     * Sets whether the scale adapts to the measured time.
+     *
+     * @param adaptive true to adapt the scale, false to keep the scale set with setScale.
+     */
+    void setAdaptive(bool adaptive);
+
+    /**
+     * Returns whether the scale adapts to the measured time.
+     *
+     * @return true if the scale adapts.
+     */
+    bool isAdaptive() const;
+
+    /**
+     * Returns the smoothed time that the scene took to draw.
+     *
+     * @return The measured GPU time, or the frame time when GPU time can't be measured, in milliseconds.
+     */
+    float getMeasuredTime() const;
+
+    /**
+     * Binds the frame buffer that the scene is drawn into and sets the viewport to the scaled
+     * viewport. The frame buffer is not cleared.
+     *
+     * @return The frame buffer of the scene.
+     */
+    FrameBuffer* begin();
+
+    /**
+     * Draws the scene upscaled into the frame buffer and viewport that were bound before
+     * begin(), which are bound again, and adapts the scale for the next frame.
+     */
+    void end();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    DynamicResolution(float targetFrameTime, Texture::Format format);
+
+    /**
+     * Destructor.
+     */
+    ~DynamicResolution();
+
+    /**
+     * Hidden copy constructor.
+     */
+    DynamicResolution(const DynamicResolution& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    DynamicResolution& operator=(const DynamicResolution&);
+
+    /**
+     * Recreates the frame buffer for the given viewport size at the highest scale.
+     */
+    void resize(unsigned int width, unsigned int height);
+
+    /**
+     * Reads the results of the timer queries that are available.
+     */
+    void readQueries();
+
+    /**
+     * Adds a measured time and adapts the scale at the end of an interval.
+     */
+    void addSample(float time, bool gpu);
+
+    float _targetFrameTime;
+    Texture::Format _format;
+    float _minScale;
+    float _maxScale;
+    float _scale;
+    bool _adaptive;
+    float _measuredTime;
+    unsigned int _sampleCount;
+    unsigned int _onTimeIntervals;
+    unsigned int _width;
+    unsigned int _height;
+    unsigned int _renderWidth;
+    unsigned int _renderHeight;
+    FrameBuffer* _frameBuffer;
+    Texture::Sampler* _sampler;
+    Model* _quad;
+    FrameBuffer* _previousBuffer;
+    Rectangle _previousViewport;
+    double _lastFrameTime;
+    unsigned int _queries[DYNAMIC_RESOLUTION_QUERY_COUNT];
+    bool _queryPending[DYNAMIC_RESOLUTION_QUERY_COUNT];
+    unsigned int _nextQuery;
+    bool _queryActive;
+};
+
+}
+
+#endif
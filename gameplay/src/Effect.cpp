@@ -1,25 +1,80 @@
 #include "Base.h"
 #include "Effect.h"
+#include "RenderStats.h"
+#include "ResourceManager.h"
 #include "FileSystem.h"
 #include "Game.h"
 
 #define OPENGL_ES_DEFINE  "OPENGL_ES"
 
+// Errors building an effect are fatal, except while effects are reloaded, which keep their
+// previous program when their new shaders fail to build.
+#define EFFECT_ERROR(...) do \
+    { \
+        if (__reloading) \
+            GP_WARN(__VA_ARGS__); \
+        else \
+            GP_ERROR(__VA_ARGS__); \
+    } while (0)
+
 namespace gameplay
 {
 
 // Cache of unique effects.
-static std::map<std::string, Effect*> __effectCache;
 static Effect* __currentEffect = NULL;
 
-Effect::Effect() : _program(0)
+// Whether effects are being built to reload effects or materials.
+static bool __reloading = false;
+
+// Marks parameter ids that have no uniform in an effect.
+Uniform Effect::_emptyUniform;
+
+struct Effect::PendingLink
+{
+    GLuint vertexShader;
+    GLuint fragmentShader;
+    std::string cachePath;
+    unsigned long long cacheKey;
+};
+
+/**
+ * Returns whether effects loaded from files are compiled in the background.
+ */
+static bool isAsyncCompileEnabled()
+{
+#ifdef GP_USE_PARALLEL_SHADER_COMPILE
+    static int enabled = -1;
+    if (enabled < 0)
+    {
+        Properties* graphicsConfig = Game::getInstance()->getConfig()->getNamespace("graphics", true);
+        enabled = (graphicsConfig && graphicsConfig->getBool("asyncShaders") && glMaxShaderCompilerThreadsKHR) ? 1 : 0;
+        if (enabled)
+        {
+            // Let the driver pick the number of compiler threads.
+            GL_ASSERT( glMaxShaderCompilerThreadsKHR(0xFFFFFFFF) );
+        }
+    }
+    return enabled == 1;
+#else
+    return false;
+#endif
+}
+
+Effect::Effect() : _program(0), _frameBlock(false), _objectBlock(false), _pending(NULL), _depthEffect(NULL), _depthEffectLoaded(false)
 {
 }
 
 Effect::~Effect()
 {
-    // Remove this effect from the cache.
-    __effectCache.erase(_id);
+    FileSystem::unwatch(this);
+    SAFE_RELEASE(_depthEffect);
+
+    if (_pending)
+    {
+        GL_ASSERT( glDeleteShader(_pending->vertexShader) );
+        GL_ASSERT( glDeleteShader(_pending->fragmentShader) );
+        SAFE_DELETE(_pending);
+    }
 
     // Free uniforms.
     for (std::map<std::string, Uniform*>::iterator itr = _uniforms.begin(); itr != _uniforms.end(); ++itr)
@@ -42,6 +97,11 @@ Effect::~Effect()
 }
 
 Effect* Effect::createFromFile(const char* vshPath, const char* fshPath, const char* defines)
+{
+    return createCached(vshPath, fshPath, defines, NULL, NULL);
+}
+
+Effect* Effect::createCached(const char* vshPath, const char* fshPath, const char* defines, const char* vshSource, const char* fshSource)
 {
     GP_ASSERT(vshPath);
     GP_ASSERT(fshPath);
@@ -55,44 +115,53 @@ Effect* Effect::createFromFile(const char* vshPath, const char* fshPath, const c
     {
         uniqueId += defines;
     }
-    std::map<std::string, Effect*>::const_iterator itr = __effectCache.find(uniqueId);
-    if (itr != __effectCache.end())
+    Effect* cached = static_cast<Effect*>(ResourceManager::find(ResourceManager::EFFECT, uniqueId));
+    if (cached)
     {
-        // Found an exiting effect with this id, so increase its ref count and return it.
-        GP_ASSERT(itr->second);
-        itr->second->addRef();
-        return itr->second;
+        // Found an exiting effect with this id, which has a new reference.
+        return cached;
     }
 
     // Read source from file.
-    char* vshSource = FileSystem::readAll(vshPath);
-    if (vshSource == NULL)
+    char* vshFileSource = vshSource ? NULL : FileSystem::readAll(vshPath);
+    if (vshSource == NULL && vshFileSource == NULL)
     {
-        GP_ERROR("Failed to read vertex shader from file '%s'.", vshPath);
+        EFFECT_ERROR("Failed to read vertex shader from file '%s'.", vshPath);
         return NULL;
     }
-    char* fshSource = FileSystem::readAll(fshPath);
-    if (fshSource == NULL)
+    char* fshFileSource = fshSource ? NULL : FileSystem::readAll(fshPath);
+    if (fshSource == NULL && fshFileSource == NULL)
     {
-        GP_ERROR("Failed to read fragment shader from file '%s'.", fshPath);
-        SAFE_DELETE_ARRAY(vshSource);
+        EFFECT_ERROR("Failed to read fragment shader from file '%s'.", fshPath);
+        SAFE_DELETE_ARRAY(vshFileSource);
         return NULL;
     }
 
-    Effect* effect = createFromSource(vshPath, vshSource, fshPath, fshSource, defines);
+    Effect* effect = createFromSource(vshPath, vshSource ? vshSource : vshFileSource, fshPath, fshSource ? fshSource : fshFileSource, defines, isAsyncCompileEnabled() && !__reloading);
+
+    // The driver doesn't report the size of programs, which are estimated by the size of their sources.
+    size_t size = strlen(vshSource ? vshSource : vshFileSource) + strlen(fshSource ? fshSource : fshFileSource);
     
-    SAFE_DELETE_ARRAY(vshSource);
-    SAFE_DELETE_ARRAY(fshSource);
+    SAFE_DELETE_ARRAY(vshFileSource);
+    SAFE_DELETE_ARRAY(fshFileSource);
 
     if (effect == NULL)
     {
-        GP_ERROR("Failed to create effect from shaders '%s', '%s'.", vshPath, fshPath);
+        EFFECT_ERROR("Failed to create effect from shaders '%s', '%s'.", vshPath, fshPath);
     }
     else
     {
         // Store this effect in the cache.
         effect->_id = uniqueId;
-        __effectCache[uniqueId] = effect;
+        ResourceManager::add(ResourceManager::EFFECT, uniqueId, effect, size);
+
+        if (FileSystem::isWatchEnabled())
+        {
+            for (size_t i = 0, count = effect->_files.size(); i < count; ++i)
+            {
+                FileSystem::watch(effect->_files[i].c_str(), effect);
+            }
+        }
     }
 
     return effect;
@@ -100,7 +169,70 @@ Effect* Effect::createFromFile(const char* vshPath, const char* fshPath, const c
 
 Effect* Effect::createFromSource(const char* vshSource, const char* fshSource, const char* defines)
 {
-    return createFromSource(NULL, vshSource, NULL, fshSource, defines);
+    return createFromSource(NULL, vshSource, NULL, fshSource, defines, false);
+}
+
+/**
+ * The defines that only affect the shading of fragments, which depth variants leave out.
+ */
+static const char* __shadingDefines[] =
+{
+    "DIRECTIONAL_LIGHT_COUNT",
+    "POINT_LIGHT_COUNT",
+    "SPOT_LIGHT_COUNT",
+    "CLUSTERED_LIGHTING",
+    "SHADOWS",
+    "SHADOW_CASCADE_COUNT",
+    "SPECULAR",
+    "BUMPED",
+    "LIGHTMAP",
+    "NORMAL_MAP",
+    "MODULATE_COLOR",
+    "MODULATE_ALPHA",
+    "DEBUG_PATCHES"
+};
+
+Effect* Effect::getDepthEffect()
+{
+    if (_depthEffectLoaded)
+        return _depthEffect;
+    _depthEffectLoaded = true;
+
+    // The id of an effect loaded from files is its vertex shader path, fragment shader path
+    // and defines, separated by semicolons.
+    size_t fshStart = _id.find(';');
+    size_t definesStart = fshStart != std::string::npos ? _id.find(';', fshStart + 1) : std::string::npos;
+    if (definesStart == std::string::npos)
+        return NULL;
+
+    std::string defines;
+    std::string remaining = _id.substr(definesStart + 1);
+    while (!remaining.empty())
+    {
+        size_t end = remaining.find(';');
+        std::string define = remaining.substr(0, end);
+        remaining = end != std::string::npos ? remaining.substr(end + 1) : std::string();
+
+        // Effects that are depth variants already have none of their own.
+        std::string name = define.substr(0, define.find_first_of(" \t"));
+        if (name == "DEPTH_PASS")
+            return NULL;
+
+        bool shading = name.empty();
+        for (size_t i = 0; i < sizeof(__shadingDefines) / sizeof(__shadingDefines[0]) && !shading; ++i)
+            shading = name == __shadingDefines[i];
+        if (!shading)
+        {
+            defines += define;
+            defines += ';';
+        }
+    }
+    defines += "DEPTH_PASS";
+
+    std::string vshPath = _id.substr(0, fshStart);
+    std::string fshPath = _id.substr(fshStart + 1, definesStart - fshStart - 1);
+    _depthEffect = createFromFile(vshPath.c_str(), fshPath.c_str(), defines.c_str());
+    return _depthEffect;
 }
 
 static void replaceDefines(const char* defines, std::string& out)
@@ -140,7 +272,7 @@ static void replaceDefines(const char* defines, std::string& out)
     }
 }
 
-static void replaceIncludes(const char* filepath, const char* source, std::string& out)
+static void replaceIncludes(const char* filepath, const char* source, std::string& out, std::vector<std::string>* files)
 {
     // Replace the #include "xxxx.xxx" with the sourced file contents of "filepath/xxxx.xxx"
     std::string str = source;
@@ -173,7 +305,7 @@ static void replaceIncludes(const char* filepath, const char* source, std::strin
             if (startQuote == std::string::npos)
             {
                 // We have started an "#include" but missing the leading quote "
-                GP_ERROR("Compile failed for shader '%s' missing leading \".", filepath);
+                EFFECT_ERROR("Compile failed for shader '%s' missing leading \".", filepath);
                 return;
             }
             // find the end quote "
@@ -181,7 +313,7 @@ static void replaceIncludes(const char* filepath, const char* source, std::strin
             if (endQuote == std::string::npos)
             {
                 // We have a start quote but missing the trailing quote "
-                GP_ERROR("Compile failed for shader '%s' missing trailing \".", filepath);
+                EFFECT_ERROR("Compile failed for shader '%s' missing trailing \".", filepath);
                 return;
             }
 
@@ -194,16 +326,18 @@ static void replaceIncludes(const char* filepath, const char* source, std::strin
             size_t len = endQuote - (startQuote);
             std::string includeStr = str.substr(startQuote, len);
             directoryPath.append(includeStr);
+            if (std::find(files->begin(), files->end(), directoryPath) == files->end())
+                files->push_back(directoryPath);
             const char* includedSource = FileSystem::readAll(directoryPath.c_str());
             if (includedSource == NULL)
             {
-                GP_ERROR("Compile failed for shader '%s' invalid filepath.", filepathStr.c_str());
+                EFFECT_ERROR("Compile failed for shader '%s' invalid filepath.", filepathStr.c_str());
                 return;
             }
             else
             {
                 // Valid file so lets attempt to see if we need to append anything to it too (recurse...)
-                replaceIncludes(directoryPath.c_str(), includedSource, out);
+                replaceIncludes(directoryPath.c_str(), includedSource, out, files);
                 SAFE_DELETE_ARRAY(includedSource);
             }
         }
@@ -226,13 +360,162 @@ static void writeShaderToErrorFile(const char* filePath, const char* source)
     }
 }
 
-Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines)
+#ifdef GP_USE_PROGRAM_BINARY
+
+// Identifies program binary cache files and their layout version.
+#define PROGRAM_BINARY_MAGIC 0x42505047
+#define PROGRAM_BINARY_VERSION 1
+
+// Header written at the start of every program binary cache file.
+struct ProgramBinaryHeader
 {
-    GP_ASSERT(vshSource);
-    GP_ASSERT(fshSource);
+    unsigned int magic;
+    unsigned int version;
+    unsigned long long key;
+    unsigned int format;
+    unsigned int length;
+};
+
+static unsigned long long hashString(unsigned long long hash, const char* str)
+{
+    // 64-bit FNV-1a.
+    if (str)
+    {
+        for (; *str; ++str)
+        {
+            hash ^= (unsigned char)*str;
+            hash *= 1099511628211ULL;
+        }
+    }
+    return hash;
+}
 
-    const unsigned int SHADER_SOURCE_LENGTH = 3;
-    const GLchar* shaderSource[SHADER_SOURCE_LENGTH];
+/**
+ * Returns whether linked programs are cached and, if so, the cache key and file path
+ * for a program built from the given preprocessed shader sources.
+ */
+static bool getProgramBinaryCachePath(const char* defines, const char* vshSource, const char* fshSource, unsigned long long* key, std::string& path)
+{
+    if (!glGetProgramBinary || !glProgramBinary)
+        return false;
+
+    Properties* graphicsConfig = Game::getInstance()->getConfig()->getNamespace("graphics", true);
+#ifdef OPENGL_ES
+    bool enabled = graphicsConfig ? graphicsConfig->getBool("shaderCache", true) : true;
+#else
+    bool enabled = graphicsConfig ? graphicsConfig->getBool("shaderCache", false) : false;
+#endif
+    if (!enabled)
+        return false;
+
+    // Binaries are only valid for the driver that created them.
+    GLint formatCount = 0;
+    GL_ASSERT( glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount) );
+    if (formatCount <= 0)
+        return false;
+
+    unsigned long long hash = 14695981039346656037ULL;
+    hash = hashString(hash, defines);
+    hash = hashString(hash, vshSource);
+    hash = hashString(hash, fshSource);
+    hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+    *key = hash;
+
+    const char* cachePath = graphicsConfig ? graphicsConfig->getString("shaderCachePath") : NULL;
+    char name[32];
+    sprintf(name, "%016llx.bin", hash);
+    path = cachePath ? cachePath : "";
+    if (path.length() > 0 && path[path.length() - 1] != '/')
+        path += '/';
+    path += name;
+    return true;
+}
+
+/**
+ * Loads a linked program from the given cache file, or returns 0 if there is no
+ * valid binary for the given key.
+ */
+static GLuint loadProgramBinary(const char* path, unsigned long long key)
+{
+    if (!FileSystem::fileExists(path))
+        return 0;
+
+    int size = 0;
+    char* data = FileSystem::readAll(path, &size);
+    if (data == NULL)
+        return 0;
+
+    GLuint program = 0;
+    const ProgramBinaryHeader* header = (const ProgramBinaryHeader*)data;
+    if (size >= (int)sizeof(ProgramBinaryHeader) && header->magic == PROGRAM_BINARY_MAGIC && header->version == PROGRAM_BINARY_VERSION &&
+        header->key == key && header->length == (unsigned int)(size - sizeof(ProgramBinaryHeader)))
+    {
+        GL_ASSERT( program = glCreateProgram() );
+        GL_ASSERT( glProgramBinary(program, header->format, data + sizeof(ProgramBinaryHeader), header->length) );
+
+        // Drivers reject binaries after updates, in which case the program is built from source again.
+        GLint success = GL_FALSE;
+        GL_ASSERT( glGetProgramiv(program, GL_LINK_STATUS, &success) );
+        if (success != GL_TRUE)
+        {
+            GL_ASSERT( glDeleteProgram(program) );
+            program = 0;
+        }
+    }
+    SAFE_DELETE_ARRAY(data);
+
+    return program;
+}
+
+/**
+ * Writes the binary of the given linked program to the given cache file.
+ */
+static void saveProgramBinary(GLuint program, const char* path, unsigned long long key)
+{
+    GLint length = 0;
+    GL_ASSERT( glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length) );
+    if (length <= 0)
+        return;
+
+    ProgramBinaryHeader header;
+    header.magic = PROGRAM_BINARY_MAGIC;
+    header.version = PROGRAM_BINARY_VERSION;
+    header.key = key;
+    header.format = 0;
+    header.length = 0;
+
+    char* data = new char[length];
+    GLenum format = 0;
+    GLsizei written = 0;
+    GL_ASSERT( glGetProgramBinary(program, length, &written, &format, data) );
+    header.format = format;
+    header.length = written;
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::WRITE));
+    if (written > 0 && stream.get() != NULL && stream->canWrite())
+    {
+        stream->write(&header, sizeof(ProgramBinaryHeader), 1);
+        stream->write(data, 1, written);
+    }
+    else
+    {
+        GP_WARN("Failed to write program binary cache file '%s'.", path);
+    }
+    SAFE_DELETE_ARRAY(data);
+}
+
+#endif
+
+/**
+ * Compiles and links a program from the given shader sources, or returns 0 on failure.
+ *
+ * The last entry of shaderSource is replaced with the preprocessed source of each shader.
+ */
+static GLuint compileProgram(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const GLchar** shaderSource, unsigned int sourceCount,
+                             const char* vshFinalSource, const char* fshFinalSource, bool retrievable)
+{
     char* infoLog = NULL;
     GLuint vertexShader;
     GLuint fragmentShader;
@@ -240,23 +523,9 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
     GLint length;
     GLint success;
 
-    // Replace all comma separated definitions with #define prefix and \n suffix
-    std::string definesStr = "";
-    replaceDefines(defines, definesStr);
-    
-    shaderSource[0] = definesStr.c_str();
-    shaderSource[1] = "\n";
-    std::string vshSourceStr = "";
-    if (vshPath)
-    {
-        // Replace the #include "xxxxx.xxx" with the sources that come from file paths
-        replaceIncludes(vshPath, vshSource, vshSourceStr);
-        if (vshSource && strlen(vshSource) != 0)
-            vshSourceStr += "\n";
-    }
-    shaderSource[2] = vshPath ? vshSourceStr.c_str() :  vshSource;
+    shaderSource[sourceCount - 1] = vshFinalSource;
     GL_ASSERT( vertexShader = glCreateShader(GL_VERTEX_SHADER) );
-    GL_ASSERT( glShaderSource(vertexShader, SHADER_SOURCE_LENGTH, shaderSource, NULL) );
+    GL_ASSERT( glShaderSource(vertexShader, sourceCount, shaderSource, NULL) );
     GL_ASSERT( glCompileShader(vertexShader) );
     GL_ASSERT( glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success) );
     if (success != GL_TRUE)
@@ -275,29 +544,21 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
 
         // Write out the expanded shader file.
         if (vshPath)
-            writeShaderToErrorFile(vshPath, shaderSource[2]);
+            writeShaderToErrorFile(vshPath, vshFinalSource);
 
-        GP_ERROR("Compile failed for vertex shader '%s' with error '%s'.", vshPath == NULL ? vshSource : vshPath, infoLog == NULL ? "" : infoLog);
+        EFFECT_ERROR("Compile failed for vertex shader '%s' with error '%s'.", vshPath == NULL ? vshSource : vshPath, infoLog == NULL ? "" : infoLog);
         SAFE_DELETE_ARRAY(infoLog);
 
         // Clean up.
         GL_ASSERT( glDeleteShader(vertexShader) );
 
-        return NULL;
+        return 0;
     }
 
     // Compile the fragment shader.
-    std::string fshSourceStr;
-    if (fshPath)
-    {
-        // Replace the #include "xxxxx.xxx" with the sources that come from file paths
-        replaceIncludes(fshPath, fshSource, fshSourceStr);
-        if (fshSource && strlen(fshSource) != 0)
-            fshSourceStr += "\n";
-    }
-    shaderSource[2] = fshPath ? fshSourceStr.c_str() : fshSource;
+    shaderSource[sourceCount - 1] = fshFinalSource;
     GL_ASSERT( fragmentShader = glCreateShader(GL_FRAGMENT_SHADER) );
-    GL_ASSERT( glShaderSource(fragmentShader, SHADER_SOURCE_LENGTH, shaderSource, NULL) );
+    GL_ASSERT( glShaderSource(fragmentShader, sourceCount, shaderSource, NULL) );
     GL_ASSERT( glCompileShader(fragmentShader) );
     GL_ASSERT( glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success) );
     if (success != GL_TRUE)
@@ -316,22 +577,28 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
         
         // Write out the expanded shader file.
         if (fshPath)
-            writeShaderToErrorFile(fshPath, shaderSource[2]);
+            writeShaderToErrorFile(fshPath, fshFinalSource);
 
-        GP_ERROR("Compile failed for fragment shader (%s): %s", fshPath == NULL ? fshSource : fshPath, infoLog == NULL ? "" : infoLog);
+        EFFECT_ERROR("Compile failed for fragment shader (%s): %s", fshPath == NULL ? fshSource : fshPath, infoLog == NULL ? "" : infoLog);
         SAFE_DELETE_ARRAY(infoLog);
 
         // Clean up.
         GL_ASSERT( glDeleteShader(vertexShader) );
         GL_ASSERT( glDeleteShader(fragmentShader) );
 
-        return NULL;
+        return 0;
     }
 
     // Link program.
     GL_ASSERT( program = glCreateProgram() );
     GL_ASSERT( glAttachShader(program, vertexShader) );
     GL_ASSERT( glAttachShader(program, fragmentShader) );
+#if defined(GP_USE_PROGRAM_BINARY) && !defined(OPENGL_ES)
+    if (retrievable && glProgramParameteri)
+    {
+        GL_ASSERT( glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE) );
+    }
+#endif
     GL_ASSERT( glLinkProgram(program) );
     GL_ASSERT( glGetProgramiv(program, GL_LINK_STATUS, &success) );
 
@@ -353,18 +620,209 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
             GL_ASSERT( glGetProgramInfoLog(program, length, NULL, infoLog) );
             infoLog[length-1] = '\0';
         }
-        GP_ERROR("Linking program failed (%s,%s): %s", vshPath == NULL ? "NULL" : vshPath, fshPath == NULL ? "NULL" : fshPath, infoLog == NULL ? "" : infoLog);
+        EFFECT_ERROR("Linking program failed (%s,%s): %s", vshPath == NULL ? "NULL" : vshPath, fshPath == NULL ? "NULL" : fshPath, infoLog == NULL ? "" : infoLog);
         SAFE_DELETE_ARRAY(infoLog);
 
         // Clean up.
         GL_ASSERT( glDeleteProgram(program) );
 
-        return NULL;
+        return 0;
+    }
+
+    return program;
+}
+
+Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines, bool async)
+{
+    GP_ASSERT(vshSource);
+    GP_ASSERT(fshSource);
+
+    const unsigned int SHADER_SOURCE_LENGTH = 3;
+    const GLchar* shaderSource[SHADER_SOURCE_LENGTH];
+    GLuint program = 0;
+
+    // Replace all comma separated definitions with #define prefix and \n suffix
+    std::string definesStr = "";
+    replaceDefines(defines, definesStr);
+    
+    shaderSource[0] = definesStr.c_str();
+    shaderSource[1] = "\n";
+    std::vector<std::string> files;
+    std::string vshSourceStr = "";
+    if (vshPath)
+    {
+        // Replace the #include "xxxxx.xxx" with the sources that come from file paths
+        files.push_back(vshPath);
+        replaceIncludes(vshPath, vshSource, vshSourceStr, &files);
+        if (vshSource && strlen(vshSource) != 0)
+            vshSourceStr += "\n";
+    }
+    std::string fshSourceStr;
+    if (fshPath)
+    {
+        // Replace the #include "xxxxx.xxx" with the sources that come from file paths
+        if (std::find(files.begin(), files.end(), fshPath) == files.end())
+            files.push_back(fshPath);
+        replaceIncludes(fshPath, fshSource, fshSourceStr, &files);
+        if (fshSource && strlen(fshSource) != 0)
+            fshSourceStr += "\n";
+    }
+    const char* vshFinalSource = vshPath ? vshSourceStr.c_str() : vshSource;
+    const char* fshFinalSource = fshPath ? fshSourceStr.c_str() : fshSource;
+
+#ifdef GP_USE_PROGRAM_BINARY
+    // Try to load a previously linked binary of exactly these sources. Reloaded programs are
+    // built from source, since they may be linked again with the attribute locations they replace.
+    unsigned long long cacheKey = 0;
+    std::string cachePath;
+    bool useCache = !__reloading && getProgramBinaryCachePath(definesStr.c_str(), vshFinalSource, fshFinalSource, &cacheKey, cachePath);
+    if (useCache)
+        program = loadProgramBinary(cachePath.c_str(), cacheKey);
+#endif
+
+#ifdef GP_USE_PARALLEL_SHADER_COMPILE
+    if (program == 0 && async)
+    {
+        // Start compiling and linking without querying any status, since that would wait for the driver.
+        Effect* effect = new Effect();
+        effect->_pending = new PendingLink();
+        shaderSource[SHADER_SOURCE_LENGTH - 1] = vshFinalSource;
+        GL_ASSERT( effect->_pending->vertexShader = glCreateShader(GL_VERTEX_SHADER) );
+        GL_ASSERT( glShaderSource(effect->_pending->vertexShader, SHADER_SOURCE_LENGTH, shaderSource, NULL) );
+        GL_ASSERT( glCompileShader(effect->_pending->vertexShader) );
+        shaderSource[SHADER_SOURCE_LENGTH - 1] = fshFinalSource;
+        GL_ASSERT( effect->_pending->fragmentShader = glCreateShader(GL_FRAGMENT_SHADER) );
+        GL_ASSERT( glShaderSource(effect->_pending->fragmentShader, SHADER_SOURCE_LENGTH, shaderSource, NULL) );
+        GL_ASSERT( glCompileShader(effect->_pending->fragmentShader) );
+
+        GL_ASSERT( program = glCreateProgram() );
+        GL_ASSERT( glAttachShader(program, effect->_pending->vertexShader) );
+        GL_ASSERT( glAttachShader(program, effect->_pending->fragmentShader) );
+#ifdef GP_USE_PROGRAM_BINARY
+#ifndef OPENGL_ES
+        if (useCache && glProgramParameteri)
+        {
+            GL_ASSERT( glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE) );
+        }
+#endif
+        if (useCache)
+        {
+            effect->_pending->cachePath = cachePath;
+            effect->_pending->cacheKey = cacheKey;
+        }
+#endif
+        GL_ASSERT( glLinkProgram(program) );
+        effect->_program = program;
+        effect->_files = files;
+        return effect;
+    }
+#endif
+
+    if (program == 0)
+    {
+#ifdef GP_USE_PROGRAM_BINARY
+        program = compileProgram(vshPath, vshSource, fshPath, fshSource, shaderSource, SHADER_SOURCE_LENGTH, vshFinalSource, fshFinalSource, useCache);
+#else
+        program = compileProgram(vshPath, vshSource, fshPath, fshSource, shaderSource, SHADER_SOURCE_LENGTH, vshFinalSource, fshFinalSource, false);
+#endif
+        if (program == 0)
+            return NULL;
+
+#ifdef GP_USE_PROGRAM_BINARY
+        if (useCache)
+            saveProgramBinary(program, cachePath.c_str(), cacheKey);
+#endif
     }
 
     // Create and return the new Effect.
     Effect* effect = new Effect();
     effect->_program = program;
+    effect->_files = files;
+
+    effect->queryProgram();
+
+    return effect;
+}
+
+bool Effect::isReady()
+{
+    if (_pending == NULL)
+        return true;
+
+#ifdef GP_USE_PARALLEL_SHADER_COMPILE
+    GLint completed = GL_FALSE;
+    GL_ASSERT( glGetProgramiv(_program, GL_COMPLETION_STATUS_KHR, &completed) );
+    if (completed != GL_TRUE)
+        return false;
+#endif
+
+    finishLink();
+    return true;
+}
+
+/**
+ * Appends the info log of the given shader or program object to the given string.
+ */
+static void appendInfoLog(GLuint object, bool program, std::string& out)
+{
+    GLint length = 0;
+    if (program)
+        GL_ASSERT( glGetProgramiv(object, GL_INFO_LOG_LENGTH, &length) );
+    else
+        GL_ASSERT( glGetShaderiv(object, GL_INFO_LOG_LENGTH, &length) );
+    if (length <= 1)
+        return;
+
+    char* infoLog = new char[length];
+    if (program)
+        GL_ASSERT( glGetProgramInfoLog(object, length, NULL, infoLog) );
+    else
+        GL_ASSERT( glGetShaderInfoLog(object, length, NULL, infoLog) );
+    infoLog[length-1] = '\0';
+    out += infoLog;
+    SAFE_DELETE_ARRAY(infoLog);
+}
+
+void Effect::finishLink()
+{
+    if (_pending == NULL)
+        return;
+
+    PendingLink* pending = _pending;
+    _pending = NULL;
+
+    GLint success;
+    GL_ASSERT( glGetProgramiv(_program, GL_LINK_STATUS, &success) );
+    if (success != GL_TRUE)
+    {
+        std::string infoLog;
+        appendInfoLog(pending->vertexShader, false, infoLog);
+        appendInfoLog(pending->fragmentShader, false, infoLog);
+        appendInfoLog(_program, true, infoLog);
+        GP_ERROR("Building program failed for effect '%s': %s", _id.c_str(), infoLog.c_str());
+
+        GL_ASSERT( glDeleteProgram(_program) );
+        _program = 0;
+    }
+
+    // Delete shaders after linking.
+    GL_ASSERT( glDeleteShader(pending->vertexShader) );
+    GL_ASSERT( glDeleteShader(pending->fragmentShader) );
+
+    if (_program)
+    {
+#ifdef GP_USE_PROGRAM_BINARY
+        if (!pending->cachePath.empty())
+            saveProgramBinary(_program, pending->cachePath.c_str(), pending->cacheKey);
+#endif
+        queryProgram();
+    }
+    SAFE_DELETE(pending);
+}
+
+void Effect::queryProgram()
+{
+    GLint length;
 
     // Query and store vertex attribute meta-data from the program.
     // NOTE: Rather than using glBindAttribLocation to explicitly specify our own
@@ -374,10 +832,10 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
     // and therefore using this function can create compatibility issues between
     // different hardware vendors.
     GLint activeAttributes;
-    GL_ASSERT( glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &activeAttributes) );
+    GL_ASSERT( glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTES, &activeAttributes) );
     if (activeAttributes > 0)
     {
-        GL_ASSERT( glGetProgramiv(program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length) );
+        GL_ASSERT( glGetProgramiv(_program, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &length) );
         if (length > 0)
         {
             GLchar* attribName = new GLchar[length + 1];
@@ -387,25 +845,46 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
             for (int i = 0; i < activeAttributes; ++i)
             {
                 // Query attribute info.
-                GL_ASSERT( glGetActiveAttrib(program, i, length, NULL, &attribSize, &attribType, attribName) );
+                GL_ASSERT( glGetActiveAttrib(_program, i, length, NULL, &attribSize, &attribType, attribName) );
                 attribName[length] = '\0';
 
                 // Query the pre-assigned attribute location.
-                GL_ASSERT( attribLocation = glGetAttribLocation(program, attribName) );
+                GL_ASSERT( attribLocation = glGetAttribLocation(_program, attribName) );
 
                 // Assign the vertex attribute mapping for the effect.
-                effect->_vertexAttributes[attribName] = attribLocation;
+                _vertexAttributes[attribName] = attribLocation;
             }
             SAFE_DELETE_ARRAY(attribName);
         }
     }
 
+#ifdef GP_USE_UNIFORM_BUFFERS
+    // Attach the engine's uniform blocks to their fixed binding points, where RenderState
+    // keeps the buffers holding the per-frame and per-object auto binding values.
+    if (glGetUniformBlockIndex)
+    {
+        GLuint blockIndex;
+        GL_ASSERT( blockIndex = glGetUniformBlockIndex(_program, UNIFORM_BLOCK_FRAME_NAME) );
+        if (blockIndex != GL_INVALID_INDEX)
+        {
+            GL_ASSERT( glUniformBlockBinding(_program, blockIndex, UNIFORM_BLOCK_FRAME_BINDING) );
+            _frameBlock = true;
+        }
+        GL_ASSERT( blockIndex = glGetUniformBlockIndex(_program, UNIFORM_BLOCK_OBJECT_NAME) );
+        if (blockIndex != GL_INVALID_INDEX)
+        {
+            GL_ASSERT( glUniformBlockBinding(_program, blockIndex, UNIFORM_BLOCK_OBJECT_BINDING) );
+            _objectBlock = true;
+        }
+    }
+#endif
+
     // Query and store uniforms from the program.
     GLint activeUniforms;
-    GL_ASSERT( glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &activeUniforms) );
+    GL_ASSERT( glGetProgramiv(_program, GL_ACTIVE_UNIFORMS, &activeUniforms) );
     if (activeUniforms > 0)
     {
-        GL_ASSERT( glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length) );
+        GL_ASSERT( glGetProgramiv(_program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &length) );
         if (length > 0)
         {
             GLchar* uniformName = new GLchar[length + 1];
@@ -416,7 +895,7 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
             for (int i = 0; i < activeUniforms; ++i)
             {
                 // Query uniform info.
-                GL_ASSERT( glGetActiveUniform(program, i, length, NULL, &uniformSize, &uniformType, uniformName) );
+                GL_ASSERT( glGetActiveUniform(_program, i, length, NULL, &uniformSize, &uniformType, uniformName) );
                 uniformName[length] = '\0';  // null terminate
                 if (length > 3)
                 {
@@ -432,13 +911,14 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
                 }
 
                 // Query the pre-assigned uniform location.
-                GL_ASSERT( uniformLocation = glGetUniformLocation(program, uniformName) );
+                GL_ASSERT( uniformLocation = glGetUniformLocation(_program, uniformName) );
 
                 Uniform* uniform = new Uniform();
-                uniform->_effect = effect;
+                uniform->_effect = this;
                 uniform->_name = uniformName;
                 uniform->_location = uniformLocation;
                 uniform->_type = uniformType;
+                uniform->_size = (unsigned int)uniformSize;
                 if (uniformType == GL_SAMPLER_2D || uniformType == GL_SAMPLER_CUBE)
                 {
                     uniform->_index = samplerIndex;
@@ -449,15 +929,165 @@ Effect* Effect::createFromSource(const char* vshPath, const char* vshSource, con
                     uniform->_index = 0;
                 }
 
-                effect->_uniforms[uniformName] = uniform;
+                _uniforms[uniformName] = uniform;
             }
             SAFE_DELETE_ARRAY(uniformName);
         }
     }
+}
 
+Effect* Effect::reloadFromFile(const char* vshPath, const char* fshPath, const char* defines)
+{
+    bool reloading = __reloading;
+    __reloading = true;
+    Effect* effect = createCached(vshPath, fshPath, defines, NULL, NULL);
+    __reloading = reloading;
     return effect;
 }
 
+bool Effect::reload()
+{
+    // The id of an effect loaded from files is its vertex shader path, fragment shader path
+    // and defines, separated by semicolons.
+    size_t fshStart = _id.find(';');
+    size_t definesStart = fshStart != std::string::npos ? _id.find(';', fshStart + 1) : std::string::npos;
+    if (definesStart == std::string::npos)
+    {
+        GP_WARN("Effect '%s' was not loaded from files and can't be reloaded.", _id.c_str());
+        return false;
+    }
+    std::string vshPath = _id.substr(0, fshStart);
+    std::string fshPath = _id.substr(fshStart + 1, definesStart - fshStart - 1);
+    std::string defines = _id.substr(definesStart + 1);
+
+    char* vshSource = FileSystem::readAll(vshPath.c_str());
+    char* fshSource = vshSource ? FileSystem::readAll(fshPath.c_str()) : NULL;
+    if (vshSource == NULL || fshSource == NULL)
+    {
+        GP_WARN("Failed to read the shaders of effect '%s'.", _id.c_str());
+        SAFE_DELETE_ARRAY(vshSource);
+        return false;
+    }
+    size_t size = strlen(vshSource) + strlen(fshSource);
+    __reloading = true;
+    Effect* effect = createFromSource(vshPath.c_str(), vshSource, fshPath.c_str(), fshSource, defines.c_str(), false);
+    __reloading = false;
+    SAFE_DELETE_ARRAY(vshSource);
+    SAFE_DELETE_ARRAY(fshSource);
+    if (effect == NULL)
+    {
+        GP_WARN("Failed to build effect '%s' again, which keeps its previous program.", _id.c_str());
+        return false;
+    }
+    if (_pending)
+        finishLink();
+
+    // The vertex attribute bindings of meshes point at the attribute locations of the previous
+    // program, so the new program is linked again with those locations if any of them moved.
+    bool relink = false;
+    for (std::map<std::string, VertexAttribute>::const_iterator itr = effect->_vertexAttributes.begin(); itr != effect->_vertexAttributes.end(); ++itr)
+    {
+        std::map<std::string, VertexAttribute>::const_iterator previous = _vertexAttributes.find(itr->first);
+        if (previous == _vertexAttributes.end())
+            GP_WARN("Vertex attribute '%s' was added to effect '%s' and is only bound for meshes that are loaded again.", itr->first.c_str(), _id.c_str());
+        else if (previous->second != itr->second)
+            relink = true;
+    }
+    if (relink)
+    {
+        for (std::map<std::string, VertexAttribute>::const_iterator itr = _vertexAttributes.begin(); itr != _vertexAttributes.end(); ++itr)
+        {
+            if (effect->_vertexAttributes.count(itr->first))
+                GL_ASSERT( glBindAttribLocation(effect->_program, itr->second, itr->first.c_str()) );
+        }
+        GL_ASSERT( glLinkProgram(effect->_program) );
+        GLint success;
+        GL_ASSERT( glGetProgramiv(effect->_program, GL_LINK_STATUS, &success) );
+        if (success != GL_TRUE)
+        {
+            std::string infoLog;
+            appendInfoLog(effect->_program, true, infoLog);
+            GP_WARN("Linking effect '%s' with its previous attribute locations failed: %s", _id.c_str(), infoLog.c_str());
+            SAFE_RELEASE(effect);
+            return false;
+        }
+        for (std::map<std::string, Uniform*>::iterator itr = effect->_uniforms.begin(); itr != effect->_uniforms.end(); ++itr)
+        {
+            SAFE_DELETE(itr->second);
+        }
+        effect->_uniforms.clear();
+        effect->_vertexAttributes.clear();
+        effect->queryProgram();
+    }
+
+    // Material parameters keep pointers to the uniforms, so the uniforms take the locations
+    // of the new program, and the uniforms that were removed no longer set anything.
+    for (std::map<std::string, Uniform*>::iterator itr = _uniforms.begin(); itr != _uniforms.end(); ++itr)
+    {
+        Uniform* uniform = itr->second;
+        std::map<std::string, Uniform*>::iterator rebuilt = effect->_uniforms.find(itr->first);
+        if (rebuilt != effect->_uniforms.end())
+        {
+            uniform->_location = rebuilt->second->_location;
+            uniform->_type = rebuilt->second->_type;
+            uniform->_size = rebuilt->second->_size;
+            uniform->_index = rebuilt->second->_index;
+            SAFE_DELETE(rebuilt->second);
+            effect->_uniforms.erase(rebuilt);
+        }
+        else if (uniform->_parent)
+        {
+            GL_ASSERT( uniform->_location = glGetUniformLocation(effect->_program, uniform->_name.c_str()) );
+        }
+        else
+        {
+            uniform->_location = -1;
+        }
+        uniform->_cachedSize = 0;
+    }
+    for (std::map<std::string, Uniform*>::iterator itr = effect->_uniforms.begin(); itr != effect->_uniforms.end(); ++itr)
+    {
+        itr->second->_effect = this;
+        _uniforms[itr->first] = itr->second;
+    }
+    effect->_uniforms.clear();
+    _uniformsById.clear();
+
+    if (__currentEffect == this)
+    {
+        GL_ASSERT( glUseProgram(0) );
+        __currentEffect = NULL;
+    }
+    if (_program)
+    {
+        GL_ASSERT( glDeleteProgram(_program) );
+    }
+    _program = effect->_program;
+    effect->_program = 0;
+    _vertexAttributes = effect->_vertexAttributes;
+    _frameBlock = effect->_frameBlock;
+    _objectBlock = effect->_objectBlock;
+
+    // The shaders may include other files than they did before.
+    _files = effect->_files;
+    SAFE_RELEASE(effect);
+    if (FileSystem::isWatchEnabled())
+    {
+        FileSystem::unwatch(this);
+        for (size_t i = 0, count = _files.size(); i < count; ++i)
+        {
+            FileSystem::watch(_files[i].c_str(), this);
+        }
+    }
+    ResourceManager::setMemorySize(ResourceManager::EFFECT, _id, size);
+    return true;
+}
+
+void Effect::fileChanged(const char* path)
+{
+    reload();
+}
+
 const char* Effect::getId() const
 {
     return _id.c_str();
@@ -465,12 +1095,18 @@ const char* Effect::getId() const
 
 VertexAttribute Effect::getVertexAttribute(const char* name) const
 {
+    if (_pending)
+        const_cast<Effect*>(this)->finishLink();
+
     std::map<std::string, VertexAttribute>::const_iterator itr = _vertexAttributes.find(name);
     return (itr == _vertexAttributes.end() ? -1 : itr->second);
 }
 
 Uniform* Effect::getUniform(const char* name) const
 {
+    if (_pending)
+        const_cast<Effect*>(this)->finishLink();
+
     std::map<std::string, Uniform*>::const_iterator itr = _uniforms.find(name);
 
 	if (itr != _uniforms.end()) {
@@ -496,6 +1132,11 @@ Uniform* Effect::getUniform(const char* name) const
 				uniform->_location = uniformLocation;
 				uniform->_index = 0;
 				uniform->_type = puniform->getType();
+				uniform->_parent = puniform;
+
+				// An element spans the rest of its array.
+				unsigned int element = (unsigned int)atoi(strchr(name, '[') + 1);
+				uniform->_size = element < puniform->_size ? puniform->_size - element : 1;
 				_uniforms[name] = uniform;
 
 				SAFE_DELETE_ARRAY(parentname);
@@ -509,8 +1150,26 @@ Uniform* Effect::getUniform(const char* name) const
 	return NULL;
 }
 
+Uniform* Effect::getUniform(unsigned int parameterId, const char* name) const
+{
+    if (parameterId < _uniformsById.size() && _uniformsById[parameterId])
+    {
+        Uniform* uniform = _uniformsById[parameterId];
+        return uniform == &_emptyUniform ? NULL : uniform;
+    }
+
+    Uniform* uniform = getUniform(name);
+    if (parameterId >= _uniformsById.size())
+        _uniformsById.resize(parameterId + 1, NULL);
+    _uniformsById[parameterId] = uniform ? uniform : &_emptyUniform;
+    return uniform;
+}
+
 Uniform* Effect::getUniform(unsigned int index) const
 {
+    if (_pending)
+        const_cast<Effect*>(this)->finishLink();
+
     unsigned int i = 0;
     for (std::map<std::string, Uniform*>::const_iterator itr = _uniforms.begin(); itr != _uniforms.end(); ++itr, ++i)
     {
@@ -524,85 +1183,106 @@ Uniform* Effect::getUniform(unsigned int index) const
 
 unsigned int Effect::getUniformCount() const
 {
+    if (_pending)
+        const_cast<Effect*>(this)->finishLink();
+
     return (unsigned int)_uniforms.size();
 }
 
 void Effect::setValue(Uniform* uniform, float value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform1f(uniform->_location, value) );
+    if (uniform->setCachedValue(&value, sizeof(float)))
+        GL_ASSERT( glUniform1f(uniform->_location, value) );
 }
 
 void Effect::setValue(Uniform* uniform, const float* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
+    count = std::min(count, uniform->_size);
+    if (uniform->setCachedValue(values, sizeof(float) * count))
+        GL_ASSERT( glUniform1fv(uniform->_location, count, values) );
 }
 
 void Effect::setValue(Uniform* uniform, int value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform1i(uniform->_location, value) );
+    if (uniform->setCachedValue(&value, sizeof(int)))
+        GL_ASSERT( glUniform1i(uniform->_location, value) );
 }
 
 void Effect::setValue(Uniform* uniform, const int* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
+    count = std::min(count, uniform->_size);
+    if (uniform->setCachedValue(values, sizeof(int) * count))
+        GL_ASSERT( glUniform1iv(uniform->_location, count, values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
+    if (uniform->setCachedValue(value.m, sizeof(Matrix)))
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, 1, GL_FALSE, value.m) );
 }
 
 void Effect::setValue(Uniform* uniform, const Matrix* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
+    count = std::min(count, uniform->_size);
+    if (uniform->setCachedValue(values, sizeof(Matrix) * count))
+        GL_ASSERT( glUniformMatrix4fv(uniform->_location, count, GL_FALSE, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
+    if (uniform->setCachedValue(&value, sizeof(Vector2)))
+        GL_ASSERT( glUniform2f(uniform->_location, value.x, value.y) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector2* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
+    count = std::min(count, uniform->_size);
+    if (uniform->setCachedValue(values, sizeof(Vector2) * count))
+        GL_ASSERT( glUniform2fv(uniform->_location, count, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
+    if (uniform->setCachedValue(&value, sizeof(Vector3)))
+        GL_ASSERT( glUniform3f(uniform->_location, value.x, value.y, value.z) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector3* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
+    count = std::min(count, uniform->_size);
+    if (uniform->setCachedValue(values, sizeof(Vector3) * count))
+        GL_ASSERT( glUniform3fv(uniform->_location, count, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4& value)
 {
     GP_ASSERT(uniform);
-    GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
+    if (uniform->setCachedValue(&value, sizeof(Vector4)))
+        GL_ASSERT( glUniform4f(uniform->_location, value.x, value.y, value.z, value.w) );
 }
 
 void Effect::setValue(Uniform* uniform, const Vector4* values, unsigned int count)
 {
     GP_ASSERT(uniform);
     GP_ASSERT(values);
-    GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
+    count = std::min(count, uniform->_size);
+    if (uniform->setCachedValue(values, sizeof(Vector4) * count))
+        GL_ASSERT( glUniform4fv(uniform->_location, count, (GLfloat*)values) );
 }
 
 void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
@@ -613,12 +1293,14 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler* sampler)
     GP_ASSERT((sampler->getTexture()->getType() == Texture::TEXTURE_2D && uniform->_type == GL_SAMPLER_2D) || 
         (sampler->getTexture()->getType() == Texture::TEXTURE_CUBE && uniform->_type == GL_SAMPLER_CUBE));
 
-    GL_ASSERT( glActiveTexture(GL_TEXTURE0 + uniform->_index) );
+    Texture::setActiveUnit(uniform->_index);
 
     // Bind the sampler - this binds the texture and applies sampler state
     const_cast<Texture::Sampler*>(sampler)->bind();
 
-    GL_ASSERT( glUniform1i(uniform->_location, uniform->_index) );
+    GLint unit = uniform->_index;
+    if (uniform->setCachedValue(&unit, sizeof(GLint)))
+        GL_ASSERT( glUniform1i(uniform->_location, unit) );
 }
 
 void Effect::setValue(Uniform* uniform, const Texture::Sampler** values, unsigned int count)
@@ -633,7 +1315,7 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler** values, unsigne
     {
         GP_ASSERT((const_cast<Texture::Sampler*>(values[i])->getTexture()->getType() == Texture::TEXTURE_2D && uniform->_type == GL_SAMPLER_2D) || 
             (const_cast<Texture::Sampler*>(values[i])->getTexture()->getType() == Texture::TEXTURE_CUBE && uniform->_type == GL_SAMPLER_CUBE));
-        GL_ASSERT( glActiveTexture(GL_TEXTURE0 + uniform->_index + i) );
+        Texture::setActiveUnit(uniform->_index + i);
 
         // Bind the sampler - this binds the texture and applies sampler state
         const_cast<Texture::Sampler*>(values[i])->bind();
@@ -642,14 +1324,21 @@ void Effect::setValue(Uniform* uniform, const Texture::Sampler** values, unsigne
     }
 
     // Pass texture unit array to GL
-    GL_ASSERT( glUniform1iv(uniform->_location, count, units) );
+    if (uniform->setCachedValue(units, sizeof(GLint) * count))
+        GL_ASSERT( glUniform1iv(uniform->_location, count, units) );
 }
 
 void Effect::bind()
 {
-   GL_ASSERT( glUseProgram(_program) );
+    if (_pending)
+        finishLink();
 
-    __currentEffect = this;
+    if (__currentEffect != this)
+    {
+        GL_ASSERT( glUseProgram(_program) );
+        RenderStats::count(RenderStats::PROGRAM_BINDS);
+        __currentEffect = this;
+    }
 }
 
 Effect* Effect::getCurrentEffect()
@@ -658,7 +1347,7 @@ Effect* Effect::getCurrentEffect()
 }
 
 Uniform::Uniform() :
-    _location(-1), _type(0), _index(0), _effect(NULL)
+    _location(-1), _type(0), _size(1), _index(0), _effect(NULL), _parent(NULL), _cachedSize(0)
 {
 }
 
@@ -682,4 +1371,34 @@ const GLenum Uniform::getType() const
     return _type;
 }
 
+unsigned int Uniform::getSize() const
+{
+    return _size;
+}
+
+bool Uniform::setCachedValue(const void* value, unsigned int size)
+{
+    if (_parent)
+    {
+        // Elements of an array uniform share their storage with the whole array,
+        // so they are never cached and the cached value of the array becomes stale.
+        _parent->_cachedSize = 0;
+        return true;
+    }
+
+    if (size > sizeof(_cachedValue))
+    {
+        // Large arrays such as matrix palettes change almost every time, so they aren't cached.
+        _cachedSize = 0;
+        return true;
+    }
+
+    if (_cachedSize == size && memcmp(_cachedValue, value, size) == 0)
+        return false;
+
+    memcpy(_cachedValue, value, size);
+    _cachedSize = size;
+    return true;
+}
+
 }
@@ -7,6 +7,7 @@
 #include "Vector4.h"
 #include "Matrix.h"
 #include "Texture.h"
+#include "FileSystem.h"
 
 namespace gameplay
 {
@@ -22,9 +23,33 @@ class Uniform;
  * In the future, this class may be extended to support additional logic that
  * typical effect systems support, such as GPU render state management,
  * techniques and passes.
+ *
+ * Where the driver supports program binaries, linked programs can be cached in
+ * writable storage so that later launches skip compiling and linking. Cached binaries
+ * are keyed by the preprocessed shader sources and the driver version, and programs
+ * are built from source again whenever a binary is missing or rejected by the driver.
+ * The cache is enabled by default on OpenGL ES and is controlled with the 'shaderCache'
+ * and 'shaderCachePath' properties of the 'graphics' namespace in the game configuration.
+ *
+ * When the 'asyncShaders' property of the 'graphics' namespace is true and the driver
+ * supports KHR_parallel_shader_compile, effects loaded from files are compiled and linked
+ * in the background. Such an effect is not ready right after being created: models skip
+ * techniques whose effects are not ready yet and draw with another ready technique
+ * of their material instead, if there is one. Any other use of an effect that is not
+ * ready waits for its program to finish linking.
+ *
+ * While FileSystem watches files, effects loaded from files reload in place when one
+ * of their shader files, or a file that the shaders include, changes.
  */
-class Effect: public Ref
+class Effect: public Ref, public FileSystem::WatchListener
 {
+    friend class Material;
+    friend class RenderState;
+    friend class MaterialParameter;
+    friend class ParticleEmitter;
+    friend class InstanceCuller;
+    friend class AssetLoader;
+
 public:
 
     /**
@@ -89,6 +114,44 @@ public:
      */
     unsigned int getUniformCount() const;
 
+    /**
+     * Returns whether the program of this effect has finished compiling and linking.
+     *
+     * This is always true unless the effect is being compiled in the background.
+     *
+     * @return True if the effect is ready to be used without waiting.
+     */
+    bool isReady();
+
+    /**
+     * Returns the variant of this effect that only lays down depth, for a depth pre-pass.
+     *
+     * The variant is built from the same shader files, with the defines that only affect
+     * shading, such as the light counts, removed and DEPTH_PASS defined. The defines for
+     * skinning, instancing, clip planes and alpha testing are kept, so the variant writes
+     * the same depth as this effect. The built-in shaders skip all shading when DEPTH_PASS
+     * is defined, except for discarding alpha tested fragments.
+     *
+     * @return The depth variant, or NULL if this effect was not loaded from files or is a depth variant.
+     * @script{ignore}
+     */
+    Effect* getDepthEffect();
+
+    /**
+     * Builds the program of this effect again from its shader files, in place.
+     *
+     * Materials and everything else that uses the effect or its uniforms keep working
+     * with the new program, and the vertex attributes keep their locations, so the
+     * vertex attribute bindings of meshes stay valid. Uniforms that were removed from the
+     * shaders are no longer set. If the shaders fail to build, the errors are logged and
+     * the effect keeps its previous program.
+     *
+     * @return true if the effect was built again, false if it was not loaded from files
+     *      or its shaders failed to build.
+     * @script{ignore}
+     */
+    bool reload();
+
     /**
      * Sets a float uniform value.
      *
@@ -239,12 +302,62 @@ private:
      */
     Effect& operator=(const Effect&);
 
-    static Effect* createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines = NULL);
+    /**
+     * A program that is being compiled and linked in the background.
+     */
+    struct PendingLink;
+
+    static Effect* createFromSource(const char* vshPath, const char* vshSource, const char* fshPath, const char* fshSource, const char* defines, bool async);
+
+    /**
+     * Returns the cached effect for the given shader files and defines, or creates it and adds it to the cache.
+     *
+     * The sources are read from the files unless they are given, such as when they were read on another thread.
+     */
+    static Effect* createCached(const char* vshPath, const char* fshPath, const char* defines, const char* vshSource, const char* fshSource);
+
+    /**
+     * Creates an effect like createFromFile, but logs the errors of building it instead of
+     * failing, for the effects that materials switch to when they are reloaded.
+     */
+    static Effect* reloadFromFile(const char* vshPath, const char* fshPath, const char* defines);
+
+    /**
+     * Reloads the effect when one of its files changes.
+     *
+     * @see FileSystem::WatchListener::fileChanged
+     */
+    void fileChanged(const char* path);
+
+    /**
+     * Waits for a program being compiled in the background to finish linking.
+     */
+    void finishLink();
+
+    /**
+     * Queries the vertex attributes, uniforms and uniform blocks of the linked program.
+     */
+    void queryProgram();
+
+    /**
+     * Returns the uniform for the material parameter with the given id and name.
+     *
+     * Lookups are cached by parameter id, including uniforms that do not exist,
+     * so only the first lookup for each parameter name searches by name.
+     */
+    Uniform* getUniform(unsigned int parameterId, const char* name) const;
 
     GLuint _program;
     std::string _id;
+    bool _frameBlock;
+    bool _objectBlock;
+    PendingLink* _pending;
+    std::vector<std::string> _files;
+    Effect* _depthEffect;
+    bool _depthEffectLoaded;
     std::map<std::string, VertexAttribute> _vertexAttributes;
     mutable std::map<std::string, Uniform*> _uniforms;
+    mutable std::vector<Uniform*> _uniformsById;
     static Uniform _emptyUniform;
 };
 
@@ -254,6 +367,7 @@ private:
 class Uniform
 {
     friend class Effect;
+    friend class MaterialParameter;
 
 public:
 
@@ -271,6 +385,15 @@ public:
      */
     const GLenum getType() const;
 
+    /**
+     * Returns the number of elements of the uniform, which is 1 unless it is an array.
+     *
+     * Array values set on the uniform are clamped to this number of elements.
+     *
+     * @return The number of elements of the uniform.
+     */
+    unsigned int getSize() const;
+
     /**
      * Returns the effect for this uniform.
      *
@@ -300,11 +423,25 @@ private:
      */
     Uniform& operator=(const Uniform&);
 
+    /**
+     * Stores the given value as the current value of this uniform.
+     *
+     * Uniform values are kept by the program object, so values only need to be
+     * passed to GL when they differ from the value that was set last.
+     *
+     * @return True if the value changed and needs to be passed to GL, false otherwise.
+     */
+    bool setCachedValue(const void* value, unsigned int size);
+
     std::string _name;
     GLint _location;
     GLenum _type;
+    unsigned int _size;
     unsigned int _index;
     Effect* _effect;
+    Uniform* _parent;
+    float _cachedValue[16];
+    unsigned int _cachedSize;
 };
 
 }
@@ -18,6 +18,9 @@
     #define __EXT_POSIX2
     #include <libgen.h>
     #include <dirent.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
     #define gp_stat stat
     #define gp_stat_struct struct stat
 #endif
@@ -76,13 +79,30 @@ static bool androidFileExists(const char* filePath)
     AAsset* asset = AAssetManager_open(__assetManager, filePath, AASSET_MODE_RANDOM);
     if (asset)
     {
-        int lenght = AAsset_getLength(asset);
+        int length = AAsset_getLength(asset);
         AAsset_close(asset);
         return length > 0;
     }
     return false;
 }
 
+// The functions of the C library streams that read assets in place, for FileSystem::openFile.
+static int readAsset(void* cookie, char* buffer, int size)
+{
+    return AAsset_read((AAsset*)cookie, buffer, (size_t)size);
+}
+
+static fpos_t seekAsset(void* cookie, fpos_t offset, int origin)
+{
+    return (fpos_t)AAsset_seek((AAsset*)cookie, (off_t)offset, origin);
+}
+
+static int closeAsset(void* cookie)
+{
+    AAsset_close((AAsset*)cookie);
+    return 0;
+}
+
 #endif
 
 /** @script{ignore} */
@@ -90,6 +110,173 @@ static std::string __resourcePath("./");
 static std::string __assetPath("");
 static std::map<std::string, std::string> __aliases;
 
+// A file that is watched for changes, with the modification time and size it had when last checked.
+struct WatchedFile
+{
+    long long modified;
+    long long size;
+    bool changed;
+    std::vector<FileSystem::WatchListener*> listeners;
+};
+
+static bool __watchEnabled = false;
+static double __watchInterval = 250.0;
+static double __watchTime = 0.0;
+static std::map<std::string, WatchedFile> __watchedFiles;
+
+// The identifier and version of pack files, written by the encoder.
+static const char ARCHIVE_IDENTIFIER[] = { '\xAB', 'G', 'P', 'K', '\xBB', '\r', '\n', '\x1A', '\n' };
+static const unsigned char ARCHIVE_VERSION[] = { 1, 0 };
+
+// The compression of the entries of pack files.
+#define ARCHIVE_COMPRESSION_NONE 0
+#define ARCHIVE_COMPRESSION_LZ4 1
+
+/**
+ * A file stored in a pack file.
+ */
+struct ArchiveEntry
+{
+    unsigned int compression;
+    unsigned long long offset;
+    unsigned int size;
+    unsigned int originalSize;
+};
+
+/**
+ * A mounted pack file, whose directory is indexed by the resource paths of its entries.
+ */
+struct Archive
+{
+    Archive() : stream(NULL), data(NULL)
+    {
+    }
+
+    ~Archive()
+    {
+        SAFE_DELETE(stream);
+    }
+
+    std::string path;
+    Stream* stream;
+    // The contents of the pack file if it is mapped, or NULL if entries are read from the stream.
+    const unsigned char* data;
+    // Guards the position of the stream while entries are read from it.
+    std::mutex mutex;
+    std::unordered_map<std::string, ArchiveEntry> entries;
+};
+
+// The mounted archives, searched from the most recently mounted one.
+static std::vector<std::shared_ptr<Archive> > __archives;
+static std::mutex __archivesMutex;
+
+/**
+ * Returns the key that the entries of archives are indexed by for the given path,
+ * which is the resolved path with forward slashes and without any leading "./".
+ */
+static std::string getArchiveKey(const char* path)
+{
+    std::string key(FileSystem::resolvePath(path));
+    std::replace(key.begin(), key.end(), '\\', '/');
+    while (key.compare(0, 2, "./") == 0)
+        key.erase(0, 2);
+    return key;
+}
+
+/**
+ * Finds the most recently mounted archive that contains an entry at the given path.
+ *
+ * @return The archive, or an empty pointer if no archive contains the path.
+ */
+static std::shared_ptr<Archive> findArchiveEntry(const char* path, ArchiveEntry* entry)
+{
+    std::lock_guard<std::mutex> lock(__archivesMutex);
+    if (__archives.empty() || FileSystem::isAbsolutePath(path))
+        return std::shared_ptr<Archive>();
+
+    std::string key = getArchiveKey(path);
+    for (size_t i = __archives.size(); i-- > 0;)
+    {
+        std::unordered_map<std::string, ArchiveEntry>::const_iterator itr = __archives[i]->entries.find(key);
+        if (itr != __archives[i]->entries.end())
+        {
+            if (entry)
+                *entry = itr->second;
+            return __archives[i];
+        }
+    }
+    return std::shared_ptr<Archive>();
+}
+
+/**
+ * Decompresses an LZ4 block into a buffer of exactly its original size.
+ *
+ * @return true if the block was valid and filled the buffer, false otherwise.
+ */
+static bool decompressLZ4(const unsigned char* src, size_t srcSize, unsigned char* dst, size_t dstSize)
+{
+    const unsigned char* ip = src;
+    const unsigned char* srcEnd = src + srcSize;
+    unsigned char* op = dst;
+    unsigned char* dstEnd = dst + dstSize;
+
+    while (ip < srcEnd)
+    {
+        // Each sequence is a token, followed by its literals and then its match.
+        unsigned int token = *ip++;
+        size_t length = token >> 4;
+        if (length == 15)
+        {
+            unsigned char byte;
+            do
+            {
+                if (ip >= srcEnd)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+        }
+        if ((size_t)(srcEnd - ip) < length || (size_t)(dstEnd - op) < length)
+            return false;
+        memcpy(op, ip, length);
+        ip += length;
+        op += length;
+
+        // The last sequence only has literals.
+        if (ip >= srcEnd)
+            break;
+
+        if (srcEnd - ip < 2)
+            return false;
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst))
+            return false;
+
+        length = token & 15;
+        if (length == 15)
+        {
+            unsigned char byte;
+            do
+            {
+                if (ip >= srcEnd)
+                    return false;
+                byte = *ip++;
+                length += byte;
+            } while (byte == 255);
+        }
+        length += 4;
+        if ((size_t)(dstEnd - op) < length)
+            return false;
+
+        // Matches may overlap the bytes they write, so they are copied one byte at a time.
+        const unsigned char* match = op - offset;
+        while (length--)
+            *op++ = *match++;
+    }
+    return op == dstEnd;
+}
+
 /**
  * Gets the fully resolved path.
  * If the path is relative then it will be prefixed with the resource path.
@@ -145,6 +332,58 @@ private:
     bool _canWrite;
 };
 
+/**
+ * A read-only stream over a file that is mapped into memory.
+ *
+ * @script{ignore}
+ */
+class MappedFileStream : public Stream
+{
+public:
+    friend class FileSystem;
+
+    ~MappedFileStream();
+    virtual bool canRead();
+    virtual bool canWrite();
+    virtual bool canSeek();
+    virtual void close();
+    virtual size_t read(void* ptr, size_t size, size_t count);
+    virtual char* readLine(char* str, int num);
+    virtual size_t write(const void* ptr, size_t size, size_t count);
+    virtual bool eof();
+    virtual size_t length();
+    virtual long int position();
+    virtual bool seek(long int offset, int origin);
+    virtual bool rewind();
+    virtual const void* getData();
+
+    static MappedFileStream* create(const char* filePath);
+
+    /**
+     * Creates a stream over an uncompressed entry of a mapped archive, which is kept mounted until the stream is closed.
+     */
+    static MappedFileStream* create(const std::shared_ptr<Archive>& archive, const unsigned char* data, size_t length);
+
+    /**
+     * Creates a stream over a buffer allocated with new[], which the stream takes ownership of.
+     */
+    static MappedFileStream* create(unsigned char* buffer, size_t length);
+
+private:
+    MappedFileStream();
+
+private:
+    const unsigned char* _data;
+    size_t _length;
+    size_t _position;
+    std::shared_ptr<Archive> _archive;
+    bool _ownsData;
+#ifdef WIN32
+    HANDLE _file;
+    HANDLE _mapping;
+#endif
+};
+
 #ifdef __ANDROID__
 
 /**
@@ -169,18 +408,96 @@ public:
     virtual long int position();
     virtual bool seek(long int offset, int origin);
     virtual bool rewind();
+    virtual const void* getData();
 
-    static FileStreamAndroid* create(const char* filePath, const char* mode);
+    static FileStreamAndroid* create(const char* filePath, const char* mode, bool mapped = false);
 
 private:
     FileStreamAndroid(AAsset* asset);
 
 private:
     AAsset* _asset;
+    const void* _data;
+    void* _mapping;
+    size_t _mappingLength;
 };
 
 #endif
 
+/**
+ * Opens a stream over an entry of an archive, which points into the archive if it is mapped
+ * and uncompressed, and otherwise owns a buffer with the contents of the entry.
+ */
+static Stream* openArchiveEntry(const std::shared_ptr<Archive>& archive, const ArchiveEntry& entry, const char* path)
+{
+    const unsigned char* data = NULL;
+    unsigned char* buffer = NULL;
+    if (archive->data)
+    {
+        data = archive->data + entry.offset;
+    }
+    else
+    {
+        buffer = new unsigned char[entry.size > 0 ? entry.size : 1];
+        std::lock_guard<std::mutex> lock(archive->mutex);
+        if (!archive->stream->seek((long int)entry.offset, SEEK_SET) || archive->stream->read(buffer, 1, entry.size) != entry.size)
+        {
+            GP_WARN("Failed to read '%s' from archive '%s'.", path, archive->path.c_str());
+            SAFE_DELETE_ARRAY(buffer);
+            return NULL;
+        }
+        data = buffer;
+    }
+
+    if (entry.compression == ARCHIVE_COMPRESSION_NONE)
+    {
+        if (buffer)
+            return MappedFileStream::create(buffer, entry.size);
+        return MappedFileStream::create(archive, data, entry.size);
+    }
+
+    unsigned char* decompressed = new unsigned char[entry.originalSize > 0 ? entry.originalSize : 1];
+    bool decompressedAll = decompressLZ4(data, entry.size, decompressed, entry.originalSize);
+    SAFE_DELETE_ARRAY(buffer);
+    if (!decompressedAll)
+    {
+        GP_WARN("Failed to decompress '%s' from archive '%s'.", path, archive->path.c_str());
+        SAFE_DELETE_ARRAY(decompressed);
+        return NULL;
+    }
+    return MappedFileStream::create(decompressed, entry.originalSize);
+}
+
+/**
+ * Adds the names of the entries of the mounted archives that are in the given directory to the list.
+ *
+ * @return true if any archive has entries in the directory, false otherwise.
+ */
+static bool listArchiveFiles(const char* dirPath, std::vector<std::string>& files)
+{
+    std::string prefix = dirPath ? getArchiveKey(dirPath) : std::string();
+    if (prefix.length() > 0 && prefix[prefix.length() - 1] != '/')
+        prefix += '/';
+
+    bool found = false;
+    std::lock_guard<std::mutex> lock(__archivesMutex);
+    for (size_t i = 0, count = __archives.size(); i < count; ++i)
+    {
+        const std::unordered_map<std::string, ArchiveEntry>& entries = __archives[i]->entries;
+        for (std::unordered_map<std::string, ArchiveEntry>::const_iterator itr = entries.begin(); itr != entries.end(); ++itr)
+        {
+            const std::string& key = itr->first;
+            if (key.compare(0, prefix.length(), prefix) != 0 || key.find('/', prefix.length()) != std::string::npos)
+                continue;
+            found = true;
+            std::string filename = key.substr(prefix.length());
+            if (std::find(files.begin(), files.end(), filename) == files.end())
+                files.push_back(filename);
+        }
+    }
+    return found;
+}
+
 /////////////////////////////
 
 FileSystem::FileSystem()
@@ -265,7 +582,7 @@ bool FileSystem::listFiles(const char* dirPath, std::vector<std::string>& files)
     HANDLE hFind = FindFirstFile(wPath.c_str(), &FindFileData);
     if (hFind == INVALID_HANDLE_VALUE) 
     {
-        return false;
+        return listArchiveFiles(dirPath, files);
     }
     do
     {
@@ -281,6 +598,7 @@ bool FileSystem::listFiles(const char* dirPath, std::vector<std::string>& files)
     } while (FindNextFile(hFind, &FindFileData) != 0);
 
     FindClose(hFind);
+    listArchiveFiles(dirPath, files);
     return true;
 #else
     std::string path(FileSystem::getResourcePath());
@@ -336,6 +654,9 @@ bool FileSystem::listFiles(const char* dirPath, std::vector<std::string>& files)
     }
 #endif
 
+    if (listArchiveFiles(dirPath, files))
+        result = true;
+
     return result;
 #endif
 }
@@ -344,6 +665,9 @@ bool FileSystem::fileExists(const char* filePath)
 {
     GP_ASSERT(filePath);
 
+    if (findArchiveEntry(filePath, NULL))
+        return true;
+
     std::string fullPath;
 
 #ifdef __ANDROID__
@@ -368,6 +692,15 @@ Stream* FileSystem::open(const char* path, size_t streamMode)
     char modeStr[] = "rb";
     if ((streamMode & WRITE) != 0)
         modeStr[0] = 'w';
+
+    // Files in mounted archives are found before the files on disk.
+    if ((streamMode & WRITE) == 0)
+    {
+        ArchiveEntry entry;
+        std::shared_ptr<Archive> archive = findArchiveEntry(path, &entry);
+        if (archive)
+            return openArchiveEntry(archive, entry, path);
+    }
 #ifdef __ANDROID__
     std::string fullPath(__resourcePath);
     fullPath += resolvePath(path);
@@ -388,7 +721,11 @@ Stream* FileSystem::open(const char* path, size_t streamMode)
     else
     {
         // First try the SD card
-        Stream* stream = FileStream::create(fullPath.c_str(), modeStr);
+        Stream* stream = NULL;
+        if ((streamMode & MAPPED) != 0)
+            stream = MappedFileStream::create(fullPath.c_str());
+        if (!stream)
+            stream = FileStream::create(fullPath.c_str(), modeStr);
 
         if (!stream)
         {
@@ -396,7 +733,7 @@ Stream* FileSystem::open(const char* path, size_t streamMode)
             fullPath = __assetPath;
             fullPath += resolvePath(path);
 
-            stream = FileStreamAndroid::create(fullPath.c_str(), modeStr);
+            stream = FileStreamAndroid::create(fullPath.c_str(), modeStr, (streamMode & MAPPED) != 0);
         }
 
         return stream;
@@ -404,11 +741,116 @@ Stream* FileSystem::open(const char* path, size_t streamMode)
 #else
     std::string fullPath;
     getFullPath(path, fullPath);
+    if ((streamMode & WRITE) == 0 && (streamMode & MAPPED) != 0)
+    {
+        // Files that can't be mapped, such as empty ones, are read normally.
+        Stream* stream = MappedFileStream::create(fullPath.c_str());
+        if (stream)
+            return stream;
+    }
     FileStream* stream = FileStream::create(fullPath.c_str(), modeStr);
     return stream;
 #endif
 }
 
+bool FileSystem::mountArchive(const char* path, const char* mountPoint)
+{
+    GP_ASSERT(path);
+
+    {
+        std::lock_guard<std::mutex> lock(__archivesMutex);
+        for (size_t i = 0, count = __archives.size(); i < count; ++i)
+        {
+            if (__archives[i]->path == path)
+            {
+                GP_WARN("Archive '%s' is already mounted.", path);
+                return true;
+            }
+        }
+    }
+
+    // The directory is read from the stream, while entries are read from its mapping if the platform can map the pack.
+    Stream* stream = open(path, READ | MAPPED);
+    if (!stream)
+    {
+        GP_WARN("Failed to open archive '%s'.", path);
+        return false;
+    }
+    std::shared_ptr<Archive> archive(new Archive());
+    archive->path = path;
+    archive->stream = stream;
+    archive->data = (const unsigned char*)stream->getData();
+
+    char identifier[sizeof(ARCHIVE_IDENTIFIER)];
+    unsigned char version[2];
+    unsigned int entryCount;
+    if (stream->read(identifier, 1, sizeof(identifier)) != sizeof(identifier) || memcmp(identifier, ARCHIVE_IDENTIFIER, sizeof(identifier)) != 0)
+    {
+        GP_WARN("Invalid archive identifier in '%s'.", path);
+        return false;
+    }
+    if (stream->read(version, 1, 2) != 2 || version[0] != ARCHIVE_VERSION[0])
+    {
+        GP_WARN("Unsupported archive version in '%s'.", path);
+        return false;
+    }
+    if (stream->read(&entryCount, 4, 1) != 1)
+    {
+        GP_WARN("Failed to read the entry count of archive '%s'.", path);
+        return false;
+    }
+
+    std::string prefix = mountPoint ? getArchiveKey(mountPoint) : std::string();
+    if (prefix.length() > 0 && prefix[prefix.length() - 1] != '/')
+        prefix += '/';
+
+    size_t length = stream->length();
+    archive->entries.reserve(entryCount);
+    for (unsigned int i = 0; i < entryCount; ++i)
+    {
+        unsigned int nameLength;
+        if (stream->read(&nameLength, 4, 1) != 1 || nameLength == 0 || nameLength > length)
+        {
+            GP_WARN("Invalid entry %u in archive '%s'.", i, path);
+            return false;
+        }
+        std::string name(nameLength, '\0');
+        ArchiveEntry entry;
+        if (stream->read(&name[0], 1, nameLength) != nameLength ||
+            stream->read(&entry.compression, 4, 1) != 1 ||
+            stream->read(&entry.offset, 8, 1) != 1 ||
+            stream->read(&entry.size, 4, 1) != 1 ||
+            stream->read(&entry.originalSize, 4, 1) != 1 ||
+            entry.compression > ARCHIVE_COMPRESSION_LZ4 ||
+            entry.offset > length || entry.size > length - entry.offset)
+        {
+            GP_WARN("Invalid entry '%s' in archive '%s'.", name.c_str(), path);
+            return false;
+        }
+        archive->entries[prefix + name] = entry;
+    }
+
+    std::lock_guard<std::mutex> lock(__archivesMutex);
+    __archives.push_back(archive);
+    return true;
+}
+
+void FileSystem::unmountArchive(const char* path)
+{
+    GP_ASSERT(path);
+
+    // Streams that are still open keep their archive alive until they are closed.
+    std::lock_guard<std::mutex> lock(__archivesMutex);
+    for (size_t i = 0, count = __archives.size(); i < count; ++i)
+    {
+        if (__archives[i]->path == path)
+        {
+            __archives.erase(__archives.begin() + i);
+            return;
+        }
+    }
+}
+
 FILE* FileSystem::openFile(const char* filePath, const char* mode)
 {
     GP_ASSERT(filePath);
@@ -417,8 +859,41 @@ FILE* FileSystem::openFile(const char* filePath, const char* mode)
     std::string fullPath;
     getFullPath(filePath, fullPath);
 
-    createFileFromAsset(filePath);
-    
+#ifdef __ANDROID__
+    bool write = strchr(mode, 'w') != NULL || strchr(mode, 'a') != NULL || strchr(mode, '+') != NULL;
+    if (!write)
+    {
+        // Files on the SD card are found first, as in open(). Assets are read in place from
+        // the APK through a stream of the C library, instead of being extracted to storage.
+        FILE* fp = fopen(fullPath.c_str(), mode);
+        if (fp)
+            return fp;
+
+        std::string assetPath(__assetPath);
+        assetPath += resolvePath(filePath);
+        AAsset* asset = AAssetManager_open(__assetManager, assetPath.c_str(), AASSET_MODE_RANDOM);
+        if (!asset)
+            return NULL;
+        fp = funopen(asset, &readAsset, NULL, &seekAsset, &closeAsset);
+        if (!fp)
+            AAsset_close(asset);
+        return fp;
+    }
+
+    // Only files that are updated or appended to start from the contents of their asset.
+    if (mode[0] == 'a' || (mode[0] == 'r' && strchr(mode, '+') != NULL))
+    {
+        createFileFromAsset(filePath);
+    }
+    else
+    {
+        size_t index = fullPath.rfind('/');
+        gp_stat_struct s;
+        if (index != std::string::npos && stat(fullPath.substr(0, index).c_str(), &s) != 0)
+            makepath(fullPath.substr(0, index), 0777);
+    }
+#endif
+
     FILE* fp = fopen(fullPath.c_str(), mode);
     return fp;
 }
@@ -456,6 +931,29 @@ char* FileSystem::readAll(const char* filePath, int* fileSize)
     return buffer;
 }
 
+size_t FileSystem::prefetch(const char* filePath)
+{
+    std::unique_ptr<Stream> stream(open(filePath, READ | MAPPED));
+    if (stream.get() == NULL)
+        return 0;
+
+    size_t length = stream->length();
+    const unsigned char* data = (const unsigned char*)stream->getData();
+    if (data)
+    {
+        // Touching a byte of every page faults the whole mapping in.
+        volatile unsigned char sum = 0;
+        for (size_t i = 0; i < length; i += 4096)
+            sum += data[i];
+    }
+    else
+    {
+        char buffer[4096];
+        while (stream->read(buffer, 1, sizeof(buffer)) == sizeof(buffer));
+    }
+    return length;
+}
+
 bool FileSystem::isAbsolutePath(const char* filePath)
 {
     if (filePath == 0 || filePath[0] == '\0')
@@ -589,6 +1087,126 @@ std::string FileSystem::getExtension(const char* path)
     return ext;
 }
 
+/**
+ * Reads the modification time and size of the file on disk at the given path.
+ *
+ * @return false if there is no such file on disk.
+ */
+static bool getFileState(const char* path, long long* modified, long long* size)
+{
+    std::string fullPath;
+    getFullPath(path, fullPath);
+
+    gp_stat_struct s;
+    if (gp_stat(fullPath.c_str(), &s) != 0)
+        return false;
+    *modified = (long long)s.st_mtime;
+    *size = (long long)s.st_size;
+    return true;
+}
+
+void FileSystem::setWatchEnabled(bool enabled)
+{
+    __watchEnabled = enabled;
+}
+
+bool FileSystem::isWatchEnabled()
+{
+    return __watchEnabled;
+}
+
+void FileSystem::setWatchInterval(float milliseconds)
+{
+    __watchInterval = std::max((double)milliseconds, 0.0);
+}
+
+float FileSystem::getWatchInterval()
+{
+    return (float)__watchInterval;
+}
+
+void FileSystem::watch(const char* path, WatchListener* listener)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(listener);
+
+    std::map<std::string, WatchedFile>::iterator itr = __watchedFiles.find(path);
+    if (itr == __watchedFiles.end())
+    {
+        WatchedFile file;
+        file.modified = 0;
+        file.size = 0;
+        file.changed = false;
+        getFileState(path, &file.modified, &file.size);
+        itr = __watchedFiles.insert(std::make_pair(std::string(path), file)).first;
+    }
+    std::vector<WatchListener*>& listeners = itr->second.listeners;
+    if (std::find(listeners.begin(), listeners.end(), listener) == listeners.end())
+        listeners.push_back(listener);
+}
+
+void FileSystem::unwatch(WatchListener* listener)
+{
+    std::map<std::string, WatchedFile>::iterator itr = __watchedFiles.begin();
+    while (itr != __watchedFiles.end())
+    {
+        std::vector<WatchListener*>& listeners = itr->second.listeners;
+        listeners.erase(std::remove(listeners.begin(), listeners.end(), listener), listeners.end());
+        if (listeners.empty())
+            __watchedFiles.erase(itr++);
+        else
+            ++itr;
+    }
+}
+
+void FileSystem::updateWatches()
+{
+    if (__watchedFiles.empty())
+        return;
+    double time = Platform::getAbsoluteTime();
+    if (time - __watchTime < __watchInterval)
+        return;
+    __watchTime = time;
+
+    // Files that are missing, such as while an editor replaces them, keep their last state.
+    std::vector<std::pair<std::string, WatchListener*> > changes;
+    for (std::map<std::string, WatchedFile>::iterator itr = __watchedFiles.begin(); itr != __watchedFiles.end(); ++itr)
+    {
+        WatchedFile& file = itr->second;
+        long long modified, size;
+        if (!getFileState(itr->first.c_str(), &modified, &size))
+            continue;
+        if (modified != file.modified || size != file.size)
+        {
+            file.modified = modified;
+            file.size = size;
+            file.changed = true;
+        }
+        else if (file.changed)
+        {
+            file.changed = false;
+            Logger::log(Logger::LEVEL_INFO, "File '%s' changed.\n", itr->first.c_str());
+            for (size_t i = 0, count = file.listeners.size(); i < count; ++i)
+            {
+                changes.push_back(std::make_pair(itr->first, file.listeners[i]));
+            }
+        }
+    }
+
+    // Listeners may watch and unwatch files when they are notified, so a listener is only
+    // notified if it still watches the file by then.
+    for (size_t i = 0, count = changes.size(); i < count; ++i)
+    {
+        std::map<std::string, WatchedFile>::iterator itr = __watchedFiles.find(changes[i].first);
+        if (itr == __watchedFiles.end())
+            continue;
+        std::vector<WatchListener*>& listeners = itr->second.listeners;
+        if (std::find(listeners.begin(), listeners.end(), changes[i].second) == listeners.end())
+            continue;
+        changes[i].second->fileChanged(changes[i].first.c_str());
+    }
+}
+
 //////////////////
 
 FileStream::FileStream(FILE* file)
@@ -717,10 +1335,232 @@ bool FileStream::rewind()
 
 ////////////////////////////////
 
+MappedFileStream::MappedFileStream()
+    : _data(NULL), _length(0), _position(0), _ownsData(false)
+#ifdef WIN32
+    , _file(INVALID_HANDLE_VALUE), _mapping(NULL)
+#endif
+{
+}
+
+MappedFileStream::~MappedFileStream()
+{
+    if (_data)
+    {
+        close();
+    }
+}
+
+MappedFileStream* MappedFileStream::create(const char* filePath)
+{
+#ifdef WIN32
+    HANDLE file = CreateFileA(filePath, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+    HANDLE mapping = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!mapping)
+    {
+        CloseHandle(file);
+        return NULL;
+    }
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!data)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        return NULL;
+    }
+
+    MappedFileStream* stream = new MappedFileStream();
+    stream->_data = (const unsigned char*)data;
+    stream->_length = (size_t)size.QuadPart;
+    stream->_file = file;
+    stream->_mapping = mapping;
+    return stream;
+#else
+    int file = ::open(filePath, O_RDONLY);
+    if (file == -1)
+        return NULL;
+    struct stat s;
+    if (fstat(file, &s) != 0 || s.st_size <= 0)
+    {
+        ::close(file);
+        return NULL;
+    }
+    void* data = mmap(NULL, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+    // The mapping keeps the file alive once it is created.
+    ::close(file);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    MappedFileStream* stream = new MappedFileStream();
+    stream->_data = (const unsigned char*)data;
+    stream->_length = (size_t)s.st_size;
+    return stream;
+#endif
+}
+
+MappedFileStream* MappedFileStream::create(const std::shared_ptr<Archive>& archive, const unsigned char* data, size_t length)
+{
+    MappedFileStream* stream = new MappedFileStream();
+    stream->_data = data;
+    stream->_length = length;
+    stream->_archive = archive;
+    return stream;
+}
+
+MappedFileStream* MappedFileStream::create(unsigned char* buffer, size_t length)
+{
+    MappedFileStream* stream = new MappedFileStream();
+    stream->_data = buffer;
+    stream->_length = length;
+    stream->_ownsData = true;
+    return stream;
+}
+
+bool MappedFileStream::canRead()
+{
+    return _data != NULL;
+}
+
+bool MappedFileStream::canWrite()
+{
+    return false;
+}
+
+bool MappedFileStream::canSeek()
+{
+    return _data != NULL;
+}
+
+void MappedFileStream::close()
+{
+    if (_archive)
+    {
+        _archive.reset();
+    }
+    else if (_ownsData)
+    {
+        delete[] _data;
+        _ownsData = false;
+    }
+    else if (_data)
+    {
+#ifdef WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle(_mapping);
+        CloseHandle(_file);
+        _mapping = NULL;
+        _file = INVALID_HANDLE_VALUE;
+#else
+        munmap((void*)_data, _length);
+#endif
+    }
+    _data = NULL;
+    _length = 0;
+    _position = 0;
+}
+
+size_t MappedFileStream::read(void* ptr, size_t size, size_t count)
+{
+    if (!_data || size == 0)
+        return 0;
+    size_t available = (_length - _position) / size;
+    if (count > available)
+        count = available;
+    memcpy(ptr, _data + _position, size * count);
+    _position += size * count;
+    return count;
+}
+
+char* MappedFileStream::readLine(char* str, int num)
+{
+    if (!_data || num <= 0 || _position >= _length)
+        return NULL;
+
+    // Like fgets, the line includes its line break.
+    int i = 0;
+    while (i < num - 1 && _position < _length)
+    {
+        char c = (char)_data[_position++];
+        str[i++] = c;
+        if (c == '\n')
+            break;
+    }
+    str[i] = '\0';
+    return str;
+}
+
+size_t MappedFileStream::write(const void* ptr, size_t size, size_t count)
+{
+    return 0;
+}
+
+bool MappedFileStream::eof()
+{
+    return _position >= _length;
+}
+
+size_t MappedFileStream::length()
+{
+    return _length;
+}
+
+long int MappedFileStream::position()
+{
+    if (!_data)
+        return -1;
+    return (long int)_position;
+}
+
+bool MappedFileStream::seek(long int offset, int origin)
+{
+    if (!_data)
+        return false;
+
+    long int base = 0;
+    if (origin == SEEK_CUR)
+        base = (long int)_position;
+    else if (origin == SEEK_END)
+        base = (long int)_length;
+    else if (origin != SEEK_SET)
+        return false;
+
+    long int position = base + offset;
+    if (position < 0 || position > (long int)_length)
+        return false;
+    _position = (size_t)position;
+    return true;
+}
+
+bool MappedFileStream::rewind()
+{
+    if (canSeek())
+    {
+        _position = 0;
+        return true;
+    }
+    return false;
+}
+
+const void* MappedFileStream::getData()
+{
+    return _data;
+}
+
+////////////////////////////////
+
 #ifdef __ANDROID__
 
 FileStreamAndroid::FileStreamAndroid(AAsset* asset)
-    : _asset(asset)
+    : _asset(asset), _data(NULL), _mapping(NULL), _mappingLength(0)
 {
 }
 
@@ -730,12 +1570,36 @@ FileStreamAndroid::~FileStreamAndroid()
         close();
 }
 
-FileStreamAndroid* FileStreamAndroid::create(const char* filePath, const char* mode)
+FileStreamAndroid* FileStreamAndroid::create(const char* filePath, const char* mode, bool mapped)
 {
-    AAsset* asset = AAssetManager_open(__assetManager, filePath, AASSET_MODE_RANDOM);
+    AAsset* asset = AAssetManager_open(__assetManager, filePath, mapped ? AASSET_MODE_BUFFER : AASSET_MODE_RANDOM);
     if (asset)
     {
         FileStreamAndroid* stream = new FileStreamAndroid(asset);
+        if (!mapped)
+            return stream;
+
+        // Assets that are stored uncompressed have a descriptor of the APK, whose range of the
+        // asset is mapped by the stream itself. Compressed ones are inflated once into a buffer
+        // owned by the asset.
+        off_t start;
+        off_t length;
+        int fd = AAsset_openFileDescriptor(asset, &start, &length);
+        if (fd >= 0)
+        {
+            off_t pageStart = start & ~((off_t)sysconf(_SC_PAGESIZE) - 1);
+            size_t mappingLength = (size_t)(length + (start - pageStart));
+            void* mapping = length > 0 ? mmap(NULL, mappingLength, PROT_READ, MAP_PRIVATE, fd, pageStart) : MAP_FAILED;
+            ::close(fd);
+            if (mapping != MAP_FAILED)
+            {
+                stream->_mapping = mapping;
+                stream->_mappingLength = mappingLength;
+                stream->_data = (const unsigned char*)mapping + (start - pageStart);
+                return stream;
+            }
+        }
+        stream->_data = AAsset_getBuffer(asset);
         return stream;
     }
     return NULL;
@@ -758,9 +1622,14 @@ bool FileStreamAndroid::canSeek()
 
 void FileStreamAndroid::close()
 {
+    if (_mapping)
+        munmap(_mapping, _mappingLength);
     if (_asset)
         AAsset_close(_asset);
     _asset = NULL;
+    _data = NULL;
+    _mapping = NULL;
+    _mappingLength = 0;
 }
 
 size_t FileStreamAndroid::read(void* ptr, size_t size, size_t count)
@@ -862,6 +1731,11 @@ bool FileStreamAndroid::rewind()
     return false;
 }
 
+const void* FileStreamAndroid::getData()
+{
+    return _data;
+}
+
 #endif
 
 }
@@ -14,6 +14,8 @@ class Properties;
  */
 class FileSystem
 {
+    friend class Game;
+
 public:
 
     /**
@@ -24,7 +26,8 @@ public:
     enum StreamMode
     {
         READ = 1,
-        WRITE = 2
+        WRITE = 2,
+        MAPPED = 4
     };
 
     /**
@@ -38,6 +41,28 @@ public:
         SAVE 
     };
 
+    /**
+     * Defines an interface for being notified when watched files change.
+     *
+     * @script{ignore}
+     */
+    class WatchListener
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~WatchListener() { }
+
+        /**
+         * Called on the main thread at the start of a frame, once a watched file has changed.
+         *
+         * @param path The path that the file is watched with.
+         */
+        virtual void fileChanged(const char* path) = 0;
+    };
+
     /**
      * Destructor.
      */
@@ -90,6 +115,10 @@ public:
      * file per-platform can be maintained and asset loading code can refer
      * to the alias name instead of the actual hard file name.
      *
+     * Namespaces nested in the properties object are not loaded. In the aliases of the game
+     * config they group the aliases of each compressed texture format, and the game loads
+     * those of the first format the device supports (see Texture::isCompressionSupported).
+     *
      * @param properties Properties object containing filesystem aliases.
      * 
      * @see Properties
@@ -152,6 +181,9 @@ public:
      * If <code>path</code> is a file path, the file at the specified location is opened relative to the currently set
      * resource path.
      *
+     * Reading with MAPPED maps the file into memory where the platform supports it, and
+     * otherwise opens it like READ. Stream::getData returns the contents of mapped streams.
+     *
      * @param path The path to the resource to be opened, relative to the currently set resource path.
      * @param streamMode The stream mode used to open the file.
      * 
@@ -162,12 +194,49 @@ public:
      */
     static Stream* open(const char* path, size_t streamMode = READ);
 
+    /**
+     * Mounts a pack file written by the encoder, so that the files it contains are opened from it.
+     *
+     * The directory of the pack is indexed when it is mounted, so that finding a file in it
+     * doesn't search the directory. The pack is mapped into memory where the platform supports it,
+     * and files that are stored uncompressed are then read straight from the mapping, while
+     * compressed files are decompressed into memory when they are opened. Files are read from
+     * their offset in the pack otherwise.
+     *
+     * Files in mounted packs are found by open, fileExists and listFiles before the files on disk,
+     * or in the APK on Android, and packs are searched from the most recently mounted one.
+     * Only relative paths are searched, and files opened for writing are always opened on disk.
+     *
+     * Packs listed in the "archives" namespace of game.config are mounted at startup, each
+     * property naming a mount point and giving the path of its pack, such as "res = res.gpk".
+     *
+     * @param path The path to the pack file, relative to the currently set resource path.
+     * @param mountPoint The directory that the paths in the pack are relative to, such as "res",
+     *        or NULL to use them as they are.
+     *
+     * @return <code>true</code> if the pack was mounted; <code>false</code> otherwise.
+     */
+    static bool mountArchive(const char* path, const char* mountPoint = NULL);
+
+    /**
+     * Unmounts a pack file that was mounted by mountArchive.
+     *
+     * Streams opened from the pack remain valid until they are closed.
+     *
+     * @param path The path the pack file was mounted with.
+     */
+    static void unmountArchive(const char* path);
+
     /**
      * Opens the specified file.
      *
      * The file at the specified location is opened, relative to the currently set
      * resource path.
      *
+     * On Android, files that are opened for reading and are not on the SD card are read
+     * in place from the assets of the APK. Prefer open(), which also reads mounted archives
+     * and can map files.
+     *
      * @param filePath The path to the file to be opened, relative to the currently set resource path.
      * @param mode The mode used to open the file, passed directly to fopen.
      * 
@@ -192,6 +261,18 @@ public:
      */
     static char* readAll(const char* filePath, int* fileSize = NULL);
 
+    /**
+     * Reads the entire contents of the specified file through the operating system cache,
+     * so that opening it again doesn't wait for the disk. Mapped files are faulted in
+     * without copying them. This may be called from any thread.
+     *
+     * @param filePath The path to the file to be read.
+     *
+     * @return The size of the file in bytes, or 0 if the file could not be opened.
+     * @script{ignore}
+     */
+    static size_t prefetch(const char* filePath);
+
     /**
      * Determines if the file path is an absolute path for the current platform.
      * 
@@ -220,6 +301,9 @@ public:
 
     /**
      * Creates a file on the file system from the specified asset (Android-specific).
+     *
+     * Assets are read in place by open() and openFile(), so this is only needed by code
+     * that passes the path of the file to a library that opens it itself.
      * 
      * @param path The path to the file.
      */
@@ -255,12 +339,78 @@ public:
      */
     static std::string getExtension(const char* path);
 
+    /**
+     * Sets whether resources watch the files they are loaded from, for tuning a running game.
+     *
+     * While watching is enabled, effects and materials watch their files when they are
+     * loaded, and reload in place when the files change. Only the files on disk are
+     * watched, not those in mounted packs or in the APK on Android. Watching can also be
+     * enabled with the 'hotReload' property of the game configuration file, and is only
+     * meant for development, since the files are polled for changes.
+     *
+     * @param enabled true to watch the files of the resources loaded from now on.
+     * @script{ignore}
+     */
+    static void setWatchEnabled(bool enabled);
+
+    /**
+     * Returns whether resources watch the files they are loaded from.
+     *
+     * @return true if watching is enabled.
+     * @script{ignore}
+     */
+    static bool isWatchEnabled();
+
+    /**
+     * Sets the time between two checks of the watched files. The default is 250 milliseconds.
+     *
+     * A change is reported once the file is the same at two checks in a row, so that
+     * files are not read while an editor is still writing them.
+     *
+     * @param milliseconds The time between two checks.
+     * @script{ignore}
+     */
+    static void setWatchInterval(float milliseconds);
+
+    /**
+     * Returns the time between two checks of the watched files.
+     *
+     * @return The time between two checks, in milliseconds.
+     * @script{ignore}
+     */
+    static float getWatchInterval();
+
+    /**
+     * Notifies a listener when the file at the given path changes, until it is unwatched.
+     *
+     * Files are watched on the main thread, whether or not watching is enabled, and the
+     * listener must be unwatched before it is destroyed.
+     *
+     * @param path The path to the file, relative to the currently set resource path.
+     * @param listener The listener to notify.
+     * @script{ignore}
+     */
+    static void watch(const char* path, WatchListener* listener);
+
+    /**
+     * Stops notifying a listener of changes to any files.
+     *
+     * @param listener The listener to stop notifying.
+     * @script{ignore}
+     */
+    static void unwatch(WatchListener* listener);
+
 private:
 
     /**
      * Constructor.
      */
     FileSystem();
+
+    /**
+     * Checks the watched files for changes and notifies their listeners. Called by the game at the start of every frame.
+     */
+    static void updateWatches();
 };
 
 }
@@ -5,35 +5,35 @@
 #include "FileSystem.h"
 #include "Bundle.h"
 #include "Material.h"
+#include "ResourceManager.h"
+#include "TextLayout.h"
+#include "GlyphCache.h"
 
 // Default font shaders
 #define FONT_VSH "res/shaders/font.vert"
 #define FONT_FSH "res/shaders/font.frag"
 
+// The number of layouts that a font caches before releasing those that are no longer drawn.
+#define FONT_LAYOUT_CACHE_SIZE 128
+
 namespace gameplay
 {
 
-static std::vector<Font*> __fontCache;
-
 static Effect* __fontEffect = NULL;
 
 Font::Font() :
-    _format(BITMAP), _style(PLAIN), _size(0), _spacing(0.0f), _glyphs(NULL), _glyphCount(0), _texture(NULL), _batch(NULL), _cutoffParam(NULL)
+    _format(BITMAP), _style(PLAIN), _size(0), _spacing(0.0f), _glyphs(NULL), _glyphCount(0), _texture(NULL), _batch(NULL), _cutoffParam(NULL),
+    _glyphCache(NULL)
 {
 }
 
 Font::~Font()
 {
-    // Remove this Font from the font cache.
-    std::vector<Font*>::iterator itr = std::find(__fontCache.begin(), __fontCache.end(), this);
-    if (itr != __fontCache.end())
-    {
-        __fontCache.erase(itr);
-    }
-
+    clearLayouts();
     SAFE_DELETE(_batch);
     SAFE_DELETE_ARRAY(_glyphs);
     SAFE_RELEASE(_texture);
+    SAFE_DELETE(_glyphCache);
 
     // Free child fonts
     for (size_t i = 0, count = _sizes.size(); i < count; ++i)
@@ -47,16 +47,15 @@ Font* Font::create(const char* path, const char* id)
     GP_ASSERT(path);
 
     // Search the font cache for a font with the given path and ID.
-    for (size_t i = 0, count = __fontCache.size(); i < count; ++i)
+    std::string key = path;
+    key += '#';
+    if (id)
+        key += id;
+    Font* f = static_cast<Font*>(ResourceManager::find(ResourceManager::FONT, key));
+    if (f)
     {
-        Font* f = __fontCache[i];
-        GP_ASSERT(f);
-        if (f->_path == path && (id == NULL || f->_id == id))
-        {
-            // Found a match.
-            f->addRef();
-            return f;
-        }
+        // Found a match.
+        return f;
     }
 
     // Load the bundle.
@@ -89,8 +88,14 @@ Font* Font::create(const char* path, const char* id)
 
     if (font)
     {
-        // Add this font to the cache.
-        __fontCache.push_back(font);
+        // Add this font to the cache, with the textures of all of its sizes.
+        size_t size = font->_texture ? font->_texture->getMemorySize() : 0;
+        for (size_t i = 0, count = font->_sizes.size(); i < count; ++i)
+        {
+            if (font->_sizes[i]->_texture)
+                size += font->_sizes[i]->_texture->getMemorySize();
+        }
+        ResourceManager::add(ResourceManager::FONT, key, font, size);
     }
 
     SAFE_RELEASE(bundle);
@@ -98,6 +103,63 @@ Font* Font::create(const char* path, const char* id)
     return font;
 }
 
+Font* Font::createDynamic(const char* path, unsigned int size, Format format)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(size);
+
+    // Search the font cache for a font created from the file with the same size and format.
+    char suffix[32];
+    sprintf(suffix, "#%u#%d", size, (int)format);
+    std::string key = path;
+    key += suffix;
+    Font* f = static_cast<Font*>(ResourceManager::find(ResourceManager::FONT, key));
+    if (f)
+    {
+        // Found a match.
+        return f;
+    }
+
+    GlyphCache* cache = GlyphCache::create(path, size, format);
+    if (cache == NULL)
+        return NULL;
+
+    // The printable ASCII characters stay in the page, since spaces and tabs are measured
+    // by the advance of the first of them and the other glyphs are looked up by index.
+    const unsigned int glyphCount = 95;
+    Glyph glyphs[glyphCount];
+    for (unsigned int i = 0; i < glyphCount; ++i)
+    {
+        const Glyph* g = cache->findGlyph(32 + i, NULL, true);
+        if (g)
+        {
+            glyphs[i] = *g;
+        }
+        else
+        {
+            memset(&glyphs[i], 0, sizeof(Glyph));
+            glyphs[i].code = 32 + i;
+        }
+    }
+    if (glyphs[0].advance == 0)
+        glyphs[0].advance = size / 4;
+
+    Font* font = create(cache->_family.c_str(), PLAIN, size, glyphs, glyphCount, cache->_texture, format);
+    if (font == NULL)
+    {
+        SAFE_DELETE(cache);
+        return NULL;
+    }
+    font->_path = path;
+    font->_glyphCache = cache;
+
+    // The page has no mipmaps, since its glyphs change as they are drawn.
+    font->_batch->getSampler()->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+
+    ResourceManager::add(ResourceManager::FONT, key, font, cache->_texture->getMemorySize());
+    return font;
+}
+
 Font* Font::create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture, Font::Format format)
 {
     GP_ASSERT(family);
@@ -179,11 +241,41 @@ Font::Format Font::getFormat()
 
 bool Font::isCharacterSupported(int character) const
 {
-    // TODO: Update this once we support unicode fonts
+    if (_glyphCache && character >= 0x80)
+        return _glyphCache->hasGlyph((unsigned int)character);
+
     int glyphIndex = character - 32; // HACK for ASCII
     return (glyphIndex >= 0 && glyphIndex < (int)_glyphCount);
 }
 
+const Font::Glyph* Font::findGlyph(const char* character, unsigned int* slot)
+{
+    GP_ASSERT(character);
+
+    unsigned char c = (unsigned char)character[0];
+    if (c < 0x80)
+    {
+        int index = c - 32; // HACK for ASCII
+        return index >= 0 && index < (int)_glyphCount ? &_glyphs[index] : NULL;
+    }
+
+    // Only the fonts rasterised at runtime have glyphs beyond ASCII. The continuation bytes
+    // of a character have no glyph, so that the character is drawn once from its first byte.
+    if (_glyphCache == NULL || c < 0xC0)
+        return NULL;
+
+    unsigned int length = c >= 0xF0 ? 4 : (c >= 0xE0 ? 3 : 2);
+    unsigned int code = c & (0x3F >> (length - 1));
+    for (unsigned int i = 1; i < length; ++i)
+    {
+        unsigned char next = (unsigned char)character[i];
+        if ((next & 0xC0) != 0x80)
+            return NULL;
+        code = (code << 6) | (next & 0x3F);
+    }
+    return _glyphCache->findGlyph(code, slot);
+}
+
 void Font::start()
 {
     // no-op : fonts now are lazily started on the first draw call
@@ -223,6 +315,19 @@ void Font::finish()
 
 Font* Font::findClosestSize(int size)
 {
+    // Distance fields are drawn at every size from the largest size of the font, so that text
+    // of all sizes shares the texture and the sprite batch of that size, and draws in one batch.
+    if (_format == DISTANCE_FIELD)
+    {
+        Font* largest = this;
+        for (size_t i = 0, count = _sizes.size(); i < count; ++i)
+        {
+            if (_sizes[i]->_size > largest->_size)
+                largest = _sizes[i];
+        }
+        return largest;
+    }
+
     if (size == (int)_size)
         return this;
 
@@ -248,18 +353,14 @@ void Font::drawText(const char* text, int x, int y, const Vector4& color, unsign
     GP_ASSERT(text);
 
     if (size == 0)
-    {
         size = _size;
-    }
-    else
+
+    // Delegate to closest sized font
+    Font* f = findClosestSize(size);
+    if (f != this)
     {
-        // Delegate to closest sized font
-        Font* f = findClosestSize(size);
-        if (f != this)
-        {
-            f->drawText(text, x, y, color, size, rightToLeft);
-            return;
-        }
+        f->drawText(text, x, y, color, size, rightToLeft);
+        return;
     }
 
     lazyStart();
@@ -356,10 +457,10 @@ void Font::drawText(const char* text, int x, int y, const Vector4& color, unsign
                 xPos += _glyphs[0].advance * 4;
                 break;
             default:
-                int index = c - 32; // HACK for ASCII
-                if (index >= 0 && index < (int)_glyphCount)
+                const Glyph* glyph = findGlyph(rightToLeft ? &cursor[i] : &text[i]);
+                if (glyph)
                 {
-                    Glyph& g = _glyphs[index];
+                    const Glyph& g = *glyph;
 
                     if (getFormat() == DISTANCE_FIELD )
                     {
@@ -398,34 +499,152 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
     GP_ASSERT(_size);
 
     if (size == 0)
-    {
         size = _size;
+
+    // Delegate to closest sized font
+    Font* f = findClosestSize(size);
+    if (f != this)
+    {
+        f->drawText(text, area, color, size, justify, wrap, rightToLeft, clip);
+        return;
     }
-    else
+
+    drawLayout(findLayout(text, area, size, justify, wrap, rightToLeft), color, clip);
+}
+
+/**
+ * Hashes the parameters that a text is laid out with.
+ */
+static size_t hashLayout(const char* text, const Rectangle& area, unsigned int size, Font::Justify justify, bool wrap, bool rightToLeft)
+{
+    // FNV-1a over the characters of the text and the bytes of the other parameters.
+    size_t hash = 2166136261u;
+    for (const char* c = text; *c; ++c)
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+
+    float values[] = { area.x, area.y, area.width, area.height, (float)size, (float)justify, wrap ? 1.0f : 0.0f, rightToLeft ? 1.0f : 0.0f };
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(values);
+    for (size_t i = 0; i < sizeof(values); ++i)
+        hash = (hash ^ bytes[i]) * 16777619u;
+    return hash;
+}
+
+TextLayout* Font::findLayout(const char* text, const Rectangle& area, unsigned int size, Justify justify, bool wrap, bool rightToLeft)
+{
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    size_t hash = hashLayout(text, area, size, justify, wrap, rightToLeft);
+    LayoutMap::iterator itr = _layouts.find(hash);
+    if (itr != _layouts.end())
     {
-        // Delegate to closest sized font
-        Font* f = findClosestSize(size);
-        if (f != this)
+        if (itr->second->matches(text, area, size, justify, wrap, rightToLeft))
         {
-            f->drawText(text, area, color, size, justify, wrap, rightToLeft, clip);
-            return;
+            itr->second->_lastDrawn = frame;
+            return itr->second;
         }
+        SAFE_RELEASE(itr->second);
+        _layouts.erase(itr);
+    }
+
+    // Once the cache is full, release the layouts that have not been drawn this frame.
+    if (_layouts.size() >= FONT_LAYOUT_CACHE_SIZE)
+    {
+        for (itr = _layouts.begin(); itr != _layouts.end();)
+        {
+            if (itr->second->_lastDrawn != frame)
+            {
+                SAFE_RELEASE(itr->second);
+                itr = _layouts.erase(itr);
+            }
+            else
+            {
+                ++itr;
+            }
+        }
+    }
+
+    TextLayout* layout = new TextLayout(this, false);
+    layout->_text = text;
+    layout->_area = area;
+    layout->_size = size;
+    layout->_justify = justify;
+    layout->_wrap = wrap;
+    layout->_rightToLeft = rightToLeft;
+    layout->_lastDrawn = frame;
+    layoutText(layout);
+    _layouts[hash] = layout;
+    return layout;
+}
+
+void Font::drawLayout(TextLayout* layout, const Vector4& color, const Rectangle& clip)
+{
+    GP_ASSERT(layout);
+    GP_ASSERT(layout->_font == this);
+    GP_ASSERT(_batch);
+
+    if (_glyphCache)
+    {
+        // Glyphs evicted since the layout was laid out have left their slots to other glyphs.
+        if (layout->_generation != _glyphCache->_generation)
+            layoutText(layout);
+        _glyphCache->touch(layout->_slots);
     }
 
     lazyStart();
 
+    if (getFormat() == DISTANCE_FIELD)
+    {
+        if (_cutoffParam == NULL)
+            _cutoffParam = _batch->getMaterial()->getParameter("u_cutoff");
+        // TODO: Fix me so that smaller font are much smoother
+        _cutoffParam->setVector2(Vector2(1.0, 1.0));
+    }
+
+    bool clipped = clip != Rectangle(0, 0, 0, 0);
+    for (size_t i = 0, count = layout->_quads.size(); i < count; ++i)
+    {
+        const TextLayout::Quad& q = layout->_quads[i];
+        if (clipped)
+            _batch->draw(q.x, q.y, q.width, q.height, q.u1, q.v1, q.u2, q.v2, color, clip);
+        else
+            _batch->draw(q.x, q.y, q.width, q.height, q.u1, q.v1, q.u2, q.v2, color);
+    }
+}
+
+void Font::clearLayouts()
+{
+    for (LayoutMap::iterator itr = _layouts.begin(); itr != _layouts.end(); ++itr)
+    {
+        SAFE_RELEASE(itr->second);
+    }
+    _layouts.clear();
+}
+
+void Font::layoutText(TextLayout* layout)
+{
+    GP_ASSERT(layout);
+    GP_ASSERT(layout->_font == this);
+
+    const char* text = layout->_text.c_str();
+    const Rectangle& area = layout->_area;
+    unsigned int size = layout->_size;
+    Justify justify = layout->_justify;
+    bool wrap = layout->_wrap;
+    bool rightToLeft = layout->_rightToLeft;
+    layout->_quads.clear();
+    layout->_slots.clear();
+
     float scale = (float)size / _size;
     int spacing = (int)(size * _spacing);
     int yPos = area.y;
     const float areaHeight = area.height - size;
-    std::vector<int> xPositions;
-    std::vector<unsigned int> lineLengths;
+    PositionList xPositions;
+    LengthList lineLengths;
 
     getMeasurementInfo(text, area, size, justify, wrap, rightToLeft, &xPositions, &yPos, &lineLengths);
 
     // Now we have the info we need in order to render.
     int xPos = area.x;
-    std::vector<int>::const_iterator xPositionsIt = xPositions.begin();
+    PositionList::const_iterator xPositionsIt = xPositions.begin();
     if (xPositionsIt != xPositions.end())
     {
         xPos = *xPositionsIt++;
@@ -436,7 +655,7 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
     unsigned int lineLength;
     unsigned int currentLineLength = 0;
     const char* lineStart;
-    std::vector<unsigned int>::const_iterator lineLengthsIt;
+    LengthList::const_iterator lineLengthsIt;
     if (rightToLeft)
     {
         lineStart = token;
@@ -504,15 +723,14 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
         }
 
         GP_ASSERT(_glyphs);
-        GP_ASSERT(_batch);
         for (int i = startIndex; i < (int)tokenLength && i >= 0; i += iteration)
         {
-            char c = token[i];
-            int glyphIndex = c - 32; // HACK for ASCII
+            unsigned int slot = std::numeric_limits<unsigned int>::max();
+            const Glyph* glyph = findGlyph(&token[i], &slot);
 
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            if (glyph)
             {
-                Glyph& g = _glyphs[glyphIndex];
+                const Glyph& g = *glyph;
 
                 if (xPos + (int)(g.advance*scale) > area.x + area.width)
                 {
@@ -522,24 +740,22 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
                 }
                 else if (xPos >= (int)area.x)
                 {
-                    // Draw this character.
+                    // Position this character.
                     if (draw)
                     {
-                        if (getFormat() == DISTANCE_FIELD)
-                        {
-                            if (_cutoffParam == NULL)
-                                _cutoffParam = _batch->getMaterial()->getParameter("u_cutoff");
-                            // TODO: Fix me so that smaller font are much smoother
-                            _cutoffParam->setVector2(Vector2(1.0, 1.0));
-                        }
-                        if (clip != Rectangle(0, 0, 0, 0))
-                        {
-                            _batch->draw(xPos + (int)(g.bearingX * scale), yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color, clip);
-                        }
-                        else
-                        {
-                            _batch->draw(xPos + (int)(g.bearingX * scale), yPos, g.width * scale, size, g.uvs[0], g.uvs[1], g.uvs[2], g.uvs[3], color);
-                        }
+                        if (slot != std::numeric_limits<unsigned int>::max())
+                            layout->_slots.push_back(slot);
+
+                        TextLayout::Quad quad;
+                        quad.x = xPos + (int)(g.bearingX * scale);
+                        quad.y = yPos;
+                        quad.width = g.width * scale;
+                        quad.height = size;
+                        quad.u1 = g.uvs[0];
+                        quad.v1 = g.uvs[1];
+                        quad.u2 = g.uvs[2];
+                        quad.v2 = g.uvs[3];
+                        layout->_quads.push_back(quad);
                     }
                 }
                 xPos += (int)(g.advance)*scale + spacing;
@@ -608,6 +824,9 @@ void Font::drawText(const char* text, const Rectangle& area, const Vector4& colo
             }
         }
     }
+
+    if (_glyphCache)
+        layout->_generation = _glyphCache->_generation;
 }
 
 void Font::measureText(const char* text, unsigned int size, unsigned int* width, unsigned int* height)
@@ -618,18 +837,14 @@ void Font::measureText(const char* text, unsigned int size, unsigned int* width,
     GP_ASSERT(height);
 
     if (size == 0)
-    {
         size = _size;
-    }
-    else
+
+    // Delegate to closest sized font
+    Font* f = findClosestSize(size);
+    if (f != this)
     {
-        // Delegate to closest sized font
-        Font* f = findClosestSize(size);
-        if (f != this)
-        {
-            f->measureText(text, size, width, height);
-            return;
-        }
+        f->measureText(text, size, width, height);
+        return;
     }
 
     const size_t length = strlen(text);
@@ -673,18 +888,14 @@ void Font::measureText(const char* text, const Rectangle& clip, unsigned int siz
     GP_ASSERT(out);
 
     if (size == 0)
-    {
         size = _size;
-    }
-    else
+
+    // Delegate to closest sized font
+    Font* f = findClosestSize(size);
+    if (f != this)
     {
-        // Delegate to closest sized font
-        Font* f = findClosestSize(size);
-        if (f != this)
-        {
-            f->measureText(text, clip, size, out, justify, wrap, ignoreClip);
-            return;
-        }
+        f->measureText(text, clip, size, out, justify, wrap, ignoreClip);
+        return;
     }
 
     if (strlen(text) == 0)
@@ -707,8 +918,8 @@ void Font::measureText(const char* text, const Rectangle& clip, unsigned int siz
     }
 
     const char* token = text;
-    std::vector<bool> emptyLines;
-    std::vector<Vector2> lines;
+    std::vector<bool, FrameAllocator::Adapter<bool> > emptyLines;
+    std::vector<Vector2, FrameAllocator::Adapter<Vector2> > lines;
 
     unsigned int lineWidth = 0;
     int yPos = clip.y + size;
@@ -1013,7 +1224,7 @@ void Font::measureText(const char* text, const Rectangle& clip, unsigned int siz
 }
 
 void Font::getMeasurementInfo(const char* text, const Rectangle& area, unsigned int size, Justify justify, bool wrap, bool rightToLeft,
-        std::vector<int>* xPositions, int* yPosition, std::vector<unsigned int>* lineLengths)
+        PositionList* xPositions, int* yPosition, LengthList* lineLengths)
 {
     GP_ASSERT(_size);
     GP_ASSERT(text);
@@ -1207,6 +1418,7 @@ float Font::getCharacterSpacing() const
 void Font::setCharacterSpacing(float spacing)
 {
     _spacing = spacing;
+    clearLayouts();
 }
 
 int Font::getIndexAtLocation(const char* text, const Rectangle& area, unsigned int size, const Vector2& inLocation, Vector2* outLocation,
@@ -1229,17 +1441,13 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
     GP_ASSERT(outLocation);
 
     if (size == 0)
-    {
         size = _size;
-    }
-    else
+
+    // Delegate to closest sized font
+    Font* f = findClosestSize(size);
+    if (f != this)
     {
-        // Delegate to closest sized font
-        Font* f = findClosestSize(size);
-        if (f != this)
-        {
-            return f->getIndexOrLocation(text, area, size, inLocation, outLocation, destIndex, justify, wrap, rightToLeft);
-        }
+        return f->getIndexOrLocation(text, area, size, inLocation, outLocation, destIndex, justify, wrap, rightToLeft);
     }
 
     unsigned int charIndex = 0;
@@ -1249,13 +1457,13 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
     int spacing = (int)(size * _spacing);
     int yPos = area.y;
     const float areaHeight = area.height - size;
-    std::vector<int> xPositions;
-    std::vector<unsigned int> lineLengths;
+    PositionList xPositions;
+    LengthList lineLengths;
 
     getMeasurementInfo(text, area, size, justify, wrap, rightToLeft, &xPositions, &yPos, &lineLengths);
 
     int xPos = area.x;
-    std::vector<int>::const_iterator xPositionsIt = xPositions.begin();
+    PositionList::const_iterator xPositionsIt = xPositions.begin();
     if (xPositionsIt != xPositions.end())
     {
         xPos = *xPositionsIt++;
@@ -1267,7 +1475,7 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
     unsigned int lineLength;
     unsigned int currentLineLength = 0;
     const char* lineStart;
-    std::vector<unsigned int>::const_iterator lineLengthsIt;
+    LengthList::const_iterator lineLengthsIt;
     if (rightToLeft)
     {
         lineStart = token;
@@ -1356,12 +1564,11 @@ int Font::getIndexOrLocation(const char* text, const Rectangle& area, unsigned i
         GP_ASSERT(_glyphs);
         for (int i = startIndex; i < (int)tokenLength && i >= 0; i += iteration)
         {
-            char c = token[i];
-            int glyphIndex = c - 32; // HACK for ASCII
+            const Glyph* glyph = findGlyph(&token[i]);
 
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            if (glyph)
             {
-                Glyph& g = _glyphs[glyphIndex];
+                const Glyph& g = *glyph;
 
                 if (xPos + (int)(g.advance*scale) > area.x + area.width)
                 {
@@ -1492,11 +1699,10 @@ unsigned int Font::getTokenWidth(const char* token, unsigned int length, unsigne
             tokenWidth += _glyphs[0].advance * 4;
             break;
         default:
-            int glyphIndex = c - 32;
-            if (glyphIndex >= 0 && glyphIndex < (int)_glyphCount)
+            const Glyph* g = findGlyph(&token[i]);
+            if (g)
             {
-                Glyph& g = _glyphs[glyphIndex];
-                tokenWidth += floor(g.advance * scale + spacing);
+                tokenWidth += floor(g->advance * scale + spacing);
             }
             break;
         }
@@ -1530,7 +1736,7 @@ unsigned int Font::getReversedTokenLength(const char* token, const char* bufStar
 }
 
 int Font::handleDelimiters(const char** token, const unsigned int size, const int iteration, const int areaX, int* xPos, int* yPos, unsigned int* lineLength,
-                          std::vector<int>::const_iterator* xPositionsIt, std::vector<int>::const_iterator xPositionsEnd, unsigned int* charIndex,
+                          PositionList::const_iterator* xPositionsIt, PositionList::const_iterator xPositionsEnd, unsigned int* charIndex,
                           const Vector2* stopAtPosition, const int currentIndex, const int destIndex)
 {
     GP_ASSERT(token);
@@ -1613,7 +1819,7 @@ int Font::handleDelimiters(const char** token, const unsigned int size, const in
 }
 
 void Font::addLineInfo(const Rectangle& area, int lineWidth, int lineLength, Justify hAlign,
-                       std::vector<int>* xPositions, std::vector<unsigned int>* lineLengths, bool rightToLeft)
+                       PositionList* xPositions, LengthList* lineLengths, bool rightToLeft)
 {
     int hWhitespace = area.width - lineWidth;
     if (hAlign == ALIGN_HCENTER)
@@ -1637,7 +1843,7 @@ void Font::addLineInfo(const Rectangle& area, int lineWidth, int lineLength, Jus
 SpriteBatch* Font::getSpriteBatch(unsigned int size) const
 {
     if (size == 0)
-        return _batch;
+        size = _size;
 
     // Find the closest sized child font
     return const_cast<Font*>(this)->findClosestSize(size)->_batch;
@@ -2,18 +2,24 @@
 #define FONT_H_
 
 #include "SpriteBatch.h"
+#include "FrameAllocator.h"
 
 namespace gameplay
 {
 
+class GlyphCache;
+class TextLayout;
+
 /**
  * Defines a font for text rendering.
  */
 class Font : public Ref
 {
     friend class Bundle;
+    friend class GlyphCache;
     friend class Text;
     friend class TextBox;
+    friend class TextLayout;
 
 public:
 
@@ -77,6 +83,30 @@ public:
      */
     static Font* create(const char* path, const char* id = NULL);
 
+    /**
+     * Creates a font that rasterises its glyphs from a TrueType or OpenType font file at runtime,
+     * as they are first drawn, instead of drawing them from a texture built by the encoder.
+     *
+     * The glyphs are kept in a single texture page, from which the glyphs drawn the longest ago
+     * are evicted once it is full, so that fonts covering large character sets such as CJK only
+     * use the memory of the characters being drawn. Text is read as UTF-8. With the DISTANCE_FIELD
+     * format the glyphs are stored as distance fields, so that the font draws smoothly at every
+     * size from the one size it rasterises at.
+     *
+     * Rasterising glyphs requires the engine to be built with GP_USE_FREETYPE.
+     *
+     * If a font has already been created from the same file with the same size and format, the
+     * existing font is returned with its reference count increased.
+     *
+     * @param path The path to the font file.
+     * @param size The size in pixels that glyphs are rasterised at.
+     * @param format The format that glyphs are stored in.
+     *
+     * @return The new Font or NULL if there was an error.
+     * @script{create}
+     */
+    static Font* createDynamic(const char* path, unsigned int size = 32, Format format = DISTANCE_FIELD);
+
     /**
      * Gets the font size (max height of glyphs) in pixels, at the specified index.
      *
@@ -144,6 +174,9 @@ public:
      * Draws the specified text within a rectangular area, with a specified alignment and scale.
      * Clips text outside the viewport. Optionally wraps text to fit within the width of the viewport.
      *
+     * The text is laid out the first time it is drawn with the given size, area, justification
+     * and wrapping, and drawn from a cache of layouts until one of them changes.
+     *
      * @param text The text to draw.
      * @param area The viewport area to draw within.  Text will be clipped outside this rectangle.
      * @param color The color of text.
@@ -152,6 +185,8 @@ public:
      * @param wrap Wraps text to fit within the width of the viewport if true.
      * @param rightToLeft Whether to draw text from right to left.
      * @param clip A region to clip text within after applying justification to the viewport area.
+     *
+     * @see TextLayout
      */
     void drawText(const char* text, const Rectangle& area, const Vector4& color, unsigned int size = 0,
                   Justify justify = ALIGN_TOP_LEFT, bool wrap = true, bool rightToLeft = false,
@@ -226,7 +261,8 @@ public:
      *
      * @param size The font size to be drawn.
      *
-     * @return The SpriteBatch that most closely matches the requested font size.
+     * @return The SpriteBatch that most closely matches the requested font size, which is the
+     *         batch of the largest size for DISTANCE_FIELD fonts, since they draw every size.
      */
     SpriteBatch* getSpriteBatch(unsigned int size) const;
 
@@ -242,6 +278,17 @@ public:
 
 private:
 
+    /**
+     * Scratch arrays built while laying out text, allocated from the frame allocator.
+     */
+    typedef std::vector<int, FrameAllocator::Adapter<int> > PositionList;
+    typedef std::vector<unsigned int, FrameAllocator::Adapter<unsigned int> > LengthList;
+
+    /**
+     * Cached layouts, by the hash of the parameters they were laid out with.
+     */
+    typedef std::unordered_map<size_t, TextLayout*> LayoutMap;
+
     /**
      * Defines a font glyph within the texture map for a font.
      */
@@ -313,7 +360,7 @@ private:
     static Font* create(const char* family, Style style, unsigned int size, Glyph* glyphs, int glyphCount, Texture* texture, Font::Format format);
 
     void getMeasurementInfo(const char* text, const Rectangle& area, unsigned int size, Justify justify, bool wrap, bool rightToLeft,
-                            std::vector<int>* xPositions, int* yPosition, std::vector<unsigned int>* lineLengths);
+                            PositionList* xPositions, int* yPosition, LengthList* lineLengths);
 
     int getIndexOrLocation(const char* text, const Rectangle& clip, unsigned int size, const Vector2& inLocation, Vector2* outLocation,
                            const int destIndex = -1, Justify justify = ALIGN_TOP_LEFT, bool wrap = true, bool rightToLeft = false);
@@ -323,16 +370,47 @@ private:
     unsigned int getReversedTokenLength(const char* token, const char* bufStart);
 
     int handleDelimiters(const char** token, const unsigned int size, const int iteration, const int areaX, int* xPos, int* yPos, unsigned int* lineLength,
-                         std::vector<int>::const_iterator* xPositionsIt, std::vector<int>::const_iterator xPositionsEnd, unsigned int* charIndex = NULL,
+                         PositionList::const_iterator* xPositionsIt, PositionList::const_iterator xPositionsEnd, unsigned int* charIndex = NULL,
                          const Vector2* stopAtPosition = NULL, const int currentIndex = -1, const int destIndex = -1);
 
     void addLineInfo(const Rectangle& area, int lineWidth, int lineLength, Justify hAlign,
-                     std::vector<int>* xPositions, std::vector<unsigned int>* lineLengths, bool rightToLeft);
+                     PositionList* xPositions, LengthList* lineLengths, bool rightToLeft);
 
     Font* findClosestSize(int size);
 
+    /**
+     * Returns the glyph of the character starting at the given byte of a UTF-8 text, or NULL if
+     * the font has no glyph for it or the byte continues a multi-byte character.
+     *
+     * @param character The first byte of the character.
+     * @param slot Set to the slot of the glyph in the glyph cache of the font, if it has one and
+     *        the glyph can be evicted from it.
+     */
+    const Glyph* findGlyph(const char* character, unsigned int* slot = NULL);
+
     void lazyStart();
 
+    /**
+     * Returns the cached layout of a text, laying it out if it isn't cached.
+     */
+    TextLayout* findLayout(const char* text, const Rectangle& area, unsigned int size, Justify justify, bool wrap, bool rightToLeft);
+
+    /**
+     * Positions the glyphs of a layout from its text and parameters.
+     */
+    void layoutText(TextLayout* layout);
+
+    /**
+     * Draws the glyphs of a layout into the sprite batch of the font, laying it out again
+     * if glyphs have been evicted from the glyph cache of the font since it was laid out.
+     */
+    void drawLayout(TextLayout* layout, const Vector4& color, const Rectangle& clip);
+
+    /**
+     * Releases the cached layouts.
+     */
+    void clearLayouts();
+
     Format _format;
     std::string _path;
     std::string _id;
@@ -347,6 +425,8 @@ private:
     SpriteBatch* _batch;
     Rectangle _viewport;
     MaterialParameter* _cutoffParam;
+    LayoutMap _layouts;
+    GlyphCache* _glyphCache;
 };
 
 }
@@ -4,6 +4,7 @@
 #include "FlowLayout.h"
 #include "VerticalLayout.h"
 #include "Game.h"
+#include "MemoryTracker.h"
 #include "Theme.h"
 #include "Label.h"
 #include "Button.h"
@@ -16,6 +17,8 @@ static const float GAMEPAD_SCROLL_SPEED = 600.0f;
 static const float JOYSTICK_THRESHOLD = 0.75f;
 // If the DPad or joystick is held down, this is the initial delay in milliseconds between focus changes.
 static const float GAMEPAD_FOCUS_REPEAT_DELAY = 300.0f;
+// The largest number of rows and columns of the grid that points are tested against.
+static const unsigned int HIT_GRID_MAX_SIZE = 32;
 
 // Shaders used for drawing offscreen quad when form is attached to a node
 #define FORM_VSH "res/shaders/sprite.vert"
@@ -29,6 +32,80 @@ static Control* __focusControl = NULL;
 static Control* __activeControl[Touch::MAX_TOUCH_POINTS];
 static bool __shiftKeyDown = false;
 
+/**
+ * The parsed properties and theme of a form file, which forms created from it again share.
+ */
+struct FormTemplate
+{
+    std::string url;
+    Properties* properties;
+    Properties* formProperties;
+    Theme* theme;
+};
+
+static std::vector<FormTemplate> __formTemplates;
+static int __formTemplatesEnabled = -1;
+
+/**
+ * Rewinds the iterators of a namespace and all of its inner namespaces, so that a template
+ * reads the same as a freshly loaded file.
+ */
+static void rewindProperties(Properties* properties)
+{
+    properties->rewind();
+    Properties* inner;
+    while ((inner = properties->getNextNamespace()) != NULL)
+        rewindProperties(inner);
+    properties->rewind();
+}
+
+/**
+ * Loads the template of the form file at the given URL.
+ */
+static bool loadFormTemplate(const char* url, FormTemplate* formTemplate)
+{
+    Properties* properties = Properties::create(url);
+    if (!properties)
+    {
+        GP_WARN("Failed to load properties file for Form.");
+        return false;
+    }
+    // Check if the Properties is valid and has a valid namespace.
+    Properties* formProperties = (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
+    if (!formProperties || !(strcmpnocase(formProperties->getNamespace(), "form") == 0))
+    {
+        GP_WARN("Invalid properties file for form: %s", url);
+        SAFE_DELETE(properties);
+        return false;
+    }
+
+    // Load the form's theme.
+    Theme* theme = NULL;
+    if (formProperties->exists("theme"))
+    {
+        std::string themeFile;
+        if (formProperties->getPath("theme", &themeFile))
+        {
+            theme = Theme::create(themeFile.c_str());
+        }
+    }
+
+    formTemplate->url = url;
+    formTemplate->properties = properties;
+    formTemplate->formProperties = formProperties;
+    formTemplate->theme = theme;
+    return true;
+}
+
+/**
+ * Releases the properties and theme of a form template.
+ */
+static void releaseFormTemplate(FormTemplate& formTemplate)
+{
+    SAFE_DELETE(formTemplate.properties);
+    SAFE_RELEASE(formTemplate.theme);
+}
+
 /**
  * Static initializer for forms.
  * @script{ignore}
@@ -42,7 +119,7 @@ struct FormInit
 };
 static FormInit __init;
 
-Form::Form() : Drawable(), _batched(true)
+Form::Form() : Drawable(), _batched(true), _retained(false), _geometryDirty(true), _hitColumns(0), _hitRows(0), _hitGridDirty(true)
 {
 }
 
@@ -58,39 +135,43 @@ Form::~Form()
 
 Form* Form::create(const char* url)
 {
-    Form* form = new Form();
+    GP_ASSERT(url);
+    MemoryTracker::Scope scope(MemoryTracker::UI);
 
-    // Load Form from .form file.
-    Properties* properties = Properties::create(url);
-    if (!properties)
+    if (__formTemplatesEnabled < 0)
     {
-        GP_WARN("Failed to load properties file for Form.");
-        return NULL;
-    }
-    // Check if the Properties is valid and has a valid namespace.
-    Properties* formProperties = (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
-    if (!formProperties || !(strcmpnocase(formProperties->getNamespace(), "form") == 0))
-    {
-        GP_WARN("Invalid properties file for form: %s", url);
-        SAFE_DELETE(properties);
-        return NULL;
+        Properties* config = Game::getInstance()->getConfig()->getNamespace("ui", true);
+        __formTemplatesEnabled = (config && config->exists("formTemplates") && !config->getBool("formTemplates")) ? 0 : 1;
     }
 
-    // Load the form's theme style.
-    Theme* theme = NULL;
-    Theme::Style* style = NULL;
-    if (formProperties->exists("theme"))
+    // Load Form from .form file, unless it was loaded before.
+    FormTemplate formTemplate;
+    bool cached = false;
+    for (size_t i = 0, count = __formTemplates.size(); i < count && !cached; ++i)
     {
-        std::string themeFile;
-        if (formProperties->getPath("theme", &themeFile))
+        if (__formTemplates[i].url == url)
         {
-            theme = Theme::create(themeFile.c_str());
+            formTemplate = __formTemplates[i];
+            rewindProperties(formTemplate.properties);
+            cached = true;
         }
     }
-    if (!theme)
+    if (!cached)
     {
-        theme = Theme::getDefault();
+        if (!loadFormTemplate(url, &formTemplate))
+            return NULL;
+        if (__formTemplatesEnabled == 1)
+        {
+            __formTemplates.push_back(formTemplate);
+            cached = true;
+        }
     }
+    Properties* formProperties = formTemplate.formProperties;
+    Form* form = new Form();
+
+    // Load the form's theme style.
+    Theme* theme = formTemplate.theme ? formTemplate.theme : Theme::getDefault();
+    Theme::Style* style = NULL;
 
     if (theme)
     {
@@ -102,23 +183,31 @@ Form* Form::create(const char* url)
     }
 
     form->_batched = formProperties->getBool("batchingEnabled", true);
+    form->_retained = formProperties->getBool("retainedModeEnabled", false);
 
     // Initialize the form and all of its child controls
     form->initialize("Form", style, formProperties);
 
-    // Release the theme: its lifetime is controlled by addRef() and release() calls in initialize (above) and ~Control.
-    if (theme != Theme::getDefault())
-    {
-        SAFE_RELEASE(theme);
-    }
-
-    SAFE_DELETE(properties);
+    // The controls hold references to the theme of their styles, and templates keep
+    // their properties and theme for the next form created from the same file.
+    if (!cached)
+        releaseFormTemplate(formTemplate);
 
     return form;
 }
 
+void Form::clearTemplates()
+{
+    for (size_t i = 0, count = __formTemplates.size(); i < count; ++i)
+    {
+        releaseFormTemplate(__formTemplates[i]);
+    }
+    __formTemplates.clear();
+}
+
 Form* Form::create(const char* id, Theme::Style* style, Layout::Type layoutType)
 {
+    MemoryTracker::Scope scope(MemoryTracker::UI);
 	Form* form = new Form();
 	form->_id = id ? id : "";
 	form->_layout = createLayout(layoutType);
@@ -204,7 +293,10 @@ void Form::update(float elapsedTime)
     //  1. First pass updates leaf controls
     //  2. Second pass updates parent controls that depend on child sizes
     if (updateBoundsInternal(Vector2::zero()))
+    {
         updateBoundsInternal(Vector2::zero());
+        _hitGridDirty = true;
+    }
 }
 
 void Form::startBatch(SpriteBatch* batch)
@@ -261,6 +353,27 @@ unsigned int Form::draw(bool wireframe)
         Matrix::createOrthographicOffCenter(0, viewport.width, viewport.height, 0, 0, 1, &_projectionMatrix);
     }
 
+    // Draw the contents of the cached containers that have changed into their frame buffers
+    updateCache(this);
+
+    // In retained mode, draw the geometry generated the last time the controls were drawn while none has changed
+    if (_batched && _retained && !_geometryDirty)
+    {
+        for (size_t i = 0, count = _cachedBatches.size(); i < count; ++i)
+        {
+            const CachedBatch& cached = _cachedBatches[i];
+            cached.batch->setProjectionMatrix(_projectionMatrix);
+            cached.batch->start();
+            if (cached.vertexCount > 0)
+            {
+                cached.batch->_batch->add(&cached.vertices[0], cached.vertices.size(), cached.vertexCount,
+                    cached.indices.empty() ? NULL : &cached.indices[0], cached.indexFormat, cached.indexCount);
+            }
+            cached.batch->finish();
+        }
+        return (unsigned int)_cachedBatches.size();
+    }
+
     // Draw the form
     unsigned int drawCalls = Container::draw(this, _absoluteClipBounds);
 
@@ -268,6 +381,23 @@ unsigned int Form::draw(bool wireframe)
     if (_batched)
     {
         unsigned int batchCount = _batches.size();
+        if (_retained)
+        {
+            // Keep the geometry of the batches before they are drawn, in the order they are drawn in.
+            _cachedBatches.resize(batchCount);
+            for (unsigned int i = 0; i < batchCount; ++i)
+            {
+                const MeshBatch* meshBatch = _batches[i]->_batch;
+                CachedBatch& cached = _cachedBatches[i];
+                cached.batch = _batches[i];
+                cached.vertexCount = meshBatch->_vertexCount;
+                cached.indexCount = meshBatch->_indexCount;
+                cached.vertices.assign(meshBatch->_vertices, meshBatch->_vertices + meshBatch->_vertexCount * meshBatch->_vertexFormat.getVertexSize());
+                cached.indexFormat = meshBatch->_indexFormat;
+                cached.indices.assign(meshBatch->_indices, meshBatch->_indices + meshBatch->_indexCount * (cached.indexFormat == Mesh::INDEX8 ? 1 : (cached.indexFormat == Mesh::INDEX16 ? 2 : 4)));
+            }
+            _geometryDirty = false;
+        }
         for (unsigned int i = 0; i < batchCount; ++i)
             _batches[i]->finish();
         _batches.clear();
@@ -290,10 +420,26 @@ bool Form::isBatchingEnabled() const
 void Form::setBatchingEnabled(bool enabled)
 {
     _batched = enabled;
+    _geometryDirty = true;
+}
+
+bool Form::isRetainedModeEnabled() const
+{
+    return _retained;
+}
+
+void Form::setRetainedModeEnabled(bool enabled)
+{
+    _retained = enabled;
+    _geometryDirty = true;
+    if (!enabled)
+        _cachedBatches.clear();
 }
 
 void Form::updateInternal(float elapsedTime)
 {
+    GP_PROFILE("Form::updateInternal");
+
     pollGamepads();
 
     for (size_t i = 0, size = __forms.size(); i < size; ++i)
@@ -349,7 +495,7 @@ Control* Form::findInputControl(int* x, int* y, bool focus, unsigned int contact
             continue;
 
         // Search for an input control within this form
-        Control* ctrl = findInputControl(form, formX, formY, focus, contactIndex);
+        Control* ctrl = form->findInputControl(formX, formY, focus);
         if (ctrl)
         {
             *x = formX;
@@ -366,35 +512,89 @@ Control* Form::findInputControl(int* x, int* y, bool focus, unsigned int contact
     return NULL;
 }
 
-Control* Form::findInputControl(Control* control, int x, int y, bool focus, unsigned int contactIndex)
+Control* Form::findInputControl(int x, int y, bool focus)
 {
-    if (!(control->_visible && control->isEnabled()))
+    if (_hitGridDirty)
+        buildHitGrid();
+    if (_hitColumns == 0)
         return NULL;
 
-    Control* result = NULL;
+    // Points outside of the form are outside of all of its controls, while points on its
+    // right and bottom edges are within it.
+    float column = (x - _absoluteClipBounds.x) * _hitColumns / _absoluteClipBounds.width;
+    float row = (y - _absoluteClipBounds.y) * _hitRows / _absoluteClipBounds.height;
+    if (column < 0.0f || row < 0.0f || column > _hitColumns || row > _hitRows)
+        return NULL;
 
-    // Does the passed in control's bounds intersect the specified coordinates - and 
-    // does the control support the specified input state?
-    if (control->_consumeInputEvents && (!focus || control->canFocus()))
+    // The last control in the order of the hierarchy is the one on top.
+    unsigned int index = std::min((unsigned int)row, _hitRows - 1) * _hitColumns + std::min((unsigned int)column, _hitColumns - 1);
+    const std::vector<unsigned int>& cell = _hitCells[index];
+    for (size_t i = cell.size(); i > 0; --i)
     {
-        if (control->_absoluteClipBounds.contains(x, y))
-            result = control;
+        Control* control = _hitControls[cell[i - 1]];
+        if (!control->_consumeInputEvents || (focus && !control->canFocus()) || !control->_absoluteClipBounds.contains(x, y))
+            continue;
+
+        // Controls within hidden or disabled containers don't receive input.
+        Control* parent = control;
+        while (parent && parent->_visible && parent->isEnabled())
+            parent = parent->_parent;
+        if (parent == NULL)
+            return control;
     }
+    return NULL;
+}
 
-    // If the control has children, search for an input control inside it that also
-    // supports the above conditions.
+void Form::buildHitGrid()
+{
+    _hitGridDirty = false;
+    _hitControls.clear();
+    _hitCells.clear();
+    _hitColumns = _hitRows = 0;
+    if (_absoluteClipBounds.width <= 0.0f || _absoluteClipBounds.height <= 0.0f)
+        return;
+
+    // Every control is listed, whatever its state, so that only layout changes rebuild the grid.
+    addToHitGrid(this);
+
+    unsigned int size = std::min((unsigned int)std::ceil(std::sqrt((float)_hitControls.size())), HIT_GRID_MAX_SIZE);
+    _hitColumns = _hitRows = std::max(size, 1u);
+    _hitCells.resize(_hitColumns * _hitRows);
+
+    float cellWidth = _absoluteClipBounds.width / _hitColumns;
+    float cellHeight = _absoluteClipBounds.height / _hitRows;
+    for (unsigned int i = 0, count = (unsigned int)_hitControls.size(); i < count; ++i)
+    {
+        const Rectangle& bounds = _hitControls[i]->_absoluteClipBounds;
+        if (bounds.width <= 0.0f || bounds.height <= 0.0f)
+            continue;
+
+        // Points on the right and bottom edges are contained as well.
+        int left = std::max((int)((bounds.x - _absoluteClipBounds.x) / cellWidth), 0);
+        int top = std::max((int)((bounds.y - _absoluteClipBounds.y) / cellHeight), 0);
+        int right = std::min((int)((bounds.right() - _absoluteClipBounds.x) / cellWidth), (int)_hitColumns - 1);
+        int bottom = std::min((int)((bounds.bottom() - _absoluteClipBounds.y) / cellHeight), (int)_hitRows - 1);
+        for (int row = top; row <= bottom; ++row)
+        {
+            for (int column = left; column <= right; ++column)
+            {
+                _hitCells[row * _hitColumns + column].push_back(i);
+            }
+        }
+    }
+}
+
+void Form::addToHitGrid(Control* control)
+{
+    _hitControls.push_back(control);
     if (control->isContainer())
     {
         Container* container = static_cast<Container*>(control);
         for (unsigned int i = 0, childCount = container->getControlCount(); i < childCount; ++i)
         {
-            Control* ctrl = findInputControl(container->getControl(i), x, y, focus, contactIndex);
-            if (ctrl)
-                result = ctrl;
+            addToHitGrid(container->getControl(i));
         }
     }
-
-    return result;
 }
 
 Control* Form::handlePointerPressRelease(int* x, int* y, bool pressed, unsigned int contactIndex)
@@ -36,6 +36,11 @@ public:
 
     /**
      * Creates a form from a .form properties file.
+     *
+     * The parsed properties of the file and its theme are kept as a template the first time
+     * a form is created from a URL, so creating the same form again neither reads nor parses
+     * any file. The templates can be released with clearTemplates, and are not kept when the
+     * 'formTemplates' property of the 'ui' namespace in the game configuration is false.
      * 
      * @param url The URL pointing to the Properties object defining the form. 
      * 
@@ -44,6 +49,15 @@ public:
      */
     static Form* create(const char* url);
 
+    /**
+     * Releases the templates kept for the forms created from files, and their themes.
+     *
+     * Forms that exist keep their own reference to their theme.
+     *
+     * @script{ignore}
+     */
+    static void clearTemplates();
+
     /**
      * Create a new Form.
 	 *
@@ -140,7 +154,42 @@ public:
      */
     void setBatchingEnabled(bool enabled);
 
+    /**
+     * Determines whether retained mode is enabled for this form.
+     *
+     * @return True if retained mode is enabled for this form, false otherwise.
+     */
+    bool isRetainedModeEnabled() const;
+
+    /**
+     * Turns retained mode on or off for this form.
+     *
+     * In retained mode, a batched form keeps the geometry that its controls generated into its
+     * sprite batches, and draws it again instead of drawing its controls for as long as none of
+     * them has changed, so that static forms such as menus and HUDs only cost their batch draws.
+     * Changes made to controls regenerate the geometry the next time the form is drawn, while
+     * changes made directly to the styles of a theme only show once a control of the form changes.
+     *
+     * Retained mode has no effect on forms that have batching disabled.
+     *
+     * @param enabled True to enable retained mode, false otherwise (default).
+     */
+    void setRetainedModeEnabled(bool enabled);
+
 private:
+
+    /**
+     * The geometry that the controls of the form generated into a sprite batch.
+     */
+    struct CachedBatch
+    {
+        SpriteBatch* batch;
+        std::vector<unsigned char> vertices;
+        std::vector<unsigned char> indices;
+        Mesh::IndexFormat indexFormat;
+        unsigned int vertexCount;
+        unsigned int indexCount;
+    };
     
     /**
      * Constructor.
@@ -258,7 +307,24 @@ private:
 
     static Control* findInputControl(int* x, int* y, bool focus, unsigned int contactIndex);
 
-    static Control* findInputControl(Control* control, int x, int y, bool focus, unsigned int contactIndex);
+    /**
+     * Finds the control of the form that receives input at a point, which is the last
+     * control in the order of the hierarchy that contains the point and accepts input.
+     *
+     * The candidates are looked up in a grid of the controls of the form, which is built
+     * the first time a point is tested after the layout of the form changed.
+     */
+    Control* findInputControl(int x, int y, bool focus);
+
+    /**
+     * Rebuilds the grid of the controls of the form.
+     */
+    void buildHitGrid();
+
+    /**
+     * Adds a control and its hierarchy to the grid of the controls of the form.
+     */
+    void addToHitGrid(Control* control);
 
     static Control* handlePointerPressRelease(int* x, int* y, bool pressed, unsigned int contactIndex);
 
@@ -279,6 +345,14 @@ private:
     Matrix _projectionMatrix;           // Projection matrix to be set on SpriteBatch objects when rendering the form
     std::vector<SpriteBatch*> _batches;
     bool _batched;
+    std::vector<CachedBatch> _cachedBatches; // Geometry drawn again in retained mode until a control changes
+    bool _retained;
+    bool _geometryDirty;
+    std::vector<Control*> _hitControls;           // The controls of the form in the order of the hierarchy
+    std::vector<std::vector<unsigned int> > _hitCells; // The indices of the controls overlapping each cell of the hit grid
+    unsigned int _hitColumns;
+    unsigned int _hitRows;
+    bool _hitGridDirty;
 };
 
 }
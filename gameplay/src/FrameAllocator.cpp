@@ -0,0 +1,110 @@
+#include "Base.h"
+#include "FrameAllocator.h"
+#include "Game.h"
+
+namespace gameplay
+{
+
+FrameAllocator::FrameAllocator(size_t blockSize)
+    : _blocks(NULL), _allocatedSize(0), _capacity(0)
+{
+    if (blockSize > 0)
+    {
+        _blocks = createBlock(blockSize);
+        _capacity = _blocks->size;
+    }
+}
+
+FrameAllocator::~FrameAllocator()
+{
+    while (_blocks)
+    {
+        Block* next = _blocks->next;
+        free(_blocks);
+        _blocks = next;
+    }
+}
+
+void* FrameAllocator::allocate(size_t size, size_t alignment)
+{
+    GP_ASSERT(alignment > 0 && (alignment & (alignment - 1)) == 0);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // The data of a block starts right after its header, which keeps pointer alignment.
+    Block* block = _blocks;
+    size_t offset = 0;
+    if (block)
+    {
+        uintptr_t start = (uintptr_t)(block + 1);
+        offset = ((start + block->offset + alignment - 1) & ~(uintptr_t)(alignment - 1)) - start;
+    }
+    if (block == NULL || offset + size > block->size)
+    {
+        // Blocks grow geometrically so that a frame that needs a lot of memory only adds a few blocks.
+        block = createBlock(std::max(size + alignment, _capacity));
+        block->next = _blocks;
+        _blocks = block;
+        _capacity += block->size;
+
+        uintptr_t start = (uintptr_t)(block + 1);
+        offset = ((start + alignment - 1) & ~(uintptr_t)(alignment - 1)) - start;
+    }
+
+    _allocatedSize += offset + size - block->offset;
+    block->offset = offset + size;
+    return (unsigned char*)(block + 1) + offset;
+}
+
+size_t FrameAllocator::getAllocatedSize() const
+{
+    return _allocatedSize;
+}
+
+size_t FrameAllocator::getCapacity() const
+{
+    return _capacity;
+}
+
+void FrameAllocator::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_blocks && _blocks->next)
+    {
+        // Replace all blocks by a single block that can hold everything allocated this frame.
+        while (_blocks)
+        {
+            Block* next = _blocks->next;
+            free(_blocks);
+            _blocks = next;
+        }
+        _blocks = createBlock(_capacity);
+    }
+    else if (_blocks)
+    {
+        _blocks->offset = 0;
+    }
+    _allocatedSize = 0;
+}
+
+void* FrameAllocator::allocateFrame(size_t size, size_t alignment)
+{
+    return Game::getInstance()->getFrameAllocator()->allocate(size, alignment);
+}
+
+FrameAllocator::Block* FrameAllocator::createBlock(size_t size)
+{
+    Block* block = (Block*)malloc(sizeof(Block) + size);
+    if (block == NULL)
+    {
+        GP_ERROR("Failed to allocate a frame allocator block of %u bytes.", (unsigned int)size);
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    block->offset = 0;
+    return block;
+}
+
+}
@@ -0,0 +1,174 @@
+#ifndef FRAMEALLOCATOR_H_
+#define FRAMEALLOCATOR_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a linear allocator for transient memory that only lives until the end of a frame.
+ *
+ * Allocating from the frame allocator only bumps an offset into a block of memory, and
+ * freeing memory does nothing at all. All memory is reclaimed at once when the game calls
+ * reset() at the end of every frame, so memory allocated from it must never be used after
+ * the frame it was allocated in. This makes it suited for scratch data such as temporary
+ * arrays built while measuring or drawing text.
+ *
+ * When a block runs out of space a new block is added. On reset, the blocks are merged
+ * into a single block that is large enough for the peak usage of the previous frame, so
+ * after a few frames no further system allocations are made.
+ *
+ * The Adapter class template allows STL containers to allocate from the frame allocator
+ * of the game, for example std::vector<int, FrameAllocator::Adapter<int> >.
+ *
+ * Allocation is thread-safe.
+ *
+ * @see Game::getFrameAllocator
+ * @script{ignore}
+ */
+class FrameAllocator
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines an STL allocator that allocates from the frame allocator of the game.
+     */
+    template <class T>
+    class Adapter
+    {
+    public:
+
+        typedef T value_type;
+        typedef T* pointer;
+        typedef const T* const_pointer;
+        typedef T& reference;
+        typedef const T& const_reference;
+        typedef size_t size_type;
+        typedef ptrdiff_t difference_type;
+
+        template <class U>
+        struct rebind
+        {
+            typedef Adapter<U> other;
+        };
+
+        Adapter() { }
+
+        template <class U>
+        Adapter(const Adapter<U>&) { }
+
+        T* allocate(size_t count, const void* hint = 0);
+
+        void deallocate(T* p, size_t count) { }
+
+        size_t max_size() const { return ((size_t)-1) / sizeof(T); }
+
+        template <class U, class... Args>
+        void construct(U* p, Args&&... args)
+        {
+#ifdef GP_USE_MEM_LEAK_DETECTION
+#undef new
+            ::new((void*)p) U(std::forward<Args>(args)...);
+#define new DEBUG_NEW
+#else
+            ::new((void*)p) U(std::forward<Args>(args)...);
+#endif
+        }
+
+        template <class U>
+        void destroy(U* p) { p->~U(); }
+
+        template <class U>
+        bool operator==(const Adapter<U>&) const { return true; }
+
+        template <class U>
+        bool operator!=(const Adapter<U>&) const { return false; }
+    };
+
+    /**
+     * Allocates memory that is valid until the end of the current frame.
+     *
+     * @param size The number of bytes to allocate.
+     * @param alignment The alignment of the memory in bytes, which must be a power of two.
+     *
+     * @return The allocated memory.
+     */
+    void* allocate(size_t size, size_t alignment = sizeof(void*));
+
+    /**
+     * Returns the number of bytes allocated since the last reset.
+     *
+     * @return The number of allocated bytes, including padding used for alignment.
+     */
+    size_t getAllocatedSize() const;
+
+    /**
+     * Returns the number of bytes held by the allocator.
+     *
+     * @return The total size of all blocks.
+     */
+    size_t getCapacity() const;
+
+private:
+
+    /**
+     * A block of memory that allocations are taken from.
+     */
+    struct Block
+    {
+        Block* next;
+        size_t size;
+        size_t offset;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param blockSize The size of the first block.
+     */
+    FrameAllocator(size_t blockSize);
+
+    /**
+     * Destructor.
+     */
+    ~FrameAllocator();
+
+    /**
+     * Hidden copy constructor.
+     */
+    FrameAllocator(const FrameAllocator&);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    FrameAllocator& operator=(const FrameAllocator&);
+
+    /**
+     * Releases all memory allocated during the frame.
+     *
+     * Called by the game at the end of every frame.
+     */
+    void reset();
+
+    /**
+     * Allocates memory from the frame allocator of the game.
+     */
+    static void* allocateFrame(size_t size, size_t alignment);
+
+    /**
+     * Allocates a new block with room for at least the given number of bytes.
+     */
+    static Block* createBlock(size_t size);
+
+    Block* _blocks;
+    size_t _allocatedSize;
+    size_t _capacity;
+    std::mutex _mutex;
+};
+
+}
+
+#include "FrameAllocator.inl"
+
+#endif
@@ -0,0 +1,12 @@
+#include "FrameAllocator.h"
+
+namespace gameplay
+{
+
+template <class T>
+T* FrameAllocator::Adapter<T>::allocate(size_t count, const void* hint)
+{
+    return static_cast<T*>(FrameAllocator::allocateFrame(count * sizeof(T), alignof(T) > sizeof(void*) ? alignof(T) : sizeof(void*)));
+}
+
+}
@@ -4,6 +4,17 @@
 
 #define FRAMEBUFFER_ID_DEFAULT "org.gameplay3d.framebuffer.default"
 
+// The attachments of the window system frame buffer, as named by glInvalidateFramebuffer.
+#ifndef GL_COLOR
+#define GL_COLOR 0x1800
+#endif
+#ifndef GL_DEPTH
+#define GL_DEPTH 0x1801
+#endif
+#ifndef GL_STENCIL
+#define GL_STENCIL 0x1802
+#endif
+
 namespace gameplay
 {
 
@@ -13,7 +24,8 @@ FrameBuffer* FrameBuffer::_defaultFrameBuffer = NULL;
 FrameBuffer* FrameBuffer::_currentFrameBuffer = NULL;
 
 FrameBuffer::FrameBuffer(const char* id, unsigned int width, unsigned int height, FrameBufferHandle handle) 
-    : _id(id ? id : ""), _handle(handle), _renderTargets(NULL), _renderTargetCount(0), _depthStencilTarget(NULL)
+    : _id(id ? id : ""), _handle(handle), _renderTargets(NULL), _renderTargetCount(0), _depthStencilTarget(NULL),
+      _discardOnUnbind(0)
 {
 }
 
@@ -292,12 +304,72 @@ bool FrameBuffer::isDefault() const
 
 FrameBuffer* FrameBuffer::bind(GLenum type)
 {
-    GL_ASSERT( glBindFramebuffer(type, _handle) );
     FrameBuffer* previousFrameBuffer = _currentFrameBuffer;
-    _currentFrameBuffer = this;
+    bindHandle(type, _handle, this);
     return previousFrameBuffer;
 }
 
+void FrameBuffer::discard(unsigned int attachments)
+{
+    if (_currentFrameBuffer == this)
+    {
+        discardBound(attachments);
+        return;
+    }
+
+    // The attachments of the bound frame buffer are discarded, so bind this one for the call.
+    GL_ASSERT( glBindFramebuffer(GL_FRAMEBUFFER, _handle) );
+    discardBound(attachments);
+    GL_ASSERT( glBindFramebuffer(GL_FRAMEBUFFER, _currentFrameBuffer->_handle) );
+}
+
+void FrameBuffer::setDiscardOnUnbind(unsigned int attachments)
+{
+    _discardOnUnbind = attachments;
+}
+
+unsigned int FrameBuffer::getDiscardOnUnbind() const
+{
+    return _discardOnUnbind;
+}
+
+void FrameBuffer::discardBound(unsigned int attachments)
+{
+    // Frame buffer objects name their attachments, while the window system frame buffer
+    // names its buffers.
+    GLenum buffers[3];
+    GLsizei count = 0;
+    if (attachments & ATTACHMENT_COLOR)
+        buffers[count++] = _handle ? GL_COLOR_ATTACHMENT0 : GL_COLOR;
+    if (attachments & ATTACHMENT_DEPTH)
+        buffers[count++] = _handle ? GL_DEPTH_ATTACHMENT : GL_DEPTH;
+    if (attachments & ATTACHMENT_STENCIL)
+        buffers[count++] = _handle ? GL_STENCIL_ATTACHMENT : GL_STENCIL;
+    if (count == 0)
+        return;
+
+#if defined(GP_USE_DISCARD_FRAMEBUFFER)
+#ifdef __ANDROID__
+    if (!glDiscardFramebuffer)
+        return;
+#endif
+    GL_ASSERT( glDiscardFramebuffer(GL_FRAMEBUFFER, count, buffers) );
+#elif defined(GLEW_ARB_invalidate_subdata)
+    if (GLEW_ARB_invalidate_subdata)
+        GL_ASSERT( glInvalidateFramebuffer(GL_FRAMEBUFFER, count, buffers) );
+#endif
+}
+
+void FrameBuffer::bindHandle(GLenum type, FrameBufferHandle handle, FrameBuffer* frameBuffer)
+{
+    // Attachments are only discarded when the current frame buffer stops being drawn to.
+    if (_currentFrameBuffer && _currentFrameBuffer != frameBuffer && _currentFrameBuffer->_discardOnUnbind && type == GL_FRAMEBUFFER)
+        _currentFrameBuffer->discardBound(_currentFrameBuffer->_discardOnUnbind);
+
+    GL_ASSERT( glBindFramebuffer(type, handle) );
+    _currentFrameBuffer = frameBuffer;
+}
+
 void FrameBuffer::getScreenshot(Image* image)
 {
     GP_ASSERT( image );
@@ -321,8 +393,7 @@ Image* FrameBuffer::createScreenshot(Image::Format format)
 
 FrameBuffer* FrameBuffer::bindDefault(GLenum type)
 {
-    GL_ASSERT( glBindFramebuffer(type, _defaultFrameBuffer->_handle) );
-    _currentFrameBuffer = _defaultFrameBuffer;
+    bindHandle(type, _defaultFrameBuffer->_handle, _defaultFrameBuffer);
     return _defaultFrameBuffer;
 }
 
@@ -21,6 +21,12 @@ namespace gameplay
  * FrameBuffer::bind and restore it when you are finished drawing to your frame buffer.
  *
  * To bind the default frame buffer, call FrameBuffer::bindDefault.
+ *
+ * On tile based GPUs, the contents of each attachment are loaded into tile memory when
+ * drawing to a frame buffer starts and stored back when it ends. Attachments whose contents
+ * are not needed should be discarded, either with discard() once they are no longer read,
+ * or with setDiscardOnUnbind() so that they are discarded whenever another frame buffer is
+ * bound. Game::clear discards the attachments it clears before clearing them.
  */
 class FrameBuffer : public Ref
 {
@@ -28,6 +34,18 @@ class FrameBuffer : public Ref
 
 public:
 
+    /**
+     * Defines the attachments of a frame buffer whose contents can be discarded.
+     */
+    enum Attachments
+    {
+        ATTACHMENT_COLOR = 1,
+        ATTACHMENT_DEPTH = 2,
+        ATTACHMENT_STENCIL = 4,
+        ATTACHMENT_DEPTH_STENCIL = ATTACHMENT_DEPTH | ATTACHMENT_STENCIL,
+        ATTACHMENT_ALL = ATTACHMENT_COLOR | ATTACHMENT_DEPTH | ATTACHMENT_STENCIL
+    };
+
     /**
      * Creates a new, empty FrameBuffer object.
      *
@@ -161,6 +179,32 @@ public:
      */
     FrameBuffer* bind(GLenum type = GL_FRAMEBUFFER);
 
+    /**
+     * Tells the driver that the contents of the given attachments are no longer needed, so
+     * that they are neither stored to memory nor loaded back the next time this frame buffer
+     * is drawn to. The contents of discarded attachments are undefined.
+     *
+     * This has no effect where neither EXT_discard_framebuffer nor glInvalidateFramebuffer are available.
+     *
+     * @param attachments The attachments to discard, as a combination of Attachments values.
+     */
+    void discard(unsigned int attachments);
+
+    /**
+     * Sets the attachments that are discarded when another frame buffer is bound while this
+     * one is bound, such as a depth buffer that is only needed while drawing to this frame buffer.
+     *
+     * @param attachments The attachments to discard, as a combination of Attachments values, or 0.
+     */
+    void setDiscardOnUnbind(unsigned int attachments);
+
+    /**
+     * Returns the attachments that are discarded when another frame buffer is bound.
+     *
+     * @return The attachments to discard, as a combination of Attachments values.
+     */
+    unsigned int getDiscardOnUnbind() const;
+
     /**
      * Records a screenshot of what is stored on the current FrameBuffer.
      *
@@ -217,11 +261,22 @@ private:
 
     static bool isPowerOfTwo(unsigned int value);
 
+    /**
+     * Discards the given attachments of the bound frame buffer.
+     */
+    void discardBound(unsigned int attachments);
+
+    /**
+     * Binds a frame buffer handle, discarding the attachments of the current frame buffer that are discarded on unbind.
+     */
+    static void bindHandle(GLenum type, FrameBufferHandle handle, FrameBuffer* frameBuffer);
+
     std::string _id;
     FrameBufferHandle _handle;
     RenderTarget** _renderTargets;
     unsigned int _renderTargetCount;
     DepthStencilTarget* _depthStencilTarget;
+    unsigned int _discardOnUnbind;
 
     static unsigned int _maxRenderTargets;
     static std::vector<FrameBuffer*> _frameBuffers;
@@ -2,6 +2,7 @@
 #include "Frustum.h"
 #include "BoundingSphere.h"
 #include "BoundingBox.h"
+#include "MathUtil.h"
 
 namespace gameplay
 {
@@ -120,6 +121,61 @@ bool Frustum::intersects(const BoundingBox& box) const
     return box.intersects(*this);
 }
 
+// The number of bounds that the array intersection tests cull at a time
+#define FRUSTUM_INTERSECT_BATCH 256
+
+unsigned int Frustum::intersects(const BoundingSphere* spheres, unsigned int count, bool* results, unsigned int stride) const
+{
+    GP_ASSERT(count == 0 || (spheres && results));
+
+    if (stride == 0)
+        stride = sizeof(BoundingSphere);
+    unsigned int visibility[FRUSTUM_INTERSECT_BATCH / 32];
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < count; i += FRUSTUM_INTERSECT_BATCH)
+    {
+        unsigned int batch = min(count - i, (unsigned int)FRUSTUM_INTERSECT_BATCH);
+        visible += cull((const BoundingSphere*)((const char*)spheres + (size_t)i * stride), batch, visibility, NULL, stride);
+        getResults(visibility, batch, results + i);
+    }
+    return visible;
+}
+
+unsigned int Frustum::intersects(const BoundingBox* boxes, unsigned int count, bool* results, unsigned int stride) const
+{
+    GP_ASSERT(count == 0 || (boxes && results));
+
+    if (stride == 0)
+        stride = sizeof(BoundingBox);
+    unsigned int visibility[FRUSTUM_INTERSECT_BATCH / 32];
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < count; i += FRUSTUM_INTERSECT_BATCH)
+    {
+        unsigned int batch = min(count - i, (unsigned int)FRUSTUM_INTERSECT_BATCH);
+        visible += cull((const BoundingBox*)((const char*)boxes + (size_t)i * stride), batch, visibility, NULL, stride);
+        getResults(visibility, batch, results + i);
+    }
+    return visible;
+}
+
+unsigned int Frustum::cull(const BoundingSphere* spheres, unsigned int count, unsigned int* visibility, unsigned char* planeCache, unsigned int stride) const
+{
+    GP_ASSERT(count == 0 || (spheres && visibility));
+
+    float planes[MATHUTIL_PLANE_COUNT * 4];
+    getPlanes(planes);
+    return MathUtil::cullSpheres(planes, (const float*)spheres, stride ? stride : sizeof(BoundingSphere), visibility, planeCache, count);
+}
+
+unsigned int Frustum::cull(const BoundingBox* boxes, unsigned int count, unsigned int* visibility, unsigned char* planeCache, unsigned int stride) const
+{
+    GP_ASSERT(count == 0 || (boxes && visibility));
+
+    float planes[MATHUTIL_PLANE_COUNT * 4];
+    getPlanes(planes);
+    return MathUtil::cullBoxes(planes, (const float*)boxes, stride ? stride : sizeof(BoundingBox), visibility, planeCache, count);
+}
+
 float Frustum::intersects(const Plane& plane) const
 {
     return plane.intersects(*this);
@@ -151,6 +207,26 @@ void Frustum::updatePlanes()
     _right.set(Vector3(_matrix.m[3] - _matrix.m[0], _matrix.m[7] - _matrix.m[4], _matrix.m[11] - _matrix.m[8]), _matrix.m[15] - _matrix.m[12]);
 }
 
+void Frustum::getPlanes(float* planes) const
+{
+    // The near and far planes are tested last, since most bounds that are culled are outside the sides.
+    const Plane* frustumPlanes[MATHUTIL_PLANE_COUNT] = { &_left, &_right, &_bottom, &_top, &_near, &_far };
+    for (unsigned int i = 0; i < MATHUTIL_PLANE_COUNT; ++i)
+    {
+        const Vector3& normal = frustumPlanes[i]->getNormal();
+        planes[i * 4] = normal.x;
+        planes[i * 4 + 1] = normal.y;
+        planes[i * 4 + 2] = normal.z;
+        planes[i * 4 + 3] = frustumPlanes[i]->getDistance();
+    }
+}
+
+void Frustum::getResults(const unsigned int* visibility, unsigned int count, bool* results)
+{
+    for (unsigned int i = 0; i < count; ++i)
+        results[i] = (visibility[i >> 5] & (1u << (i & 31))) != 0;
+}
+
 void Frustum::set(const Matrix& matrix)
 {
     _matrix.set(matrix);
@@ -171,6 +171,71 @@ public:
      */
     bool intersects(const BoundingBox& box) const;
 
+    /**
+     * Tests whether this frustum intersects each bounding sphere of an array.
+     *
+     * The spheres can be members of larger elements, such as the bounds of the nodes
+     * or particles of an array, by passing the size of those elements as the stride.
+     *
+     * @param spheres The first bounding sphere to test intersection with.
+     * @param count The number of bounding spheres to test.
+     * @param results Populated with whether each bounding sphere intersects this frustum.
+     * @param stride The number of bytes from one sphere to the next in spheres, or 0 if they are packed.
+     *
+     * @return The number of bounding spheres that intersect this frustum.
+     * @script{ignore}
+     */
+    unsigned int intersects(const BoundingSphere* spheres, unsigned int count, bool* results, unsigned int stride = 0) const;
+
+    /**
+     * Tests whether this frustum intersects each bounding box of an array.
+     *
+     * @param boxes The first bounding box to test intersection with.
+     * @param count The number of bounding boxes to test.
+     * @param results Populated with whether each bounding box intersects this frustum.
+     * @param stride The number of bytes from one box to the next in boxes, or 0 if they are packed.
+     *
+     * @return The number of bounding boxes that intersect this frustum.
+     * @script{ignore}
+     */
+    unsigned int intersects(const BoundingBox* boxes, unsigned int count, bool* results, unsigned int stride = 0) const;
+
+    /**
+     * Culls an array of bounding spheres against this frustum, and sets bit i % 32 of
+     * visibility[i / 32] for each sphere i that intersects it. The other bits are cleared.
+     *
+     * The spheres are tested several at a time with the SIMD instructions of the platform.
+     * When a plane cache is given, it holds a byte per sphere with the index of the plane
+     * that culled the sphere the last time it was culled, which is tested first. Since
+     * bounds and cameras move little from one frame to the next, the same plane usually
+     * culls the sphere again, and the other planes are not tested. The cache should be
+     * kept with the spheres between frames, and zeroed when it is created.
+     *
+     * @param spheres The first bounding sphere to cull.
+     * @param count The number of bounding spheres to cull.
+     * @param visibility The visibility mask to populate, of (count + 31) / 32 words.
+     * @param planeCache The plane cache of count bytes to test first and update, or NULL.
+     * @param stride The number of bytes from one sphere to the next in spheres, or 0 if they are packed.
+     *
+     * @return The number of bounding spheres that intersect this frustum.
+     * @script{ignore}
+     */
+    unsigned int cull(const BoundingSphere* spheres, unsigned int count, unsigned int* visibility, unsigned char* planeCache = NULL, unsigned int stride = 0) const;
+
+    /**
+     * Culls an array of bounding boxes against this frustum, like the bounding sphere version.
+     *
+     * @param boxes The first bounding box to cull.
+     * @param count The number of bounding boxes to cull.
+     * @param visibility The visibility mask to populate, of (count + 31) / 32 words.
+     * @param planeCache The plane cache of count bytes to test first and update, or NULL.
+     * @param stride The number of bytes from one box to the next in boxes, or 0 if they are packed.
+     *
+     * @return The number of bounding boxes that intersect this frustum.
+     * @script{ignore}
+     */
+    unsigned int cull(const BoundingBox* boxes, unsigned int count, unsigned int* visibility, unsigned char* planeCache = NULL, unsigned int stride = 0) const;
+
     /**
      * Tests whether this frustum intersects the specified plane.
      *
@@ -214,6 +279,17 @@ private:
      */
     void updatePlanes();
 
+    /**
+     * Stores the normal and distance of each plane of this frustum, in the order
+     * that the bounds of the array tests are tested against them.
+     */
+    void getPlanes(float* planes) const;
+
+    /**
+     * Expands the bits of a visibility mask into an array of results.
+     */
+    static void getResults(const unsigned int* visibility, unsigned int count, bool* results);
+
     Plane _near;
     Plane _far;
     Plane _bottom;
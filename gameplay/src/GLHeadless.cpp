@@ -0,0 +1,643 @@
+#ifdef GP_HEADLESS
+
+#include "Base.h"
+
+// The last name given to an object, so that every object has a different name.
+static GLuint __lastName = 0;
+
+// The buffer bound to each target, and the system memory backing each buffer for mapping.
+static std::map<GLenum, GLuint> __boundBuffers;
+static std::map<GLuint, std::vector<unsigned char> > __buffers;
+
+static void generateNames(GLsizei n, GLuint* names)
+{
+    for (GLsizei i = 0; i < n; ++i)
+        names[i] = ++__lastName;
+}
+
+static void resizeBuffer(GLenum target, GLsizeiptr size)
+{
+    std::map<GLenum, GLuint>::const_iterator itr = __boundBuffers.find(target);
+    if (itr != __boundBuffers.end() && itr->second != 0)
+        __buffers[itr->second].resize((size_t)size);
+}
+
+static void* mapBuffer(GLenum target, GLintptr offset)
+{
+    std::map<GLenum, GLuint>::const_iterator itr = __boundBuffers.find(target);
+    if (itr == __boundBuffers.end() || itr->second == 0)
+        return NULL;
+
+    std::vector<unsigned char>& memory = __buffers[itr->second];
+    return (size_t)offset < memory.size() ? &memory[(size_t)offset] : NULL;
+}
+
+static void getActive(GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    if (length)
+        *length = 0;
+    *size = 0;
+    *type = 0;
+    if (bufSize > 0)
+        name[0] = '\0';
+}
+
+static void getInfoLog(GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    if (length)
+        *length = 0;
+    if (bufSize > 0)
+        infoLog[0] = '\0';
+}
+
+void glActiveTexture(GLenum texture)
+{
+}
+
+void glAttachShader(GLuint program, GLuint shader)
+{
+}
+
+void glBeginQuery(GLenum target, GLuint id)
+{
+}
+
+void glBeginTransformFeedback(GLenum primitiveMode)
+{
+}
+
+void glBindAttribLocation(GLuint program, GLuint index, const GLchar* name)
+{
+}
+
+void glBindBuffer(GLenum target, GLuint buffer)
+{
+    __boundBuffers[target] = buffer;
+}
+
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer)
+{
+}
+
+void glBindFramebuffer(GLenum target, GLuint framebuffer)
+{
+}
+
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer)
+{
+}
+
+void glBindTexture(GLenum target, GLuint texture)
+{
+}
+
+void glBindVertexArray(GLuint array)
+{
+}
+
+void glBlendFunc(GLenum sfactor, GLenum dfactor)
+{
+}
+
+void glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+}
+
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+{
+    resizeBuffer(target, size);
+}
+
+void glBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+{
+    resizeBuffer(target, size);
+}
+
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+{
+}
+
+GLenum glCheckFramebufferStatus(GLenum target)
+{
+    return GL_FRAMEBUFFER_COMPLETE;
+}
+
+void glClear(GLbitfield mask)
+{
+}
+
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+{
+}
+
+void glClearDepth(GLdouble depth)
+{
+}
+
+void glClearDepthf(GLfloat d)
+{
+}
+
+void glClearStencil(GLint s)
+{
+}
+
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+{
+    return GL_ALREADY_SIGNALED;
+}
+
+void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+}
+
+void glCompileShader(GLuint shader)
+{
+}
+
+void glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+{
+}
+
+GLuint glCreateProgram()
+{
+    return ++__lastName;
+}
+
+GLuint glCreateShader(GLenum type)
+{
+    return ++__lastName;
+}
+
+void glCullFace(GLenum mode)
+{
+}
+
+void glDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+    for (GLsizei i = 0; i < n; ++i)
+        __buffers.erase(buffers[i]);
+}
+
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+{
+}
+
+void glDeleteProgram(GLuint program)
+{
+}
+
+void glDeleteQueries(GLsizei n, const GLuint* ids)
+{
+}
+
+void glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+{
+}
+
+void glDeleteShader(GLuint shader)
+{
+}
+
+void glDeleteSync(GLsync sync)
+{
+}
+
+void glDeleteTextures(GLsizei n, const GLuint* textures)
+{
+}
+
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays)
+{
+}
+
+void glDepthFunc(GLenum func)
+{
+}
+
+void glDepthMask(GLboolean flag)
+{
+}
+
+void glDisable(GLenum cap)
+{
+}
+
+void glDisableVertexAttribArray(GLuint index)
+{
+}
+
+void glDrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+}
+
+void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount)
+{
+}
+
+void glDrawBuffer(GLenum buf)
+{
+}
+
+void glDrawBuffers(GLsizei n, const GLenum* bufs)
+{
+}
+
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+}
+
+void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount)
+{
+}
+
+void glEnable(GLenum cap)
+{
+}
+
+void glEnableVertexAttribArray(GLuint index)
+{
+}
+
+void glEndQuery(GLenum target)
+{
+}
+
+void glEndTransformFeedback()
+{
+}
+
+GLsync glFenceSync(GLenum condition, GLbitfield flags)
+{
+    return (GLsync)(size_t)++__lastName;
+}
+
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+{
+}
+
+void glFramebufferTexture1D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+}
+
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+}
+
+void glFramebufferTexture3D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset)
+{
+}
+
+void glFramebufferTextureLayer(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer)
+{
+}
+
+void glFrontFace(GLenum mode)
+{
+}
+
+void glGenBuffers(GLsizei n, GLuint* buffers)
+{
+    generateNames(n, buffers);
+}
+
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers)
+{
+    generateNames(n, framebuffers);
+}
+
+void glGenQueries(GLsizei n, GLuint* ids)
+{
+    generateNames(n, ids);
+}
+
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+{
+    generateNames(n, renderbuffers);
+}
+
+void glGenTextures(GLsizei n, GLuint* textures)
+{
+    generateNames(n, textures);
+}
+
+void glGenVertexArrays(GLsizei n, GLuint* arrays)
+{
+    generateNames(n, arrays);
+}
+
+void glGenerateMipmap(GLenum target)
+{
+}
+
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getActive(bufSize, length, size, type, name);
+}
+
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name)
+{
+    getActive(bufSize, length, size, type, name);
+}
+
+GLint glGetAttribLocation(GLuint program, const GLchar* name)
+{
+    return -1;
+}
+
+GLenum glGetError()
+{
+    return GL_NO_ERROR;
+}
+
+void glGetFramebufferAttachmentParameteriv(GLenum target, GLenum attachment, GLenum pname, GLint* params)
+{
+    *params = 0;
+}
+
+void glGetIntegerv(GLenum pname, GLint* data)
+{
+    switch (pname)
+    {
+    case GL_MAJOR_VERSION:
+        *data = 3;
+        break;
+    case GL_MINOR_VERSION:
+        *data = 0;
+        break;
+    case GL_MAX_TEXTURE_SIZE:
+        *data = 16384;
+        break;
+    case GL_MAX_VERTEX_ATTRIBS:
+    case GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS:
+        *data = 16;
+        break;
+    case GL_MAX_COLOR_ATTACHMENTS:
+        *data = 8;
+        break;
+    default:
+        *data = 0;
+        break;
+    }
+}
+
+void glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+{
+    if (length)
+        *length = 0;
+    *binaryFormat = 0;
+}
+
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    getInfoLog(bufSize, length, infoLog);
+}
+
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params)
+{
+    *params = (pname == GL_LINK_STATUS) ? GL_TRUE : 0;
+}
+
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+{
+    *params = 0;
+}
+
+void glGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params)
+{
+    *params = (pname == GL_QUERY_RESULT_AVAILABLE) ? GL_TRUE : 0;
+}
+
+void glGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params)
+{
+    *params = 0;
+}
+
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+{
+    getInfoLog(bufSize, length, infoLog);
+}
+
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params)
+{
+    *params = (pname == GL_COMPILE_STATUS) ? GL_TRUE : 0;
+}
+
+const GLubyte* glGetString(GLenum name)
+{
+    switch (name)
+    {
+    case GL_VENDOR:
+        return (const GLubyte*)"gameplay";
+    case GL_RENDERER:
+        return (const GLubyte*)"headless";
+    case GL_VERSION:
+        return (const GLubyte*)"3.0 headless";
+    default:
+        return (const GLubyte*)"";
+    }
+}
+
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName)
+{
+    return GL_INVALID_INDEX;
+}
+
+GLint glGetUniformLocation(GLuint program, const GLchar* name)
+{
+    return -1;
+}
+
+void glHint(GLenum target, GLenum mode)
+{
+}
+
+void glInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments)
+{
+}
+
+GLboolean glIsEnabled(GLenum cap)
+{
+    return GL_FALSE;
+}
+
+GLboolean glIsFramebuffer(GLuint framebuffer)
+{
+    return GL_FALSE;
+}
+
+GLboolean glIsRenderbuffer(GLuint renderbuffer)
+{
+    return GL_FALSE;
+}
+
+GLboolean glIsTexture(GLuint texture)
+{
+    return GL_FALSE;
+}
+
+GLboolean glIsVertexArray(GLuint array)
+{
+    return GL_FALSE;
+}
+
+void glLinkProgram(GLuint program)
+{
+}
+
+void* glMapBuffer(GLenum target, GLenum access)
+{
+    return mapBuffer(target, 0);
+}
+
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+{
+    return mapBuffer(target, offset);
+}
+
+void glPixelStorei(GLenum pname, GLint param)
+{
+}
+
+void glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+{
+}
+
+void glProgramParameteri(GLuint program, GLenum pname, GLint value)
+{
+}
+
+void glQueryCounter(GLuint id, GLenum target)
+{
+}
+
+void glReadBuffer(GLenum src)
+{
+}
+
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels)
+{
+}
+
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+{
+}
+
+void glRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height)
+{
+}
+
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+}
+
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const*string, const GLint* length)
+{
+}
+
+void glStencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+}
+
+void glStencilMask(GLuint mask)
+{
+}
+
+void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass)
+{
+}
+
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+{
+}
+
+void glTexParameteri(GLenum target, GLenum pname, GLint param)
+{
+}
+
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+{
+}
+
+void glTransformFeedbackVaryings(GLuint program, GLsizei count, const GLchar* const*varyings, GLenum bufferMode)
+{
+}
+
+void glUniform1f(GLint location, GLfloat v0)
+{
+}
+
+void glUniform1fv(GLint location, GLsizei count, const GLfloat* value)
+{
+}
+
+void glUniform1i(GLint location, GLint v0)
+{
+}
+
+void glUniform1iv(GLint location, GLsizei count, const GLint* value)
+{
+}
+
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1)
+{
+}
+
+void glUniform2fv(GLint location, GLsizei count, const GLfloat* value)
+{
+}
+
+void glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2)
+{
+}
+
+void glUniform3fv(GLint location, GLsizei count, const GLfloat* value)
+{
+}
+
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3)
+{
+}
+
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value)
+{
+}
+
+void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding)
+{
+}
+
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value)
+{
+}
+
+GLboolean glUnmapBuffer(GLenum target)
+{
+    return GL_TRUE;
+}
+
+void glUseProgram(GLuint program)
+{
+}
+
+void glVertexAttrib1f(GLuint index, GLfloat x)
+{
+}
+
+void glVertexAttrib4fv(GLuint index, const GLfloat* v)
+{
+}
+
+void glVertexAttribDivisor(GLuint index, GLuint divisor)
+{
+}
+
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+{
+}
+
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+}
+
+#endif
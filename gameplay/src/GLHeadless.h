@@ -0,0 +1,334 @@
+#ifndef GLHEADLESS_H_
+#define GLHEADLESS_H_
+
+#include <cstddef>
+
+/**
+ * Declares the subset of OpenGL used by gameplay for headless builds, which are compiled with
+ * GP_HEADLESS and have neither a window nor a GL context.
+ *
+ * The functions do not draw anything. Objects are given unique names, shaders always compile
+ * and link with no active uniforms or attributes, frame buffers are always complete and
+ * mapped buffers are backed by system memory, so that meshes, materials and scenes can be
+ * loaded and simulated on machines without a GPU.
+ */
+
+typedef void GLvoid;
+typedef unsigned int GLenum;
+typedef unsigned char GLboolean;
+typedef unsigned int GLbitfield;
+typedef signed char GLbyte;
+typedef short GLshort;
+typedef int GLint;
+typedef int GLsizei;
+typedef unsigned char GLubyte;
+typedef unsigned short GLushort;
+typedef unsigned int GLuint;
+typedef unsigned short GLhalf;
+typedef float GLfloat;
+typedef float GLclampf;
+typedef double GLdouble;
+typedef double GLclampd;
+typedef char GLchar;
+typedef ptrdiff_t GLintptr;
+typedef ptrdiff_t GLsizeiptr;
+typedef long long GLint64;
+typedef unsigned long long GLuint64;
+typedef struct __GLsync* GLsync;
+
+#define GL_ACTIVE_ATTRIBUTES               0x8B89
+#define GL_ACTIVE_ATTRIBUTE_MAX_LENGTH     0x8B8A
+#define GL_ACTIVE_UNIFORMS                 0x8B86
+#define GL_ACTIVE_UNIFORM_MAX_LENGTH       0x8B87
+#define GL_ALPHA                           0x1906
+#define GL_ALREADY_SIGNALED                0x911A
+#define GL_ALWAYS                          0x0207
+#define GL_ARRAY_BUFFER                    0x8892
+#define GL_BACK                            0x0405
+#define GL_BGRA_EXT                        0x80E1
+#define GL_BLEND                           0x0BE2
+#define GL_BYTE                            0x1400
+#define GL_CCW                             0x0901
+#define GL_CLAMP_TO_EDGE                   0x812F
+#define GL_COLOR                           0x1800
+#define GL_COLOR_ATTACHMENT0               0x8CE0
+#define GL_COLOR_BUFFER_BIT                0x00004000
+#define GL_COMPILE_STATUS                  0x8B81
+#define GL_COMPLETION_STATUS_KHR           0x91B1
+#define GL_COMPRESSED_RGB8_ETC2            0x9274
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT   0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT   0x83F2
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT   0x83F3
+#define GL_COMPRESSED_TEXTURE_FORMATS      0x86A3
+#define GL_CONSTANT_ALPHA                  0x8003
+#define GL_CULL_FACE                       0x0B44
+#define GL_CW                              0x0900
+#define GL_DECR                            0x1E03
+#define GL_DECR_WRAP                       0x8508
+#define GL_DEPTH                           0x1801
+#define GL_DEPTH24_STENCIL8                0x88F0
+#define GL_DEPTH_ATTACHMENT                0x8D00
+#define GL_DEPTH_BUFFER_BIT                0x00000100
+#define GL_DEPTH_COMPONENT                 0x1902
+#define GL_DEPTH_COMPONENT16               0x81A5
+#define GL_DEPTH_COMPONENT24               0x81A6
+#define GL_DEPTH_COMPONENT32F              0x8CAC
+#define GL_DEPTH_TEST                      0x0B71
+#define GL_DST_ALPHA                       0x0304
+#define GL_DST_COLOR                       0x0306
+#define GL_DYNAMIC_COPY                    0x88EA
+#define GL_DYNAMIC_DRAW                    0x88E8
+#define GL_ELEMENT_ARRAY_BUFFER            0x8893
+#define GL_EQUAL                           0x0202
+#define GL_EXTENSIONS                      0x1F03
+#define GL_FALSE                           0
+#define GL_FLOAT                           0x1406
+#define GL_FRAGMENT_SHADER                 0x8B30
+#define GL_FRAMEBUFFER                     0x8D40
+#define GL_FRAMEBUFFER_BINDING             0x8CA6
+#define GL_FRAMEBUFFER_COMPLETE            0x8CD5
+#define GL_FRONT                           0x0404
+#define GL_FRONT_AND_BACK                  0x0408
+#define GL_GENERATE_MIPMAP                 0x8191
+#define GL_GENERATE_MIPMAP_HINT            0x8192
+#define GL_GEQUAL                          0x0206
+#define GL_GREATER                         0x0204
+#define GL_HALF_FLOAT                      0x140B
+#define GL_INCR                            0x1E02
+#define GL_INCR_WRAP                       0x8507
+#define GL_INFO_LOG_LENGTH                 0x8B84
+#define GL_INTERLEAVED_ATTRIBS             0x8C8C
+#define GL_INT_2_10_10_10_REV              0x8D9F
+#define GL_INVALID_INDEX                   0xFFFFFFFFu
+#define GL_INVERT                          0x150A
+#define GL_KEEP                            0x1E00
+#define GL_LEQUAL                          0x0203
+#define GL_LESS                            0x0201
+#define GL_LINEAR                          0x2601
+#define GL_LINEAR_MIPMAP_LINEAR            0x2703
+#define GL_LINEAR_MIPMAP_NEAREST           0x2701
+#define GL_LINES                           0x0001
+#define GL_LINE_LOOP                       0x0002
+#define GL_LINE_STRIP                      0x0003
+#define GL_LINK_STATUS                     0x8B82
+#define GL_MAJOR_VERSION                   0x821B
+#define GL_MAP_COHERENT_BIT                0x0080
+#define GL_MAP_INVALIDATE_BUFFER_BIT       0x0008
+#define GL_MAP_PERSISTENT_BIT              0x0040
+#define GL_MAP_UNSYNCHRONIZED_BIT          0x0020
+#define GL_MAP_WRITE_BIT                   0x0002
+#define GL_MAX_COLOR_ATTACHMENTS           0x8CDF
+#define GL_MAX_TEXTURE_SIZE                0x0D33
+#define GL_MAX_VERTEX_ATTRIBS              0x8869
+#define GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS  0x8B4C
+#define GL_MINOR_VERSION                   0x821C
+#define GL_MULTISAMPLE                     0x809D
+#define GL_NEAREST                         0x2600
+#define GL_NEAREST_MIPMAP_LINEAR           0x2702
+#define GL_NEAREST_MIPMAP_NEAREST          0x2700
+#define GL_NEVER                           0x0200
+#define GL_NICEST                          0x1102
+#define GL_NONE                            0
+#define GL_NOTEQUAL                        0x0205
+#define GL_NO_ERROR                        0
+#define GL_NUM_COMPRESSED_TEXTURE_FORMATS  0x86A2
+#define GL_NUM_PROGRAM_BINARY_FORMATS      0x87FE
+#define GL_ONE                             1
+#define GL_ONE_MINUS_CONSTANT_ALPHA        0x8004
+#define GL_ONE_MINUS_DST_ALPHA             0x0305
+#define GL_ONE_MINUS_DST_COLOR             0x0307
+#define GL_ONE_MINUS_SRC_ALPHA             0x0303
+#define GL_ONE_MINUS_SRC_COLOR             0x0301
+#define GL_PIXEL_UNPACK_BUFFER             0x88EC
+#define GL_POINTS                          0x0000
+#define GL_PROGRAM_BINARY_LENGTH           0x8741
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#define GL_QUERY_RESULT                    0x8866
+#define GL_QUERY_RESULT_AVAILABLE          0x8867
+#define GL_RASTERIZER_DISCARD              0x8C89
+#define GL_RENDERBUFFER                    0x8D41
+#define GL_RENDERER                        0x1F01
+#define GL_REPEAT                          0x2901
+#define GL_REPLACE                         0x1E01
+#define GL_RGB                             0x1907
+#define GL_RGBA                            0x1908
+#define GL_RGBA32F                         0x8814
+#define GL_SAMPLER_2D                      0x8B5E
+#define GL_SAMPLER_CUBE                    0x8B60
+#define GL_SAMPLES_PASSED                  0x8914
+#define GL_SCISSOR_TEST                    0x0C11
+#define GL_SHORT                           0x1402
+#define GL_SRC_ALPHA                       0x0302
+#define GL_SRC_ALPHA_SATURATE              0x0308
+#define GL_SRC_COLOR                       0x0300
+#define GL_STATIC_DRAW                     0x88E4
+#define GL_STENCIL                         0x1802
+#define GL_STENCIL_ATTACHMENT              0x8D20
+#define GL_STENCIL_BUFFER_BIT              0x00000400
+#define GL_STENCIL_INDEX8                  0x8D48
+#define GL_STENCIL_TEST                    0x0B90
+#define GL_STREAM_DRAW                     0x88E0
+#define GL_SYNC_FLUSH_COMMANDS_BIT         0x00000001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE      0x9117
+#define GL_TEXTURE0                        0x84C0
+#define GL_TEXTURE_2D                      0x0DE1
+#define GL_TEXTURE_COMPARE_MODE            0x884C
+#define GL_TEXTURE_CUBE_MAP                0x8513
+#define GL_TEXTURE_CUBE_MAP_POSITIVE_X     0x8515
+#define GL_TEXTURE_MAG_FILTER              0x2800
+#define GL_TEXTURE_MIN_FILTER              0x2801
+#define GL_TEXTURE_WRAP_R                  0x8072
+#define GL_TEXTURE_WRAP_S                  0x2802
+#define GL_TEXTURE_WRAP_T                  0x2803
+#define GL_TIMESTAMP                       0x8E28
+#define GL_TIME_ELAPSED                    0x88BF
+#define GL_TIME_ELAPSED_EXT                0x88BF
+#define GL_TRANSFORM_FEEDBACK_BUFFER       0x8C8E
+#define GL_TRIANGLES                       0x0004
+#define GL_TRIANGLE_STRIP                  0x0005
+#define GL_TRUE                            1
+#define GL_UNIFORM_BUFFER                  0x8A11
+#define GL_UNPACK_ALIGNMENT                0x0CF5
+#define GL_UNSIGNED_BYTE                   0x1401
+#define GL_UNSIGNED_INT                    0x1405
+#define GL_UNSIGNED_SHORT                  0x1403
+#define GL_UNSIGNED_SHORT_4_4_4_4          0x8033
+#define GL_UNSIGNED_SHORT_5_5_5_1          0x8034
+#define GL_UNSIGNED_SHORT_5_6_5            0x8363
+#define GL_VENDOR                          0x1F00
+#define GL_VERSION                         0x1F02
+#define GL_VERTEX_SHADER                   0x8B31
+#define GL_WRITE_ONLY                      0x88B9
+#define GL_ZERO                            0
+
+void glActiveTexture(GLenum texture);
+void glAttachShader(GLuint program, GLuint shader);
+void glBeginQuery(GLenum target, GLuint id);
+void glBeginTransformFeedback(GLenum primitiveMode);
+void glBindAttribLocation(GLuint program, GLuint index, const GLchar* name);
+void glBindBuffer(GLenum target, GLuint buffer);
+void glBindBufferBase(GLenum target, GLuint index, GLuint buffer);
+void glBindFramebuffer(GLenum target, GLuint framebuffer);
+void glBindRenderbuffer(GLenum target, GLuint renderbuffer);
+void glBindTexture(GLenum target, GLuint texture);
+void glBindVertexArray(GLuint array);
+void glBlendFunc(GLenum sfactor, GLenum dfactor);
+void glBlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+void glBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+void glBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+void glBufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+GLenum glCheckFramebufferStatus(GLenum target);
+void glClear(GLbitfield mask);
+void glClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void glClearDepth(GLdouble depth);
+void glClearDepthf(GLfloat d);
+void glClearStencil(GLint s);
+GLenum glClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout);
+void glColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+void glCompileShader(GLuint shader);
+void glCompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data);
+GLuint glCreateProgram();
+GLuint glCreateShader(GLenum type);
+void glCullFace(GLenum mode);
+void glDeleteBuffers(GLsizei n, const GLuint* buffers);
+void glDeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+void glDeleteProgram(GLuint program);
+void glDeleteQueries(GLsizei n, const GLuint* ids);
+void glDeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers);
+void glDeleteShader(GLuint shader);
+void glDeleteSync(GLsync sync);
+void glDeleteTextures(GLsizei n, const GLuint* textures);
+void glDeleteVertexArrays(GLsizei n, const GLuint* arrays);
+void glDepthFunc(GLenum func);
+void glDepthMask(GLboolean flag);
+void glDisable(GLenum cap);
+void glDisableVertexAttribArray(GLuint index);
+void glDrawArrays(GLenum mode, GLint first, GLsizei count);
+void glDrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+void glDrawBuffer(GLenum buf);
+void glDrawBuffers(GLsizei n, const GLenum* bufs);
+void glDrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices);
+void glDrawElementsInstanced(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount);
+void glEnable(GLenum cap);
+void glEnableVertexAttribArray(GLuint index);
+void glEndQuery(GLenum target);
+void glEndTransformFeedback();
+GLsync glFenceSync(GLenum condition, GLbitfield flags);
+void glFramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+void glFramebufferTexture1D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+void glFramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+void glFramebufferTexture3D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level, GLint zoffset);
+void glFramebufferTextureLayer(GLenum target, GLenum attachment, GLuint texture, GLint level, GLint layer);
+void glFrontFace(GLenum mode);
+void glGenBuffers(GLsizei n, GLuint* buffers);
+void glGenFramebuffers(GLsizei n, GLuint* framebuffers);
+void glGenQueries(GLsizei n, GLuint* ids);
+void glGenRenderbuffers(GLsizei n, GLuint* renderbuffers);
+void glGenTextures(GLsizei n, GLuint* textures);
+void glGenVertexArrays(GLsizei n, GLuint* arrays);
+void glGenerateMipmap(GLenum target);
+void glGetActiveAttrib(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+void glGetActiveUniform(GLuint program, GLuint index, GLsizei bufSize, GLsizei* length, GLint* size, GLenum* type, GLchar* name);
+GLint glGetAttribLocation(GLuint program, const GLchar* name);
+GLenum glGetError();
+void glGetFramebufferAttachmentParameteriv(GLenum target, GLenum attachment, GLenum pname, GLint* params);
+void glGetIntegerv(GLenum pname, GLint* data);
+void glGetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+void glGetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void glGetProgramiv(GLuint program, GLenum pname, GLint* params);
+void glGetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params);
+void glGetQueryObjectuiv(GLuint id, GLenum pname, GLuint* params);
+void glGetRenderbufferParameteriv(GLenum target, GLenum pname, GLint* params);
+void glGetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void glGetShaderiv(GLuint shader, GLenum pname, GLint* params);
+const GLubyte* glGetString(GLenum name);
+GLuint glGetUniformBlockIndex(GLuint program, const GLchar* uniformBlockName);
+GLint glGetUniformLocation(GLuint program, const GLchar* name);
+void glHint(GLenum target, GLenum mode);
+void glInvalidateFramebuffer(GLenum target, GLsizei numAttachments, const GLenum* attachments);
+GLboolean glIsEnabled(GLenum cap);
+GLboolean glIsFramebuffer(GLuint framebuffer);
+GLboolean glIsRenderbuffer(GLuint renderbuffer);
+GLboolean glIsTexture(GLuint texture);
+GLboolean glIsVertexArray(GLuint array);
+void glLinkProgram(GLuint program);
+void* glMapBuffer(GLenum target, GLenum access);
+void* glMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+void glPixelStorei(GLenum pname, GLint param);
+void glProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+void glProgramParameteri(GLuint program, GLenum pname, GLint value);
+void glQueryCounter(GLuint id, GLenum target);
+void glReadBuffer(GLenum src);
+void glReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, void* pixels);
+void glRenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height);
+void glRenderbufferStorageMultisample(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
+void glScissor(GLint x, GLint y, GLsizei width, GLsizei height);
+void glShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+void glStencilFunc(GLenum func, GLint ref, GLuint mask);
+void glStencilMask(GLuint mask);
+void glStencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+void glTexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+void glTexParameteri(GLenum target, GLenum pname, GLint param);
+void glTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels);
+void glTransformFeedbackVaryings(GLuint program, GLsizei count, const GLchar* const* varyings, GLenum bufferMode);
+void glUniform1f(GLint location, GLfloat v0);
+void glUniform1fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniform1i(GLint location, GLint v0);
+void glUniform1iv(GLint location, GLsizei count, const GLint* value);
+void glUniform2f(GLint location, GLfloat v0, GLfloat v1);
+void glUniform2fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniform3f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2);
+void glUniform3fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniform4f(GLint location, GLfloat v0, GLfloat v1, GLfloat v2, GLfloat v3);
+void glUniform4fv(GLint location, GLsizei count, const GLfloat* value);
+void glUniformBlockBinding(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+void glUniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+GLboolean glUnmapBuffer(GLenum target);
+void glUseProgram(GLuint program);
+void glVertexAttrib1f(GLuint index, GLfloat x);
+void glVertexAttrib4fv(GLuint index, const GLfloat* v);
+void glVertexAttribDivisor(GLuint index, GLuint divisor);
+void glVertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+void glViewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+#endif
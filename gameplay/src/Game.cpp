@@ -8,6 +8,16 @@
 #include "ControlFactory.h"
 #include "Theme.h"
 #include "Form.h"
+#include "MeshBatch.h"
+#include "RenderStats.h"
+#include "MemoryTracker.h"
+#include "InputQueue.h"
+#include "InputRecorder.h"
+#include "ResourceManager.h"
+#include "Texture.h"
+#include "TextureStreamer.h"
+#include "ScreenDisplayer.h"
+#include "SpriteBatch.h"
 
 /** @script{ignore} */
 GLenum __gl_error_code = GL_NO_ERROR;
@@ -21,6 +31,51 @@ static Game* __gameInstance = NULL;
 double Game::_pausedTimeLast = 0.0;
 double Game::_pausedTimeTotal = 0.0;
 
+// Returns the family of compressed texture formats that a namespace of the aliases in the game config is named after.
+static bool getTextureCompression(const char* name, Texture::Compression* compression)
+{
+    static const struct { const char* name; Texture::Compression compression; } names[] =
+    {
+        { "etc1", Texture::COMPRESSION_ETC1 },
+        { "etc2", Texture::COMPRESSION_ETC2 },
+        { "astc", Texture::COMPRESSION_ASTC },
+        { "bc", Texture::COMPRESSION_BC },
+        { "dxt", Texture::COMPRESSION_BC },
+        { "pvrtc", Texture::COMPRESSION_PVRTC },
+        { "atc", Texture::COMPRESSION_ATC }
+    };
+    for (unsigned int i = 0; i < sizeof(names) / sizeof(names[0]); ++i)
+    {
+        if (strcmp(name, names[i].name) == 0)
+        {
+            *compression = names[i].compression;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Initializes a subsystem that does not need the graphics context on a worker during startup.
+ */
+class StartupJob : public JobController::Job
+{
+public:
+
+    StartupJob(const std::function<void()>& function) : _function(function)
+    {
+    }
+
+    void execute(unsigned int worker)
+    {
+        _function();
+    }
+
+private:
+
+    std::function<void()> _function;
+};
+
 /**
 * @script{ignore}
 */
@@ -61,16 +116,18 @@ public:
 
 Game::Game()
     : _initialized(false), _state(UNINITIALIZED), _pausedCount(0),
-      _frameLastFPS(0), _frameCount(0), _frameRate(0), _width(0), _height(0),
+      _frameLastFPS(0), _frameCount(0), _frameRate(0), _frameIndex(0), _width(0), _height(0),
       _clearDepth(1.0f), _clearStencil(0), _properties(NULL),
       _animationController(NULL), _audioController(NULL),
-      _physicsController(NULL), _aiController(NULL), _audioListener(NULL),
-      _timeEvents(NULL), _scriptController(NULL), _scriptTarget(NULL)
+      _physicsController(NULL), _aiController(NULL), _jobController(NULL), _assetLoader(NULL), _frameAllocator(NULL), _audioListener(NULL),
+      _timeEvents(NULL), _scriptController(NULL), _scriptTarget(NULL), _pipelined(false), _simulation(NULL),
+      _targetFrameRate(0), _nextFrameTime(0.0), _sleepMargin(1.0), _splashScreen(NULL), _lastFrameTime(0.0)
 {
     GP_ASSERT(__gameInstance == NULL);
 
     __gameInstance = this;
-    _timeEvents = new std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >();
+    _frameAllocator = new FrameAllocator(64 * 1024);
+    _timeEvents = new TimerWheel();
 }
 
 Game::~Game()
@@ -81,6 +138,7 @@ Game::~Game()
     // Do not call any virtual functions from the destructor.
     // Finalization is done from outside this class.
     SAFE_DELETE(_timeEvents);
+    SAFE_DELETE(_frameAllocator);
 #ifdef GP_USE_MEM_LEAK_DETECTION
     Ref::printLeaks();
     printMemoryLeaks();
@@ -115,6 +173,11 @@ void Game::render(float elapsedTime)
     // stub
 }
 
+void Game::snapshot(float elapsedTime)
+{
+    // stub
+}
+
 double Game::getAbsoluteTime()
 {
     return Platform::getAbsoluteTime();
@@ -122,6 +185,8 @@ double Game::getAbsoluteTime()
 
 double Game::getGameTime()
 {
+    if (InputRecorder::isReplaying())
+        return InputRecorder::getReplayTime();
     return Platform::getAbsoluteTime() - _pausedTimeTotal;
 }
 
@@ -160,28 +225,120 @@ bool Game::startup()
     if (_state != UNINITIALIZED)
         return false;
 
+    MemoryTracker::initialize();
+    InputQueue::initialize();
+    Gamepad::initialize();
+
+    Properties* logger = _properties ? _properties->getNamespace("logger", true) : NULL;
+    if (logger)
+    {
+        if (logger->exists("infoRateLimit"))
+            Logger::setRateLimit(Logger::LEVEL_INFO, (unsigned int)std::max(logger->getInt("infoRateLimit"), 0));
+        if (logger->exists("warnRateLimit"))
+            Logger::setRateLimit(Logger::LEVEL_WARN, (unsigned int)std::max(logger->getInt("warnRateLimit"), 0));
+        if (logger->exists("binaryOutput"))
+            Logger::setBinaryOutput(logger->getString("binaryOutput"));
+        if (logger->getBool("asynchronous"))
+            Logger::setAsynchronous(true);
+    }
+
+    // The job controller is initialized first since other controllers can run their work on its
+    // workers, and the subsystems that do not need the graphics context are initialized on them,
+    // while the graphics state is set up and the splash screen is drawn on this thread.
+    _jobController = new JobController();
+    _jobController->initialize();
+
+    _audioController = new AudioController();
+    _physicsController = new PhysicsController();
+    _scriptController = new ScriptController();
+    StartupJob audioJob(std::bind(&AudioController::initialize, _audioController));
+    StartupJob physicsJob(std::bind(&PhysicsController::initialize, _physicsController));
+    StartupJob scriptJob(std::bind(&ScriptController::initialize, _scriptController));
+    JobController::Job* jobs[] = { &audioJob, &physicsJob, &scriptJob };
+    JobController::Group group;
+    _jobController->submit(jobs, 3, &group);
+
+    // Watch the files of the resources before the first ones are loaded.
+    if (_properties && _properties->exists("hotReload"))
+        FileSystem::setWatchEnabled(_properties->getBool("hotReload"));
+    if (_properties && _properties->exists("hotReloadInterval"))
+        FileSystem::setWatchInterval(_properties->getFloat("hotReloadInterval"));
+
     setViewport(Rectangle(0.0f, 0.0f, (float)_width, (float)_height));
     RenderState::initialize();
     FrameBuffer::initialize();
 
+    // The splash screen of the game config is shown for at least its time, which includes the
+    // initialization of the game.
+    Properties* splash = _properties ? _properties->getNamespace("splash", true) : NULL;
+    if (splash && splash->getString("image"))
+    {
+        _splashScreen = new ScreenDisplayer();
+        _splashScreen->run(this, &Game::drawSplash, (void*)splash->getString("image"), (unsigned long)std::max(splash->getInt("time"), 0));
+    }
+
+    // The aliases of the game config can be grouped by compressed texture format, such as
+    // 'astc' or 'etc2', for games that ship textures in several formats. The aliases of
+    // the first format listed that the device supports override the others.
+    Properties* aliases = _properties ? _properties->getNamespace("aliases", true) : NULL;
+    if (aliases)
+    {
+        aliases->rewind();
+        Properties* formatAliases;
+        while ((formatAliases = aliases->getNextNamespace()) != NULL)
+        {
+            Texture::Compression compression;
+            if (getTextureCompression(formatAliases->getNamespace(), &compression) && Texture::isCompressionSupported(compression))
+            {
+                FileSystem::loadResourceAliases(formatAliases);
+                break;
+            }
+        }
+    }
+
     _animationController = new AnimationController();
     _animationController->initialize();
 
-    _audioController = new AudioController();
-    _audioController->initialize();
+    TextureStreamer::initialize();
 
-    _physicsController = new PhysicsController();
-    _physicsController->initialize();
+    _assetLoader = new AssetLoader();
+    _assetLoader->initialize();
 
     _aiController = new AIController();
     _aiController->initialize();
 
-    _scriptController = new ScriptController();
-    _scriptController->initialize();
+    if (_properties && _properties->exists("aiUpdateBudget"))
+        _aiController->setUpdateBudget(_properties->getFloat("aiUpdateBudget"));
+    if (_properties && _properties->exists("aiLodDistance"))
+        _aiController->setLodDistance(_properties->getFloat("aiLodDistance"));
+
+    // This thread runs what is left of the worker jobs if there are no workers.
+    _jobController->wait(&group);
+
+    if (_properties && _properties->exists("scriptCollectorBudget"))
+        _scriptController->setCollectorBudget(_properties->getFloat("scriptCollectorBudget"));
+    if (_properties && _properties->exists("scriptProfilerInterval"))
+        _scriptController->getProfiler()->setInterval(_properties->getFloat("scriptProfilerInterval"));
+    if (_properties && _properties->exists("scriptProfiler"))
+        _scriptController->getProfiler()->setEnabled(_properties->getBool("scriptProfiler"));
 
     // Load any gamepads, ui or physical.
     loadGamepads();
 
+    if (_properties && _properties->exists("pipelined"))
+        _pipelined = _properties->getBool("pipelined");
+
+    if (_properties && _properties->exists("targetFrameRate"))
+        setTargetFrameRate((unsigned int)_properties->getInt("targetFrameRate"));
+
+    if (_properties && _properties->exists("profiler"))
+        Profiler::setEnabled(_properties->getBool("profiler"));
+    if (_properties && _properties->exists("profilerMaterials"))
+        Profiler::setMaterialTimingEnabled(_properties->getBool("profilerMaterials"));
+
+    // Start recording or replaying the input once the profiler is configured.
+    InputRecorder::initialize();
+
     // Set script handler
     if (_properties)
     {
@@ -223,6 +380,7 @@ bool Game::startup()
     }
 
     _state = RUNNING;
+    _lastFrameTime = getGameTime();
 
     return true;
 }
@@ -236,9 +394,14 @@ void Game::shutdown()
         GP_ASSERT(_audioController);
         GP_ASSERT(_physicsController);
         GP_ASSERT(_aiController);
+        GP_ASSERT(_jobController);
 
         Platform::signalShutdown();
 
+        // Stop the simulation thread before anything it may touch is released.
+        stopSimulation();
+        SAFE_DELETE(_splashScreen);
+
 		// Call user finalize
         finalize();
 
@@ -252,6 +415,11 @@ void Game::shutdown()
 		// Shutdown scripting system first so that any objects allocated in script are released before our subsystems are released
 		_scriptController->finalize();
 
+        // Stop recording or replaying, which disconnects the replayed gamepads.
+        InputRecorder::finalize();
+
+        // Stop sampling the gamepads before they are released.
+        Gamepad::finalize();
         unsigned int gamepadCount = Gamepad::getGamepadCount();
         for (unsigned int i = 0; i < gamepadCount; i++)
         {
@@ -259,6 +427,16 @@ void Game::shutdown()
             SAFE_DELETE(gamepad);
         }
 
+        // Release the assets of pending requests while the controllers they use still exist.
+        _assetLoader->finalize();
+        SAFE_DELETE(_assetLoader);
+
+        // Stop reading texture levels before the textures and the workers are released.
+        TextureStreamer::finalize();
+
+        // Release the cached resources while the audio and graphics contexts still exist.
+        ResourceManager::finalize();
+
         _animationController->finalize();
         SAFE_DELETE(_animationController);
 
@@ -269,9 +447,13 @@ void Game::shutdown()
         SAFE_DELETE(_physicsController);
         _aiController->finalize();
         SAFE_DELETE(_aiController);
+
+        _jobController->finalize();
+        SAFE_DELETE(_jobController);
         
         ControlFactory::finalize();
 
+        Form::clearTemplates();
         Theme::finalize();
 
         // Note: we do not clean up the script controller here
@@ -279,11 +461,17 @@ void Game::shutdown()
 
         SAFE_DELETE(_audioListener);
 
+        Profiler::finalize();
+        MeshBatch::finalize();
         FrameBuffer::finalize();
         RenderState::finalize();
 
         SAFE_DELETE(_properties);
 
+        // Write the queued messages and stop the logging thread last, since everything above may log.
+        Logger::setAsynchronous(false);
+        Logger::setBinaryOutput(NULL);
+
 		_state = UNINITIALIZED;
     }
 }
@@ -354,8 +542,57 @@ void Game::exit()
 }
 
 
+void Game::setTargetFrameRate(unsigned int framesPerSecond)
+{
+    _targetFrameRate = framesPerSecond;
+    _nextFrameTime = 0.0;
+}
+
+bool Game::waitForFrame()
+{
+    if (_targetFrameRate == 0 || _nextFrameTime == 0.0)
+        return false;
+
+    double now = Platform::getAbsoluteTime();
+    if (now >= _nextFrameTime)
+        return false;
+
+    // Sleep for all but the margin, which covers how late the platform wakes up, and spin
+    // through the rest. The margin grows quickly when a sleep overshoots and shrinks slowly.
+    double remaining = _nextFrameTime - now;
+    if (remaining > _sleepMargin)
+    {
+        double sleepTime = remaining - _sleepMargin;
+        Platform::sleep((long)sleepTime);
+        double overshoot = (Platform::getAbsoluteTime() - now) - (double)(long)sleepTime;
+        if (overshoot > _sleepMargin)
+            _sleepMargin = overshoot;
+        else
+            _sleepMargin += (overshoot - _sleepMargin) * 0.05;
+        _sleepMargin = std::min(std::max(_sleepMargin, 0.5), 4.0);
+    }
+    while (Platform::getAbsoluteTime() < _nextFrameTime)
+        std::this_thread::yield();
+
+    return true;
+}
+
 void Game::frame()
 {
+    Profiler::beginFrame();
+
+    if (_targetFrameRate > 0)
+    {
+        // Frames are due at a steady cadence. A frame that is late by more than an interval
+        // restarts the cadence instead of being followed by a burst of frames catching up.
+        double interval = 1000.0 / (double)_targetFrameRate;
+        double now = Platform::getAbsoluteTime();
+        if (_nextFrameTime == 0.0 || now - _nextFrameTime > interval)
+            _nextFrameTime = now + interval;
+        else
+            _nextFrameTime += interval;
+    }
+
     if (!_initialized)
     {
         // Perform lazy first time initialization
@@ -364,16 +601,33 @@ void Game::frame()
             _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, initialize));
         _initialized = true;
 
+        // The splash screen waits for the rest of its time.
+        SAFE_DELETE(_splashScreen);
+
         // Fire first game resize event
         Platform::resizeEventInternal(_width, _height);
     }
 
-	static double lastFrameTime = Game::getGameTime();
-	double frameTime = getGameTime();
+    // Record the elapsed time and the input of the frame, or replay them.
+    InputRecorder::beginFrame();
+
+    double frameTime = getGameTime();
 
     // Fire time events to scheduled TimeListeners
     fireTimeEvents(frameTime);
 
+    // Execute the jobs queued for the main thread.
+    _jobController->update();
+
+    // Create the assets whose files were decoded in the background.
+    _assetLoader->update();
+
+    // Reload the resources whose files changed.
+    FileSystem::updateWatches();
+
+    // Dispatch the input events of the frame.
+    InputQueue::update();
+
     if (_state == Game::RUNNING)
     {
         GP_ASSERT(_animationController);
@@ -382,43 +636,72 @@ void Game::frame()
         GP_ASSERT(_aiController);
 
         // Update Time.
-        float elapsedTime = (frameTime - lastFrameTime);
-        lastFrameTime = frameTime;
+        float elapsedTime = (float)(frameTime - _lastFrameTime);
+        _lastFrameTime = frameTime;
+
+        // Update the script contexts on the workers while the frame is updated and rendered.
+        if (_scriptController)
+            _scriptController->startContexts(elapsedTime);
+
+        if (_pipelined)
+        {
+            framePipelined(elapsedTime);
+        }
+        else
+        {
+            // Notify the listeners of the transforms changed by the updates below once.
+            Transform::deferTransformChanged();
 
-        // Update the scheduled and running animations.
-        _animationController->update(elapsedTime);
+            // Update the scheduled and running animations.
+            _animationController->update(elapsedTime);
 
-        // Update the physics.
-        _physicsController->update(elapsedTime);
+            // Update the physics.
+            _physicsController->update(elapsedTime);
 
-        // Update AI.
-        _aiController->update(elapsedTime);
+            // Update AI.
+            _aiController->update(elapsedTime);
 
-        // Update gamepads.
-        Gamepad::updateInternal(elapsedTime);
+            // Update gamepads.
+            Gamepad::updateInternal(elapsedTime);
 
-        // Application Update.
-        update(elapsedTime);
+            // Application Update.
+            {
+                GP_PROFILE("Game::update");
+                update(elapsedTime);
+            }
 
-        // Update forms.
-        Form::updateInternal(elapsedTime);
+            // Update forms.
+            Form::updateInternal(elapsedTime);
 
-        // Run script update.
-        if (_scriptTarget)
-            _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), elapsedTime);
+            // Run script update.
+            if (_scriptTarget)
+                _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), elapsedTime);
 
-        // Audio Rendering.
-        _audioController->update(elapsedTime);
+            Transform::flushTransformChanged();
 
-        // Graphics Rendering.
-        render(elapsedTime);
+            // Resolve all transforms changed during the update.
+            Scene::updateTransformsInternal();
 
-        // Run script render.
-        if (_scriptTarget)
-            _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, render), elapsedTime);
+            // Audio Rendering.
+            _audioController->update(elapsedTime);
+
+#ifndef GP_HEADLESS
+            // Graphics Rendering.
+            {
+                GP_PROFILE("Game::render");
+                GP_PROFILE_GPU("Game::render");
+                render(elapsedTime);
+            }
+
+            // Run script render.
+            if (_scriptTarget)
+                _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, render), elapsedTime);
+#endif
+        }
 
         // Update FPS.
         ++_frameCount;
+        ++_frameIndex;
         if ((Game::getGameTime() - _frameLastFPS) >= 1000)
         {
             _frameRate = _frameCount;
@@ -428,6 +711,8 @@ void Game::frame()
     }
 	else if (_state == Game::PAUSED)
     {
+        Transform::deferTransformChanged();
+
         // Update gamepads.
         Gamepad::updateInternal(0);
 
@@ -441,15 +726,188 @@ void Game::frame()
         if (_scriptTarget)
             _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), 0);
 
+        Transform::flushTransformChanged();
+
+        // Resolve all transforms changed during the update.
+        Scene::updateTransformsInternal();
+
+#ifndef GP_HEADLESS
         // Graphics Rendering.
         render(0);
 
         // Script render.
         if (_scriptTarget)
             _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, render), 0);
+#endif
+    }
+
+    // Deliver the messages of the script contexts and collect script garbage now that the frame is rendered.
+    if (_scriptController)
+    {
+        _scriptController->finishContexts();
+        _scriptController->updateCollector();
+    }
+
+    RenderStats::endFrame();
+    Profiler::endFrame();
+    InputRecorder::endFrame();
+
+    // Upload the texture levels that have been read and stream those requested during the frame.
+    TextureStreamer::update();
+
+    // Evict the unreferenced resources that exceed the memory budgets.
+    MemoryTracker::update();
+    ResourceManager::update();
+
+    // Release the transient memory allocated during the frame.
+    _frameAllocator->reset();
+}
+
+void Game::framePipelined(float elapsedTime)
+{
+    // Notify the listeners of the transforms changed by the updates below once.
+    Transform::deferTransformChanged();
+
+    // Update gamepads.
+    Gamepad::updateInternal(elapsedTime);
+
+    // Update forms.
+    Form::updateInternal(elapsedTime);
+
+    // Run script update.
+    if (_scriptTarget)
+        _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, update), elapsedTime);
+
+    Transform::flushTransformChanged();
+
+    // Resolve all transforms changed during the previous simulation and the updates above.
+    Scene::updateTransformsInternal();
+
+    // Audio Rendering.
+    _audioController->update(elapsedTime);
+
+    // Capture what is rendered for this frame while nothing else is running.
+    {
+        GP_PROFILE("Game::snapshot");
+        snapshot(elapsedTime);
+    }
+
+    // Start the simulation of the next frame.
+    if (_simulation == NULL)
+    {
+        _simulation = new Simulation();
+        _simulation->running = true;
+        _simulation->thread = new std::thread(&Game::runSimulation, this);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_simulation->mutex);
+        _simulation->elapsedTime = elapsedTime;
+        _simulation->pending = true;
+    }
+    _simulation->started.notify_one();
+
+#ifndef GP_HEADLESS
+    // Graphics Rendering.
+    {
+        GP_PROFILE("Game::render");
+        GP_PROFILE_GPU("Game::render");
+        render(elapsedTime);
+    }
+
+    // Run script render.
+    if (_scriptTarget)
+        _scriptTarget->fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(GameScriptTarget, render), elapsedTime);
+#endif
+
+    // Wait for the simulation so that events are never delivered while it is running.
+    GP_PROFILE("Wait for simulation");
+    std::unique_lock<std::mutex> lock(_simulation->mutex);
+    while (_simulation->pending)
+    {
+        _simulation->completed.wait(lock);
     }
 }
 
+void Game::simulate(float elapsedTime)
+{
+    // The simulation thread defers the notifications of its own changes.
+    Transform::deferTransformChanged();
+
+    // Update the scheduled and running animations.
+    _animationController->update(elapsedTime);
+
+    // Update the physics.
+    _physicsController->update(elapsedTime);
+
+    // Update AI.
+    _aiController->update(elapsedTime);
+
+    // Application Update.
+    {
+        GP_PROFILE("Game::update");
+        update(elapsedTime);
+    }
+
+    Transform::flushTransformChanged();
+}
+
+void Game::runSimulation()
+{
+    std::unique_lock<std::mutex> lock(_simulation->mutex);
+    while (true)
+    {
+        while (_simulation->running && !_simulation->pending)
+        {
+            _simulation->started.wait(lock);
+        }
+        if (!_simulation->running)
+            break;
+
+        float elapsedTime = _simulation->elapsedTime;
+        lock.unlock();
+        simulate(elapsedTime);
+        lock.lock();
+
+        _simulation->pending = false;
+        _simulation->completed.notify_one();
+    }
+}
+
+void Game::stopSimulation()
+{
+    if (_simulation == NULL)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_simulation->mutex);
+        _simulation->running = false;
+    }
+    _simulation->started.notify_one();
+    _simulation->thread->join();
+    SAFE_DELETE(_simulation->thread);
+    SAFE_DELETE(_simulation);
+}
+
+void Game::drawSplash(void* image)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4(0, 0, 0, 1), 1.0f, 0);
+
+    Texture* texture = Texture::create((const char*)image, false);
+    if (!texture)
+        return;
+
+    // The image is drawn centered at its own size, scaled down to fit the screen.
+    float width = (float)texture->getWidth();
+    float height = (float)texture->getHeight();
+    float scale = std::min(1.0f, std::min((float)_width / width, (float)_height / height));
+    SpriteBatch* batch = SpriteBatch::create(texture);
+    batch->start();
+    batch->draw(_width * 0.5f, _height * 0.5f, 0.0f, width * scale, height * scale, 0.0f, 1.0f, 1.0f, 0.0f, Vector4::one(), true);
+    batch->finish();
+    SAFE_DELETE(batch);
+    SAFE_RELEASE(texture);
+}
+
 void Game::renderOnce(const char* function)
 {
     _scriptController->executeFunction<void>(function, NULL);
@@ -464,10 +922,9 @@ void Game::updateOnce()
     GP_ASSERT(_aiController);
 
     // Update Time.
-    static double lastFrameTime = getGameTime();
     double frameTime = getGameTime();
-    float elapsedTime = (frameTime - lastFrameTime);
-    lastFrameTime = frameTime;
+    float elapsedTime = (float)(frameTime - _lastFrameTime);
+    _lastFrameTime = frameTime;
 
     // Update the internal controllers.
     _animationController->update(elapsedTime);
@@ -524,6 +981,19 @@ void Game::clear(ClearFlags flags, const Vector4& clearColor, float clearDepth,
         }
         bits |= GL_STENCIL_BUFFER_BIT;
     }
+
+    // A clear that covers the whole frame buffer doesn't need its previous contents.
+    if (bits && !glIsEnabled(GL_SCISSOR_TEST))
+    {
+        unsigned int attachments = 0;
+        if (bits & GL_COLOR_BUFFER_BIT)
+            attachments |= FrameBuffer::ATTACHMENT_COLOR;
+        if (bits & GL_DEPTH_BUFFER_BIT)
+            attachments |= FrameBuffer::ATTACHMENT_DEPTH;
+        if (bits & GL_STENCIL_BUFFER_BIT)
+            attachments |= FrameBuffer::ATTACHMENT_STENCIL;
+        FrameBuffer::getCurrent()->discard(attachments);
+    }
     glClear(bits);
 }
 
@@ -709,11 +1179,10 @@ void Game::getArguments(int* argc, char*** argv) const
     Platform::getArguments(argc, argv);
 }
 
-void Game::schedule(float timeOffset, TimeListener* timeListener, void* cookie)
+unsigned int Game::schedule(float timeOffset, TimeListener* timeListener, void* cookie)
 {
     GP_ASSERT(_timeEvents);
-    TimeEvent timeEvent(getGameTime() + timeOffset, timeListener, cookie);
-    _timeEvents->push(timeEvent);
+    return _timeEvents->schedule(getGameTime() + timeOffset, timeListener, cookie);
 }
 
 void Game::schedule(float timeOffset, const char* function)
@@ -721,38 +1190,27 @@ void Game::schedule(float timeOffset, const char* function)
     getScriptController()->schedule(timeOffset, function);
 }
 
-void Game::clearSchedule()
+bool Game::cancelSchedule(unsigned int id)
 {
-    SAFE_DELETE(_timeEvents);
-    _timeEvents = new std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >();
+    GP_ASSERT(_timeEvents);
+    return _timeEvents->cancel(id);
 }
 
-void Game::fireTimeEvents(double frameTime)
+void Game::clearSchedule()
 {
-    while (_timeEvents->size() > 0)
-    {
-        const TimeEvent* timeEvent = &_timeEvents->top();
-        if (timeEvent->time > frameTime)
-        {
-            break;
-        }
-        if (timeEvent->listener)
-        {
-            timeEvent->listener->timeEvent(frameTime - timeEvent->time, timeEvent->cookie);
-        }
-        _timeEvents->pop();
-    }
+    GP_ASSERT(_timeEvents);
+    _timeEvents->clear();
 }
 
-Game::TimeEvent::TimeEvent(double time, TimeListener* timeListener, void* cookie)
-    : time(time), listener(timeListener), cookie(cookie)
+void Game::fireTimeEvents(double frameTime)
 {
+    GP_ASSERT(_timeEvents);
+    _timeEvents->update(frameTime);
 }
 
-bool Game::TimeEvent::operator<(const TimeEvent& v) const
+Game::Simulation::Simulation()
+    : thread(NULL), elapsedTime(0.0f), pending(false), running(false)
 {
-    // The first element of std::priority_queue is the greatest.
-    return time > v.time;
 }
 
 Properties* Game::getConfig() const
@@ -778,6 +1236,17 @@ void Game::loadConfig()
             {
                 FileSystem::loadResourceAliases(aliases);
             }
+
+            // Mount pack files, each named by the directory it is mounted at.
+            Properties* archives = _properties->getNamespace("archives", true);
+            if (archives)
+            {
+                const char* mountPoint;
+                while ((mountPoint = archives->getNextProperty()) != NULL)
+                {
+                    FileSystem::mountArchive(archives->getString(), mountPoint);
+                }
+            }
         }
         else
         {
@@ -10,15 +10,20 @@
 #include "AnimationController.h"
 #include "PhysicsController.h"
 #include "AIController.h"
+#include "JobController.h"
+#include "AssetLoader.h"
+#include "FrameAllocator.h"
 #include "AudioListener.h"
 #include "Rectangle.h"
 #include "Vector4.h"
 #include "TimeListener.h"
+#include "TimerWheel.h"
 
 namespace gameplay
 {
 
 class ScriptController;
+class ScreenDisplayer;
 
 /**
  * Defines the base class your game will extend for game initialization, logic and platform delegates.
@@ -32,6 +37,7 @@ class Game
 {
     friend class Platform;
     friend class Gamepad;
+    friend class InputRecorder;
     friend class ShutdownListener;
 
 public:
@@ -169,6 +175,16 @@ public:
      */
     inline unsigned int getFrameRate() const;
 
+    /**
+     * Gets the number of frames that have been run since the game started.
+     *
+     * Unlike the frame count used for the frame rate, this index is never reset,
+     * so it can be used to tell whether work was already done in the current frame.
+     *
+     * @return The index of the current frame.
+     */
+    inline unsigned int getFrameIndex() const;
+
     /**
      * Gets the game window width.
      * 
@@ -209,6 +225,9 @@ public:
     /**
      * Clears the specified resource buffers to the specified clear values. 
      *
+     * Unless the scissor test is enabled, the cleared buffers of the current frame buffer are
+     * discarded first, so that tile based GPUs don't load their previous contents.
+     *
      * @param flags The flags indicating which buffers to be cleared.
      * @param clearColor The color value to clear to when the flags includes the color buffer.
      * @param clearDepth The depth value to clear to when the flags includes the color buffer.
@@ -241,6 +260,9 @@ public:
      * Gets the animation controller for managing control of animations
      * associated with the game.
      * 
+     * The controller of the World that is current on the calling thread is returned
+     * when there is one.
+     *
      * @return The animation controller for this game.
      */
     inline AnimationController* getAnimationController() const;
@@ -249,6 +271,9 @@ public:
      * Gets the physics controller for managing control of physics
      * associated with the game.
      * 
+     * The controller of the World that is current on the calling thread is returned
+     * when there is one.
+     *
      * @return The physics controller for this game.
      */
     inline PhysicsController* getPhysicsController() const;
@@ -257,10 +282,37 @@ public:
      * Gets the AI controller for managing control of artificial
      * intelligence associated with the game.
      *
+     * The controller of the World that is current on the calling thread is returned
+     * when there is one.
+     *
      * @return The AI controller for this game.
      */
     inline AIController* getAIController() const;
 
+    /**
+     * Gets the job controller for executing work in parallel on
+     * the worker threads of the game.
+     *
+     * @return The job controller for this game.
+     * @script{ignore}
+     */
+    inline JobController* getJobController() const;
+
+    /**
+     * Gets the asset loader for loading assets in the background.
+     *
+     * @return The asset loader for this game.
+     */
+    inline AssetLoader* getAssetLoader() const;
+
+    /**
+     * Gets the frame allocator for transient memory that is released at the end of every frame.
+     *
+     * @return The frame allocator for this game.
+     * @script{ignore}
+     */
+    inline FrameAllocator* getFrameAllocator() const;
+
     /**
      * Gets the script controller for managing control of Lua scripts
      * associated with the game.
@@ -534,6 +586,67 @@ public:
      */
     inline bool isMultiTouch() const;
 
+    /**
+     * Sets whether the simulation of the next frame runs in parallel with the rendering
+     * of the current frame. Default is disabled.
+     *
+     * When enabled, each frame first resolves the transforms changed by the simulation
+     * of the previous frame and calls snapshot(), after which animations, physics, AI and
+     * update() of the next frame are run on a simulation thread while render() draws
+     * the current frame on the main thread. The frame returns once both are complete, so
+     * input events and time events are never delivered while the simulation is running.
+     *
+     * Since render() overlaps with the simulation, it must only draw what was captured
+     * by snapshot(), for example by executing a CommandBuffer recorded there, and must
+     * not read or modify the scene. Gamepads, forms and script callbacks are updated on
+     * the main thread before the snapshot is taken, and the job controller must not be
+     * used from render() while the simulation is running.
+     *
+     * Pipelining can also be enabled with the 'pipelined' property of the game
+     * configuration file.
+     *
+     * @param enabled true to run the simulation in parallel with rendering, false to run them in sequence.
+     * @script{ignore}
+     */
+    inline void setPipelined(bool enabled);
+
+    /**
+     * Is the simulation run in parallel with rendering.
+     *
+     * @return true if pipelining is enabled.
+     * @script{ignore}
+     */
+    inline bool isPipelined() const;
+
+    /**
+     * Sets the frame rate that frames are paced to.
+     *
+     * When a target frame rate is set, the platform waits between frames until the next
+     * frame is due instead of starting it right away, so that a game that runs faster than
+     * it needs to doesn't keep a CPU core busy. The wait sleeps for most of the remaining
+     * time and spins for the rest, by a margin that adapts to how much the sleeps of the
+     * platform overshoot. Input events are processed after the wait, right before the frame
+     * that handles them, which keeps the latency of input short and even.
+     *
+     * Frames that are late start right away, and frames that are late by more than a whole
+     * interval restart the pacing rather than being caught up on.
+     *
+     * The target frame rate can also be set with the 'targetFrameRate' property of the game
+     * configuration file.
+     *
+     * @param framesPerSecond The target frame rate, or 0 to start every frame as soon as possible.
+     * @script{ignore}
+     */
+    void setTargetFrameRate(unsigned int framesPerSecond);
+
+    /**
+     * Returns the frame rate that frames are paced to.
+     *
+     * @return The target frame rate, or 0 if frames are not paced.
+     * @script{ignore}
+     */
+    inline unsigned int getTargetFrameRate() const;
+
     /**
      * Whether this game is allowed to exit programmatically.
      *
@@ -588,9 +701,11 @@ public:
      * @param timeOffset The number of game milliseconds in the future to schedule the event to be fired.
      * @param timeListener The TimeListener that will receive the event.
      * @param cookie The cookie data that the time event will contain.
+     *
+     * @return The id of the time event, which can be used to cancel it.
      * @script{ignore}
      */
-    void schedule(float timeOffset, TimeListener* timeListener, void* cookie = 0);
+    unsigned int schedule(float timeOffset, TimeListener* timeListener, void* cookie = 0);
 
     /**
      * Schedules a time event to be sent to the given TimeListener a given number of game milliseconds from now.
@@ -605,6 +720,16 @@ public:
      */
     void schedule(float timeOffset, const char* function);
 
+    /**
+     * Cancels a scheduled time event.
+     *
+     * @param id The id returned by schedule.
+     *
+     * @return true if the event was cancelled, false if it has already been fired or cancelled.
+     * @script{ignore}
+     */
+    bool cancelSchedule(unsigned int id);
+
     /**
      * Clears all scheduled time events.
      */
@@ -651,6 +776,20 @@ protected:
      */
     virtual void render(float elapsedTime);
 
+    /**
+     * Snapshot callback for capturing what render() draws when pipelining is enabled.
+     *
+     * Called on the main thread once per frame when the game is running pipelined, after
+     * the transforms changed by the previous simulation have been resolved and before the
+     * simulation of the next frame is started. This is the only point where the scene can
+     * be read safely, so everything render() needs should be recorded here.
+     *
+     * @param elapsedTime The elapsed game time.
+     *
+     * @see setPipelined
+     */
+    virtual void snapshot(float elapsedTime);
+
     /**
      * Renders a single frame once and then swaps it to the display.
      *
@@ -684,17 +823,18 @@ private:
     };
 
     /**
-     * TimeEvent represents the event that is sent to TimeListeners as a result of calling Game::schedule().
+     * The state shared between the main thread and the simulation thread when pipelining.
      */
-    class TimeEvent
+    struct Simulation
     {
-    public:
-
-        TimeEvent(double time, TimeListener* timeListener, void* cookie);
-        bool operator<(const TimeEvent& v) const;
-        double time;
-        TimeListener* listener;
-        void* cookie;
+        Simulation();
+        std::thread* thread;
+        std::mutex mutex;
+        std::condition_variable started;
+        std::condition_variable completed;
+        float elapsedTime;
+        bool pending;
+        bool running;
     };
 
     /**
@@ -714,6 +854,15 @@ private:
      */
     void shutdown();
 
+    /**
+     * Waits until the next frame is due when frames are paced. Called by the platform before
+     * it processes the pending input events and calls frame().
+     *
+     * @return true if it waited, in which case the input events that arrived meanwhile
+     *      should be processed before the frame.
+     */
+    bool waitForFrame();
+
     /**
      * Fires the time events that were scheduled to be called.
      * 
@@ -731,6 +880,37 @@ private:
      */
     void loadGamepads();
 
+    /**
+     * Draws the splash screen of the game config.
+     *
+     * @param image The path of the image to draw.
+     */
+    void drawSplash(void* image);
+
+    /**
+     * Runs a single frame with the simulation of the next frame overlapping the rendering.
+     *
+     * @param elapsedTime The elapsed game time.
+     */
+    void framePipelined(float elapsedTime);
+
+    /**
+     * Updates animations, physics, AI and the application for a frame on the simulation thread.
+     *
+     * @param elapsedTime The elapsed game time.
+     */
+    void simulate(float elapsedTime);
+
+    /**
+     * Runs the simulations requested by the main thread until pipelining is stopped.
+     */
+    void runSimulation();
+
+    /**
+     * Stops the simulation thread, if one has been started.
+     */
+    void stopSimulation();
+
     void keyEventInternal(Keyboard::KeyEvent evt, int key);
     void touchEventInternal(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex);
     bool mouseEventInternal(Mouse::MouseEvent evt, int x, int y, int wheelDelta);
@@ -751,6 +931,7 @@ private:
     double _frameLastFPS;                       // The last time the frame count was updated.
     unsigned int _frameCount;                   // The current frame count.
     unsigned int _frameRate;                    // The current frame rate.
+    unsigned int _frameIndex;                   // The number of frames run since the game started.
     unsigned int _width;                        // The game's display width.
     unsigned int _height;                       // The game's display height.
     Rectangle _viewport;                        // the games's current viewport.
@@ -762,10 +943,20 @@ private:
     AudioController* _audioController;          // Controls audio sources that are playing in the game.
     PhysicsController* _physicsController;      // Controls the simulation of a physics scene and entities.
     AIController* _aiController;                // Controls AI simulation.
+    JobController* _jobController;              // Controls the worker threads executing parallel jobs.
+    AssetLoader* _assetLoader;                  // Loads assets on the worker threads.
+    FrameAllocator* _frameAllocator;            // Allocates transient memory that is released at the end of every frame.
     AudioListener* _audioListener;              // The audio listener in 3D space.
-    std::priority_queue<TimeEvent, std::vector<TimeEvent>, std::less<TimeEvent> >* _timeEvents;     // Contains the scheduled time events.
+    TimerWheel* _timeEvents;                    // Contains the scheduled time events.
+    double _lastFrameTime;                      // The game time of the last frame that was updated.
     ScriptController* _scriptController;            // Controls the scripting engine.
     ScriptTarget* _scriptTarget;                // Script target for the game
+    bool _pipelined;                            // If the simulation runs in parallel with rendering.
+    Simulation* _simulation;                    // The simulation thread, created on the first pipelined frame.
+    unsigned int _targetFrameRate;              // The frame rate that frames are paced to, or 0.
+    double _nextFrameTime;                      // The absolute time at which the next paced frame is due.
+    double _sleepMargin;                        // The time left to spin after sleeping, from the observed oversleep.
+    ScreenDisplayer* _splashScreen;             // The splash screen of the game config, until the game is initialized.
 
     // Note: Do not add STL object member variables on the stack; this will cause false memory leaks to be reported.
 
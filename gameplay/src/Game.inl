@@ -1,5 +1,6 @@
 #include "Game.h"
 #include "Platform.h"
+#include "World.h"
 
 namespace gameplay
 {
@@ -19,6 +20,11 @@ inline unsigned int Game::getFrameRate() const
     return _frameRate;
 }
 
+inline unsigned int Game::getFrameIndex() const
+{
+    return _frameIndex;
+}
+
 inline unsigned int Game::getWidth() const
 {
     return _width;
@@ -41,7 +47,8 @@ inline const Rectangle& Game::getViewport() const
 
 inline AnimationController* Game::getAnimationController() const
 {
-    return _animationController;
+    World* world = World::getCurrent();
+    return world ? world->getAnimationController() : _animationController;
 }
 
 inline AudioController* Game::getAudioController() const
@@ -51,7 +58,8 @@ inline AudioController* Game::getAudioController() const
 
 inline PhysicsController* Game::getPhysicsController() const
 {
-    return _physicsController;
+    World* world = World::getCurrent();
+    return world ? world->getPhysicsController() : _physicsController;
 }
 
 inline ScriptController* Game::getScriptController() const
@@ -60,7 +68,23 @@ inline ScriptController* Game::getScriptController() const
 }
 inline AIController* Game::getAIController() const
 {
-    return _aiController;
+    World* world = World::getCurrent();
+    return world ? world->getAIController() : _aiController;
+}
+
+inline JobController* Game::getJobController() const
+{
+    return _jobController;
+}
+
+inline AssetLoader* Game::getAssetLoader() const
+{
+    return _assetLoader;
+}
+
+inline FrameAllocator* Game::getFrameAllocator() const
+{
+    return _frameAllocator;
 }
 
 template <class T>
@@ -116,6 +140,21 @@ inline bool Game::isMultiTouch() const
     return Platform::isMultiTouch();
 }
 
+inline void Game::setPipelined(bool enabled)
+{
+    _pipelined = enabled;
+}
+
+inline bool Game::isPipelined() const
+{
+    return _pipelined;
+}
+
+inline unsigned int Game::getTargetFrameRate() const
+{
+    return _targetFrameRate;
+}
+
 inline bool Game::canExit() const
 {
     return Platform::canExit();
@@ -5,14 +5,29 @@
 #include "Platform.h"
 #include "Form.h"
 #include "JoystickControl.h"
+#include "InputRecorder.h"
 
 namespace gameplay
 {
 
+// The bit of the middle sample index that marks a sample the main thread has not read yet.
+#define GAMEPAD_SAMPLE_NEW 4
+
 static std::vector<Gamepad*> __gamepads;
+static std::mutex __samplerMutex;
+static std::thread* __samplerThread = NULL;
+static std::atomic<bool> __samplerRunning(false);
+static unsigned int __sampleRate = 0;
+static thread_local bool __sampling = false;
+
+Gamepad::Sample::Sample() : buttons(0), time(0.0), disconnected(false)
+{
+    triggers[0] = triggers[1] = 0.0f;
+}
 
 Gamepad::Gamepad(const char* formPath)
-    : _handle((GamepadHandle)INT_MAX), _buttonCount(0), _joystickCount(0), _triggerCount(0), _form(NULL), _buttons(0)
+    : _handle((GamepadHandle)INT_MAX), _buttonCount(0), _joystickCount(0), _triggerCount(0), _form(NULL), _buttons(0), _stateTime(0.0),
+      _sampleMiddle(1), _sampleBack(0), _sampleFront(2)
 {
     GP_ASSERT(formPath);
     _form = Form::create(formPath);
@@ -36,7 +51,8 @@ Gamepad::Gamepad(const char* formPath)
 
 Gamepad::Gamepad(GamepadHandle handle, unsigned int buttonCount, unsigned int joystickCount, unsigned int triggerCount, const char* name)
     : _handle(handle), _buttonCount(buttonCount), _joystickCount(joystickCount), _triggerCount(triggerCount),
-      _form(NULL), _buttons(0)
+      _form(NULL), _buttons(0), _stateTime(0.0),
+      _sampleMiddle(1), _sampleBack(0), _sampleFront(2)
 {
     if (name)
     {
@@ -58,7 +74,10 @@ Gamepad* Gamepad::add(GamepadHandle handle, unsigned int buttonCount, unsigned i
 {
     Gamepad* gamepad = new Gamepad(handle, buttonCount, joystickCount, triggerCount, name);
 
-    __gamepads.push_back(gamepad);
+    {
+        std::lock_guard<std::mutex> lock(__samplerMutex);
+        __gamepads.push_back(gamepad);
+    }
     Game::getInstance()->gamepadEventInternal(CONNECTED_EVENT, gamepad);
     return gamepad;
 }
@@ -67,7 +86,10 @@ Gamepad* Gamepad::add(const char* formPath)
 {
     Gamepad* gamepad = new Gamepad(formPath);
 
-    __gamepads.push_back(gamepad);
+    {
+        std::lock_guard<std::mutex> lock(__samplerMutex);
+        __gamepads.push_back(gamepad);
+    }
     Game::getInstance()->gamepadEventInternal(CONNECTED_EVENT, gamepad);
     return gamepad;
 }
@@ -80,7 +102,10 @@ void Gamepad::remove(GamepadHandle handle)
         Gamepad* gamepad = *it;
         if (gamepad->_handle == handle)
         {
-            it = __gamepads.erase(it);
+            {
+                std::lock_guard<std::mutex> lock(__samplerMutex);
+                it = __gamepads.erase(it);
+            }
             Game::getInstance()->gamepadEventInternal(DISCONNECTED_EVENT, gamepad);
             SAFE_DELETE(gamepad);
         }
@@ -99,7 +124,10 @@ void Gamepad::remove(Gamepad* gamepad)
         Gamepad* g = *it;
         if (g == gamepad)
         {
-            it = __gamepads.erase(it);
+            {
+                std::lock_guard<std::mutex> lock(__samplerMutex);
+                it = __gamepads.erase(it);
+            }
             Game::getInstance()->gamepadEventInternal(DISCONNECTED_EVENT, g);
             SAFE_DELETE(gamepad);
         }
@@ -240,9 +268,127 @@ const char* Gamepad::getName() const
 
 void Gamepad::update(float elapsedTime)
 {
-    if (!_form)
+    // The physical gamepads are set by a replay instead of the devices.
+    if (!_form && !InputRecorder::isReplaying())
     {
+        if (__samplerThread)
+        {
+            applySample();
+        }
+        else
+        {
+            Platform::pollGamepadState(this);
+            _stateTime = Game::getAbsoluteTime();
+        }
+    }
+}
+
+void Gamepad::applySample()
+{
+    // Take the latest sample if the sampler thread published one since the last update.
+    if (_sampleMiddle.load(std::memory_order_relaxed) & GAMEPAD_SAMPLE_NEW)
+        _sampleFront = _sampleMiddle.exchange(_sampleFront, std::memory_order_acq_rel) & ~GAMEPAD_SAMPLE_NEW;
+
+    const Sample& sample = _samples[_sampleFront];
+    if (sample.disconnected)
+    {
+        // Polling the device again on this thread removes the gamepad.
         Platform::pollGamepadState(this);
+        return;
+    }
+    if (sample.time == 0.0)
+        return;
+
+    setButtons(sample.buttons);
+    for (unsigned int i = 0; i < _joystickCount && i < 2; ++i)
+    {
+        setJoystickValue(i, sample.joysticks[i].x, sample.joysticks[i].y);
+    }
+    for (unsigned int i = 0; i < _triggerCount && i < 2; ++i)
+    {
+        setTriggerValue(i, sample.triggers[i]);
+    }
+    _stateTime = sample.time;
+}
+
+bool Gamepad::deferDisconnect()
+{
+    if (!__sampling)
+        return false;
+    _sample.disconnected = true;
+    return true;
+}
+
+double Gamepad::getStateTime() const
+{
+    return _stateTime;
+}
+
+void Gamepad::setSampleRate(unsigned int rate)
+{
+    if (__samplerThread)
+    {
+        __samplerRunning.store(false);
+        __samplerThread->join();
+        SAFE_DELETE(__samplerThread);
+    }
+
+    __sampleRate = rate;
+    if (rate > 0)
+    {
+        __samplerRunning.store(true);
+        __samplerThread = new std::thread(&Gamepad::runSampler, rate);
+    }
+}
+
+unsigned int Gamepad::getSampleRate()
+{
+    return __sampleRate;
+}
+
+void Gamepad::initialize()
+{
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("gamepads", true);
+    if (config && config->exists("sampleRate"))
+        setSampleRate((unsigned int)std::max(config->getInt("sampleRate"), 0));
+}
+
+void Gamepad::finalize()
+{
+    setSampleRate(0);
+}
+
+void Gamepad::runSampler(unsigned int rate)
+{
+    __sampling = true;
+
+    std::chrono::steady_clock::duration interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / rate));
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while (__samplerRunning.load(std::memory_order_relaxed))
+    {
+        {
+            std::lock_guard<std::mutex> lock(__samplerMutex);
+            for (size_t i = 0, count = __gamepads.size(); i < count; ++i)
+            {
+                Gamepad* gamepad = __gamepads[i];
+                if (gamepad->_form || gamepad->_sample.disconnected)
+                    continue;
+
+                // The setters write into the sample while the platform polls on this thread.
+                Platform::pollGamepadState(gamepad);
+                gamepad->_sample.time = Game::getAbsoluteTime();
+
+                gamepad->_samples[gamepad->_sampleBack] = gamepad->_sample;
+                gamepad->_sampleBack = gamepad->_sampleMiddle.exchange(gamepad->_sampleBack | GAMEPAD_SAMPLE_NEW, std::memory_order_acq_rel) & ~GAMEPAD_SAMPLE_NEW;
+            }
+        }
+
+        // A sampler that falls behind skips the samples it missed rather than catching up.
+        next += interval;
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        if (next < now)
+            next = now;
+        std::this_thread::sleep_until(next);
     }
 }
 
@@ -253,6 +399,7 @@ void Gamepad::updateInternal(float elapsedTime)
     {
         __gamepads[i]->update(elapsedTime);
     }
+    InputRecorder::updateGamepads();
 }
 
 void Gamepad::draw()
@@ -315,7 +462,7 @@ void Gamepad::getJoystickValues(unsigned int joystickId, Vector2* outValue) cons
     }
     else
     {
-        outValue->set(_joysticks[joystickId]);
+        outValue->set(__sampling ? _sample.joysticks[joystickId] : _joysticks[joystickId]);
     }
 }
 
@@ -352,6 +499,12 @@ Form* Gamepad::getForm() const
 
 void Gamepad::setButtons(unsigned int buttons)
 {
+    if (__sampling)
+    {
+        _sample.buttons = buttons;
+        return;
+    }
+
     if (buttons != _buttons)
     {
         _buttons = buttons;
@@ -361,6 +514,12 @@ void Gamepad::setButtons(unsigned int buttons)
 
 void Gamepad::setJoystickValue(unsigned int index, float x, float y)
 {
+    if (__sampling)
+    {
+        _sample.joysticks[index].set(x, y);
+        return;
+    }
+
     if (_joysticks[index].x != x || _joysticks[index].y != y)
     {
         _joysticks[index].set(x, y);
@@ -370,6 +529,12 @@ void Gamepad::setJoystickValue(unsigned int index, float x, float y)
 
 void Gamepad::setTriggerValue(unsigned int index, float value)
 {
+    if (__sampling)
+    {
+        _sample.triggers[index] = value;
+        return;
+    }
+
     if (_triggers[index] != value)
     {
         _triggers[index] = value;
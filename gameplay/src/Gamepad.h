@@ -17,12 +17,20 @@ class Platform;
  *
  * A gamepad can be either physical or virtual. Most platform support up to 4
  * gamepad controllers connected simulataneously.
+ *
+ * Physical gamepads are polled once per frame by default. On platforms that poll the
+ * devices, such as Linux and Windows, they can instead be sampled at a fixed rate by a
+ * thread of their own, which is set with setSampleRate or with the 'sampleRate' property
+ * of the 'gamepads' namespace in the game configuration file. The thread stores every
+ * sample in a lock-free buffer, and the state returned by the gamepad is the latest
+ * sample as of the last update, so reading it never waits for a device.
  */
 class Gamepad
 {
     friend class Platform;
     friend class Game;
     friend class Button;
+    friend class InputRecorder;
 
 public:
 
@@ -114,6 +122,29 @@ public:
      */
     const char* getName() const;
 
+    /**
+     * Returns the time at which the current state of the gamepad was read from the device.
+     *
+     * @return The absolute time of the state, in milliseconds, or 0 for a virtual gamepad.
+     */
+    double getStateTime() const;
+
+    /**
+     * Sets the rate at which physical gamepads are sampled by a thread of their own.
+     *
+     * @param rate The number of samples per second, or 0 to poll the gamepads once per frame.
+     * @script{ignore}
+     */
+    static void setSampleRate(unsigned int rate);
+
+    /**
+     * Returns the rate at which physical gamepads are sampled by a thread of their own.
+     *
+     * @return The number of samples per second, or 0 if the gamepads are polled once per frame.
+     * @script{ignore}
+     */
+    static unsigned int getSampleRate();
+
     /**
      * Returns whether the gamepad is currently represented with a UI form or not.
      *
@@ -146,6 +177,20 @@ public:
 
 private:
 
+    /**
+     * The state of a physical gamepad as read by the sampler thread.
+     */
+    struct Sample
+    {
+        Sample();
+
+        unsigned int buttons;
+        Vector2 joysticks[2];
+        float triggers[2];
+        double time;
+        bool disconnected;
+    };
+
     /**
      * Constructs a gamepad from the specified .form file.
      *
@@ -192,6 +237,34 @@ private:
 
     static ButtonMapping getButtonMappingFromString(const char* string);
 
+    /**
+     * Called during startup to start the sampler thread if the configuration asks for it.
+     */
+    static void initialize();
+
+    /**
+     * Called during shutdown to stop the sampler thread.
+     */
+    static void finalize();
+
+    /**
+     * Samples the physical gamepads at the sample rate until the rate is changed.
+     */
+    static void runSampler(unsigned int rate);
+
+    /**
+     * Called by the platform when a physical gamepad is disconnected while it is polled.
+     *
+     * @return true if the gamepad is polled by the sampler thread, in which case it is
+     *      removed by the next update on the main thread instead.
+     */
+    bool deferDisconnect();
+
+    /**
+     * Applies the latest sample of the sampler thread to the state of the gamepad.
+     */
+    void applySample();
+
     void setButtons(unsigned int buttons);
 
     void setJoystickValue(unsigned int index, float x, float y);
@@ -211,6 +284,12 @@ private:
     unsigned int _buttons;
     Vector2 _joysticks[2];
     float _triggers[2];
+    double _stateTime;
+    Sample _sample;                           // The state that the sampler thread polls into
+    Sample _samples[3];                       // The samples exchanged between the sampler thread and the main thread
+    std::atomic<unsigned int> _sampleMiddle;  // The index of the latest sample and whether it is new
+    unsigned int _sampleBack;                 // The index of the sample the sampler thread writes
+    unsigned int _sampleFront;                // The index of the sample the main thread reads
 };
 
 }
@@ -0,0 +1,317 @@
+#include "Base.h"
+#include "GlyphCache.h"
+#include "FileSystem.h"
+#include "Game.h"
+
+#ifdef GP_USE_FREETYPE
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#endif
+
+// The width and height of the page that glyphs are rasterised into.
+#define GLYPH_PAGE_SIZE 1024
+
+// The number of pixels around the outline of glyphs that their distance fields cover.
+#define GLYPH_DISTANCE_SPREAD 4
+
+namespace gameplay
+{
+
+static const unsigned int NO_SLOT = std::numeric_limits<unsigned int>::max();
+
+#ifdef GP_USE_FREETYPE
+static FT_Library __library = NULL;
+static unsigned int __libraryUsers = 0;
+#endif
+
+/**
+ * Replaces the coverage of a glyph cell by the distance of each pixel to the outline, searched
+ * within the spread and mapped so that the outline is at the middle of the range, with the
+ * inside of the glyph above it like the distance fields written by the encoder.
+ */
+static void createDistanceField(unsigned char* data, unsigned int width, unsigned int height, int spread)
+{
+    std::vector<unsigned char> coverage(data, data + (size_t)width * height);
+    int maxDistance = spread * spread + 1;
+    for (int y = 0; y < (int)height; ++y)
+    {
+        for (int x = 0; x < (int)width; ++x)
+        {
+            bool inside = coverage[y * width + x] >= 128;
+            int nearest = maxDistance;
+            for (int dy = -spread; dy <= spread; ++dy)
+            {
+                int sy = y + dy;
+                for (int dx = -spread; dx <= spread; ++dx)
+                {
+                    int sx = x + dx;
+                    bool sample = sx >= 0 && sy >= 0 && sx < (int)width && sy < (int)height && coverage[sy * width + sx] >= 128;
+                    if (sample != inside)
+                        nearest = std::min(nearest, dx * dx + dy * dy);
+                }
+            }
+
+            float distance = std::min(sqrtf((float)nearest) - 0.5f, (float)spread);
+            float value = 128.0f + (inside ? distance : -distance) * 127.0f / spread;
+            data[y * width + x] = (unsigned char)std::min(std::max(value, 0.0f), 255.0f);
+        }
+    }
+}
+
+GlyphCache::GlyphCache()
+    : _face(NULL), _fontData(NULL), _size(0), _format(Font::BITMAP), _ascender(0), _cellWidth(0), _padding(0),
+      _columns(0), _slotCapacity(0), _texture(NULL), _generation(0), _warnedFrame(NO_SLOT)
+{
+}
+
+GlyphCache::~GlyphCache()
+{
+    SAFE_RELEASE(_texture);
+#ifdef GP_USE_FREETYPE
+    if (_face)
+    {
+        FT_Done_Face(_face);
+        if (--__libraryUsers == 0)
+        {
+            FT_Done_FreeType(__library);
+            __library = NULL;
+        }
+    }
+#endif
+    SAFE_DELETE_ARRAY(_fontData);
+}
+
+GlyphCache* GlyphCache::create(const char* path, unsigned int size, Font::Format format)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(size);
+
+#ifdef GP_USE_FREETYPE
+    int fileSize = 0;
+    char* fontData = FileSystem::readAll(path, &fileSize);
+    if (fontData == NULL)
+    {
+        GP_WARN("Failed to read font file '%s'.", path);
+        return NULL;
+    }
+
+    if (__library == NULL && FT_Init_FreeType(&__library) != 0)
+    {
+        GP_WARN("Failed to initialize FreeType.");
+        __library = NULL;
+        SAFE_DELETE_ARRAY(fontData);
+        return NULL;
+    }
+
+    FT_Face face = NULL;
+    if (FT_New_Memory_Face(__library, (const FT_Byte*)fontData, fileSize, 0, &face) != 0 || FT_Set_Pixel_Sizes(face, 0, size) != 0)
+    {
+        GP_WARN("Failed to load font file '%s'.", path);
+        if (face)
+            FT_Done_Face(face);
+        if (__libraryUsers == 0)
+        {
+            FT_Done_FreeType(__library);
+            __library = NULL;
+        }
+        SAFE_DELETE_ARRAY(fontData);
+        return NULL;
+    }
+    ++__libraryUsers;
+
+    GlyphCache* cache = new GlyphCache();
+    cache->_face = face;
+    cache->_fontData = fontData;
+    cache->_family = face->family_name ? face->family_name : "";
+    cache->_size = size;
+    cache->_format = format;
+    cache->_ascender = (int)(face->size->metrics.ascender >> 6);
+
+    // Cells are as wide as the widest advance of the font, within twice its size, and padded
+    // so that neither filtering nor the distance fields reach into the neighbouring cells.
+    cache->_cellWidth = std::min(std::max((unsigned int)(face->size->metrics.max_advance >> 6), size), size * 2);
+    cache->_padding = format == Font::DISTANCE_FIELD ? GLYPH_DISTANCE_SPREAD : 1;
+    unsigned int stride = cache->_cellWidth + 2 * cache->_padding;
+    unsigned int rowHeight = size + 2 * cache->_padding;
+    cache->_columns = GLYPH_PAGE_SIZE / stride;
+    cache->_slotCapacity = cache->_columns * (GLYPH_PAGE_SIZE / rowHeight);
+    if (cache->_slotCapacity == 0)
+    {
+        GP_WARN("Font size %u is too large for the glyph page of font file '%s'.", size, path);
+        SAFE_DELETE(cache);
+        return NULL;
+    }
+
+    std::vector<unsigned char> page((size_t)GLYPH_PAGE_SIZE * GLYPH_PAGE_SIZE, 0);
+    cache->_texture = Texture::create(Texture::ALPHA, GLYPH_PAGE_SIZE, GLYPH_PAGE_SIZE, &page[0], false);
+    if (cache->_texture == NULL)
+    {
+        GP_WARN("Failed to create the glyph page of font file '%s'.", path);
+        SAFE_DELETE(cache);
+        return NULL;
+    }
+    return cache;
+#else
+    GP_WARN("Failed to load font file '%s': fonts can only be rasterised at runtime when built with GP_USE_FREETYPE.", path);
+    return NULL;
+#endif
+}
+
+const Font::Glyph* GlyphCache::findGlyph(unsigned int code, unsigned int* slot, bool pin)
+{
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    SlotMap::iterator itr = _codes.find(code);
+    if (itr != _codes.end())
+    {
+        if (itr->second == NO_SLOT)
+            return NULL;
+
+        Slot& s = _slots[itr->second];
+        s.lastUsed = frame;
+        s.pinned = s.pinned || pin;
+        if (slot)
+            *slot = itr->second;
+        return &s.glyph;
+    }
+
+    if (!hasGlyph(code))
+    {
+        _codes[code] = NO_SLOT;
+        return NULL;
+    }
+
+    unsigned int index = allocateSlot(frame);
+    if (index == NO_SLOT)
+    {
+        if (_warnedFrame != frame)
+        {
+            GP_WARN("The glyph page of font '%s' is full with the glyphs drawn this frame.", _family.c_str());
+            _warnedFrame = frame;
+        }
+        return NULL;
+    }
+
+    Slot& s = _slots[index];
+    s.lastUsed = frame;
+    s.pinned = pin;
+    if (!rasterize(code, index))
+    {
+        // The slot stays free for the next glyph.
+        s.glyph.code = 0;
+        s.lastUsed = 0;
+        s.pinned = false;
+        _codes[code] = NO_SLOT;
+        return NULL;
+    }
+    _codes[code] = index;
+    if (slot)
+        *slot = index;
+    return &s.glyph;
+}
+
+bool GlyphCache::hasGlyph(unsigned int code) const
+{
+#ifdef GP_USE_FREETYPE
+    return _face && FT_Get_Char_Index(_face, code) != 0;
+#else
+    return false;
+#endif
+}
+
+void GlyphCache::touch(const std::vector<unsigned int>& slots)
+{
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    for (size_t i = 0, count = slots.size(); i < count; ++i)
+    {
+        GP_ASSERT(slots[i] < _slots.size());
+        _slots[slots[i]].lastUsed = frame;
+    }
+}
+
+unsigned int GlyphCache::allocateSlot(unsigned int frame)
+{
+    // Slots freed by glyphs that failed to rasterise have no code.
+    for (size_t i = 0, count = _slots.size(); i < count; ++i)
+    {
+        if (_slots[i].glyph.code == 0 && !_slots[i].pinned)
+            return (unsigned int)i;
+    }
+    if (_slots.size() < _slotCapacity)
+    {
+        Slot s;
+        memset(&s.glyph, 0, sizeof(s.glyph));
+        s.lastUsed = 0;
+        s.pinned = false;
+        _slots.push_back(s);
+        return (unsigned int)_slots.size() - 1;
+    }
+
+    // Evict the glyph drawn the longest ago, which the layouts drawn since then no longer
+    // point to once the generation changes.
+    unsigned int oldest = NO_SLOT;
+    for (size_t i = 0, count = _slots.size(); i < count; ++i)
+    {
+        const Slot& s = _slots[i];
+        if (!s.pinned && s.lastUsed != frame && (oldest == NO_SLOT || s.lastUsed < _slots[oldest].lastUsed))
+            oldest = (unsigned int)i;
+    }
+    if (oldest != NO_SLOT)
+    {
+        _codes.erase(_slots[oldest].glyph.code);
+        _slots[oldest].glyph.code = 0;
+        ++_generation;
+    }
+    return oldest;
+}
+
+bool GlyphCache::rasterize(unsigned int code, unsigned int slot)
+{
+#ifdef GP_USE_FREETYPE
+    GP_ASSERT(_face);
+    GP_ASSERT(slot < _slots.size());
+
+    if (FT_Load_Char(_face, code, FT_LOAD_RENDER) != 0)
+    {
+        GP_WARN("Failed to rasterise character %u of font '%s'.", code, _family.c_str());
+        return false;
+    }
+
+    // Glyphs are placed in their cell like in the textures of the encoder, with the ascender
+    // of the font at the top of the cell so that the quads of a line share a baseline.
+    FT_GlyphSlot ftGlyph = _face->glyph;
+    const FT_Bitmap& bitmap = ftGlyph->bitmap;
+    unsigned int width = std::min((unsigned int)bitmap.width, _cellWidth);
+    unsigned int stride = _cellWidth + 2 * _padding;
+    unsigned int rowHeight = _size + 2 * _padding;
+    _cell.assign((size_t)stride * rowHeight, 0);
+    int top = _ascender - ftGlyph->bitmap_top;
+    for (int row = 0; row < (int)bitmap.rows; ++row)
+    {
+        int y = top + row;
+        if (y < 0 || y >= (int)_size)
+            continue;
+        memcpy(&_cell[(y + _padding) * stride + _padding], bitmap.buffer + row * bitmap.pitch, width);
+    }
+    if (_format == Font::DISTANCE_FIELD)
+        createDistanceField(&_cell[0], stride, rowHeight, GLYPH_DISTANCE_SPREAD);
+
+    unsigned int x = (slot % _columns) * stride;
+    unsigned int y = (slot / _columns) * rowHeight;
+    _texture->setData(x, y, stride, rowHeight, &_cell[0]);
+
+    Font::Glyph& glyph = _slots[slot].glyph;
+    glyph.code = code;
+    glyph.width = width;
+    glyph.bearingX = (int)(ftGlyph->metrics.horiBearingX >> 6);
+    glyph.advance = (unsigned int)(ftGlyph->metrics.horiAdvance >> 6);
+    glyph.uvs[0] = (float)(x + _padding) / GLYPH_PAGE_SIZE;
+    glyph.uvs[1] = (float)(y + _padding) / GLYPH_PAGE_SIZE;
+    glyph.uvs[2] = (float)(x + _padding + width) / GLYPH_PAGE_SIZE;
+    glyph.uvs[3] = (float)(y + _padding + _size) / GLYPH_PAGE_SIZE;
+    return true;
+#else
+    return false;
+#endif
+}
+
+}
@@ -0,0 +1,130 @@
+#ifndef GLYPHCACHE_H_
+#define GLYPHCACHE_H_
+
+#include "Font.h"
+
+struct FT_FaceRec_;
+
+namespace gameplay
+{
+
+/**
+ * Defines the glyphs of a font file that are rasterised at runtime into a texture page, as
+ * they are first drawn, for the fonts created with Font::createDynamic.
+ *
+ * The page is divided into cells as high as the size of the font, which hold a glyph each.
+ * Once every cell is taken, the glyph drawn the longest ago is evicted for the next one, so
+ * that a font covering thousands of characters, such as a CJK font, only uses the memory of
+ * the characters that are on screen. Glyphs drawn during the current frame are never evicted,
+ * and the printable ASCII characters stay in the page for as long as the font exists.
+ *
+ * With the DISTANCE_FIELD format, glyphs are stored as distance fields, which the font draws
+ * smoothly at any size from the single size they are rasterised at.
+ *
+ * Glyphs are rasterised with FreeType, which the engine uses when built with GP_USE_FREETYPE.
+ */
+class GlyphCache
+{
+    friend class Font;
+
+private:
+
+    /**
+     * A cell of the page.
+     */
+    struct Slot
+    {
+        Font::Glyph glyph;
+        unsigned int lastUsed;
+        bool pinned;
+    };
+
+    /**
+     * The slots of the characters in the page, or NO_SLOT for the characters the font file does not have.
+     */
+    typedef std::unordered_map<unsigned int, unsigned int> SlotMap;
+
+    /**
+     * Constructor.
+     */
+    GlyphCache();
+
+    /**
+     * Destructor.
+     */
+    ~GlyphCache();
+
+    /**
+     * Hidden copy constructor.
+     */
+    GlyphCache(const GlyphCache& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    GlyphCache& operator=(const GlyphCache&);
+
+    /**
+     * Loads a font file to rasterise glyphs from.
+     *
+     * @param path The path of the font file (TrueType or OpenType).
+     * @param size The size in pixels that glyphs are rasterised at.
+     * @param format The format that glyphs are stored in.
+     *
+     * @return The new cache, or NULL if the font file could not be loaded.
+     */
+    static GlyphCache* create(const char* path, unsigned int size, Font::Format format);
+
+    /**
+     * Returns the glyph of a character, rasterising it into the page if it isn't there.
+     *
+     * @param code The code point of the character.
+     * @param slot Set to the slot of the glyph, if not NULL.
+     * @param pin Whether the glyph stays in the page for as long as the cache exists.
+     *
+     * @return The glyph, or NULL if the font file has no glyph for the character or if
+     *         every glyph of the page is used by the current frame.
+     */
+    const Font::Glyph* findGlyph(unsigned int code, unsigned int* slot = NULL, bool pin = false);
+
+    /**
+     * Determines whether the font file has a glyph for a character.
+     */
+    bool hasGlyph(unsigned int code) const;
+
+    /**
+     * Marks the glyphs in the given slots as used by the current frame.
+     */
+    void touch(const std::vector<unsigned int>& slots);
+
+    /**
+     * Returns a free slot, evicting the glyph drawn the longest ago if there is none.
+     */
+    unsigned int allocateSlot(unsigned int frame);
+
+    /**
+     * Rasterises the glyph of a character into a slot of the page.
+     */
+    bool rasterize(unsigned int code, unsigned int slot);
+
+    FT_FaceRec_* _face;
+    char* _fontData;
+    std::string _family;
+    unsigned int _size;
+    Font::Format _format;
+    int _ascender;
+    unsigned int _cellWidth;
+    unsigned int _padding;
+    unsigned int _columns;
+    unsigned int _slotCapacity;
+    Texture* _texture;
+    std::vector<Slot> _slots;
+    SlotMap _codes;
+    std::vector<unsigned char> _cell;
+    unsigned int _generation;
+    unsigned int _warnedFrame;
+};
+
+}
+
+#endif
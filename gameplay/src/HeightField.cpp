@@ -3,6 +3,14 @@
 #include "Image.h"
 #include "FileSystem.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define HEIGHTFIELD_USE_SSE
+#elif defined(GP_USE_NEON) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define HEIGHTFIELD_USE_NEON
+#endif
+
 namespace gameplay
 {
 
@@ -203,6 +211,107 @@ float HeightField::getHeight(float column, float row) const
     }
 }
 
+void HeightField::getHeights(const float* columns, const float* rows, float* heights, unsigned int count) const
+{
+    GP_ASSERT(columns);
+    GP_ASSERT(rows);
+    GP_ASSERT(heights);
+
+    if (_cols < 2 || _rows < 2)
+    {
+        for (unsigned int i = 0; i < count; ++i)
+            heights[i] = getHeight(columns[i], rows[i]);
+        return;
+    }
+
+    // The cell of a point on the last row or column is the one before it with an
+    // interpolation factor of one, so every point reads the same four heights.
+    const float maxColumn = (float)(_cols - 1);
+    const float maxRow = (float)(_rows - 1);
+    const float lastCellColumn = (float)(_cols - 2);
+    const float lastCellRow = (float)(_rows - 2);
+    unsigned int i = 0;
+
+#if defined(HEIGHTFIELD_USE_SSE) || defined(HEIGHTFIELD_USE_NEON)
+    int x[4];
+    int y[4];
+    float h00[4];
+    float h01[4];
+    float h10[4];
+    float h11[4];
+#if defined(HEIGHTFIELD_USE_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 maxX = _mm_set1_ps(maxColumn);
+    const __m128 maxY = _mm_set1_ps(maxRow);
+    const __m128 cellX = _mm_set1_ps(lastCellColumn);
+    const __m128 cellY = _mm_set1_ps(lastCellRow);
+#else
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float32x4_t maxX = vdupq_n_f32(maxColumn);
+    const float32x4_t maxY = vdupq_n_f32(maxRow);
+    const float32x4_t cellX = vdupq_n_f32(lastCellColumn);
+    const float32x4_t cellY = vdupq_n_f32(lastCellRow);
+#endif
+    for (; i + 4 <= count; i += 4)
+    {
+#if defined(HEIGHTFIELD_USE_SSE)
+        __m128 column = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(columns + i), zero), maxX);
+        __m128 row = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(rows + i), zero), maxY);
+        __m128i x1 = _mm_cvttps_epi32(_mm_min_ps(column, cellX));
+        __m128i y1 = _mm_cvttps_epi32(_mm_min_ps(row, cellY));
+        __m128 xFactor = _mm_sub_ps(column, _mm_cvtepi32_ps(x1));
+        __m128 yFactor = _mm_sub_ps(row, _mm_cvtepi32_ps(y1));
+        _mm_storeu_si128((__m128i*)x, x1);
+        _mm_storeu_si128((__m128i*)y, y1);
+#else
+        float32x4_t column = vminq_f32(vmaxq_f32(vld1q_f32(columns + i), zero), maxX);
+        float32x4_t row = vminq_f32(vmaxq_f32(vld1q_f32(rows + i), zero), maxY);
+        int32x4_t x1 = vcvtq_s32_f32(vminq_f32(column, cellX));
+        int32x4_t y1 = vcvtq_s32_f32(vminq_f32(row, cellY));
+        float32x4_t xFactor = vsubq_f32(column, vcvtq_f32_s32(x1));
+        float32x4_t yFactor = vsubq_f32(row, vcvtq_f32_s32(y1));
+        vst1q_s32(x, x1);
+        vst1q_s32(y, y1);
+#endif
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            const float* cell = _array + x[j] + y[j] * _cols;
+            h00[j] = cell[0];
+            h10[j] = cell[1];
+            h01[j] = cell[_cols];
+            h11[j] = cell[_cols + 1];
+        }
+#if defined(HEIGHTFIELD_USE_SSE)
+        __m128 a = _mm_loadu_ps(h00);
+        __m128 b = _mm_loadu_ps(h01);
+        a = _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(h10), a), xFactor));
+        b = _mm_add_ps(b, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(h11), b), xFactor));
+        _mm_storeu_ps(heights + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(b, a), yFactor)));
+#else
+        float32x4_t a = vld1q_f32(h00);
+        float32x4_t b = vld1q_f32(h01);
+        a = vmlaq_f32(a, vsubq_f32(vld1q_f32(h10), a), xFactor);
+        b = vmlaq_f32(b, vsubq_f32(vld1q_f32(h11), b), xFactor);
+        vst1q_f32(heights + i, vmlaq_f32(a, vsubq_f32(b, a), yFactor));
+#endif
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        float column = columns[i] < 0 ? 0 : (columns[i] > maxColumn ? maxColumn : columns[i]);
+        float row = rows[i] < 0 ? 0 : (rows[i] > maxRow ? maxRow : rows[i]);
+        unsigned int x1 = (unsigned int)(column < lastCellColumn ? column : lastCellColumn);
+        unsigned int y1 = (unsigned int)(row < lastCellRow ? row : lastCellRow);
+        float xFactor = column - x1;
+        float yFactor = row - y1;
+        const float* cell = _array + x1 + y1 * _cols;
+        float a = cell[0] + (cell[1] - cell[0]) * xFactor;
+        float b = cell[_cols] + (cell[_cols + 1] - cell[_cols]) * xFactor;
+        heights[i] = a + (b - a) * yFactor;
+    }
+}
+
 unsigned int HeightField::getColumnCount() const
 {
     return _cols;
@@ -99,6 +99,21 @@ namespace gameplay
          */
         float getHeight(float column, float row) const;
 
+        /**
+         * Returns the interpolated heights at a number of rows and columns at once.
+         *
+         * The results are the same as calling getHeight for every point, but the interpolation
+         * of each group of four points is done with SIMD instructions where they are available.
+         *
+         * @param columns The columns of the height values to query.
+         * @param rows The rows of the height values to query.
+         * @param heights Receives the height values.
+         * @param count The number of points to query.
+         *
+         * @script{ignore}
+         */
+        void getHeights(const float* columns, const float* rows, float* heights, unsigned int count) const;
+
         /**
          * Returns the number of rows in the heightfield.
          *
@@ -0,0 +1,129 @@
+#include "Base.h"
+#include "IOQueue.h"
+#include "FileSystem.h"
+#include "Game.h"
+
+namespace gameplay
+{
+
+IOQueue::IOQueue()
+{
+}
+
+IOQueue::~IOQueue()
+{
+    // Workers may still be reading, so every file is waited for before it is deleted.
+    JobController* jobs = Game::getInstance()->getJobController();
+    for (size_t i = 0, count = _files.size(); i < count; ++i)
+    {
+        if (_files[i]->queued)
+            jobs->wait(&_files[i]->group);
+        SAFE_DELETE(_files[i]);
+    }
+}
+
+IOQueue::File* IOQueue::find(const char* path) const
+{
+    std::unordered_map<std::string, File*>::const_iterator itr = _paths.find(path);
+    return itr != _paths.end() ? itr->second : NULL;
+}
+
+void IOQueue::read(const char* path)
+{
+    GP_ASSERT(path);
+
+    if (strlen(path) == 0 || find(path))
+        return;
+
+    File* file = new File(path);
+    file->queued = true;
+    file->submitTime = Game::getAbsoluteTime();
+    _files.push_back(file);
+    _paths[file->path] = file;
+    Game::getInstance()->getJobController()->submit(file, &file->group);
+}
+
+void IOQueue::wait(const char* path)
+{
+    GP_ASSERT(path);
+
+    File* file = find(path);
+    if (file == NULL || !file->queued || file->group.isComplete())
+        return;
+
+    double start = Game::getAbsoluteTime();
+    Game::getInstance()->getJobController()->wait(&file->group);
+    file->waitTime += (float)(Game::getAbsoluteTime() - start);
+}
+
+void IOQueue::addLoadTime(const char* path, float milliseconds)
+{
+    GP_ASSERT(path);
+
+    File* file = find(path);
+    if (file == NULL)
+    {
+        file = new File(path);
+        _files.push_back(file);
+        _paths[file->path] = file;
+    }
+    file->loadTime += milliseconds;
+}
+
+unsigned int IOQueue::getFileCount() const
+{
+    return (unsigned int)_files.size();
+}
+
+void IOQueue::print(const char* name) const
+{
+    struct Timing
+    {
+        float total;
+        const File* file;
+        bool operator<(const Timing& other) const { return total > other.total; }
+    };
+    std::vector<Timing> timings;
+    size_t size = 0;
+    float readTime = 0.0f;
+    float waitTime = 0.0f;
+    float loadTime = 0.0f;
+    for (size_t i = 0, count = _files.size(); i < count; ++i)
+    {
+        const File* file = _files[i];
+        if (file->queued && !file->group.isComplete())
+            continue;
+
+        Timing timing = { file->readTime + file->loadTime, file };
+        timings.push_back(timing);
+        size += file->size;
+        readTime += file->readTime;
+        waitTime += file->waitTime;
+        loadTime += file->loadTime;
+    }
+    std::sort(timings.begin(), timings.end());
+
+    Logger::log(Logger::LEVEL_INFO, "%s: %u files, %.2f MB, %.2f ms read, %.2f ms waited, %.2f ms loaded\n",
+        name ? name : "IOQueue", (unsigned int)timings.size(), size / (1024.0 * 1024.0), readTime, waitTime, loadTime);
+    for (size_t i = 0, count = timings.size(); i < count; ++i)
+    {
+        const File* file = timings[i].file;
+        Logger::log(Logger::LEVEL_INFO, "  %8.2f ms queued %8.2f ms read %8.2f ms waited %8.2f ms loaded %10u bytes  %s\n",
+            file->queueTime, file->readTime, file->waitTime, file->loadTime, (unsigned int)file->size, file->path.c_str());
+    }
+}
+
+IOQueue::File::File(const char* path)
+    : path(path), queued(false), size(0), submitTime(0.0), queueTime(0.0f), readTime(0.0f), waitTime(0.0f), loadTime(0.0f)
+{
+}
+
+void IOQueue::File::execute(unsigned int worker)
+{
+    double start = Game::getAbsoluteTime();
+    queueTime = (float)(start - submitTime);
+    size = FileSystem::prefetch(path.c_str());
+    readTime = (float)(Game::getAbsoluteTime() - start);
+}
+
+}
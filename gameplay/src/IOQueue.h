@@ -0,0 +1,122 @@
+#ifndef IOQUEUE_H_
+#define IOQUEUE_H_
+
+#include "JobController.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a queue of file reads that run on the workers of the job controller.
+ *
+ * All the files that a load needs are queued up front, so that reading them from the disk
+ * overlaps with parsing the ones that have already been read, instead of each file being
+ * opened and parsed one after the other. Files are read through the operating system cache
+ * with FileSystem::prefetch, so opening them once their read has completed doesn't wait
+ * for the disk.
+ *
+ * The queue records how long each file took to read, how long the loading thread waited
+ * for it, and how long it took to load once it was read, so that slow assets can be found.
+ *
+ * @script{ignore}
+ */
+class IOQueue
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    IOQueue();
+
+    /**
+     * Destructor.
+     *
+     * Waits for the reads that are still pending.
+     */
+    ~IOQueue();
+
+    /**
+     * Queues a read of the file at the given path, unless it is already queued.
+     *
+     * @param path The path of the file.
+     */
+    void read(const char* path);
+
+    /**
+     * Waits until the file at the given path has been read, and records the time spent waiting.
+     *
+     * Files that were not queued are not waited for.
+     *
+     * @param path The path of the file.
+     */
+    void wait(const char* path);
+
+    /**
+     * Records time spent loading the file at the given path after it was read, such as parsing it.
+     *
+     * The time is added to that of the file, which is added to the queue if it wasn't.
+     *
+     * @param path The path of the file.
+     * @param milliseconds The time in milliseconds spent loading the file.
+     */
+    void addLoadTime(const char* path, float milliseconds);
+
+    /**
+     * Returns the number of files in the queue.
+     *
+     * @return The number of files.
+     */
+    unsigned int getFileCount() const;
+
+    /**
+     * Logs the timings of each file in the queue, the slowest first.
+     *
+     * @param name The name of the load to log the timings under.
+     */
+    void print(const char* name) const;
+
+private:
+
+    /**
+     * A file in the queue, which is the job that reads it.
+     */
+    class File : public JobController::Job
+    {
+    public:
+        File(const char* path);
+        void execute(unsigned int worker);
+
+        std::string path;
+        JobController::Group group;
+        bool queued;
+        size_t size;
+        double submitTime;
+        float queueTime;
+        float readTime;
+        float waitTime;
+        float loadTime;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    IOQueue(const IOQueue&);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    IOQueue& operator=(const IOQueue&);
+
+    /**
+     * Returns the file with the given path, or NULL if it isn't in the queue.
+     */
+    File* find(const char* path) const;
+
+    std::vector<File*> _files;
+    std::unordered_map<std::string, File*> _paths;
+};
+
+}
+
+#endif
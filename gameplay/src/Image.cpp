@@ -14,6 +14,28 @@ static void readStream(png_structp png, png_bytep data, png_size_t length)
     }
 }
 
+/**
+ * The data of a png image held in memory, such as in a mapped file or a pack.
+ */
+struct PNGMemory
+{
+    const unsigned char* data;
+    size_t size;
+    size_t position;
+};
+
+// Callback for reading a png image held in memory, without the virtual reads of a stream.
+static void readMemory(png_structp png, png_bytep data, png_size_t length)
+{
+    PNGMemory* memory = reinterpret_cast<PNGMemory*>(png_get_io_ptr(png));
+    if (memory == NULL || memory->size - memory->position < length)
+    {
+        png_error(png, "Error reading PNG.");
+    }
+    memcpy(data, memory->data + memory->position, length);
+    memory->position += length;
+}
+
 Image* Image::create(const char* path)
 {
     GP_ASSERT(path);
@@ -51,24 +73,52 @@ Image* Image::create(const char* path)
         return NULL;
     }
 
+    // The image is created before setjmp so that it can be released when decoding fails.
+    Image* image = new Image();
+    std::vector<png_bytep> rows;
+
     // Set up error handling (required without using custom error handlers above).
     if (setjmp(png_jmpbuf(png)))
     {
-        GP_ERROR("Failed to set up error handling for reading PNG file '%s'.", path);
+        GP_ERROR("Failed to read PNG file '%s'.", path);
         png_destroy_read_struct(&png, &info, NULL);
+        SAFE_RELEASE(image);
         return NULL;
     }
 
-    // Initialize file io.
-    png_set_read_fn(png, stream.get(), readStream);
+    // Initialize file io, reading straight from memory when the stream holds the whole file.
+    PNGMemory memory;
+    memory.data = (const unsigned char*)stream->getData();
+    if (memory.data)
+    {
+        memory.size = stream->length();
+        memory.position = 8;
+        png_set_read_fn(png, &memory, readMemory);
+    }
+    else
+    {
+        png_set_read_fn(png, stream.get(), readStream);
+    }
 
     // Indicate that we already read the first 8 bytes (signature).
     png_set_sig_bytes(png, 8);
 
-    // Read the entire image into memory.
-    png_read_png(png, info, PNG_TRANSFORM_STRIP_16 | PNG_TRANSFORM_PACKING | PNG_TRANSFORM_EXPAND | PNG_TRANSFORM_GRAY_TO_RGB, NULL);
+    // Images are game assets, so the checksums of their chunks and compressed data are not
+    // verified, which saves a pass over the data of each.
+    png_set_crc_action(png, PNG_CRC_QUIET_USE, PNG_CRC_QUIET_USE);
+#if defined(PNG_IGNORE_ADLER32) && defined(PNG_SET_OPTION_SUPPORTED)
+    png_set_option(png, PNG_IGNORE_ADLER32, PNG_OPTION_ON);
+#endif
+
+    // Expand every color type to 8 bit RGB or RGBA.
+    png_read_info(png, info);
+    png_set_strip_16(png);
+    png_set_packing(png);
+    png_set_expand(png);
+    png_set_gray_to_rgb(png);
+    png_set_interlace_handling(png);
+    png_read_update_info(png, info);
 
-    Image* image = new Image();
     image->_width = png_get_image_width(png, info);
     image->_height = png_get_image_height(png, info);
 
@@ -86,6 +136,7 @@ Image* Image::create(const char* path)
     default:
         GP_ERROR("Unsupported PNG color type (%d) for image file '%s'.", (int)colorType, path);
         png_destroy_read_struct(&png, &info, NULL);
+        SAFE_RELEASE(image);
         return NULL;
     }
 
@@ -94,12 +145,14 @@ Image* Image::create(const char* path)
     // Allocate image data.
     image->_data = new unsigned char[stride * image->_height];
 
-    // Read rows into image data.
-    png_bytepp rows = png_get_rows(png, info);
+    // Decode the rows straight into the image data, from the bottom row up.
+    rows.resize(image->_height);
     for (unsigned int i = 0; i < image->_height; ++i)
     {
-        memcpy(image->_data+(stride * (image->_height-1-i)), rows[i], stride);
+        rows[i] = image->_data + stride * (image->_height - 1 - i);
     }
+    png_read_image(png, &rows[0]);
+    png_read_end(png, NULL);
 
     // Clean up.
     png_destroy_read_struct(&png, &info, NULL);
@@ -27,6 +27,9 @@ public:
     /**
      * Creates an image from the image file at the given path.
      *
+     * The image is decoded straight into its data, and can be created on any thread,
+     * such as the workers of the job controller.
+     *
      * @param path The path to the image file.
      * @return The newly created image.
      * @script{create}
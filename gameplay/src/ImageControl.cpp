@@ -6,13 +6,15 @@ namespace gameplay
 
 ImageControl::ImageControl() :
     _srcRegion(Rectangle::empty()), _dstRegion(Rectangle::empty()), _batch(NULL),
-    _tw(0.0f), _th(0.0f), _uvs(Theme::UVs::full())
+    _atlas(NULL), _tw(0.0f), _th(0.0f), _uvs(Theme::UVs::full())
 {
 }
 
 ImageControl::~ImageControl()
 {
-    SAFE_DELETE(_batch);
+    if (!_atlas)
+        SAFE_DELETE(_batch);
+    SAFE_RELEASE(_atlas);
 }
 
 ImageControl* ImageControl::create(const char* id, Theme::Style* style)
@@ -65,13 +67,43 @@ const char* ImageControl::getTypeName() const
 
 void ImageControl::setImage(const char* path)
 {
-    SAFE_DELETE(_batch);
-    Texture* texture = Texture::create(path);
-    _batch = SpriteBatch::create(texture);
+    if (!_atlas)
+        SAFE_DELETE(_batch);
+    SAFE_RELEASE(_atlas);
+
+    // Images packed into an atlas draw with the batch of their page, which the image
+    // controls and themes of a form that use the same page share.
+    TextureAtlas::Region region;
+    _atlas = TextureAtlas::find(path, &region);
+    if (_atlas)
+    {
+        _atlas->addRef();
+        _batch = _atlas->getSpriteBatch(region.page);
+        _imageBounds = region.bounds;
+    }
+    else
+    {
+        Texture* texture = Texture::create(path);
+        _batch = SpriteBatch::create(texture);
+        _imageBounds.set(0, 0, texture->getWidth(), texture->getHeight());
+        texture->release();
+    }
+    Texture* texture = _batch->getSampler()->getTexture();
     _tw = 1.0f / texture->getWidth();
     _th = 1.0f / texture->getHeight();
-    texture->release();
+    if (_srcRegion.isEmpty())
+    {
+        _uvs.u1 = _imageBounds.x * _tw;
+        _uvs.u2 = (_imageBounds.x + _imageBounds.width) * _tw;
+        _uvs.v1 = 1.0f - (_imageBounds.y * _th);
+        _uvs.v2 = 1.0f - ((_imageBounds.y + _imageBounds.height) * _th);
+    }
+    else
+    {
+        setRegionSrc(_srcRegion);
+    }
 
+    setGeometryDirty();
     if (_autoSize != AUTO_SIZE_NONE)
         setDirty(DIRTY_BOUNDS);
 }
@@ -80,10 +112,14 @@ void ImageControl::setRegionSrc(float x, float y, float width, float height)
 {
     _srcRegion.set(x, y, width, height);
 
+    // The source region is relative to the image, wherever it is in its texture.
+    x += _imageBounds.x;
+    y += _imageBounds.y;
     _uvs.u1 = x * _tw;
     _uvs.u2 = (x + width) * _tw;
     _uvs.v1 = 1.0f - (y * _th);
     _uvs.v2 = 1.0f - ((y + height) * _th);
+    setGeometryDirty();
 }
 
 void ImageControl::setRegionSrc(const Rectangle& region)
@@ -99,6 +135,7 @@ const Rectangle& ImageControl::getRegionSrc() const
 void ImageControl::setRegionDst(float x, float y, float width, float height)
 {
     _dstRegion.set(x, y, width, height);
+    setGeometryDirty();
 }
 
 void ImageControl::setRegionDst(const Rectangle& region)
@@ -144,12 +181,12 @@ void ImageControl::updateBounds()
     {
         if (_autoSize & AUTO_SIZE_WIDTH)
         {
-            setWidthInternal(_batch->getSampler()->getTexture()->getWidth());
+            setWidthInternal(_imageBounds.width);
         }
 
         if (_autoSize & AUTO_SIZE_HEIGHT)
         {
-            setHeightInternal(_batch->getSampler()->getTexture()->getWidth());
+            setHeightInternal(_imageBounds.height);
         }
     }
 
@@ -5,6 +5,7 @@
 #include "Theme.h"
 #include "Image.h"
 #include "SpriteBatch.h"
+#include "TextureAtlas.h"
 #include "Rectangle.h"
 
 namespace gameplay
@@ -143,6 +144,10 @@ private:
     // Destination region.
     Rectangle _dstRegion;
     SpriteBatch* _batch;
+    // The atlas whose shared batch draws the image, or NULL if the batch is owned.
+    TextureAtlas* _atlas;
+    // The bounds of the image in its texture.
+    Rectangle _imageBounds;
 
     // One over texture width and height, for use when calculating UVs from a new source region.
     float _tw;
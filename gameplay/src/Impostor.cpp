@@ -0,0 +1,228 @@
+#include "Base.h"
+#include "Impostor.h"
+#include "Camera.h"
+#include "DepthStencilTarget.h"
+#include "FrameBuffer.h"
+#include "Game.h"
+#include "Model.h"
+#include "Node.h"
+#include "Scene.h"
+
+namespace gameplay
+{
+
+static unsigned int __impostorCount = 0;
+
+// Returns the world bounds of the mesh of the model of the given node.
+static BoundingSphere getModelBounds(Node* node)
+{
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    GP_ASSERT(model);
+
+    BoundingSphere bounds(model->getMesh()->getBoundingSphere());
+    bounds.transform(node->getWorldMatrix());
+    return bounds;
+}
+
+Impostor::Impostor()
+    : _viewCount(0), _cellSize(0), _columns(0), _rows(0), _batch(NULL)
+{
+}
+
+Impostor::~Impostor()
+{
+    SAFE_DELETE(_batch);
+}
+
+Impostor* Impostor::create(Node* node, unsigned int viewCount, unsigned int cellSize)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(viewCount > 0);
+    GP_ASSERT(cellSize > 0);
+
+    if (!dynamic_cast<Model*>(node->getDrawable()))
+    {
+        GP_WARN("Failed to create impostor for node '%s', which has no model.", node->getId());
+        return NULL;
+    }
+
+    // Render a copy of the node without its transform, in a scene of its own. The copy
+    // always draws its mesh, and the scene keeps it alive until it is released.
+    Scene* scene = Scene::create();
+    Node* copy = node->clone();
+    copy->setIdentity();
+    Model* model = static_cast<Model*>(copy->getDrawable());
+    model->setImpostor(NULL, 0.0f);
+    scene->addNode(copy);
+    copy->release();
+    if (node->getScene())
+    {
+        const Vector3& ambient = node->getScene()->getAmbientColor();
+        scene->setAmbientColor(ambient.x, ambient.y, ambient.z);
+    }
+
+    BoundingSphere bounds = getModelBounds(copy);
+    if (bounds.radius <= 0.0f)
+    {
+        GP_WARN("Failed to create impostor for node '%s', which has empty bounds.", node->getId());
+        SAFE_RELEASE(scene);
+        return NULL;
+    }
+
+    // The views are laid out in a grid of cells that is close to square.
+    unsigned int columns = 1;
+    while (columns * columns < viewCount)
+        ++columns;
+    unsigned int rows = (viewCount + columns - 1) / columns;
+    unsigned int width = columns * cellSize;
+    unsigned int height = rows * cellSize;
+
+    char id[32];
+    sprintf(id, "impostor%u", __impostorCount++);
+    FrameBuffer* frameBuffer = FrameBuffer::create(id, width, height, Texture::RGBA);
+    if (!frameBuffer)
+    {
+        GP_WARN("Failed to create frame buffer for impostor of node '%s'.", node->getId());
+        SAFE_RELEASE(scene);
+        return NULL;
+    }
+    DepthStencilTarget* depthTarget = DepthStencilTarget::create(id, DepthStencilTarget::DEPTH, width, height);
+    frameBuffer->setDepthStencilTarget(depthTarget);
+    SAFE_RELEASE(depthTarget);
+
+    // An orthographic camera circles the node at twice the radius of its bounds, looking
+    // at their center, so that the bounds exactly fill each cell.
+    float radius = bounds.radius;
+    Camera* camera = Camera::createOrthographic(radius * 2.0f, radius * 2.0f, 1.0f, radius * 0.5f, radius * 4.0f);
+    Node* cameraNode = scene->addNode("camera");
+    cameraNode->setCamera(camera);
+    scene->setActiveCamera(camera);
+    SAFE_RELEASE(camera);
+
+    Game* game = Game::getInstance();
+    Rectangle viewport = game->getViewport();
+    FrameBuffer* previousFrameBuffer = frameBuffer->bind();
+    game->setViewport(Rectangle(0, 0, (float)width, (float)height));
+    game->clear(Game::CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+
+    for (unsigned int i = 0; i < viewCount; ++i)
+    {
+        // View i looks at the node from the angle i / viewCount of a full turn around its
+        // up axis, starting at its local Z axis.
+        float angle = MATH_PIX2 * i / viewCount;
+        cameraNode->setRotation(Vector3::unitY(), angle);
+        cameraNode->setTranslation(bounds.center + Vector3(sinf(angle), 0.0f, cosf(angle)) * (radius * 2.0f));
+
+        game->setViewport(Rectangle((float)((i % columns) * cellSize), (float)((i / columns) * cellSize), (float)cellSize, (float)cellSize));
+        model->draw();
+    }
+
+    previousFrameBuffer->bind();
+    game->setViewport(viewport);
+
+    Impostor* impostor = new Impostor();
+    impostor->_viewCount = viewCount;
+    impostor->_cellSize = cellSize;
+    impostor->_columns = columns;
+    impostor->_rows = rows;
+    impostor->_batch = SpriteBatch::create(frameBuffer->getRenderTarget(0)->getTexture());
+    impostor->_batch->getSampler()->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+    impostor->_batch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+
+    // Quads are sorted back to front, so they are blended without writing depth.
+    impostor->_batch->getStateBlock()->setDepthTest(true);
+    impostor->_batch->getStateBlock()->setDepthWrite(false);
+
+    SAFE_RELEASE(frameBuffer);
+    SAFE_RELEASE(scene);
+    return impostor;
+}
+
+Texture* Impostor::getTexture() const
+{
+    return _batch->getSampler()->getTexture();
+}
+
+unsigned int Impostor::getViewCount() const
+{
+    return _viewCount;
+}
+
+void Impostor::add(Node* node)
+{
+    GP_ASSERT(node);
+
+    Entry entry;
+    entry.node = node;
+    entry.distance = 0.0f;
+    _entries.push_back(entry);
+}
+
+unsigned int Impostor::getQueuedCount() const
+{
+    return (unsigned int)_entries.size();
+}
+
+unsigned int Impostor::draw(Camera* camera)
+{
+    GP_PROFILE("Impostor::draw");
+
+    if (_entries.empty() || !camera)
+    {
+        _entries.clear();
+        return 0;
+    }
+
+    Vector3 eye = camera->getNode() ? camera->getNode()->getTranslationWorld() : Vector3::zero();
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        _entries[i].bounds = getModelBounds(_entries[i].node);
+        _entries[i].distance = eye.distanceSquared(_entries[i].bounds.center);
+    }
+    std::sort(_entries.begin(), _entries.end(), [](const Entry& a, const Entry& b) { return a.distance > b.distance; });
+
+    float u = 1.0f / _columns;
+    float v = 1.0f / _rows;
+    float step = MATH_PIX2 / _viewCount;
+    _batch->setProjectionMatrix(camera->getViewProjectionMatrix());
+    _batch->start();
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        Node* node = _entries[i].node;
+        const BoundingSphere& bounds = _entries[i].bounds;
+
+        // The quad only rotates about the up axis of the node, like the camera of the views.
+        Vector3 up = node->getUpVectorWorld();
+        up.normalize();
+        Vector3 toCamera = eye - bounds.center;
+        toCamera -= up * Vector3::dot(toCamera, up);
+        Vector3 back = -node->getForwardVectorWorld();
+        back -= up * Vector3::dot(back, up);
+        back.normalize();
+        if (toCamera.lengthSquared() < MATH_EPSILON)
+            toCamera = back;
+        toCamera.normalize();
+        Vector3 right;
+        Vector3::cross(up, toCamera, &right);
+        Vector3 side;
+        Vector3::cross(up, back, &side);
+
+        // Pick the view whose angle around the up axis is closest to that of the camera.
+        float angle = atan2f(Vector3::dot(toCamera, side), Vector3::dot(toCamera, back));
+        int view = (int)floorf(angle / step + 0.5f) % (int)_viewCount;
+        if (view < 0)
+            view += _viewCount;
+        float u1 = (view % _columns) * u;
+        float v1 = (view / _columns) * v;
+
+        float size = bounds.radius * 2.0f;
+        _batch->draw(bounds.center, right, up, size, size, u1, v1, u1 + u, v1 + v, Vector4::one(), Vector2::zero(), 0.0f);
+    }
+    _batch->finish();
+
+    unsigned int count = (unsigned int)_entries.size();
+    _entries.clear();
+    return count;
+}
+
+}
@@ -0,0 +1,133 @@
+#ifndef IMPOSTOR_H_
+#define IMPOSTOR_H_
+
+#include "Ref.h"
+#include "Texture.h"
+#include "SpriteBatch.h"
+#include "BoundingSphere.h"
+
+namespace gameplay
+{
+
+class Camera;
+class Node;
+
+/**
+ * Defines a set of pre-rendered views of a model that is drawn as a camera-facing
+ * quad in place of the model when it is far away.
+ *
+ * An impostor renders a copy of the model of a node into the cells of an atlas texture
+ * when it is created, once for each of a number of views spread evenly around
+ * the up axis of the node. Models that are given the impostor through Model::setImpostor
+ * add their node to the impostor instead of drawing their mesh once they are further
+ * from the active camera than the impostor distance. Calling draw after the scene has
+ * been drawn then draws all of the nodes that were added as a single batch of quads,
+ * which rotate about the up axis of each node to face the camera and show the view
+ * whose angle is closest to the direction of the camera.
+ *
+ * The quad of a node covers the bounding sphere of the mesh of its model. Impostors suit models that
+ * are seen from the side and look similar from nearby angles, such as trees, rocks and
+ * buildings. Lighting is baked into the atlas with the light parameters that the
+ * materials of the node had when the impostor was created.
+ *
+ * @script{ignore}
+ */
+class Impostor : public Ref
+{
+public:
+
+    /**
+     * Creates an impostor by rendering the model of the given node into an atlas.
+     *
+     * The node is cloned into a separate scene for rendering, so its own transform and
+     * scene are not modified.
+     *
+     * @param node The node whose model to render the views of.
+     * @param viewCount The number of views around the up axis of the node.
+     * @param cellSize The width and height of the atlas cell of each view, in pixels.
+     *
+     * @return The new impostor, or NULL if it could not be rendered.
+     */
+    static Impostor* create(Node* node, unsigned int viewCount = 8, unsigned int cellSize = 128);
+
+    /**
+     * Returns the atlas texture that holds the views of the model.
+     *
+     * @return The atlas texture.
+     */
+    Texture* getTexture() const;
+
+    /**
+     * Returns the number of views around the up axis of the model.
+     *
+     * @return The number of views.
+     */
+    unsigned int getViewCount() const;
+
+    /**
+     * Adds a node to be drawn with this impostor by the next call to draw.
+     *
+     * @param node The node of a model to draw as an impostor, which must remain valid until draw is called.
+     */
+    void add(Node* node);
+
+    /**
+     * Returns the number of nodes that were added since the last call to draw.
+     *
+     * @return The number of queued nodes.
+     */
+    unsigned int getQueuedCount() const;
+
+    /**
+     * Draws the nodes added since the last call to draw as camera-facing quads, from
+     * back to front, and then removes them.
+     *
+     * @param camera The camera to draw the quads for.
+     *
+     * @return The number of impostors drawn.
+     */
+    unsigned int draw(Camera* camera);
+
+private:
+
+    /**
+     * A node added to the impostor, with its bounds and distance to the camera for sorting.
+     */
+    struct Entry
+    {
+        Node* node;
+        BoundingSphere bounds;
+        float distance;
+    };
+
+    /**
+     * Constructor.
+     */
+    Impostor();
+
+    /**
+     * Destructor.
+     */
+    ~Impostor();
+
+    /**
+     * Hidden copy constructor.
+     */
+    Impostor(const Impostor& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    Impostor& operator=(const Impostor&);
+
+    unsigned int _viewCount;
+    unsigned int _cellSize;
+    unsigned int _columns;
+    unsigned int _rows;
+    SpriteBatch* _batch;
+    std::vector<Entry> _entries;
+};
+
+}
+
+#endif
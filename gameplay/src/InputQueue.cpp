@@ -0,0 +1,239 @@
+#include "Base.h"
+#include "InputQueue.h"
+#include "Platform.h"
+#include "Game.h"
+
+namespace gameplay
+{
+
+/**
+ * The kinds of queued input events.
+ */
+enum InputEventType
+{
+    INPUT_MOUSE,
+    INPUT_TOUCH,
+    INPUT_KEY
+};
+
+/**
+ * A queued input event.
+ */
+struct InputEvent
+{
+    InputEventType type;
+    int evt;
+    int x;
+    int y;
+    int value;
+    bool relative;
+    bool touch;
+};
+
+static bool __buffered = true;
+static bool __rawSamples = false;
+static bool __dispatching = false;
+static std::vector<InputEvent> __events;
+static std::vector<InputEvent> __dispatchedEvents;
+static std::vector<InputQueue::Sample> __samples;
+static std::vector<InputQueue::Sample> __dispatchedSamples;
+static unsigned int __coalescedCount = 0;
+static unsigned int __dispatchedCoalescedCount = 0;
+
+/**
+ * Replaces or adds to a queued move of the same pointer, if only moves follow it.
+ *
+ * @return true if the move was coalesced.
+ */
+static bool coalesce(const InputEvent& event)
+{
+    for (size_t i = __events.size(); i > 0; --i)
+    {
+        InputEvent& queued = __events[i - 1];
+        bool move = (queued.type == INPUT_MOUSE && queued.evt == Mouse::MOUSE_MOVE) || (queued.type == INPUT_TOUCH && queued.evt == Touch::TOUCH_MOVE);
+        if (!move)
+            return false;
+
+        if (queued.type == event.type && queued.value == event.value && queued.relative == event.relative && queued.touch == event.touch)
+        {
+            if (event.relative)
+            {
+                queued.x += event.x;
+                queued.y += event.y;
+            }
+            else
+            {
+                queued.x = event.x;
+                queued.y = event.y;
+            }
+            ++__coalescedCount;
+            return true;
+        }
+    }
+    return false;
+}
+
+void InputQueue::setBuffered(bool buffered)
+{
+    if (__buffered && !buffered)
+        dispatch();
+    __buffered = buffered;
+}
+
+bool InputQueue::isBuffered()
+{
+    return __buffered;
+}
+
+void InputQueue::setRawSamplesEnabled(bool enabled)
+{
+    __rawSamples = enabled;
+    if (!enabled)
+        __samples.clear();
+}
+
+bool InputQueue::isRawSamplesEnabled()
+{
+    return __rawSamples;
+}
+
+const std::vector<InputQueue::Sample>& InputQueue::getRawSamples()
+{
+    return __dispatchedSamples;
+}
+
+unsigned int InputQueue::getCoalescedCount()
+{
+    return __dispatchedCoalescedCount;
+}
+
+void InputQueue::initialize()
+{
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("input", true);
+    if (config)
+    {
+        if (config->exists("buffered"))
+            setBuffered(config->getBool("buffered"));
+        if (config->exists("rawSamples"))
+            setRawSamplesEnabled(config->getBool("rawSamples"));
+    }
+}
+
+bool InputQueue::queueMouse(Mouse::MouseEvent evt, int x, int y, int wheelDelta, bool touchFallback)
+{
+    if (!__buffered || __dispatching)
+        return false;
+
+    InputEvent event;
+    event.type = INPUT_MOUSE;
+    event.evt = evt;
+    event.x = x;
+    event.y = y;
+    event.value = wheelDelta;
+    event.relative = evt == Mouse::MOUSE_MOVE && Game::getInstance()->isMouseCaptured();
+    event.touch = touchFallback;
+
+    if (evt == Mouse::MOUSE_MOVE)
+    {
+        if (__rawSamples)
+        {
+            Sample sample = { Game::getAbsoluteTime(), x, y, 0, true };
+            __samples.push_back(sample);
+        }
+        if (coalesce(event))
+            return true;
+    }
+    __events.push_back(event);
+    return true;
+}
+
+bool InputQueue::queueTouch(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse)
+{
+    if (!__buffered || __dispatching)
+        return false;
+
+    InputEvent event;
+    event.type = INPUT_TOUCH;
+    event.evt = evt;
+    event.x = x;
+    event.y = y;
+    event.value = (int)contactIndex;
+    event.relative = false;
+    event.touch = actuallyMouse;
+
+    if (evt == Touch::TOUCH_MOVE)
+    {
+        // The touches that platforms derive from the mouse are already sampled as mouse moves.
+        if (__rawSamples && !actuallyMouse)
+        {
+            Sample sample = { Game::getAbsoluteTime(), x, y, contactIndex, false };
+            __samples.push_back(sample);
+        }
+        if (coalesce(event))
+            return true;
+    }
+    __events.push_back(event);
+    return true;
+}
+
+bool InputQueue::queueKey(Keyboard::KeyEvent evt, int key)
+{
+    if (!__buffered || __dispatching)
+        return false;
+
+    InputEvent event;
+    event.type = INPUT_KEY;
+    event.evt = evt;
+    event.x = 0;
+    event.y = 0;
+    event.value = key;
+    event.relative = false;
+    event.touch = false;
+    __events.push_back(event);
+    return true;
+}
+
+void InputQueue::update()
+{
+    dispatch();
+
+    __dispatchedSamples.swap(__samples);
+    __samples.clear();
+    __dispatchedCoalescedCount = __coalescedCount;
+    __coalescedCount = 0;
+}
+
+void InputQueue::dispatch()
+{
+    if (__dispatching)
+        return;
+
+    __dispatching = true;
+    __dispatchedEvents.swap(__events);
+
+    for (size_t i = 0, count = __dispatchedEvents.size(); i < count; ++i)
+    {
+        const InputEvent& event = __dispatchedEvents[i];
+        switch (event.type)
+        {
+        case INPUT_MOUSE:
+            Platform::pointerEventInternal((Mouse::MouseEvent)event.evt, event.x, event.y, event.value, event.touch);
+            break;
+        case INPUT_TOUCH:
+            Platform::touchEventInternal((Touch::TouchEvent)event.evt, event.x, event.y, (unsigned int)event.value, event.touch);
+            break;
+        case INPUT_KEY:
+            Platform::keyEventInternal((Keyboard::KeyEvent)event.evt, event.value);
+            break;
+        }
+    }
+    __dispatchedEvents.clear();
+    __dispatching = false;
+}
+
+bool InputQueue::isDispatching()
+{
+    return __dispatching;
+}
+
+}
@@ -0,0 +1,171 @@
+#ifndef INPUTQUEUE_H_
+#define INPUTQUEUE_H_
+
+#include "Mouse.h"
+#include "Touch.h"
+#include "Keyboard.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines the queue that buffers the input events of a frame until the game dispatches them.
+ *
+ * High-rate mice and touch screens report many motion events per frame, and dispatching
+ * every one of them to the forms, the game and its scripts costs a hit test of the forms
+ * each time. While input is buffered, the platform queues touch, key and mouse events as
+ * they arrive, and the game dispatches the queue once per frame, before it updates.
+ *
+ * Motion events are coalesced as they are queued: a mouse or touch move replaces the
+ * previous move of the same pointer, as long as only moves were queued in between, so
+ * presses and releases keep their order and position. Moves of a captured mouse are
+ * deltas and are added up instead. The positions of the moves can still be kept as raw
+ * samples, for games that need every position, such as drawing applications.
+ *
+ * Events that platforms report and consume immediately, such as mouse events whose
+ * consumption decides whether a touch event follows, are dispatched after the queue.
+ *
+ * Input is buffered by default. Buffering and raw samples can be set with the 'buffered'
+ * and 'rawSamples' properties of the 'input' namespace in the game configuration file.
+ *
+ * @script{ignore}
+ */
+class InputQueue
+{
+    friend class Game;
+    friend class Platform;
+    friend class InputRecorder;
+
+public:
+
+    /**
+     * Defines the position of a motion event as it was reported, before coalescing.
+     */
+    struct Sample
+    {
+        /**
+         * The absolute time of the event, in milliseconds.
+         */
+        double time;
+
+        /**
+         * The x position, or the x delta of a captured mouse.
+         */
+        int x;
+
+        /**
+         * The y position, or the y delta of a captured mouse.
+         */
+        int y;
+
+        /**
+         * The contact index of a touch, or 0 for the mouse.
+         */
+        unsigned int contactIndex;
+
+        /**
+         * Whether the sample is a mouse move rather than a touch move.
+         */
+        bool mouse;
+    };
+
+    /**
+     * Sets whether input events are queued and dispatched once per frame.
+     *
+     * Disabling buffering dispatches the queued events right away.
+     *
+     * @param buffered true to buffer input events, false to dispatch them as they arrive.
+     */
+    static void setBuffered(bool buffered);
+
+    /**
+     * Returns whether input events are queued and dispatched once per frame.
+     *
+     * @return true if input events are buffered.
+     */
+    static bool isBuffered();
+
+    /**
+     * Sets whether the positions of motion events are kept as raw samples.
+     *
+     * @param enabled true to keep raw samples.
+     */
+    static void setRawSamplesEnabled(bool enabled);
+
+    /**
+     * Returns whether the positions of motion events are kept as raw samples.
+     *
+     * @return true if raw samples are kept.
+     */
+    static bool isRawSamplesEnabled();
+
+    /**
+     * Returns the raw samples of the motion events of the last frame, oldest first.
+     *
+     * @return The raw samples.
+     */
+    static const std::vector<Sample>& getRawSamples();
+
+    /**
+     * Returns the number of motion events that were coalesced into others during the
+     * last frame.
+     *
+     * @return The number of coalesced events.
+     */
+    static unsigned int getCoalescedCount();
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    InputQueue();
+
+    /**
+     * Called during startup to read the input configuration.
+     */
+    static void initialize();
+
+    /**
+     * Queues a mouse event, followed by a touch event of the first contact if the mouse
+     * event is not consumed and touchFallback is set.
+     *
+     * @return true if the event was queued, false if it must be dispatched right away.
+     */
+    static bool queueMouse(Mouse::MouseEvent evt, int x, int y, int wheelDelta, bool touchFallback);
+
+    /**
+     * Queues a touch event.
+     *
+     * @return true if the event was queued, false if it must be dispatched right away.
+     */
+    static bool queueTouch(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse);
+
+    /**
+     * Queues a key event.
+     *
+     * @return true if the event was queued, false if it must be dispatched right away.
+     */
+    static bool queueKey(Keyboard::KeyEvent evt, int key);
+
+    /**
+     * Dispatches the queued events and completes the raw samples of the frame. Called by
+     * the game once per frame, before it updates.
+     */
+    static void update();
+
+    /**
+     * Dispatches the queued events. Called by the platform before events that are
+     * dispatched right away.
+     */
+    static void dispatch();
+
+    /**
+     * Returns whether the queued events are being dispatched.
+     */
+    static bool isDispatching();
+};
+
+}
+
+#endif
@@ -0,0 +1,623 @@
+#include "Base.h"
+#include "InputRecorder.h"
+#include "InputQueue.h"
+#include "Platform.h"
+#include "Game.h"
+#include "Gamepad.h"
+#include "FileSystem.h"
+#include "Profiler.h"
+
+// The identifier and version at the start of a recording.
+#define RECORDING_MAGIC     0x52495047
+#define RECORDING_VERSION   1
+
+// The size of the records that are buffered before they are written to the file.
+#define RECORDING_BUFFER_SIZE 65536
+
+// The handles of the gamepads connected by a replay, which are never polled.
+#define RECORDING_GAMEPAD_HANDLE 0x7F000000
+
+namespace gameplay
+{
+
+/**
+ * The kinds of records of a recording.
+ */
+enum RecordType
+{
+    RECORD_FRAME,
+    RECORD_KEY,
+    RECORD_TOUCH,
+    RECORD_MOUSE,
+    RECORD_POINTER,
+    RECORD_GESTURE,
+    RECORD_GAMEPAD_CONNECTED,
+    RECORD_GAMEPAD_DISCONNECTED,
+    RECORD_GAMEPAD_STATE
+};
+
+/**
+ * The last recorded state of a physical gamepad.
+ */
+struct RecordedGamepad
+{
+    GamepadHandle handle;
+    unsigned int id;
+    unsigned int buttons;
+    float joysticks[4];
+    float triggers[2];
+};
+
+/**
+ * The time taken by a replayed frame, in milliseconds.
+ */
+struct ReplayFrame
+{
+    float elapsedTime;
+    float frameTime;
+    float updateTime;
+    float renderTime;
+    float gpuRenderTime;
+};
+
+static bool __recording = false;
+static bool __replaying = false;
+static bool __injecting = false;
+static bool __exitOnReplayEnd = false;
+static Stream* __stream = NULL;
+static std::vector<unsigned char> __data;
+static size_t __position = 0;
+static unsigned int __frameCount = 0;
+static double __time = 0.0;
+static double __elapsedTime = 0.0;
+static float __timeStep = 0.0f;
+static std::vector<RecordedGamepad> __gamepads;
+static unsigned int __gamepadCount = 0;
+static std::string __tracePath;
+static std::vector<ReplayFrame> __frames;
+
+template <class T>
+static void write(T value)
+{
+    size_t offset = __data.size();
+    __data.resize(offset + sizeof(T));
+    memcpy(&__data[offset], &value, sizeof(T));
+}
+
+template <class T>
+static bool read(T* value)
+{
+    if (__position + sizeof(T) > __data.size())
+        return false;
+    memcpy(value, &__data[__position], sizeof(T));
+    __position += sizeof(T);
+    return true;
+}
+
+static bool flush()
+{
+    bool result = __data.empty() || __stream->write(&__data[0], 1, __data.size()) == __data.size();
+    __data.clear();
+    return result;
+}
+
+/**
+ * Writes the state of a gamepad if it changed since it was last recorded.
+ */
+static void writeGamepadState(RecordedGamepad& recorded, unsigned int buttons, const Vector2* joystickValues, const float* triggerValues, bool force)
+{
+    float joysticks[4] = { joystickValues[0].x, joystickValues[0].y, joystickValues[1].x, joystickValues[1].y };
+    float triggers[2] = { triggerValues[0], triggerValues[1] };
+    if (!force && buttons == recorded.buttons && memcmp(joysticks, recorded.joysticks, sizeof(joysticks)) == 0 &&
+        memcmp(triggers, recorded.triggers, sizeof(triggers)) == 0)
+    {
+        return;
+    }
+
+    recorded.buttons = buttons;
+    memcpy(recorded.joysticks, joysticks, sizeof(joysticks));
+    memcpy(recorded.triggers, triggers, sizeof(triggers));
+    write((unsigned char)RECORD_GAMEPAD_STATE);
+    write(recorded.id);
+    write(buttons);
+    for (unsigned int i = 0; i < 4; ++i)
+        write(joysticks[i]);
+    for (unsigned int i = 0; i < 2; ++i)
+        write(triggers[i]);
+}
+
+/**
+ * Writes the frame times of a replay to its trace.
+ */
+static void writeTrace()
+{
+    if (__frames.empty())
+        return;
+
+    double total = 0.0;
+    float maxFrameTime = 0.0f;
+    for (size_t i = 0, count = __frames.size(); i < count; ++i)
+    {
+        total += __frames[i].frameTime;
+        maxFrameTime = std::max(maxFrameTime, __frames[i].frameTime);
+    }
+    Logger::log(Logger::LEVEL_INFO, "Replay of %u frames: %.3f ms average, %.3f ms maximum frame time\n",
+        (unsigned int)__frames.size(), total / (double)__frames.size(), maxFrameTime);
+
+    if (__tracePath.empty())
+        return;
+
+    Stream* stream = FileSystem::open(__tracePath.c_str(), FileSystem::WRITE);
+    if (!stream)
+    {
+        GP_WARN("Failed to open file '%s' to write the trace of a replay.", __tracePath.c_str());
+        return;
+    }
+    std::string text = "frame,elapsedTime,frameTime,updateTime,renderTime,gpuRenderTime\n";
+    char line[128];
+    for (size_t i = 0, count = __frames.size(); i < count; ++i)
+    {
+        const ReplayFrame& frame = __frames[i];
+        sprintf(line, "%u,%.3f,%.3f,%.3f,%.3f,%.3f\n", (unsigned int)i, frame.elapsedTime, frame.frameTime, frame.updateTime, frame.renderTime, frame.gpuRenderTime);
+        text.append(line);
+    }
+    if (stream->write(text.c_str(), 1, text.length()) != text.length())
+        GP_WARN("Failed to write the trace of a replay to file '%s'.", __tracePath.c_str());
+    stream->close();
+    SAFE_DELETE(stream);
+}
+
+bool InputRecorder::startRecording(const char* path)
+{
+    GP_ASSERT(path);
+
+    stop();
+
+    __stream = FileSystem::open(path, FileSystem::WRITE);
+    if (!__stream)
+    {
+        GP_WARN("Failed to open file '%s' to record the input.", path);
+        return false;
+    }
+    __data.clear();
+    __data.reserve(RECORDING_BUFFER_SIZE);
+    write((unsigned int)RECORDING_MAGIC);
+    write((unsigned int)RECORDING_VERSION);
+
+    __recording = true;
+    __frameCount = 0;
+    __time = Game::getGameTime();
+    __gamepads.clear();
+    __gamepadCount = 0;
+    return true;
+}
+
+bool InputRecorder::startReplay(const char* path, const char* tracePath, float timeStep)
+{
+    GP_ASSERT(path);
+
+    stop();
+
+    Stream* stream = FileSystem::open(path);
+    if (!stream)
+    {
+        GP_WARN("Failed to open recording '%s'.", path);
+        return false;
+    }
+    size_t length = stream->length();
+    __data.resize(length);
+    bool result = length == 0 || stream->read(&__data[0], 1, length) == length;
+    stream->close();
+    SAFE_DELETE(stream);
+
+    __position = 0;
+    unsigned int magic = 0;
+    unsigned int version = 0;
+    if (!result || !read(&magic) || !read(&version) || magic != RECORDING_MAGIC || version != RECORDING_VERSION)
+    {
+        GP_WARN("Invalid recording '%s'.", path);
+        __data.clear();
+        return false;
+    }
+
+    __replaying = true;
+    __frameCount = 0;
+    __time = Game::getGameTime();
+    __timeStep = std::max(timeStep, 0.0f);
+    __gamepads.clear();
+    __tracePath = tracePath ? tracePath : "";
+    __frames.clear();
+    if (tracePath)
+        Profiler::setEnabled(true);
+    return true;
+}
+
+void InputRecorder::stop()
+{
+    if (__recording)
+    {
+        __recording = false;
+        if (!flush())
+            GP_WARN("Failed to write the end of a recording.");
+        __stream->close();
+        SAFE_DELETE(__stream);
+    }
+    else if (__replaying)
+    {
+        __replaying = false;
+
+        // The recorded gamepads are disconnected, and the game time continues from the time of the replay.
+        for (size_t i = 0, count = __gamepads.size(); i < count; ++i)
+        {
+            Gamepad* gamepad = Gamepad::getGamepad(__gamepads[i].handle);
+            if (gamepad)
+                Gamepad::remove(gamepad);
+        }
+        Game::_pausedTimeTotal = Game::getAbsoluteTime() - __time;
+
+        writeTrace();
+        __frames.clear();
+        __tracePath.clear();
+    }
+    __data.clear();
+    __gamepads.clear();
+}
+
+bool InputRecorder::isRecording()
+{
+    return __recording;
+}
+
+bool InputRecorder::isReplaying()
+{
+    return __replaying;
+}
+
+void InputRecorder::setExitOnReplayEnd(bool exit)
+{
+    __exitOnReplayEnd = exit;
+}
+
+unsigned int InputRecorder::getFrameCount()
+{
+    return __frameCount;
+}
+
+void InputRecorder::initialize()
+{
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("input", true);
+    if (config)
+    {
+        setExitOnReplayEnd(config->getBool("replayExit"));
+        if (config->exists("replay"))
+            startReplay(config->getString("replay"), config->getString("replayTrace"), config->getFloat("replayTimeStep"));
+        else if (config->exists("record"))
+            startRecording(config->getString("record"));
+    }
+}
+
+void InputRecorder::finalize()
+{
+    stop();
+}
+
+void InputRecorder::beginFrame()
+{
+    if (__recording)
+    {
+        double time = Game::getGameTime();
+        write((unsigned char)RECORD_FRAME);
+        write(time - __time);
+        __time = time;
+        ++__frameCount;
+        if (__data.size() >= RECORDING_BUFFER_SIZE && !flush())
+            GP_WARN("Failed to write a recording.");
+        return;
+    }
+    if (!__replaying)
+        return;
+
+    // The events that were recorded before the frame are passed to the platform functions
+    // that reported them.
+    __injecting = true;
+    bool frame = false;
+    unsigned char type;
+    while (!frame && read(&type))
+    {
+        unsigned char evt = 0;
+        int x = 0, y = 0, value = 0;
+        unsigned int contactIndex = 0;
+        unsigned char flag = 0;
+        float scale = 0.0f;
+        switch (type)
+        {
+        case RECORD_FRAME:
+        {
+            double elapsedTime = 0.0;
+            read(&elapsedTime);
+            __elapsedTime = __timeStep > 0.0f ? (double)__timeStep : elapsedTime;
+            __time += __elapsedTime;
+            ++__frameCount;
+            frame = true;
+            break;
+        }
+        case RECORD_KEY:
+            if (read(&evt) && read(&value))
+                Platform::keyEventInternal((Keyboard::KeyEvent)evt, value);
+            break;
+        case RECORD_TOUCH:
+            if (read(&evt) && read(&x) && read(&y) && read(&contactIndex) && read(&flag))
+                Platform::touchEventInternal((Touch::TouchEvent)evt, x, y, contactIndex, flag != 0);
+            break;
+        case RECORD_MOUSE:
+            if (read(&evt) && read(&x) && read(&y) && read(&value))
+                Platform::mouseEventInternal((Mouse::MouseEvent)evt, x, y, value);
+            break;
+        case RECORD_POINTER:
+            if (read(&evt) && read(&x) && read(&y) && read(&value) && read(&flag))
+                Platform::pointerEventInternal((Mouse::MouseEvent)evt, x, y, value, flag != 0);
+            break;
+        case RECORD_GESTURE:
+            if (!read(&evt) || !read(&x) || !read(&y) || !read(&value) || !read(&scale))
+                break;
+            switch (evt)
+            {
+            case GESTURE_SWIPE:
+                Platform::gestureSwipeEventInternal(x, y, value);
+                break;
+            case GESTURE_PINCH:
+                Platform::gesturePinchEventInternal(x, y, scale);
+                break;
+            case GESTURE_TAP:
+                Platform::gestureTapEventInternal(x, y);
+                break;
+            case GESTURE_LONG_TAP:
+                Platform::gestureLongTapEventInternal(x, y, scale);
+                break;
+            case GESTURE_DRAG:
+                Platform::gestureDragEventInternal(x, y);
+                break;
+            case GESTURE_DROP:
+                Platform::gestureDropEventInternal(x, y);
+                break;
+            }
+            break;
+        default:
+        {
+            // The gamepad records of frames that didn't update the gamepads are applied with the events.
+            size_t position = --__position;
+            updateGamepads();
+            if (__position == position)
+            {
+                GP_WARN("Invalid record in a replay.");
+                __position = __data.size();
+            }
+            break;
+        }
+        }
+    }
+    __injecting = false;
+
+    if (!frame)
+    {
+        stop();
+        if (__exitOnReplayEnd)
+            Game::getInstance()->exit();
+    }
+}
+
+void InputRecorder::endFrame()
+{
+    if (!__replaying)
+        return;
+
+    ReplayFrame frame;
+    frame.elapsedTime = (float)__elapsedTime;
+    frame.frameTime = Profiler::getFrameTime();
+    frame.updateTime = Profiler::getZoneTime("Game::update");
+    frame.renderTime = Profiler::getZoneTime("Game::render");
+    frame.gpuRenderTime = Profiler::getZoneTime("Game::render", true);
+    __frames.push_back(frame);
+}
+
+void InputRecorder::updateGamepads()
+{
+    if (__recording)
+    {
+        // Gamepads that were removed are disconnected, and new ones are connected with their state.
+        for (size_t i = 0; i < __gamepads.size();)
+        {
+            Gamepad* gamepad = Gamepad::getGamepad(__gamepads[i].handle);
+            if (gamepad)
+            {
+                writeGamepadState(__gamepads[i], gamepad->_buttons, gamepad->_joysticks, gamepad->_triggers, false);
+                ++i;
+                continue;
+            }
+            write((unsigned char)RECORD_GAMEPAD_DISCONNECTED);
+            write(__gamepads[i].id);
+            __gamepads.erase(__gamepads.begin() + i);
+        }
+        for (unsigned int i = 0, count = Gamepad::getGamepadCount(); i < count; ++i)
+        {
+            Gamepad* gamepad = Gamepad::getGamepad(i, false);
+            if (!gamepad || gamepad->isVirtual())
+                continue;
+            bool found = false;
+            for (size_t j = 0, recordedCount = __gamepads.size(); j < recordedCount && !found; ++j)
+                found = __gamepads[j].handle == gamepad->_handle;
+            if (found)
+                continue;
+
+            RecordedGamepad recorded;
+            recorded.handle = gamepad->_handle;
+            recorded.id = __gamepadCount++;
+            write((unsigned char)RECORD_GAMEPAD_CONNECTED);
+            write(recorded.id);
+            write(gamepad->_buttonCount);
+            write(gamepad->_joystickCount);
+            write(gamepad->_triggerCount);
+            write((unsigned short)gamepad->_name.length());
+            for (size_t j = 0, length = gamepad->_name.length(); j < length; ++j)
+                write(gamepad->_name[j]);
+            writeGamepadState(recorded, gamepad->_buttons, gamepad->_joysticks, gamepad->_triggers, true);
+            __gamepads.push_back(recorded);
+        }
+        return;
+    }
+    if (!__replaying)
+        return;
+
+    // The gamepad records that follow the start of the frame were recorded by its update.
+    unsigned char type;
+    while (__position < __data.size())
+    {
+        type = __data[__position];
+        if (type != RECORD_GAMEPAD_CONNECTED && type != RECORD_GAMEPAD_DISCONNECTED && type != RECORD_GAMEPAD_STATE)
+            break;
+        ++__position;
+
+        unsigned int id;
+        if (!read(&id))
+            break;
+        GamepadHandle handle = (GamepadHandle)(RECORDING_GAMEPAD_HANDLE + id);
+        if (type == RECORD_GAMEPAD_CONNECTED)
+        {
+            unsigned int buttonCount, joystickCount, triggerCount;
+            unsigned short length;
+            if (!read(&buttonCount) || !read(&joystickCount) || !read(&triggerCount) || !read(&length) || __position + length > __data.size())
+                break;
+            std::string name((const char*)&__data[__position], length);
+            __position += length;
+            RecordedGamepad recorded;
+            recorded.handle = handle;
+            recorded.id = id;
+            __gamepads.push_back(recorded);
+            Gamepad::add(handle, buttonCount, joystickCount, triggerCount, name.c_str());
+        }
+        else if (type == RECORD_GAMEPAD_DISCONNECTED)
+        {
+            Gamepad* gamepad = Gamepad::getGamepad(handle);
+            if (gamepad)
+                Gamepad::remove(gamepad);
+        }
+        else
+        {
+            unsigned int buttons;
+            float joysticks[4];
+            float triggers[2];
+            if (!read(&buttons) || !read(&joysticks[0]) || !read(&joysticks[1]) || !read(&joysticks[2]) || !read(&joysticks[3]) ||
+                !read(&triggers[0]) || !read(&triggers[1]))
+            {
+                break;
+            }
+            Gamepad* gamepad = Gamepad::getGamepad(handle);
+            if (gamepad)
+            {
+                gamepad->setButtons(buttons);
+                for (unsigned int i = 0; i < gamepad->_joystickCount && i < 2; ++i)
+                    gamepad->setJoystickValue(i, joysticks[i * 2], joysticks[i * 2 + 1]);
+                for (unsigned int i = 0; i < gamepad->_triggerCount && i < 2; ++i)
+                    gamepad->setTriggerValue(i, triggers[i]);
+            }
+        }
+    }
+}
+
+double InputRecorder::getReplayTime()
+{
+    return __time;
+}
+
+bool InputRecorder::capture(bool* record)
+{
+    // Events that the input queue dispatches, or that a replay passes in, are let through.
+    *record = false;
+    if (__injecting || InputQueue::isDispatching())
+        return true;
+    *record = __recording;
+    return !__replaying;
+}
+
+bool InputRecorder::captureKey(Keyboard::KeyEvent evt, int key)
+{
+    bool record;
+    bool result = capture(&record);
+    if (record)
+    {
+        write((unsigned char)RECORD_KEY);
+        write((unsigned char)evt);
+        write(key);
+    }
+    return result;
+}
+
+bool InputRecorder::captureTouch(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse)
+{
+    bool record;
+    bool result = capture(&record);
+    if (record)
+    {
+        write((unsigned char)RECORD_TOUCH);
+        write((unsigned char)evt);
+        write(x);
+        write(y);
+        write(contactIndex);
+        write((unsigned char)actuallyMouse);
+    }
+    return result;
+}
+
+bool InputRecorder::captureMouse(Mouse::MouseEvent evt, int x, int y, int wheelDelta)
+{
+    bool record;
+    bool result = capture(&record);
+    if (record)
+    {
+        write((unsigned char)RECORD_MOUSE);
+        write((unsigned char)evt);
+        write(x);
+        write(y);
+        write(wheelDelta);
+    }
+    return result;
+}
+
+bool InputRecorder::capturePointer(Mouse::MouseEvent evt, int x, int y, int wheelDelta, bool touchFallback)
+{
+    bool record;
+    bool result = capture(&record);
+    if (record)
+    {
+        write((unsigned char)RECORD_POINTER);
+        write((unsigned char)evt);
+        write(x);
+        write(y);
+        write(wheelDelta);
+        write((unsigned char)touchFallback);
+    }
+    return result;
+}
+
+bool InputRecorder::captureGesture(Gesture gesture, int x, int y, int value, float scale)
+{
+    bool record;
+    bool result = capture(&record);
+    if (record)
+    {
+        write((unsigned char)RECORD_GESTURE);
+        write((unsigned char)gesture);
+        write(x);
+        write(y);
+        write(value);
+        write(scale);
+    }
+    return result;
+}
+
+bool InputRecorder::captureGamepad()
+{
+    return !__replaying || __injecting;
+}
+
+}
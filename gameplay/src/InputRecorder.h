@@ -0,0 +1,185 @@
+#ifndef INPUTRECORDER_H_
+#define INPUTRECORDER_H_
+
+#include "Mouse.h"
+#include "Touch.h"
+#include "Keyboard.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a recorder of the input events and frame times of a game session, which can be
+ * replayed to run the same workload again, such as to compare the performance of builds.
+ *
+ * While recording, the key, mouse, touch and gesture events reported by the platform are
+ * written to a compact binary file in the order that they arrive, together with the game
+ * time that passes at the start of every frame and the state of the physical gamepads
+ * whenever it changes.
+ *
+ * While replaying, the events reported by the platform are ignored and the recorded ones
+ * are passed to the game before the frames that they arrived before, so that they are
+ * queued, coalesced and dispatched as they were. The game time returned by
+ * Game::getGameTime advances by the recorded time at the start of every frame, or by a
+ * fixed time step, regardless of how long the frames take, so that animations, physics
+ * and the game itself are updated with the same elapsed times as they were recorded.
+ * The recorded gamepads are connected when the replay reaches them and are disconnected
+ * when it ends. A replay is only deterministic if it starts from the state that the
+ * recording started from, such as from the game configuration file, and if the game
+ * doesn't depend on the absolute time or on unseeded random numbers.
+ *
+ * A replay can write a trace of the time taken by every frame, in the comma separated
+ * format, with the frame time, the time of the update and render zones of the game and
+ * the GPU time of the render zone measured by the profiler, which is enabled for it.
+ *
+ * Recording and replaying can be started from the 'record', 'replay', 'replayTrace',
+ * 'replayTimeStep' and 'replayExit' properties of the 'input' namespace in the game
+ * configuration file.
+ *
+ * @see Profiler
+ * @script{ignore}
+ */
+class InputRecorder
+{
+    friend class Game;
+    friend class Platform;
+    friend class Gamepad;
+
+public:
+
+    /**
+     * Starts recording to a file, stopping any recording or replay in progress.
+     *
+     * @param path The path of the file to record to.
+     *
+     * @return true if recording started, false if the file could not be opened.
+     */
+    static bool startRecording(const char* path);
+
+    /**
+     * Starts replaying a recording, stopping any recording or replay in progress.
+     *
+     * @param path The path of the recording.
+     * @param tracePath The path of the file to write the frame times of the replay to when
+     *      it ends, or NULL to not write any.
+     * @param timeStep The game time that every frame advances by, in milliseconds, or zero
+     *      to advance by the recorded times.
+     *
+     * @return true if the replay started, false if the recording could not be read.
+     */
+    static bool startReplay(const char* path, const char* tracePath = NULL, float timeStep = 0.0f);
+
+    /**
+     * Stops recording or replaying, writing the rest of the recording or the trace of the replay.
+     */
+    static void stop();
+
+    /**
+     * Returns whether the input is being recorded.
+     *
+     * @return true while recording.
+     */
+    static bool isRecording();
+
+    /**
+     * Returns whether a recording is being replayed.
+     *
+     * @return true while replaying.
+     */
+    static bool isReplaying();
+
+    /**
+     * Sets whether the game exits when a replay ends.
+     *
+     * @param exit true to exit the game at the end of a replay.
+     */
+    static void setExitOnReplayEnd(bool exit);
+
+    /**
+     * Returns the number of frames recorded or replayed so far.
+     *
+     * @return The number of frames.
+     */
+    static unsigned int getFrameCount();
+
+private:
+
+    /**
+     * The kinds of gesture events.
+     */
+    enum Gesture
+    {
+        GESTURE_SWIPE,
+        GESTURE_PINCH,
+        GESTURE_TAP,
+        GESTURE_LONG_TAP,
+        GESTURE_DRAG,
+        GESTURE_DROP
+    };
+
+    /**
+     * Hidden constructor.
+     */
+    InputRecorder();
+
+    /**
+     * Called during startup to start recording or replaying from the input configuration.
+     */
+    static void initialize();
+
+    /**
+     * Called during shutdown to stop recording or replaying.
+     */
+    static void finalize();
+
+    /**
+     * Records the game time that passed since the last frame, or replays the events and the
+     * time of the next frame. Called by the game at the start of every frame.
+     */
+    static void beginFrame();
+
+    /**
+     * Adds the time measured by the profiler for the frame to the trace of a replay. Called
+     * by the game at the end of every frame.
+     */
+    static void endFrame();
+
+    /**
+     * Records the changes of the physical gamepads, or replays them. Called once per frame
+     * after the gamepads are updated.
+     */
+    static void updateGamepads();
+
+    /**
+     * Returns the game time of the replay.
+     */
+    static double getReplayTime();
+
+    /**
+     * Determines whether an event reported by the platform is recorded, and whether it is dispatched.
+     */
+    static bool capture(bool* record);
+
+    /**
+     * Records the events reported by the platform, and determines whether they are dispatched.
+     * The events that the engine dispatches again through the platform are let through.
+     *
+     * @return true if the event is dispatched, false if it is ignored during a replay.
+     */
+    static bool captureKey(Keyboard::KeyEvent evt, int key);
+    static bool captureTouch(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse);
+    static bool captureMouse(Mouse::MouseEvent evt, int x, int y, int wheelDelta);
+    static bool capturePointer(Mouse::MouseEvent evt, int x, int y, int wheelDelta, bool touchFallback);
+    static bool captureGesture(Gesture gesture, int x, int y, int value, float scale);
+
+    /**
+     * Determines whether the events of the physical gamepads reported by the platform are applied.
+     *
+     * @return false during a replay.
+     */
+    static bool captureGamepad();
+};
+
+}
+
+#endif
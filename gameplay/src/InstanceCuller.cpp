@@ -0,0 +1,490 @@
+#include "Base.h"
+#include "InstanceCuller.h"
+#include "Camera.h"
+#include "Game.h"
+#include "MeshPart.h"
+#include "Model.h"
+#include "Node.h"
+#include "RenderStats.h"
+#include "Scene.h"
+
+// The number of unsigned integers of an indirect draw command, which is the size of the
+// command of an indexed draw. The commands of draws without indices have one less, but
+// keep the instance count at the same offset.
+#define INSTANCE_CULLER_COMMAND_SIZE 5
+
+namespace gameplay
+{
+
+#ifdef GP_USE_COMPUTE_SHADERS
+
+// Compute shader that tests every instance against the frustum and the depth pyramid and
+// appends the visible ones to the visible instance buffer, counting them in every command.
+static const char* INSTANCE_CULL_CS =
+{
+    "#version 430\n"
+    "layout(local_size_x = 64) in;\n"
+    "layout(std430, binding = 0) readonly buffer Instances { float instances[]; };\n"
+    "layout(std430, binding = 1) writeonly buffer Visible { float visible[]; };\n"
+    "layout(std430, binding = 2) buffer Commands { uint commands[]; };\n"
+    "uniform uint u_instanceCount;\n"
+    "uniform uint u_commandCount;\n"
+    "uniform mat4 u_worldMatrix;\n"
+    "uniform vec4 u_bounds;\n"
+    "uniform vec4 u_planes[6];\n"
+    "uniform int u_occlusion;\n"
+    "uniform mat4 u_pyramidViewProjection;\n"
+    "uniform sampler2D u_pyramid;\n"
+    "uniform int u_pyramidLevels;\n"
+    "bool isOccluded(vec3 center, float radius) {\n"
+    "    vec3 low = vec3(1.0);\n"
+    "    vec3 high = vec3(0.0);\n"
+    "    for (int i = 0; i < 8; ++i) {\n"
+    "        vec3 corner = center + radius * vec3((i & 1) != 0 ? 1.0 : -1.0, (i & 2) != 0 ? 1.0 : -1.0, (i & 4) != 0 ? 1.0 : -1.0);\n"
+    "        vec4 clip = u_pyramidViewProjection * vec4(corner, 1.0);\n"
+    "        if (clip.w <= 0.0)\n"
+    "            return false;\n"
+    "        vec3 window = clip.xyz / clip.w * 0.5 + 0.5;\n"
+    "        low = min(low, window);\n"
+    "        high = max(high, window);\n"
+    "    }\n"
+    "    if (low.z <= 0.0)\n"
+    "        return false;\n"
+    "    low.xy = clamp(low.xy, 0.0, 1.0);\n"
+    "    high.xy = clamp(high.xy, 0.0, 1.0);\n"
+    "    vec2 extent = (high.xy - low.xy) * vec2(textureSize(u_pyramid, 0));\n"
+    "    int level = clamp(int(ceil(log2(max(max(extent.x, extent.y), 1.0)))), 0, u_pyramidLevels - 1);\n"
+    "    ivec2 size = textureSize(u_pyramid, level);\n"
+    "    ivec2 a = clamp(ivec2(low.xy * vec2(size)), ivec2(0), size - 1);\n"
+    "    ivec2 b = clamp(ivec2(high.xy * vec2(size)), ivec2(0), size - 1);\n"
+    "    float depth = max(max(texelFetch(u_pyramid, a, level).r, texelFetch(u_pyramid, ivec2(b.x, a.y), level).r),\n"
+    "                      max(texelFetch(u_pyramid, ivec2(a.x, b.y), level).r, texelFetch(u_pyramid, b, level).r));\n"
+    "    return low.z > depth;\n"
+    "}\n"
+    "void main() {\n"
+    "    uint index = gl_GlobalInvocationID.x;\n"
+    "    if (index >= u_instanceCount)\n"
+    "        return;\n"
+    "    uint base = index * 21u;\n"
+    "    mat4 instance;\n"
+    "    for (uint c = 0u; c < 4u; ++c)\n"
+    "        instance[c] = vec4(instances[base + c * 4u], instances[base + c * 4u + 1u], instances[base + c * 4u + 2u], instances[base + c * 4u + 3u]);\n"
+    "    mat4 world = u_worldMatrix * instance;\n"
+    "    vec3 center = (world * vec4(u_bounds.xyz, 1.0)).xyz;\n"
+    "    float radius = u_bounds.w * max(length(world[0].xyz), max(length(world[1].xyz), length(world[2].xyz)));\n"
+    "    for (int i = 0; i < 6; ++i) {\n"
+    "        if (dot(u_planes[i].xyz, center) + u_planes[i].w < -radius)\n"
+    "            return;\n"
+    "    }\n"
+    "    if (u_occlusion != 0 && isOccluded(center, radius))\n"
+    "        return;\n"
+    "    uint slot = atomicAdd(commands[1], 1u);\n"
+    "    for (uint i = 1u; i < u_commandCount; ++i)\n"
+    "        atomicAdd(commands[i * 5u + 1u], 1u);\n"
+    "    uint target = slot * 21u;\n"
+    "    for (uint i = 0u; i < 21u; ++i)\n"
+    "        visible[target + i] = instances[base + i];\n"
+    "}\n"
+};
+
+// Compute shader that writes every texel of a level of the pyramid with the farthest
+// depth of the texels that it covers in the level below, or in the depth texture.
+static const char* DEPTH_PYRAMID_CS =
+{
+    "#version 430\n"
+    "layout(local_size_x = 8, local_size_y = 8) in;\n"
+    "layout(r32f, binding = 0) writeonly uniform image2D u_destination;\n"
+    "uniform sampler2D u_source;\n"
+    "uniform int u_sourceLevel;\n"
+    "uniform ivec2 u_destinationSize;\n"
+    "void main() {\n"
+    "    ivec2 p = ivec2(gl_GlobalInvocationID.xy);\n"
+    "    if (p.x >= u_destinationSize.x || p.y >= u_destinationSize.y)\n"
+    "        return;\n"
+    "    ivec2 sourceSize = textureSize(u_source, u_sourceLevel);\n"
+    "    ivec2 first = p * sourceSize / u_destinationSize;\n"
+    "    ivec2 last = min(((p + 1) * sourceSize + u_destinationSize - 1) / u_destinationSize, sourceSize) - 1;\n"
+    "    float depth = 0.0;\n"
+    "    for (int y = first.y; y <= last.y; ++y) {\n"
+    "        for (int x = first.x; x <= last.x; ++x)\n"
+    "            depth = max(depth, texelFetch(u_source, ivec2(x, y), u_sourceLevel).r);\n"
+    "    }\n"
+    "    imageStore(u_destination, p, vec4(depth));\n"
+    "}\n"
+};
+
+enum CullUniform
+{
+    CULL_INSTANCE_COUNT,
+    CULL_COMMAND_COUNT,
+    CULL_WORLD_MATRIX,
+    CULL_BOUNDS,
+    CULL_PLANES,
+    CULL_OCCLUSION,
+    CULL_PYRAMID_VIEW_PROJECTION,
+    CULL_PYRAMID,
+    CULL_PYRAMID_LEVELS,
+    CULL_UNIFORM_COUNT
+};
+static const char* __cullUniforms[CULL_UNIFORM_COUNT] =
+{
+    "u_instanceCount", "u_commandCount", "u_worldMatrix", "u_bounds", "u_planes", "u_occlusion",
+    "u_pyramidViewProjection", "u_pyramid", "u_pyramidLevels"
+};
+
+// The culling program is shared by all cullers and is deleted with the last one.
+static GLuint __cullProgram = 0;
+static GLint __cullUniformLocations[CULL_UNIFORM_COUNT];
+static unsigned int __cullerCount = 0;
+
+// Creates a program from the source of a compute shader.
+static GLuint createComputeProgram(const char* source, const char* name)
+{
+    GLuint shader;
+    GL_ASSERT( shader = glCreateShader(GL_COMPUTE_SHADER) );
+    GL_ASSERT( glShaderSource(shader, 1, &source, NULL) );
+    GL_ASSERT( glCompileShader(shader) );
+
+    GLint success;
+    char log[1024];
+    GL_ASSERT( glGetShaderiv(shader, GL_COMPILE_STATUS, &success) );
+    if (success != GL_TRUE)
+    {
+        GL_ASSERT( glGetShaderInfoLog(shader, sizeof(log), NULL, log) );
+        GP_WARN("Compile failed for the %s compute shader with error '%s'.", name, log);
+        GL_ASSERT( glDeleteShader(shader) );
+        return 0;
+    }
+
+    GLuint program;
+    GL_ASSERT( program = glCreateProgram() );
+    GL_ASSERT( glAttachShader(program, shader) );
+    GL_ASSERT( glLinkProgram(program) );
+    GL_ASSERT( glDeleteShader(shader) );
+
+    GL_ASSERT( glGetProgramiv(program, GL_LINK_STATUS, &success) );
+    if (success != GL_TRUE)
+    {
+        GL_ASSERT( glGetProgramInfoLog(program, sizeof(log), NULL, log) );
+        GP_WARN("Linking program failed for the %s compute shader with error '%s'.", name, log);
+        GL_ASSERT( glDeleteProgram(program) );
+        return 0;
+    }
+
+    return program;
+}
+
+#endif
+
+InstanceCuller::DepthPyramid::DepthPyramid()
+    : _width(0), _height(0), _levelCount(0), _texture(NULL), _sampler(NULL), _depthSampler(NULL), _updated(false),
+      _program(0), _sourceUniform(-1), _sourceLevelUniform(-1), _destinationSizeUniform(-1)
+{
+}
+
+InstanceCuller::DepthPyramid::~DepthPyramid()
+{
+    SAFE_RELEASE(_depthSampler);
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_texture);
+#ifdef GP_USE_COMPUTE_SHADERS
+    if (_program)
+    {
+        GL_ASSERT( glDeleteProgram(_program) );
+        _program = 0;
+    }
+#endif
+}
+
+InstanceCuller::DepthPyramid* InstanceCuller::DepthPyramid::create(unsigned int width, unsigned int height)
+{
+    GP_ASSERT(width > 0 && height > 0);
+
+#ifdef GP_USE_COMPUTE_SHADERS
+    if (!isSupported())
+        return NULL;
+
+    GLuint program = createComputeProgram(DEPTH_PYRAMID_CS, "depth pyramid");
+    if (!program)
+        return NULL;
+
+    DepthPyramid* pyramid = new DepthPyramid();
+    pyramid->_program = program;
+    GL_ASSERT( pyramid->_sourceUniform = glGetUniformLocation(program, "u_source") );
+    GL_ASSERT( pyramid->_sourceLevelUniform = glGetUniformLocation(program, "u_sourceLevel") );
+    GL_ASSERT( pyramid->_destinationSizeUniform = glGetUniformLocation(program, "u_destinationSize") );
+    pyramid->_width = width;
+    pyramid->_height = height;
+    pyramid->_levelCount = 1;
+    while ((std::max(width, height) >> pyramid->_levelCount) > 0)
+    {
+        ++pyramid->_levelCount;
+    }
+
+    // The levels are allocated at once, so the texture is complete before any is written.
+    TextureHandle handle;
+    GL_ASSERT( glGenTextures(1, &handle) );
+    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, handle) );
+    GL_ASSERT( glTexStorage2D(GL_TEXTURE_2D, pyramid->_levelCount, GL_R32F, width, height) );
+    pyramid->_texture = Texture::create(handle, width, height);
+    pyramid->_sampler = Texture::Sampler::create(pyramid->_texture);
+    pyramid->_sampler->setFilterMode(Texture::NEAREST_MIPMAP_NEAREST, Texture::NEAREST);
+    pyramid->_sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    Texture::setActiveUnit(0);
+    pyramid->_sampler->bind();
+    return pyramid;
+#else
+    return NULL;
+#endif
+}
+
+void InstanceCuller::DepthPyramid::update(Texture* depthTexture, Camera* camera)
+{
+    GP_ASSERT(depthTexture);
+    GP_ASSERT(camera);
+
+#ifdef GP_USE_COMPUTE_SHADERS
+    GP_PROFILE("InstanceCuller::DepthPyramid::update");
+
+    if (!_depthSampler || _depthSampler->getTexture() != depthTexture)
+    {
+        SAFE_RELEASE(_depthSampler);
+        _depthSampler = Texture::Sampler::create(depthTexture);
+        _depthSampler->setFilterMode(Texture::NEAREST, Texture::NEAREST);
+        _depthSampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    }
+
+    GL_ASSERT( glUseProgram(_program) );
+    GL_ASSERT( glUniform1i(_sourceUniform, 0) );
+    RenderStats::count(RenderStats::PROGRAM_BINDS);
+    Texture::setActiveUnit(0);
+    for (unsigned int level = 0; level < _levelCount; ++level)
+    {
+        // The first level is reduced from the depth texture, and every other from the level below it.
+        unsigned int width = std::max(_width >> level, 1u);
+        unsigned int height = std::max(_height >> level, 1u);
+        if (level == 0)
+            _depthSampler->bind();
+        else if (level == 1)
+            _sampler->bind();
+        GL_ASSERT( glUniform1i(_sourceLevelUniform, level == 0 ? 0 : (GLint)level - 1) );
+        GL_ASSERT( glUniform2i(_destinationSizeUniform, (GLint)width, (GLint)height) );
+        GL_ASSERT( glBindImageTexture(0, _texture->getHandle(), (GLint)level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F) );
+        GL_ASSERT( glDispatchCompute((width + 7) / 8, (height + 7) / 8, 1) );
+        GL_ASSERT( glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT) );
+    }
+    GL_ASSERT( glBindImageTexture(0, 0, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F) );
+
+    // Effect only binds its program when it changes, so restore the program it last bound.
+    Effect* effect = Effect::getCurrentEffect();
+    GL_ASSERT( glUseProgram(effect ? effect->_program : 0) );
+
+    _viewProjection = camera->getViewProjectionMatrix();
+    _updated = true;
+#endif
+}
+
+unsigned int InstanceCuller::DepthPyramid::getLevelCount() const
+{
+    return _levelCount;
+}
+
+Texture* InstanceCuller::DepthPyramid::getTexture() const
+{
+    return _texture;
+}
+
+const Matrix& InstanceCuller::DepthPyramid::getViewProjectionMatrix() const
+{
+    return _viewProjection;
+}
+
+InstanceCuller::InstanceCuller(Model* model)
+    : _model(model), _mesh(NULL), _frame(0), _visibleBuffer(0), _commandBuffer(0), _capacity(0)
+{
+    ++__cullerCount;
+}
+
+InstanceCuller::~InstanceCuller()
+{
+#ifdef GP_USE_COMPUTE_SHADERS
+    if (_visibleBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_visibleBuffer) );
+        _visibleBuffer = 0;
+    }
+    if (_commandBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_commandBuffer) );
+        _commandBuffer = 0;
+    }
+    if (--__cullerCount == 0 && __cullProgram)
+    {
+        GL_ASSERT( glDeleteProgram(__cullProgram) );
+        __cullProgram = 0;
+    }
+#endif
+}
+
+bool InstanceCuller::isSupported()
+{
+#ifdef GP_USE_COMPUTE_SHADERS
+    // Compute shaders and indirect draws are only available if the device supports OpenGL 4.3.
+    return glDispatchCompute && glMemoryBarrier && glBindBufferBase && glBindImageTexture && glTexStorage2D &&
+        glDrawElementsIndirect && glDrawArraysIndirect && Model::isInstancingSupported();
+#else
+    return false;
+#endif
+}
+
+Model* InstanceCuller::getModel() const
+{
+    return _model;
+}
+
+unsigned int InstanceCuller::cull(Camera* camera, DepthPyramid* pyramid)
+{
+    _mesh = NULL;
+    unsigned int instanceCount = _model->getInstanceCount();
+    Node* node = _model->getNode();
+    if (!camera && node && node->getScene())
+        camera = node->getScene()->getActiveCamera();
+    if (instanceCount == 0 || !camera)
+        return 0;
+
+#ifdef GP_USE_COMPUTE_SHADERS
+    GP_PROFILE("InstanceCuller::cull");
+
+    if (!__cullProgram)
+    {
+        __cullProgram = createComputeProgram(INSTANCE_CULL_CS, "instance culling");
+        if (!__cullProgram)
+            return 0;
+        for (unsigned int i = 0; i < CULL_UNIFORM_COUNT; ++i)
+        {
+            GL_ASSERT( __cullUniformLocations[i] = glGetUniformLocation(__cullProgram, __cullUniforms[i]) );
+        }
+    }
+
+    // The commands of the parts of the level of detail start with no instances, which the shader counts.
+    Mesh* mesh = _model->selectLOD(camera);
+    unsigned int partCount = mesh->getPartCount();
+    unsigned int commandCount = std::max(partCount, 1u);
+    _commands.assign(commandCount * INSTANCE_CULLER_COMMAND_SIZE, 0);
+    if (partCount == 0)
+    {
+        _commands[0] = mesh->getVertexCount();
+    }
+    for (unsigned int i = 0; i < partCount; ++i)
+    {
+        MeshPart* part = mesh->getPart(i);
+        unsigned int indexSize = part->getIndexFormat() == Mesh::INDEX8 ? 1 : (part->getIndexFormat() == Mesh::INDEX16 ? 2 : 4);
+        _commands[i * INSTANCE_CULLER_COMMAND_SIZE] = part->getIndexCount();
+        _commands[i * INSTANCE_CULLER_COMMAND_SIZE + 2] = part->getIndexOffset() / indexSize;
+    }
+    if (_commandBuffer == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &_commandBuffer) );
+    }
+    GL_ASSERT( glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer) );
+    GL_ASSERT( glBufferData(GL_DRAW_INDIRECT_BUFFER, _commands.size() * sizeof(GLuint), &_commands[0], GL_DYNAMIC_DRAW) );
+    GL_ASSERT( glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0) );
+
+    if (_visibleBuffer == 0 || _capacity < instanceCount)
+    {
+        if (_visibleBuffer == 0)
+        {
+            GL_ASSERT( glGenBuffers(1, &_visibleBuffer) );
+        }
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _visibleBuffer) );
+        GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, instanceCount * MODEL_INSTANCE_SIZE * sizeof(float), NULL, GL_DYNAMIC_DRAW) );
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+        _capacity = instanceCount;
+    }
+
+    const GLint* uniforms = __cullUniformLocations;
+    const BoundingSphere& bounds = mesh->getBoundingSphere();
+    const Frustum& frustum = camera->getFrustum();
+    Plane planes[6] = { frustum.getNear(), frustum.getFar(), frustum.getLeft(), frustum.getRight(), frustum.getBottom(), frustum.getTop() };
+    float planeData[24];
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+        const Vector3& normal = planes[i].getNormal();
+        planeData[i * 4] = normal.x;
+        planeData[i * 4 + 1] = normal.y;
+        planeData[i * 4 + 2] = normal.z;
+        planeData[i * 4 + 3] = planes[i].getDistance();
+    }
+    bool occlusion = pyramid && pyramid->_updated;
+
+    GL_ASSERT( glUseProgram(__cullProgram) );
+    GL_ASSERT( glUniform1ui(uniforms[CULL_INSTANCE_COUNT], instanceCount) );
+    GL_ASSERT( glUniform1ui(uniforms[CULL_COMMAND_COUNT], commandCount) );
+    GL_ASSERT( glUniformMatrix4fv(uniforms[CULL_WORLD_MATRIX], 1, GL_FALSE, node ? node->getWorldMatrix().m : Matrix::identity().m) );
+    GL_ASSERT( glUniform4f(uniforms[CULL_BOUNDS], bounds.center.x, bounds.center.y, bounds.center.z, bounds.radius) );
+    GL_ASSERT( glUniform4fv(uniforms[CULL_PLANES], 6, planeData) );
+    GL_ASSERT( glUniform1i(uniforms[CULL_OCCLUSION], occlusion ? 1 : 0) );
+    GL_ASSERT( glUniform1i(uniforms[CULL_PYRAMID], 0) );
+    RenderStats::count(RenderStats::PROGRAM_BINDS);
+    if (occlusion)
+    {
+        GL_ASSERT( glUniformMatrix4fv(uniforms[CULL_PYRAMID_VIEW_PROJECTION], 1, GL_FALSE, pyramid->_viewProjection.m) );
+        GL_ASSERT( glUniform1i(uniforms[CULL_PYRAMID_LEVELS], (GLint)pyramid->_levelCount) );
+        Texture::setActiveUnit(0);
+        pyramid->_sampler->bind();
+    }
+
+    GL_ASSERT( glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _model->updateInstanceBuffer()) );
+    GL_ASSERT( glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _visibleBuffer) );
+    GL_ASSERT( glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, _commandBuffer) );
+    GL_ASSERT( glDispatchCompute((instanceCount + 63) / 64, 1, 1) );
+    GL_ASSERT( glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0) );
+    GL_ASSERT( glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0) );
+    GL_ASSERT( glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, 0) );
+
+    // The draws read the visible instances as vertex attributes and their counts as commands.
+    GL_ASSERT( glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT) );
+    Effect* effect = Effect::getCurrentEffect();
+    GL_ASSERT( glUseProgram(effect ? effect->_program : 0) );
+
+    _mesh = mesh;
+    _frame = Game::getInstance()->getFrameIndex();
+    return instanceCount;
+#else
+    return 0;
+#endif
+}
+
+bool InstanceCuller::isCulled(Mesh* mesh) const
+{
+    return _mesh && _mesh == mesh && _frame == Game::getInstance()->getFrameIndex();
+}
+
+void InstanceCuller::draw(Mesh* mesh, MeshPart* part)
+{
+#ifdef GP_USE_COMPUTE_SHADERS
+    unsigned int index = 0;
+    for (unsigned int count = mesh->getPartCount(); index < count && mesh->getPart(index) != part; ++index);
+    GP_ASSERT(!part || index < mesh->getPartCount());
+
+    const GLvoid* offset = (const GLvoid*)(size_t)(index * INSTANCE_CULLER_COMMAND_SIZE * sizeof(GLuint));
+    GL_ASSERT( glBindBuffer(GL_DRAW_INDIRECT_BUFFER, _commandBuffer) );
+    if (part)
+    {
+        GL_ASSERT( glDrawElementsIndirect(part->getPrimitiveType(), part->getIndexFormat(), offset) );
+    }
+    else
+    {
+        GL_ASSERT( glDrawArraysIndirect(mesh->getPrimitiveType(), offset) );
+    }
+    GL_ASSERT( glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0) );
+    RenderStats::count(RenderStats::DRAW_CALLS);
+#endif
+}
+
+void InstanceCuller::invalidate()
+{
+    _mesh = NULL;
+}
+
+}
@@ -0,0 +1,217 @@
+#ifndef INSTANCECULLER_H_
+#define INSTANCECULLER_H_
+
+#include "Texture.h"
+#include "Matrix.h"
+
+namespace gameplay
+{
+
+class Camera;
+class Mesh;
+class MeshPart;
+class Model;
+
+/**
+ * Defines the culling of the instances of a model on the GPU.
+ *
+ * Large sets of instances, such as foliage, debris or crowds of impostors, are culled
+ * by a compute shader without any work per instance on the CPU. Every instance is
+ * tested against the frustum of a camera and, optionally, against the depth pyramid of
+ * the previous frame, and the instances that pass are written to a compacted instance
+ * buffer. The compute shader also writes the instance counts of the indirect draw
+ * commands of the mesh parts, so the model draws the visible instances with indirect
+ * draw calls without reading anything back from the GPU.
+ *
+ * The culler of a model is created with Model::setInstanceCulling, and cull must be
+ * called every frame before the model is drawn. The culled instances are drawn by
+ * every draw of the model in the frame of the cull, so views that see other instances,
+ * such as shadow maps, should be drawn before it. Otherwise, and when the model draws
+ * a different level of detail than the one that was culled, all instances are drawn.
+ * The order of the visible instances is not preserved.
+ *
+ * Culling on the GPU requires OpenGL 4.3. Where it is not supported, models draw all
+ * of their instances.
+ *
+ * @see Model::setInstanceCulling
+ * @script{ignore}
+ */
+class InstanceCuller
+{
+    friend class Model;
+
+public:
+
+    /**
+     * Defines a pyramid of the farthest depths of a depth buffer, which the instances
+     * are tested against for occlusion.
+     *
+     * Every level of the pyramid holds, in each texel, the farthest depth of the texels
+     * that it covers in the level below, starting from the depth texture of a view. An
+     * instance is occluded when its bounds are behind the farthest depth of the area that
+     * they cover, which only takes four texels at the level where that area is a texel.
+     *
+     * The pyramid should be updated once the opaque geometry of a frame has been drawn,
+     * with the camera it was drawn with, and is used by the culls of the next frame.
+     * Instances that were hidden and come into view when the camera moves may therefore
+     * appear a frame late.
+     */
+    class DepthPyramid
+    {
+        friend class InstanceCuller;
+
+    public:
+
+        /**
+         * Creates a depth pyramid.
+         *
+         * @param width The width of the first level, usually half the width of the depth texture.
+         * @param height The height of the first level, usually half the height of the depth texture.
+         *
+         * @return The new pyramid, or NULL if culling on the GPU is not supported.
+         */
+        static DepthPyramid* create(unsigned int width, unsigned int height);
+
+        /**
+         * Destructor.
+         */
+        ~DepthPyramid();
+
+        /**
+         * Builds the pyramid from a depth texture.
+         *
+         * @param depthTexture The depth texture of the view, such as the depth texture of its frame buffer.
+         * @param camera The camera that the view was drawn with.
+         */
+        void update(Texture* depthTexture, Camera* camera);
+
+        /**
+         * Returns the number of levels of the pyramid.
+         *
+         * @return The level count.
+         */
+        unsigned int getLevelCount() const;
+
+        /**
+         * Returns the texture of the pyramid, whose mipmap levels are the levels of the pyramid.
+         *
+         * @return The pyramid texture.
+         */
+        Texture* getTexture() const;
+
+        /**
+         * Returns the view projection matrix of the camera of the last update.
+         *
+         * @return The view projection matrix.
+         */
+        const Matrix& getViewProjectionMatrix() const;
+
+    private:
+
+        /**
+         * Constructor.
+         */
+        DepthPyramid();
+
+        /**
+         * Hidden copy constructor.
+         */
+        DepthPyramid(const DepthPyramid& copy);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        DepthPyramid& operator=(const DepthPyramid&);
+
+        unsigned int _width;
+        unsigned int _height;
+        unsigned int _levelCount;
+        Texture* _texture;
+        Texture::Sampler* _sampler;
+        Texture::Sampler* _depthSampler;
+        Matrix _viewProjection;
+        bool _updated;
+        GLuint _program;
+        GLint _sourceUniform;
+        GLint _sourceLevelUniform;
+        GLint _destinationSizeUniform;
+    };
+
+    /**
+     * Determines if the current device supports culling instances on the GPU.
+     *
+     * @return True if compute shaders and indirect draws are supported, false otherwise.
+     */
+    static bool isSupported();
+
+    /**
+     * Returns the model whose instances are culled.
+     *
+     * @return The model.
+     */
+    Model* getModel() const;
+
+    /**
+     * Culls the instances of the model for the current frame.
+     *
+     * The level of detail that the model draws for the camera is culled, with the bounds
+     * of its mesh transformed by the world transform of each instance.
+     *
+     * @param camera The camera to cull for, or NULL to use the active camera of the scene of the model.
+     * @param pyramid The depth pyramid of the previous frame to test for occlusion, or NULL to
+     *      only test against the frustum.
+     *
+     * @return The number of instances that were tested.
+     */
+    unsigned int cull(Camera* camera = NULL, DepthPyramid* pyramid = NULL);
+
+private:
+
+    /**
+     * Constructor.
+     */
+    InstanceCuller(Model* model);
+
+    /**
+     * Destructor.
+     */
+    ~InstanceCuller();
+
+    /**
+     * Hidden copy constructor.
+     */
+    InstanceCuller(const InstanceCuller& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    InstanceCuller& operator=(const InstanceCuller&);
+
+    /**
+     * Returns whether the given mesh of the model was culled in the current frame.
+     */
+    bool isCulled(Mesh* mesh) const;
+
+    /**
+     * Draws the visible instances of the given mesh part, or of the whole mesh if part is
+     * NULL, with the instance attributes bound to the visible instance buffer.
+     */
+    void draw(Mesh* mesh, MeshPart* part);
+
+    /**
+     * Discards the result of the last cull, once the instances of the model have changed.
+     */
+    void invalidate();
+
+    Model* _model;
+    Mesh* _mesh;
+    unsigned int _frame;
+    VertexBufferHandle _visibleBuffer;
+    VertexBufferHandle _commandBuffer;
+    unsigned int _capacity;
+    std::vector<unsigned int> _commands;
+};
+
+}
+
+#endif
@@ -0,0 +1,386 @@
+#include "Base.h"
+#include "JobController.h"
+#include "Game.h"
+#include "World.h"
+
+namespace gameplay
+{
+
+JobController::Group::Group()
+    : _pending(0)
+{
+}
+
+JobController::Group::~Group()
+{
+    GP_ASSERT(_pending == 0);
+}
+
+bool JobController::Group::isComplete() const
+{
+    return _pending == 0;
+}
+
+JobController::JobController()
+    : _queuedJobs(0), _running(false)
+{
+}
+
+JobController::~JobController()
+{
+}
+
+void JobController::initialize()
+{
+    unsigned int workerCount = std::thread::hardware_concurrency();
+    workerCount = workerCount > 1 ? workerCount - 1 : 0;
+
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("jobs", true);
+    if (config && config->exists("workerCount"))
+    {
+        int count = config->getInt("workerCount");
+        workerCount = count > 0 ? (unsigned int)count : 0;
+    }
+
+    _mainThread = std::this_thread::get_id();
+    _running = true;
+
+    // Worker index 0 is reserved for the threads that are not workers.
+    _queues.push_back(new Queue());
+    _threadIds.push_back(std::thread::id());
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _queues.push_back(new Queue());
+        _threadIds.push_back(std::thread::id());
+    }
+
+    // No job can be submitted before initialization completes, so the workers
+    // never look up their index while the ids are being written.
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _threads.push_back(new std::thread(&JobController::run, this, i + 1));
+    }
+    for (unsigned int i = 0; i < workerCount; ++i)
+    {
+        _threadIds[i + 1] = _threads[i]->get_id();
+    }
+}
+
+void JobController::finalize()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _wakeup.notify_all();
+
+    for (size_t i = 0, count = _threads.size(); i < count; ++i)
+    {
+        _threads[i]->join();
+        SAFE_DELETE(_threads[i]);
+    }
+    _threads.clear();
+    _threadIds.clear();
+
+    for (size_t i = 0, count = _queues.size(); i < count; ++i)
+    {
+        SAFE_DELETE(_queues[i]);
+    }
+    _queues.clear();
+    _mainThreadEntries.clear();
+}
+
+void JobController::update()
+{
+    Entry entry;
+    while (nextMainThread(&entry))
+    {
+        execute(entry, 0);
+    }
+}
+
+unsigned int JobController::getWorkerCount() const
+{
+    return (unsigned int)_threads.size() + 1;
+}
+
+unsigned int JobController::getCurrentWorker() const
+{
+    std::thread::id id = std::this_thread::get_id();
+    for (size_t i = 1, count = _threadIds.size(); i < count; ++i)
+    {
+        if (_threadIds[i] == id)
+            return (unsigned int)i;
+    }
+    return 0;
+}
+
+void JobController::submit(Job* job, Group* group, Group* dependency)
+{
+    submit(&job, 1, group, dependency);
+}
+
+void JobController::submit(Job** jobs, unsigned int count, Group* group, Group* dependency)
+{
+    GP_ASSERT(jobs || count == 0);
+    GP_ASSERT(group);
+
+    if (count == 0)
+        return;
+
+    group->_pending += count;
+
+    if (dependency)
+    {
+        // The dependency only completes while the mutex is locked, so it either
+        // releases these jobs itself or has already completed.
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (dependency->_pending > 0)
+        {
+            for (unsigned int i = 0; i < count; ++i)
+            {
+                dependency->_dependents.push_back(std::make_pair(jobs[i], group));
+            }
+            return;
+        }
+    }
+
+    unsigned int worker = getCurrentWorker();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        push(worker, jobs[i], group);
+    }
+    notify();
+}
+
+void JobController::wait(Group* group)
+{
+    GP_ASSERT(group);
+
+    unsigned int worker = getCurrentWorker();
+    bool mainThread = std::this_thread::get_id() == _mainThread;
+    while (group->_pending > 0)
+    {
+        Entry entry;
+        if ((mainThread && nextMainThread(&entry)) || next(worker, &entry))
+        {
+            execute(entry, worker);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (group->_pending > 0 && _queuedJobs == 0)
+        {
+            if (mainThread)
+            {
+                std::lock_guard<std::mutex> mainThreadLock(_mainThreadMutex);
+                if (!_mainThreadEntries.empty())
+                    continue;
+            }
+            _wakeup.wait(lock);
+        }
+    }
+}
+
+void JobController::execute(Job** jobs, unsigned int count)
+{
+    GP_ASSERT(jobs || count == 0);
+
+    if (count == 0)
+        return;
+
+    Group group;
+    submit(jobs, count, &group);
+    wait(&group);
+}
+
+void JobController::parallelFor(unsigned int count, const std::function<void(unsigned int, unsigned int, unsigned int)>& function, unsigned int grainSize)
+{
+    if (count == 0)
+        return;
+
+    // A few batches per worker lets faster workers steal the remaining batches of slower ones.
+    if (grainSize == 0)
+    {
+        unsigned int batchCount = getWorkerCount() * 4;
+        grainSize = (count + batchCount - 1) / batchCount;
+    }
+    if (count <= grainSize)
+    {
+        function(0, count, getCurrentWorker());
+        return;
+    }
+
+    class RangeJob : public Job
+    {
+    public:
+        void execute(unsigned int worker)
+        {
+            // The batches run with the world of the loop current, whichever thread executes them.
+            World* previous = World::setCurrent(world);
+            (*function)(begin, end, worker);
+            World::setCurrent(previous);
+        }
+        const std::function<void(unsigned int, unsigned int, unsigned int)>* function;
+        World* world;
+        unsigned int begin;
+        unsigned int end;
+    };
+
+    unsigned int jobCount = (count + grainSize - 1) / grainSize;
+    std::vector<RangeJob> jobs(jobCount);
+    std::vector<Job*> jobPointers(jobCount);
+    World* world = World::getCurrent();
+    for (unsigned int i = 0; i < jobCount; ++i)
+    {
+        jobs[i].function = &function;
+        jobs[i].world = world;
+        jobs[i].begin = i * grainSize;
+        jobs[i].end = std::min(count, (i + 1) * grainSize);
+        jobPointers[i] = &jobs[i];
+    }
+    execute(&jobPointers[0], jobCount);
+}
+
+void JobController::executeOnMainThread(Job* job, Group* group)
+{
+    GP_ASSERT(job);
+
+    if (group)
+        ++group->_pending;
+
+    Entry entry;
+    entry.job = job;
+    entry.group = group;
+    {
+        std::lock_guard<std::mutex> lock(_mainThreadMutex);
+        _mainThreadEntries.push_back(entry);
+    }
+    notify();
+}
+
+void JobController::run(unsigned int worker)
+{
+    while (true)
+    {
+        Entry entry;
+        if (next(worker, &entry))
+        {
+            execute(entry, worker);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        if (!_running)
+            break;
+        if (_queuedJobs == 0)
+            _wakeup.wait(lock);
+    }
+}
+
+void JobController::push(unsigned int worker, Job* job, Group* group)
+{
+    GP_ASSERT(worker < _queues.size());
+
+    Entry entry;
+    entry.job = job;
+    entry.group = group;
+
+    Queue* queue = _queues[worker];
+    std::lock_guard<std::mutex> lock(queue->mutex);
+    queue->entries.push_back(entry);
+    ++_queuedJobs;
+}
+
+bool JobController::next(unsigned int worker, Entry* entry)
+{
+    GP_ASSERT(entry);
+
+    if (_queuedJobs == 0)
+        return false;
+
+    // Our own most recent job is the most likely to still be in the cache.
+    Queue* queue = _queues[worker];
+    {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        if (!queue->entries.empty())
+        {
+            *entry = queue->entries.back();
+            queue->entries.pop_back();
+            --_queuedJobs;
+            return true;
+        }
+    }
+
+    // Steal the oldest job of another worker, which tends to be the largest remaining piece of work.
+    for (size_t i = 1, count = _queues.size(); i < count; ++i)
+    {
+        Queue* victim = _queues[(worker + i) % count];
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->entries.empty())
+        {
+            *entry = victim->entries.front();
+            victim->entries.pop_front();
+            --_queuedJobs;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobController::nextMainThread(Entry* entry)
+{
+    GP_ASSERT(entry);
+
+    std::lock_guard<std::mutex> lock(_mainThreadMutex);
+    if (_mainThreadEntries.empty())
+        return false;
+    *entry = _mainThreadEntries.front();
+    _mainThreadEntries.erase(_mainThreadEntries.begin());
+    return true;
+}
+
+void JobController::execute(const Entry& entry, unsigned int worker)
+{
+    GP_ASSERT(entry.job);
+
+    entry.job->execute(worker);
+
+    Group* group = entry.group;
+    if (group == NULL)
+        return;
+
+    std::vector<std::pair<Job*, Group*> > dependents;
+    bool completed;
+    {
+        // The group may be destroyed by a waiting thread as soon as its last job completes,
+        // so its dependents are taken before the count is decremented and put back if
+        // other jobs are still pending.
+        std::lock_guard<std::mutex> lock(_mutex);
+        dependents.swap(group->_dependents);
+        completed = group->_pending.fetch_sub(1) == 1;
+        if (!completed)
+            dependents.swap(group->_dependents);
+    }
+
+    if (!completed)
+        return;
+
+    for (size_t i = 0, count = dependents.size(); i < count; ++i)
+    {
+        push(worker, dependents[i].first, dependents[i].second);
+    }
+    notify();
+}
+
+void JobController::notify()
+{
+    // Locking the mutex ensures that a thread that has just found no work is already
+    // waiting, so that it doesn't miss the notification.
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _wakeup.notify_all();
+}
+
+}
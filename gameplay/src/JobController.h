@@ -0,0 +1,290 @@
+#ifndef JOBCONTROLLER_H_
+#define JOBCONTROLLER_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a work-stealing scheduler that executes jobs in parallel with the main thread.
+ *
+ * Every thread that executes jobs owns a queue of jobs. Jobs submitted from a worker
+ * thread are pushed onto the queue of that worker, which executes its most recently
+ * submitted jobs first. A worker that runs out of jobs steals the oldest jobs from the
+ * queues of the other workers, which keeps all workers busy without a central queue
+ * becoming a bottleneck. Jobs submitted from any other thread are pushed onto the
+ * queue of worker index 0.
+ *
+ * Jobs are submitted into a job group, which counts the jobs that have not completed
+ * yet. A thread that waits for a group takes part in executing jobs until every job of
+ * the group has completed, so waiting from within a job does not block a worker. A job
+ * can also be submitted with a dependency on another group, in which case it is only
+ * queued once every job of that group has completed.
+ *
+ * Each thread that executes jobs is identified by a worker index in the range
+ * [0, getWorkerCount()), where every thread that is not a worker of the controller,
+ * such as the main thread, uses index 0. Jobs can use the worker index to write to
+ * per-thread storage without any further synchronization, as long as only a single
+ * thread other than the workers submits jobs at a time.
+ *
+ * Jobs that must run on the main thread, such as jobs that call into OpenGL, can be
+ * queued with executeOnMainThread from any thread. They are executed at the start of
+ * the next frame, or while the main thread waits for a group.
+ *
+ * The number of worker threads defaults to one less than the number of hardware
+ * threads and can be set with the 'workerCount' property of the 'jobs' namespace
+ * in the game configuration file. A worker count of 0 executes all jobs on the
+ * thread that waits for them.
+ *
+ * @script{ignore}
+ */
+class JobController
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines a unit of work that can be executed by the job controller.
+     */
+    class Job
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~Job() { }
+
+        /**
+         * Executes the job.
+         *
+         * @param worker The index of the thread executing the job.
+         */
+        virtual void execute(unsigned int worker) = 0;
+    };
+
+    /**
+     * Defines a set of submitted jobs that can be waited for or depended on.
+     *
+     * A group must not be destroyed before all of its jobs have completed.
+     */
+    class Group
+    {
+        friend class JobController;
+
+    public:
+
+        /**
+         * Constructor.
+         */
+        Group();
+
+        /**
+         * Destructor.
+         */
+        ~Group();
+
+        /**
+         * Returns whether every job submitted into the group has completed.
+         *
+         * @return true if the group has no pending jobs.
+         */
+        bool isComplete() const;
+
+    private:
+
+        /**
+         * Hidden copy constructor.
+         */
+        Group(const Group&);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Group& operator=(const Group&);
+
+        std::atomic<unsigned int> _pending;
+        std::vector<std::pair<Job*, Group*> > _dependents;
+    };
+
+    /**
+     * Returns the number of threads that execute jobs, including the submitting thread.
+     *
+     * @return The number of threads that execute jobs.
+     */
+    unsigned int getWorkerCount() const;
+
+    /**
+     * Returns the worker index of the calling thread.
+     *
+     * @return The worker index, which is 0 for every thread that is not a worker.
+     */
+    unsigned int getCurrentWorker() const;
+
+    /**
+     * Submits a job into the given group.
+     *
+     * The job is owned by the caller and must remain valid until the group completes.
+     *
+     * @param job The job to execute.
+     * @param group The group to add the job to.
+     * @param dependency A group whose jobs must all complete before the job is started, or NULL.
+     */
+    void submit(Job* job, Group* group, Group* dependency = NULL);
+
+    /**
+     * Submits the given jobs into the given group.
+     *
+     * @param jobs The jobs to execute.
+     * @param count The number of jobs.
+     * @param group The group to add the jobs to.
+     * @param dependency A group whose jobs must all complete before the jobs are started, or NULL.
+     */
+    void submit(Job** jobs, unsigned int count, Group* group, Group* dependency = NULL);
+
+    /**
+     * Executes jobs until every job of the given group has completed.
+     *
+     * @param group The group to wait for.
+     */
+    void wait(Group* group);
+
+    /**
+     * Executes the given jobs and waits for all of them to complete.
+     *
+     * @param jobs The jobs to execute.
+     * @param count The number of jobs.
+     */
+    void execute(Job** jobs, unsigned int count);
+
+    /**
+     * Calls the given function for every index in the range [0, count) in parallel.
+     *
+     * The range is split into contiguous batches of at least grainSize indices, and the
+     * function is called once per batch with the range of the batch. This method returns
+     * once the function has been called for every index. Each batch is executed with the
+     * World that is current on the calling thread made current on the thread executing it.
+     *
+     * @param count The number of indices.
+     * @param function The function called with the first index, the end index and the worker index of a batch.
+     * @param grainSize The minimum number of indices per batch, or 0 to split the range evenly among the workers.
+     */
+    void parallelFor(unsigned int count, const std::function<void(unsigned int, unsigned int, unsigned int)>& function, unsigned int grainSize = 0);
+
+    /**
+     * Queues a job to be executed on the main thread.
+     *
+     * The job is executed at the start of the next frame, or earlier if the main thread
+     * waits for a group before then. It is owned by the caller and must remain valid
+     * until the group completes. A group that contains jobs queued for the main thread
+     * should only be waited for on the main thread.
+     *
+     * @param job The job to execute.
+     * @param group The group to add the job to, or NULL.
+     */
+    void executeOnMainThread(Job* job, Group* group = NULL);
+
+private:
+
+    /**
+     * A job queued for execution along with the group it belongs to.
+     */
+    struct Entry
+    {
+        Job* job;
+        Group* group;
+    };
+
+    /**
+     * The jobs queued on a single worker.
+     */
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Entry> entries;
+    };
+
+    /**
+     * Constructor.
+     */
+    JobController();
+
+    /**
+     * Destructor.
+     */
+    ~JobController();
+
+    /**
+     * Hidden copy constructor.
+     */
+    JobController(const JobController&);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    JobController& operator=(const JobController&);
+
+    /**
+     * Called during startup to start the worker threads.
+     */
+    void initialize();
+
+    /**
+     * Called during shutdown to stop the worker threads.
+     */
+    void finalize();
+
+    /**
+     * Called once per frame to execute the jobs queued for the main thread.
+     */
+    void update();
+
+    /**
+     * Executes queued jobs until the controller is finalized.
+     */
+    void run(unsigned int worker);
+
+    /**
+     * Pushes a job whose dependencies have completed onto the queue of the given worker.
+     */
+    void push(unsigned int worker, Job* job, Group* group);
+
+    /**
+     * Pops a job off of the queue of the given worker, or steals one from another worker.
+     *
+     * @return true if a job was found.
+     */
+    bool next(unsigned int worker, Entry* entry);
+
+    /**
+     * Pops a job off of the main thread queue.
+     *
+     * @return true if a job was found.
+     */
+    bool nextMainThread(Entry* entry);
+
+    /**
+     * Executes a job and completes it in its group.
+     */
+    void execute(const Entry& entry, unsigned int worker);
+
+    /**
+     * Wakes up all threads that are waiting for jobs or groups.
+     */
+    void notify();
+
+    std::vector<std::thread*> _threads;
+    std::vector<std::thread::id> _threadIds;
+    std::vector<Queue*> _queues;
+    std::thread::id _mainThread;
+    std::mutex _mainThreadMutex;
+    std::vector<Entry> _mainThreadEntries;
+    std::mutex _mutex;
+    std::condition_variable _wakeup;
+    std::atomic<unsigned int> _queuedJobs;
+    bool _running;
+};
+
+}
+
+#endif
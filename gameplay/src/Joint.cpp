@@ -65,6 +65,11 @@ void Joint::transformChanged()
 {
     Node::transformChanged();
     _jointMatrixDirty = true;
+
+    for (const SkinReference* itr = &_skin; itr && itr->skin; itr = itr->next)
+    {
+        itr->skin->setDirty(false);
+    }
 }
 
 void Joint::updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette)
@@ -78,8 +83,8 @@ void Joint::updateJointMatrix(const Matrix& bindShape, Vector4* matrixPalette)
         _jointMatrixDirty = false;
 
         static Matrix t;
-        Matrix::multiply(Node::getWorldMatrix(), getInverseBindPose(), &t);
-        Matrix::multiply(t, bindShape, &t);
+        Matrix::multiplyAffine(Node::getWorldMatrix(), getInverseBindPose(), &t);
+        Matrix::multiplyAffine(t, bindShape, &t);
 
         GP_ASSERT(matrixPalette);
         matrixPalette[0].set(t.m[0], t.m[4], t.m[8], t.m[12]);
@@ -97,6 +102,11 @@ void Joint::setInverseBindPose(const Matrix& m)
 {
     _bindPose = m;
     _jointMatrixDirty = true;
+
+    for (const SkinReference* itr = &_skin; itr && itr->skin; itr = itr->next)
+    {
+        itr->skin->setDirty(true);
+    }
 }
 
 void Joint::addSkin(MeshSkin* skin)
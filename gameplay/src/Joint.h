@@ -20,6 +20,7 @@ class Joint : public Node
 {
     friend class Node;
     friend class MeshSkin;
+    friend class AnimationController;
     friend class Bundle;
 
 public:
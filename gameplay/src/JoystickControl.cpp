@@ -142,6 +142,7 @@ void JoystickControl::setRadius(float radius, bool isPercentage)
     _radiusCoord = radius;
     setBoundsBit(isPercentage, _boundsBits, BOUNDS_RADIUS_PERCENTAGE_BIT);
     updateAbsoluteSizes();
+    setGeometryDirty();
 }
 
 float JoystickControl::getRadius() const
@@ -215,6 +216,7 @@ void JoystickControl::setRegion(const Vector2& regionSizeIn, Vector2& regionSize
     regionSizeOut = regionSizeIn;
     setBoundsBit(isWidthPercentage, regionBoundsBitsOut, BOUNDS_WIDTH_PERCENTAGE_BIT);
     setBoundsBit(isHeightPercentage, regionBoundsBitsOut, BOUNDS_HEIGHT_PERCENTAGE_BIT);
+    setGeometryDirty();
 }
 
 void JoystickControl::getRegion(Vector2& regionOut, int& regionBoundsBitsOut, const char* regionPropertyId)
@@ -304,6 +306,9 @@ void JoystickControl::addListener(Control::Listener* listener, int eventFlags)
 
 bool JoystickControl::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
 {
+    // The inner region follows the touch without changing the state of the joystick.
+    setGeometryDirty();
+
     switch (evt)
     {
         case Touch::TOUCH_PRESS:
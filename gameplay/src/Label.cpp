@@ -4,7 +4,7 @@
 namespace gameplay
 {
 
-Label::Label() : _text(""), _font(NULL)
+Label::Label() : _text(""), _font(NULL), _measuredFont(NULL), _measuredFontSize(0), _measuredWidth(0), _measuredHeight(0)
 {
 }
 
@@ -66,6 +66,7 @@ void Label::setText(const char* text)
     if ((text == NULL && _text.length() > 0) || strcmp(text, _text.c_str()) != 0)
     {
         _text = text ? text : "";
+        setGeometryDirty();
         if (_autoSize != AUTO_SIZE_NONE)
             setDirty(DIRTY_BOUNDS);
     }
@@ -101,8 +102,16 @@ void Label::updateBounds()
         // Measure bounds based only on normal state so that bounds updates are not always required on state changes.
         // This is a trade-off for functionality vs performance, but changing the size of UI controls on hover/focus/etc
         // is a pretty bad practice so we'll prioritize performance here.
-        unsigned int w, h;
-        _font->measureText(_text.c_str(), getFontSize(NORMAL), &w, &h);
+        unsigned int fontSize = getFontSize(NORMAL);
+        if (_font != _measuredFont || fontSize != _measuredFontSize || _text != _measuredText)
+        {
+            _font->measureText(_text.c_str(), fontSize, &_measuredWidth, &_measuredHeight);
+            _measuredText = _text;
+            _measuredFont = _font;
+            _measuredFontSize = fontSize;
+        }
+        unsigned int w = _measuredWidth;
+        unsigned int h = _measuredHeight;
         if (_autoSize & AUTO_SIZE_WIDTH)
         {
             setWidthInternal(w + getBorder(NORMAL).left + getBorder(NORMAL).right + getPadding().left + getPadding().right);
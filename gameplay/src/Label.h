@@ -147,6 +147,16 @@ private:
      * Constructor.
      */
     Label(const Label& copy);
+
+    /**
+     * The text, font and font size that the measured size of the text was computed for, which
+     * is kept between bounds updates so that only text changes measure the text again.
+     */
+    std::string _measuredText;
+    Font* _measuredFont;
+    unsigned int _measuredFontSize;
+    unsigned int _measuredWidth;
+    unsigned int _measuredHeight;
 };
 
 }
@@ -0,0 +1,349 @@
+#include "Base.h"
+#include "LightClusters.h"
+#include "Scene.h"
+#include "Game.h"
+#include "JobController.h"
+
+// The width of the light cluster texture, in texels. A power of two keeps the
+// row and column of a texel exact in the shaders.
+#define LIGHT_CLUSTER_TEXTURE_WIDTH 512
+
+// The number of light list entries reserved for each cluster on average.
+#define LIGHT_CLUSTER_AVERAGE_LIGHTS 32
+
+// The number of texels each light takes.
+#define LIGHT_CLUSTER_LIGHT_TEXELS 3
+
+namespace gameplay
+{
+
+LightClusters::LightClusters(Scene* scene)
+    : _scene(scene), _tilesX(16), _tilesY(8), _slices(24), _maxLights(256), _maxEntries(0), _clusterOffset(0), _entryOffset(0),
+      _lightCount(0), _usedRows(0), _sampler(NULL), _overflowWarned(false)
+{
+    GP_ASSERT(_scene);
+    resize();
+}
+
+LightClusters::~LightClusters()
+{
+    SAFE_RELEASE(_sampler);
+}
+
+void LightClusters::setGridSize(unsigned int tilesX, unsigned int tilesY, unsigned int slices)
+{
+    GP_ASSERT(tilesX > 0 && tilesY > 0 && slices > 0);
+
+    if (tilesX == _tilesX && tilesY == _tilesY && slices == _slices)
+        return;
+
+    _tilesX = tilesX;
+    _tilesY = tilesY;
+    _slices = slices;
+    resize();
+}
+
+void LightClusters::setMaxLightCount(unsigned int count)
+{
+    GP_ASSERT(count > 0);
+
+    if (count == _maxLights)
+        return;
+
+    _maxLights = count;
+    resize();
+}
+
+unsigned int LightClusters::getMaxLightCount() const
+{
+    return _maxLights;
+}
+
+unsigned int LightClusters::getLightCount() const
+{
+    return _lightCount;
+}
+
+const Texture::Sampler* LightClusters::getSampler() const
+{
+    return _sampler;
+}
+
+const Vector4* LightClusters::getParameters() const
+{
+    return _parameters;
+}
+
+unsigned int LightClusters::getParameterCount() const
+{
+    return 4;
+}
+
+void LightClusters::resize()
+{
+    unsigned int clusterCount = _tilesX * _tilesY * _slices;
+    _maxEntries = clusterCount * LIGHT_CLUSTER_AVERAGE_LIGHTS;
+    _clusterOffset = _maxLights * LIGHT_CLUSTER_LIGHT_TEXELS;
+    _entryOffset = _clusterOffset + clusterCount;
+
+    unsigned int texelCount = _entryOffset + (_maxEntries + 3) / 4;
+    unsigned int height = (texelCount + LIGHT_CLUSTER_TEXTURE_WIDTH - 1) / LIGHT_CLUSTER_TEXTURE_WIDTH;
+
+    _data.assign((size_t)height * LIGHT_CLUSTER_TEXTURE_WIDTH * 4, 0.0f);
+    _clusterCounts.assign(clusterCount, 0);
+    _clusterFirsts.assign(clusterCount, 0);
+    _lightCount = 0;
+    _usedRows = 0;
+
+    SAFE_RELEASE(_sampler);
+    Texture* texture = Texture::create(Texture::RGBA32F, LIGHT_CLUSTER_TEXTURE_WIDTH, height, (const unsigned char*)&_data[0]);
+    GP_ASSERT(texture);
+    _sampler = Texture::Sampler::create(texture);
+    _sampler->setFilterMode(Texture::NEAREST, Texture::NEAREST);
+    _sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    SAFE_RELEASE(texture);
+
+    _parameters[0].set((float)_tilesX, (float)_tilesY, (float)_slices, 0.0f);
+    _parameters[1].set(0.0f, 0.0f, 0.0f, 0.0f);
+    _parameters[2].set(0.0f, 0.0f, (float)_clusterOffset, (float)_entryOffset);
+    _parameters[3].set((float)LIGHT_CLUSTER_TEXTURE_WIDTH, 1.0f / LIGHT_CLUSTER_TEXTURE_WIDTH, 1.0f / height, 0.0f);
+}
+
+bool LightClusters::gatherLight(Node* node)
+{
+    Light* light = node->getLight();
+    if (light && node->isEnabledInHierarchy())
+    {
+        if (light->getLightType() == Light::DIRECTIONAL)
+            _directionalLights.push_back(light);
+        else
+            _localLights.push_back(light);
+    }
+    return true;
+}
+
+void LightClusters::setTexel(unsigned int index, float x, float y, float z, float w)
+{
+    float* texel = &_data[(size_t)index * 4];
+    texel[0] = x;
+    texel[1] = y;
+    texel[2] = z;
+    texel[3] = w;
+}
+
+bool LightClusters::computeBounds(const Vector3& center, float radius, const Camera* camera, LightBounds* bounds) const
+{
+    float nearPlane = camera->getNearPlane();
+    float farPlane = camera->getFarPlane();
+
+    // The view looks down the negative z axis.
+    float minDepth = -center.z - radius;
+    float maxDepth = -center.z + radius;
+    if (maxDepth < nearPlane || minDepth > farPlane)
+        return false;
+
+    float sliceScale = _parameters[2].x;
+    float sliceBias = _parameters[2].y;
+    bounds->minZ = minDepth <= nearPlane ? 0 : (unsigned int)std::max(floorf(logf(minDepth) * sliceScale + sliceBias), 0.0f);
+    bounds->maxZ = maxDepth >= farPlane ? _slices - 1 : (unsigned int)std::max(floorf(logf(maxDepth) * sliceScale + sliceBias), 0.0f);
+    bounds->minZ = std::min(bounds->minZ, _slices - 1);
+    bounds->maxZ = std::min(bounds->maxZ, _slices - 1);
+
+    // A perspective projection of a box that reaches behind the near plane has no finite bounds on screen.
+    if (camera->getCameraType() == Camera::PERSPECTIVE && center.z + radius > -nearPlane)
+    {
+        bounds->minX = 0;
+        bounds->maxX = _tilesX - 1;
+        bounds->minY = 0;
+        bounds->maxY = _tilesY - 1;
+        return true;
+    }
+
+    // Project the corners of the box around the sphere and bound them on screen.
+    const Matrix& projection = camera->getProjectionMatrix();
+    float minU = FLT_MAX;
+    float minV = FLT_MAX;
+    float maxU = -FLT_MAX;
+    float maxV = -FLT_MAX;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        Vector4 corner(center.x + ((i & 1) ? radius : -radius), center.y + ((i & 2) ? radius : -radius), center.z + ((i & 4) ? radius : -radius), 1.0f);
+        projection.transformVector(&corner);
+        float u = corner.x / corner.w;
+        float v = corner.y / corner.w;
+        minU = std::min(minU, u);
+        minV = std::min(minV, v);
+        maxU = std::max(maxU, u);
+        maxV = std::max(maxV, v);
+    }
+    if (maxU < -1.0f || minU > 1.0f || maxV < -1.0f || minV > 1.0f)
+        return false;
+
+    float tilesX = (float)_tilesX;
+    float tilesY = (float)_tilesY;
+    bounds->minX = (unsigned int)MATH_CLAMP(floorf((minU * 0.5f + 0.5f) * tilesX), 0.0f, tilesX - 1.0f);
+    bounds->maxX = (unsigned int)MATH_CLAMP(floorf((maxU * 0.5f + 0.5f) * tilesX), 0.0f, tilesX - 1.0f);
+    bounds->minY = (unsigned int)MATH_CLAMP(floorf((minV * 0.5f + 0.5f) * tilesY), 0.0f, tilesY - 1.0f);
+    bounds->maxY = (unsigned int)MATH_CLAMP(floorf((maxV * 0.5f + 0.5f) * tilesY), 0.0f, tilesY - 1.0f);
+    return true;
+}
+
+void LightClusters::update(Camera* camera)
+{
+    GP_PROFILE("LightClusters::update");
+
+    if (camera == NULL)
+        camera = _scene->getActiveCamera();
+    if (camera == NULL)
+        return;
+
+    _directionalLights.clear();
+    _localLights.clear();
+    _scene->visit(this, &LightClusters::gatherLight);
+
+    unsigned int directionalCount = std::min((unsigned int)_directionalLights.size(), _maxLights);
+    unsigned int localCount = std::min((unsigned int)_localLights.size(), _maxLights - directionalCount);
+    if (directionalCount + localCount < _directionalLights.size() + _localLights.size() && !_overflowWarned)
+    {
+        GP_WARN("Scene has more lights than the %u that its light clusters can hold.", _maxLights);
+        _overflowWarned = true;
+    }
+
+    // Map window coordinates to tiles and the log of the view depth to slices.
+    const Rectangle& viewport = Game::getInstance()->getViewport();
+    float tileScaleX = viewport.width > 0.0f ? _tilesX / viewport.width : 0.0f;
+    float tileScaleY = viewport.height > 0.0f ? _tilesY / viewport.height : 0.0f;
+    float nearPlane = std::max(camera->getNearPlane(), MATH_EPSILON);
+    float farPlane = std::max(camera->getFarPlane(), nearPlane + MATH_EPSILON);
+    float sliceScale = _slices / logf(farPlane / nearPlane);
+    _parameters[0].w = (float)directionalCount;
+    _parameters[1].set(tileScaleX, tileScaleY, -viewport.x * tileScaleX, -viewport.y * tileScaleY);
+    _parameters[2].x = sliceScale;
+    _parameters[2].y = -logf(nearPlane) * sliceScale;
+
+    // Pack the lights in view space.
+    const Matrix& view = camera->getViewMatrix();
+    for (unsigned int i = 0; i < directionalCount; ++i)
+    {
+        Light* light = _directionalLights[i];
+        Vector3 direction;
+        view.transformVector(light->getNode()->getForwardVectorWorld(), &direction);
+        const Vector3& color = light->getColor();
+        unsigned int texel = i * LIGHT_CLUSTER_LIGHT_TEXELS;
+        setTexel(texel, direction.x, direction.y, direction.z, 0.0f);
+        setTexel(texel + 1, color.x, color.y, color.z, 0.0f);
+        setTexel(texel + 2, 0.0f, 0.0f, 0.0f, 0.0f);
+    }
+
+    _bounds.resize(localCount);
+    std::vector<unsigned int> visibleLights;
+    visibleLights.reserve(localCount);
+    for (unsigned int i = 0; i < localCount; ++i)
+    {
+        Light* light = _localLights[i];
+        Node* node = light->getNode();
+        Vector3 position;
+        view.transformPoint(node->getTranslationWorld(), &position);
+        if (!computeBounds(position, light->getRange(), camera, &_bounds[visibleLights.size()]))
+            continue;
+
+        // Point lights get a cone that covers the whole sphere, so that the shaders need no branch.
+        Vector3 direction;
+        float innerAngleCos = -1.0f;
+        float outerAngleCos = -2.0f;
+        if (light->getLightType() == Light::SPOT)
+        {
+            view.transformVector(node->getForwardVectorWorld(), &direction);
+            direction.normalize();
+            innerAngleCos = light->getInnerAngleCos();
+            outerAngleCos = light->getOuterAngleCos();
+        }
+
+        const Vector3& color = light->getColor();
+        unsigned int texel = (directionalCount + (unsigned int)visibleLights.size()) * LIGHT_CLUSTER_LIGHT_TEXELS;
+        setTexel(texel, position.x, position.y, position.z, light->getRangeInverse());
+        setTexel(texel + 1, color.x, color.y, color.z, outerAngleCos);
+        setTexel(texel + 2, direction.x, direction.y, direction.z, innerAngleCos);
+        visibleLights.push_back(i);
+    }
+    unsigned int visibleCount = (unsigned int)visibleLights.size();
+    _lightCount = directionalCount + visibleCount;
+
+    // Count the lights of every cluster. Each batch of slices owns its clusters,
+    // so the batches never write to the same cluster.
+    unsigned int tilesX = _tilesX;
+    unsigned int sliceSize = _tilesX * _tilesY;
+    const std::vector<LightBounds>& bounds = _bounds;
+    std::vector<unsigned int>& counts = _clusterCounts;
+    std::vector<unsigned int>& firsts = _clusterFirsts;
+    JobController* jobController = Game::getInstance()->getJobController();
+    jobController->parallelFor(_slices, [&](unsigned int begin, unsigned int end, unsigned int worker)
+    {
+        std::fill(counts.begin() + begin * sliceSize, counts.begin() + end * sliceSize, 0);
+        for (unsigned int i = 0; i < visibleCount; ++i)
+        {
+            const LightBounds& b = bounds[i];
+            for (unsigned int z = std::max(b.minZ, begin), zEnd = std::min(b.maxZ + 1, end); z < zEnd; ++z)
+            {
+                for (unsigned int y = b.minY; y <= b.maxY; ++y)
+                {
+                    unsigned int* row = &counts[z * sliceSize + y * tilesX];
+                    for (unsigned int x = b.minX; x <= b.maxX; ++x)
+                        ++row[x];
+                }
+            }
+        }
+    });
+
+    // Lay out the light lists of the clusters, clamping them to the entries that fit in the texture.
+    unsigned int clusterCount = sliceSize * _slices;
+    unsigned int entryCount = 0;
+    for (unsigned int i = 0; i < clusterCount; ++i)
+    {
+        unsigned int count = std::min(counts[i], _maxEntries - entryCount);
+        if (count < counts[i] && !_overflowWarned)
+        {
+            GP_WARN("Light clusters ran out of light list entries; lights were dropped from some clusters.");
+            _overflowWarned = true;
+        }
+        counts[i] = count;
+        firsts[i] = entryCount;
+        setTexel(_clusterOffset + i, (float)entryCount, (float)count, 0.0f, 0.0f);
+        entryCount += count;
+    }
+
+    // Fill the light lists in light order.
+    float* entries = &_data[(size_t)_entryOffset * 4];
+    jobController->parallelFor(_slices, [&](unsigned int begin, unsigned int end, unsigned int worker)
+    {
+        for (unsigned int i = 0; i < visibleCount; ++i)
+        {
+            const LightBounds& b = bounds[i];
+            float index = (float)(directionalCount + i);
+            for (unsigned int z = std::max(b.minZ, begin), zEnd = std::min(b.maxZ + 1, end); z < zEnd; ++z)
+            {
+                for (unsigned int y = b.minY; y <= b.maxY; ++y)
+                {
+                    unsigned int first = z * sliceSize + y * tilesX;
+                    for (unsigned int x = b.minX; x <= b.maxX; ++x)
+                    {
+                        unsigned int cluster = first + x;
+                        if (counts[cluster] > 0)
+                        {
+                            entries[firsts[cluster]++] = index;
+                            --counts[cluster];
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    // Upload the rows that hold data. Rows past the last list entry still hold stale
+    // data from earlier frames, which the clusters no longer reference.
+    unsigned int texelCount = _entryOffset + (entryCount + 3) / 4;
+    _usedRows = (texelCount + LIGHT_CLUSTER_TEXTURE_WIDTH - 1) / LIGHT_CLUSTER_TEXTURE_WIDTH;
+    _sampler->getTexture()->setData(0, 0, LIGHT_CLUSTER_TEXTURE_WIDTH, _usedRows, (const unsigned char*)&_data[0]);
+}
+
+}
@@ -0,0 +1,198 @@
+#ifndef LIGHTCLUSTERS_H_
+#define LIGHTCLUSTERS_H_
+
+#include "Texture.h"
+#include "Vector4.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+class Camera;
+class Light;
+
+/**
+ * Defines a view-space grid of clusters that the lights of a scene are assigned to each frame.
+ *
+ * The view frustum of the camera is divided into tiles on screen and into slices along the
+ * view direction, with slices growing exponentially with depth. Every point and spot light
+ * is assigned to the clusters its range overlaps, and shaders compiled with the
+ * CLUSTERED_LIGHTING define look up the cluster of each fragment and only loop over the
+ * lights of that cluster. Since the light counts are no longer compiled into the shaders,
+ * a material needs a single effect for any number and combination of lights.
+ *
+ * The lights, the cluster table and the light lists of the clusters are packed into one
+ * RGBA32F texture that is bound with the LIGHT_CLUSTER_TEXTURE auto binding. The layout of
+ * the texture is described by the four Vector4 values of the LIGHT_CLUSTER_PARAMETERS
+ * auto binding:
+ *
+ * - [0] The number of tiles across and up, the number of slices and the number of directional lights.
+ * - [1] The scale and bias that map window coordinates to tiles.
+ * - [2] The scale and bias that map the log of the view depth to slices, and the first texels
+ *       of the cluster table and of the light lists.
+ * - [3] The width of the texture, its inverse and the inverse of its height.
+ *
+ * Each light takes three texels: directional lights come first and store their view-space
+ * direction and color, point and spot lights store their view-space position and inverse
+ * range, their color and outer cone angle cosine, and their view-space direction and inner
+ * cone angle cosine. Each texel of the cluster table stores the first entry and the number
+ * of entries of a cluster in the light lists, which store four light indices per texel.
+ *
+ * Float textures require OpenGL ES 3.0 or OES_texture_float on OpenGL ES 2.0, and shaders
+ * need highp fragment precision to address the texture.
+ *
+ * @see Scene::setLightClustersEnabled
+ * @script{ignore}
+ */
+class LightClusters
+{
+    friend class Scene;
+
+public:
+
+    /**
+     * Sets the number of tiles and slices of the grid.
+     *
+     * @param tilesX The number of tiles across the viewport.
+     * @param tilesY The number of tiles up the viewport.
+     * @param slices The number of slices between the near and far planes.
+     */
+    void setGridSize(unsigned int tilesX, unsigned int tilesY, unsigned int slices);
+
+    /**
+     * Sets the largest number of lights that are packed each frame.
+     *
+     * Lights beyond this number are ignored, in the order they are found in the scene.
+     *
+     * @param count The largest number of lights.
+     */
+    void setMaxLightCount(unsigned int count);
+
+    /**
+     * Returns the largest number of lights that are packed each frame.
+     *
+     * @return The largest number of lights.
+     */
+    unsigned int getMaxLightCount() const;
+
+    /**
+     * Returns the number of lights that were packed by the last update.
+     *
+     * @return The number of directional, point and spot lights.
+     */
+    unsigned int getLightCount() const;
+
+    /**
+     * Gathers the enabled lights of the scene and assigns them to the clusters of the given
+     * camera's view. This should be called once per frame, after the lights and the camera
+     * have moved and before the scene is drawn.
+     *
+     * The light lists of the clusters are built on the job workers, one batch of slices at a time.
+     *
+     * @param camera The camera to build the clusters for, or NULL to use the active camera of the scene.
+     */
+    void update(Camera* camera = NULL);
+
+    /**
+     * Returns the sampler of the texture that the lights and clusters are packed into.
+     *
+     * @return The sampler of the light cluster texture.
+     */
+    const Texture::Sampler* getSampler() const;
+
+    /**
+     * Returns the values that describe the layout of the grid and the texture.
+     *
+     * @return An array of four values.
+     */
+    const Vector4* getParameters() const;
+
+    /**
+     * Returns the number of values returned by getParameters.
+     *
+     * @return The number of values, which is 4.
+     */
+    unsigned int getParameterCount() const;
+
+private:
+
+    /**
+     * The clusters that a point or spot light overlaps.
+     */
+    struct LightBounds
+    {
+        unsigned int minX;
+        unsigned int maxX;
+        unsigned int minY;
+        unsigned int maxY;
+        unsigned int minZ;
+        unsigned int maxZ;
+    };
+
+    /**
+     * Constructor.
+     */
+    LightClusters(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~LightClusters();
+
+    /**
+     * Hidden copy constructor.
+     */
+    LightClusters(const LightClusters& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    LightClusters& operator=(const LightClusters&);
+
+    /**
+     * Recreates the texture and the buffers for the current grid size and light count.
+     */
+    void resize();
+
+    /**
+     * Adds the light of the given node, if any, to the gathered lights.
+     */
+    bool gatherLight(Node* node);
+
+    /**
+     * Computes the range of clusters that a sphere in view space overlaps.
+     *
+     * @return false if the sphere is outside of the view.
+     */
+    bool computeBounds(const Vector3& center, float radius, const Camera* camera, LightBounds* bounds) const;
+
+    /**
+     * Writes a texel of the light cluster data.
+     */
+    void setTexel(unsigned int index, float x, float y, float z, float w);
+
+    Scene* _scene;
+    unsigned int _tilesX;
+    unsigned int _tilesY;
+    unsigned int _slices;
+    unsigned int _maxLights;
+    unsigned int _maxEntries;
+    unsigned int _clusterOffset;
+    unsigned int _entryOffset;
+    unsigned int _lightCount;
+    unsigned int _usedRows;
+    Vector4 _parameters[4];
+    Texture::Sampler* _sampler;
+    std::vector<float> _data;
+    std::vector<Light*> _directionalLights;
+    std::vector<Light*> _localLights;
+    std::vector<LightBounds> _bounds;
+    std::vector<unsigned int> _clusterCounts;
+    std::vector<unsigned int> _clusterFirsts;
+    bool _overflowWarned;
+};
+
+}
+
+#endif
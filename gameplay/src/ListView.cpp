@@ -0,0 +1,248 @@
+#include "Base.h"
+#include "ListView.h"
+#include "ControlFactory.h"
+#include "Form.h"
+
+namespace gameplay
+{
+
+// The index of the item controls that are not bound to an item.
+static const unsigned int NO_ITEM = std::numeric_limits<unsigned int>::max();
+
+ListView::ListView()
+    : _itemSource(NULL), _itemTemplate(NULL), _itemCount(0), _itemHeight(0.0f), _itemsDirty(false)
+{
+    GP_REGISTER_SCRIPT_EVENTS();
+}
+
+ListView::~ListView()
+{
+    SAFE_DELETE(_itemTemplate);
+}
+
+ListView* ListView::create(const char* id, Theme::Style* style)
+{
+    ListView* list = new ListView();
+    list->_id = id ? id : "";
+    list->_layout = createLayout(Layout::LAYOUT_ABSOLUTE);
+    list->initialize("ListView", style, NULL);
+    return list;
+}
+
+Control* ListView::create(Theme::Style* style, Properties* properties)
+{
+    ListView* list = new ListView();
+    list->initialize("ListView", style, properties);
+    return list;
+}
+
+void ListView::initialize(const char* typeName, Theme::Style* style, Properties* properties)
+{
+    Container::initialize(typeName, style, properties);
+
+    // Items are placed by the list itself, which only scrolls vertically.
+    if (_layout->getType() != Layout::LAYOUT_ABSOLUTE)
+        setLayout(Layout::LAYOUT_ABSOLUTE);
+    setScroll(SCROLL_VERTICAL);
+
+    if (properties)
+    {
+        _itemHeight = std::max(properties->getFloat("itemHeight"), 0.0f);
+        _itemCount = (unsigned int)std::max(properties->getInt("itemCount"), 0);
+
+        // Keep the control of the item namespace, since the properties of the form do not outlive it.
+        Properties* itemNS = properties->getNamespace("item", true, false);
+        if (itemNS)
+        {
+            itemNS->rewind();
+            Properties* templateNS = itemNS->getNextNamespace();
+            if (templateNS)
+                _itemTemplate = templateNS->clone();
+            else
+                GP_WARN("The item namespace of list '%s' does not define a control.", _id.c_str());
+        }
+    }
+}
+
+const char* ListView::getTypeName() const
+{
+    return "ListView";
+}
+
+void ListView::setItemSource(ItemSource* source)
+{
+    if (source != _itemSource)
+    {
+        _itemSource = source;
+        refreshItems();
+    }
+}
+
+ListView::ItemSource* ListView::getItemSource() const
+{
+    return _itemSource;
+}
+
+void ListView::setItemCount(unsigned int count)
+{
+    if (count != _itemCount)
+    {
+        _itemCount = count;
+        refreshItems();
+    }
+}
+
+unsigned int ListView::getItemCount() const
+{
+    return _itemCount;
+}
+
+void ListView::setItemHeight(float height)
+{
+    height = std::max(height, 0.0f);
+    if (height != _itemHeight)
+    {
+        _itemHeight = height;
+        refreshItems();
+    }
+}
+
+float ListView::getItemHeight() const
+{
+    return _itemHeight;
+}
+
+Control* ListView::getItem(unsigned int index) const
+{
+    for (size_t i = 0, count = _items.size(); i < count; ++i)
+    {
+        if (_items[i].index == index)
+            return _items[i].control;
+    }
+    return NULL;
+}
+
+void ListView::refreshItems()
+{
+    _itemsDirty = true;
+    setDirty(DIRTY_ABSOLUTE_BOUNDS);
+}
+
+void ListView::scrollToItem(unsigned int index)
+{
+    setScrollPosition(Vector2(0, -_itemHeight * std::min(index, _itemCount)));
+}
+
+void ListView::updateAbsoluteBounds(const Vector2& offset)
+{
+    // Scrolling, which the container updates along with its absolute bounds, moves the viewport.
+    Container::updateAbsoluteBounds(offset);
+
+    updateItems();
+}
+
+void ListView::measureContents(float* width, float* height)
+{
+    Container::measureContents(width, height);
+
+    *height = _itemHeight * _itemCount;
+}
+
+void ListView::updateItems()
+{
+    // Find the items within the viewport.
+    unsigned int first = 0;
+    unsigned int last = 0;
+    if (_itemHeight > 0 && _itemCount > 0 && _viewportBounds.height > 0)
+    {
+        float top = -_scrollPosition.y;
+        first = (unsigned int)std::max(top / _itemHeight, 0.0f);
+        last = (unsigned int)std::min(ceilf((top + _viewportBounds.height) / _itemHeight), (float)_itemCount);
+        first = std::min(first, last);
+    }
+
+    // Free the controls of the items that scrolled out of the viewport, so that they can be
+    // recycled for the items that scrolled into it.
+    std::vector<bool> bound(last - first, false);
+    for (size_t i = 0, count = _items.size(); i < count; ++i)
+    {
+        Item& item = _items[i];
+        if (item.index == NO_ITEM)
+            continue;
+
+        if (item.index >= first && item.index < last)
+        {
+            bound[item.index - first] = true;
+            if (_itemsDirty)
+                bindItem(item);
+            continue;
+        }
+
+        Control* focus = Form::getFocusControl();
+        if (focus && (focus == item.control || focus->isChild(item.control)))
+            Form::clearFocus();
+        item.index = NO_ITEM;
+        item.control->setVisible(false);
+    }
+    _itemsDirty = false;
+
+    size_t free = 0;
+    for (unsigned int index = first; index < last; ++index)
+    {
+        if (bound[index - first])
+            continue;
+
+        while (free < _items.size() && _items[free].index != NO_ITEM)
+            ++free;
+        if (free == _items.size())
+        {
+            Control* control = createItem();
+            if (control == NULL)
+                break;
+
+            addControl(control);
+            control->release();
+
+            Item item;
+            item.control = control;
+            item.index = NO_ITEM;
+            _items.push_back(item);
+        }
+
+        Item& item = _items[free];
+        item.index = index;
+        item.control->setPosition(0, _itemHeight * index);
+        item.control->setWidth(1.0f, true);
+        item.control->setHeight(_itemHeight);
+        item.control->setVisible(true);
+        bindItem(item);
+    }
+}
+
+Control* ListView::createItem()
+{
+    Control* control = _itemSource ? _itemSource->createItem(this) : NULL;
+    if (control == NULL && _itemTemplate)
+    {
+        // Each control is created from its own copy of the template, since controls walk the
+        // namespaces of their properties.
+        Properties* properties = _itemTemplate->clone();
+        control = ControlFactory::getInstance()->createControl(properties->getNamespace(), _style, properties);
+        SAFE_DELETE(properties);
+    }
+    if (control == NULL)
+    {
+        GP_WARN("List '%s' has neither an item source nor an item template to create item controls with.", _id.c_str());
+    }
+    return control;
+}
+
+void ListView::bindItem(Item& item)
+{
+    if (_itemSource)
+        _itemSource->bindItem(this, item.control, item.index);
+
+    fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(ListView, bindItem), dynamic_cast<void*>(this), dynamic_cast<void*>(item.control), item.index);
+}
+
+}
@@ -0,0 +1,258 @@
+#ifndef LISTVIEW_H_
+#define LISTVIEW_H_
+
+#include "Container.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a vertically scrolling container that shows a long list of items of equal height
+ * with only the controls of the items that are within its viewport.
+ *
+ * The list holds a few item controls, which it binds to the items that scroll into view and
+ * recycles for other items as they scroll out of it, so that a list of thousands of items
+ * updates, lays out and hit-tests as many controls as a list of a few dozen. The content of an
+ * item is filled in whenever its control is bound to it, either by an ItemSource from C++ or
+ * by a "bindItem" script callback, which receives the list, the item control and the index of
+ * the item.
+ *
+ * Item controls are created by the item source, or else from the item template of the list,
+ * which is the single control defined within the "item" namespace of its properties:
+ *
+ * @code
+ * listView scores
+ * {
+ *     size = 400, 600
+ *     itemHeight = 48
+ *     itemCount = 5000
+ *
+ *     item
+ *     {
+ *         label entry
+ *         {
+ *             style = Label
+ *         }
+ *     }
+ * }
+ * @endcode
+ *
+ * Item controls are placed at the top of their item, across the width of the list.
+ *
+ * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-UI_Forms
+ */
+class ListView : public Container
+{
+    friend class ControlFactory;
+
+    GP_SCRIPT_EVENTS_START();
+    GP_SCRIPT_EVENT(bindItem, "<ListView><Control>u");
+    GP_SCRIPT_EVENTS_END();
+
+public:
+
+    /**
+     * Defines the source of the items of a list.
+     */
+    class ItemSource
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~ItemSource() { }
+
+        /**
+         * Creates a control to show items with, which the list then binds to the items that
+         * scroll into view.
+         *
+         * The default implementation returns NULL, so that the item template of the list is used.
+         *
+         * @param list The list that the control is for.
+         *
+         * @return The new control, or NULL to create it from the item template of the list.
+         */
+        virtual Control* createItem(ListView* list) { return NULL; }
+
+        /**
+         * Fills in the content of an item control for the item that it is now bound to.
+         *
+         * @param list The list that the item belongs to.
+         * @param item The item control.
+         * @param index The index of the item.
+         */
+        virtual void bindItem(ListView* list, Control* item, unsigned int index) = 0;
+    };
+
+    /**
+     * Creates a new list.
+     *
+     * @param id The list ID.
+     * @param style The list style (optional).
+     *
+     * @return The new list.
+     * @script{create}
+     */
+    static ListView* create(const char* id, Theme::Style* style = NULL);
+
+    /**
+     * Extends ScriptTarget::getTypeName() to return the type name of this class.
+     *
+     * @return The type name of this class: "ListView"
+     * @see ScriptTarget::getTypeName()
+     */
+    const char* getTypeName() const;
+
+    /**
+     * Sets the source that creates and fills in the item controls of the list.
+     *
+     * The source is not owned by the list and must outlive it, or be removed from it first.
+     *
+     * @param source The item source, or NULL to only use the item template and script callbacks.
+     * @script{ignore}
+     */
+    void setItemSource(ItemSource* source);
+
+    /**
+     * Returns the source of the items of the list.
+     *
+     * @return The item source, or NULL if there is none.
+     * @script{ignore}
+     */
+    ItemSource* getItemSource() const;
+
+    /**
+     * Sets the number of items in the list.
+     *
+     * @param count The number of items.
+     */
+    void setItemCount(unsigned int count);
+
+    /**
+     * Returns the number of items in the list.
+     *
+     * @return The number of items.
+     */
+    unsigned int getItemCount() const;
+
+    /**
+     * Sets the height of each item of the list.
+     *
+     * @param height The height of an item, in pixels.
+     */
+    void setItemHeight(float height);
+
+    /**
+     * Returns the height of each item of the list.
+     *
+     * @return The height of an item, in pixels.
+     */
+    float getItemHeight() const;
+
+    /**
+     * Returns the control that shows an item, if the item is within the viewport of the list.
+     *
+     * @param index The index of the item.
+     *
+     * @return The item control, or NULL if the item has no control.
+     */
+    Control* getItem(unsigned int index) const;
+
+    /**
+     * Binds the item controls of the list again, for when the content of its items changes.
+     */
+    void refreshItems();
+
+    /**
+     * Scrolls the list so that the given item is at the top of its viewport.
+     *
+     * @param index The index of the item.
+     */
+    void scrollToItem(unsigned int index);
+
+protected:
+
+    /**
+     * Constructor.
+     */
+    ListView();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ListView();
+
+    /**
+     * Creates a list with a given style and properties, including its item template.
+     *
+     * @param style The style to apply to this list.
+     * @param properties A properties object containing a definition of the list (optional).
+     *
+     * @return The new list.
+     */
+    static Control* create(Theme::Style* style, Properties* properties = NULL);
+
+    /**
+     * @see Control::initialize
+     */
+    void initialize(const char* typeName, Theme::Style* style, Properties* properties);
+
+    /**
+     * @see Control::updateAbsoluteBounds
+     */
+    void updateAbsoluteBounds(const Vector2& offset);
+
+    /**
+     * @see Container::measureContents
+     */
+    void measureContents(float* width, float* height);
+
+private:
+
+    /**
+     * An item control of the list, and the item that it is bound to.
+     */
+    struct Item
+    {
+        Control* control;
+        unsigned int index;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    ListView(const ListView& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ListView& operator=(const ListView&);
+
+    /**
+     * Binds the item controls to the items within the viewport, recycling those of the items
+     * that scrolled out of it.
+     */
+    void updateItems();
+
+    /**
+     * Creates a new item control, from the item source or from the item template.
+     */
+    Control* createItem();
+
+    /**
+     * Fills in the content of an item control for its item.
+     */
+    void bindItem(Item& item);
+
+    ItemSource* _itemSource;
+    Properties* _itemTemplate;
+    unsigned int _itemCount;
+    float _itemHeight;
+    std::vector<Item> _items;
+    bool _itemsDirty;
+};
+
+}
+
+#endif
@@ -1,14 +1,108 @@
-
 #include "Base.h"
 #include "Game.h"
 #include "ScriptController.h"
+#include "FileSystem.h"
+
+// The number of records in the ring buffer of the asynchronous logger, a power of two.
+#define LOGGER_RECORD_COUNT 1024
+
+// The number of bytes of a record that hold a message or the arguments of a deferred message.
+#define LOGGER_RECORD_DATA_SIZE 240
+
+// The number of queued records at which the background thread is woken up right away,
+// rather than with its next poll.
+#define LOGGER_WAKEUP_THRESHOLD (LOGGER_RECORD_COUNT / 2)
+
+// The interval at which the background thread polls for records.
+#define LOGGER_POLL_INTERVAL 10
+
+// The types of the entries of a binary log file.
+#define LOGGER_ENTRY_FORMAT 1
+#define LOGGER_ENTRY_DEFERRED 2
+#define LOGGER_ENTRY_TEXT 3
 
 namespace gameplay
 {
 
+/**
+ * A message queued in the ring buffer of the asynchronous logger.
+ */
+struct LoggerRecord
+{
+    std::atomic<size_t> sequence;
+    const char* format;
+    unsigned short size;
+    unsigned char level;
+    char data[LOGGER_RECORD_DATA_SIZE];
+};
+
+/**
+ * The bounded multi-producer ring buffer that the background thread of the asynchronous
+ * logger drains. Each record carries a sequence number that tells producers whether it is
+ * free and the consumer whether it has been written, so the threads that log never lock.
+ */
+struct LoggerBackend
+{
+    LoggerBackend() : enqueuePosition(0), dequeuePosition(0), thread(NULL), running(false), dropped(0), binaryOutput(NULL), nextFormatId(0)
+    {
+        for (size_t i = 0; i < LOGGER_RECORD_COUNT; ++i)
+        {
+            records[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    LoggerRecord records[LOGGER_RECORD_COUNT];
+    std::atomic<size_t> enqueuePosition;
+    std::atomic<size_t> dequeuePosition;
+    std::thread* thread;
+    std::atomic<bool> running;
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::condition_variable drained;
+    std::atomic<unsigned int> dropped;
+    std::mutex outputMutex;
+    Stream* binaryOutput;
+    std::unordered_map<const char*, unsigned int> formatIds;
+    unsigned int nextFormatId;
+};
+
+/**
+ * The length modifiers of a printf conversion.
+ */
+enum LoggerLength
+{
+    LOGGER_LENGTH_NONE,
+    LOGGER_LENGTH_HH,
+    LOGGER_LENGTH_H,
+    LOGGER_LENGTH_L,
+    LOGGER_LENGTH_LL,
+    LOGGER_LENGTH_J,
+    LOGGER_LENGTH_Z,
+    LOGGER_LENGTH_T,
+    LOGGER_LENGTH_LONG_DOUBLE
+};
+
+/**
+ * A printf conversion of a deferred message, parsed from its format.
+ */
+struct LoggerConversion
+{
+    const char* begin;
+    size_t flagsLength;
+    LoggerLength length;
+    char type;
+    unsigned int starCount;
+};
+
+static LoggerBackend __backend;
+static std::mutex __backendMutex;
+static thread_local bool __backendThread = false;
+static thread_local bool __lineOpen[3] = { false, false, false };
+static thread_local bool __lineSuppressed[3] = { false, false, false };
+
 Logger::State Logger::_state[3];
 
-Logger::State::State() : logFunctionC(NULL), logFunctionLua(NULL), enabled(true)
+Logger::State::State() : logFunctionC(NULL), logFunctionLua(NULL), enabled(true), rateLimit(0), rateWindow(0), rateCount(0), suppressedCount(0)
 {
 }
 
@@ -20,10 +114,459 @@ Logger::~Logger()
 {
 }
 
+/**
+ * Parses the conversion that follows a '%' of a format.
+ *
+ * @return The character after the conversion, or NULL if the conversion can't be deferred.
+ */
+static const char* parseConversion(const char* str, LoggerConversion* conversion)
+{
+    conversion->begin = str;
+    conversion->starCount = 0;
+    conversion->length = LOGGER_LENGTH_NONE;
+
+    while (*str == '-' || *str == '+' || *str == ' ' || *str == '#' || *str == '0')
+        ++str;
+    if (*str == '*')
+    {
+        ++conversion->starCount;
+        ++str;
+    }
+    while (*str >= '0' && *str <= '9')
+        ++str;
+    if (*str == '.')
+    {
+        ++str;
+        if (*str == '*')
+        {
+            ++conversion->starCount;
+            ++str;
+        }
+        while (*str >= '0' && *str <= '9')
+            ++str;
+    }
+    conversion->flagsLength = str - conversion->begin;
+
+    switch (*str)
+    {
+    case 'h':
+        conversion->length = str[1] == 'h' ? LOGGER_LENGTH_HH : LOGGER_LENGTH_H;
+        str += str[1] == 'h' ? 2 : 1;
+        break;
+    case 'l':
+        conversion->length = str[1] == 'l' ? LOGGER_LENGTH_LL : LOGGER_LENGTH_L;
+        str += str[1] == 'l' ? 2 : 1;
+        break;
+    case 'j':
+        conversion->length = LOGGER_LENGTH_J;
+        ++str;
+        break;
+    case 'z':
+        conversion->length = LOGGER_LENGTH_Z;
+        ++str;
+        break;
+    case 't':
+        conversion->length = LOGGER_LENGTH_T;
+        ++str;
+        break;
+    case 'L':
+        conversion->length = LOGGER_LENGTH_LONG_DOUBLE;
+        ++str;
+        break;
+    }
+
+    conversion->type = *str;
+    switch (conversion->type)
+    {
+    case 'd': case 'i': case 'u': case 'x': case 'X': case 'o':
+        if (conversion->length == LOGGER_LENGTH_LONG_DOUBLE)
+            return NULL;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        if (conversion->length != LOGGER_LENGTH_NONE && conversion->length != LOGGER_LENGTH_L && conversion->length != LOGGER_LENGTH_LONG_DOUBLE)
+            return NULL;
+        break;
+    case 'c': case 's': case 'p':
+        // Wide characters and strings are not deferred.
+        if (conversion->length != LOGGER_LENGTH_NONE)
+            return NULL;
+        break;
+    case '%':
+        if (conversion->flagsLength > 0 || conversion->length != LOGGER_LENGTH_NONE)
+            return NULL;
+        break;
+    default:
+        return NULL;
+    }
+
+    // The conversion is formatted with a specification built from it, which must fit.
+    if (conversion->flagsLength > 24)
+        return NULL;
+    return str + 1;
+}
+
+static bool appendArgument(char* data, size_t* size, const void* value, size_t length)
+{
+    if (*size + length > LOGGER_RECORD_DATA_SIZE)
+        return false;
+    memcpy(data + *size, value, length);
+    *size += length;
+    return true;
+}
+
+/**
+ * Copies the arguments of a deferred message into the data of a record. Integers,
+ * characters and pointers are stored as 64-bit values converted to the type of their
+ * conversion, floating-point numbers as doubles and strings with their terminator.
+ *
+ * @return true if the message can be deferred.
+ */
+static bool captureArguments(const char* format, va_list args, char* data, size_t* size)
+{
+    *size = 0;
+    LoggerConversion conversion;
+    for (const char* str = strchr(format, '%'); str; str = strchr(str, '%'))
+    {
+        str = parseConversion(str + 1, &conversion);
+        if (str == NULL)
+            return false;
+
+        for (unsigned int i = 0; i < conversion.starCount; ++i)
+        {
+            long long star = va_arg(args, int);
+            if (!appendArgument(data, size, &star, sizeof(star)))
+                return false;
+        }
+
+        switch (conversion.type)
+        {
+        case 'd': case 'i':
+        {
+            long long value;
+            switch (conversion.length)
+            {
+            case LOGGER_LENGTH_HH: value = (signed char)va_arg(args, int); break;
+            case LOGGER_LENGTH_H: value = (short)va_arg(args, int); break;
+            case LOGGER_LENGTH_L: value = va_arg(args, long); break;
+            case LOGGER_LENGTH_LL: value = va_arg(args, long long); break;
+            case LOGGER_LENGTH_J: value = (long long)va_arg(args, intmax_t); break;
+            case LOGGER_LENGTH_Z: value = (long long)(ptrdiff_t)va_arg(args, size_t); break;
+            case LOGGER_LENGTH_T: value = va_arg(args, ptrdiff_t); break;
+            default: value = va_arg(args, int); break;
+            }
+            if (!appendArgument(data, size, &value, sizeof(value)))
+                return false;
+            break;
+        }
+        case 'u': case 'x': case 'X': case 'o':
+        {
+            unsigned long long value;
+            switch (conversion.length)
+            {
+            case LOGGER_LENGTH_HH: value = (unsigned char)va_arg(args, unsigned int); break;
+            case LOGGER_LENGTH_H: value = (unsigned short)va_arg(args, unsigned int); break;
+            case LOGGER_LENGTH_L: value = va_arg(args, unsigned long); break;
+            case LOGGER_LENGTH_LL: value = va_arg(args, unsigned long long); break;
+            case LOGGER_LENGTH_J: value = (unsigned long long)va_arg(args, uintmax_t); break;
+            case LOGGER_LENGTH_Z: value = va_arg(args, size_t); break;
+            case LOGGER_LENGTH_T: value = (size_t)va_arg(args, ptrdiff_t); break;
+            default: value = va_arg(args, unsigned int); break;
+            }
+            if (!appendArgument(data, size, &value, sizeof(value)))
+                return false;
+            break;
+        }
+        case 'c':
+        {
+            long long value = va_arg(args, int);
+            if (!appendArgument(data, size, &value, sizeof(value)))
+                return false;
+            break;
+        }
+        case 'p':
+        {
+            unsigned long long value = (uintptr_t)va_arg(args, void*);
+            if (!appendArgument(data, size, &value, sizeof(value)))
+                return false;
+            break;
+        }
+        case 's':
+        {
+            const char* value = va_arg(args, const char*);
+            if (value == NULL)
+                value = "(null)";
+            if (!appendArgument(data, size, value, strlen(value) + 1))
+                return false;
+            break;
+        }
+        case '%':
+            break;
+        default:
+        {
+            double value = conversion.length == LOGGER_LENGTH_LONG_DOUBLE ? (double)va_arg(args, long double) : va_arg(args, double);
+            if (!appendArgument(data, size, &value, sizeof(value)))
+                return false;
+            break;
+        }
+        }
+    }
+    return true;
+}
+
+template <class T>
+static int formatConversion(char* buffer, size_t size, const char* specification, unsigned int starCount, const int* stars, T value)
+{
+    switch (starCount)
+    {
+    case 0:
+        return snprintf(buffer, size, specification, value);
+    case 1:
+        return snprintf(buffer, size, specification, stars[0], value);
+    default:
+        return snprintf(buffer, size, specification, stars[0], stars[1], value);
+    }
+}
+
+template <class T>
+static void appendConversion(std::string& str, const char* specification, unsigned int starCount, const int* stars, T value)
+{
+    char buffer[256];
+    int needed = formatConversion(buffer, sizeof(buffer), specification, starCount, stars, value);
+    if (needed < 0)
+        return;
+    if ((size_t)needed < sizeof(buffer))
+    {
+        str.append(buffer, needed);
+        return;
+    }
+    std::vector<char> dynamicBuffer(needed + 1);
+    formatConversion(&dynamicBuffer[0], dynamicBuffer.size(), specification, starCount, stars, value);
+    str.append(&dynamicBuffer[0], needed);
+}
+
+/**
+ * Formats a deferred message from the arguments captured by captureArguments.
+ */
+static void formatDeferred(const char* format, const char* data, std::string& str)
+{
+    LoggerConversion conversion;
+    const char* literal = format;
+    for (const char* s = strchr(format, '%'); s; s = strchr(s, '%'))
+    {
+        str.append(literal, s - literal);
+        s = parseConversion(s + 1, &conversion);
+        GP_ASSERT(s);
+        literal = s;
+
+        if (conversion.type == '%')
+        {
+            str.push_back('%');
+            continue;
+        }
+
+        int stars[2];
+        for (unsigned int i = 0; i < conversion.starCount; ++i)
+        {
+            long long star;
+            memcpy(&star, data, sizeof(star));
+            data += sizeof(star);
+            stars[i] = (int)star;
+        }
+
+        // Integers are formatted as 64-bit values, with the conversion of their type.
+        char specification[32];
+        specification[0] = '%';
+        memcpy(specification + 1, conversion.begin, conversion.flagsLength);
+        char* end = specification + 1 + conversion.flagsLength;
+
+        switch (conversion.type)
+        {
+        case 'd': case 'i':
+        {
+            long long value;
+            memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            end[0] = 'l'; end[1] = 'l'; end[2] = conversion.type; end[3] = '\0';
+            appendConversion(str, specification, conversion.starCount, stars, value);
+            break;
+        }
+        case 'u': case 'x': case 'X': case 'o':
+        {
+            unsigned long long value;
+            memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            end[0] = 'l'; end[1] = 'l'; end[2] = conversion.type; end[3] = '\0';
+            appendConversion(str, specification, conversion.starCount, stars, value);
+            break;
+        }
+        case 'c':
+        {
+            long long value;
+            memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            end[0] = 'c'; end[1] = '\0';
+            appendConversion(str, specification, conversion.starCount, stars, (int)value);
+            break;
+        }
+        case 'p':
+        {
+            unsigned long long value;
+            memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            end[0] = 'p'; end[1] = '\0';
+            appendConversion(str, specification, conversion.starCount, stars, (void*)(uintptr_t)value);
+            break;
+        }
+        case 's':
+        {
+            end[0] = 's'; end[1] = '\0';
+            appendConversion(str, specification, conversion.starCount, stars, data);
+            data += strlen(data) + 1;
+            break;
+        }
+        default:
+        {
+            double value;
+            memcpy(&value, data, sizeof(value));
+            data += sizeof(value);
+            end[0] = conversion.type; end[1] = '\0';
+            appendConversion(str, specification, conversion.starCount, stars, value);
+            break;
+        }
+        }
+    }
+    str.append(literal);
+}
+
+/**
+ * Claims a free record of the ring buffer.
+ *
+ * @return The record, which is queued by publishRecord, or NULL if the ring buffer is full.
+ */
+static LoggerRecord* claimRecord(size_t* position)
+{
+    size_t pos = __backend.enqueuePosition.load(std::memory_order_relaxed);
+    for ( ; ; )
+    {
+        LoggerRecord* record = &__backend.records[pos & (LOGGER_RECORD_COUNT - 1)];
+        size_t sequence = record->sequence.load(std::memory_order_acquire);
+        ptrdiff_t difference = (ptrdiff_t)sequence - (ptrdiff_t)pos;
+        if (difference == 0)
+        {
+            if (__backend.enqueuePosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                *position = pos;
+                return record;
+            }
+        }
+        else if (difference < 0)
+        {
+            __backend.dropped.fetch_add(1, std::memory_order_relaxed);
+            return NULL;
+        }
+        else
+        {
+            pos = __backend.enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+static void publishRecord(LoggerRecord* record, size_t position, bool urgent)
+{
+    record->sequence.store(position + 1, std::memory_order_release);
+
+    // The background thread polls for records, so it is only woken up when they pile up.
+    if (urgent || position - __backend.dequeuePosition.load(std::memory_order_relaxed) == LOGGER_WAKEUP_THRESHOLD)
+        __backend.wakeup.notify_one();
+}
+
+static void writeBinary(Stream* stream, unsigned char type, unsigned char level, const unsigned int* id, const void* data, size_t size)
+{
+    unsigned short length = (unsigned short)size;
+    stream->write(&type, 1, 1);
+    if (type != LOGGER_ENTRY_FORMAT)
+        stream->write(&level, 1, 1);
+    if (id)
+        stream->write(id, sizeof(unsigned int), 1);
+    stream->write(&length, sizeof(length), 1);
+    stream->write(data, 1, size);
+}
+
+/**
+ * Writes a record that was dequeued by the background thread.
+ */
+static void writeRecord(const LoggerRecord* record, std::string& str)
+{
+    Stream* stream = __backend.binaryOutput;
+    if (stream)
+    {
+        if (record->format == NULL)
+        {
+            writeBinary(stream, LOGGER_ENTRY_TEXT, record->level, NULL, record->data, record->size);
+            return;
+        }
+
+        // Each format is written once, the first time a message uses it.
+        std::unordered_map<const char*, unsigned int>::iterator itr = __backend.formatIds.find(record->format);
+        if (itr == __backend.formatIds.end())
+        {
+            itr = __backend.formatIds.insert(std::make_pair(record->format, __backend.nextFormatId++)).first;
+            writeBinary(stream, LOGGER_ENTRY_FORMAT, 0, &itr->second, record->format, strlen(record->format));
+        }
+        writeBinary(stream, LOGGER_ENTRY_DEFERRED, record->level, &itr->second, record->data, record->size);
+        return;
+    }
+
+    if (record->format == NULL)
+    {
+        gameplay::print("%s", record->data);
+        return;
+    }
+    str.clear();
+    formatDeferred(record->format, record->data, str);
+    gameplay::print("%s", str.c_str());
+}
+
+/**
+ * Drains the ring buffer until asynchronous logging is disabled.
+ */
+static void runBackend()
+{
+    __backendThread = true;
+
+    std::string str;
+    for ( ; ; )
+    {
+        {
+            std::lock_guard<std::mutex> outputLock(__backend.outputMutex);
+            for ( ; ; )
+            {
+                size_t pos = __backend.dequeuePosition.load(std::memory_order_relaxed);
+                LoggerRecord& record = __backend.records[pos & (LOGGER_RECORD_COUNT - 1)];
+                if (record.sequence.load(std::memory_order_acquire) != pos + 1)
+                    break;
+
+                writeRecord(&record, str);
+                record.sequence.store(pos + LOGGER_RECORD_COUNT, std::memory_order_release);
+                __backend.dequeuePosition.store(pos + 1, std::memory_order_release);
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(__backend.mutex);
+        __backend.drained.notify_all();
+        if (!__backend.running.load(std::memory_order_relaxed) &&
+            __backend.dequeuePosition.load(std::memory_order_relaxed) == __backend.enqueuePosition.load(std::memory_order_relaxed))
+        {
+            break;
+        }
+        __backend.wakeup.wait_for(lock, std::chrono::milliseconds(LOGGER_POLL_INTERVAL));
+    }
+}
+
 void Logger::log(Level level, const char* message, ...)
 {
     State& state = _state[level];
-    if (!state.enabled)
+    if (!state.enabled || isSuppressed(level, message))
         return;
 
     // Declare a moderately sized buffer on the stack that should be
@@ -57,21 +600,184 @@ void Logger::log(Level level, const char* message, ...)
         va_end(args);
     }
 
+    write(level, str);
+}
+
+void Logger::logDeferred(Level level, const char* message, ...)
+{
+    State& state = _state[level];
+    if (!state.enabled || isSuppressed(level, message))
+        return;
+
+    if (!state.logFunctionC && !state.logFunctionLua && !__backendThread && isAsynchronous() && strlen(message) <= 0xFFFF)
+    {
+        size_t position;
+        LoggerRecord* record = claimRecord(&position);
+        if (record == NULL)
+        {
+            // Errors are written even when the ring buffer is full.
+            if (level != LEVEL_ERROR)
+                return;
+        }
+        else
+        {
+            size_t size;
+            va_list args;
+            va_start(args, message);
+            bool captured = captureArguments(message, args, record->data, &size);
+            va_end(args);
+
+            if (captured)
+            {
+                record->format = message;
+                record->level = (unsigned char)level;
+                record->size = (unsigned short)size;
+                publishRecord(record, position, level == LEVEL_ERROR);
+                if (level == LEVEL_ERROR)
+                    flush();
+                return;
+            }
+
+            // The claimed record can't be given back, so it carries the message formatted instead.
+            va_start(args, message);
+            int needed = vsnprintf(record->data, LOGGER_RECORD_DATA_SIZE, message, args);
+            va_end(args);
+            if (needed < 0)
+                needed = 0;
+            if (needed < LOGGER_RECORD_DATA_SIZE)
+            {
+                record->format = NULL;
+                record->level = (unsigned char)level;
+                record->size = (unsigned short)needed;
+                publishRecord(record, position, level == LEVEL_ERROR);
+                if (level == LEVEL_ERROR)
+                    flush();
+                return;
+            }
+
+            // A message that doesn't fit into a record is written without the record once the
+            // messages queued before it have been written.
+            record->format = NULL;
+            record->level = (unsigned char)level;
+            record->size = 0;
+            record->data[0] = '\0';
+            publishRecord(record, position, true);
+        }
+    }
+
+    int size = 1024;
+    char stackBuffer[1024];
+    std::vector<char> dynamicBuffer;
+    char* str = stackBuffer;
+    for ( ; ; )
+    {
+        va_list args;
+        va_start(args, message);
+        int needed = vsnprintf(str, size-1, message, args);
+        va_end(args);
+        if (needed >= 0 && needed < size)
+        {
+            str[needed] = '\0';
+            break;
+        }
+        size = needed > 0 ? (needed + 1) : (size * 2);
+        dynamicBuffer.resize(size);
+        str = &dynamicBuffer[0];
+    }
+
+    write(level, str);
+}
+
+void Logger::write(Level level, const char* message)
+{
+    State& state = _state[level];
     if (state.logFunctionC)
     {
         // Pass call to registered C log function
-        (*state.logFunctionC)(level, str);
+        (*state.logFunctionC)(level, message);
+        return;
     }
-    else if (state.logFunctionLua)
+    if (state.logFunctionLua)
     {
         // Pass call to registered Lua log function
-        Game::getInstance()->getScriptController()->executeFunction<void>(state.logFunctionLua, "[Logger::Level]s", NULL, level, str);
+        Game::getInstance()->getScriptController()->executeFunction<void>(state.logFunctionLua, "[Logger::Level]s", NULL, level, message);
+        return;
+    }
+
+    if (!__backendThread && isAsynchronous())
+    {
+        size_t length = strlen(message);
+        if (length < LOGGER_RECORD_DATA_SIZE)
+        {
+            size_t position;
+            LoggerRecord* record = claimRecord(&position);
+            if (record)
+            {
+                memcpy(record->data, message, length + 1);
+                record->format = NULL;
+                record->level = (unsigned char)level;
+                record->size = (unsigned short)length;
+                publishRecord(record, position, level == LEVEL_ERROR);
+
+                // Errors usually end the program, so they are written before log returns.
+                if (level == LEVEL_ERROR)
+                    flush();
+                return;
+            }
+            if (level != LEVEL_ERROR)
+                return;
+        }
+
+        // Messages that don't fit into a record keep their place among the queued messages.
+        flush();
+        std::lock_guard<std::mutex> outputLock(__backend.outputMutex);
+        if (__backend.binaryOutput)
+        {
+            writeBinary(__backend.binaryOutput, LOGGER_ENTRY_TEXT, (unsigned char)level, NULL, message, std::min(length, (size_t)0xFFFF));
+            return;
+        }
+    }
+
+    // Log to the default output
+    gameplay::print("%s", message);
+}
+
+bool Logger::isSuppressed(Level level, const char* message)
+{
+    // A message that is logged in parts is kept or suppressed as a whole, where a part that
+    // ends with a new line ends the message.
+    size_t length = strlen(message);
+    bool open = __lineOpen[level];
+    __lineOpen[level] = length > 0 && message[length - 1] != '\n';
+    if (open)
+        return __lineSuppressed[level];
+
+    State& state = _state[level];
+    unsigned int limit = state.rateLimit.load(std::memory_order_relaxed);
+    if (limit == 0)
+    {
+        __lineSuppressed[level] = false;
+        return false;
     }
-    else
+
+    long long now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    long long window = state.rateWindow.load(std::memory_order_relaxed);
+    if (now != window && state.rateWindow.compare_exchange_strong(window, now))
     {
-        // Log to the default output
-        gameplay::print("%s", str);
+        state.rateCount.store(0, std::memory_order_relaxed);
+        unsigned int suppressed = state.suppressedCount.exchange(0, std::memory_order_relaxed);
+        if (suppressed > 0)
+        {
+            char notice[64];
+            snprintf(notice, sizeof(notice), "%u messages suppressed by the rate limit\n", suppressed);
+            write(level, notice);
+        }
     }
+
+    __lineSuppressed[level] = state.rateCount.fetch_add(1, std::memory_order_relaxed) >= limit;
+    if (__lineSuppressed[level])
+        state.suppressedCount.fetch_add(1, std::memory_order_relaxed);
+    return __lineSuppressed[level];
 }
 
 bool Logger::isEnabled(Level level)
@@ -98,4 +804,88 @@ void Logger::set(Level level, const char* logFunction)
     state.logFunctionC = NULL;
 }
 
+void Logger::setAsynchronous(bool asynchronous)
+{
+    std::lock_guard<std::mutex> backendLock(__backendMutex);
+    if (asynchronous == (__backend.thread != NULL))
+        return;
+
+    if (asynchronous)
+    {
+        __backend.running.store(true);
+        __backend.thread = new std::thread(runBackend);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(__backend.mutex);
+        __backend.running.store(false);
+    }
+    __backend.wakeup.notify_one();
+    __backend.thread->join();
+    SAFE_DELETE(__backend.thread);
+}
+
+bool Logger::isAsynchronous()
+{
+    return __backend.running.load(std::memory_order_relaxed);
+}
+
+void Logger::flush()
+{
+    if (__backendThread || !isAsynchronous())
+        return;
+
+    size_t position = __backend.enqueuePosition.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(__backend.mutex);
+    __backend.wakeup.notify_one();
+    while (__backend.running.load(std::memory_order_relaxed) && (ptrdiff_t)(position - __backend.dequeuePosition.load(std::memory_order_acquire)) > 0)
+    {
+        __backend.drained.wait_for(lock, std::chrono::milliseconds(LOGGER_POLL_INTERVAL));
+        __backend.wakeup.notify_one();
+    }
+}
+
+void Logger::setRateLimit(Level level, unsigned int messagesPerSecond)
+{
+    _state[level].rateLimit.store(messagesPerSecond, std::memory_order_relaxed);
+}
+
+unsigned int Logger::getRateLimit(Level level)
+{
+    return _state[level].rateLimit.load(std::memory_order_relaxed);
+}
+
+unsigned int Logger::getDroppedCount()
+{
+    return __backend.dropped.load(std::memory_order_relaxed);
+}
+
+bool Logger::setBinaryOutput(const char* path)
+{
+    Stream* stream = NULL;
+    if (path)
+    {
+        stream = FileSystem::open(path, FileSystem::WRITE);
+        if (stream == NULL)
+        {
+            GP_WARN("Failed to open binary log file '%s'.", path);
+            return false;
+        }
+    }
+
+    // The formats are written again at the start of the next file.
+    flush();
+    std::lock_guard<std::mutex> outputLock(__backend.outputMutex);
+    if (__backend.binaryOutput)
+    {
+        __backend.binaryOutput->close();
+        SAFE_DELETE(__backend.binaryOutput);
+    }
+    __backend.binaryOutput = stream;
+    __backend.formatIds.clear();
+    __backend.nextFormatId = 0;
+    return true;
+}
+
 }
@@ -13,6 +13,22 @@ namespace gameplay
  * can be modified for a specific log level by passing a custom C or Lua logging
  * function to the Logger::set method. Logging can also be toggled using the
  * setEnabled method.
+ *
+ * Logging can be made asynchronous with setAsynchronous, so that printing does not stall
+ * the threads that log, which matters on platforms where the default output blocks, such
+ * as logcat on Android. The messages are then formatted into the records of a lock-free
+ * ring buffer, which a background thread drains to the default output. A message that
+ * finds the ring buffer full is dropped rather than blocking the thread that logs it.
+ * Messages passed to a C or Lua logging function are still handled by the thread that
+ * logs them. Errors are always written out before log returns, since they usually end
+ * the program.
+ *
+ * Each level can be given a rate limit, above which the messages of a second are
+ * suppressed and counted instead of logged.
+ *
+ * Messages logged with logDeferred are not formatted by the thread that logs them. Their
+ * arguments are copied into the record and formatted by the background thread, or written
+ * to a binary log file without being formatted at all, if one is set with setBinaryOutput.
  */
 class Logger
 {
@@ -85,6 +101,103 @@ public:
      */
     static void set(Level level, const char* logFunction);
 
+    /**
+     * Logs a message whose formatting is deferred to the background thread that writes
+     * the messages of an asynchronous logger.
+     *
+     * The message must be a string with static storage duration, such as a string
+     * literal, since it is only read once the message is written. The arguments are copied
+     * when the message is logged, including the characters of strings. Messages whose
+     * arguments don't fit into a record, or that use conversions other than those for
+     * integers, floating-point numbers, characters, strings and pointers, are formatted
+     * right away instead. A logger that is not asynchronous formats every message right away.
+     *
+     * @param level Log level.
+     * @param message Log message, with the format specification of printf.
+     * @script{ignore}
+     */
+    static void logDeferred(Level level, const char* message, ...);
+
+    /**
+     * Sets whether messages are written by a background thread.
+     *
+     * Disabling asynchronous logging writes the queued messages and stops the thread.
+     *
+     * @param asynchronous true to write messages on a background thread, false to write
+     *      them on the thread that logs them.
+     * @script{ignore}
+     */
+    static void setAsynchronous(bool asynchronous);
+
+    /**
+     * Returns whether messages are written by a background thread.
+     *
+     * @return true if logging is asynchronous.
+     * @script{ignore}
+     */
+    static bool isAsynchronous();
+
+    /**
+     * Waits until every message that was queued before the call has been written.
+     * @script{ignore}
+     */
+    static void flush();
+
+    /**
+     * Sets the number of messages per second that are logged at the given level.
+     *
+     * The messages logged beyond the limit within a second are suppressed, and the number
+     * of suppressed messages is logged before the first message of a later second. A message that is
+     * logged in parts, like those of GP_WARN, counts once.
+     *
+     * @param level Log level.
+     * @param messagesPerSecond The number of messages per second, or 0 for no limit (the default).
+     * @script{ignore}
+     */
+    static void setRateLimit(Level level, unsigned int messagesPerSecond);
+
+    /**
+     * Returns the number of messages per second that are logged at the given level.
+     *
+     * @param level Log level.
+     *
+     * @return The rate limit, or 0 if there is no limit.
+     * @script{ignore}
+     */
+    static unsigned int getRateLimit(Level level);
+
+    /**
+     * Returns the number of messages that were dropped because the asynchronous ring
+     * buffer was full.
+     *
+     * @return The number of dropped messages.
+     * @script{ignore}
+     */
+    static unsigned int getDroppedCount();
+
+    /**
+     * Writes the messages of the asynchronous logger to a binary log file instead of
+     * the default output. Messages that are logged while the logger is not asynchronous,
+     * or that are passed to a C or Lua logging function, are not written to the file.
+     *
+     * The file is a sequence of entries that each start with a byte identifying their
+     * type. A format entry (1) is followed by a 32-bit id, a 16-bit length and the
+     * characters of a message passed to logDeferred, and is written the first time the
+     * message is logged. A deferred message entry (2) is followed by the level byte, the
+     * 32-bit id of its format, a 16-bit size and its arguments in the order of the
+     * conversions, without padding. Integers, characters, pointers and the arguments of
+     * '*' widths and precisions are stored as 64-bit values, floating-point numbers as
+     * doubles and strings with their terminator. A text entry (3) is followed by the level byte,
+     * a 16-bit length and the characters of a formatted message. Values are in the byte
+     * order of the device.
+     *
+     * @param path The path of the file to write, or NULL to write to the default output again.
+     *
+     * @return true if the file was opened.
+     * @script{ignore}
+     */
+    static bool setBinaryOutput(const char* path);
+
 private:
 
     struct State
@@ -93,6 +206,10 @@ private:
         void (*logFunctionC) (Level, const char*);
         const char* logFunctionLua;
         bool enabled;
+        std::atomic<unsigned int> rateLimit;
+        std::atomic<long long> rateWindow;
+        std::atomic<unsigned int> rateCount;
+        std::atomic<unsigned int> suppressedCount;
     };
 
     /**
@@ -115,6 +232,16 @@ private:
      */
     Logger& operator=(const Logger&);
 
+    /**
+     * Determines whether a part of a message is suppressed by the rate limit of its level.
+     */
+    static bool isSuppressed(Level level, const char* message);
+
+    /**
+     * Writes a formatted message to the handler of its level.
+     */
+    static void write(Level level, const char* message);
+
     static State _state[3];
 
 };
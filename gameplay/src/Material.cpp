@@ -6,17 +6,20 @@
 #include "Pass.h"
 #include "Properties.h"
 #include "Node.h"
+#include "StringPool.h"
 
 namespace gameplay
 {
 
 Material::Material() :
-    _currentTechnique(NULL)
+    _currentTechnique(NULL), _profilerName(NULL)
 {
 }
 
 Material::~Material()
 {
+    FileSystem::unwatch(this);
+
     // Destroy all the techniques.
     for (size_t i = 0, count = _techniques.size(); i < count; ++i)
     {
@@ -42,6 +45,8 @@ Material* Material::create(const char* url, PassCallback callback, void* cookie)
 
     Material* material = create((strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace(), callback, cookie);
     SAFE_DELETE(properties);
+    if (material)
+        material->setUrl(url);
 
     return material;
 }
@@ -171,6 +176,19 @@ Technique* Material::getTechnique() const
     return _currentTechnique;
 }
 
+Technique* Material::getReadyTechnique() const
+{
+    if (_currentTechnique == NULL || _currentTechnique->isReady())
+        return _currentTechnique;
+
+    for (size_t i = 0, count = _techniques.size(); i < count; ++i)
+    {
+        if (_techniques[i]->isReady())
+            return _techniques[i];
+    }
+    return NULL;
+}
+
 void Material::setTechnique(const char* id)
 {
     Technique* t = getTechnique(id);
@@ -190,10 +208,155 @@ void Material::setNodeBinding(Node* node)
     }
 }
 
+bool Material::reload()
+{
+    if (_url.empty())
+    {
+        GP_WARN("Material was not created from a material file and can't be reloaded.");
+        return false;
+    }
+
+    Properties* properties = Properties::create(_url.c_str());
+    if (properties == NULL)
+    {
+        GP_WARN("Failed to reload material from file: %s", _url.c_str());
+        return false;
+    }
+    Properties* materialProperties = (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
+    if (!materialProperties || strcmp(materialProperties->getNamespace(), "material") != 0)
+    {
+        GP_WARN("Failed to reload material from file: %s", _url.c_str());
+        SAFE_DELETE(properties);
+        return false;
+    }
+
+    loadRenderState(this, materialProperties);
+
+    Properties* techniqueProperties = NULL;
+    while ((techniqueProperties = materialProperties->getNextNamespace()))
+    {
+        if (strcmp(techniqueProperties->getNamespace(), "technique") != 0)
+            continue;
+
+        Technique* technique = getTechnique(techniqueProperties->getId());
+        if (technique == NULL)
+        {
+            GP_WARN("Technique '%s' was added to material '%s' and is not loaded until the material is created again.", techniqueProperties->getId(), _url.c_str());
+            continue;
+        }
+        loadRenderState(technique, techniqueProperties);
+
+        techniqueProperties->rewind();
+        Properties* passProperties = NULL;
+        while ((passProperties = techniqueProperties->getNextNamespace()))
+        {
+            if (strcmp(passProperties->getNamespace(), "pass") != 0)
+                continue;
+
+            Pass* pass = technique->getPass(passProperties->getId());
+            if (pass == NULL)
+            {
+                GP_WARN("Pass '%s' was added to material '%s' and is not loaded until the material is created again.", passProperties->getId(), _url.c_str());
+                continue;
+            }
+            loadRenderState(pass, passProperties);
+
+            // Switch to another effect if the shaders or the defines of the pass changed.
+            const char* vertexShaderPath = passProperties->getString("vertexShader");
+            const char* fragmentShaderPath = passProperties->getString("fragmentShader");
+            if (!vertexShaderPath || !fragmentShaderPath)
+            {
+                GP_WARN("Pass '%s' of material '%s' is missing its shaders.", passProperties->getId(), _url.c_str());
+                continue;
+            }
+            const char* passDefines = passProperties->getString("defines");
+            std::string allDefines = passDefines ? passDefines : "";
+            if (pass->_callbackDefines.length() > 0)
+            {
+                if (allDefines.length() > 0)
+                    allDefines += ';';
+                allDefines += pass->_callbackDefines;
+            }
+            std::string effectId = vertexShaderPath;
+            effectId += ';';
+            effectId += fragmentShaderPath;
+            effectId += ';';
+            effectId += allDefines;
+            if (pass->_effect && effectId == pass->_effect->getId())
+                continue;
+
+            Effect* effect = Effect::reloadFromFile(vertexShaderPath, fragmentShaderPath, allDefines.c_str());
+            if (effect == NULL)
+            {
+                GP_WARN("Failed to create effect for pass '%s' of material '%s'; the pass keeps its previous effect.", passProperties->getId(), _url.c_str());
+                continue;
+            }
+            pass->setEffect(effect);
+            SAFE_RELEASE(effect);
+        }
+    }
+    SAFE_DELETE(properties);
+
+    // The profiler name may have been taken from the effect of the first pass.
+    _profilerName = NULL;
+
+    return true;
+}
+
+void Material::setUrl(const char* url)
+{
+    GP_ASSERT(url);
+
+    FileSystem::unwatch(this);
+    _url = url;
+    _profilerName = NULL;
+
+    if (FileSystem::isWatchEnabled())
+    {
+        std::string path = _url.substr(0, _url.find('#'));
+        FileSystem::watch(path.c_str(), this);
+    }
+}
+
+void Material::fileChanged(const char* path)
+{
+    reload();
+}
+
+const char* Material::getProfilerName()
+{
+    if (_profilerName == NULL)
+    {
+        if (!_url.empty())
+        {
+            _profilerName = StringPool::intern(_url.c_str());
+        }
+        else
+        {
+            Pass* pass = _currentTechnique && _currentTechnique->getPassCount() > 0 ? _currentTechnique->getPassByIndex(0) : NULL;
+            if (pass && pass->_effect)
+            {
+                // The shader paths of the effect id, without its defines.
+                std::string id = pass->_effect->getId();
+                size_t fshStart = id.find(';');
+                size_t definesStart = fshStart != std::string::npos ? id.find(';', fshStart + 1) : std::string::npos;
+                _profilerName = StringPool::intern(id.substr(0, definesStart).c_str());
+            }
+            else
+            {
+                _profilerName = "Material";
+            }
+        }
+    }
+    return _profilerName;
+}
+
 Material* Material::clone(NodeCloneContext &context) const
 {
     Material* material = new Material();
     RenderState::cloneInto(material, context);
+    if (!_url.empty())
+        material->setUrl(_url.c_str());
 
     for (std::vector<Technique*>::const_iterator it = _techniques.begin(); it != _techniques.end(); ++it)
     {
@@ -271,6 +434,7 @@ bool Material::loadPass(Technique* technique, Properties* passProperties, PassCa
             if (allDefines.length() > 0)
                 allDefines += ';';
             allDefines += customDefines;
+            pass->_callbackDefines = customDefines;
         }
     }
 
@@ -4,6 +4,7 @@
 #include "RenderState.h"
 #include "Technique.h"
 #include "Properties.h"
+#include "FileSystem.h"
 
 namespace gameplay
 {
@@ -18,15 +19,19 @@ class NodeCloneContext;
  * material files (.material). When multiple techniques are loaded using a material file,
  * the current technique for an object can be set at runtime.
  *
+ * While FileSystem watches files, materials loaded from material files reload in place
+ * when their file changes.
+ *
  * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-Materials
  */
-class Material : public RenderState
+class Material : public RenderState, public FileSystem::WatchListener
 {
     friend class Technique;
     friend class Pass;
     friend class RenderState;
     friend class Node;
     friend class Model;
+    friend class SceneLoader;
 
 public:
 
@@ -136,6 +141,16 @@ public:
      */
     Technique* getTechnique() const;
 
+    /**
+     * Returns the technique that should be used to draw with this material.
+     *
+     * This is the current technique, unless one of its effects is still being compiled
+     * in the background, in which case the first technique that is ready is returned.
+     *
+     * @return The technique to draw with, or NULL if no technique is ready yet.
+     */
+    Technique* getReadyTechnique() const;
+
     /**
      * Sets the current material technique. 
      *
@@ -148,6 +163,21 @@ public:
      */
     void setNodeBinding(Node* node);
 
+    /**
+     * Loads this material again from the material file it was created from, in place.
+     *
+     * The parameters, render states and samplers in the file are set again, while the
+     * node binding, the current technique and the parameters set in code that the file
+     * doesn't set are kept. Passes whose shaders or defines changed switch to the effect
+     * for them, unless it fails to build. Techniques and passes are matched by their ids,
+     * and those that were added to the file are only loaded with a new material.
+     *
+     * @return true if the material was reloaded, false if it was not created from a
+     *      material file or the file could not be loaded.
+     * @script{ignore}
+     */
+    bool reload();
+
 private:
 
     /**
@@ -195,8 +225,28 @@ private:
      */
     static void loadRenderState(RenderState* renderState, Properties* properties);
 
+    /**
+     * Sets the URL that the material is reloaded from, and watches its file if FileSystem watches files.
+     */
+    void setUrl(const char* url);
+
+    /**
+     * Reloads the material when its file changes.
+     *
+     * @see FileSystem::WatchListener::fileChanged
+     */
+    void fileChanged(const char* path);
+
+    /**
+     * Returns the name that the draws of this material are profiled with, which is its URL,
+     * or else the shaders of its first pass.
+     */
+    const char* getProfilerName();
+
     Technique* _currentTechnique;
     std::vector<Technique*> _techniques;
+    std::string _url;
+    const char* _profilerName;
 };
 
 }
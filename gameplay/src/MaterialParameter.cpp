@@ -5,8 +5,14 @@
 namespace gameplay
 {
 
+// Interned parameter names, indexed by their id. Names are kept in a deque so that the
+// strings returned by getIdName stay valid while other threads intern new names.
+static std::unordered_map<std::string, unsigned int> __parameterIds;
+static std::deque<std::string> __parameterNames;
+static std::mutex __parameterMutex;
+
 MaterialParameter::MaterialParameter(const char* name) :
-_type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name ? name : ""), _uniform(NULL), _loggerDirtyBits(0)
+_type(MaterialParameter::NONE), _count(1), _dynamic(false), _name(name ? name : ""), _id(getId(_name.c_str())), _uniform(NULL), _loggerDirtyBits(0)
 {
     clearValue();
 }
@@ -80,6 +86,33 @@ const char* MaterialParameter::getName() const
     return _name.c_str();
 }
 
+unsigned int MaterialParameter::getId() const
+{
+    return _id;
+}
+
+unsigned int MaterialParameter::getId(const char* name)
+{
+    GP_ASSERT(name);
+
+    std::lock_guard<std::mutex> lock(__parameterMutex);
+    std::unordered_map<std::string, unsigned int>::const_iterator itr = __parameterIds.find(name);
+    if (itr != __parameterIds.end())
+        return itr->second;
+
+    unsigned int id = (unsigned int)__parameterNames.size();
+    __parameterNames.push_back(name);
+    __parameterIds[name] = id;
+    return id;
+}
+
+const char* MaterialParameter::getIdName(unsigned int id)
+{
+    std::lock_guard<std::mutex> lock(__parameterMutex);
+    GP_ASSERT(id < __parameterNames.size());
+    return __parameterNames[id].c_str();
+}
+
 Texture::Sampler* MaterialParameter::getSampler(unsigned int index) const
 {
     if (_type == MaterialParameter::SAMPLER)
@@ -454,7 +487,7 @@ void MaterialParameter::bind(Effect* effect)
     // we need to update our uniform to point to the new effect's uniform.
     if (!_uniform || _uniform->getEffect() != effect)
     {
-        _uniform = effect->getUniform(_name.c_str());
+        _uniform = effect->getUniform(_id, _name.c_str());
 
         if (!_uniform)
         {
@@ -468,6 +501,11 @@ void MaterialParameter::bind(Effect* effect)
         }
     }
 
+    // Uniforms that live in a uniform block have no location and are set through
+    // the block buffers by RenderState instead.
+    if (_uniform->_location < 0)
+        return;
+
     switch (_type)
     {
     case MaterialParameter::FLOAT:
@@ -8,6 +8,7 @@
 #include "Matrix.h"
 #include "Texture.h"
 #include "Effect.h"
+#include "ObjectPool.h"
 
 namespace gameplay
 {
@@ -40,6 +41,8 @@ class MaterialParameter : public AnimationTarget, public Ref
 
 public:
 
+    GP_POOLED_OBJECT(MaterialParameter);
+
     /**
      * Animates the uniform.
      */
@@ -50,6 +53,30 @@ public:
      */
     const char* getName() const;
 
+    /**
+     * Returns the id of the name of this material parameter.
+     *
+     * @return The parameter id.
+     * @see MaterialParameter::getId(const char*)
+     * @script{ignore}
+     */
+    unsigned int getId() const;
+
+    /**
+     * Returns the id of the given material parameter name.
+     *
+     * Parameter names are interned: every distinct name is assigned a small integer id
+     * the first time it is used, and the same name always returns the same id. Passing
+     * the id to RenderState::getParameterById instead of the name avoids any string
+     * comparisons, so code that sets parameters every frame should look ids up once.
+     *
+     * @param name The material parameter (uniform) name.
+     *
+     * @return The id of the name.
+     * @script{ignore}
+     */
+    static unsigned int getId(const char* name);
+
     /**
      * Returns the texture sampler or NULL if this MaterialParameter is not a sampler type.
      * 
@@ -436,6 +463,11 @@ private:
 
     void cloneInto(MaterialParameter* materialParameter) const;
 
+    /**
+     * Returns the name that was assigned the given id.
+     */
+    static const char* getIdName(unsigned int id);
+
     enum LOGGER_DIRTYBITS
     {
         UNIFORM_NOT_FOUND = 0x01,
@@ -479,6 +511,7 @@ private:
     unsigned int _count;
     bool _dynamic;
     std::string _name;
+    unsigned int _id;
     Uniform* _uniform;
     char _loggerDirtyBits;
 };
@@ -12,6 +12,9 @@ class MathUtil
 {
     friend class Matrix;
     friend class Vector3;
+    friend class BoundingBox;
+    friend class Frustum;
+    friend class Quaternion;
 
 public:
 
@@ -56,6 +59,12 @@ private:
 
     inline static void multiplyMatrix(const float* m1, const float* m2, float* dst);
 
+    /**
+     * Multiplies two affine matrices, whose last rows are (0, 0, 0, 1), which skips the
+     * products of the last rows and gives a product whose last row is (0, 0, 0, 1).
+     */
+    inline static void multiplyAffineMatrix(const float* m1, const float* m2, float* dst);
+
     inline static void negateMatrix(const float* m, float* dst);
 
     inline static void transposeMatrix(const float* m, float* dst);
@@ -66,6 +75,46 @@ private:
 
     inline static void crossVector3(const float* v1, const float* v2, float* dst);
 
+    /**
+     * Interpolates count pairs of unit quaternions with a normalized lerp whose coefficient is
+     * corrected towards that of a slerp, which keeps the angular error below a tenth of a degree.
+     *
+     * The quaternions are packed, the shorter arc is taken, and dst may be either source array.
+     */
+    inline static void slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count);
+
+    /**
+     * Transforms count three-component vectors, with the given w component, by a matrix.
+     *
+     * The vectors are read srcStride bytes apart and written dstStride bytes apart,
+     * and the source and destination may be the same array.
+     */
+    inline static void transformVectors(const float* m, const float* src, unsigned int srcStride, float w, float* dst, unsigned int dstStride, unsigned int count);
+
+    /**
+     * Transforms count bounding boxes, stored as their min and max points, by an affine matrix.
+     */
+    inline static void transformBoxes(const float* m, const float* src, unsigned int srcStride, float* dst, unsigned int dstStride, unsigned int count);
+
+    /**
+     * Culls count spheres, stored as their center and radius, against six planes, stored as
+     * their normal and distance, and sets bit i % 32 of visibility[i / 32] for each sphere i
+     * that is in front of or intersects every plane. The other bits are cleared.
+     *
+     * If planeCache is not NULL, it holds a byte per sphere with the index of the plane that
+     * last culled it, which is tested first, and is updated for the spheres that are culled.
+     *
+     * @return The number of visible spheres.
+     */
+    inline static unsigned int cullSpheres(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count);
+
+    /**
+     * Culls count boxes, stored as their min and max points, against six planes, like cullSpheres.
+     *
+     * @return The number of visible boxes.
+     */
+    inline static unsigned int cullBoxes(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count);
+
     MathUtil();
 };
 
@@ -73,8 +122,13 @@ private:
 
 #define MATRIX_SIZE ( sizeof(float) * 16)
 
-#ifdef GP_USE_NEON
+// The number of planes tested by MathUtil::cullSpheres and MathUtil::cullBoxes
+#define MATHUTIL_PLANE_COUNT 6
+
+#if defined(GP_USE_NEON)
 #include "MathUtilNeon.inl"
+#elif defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include "MathUtilSSE.inl"
 #else
 #include "MathUtil.inl"
 #endif
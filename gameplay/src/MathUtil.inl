@@ -109,6 +109,34 @@ inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* ds
     memcpy(dst, product, MATRIX_SIZE);
 }
 
+inline void MathUtil::multiplyAffineMatrix(const float* m1, const float* m2, float* dst)
+{
+    // Support the case where m1 or m2 is the same array as dst.
+    float product[16];
+
+    product[0]  = m1[0] * m2[0]  + m1[4] * m2[1]  + m1[8]  * m2[2];
+    product[1]  = m1[1] * m2[0]  + m1[5] * m2[1]  + m1[9]  * m2[2];
+    product[2]  = m1[2] * m2[0]  + m1[6] * m2[1]  + m1[10] * m2[2];
+    product[3]  = 0.0f;
+
+    product[4]  = m1[0] * m2[4]  + m1[4] * m2[5]  + m1[8]  * m2[6];
+    product[5]  = m1[1] * m2[4]  + m1[5] * m2[5]  + m1[9]  * m2[6];
+    product[6]  = m1[2] * m2[4]  + m1[6] * m2[5]  + m1[10] * m2[6];
+    product[7]  = 0.0f;
+
+    product[8]  = m1[0] * m2[8]  + m1[4] * m2[9]  + m1[8]  * m2[10];
+    product[9]  = m1[1] * m2[8]  + m1[5] * m2[9]  + m1[9]  * m2[10];
+    product[10] = m1[2] * m2[8]  + m1[6] * m2[9]  + m1[10] * m2[10];
+    product[11] = 0.0f;
+
+    product[12] = m1[0] * m2[12] + m1[4] * m2[13] + m1[8]  * m2[14] + m1[12];
+    product[13] = m1[1] * m2[12] + m1[5] * m2[13] + m1[9]  * m2[14] + m1[13];
+    product[14] = m1[2] * m2[12] + m1[6] * m2[13] + m1[10] * m2[14] + m1[14];
+    product[15] = 1.0f;
+
+    memcpy(dst, product, MATRIX_SIZE);
+}
+
 inline void MathUtil::negateMatrix(const float* m, float* dst)
 {
     dst[0]  = -m[0];
@@ -172,6 +200,178 @@ inline void MathUtil::crossVector3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtil::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+    // The coefficient of the lerp is corrected by a polynomial fitted to the slerp, in t and in
+    // the cosine of the angle between the quaternions.
+    float h = t - 0.5f;
+    float c = t * h * (t - 1.0f);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* a = q1 + i * 4;
+        const float* b = q2 + i * 4;
+        float* d = dst + i * 4;
+
+        float cosTheta = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        float f = fabsf(cosTheta);
+        float k = (1.0904f + f * (-3.2452f + f * (3.55645f - f * 1.43519f))) * h * h + (0.848013f + f * (-1.06021f + f * 0.215638f));
+        float t2 = t + c * k;
+        float t1 = 1.0f - t2;
+        if (cosTheta < 0.0f)
+            t2 = -t2;
+
+        // Handle case where q1 == dst or q2 == dst.
+        float x = t1 * a[0] + t2 * b[0];
+        float y = t1 * a[1] + t2 * b[1];
+        float z = t1 * a[2] + t2 * b[2];
+        float w = t1 * a[3] + t2 * b[3];
+        float n = 1.0f / sqrtf(x * x + y * y + z * z + w * w);
+
+        d[0] = x * n;
+        d[1] = y * n;
+        d[2] = z * n;
+        d[3] = w * n;
+    }
+}
+
+inline void MathUtil::transformVectors(const float* m, const float* src, unsigned int srcStride, float w, float* dst, unsigned int dstStride, unsigned int count)
+{
+    float tx = m[12] * w;
+    float ty = m[13] * w;
+    float tz = m[14] * w;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* v = (const float*)((const char*)src + (size_t)i * srcStride);
+        float* d = (float*)((char*)dst + (size_t)i * dstStride);
+
+        // Handle case where src == dst.
+        float x = v[0] * m[0] + v[1] * m[4] + v[2] * m[8] + tx;
+        float y = v[0] * m[1] + v[1] * m[5] + v[2] * m[9] + ty;
+        float z = v[0] * m[2] + v[1] * m[6] + v[2] * m[10] + tz;
+
+        d[0] = x;
+        d[1] = y;
+        d[2] = z;
+    }
+}
+
+inline void MathUtil::transformBoxes(const float* m, const float* src, unsigned int srcStride, float* dst, unsigned int dstStride, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* b = (const float*)((const char*)src + (size_t)i * srcStride);
+        float* d = (float*)((char*)dst + (size_t)i * dstStride);
+
+        // Transform the center of the box, and project its extents onto the transformed axes.
+        float cx = (b[0] + b[3]) * 0.5f;
+        float cy = (b[1] + b[4]) * 0.5f;
+        float cz = (b[2] + b[5]) * 0.5f;
+        float ex = (b[3] - b[0]) * 0.5f;
+        float ey = (b[4] - b[1]) * 0.5f;
+        float ez = (b[5] - b[2]) * 0.5f;
+
+        float x = cx * m[0] + cy * m[4] + cz * m[8] + m[12];
+        float y = cx * m[1] + cy * m[5] + cz * m[9] + m[13];
+        float z = cx * m[2] + cy * m[6] + cz * m[10] + m[14];
+        float extentX = ex * fabsf(m[0]) + ey * fabsf(m[4]) + ez * fabsf(m[8]);
+        float extentY = ex * fabsf(m[1]) + ey * fabsf(m[5]) + ez * fabsf(m[9]);
+        float extentZ = ex * fabsf(m[2]) + ey * fabsf(m[6]) + ez * fabsf(m[10]);
+
+        d[0] = x - extentX;
+        d[1] = y - extentY;
+        d[2] = z - extentZ;
+        d[3] = x + extentX;
+        d[4] = y + extentY;
+        d[5] = z + extentZ;
+    }
 }
 
+/**
+ * Returns the index of the first of the planes that the sphere is behind, testing the plane
+ * with the given index first, or MATHUTIL_PLANE_COUNT if the sphere is not behind any plane.
+ */
+inline unsigned int mathUtilCullSphere(const float* planes, const float* s, unsigned int first)
+{
+    if (first >= MATHUTIL_PLANE_COUNT)
+        first = 0;
+    for (unsigned int i = 0; i < MATHUTIL_PLANE_COUNT; ++i)
+    {
+        // Test the first plane, followed by the others in order.
+        unsigned int j = i == 0 ? first : (i <= first ? i - 1 : i);
+        const float* p = planes + j * 4;
+        if (p[0] * s[0] + p[1] * s[1] + p[2] * s[2] + p[3] < -s[3])
+            return j;
+    }
+    return MATHUTIL_PLANE_COUNT;
+}
 
+/**
+ * Returns the index of the first of the planes that the box, stored as its min and max points,
+ * is behind, like mathUtilCullSphere.
+ */
+inline unsigned int mathUtilCullBox(const float* planes, const float* b, unsigned int first)
+{
+    float cx = (b[0] + b[3]) * 0.5f;
+    float cy = (b[1] + b[4]) * 0.5f;
+    float cz = (b[2] + b[5]) * 0.5f;
+    float ex = (b[3] - b[0]) * 0.5f;
+    float ey = (b[4] - b[1]) * 0.5f;
+    float ez = (b[5] - b[2]) * 0.5f;
+    if (first >= MATHUTIL_PLANE_COUNT)
+        first = 0;
+    for (unsigned int i = 0; i < MATHUTIL_PLANE_COUNT; ++i)
+    {
+        unsigned int j = i == 0 ? first : (i <= first ? i - 1 : i);
+        const float* p = planes + j * 4;
+        float distance = p[0] * cx + p[1] * cy + p[2] * cz + p[3];
+        if (distance < -(fabsf(ex * p[0]) + fabsf(ey * p[1]) + fabsf(ez * p[2])))
+            return j;
+    }
+    return MATHUTIL_PLANE_COUNT;
+}
+
+inline unsigned int MathUtil::cullSpheres(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count)
+{
+    memset(visibility, 0, ((count + 31) / 32) * sizeof(unsigned int));
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* s = (const float*)((const char*)src + (size_t)i * srcStride);
+        unsigned int plane = mathUtilCullSphere(planes, s, planeCache ? planeCache[i] : 0);
+        if (plane < MATHUTIL_PLANE_COUNT)
+        {
+            if (planeCache)
+                planeCache[i] = (unsigned char)plane;
+        }
+        else
+        {
+            visibility[i >> 5] |= 1u << (i & 31);
+            ++visible;
+        }
+    }
+    return visible;
+}
+
+inline unsigned int MathUtil::cullBoxes(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count)
+{
+    memset(visibility, 0, ((count + 31) / 32) * sizeof(unsigned int));
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* b = (const float*)((const char*)src + (size_t)i * srcStride);
+        unsigned int plane = mathUtilCullBox(planes, b, planeCache ? planeCache[i] : 0);
+        if (plane < MATHUTIL_PLANE_COUNT)
+        {
+            if (planeCache)
+                planeCache[i] = (unsigned char)plane;
+        }
+        else
+        {
+            visibility[i >> 5] |= 1u << (i & 31);
+            ++visible;
+        }
+    }
+    return visible;
+}
+
+}
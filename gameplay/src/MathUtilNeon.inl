@@ -1,11 +1,21 @@
+#include <arm_neon.h>
+
+// Matrices and Vector4s are 16-byte aligned when built with GP_USE_ALIGNED_MATH, so their
+// loads and stores are given an alignment qualifier.
+#if defined(GP_USE_ALIGNED_MATH)
+#define MATHUTIL_ALIGN128 ":128"
+#else
+#define MATHUTIL_ALIGN128 ""
+#endif
+
 namespace gameplay
 {
 
 inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
 {
     asm volatile(
-        "vld1.32 {q0, q1}, [%1]!    \n\t" // M[m0-m7]
-        "vld1.32 {q2, q3}, [%1]     \n\t" // M[m8-m15]
+        "vld1.32 {q0, q1}, [%1" MATHUTIL_ALIGN128 "]!    \n\t" // M[m0-m7]
+        "vld1.32 {q2, q3}, [%1" MATHUTIL_ALIGN128 "]     \n\t" // M[m8-m15]
         "vld1.32 {d8[0]},  [%2]     \n\t" // s
         "vmov.f32 s17, s16          \n\t" // s
         "vmov.f32 s18, s16          \n\t" // s
@@ -16,8 +26,8 @@ inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
         "vadd.f32 q10, q2, q4       \n\t" // DST->M[m8-m11] = M[m8-m11] + s
         "vadd.f32 q11, q3, q4       \n\t" // DST->M[m12-m15] = M[m12-m15] + s
 
-        "vst1.32 {q8, q9}, [%0]!    \n\t" // DST->M[m0-m7]
-        "vst1.32 {q10, q11}, [%0]   \n\t" // DST->M[m8-m15]
+        "vst1.32 {q8, q9}, [%0" MATHUTIL_ALIGN128 "]!    \n\t" // DST->M[m0-m7]
+        "vst1.32 {q10, q11}, [%0" MATHUTIL_ALIGN128 "]   \n\t" // DST->M[m8-m15]
         :
         : "r"(dst), "r"(m), "r"(&scalar)
         : "q0", "q1", "q2", "q3", "q4", "q8", "q9", "q10", "q11", "memory"
@@ -27,18 +37,18 @@ inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
 inline void MathUtil::addMatrix(const float* m1, const float* m2, float* dst)
 {
     asm volatile(
-        "vld1.32     {q0, q1},     [%1]! \n\t" // M1[m0-m7]
-        "vld1.32     {q2, q3},     [%1]  \n\t" // M1[m8-m15]
-        "vld1.32     {q8, q9},     [%2]! \n\t" // M2[m0-m7]
-        "vld1.32     {q10, q11}, [%2]    \n\t" // M2[m8-m15]
+        "vld1.32     {q0, q1},     [%1" MATHUTIL_ALIGN128 "]! \n\t" // M1[m0-m7]
+        "vld1.32     {q2, q3},     [%1" MATHUTIL_ALIGN128 "]  \n\t" // M1[m8-m15]
+        "vld1.32     {q8, q9},     [%2" MATHUTIL_ALIGN128 "]! \n\t" // M2[m0-m7]
+        "vld1.32     {q10, q11}, [%2" MATHUTIL_ALIGN128 "]    \n\t" // M2[m8-m15]
 
         "vadd.f32   q12, q0, q8          \n\t" // DST->M[m0-m3] = M1[m0-m3] + M2[m0-m3]
         "vadd.f32   q13, q1, q9          \n\t" // DST->M[m4-m7] = M1[m4-m7] + M2[m4-m7]
         "vadd.f32   q14, q2, q10         \n\t" // DST->M[m8-m11] = M1[m8-m11] + M2[m8-m11]
         "vadd.f32   q15, q3, q11         \n\t" // DST->M[m12-m15] = M1[m12-m15] + M2[m12-m15]
 
-        "vst1.32    {q12, q13}, [%0]!    \n\t" // DST->M[m0-m7]
-        "vst1.32    {q14, q15}, [%0]     \n\t" // DST->M[m8-m15]
+        "vst1.32    {q12, q13}, [%0" MATHUTIL_ALIGN128 "]!    \n\t" // DST->M[m0-m7]
+        "vst1.32    {q14, q15}, [%0" MATHUTIL_ALIGN128 "]     \n\t" // DST->M[m8-m15]
         :
         : "r"(dst), "r"(m1), "r"(m2)
         : "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15", "memory"
@@ -48,18 +58,18 @@ inline void MathUtil::addMatrix(const float* m1, const float* m2, float* dst)
 inline void MathUtil::subtractMatrix(const float* m1, const float* m2, float* dst)
 {
     asm volatile(
-        "vld1.32     {q0, q1},     [%1]!  \n\t" // M1[m0-m7]
-        "vld1.32     {q2, q3},     [%1]   \n\t" // M1[m8-m15]
-        "vld1.32     {q8, q9},     [%2]!  \n\t" // M2[m0-m7]
-        "vld1.32     {q10, q11}, [%2]     \n\t" // M2[m8-m15]
+        "vld1.32     {q0, q1},     [%1" MATHUTIL_ALIGN128 "]!  \n\t" // M1[m0-m7]
+        "vld1.32     {q2, q3},     [%1" MATHUTIL_ALIGN128 "]   \n\t" // M1[m8-m15]
+        "vld1.32     {q8, q9},     [%2" MATHUTIL_ALIGN128 "]!  \n\t" // M2[m0-m7]
+        "vld1.32     {q10, q11}, [%2" MATHUTIL_ALIGN128 "]     \n\t" // M2[m8-m15]
 
         "vsub.f32   q12, q0, q8         \n\t" // DST->M[m0-m3] = M1[m0-m3] - M2[m0-m3]
         "vsub.f32   q13, q1, q9         \n\t" // DST->M[m4-m7] = M1[m4-m7] - M2[m4-m7]
         "vsub.f32   q14, q2, q10        \n\t" // DST->M[m8-m11] = M1[m8-m11] - M2[m8-m11]
         "vsub.f32   q15, q3, q11        \n\t" // DST->M[m12-m15] = M1[m12-m15] - M2[m12-m15]
 
-        "vst1.32    {q12, q13}, [%0]!   \n\t" // DST->M[m0-m7]
-        "vst1.32    {q14, q15}, [%0]    \n\t" // DST->M[m8-m15]
+        "vst1.32    {q12, q13}, [%0" MATHUTIL_ALIGN128 "]!   \n\t" // DST->M[m0-m7]
+        "vst1.32    {q14, q15}, [%0" MATHUTIL_ALIGN128 "]    \n\t" // DST->M[m8-m15]
         :
         : "r"(dst), "r"(m1), "r"(m2)
         : "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15", "memory"
@@ -70,16 +80,16 @@ inline void MathUtil::multiplyMatrix(const float* m, float scalar, float* dst)
 {
     asm volatile(
         "vld1.32     {d0[0]},         [%2]        \n\t" // M[m0-m7]
-        "vld1.32    {q4-q5},          [%1]!       \n\t" // M[m8-m15]
-        "vld1.32    {q6-q7},          [%1]        \n\t" // s
+        "vld1.32    {q4-q5},          [%1" MATHUTIL_ALIGN128 "]!       \n\t" // M[m8-m15]
+        "vld1.32    {q6-q7},          [%1" MATHUTIL_ALIGN128 "]        \n\t" // s
 
         "vmul.f32     q8, q4, d0[0]               \n\t" // DST->M[m0-m3] = M[m0-m3] * s
         "vmul.f32     q9, q5, d0[0]               \n\t" // DST->M[m4-m7] = M[m4-m7] * s
         "vmul.f32     q10, q6, d0[0]              \n\t" // DST->M[m8-m11] = M[m8-m11] * s
         "vmul.f32     q11, q7, d0[0]              \n\t" // DST->M[m12-m15] = M[m12-m15] * s
 
-        "vst1.32     {q8-q9},           [%0]!     \n\t" // DST->M[m0-m7]
-        "vst1.32     {q10-q11},         [%0]      \n\t" // DST->M[m8-m15]
+        "vst1.32     {q8-q9},           [%0" MATHUTIL_ALIGN128 "]!     \n\t" // DST->M[m0-m7]
+        "vst1.32     {q10-q11},         [%0" MATHUTIL_ALIGN128 "]      \n\t" // DST->M[m8-m15]
         :
         : "r"(dst), "r"(m), "r"(&scalar)
         : "q0", "q4", "q5", "q6", "q7", "q8", "q9", "q10", "q11", "memory"
@@ -89,10 +99,10 @@ inline void MathUtil::multiplyMatrix(const float* m, float scalar, float* dst)
 inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
 {
     asm volatile(
-        "vld1.32     {d16 - d19}, [%1]! \n\t"       // M1[m0-m7]
-        "vld1.32     {d20 - d23}, [%1]  \n\t"       // M1[m8-m15]
-        "vld1.32     {d0 - d3}, [%2]!   \n\t"       // M2[m0-m7]
-        "vld1.32     {d4 - d7}, [%2]    \n\t"       // M2[m8-m15]
+        "vld1.32     {d16 - d19}, [%1" MATHUTIL_ALIGN128 "]! \n\t"       // M1[m0-m7]
+        "vld1.32     {d20 - d23}, [%1" MATHUTIL_ALIGN128 "]  \n\t"       // M1[m8-m15]
+        "vld1.32     {d0 - d3}, [%2" MATHUTIL_ALIGN128 "]!   \n\t"       // M2[m0-m7]
+        "vld1.32     {d4 - d7}, [%2" MATHUTIL_ALIGN128 "]    \n\t"       // M2[m8-m15]
 
         "vmul.f32    q12, q8, d0[0]     \n\t"         // DST->M[m0-m3] = M1[m0-m3] * M2[m0]
         "vmul.f32    q13, q8, d2[0]     \n\t"         // DST->M[m4-m7] = M1[m4-m7] * M2[m4]
@@ -114,8 +124,42 @@ inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* ds
         "vmla.f32    q14, q11, d5[1]    \n\t"         // DST->M[m8-m11] += M1[m8-m11] * M2[m11]
         "vmla.f32    q15, q11, d7[1]    \n\t"         // DST->M[m12-m15] += M1[m12-m15] * M2[m15]
 
-        "vst1.32    {d24 - d27}, [%0]!  \n\t"       // DST->M[m0-m7]
-        "vst1.32    {d28 - d31}, [%0]   \n\t"       // DST->M[m8-m15]
+        "vst1.32    {d24 - d27}, [%0" MATHUTIL_ALIGN128 "]!  \n\t"       // DST->M[m0-m7]
+        "vst1.32    {d28 - d31}, [%0" MATHUTIL_ALIGN128 "]   \n\t"       // DST->M[m8-m15]
+
+        : // output
+        : "r"(dst), "r"(m1), "r"(m2) // input - note *value* of pointer doesn't change.
+        : "memory", "q0", "q1", "q2", "q3", "q8", "q9", "q10", "q11", "q12", "q13", "q14", "q15"
+    );
+}
+
+inline void MathUtil::multiplyAffineMatrix(const float* m1, const float* m2, float* dst)
+{
+    asm volatile(
+        "vld1.32     {d16 - d19}, [%1" MATHUTIL_ALIGN128 "]! \n\t"       // M1[m0-m7]
+        "vld1.32     {d20 - d23}, [%1" MATHUTIL_ALIGN128 "]  \n\t"       // M1[m8-m15]
+        "vld1.32     {d0 - d3}, [%2" MATHUTIL_ALIGN128 "]!   \n\t"       // M2[m0-m7]
+        "vld1.32     {d4 - d7}, [%2" MATHUTIL_ALIGN128 "]    \n\t"       // M2[m8-m15]
+
+        "vmul.f32    q12, q8, d0[0]     \n\t"         // DST->M[m0-m3] = M1[m0-m3] * M2[m0]
+        "vmul.f32    q13, q8, d2[0]     \n\t"         // DST->M[m4-m7] = M1[m4-m7] * M2[m4]
+        "vmul.f32    q14, q8, d4[0]     \n\t"         // DST->M[m8-m11] = M1[m8-m11] * M2[m8]
+        "vmul.f32    q15, q8, d6[0]     \n\t"         // DST->M[m12-m15] = M1[m12-m15] * M2[m12]
+
+        "vmla.f32    q12, q9, d0[1]     \n\t"         // DST->M[m0-m3] += M1[m0-m3] * M2[m1]
+        "vmla.f32    q13, q9, d2[1]     \n\t"         // DST->M[m4-m7] += M1[m4-m7] * M2[m5]
+        "vmla.f32    q14, q9, d4[1]     \n\t"         // DST->M[m8-m11] += M1[m8-m11] * M2[m9]
+        "vmla.f32    q15, q9, d6[1]     \n\t"         // DST->M[m12-m15] += M1[m12-m15] * M2[m13]
+
+        "vmla.f32    q12, q10, d1[0]    \n\t"         // DST->M[m0-m3] += M1[m0-m3] * M2[m2]
+        "vmla.f32    q13, q10, d3[0]    \n\t"         // DST->M[m4-m7] += M1[m4-m7] * M2[m6]
+        "vmla.f32    q14, q10, d5[0]    \n\t"         // DST->M[m8-m11] += M1[m8-m11] * M2[m10]
+        "vmla.f32    q15, q10, d7[0]    \n\t"         // DST->M[m12-m15] += M1[m12-m15] * M2[m14]
+
+        "vadd.f32    q15, q15, q11      \n\t"         // DST->M[m12-m15] += M1[m12-m15], as M2[m15] is 1
+
+        "vst1.32    {d24 - d27}, [%0" MATHUTIL_ALIGN128 "]!  \n\t"       // DST->M[m0-m7]
+        "vst1.32    {d28 - d31}, [%0" MATHUTIL_ALIGN128 "]   \n\t"       // DST->M[m8-m15]
 
         : // output
         : "r"(dst), "r"(m1), "r"(m2) // input - note *value* of pointer doesn't change.
@@ -126,16 +170,16 @@ inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* ds
 inline void MathUtil::negateMatrix(const float* m, float* dst)
 {
     asm volatile(
-        "vld1.32     {q0-q1},  [%1]!     \n\t" // load m0-m7
-        "vld1.32     {q2-q3},  [%1]      \n\t" // load m8-m15
+        "vld1.32     {q0-q1},  [%1" MATHUTIL_ALIGN128 "]!     \n\t" // load m0-m7
+        "vld1.32     {q2-q3},  [%1" MATHUTIL_ALIGN128 "]      \n\t" // load m8-m15
 
         "vneg.f32     q4, q0             \n\t" // negate m0-m3
         "vneg.f32     q5, q1             \n\t" // negate m4-m7
         "vneg.f32     q6, q2             \n\t" // negate m8-m15
         "vneg.f32     q7, q3             \n\t" // negate m8-m15
 
-        "vst1.32     {q4-q5},  [%0]!     \n\t" // store m0-m7
-        "vst1.32     {q6-q7},  [%0]      \n\t" // store m8-m15
+        "vst1.32     {q4-q5},  [%0" MATHUTIL_ALIGN128 "]!     \n\t" // store m0-m7
+        "vst1.32     {q6-q7},  [%0" MATHUTIL_ALIGN128 "]      \n\t" // store m8-m15
         :
         : "r"(dst), "r"(m)
         : "q0", "q1", "q2", "q3", "q4", "q5", "q6", "q7", "memory"
@@ -150,8 +194,8 @@ inline void MathUtil::transposeMatrix(const float* m, float* dst)
         "vld4.32 {d1[0], d3[0], d5[0], d7[0]}, [%1]!    \n\t" // DST->M[m2, m6, m10, m12] = M[m8-m11]
         "vld4.32 {d1[1], d3[1], d5[1], d7[1]}, [%1]     \n\t" // DST->M[m3, m7, m11, m12] = M[m12-m15]
 
-        "vst1.32 {q0-q1}, [%0]!                         \n\t" // DST->M[m0-m7]
-        "vst1.32 {q2-q3}, [%0]                          \n\t" // DST->M[m8-m15]
+        "vst1.32 {q0-q1}, [%0" MATHUTIL_ALIGN128 "]!                         \n\t" // DST->M[m0-m7]
+        "vst1.32 {q2-q3}, [%0" MATHUTIL_ALIGN128 "]                          \n\t" // DST->M[m8-m15]
         :
         : "r"(dst), "r"(m)
         : "q0", "q1", "q2", "q3", "memory"
@@ -165,8 +209,8 @@ inline void MathUtil::transformVector4(const float* m, float x, float y, float z
         "vld1.32    {d0[1]},        [%2]    \n\t"    // V[y]
         "vld1.32    {d1[0]},        [%3]    \n\t"    // V[z]
         "vld1.32    {d1[1]},        [%4]    \n\t"    // V[w]
-        "vld1.32    {d18 - d21},    [%5]!   \n\t"    // M[m0-m7]
-        "vld1.32    {d22 - d25},    [%5]    \n\t"    // M[m8-m15]
+        "vld1.32    {d18 - d21},    [%5" MATHUTIL_ALIGN128 "]!   \n\t"    // M[m0-m7]
+        "vld1.32    {d22 - d25},    [%5" MATHUTIL_ALIGN128 "]    \n\t"    // M[m8-m15]
 
         "vmul.f32 q13,  q9, d0[0]           \n\t"    // DST->V = M[m0-m3] * V[x]
         "vmla.f32 q13, q10, d0[1]           \n\t"    // DST->V += M[m4-m7] * V[y]
@@ -185,16 +229,16 @@ inline void MathUtil::transformVector4(const float* m, const float* v, float* ds
 {
     asm volatile
     (
-        "vld1.32    {d0, d1}, [%1]     \n\t"   // V[x, y, z, w]
-        "vld1.32    {d18 - d21}, [%2]! \n\t"   // M[m0-m7]
-        "vld1.32    {d22 - d25}, [%2]  \n\t"    // M[m8-m15]
+        "vld1.32    {d0, d1}, [%1" MATHUTIL_ALIGN128 "]     \n\t"   // V[x, y, z, w]
+        "vld1.32    {d18 - d21}, [%2" MATHUTIL_ALIGN128 "]! \n\t"   // M[m0-m7]
+        "vld1.32    {d22 - d25}, [%2" MATHUTIL_ALIGN128 "]  \n\t"    // M[m8-m15]
 
         "vmul.f32   q13, q9, d0[0]     \n\t"   // DST->V = M[m0-m3] * V[x]
         "vmla.f32   q13, q10, d0[1]    \n\t"   // DST->V = M[m4-m7] * V[y]
         "vmla.f32   q13, q11, d1[0]    \n\t"   // DST->V = M[m8-m11] * V[z]
         "vmla.f32   q13, q12, d1[1]    \n\t"   // DST->V = M[m12-m15] * V[w]
 
-        "vst1.32    {d26, d27}, [%0]   \n\t"   // DST->V
+        "vst1.32    {d26, d27}, [%0" MATHUTIL_ALIGN128 "]   \n\t"   // DST->V
         :
         : "r"(dst), "r"(v), "r"(m)
         : "q0", "q9", "q10","q11", "q12", "q13", "memory"
@@ -226,4 +270,248 @@ inline void MathUtil::crossVector3(const float* v1, const float* v2, float* dst)
     );
 }
 
+/**
+ * Interpolates four pairs of quaternions, which are deinterleaved so that each register holds
+ * one component of the four quaternions.
+ */
+inline void mathUtilSlerpQuaternions4(const float* q1, const float* q2, float32x4_t t, float32x4_t h2, float32x4_t c, float* dst)
+{
+    float32x4x4_t a = vld4q_f32(q1);
+    float32x4x4_t b = vld4q_f32(q2);
+
+    float32x4_t cosTheta = vmulq_f32(a.val[0], b.val[0]);
+    cosTheta = vmlaq_f32(cosTheta, a.val[1], b.val[1]);
+    cosTheta = vmlaq_f32(cosTheta, a.val[2], b.val[2]);
+    cosTheta = vmlaq_f32(cosTheta, a.val[3], b.val[3]);
+    uint32x4_t sign = vandq_u32(vreinterpretq_u32_f32(cosTheta), vdupq_n_u32(0x80000000));
+    float32x4_t f = vabsq_f32(cosTheta);
+
+    // k = A(f) * (t - 0.5)^2 + B(f)
+    float32x4_t k = vmlsq_f32(vdupq_n_f32(3.55645f), f, vdupq_n_f32(1.43519f));
+    k = vmlaq_f32(vdupq_n_f32(-3.2452f), f, k);
+    k = vmlaq_f32(vdupq_n_f32(1.0904f), f, k);
+    float32x4_t r = vmlaq_f32(vdupq_n_f32(-1.06021f), f, vdupq_n_f32(0.215638f));
+    r = vmlaq_f32(vdupq_n_f32(0.848013f), f, r);
+    k = vmlaq_f32(r, k, h2);
+
+    float32x4_t t2 = vmlaq_f32(t, c, k);
+    float32x4_t t1 = vsubq_f32(vdupq_n_f32(1.0f), t2);
+    t2 = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(t2), sign));
+
+    float32x4x4_t q;
+    for (int i = 0; i < 4; ++i)
+        q.val[i] = vmlaq_f32(vmulq_f32(t1, a.val[i]), t2, b.val[i]);
+
+    // The reciprocal square root estimate is refined with one Newton iteration.
+    float32x4_t l = vmulq_f32(q.val[0], q.val[0]);
+    l = vmlaq_f32(l, q.val[1], q.val[1]);
+    l = vmlaq_f32(l, q.val[2], q.val[2]);
+    l = vmlaq_f32(l, q.val[3], q.val[3]);
+    float32x4_t n = vrsqrteq_f32(l);
+    n = vmulq_f32(n, vrsqrtsq_f32(vmulq_f32(l, n), n));
+    for (int i = 0; i < 4; ++i)
+        q.val[i] = vmulq_f32(q.val[i], n);
+
+    vst4q_f32(dst, q);
+}
+
+inline void MathUtil::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+    float h = t - 0.5f;
+    float32x4_t tt = vdupq_n_f32(t);
+    float32x4_t h2 = vdupq_n_f32(h * h);
+    float32x4_t c = vdupq_n_f32(t * h * (t - 1.0f));
+
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+        mathUtilSlerpQuaternions4(q1 + i * 4, q2 + i * 4, tt, h2, c, dst + i * 4);
+
+    // The remaining quaternions are interpolated in a block padded with identities.
+    if (i < count)
+    {
+        float a[16] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        float b[16];
+        memcpy(b, a, sizeof(a));
+        size_t size = (count - i) * 4 * sizeof(float);
+        memcpy(a, q1 + i * 4, size);
+        memcpy(b, q2 + i * 4, size);
+        mathUtilSlerpQuaternions4(a, b, tt, h2, c, a);
+        memcpy(dst + i * 4, a, size);
+    }
+}
+
+inline void MathUtil::transformVectors(const float* m, const float* src, unsigned int srcStride, float w, float* dst, unsigned int dstStride, unsigned int count)
+{
+    // The columns of the matrix stay in registers for the whole array.
+    float32x4_t c0 = vld1q_f32(m);                         // M[m0-m3]
+    float32x4_t c1 = vld1q_f32(m + 4);                     // M[m4-m7]
+    float32x4_t c2 = vld1q_f32(m + 8);                     // M[m8-m11]
+    float32x4_t c3 = vmulq_n_f32(vld1q_f32(m + 12), w);    // M[m12-m15] * w
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* v = (const float*)((const char*)src + (size_t)i * srcStride);
+        float32x4_t r = vmlaq_n_f32(c3, c0, v[0]);
+        r = vmlaq_n_f32(r, c1, v[1]);
+        r = vmlaq_n_f32(r, c2, v[2]);
+
+        float* d = (float*)((char*)dst + (size_t)i * dstStride);
+        vst1_f32(d, vget_low_f32(r));
+        vst1q_lane_f32(d + 2, r, 2);
+    }
+}
+
+inline void MathUtil::transformBoxes(const float* m, const float* src, unsigned int srcStride, float* dst, unsigned int dstStride, unsigned int count)
+{
+    float32x4_t c0 = vld1q_f32(m);      // M[m0-m3]
+    float32x4_t c1 = vld1q_f32(m + 4);  // M[m4-m7]
+    float32x4_t c2 = vld1q_f32(m + 8);  // M[m8-m11]
+    float32x4_t c3 = vld1q_f32(m + 12); // M[m12-m15]
+    float32x4_t a0 = vabsq_f32(c0);
+    float32x4_t a1 = vabsq_f32(c1);
+    float32x4_t a2 = vabsq_f32(c2);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* b = (const float*)((const char*)src + (size_t)i * srcStride);
+
+        // Transform the center of the box, and project its extents onto the transformed axes.
+        float ex = (b[3] - b[0]) * 0.5f;
+        float ey = (b[4] - b[1]) * 0.5f;
+        float ez = (b[5] - b[2]) * 0.5f;
+        float32x4_t c = vmlaq_n_f32(c3, c0, (b[0] + b[3]) * 0.5f);
+        c = vmlaq_n_f32(c, c1, (b[1] + b[4]) * 0.5f);
+        c = vmlaq_n_f32(c, c2, (b[2] + b[5]) * 0.5f);
+        float32x4_t e = vmulq_n_f32(a0, ex);
+        e = vmlaq_n_f32(e, a1, ey);
+        e = vmlaq_n_f32(e, a2, ez);
+
+        float* d = (float*)((char*)dst + (size_t)i * dstStride);
+        float32x4_t min = vsubq_f32(c, e);
+        float32x4_t max = vaddq_f32(c, e);
+        vst1_f32(d, vget_low_f32(min));
+        vst1q_lane_f32(d + 2, min, 2);
+        vst1_f32(d + 3, vget_low_f32(max));
+        vst1q_lane_f32(d + 5, max, 2);
+    }
+}
+
+/**
+ * Loads six planes into the lanes of two sets of registers, with the last two lanes
+ * of the second set holding planes that every volume passes.
+ */
+inline void mathUtilLoadPlanes(const float* planes, float32x4x4_t* first, float32x4x4_t* second)
+{
+    *first = vld4q_f32(planes);
+    float padded[16];
+    memcpy(padded, planes + 16, sizeof(float) * 8);
+    memset(padded + 8, 0, sizeof(float) * 8);
+    *second = vld4q_f32(padded);
+}
+
+/**
+ * Returns a mask with bit i set if lane i of the comparison result is set.
+ */
+inline unsigned int mathUtilMoveMask(uint32x4_t v)
+{
+    static const uint32_t bits[4] = { 1, 2, 4, 8 };
+    uint32x4_t m = vandq_u32(v, vld1q_u32(bits));
+    uint32x2_t sum = vpadd_u32(vget_low_u32(m), vget_high_u32(m));
+    sum = vpadd_u32(sum, sum);
+    return vget_lane_u32(sum, 0);
+}
+
+/**
+ * Returns the index of the lowest set bit of a mask of the six planes, or MATHUTIL_PLANE_COUNT if none is set.
+ */
+inline unsigned int mathUtilFirstPlane(unsigned int mask)
+{
+    for (unsigned int j = 0; j < MATHUTIL_PLANE_COUNT; ++j)
+    {
+        if (mask & (1u << j))
+            return j;
+    }
+    return MATHUTIL_PLANE_COUNT;
+}
+
+inline unsigned int MathUtil::cullSpheres(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count)
+{
+    memset(visibility, 0, ((count + 31) / 32) * sizeof(unsigned int));
+
+    // Each sphere is tested against four planes at once, after the plane that last culled it.
+    float32x4x4_t p0;
+    float32x4x4_t p1;
+    mathUtilLoadPlanes(planes, &p0, &p1);
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* s = (const float*)((const char*)src + (size_t)i * srcStride);
+        if (planeCache && planeCache[i] < MATHUTIL_PLANE_COUNT)
+        {
+            const float* p = planes + planeCache[i] * 4;
+            if (p[0] * s[0] + p[1] * s[1] + p[2] * s[2] + p[3] < -s[3])
+                continue;
+        }
+        float32x4_t r = vdupq_n_f32(-s[3]);
+        float32x4_t d0 = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(p0.val[3], p0.val[0], s[0]), p0.val[1], s[1]), p0.val[2], s[2]);
+        float32x4_t d1 = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(p1.val[3], p1.val[0], s[0]), p1.val[1], s[1]), p1.val[2], s[2]);
+        unsigned int outside = mathUtilMoveMask(vcltq_f32(d0, r)) | (mathUtilMoveMask(vcltq_f32(d1, r)) << 4);
+        if (outside)
+        {
+            if (planeCache)
+                planeCache[i] = (unsigned char)mathUtilFirstPlane(outside);
+        }
+        else
+        {
+            visibility[i >> 5] |= 1u << (i & 31);
+            ++visible;
+        }
+    }
+    return visible;
+}
+
+inline unsigned int MathUtil::cullBoxes(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count)
+{
+    memset(visibility, 0, ((count + 31) / 32) * sizeof(unsigned int));
+
+    // Each box is tested against four planes at once, after the plane that last culled it.
+    float32x4x4_t p0;
+    float32x4x4_t p1;
+    mathUtilLoadPlanes(planes, &p0, &p1);
+    float32x4_t a0[3] = { vabsq_f32(p0.val[0]), vabsq_f32(p0.val[1]), vabsq_f32(p0.val[2]) };
+    float32x4_t a1[3] = { vabsq_f32(p1.val[0]), vabsq_f32(p1.val[1]), vabsq_f32(p1.val[2]) };
+    unsigned int visible = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* b = (const float*)((const char*)src + (size_t)i * srcStride);
+        float cx = (b[0] + b[3]) * 0.5f;
+        float cy = (b[1] + b[4]) * 0.5f;
+        float cz = (b[2] + b[5]) * 0.5f;
+        float ex = (b[3] - b[0]) * 0.5f;
+        float ey = (b[4] - b[1]) * 0.5f;
+        float ez = (b[5] - b[2]) * 0.5f;
+        if (planeCache && planeCache[i] < MATHUTIL_PLANE_COUNT)
+        {
+            const float* p = planes + planeCache[i] * 4;
+            float distance = p[0] * cx + p[1] * cy + p[2] * cz + p[3];
+            if (distance < -(fabsf(ex * p[0]) + fabsf(ey * p[1]) + fabsf(ez * p[2])))
+                continue;
+        }
+        float32x4_t d0 = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(p0.val[3], p0.val[0], cx), p0.val[1], cy), p0.val[2], cz);
+        float32x4_t d1 = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(p1.val[3], p1.val[0], cx), p1.val[1], cy), p1.val[2], cz);
+        float32x4_t r0 = vnegq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(a0[0], ex), a0[1], ey), a0[2], ez));
+        float32x4_t r1 = vnegq_f32(vmlaq_n_f32(vmlaq_n_f32(vmulq_n_f32(a1[0], ex), a1[1], ey), a1[2], ez));
+        unsigned int outside = mathUtilMoveMask(vcltq_f32(d0, r0)) | (mathUtilMoveMask(vcltq_f32(d1, r1)) << 4);
+        if (outside)
+        {
+            if (planeCache)
+                planeCache[i] = (unsigned char)mathUtilFirstPlane(outside);
+        }
+        else
+        {
+            visibility[i >> 5] |= 1u << (i & 31);
+            ++visible;
+        }
+    }
+    return visible;
+}
+
 }
@@ -0,0 +1,613 @@
+#include <xmmintrin.h>
+#if defined(__AVX__)
+#include <immintrin.h>
+#define MATHUTIL_USE_AVX
+#endif
+
+// Matrices and Vector4s are 16-byte aligned when built with GP_USE_ALIGNED_MATH, so they are
+// loaded and stored with aligned moves. The AVX loads stay unaligned, since they need 32 bytes.
+#if defined(GP_USE_ALIGNED_MATH)
+#define MATHUTIL_LOAD_PS _mm_load_ps
+#define MATHUTIL_STORE_PS _mm_store_ps
+#else
+#define MATHUTIL_LOAD_PS _mm_loadu_ps
+#define MATHUTIL_STORE_PS _mm_storeu_ps
+#endif
+
+namespace gameplay
+{
+
+inline void MathUtil::addMatrix(const float* m, float scalar, float* dst)
+{
+#if defined(MATHUTIL_USE_AVX)
+    __m256 s = _mm256_set1_ps(scalar);
+    __m256 a = _mm256_add_ps(_mm256_loadu_ps(m), s);     // M[m0-m7] + s
+    __m256 b = _mm256_add_ps(_mm256_loadu_ps(m + 8), s); // M[m8-m15] + s
+    _mm256_storeu_ps(dst, a);
+    _mm256_storeu_ps(dst + 8, b);
+#else
+    __m128 s = _mm_set1_ps(scalar);
+    __m128 a = _mm_add_ps(MATHUTIL_LOAD_PS(m), s);      // M[m0-m3] + s
+    __m128 b = _mm_add_ps(MATHUTIL_LOAD_PS(m + 4), s);  // M[m4-m7] + s
+    __m128 c = _mm_add_ps(MATHUTIL_LOAD_PS(m + 8), s);  // M[m8-m11] + s
+    __m128 d = _mm_add_ps(MATHUTIL_LOAD_PS(m + 12), s); // M[m12-m15] + s
+    MATHUTIL_STORE_PS(dst, a);
+    MATHUTIL_STORE_PS(dst + 4, b);
+    MATHUTIL_STORE_PS(dst + 8, c);
+    MATHUTIL_STORE_PS(dst + 12, d);
+#endif
+}
+
+inline void MathUtil::addMatrix(const float* m1, const float* m2, float* dst)
+{
+#if defined(MATHUTIL_USE_AVX)
+    __m256 a = _mm256_add_ps(_mm256_loadu_ps(m1), _mm256_loadu_ps(m2));         // M1[m0-m7] + M2[m0-m7]
+    __m256 b = _mm256_add_ps(_mm256_loadu_ps(m1 + 8), _mm256_loadu_ps(m2 + 8)); // M1[m8-m15] + M2[m8-m15]
+    _mm256_storeu_ps(dst, a);
+    _mm256_storeu_ps(dst + 8, b);
+#else
+    __m128 a = _mm_add_ps(MATHUTIL_LOAD_PS(m1), MATHUTIL_LOAD_PS(m2));           // M1[m0-m3] + M2[m0-m3]
+    __m128 b = _mm_add_ps(MATHUTIL_LOAD_PS(m1 + 4), MATHUTIL_LOAD_PS(m2 + 4));   // M1[m4-m7] + M2[m4-m7]
+    __m128 c = _mm_add_ps(MATHUTIL_LOAD_PS(m1 + 8), MATHUTIL_LOAD_PS(m2 + 8));   // M1[m8-m11] + M2[m8-m11]
+    __m128 d = _mm_add_ps(MATHUTIL_LOAD_PS(m1 + 12), MATHUTIL_LOAD_PS(m2 + 12)); // M1[m12-m15] + M2[m12-m15]
+    MATHUTIL_STORE_PS(dst, a);
+    MATHUTIL_STORE_PS(dst + 4, b);
+    MATHUTIL_STORE_PS(dst + 8, c);
+    MATHUTIL_STORE_PS(dst + 12, d);
+#endif
+}
+
+inline void MathUtil::subtractMatrix(const float* m1, const float* m2, float* dst)
+{
+#if defined(MATHUTIL_USE_AVX)
+    __m256 a = _mm256_sub_ps(_mm256_loadu_ps(m1), _mm256_loadu_ps(m2));         // M1[m0-m7] - M2[m0-m7]
+    __m256 b = _mm256_sub_ps(_mm256_loadu_ps(m1 + 8), _mm256_loadu_ps(m2 + 8)); // M1[m8-m15] - M2[m8-m15]
+    _mm256_storeu_ps(dst, a);
+    _mm256_storeu_ps(dst + 8, b);
+#else
+    __m128 a = _mm_sub_ps(MATHUTIL_LOAD_PS(m1), MATHUTIL_LOAD_PS(m2));           // M1[m0-m3] - M2[m0-m3]
+    __m128 b = _mm_sub_ps(MATHUTIL_LOAD_PS(m1 + 4), MATHUTIL_LOAD_PS(m2 + 4));   // M1[m4-m7] - M2[m4-m7]
+    __m128 c = _mm_sub_ps(MATHUTIL_LOAD_PS(m1 + 8), MATHUTIL_LOAD_PS(m2 + 8));   // M1[m8-m11] - M2[m8-m11]
+    __m128 d = _mm_sub_ps(MATHUTIL_LOAD_PS(m1 + 12), MATHUTIL_LOAD_PS(m2 + 12)); // M1[m12-m15] - M2[m12-m15]
+    MATHUTIL_STORE_PS(dst, a);
+    MATHUTIL_STORE_PS(dst + 4, b);
+    MATHUTIL_STORE_PS(dst + 8, c);
+    MATHUTIL_STORE_PS(dst + 12, d);
+#endif
+}
+
+inline void MathUtil::multiplyMatrix(const float* m, float scalar, float* dst)
+{
+#if defined(MATHUTIL_USE_AVX)
+    __m256 s = _mm256_set1_ps(scalar);
+    __m256 a = _mm256_mul_ps(_mm256_loadu_ps(m), s);     // M[m0-m7] * s
+    __m256 b = _mm256_mul_ps(_mm256_loadu_ps(m + 8), s); // M[m8-m15] * s
+    _mm256_storeu_ps(dst, a);
+    _mm256_storeu_ps(dst + 8, b);
+#else
+    __m128 s = _mm_set1_ps(scalar);
+    __m128 a = _mm_mul_ps(MATHUTIL_LOAD_PS(m), s);      // M[m0-m3] * s
+    __m128 b = _mm_mul_ps(MATHUTIL_LOAD_PS(m + 4), s);  // M[m4-m7] * s
+    __m128 c = _mm_mul_ps(MATHUTIL_LOAD_PS(m + 8), s);  // M[m8-m11] * s
+    __m128 d = _mm_mul_ps(MATHUTIL_LOAD_PS(m + 12), s); // M[m12-m15] * s
+    MATHUTIL_STORE_PS(dst, a);
+    MATHUTIL_STORE_PS(dst + 4, b);
+    MATHUTIL_STORE_PS(dst + 8, c);
+    MATHUTIL_STORE_PS(dst + 12, d);
+#endif
+}
+
+inline void MathUtil::multiplyMatrix(const float* m1, const float* m2, float* dst)
+{
+    // Both matrices are loaded before the product is stored, which supports the case
+    // where m1 or m2 is the same array as dst.
+    __m128 c0 = MATHUTIL_LOAD_PS(m1);      // M1[m0-m3]
+    __m128 c1 = MATHUTIL_LOAD_PS(m1 + 4);  // M1[m4-m7]
+    __m128 c2 = MATHUTIL_LOAD_PS(m1 + 8);  // M1[m8-m11]
+    __m128 c3 = MATHUTIL_LOAD_PS(m1 + 12); // M1[m12-m15]
+
+#if defined(MATHUTIL_USE_AVX)
+    // Each half of a 256-bit register holds a column of the product, so two columns
+    // are multiplied at once with the columns of m1 duplicated into both halves.
+    __m256 d0 = _mm256_insertf128_ps(_mm256_castps128_ps256(c0), c0, 1);
+    __m256 d1 = _mm256_insertf128_ps(_mm256_castps128_ps256(c1), c1, 1);
+    __m256 d2 = _mm256_insertf128_ps(_mm256_castps128_ps256(c2), c2, 1);
+    __m256 d3 = _mm256_insertf128_ps(_mm256_castps128_ps256(c3), c3, 1);
+    __m256 a = _mm256_loadu_ps(m2);     // M2[m0-m7]
+    __m256 b = _mm256_loadu_ps(m2 + 8); // M2[m8-m15]
+
+    __m256 p = _mm256_mul_ps(d0, _mm256_permute_ps(a, _MM_SHUFFLE(0, 0, 0, 0)));
+    p = _mm256_add_ps(p, _mm256_mul_ps(d1, _mm256_permute_ps(a, _MM_SHUFFLE(1, 1, 1, 1))));
+    p = _mm256_add_ps(p, _mm256_mul_ps(d2, _mm256_permute_ps(a, _MM_SHUFFLE(2, 2, 2, 2))));
+    p = _mm256_add_ps(p, _mm256_mul_ps(d3, _mm256_permute_ps(a, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    __m256 q = _mm256_mul_ps(d0, _mm256_permute_ps(b, _MM_SHUFFLE(0, 0, 0, 0)));
+    q = _mm256_add_ps(q, _mm256_mul_ps(d1, _mm256_permute_ps(b, _MM_SHUFFLE(1, 1, 1, 1))));
+    q = _mm256_add_ps(q, _mm256_mul_ps(d2, _mm256_permute_ps(b, _MM_SHUFFLE(2, 2, 2, 2))));
+    q = _mm256_add_ps(q, _mm256_mul_ps(d3, _mm256_permute_ps(b, _MM_SHUFFLE(3, 3, 3, 3))));
+
+    _mm256_storeu_ps(dst, p);
+    _mm256_storeu_ps(dst + 8, q);
+#else
+    __m128 product[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        __m128 column = MATHUTIL_LOAD_PS(m2 + i * 4); // M2[column i]
+        __m128 x = _mm_mul_ps(c0, _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)));
+        x = _mm_add_ps(x, _mm_mul_ps(c1, _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1))));
+        x = _mm_add_ps(x, _mm_mul_ps(c2, _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2))));
+        x = _mm_add_ps(x, _mm_mul_ps(c3, _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3))));
+        product[i] = x;
+    }
+    MATHUTIL_STORE_PS(dst, product[0]);
+    MATHUTIL_STORE_PS(dst + 4, product[1]);
+    MATHUTIL_STORE_PS(dst + 8, product[2]);
+    MATHUTIL_STORE_PS(dst + 12, product[3]);
+#endif
+}
+
+inline void MathUtil::multiplyAffineMatrix(const float* m1, const float* m2, float* dst)
+{
+    // The last rows of the matrices are (0, 0, 0, 1), so the last column of m1 is only added to
+    // the last column of the product, and the last row of the product comes from those of m1.
+    __m128 c0 = MATHUTIL_LOAD_PS(m1);      // M1[m0-m3]
+    __m128 c1 = MATHUTIL_LOAD_PS(m1 + 4);  // M1[m4-m7]
+    __m128 c2 = MATHUTIL_LOAD_PS(m1 + 8);  // M1[m8-m11]
+    __m128 c3 = MATHUTIL_LOAD_PS(m1 + 12); // M1[m12-m15]
+
+    __m128 product[4];
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        __m128 column = MATHUTIL_LOAD_PS(m2 + i * 4); // M2[column i]
+        __m128 x = _mm_mul_ps(c0, _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)));
+        x = _mm_add_ps(x, _mm_mul_ps(c1, _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1))));
+        x = _mm_add_ps(x, _mm_mul_ps(c2, _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2))));
+        product[i] = x;
+    }
+    product[3] = _mm_add_ps(product[3], c3);
+
+    MATHUTIL_STORE_PS(dst, product[0]);
+    MATHUTIL_STORE_PS(dst + 4, product[1]);
+    MATHUTIL_STORE_PS(dst + 8, product[2]);
+    MATHUTIL_STORE_PS(dst + 12, product[3]);
+}
+
+inline void MathUtil::negateMatrix(const float* m, float* dst)
+{
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 a = _mm_xor_ps(MATHUTIL_LOAD_PS(m), sign);      // -M[m0-m3]
+    __m128 b = _mm_xor_ps(MATHUTIL_LOAD_PS(m + 4), sign);  // -M[m4-m7]
+    __m128 c = _mm_xor_ps(MATHUTIL_LOAD_PS(m + 8), sign);  // -M[m8-m11]
+    __m128 d = _mm_xor_ps(MATHUTIL_LOAD_PS(m + 12), sign); // -M[m12-m15]
+    MATHUTIL_STORE_PS(dst, a);
+    MATHUTIL_STORE_PS(dst + 4, b);
+    MATHUTIL_STORE_PS(dst + 8, c);
+    MATHUTIL_STORE_PS(dst + 12, d);
+}
+
+inline void MathUtil::transposeMatrix(const float* m, float* dst)
+{
+    __m128 a = MATHUTIL_LOAD_PS(m);      // M[m0-m3]
+    __m128 b = MATHUTIL_LOAD_PS(m + 4);  // M[m4-m7]
+    __m128 c = MATHUTIL_LOAD_PS(m + 8);  // M[m8-m11]
+    __m128 d = MATHUTIL_LOAD_PS(m + 12); // M[m12-m15]
+    _MM_TRANSPOSE4_PS(a, b, c, d);
+    MATHUTIL_STORE_PS(dst, a);
+    MATHUTIL_STORE_PS(dst + 4, b);
+    MATHUTIL_STORE_PS(dst + 8, c);
+    MATHUTIL_STORE_PS(dst + 12, d);
+}
+
+inline void MathUtil::transformVector4(const float* m, float x, float y, float z, float w, float* dst)
+{
+    __m128 v = _mm_mul_ps(MATHUTIL_LOAD_PS(m), _mm_set1_ps(x));         // M[m0-m3] * x
+    v = _mm_add_ps(v, _mm_mul_ps(MATHUTIL_LOAD_PS(m + 4), _mm_set1_ps(y)));  // + M[m4-m7] * y
+    v = _mm_add_ps(v, _mm_mul_ps(MATHUTIL_LOAD_PS(m + 8), _mm_set1_ps(z)));  // + M[m8-m11] * z
+    v = _mm_add_ps(v, _mm_mul_ps(MATHUTIL_LOAD_PS(m + 12), _mm_set1_ps(w))); // + M[m12-m15] * w
+
+    // Only the x, y and z components are written.
+    _mm_storel_pi((__m64*)dst, v);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(v, v));
+}
+
+inline void MathUtil::transformVector4(const float* m, const float* v, float* dst)
+{
+    // Handle case where v == dst.
+    __m128 p = MATHUTIL_LOAD_PS(v);
+    __m128 r = _mm_mul_ps(MATHUTIL_LOAD_PS(m), _mm_shuffle_ps(p, p, _MM_SHUFFLE(0, 0, 0, 0)));           // M[m0-m3] * V[x]
+    r = _mm_add_ps(r, _mm_mul_ps(MATHUTIL_LOAD_PS(m + 4), _mm_shuffle_ps(p, p, _MM_SHUFFLE(1, 1, 1, 1))));  // + M[m4-m7] * V[y]
+    r = _mm_add_ps(r, _mm_mul_ps(MATHUTIL_LOAD_PS(m + 8), _mm_shuffle_ps(p, p, _MM_SHUFFLE(2, 2, 2, 2))));  // + M[m8-m11] * V[z]
+    r = _mm_add_ps(r, _mm_mul_ps(MATHUTIL_LOAD_PS(m + 12), _mm_shuffle_ps(p, p, _MM_SHUFFLE(3, 3, 3, 3)))); // + M[m12-m15] * V[w]
+    MATHUTIL_STORE_PS(dst, r);
+}
+
+inline void MathUtil::crossVector3(const float* v1, const float* v2, float* dst)
+{
+    // The vectors are three floats, so they are not loaded past their last component.
+    __m128 a = _mm_set_ps(0.0f, v1[2], v1[1], v1[0]);
+    __m128 b = _mm_set_ps(0.0f, v2[2], v2[1], v2[0]);
+    __m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    __m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+
+    // (a * b.yzx - a.yzx * b).yzx is the cross product.
+    __m128 c = _mm_sub_ps(_mm_mul_ps(a, bYZX), _mm_mul_ps(aYZX, b));
+    c = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+
+    _mm_storel_pi((__m64*)dst, c);
+    _mm_store_ss(dst + 2, _mm_movehl_ps(c, c));
+}
+
+/**
+ * Interpolates four pairs of quaternions, which are transposed so that each register holds
+ * one component of the four quaternions.
+ */
+inline void mathUtilSlerpQuaternions4(const float* q1, const float* q2, __m128 t, __m128 h2, __m128 c, float* dst)
+{
+    __m128 ax = MATHUTIL_LOAD_PS(q1);
+    __m128 ay = MATHUTIL_LOAD_PS(q1 + 4);
+    __m128 az = MATHUTIL_LOAD_PS(q1 + 8);
+    __m128 aw = MATHUTIL_LOAD_PS(q1 + 12);
+    _MM_TRANSPOSE4_PS(ax, ay, az, aw);
+    __m128 bx = MATHUTIL_LOAD_PS(q2);
+    __m128 by = MATHUTIL_LOAD_PS(q2 + 4);
+    __m128 bz = MATHUTIL_LOAD_PS(q2 + 8);
+    __m128 bw = MATHUTIL_LOAD_PS(q2 + 12);
+    _MM_TRANSPOSE4_PS(bx, by, bz, bw);
+
+    __m128 cosTheta = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+    __m128 sign = _mm_and_ps(cosTheta, _mm_set1_ps(-0.0f));
+    __m128 f = _mm_xor_ps(cosTheta, sign);
+
+    // k = A(f) * (t - 0.5)^2 + B(f)
+    __m128 k = _mm_sub_ps(_mm_set1_ps(3.55645f), _mm_mul_ps(f, _mm_set1_ps(1.43519f)));
+    k = _mm_add_ps(_mm_set1_ps(-3.2452f), _mm_mul_ps(f, k));
+    k = _mm_add_ps(_mm_set1_ps(1.0904f), _mm_mul_ps(f, k));
+    __m128 b = _mm_add_ps(_mm_set1_ps(-1.06021f), _mm_mul_ps(f, _mm_set1_ps(0.215638f)));
+    b = _mm_add_ps(_mm_set1_ps(0.848013f), _mm_mul_ps(f, b));
+    k = _mm_add_ps(_mm_mul_ps(k, h2), b);
+
+    __m128 t2 = _mm_add_ps(t, _mm_mul_ps(c, k));
+    __m128 t1 = _mm_sub_ps(_mm_set1_ps(1.0f), t2);
+    t2 = _mm_xor_ps(t2, sign);
+
+    __m128 x = _mm_add_ps(_mm_mul_ps(t1, ax), _mm_mul_ps(t2, bx));
+    __m128 y = _mm_add_ps(_mm_mul_ps(t1, ay), _mm_mul_ps(t2, by));
+    __m128 z = _mm_add_ps(_mm_mul_ps(t1, az), _mm_mul_ps(t2, bz));
+    __m128 w = _mm_add_ps(_mm_mul_ps(t1, aw), _mm_mul_ps(t2, bw));
+
+    // The reciprocal square root estimate is refined with one Newton iteration.
+    __m128 l = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+    __m128 n = _mm_rsqrt_ps(l);
+    n = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), n), _mm_sub_ps(_mm_set1_ps(3.0f), _mm_mul_ps(_mm_mul_ps(l, n), n)));
+    x = _mm_mul_ps(x, n);
+    y = _mm_mul_ps(y, n);
+    z = _mm_mul_ps(z, n);
+    w = _mm_mul_ps(w, n);
+
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    MATHUTIL_STORE_PS(dst, x);
+    MATHUTIL_STORE_PS(dst + 4, y);
+    MATHUTIL_STORE_PS(dst + 8, z);
+    MATHUTIL_STORE_PS(dst + 12, w);
+}
+
+inline void MathUtil::slerpQuaternions(const float* q1, const float* q2, float t, float* dst, unsigned int count)
+{
+    float h = t - 0.5f;
+    __m128 tt = _mm_set1_ps(t);
+    __m128 h2 = _mm_set1_ps(h * h);
+    __m128 c = _mm_set1_ps(t * h * (t - 1.0f));
+
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+        mathUtilSlerpQuaternions4(q1 + i * 4, q2 + i * 4, tt, h2, c, dst + i * 4);
+
+    // The remaining quaternions are interpolated in a block padded with identities.
+    if (i < count)
+    {
+        GP_MATH_ALIGN float a[16] = { 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f };
+        GP_MATH_ALIGN float b[16];
+        memcpy(b, a, sizeof(a));
+        size_t size = (count - i) * 4 * sizeof(float);
+        memcpy(a, q1 + i * 4, size);
+        memcpy(b, q2 + i * 4, size);
+        mathUtilSlerpQuaternions4(a, b, tt, h2, c, a);
+        memcpy(dst + i * 4, a, size);
+    }
+}
+
+/**
+ * Loads the three floats at p into the x, y and z components, without reading past them.
+ */
+inline __m128 mathUtilLoadVector3(const float* p)
+{
+    return _mm_movelh_ps(_mm_loadl_pi(_mm_setzero_ps(), (const __m64*)p), _mm_load_ss(p + 2));
+}
+
+/**
+ * Stores the x, y and z components at p.
+ */
+inline void mathUtilStoreVector3(float* p, __m128 v)
+{
+    _mm_storel_pi((__m64*)p, v);
+    _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+}
+
+inline void MathUtil::transformVectors(const float* m, const float* src, unsigned int srcStride, float w, float* dst, unsigned int dstStride, unsigned int count)
+{
+    // The columns of the matrix stay in registers for the whole array.
+    __m128 c0 = MATHUTIL_LOAD_PS(m);                                     // M[m0-m3]
+    __m128 c1 = MATHUTIL_LOAD_PS(m + 4);                                 // M[m4-m7]
+    __m128 c2 = MATHUTIL_LOAD_PS(m + 8);                                 // M[m8-m11]
+    __m128 c3 = _mm_mul_ps(MATHUTIL_LOAD_PS(m + 12), _mm_set1_ps(w));    // M[m12-m15] * w
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* v = (const float*)((const char*)src + (size_t)i * srcStride);
+        __m128 r = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(v[0])), _mm_mul_ps(c1, _mm_set1_ps(v[1])));
+        r = _mm_add_ps(r, _mm_mul_ps(c2, _mm_set1_ps(v[2])));
+        r = _mm_add_ps(r, c3);
+        mathUtilStoreVector3((float*)((char*)dst + (size_t)i * dstStride), r);
+    }
+}
+
+inline void MathUtil::transformBoxes(const float* m, const float* src, unsigned int srcStride, float* dst, unsigned int dstStride, unsigned int count)
+{
+    __m128 sign = _mm_set1_ps(-0.0f);
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 c0 = MATHUTIL_LOAD_PS(m);      // M[m0-m3]
+    __m128 c1 = MATHUTIL_LOAD_PS(m + 4);  // M[m4-m7]
+    __m128 c2 = MATHUTIL_LOAD_PS(m + 8);  // M[m8-m11]
+    __m128 c3 = MATHUTIL_LOAD_PS(m + 12); // M[m12-m15]
+    __m128 a0 = _mm_andnot_ps(sign, c0);
+    __m128 a1 = _mm_andnot_ps(sign, c1);
+    __m128 a2 = _mm_andnot_ps(sign, c2);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const float* b = (const float*)((const char*)src + (size_t)i * srcStride);
+        __m128 min = mathUtilLoadVector3(b);
+        __m128 max = mathUtilLoadVector3(b + 3);
+        __m128 center = _mm_mul_ps(_mm_add_ps(min, max), half);
+        __m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+        // Transform the center of the box, and project its extents onto the transformed axes.
+        __m128 x = _mm_shuffle_ps(center, center, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(center, center, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(center, center, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 c = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, c0), _mm_mul_ps(y, c1)), _mm_mul_ps(z, c2)), c3);
+        x = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(0, 0, 0, 0));
+        y = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(1, 1, 1, 1));
+        z = _mm_shuffle_ps(extent, extent, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, a0), _mm_mul_ps(y, a1)), _mm_mul_ps(z, a2));
+
+        float* d = (float*)((char*)dst + (size_t)i * dstStride);
+        mathUtilStoreVector3(d, _mm_sub_ps(c, e));
+        mathUtilStoreVector3(d + 3, _mm_add_ps(c, e));
+    }
+}
+
+/**
+ * Returns the index of the first of the planes that the sphere is behind, testing the plane
+ * with the given index first, or MATHUTIL_PLANE_COUNT if the sphere is not behind any plane.
+ */
+inline unsigned int mathUtilCullSphere(const float* planes, const float* s, unsigned int first)
+{
+    if (first >= MATHUTIL_PLANE_COUNT)
+        first = 0;
+    for (unsigned int i = 0; i < MATHUTIL_PLANE_COUNT; ++i)
+    {
+        // Test the first plane, followed by the others in order.
+        unsigned int j = i == 0 ? first : (i <= first ? i - 1 : i);
+        const float* p = planes + j * 4;
+        if (p[0] * s[0] + p[1] * s[1] + p[2] * s[2] + p[3] < -s[3])
+            return j;
+    }
+    return MATHUTIL_PLANE_COUNT;
+}
+
+/**
+ * Returns the index of the first of the planes that the box, stored as its min and max points,
+ * is behind, like mathUtilCullSphere.
+ */
+inline unsigned int mathUtilCullBox(const float* planes, const float* b, unsigned int first)
+{
+    float cx = (b[0] + b[3]) * 0.5f;
+    float cy = (b[1] + b[4]) * 0.5f;
+    float cz = (b[2] + b[5]) * 0.5f;
+    float ex = (b[3] - b[0]) * 0.5f;
+    float ey = (b[4] - b[1]) * 0.5f;
+    float ez = (b[5] - b[2]) * 0.5f;
+    if (first >= MATHUTIL_PLANE_COUNT)
+        first = 0;
+    for (unsigned int i = 0; i < MATHUTIL_PLANE_COUNT; ++i)
+    {
+        unsigned int j = i == 0 ? first : (i <= first ? i - 1 : i);
+        const float* p = planes + j * 4;
+        float distance = p[0] * cx + p[1] * cy + p[2] * cz + p[3];
+        if (distance < -(fabsf(ex * p[0]) + fabsf(ey * p[1]) + fabsf(ez * p[2])))
+            return j;
+    }
+    return MATHUTIL_PLANE_COUNT;
+}
+
+/**
+ * Loads the planes with the given indices and transposes them, so that the lanes of nx, ny,
+ * nz and d hold the normal and distance of each plane.
+ */
+inline void mathUtilLoadPlanes(const float* planes, const unsigned char* indices, __m128* nx, __m128* ny, __m128* nz, __m128* d)
+{
+    unsigned int index[4];
+    for (unsigned int k = 0; k < 4; ++k)
+        index[k] = indices[k] < MATHUTIL_PLANE_COUNT ? indices[k] : 0;
+    *nx = _mm_loadu_ps(planes + index[0] * 4);
+    *ny = _mm_loadu_ps(planes + index[1] * 4);
+    *nz = _mm_loadu_ps(planes + index[2] * 4);
+    *d = _mm_loadu_ps(planes + index[3] * 4);
+    _MM_TRANSPOSE4_PS(*nx, *ny, *nz, *d);
+}
+
+/**
+ * Stores the index of a plane in the plane cache of each lane of the mask.
+ */
+inline void mathUtilCachePlane(unsigned char* planeCache, int mask, unsigned int plane)
+{
+    for (unsigned int k = 0; k < 4; ++k)
+    {
+        if (mask & (1 << k))
+            planeCache[k] = (unsigned char)plane;
+    }
+}
+
+/**
+ * Sets the bits of the visible lanes of a group of four volumes in a visibility mask.
+ *
+ * @return The number of visible lanes.
+ */
+inline unsigned int mathUtilSetVisibility(unsigned int* visibility, unsigned int i, int culled)
+{
+    unsigned int visible = ~(unsigned int)culled & 0xF;
+    visibility[i >> 5] |= visible << (i & 31);
+    return (visible & 1) + ((visible >> 1) & 1) + ((visible >> 2) & 1) + (visible >> 3);
+}
+
+inline unsigned int MathUtil::cullSpheres(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count)
+{
+    memset(visibility, 0, ((count + 31) / 32) * sizeof(unsigned int));
+
+    // Four spheres are tested at once, with their centers and radii transposed into the lanes
+    // of four registers. Groups of four are aligned to the words of the visibility mask.
+    unsigned int visible = 0;
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const char* s = (const char*)src + (size_t)i * srcStride;
+        __m128 x = _mm_loadu_ps((const float*)s);
+        __m128 y = _mm_loadu_ps((const float*)(s + srcStride));
+        __m128 z = _mm_loadu_ps((const float*)(s + srcStride * 2));
+        __m128 r = _mm_loadu_ps((const float*)(s + srcStride * 3));
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+        r = _mm_sub_ps(_mm_setzero_ps(), r);
+
+        // Each sphere is first tested against the plane that last culled it, so the group is
+        // skipped without testing the other planes if its spheres are still behind those.
+        int culled = 0;
+        if (planeCache)
+        {
+            __m128 nx, ny, nz, d;
+            mathUtilLoadPlanes(planes, planeCache + i, &nx, &ny, &nz, &d);
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, nx), _mm_mul_ps(y, ny));
+            distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(z, nz)), d);
+            culled = _mm_movemask_ps(_mm_cmplt_ps(distance, r));
+        }
+        for (unsigned int j = 0; j < MATHUTIL_PLANE_COUNT && culled != 0xF; ++j)
+        {
+            const float* p = planes + j * 4;
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(p[0])), _mm_mul_ps(y, _mm_set1_ps(p[1])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(z, _mm_set1_ps(p[2])));
+            distance = _mm_add_ps(distance, _mm_set1_ps(p[3]));
+            int outside = _mm_movemask_ps(_mm_cmplt_ps(distance, r)) & ~culled;
+            if (outside)
+            {
+                if (planeCache)
+                    mathUtilCachePlane(planeCache + i, outside, j);
+                culled |= outside;
+            }
+        }
+        visible += mathUtilSetVisibility(visibility, i, culled);
+    }
+    for (; i < count; ++i)
+    {
+        const float* s = (const float*)((const char*)src + (size_t)i * srcStride);
+        unsigned int plane = mathUtilCullSphere(planes, s, planeCache ? planeCache[i] : 0);
+        if (plane < MATHUTIL_PLANE_COUNT)
+        {
+            if (planeCache)
+                planeCache[i] = (unsigned char)plane;
+        }
+        else
+        {
+            visibility[i >> 5] |= 1u << (i & 31);
+            ++visible;
+        }
+    }
+    return visible;
+}
+
+inline unsigned int MathUtil::cullBoxes(const float* planes, const float* src, unsigned int srcStride, unsigned int* visibility, unsigned char* planeCache, unsigned int count)
+{
+    memset(visibility, 0, ((count + 31) / 32) * sizeof(unsigned int));
+
+    // Four boxes are tested at once. The first four floats of each box hold its min point,
+    // and the last four its max point, which are transposed into the lanes of six registers.
+    __m128 half = _mm_set1_ps(0.5f);
+    __m128 sign = _mm_set1_ps(-0.0f);
+    unsigned int visible = 0;
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        const char* b = (const char*)src + (size_t)i * srcStride;
+        __m128 minX = _mm_loadu_ps((const float*)b);
+        __m128 minY = _mm_loadu_ps((const float*)(b + srcStride));
+        __m128 minZ = _mm_loadu_ps((const float*)(b + srcStride * 2));
+        __m128 unused0 = _mm_loadu_ps((const float*)(b + srcStride * 3));
+        _MM_TRANSPOSE4_PS(minX, minY, minZ, unused0);
+        __m128 unused1 = _mm_loadu_ps((const float*)b + 2);
+        __m128 maxX = _mm_loadu_ps((const float*)(b + srcStride) + 2);
+        __m128 maxY = _mm_loadu_ps((const float*)(b + srcStride * 2) + 2);
+        __m128 maxZ = _mm_loadu_ps((const float*)(b + srcStride * 3) + 2);
+        _MM_TRANSPOSE4_PS(unused1, maxX, maxY, maxZ);
+
+        __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half);
+        __m128 cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half);
+        __m128 cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+        __m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half);
+        __m128 ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half);
+        __m128 ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+        int culled = 0;
+        if (planeCache)
+        {
+            __m128 nx, ny, nz, d;
+            mathUtilLoadPlanes(planes, planeCache + i, &nx, &ny, &nz, &d);
+            __m128 distance = _mm_add_ps(_mm_mul_ps(cx, nx), _mm_mul_ps(cy, ny));
+            distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(cz, nz)), d);
+            __m128 radius = _mm_add_ps(_mm_mul_ps(ex, _mm_andnot_ps(sign, nx)), _mm_mul_ps(ey, _mm_andnot_ps(sign, ny)));
+            radius = _mm_add_ps(radius, _mm_mul_ps(ez, _mm_andnot_ps(sign, nz)));
+            culled = _mm_movemask_ps(_mm_cmplt_ps(distance, _mm_xor_ps(radius, sign)));
+        }
+        for (unsigned int j = 0; j < MATHUTIL_PLANE_COUNT && culled != 0xF; ++j)
+        {
+            const float* p = planes + j * 4;
+            __m128 distance = _mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(p[0])), _mm_mul_ps(cy, _mm_set1_ps(p[1])));
+            distance = _mm_add_ps(distance, _mm_mul_ps(cz, _mm_set1_ps(p[2])));
+            distance = _mm_add_ps(distance, _mm_set1_ps(p[3]));
+            __m128 radius = _mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(fabsf(p[0]))), _mm_mul_ps(ey, _mm_set1_ps(fabsf(p[1]))));
+            radius = _mm_add_ps(radius, _mm_mul_ps(ez, _mm_set1_ps(fabsf(p[2]))));
+            int outside = _mm_movemask_ps(_mm_cmplt_ps(distance, _mm_xor_ps(radius, sign))) & ~culled;
+            if (outside)
+            {
+                if (planeCache)
+                    mathUtilCachePlane(planeCache + i, outside, j);
+                culled |= outside;
+            }
+        }
+        visible += mathUtilSetVisibility(visibility, i, culled);
+    }
+    for (; i < count; ++i)
+    {
+        const float* b = (const float*)((const char*)src + (size_t)i * srcStride);
+        unsigned int plane = mathUtilCullBox(planes, b, planeCache ? planeCache[i] : 0);
+        if (plane < MATHUTIL_PLANE_COUNT)
+        {
+            if (planeCache)
+                planeCache[i] = (unsigned char)plane;
+        }
+        else
+        {
+            visibility[i >> 5] |= 1u << (i & 31);
+            ++visible;
+        }
+    }
+    return visible;
+}
+
+}
@@ -289,6 +289,27 @@ void Matrix::createRotation(const Quaternion& q, Matrix* dst)
     dst->m[15] = 1.0f;
 }
 
+void Matrix::createTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale, Matrix* dst)
+{
+    GP_ASSERT(dst);
+
+    // The columns of the rotation matrix, scaled by the scale of each axis.
+    createRotation(rotation, dst);
+    dst->m[0] *= scale.x;
+    dst->m[1] *= scale.x;
+    dst->m[2] *= scale.x;
+    dst->m[4] *= scale.y;
+    dst->m[5] *= scale.y;
+    dst->m[6] *= scale.y;
+    dst->m[8] *= scale.z;
+    dst->m[9] *= scale.z;
+    dst->m[10] *= scale.z;
+
+    dst->m[12] = translation.x;
+    dst->m[13] = translation.y;
+    dst->m[14] = translation.z;
+}
+
 void Matrix::createRotation(const Vector3& axis, float angle, Matrix* dst)
 {
     GP_ASSERT(dst);
@@ -700,6 +721,67 @@ bool Matrix::invert(Matrix* dst) const
     return true;
 }
 
+bool Matrix::invertAffine()
+{
+    return invertAffine(this);
+}
+
+bool Matrix::invertAffine(Matrix* dst) const
+{
+    GP_ASSERT(dst);
+
+    // The rows of the inverse of the upper 3x3 part are the cross products of its columns.
+    float r0x = m[5] * m[10] - m[6] * m[9];
+    float r0y = m[6] * m[8] - m[4] * m[10];
+    float r0z = m[4] * m[9] - m[5] * m[8];
+    float r1x = m[9] * m[2] - m[10] * m[1];
+    float r1y = m[10] * m[0] - m[8] * m[2];
+    float r1z = m[8] * m[1] - m[9] * m[0];
+    float r2x = m[1] * m[6] - m[2] * m[5];
+    float r2y = m[2] * m[4] - m[0] * m[6];
+    float r2z = m[0] * m[5] - m[1] * m[4];
+
+    // Calculate the determinant.
+    float det = m[0] * r0x + m[1] * r0y + m[2] * r0z;
+
+    // Close to zero, can't invert.
+    if (fabs(det) <= MATH_TOLERANCE)
+        return false;
+
+    float invDet = 1.0f / det;
+    r0x *= invDet; r0y *= invDet; r0z *= invDet;
+    r1x *= invDet; r1y *= invDet; r1z *= invDet;
+    r2x *= invDet; r2y *= invDet; r2z *= invDet;
+
+    // Support the case where m == dst.
+    float tx = m[12];
+    float ty = m[13];
+    float tz = m[14];
+
+    dst->m[0] = r0x;
+    dst->m[1] = r1x;
+    dst->m[2] = r2x;
+    dst->m[3] = 0.0f;
+
+    dst->m[4] = r0y;
+    dst->m[5] = r1y;
+    dst->m[6] = r2y;
+    dst->m[7] = 0.0f;
+
+    dst->m[8] = r0z;
+    dst->m[9] = r1z;
+    dst->m[10] = r2z;
+    dst->m[11] = 0.0f;
+
+    // The translation of the inverse is the negated translation, transformed by the inverse.
+    dst->m[12] = -(r0x * tx + r0y * ty + r0z * tz);
+    dst->m[13] = -(r1x * tx + r1y * ty + r1z * tz);
+    dst->m[14] = -(r2x * tx + r2y * ty + r2z * tz);
+    dst->m[15] = 1.0f;
+
+    return true;
+}
+
 bool Matrix::isIdentity() const
 {
     return (memcmp(m, MATRIX_IDENTITY, MATRIX_SIZE) == 0);
@@ -734,6 +816,13 @@ void Matrix::multiply(const Matrix& m1, const Matrix& m2, Matrix* dst)
     MathUtil::multiplyMatrix(m1.m, m2.m, dst->m);
 }
 
+void Matrix::multiplyAffine(const Matrix& m1, const Matrix& m2, Matrix* dst)
+{
+    GP_ASSERT(dst);
+
+    MathUtil::multiplyAffineMatrix(m1.m, m2.m, dst->m);
+}
+
 void Matrix::negate()
 {
     negate(this);
@@ -934,6 +1023,20 @@ void Matrix::transformVector(const Vector4& vector, Vector4* dst) const
     MathUtil::transformVector4(m, (const float*) &vector, (float*)dst);
 }
 
+void Matrix::transformPoints(const Vector3* points, unsigned int count, Vector3* dst, unsigned int stride, unsigned int dstStride) const
+{
+    GP_ASSERT(count == 0 || (points && dst));
+
+    MathUtil::transformVectors(m, (const float*)points, stride, 1.0f, (float*)dst, dstStride, count);
+}
+
+void Matrix::transformVectors(const Vector3* vectors, unsigned int count, Vector3* dst, unsigned int stride, unsigned int dstStride) const
+{
+    GP_ASSERT(count == 0 || (vectors && dst));
+
+    MathUtil::transformVectors(m, (const float*)vectors, stride, 0.0f, (float*)dst, dstStride, count);
+}
+
 void Matrix::translate(float x, float y, float z)
 {
     translate(x, y, z, this);
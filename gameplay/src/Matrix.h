@@ -41,7 +41,7 @@ class Quaternion;
  *
  * @see Transform
  */
-class Matrix
+class GP_MATH_ALIGN Matrix
 {
 public:
 
@@ -285,6 +285,21 @@ public:
      */
     static void createRotation(const Quaternion& quat, Matrix* dst);
 
+    /**
+     * Creates an affine matrix that scales, then rotates and then translates, which is
+     * the matrix that composes a scale, rotation and translation in TRS order.
+     *
+     * This is equivalent to creating a translation matrix and then rotating and scaling it,
+     * but writes the matrix directly instead of multiplying the three matrices.
+     *
+     * @param translation The translation.
+     * @param rotation The rotation, which must be normalized.
+     * @param scale The scale.
+     * @param dst A matrix to store the result in.
+     * @script{ignore}
+     */
+    static void createTransform(const Vector3& translation, const Quaternion& rotation, const Vector3& scale, Matrix* dst);
+
     /**
      * Creates a rotation matrix from the specified axis and angle.
      *
@@ -480,6 +495,29 @@ public:
      */
     bool invert(Matrix* dst) const;
 
+    /**
+     * Inverts this matrix, which must be affine, i.e. have (0, 0, 0, 1) as its last row,
+     * as the matrices of transforms, nodes and views are.
+     *
+     * This is equivalent to invert, but only inverts the upper 3x3 part and transforms
+     * the translation by it, which is several times fewer operations.
+     *
+     * @return true if the the matrix can be inverted, false otherwise.
+     * @script{ignore}
+     */
+    bool invertAffine();
+
+    /**
+     * Stores the inverse of this matrix, which must be affine, in the specified matrix.
+     *
+     * @param dst A matrix to store the invert of this matrix in.
+     *
+     * @return true if the the matrix can be inverted, false otherwise.
+     * @see invertAffine()
+     * @script{ignore}
+     */
+    bool invertAffine(Matrix* dst) const;
+
     /**
      * Determines if this matrix is equal to the identity matrix.
      *
@@ -527,6 +565,20 @@ public:
      */
     static void multiply(const Matrix& m1, const Matrix& m2, Matrix* dst);
 
+    /**
+     * Multiplies m1 by m2, which must both be affine, i.e. have (0, 0, 0, 1) as their
+     * last row, and stores the result in dst.
+     *
+     * This is equivalent to multiply, but skips the products of the last rows, so it should
+     * be used to compose transforms that have no projection.
+     *
+     * @param m1 The first matrix to multiply.
+     * @param m2 The second matrix to multiply.
+     * @param dst A matrix to store the result in.
+     * @script{ignore}
+     */
+    static void multiplyAffine(const Matrix& m1, const Matrix& m2, Matrix* dst);
+
     /**
      * Negates this matrix.
      */
@@ -810,6 +862,37 @@ public:
      */
     void transformVector(const Vector4& vector, Vector4* dst) const;
 
+    /**
+     * Transforms an array of points by this matrix, and stores the results in dst.
+     *
+     * The points can be members of larger elements, such as the positions of the
+     * vertices of a vertex buffer or of particles, by passing the size of those
+     * elements as the stride.
+     *
+     * @param points The first point to transform.
+     * @param count The number of points to transform.
+     * @param dst The first point to store the results in, which can be points.
+     * @param stride The number of bytes from one point to the next in points.
+     * @param dstStride The number of bytes from one point to the next in dst.
+     * @script{ignore}
+     */
+    void transformPoints(const Vector3* points, unsigned int count, Vector3* dst,
+                         unsigned int stride = sizeof(Vector3), unsigned int dstStride = sizeof(Vector3)) const;
+
+    /**
+     * Transforms an array of vectors by this matrix, by treating the fourth (w)
+     * coordinate as zero, and stores the results in dst.
+     *
+     * @param vectors The first vector to transform.
+     * @param count The number of vectors to transform.
+     * @param dst The first vector to store the results in, which can be vectors.
+     * @param stride The number of bytes from one vector to the next in vectors.
+     * @param dstStride The number of bytes from one vector to the next in dst.
+     * @script{ignore}
+     */
+    void transformVectors(const Vector3* vectors, unsigned int count, Vector3* dst,
+                          unsigned int stride = sizeof(Vector3), unsigned int dstStride = sizeof(Vector3)) const;
+
     /**
      * Post-multiplies this matrix by the matrix corresponding to the
      * specified translation.
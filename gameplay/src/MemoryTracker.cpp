@@ -0,0 +1,178 @@
+#include "Base.h"
+#include "MemoryTracker.h"
+#include "ResourceManager.h"
+#include "Game.h"
+
+namespace gameplay
+{
+
+static const char* __tagNames[MemoryTracker::TAG_COUNT] = { "general", "render", "physics", "script", "audio", "ui" };
+
+// The counters are zero-initialized before any constructor runs, so that allocations
+// made during static initialization can already be tracked.
+static std::atomic<size_t> __usage[MemoryTracker::TAG_COUNT];
+static std::atomic<size_t> __peakUsage[MemoryTracker::TAG_COUNT];
+static std::atomic<unsigned int> __allocationCount[MemoryTracker::TAG_COUNT];
+static std::atomic<size_t> __budget[MemoryTracker::TAG_COUNT];
+static std::atomic<bool> __overBudget[MemoryTracker::TAG_COUNT];
+static thread_local MemoryTracker::Tag __currentTag = MemoryTracker::GENERAL;
+
+MemoryTracker::Scope::Scope(Tag tag)
+    : _previous(__currentTag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    __currentTag = tag;
+}
+
+MemoryTracker::Scope::~Scope()
+{
+    __currentTag = _previous;
+}
+
+MemoryTracker::Tag MemoryTracker::getCurrentTag()
+{
+    return __currentTag;
+}
+
+const char* MemoryTracker::getTagName(Tag tag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    return __tagNames[tag];
+}
+
+size_t MemoryTracker::getUsage(Tag tag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    return __usage[tag].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getPeakUsage(Tag tag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    return __peakUsage[tag].load(std::memory_order_relaxed);
+}
+
+unsigned int MemoryTracker::getAllocationCount(Tag tag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    return __allocationCount[tag].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getTotalUsage()
+{
+    size_t usage = 0;
+    for (unsigned int i = 0; i < TAG_COUNT; ++i)
+        usage += __usage[i].load(std::memory_order_relaxed);
+    return usage;
+}
+
+void MemoryTracker::setBudget(Tag tag, size_t bytes)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    __budget[tag].store(bytes, std::memory_order_relaxed);
+    __overBudget[tag].store(false, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getBudget(Tag tag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    return __budget[tag].load(std::memory_order_relaxed);
+}
+
+bool MemoryTracker::isOverBudget(Tag tag)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    size_t budget = __budget[tag].load(std::memory_order_relaxed);
+    return budget > 0 && __usage[tag].load(std::memory_order_relaxed) > budget;
+}
+
+void MemoryTracker::resetPeakUsage()
+{
+    for (unsigned int i = 0; i < TAG_COUNT; ++i)
+        __peakUsage[i].store(__usage[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void MemoryTracker::print()
+{
+    for (unsigned int i = 0; i < TAG_COUNT; ++i)
+    {
+        Logger::log(Logger::LEVEL_INFO, "Memory %s: %.2f MB in %u allocations, peak: %.2f MB, budget: %.2f MB\n", __tagNames[i],
+            getUsage((Tag)i) / (1024.0 * 1024.0), getAllocationCount((Tag)i), getPeakUsage((Tag)i) / (1024.0 * 1024.0), getBudget((Tag)i) / (1024.0 * 1024.0));
+    }
+    Logger::log(Logger::LEVEL_INFO, "Memory total: %.2f MB\n", getTotalUsage() / (1024.0 * 1024.0));
+}
+
+void MemoryTracker::add(Tag tag, size_t size)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    __allocationCount[tag].fetch_add(1, std::memory_order_relaxed);
+    grow(tag, __usage[tag].fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+void MemoryTracker::remove(Tag tag, size_t size)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    GP_ASSERT(__allocationCount[tag].load(std::memory_order_relaxed) > 0);
+    __allocationCount[tag].fetch_sub(1, std::memory_order_relaxed);
+    __usage[tag].fetch_sub(size, std::memory_order_relaxed);
+}
+
+void MemoryTracker::resize(Tag tag, size_t oldSize, size_t newSize)
+{
+    GP_ASSERT(tag < TAG_COUNT);
+    if (newSize > oldSize)
+        grow(tag, __usage[tag].fetch_add(newSize - oldSize, std::memory_order_relaxed) + newSize - oldSize);
+    else
+        __usage[tag].fetch_sub(oldSize - newSize, std::memory_order_relaxed);
+}
+
+void MemoryTracker::initialize()
+{
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("memoryBudgets", true);
+    if (config)
+    {
+        for (unsigned int i = 0; i < TAG_COUNT; ++i)
+        {
+            if (config->exists(__tagNames[i]))
+                setBudget((Tag)i, (size_t)(std::max(config->getFloat(__tagNames[i]), 0.0f) * 1024.0f * 1024.0f));
+        }
+    }
+}
+
+void MemoryTracker::update()
+{
+    // Only the cached resources that nothing references can be released on behalf of a subsystem.
+    static const Tag tags[] = { RENDER, AUDIO };
+    for (unsigned int i = 0; i < sizeof(tags) / sizeof(tags[0]); ++i)
+    {
+        if (!isOverBudget(tags[i]))
+            continue;
+
+        size_t excess = getUsage(tags[i]) - getBudget(tags[i]);
+        size_t cached = ResourceManager::getMemoryUsage();
+        ResourceManager::trim(cached > excess ? cached - excess : 0);
+    }
+}
+
+void MemoryTracker::grow(Tag tag, size_t usage)
+{
+    size_t peak = __peakUsage[tag].load(std::memory_order_relaxed);
+    while (usage > peak && !__peakUsage[tag].compare_exchange_weak(peak, usage, std::memory_order_relaxed))
+    {
+    }
+
+    // Warn once each time the budget is crossed, rather than for every allocation over it.
+    size_t budget = __budget[tag].load(std::memory_order_relaxed);
+    if (budget == 0)
+        return;
+    if (usage <= budget)
+    {
+        if (__overBudget[tag].load(std::memory_order_relaxed))
+            __overBudget[tag].store(false, std::memory_order_relaxed);
+        return;
+    }
+    if (!__overBudget[tag].exchange(true, std::memory_order_relaxed))
+        GP_WARN("The %s memory of %.2f MB exceeds its budget of %.2f MB.", __tagNames[tag], usage / (1024.0 * 1024.0), budget / (1024.0 * 1024.0));
+}
+
+}
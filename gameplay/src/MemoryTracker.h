@@ -0,0 +1,228 @@
+#ifndef MEMORYTRACKER_H_
+#define MEMORYTRACKER_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines counters for the memory used by each subsystem of the engine, with budgets
+ * that the memory of a subsystem should stay within.
+ *
+ * Each subsystem reports the memory it allocates and releases under its tag: the graphics
+ * memory counted by RenderStats is tracked as render memory, the allocations of Bullet as
+ * physics memory, the allocations of the Lua states as script memory and OpenAL buffers as
+ * audio memory. Every tag keeps a running total, the high-water mark of the total and the
+ * number of live allocations, which are updated with atomic operations and can be queried
+ * at any time from any thread, in release builds as well.
+ *
+ * Memory that a subsystem allocates with the new operator is attributed to the tag of a
+ * MemoryTracker::Scope that is active on the allocating thread. This requires the new
+ * operator to be replaced, so it only happens when GP_USE_MEM_LEAK_DETECTION is defined,
+ * and allocations outside of any scope are counted as general memory.
+ *
+ * The budgets can be set with the 'memoryBudgets' namespace of the game configuration
+ * file, which has an entry in megabytes for each tag that has a budget, such as
+ * 'render = 192'. A warning is logged whenever the memory of a tag grows past its budget.
+ * At the end of every frame in which the render or audio memory is over budget, the
+ * unreferenced resources cached by the ResourceManager are evicted to make up for it.
+ *
+ * @script{ignore}
+ */
+class MemoryTracker
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines the subsystems whose memory is tracked.
+     */
+    enum Tag
+    {
+        GENERAL,
+        RENDER,
+        PHYSICS,
+        SCRIPT,
+        AUDIO,
+        UI,
+        TAG_COUNT
+    };
+
+    /**
+     * Attributes the memory allocated with the new operator on the current thread to a
+     * tag for as long as the scope exists.
+     */
+    class Scope
+    {
+    public:
+
+        /**
+         * Constructor.
+         *
+         * @param tag The tag to attribute allocations to.
+         */
+        Scope(Tag tag);
+
+        /**
+         * Destructor. Restores the tag that was active before the scope.
+         */
+        ~Scope();
+
+    private:
+
+        /**
+         * Hidden copy constructor.
+         */
+        Scope(const Scope&);
+
+        /**
+         * Hidden copy assignment operator.
+         */
+        Scope& operator=(const Scope&);
+
+        Tag _previous;
+    };
+
+    /**
+     * Returns the tag of the innermost scope that is active on the current thread.
+     *
+     * @return The current tag, which is GENERAL outside of any scope.
+     */
+    static Tag getCurrentTag();
+
+    /**
+     * Returns the name of a tag, as used in the game configuration.
+     *
+     * @param tag The tag.
+     *
+     * @return The name of the tag, such as "render".
+     */
+    static const char* getTagName(Tag tag);
+
+    /**
+     * Returns the number of bytes currently used by a tag.
+     *
+     * @param tag The tag.
+     *
+     * @return The memory in use in bytes.
+     */
+    static size_t getUsage(Tag tag);
+
+    /**
+     * Returns the largest number of bytes that a tag has used at once.
+     *
+     * @param tag The tag.
+     *
+     * @return The high-water mark in bytes.
+     */
+    static size_t getPeakUsage(Tag tag);
+
+    /**
+     * Returns the number of live allocations of a tag.
+     *
+     * @param tag The tag.
+     *
+     * @return The number of allocations that have not been released.
+     */
+    static unsigned int getAllocationCount(Tag tag);
+
+    /**
+     * Returns the number of bytes currently used by all tags.
+     *
+     * @return The total memory in use in bytes.
+     */
+    static size_t getTotalUsage();
+
+    /**
+     * Sets the number of bytes that a tag should use at most.
+     *
+     * @param tag The tag.
+     * @param bytes The budget in bytes, or zero for no budget.
+     */
+    static void setBudget(Tag tag, size_t bytes);
+
+    /**
+     * Returns the budget of a tag.
+     *
+     * @param tag The tag.
+     *
+     * @return The budget in bytes, or zero if the tag has no budget.
+     */
+    static size_t getBudget(Tag tag);
+
+    /**
+     * Determines whether a tag uses more memory than its budget.
+     *
+     * @param tag The tag.
+     *
+     * @return true if the tag has a budget and is over it.
+     */
+    static bool isOverBudget(Tag tag);
+
+    /**
+     * Resets the high-water marks of all tags to their current usage.
+     */
+    static void resetPeakUsage();
+
+    /**
+     * Prints the usage, high-water mark and budget of every tag to the log.
+     */
+    static void print();
+
+    /**
+     * Records that memory was allocated.
+     *
+     * @param tag The tag of the subsystem that allocated it.
+     * @param size The allocated size in bytes.
+     * @script{ignore}
+     */
+    static void add(Tag tag, size_t size);
+
+    /**
+     * Records that memory was released.
+     *
+     * @param tag The tag the memory was added to.
+     * @param size The released size in bytes.
+     * @script{ignore}
+     */
+    static void remove(Tag tag, size_t size);
+
+    /**
+     * Records that an allocation changed its size, such as when it is reallocated.
+     *
+     * @param tag The tag the memory was added to.
+     * @param oldSize The previous size in bytes.
+     * @param newSize The new size in bytes.
+     * @script{ignore}
+     */
+    static void resize(Tag tag, size_t oldSize, size_t newSize);
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    MemoryTracker();
+
+    /**
+     * Sets the budgets from the 'memoryBudgets' namespace of the game configuration.
+     * Called by the game during startup.
+     */
+    static void initialize();
+
+    /**
+     * Evicts cached resources while the render or audio memory is over budget. Called by
+     * the game at the end of every frame.
+     */
+    static void update();
+
+    /**
+     * Raises the high-water mark of a tag to the given usage and warns when the usage
+     * grows past the budget of the tag.
+     */
+    static void grow(Tag tag, size_t usage);
+};
+
+}
+
+#endif
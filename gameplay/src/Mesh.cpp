@@ -1,21 +1,29 @@
 #include "Base.h"
 #include "Mesh.h"
+#include "RenderStats.h"
+#include "MeshBuffer.h"
 #include "MeshPart.h"
+#include "MeshBVH.h"
+#include "Bundle.h"
 #include "Effect.h"
 #include "Model.h"
 #include "Material.h"
+#include "Game.h"
 
 namespace gameplay
 {
 
 Mesh::Mesh(const VertexFormat& vertexFormat) 
-    : _vertexFormat(vertexFormat), _vertexCount(0), _vertexBuffer(0), _primitiveType(TRIANGLES), 
-      _partCount(0), _parts(NULL), _dynamic(false)
+    : _vertexFormat(vertexFormat), _vertexCount(0), _vertexBuffer(0), _vertexOffset(0), _sharedBuffer(false), _primitiveType(TRIANGLES), 
+      _partCount(0), _parts(NULL), _dynamic(false), _bvh(NULL), _bvhLoaded(false),
+      _vertexBuffers(NULL), _bufferCount(1), _bufferIndex(0), _bufferFrameIndex(0), _vertexData(NULL)
 {
 }
 
 Mesh::~Mesh()
 {
+    SAFE_DELETE(_bvh);
+
     if (_parts)
     {
         for (unsigned int i = 0; i < _partCount; ++i)
@@ -25,24 +33,40 @@ Mesh::~Mesh()
         SAFE_DELETE_ARRAY(_parts);
     }
 
+    // Leaves only the current vertex buffer of the ring to delete.
+    setBufferCount(1);
+
     if (_vertexBuffer)
     {
-        glDeleteBuffers(1, &_vertexBuffer);
+        RenderStats::removeMemory(RenderStats::VERTEX_BUFFER_MEMORY, _vertexFormat.getVertexSize() * _vertexCount, this);
+        if (_sharedBuffer)
+            MeshBuffer::release(_vertexBuffer, _vertexOffset, _vertexFormat.getVertexSize() * _vertexCount);
+        else
+            glDeleteBuffers(1, &_vertexBuffer);
         _vertexBuffer = 0;
     }
 }
 
 Mesh* Mesh::createMesh(const VertexFormat& vertexFormat, unsigned int vertexCount, bool dynamic)
 {
+    // Static meshes take their vertices from a buffer shared with other meshes.
     GLuint vbo;
-    GL_ASSERT( glGenBuffers(1, &vbo) );
-    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, vbo) );
-    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, vertexFormat.getVertexSize() * vertexCount, NULL, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW) );
+    unsigned int offset = 0;
+    bool shared = !dynamic && MeshBuffer::allocateVertices(vertexFormat, vertexCount, &vbo, &offset);
+    if (!shared)
+    {
+        GL_ASSERT( glGenBuffers(1, &vbo) );
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, vbo) );
+        GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, vertexFormat.getVertexSize() * vertexCount, NULL, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW) );
+    }
 
     Mesh* mesh = new Mesh(vertexFormat);
     mesh->_vertexCount = vertexCount;
     mesh->_vertexBuffer = vbo;
+    mesh->_vertexOffset = offset;
+    mesh->_sharedBuffer = shared;
     mesh->_dynamic = dynamic;
+    RenderStats::addMemory(RenderStats::VERTEX_BUFFER_MEMORY, vertexFormat.getVertexSize() * vertexCount, mesh);
 
     return mesh;
 }
@@ -226,6 +250,109 @@ const char* Mesh::getUrl() const
     return _url.c_str();
 }
 
+/**
+ * Appends the triangles of a list or strip of vertex indices.
+ */
+static void addTriangles(Mesh::PrimitiveType primitiveType, const unsigned int* indices, unsigned int indexCount, unsigned int part,
+                         std::vector<unsigned int>& triangles, std::vector<unsigned int>& parts)
+{
+    if (primitiveType == Mesh::TRIANGLES)
+    {
+        for (unsigned int i = 0; i + 2 < indexCount; i += 3)
+        {
+            triangles.insert(triangles.end(), indices + i, indices + i + 3);
+            parts.push_back(part);
+        }
+    }
+    else if (primitiveType == Mesh::TRIANGLE_STRIP)
+    {
+        for (unsigned int i = 0; i + 2 < indexCount; ++i)
+        {
+            // Every other triangle of a strip is wound the other way, and degenerate ones join strips.
+            unsigned int a = indices[i];
+            unsigned int b = indices[i + ((i & 1) ? 2 : 1)];
+            unsigned int c = indices[i + ((i & 1) ? 1 : 2)];
+            if (a == b || b == c || a == c)
+                continue;
+            triangles.push_back(a);
+            triangles.push_back(b);
+            triangles.push_back(c);
+            parts.push_back(part);
+        }
+    }
+}
+
+const MeshBVH* Mesh::getBVH() const
+{
+    if (_bvh || _bvhLoaded || _url.empty())
+        return _bvh;
+    _bvhLoaded = true;
+
+    Bundle::MeshData* data = Bundle::readMeshData(_url.c_str());
+    if (data == NULL)
+        return NULL;
+
+    // Positions can be stored as half floats or integers, so they are converted to floats.
+    std::vector<float> positions(data->vertexCount * 3);
+    unsigned int vertexStride = data->vertexFormat.getVertexSize();
+    const VertexFormat::Element& position = data->vertexFormat.getElement(0);
+    GP_ASSERT(position.usage == VertexFormat::POSITION && position.size >= 3);
+    for (unsigned int i = 0; i < data->vertexCount; ++i)
+    {
+        float p[4];
+        position.read(&data->vertexData[i * vertexStride], p);
+        memcpy(&positions[i * 3], p, sizeof(float) * 3);
+    }
+
+    std::vector<unsigned int> triangles;
+    std::vector<unsigned int> parts;
+    std::vector<unsigned int> indices;
+    if (data->parts.empty())
+    {
+        indices.resize(data->vertexCount);
+        for (unsigned int i = 0; i < data->vertexCount; ++i)
+            indices[i] = i;
+        addTriangles(data->primitiveType, indices.empty() ? NULL : &indices[0], (unsigned int)indices.size(), 0, triangles, parts);
+    }
+    for (size_t i = 0; i < data->parts.size(); ++i)
+    {
+        const Bundle::MeshPartData* part = data->parts[i];
+        indices.resize(part->indexCount);
+        for (unsigned int j = 0; j < part->indexCount; ++j)
+        {
+            switch (part->indexFormat)
+            {
+            case INDEX8:
+                indices[j] = ((const unsigned char*)part->indexData)[j];
+                break;
+            case INDEX16:
+                indices[j] = ((const unsigned short*)part->indexData)[j];
+                break;
+            default:
+                indices[j] = ((const unsigned int*)part->indexData)[j];
+                break;
+            }
+        }
+        if (!indices.empty())
+            addTriangles(part->primitiveType, &indices[0], (unsigned int)indices.size(), (unsigned int)i, triangles, parts);
+    }
+
+    if (!triangles.empty() && !positions.empty())
+        _bvh = MeshBVH::create(&positions[0], data->vertexCount, &triangles[0], (unsigned int)parts.size(), &parts[0]);
+    SAFE_DELETE(data);
+    return _bvh;
+}
+
+void Mesh::setBVH(MeshBVH* bvh)
+{
+    if (_bvh != bvh)
+    {
+        SAFE_DELETE(_bvh);
+        _bvh = bvh;
+    }
+    _bvhLoaded = true;
+}
+
 const VertexFormat& Mesh::getVertexFormat() const
 {
     return _vertexFormat;
@@ -246,6 +373,11 @@ VertexBufferHandle Mesh::getVertexBuffer() const
     return _vertexBuffer;
 }
 
+unsigned int Mesh::getVertexOffset() const
+{
+    return _vertexOffset;
+}
+
 bool Mesh::isDynamic() const
 {
     return _dynamic;
@@ -263,21 +395,65 @@ void Mesh::setPrimitiveType(PrimitiveType type)
 
 void* Mesh::mapVertexBuffer()
 {
+    // Meshes with a ring of buffers are written in memory and uploaded when unmapped.
+    if (_vertexBuffers)
+        return _vertexData;
+
     GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
 
-    return (void*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+    // A shared buffer is mapped whole, and the vertices of the mesh start at its offset.
+    unsigned char* data = (unsigned char*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+    return data ? (void*)(data + _vertexOffset) : NULL;
 }
 
 bool Mesh::unmapVertexBuffer()
 {
+    if (_vertexBuffers)
+    {
+        // The whole copy is uploaded, since it isn't known which vertices were written.
+        nextBuffer();
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
+        GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, 0, _vertexFormat.getVertexSize() * _vertexCount, _vertexData) );
+        return true;
+    }
+
     return glUnmapBuffer(GL_ARRAY_BUFFER);
 }
 
 void Mesh::setVertexData(const void* vertexData, unsigned int vertexStart, unsigned int vertexCount)
 {
+    if (_vertexBuffers)
+    {
+        // The buffers of a ring are never orphaned. Vertices are written into the copy in
+        // memory, which is uploaded whole when the mesh moves to the next buffer.
+        if (vertexData == NULL)
+            return;
+
+        unsigned int vertexSize = _vertexFormat.getVertexSize();
+        if (vertexCount == 0)
+        {
+            vertexCount = _vertexCount - vertexStart;
+        }
+        GP_ASSERT(vertexStart + vertexCount <= _vertexCount);
+        memcpy(_vertexData + vertexStart * vertexSize, vertexData, vertexCount * vertexSize);
+
+        if (nextBuffer())
+        {
+            vertexStart = 0;
+            vertexCount = _vertexCount;
+        }
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
+        GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, vertexStart * vertexSize, vertexCount * vertexSize, _vertexData + vertexStart * vertexSize) );
+        return;
+    }
+
+    // The range of a shared buffer can't be orphaned, and keeps its data.
+    if (_sharedBuffer && vertexData == NULL)
+        return;
+
     GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffer) );
 
-    if (vertexStart == 0 && vertexCount == 0)
+    if (vertexStart == 0 && vertexCount == 0 && !_sharedBuffer)
     {
         GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, _vertexFormat.getVertexSize() * _vertexCount, vertexData, _dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW) );
     }
@@ -288,10 +464,79 @@ void Mesh::setVertexData(const void* vertexData, unsigned int vertexStart, unsig
             vertexCount = _vertexCount - vertexStart;
         }
 
-        GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, vertexStart * _vertexFormat.getVertexSize(), vertexCount * _vertexFormat.getVertexSize(), vertexData) );
+        GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, _vertexOffset + vertexStart * _vertexFormat.getVertexSize(), vertexCount * _vertexFormat.getVertexSize(), vertexData) );
     }
 }
 
+void Mesh::setBufferCount(unsigned int count)
+{
+    GP_ASSERT(count > 0);
+
+    if (count == _bufferCount)
+        return;
+    if (!_dynamic)
+    {
+        GP_WARN("Static mesh '%s' can't have more than one vertex buffer.", _url.c_str());
+        return;
+    }
+
+    // Delete the ring, keeping the current buffer as the single one.
+    unsigned int size = _vertexFormat.getVertexSize() * _vertexCount;
+    if (_vertexBuffers)
+    {
+        RenderStats::removeMemory(RenderStats::VERTEX_BUFFER_MEMORY, size * (_bufferCount - 1), _vertexBuffers);
+        for (unsigned int i = 0; i < _bufferCount; ++i)
+        {
+            if (_vertexBuffers[i] != _vertexBuffer)
+                GL_ASSERT( glDeleteBuffers(1, &_vertexBuffers[i]) );
+        }
+        SAFE_DELETE_ARRAY(_vertexBuffers);
+    }
+    _bufferCount = 1;
+    _bufferIndex = 0;
+    if (count == 1)
+    {
+        SAFE_DELETE_ARRAY(_vertexData);
+        return;
+    }
+
+    _vertexBuffers = new VertexBufferHandle[count];
+    _vertexBuffers[0] = _vertexBuffer;
+    for (unsigned int i = 1; i < count; ++i)
+    {
+        GL_ASSERT( glGenBuffers(1, &_vertexBuffers[i]) );
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _vertexBuffers[i]) );
+        GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_DYNAMIC_DRAW) );
+    }
+    RenderStats::addMemory(RenderStats::VERTEX_BUFFER_MEMORY, size * (count - 1), _vertexBuffers, _url.empty() ? NULL : _url.c_str());
+    _bufferCount = count;
+    _bufferFrameIndex = Game::getInstance()->getFrameIndex();
+
+    if (_vertexData == NULL)
+    {
+        _vertexData = new unsigned char[size];
+        memset(_vertexData, 0, size);
+    }
+}
+
+unsigned int Mesh::getBufferCount() const
+{
+    return _bufferCount;
+}
+
+bool Mesh::nextBuffer()
+{
+    unsigned int frameIndex = Game::getInstance()->getFrameIndex();
+    if (frameIndex == _bufferFrameIndex)
+        return false;
+
+    // The GPU finished drawing from the next buffer of the ring frames ago.
+    _bufferFrameIndex = frameIndex;
+    _bufferIndex = (_bufferIndex + 1) % _bufferCount;
+    _vertexBuffer = _vertexBuffers[_bufferIndex];
+    return true;
+}
+
 MeshPart* Mesh::addPart(PrimitiveType primitiveType, IndexFormat indexFormat, unsigned int indexCount, bool dynamic)
 {
     MeshPart* part = MeshPart::create(this, _partCount, primitiveType, indexFormat, indexCount, dynamic);
@@ -315,6 +560,66 @@ MeshPart* Mesh::addPart(PrimitiveType primitiveType, IndexFormat indexFormat, un
     return part;
 }
 
+MeshPart* Mesh::addPart(PrimitiveType primitiveType, const unsigned int* indices, unsigned int indexCount, bool dynamic)
+{
+    GP_ASSERT(indices || indexCount == 0);
+
+    IndexFormat indexFormat = getIndexFormat(_vertexCount);
+    if (indexFormat == INDEX32 && !isIndex32Supported())
+    {
+        GP_WARN("Mesh with %u vertices needs 32-bit indices, which the device does not support.", _vertexCount);
+        return NULL;
+    }
+
+    MeshPart* part = addPart(primitiveType, indexFormat, indexCount, dynamic);
+    if (part && indexCount > 0)
+    {
+        switch (indexFormat)
+        {
+        case INDEX8:
+            {
+                std::vector<unsigned char> data(indices, indices + indexCount);
+                part->setIndexData(&data[0], 0, 0);
+            }
+            break;
+        case INDEX16:
+            {
+                std::vector<unsigned short> data(indices, indices + indexCount);
+                part->setIndexData(&data[0], 0, 0);
+            }
+            break;
+        default:
+            part->setIndexData(indices, 0, 0);
+            break;
+        }
+    }
+    return part;
+}
+
+Mesh::IndexFormat Mesh::getIndexFormat(unsigned int vertexCount)
+{
+    if (vertexCount <= 256)
+        return INDEX8;
+    if (vertexCount <= 65536)
+        return INDEX16;
+    return INDEX32;
+}
+
+bool Mesh::isIndex32Supported()
+{
+#if defined(OPENGL_ES) && !defined(GL_ES_VERSION_3_0)
+    static int __index32Supported = -1;
+    if (__index32Supported == -1)
+    {
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        __index32Supported = (extensions && strstr(extensions, "GL_OES_element_index_uint")) ? 1 : 0;
+    }
+    return __index32Supported == 1;
+#else
+    return true;
+#endif
+}
+
 unsigned int Mesh::getPartCount() const
 {
     return _partCount;
@@ -13,6 +13,7 @@ namespace gameplay
 class MeshPart;
 class Material;
 class Model;
+class MeshBVH;
 
 /**
  * Defines a mesh supporting various vertex formats and 1 or more
@@ -170,6 +171,19 @@ public:
      */
     VertexBufferHandle getVertexBuffer() const;
 
+    /**
+     * Returns the offset of the first vertex of the mesh in its vertex buffer.
+     *
+     * Static meshes share their vertex buffer with other meshes of the same vertex format,
+     * so their vertices may start anywhere in it. The offset is always a whole number of
+     * vertices.
+     *
+     * @return The offset in bytes.
+     * @see MeshBuffer
+     * @script{ignore}
+     */
+    unsigned int getVertexOffset() const;
+
     /**
      * Determines if the mesh is dynamic.
      *
@@ -221,7 +235,11 @@ public:
      * vertex buffer become corrupted while the buffer was mapped. The corruption results from screen
      * resolution change or window system specific events. In this case, the data must be resubmitted.
      *
+     * Meshes with more than one vertex buffer return a copy of their vertices in memory
+     * instead, which unmapVertexBuffer uploads to the buffer of the current frame.
+     *
      * @return The mapped vertex buffer
+     * @see setBufferCount
      */
     void* mapVertexBuffer();
 
@@ -241,6 +259,35 @@ public:
      */
     void setVertexData(const void* vertexData, unsigned int vertexStart = 0, unsigned int vertexCount = 0);
 
+    /**
+     * Sets the number of vertex buffers that a dynamic mesh rotates through.
+     *
+     * A dynamic mesh with a single vertex buffer writes over the vertices that the GPU may
+     * still be drawing from the previous frame, which makes the driver wait for the GPU or
+     * copy the buffer. With more than one buffer, the first update of the vertices in a frame
+     * moves to the next buffer of the ring, which the GPU finished drawing from frames ago,
+     * so that meshes updated every frame, such as procedural geometry, cloth or trails, never
+     * wait. Such meshes keep a copy of their vertices in memory, so that updates of a part of
+     * the vertices upload the whole copy when they move to the next buffer.
+     *
+     * The contents of the buffers that are added are undefined, so the number of buffers
+     * should be set before the vertices are first set. Static meshes always have a single
+     * vertex buffer.
+     *
+     * @param count The number of vertex buffers, 1 to go back to a single buffer.
+     * @script{ignore}
+     */
+    void setBufferCount(unsigned int count);
+
+    /**
+     * Returns the number of vertex buffers that the mesh rotates through.
+     *
+     * @return The number of vertex buffers.
+     * @see setBufferCount
+     * @script{ignore}
+     */
+    unsigned int getBufferCount() const;
+
     /**
      * Creates and adds a new part of primitive data defining how the vertices are connected.
      *
@@ -253,6 +300,40 @@ public:
      */
     MeshPart* addPart(PrimitiveType primitiveType, Mesh::IndexFormat indexFormat, unsigned int indexCount, bool dynamic = false);
 
+    /**
+     * Creates and adds a new part of primitive data, storing the given indices in the smallest
+     * index format that can address every vertex of this mesh.
+     *
+     * @param primitiveType The type of primitive data to connect the indices as.
+     * @param indices The indices of the part.
+     * @param indexCount The number of indices.
+     * @param dynamic true if the index data is dynamic; false otherwise.
+     *
+     * @return The newly created/added mesh part, or NULL if the mesh needs 32-bit indices
+     *      and the device does not support them.
+     * @script{ignore}
+     */
+    MeshPart* addPart(PrimitiveType primitiveType, const unsigned int* indices, unsigned int indexCount, bool dynamic = false);
+
+    /**
+     * Returns the smallest index format that can address the given number of vertices.
+     *
+     * @param vertexCount The number of vertices.
+     *
+     * @return INDEX8 for up to 256 vertices, INDEX16 for up to 65536 and INDEX32 otherwise.
+     * @script{ignore}
+     */
+    static IndexFormat getIndexFormat(unsigned int vertexCount);
+
+    /**
+     * Determines whether the device can draw with 32-bit indices. They are always
+     * supported on desktop OpenGL, and on OpenGL ES with GL_OES_element_index_uint.
+     *
+     * @return True if INDEX32 is supported, false otherwise.
+     * @script{ignore}
+     */
+    static bool isIndex32Supported();
+
     /**
      * Gets the number of mesh parts contained within the mesh.
      *
@@ -327,6 +408,28 @@ public:
      */
     void setBoundingSphere(const BoundingSphere& sphere);
 
+    /**
+     * Returns the bounding volume hierarchy of the triangles of this mesh, for ray picking.
+     *
+     * Meshes loaded from a bundle build it the first time it is requested, from the vertex
+     * and index data of the bundle, so that no copy of the data is kept for meshes that are
+     * never picked. Skinned meshes are in their bind pose.
+     *
+     * @return The hierarchy, or NULL if the mesh has no triangles or was not loaded from a
+     *      bundle and was not given one.
+     * @script{ignore}
+     */
+    const MeshBVH* getBVH() const;
+
+    /**
+     * Sets the bounding volume hierarchy of the triangles of this mesh, such as one created
+     * from the data of a mesh that was not loaded from a bundle.
+     *
+     * @param bvh The hierarchy, which the mesh takes ownership of, or NULL.
+     * @script{ignore}
+     */
+    void setBVH(MeshBVH* bvh);
+
     /**
      * Destructor.
      */
@@ -349,16 +452,32 @@ private:
      */
     Mesh& operator=(const Mesh&);
 
+    /**
+     * Moves to the next vertex buffer of the ring once the game has moved to a new frame.
+     *
+     * @return true if the mesh moved to another buffer, whose data must then be uploaded whole.
+     */
+    bool nextBuffer();
+
     std::string _url;
     const VertexFormat _vertexFormat;
     unsigned int _vertexCount;
     VertexBufferHandle _vertexBuffer;
+    unsigned int _vertexOffset;
+    bool _sharedBuffer;
     PrimitiveType _primitiveType;
     unsigned int _partCount;
     MeshPart** _parts;
     bool _dynamic;
     BoundingBox _boundingBox;
     BoundingSphere _boundingSphere;
+    mutable MeshBVH* _bvh;
+    mutable bool _bvhLoaded;
+    VertexBufferHandle* _vertexBuffers;
+    unsigned int _bufferCount;
+    unsigned int _bufferIndex;
+    unsigned int _bufferFrameIndex;
+    unsigned char* _vertexData;
 };
 
 }
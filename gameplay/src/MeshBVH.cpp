@@ -0,0 +1,253 @@
+#include "Base.h"
+#include "MeshBVH.h"
+
+// The number of triangles below which a node is not split.
+#define MESH_BVH_LEAF_SIZE 4
+
+// The depth of the traversal stack, which median splits never come close to.
+#define MESH_BVH_STACK_SIZE 64
+
+namespace gameplay
+{
+
+MeshBVH::MeshBVH()
+{
+}
+
+MeshBVH::~MeshBVH()
+{
+}
+
+MeshBVH* MeshBVH::create(const float* positions, unsigned int vertexCount, const unsigned int* indices, unsigned int triangleCount, const unsigned int* parts)
+{
+    GP_ASSERT(positions || vertexCount == 0);
+    GP_ASSERT(indices || triangleCount == 0);
+
+    if (vertexCount == 0 || triangleCount == 0)
+        return NULL;
+
+    MeshBVH* bvh = new MeshBVH();
+    bvh->_positions.assign(positions, positions + vertexCount * 3);
+    bvh->_indices.assign(indices, indices + triangleCount * 3);
+    if (parts)
+        bvh->_parts.assign(parts, parts + triangleCount);
+
+    // Triangles that refer to missing vertices are left out.
+    std::vector<Vector3> centers(triangleCount);
+    bvh->_triangles.reserve(triangleCount);
+    for (unsigned int i = 0; i < triangleCount; ++i)
+    {
+        const unsigned int* t = &indices[i * 3];
+        if (t[0] >= vertexCount || t[1] >= vertexCount || t[2] >= vertexCount)
+            continue;
+
+        const float* a = &positions[t[0] * 3];
+        const float* b = &positions[t[1] * 3];
+        const float* c = &positions[t[2] * 3];
+        centers[i].set((a[0] + b[0] + c[0]) / 3.0f, (a[1] + b[1] + c[1]) / 3.0f, (a[2] + b[2] + c[2]) / 3.0f);
+        bvh->_triangles.push_back(i);
+    }
+    if (bvh->_triangles.empty())
+    {
+        SAFE_DELETE(bvh);
+        return NULL;
+    }
+
+    bvh->_nodes.reserve(bvh->_triangles.size() / MESH_BVH_LEAF_SIZE * 2 + 1);
+    bvh->_nodes.push_back(Node());
+    bvh->build(0, 0, (unsigned int)bvh->_triangles.size(), centers);
+
+    const Node& root = bvh->_nodes[0];
+    bvh->_bounds.set(Vector3(root.min[0], root.min[1], root.min[2]), Vector3(root.max[0], root.max[1], root.max[2]));
+    return bvh;
+}
+
+void MeshBVH::build(unsigned int node, unsigned int begin, unsigned int end, std::vector<Vector3>& centers)
+{
+    Vector3 boundsMin(FLT_MAX, FLT_MAX, FLT_MAX);
+    Vector3 boundsMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    Vector3 centerMin(boundsMin);
+    Vector3 centerMax(boundsMax);
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        unsigned int triangle = _triangles[i];
+        for (unsigned int j = 0; j < 3; ++j)
+        {
+            const float* p = &_positions[_indices[triangle * 3 + j] * 3];
+            boundsMin.set(std::min(boundsMin.x, p[0]), std::min(boundsMin.y, p[1]), std::min(boundsMin.z, p[2]));
+            boundsMax.set(std::max(boundsMax.x, p[0]), std::max(boundsMax.y, p[1]), std::max(boundsMax.z, p[2]));
+        }
+        const Vector3& c = centers[triangle];
+        centerMin.set(std::min(centerMin.x, c.x), std::min(centerMin.y, c.y), std::min(centerMin.z, c.z));
+        centerMax.set(std::max(centerMax.x, c.x), std::max(centerMax.y, c.y), std::max(centerMax.z, c.z));
+    }
+
+    Node& n = _nodes[node];
+    n.min[0] = boundsMin.x;
+    n.min[1] = boundsMin.y;
+    n.min[2] = boundsMin.z;
+    n.max[0] = boundsMax.x;
+    n.max[1] = boundsMax.y;
+    n.max[2] = boundsMax.z;
+
+    // Split along the longest axis of the centers, unless they all coincide.
+    Vector3 extent = centerMax - centerMin;
+    int axis = extent.x >= extent.y ? (extent.x >= extent.z ? 0 : 2) : (extent.y >= extent.z ? 1 : 2);
+    float axisExtent = axis == 0 ? extent.x : (axis == 1 ? extent.y : extent.z);
+    if (end - begin <= MESH_BVH_LEAF_SIZE || axisExtent <= 0.0f)
+    {
+        n.index = begin;
+        n.count = end - begin;
+        return;
+    }
+
+    unsigned int middle = begin + (end - begin) / 2;
+    std::nth_element(_triangles.begin() + begin, _triangles.begin() + middle, _triangles.begin() + end,
+        [&centers, axis](unsigned int a, unsigned int b)
+        {
+            const Vector3& ca = centers[a];
+            const Vector3& cb = centers[b];
+            return (axis == 0 ? ca.x < cb.x : (axis == 1 ? ca.y < cb.y : ca.z < cb.z));
+        });
+    n.count = 0;
+
+    // The first child follows its parent, and the parent refers to the second.
+    unsigned int first = (unsigned int)_nodes.size();
+    _nodes.push_back(Node());
+    build(first, begin, middle, centers);
+    unsigned int second = (unsigned int)_nodes.size();
+    _nodes.push_back(Node());
+    _nodes[node].index = second;
+    build(second, middle, end, centers);
+}
+
+/**
+ * Returns the distance along a ray at which it enters a box, or a negative value if it misses it.
+ */
+static float intersectBox(const float* min, const float* max, const float* origin, const float* inverse, float maxDistance)
+{
+    float tmin = 0.0f;
+    float tmax = maxDistance;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        float t1 = (min[i] - origin[i]) * inverse[i];
+        float t2 = (max[i] - origin[i]) * inverse[i];
+        if (t1 > t2)
+            std::swap(t1, t2);
+        tmin = std::max(tmin, t1);
+        tmax = std::min(tmax, t2);
+        if (tmin > tmax)
+            return -1.0f;
+    }
+    return tmin;
+}
+
+bool MeshBVH::intersects(const Ray& ray, Hit* hit, float maxDistance) const
+{
+    GP_ASSERT(hit);
+
+    const Vector3& o = ray.getOrigin();
+    const Vector3& d = ray.getDirection();
+    const float origin[3] = { o.x, o.y, o.z };
+    const float inverse[3] = { 1.0f / d.x, 1.0f / d.y, 1.0f / d.z };
+
+    float closest = maxDistance;
+    unsigned int closestTriangle = 0;
+    float closestNormal[3] = { 0.0f, 0.0f, 0.0f };
+    bool found = false;
+
+    unsigned int stack[MESH_BVH_STACK_SIZE];
+    unsigned int depth = 0;
+    if (intersectBox(_nodes[0].min, _nodes[0].max, origin, inverse, closest) >= 0.0f)
+        stack[depth++] = 0;
+
+    while (depth > 0)
+    {
+        const Node& node = _nodes[stack[--depth]];
+        if (node.count == 0)
+        {
+            // Visit the nearer child first, so that its hits cull the other one.
+            unsigned int first = (unsigned int)(&node - &_nodes[0]) + 1;
+            unsigned int second = node.index;
+            float t1 = intersectBox(_nodes[first].min, _nodes[first].max, origin, inverse, closest);
+            float t2 = intersectBox(_nodes[second].min, _nodes[second].max, origin, inverse, closest);
+            if (t1 >= 0.0f && t2 >= 0.0f && t2 < t1)
+            {
+                std::swap(first, second);
+                std::swap(t1, t2);
+            }
+            if (t2 >= 0.0f && depth < MESH_BVH_STACK_SIZE)
+                stack[depth++] = second;
+            if (t1 >= 0.0f && depth < MESH_BVH_STACK_SIZE)
+                stack[depth++] = first;
+            continue;
+        }
+
+        for (unsigned int i = node.index, end = node.index + node.count; i < end; ++i)
+        {
+            // Moller-Trumbore, for both faces of the triangle.
+            unsigned int triangle = _triangles[i];
+            const float* a = &_positions[_indices[triangle * 3] * 3];
+            const float* b = &_positions[_indices[triangle * 3 + 1] * 3];
+            const float* c = &_positions[_indices[triangle * 3 + 2] * 3];
+            float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+            float e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+            float p[3] = { d.y * e2[2] - d.z * e2[1], d.z * e2[0] - d.x * e2[2], d.x * e2[1] - d.y * e2[0] };
+            float determinant = e1[0] * p[0] + e1[1] * p[1] + e1[2] * p[2];
+            if (fabs(determinant) < 1e-12f)
+                continue;
+
+            float inverseDeterminant = 1.0f / determinant;
+            float s[3] = { origin[0] - a[0], origin[1] - a[1], origin[2] - a[2] };
+            float u = (s[0] * p[0] + s[1] * p[1] + s[2] * p[2]) * inverseDeterminant;
+            if (u < 0.0f || u > 1.0f)
+                continue;
+
+            float q[3] = { s[1] * e1[2] - s[2] * e1[1], s[2] * e1[0] - s[0] * e1[2], s[0] * e1[1] - s[1] * e1[0] };
+            float v = (d.x * q[0] + d.y * q[1] + d.z * q[2]) * inverseDeterminant;
+            if (v < 0.0f || u + v > 1.0f)
+                continue;
+
+            float t = (e2[0] * q[0] + e2[1] * q[1] + e2[2] * q[2]) * inverseDeterminant;
+            if (t < 0.0f || t >= closest)
+                continue;
+
+            closest = t;
+            closestTriangle = triangle;
+            closestNormal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+            closestNormal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+            closestNormal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+            found = true;
+        }
+    }
+
+    if (!found)
+        return false;
+
+    hit->distance = closest;
+    hit->point = o + d * closest;
+    hit->normal.set(closestNormal[0], closestNormal[1], closestNormal[2]);
+    hit->normal.normalize();
+    if (Vector3::dot(hit->normal, d) > 0.0f)
+        hit->normal.negate();
+    hit->triangle = closestTriangle;
+    hit->part = _parts.empty() ? 0 : _parts[closestTriangle];
+    return true;
+}
+
+const BoundingBox& MeshBVH::getBounds() const
+{
+    return _bounds;
+}
+
+unsigned int MeshBVH::getTriangleCount() const
+{
+    return (unsigned int)_triangles.size();
+}
+
+unsigned int MeshBVH::getNodeCount() const
+{
+    return (unsigned int)_nodes.size();
+}
+
+}
@@ -0,0 +1,155 @@
+#ifndef MESHBVH_H_
+#define MESHBVH_H_
+
+#include "Vector3.h"
+#include "BoundingBox.h"
+#include "Ray.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a bounding volume hierarchy of the triangles of a mesh, for exact ray picking.
+ *
+ * The triangles are split recursively in two halves along the longest axis of the bounds
+ * of their centers, until a leaf holds a few triangles. A ray is then tested against the
+ * boxes of the hierarchy, nearest child first, and only against the triangles of the
+ * leaves whose boxes it enters before the closest hit found so far.
+ *
+ * Meshes loaded from bundles build their hierarchy the first time it is requested, with
+ * Mesh::getBVH. Other meshes can be given one created from their positions and indices.
+ *
+ * @script{ignore}
+ */
+class MeshBVH
+{
+    friend class Mesh;
+
+public:
+
+    /**
+     * Defines the closest triangle hit by a ray.
+     */
+    struct Hit
+    {
+        /**
+         * The distance along the ray to the hit, in the space of the mesh.
+         */
+        float distance;
+
+        /**
+         * The point that was hit, in the space of the mesh.
+         */
+        Vector3 point;
+
+        /**
+         * The unit normal of the triangle that was hit, facing the ray origin.
+         */
+        Vector3 normal;
+
+        /**
+         * The index of the triangle that was hit, in the order the triangles were given.
+         */
+        unsigned int triangle;
+
+        /**
+         * The part of the triangle that was hit.
+         */
+        unsigned int part;
+    };
+
+    /**
+     * Creates a hierarchy of triangles.
+     *
+     * @param positions The positions of the vertices, 3 floats each.
+     * @param vertexCount The number of vertices.
+     * @param indices The 3 indices of the vertices of each triangle.
+     * @param triangleCount The number of triangles.
+     * @param parts The part of each triangle, or NULL if all triangles are of part 0.
+     *
+     * @return The new hierarchy, or NULL if there are no triangles.
+     */
+    static MeshBVH* create(const float* positions, unsigned int vertexCount, const unsigned int* indices, unsigned int triangleCount, const unsigned int* parts = NULL);
+
+    /**
+     * Destructor.
+     */
+    ~MeshBVH();
+
+    /**
+     * Finds the closest triangle that a ray hits, from both sides.
+     *
+     * @param ray The ray, in the space of the mesh.
+     * @param hit Populated with the closest hit, if any.
+     * @param maxDistance The distance along the ray beyond which triangles are not hit.
+     *
+     * @return true if a triangle was hit.
+     */
+    bool intersects(const Ray& ray, Hit* hit, float maxDistance = FLT_MAX) const;
+
+    /**
+     * Returns the bounds of all triangles.
+     *
+     * @return The bounds of the mesh.
+     */
+    const BoundingBox& getBounds() const;
+
+    /**
+     * Returns the number of triangles.
+     *
+     * @return The number of triangles.
+     */
+    unsigned int getTriangleCount() const;
+
+    /**
+     * Returns the number of nodes of the hierarchy.
+     *
+     * @return The number of nodes.
+     */
+    unsigned int getNodeCount() const;
+
+private:
+
+    /**
+     * A box of the hierarchy. An inner node is followed by its first child and refers to
+     * its second; a leaf refers to its first triangle.
+     */
+    struct Node
+    {
+        float min[3];
+        unsigned int index;
+        float max[3];
+        unsigned int count;
+    };
+
+    /**
+     * Constructor.
+     */
+    MeshBVH();
+
+    /**
+     * Hidden copy constructor.
+     */
+    MeshBVH(const MeshBVH& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    MeshBVH& operator=(const MeshBVH&);
+
+    /**
+     * Builds the node at the given index over a range of the triangles.
+     */
+    void build(unsigned int node, unsigned int begin, unsigned int end, std::vector<Vector3>& centers);
+
+    std::vector<Node> _nodes;
+    std::vector<float> _positions;
+    std::vector<unsigned int> _indices;
+    std::vector<unsigned int> _triangles;
+    std::vector<unsigned int> _parts;
+    BoundingBox _bounds;
+};
+
+}
+
+#endif
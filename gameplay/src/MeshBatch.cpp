@@ -1,13 +1,224 @@
 #include "Base.h"
 #include "MeshBatch.h"
+#include "RenderStats.h"
 #include "Material.h"
+#include "Game.h"
+
+// The number of frames whose streamed vertices the GPU can still be reading while the next frame is drawn.
+#define MESH_BATCH_STREAM_FRAMES 3
+
+// The initial size in bytes of the vertex and index buffers that a frame streams batches into.
+#define MESH_BATCH_STREAM_SIZE (512 * 1024)
+
+// The alignment in bytes of the vertices and indices of each batch in the stream buffers.
+#define MESH_BATCH_STREAM_ALIGNMENT 16
+
+// Buffers can be mapped persistently on desktop OpenGL where the driver exposes ARB_buffer_storage (core in OpenGL 4.4).
+#if defined(GLEW_STATIC) && defined(GL_ARB_buffer_storage) && defined(GL_ARB_sync)
+#define MESH_BATCH_PERSISTENT_MAPPING
+#endif
 
 namespace gameplay
 {
 
+/**
+ * A buffer that the batches drawn during a frame append their vertices or indices to.
+ */
+struct MeshBatchStream
+{
+    GLenum target;
+    GLuint handle;
+    size_t size;
+    size_t offset;
+    unsigned char* mapped;
+};
+
+/**
+ * The stream buffers of a frame of the ring.
+ */
+struct MeshBatchStreamFrame
+{
+    MeshBatchStream vertices;
+    MeshBatchStream indices;
+#ifdef MESH_BATCH_PERSISTENT_MAPPING
+    GLsync fence;
+#endif
+};
+
+static MeshBatchStreamFrame __streamFrames[MESH_BATCH_STREAM_FRAMES];
+static unsigned int __streamFrame = 0;
+static unsigned int __streamFrameIndex = 0;
+static bool __streamStarted = false;
+static bool __streamPersistent = false;
+
+/**
+ * Creates the storage of a stream buffer, replacing its previous storage.
+ */
+static void allocateStream(MeshBatchStream& stream, size_t size)
+{
+    stream.size = size;
+    stream.offset = 0;
+#ifdef MESH_BATCH_PERSISTENT_MAPPING
+    if (__streamPersistent)
+    {
+        // The storage of persistent buffers is immutable, so growing one takes a new buffer.
+        // The draws that still read the previous buffer keep its storage alive until they are done.
+        if (stream.handle)
+        {
+            GL_ASSERT( glBindBuffer(stream.target, stream.handle) );
+            GL_ASSERT( glUnmapBuffer(stream.target) );
+            GL_ASSERT( glDeleteBuffers(1, &stream.handle) );
+        }
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GL_ASSERT( glGenBuffers(1, &stream.handle) );
+        GL_ASSERT( glBindBuffer(stream.target, stream.handle) );
+        GL_ASSERT( glBufferStorage(stream.target, (GLsizeiptr)size, NULL, flags) );
+        stream.mapped = (unsigned char*)glMapBufferRange(stream.target, 0, (GLsizeiptr)size, flags);
+        GP_ASSERT(stream.mapped);
+        return;
+    }
+#endif
+    if (stream.handle == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &stream.handle) );
+    }
+    GL_ASSERT( glBindBuffer(stream.target, stream.handle) );
+    GL_ASSERT( glBufferData(stream.target, (GLsizeiptr)size, NULL, GL_STREAM_DRAW) );
+}
+
+/**
+ * Appends data to a stream buffer, growing it if the data does not fit, and returns its offset.
+ */
+static size_t streamData(MeshBatchStream& stream, const void* data, size_t size)
+{
+    size_t offset = (stream.offset + MESH_BATCH_STREAM_ALIGNMENT - 1) / MESH_BATCH_STREAM_ALIGNMENT * MESH_BATCH_STREAM_ALIGNMENT;
+    if (stream.handle == 0 || offset + size > stream.size)
+    {
+        size_t capacity = stream.size ? stream.size * 2 : MESH_BATCH_STREAM_SIZE;
+        while (capacity < size)
+            capacity *= 2;
+        allocateStream(stream, capacity);
+        offset = 0;
+    }
+    else
+    {
+        GL_ASSERT( glBindBuffer(stream.target, stream.handle) );
+    }
+    RenderStats::count(RenderStats::BUFFER_BINDS);
+
+    if (stream.mapped)
+    {
+        memcpy(stream.mapped + offset, data, size);
+    }
+    else
+    {
+        GL_ASSERT( glBufferSubData(stream.target, (GLintptr)offset, (GLsizeiptr)size, data) );
+    }
+    stream.offset = offset + size;
+    return offset;
+}
+
+/**
+ * Returns the size in bytes of an index in the given format.
+ */
+static unsigned int getIndexSize(Mesh::IndexFormat indexFormat)
+{
+    return indexFormat == Mesh::INDEX8 ? 1 : (indexFormat == Mesh::INDEX16 ? 2 : 4);
+}
+
+/**
+ * Reads the index at position i of an array of indices in the given format.
+ */
+static unsigned int readIndex(const void* indices, Mesh::IndexFormat indexFormat, unsigned int i)
+{
+    switch (indexFormat)
+    {
+    case Mesh::INDEX8:
+        return ((const unsigned char*)indices)[i];
+    case Mesh::INDEX16:
+        return ((const unsigned short*)indices)[i];
+    default:
+        return ((const unsigned int*)indices)[i];
+    }
+}
+
+/**
+ * Writes the index at position i of an array of indices in the given format.
+ */
+static void writeIndex(void* indices, Mesh::IndexFormat indexFormat, unsigned int i, unsigned int value)
+{
+    switch (indexFormat)
+    {
+    case Mesh::INDEX8:
+        ((unsigned char*)indices)[i] = (unsigned char)value;
+        break;
+    case Mesh::INDEX16:
+        ((unsigned short*)indices)[i] = (unsigned short)value;
+        break;
+    default:
+        ((unsigned int*)indices)[i] = value;
+        break;
+    }
+}
+
+/**
+ * Returns the stream buffers of the current frame, moving to the next frame of the ring
+ * once the game has moved to a new frame.
+ */
+static MeshBatchStreamFrame& getStreamFrame()
+{
+    unsigned int frameIndex = Game::getInstance()->getFrameIndex();
+    if (!__streamStarted)
+    {
+        for (unsigned int i = 0; i < MESH_BATCH_STREAM_FRAMES; ++i)
+        {
+            memset(&__streamFrames[i], 0, sizeof(MeshBatchStreamFrame));
+            __streamFrames[i].vertices.target = GL_ARRAY_BUFFER;
+            __streamFrames[i].indices.target = GL_ELEMENT_ARRAY_BUFFER;
+        }
+#ifdef MESH_BATCH_PERSISTENT_MAPPING
+        __streamPersistent = GLEW_ARB_buffer_storage && GLEW_ARB_sync;
+#endif
+        __streamStarted = true;
+        __streamFrameIndex = frameIndex;
+    }
+    else if (frameIndex != __streamFrameIndex)
+    {
+#ifdef MESH_BATCH_PERSISTENT_MAPPING
+        // Fence the draws of the previous frame, which the GPU has finished reading once it signals.
+        if (__streamPersistent)
+            __streamFrames[__streamFrame].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#endif
+        __streamFrame = (__streamFrame + 1) % MESH_BATCH_STREAM_FRAMES;
+        __streamFrameIndex = frameIndex;
+
+        MeshBatchStreamFrame& frame = __streamFrames[__streamFrame];
+        frame.vertices.offset = 0;
+        frame.indices.offset = 0;
+#ifdef MESH_BATCH_PERSISTENT_MAPPING
+        if (frame.fence)
+        {
+            // Only waits when the GPU is more frames behind than the ring holds.
+            glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+            glDeleteSync(frame.fence);
+            frame.fence = NULL;
+        }
+        if (!__streamPersistent)
+#endif
+        {
+            // Orphan the storage that the GPU may still be reading, so that writing into it doesn't wait.
+            if (frame.vertices.handle)
+                allocateStream(frame.vertices, frame.vertices.size);
+            if (frame.indices.handle)
+                allocateStream(frame.indices, frame.indices.size);
+        }
+    }
+    return __streamFrames[__streamFrame];
+}
+
 MeshBatch::MeshBatch(const VertexFormat& vertexFormat, Mesh::PrimitiveType primitiveType, Material* material, bool indexed, unsigned int initialCapacity, unsigned int growSize)
     : _vertexFormat(vertexFormat), _primitiveType(primitiveType), _material(material), _indexed(indexed), _capacity(0), _growSize(growSize),
-    _vertexCapacity(0), _indexCapacity(0), _vertexCount(0), _indexCount(0), _vertices(NULL), _verticesPtr(NULL), _indices(NULL), _indicesPtr(NULL), _started(false)
+    _vertexCapacity(0), _indexCapacity(0), _vertexCount(0), _indexCount(0), _vertices(NULL), _verticesPtr(NULL), _indexFormat(Mesh::INDEX8), _indices(NULL), _started(false)
 {
     resize(initialCapacity);
 }
@@ -43,7 +254,7 @@ MeshBatch* MeshBatch::create(const VertexFormat& vertexFormat, Mesh::PrimitiveTy
     return batch;
 }
 
-void MeshBatch::add(const void* vertices, size_t size, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount)
+void MeshBatch::add(const void* vertices, size_t size, unsigned int vertexCount, const void* indices, Mesh::IndexFormat indexFormat, unsigned int indexCount)
 {
     GP_ASSERT(vertices);
     
@@ -70,32 +281,32 @@ void MeshBatch::add(const void* vertices, size_t size, unsigned int vertexCount,
     if (_indexed)
     {
         GP_ASSERT(indices);
-        GP_ASSERT(_indicesPtr);
+        GP_ASSERT(_indices);
 
-        if (_vertexCount == 0)
+        if (_vertexCount == 0 && indexFormat == _indexFormat)
         {
             // Simply copy values directly into the start of the index array.
-            memcpy(_indicesPtr, indices, indexCount * sizeof(unsigned short));
+            memcpy(_indices, indices, indexCount * getIndexSize(_indexFormat));
         }
         else
         {
-            if (_primitiveType == Mesh::TRIANGLE_STRIP)
+            unsigned int start = _indexCount;
+            if (_primitiveType == Mesh::TRIANGLE_STRIP && _vertexCount > 0)
             {
                 // Create a degenerate triangle to connect separate triangle strips
                 // by duplicating the previous and next vertices.
-                _indicesPtr[0] = *(_indicesPtr-1);
-                _indicesPtr[1] = _vertexCount;
-                _indicesPtr += 2;
+                writeIndex(_indices, _indexFormat, start, readIndex(_indices, _indexFormat, start - 1));
+                writeIndex(_indices, _indexFormat, start + 1, _vertexCount);
+                start += 2;
             }
             
             // Loop through all indices and insert them, with their values offset by
             // 'vertexCount' so that they are relative to the first newly inserted vertex.
             for (unsigned int i = 0; i < indexCount; ++i)
             {
-                _indicesPtr[i] = indices[i] + _vertexCount;
+                writeIndex(_indices, _indexFormat, start + i, readIndex(indices, indexFormat, i) + _vertexCount);
             }
         }
-        _indicesPtr += indexCount;
         _indexCount = newIndexCount;
     }
     
@@ -116,7 +327,8 @@ void MeshBatch::updateVertexAttributeBinding()
         {
             Pass* p = t->getPassByIndex(j);
             GP_ASSERT(p);
-            VertexAttributeBinding* b = VertexAttributeBinding::create(_vertexFormat, _vertices, p->getEffect());
+            // The attribute pointers are offsets into the stream buffers that the batch is drawn from.
+            VertexAttributeBinding* b = VertexAttributeBinding::create(_vertexFormat, NULL, p->getEffect());
             p->setVertexAttributeBinding(b);
             SAFE_RELEASE(b);
         }
@@ -146,7 +358,8 @@ bool MeshBatch::resize(unsigned int capacity)
 
     // Store old batch data.
     unsigned char* oldVertices = _vertices;
-    unsigned short* oldIndices = _indices;
+    unsigned char* oldIndices = _indices;
+    Mesh::IndexFormat oldIndexFormat = _indexFormat;
 
     unsigned int vertexCapacity = 0;
     switch (_primitiveType)
@@ -175,12 +388,17 @@ bool MeshBatch::resize(unsigned int capacity)
     // (we only know how many indices will be stored). Assume the worst case
     // for now, which is the same number of vertices as indices.
     unsigned int indexCapacity = vertexCapacity;
-    if (_indexed && indexCapacity > USHRT_MAX)
+    Mesh::IndexFormat indexFormat = Mesh::getIndexFormat(vertexCapacity);
+    if (_indexed && indexFormat == Mesh::INDEX32 && !Mesh::isIndex32Supported())
     {
-        GP_ERROR("Index capacity is greater than the maximum unsigned short value (%d > %d).", indexCapacity, USHRT_MAX);
+        GP_ERROR("Vertex capacity needs 32-bit indices, which the device does not support (%d > %d).", vertexCapacity, USHRT_MAX + 1);
         return false;
     }
 
+    // Indices only ever widen, so that a batch which once needed wide indices doesn't convert them back and forth.
+    if (oldIndices && getIndexSize(indexFormat) < getIndexSize(oldIndexFormat))
+        indexFormat = oldIndexFormat;
+
     // Allocate new data and reset pointers.
     unsigned int voffset = _verticesPtr - _vertices;
     unsigned int vBytes = vertexCapacity * _vertexFormat.getVertexSize();
@@ -191,11 +409,10 @@ bool MeshBatch::resize(unsigned int capacity)
 
     if (_indexed)
     {
-        unsigned int ioffset = _indicesPtr - _indices;
-        _indices = new unsigned short[indexCapacity];
-        if (ioffset >= indexCapacity)
-            ioffset = indexCapacity - 1;
-        _indicesPtr = _indices + ioffset;
+        _indices = new unsigned char[indexCapacity * getIndexSize(indexFormat)];
+        _indexFormat = indexFormat;
+        if (_indexCount > indexCapacity)
+            _indexCount = indexCapacity;
     }
 
     // Copy old data back in
@@ -203,7 +420,18 @@ bool MeshBatch::resize(unsigned int capacity)
         memcpy(_vertices, oldVertices, std::min(_vertexCapacity, vertexCapacity) * _vertexFormat.getVertexSize());
     SAFE_DELETE_ARRAY(oldVertices);
     if (oldIndices)
-        memcpy(_indices, oldIndices, std::min(_indexCapacity, indexCapacity) * sizeof(unsigned short));
+    {
+        unsigned int count = std::min(_indexCapacity, indexCapacity);
+        if (_indexFormat == oldIndexFormat)
+        {
+            memcpy(_indices, oldIndices, count * getIndexSize(_indexFormat));
+        }
+        else
+        {
+            for (unsigned int i = 0; i < count; ++i)
+                writeIndex(_indices, _indexFormat, i, readIndex(oldIndices, oldIndexFormat, i));
+        }
+    }
     SAFE_DELETE_ARRAY(oldIndices);
 
     // Assign new capacities
@@ -211,15 +439,26 @@ bool MeshBatch::resize(unsigned int capacity)
     _vertexCapacity = vertexCapacity;
     _indexCapacity = indexCapacity;
 
-    // Update our vertex attribute bindings now that our client array pointers have changed
-    updateVertexAttributeBinding();
+    // Create the vertex attribute bindings the first time the batch is sized.
+    if (oldVertices == NULL)
+        updateVertexAttributeBinding();
 
     return true;
 }
 
 void MeshBatch::add(const float* vertices, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount)
 {
-    add(vertices, sizeof(float), vertexCount, indices, indexCount);
+    add(vertices, sizeof(float), vertexCount, indices, Mesh::INDEX16, indexCount);
+}
+
+void MeshBatch::add(const float* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+    add(vertices, sizeof(float), vertexCount, indices, Mesh::INDEX32, indexCount);
+}
+
+Mesh::IndexFormat MeshBatch::getIndexFormat() const
+{
+    return _indexFormat;
 }
 
 void MeshBatch::start()
@@ -227,7 +466,6 @@ void MeshBatch::start()
     _vertexCount = 0;
     _indexCount = 0;
     _verticesPtr = _vertices;
-    _indicesPtr = _indices;
     _started = true;
 }
 
@@ -246,14 +484,17 @@ void MeshBatch::draw()
     if (_vertexCount == 0 || (_indexed && _indexCount == 0))
         return; // nothing to draw
 
-    // Not using VBOs, so unbind the element array buffer.
-    // ARRAY_BUFFER will be unbound automatically during pass->bind().
-    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0 ) );
-
     GP_ASSERT(_material);
     if (_indexed)
         GP_ASSERT(_indices);
 
+    // Stream the vertices and indices into the buffers of the frame, once for every pass.
+    MeshBatchStreamFrame& frame = getStreamFrame();
+    size_t vertexOffset = streamData(frame.vertices, _vertices, (size_t)_vertexCount * _vertexFormat.getVertexSize());
+    size_t indexOffset = 0;
+    if (_indexed)
+        indexOffset = streamData(frame.indices, _indices, (size_t)_indexCount * getIndexSize(_indexFormat));
+
     // Bind the material.
     Technique* technique = _material->getTechnique();
     GP_ASSERT(technique);
@@ -262,19 +503,66 @@ void MeshBatch::draw()
     {
         Pass* pass = technique->getPassByIndex(i);
         GP_ASSERT(pass);
+        // The effect of the pass is replaced when its material is reloaded.
+        if (!pass->getVertexAttributeBinding())
+            updateVertexAttributeBinding();
+        GP_ASSERT(pass->getVertexAttributeBinding());
+        pass->getVertexAttributeBinding()->setVertexBuffer(frame.vertices.handle, vertexOffset);
         pass->bind();
 
         if (_indexed)
         {
-            GL_ASSERT( glDrawElements(_primitiveType, _indexCount, GL_UNSIGNED_SHORT, (GLvoid*)_indices) );
+            GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, frame.indices.handle) );
+            GL_ASSERT( glDrawElements(_primitiveType, _indexCount, _indexFormat, (GLvoid*)indexOffset) );
+            RenderStats::count(RenderStats::DRAW_CALLS);
         }
         else
         {
             GL_ASSERT( glDrawArrays(_primitiveType, 0, _vertexCount) );
+            RenderStats::count(RenderStats::DRAW_CALLS);
         }
 
         pass->unbind();
     }
+
+    // Meshes drawn without vertex array objects expect no element array buffer to be bound.
+    if (_indexed)
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
+    }
+}
+
+void MeshBatch::finalize()
+{
+    if (!__streamStarted)
+        return;
+
+    for (unsigned int i = 0; i < MESH_BATCH_STREAM_FRAMES; ++i)
+    {
+        MeshBatchStreamFrame& frame = __streamFrames[i];
+#ifdef MESH_BATCH_PERSISTENT_MAPPING
+        if (frame.fence)
+        {
+            glDeleteSync(frame.fence);
+            frame.fence = NULL;
+        }
+#endif
+        MeshBatchStream* streams[] = { &frame.vertices, &frame.indices };
+        for (unsigned int j = 0; j < 2; ++j)
+        {
+            if (streams[j]->handle)
+            {
+                if (streams[j]->mapped)
+                {
+                    GL_ASSERT( glBindBuffer(streams[j]->target, streams[j]->handle) );
+                    GL_ASSERT( glUnmapBuffer(streams[j]->target) );
+                }
+                GL_ASSERT( glDeleteBuffers(1, &streams[j]->handle) );
+            }
+        }
+    }
+    __streamStarted = false;
+    __streamFrame = 0;
 }
     
 
@@ -10,9 +10,23 @@ class Material;
 
 /**
  * Defines a class for rendering multiple mesh into a single draw call on the graphics device.
+ *
+ * When drawn, the vertices and indices of a batch are streamed into vertex buffers shared by
+ * every batch drawn during the same frame, at increasing offsets. A ring of buffers holds the
+ * last few frames, so that a frame writes into buffers the GPU is no longer reading. Where the
+ * driver supports ARB_buffer_storage the buffers are mapped persistently, and vertices are
+ * copied once straight into memory the GPU reads from; elsewhere, such as on OpenGL ES 2.0,
+ * the buffers of a frame are orphaned as it starts and written with glBufferSubData.
+ *
+ * Indices are stored in the smallest format that can address the vertex capacity of the batch,
+ * and are widened as the batch grows, up to 32-bit indices where the device supports them.
  */
 class MeshBatch
 {
+    friend class Form;
+    friend class Game;
+    friend class SpriteBatch;
+
 public:
 
     /**
@@ -71,6 +85,13 @@ public:
      */
     inline Material* getMaterial() const;
 
+    /**
+     * Returns the format that the indices of this batch are stored and drawn in.
+     *
+     * @return The index format of the batch.
+     */
+    Mesh::IndexFormat getIndexFormat() const;
+
     /**
      * Adds a group of primitives to the batch.
      *
@@ -93,6 +114,18 @@ public:
     template <class T>
     void add(const T* vertices, unsigned int vertexCount, const unsigned short* indices = NULL, unsigned int indexCount = 0);
 
+    /**
+     * Adds a group of primitives with 32-bit indices to the batch.
+     *
+     * @param vertices Array of vertices.
+     * @param vertexCount Number of vertices.
+     * @param indices Array of indices into the vertex array.
+     * @param indexCount Number of indices.
+     * @see add(const T*, unsigned int, const unsigned short*, unsigned int)
+     */
+    template <class T>
+    void add(const T* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+
     /**
      * Adds a group of primitives to the batch.
      *
@@ -114,6 +147,18 @@ public:
      */
     void add(const float* vertices, unsigned int vertexCount, const unsigned short* indices = NULL, unsigned int indexCount = 0);
 
+    /**
+     * Adds a group of primitives with 32-bit indices to the batch.
+     *
+     * @param vertices Array of vertices.
+     * @param vertexCount Number of vertices.
+     * @param indices Array of indices into the vertex array.
+     * @param indexCount Number of indices.
+     * @see add(const float*, unsigned int, const unsigned short*, unsigned int)
+     * @script{ignore}
+     */
+    void add(const float* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+
     /**
      * Starts batching.
      *
@@ -158,12 +203,17 @@ private:
      */
     MeshBatch& operator=(const MeshBatch&);
 
-    void add(const void* vertices, size_t size, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount);
+    void add(const void* vertices, size_t size, unsigned int vertexCount, const void* indices, Mesh::IndexFormat indexFormat, unsigned int indexCount);
 
     void updateVertexAttributeBinding();
 
     bool resize(unsigned int capacity);
 
+    /**
+     * Releases the buffers that batches stream into. Called by the game during shutdown.
+     */
+    static void finalize();
+
     const VertexFormat _vertexFormat;
     Mesh::PrimitiveType _primitiveType;
     Material* _material;
@@ -176,8 +226,8 @@ private:
     unsigned int _indexCount;
     unsigned char* _vertices;
     unsigned char* _verticesPtr;
-    unsigned short* _indices;
-    unsigned short* _indicesPtr;
+    Mesh::IndexFormat _indexFormat;
+    unsigned char* _indices;
     bool _started;
 
 };
@@ -0,0 +1,197 @@
+#include "Base.h"
+#include "MeshBuffer.h"
+#include "Game.h"
+
+// The default size of a shared buffer, in kilobytes.
+#define MESH_BUFFER_DEFAULT_SIZE 2048
+
+namespace gameplay
+{
+
+/**
+ * A free range of a shared buffer.
+ */
+struct MeshBufferRange
+{
+    unsigned int offset;
+    unsigned int size;
+};
+
+/**
+ * A shared vertex or index buffer.
+ */
+struct MeshBufferArena
+{
+    GLenum target;
+    VertexFormat* vertexFormat;
+    unsigned int indexSize;
+    GLuint handle;
+    unsigned int size;
+    unsigned int allocated;
+    std::vector<MeshBufferRange> free;
+};
+
+static std::vector<MeshBufferArena*> __arenas;
+static int __enabled = -1;
+static unsigned int __bufferSize = 0;
+
+/**
+ * Reads the configuration of the shared buffers the first time one is needed.
+ */
+static bool isEnabled()
+{
+    if (__enabled < 0)
+    {
+        Properties* graphicsConfig = Game::getInstance()->getConfig()->getNamespace("graphics", true);
+        __enabled = (graphicsConfig && graphicsConfig->exists("meshBuffers") && !graphicsConfig->getBool("meshBuffers")) ? 0 : 1;
+        int size = (graphicsConfig && graphicsConfig->exists("meshBufferSize")) ? graphicsConfig->getInt("meshBufferSize") : MESH_BUFFER_DEFAULT_SIZE;
+        __bufferSize = (unsigned int)std::max(size, 1) * 1024;
+    }
+    return __enabled == 1;
+}
+
+/**
+ * Allocates a range from the first shared buffer with room for it, creating a new one if none has.
+ */
+static bool allocate(GLenum target, const VertexFormat* vertexFormat, unsigned int indexSize, unsigned int elementSize, unsigned int size, GLuint* buffer, unsigned int* offset)
+{
+    GP_ASSERT(buffer);
+    GP_ASSERT(offset);
+
+    // Large meshes would leave too much of a shared buffer unused.
+    if (size == 0 || !isEnabled() || size > __bufferSize / 4)
+        return false;
+
+    for (size_t i = 0, count = __arenas.size(); i < count; ++i)
+    {
+        MeshBufferArena* arena = __arenas[i];
+        if (arena->target != target || arena->indexSize != indexSize || (vertexFormat && *arena->vertexFormat != *vertexFormat))
+            continue;
+
+        for (size_t j = 0, ranges = arena->free.size(); j < ranges; ++j)
+        {
+            MeshBufferRange& range = arena->free[j];
+            if (range.size >= size)
+            {
+                *buffer = arena->handle;
+                *offset = range.offset;
+                range.offset += size;
+                range.size -= size;
+                if (range.size == 0)
+                    arena->free.erase(arena->free.begin() + j);
+                arena->allocated += size;
+                return true;
+            }
+        }
+    }
+
+    // Every range of a buffer is a whole number of elements, so that the offset of a
+    // range is also the index of its first vertex or index.
+    MeshBufferArena* arena = new MeshBufferArena();
+    arena->target = target;
+    arena->vertexFormat = vertexFormat ? new VertexFormat(*vertexFormat) : NULL;
+    arena->indexSize = indexSize;
+    arena->size = (__bufferSize / elementSize) * elementSize;
+    arena->allocated = size;
+    GL_ASSERT( glGenBuffers(1, &arena->handle) );
+    GL_ASSERT( glBindBuffer(target, arena->handle) );
+    GL_ASSERT( glBufferData(target, arena->size, NULL, GL_STATIC_DRAW) );
+    if (size < arena->size)
+    {
+        MeshBufferRange range = { size, arena->size - size };
+        arena->free.push_back(range);
+    }
+    __arenas.push_back(arena);
+
+    *buffer = arena->handle;
+    *offset = 0;
+    return true;
+}
+
+unsigned int MeshBuffer::getBufferCount()
+{
+    return (unsigned int)__arenas.size();
+}
+
+size_t MeshBuffer::getBufferMemory()
+{
+    size_t memory = 0;
+    for (size_t i = 0, count = __arenas.size(); i < count; ++i)
+    {
+        memory += __arenas[i]->size;
+    }
+    return memory;
+}
+
+size_t MeshBuffer::getAllocatedMemory()
+{
+    size_t memory = 0;
+    for (size_t i = 0, count = __arenas.size(); i < count; ++i)
+    {
+        memory += __arenas[i]->allocated;
+    }
+    return memory;
+}
+
+bool MeshBuffer::allocateVertices(const VertexFormat& vertexFormat, unsigned int vertexCount, GLuint* buffer, unsigned int* offset)
+{
+    unsigned int vertexSize = vertexFormat.getVertexSize();
+    return allocate(GL_ARRAY_BUFFER, &vertexFormat, 0, vertexSize, vertexSize * vertexCount, buffer, offset);
+}
+
+bool MeshBuffer::allocateIndices(unsigned int indexSize, unsigned int indexCount, GLuint* buffer, unsigned int* offset)
+{
+    return allocate(GL_ELEMENT_ARRAY_BUFFER, NULL, indexSize, indexSize, indexSize * indexCount, buffer, offset);
+}
+
+void MeshBuffer::release(GLuint buffer, unsigned int offset, unsigned int size)
+{
+    for (size_t i = 0, count = __arenas.size(); i < count; ++i)
+    {
+        MeshBufferArena* arena = __arenas[i];
+        if (arena->handle != buffer)
+            continue;
+
+        GP_ASSERT(arena->allocated >= size && offset + size <= arena->size);
+        arena->allocated -= size;
+        if (arena->allocated == 0)
+        {
+            GL_ASSERT( glDeleteBuffers(1, &arena->handle) );
+            SAFE_DELETE(arena->vertexFormat);
+            SAFE_DELETE(arena);
+            __arenas.erase(__arenas.begin() + i);
+            return;
+        }
+
+        // Keep the free ranges sorted and merge the released range with its neighbours.
+        std::vector<MeshBufferRange>& ranges = arena->free;
+        size_t j = 0;
+        while (j < ranges.size() && ranges[j].offset < offset)
+        {
+            ++j;
+        }
+        if (j > 0 && ranges[j - 1].offset + ranges[j - 1].size == offset)
+        {
+            ranges[j - 1].size += size;
+            if (j < ranges.size() && offset + size == ranges[j].offset)
+            {
+                ranges[j - 1].size += ranges[j].size;
+                ranges.erase(ranges.begin() + j);
+            }
+        }
+        else if (j < ranges.size() && offset + size == ranges[j].offset)
+        {
+            ranges[j].offset = offset;
+            ranges[j].size += size;
+        }
+        else
+        {
+            MeshBufferRange range = { offset, size };
+            ranges.insert(ranges.begin() + j, range);
+        }
+        return;
+    }
+    GP_WARN("Released a range of an unknown mesh buffer (%u).", buffer);
+}
+
+}
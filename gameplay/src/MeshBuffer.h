@@ -0,0 +1,103 @@
+#ifndef MESHBUFFER_H_
+#define MESHBUFFER_H_
+
+#include "VertexFormat.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines the large vertex and index buffers that the buffers of static meshes are
+ * sub-allocated from.
+ *
+ * A scene made of thousands of small meshes would otherwise hold thousands of small
+ * buffer objects, and rebind a different one for every draw. Static meshes instead take
+ * a range of a shared buffer of their vertex format, and the index buffers of their parts
+ * take a range of a shared buffer of their index format. Meshes and mesh parts report the
+ * offset of their range, which the vertex attribute bindings and the draws apply, so
+ * indices remain relative to the first vertex of their mesh on every device, without base
+ * vertex draws.
+ *
+ * Dynamic meshes and parts keep buffers of their own, since replacing their data must not
+ * stall on the other meshes of a shared buffer. So do meshes that take more than a quarter
+ * of a shared buffer. A shared buffer is deleted once all the ranges allocated from it are
+ * released.
+ *
+ * Shared buffers can be disabled and sized with the 'meshBuffers' and 'meshBufferSize'
+ * properties of the 'graphics' namespace in the game configuration file. The size is in
+ * kilobytes.
+ *
+ * @script{ignore}
+ */
+class MeshBuffer
+{
+    friend class Mesh;
+    friend class MeshPart;
+
+public:
+
+    /**
+     * Returns the number of shared buffers that are allocated.
+     *
+     * @return The number of shared vertex and index buffers.
+     */
+    static unsigned int getBufferCount();
+
+    /**
+     * Returns the memory held by the shared buffers.
+     *
+     * @return The size of all shared buffers in bytes.
+     */
+    static size_t getBufferMemory();
+
+    /**
+     * Returns the memory of the shared buffers that is allocated to meshes and mesh parts.
+     *
+     * @return The size of all allocated ranges in bytes.
+     */
+    static size_t getAllocatedMemory();
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    MeshBuffer();
+
+    /**
+     * Allocates the vertices of a static mesh from a shared vertex buffer of its format.
+     *
+     * @param vertexFormat The vertex format of the mesh.
+     * @param vertexCount The number of vertices.
+     * @param buffer Populated with the shared buffer.
+     * @param offset Populated with the offset of the first vertex in the buffer, in bytes.
+     *
+     * @return true if the vertices were allocated, false if the mesh needs a buffer of its own.
+     */
+    static bool allocateVertices(const VertexFormat& vertexFormat, unsigned int vertexCount, GLuint* buffer, unsigned int* offset);
+
+    /**
+     * Allocates the indices of a static mesh part from a shared index buffer of its index size.
+     *
+     * @param indexSize The size of an index in bytes.
+     * @param indexCount The number of indices.
+     * @param buffer Populated with the shared buffer.
+     * @param offset Populated with the offset of the first index in the buffer, in bytes.
+     *
+     * @return true if the indices were allocated, false if the part needs a buffer of its own.
+     */
+    static bool allocateIndices(unsigned int indexSize, unsigned int indexCount, GLuint* buffer, unsigned int* offset);
+
+    /**
+     * Releases a range allocated from a shared buffer, and deletes the buffer once it is empty.
+     *
+     * @param buffer The shared buffer.
+     * @param offset The offset of the range in bytes.
+     * @param size The size of the range in bytes.
+     */
+    static void release(GLuint buffer, unsigned int offset, unsigned int size);
+};
+
+}
+
+#endif
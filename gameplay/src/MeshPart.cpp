@@ -1,11 +1,14 @@
 #include "Base.h"
 #include "MeshPart.h"
+#include "RenderStats.h"
+#include "MeshBuffer.h"
 
 namespace gameplay
 {
 
 MeshPart::MeshPart() :
-    _mesh(NULL), _meshIndex(0), _primitiveType(Mesh::TRIANGLES), _indexCount(0), _indexBuffer(0), _dynamic(false)
+    _mesh(NULL), _meshIndex(0), _primitiveType(Mesh::TRIANGLES), _indexCount(0), _indexBuffer(0), _indexOffset(0),
+    _sharedBuffer(false), _dynamic(false)
 {
 }
 
@@ -13,18 +16,18 @@ MeshPart::~MeshPart()
 {
     if (_indexBuffer)
     {
-        glDeleteBuffers(1, &_indexBuffer);
+        unsigned int indexSize = _indexFormat == Mesh::INDEX8 ? 1 : (_indexFormat == Mesh::INDEX16 ? 2 : 4);
+        RenderStats::removeMemory(RenderStats::INDEX_BUFFER_MEMORY, indexSize * _indexCount, this);
+        if (_sharedBuffer)
+            MeshBuffer::release(_indexBuffer, _indexOffset, indexSize * _indexCount);
+        else
+            glDeleteBuffers(1, &_indexBuffer);
     }
 }
 
 MeshPart* MeshPart::create(Mesh* mesh, unsigned int meshIndex, Mesh::PrimitiveType primitiveType,
     Mesh::IndexFormat indexFormat, unsigned int indexCount, bool dynamic)
 {
-    // Create a VBO for our index buffer.
-    GLuint vbo;
-    GL_ASSERT( glGenBuffers(1, &vbo) );
-    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo) );
-
     unsigned int indexSize = 0;
     switch (indexFormat)
     {
@@ -39,11 +42,20 @@ MeshPart* MeshPart::create(Mesh* mesh, unsigned int meshIndex, Mesh::PrimitiveTy
         break;
     default:
         GP_ERROR("Unsupported index format (%d).", indexFormat);
-        glDeleteBuffers(1, &vbo);
         return NULL;
     }
 
-    GL_ASSERT( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * indexCount, NULL, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW) );
+    // Static parts take their indices from a buffer shared with other parts, and
+    // the others get a VBO of their own.
+    GLuint vbo;
+    unsigned int offset = 0;
+    bool shared = !dynamic && MeshBuffer::allocateIndices(indexSize, indexCount, &vbo, &offset);
+    if (!shared)
+    {
+        GL_ASSERT( glGenBuffers(1, &vbo) );
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, vbo) );
+        GL_ASSERT( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * indexCount, NULL, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW) );
+    }
 
     MeshPart* part = new MeshPart();
     part->_mesh = mesh;
@@ -52,7 +64,10 @@ MeshPart* MeshPart::create(Mesh* mesh, unsigned int meshIndex, Mesh::PrimitiveTy
     part->_indexFormat = indexFormat;
     part->_indexCount = indexCount;
     part->_indexBuffer = vbo;
+    part->_indexOffset = offset;
+    part->_sharedBuffer = shared;
     part->_dynamic = dynamic;
+    RenderStats::addMemory(RenderStats::INDEX_BUFFER_MEMORY, indexSize * indexCount, part, mesh->getUrl()[0] ? mesh->getUrl() : NULL);
 
     return part;
 }
@@ -82,11 +97,18 @@ IndexBufferHandle MeshPart::getIndexBuffer() const
     return _indexBuffer;
 }
 
+unsigned int MeshPart::getIndexOffset() const
+{
+    return _indexOffset;
+}
+
 void* MeshPart::mapIndexBuffer()
 {
     GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer) );
 
-    return (void*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
+    // A shared buffer is mapped whole, and the indices of the part start at its offset.
+    unsigned char* data = (unsigned char*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
+    return data ? (void*)(data + _indexOffset) : NULL;
 }
 
 bool MeshPart::unmapIndexBuffer()
@@ -96,6 +118,10 @@ bool MeshPart::unmapIndexBuffer()
 
 void MeshPart::setIndexData(const void* indexData, unsigned int indexStart, unsigned int indexCount)
 {
+    // The range of a shared buffer can't be orphaned, and keeps its data.
+    if (_sharedBuffer && indexData == NULL)
+        return;
+
     GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _indexBuffer) );
 
     unsigned int indexSize = 0;
@@ -115,7 +141,7 @@ void MeshPart::setIndexData(const void* indexData, unsigned int indexStart, unsi
         return;
     }
 
-    if (indexStart == 0 && indexCount == 0)
+    if (indexStart == 0 && indexCount == 0 && !_sharedBuffer)
     {
         GL_ASSERT( glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * _indexCount, indexData, _dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW) );
     }
@@ -126,7 +152,7 @@ void MeshPart::setIndexData(const void* indexData, unsigned int indexStart, unsi
             indexCount = _indexCount - indexStart;
         }
 
-        GL_ASSERT( glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexStart * indexSize, indexCount * indexSize, indexData) );
+        GL_ASSERT( glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, _indexOffset + indexStart * indexSize, indexCount * indexSize, indexData) );
     }
 }
 
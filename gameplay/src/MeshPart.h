@@ -57,6 +57,18 @@ public:
      */
     IndexBufferHandle getIndexBuffer() const;
 
+    /**
+     * Returns the offset of the first index of the part in its index buffer, which draws
+     * of the part pass as their indices.
+     *
+     * Static parts share their index buffer with other parts of the same index format.
+     *
+     * @return The offset in bytes.
+     * @see MeshBuffer
+     * @script{ignore}
+     */
+    unsigned int getIndexOffset() const;
+
     /**
      * Maps the index buffer for the specified access.
      *
@@ -136,6 +148,8 @@ private:
     Mesh::IndexFormat _indexFormat;
     unsigned int _indexCount;
     IndexBufferHandle _indexBuffer;
+    unsigned int _indexOffset;
+    bool _sharedBuffer;
     bool _dynamic;
 };
 
@@ -2,15 +2,114 @@
 #include "MeshSkin.h"
 #include "Joint.h"
 #include "Model.h"
+#include "NodeIndex.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PALETTE_USE_SSE
+#elif defined(GP_USE_NEON) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PALETTE_USE_NEON
+#endif
 
 // The number of rows in each palette matrix.
 #define PALETTE_ROWS 3
 
+// The number of rows in each dual quaternion palette entry.
+#define DUAL_QUATERNION_ROWS 2
+
 namespace gameplay
 {
 
+// Computes the first three rows of the product of a column-major matrix and a row-wise matrix.
+static void multiplyPaletteMatrix(const float* m, const float* rows, float* dst)
+{
+#if defined(PALETTE_USE_SSE)
+    __m128 r0 = _mm_loadu_ps(rows);
+    __m128 r1 = _mm_loadu_ps(rows + 4);
+    __m128 r2 = _mm_loadu_ps(rows + 8);
+    __m128 r3 = _mm_loadu_ps(rows + 12);
+    for (unsigned int i = 0; i < PALETTE_ROWS; ++i)
+    {
+        __m128 x = _mm_mul_ps(r0, _mm_set1_ps(m[i]));
+        x = _mm_add_ps(x, _mm_mul_ps(r1, _mm_set1_ps(m[4 + i])));
+        x = _mm_add_ps(x, _mm_mul_ps(r2, _mm_set1_ps(m[8 + i])));
+        x = _mm_add_ps(x, _mm_mul_ps(r3, _mm_set1_ps(m[12 + i])));
+        _mm_storeu_ps(dst + i * 4, x);
+    }
+#elif defined(PALETTE_USE_NEON)
+    float32x4_t r0 = vld1q_f32(rows);
+    float32x4_t r1 = vld1q_f32(rows + 4);
+    float32x4_t r2 = vld1q_f32(rows + 8);
+    float32x4_t r3 = vld1q_f32(rows + 12);
+    for (unsigned int i = 0; i < PALETTE_ROWS; ++i)
+    {
+        float32x4_t x = vmulq_n_f32(r0, m[i]);
+        x = vmlaq_n_f32(x, r1, m[4 + i]);
+        x = vmlaq_n_f32(x, r2, m[8 + i]);
+        x = vmlaq_n_f32(x, r3, m[12 + i]);
+        vst1q_f32(dst + i * 4, x);
+    }
+#else
+    for (unsigned int i = 0; i < PALETTE_ROWS; ++i)
+    {
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            dst[i * 4 + j] = m[i] * rows[j] + m[4 + i] * rows[4 + j] + m[8 + i] * rows[8 + j] + m[12 + i] * rows[12 + j];
+        }
+    }
+#endif
+}
+
+// Converts a rigid transform given as 3 rows into a rotation quaternion and its dual part.
+static void convertToDualQuaternion(const Vector4* rows, Vector4* dst)
+{
+    // Remove any scale from the rotation before extracting the quaternion.
+    Vector3 x(rows[0].x, rows[1].x, rows[2].x);
+    Vector3 y(rows[0].y, rows[1].y, rows[2].y);
+    Vector3 z(rows[0].z, rows[1].z, rows[2].z);
+    x.normalize();
+    y.normalize();
+    z.normalize();
+
+    Vector4 q;
+    float trace = x.x + y.y + z.z;
+    if (trace > 0.0f)
+    {
+        float s = 0.5f / sqrt(trace + 1.0f);
+        q.set((y.z - z.y) * s, (z.x - x.z) * s, (x.y - y.x) * s, 0.25f / s);
+    }
+    else if (x.x > y.y && x.x > z.z)
+    {
+        float s = 2.0f * sqrt(1.0f + x.x - y.y - z.z);
+        q.set(0.25f * s, (y.x + x.y) / s, (z.x + x.z) / s, (y.z - z.y) / s);
+    }
+    else if (y.y > z.z)
+    {
+        float s = 2.0f * sqrt(1.0f + y.y - x.x - z.z);
+        q.set((y.x + x.y) / s, 0.25f * s, (z.y + y.z) / s, (z.x - x.z) / s);
+    }
+    else
+    {
+        float s = 2.0f * sqrt(1.0f + z.z - x.x - y.y);
+        q.set((z.x + x.z) / s, (z.y + y.z) / s, 0.25f * s, (x.y - y.x) / s);
+    }
+    q.normalize();
+
+    // The dual part is half the translation multiplied by the rotation.
+    float tx = rows[0].w;
+    float ty = rows[1].w;
+    float tz = rows[2].w;
+    dst[0] = q;
+    dst[1].set(0.5f * (tx * q.w + ty * q.z - tz * q.y),
+               0.5f * (-tx * q.z + ty * q.w + tz * q.x),
+               0.5f * (tx * q.y - ty * q.x + tz * q.w),
+               -0.5f * (tx * q.x + ty * q.y + tz * q.z));
+}
+
 MeshSkin::MeshSkin()
-    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _model(NULL)
+    : _rootJoint(NULL), _rootNode(NULL), _matrixPalette(NULL), _bindMatrices(NULL), _dualQuaternionPalette(NULL),
+      _partMatrixPalette(NULL), _partDualQuaternionPalette(NULL), _part(-1), _bindMatricesDirty(true), _matrixPaletteDirty(true), _dualQuaternionPaletteDirty(true), _model(NULL)
 {
 }
 
@@ -19,6 +118,10 @@ MeshSkin::~MeshSkin()
     clearJoints();
 
     SAFE_DELETE_ARRAY(_matrixPalette);
+    SAFE_DELETE_ARRAY(_bindMatrices);
+    SAFE_DELETE_ARRAY(_dualQuaternionPalette);
+    SAFE_DELETE_ARRAY(_partMatrixPalette);
+    SAFE_DELETE_ARRAY(_partDualQuaternionPalette);
 }
 
 const Matrix& MeshSkin::getBindShape() const
@@ -29,6 +132,7 @@ const Matrix& MeshSkin::getBindShape() const
 void MeshSkin::setBindShape(const float* matrix)
 {
     _bindShape.set(matrix);
+    setDirty(true);
 }
 
 unsigned int MeshSkin::getJointCount() const
@@ -105,6 +209,9 @@ MeshSkin* MeshSkin::clone(NodeCloneContext &context) const
             GP_ASSERT(newJoint);
             skin->setJoint(newJoint, i);
         }
+        skin->setPartPalettes(_partJoints);
+        skin->_boundedJoints = _boundedJoints;
+        skin->_jointBounds = _jointBounds;
     }
     return skin;
 }
@@ -121,11 +228,21 @@ void MeshSkin::setJointCount(unsigned int jointCount)
         _joints[i] = NULL;
     }
 
+    // The palettes of the parts and the joint bounds refer to the old joints.
+    _part = -1;
+    _partJoints.clear();
+    _boundedJoints.clear();
+    _jointBounds.clear();
+
     // Rebuild the matrix palette. Each matrix is 3 rows of Vector4.
     SAFE_DELETE_ARRAY(_matrixPalette);
+    SAFE_DELETE_ARRAY(_bindMatrices);
+    SAFE_DELETE_ARRAY(_dualQuaternionPalette);
+    setDirty(true);
 
     if (jointCount > 0)
     {
+        _bindMatrices = new float[jointCount * 16];
         _matrixPalette = new Vector4[jointCount * PALETTE_ROWS];
         for (unsigned int i = 0; i < jointCount * PALETTE_ROWS; i+=PALETTE_ROWS)
         {
@@ -153,23 +270,282 @@ void MeshSkin::setJoint(Joint* joint, unsigned int index)
         joint->addRef();
         joint->addSkin(this);
     }
+    setDirty(true);
 }
 
 Vector4* MeshSkin::getMatrixPalette() const
 {
     GP_ASSERT(_matrixPalette);
 
-    for (size_t i = 0, count = _joints.size(); i < count; i++)
+    if (_matrixPaletteDirty)
     {
-        GP_ASSERT(_joints[i]);
-        _joints[i]->updateJointMatrix(getBindShape(), &_matrixPalette[i * PALETTE_ROWS]);
+        updateMatrixPalette();
+    }
+    if (_part < 0)
+    {
+        return _matrixPalette;
     }
-    return _matrixPalette;
+
+    // Gather the rows of the joints of the part being drawn.
+    const std::vector<unsigned int>& joints = _partJoints[_part];
+    for (size_t i = 0, count = joints.size(); i < count; ++i)
+    {
+        memcpy(&_partMatrixPalette[i * PALETTE_ROWS], &_matrixPalette[joints[i] * PALETTE_ROWS], sizeof(Vector4) * PALETTE_ROWS);
+    }
+    return _partMatrixPalette;
 }
 
 unsigned int MeshSkin::getMatrixPaletteSize() const
 {
-    return (unsigned int)_joints.size() * PALETTE_ROWS;
+    return (_part < 0 ? (unsigned int)_joints.size() : (unsigned int)_partJoints[_part].size()) * PALETTE_ROWS;
+}
+
+unsigned int MeshSkin::getPartPaletteCount() const
+{
+    return (unsigned int)_partJoints.size();
+}
+
+unsigned int MeshSkin::getPartJointCount(unsigned int partIndex) const
+{
+    return partIndex < _partJoints.size() ? (unsigned int)_partJoints[partIndex].size() : (unsigned int)_joints.size();
+}
+
+Vector4* MeshSkin::getDualQuaternionPalette() const
+{
+    GP_ASSERT(_matrixPalette);
+
+    if (_matrixPaletteDirty)
+    {
+        updateMatrixPalette();
+    }
+    if (_dualQuaternionPaletteDirty)
+    {
+        updateDualQuaternionPalette();
+    }
+    if (_part < 0)
+    {
+        return _dualQuaternionPalette;
+    }
+
+    // Gather the dual quaternions of the joints of the part being drawn.
+    const std::vector<unsigned int>& joints = _partJoints[_part];
+    for (size_t i = 0, count = joints.size(); i < count; ++i)
+    {
+        memcpy(&_partDualQuaternionPalette[i * DUAL_QUATERNION_ROWS], &_dualQuaternionPalette[joints[i] * DUAL_QUATERNION_ROWS], sizeof(Vector4) * DUAL_QUATERNION_ROWS);
+    }
+    return _partDualQuaternionPalette;
+}
+
+unsigned int MeshSkin::getDualQuaternionPaletteSize() const
+{
+    return (_part < 0 ? (unsigned int)_joints.size() : (unsigned int)_partJoints[_part].size()) * DUAL_QUATERNION_ROWS;
+}
+
+void MeshSkin::updateDualQuaternionPalette() const
+{
+    const size_t count = _joints.size();
+    if (!_dualQuaternionPalette)
+    {
+        const_cast<MeshSkin*>(this)->_dualQuaternionPalette = new Vector4[count * DUAL_QUATERNION_ROWS];
+    }
+    for (size_t i = 0; i < count; ++i)
+    {
+        convertToDualQuaternion(&_matrixPalette[i * PALETTE_ROWS], &_dualQuaternionPalette[i * DUAL_QUATERNION_ROWS]);
+    }
+    _dualQuaternionPaletteDirty = false;
+}
+
+void MeshSkin::setPartPalettes(const std::vector<std::vector<unsigned int> >& partJoints)
+{
+    _part = -1;
+    _partJoints.clear();
+    SAFE_DELETE_ARRAY(_partMatrixPalette);
+    SAFE_DELETE_ARRAY(_partDualQuaternionPalette);
+
+    size_t maxCount = 0;
+    for (size_t i = 0, count = partJoints.size(); i < count; ++i)
+    {
+        for (size_t j = 0, jointCount = partJoints[i].size(); j < jointCount; ++j)
+        {
+            if (partJoints[i][j] >= _joints.size())
+            {
+                GP_WARN("Invalid joint index %u in the palette of mesh part %u; the parts will use the palette of all joints.", partJoints[i][j], (unsigned int)i);
+                return;
+            }
+        }
+        maxCount = std::max(maxCount, partJoints[i].size());
+    }
+    if (maxCount > 0)
+    {
+        _partJoints = partJoints;
+        _partMatrixPalette = new Vector4[maxCount * PALETTE_ROWS];
+        _partDualQuaternionPalette = new Vector4[maxCount * DUAL_QUATERNION_ROWS];
+    }
+}
+
+void MeshSkin::setPart(int partIndex)
+{
+    _part = partIndex >= 0 && partIndex < (int)_partJoints.size() ? partIndex : -1;
+}
+
+void MeshSkin::setDirty(bool bindMatrices) const
+{
+    // The bounds of the model follow the pose. They were computed along with the palette,
+    // so they only need to be marked dirty by the first joint that moves since.
+    if (!_matrixPaletteDirty && !_boundedJoints.empty() && _model && _model->getNode())
+        _model->getNode()->setBoundsDirty();
+
+    _bindMatricesDirty |= bindMatrices;
+    _matrixPaletteDirty = true;
+    _dualQuaternionPaletteDirty = true;
+}
+
+void MeshSkin::updateMatrixPalette() const
+{
+    const size_t count = _joints.size();
+    if (_bindMatricesDirty)
+    {
+        // The bind matrices only change when the skin is loaded or a bind pose is changed.
+        Matrix m;
+        for (size_t i = 0; i < count; ++i)
+        {
+            GP_ASSERT(_joints[i]);
+            Matrix::multiply(_joints[i]->getInverseBindPose(), _bindShape, &m);
+            m.transpose();
+            memcpy(_bindMatrices + i * 16, m.m, sizeof(float) * 16);
+        }
+        _bindMatricesDirty = false;
+    }
+
+    // Compute every palette matrix with a single product from the joint's world matrix.
+    float* palette = &_matrixPalette[0].x;
+    for (size_t i = 0; i < count; ++i)
+    {
+        GP_ASSERT(_joints[i]);
+        multiplyPaletteMatrix(_joints[i]->getWorldMatrix().m, _bindMatrices + i * 16, palette + i * PALETTE_ROWS * 4);
+    }
+    _matrixPaletteDirty = false;
+}
+
+void MeshSkin::setJointBounds(const std::vector<BoundingBox>& jointBounds)
+{
+    _boundedJoints.clear();
+    _jointBounds.clear();
+    for (size_t i = 0, count = std::min(jointBounds.size(), _joints.size()); i < count; ++i)
+    {
+        const BoundingBox& box = jointBounds[i];
+        if (box.min.x > box.max.x || box.min.y > box.max.y || box.min.z > box.max.z)
+            continue;
+
+        _boundedJoints.push_back((unsigned int)i);
+        _jointBounds.push_back(Vector4((box.min.x + box.max.x) * 0.5f, (box.min.y + box.max.y) * 0.5f, (box.min.z + box.max.z) * 0.5f, 1.0f));
+        _jointBounds.push_back(Vector4((box.max.x - box.min.x) * 0.5f, (box.max.y - box.min.y) * 0.5f, (box.max.z - box.min.z) * 0.5f, 0.0f));
+    }
+    if (_model && _model->getNode())
+        _model->getNode()->setBoundsDirty();
+}
+
+bool MeshSkin::computeBounds(BoundingBox* bounds) const
+{
+    GP_ASSERT(bounds);
+
+    if (_boundedJoints.empty() || _matrixPalette == NULL)
+        return false;
+    if (_matrixPaletteDirty)
+        updateMatrixPalette();
+
+    // Each box is transformed by its center and half extents: the center by the palette
+    // matrix, and the extents by the absolute values of its rotation and scale.
+    const float* palette = &_matrixPalette[0].x;
+    const float* jointBounds = &_jointBounds[0].x;
+#if defined(PALETTE_USE_SSE)
+    __m128 minimum = _mm_set1_ps(FLT_MAX);
+    __m128 maximum = _mm_set1_ps(-FLT_MAX);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    for (size_t i = 0, count = _boundedJoints.size(); i < count; ++i)
+    {
+        const float* rows = palette + _boundedJoints[i] * PALETTE_ROWS * 4;
+        __m128 center = _mm_loadu_ps(jointBounds + i * 8);
+        __m128 extents = _mm_loadu_ps(jointBounds + i * 8 + 4);
+        __m128 r0 = _mm_loadu_ps(rows);
+        __m128 r1 = _mm_loadu_ps(rows + 4);
+        __m128 r2 = _mm_loadu_ps(rows + 8);
+
+        // Sum the products of each row by transposing them, which leaves the dot products in x, y and z.
+        __m128 c0 = _mm_mul_ps(r0, center);
+        __m128 c1 = _mm_mul_ps(r1, center);
+        __m128 c2 = _mm_mul_ps(r2, center);
+        __m128 c3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        __m128 c = _mm_add_ps(_mm_add_ps(c0, c1), _mm_add_ps(c2, c3));
+
+        __m128 e0 = _mm_mul_ps(_mm_andnot_ps(sign, r0), extents);
+        __m128 e1 = _mm_mul_ps(_mm_andnot_ps(sign, r1), extents);
+        __m128 e2 = _mm_mul_ps(_mm_andnot_ps(sign, r2), extents);
+        __m128 e3 = _mm_setzero_ps();
+        _MM_TRANSPOSE4_PS(e0, e1, e2, e3);
+        __m128 e = _mm_add_ps(_mm_add_ps(e0, e1), _mm_add_ps(e2, e3));
+
+        minimum = _mm_min_ps(minimum, _mm_sub_ps(c, e));
+        maximum = _mm_max_ps(maximum, _mm_add_ps(c, e));
+    }
+    float result[8];
+    _mm_storeu_ps(result, minimum);
+    _mm_storeu_ps(result + 4, maximum);
+#elif defined(PALETTE_USE_NEON)
+    float32x4_t minimum = vdupq_n_f32(FLT_MAX);
+    float32x4_t maximum = vdupq_n_f32(-FLT_MAX);
+    for (size_t i = 0, count = _boundedJoints.size(); i < count; ++i)
+    {
+        const float* rows = palette + _boundedJoints[i] * PALETTE_ROWS * 4;
+        float32x4_t center = vld1q_f32(jointBounds + i * 8);
+        float32x4_t extents = vld1q_f32(jointBounds + i * 8 + 4);
+        float32x4x4_t c;
+        float32x4x4_t e;
+        for (unsigned int j = 0; j < PALETTE_ROWS; ++j)
+        {
+            float32x4_t r = vld1q_f32(rows + j * 4);
+            c.val[j] = vmulq_f32(r, center);
+            e.val[j] = vmulq_f32(vabsq_f32(r), extents);
+        }
+        c.val[3] = vdupq_n_f32(0.0f);
+        e.val[3] = vdupq_n_f32(0.0f);
+
+        // Sum the products of each row by transposing them, which leaves the dot products in x, y and z.
+        float32x4x2_t c01 = vtrnq_f32(c.val[0], c.val[1]);
+        float32x4x2_t c23 = vtrnq_f32(c.val[2], c.val[3]);
+        float32x4_t cs = vaddq_f32(vaddq_f32(vcombine_f32(vget_low_f32(c01.val[0]), vget_low_f32(c23.val[0])), vcombine_f32(vget_low_f32(c01.val[1]), vget_low_f32(c23.val[1]))),
+            vaddq_f32(vcombine_f32(vget_high_f32(c01.val[0]), vget_high_f32(c23.val[0])), vcombine_f32(vget_high_f32(c01.val[1]), vget_high_f32(c23.val[1]))));
+        float32x4x2_t e01 = vtrnq_f32(e.val[0], e.val[1]);
+        float32x4x2_t e23 = vtrnq_f32(e.val[2], e.val[3]);
+        float32x4_t es = vaddq_f32(vaddq_f32(vcombine_f32(vget_low_f32(e01.val[0]), vget_low_f32(e23.val[0])), vcombine_f32(vget_low_f32(e01.val[1]), vget_low_f32(e23.val[1]))),
+            vaddq_f32(vcombine_f32(vget_high_f32(e01.val[0]), vget_high_f32(e23.val[0])), vcombine_f32(vget_high_f32(e01.val[1]), vget_high_f32(e23.val[1]))));
+
+        minimum = vminq_f32(minimum, vsubq_f32(cs, es));
+        maximum = vmaxq_f32(maximum, vaddq_f32(cs, es));
+    }
+    float result[8];
+    vst1q_f32(result, minimum);
+    vst1q_f32(result + 4, maximum);
+#else
+    float result[8] = { FLT_MAX, FLT_MAX, FLT_MAX, 0.0f, -FLT_MAX, -FLT_MAX, -FLT_MAX, 0.0f };
+    for (size_t i = 0, count = _boundedJoints.size(); i < count; ++i)
+    {
+        const float* rows = palette + _boundedJoints[i] * PALETTE_ROWS * 4;
+        const float* center = jointBounds + i * 8;
+        const float* extents = center + 4;
+        for (unsigned int j = 0; j < PALETTE_ROWS; ++j)
+        {
+            const float* r = rows + j * 4;
+            float c = r[0] * center[0] + r[1] * center[1] + r[2] * center[2] + r[3];
+            float e = fabs(r[0]) * extents[0] + fabs(r[1]) * extents[1] + fabs(r[2]) * extents[2];
+            result[j] = std::min(result[j], c - e);
+            result[4 + j] = std::max(result[4 + j], c + e);
+        }
+    }
+#endif
+    bounds->set(result[0], result[1], result[2], result[4], result[5], result[6]);
+    return true;
 }
 
 Model* MeshSkin::getModel() const
@@ -252,12 +628,20 @@ void MeshSkin::setRootNode(Node* node)
 {
     if (_rootNode != node)
     {
+        // The joint hierarchy can be found through the node of the model.
+        Node* modelNode = _model ? _model->getNode() : NULL;
+        if (modelNode && modelNode->_nodeIndex)
+            modelNode->_nodeIndex->removeSkin(modelNode);
+
         SAFE_RELEASE(_rootNode);
         _rootNode = node;
         if (_rootNode)
         {
             _rootNode->addRef();
         }
+
+        if (modelNode && modelNode->_nodeIndex)
+            modelNode->_nodeIndex->addSkin(modelNode);
     }
 }
 
@@ -3,6 +3,7 @@
 
 #include "Matrix.h"
 #include "Transform.h"
+#include "BoundingBox.h"
 
 namespace gameplay
 {
@@ -19,6 +20,18 @@ class Joint;
  * vertex blending. This allows for a Model's mesh to support
  * a skeleton on joints that will influence the vertex position
  * and which the joints can be animated.
+ *
+ * The matrix palette is computed for all joints in one pass and cached
+ * until a joint, its bind pose or the bind shape changes, so drawing a
+ * skinned model several times in a frame (for example in multiple passes
+ * or into shadow maps) only computes the palette once.
+ *
+ * The encoder can split the parts of a skinned mesh so that each part only
+ * references a limited number of joints (see the -joints option). Each part
+ * then has a palette of its own, whose entries are the rows of its joints in
+ * the order that the blend indices of its vertices refer to them, and only
+ * that palette is uploaded while the part is drawn. Shared skeletons always
+ * use the palette of all joints, so they are not meant for split meshes.
  */
 class MeshSkin : public Transform::Listener
 {
@@ -27,6 +40,7 @@ class MeshSkin : public Transform::Listener
     friend class Joint;
     friend class Node;
     friend class Scene;
+    friend class NodeIndex;
 
 public:
 
@@ -92,6 +106,10 @@ public:
 
     /**
      * Returns the pointer to the Vector4 array for the purpose of binding to a shader.
+     *
+     * The palette is only recomputed if a joint moved since it was last returned.
+     * While a mesh part that has a palette of its own is drawn, only the rows of
+     * the joints of that part are returned.
      * 
      * @return The pointer to the matrix palette.
      */
@@ -106,6 +124,61 @@ public:
      */
     unsigned int getMatrixPaletteSize() const;
 
+    /**
+     * Computes the bounds of the skinned mesh in its current pose.
+     *
+     * The box of the vertices that each joint influences is transformed by the matrix
+     * palette, which the skin computes once per pose for drawing anyway, and the boxes of
+     * all joints are merged. Since every skinned vertex is a weighted average of its
+     * positions transformed by each of its joints, the result contains all of them.
+     *
+     * @param bounds Populated with the bounds, in the space of the node of the model.
+     *
+     * @return true if the bounds were computed, false if the skin has no joint bounds,
+     *      such as a skin loaded from a bundle encoded before version 1.10.
+     * @script{ignore}
+     */
+    bool computeBounds(BoundingBox* bounds) const;
+
+    /**
+     * Returns the number of mesh parts that have a palette of their own.
+     *
+     * @return The number of part palettes, or zero if every part uses the palette of all joints.
+     * @script{ignore}
+     */
+    unsigned int getPartPaletteCount() const;
+
+    /**
+     * Returns the number of joints in the palette of the given mesh part.
+     *
+     * @param partIndex The index of the mesh part.
+     *
+     * @return The number of joints of the part, or the number of joints of the skin if
+     *         the part doesn't have a palette of its own.
+     * @script{ignore}
+     */
+    unsigned int getPartJointCount(unsigned int partIndex) const;
+
+    /**
+     * Returns the joint transforms as dual quaternions for the purpose of binding to a shader.
+     *
+     * Each joint is represented by 2 Vector4's: the rotation quaternion followed by
+     * the dual part encoding the translation. This uploads two thirds of the data of
+     * the matrix palette and avoids the volume loss of blended matrices, but cannot
+     * represent scaled joints. Shaders use it when compiled with SKINNING_DUAL_QUATERNION.
+     *
+     * @return The pointer to the dual quaternion palette.
+     */
+    Vector4* getDualQuaternionPalette() const;
+
+    /**
+     * Returns the number of elements in the dual quaternion palette array.
+     * Each joint is represented by 2 Vector4's.
+     *
+     * @return The dual quaternion palette size.
+     */
+    unsigned int getDualQuaternionPaletteSize() const;
+
     /**
      * Returns our parent Model.
      */
@@ -175,6 +248,43 @@ private:
      */
     void clearJoints();
 
+    /**
+     * Marks the palettes for recomputation, and the bind matrices of the joints if
+     * a bind pose or the bind shape changed.
+     */
+    void setDirty(bool bindMatrices) const;
+
+    /**
+     * Computes the matrix palette of all joints.
+     */
+    void updateMatrixPalette() const;
+
+    /**
+     * Computes the dual quaternion palette of all joints.
+     */
+    void updateDualQuaternionPalette() const;
+
+    /**
+     * Sets the joints of the palette of each mesh part.
+     *
+     * @param partJoints The indices of the joints of each part, in palette order.
+     */
+    void setPartPalettes(const std::vector<std::vector<unsigned int> >& partJoints);
+
+    /**
+     * Sets the box of the vertices that each joint influences, in the space of the mesh vertices.
+     *
+     * @param jointBounds The box of each joint, which is empty for joints that influence no vertex.
+     */
+    void setJointBounds(const std::vector<BoundingBox>& jointBounds);
+
+    /**
+     * Sets the mesh part that is being drawn, which selects the palette that is returned.
+     *
+     * @param partIndex The index of the part, or -1 to return the palette of all joints.
+     */
+    void setPart(int partIndex);
+
     Matrix _bindShape;
     std::vector<Joint*> _joints;
     Joint* _rootJoint;
@@ -189,6 +299,28 @@ private:
     // Each 4x3 row-wise matrix is represented as 3 Vector4's.
     // The number of Vector4's is (_joints.size() * 3).
     Vector4* _matrixPalette;
+
+    // The inverse bind pose of every joint multiplied by the bind shape, stored
+    // row-wise as 4 rows of 4 floats so the palette rows can be computed directly.
+    float* _bindMatrices;
+
+    // Pointer to the array of dual quaternions, 2 Vector4's per joint, created on first use.
+    Vector4* _dualQuaternionPalette;
+    // The joints of the palette of each mesh part, or empty if every part uses the palette of all joints.
+    std::vector<std::vector<unsigned int> > _partJoints;
+
+    // The palettes of the part being drawn, gathered from the palettes of all joints.
+    Vector4* _partMatrixPalette;
+    Vector4* _partDualQuaternionPalette;
+    int _part;
+
+    // The joints that influence vertices, and the center and half extents of the box of
+    // their vertices, stored as 2 Vector4's per joint with a w of 1 and 0.
+    std::vector<unsigned int> _boundedJoints;
+    std::vector<Vector4> _jointBounds;
+    mutable bool _bindMatricesDirty;
+    mutable bool _matrixPaletteDirty;
+    mutable bool _dualQuaternionPaletteDirty;
     Model* _model;
 };
 
@@ -1,21 +1,34 @@
 #include "Base.h"
 #include "Model.h"
+#include "RenderStats.h"
 #include "MeshPart.h"
 #include "Scene.h"
+#include "NodeIndex.h"
 #include "Technique.h"
 #include "Pass.h"
 #include "Node.h"
+#include "Impostor.h"
+#include "Game.h"
+#include "TextureStreamer.h"
+#include "InstanceCuller.h"
+#include "Profiler.h"
 
 namespace gameplay
 {
 
+static bool __depthPrePass = false;
+
 Model::Model() : Drawable(),
-    _mesh(NULL), _material(NULL), _partCount(0), _partMaterials(NULL), _skin(NULL)
+    _mesh(NULL), _material(NULL), _partCount(0), _partMaterials(NULL), _skin(NULL),
+    _instanceBuffer(0), _instanceBufferDirty(false), _instanceCuller(NULL), _impostor(NULL), _impostorDistance(0.0f),
+    _currentLOD(0), _lodCamera(NULL), _lodFrame(0), _lightmap(NULL), _lightmapScaleOffset(1.0f, 1.0f, 0.0f, 0.0f)
 {
 }
 
 Model::Model(Mesh* mesh) : Drawable(),
-    _mesh(mesh), _material(NULL), _partCount(0), _partMaterials(NULL), _skin(NULL)
+    _mesh(mesh), _material(NULL), _partCount(0), _partMaterials(NULL), _skin(NULL),
+    _instanceBuffer(0), _instanceBufferDirty(false), _instanceCuller(NULL), _impostor(NULL), _impostorDistance(0.0f),
+    _currentLOD(0), _lodCamera(NULL), _lodFrame(0), _lightmap(NULL), _lightmapScaleOffset(1.0f, 1.0f, 0.0f, 0.0f)
 {
     GP_ASSERT(mesh);
     _partCount = mesh->getPartCount();
@@ -34,6 +47,23 @@ Model::~Model()
     }
     SAFE_RELEASE(_mesh);
     SAFE_DELETE(_skin);
+    SAFE_RELEASE(_impostor);
+    SAFE_RELEASE(_lightmap);
+    for (size_t i = 0, count = _lods.size(); i < count; ++i)
+    {
+        for (size_t j = 0, bindingCount = _lods[i].bindings.size(); j < bindingCount; ++j)
+        {
+            SAFE_RELEASE(_lods[i].bindings[j].second);
+        }
+        SAFE_RELEASE(_lods[i].mesh);
+    }
+
+    SAFE_DELETE(_instanceCuller);
+    if (_instanceBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_instanceBuffer) );
+        _instanceBuffer = 0;
+    }
 }
 
 Model* Model::create(Mesh* mesh)
@@ -151,6 +181,10 @@ void Model::setMaterial(Material* material, int partIndex)
             {
                 Pass* p = t->getPassByIndex(j);
                 GP_ASSERT(p);
+
+                // Bindings for effects that are still compiling are created once they are drawn.
+                if (!p->getEffect()->isReady())
+                    continue;
                 VertexAttributeBinding* b = VertexAttributeBinding::create(_mesh, p->getEffect());
                 p->setVertexAttributeBinding(b);
                 SAFE_RELEASE(b);
@@ -207,6 +241,30 @@ bool Model::hasMaterial(unsigned int partIndex) const
     return (partIndex < _partCount && _partMaterials && _partMaterials[partIndex]);
 }
 
+Material* Model::getUniqueMaterial(int partIndex)
+{
+    Material* material = getMaterial(partIndex);
+    if (material == NULL)
+        return NULL;
+
+    // A part that uses the shared material also gets a material of its own, since the
+    // shared material is used by the other parts.
+    if (material->getRefCount() > 1 || (partIndex >= 0 && !hasMaterial(partIndex)))
+    {
+        NodeCloneContext context;
+        Material* copy = material->clone(context);
+        if (copy == NULL)
+        {
+            GP_ERROR("Failed to clone material for model.");
+            return NULL;
+        }
+        setMaterial(copy, partIndex);
+        copy->release();
+        material = copy;
+    }
+    return material;
+}
+
 MeshSkin* Model::getSkin() const
 {
     return _skin;
@@ -216,6 +274,11 @@ void Model::setSkin(MeshSkin* skin)
 {
     if (_skin != skin)
     {
+        // The joint hierarchy of the skin can be found through the node of the model.
+        Node* node = getNode();
+        if (node && node->_nodeIndex)
+            node->_nodeIndex->removeSkin(node);
+
         // Free the old skin
         SAFE_DELETE(_skin);
 
@@ -223,11 +286,29 @@ void Model::setSkin(MeshSkin* skin)
         _skin = skin;
         if (_skin)
             _skin->_model = this;
+
+        if (node && node->_nodeIndex)
+            node->_nodeIndex->addSkin(node);
     }
 }
 
 void Model::setNode(Node* node)
 {
+    // Materials shared with other models must not keep pointing at a node that may be destroyed.
+    if (_node && _node != node)
+    {
+        if (_material)
+            clearMaterialNodeBinding(_material, _node);
+        if (_partMaterials)
+        {
+            for (unsigned int i = 0; i < _partCount; ++i)
+            {
+                if (_partMaterials[i])
+                    clearMaterialNodeBinding(_partMaterials[i], _node);
+            }
+        }
+    }
+
     Drawable::setNode(node);
 
     // Re-bind node related material parameters
@@ -283,6 +364,7 @@ static bool drawWireframe(Mesh* mesh)
 static bool drawWireframe(MeshPart* part)
 {
     unsigned int indexCount = part->getIndexCount();
+    size_t indexOffset = part->getIndexOffset();
     unsigned int indexSize = 0;
     switch (part->getIndexFormat())
     {
@@ -306,7 +388,7 @@ static bool drawWireframe(MeshPart* part)
         {
             for (size_t i = 0; i < indexCount; i += 3)
             {
-                GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(i*indexSize))) );
+                GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(indexOffset + i*indexSize))) );
             }
         }
         return true;
@@ -315,7 +397,7 @@ static bool drawWireframe(MeshPart* part)
         {
             for (size_t i = 2; i < indexCount; ++i)
             {
-                GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)((i-2)*indexSize))) );
+                GL_ASSERT( glDrawElements(GL_LINE_LOOP, 3, part->getIndexFormat(), ((const GLvoid*)(indexOffset + (i-2)*indexSize))) );
             }
         }
         return true;
@@ -328,28 +410,45 @@ static bool drawWireframe(MeshPart* part)
 
 unsigned int Model::draw(bool wireframe)
 {
+    GP_PROFILE("Model::draw");
+
     GP_ASSERT(_mesh);
 
-    unsigned int partCount = _mesh->getPartCount();
+    // Far away models are queued on their impostor instead of being drawn.
+    if (_impostor && _node)
+    {
+        Scene* scene = _node->getScene();
+        Camera* camera = scene ? scene->getActiveCamera() : NULL;
+        if (camera && camera->getNode() &&
+            camera->getNode()->getTranslationWorld().distanceSquared(_node->getTranslationWorld()) > _impostorDistance * _impostorDistance)
+        {
+            _impostor->add(_node);
+            return 0;
+        }
+    }
+
+    Mesh* mesh = selectLOD(NULL);
+
+    // Streamed textures are requested at the number of pixels covered by the model.
+    float screenSize;
+    bool streaming = TextureStreamer::isEnabled() && TextureStreamer::getTextureCount() > 0 && _node && _node->getScene() &&
+        getScreenSize(_node->getScene()->getActiveCamera(), &screenSize);
+    if (streaming)
+        TextureStreamer::setDrawResolution(std::max(screenSize * Game::getInstance()->getViewport().height, 1.0f));
+
+    unsigned int partCount = mesh->getPartCount();
     if (partCount == 0)
     {
         // No mesh parts (index buffers).
         if (_material)
         {
-            Technique* technique = _material->getTechnique();
-            GP_ASSERT(technique);
-            unsigned int passCount = technique->getPassCount();
+            Technique* technique = _material->getReadyTechnique();
+            unsigned int passCount = technique ? technique->getPassCount() : 0;
             for (unsigned int i = 0; i < passCount; ++i)
             {
                 Pass* pass = technique->getPassByIndex(i);
                 GP_ASSERT(pass);
-                pass->bind();
-                GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0) );
-                if (!wireframe || !drawWireframe(_mesh))
-                {
-                    GL_ASSERT( glDrawArrays(_mesh->getPrimitiveType(), 0, _mesh->getVertexCount()) );
-                }
-                pass->unbind();
+                drawPass(NULL, pass, wireframe);
             }
         }
     }
@@ -357,34 +456,552 @@ unsigned int Model::draw(bool wireframe)
     {
         for (unsigned int i = 0; i < partCount; ++i)
         {
-            MeshPart* part = _mesh->getPart(i);
+            MeshPart* part = mesh->getPart(i);
             GP_ASSERT(part);
 
             // Get the material for this mesh part.
             Material* material = getMaterial(i);
             if (material)
             {
-                Technique* technique = material->getTechnique();
-                GP_ASSERT(technique);
-                unsigned int passCount = technique->getPassCount();
+                // The skin only binds the joints of the part if the part has a palette of its own.
+                if (_skin)
+                    _skin->setPart((int)i);
+
+                Technique* technique = material->getReadyTechnique();
+                unsigned int passCount = technique ? technique->getPassCount() : 0;
                 for (unsigned int j = 0; j < passCount; ++j)
                 {
                     Pass* pass = technique->getPassByIndex(j);
                     GP_ASSERT(pass);
-                    pass->bind();
-                    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part->_indexBuffer) );
-                    if (!wireframe || !drawWireframe(part))
-                    {
-                        GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), 0) );
-                    }
-                    pass->unbind();
+                    drawPass(part, pass, wireframe);
                 }
             }
         }
+        if (_skin)
+            _skin->setPart(-1);
     }
+
+    if (streaming)
+        TextureStreamer::setDrawResolution(0.0f);
     return partCount;
 }
 
+void Model::setDepthPrePass(bool depthPrePass)
+{
+    __depthPrePass = depthPrePass;
+}
+
+void Model::drawPass(MeshPart* part, Pass* pass, bool wireframe)
+{
+    GP_ASSERT(pass);
+
+    if (__depthPrePass)
+    {
+        // The first pass of a technique lays down the depth that its other passes draw over.
+        if (pass->_technique && pass->_technique->getPassByIndex(0) != pass)
+            return;
+        pass = pass->getDepthPass();
+        if (!pass)
+            return;
+    }
+
+    // A material that is shared by several models is bound to the node of the model drawn with it.
+    if (_node && pass->_nodeBinding != _node)
+    {
+        RenderState* material = pass;
+        while (material->_parent)
+            material = material->_parent;
+        material->setNodeBinding(_node);
+    }
+
+#ifndef GP_NO_PROFILER
+    // Each draw of a material is measured as a zone named after the material.
+    const char* materialName = NULL;
+    if (Profiler::isMaterialTimingEnabled())
+    {
+        RenderState* material = pass;
+        while (material->_parent)
+            material = material->_parent;
+        materialName = static_cast<Material*>(material)->getProfilerName();
+    }
+    Profiler::GpuZone materialZone(materialName);
+#endif
+
+    if (pass->getVertexAttributeBinding() == NULL)
+    {
+        // The effect of this pass finished compiling after the material was set.
+        VertexAttributeBinding* b = VertexAttributeBinding::create(_mesh, pass->getEffect());
+        pass->setVertexAttributeBinding(b);
+        SAFE_RELEASE(b);
+    }
+    pass->bind();
+
+    // Levels of detail are drawn with the pass of the mesh of the model, but with the
+    // vertex buffer of their own mesh.
+    Mesh* mesh = part ? part->_mesh : getLODMesh(_currentLOD);
+    VertexAttributeBinding* lodBinding = mesh != _mesh ? getLODBinding(mesh, pass->getEffect()) : NULL;
+    if (lodBinding)
+        lodBinding->bind();
+
+    // No mesh parts (index buffers) draw without one.
+    VertexAttributeBinding* binding = lodBinding ? lodBinding : pass->getVertexAttributeBinding();
+    if (binding)
+    {
+        binding->bindIndexBuffer(part ? part->_indexBuffer : 0);
+    }
+    else
+    {
+        GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, part ? part->_indexBuffer : 0) );
+        if (part)
+            RenderStats::count(RenderStats::BUFFER_BINDS);
+    }
+
+    unsigned int instanceCount = getInstanceCount();
+    if (instanceCount == 0)
+    {
+        drawMesh(mesh, part, wireframe, 0);
+    }
+    else if (isInstancingSupported() && !wireframe)
+    {
+        // Once culled on the GPU, the visible instances and their counts are only known to the GPU.
+        Effect* effect = pass->getEffect();
+        if (_instanceCuller && _instanceCuller->isCulled(mesh))
+        {
+            bindInstances(effect, _instanceCuller->_visibleBuffer);
+            _instanceCuller->draw(mesh, part);
+        }
+        else
+        {
+            bindInstances(effect, updateInstanceBuffer());
+            drawMesh(mesh, part, false, instanceCount);
+        }
+        unbindInstances(effect);
+    }
+    else
+    {
+        // Without hardware instancing, the instance attributes are set to constant
+        // values and the mesh is drawn once per instance.
+        Effect* effect = pass->getEffect();
+        VertexAttribute matrixAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME);
+        VertexAttribute colorAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_COLOR_NAME);
+        VertexAttribute poseAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_POSE_NAME);
+        for (unsigned int i = 0; i < instanceCount; ++i)
+        {
+            const float* instance = &_instanceData[i * MODEL_INSTANCE_SIZE];
+            if (matrixAttrib != -1)
+            {
+                for (unsigned int column = 0; column < 4; ++column)
+                {
+                    GL_ASSERT( glVertexAttrib4fv(matrixAttrib + column, instance + column * 4) );
+                }
+            }
+            if (colorAttrib != -1)
+            {
+                GL_ASSERT( glVertexAttrib4fv(colorAttrib, instance + 16) );
+            }
+            if (poseAttrib != -1)
+            {
+                GL_ASSERT( glVertexAttrib1f(poseAttrib, instance[20]) );
+            }
+            drawMesh(mesh, part, wireframe, 0);
+        }
+    }
+    if (lodBinding)
+        lodBinding->unbind();
+    pass->unbind();
+}
+
+void Model::drawMesh(Mesh* mesh, MeshPart* part, bool wireframe, unsigned int instanceCount)
+{
+    if (part)
+    {
+        if (!wireframe || !drawWireframe(part))
+        {
+            if (instanceCount > 0)
+            {
+                GL_ASSERT( glDrawElementsInstanced(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), (const GLvoid*)(size_t)part->getIndexOffset(), instanceCount) );
+                RenderStats::count(RenderStats::DRAW_CALLS);
+            }
+            else
+            {
+                GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), (const GLvoid*)(size_t)part->getIndexOffset()) );
+                RenderStats::count(RenderStats::DRAW_CALLS);
+            }
+        }
+    }
+    else
+    {
+        if (!wireframe || !drawWireframe(mesh))
+        {
+            if (instanceCount > 0)
+            {
+                GL_ASSERT( glDrawArraysInstanced(mesh->getPrimitiveType(), 0, mesh->getVertexCount(), instanceCount) );
+                RenderStats::count(RenderStats::DRAW_CALLS);
+            }
+            else
+            {
+                GL_ASSERT( glDrawArrays(mesh->getPrimitiveType(), 0, mesh->getVertexCount()) );
+                RenderStats::count(RenderStats::DRAW_CALLS);
+            }
+        }
+    }
+}
+
+void Model::setInstances(const Matrix* transforms, const Vector4* colors, unsigned int count)
+{
+    GP_ASSERT(transforms || count == 0);
+
+    unsigned int previousCount = getInstanceCount();
+    _instanceData.resize(count * MODEL_INSTANCE_SIZE);
+    _instanceBufferDirty = true;
+    if (_instanceCuller)
+        _instanceCuller->invalidate();
+
+    GP_ASSERT(_mesh);
+    const BoundingSphere& meshBounds = _mesh->getBoundingSphere();
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        float* instance = &_instanceData[i * MODEL_INSTANCE_SIZE];
+        memcpy(instance, transforms[i].m, sizeof(float) * 16);
+        const Vector4& color = colors ? colors[i] : Vector4::one();
+        instance[16] = color.x;
+        instance[17] = color.y;
+        instance[18] = color.z;
+        instance[19] = color.w;
+        if (i >= previousCount)
+            instance[20] = 0.0f;
+
+        BoundingSphere bounds(meshBounds);
+        bounds.transform(transforms[i]);
+        if (i == 0)
+            _instanceBounds.set(bounds);
+        else
+            _instanceBounds.merge(bounds);
+    }
+
+    if (_node)
+        _node->setBoundsDirty();
+}
+
+void Model::setInstances(Node** nodes, const Vector4* colors, unsigned int count)
+{
+    GP_ASSERT(nodes || count == 0);
+
+    std::vector<Matrix> transforms(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        GP_ASSERT(nodes[i]);
+        transforms[i] = nodes[i]->getWorldMatrix();
+    }
+    setInstances(count > 0 ? &transforms[0] : NULL, colors, count);
+}
+
+void Model::setInstancePoses(const unsigned int* poses, unsigned int count)
+{
+    GP_ASSERT(poses || count == 0);
+    GP_ASSERT(count == getInstanceCount());
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _instanceData[i * MODEL_INSTANCE_SIZE + 20] = (float)poses[i];
+    }
+    _instanceBufferDirty = true;
+    if (_instanceCuller)
+        _instanceCuller->invalidate();
+}
+
+unsigned int Model::getInstanceCount() const
+{
+    return (unsigned int)(_instanceData.size() / MODEL_INSTANCE_SIZE);
+}
+
+bool Model::setInstanceCulling(bool enabled)
+{
+    if (!enabled)
+    {
+        SAFE_DELETE(_instanceCuller);
+        return true;
+    }
+    if (!InstanceCuller::isSupported())
+        return false;
+    if (!_instanceCuller)
+        _instanceCuller = new InstanceCuller(this);
+    return true;
+}
+
+InstanceCuller* Model::getInstanceCuller() const
+{
+    return _instanceCuller;
+}
+
+bool Model::isInstancingSupported()
+{
+#if defined(__ANDROID__) || defined(WIN32) || defined(__linux__)
+    // The instancing functions are only available if the device supports them.
+    return glDrawArraysInstanced && glDrawElementsInstanced && glVertexAttribDivisor;
+#else
+    static int __instancingSupported = -1;
+    if (__instancingSupported == -1)
+    {
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        __instancingSupported = (extensions && (strstr(extensions, "GL_EXT_instanced_arrays") || strstr(extensions, "GL_ARB_instanced_arrays"))) ? 1 : 0;
+    }
+    return __instancingSupported == 1;
+#endif
+}
+
+void Model::setImpostor(Impostor* impostor, float distance)
+{
+    if (impostor)
+        impostor->addRef();
+    SAFE_RELEASE(_impostor);
+    _impostor = impostor;
+    _impostorDistance = distance;
+}
+
+Impostor* Model::getImpostor() const
+{
+    return _impostor;
+}
+
+float Model::getImpostorDistance() const
+{
+    return _impostorDistance;
+}
+
+void Model::setLightmap(Texture::Sampler* sampler)
+{
+    if (sampler)
+        sampler->addRef();
+    SAFE_RELEASE(_lightmap);
+    _lightmap = sampler;
+}
+
+Texture::Sampler* Model::getLightmap() const
+{
+    return _lightmap;
+}
+
+void Model::setLightmapScaleOffset(const Vector4& scaleOffset)
+{
+    _lightmapScaleOffset = scaleOffset;
+}
+
+const Vector4& Model::getLightmapScaleOffset() const
+{
+    return _lightmapScaleOffset;
+}
+
+void Model::addLOD(Mesh* mesh, float screenSize)
+{
+    GP_ASSERT(mesh);
+    GP_ASSERT(_mesh);
+
+    if (mesh->getPartCount() != _mesh->getPartCount())
+    {
+        GP_WARN("Failed to add level of detail with %u mesh parts to a model with %u mesh parts.", mesh->getPartCount(), _mesh->getPartCount());
+        return;
+    }
+    GP_ASSERT(screenSize < getLODScreenSize(getLODCount() - 1));
+
+    mesh->addRef();
+    LOD lod;
+    lod.mesh = mesh;
+    lod.screenSize = screenSize;
+    _lods.push_back(lod);
+
+    // Select the level again the next time the model is drawn.
+    _lodCamera = NULL;
+}
+
+unsigned int Model::getLODCount() const
+{
+    return (unsigned int)_lods.size() + 1;
+}
+
+Mesh* Model::getLODMesh(unsigned int index) const
+{
+    GP_ASSERT(index < getLODCount());
+    return index == 0 ? _mesh : _lods[index - 1].mesh;
+}
+
+float Model::getLODScreenSize(unsigned int index) const
+{
+    GP_ASSERT(index < getLODCount());
+    return index == 0 ? 1.0f : _lods[index - 1].screenSize;
+}
+
+unsigned int Model::getCurrentLOD() const
+{
+    return _currentLOD;
+}
+
+Mesh* Model::selectLOD(Camera* camera)
+{
+    GP_ASSERT(_mesh);
+
+    if (_lods.empty())
+        return _mesh;
+
+    if (!camera && _node && _node->getScene())
+        camera = _node->getScene()->getActiveCamera();
+
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    if (camera == _lodCamera && frame == _lodFrame)
+        return getLODMesh(_currentLOD);
+    _lodCamera = camera;
+    _lodFrame = frame;
+
+    // Levels are sorted by decreasing screen size, so the model is drawn with the
+    // last level whose screen size it is smaller than.
+    _currentLOD = 0;
+    float screenSize;
+    if (getScreenSize(camera, &screenSize))
+    {
+        while (_currentLOD < _lods.size() && screenSize < _lods[_currentLOD].screenSize)
+            ++_currentLOD;
+    }
+    return getLODMesh(_currentLOD);
+}
+
+bool Model::getScreenSize(Camera* camera, float* screenSize) const
+{
+    GP_ASSERT(screenSize);
+
+    if (!camera || !camera->getNode() || !_node)
+        return false;
+
+    BoundingSphere bounds(getBoundingSphere());
+    bounds.transform(_node->getWorldMatrix());
+
+    // The height of the view at the distance of the model, in world units.
+    float height;
+    if (camera->getCameraType() == Camera::PERSPECTIVE)
+    {
+        float distance = camera->getNode()->getTranslationWorld().distance(bounds.center);
+        height = 2.0f * distance * tanf(MATH_DEG_TO_RAD(camera->getFieldOfView()) * 0.5f);
+    }
+    else
+    {
+        height = camera->getZoomY();
+    }
+    if (height <= 0.0f)
+        return false;
+
+    *screenSize = bounds.radius * 2.0f / height;
+    return true;
+}
+
+VertexAttributeBinding* Model::getLODBinding(Mesh* mesh, Effect* effect)
+{
+    GP_ASSERT(effect);
+
+    for (size_t i = 0, count = _lods.size(); i < count; ++i)
+    {
+        LOD& lod = _lods[i];
+        if (lod.mesh != mesh)
+            continue;
+
+        for (size_t j = 0, bindingCount = lod.bindings.size(); j < bindingCount; ++j)
+        {
+            if (lod.bindings[j].first == effect)
+                return lod.bindings[j].second;
+        }
+        VertexAttributeBinding* binding = VertexAttributeBinding::create(mesh, effect);
+        if (binding)
+            lod.bindings.push_back(std::make_pair(effect, binding));
+        return binding;
+    }
+    return NULL;
+}
+
+VertexBufferHandle Model::updateInstanceBuffer()
+{
+    if (_instanceBuffer == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &_instanceBuffer) );
+        _instanceBufferDirty = true;
+    }
+    if (_instanceBufferDirty && !_instanceData.empty())
+    {
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+        GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, _instanceData.size() * sizeof(float), &_instanceData[0], GL_DYNAMIC_DRAW) );
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+        _instanceBufferDirty = false;
+    }
+    return _instanceBuffer;
+}
+
+void Model::bindInstances(Effect* effect, VertexBufferHandle buffer)
+{
+    GP_ASSERT(effect);
+
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, buffer) );
+
+    // A matrix attribute occupies four consecutive attribute locations, one for each column.
+    GLsizei stride = MODEL_INSTANCE_SIZE * sizeof(float);
+    VertexAttribute matrixAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME);
+    if (matrixAttrib != -1)
+    {
+        for (unsigned int column = 0; column < 4; ++column)
+        {
+            GL_ASSERT( glVertexAttribPointer(matrixAttrib + column, 4, GL_FLOAT, GL_FALSE, stride, (void*)(column * 4 * sizeof(float))) );
+            GL_ASSERT( glEnableVertexAttribArray(matrixAttrib + column) );
+            GL_ASSERT( glVertexAttribDivisor(matrixAttrib + column, 1) );
+        }
+    }
+    VertexAttribute colorAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_COLOR_NAME);
+    if (colorAttrib != -1)
+    {
+        GL_ASSERT( glVertexAttribPointer(colorAttrib, 4, GL_FLOAT, GL_FALSE, stride, (void*)(16 * sizeof(float))) );
+        GL_ASSERT( glEnableVertexAttribArray(colorAttrib) );
+        GL_ASSERT( glVertexAttribDivisor(colorAttrib, 1) );
+    }
+    VertexAttribute poseAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_POSE_NAME);
+    if (poseAttrib != -1)
+    {
+        GL_ASSERT( glVertexAttribPointer(poseAttrib, 1, GL_FLOAT, GL_FALSE, stride, (void*)(20 * sizeof(float))) );
+        GL_ASSERT( glEnableVertexAttribArray(poseAttrib) );
+        GL_ASSERT( glVertexAttribDivisor(poseAttrib, 1) );
+    }
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+}
+
+void Model::unbindInstances(Effect* effect)
+{
+    GP_ASSERT(effect);
+
+    // The attribute state may belong to a vertex array object that is shared with
+    // models that are not instanced, so it has to be reset while it is still bound.
+    VertexAttribute matrixAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_MATRIX_NAME);
+    if (matrixAttrib != -1)
+    {
+        for (unsigned int column = 0; column < 4; ++column)
+        {
+            GL_ASSERT( glVertexAttribDivisor(matrixAttrib + column, 0) );
+            GL_ASSERT( glDisableVertexAttribArray(matrixAttrib + column) );
+        }
+    }
+    VertexAttribute colorAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_COLOR_NAME);
+    if (colorAttrib != -1)
+    {
+        GL_ASSERT( glVertexAttribDivisor(colorAttrib, 0) );
+        GL_ASSERT( glDisableVertexAttribArray(colorAttrib) );
+    }
+    VertexAttribute poseAttrib = effect->getVertexAttribute(VERTEX_ATTRIBUTE_INSTANCE_POSE_NAME);
+    if (poseAttrib != -1)
+    {
+        GL_ASSERT( glVertexAttribDivisor(poseAttrib, 0) );
+        GL_ASSERT( glDisableVertexAttribArray(poseAttrib) );
+    }
+}
+
+const BoundingSphere& Model::getBoundingSphere() const
+{
+    GP_ASSERT(_mesh);
+    return _instanceData.empty() ? _mesh->getBoundingSphere() : _instanceBounds;
+}
+
 void Model::setMaterialNodeBinding(Material *material)
 {
     GP_ASSERT(material);
@@ -395,6 +1012,16 @@ void Model::setMaterialNodeBinding(Material *material)
     }
 }
 
+void Model::clearMaterialNodeBinding(Material* material, Node* node)
+{
+    GP_ASSERT(material);
+
+    if (material->_nodeBinding == node)
+    {
+        material->setNodeBinding(NULL);
+    }
+}
+
 Drawable* Model::clone(NodeCloneContext& context)
 {
     Model* model = Model::create(getMesh());
@@ -408,6 +1035,37 @@ Drawable* Model::clone(NodeCloneContext& context)
     {
         model->setSkin(getSkin()->clone(context));
     }
+    if (!_instanceData.empty())
+    {
+        model->_instanceData = _instanceData;
+        model->_instanceBounds = _instanceBounds;
+        model->_instanceBufferDirty = true;
+    }
+    if (_instanceCuller)
+        model->setInstanceCulling(true);
+    model->setImpostor(_impostor, _impostorDistance);
+    model->setLightmap(_lightmap);
+    model->_lightmapScaleOffset = _lightmapScaleOffset;
+    for (size_t i = 0, count = _lods.size(); i < count; ++i)
+    {
+        model->addLOD(_lods[i].mesh, _lods[i].screenSize);
+    }
+    if (context.getShareMaterials())
+    {
+        // Instances share the materials, which are bound to the node of each model when it is drawn.
+        if (getMaterial())
+            model->setMaterial(getMaterial());
+        if (_partMaterials)
+        {
+            GP_ASSERT(_partCount == model->_partCount);
+            for (unsigned int i = 0; i < _partCount; ++i)
+            {
+                if (_partMaterials[i])
+                    model->setMaterial(_partMaterials[i], i);
+            }
+        }
+        return model;
+    }
     if (getMaterial())
     {
         Material* materialClone = getMaterial()->clone(context);
@@ -5,11 +5,18 @@
 #include "MeshSkin.h"
 #include "Material.h"
 #include "Drawable.h"
+#include "ObjectPool.h"
+
+// The number of floats stored per instance: a 4x4 transform followed by an RGBA color and a pose index.
+#define MODEL_INSTANCE_SIZE 21
 
 namespace gameplay
 {
 
 class Bundle;
+class Camera;
+class Impostor;
+class InstanceCuller;
 class MeshSkin;
 
 
@@ -17,7 +24,9 @@ class MeshSkin;
  * Defines a Model or mesh renderer which is an instance of a Mesh. 
  *
  * A model has a mesh that can be drawn with the specified materials for
- * each of the mesh parts within it.
+ * each of the mesh parts within it. It may also have simplified levels of detail,
+ * which are drawn in place of the mesh when the model covers a small part of the
+ * screen, using the same materials.
  */
 class Model : public Ref, public Drawable
 {
@@ -25,9 +34,14 @@ class Model : public Ref, public Drawable
     friend class Scene;
     friend class Mesh;
     friend class Bundle;
+    friend class RenderQueue;
+    friend class CommandBuffer;
+    friend class InstanceCuller;
 
 public:
 
+    GP_POOLED_OBJECT(Model);
+
     /**
      * Creates a new Model.
      * @script{create}
@@ -123,6 +137,22 @@ public:
      */
     bool hasMaterial(unsigned int partIndex) const;
 
+    /**
+     * Returns a material for the specified mesh part that only this model uses, which
+     * can be changed without affecting other models.
+     *
+     * Models instantiated from a Prefab share the materials of the prefab. The first
+     * time the material of such a model is changed through this method, it is cloned
+     * and set on the model, like a copy-on-write. A material that only this model
+     * references is returned as is.
+     *
+     * @param partIndex The index of the mesh part whose Material to return (-1 for shared material).
+     *
+     * @return The material of the mesh part, or NULL if no Material is set.
+     * @script{ignore}
+     */
+    Material* getUniqueMaterial(int partIndex = -1);
+
     /**
      * Returns the MeshSkin.
      *
@@ -141,8 +171,239 @@ public:
      */
     unsigned int draw(bool wireframe = false);
 
+    /**
+     * Sets the instances of this model to draw.
+     *
+     * When a model has instances, every mesh part is drawn once per instance with a
+     * single instanced draw call, using a per-instance vertex buffer that holds the
+     * transform and color of each instance. Instance transforms are relative to the
+     * node this model is attached to. The effect of the material must read the
+     * transform and color from the a_instanceMatrix and a_instanceColor attributes,
+     * which the built-in shaders do when INSTANCING is defined.
+     *
+     * On devices that don't support hardware instancing, every instance is drawn
+     * with a separate draw call, but passes are still only bound once per mesh part.
+     *
+     * Passing a count of zero removes all instances, which draws the model once
+     * without any instance attributes.
+     *
+     * @param transforms The transform of each instance.
+     * @param colors The color of each instance, or NULL to use white for all instances.
+     * @param count The number of instances.
+     * @script{ignore}
+     */
+    void setInstances(const Matrix* transforms, const Vector4* colors, unsigned int count);
+
+    /**
+     * Sets the instances of this model to draw from the world transforms of the given nodes.
+     *
+     * The world matrices of the nodes are copied, so this method must be called again
+     * after any of the nodes moves. The model itself should be attached to a node
+     * with an identity transform, since instance transforms are relative to it.
+     *
+     * @param nodes The nodes to use the world transforms of.
+     * @param colors The color of each instance, or NULL to use white for all instances.
+     * @param count The number of nodes.
+     * @script{ignore}
+     *
+     * @see setInstances(const Matrix*, const Vector4*, unsigned int)
+     */
+    void setInstances(Node** nodes, const Vector4* colors, unsigned int count);
+
+    /**
+     * Sets the pose that each instance of this model is drawn with.
+     *
+     * Poses index the rows of the palette texture of a SharedSkeleton and are read
+     * by effects compiled with SKINNING_POSE_TEXTURE from the a_instancePose attribute.
+     * Instances keep their pose when setInstances is called again, and new instances
+     * are drawn with the first pose.
+     *
+     * @param poses The pose of each instance.
+     * @param count The number of poses, which must match the number of instances.
+     * @script{ignore}
+     *
+     * @see SharedSkeleton
+     */
+    void setInstancePoses(const unsigned int* poses, unsigned int count);
+
+    /**
+     * Returns the number of instances of this model.
+     *
+     * @return The number of instances, or zero if the model is not instanced.
+     */
+    unsigned int getInstanceCount() const;
+
+    /**
+     * Determines if the current device supports hardware instancing.
+     *
+     * @return True if instanced draw calls are supported, false otherwise.
+     */
+    static bool isInstancingSupported();
+
+    /**
+     * Sets whether the instances of this model are culled on the GPU.
+     *
+     * Once enabled, InstanceCuller::cull must be called on the culler of this model
+     * every frame before it is drawn, and the model only draws the instances that
+     * passed the cull.
+     *
+     * @param enabled true to cull the instances on the GPU.
+     *
+     * @return true if the culling was set, false if culling on the GPU is not supported.
+     * @script{ignore}
+     *
+     * @see InstanceCuller
+     */
+    bool setInstanceCulling(bool enabled);
+
+    /**
+     * Returns the culler of the instances of this model.
+     *
+     * @return The culler, or NULL if the instances are not culled on the GPU.
+     * @script{ignore}
+     */
+    InstanceCuller* getInstanceCuller() const;
+
+    /**
+     * Sets the impostor that draws this model once it is further than the given
+     * distance from the active camera of its scene.
+     *
+     * Beyond the distance, draw adds the node of this model to the impostor instead
+     * of drawing the mesh, and Impostor::draw must be called after the scene has been
+     * drawn to draw the queued nodes. Impostors are shared when the node is cloned.
+     *
+     * @param impostor The impostor to use, or NULL to always draw the mesh.
+     * @param distance The distance from the camera to the node beyond which the impostor is drawn.
+     * @script{ignore}
+     *
+     * @see Impostor
+     */
+    void setImpostor(Impostor* impostor, float distance);
+
+    /**
+     * Returns the impostor that draws this model when it is far away.
+     *
+     * @return The impostor, or NULL if the mesh is always drawn.
+     * @script{ignore}
+     */
+    Impostor* getImpostor() const;
+
+    /**
+     * Returns the distance from the camera beyond which the impostor of this model is drawn.
+     *
+     * @return The impostor distance.
+     */
+    float getImpostorDistance() const;
+
+    /**
+     * Adds a level of detail to draw in place of the mesh of this model once the
+     * model covers less than the given fraction of the height of the viewport.
+     *
+     * Levels are added from the most to the least detailed, with decreasing screen
+     * sizes. The mesh of the model itself is level zero and is drawn at any size. Each
+     * level must have the same number of parts as the mesh of the model, since the parts
+     * of all levels share the materials of the model.
+     *
+     * The level is selected once per frame for each camera, from the bounding sphere
+     * of the model and the projection of the camera.
+     *
+     * @param mesh The mesh of the level.
+     * @param screenSize The fraction of the viewport height covered by the diameter of
+     *      the bounds of the model below which the level is drawn.
+     * @script{ignore}
+     */
+    void addLOD(Mesh* mesh, float screenSize);
+
+    /**
+     * Returns the number of levels of detail of this model, including the mesh of the model.
+     *
+     * @return The number of levels of detail.
+     */
+    unsigned int getLODCount() const;
+
+    /**
+     * Returns the mesh of the given level of detail.
+     *
+     * @param index The level of detail, where zero is the mesh of the model.
+     *
+     * @return The mesh of the level.
+     * @script{ignore}
+     */
+    Mesh* getLODMesh(unsigned int index) const;
+
+    /**
+     * Returns the screen size below which the given level of detail is drawn.
+     *
+     * @param index The level of detail, where zero is the mesh of the model.
+     *
+     * @return The screen size of the level, which is one for level zero.
+     * @script{ignore}
+     */
+    float getLODScreenSize(unsigned int index) const;
+
+    /**
+     * Returns the level of detail that was selected when this model was last drawn.
+     *
+     * @return The current level of detail.
+     */
+    unsigned int getCurrentLOD() const;
+
+    /**
+     * Sets the baked lightmap of this model.
+     *
+     * The lightmap is sampled with the second texture coordinates of the mesh by materials
+     * whose LIGHTMAP define is set, through the LIGHTMAP_TEXTURE auto-binding, so that
+     * static geometry can be lit without any dynamic light. Lightmaps are shared when the
+     * node is cloned.
+     *
+     * @param sampler The sampler of the lightmap, or NULL to clear it.
+     * @script{ignore}
+     *
+     * @see RenderState::LIGHTMAP_TEXTURE
+     */
+    void setLightmap(Texture::Sampler* sampler);
+
+    /**
+     * Returns the baked lightmap of this model.
+     *
+     * @return The sampler of the lightmap, or NULL if the model has none.
+     * @script{ignore}
+     */
+    Texture::Sampler* getLightmap() const;
+
+    /**
+     * Sets the scale and offset applied to the second texture coordinates of the mesh to
+     * find the area of the lightmap that belongs to this model, when several models share
+     * a lightmap atlas.
+     *
+     * @param scaleOffset The scale in x and y and the offset in z and w, which is (1, 1, 0, 0) by default.
+     * @script{ignore}
+     *
+     * @see RenderState::LIGHTMAP_SCALE_OFFSET
+     */
+    void setLightmapScaleOffset(const Vector4& scaleOffset);
+
+    /**
+     * Returns the scale and offset applied to the second texture coordinates of the mesh.
+     *
+     * @return The scale in x and y and the offset in z and w.
+     * @script{ignore}
+     */
+    const Vector4& getLightmapScaleOffset() const;
+
 private:
 
+    /**
+     * A level of detail of the model, with the vertex attribute bindings of its
+     * mesh for each effect it has been drawn with.
+     */
+    struct LOD
+    {
+        Mesh* mesh;
+        float screenSize;
+        std::vector<std::pair<Effect*, VertexAttributeBinding*> > bindings;
+    };
+
     /**
      * Constructor.
      */
@@ -185,6 +446,72 @@ private:
      */
     void setMaterialNodeBinding(Material *m);
 
+    /**
+     * Unbinds the specified material from the given node, which this model is detached from.
+     */
+    static void clearMaterialNodeBinding(Material* material, Node* node);
+
+    /**
+     * Draws the given mesh part, or the whole mesh if part is NULL, with the given pass.
+     *
+     * During a depth pre-pass, the first pass of each technique is drawn with its depth
+     * pass instead, and the other passes are not drawn.
+     */
+    void drawPass(MeshPart* part, Pass* pass, bool wireframe);
+
+    /**
+     * Starts or ends a depth pre-pass, in which models only lay down their depth.
+     */
+    static void setDepthPrePass(bool depthPrePass);
+
+    /**
+     * Draws the given mesh part, or the whole mesh if part is NULL, without binding a pass.
+     */
+    void drawMesh(Mesh* mesh, MeshPart* part, bool wireframe, unsigned int instanceCount);
+
+    /**
+     * Selects the level of detail to draw for the given camera, or for the active
+     * camera of the scene if camera is NULL, and returns its mesh.
+     *
+     * The level is only selected again when the camera or the frame changes.
+     */
+    Mesh* selectLOD(Camera* camera);
+
+    /**
+     * Computes the fraction of the view height covered by the diameter of the bounding
+     * sphere of the model, seen from the given camera.
+     *
+     * @return true if the screen size could be computed; false if the model has no node
+     *         or the camera has no node.
+     */
+    bool getScreenSize(Camera* camera, float* screenSize) const;
+
+    /**
+     * Returns the vertex attribute binding of the given level of detail mesh for the
+     * given effect, or NULL if the mesh is not a level of detail of this model.
+     */
+    VertexAttributeBinding* getLODBinding(Mesh* mesh, Effect* effect);
+
+    /**
+     * Uploads the instance data to the instance buffer if it has changed and returns the buffer.
+     */
+    VertexBufferHandle updateInstanceBuffer();
+
+    /**
+     * Points the instance attributes of the given effect at the given instance buffer.
+     */
+    void bindInstances(Effect* effect, VertexBufferHandle buffer);
+
+    /**
+     * Resets the instance attributes of the given effect to their defaults.
+     */
+    void unbindInstances(Effect* effect);
+
+    /**
+     * Returns the local bounds of this model, including all of its instances.
+     */
+    const BoundingSphere& getBoundingSphere() const;
+
     void validatePartCount();
 
     Mesh* _mesh;
@@ -192,6 +519,19 @@ private:
     unsigned int _partCount;
     Material** _partMaterials;
     MeshSkin* _skin;
+    std::vector<float> _instanceData;
+    VertexBufferHandle _instanceBuffer;
+    bool _instanceBufferDirty;
+    BoundingSphere _instanceBounds;
+    InstanceCuller* _instanceCuller;
+    Impostor* _impostor;
+    float _impostorDistance;
+    std::vector<LOD> _lods;
+    unsigned int _currentLOD;
+    Camera* _lodCamera;
+    unsigned int _lodFrame;
+    Texture::Sampler* _lightmap;
+    Vector4 _lightmapScaleOffset;
 };
 
 }
@@ -0,0 +1,629 @@
+#include "Base.h"
+#include "NavigationMesh.h"
+#include "FileSystem.h"
+#include "Game.h"
+
+// The version of the navigation mesh files that can be loaded
+#define NAVMESH_VERSION_MAJOR 1
+#define NAVMESH_VERSION_MINOR 0
+
+// The default number of cached corridors
+#define NAVMESH_CACHE_SIZE 256
+
+// The maximum number of cells along each axis of the grid that locates points
+#define NAVMESH_GRID_SIZE_MAX 1024
+
+// The tolerance of the tests for points inside triangles
+#define NAVMESH_EPSILON 0.0001f
+
+namespace gameplay
+{
+
+/**
+ * Returns twice the signed area of a triangle in the horizontal plane.
+ */
+static float triarea2(const Vector3& a, const Vector3& b, const Vector3& c)
+{
+    return (c.x - a.x) * (b.z - a.z) - (b.x - a.x) * (c.z - a.z);
+}
+
+/**
+ * Returns whether two points are at the same position in the horizontal plane.
+ */
+static bool equalXZ(const Vector3& a, const Vector3& b)
+{
+    float dx = a.x - b.x;
+    float dz = a.z - b.z;
+    return dx * dx + dz * dz < NAVMESH_EPSILON * NAVMESH_EPSILON;
+}
+
+NavigationMesh::NavigationMesh()
+    : _gridMinX(0.0f), _gridMinZ(0.0f), _gridCellSize(1.0f), _gridWidth(0), _gridHeight(0), _cacheSize(NAVMESH_CACHE_SIZE)
+{
+}
+
+NavigationMesh::~NavigationMesh()
+{
+    Game* game = Game::getInstance();
+    if (!_runningQueries.empty())
+        game->getJobController()->wait(&_group);
+    if (game->getAIController())
+        game->getAIController()->removeNavigationMesh(this);
+}
+
+NavigationMesh* NavigationMesh::create(const char* path)
+{
+    GP_ASSERT(path);
+
+    Stream* stream = FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED);
+    if (!stream)
+    {
+        GP_WARN("Failed to open navigation mesh file '%s'.", path);
+        return NULL;
+    }
+
+    char sig[9];
+    unsigned char version[2];
+    if (stream->read(sig, 1, 9) != 9 || memcmp(sig, "\xABGPN\xBB\r\n\x1A\n", 9) != 0 ||
+        stream->read(version, 1, 2) != 2 || version[0] != NAVMESH_VERSION_MAJOR)
+    {
+        SAFE_DELETE(stream);
+        GP_WARN("Invalid navigation mesh header in file '%s'.", path);
+        return NULL;
+    }
+
+    bool valid = true;
+    unsigned int vertexCount = 0;
+    unsigned int triangleCount = 0;
+    std::vector<Vector3> vertices;
+    std::vector<unsigned int> indices;
+    if (stream->read(&vertexCount, sizeof(unsigned int), 1) == 1 && (size_t)vertexCount * 3 * sizeof(float) <= stream->length())
+    {
+        vertices.resize(vertexCount);
+        for (unsigned int i = 0; i < vertexCount && valid; ++i)
+            valid = stream->read(&vertices[i].x, sizeof(float), 3) == 3;
+    }
+    else
+        valid = false;
+    if (valid && stream->read(&triangleCount, sizeof(unsigned int), 1) == 1 && (size_t)triangleCount * 3 * sizeof(unsigned int) <= stream->length())
+    {
+        indices.resize(triangleCount * 3);
+        valid = triangleCount == 0 || stream->read(&indices[0], sizeof(unsigned int), indices.size()) == indices.size();
+        for (size_t i = 0, count = indices.size(); i < count && valid; ++i)
+            valid = indices[i] < vertexCount;
+    }
+    else
+        valid = false;
+    SAFE_DELETE(stream);
+
+    if (!valid)
+    {
+        GP_WARN("Invalid navigation mesh data in file '%s'.", path);
+        return NULL;
+    }
+
+    NavigationMesh* mesh = create(vertices.empty() ? NULL : &vertices[0], vertexCount, indices.empty() ? NULL : &indices[0], triangleCount);
+    mesh->_path = path;
+    return mesh;
+}
+
+NavigationMesh* NavigationMesh::create(const Vector3* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int triangleCount)
+{
+    GP_ASSERT(vertexCount == 0 || vertices);
+    GP_ASSERT(triangleCount == 0 || indices);
+
+    NavigationMesh* mesh = new NavigationMesh();
+    mesh->_vertices.assign(vertices, vertices + vertexCount);
+    mesh->_indices.assign(indices, indices + triangleCount * 3);
+    mesh->build();
+    return mesh;
+}
+
+void NavigationMesh::build()
+{
+    unsigned int triangleCount = getTriangleCount();
+
+    // Connect the triangles that share an edge, which is the edge from vertex e to vertex e + 1
+    // of a triangle. Edges that are shared by more than two triangles connect the first two.
+    _neighbors.assign(triangleCount * 3, -1);
+    std::unordered_map<unsigned long long, unsigned int> edges;
+    for (unsigned int i = 0, count = triangleCount * 3; i < count; ++i)
+    {
+        unsigned int a = _indices[i];
+        unsigned int b = _indices[i % 3 == 2 ? i - 2 : i + 1];
+        unsigned long long key = a < b ? ((unsigned long long)a << 32) | b : ((unsigned long long)b << 32) | a;
+        std::unordered_map<unsigned long long, unsigned int>::iterator itr = edges.find(key);
+        if (itr == edges.end())
+        {
+            edges[key] = i;
+        }
+        else if (itr->second / 3 != i / 3)
+        {
+            _neighbors[i] = (int)(itr->second / 3);
+            _neighbors[itr->second] = (int)(i / 3);
+            edges.erase(itr);
+        }
+    }
+
+    // Bin the triangles into a grid of about one triangle per cell, by their bounds in the
+    // horizontal plane, with the triangles of each cell stored contiguously.
+    _gridWidth = 0;
+    _gridHeight = 0;
+    _gridCells.clear();
+    _gridTriangles.clear();
+    if (triangleCount == 0)
+        return;
+
+    float maxX = -FLT_MAX;
+    float maxZ = -FLT_MAX;
+    _gridMinX = FLT_MAX;
+    _gridMinZ = FLT_MAX;
+    for (size_t i = 0, count = _indices.size(); i < count; ++i)
+    {
+        const Vector3& v = _vertices[_indices[i]];
+        _gridMinX = std::min(_gridMinX, v.x);
+        _gridMinZ = std::min(_gridMinZ, v.z);
+        maxX = std::max(maxX, v.x);
+        maxZ = std::max(maxZ, v.z);
+    }
+    float sizeX = std::max(maxX - _gridMinX, NAVMESH_EPSILON);
+    float sizeZ = std::max(maxZ - _gridMinZ, NAVMESH_EPSILON);
+    _gridCellSize = sqrt(sizeX * sizeZ / triangleCount);
+    _gridWidth = std::min((unsigned int)(sizeX / _gridCellSize) + 1, (unsigned int)NAVMESH_GRID_SIZE_MAX);
+    _gridHeight = std::min((unsigned int)(sizeZ / _gridCellSize) + 1, (unsigned int)NAVMESH_GRID_SIZE_MAX);
+
+    _gridCells.assign(_gridWidth * _gridHeight + 1, 0);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (unsigned int t = 0; t < triangleCount; ++t)
+        {
+            const Vector3& a = _vertices[_indices[t * 3]];
+            const Vector3& b = _vertices[_indices[t * 3 + 1]];
+            const Vector3& c = _vertices[_indices[t * 3 + 2]];
+            unsigned int minCellX = std::min((unsigned int)((std::min(a.x, std::min(b.x, c.x)) - _gridMinX) / _gridCellSize), _gridWidth - 1);
+            unsigned int maxCellX = std::min((unsigned int)((std::max(a.x, std::max(b.x, c.x)) - _gridMinX) / _gridCellSize), _gridWidth - 1);
+            unsigned int minCellZ = std::min((unsigned int)((std::min(a.z, std::min(b.z, c.z)) - _gridMinZ) / _gridCellSize), _gridHeight - 1);
+            unsigned int maxCellZ = std::min((unsigned int)((std::max(a.z, std::max(b.z, c.z)) - _gridMinZ) / _gridCellSize), _gridHeight - 1);
+            for (unsigned int z = minCellZ; z <= maxCellZ; ++z)
+            {
+                for (unsigned int x = minCellX; x <= maxCellX; ++x)
+                {
+                    unsigned int cell = z * _gridWidth + x;
+                    if (pass == 0)
+                        ++_gridCells[cell + 1];
+                    else
+                        _gridTriangles[_gridCells[cell]++] = t;
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            // Turn the counts into the offset of each cell. Storing the triangles advances the
+            // offset of each cell to that of the next, so the offsets are shifted back afterwards.
+            for (unsigned int i = 1, count = _gridCells.size(); i < count; ++i)
+                _gridCells[i] += _gridCells[i - 1];
+            _gridTriangles.resize(_gridCells.back());
+        }
+        else
+        {
+            for (unsigned int i = _gridCells.size() - 1; i > 0; --i)
+                _gridCells[i] = _gridCells[i - 1];
+            _gridCells[0] = 0;
+        }
+    }
+}
+
+const char* NavigationMesh::getPath() const
+{
+    return _path.c_str();
+}
+
+unsigned int NavigationMesh::getTriangleCount() const
+{
+    return (unsigned int)(_indices.size() / 3);
+}
+
+bool NavigationMesh::getNearestPoint(const Vector3& point, Vector3* dst) const
+{
+    GP_ASSERT(dst);
+
+    return findTriangle(point, dst) >= 0;
+}
+
+int NavigationMesh::findTriangle(const Vector3& point, Vector3* dst) const
+{
+    if (_gridCells.empty())
+        return -1;
+
+    int cellX = (int)floor((point.x - _gridMinX) / _gridCellSize);
+    int cellZ = (int)floor((point.z - _gridMinZ) / _gridCellSize);
+
+    // Find the triangle below or above the point that is the closest vertically.
+    int found = -1;
+    float foundDistance = FLT_MAX;
+    if (cellX >= 0 && cellX < (int)_gridWidth && cellZ >= 0 && cellZ < (int)_gridHeight)
+    {
+        unsigned int cell = cellZ * _gridWidth + cellX;
+        for (unsigned int i = _gridCells[cell], end = _gridCells[cell + 1]; i < end; ++i)
+        {
+            unsigned int t = _gridTriangles[i];
+            const Vector3& a = _vertices[_indices[t * 3]];
+            const Vector3& b = _vertices[_indices[t * 3 + 1]];
+            const Vector3& c = _vertices[_indices[t * 3 + 2]];
+            float area = triarea2(a, b, c);
+            if (fabs(area) < NAVMESH_EPSILON * NAVMESH_EPSILON)
+                continue;
+            float u = triarea2(point, b, c) / area;
+            float v = triarea2(point, c, a) / area;
+            float w = 1.0f - u - v;
+            if (u < -NAVMESH_EPSILON || v < -NAVMESH_EPSILON || w < -NAVMESH_EPSILON)
+                continue;
+            float y = a.y * u + b.y * v + c.y * w;
+            float distance = fabs(y - point.y);
+            if (distance < foundDistance)
+            {
+                found = (int)t;
+                foundDistance = distance;
+                dst->set(point.x, y, point.z);
+            }
+        }
+    }
+    if (found >= 0)
+        return found;
+
+    // Otherwise find the nearest triangle, searching the rings of cells around the point
+    // until the nearest triangle found is closer than the cells of the next ring can be.
+    cellX = std::max(std::min(cellX, (int)_gridWidth - 1), 0);
+    cellZ = std::max(std::min(cellZ, (int)_gridHeight - 1), 0);
+    int ringCount = (int)std::max(_gridWidth, _gridHeight);
+    for (int ring = 0; ring < ringCount; ++ring)
+    {
+        for (int z = cellZ - ring; z <= cellZ + ring; ++z)
+        {
+            if (z < 0 || z >= (int)_gridHeight)
+                continue;
+            int step = (z == cellZ - ring || z == cellZ + ring) ? 1 : ring * 2;
+            for (int x = cellX - ring; x <= cellX + ring; x += step)
+            {
+                if (x < 0 || x >= (int)_gridWidth)
+                    continue;
+                unsigned int cell = z * _gridWidth + x;
+                for (unsigned int i = _gridCells[cell], end = _gridCells[cell + 1]; i < end; ++i)
+                {
+                    unsigned int t = _gridTriangles[i];
+                    Vector3 closest = getClosestPoint(t, point);
+                    float distance = closest.distanceSquared(point);
+                    if (distance < foundDistance)
+                    {
+                        found = (int)t;
+                        foundDistance = distance;
+                        *dst = closest;
+                    }
+                }
+            }
+        }
+        float ringDistance = ring * _gridCellSize;
+        if (found >= 0 && foundDistance <= ringDistance * ringDistance)
+            break;
+    }
+    return found;
+}
+
+Vector3 NavigationMesh::getClosestPoint(unsigned int triangle, const Vector3& point) const
+{
+    const Vector3& a = _vertices[_indices[triangle * 3]];
+    const Vector3& b = _vertices[_indices[triangle * 3 + 1]];
+    const Vector3& c = _vertices[_indices[triangle * 3 + 2]];
+
+    // Find the region of the triangle that the point projects to, from Real-Time Collision Detection.
+    Vector3 ab = b - a;
+    Vector3 ac = c - a;
+    Vector3 ap = point - a;
+    float d1 = ab.dot(ap);
+    float d2 = ac.dot(ap);
+    if (d1 <= 0.0f && d2 <= 0.0f)
+        return a;
+
+    Vector3 bp = point - b;
+    float d3 = ab.dot(bp);
+    float d4 = ac.dot(bp);
+    if (d3 >= 0.0f && d4 <= d3)
+        return b;
+
+    float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f)
+        return a + ab * (d1 / (d1 - d3));
+
+    Vector3 cp = point - c;
+    float d5 = ab.dot(cp);
+    float d6 = ac.dot(cp);
+    if (d6 >= 0.0f && d5 <= d6)
+        return c;
+
+    float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f)
+        return a + ac * (d2 / (d2 - d6));
+
+    float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f)
+        return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+
+    float denominator = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denominator) + ac * (vc * denominator);
+}
+
+Vector3 NavigationMesh::getCentroid(unsigned int triangle) const
+{
+    return (_vertices[_indices[triangle * 3]] + _vertices[_indices[triangle * 3 + 1]] + _vertices[_indices[triangle * 3 + 2]]) * (1.0f / 3.0f);
+}
+
+bool NavigationMesh::findPath(const Vector3& start, const Vector3& end, std::vector<Vector3>* path) const
+{
+    GP_ASSERT(path);
+
+    path->clear();
+
+    Vector3 startPoint;
+    Vector3 endPoint;
+    int startTriangle = findTriangle(start, &startPoint);
+    int endTriangle = findTriangle(end, &endPoint);
+    if (startTriangle < 0 || endTriangle < 0)
+        return false;
+
+    // Look the corridor between the triangles up in the cache, and search for it otherwise.
+    std::vector<unsigned int> corridor;
+    unsigned long long key = ((unsigned long long)startTriangle << 32) | (unsigned int)endTriangle;
+    bool cached = false;
+    if (_cacheSize > 0)
+    {
+        std::lock_guard<std::mutex> lock(_cacheMutex);
+        std::unordered_map<unsigned long long, CacheEntry>::iterator itr = _cache.find(key);
+        if (itr != _cache.end())
+        {
+            corridor = itr->second.corridor;
+            _cacheUse.splice(_cacheUse.begin(), _cacheUse, itr->second.use);
+            cached = true;
+        }
+    }
+    if (!cached)
+    {
+        if (!findCorridor(startTriangle, endTriangle, startPoint, endPoint, &corridor))
+            return false;
+
+        if (_cacheSize > 0)
+        {
+            std::lock_guard<std::mutex> lock(_cacheMutex);
+            if (_cache.find(key) == _cache.end())
+            {
+                _cacheUse.push_front(key);
+                CacheEntry& entry = _cache[key];
+                entry.corridor = corridor;
+                entry.use = _cacheUse.begin();
+                while (_cache.size() > _cacheSize)
+                {
+                    _cache.erase(_cacheUse.back());
+                    _cacheUse.pop_back();
+                }
+            }
+        }
+    }
+
+    straightenPath(corridor, startPoint, endPoint, path);
+    return true;
+}
+
+bool NavigationMesh::findCorridor(unsigned int startTriangle, unsigned int endTriangle, const Vector3& start, const Vector3& end, std::vector<unsigned int>* corridor) const
+{
+    corridor->clear();
+    if (startTriangle == endTriangle)
+    {
+        corridor->push_back(startTriangle);
+        return true;
+    }
+
+    // A* over the triangles, which are entered at their centroid, except for the
+    // start and end triangles which are at the start and end points.
+    unsigned int triangleCount = getTriangleCount();
+    std::vector<float> costs(triangleCount, FLT_MAX);
+    std::vector<int> parents(triangleCount, -1);
+    std::vector<bool> closed(triangleCount, false);
+    std::priority_queue<std::pair<float, unsigned int>, std::vector<std::pair<float, unsigned int> >, std::greater<std::pair<float, unsigned int> > > open;
+
+    costs[startTriangle] = 0.0f;
+    open.push(std::make_pair(start.distance(end), startTriangle));
+    while (!open.empty())
+    {
+        unsigned int t = open.top().second;
+        open.pop();
+        if (closed[t])
+            continue;
+        if (t == endTriangle)
+            break;
+        closed[t] = true;
+
+        Vector3 position = t == startTriangle ? start : getCentroid(t);
+        for (unsigned int e = 0; e < 3; ++e)
+        {
+            int neighbor = _neighbors[t * 3 + e];
+            if (neighbor < 0 || closed[neighbor])
+                continue;
+            Vector3 neighborPosition = (unsigned int)neighbor == endTriangle ? end : getCentroid(neighbor);
+            float cost = costs[t] + position.distance(neighborPosition);
+            if (cost < costs[neighbor])
+            {
+                costs[neighbor] = cost;
+                parents[neighbor] = (int)t;
+                open.push(std::make_pair(cost + neighborPosition.distance(end), (unsigned int)neighbor));
+            }
+        }
+    }
+    if (parents[endTriangle] < 0)
+        return false;
+
+    for (int t = (int)endTriangle; t >= 0; t = parents[t])
+        corridor->push_back((unsigned int)t);
+    std::reverse(corridor->begin(), corridor->end());
+    return true;
+}
+
+void NavigationMesh::straightenPath(const std::vector<unsigned int>& corridor, const Vector3& start, const Vector3& end, std::vector<Vector3>* path) const
+{
+    // The portals are the edges shared by consecutive triangles of the corridor, as their
+    // left and right end when crossed towards the end, between a portal at each end point.
+    std::vector<std::pair<Vector3, Vector3> > portals;
+    portals.reserve(corridor.size() + 1);
+    portals.push_back(std::make_pair(start, start));
+    for (size_t i = 0, count = corridor.size(); i + 1 < count; ++i)
+    {
+        unsigned int t = corridor[i];
+        for (unsigned int e = 0; e < 3; ++e)
+        {
+            if (_neighbors[t * 3 + e] != (int)corridor[i + 1])
+                continue;
+            const Vector3& a = _vertices[_indices[t * 3 + e]];
+            const Vector3& b = _vertices[_indices[t * 3 + (e + 1) % 3]];
+            if (triarea2(getCentroid(t), a, b) < 0.0f)
+                portals.push_back(std::make_pair(b, a));
+            else
+                portals.push_back(std::make_pair(a, b));
+            break;
+        }
+    }
+    portals.push_back(std::make_pair(end, end));
+
+    // Pull the path taut through the portals, with the simple stupid funnel algorithm.
+    Vector3 apex = start;
+    Vector3 left = start;
+    Vector3 right = start;
+    size_t apexIndex = 0;
+    size_t leftIndex = 0;
+    size_t rightIndex = 0;
+    path->push_back(start);
+    for (size_t i = 1, count = portals.size(); i < count; ++i)
+    {
+        const Vector3& portalLeft = portals[i].first;
+        const Vector3& portalRight = portals[i].second;
+
+        // Narrow the funnel from the right, unless it crosses the left side.
+        if (triarea2(apex, right, portalRight) <= 0.0f)
+        {
+            if (equalXZ(apex, right) || triarea2(apex, left, portalRight) > 0.0f)
+            {
+                right = portalRight;
+                rightIndex = i;
+            }
+            else
+            {
+                // The left side is a corner of the path, where the funnel restarts.
+                path->push_back(left);
+                apex = left;
+                apexIndex = leftIndex;
+                right = apex;
+                rightIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+
+        // Narrow the funnel from the left, unless it crosses the right side.
+        if (triarea2(apex, left, portalLeft) >= 0.0f)
+        {
+            if (equalXZ(apex, left) || triarea2(apex, right, portalLeft) < 0.0f)
+            {
+                left = portalLeft;
+                leftIndex = i;
+            }
+            else
+            {
+                path->push_back(right);
+                apex = right;
+                apexIndex = rightIndex;
+                left = apex;
+                leftIndex = apexIndex;
+                i = apexIndex;
+                continue;
+            }
+        }
+    }
+    if (!equalXZ(path->back(), end) || path->size() == 1)
+        path->push_back(end);
+}
+
+void NavigationMesh::requestPath(const Vector3& start, const Vector3& end, const char* receiver, unsigned int messageId)
+{
+    if (_queries.empty() && _runningQueries.empty())
+        Game::getInstance()->getAIController()->addNavigationMesh(this);
+
+    _queries.resize(_queries.size() + 1);
+    Query& query = _queries.back();
+    query.mesh = this;
+    query.start = start;
+    query.end = end;
+    query.receiver = receiver ? receiver : "";
+    query.messageId = messageId;
+    query.found = false;
+}
+
+void NavigationMesh::updateQueries()
+{
+    if (!_group.isComplete())
+        return;
+
+    // Send the paths found by the last batch.
+    AIController* controller = Game::getInstance()->getAIController();
+    for (size_t i = 0, count = _runningQueries.size(); i < count; ++i)
+    {
+        const Query& query = _runningQueries[i];
+        unsigned int pointCount = query.found ? (unsigned int)query.path.size() : 0;
+        AIMessage* message = AIMessage::create(query.messageId, _path.c_str(), query.receiver.c_str(), 1 + pointCount * 3);
+        message->setInt(0, (int)pointCount);
+        for (unsigned int j = 0; j < pointCount; ++j)
+        {
+            message->setFloat(1 + j * 3, query.path[j].x);
+            message->setFloat(2 + j * 3, query.path[j].y);
+            message->setFloat(3 + j * 3, query.path[j].z);
+        }
+        controller->sendMessage(message);
+    }
+    _runningQueries.clear();
+
+    // Start the requests made since, as one batch of jobs.
+    if (_queries.empty())
+        return;
+    _runningQueries.swap(_queries);
+    _jobs.resize(_runningQueries.size());
+    for (size_t i = 0, count = _runningQueries.size(); i < count; ++i)
+        _jobs[i] = &_runningQueries[i];
+    Game::getInstance()->getJobController()->submit(&_jobs[0], (unsigned int)_jobs.size(), &_group);
+}
+
+void NavigationMesh::Query::execute(unsigned int worker)
+{
+    found = mesh->findPath(start, end, &path);
+}
+
+unsigned int NavigationMesh::getCacheSize() const
+{
+    return _cacheSize;
+}
+
+void NavigationMesh::setCacheSize(unsigned int size)
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cacheSize = size;
+    while (_cache.size() > _cacheSize)
+    {
+        _cache.erase(_cacheUse.back());
+        _cacheUse.pop_back();
+    }
+}
+
+void NavigationMesh::clearCache()
+{
+    std::lock_guard<std::mutex> lock(_cacheMutex);
+    _cache.clear();
+    _cacheUse.clear();
+}
+
+}
@@ -0,0 +1,253 @@
+#ifndef NAVIGATIONMESH_H_
+#define NAVIGATIONMESH_H_
+
+#include "Ref.h"
+#include "Vector3.h"
+#include "JobController.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a navigation mesh, which is the walkable surface of a level that agents find paths on.
+ *
+ * A navigation mesh is made of triangles that are connected by their shared edges. Paths are
+ * found with an A* search over the graph of triangles, which yields the corridor of triangles
+ * between two points, and the corridor is then straightened into the shortest path through it.
+ * The corridors of recent searches are cached, so agents that follow similar routes, such as
+ * a group heading to the same destination, only search the graph once.
+ *
+ * Navigation meshes are generated from the geometry of a scene by gameplay-encoder, with the
+ * -navmesh option, which keeps the triangles of the given nodes that are flat enough to walk on.
+ *
+ * Paths can be found immediately with findPath, or requested with requestPath, in which case
+ * the requests of each frame are searched as a batch on the workers of the JobController and
+ * their results are sent to the requesting agents as AIMessages. Paths are found in the
+ * horizontal plane (X and Z), so a navigation mesh should not have walkable triangles above
+ * one another within a single connected area, such as the floors of a multi-story building
+ * modeled as one surface.
+ */
+class NavigationMesh : public Ref
+{
+    friend class AIController;
+
+public:
+
+    /**
+     * Creates a navigation mesh from a file written by gameplay-encoder.
+     *
+     * @param path The path of the navigation mesh file (.nav).
+     *
+     * @return The new navigation mesh, or NULL if the file could not be read.
+     * @script{create}
+     */
+    static NavigationMesh* create(const char* path);
+
+    /**
+     * Creates a navigation mesh from the given triangles.
+     *
+     * @param vertices The vertices of the triangles.
+     * @param vertexCount The number of vertices.
+     * @param indices The three vertex indices of each triangle.
+     * @param triangleCount The number of triangles.
+     *
+     * @return The new navigation mesh.
+     * @script{ignore}
+     */
+    static NavigationMesh* create(const Vector3* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int triangleCount);
+
+    /**
+     * Returns the path of the file the navigation mesh was loaded from.
+     *
+     * @return The file path, or an empty string if the mesh was not loaded from a file.
+     */
+    const char* getPath() const;
+
+    /**
+     * Returns the number of triangles of the navigation mesh.
+     *
+     * @return The triangle count.
+     */
+    unsigned int getTriangleCount() const;
+
+    /**
+     * Finds the point of the navigation mesh that is nearest to the given point.
+     *
+     * @param point The point.
+     * @param dst Populated with the nearest point of the navigation mesh.
+     *
+     * @return true if the navigation mesh has a triangle, false otherwise.
+     */
+    bool getNearestPoint(const Vector3& point, Vector3* dst) const;
+
+    /**
+     * Finds the shortest path between two points on the navigation mesh.
+     *
+     * The points are located on the triangle below or above them, or on the nearest
+     * triangle if there is none. This method can be called from any thread.
+     *
+     * @param start The start of the path.
+     * @param end The end of the path.
+     * @param path Populated with the points of the path, from start to end.
+     *
+     * @return true if a path was found, false if the points are not connected.
+     * @script{ignore}
+     */
+    bool findPath(const Vector3& start, const Vector3& end, std::vector<Vector3>* path) const;
+
+    /**
+     * Requests the shortest path between two points, which is found on a worker thread
+     * and sent to an agent as a message.
+     *
+     * The message is sent once the path has been found, which is at the earliest during
+     * the update of the AIController in the next frame. The sender of the message is the
+     * path of the navigation mesh and its ID is the given message ID. Its first parameter
+     * is an integer that holds the number of points of the path, which is 0 if no path was
+     * found, followed by three float parameters for the X, Y and Z coordinates of each point.
+     *
+     * @param start The start of the path.
+     * @param end The end of the path.
+     * @param receiver The ID of the agent to send the path to.
+     * @param messageId The ID of the message that the path is sent in.
+     */
+    void requestPath(const Vector3& start, const Vector3& end, const char* receiver, unsigned int messageId);
+
+    /**
+     * Returns the number of corridors that the navigation mesh caches.
+     *
+     * @return The cache size.
+     */
+    unsigned int getCacheSize() const;
+
+    /**
+     * Sets the number of corridors that the navigation mesh caches, which is 256 by default.
+     *
+     * The corridor between the triangles of two points is cached once it has been found,
+     * and the least recently used corridors are dropped once the cache is full.
+     *
+     * @param size The cache size, or 0 to disable the cache.
+     */
+    void setCacheSize(unsigned int size);
+
+    /**
+     * Removes all the corridors from the cache.
+     */
+    void clearCache();
+
+private:
+
+    /**
+     * A path requested with requestPath, which is found as a job.
+     */
+    class Query : public JobController::Job
+    {
+    public:
+
+        void execute(unsigned int worker);
+
+        const NavigationMesh* mesh;
+        Vector3 start;
+        Vector3 end;
+        std::string receiver;
+        unsigned int messageId;
+        std::vector<Vector3> path;
+        bool found;
+    };
+
+    /**
+     * A corridor in the cache, and its position in the order of use.
+     */
+    struct CacheEntry
+    {
+        std::vector<unsigned int> corridor;
+        std::list<unsigned long long>::iterator use;
+    };
+
+    /**
+     * Constructor.
+     */
+    NavigationMesh();
+
+    /**
+     * Destructor.
+     */
+    ~NavigationMesh();
+
+    /**
+     * Hidden copy constructor.
+     */
+    NavigationMesh(const NavigationMesh& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    NavigationMesh& operator=(const NavigationMesh&);
+
+    /**
+     * Connects the triangles that share an edge and builds the grid that locates points.
+     */
+    void build();
+
+    /**
+     * Returns the triangle that a point is located on.
+     *
+     * @param point The point.
+     * @param dst Populated with the point moved onto the triangle.
+     *
+     * @return The index of the triangle below or above the point that is the closest
+     *      vertically, or of the nearest triangle if there is none, or -1 if the mesh is empty.
+     */
+    int findTriangle(const Vector3& point, Vector3* dst) const;
+
+    /**
+     * Returns the point of a triangle that is closest to the given point.
+     */
+    Vector3 getClosestPoint(unsigned int triangle, const Vector3& point) const;
+
+    /**
+     * Returns the centroid of a triangle.
+     */
+    Vector3 getCentroid(unsigned int triangle) const;
+
+    /**
+     * Finds the corridor of triangles between two triangles with an A* search.
+     *
+     * @return true if the triangles are connected, false otherwise.
+     */
+    bool findCorridor(unsigned int startTriangle, unsigned int endTriangle, const Vector3& start, const Vector3& end, std::vector<unsigned int>* corridor) const;
+
+    /**
+     * Straightens a corridor into the shortest path through it, with the funnel algorithm.
+     */
+    void straightenPath(const std::vector<unsigned int>& corridor, const Vector3& start, const Vector3& end, std::vector<Vector3>* path) const;
+
+    /**
+     * Sends the paths that were found by the jobs of the last batch of requests, and then
+     * starts the jobs of the requests made since, if the last batch has completed.
+     */
+    void updateQueries();
+
+    std::string _path;
+    std::vector<Vector3> _vertices;
+    std::vector<unsigned int> _indices;
+    std::vector<int> _neighbors;
+    float _gridMinX;
+    float _gridMinZ;
+    float _gridCellSize;
+    unsigned int _gridWidth;
+    unsigned int _gridHeight;
+    std::vector<unsigned int> _gridCells;
+    std::vector<unsigned int> _gridTriangles;
+    unsigned int _cacheSize;
+    mutable std::mutex _cacheMutex;
+    mutable std::unordered_map<unsigned long long, CacheEntry> _cache;
+    mutable std::list<unsigned long long> _cacheUse;
+    std::vector<Query> _queries;
+    std::vector<Query> _runningQueries;
+    std::vector<JobController::Job*> _jobs;
+    JobController::Group _group;
+};
+
+}
+
+#endif
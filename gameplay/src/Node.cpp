@@ -13,20 +13,25 @@
 #include "Drawable.h"
 #include "Form.h"
 #include "Ref.h"
-
-// Node dirty flags
-#define NODE_DIRTY_WORLD 1
-#define NODE_DIRTY_BOUNDS 2
-#define NODE_DIRTY_HIERARCHY 4
-#define NODE_DIRTY_ALL (NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS | NODE_DIRTY_HIERARCHY)
+#include "TransformHierarchy.h"
+#include "SpatialIndex.h"
+#include "NodeIndex.h"
 
 namespace gameplay
 {
 
+// Interned tag names, indexed by their id. Names are kept in a deque so that the
+// strings returned by getTagName stay valid while other threads intern new names.
+static std::unordered_map<std::string, unsigned int> __tagIds;
+static std::deque<std::string> __tagNames;
+static std::mutex __tagMutex;
+
 Node::Node(const char* id)
-    : _scene(NULL), _firstChild(NULL), _nextSibling(NULL), _prevSibling(NULL), _parent(NULL), _childCount(0), _enabled(true), _tags(NULL),
+    : _scene(NULL), _firstChild(NULL), _nextSibling(NULL), _prevSibling(NULL), _parent(NULL), _childCount(0), _enabled(true),
     _drawable(NULL), _camera(NULL), _light(NULL), _audioSource(NULL), _collisionObject(NULL), _agent(NULL), _userObject(NULL),
-      _dirtyBits(NODE_DIRTY_ALL)
+      _worldViewCamera(NULL), _worldViewVersion(0), _dirtyBits(NODE_DIRTY_ALL), _transformHierarchy(NULL), _transformHierarchyIndex(-1),
+      _spatialIndex(NULL), _spatialIndexEntry(-1), _nodeIndex(NULL), _nodeIndexPaths(0), _nodeIndexSkinPaths(0), _occlusionQuery(0), _occlusionQueryPending(false), _occlusionQueryFrame(0),
+      _visible(true), _visibleFrame(0), _reflected(true)
 {
     GP_REGISTER_SCRIPT_EVENTS();
     if (id)
@@ -37,6 +42,12 @@ Node::Node(const char* id)
 
 Node::~Node()
 {
+    if (_transformHierarchy)
+        _transformHierarchy->remove(this);
+    if (_spatialIndex)
+        _spatialIndex->remove(this);
+    if (_nodeIndex)
+        _nodeIndex->remove(this, _nodeIndexPaths, _nodeIndexSkinPaths);
     removeAllChildren();
     if (_drawable)
         _drawable->setNode(NULL);
@@ -49,8 +60,13 @@ Node::~Node()
     SAFE_RELEASE(_audioSource);
     SAFE_DELETE(_collisionObject);
     SAFE_RELEASE(_userObject);
-    SAFE_DELETE(_tags);
     setAgent(NULL);
+#ifdef GP_USE_OCCLUSION_QUERIES
+    if (_occlusionQuery)
+    {
+        GL_ASSERT( glDeleteQueries(1, &_occlusionQuery) );
+    }
+#endif
 }
 
 Node* Node::create(const char* id)
@@ -70,9 +86,13 @@ const char* Node::getId() const
 
 void Node::setId(const char* id)
 {
-    if (id)
+    if (id && _id != id)
     {
+        std::string previousId;
+        previousId.swap(_id);
         _id = id;
+        if (_nodeIndex)
+            _nodeIndex->setId(this, previousId);
     }
 }
 
@@ -122,6 +142,15 @@ void Node::addChild(Node* child)
     ++_childCount;
     setBoundsDirty();
 
+    if (_nodeIndex)
+        _nodeIndex->addChild(this, child);
+
+    // The new child is picked up by the transform hierarchy on its next rebuild.
+    if (_transformHierarchy)
+        _transformHierarchy->invalidate();
+    if (_spatialIndex)
+        _spatialIndex->add(child);
+
     if (_dirtyBits & NODE_DIRTY_HIERARCHY)
     {
         hierarchyChanged();
@@ -153,6 +182,14 @@ void Node::removeAllChildren()
 
 void Node::remove()
 {
+    // Detach ourself (and our children) from the transform hierarchy and spatial index of our scene.
+    if (_transformHierarchy)
+        _transformHierarchy->remove(this);
+    if (_spatialIndex)
+        _spatialIndex->remove(this);
+    if (_parent && _parent->_nodeIndex)
+        _parent->_nodeIndex->removeChild(_parent, this);
+
     // Re-link our neighbours.
     if (_prevSibling)
     {
@@ -226,6 +263,11 @@ Node* Node::findNode(const char* id, bool recursive, bool exactMatch, bool skipS
 {
     GP_ASSERT(id);
 
+    // Exact matches of an id that is unique in the scene are answered by its node index.
+    Node* indexed;
+    if (exactMatch && recursive && _nodeIndex && _nodeIndex->find(this, id, skipSkin, &indexed))
+        return indexed;
+
     // If not skipSkin hierarchy, try searching the skin hierarchy
     if (!skipSkin)
     {
@@ -280,6 +322,17 @@ unsigned int Node::findNodes(const char* id, std::vector<Node*>& nodes, bool rec
 {
     GP_ASSERT(id);
 
+    // A node that is reachable along a single path is found once, like by the search.
+    Node* indexed;
+    if (exactMatch && recursive && _nodeIndex && _nodeIndex->find(this, id, skipSkin, &indexed) &&
+        (indexed == NULL || indexed->_nodeIndexPaths + indexed->_nodeIndexSkinPaths == 1))
+    {
+        if (indexed == NULL)
+            return 0;
+        nodes.push_back(indexed);
+        return 1;
+    }
+
     // If the drawable is a model with a mesh skin, search the skin's hierarchy as well.
     unsigned int count = 0;
 
@@ -341,18 +394,28 @@ Scene* Node::getScene() const
 bool Node::hasTag(const char* name) const
 {
     GP_ASSERT(name);
-    return (_tags ? _tags->find(name) != _tags->end() : false);
+
+    unsigned int id;
+    return findTagId(name, &id) && findTag(id) != NULL;
+}
+
+bool Node::hasTag(unsigned int id) const
+{
+    return findTag(id) != NULL;
 }
 
 const char* Node::getTag(const char* name) const
 {
     GP_ASSERT(name);
 
-    if (!_tags)
-        return NULL;
+    unsigned int id;
+    return findTagId(name, &id) ? getTag(id) : NULL;
+}
 
-    std::map<std::string, std::string>::const_iterator itr = _tags->find(name);
-    return (itr == _tags->end() ? NULL : itr->second.c_str());
+const char* Node::getTag(unsigned int id) const
+{
+    const Tag* tag = findTag(id);
+    return tag ? tag->value.c_str() : NULL;
 }
 
 void Node::setTag(const char* name, const char* value)
@@ -361,27 +424,95 @@ void Node::setTag(const char* name, const char* value)
 
     if (value == NULL)
     {
-        // Removing tag
-        if (_tags)
-        {
-            _tags->erase(name);
-            if (_tags->size() == 0)
-            {
-                SAFE_DELETE(_tags);
-            }
-        }
+        // Removing a tag that was never interned doesn't need an id.
+        unsigned int id;
+        if (findTagId(name, &id))
+            setTag(id, NULL);
     }
     else
     {
-        // Setting tag
-        if (_tags == NULL)
+        setTag(getTagId(name), value);
+    }
+}
+
+void Node::setTag(unsigned int id, const char* value)
+{
+    for (size_t i = 0, count = _tags.size(); i < count; ++i)
+    {
+        if (_tags[i].id != id)
+            continue;
+
+        if (value == NULL)
         {
-            _tags = new std::map<std::string, std::string>();
+            // Removing tag
+            if (_nodeIndex)
+                _nodeIndex->setTag(this, id, false);
+            _tags[i] = _tags.back();
+            _tags.pop_back();
         }
-        (*_tags)[name] = value;
+        else
+        {
+            _tags[i].value = value;
+        }
+        return;
+    }
+
+    if (value)
+    {
+        // Setting tag
+        Tag tag;
+        tag.id = id;
+        tag.value = value;
+        _tags.push_back(tag);
+        if (_nodeIndex)
+            _nodeIndex->setTag(this, id, true);
     }
 }
 
+unsigned int Node::getTagId(const char* name)
+{
+    GP_ASSERT(name);
+
+    std::lock_guard<std::mutex> lock(__tagMutex);
+    std::unordered_map<std::string, unsigned int>::const_iterator itr = __tagIds.find(name);
+    if (itr != __tagIds.end())
+        return itr->second;
+
+    unsigned int id = (unsigned int)__tagNames.size();
+    __tagNames.push_back(name);
+    __tagIds[name] = id;
+    return id;
+}
+
+const char* Node::getTagName(unsigned int id)
+{
+    std::lock_guard<std::mutex> lock(__tagMutex);
+    GP_ASSERT(id < __tagNames.size());
+    return __tagNames[id].c_str();
+}
+
+bool Node::findTagId(const char* name, unsigned int* id)
+{
+    GP_ASSERT(id);
+
+    std::lock_guard<std::mutex> lock(__tagMutex);
+    std::unordered_map<std::string, unsigned int>::const_iterator itr = __tagIds.find(name);
+    if (itr == __tagIds.end())
+        return false;
+    *id = itr->second;
+    return true;
+}
+
+const Node::Tag* Node::findTag(unsigned int id) const
+{
+    for (size_t i = 0, count = _tags.size(); i < count; ++i)
+    {
+        if (_tags[i].id == id)
+            return &_tags[i];
+    }
+    return NULL;
+}
+
 void Node::setEnabled(bool enabled)
 {
     if (_enabled != enabled)
@@ -416,6 +547,26 @@ bool Node::isEnabledInHierarchy() const
    return true;
 }
 
+void Node::setReflected(bool reflected)
+{
+    _reflected = reflected;
+}
+
+bool Node::isReflected() const
+{
+    return _reflected;
+}
+
+bool Node::isVisible() const
+{
+    return _visible;
+}
+
+unsigned int Node::getVisibleFrame() const
+{
+    return _visibleFrame;
+}
+
 void Node::update(float elapsedTime)
 {
     for (Node* node = _firstChild; node != NULL; node = node->_nextSibling)
@@ -435,6 +586,10 @@ bool Node::isStatic() const
 
 const Matrix& Node::getWorldMatrix() const
 {
+    // Nodes attached to a transform hierarchy have their world matrix resolved by it.
+    if (_transformHierarchy)
+        return _transformHierarchy->getWorldMatrix(this);
+
     if (_dirtyBits & NODE_DIRTY_WORLD)
     {
         // Clear our dirty flag immediately to prevent this block from being entered if our
@@ -448,7 +603,7 @@ const Matrix& Node::getWorldMatrix() const
             Node* parent = getParent();
             if (parent && (!_collisionObject || _collisionObject->isKinematic()))
             {
-                Matrix::multiply(parent->getWorldMatrix(), getMatrix(), &_world);
+                Matrix::multiplyAffine(parent->getWorldMatrix(), getMatrix(), &_world);
             }
             else
             {
@@ -468,16 +623,32 @@ const Matrix& Node::getWorldMatrix() const
 
 const Matrix& Node::getWorldViewMatrix() const
 {
-    static Matrix worldView;
-    Matrix::multiply(getViewMatrix(), getWorldMatrix(), &worldView);
-    return worldView;
+    Scene* scene = getScene();
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (camera == NULL)
+    {
+        // Without a camera the view matrix is identity.
+        return getWorldMatrix();
+    }
+
+    // Only re-calculate the world-view matrix if our world matrix or the view
+    // of the active camera changed since it was last computed.
+    const Matrix& world = getWorldMatrix();
+    if ((_dirtyBits & NODE_DIRTY_WORLD_VIEW) || _worldViewCamera != camera || _worldViewVersion != camera->_viewVersion)
+    {
+        Matrix::multiplyAffine(camera->getViewMatrix(), world, &_worldView);
+        _worldViewCamera = camera;
+        _worldViewVersion = camera->_viewVersion;
+        _dirtyBits &= ~NODE_DIRTY_WORLD_VIEW;
+    }
+    return _worldView;
 }
 
 const Matrix& Node::getInverseTransposeWorldViewMatrix() const
 {
     static Matrix invTransWorldView;
-    Matrix::multiply(getViewMatrix(), getWorldMatrix(), &invTransWorldView);
-    invTransWorldView.invert();
+    Matrix::multiplyAffine(getViewMatrix(), getWorldMatrix(), &invTransWorldView);
+    invTransWorldView.invertAffine();
     invTransWorldView.transpose();
     return invTransWorldView;
 }
@@ -485,8 +656,7 @@ const Matrix& Node::getInverseTransposeWorldViewMatrix() const
 const Matrix& Node::getInverseTransposeWorldMatrix() const
 {
     static Matrix invTransWorld;
-    invTransWorld = getWorldMatrix();
-    invTransWorld.invert();
+    getWorldMatrix().invertAffine(&invTransWorld);
     invTransWorld.transpose();
     return invTransWorld;
 }
@@ -657,7 +827,21 @@ void Node::hierarchyChanged()
 void Node::transformChanged()
 {
     // Our local transform was changed, so mark our world matrices dirty.
-    _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS;
+    _dirtyBits |= NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS | NODE_DIRTY_WORLD_VIEW;
+    if (_transformHierarchy)
+        _transformHierarchy->setDirty(this);
+
+    if (_spatialIndex)
+        _spatialIndex->setDirty(this);
+
+    // Flag our ancestors so that Scene::updateTransforms() can find this dirty subtree
+    // and so that their bounds get merged with our new bounds.
+    for (Node* n = _parent; n != NULL && (n->_dirtyBits & (NODE_DIRTY_CHILDREN | NODE_DIRTY_BOUNDS)) != (NODE_DIRTY_CHILDREN | NODE_DIRTY_BOUNDS); n = n->_parent)
+    {
+        n->_dirtyBits |= NODE_DIRTY_CHILDREN | NODE_DIRTY_BOUNDS;
+        if (n->_spatialIndex)
+            n->_spatialIndex->setDirty(n);
+    }
 
     // Notify our children that their transform has also changed (since transforms are inherited).
     for (Node* n = getFirstChild(); n != NULL; n = n->getNextSibling())
@@ -683,6 +867,8 @@ void Node::setBoundsDirty()
 {
     // Mark ourself and our parent nodes as dirty
     _dirtyBits |= NODE_DIRTY_BOUNDS;
+    if (_spatialIndex)
+        _spatialIndex->setDirty(this);
 
     // Mark our parent bounds as dirty as well
     if (_parent)
@@ -810,6 +996,10 @@ void Node::setDrawable(Drawable* drawable)
 {
     if (_drawable != drawable)
     {
+        // The joint hierarchy of the skin of a model can be found through its node.
+        if (_nodeIndex)
+            _nodeIndex->removeSkin(this);
+
         if (_drawable)
         {
             _drawable->setNode(NULL);
@@ -827,6 +1017,9 @@ void Node::setDrawable(Drawable* drawable)
                 ref->addRef();
             _drawable->setNode(this);
         }
+
+        if (_nodeIndex)
+            _nodeIndex->addSkin(this);
     }
     setBoundsDirty();
 }
@@ -849,16 +1042,25 @@ const BoundingSphere& Node::getBoundingSphere() const
             empty = false;
         }
         Model* model = dynamic_cast<Model*>(_drawable);
+        // Skins with joint bounds are bounded by their current pose, which already
+        // includes the transforms of the joint hierarchy.
+        BoundingBox skinBounds;
+        bool posed = model && model->getMesh() && model->getSkin() && model->getSkin()->computeBounds(&skinBounds);
         if (model && model->getMesh())
         {
+            BoundingSphere modelBounds;
+            if (posed)
+                modelBounds.set(skinBounds);
+            else
+                modelBounds.set(model->getBoundingSphere());
             if (empty)
             {
-                _bounds.set(model->getMesh()->getBoundingSphere());
+                _bounds.set(modelBounds);
                 empty = false;
             }
             else
             {
-                _bounds.merge(model->getMesh()->getBoundingSphere());
+                _bounds.merge(modelBounds);
             }
         }
         if (_light)
@@ -866,6 +1068,8 @@ const BoundingSphere& Node::getBoundingSphere() const
             switch (_light->getLightType())
             {
             case Light::POINT:
+            case Light::SPOT:
+                // Spot lights are bounded by the sphere of their range, which contains their cone.
                 if (empty)
                 {
                     _bounds.set(Vector3::zero(), _light->getRange());
@@ -876,8 +1080,7 @@ const BoundingSphere& Node::getBoundingSphere() const
                     _bounds.merge(BoundingSphere(Vector3::zero(), _light->getRange()));
                 }
                 break;
-            case Light::SPOT:
-                // TODO: Implement spot light bounds
+            default:
                 break;
             }
         }
@@ -892,7 +1095,7 @@ const BoundingSphere& Node::getBoundingSphere() const
         if (!empty)
         {
             bool applyWorldTransform = true;
-            if (model && model->getSkin())
+            if (model && model->getSkin() && !posed)
             {
                 // Special case: If the root joint of our mesh skin is parented by any nodes, 
                 // multiply the world matrix of the root joint's parent by this node's
@@ -909,7 +1112,7 @@ const BoundingSphere& Node::getBoundingSphere() const
                     // TODO: Should we protect against the case where joints are nested directly
                     // in the node hierachy of the model (this is normally not the case)?
                     Matrix boundsMatrix;
-                    Matrix::multiply(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
+                    Matrix::multiplyAffine(getWorldMatrix(), jointParent->getWorldMatrix(), &boundsMatrix);
                     _bounds.transform(boundsMatrix);
                     applyWorldTransform = false;
                 }
@@ -1011,10 +1214,8 @@ void Node::cloneInto(Node* node, NodeCloneContext& context) const
         if (ref)
             ref->release();
     }
-    if (_tags)
-    {
-        node->_tags = new std::map<std::string, std::string>(_tags->begin(), _tags->end());
-    }
+    node->_tags = _tags;
+    node->_reflected = _reflected;
 
     node->_world = _world;
     node->_bounds = _bounds;
@@ -1225,6 +1426,7 @@ void Node::setUserObject(Ref* obj)
 }
 
 NodeCloneContext::NodeCloneContext()
+    : _shareMaterials(false)
 {
 }
 
@@ -1236,7 +1438,7 @@ Animation* NodeCloneContext::findClonedAnimation(const Animation* animation)
 {
     GP_ASSERT(animation);
 
-    std::map<const Animation*, Animation*>::iterator it = _clonedAnimations.find(animation);
+    std::unordered_map<const Animation*, Animation*>::iterator it = _clonedAnimations.find(animation);
     return it != _clonedAnimations.end() ? it->second : NULL;
 }
 
@@ -1252,7 +1454,7 @@ Node* NodeCloneContext::findClonedNode(const Node* node)
 {
     GP_ASSERT(node);
 
-    std::map<const Node*, Node*>::iterator it = _clonedNodes.find(node);
+    std::unordered_map<const Node*, Node*>::iterator it = _clonedNodes.find(node);
     return it != _clonedNodes.end() ? it->second : NULL;
 }
 
@@ -1264,4 +1466,14 @@ void NodeCloneContext::registerClonedNode(const Node* original, Node* clone)
     _clonedNodes[original] = clone;
 }
 
+void NodeCloneContext::setShareMaterials(bool share)
+{
+    _shareMaterials = share;
+}
+
+bool NodeCloneContext::getShareMaterials() const
+{
+    return _shareMaterials;
+}
+
 }
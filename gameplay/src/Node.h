@@ -15,6 +15,15 @@
 #include "PhysicsCollisionObject.h"
 #include "BoundingBox.h"
 #include "AIAgent.h"
+#include "ObjectPool.h"
+
+// Node dirty flags
+#define NODE_DIRTY_WORLD 1
+#define NODE_DIRTY_BOUNDS 2
+#define NODE_DIRTY_HIERARCHY 4
+#define NODE_DIRTY_WORLD_VIEW 8
+#define NODE_DIRTY_CHILDREN 16
+#define NODE_DIRTY_ALL (NODE_DIRTY_WORLD | NODE_DIRTY_BOUNDS | NODE_DIRTY_HIERARCHY | NODE_DIRTY_WORLD_VIEW)
 
 namespace gameplay
 {
@@ -25,6 +34,9 @@ class Light;
 class AudioSource;
 class AIAgent;
 class Drawable;
+class TransformHierarchy;
+class SpatialIndex;
+class NodeIndex;
 
 /**
  * Defines a hierarchical structure of objects in 3D transformation spaces.
@@ -41,6 +53,12 @@ class Node : public Transform, public Ref
     friend class Bundle;
     friend class MeshSkin;
     friend class Light;
+    friend class TransformHierarchy;
+    friend class SpatialIndex;
+    friend class NodeIndex;
+    friend class Model;
+    friend class OcclusionCuller;
+    friend class Prefab;
 
     GP_SCRIPT_EVENTS_START();
     GP_SCRIPT_EVENT(update, "<Node>f");
@@ -52,6 +70,8 @@ class Node : public Transform, public Ref
 
 public:
 
+    GP_POOLED_OBJECT(Node);
+
     /**
      * Defines the types of nodes.
      */
@@ -207,6 +227,15 @@ public:
      */
     void setTag(const char* name, const char* value = "");
 
+    /**
+     * Sets a tag on this Node by the id of its name.
+     *
+     * @param id The id of the name of the tag, as returned by getTagId.
+     * @param value Value of the tag, or NULL to remove the tag.
+     * @script{ignore}
+     */
+    void setTag(unsigned int id, const char* value = "");
+
     /**
      * Returns the value of the custom tag with the given name.
      *
@@ -216,6 +245,16 @@ public:
      */
     const char* getTag(const char* name) const;
 
+    /**
+     * Returns the value of the custom tag with the given id.
+     *
+     * @param id The id of the name of the tag, as returned by getTagId.
+     *
+     * @return The value of the given tag, or NULL if the tag is not set.
+     * @script{ignore}
+     */
+    const char* getTag(unsigned int id) const;
+
     /**
      * Determines if a custom tag with the specified name is set.
      *
@@ -225,6 +264,40 @@ public:
      */
     bool hasTag(const char* name) const;
 
+    /**
+     * Determines if a custom tag with the specified id is set.
+     *
+     * @param id The id of the name of the tag, as returned by getTagId.
+     *
+     * @return true if the tag is set, false otherwise.
+     * @script{ignore}
+     */
+    bool hasTag(unsigned int id) const;
+
+    /**
+     * Returns the id of a tag name, which identifies the tag without comparing strings.
+     *
+     * Tag names are interned the first time their id is requested, and keep their id for
+     * the lifetime of the process. Code that tests the same tag often, such as every frame,
+     * should look up its id once and use the id overloads of the tag methods.
+     *
+     * @param name The name of the tag.
+     *
+     * @return The id of the tag name.
+     * @script{ignore}
+     */
+    static unsigned int getTagId(const char* name);
+
+    /**
+     * Returns the name of the tag with the given id.
+     *
+     * @param id The id of the tag name, as returned by getTagId.
+     *
+     * @return The name of the tag.
+     * @script{ignore}
+     */
+    static const char* getTagName(unsigned int id);
+
     /**
      * Sets if the node is enabled in the scene.
      *
@@ -246,6 +319,44 @@ public:
      */
     bool isEnabledInHierarchy() const;
 
+    /**
+     * Sets whether the drawable of this node is drawn into planar reflections.
+     *
+     * Small or distant details can be left out of reflections to make them cheaper. The
+     * flag can also be set with the 'reflected' property of a node in a scene file.
+     *
+     * @param reflected true if the node is reflected, which is the default.
+     * @see PlanarReflection
+     * @script{ignore}
+     */
+    void setReflected(bool reflected);
+
+    /**
+     * Returns whether the drawable of this node is drawn into planar reflections.
+     *
+     * @return true if the node is reflected.
+     * @script{ignore}
+     */
+    bool isReflected() const;
+
+    /**
+     * Determines if this node was visible the last time it was tested by the hardware
+     * occlusion queries of an OcclusionCuller.
+     *
+     * Nodes that have never been tested are visible. Game code can use this to skip
+     * updating animations, effects or physics of nodes that nobody can see.
+     *
+     * @return true if the node may be visible, false if it was hidden behind other geometry.
+     */
+    bool isVisible() const;
+
+    /**
+     * Returns the index of the last frame in which an OcclusionCuller found this node visible.
+     *
+     * @return The frame index, as returned by Game::getFrameIndex.
+     */
+    unsigned int getVisibleFrame() const;
+
     /**
      * Called to update the state of this Node.
      *
@@ -712,6 +823,27 @@ private:
 
     PhysicsCollisionObject* setCollisionObject(Properties* properties);
 
+    /**
+     * A tag assigned to a node.
+     */
+    struct Tag
+    {
+        unsigned int id;
+        std::string value;
+    };
+
+    /**
+     * Looks up the id of a tag name without interning it.
+     *
+     * @return true if the name has an id, false if its id was never requested.
+     */
+    static bool findTagId(const char* name, unsigned int* id);
+
+    /**
+     * Returns the tag with the given id, or NULL if it is not set.
+     */
+    const Tag* findTag(unsigned int id) const;
+
 protected:
 
     /** The scene this node is attached to. */
@@ -730,8 +862,8 @@ protected:
     unsigned int _childCount;
     /** If this node is enabled. Maybe different if parent is enabled/disabled. */
     bool _enabled; 
-    /** Tags assigned to this node. */
-    std::map<std::string, std::string>* _tags;
+    /** Tags assigned to this node, by the id of their name, in no particular order. */
+    std::vector<Tag> _tags;
     /** The drawble component attached to this node. */
     Drawable* _drawable;
     /** The camera component attached to this node. */
@@ -748,10 +880,42 @@ protected:
     Ref* _userObject;
     /** The world matrix for this node. */
     mutable Matrix _world;
+    /** The cached world-view matrix for this node. */
+    mutable Matrix _worldView;
+    /** The camera the cached world-view matrix was computed with. */
+    mutable const Camera* _worldViewCamera;
+    /** The view version of the camera the cached world-view matrix was computed with. */
+    mutable unsigned int _worldViewVersion;
     /** The bounding sphere for this node. */
     mutable BoundingSphere _bounds;
     /** The dirty bits used for optimization. */
     mutable int _dirtyBits;
+    /** The transform hierarchy of the scene this node is stored in, or NULL. */
+    TransformHierarchy* _transformHierarchy;
+    /** The index of this node within its transform hierarchy. */
+    int _transformHierarchyIndex;
+    /** The spatial index of the scene this node is stored in, or NULL. */
+    SpatialIndex* _spatialIndex;
+    /** The entry of this node within its spatial index, or -1. */
+    int _spatialIndexEntry;
+    /** The node index of the scene this node can be found in, or NULL. */
+    NodeIndex* _nodeIndex;
+    /** The number of paths through the scene hierarchy along which the node index reaches this node. */
+    unsigned int _nodeIndexPaths;
+    /** The number of paths through skins along which the node index reaches this node. */
+    unsigned int _nodeIndexSkinPaths;
+    /** The hardware occlusion query of this node, or zero if it was never tested. */
+    QueryHandle _occlusionQuery;
+    /** If the occlusion query of this node was issued and its result has not been read yet. */
+    bool _occlusionQueryPending;
+    /** The frame from which the visibility of this node may be tested again. */
+    unsigned int _occlusionQueryFrame;
+    /** If this node was visible the last time its occlusion query returned. */
+    bool _visible;
+    /** The last frame in which this node was found to be visible. */
+    unsigned int _visibleFrame;
+    /** If this node is drawn into planar reflections. */
+    bool _reflected;
 };
 
 /**
@@ -806,6 +970,23 @@ public:
      */
     void registerClonedNode(const Node* original, Node* clone);
 
+    /**
+     * Sets whether cloned models share the materials of the original models instead of
+     * cloning them, which Prefab uses to instantiate nodes quickly.
+     *
+     * @param share true to share materials, false to clone them (the default).
+     * @script{ignore}
+     */
+    void setShareMaterials(bool share);
+
+    /**
+     * Returns whether cloned models share the materials of the original models.
+     *
+     * @return true if materials are shared.
+     * @script{ignore}
+     */
+    bool getShareMaterials() const;
+
 private:
 
     /**
@@ -818,8 +999,9 @@ private:
      */
     NodeCloneContext& operator=(const NodeCloneContext&);
 
-    std::map<const Animation*, Animation*> _clonedAnimations;
-    std::map<const Node*, Node*> _clonedNodes;
+    std::unordered_map<const Animation*, Animation*> _clonedAnimations;
+    std::unordered_map<const Node*, Node*> _clonedNodes;
+    bool _shareMaterials;
 };
 
 }
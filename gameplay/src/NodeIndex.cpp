@@ -0,0 +1,280 @@
+#include "Base.h"
+#include "NodeIndex.h"
+#include "Node.h"
+#include "MeshSkin.h"
+
+namespace gameplay
+{
+
+NodeIndex::NodeIndex()
+    : _nodeCount(0), _complete(true)
+{
+}
+
+NodeIndex::~NodeIndex()
+{
+    for (std::unordered_map<std::string, std::vector<Node*> >::iterator itr = _ids.begin(); itr != _ids.end(); ++itr)
+    {
+        for (size_t i = 0, count = itr->second.size(); i < count; ++i)
+        {
+            Node* node = itr->second[i];
+            node->_nodeIndex = NULL;
+            node->_nodeIndexPaths = 0;
+            node->_nodeIndexSkinPaths = 0;
+        }
+    }
+}
+
+unsigned int NodeIndex::getNodeCount() const
+{
+    return _nodeCount;
+}
+
+unsigned int NodeIndex::findNodesByTag(const char* name, std::vector<Node*>& nodes, const char* value) const
+{
+    GP_ASSERT(name);
+
+    // A name without an id is not the tag of any node.
+    unsigned int id;
+    return Node::findTagId(name, &id) ? findNodesByTag(id, nodes, value) : 0;
+}
+
+unsigned int NodeIndex::findNodesByTag(unsigned int id, std::vector<Node*>& nodes, const char* value) const
+{
+    std::unordered_map<unsigned int, std::vector<Node*> >::const_iterator itr = _tags.find(id);
+    if (itr == _tags.end())
+        return 0;
+
+    unsigned int count = 0;
+    for (size_t i = 0, tagged = itr->second.size(); i < tagged; ++i)
+    {
+        Node* node = itr->second[i];
+        if (value == NULL || strcmp(node->getTag(id), value) == 0)
+        {
+            nodes.push_back(node);
+            ++count;
+        }
+    }
+    return count;
+}
+
+void NodeIndex::add(Node* node, unsigned int paths, unsigned int skinPaths)
+{
+    GP_ASSERT(node);
+
+    if (paths == 0 && skinPaths == 0)
+        return;
+
+    if (node->_nodeIndex != this)
+    {
+        if (node->_nodeIndex)
+        {
+            // The node is reachable from another scene as well, so this index can no longer
+            // tell that a node is missing and every search falls back to the hierarchy.
+            _complete = false;
+            return;
+        }
+        node->_nodeIndex = this;
+        insert(node);
+    }
+    node->_nodeIndexPaths += paths;
+    node->_nodeIndexSkinPaths += skinPaths;
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        add(child, paths, skinPaths);
+    }
+
+    // Searches include the skin of a model, but not the skins within it.
+    if (paths > 0)
+    {
+        Node* root = getSkinRoot(node);
+        if (root)
+            add(root, 0, paths);
+    }
+}
+
+void NodeIndex::remove(Node* node, unsigned int paths, unsigned int skinPaths)
+{
+    GP_ASSERT(node);
+
+    if ((paths == 0 && skinPaths == 0) || node->_nodeIndex != this)
+        return;
+
+    GP_ASSERT(node->_nodeIndexPaths >= paths && node->_nodeIndexSkinPaths >= skinPaths);
+    node->_nodeIndexPaths -= paths;
+    node->_nodeIndexSkinPaths -= skinPaths;
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        remove(child, paths, skinPaths);
+    }
+
+    if (paths > 0)
+    {
+        Node* root = getSkinRoot(node);
+        if (root)
+            remove(root, 0, paths);
+    }
+
+    // A skin can reach back into the hierarchy of its model, in which case the node may
+    // already have been removed by the recursion.
+    if (node->_nodeIndex == this && node->_nodeIndexPaths == 0 && node->_nodeIndexSkinPaths == 0)
+    {
+        unlink(node);
+        node->_nodeIndex = NULL;
+    }
+}
+
+void NodeIndex::addChild(Node* parent, Node* child)
+{
+    GP_ASSERT(parent && parent->_nodeIndex == this);
+    add(child, parent->_nodeIndexPaths, parent->_nodeIndexSkinPaths);
+}
+
+void NodeIndex::removeChild(Node* parent, Node* child)
+{
+    GP_ASSERT(parent && parent->_nodeIndex == this);
+    remove(child, parent->_nodeIndexPaths, parent->_nodeIndexSkinPaths);
+}
+
+void NodeIndex::removeSkin(Node* node)
+{
+    GP_ASSERT(node && node->_nodeIndex == this);
+
+    Node* root = getSkinRoot(node);
+    if (root)
+        remove(root, 0, node->_nodeIndexPaths);
+}
+
+void NodeIndex::addSkin(Node* node)
+{
+    GP_ASSERT(node && node->_nodeIndex == this);
+
+    Node* root = getSkinRoot(node);
+    if (root)
+        add(root, 0, node->_nodeIndexPaths);
+}
+
+void NodeIndex::setId(Node* node, const std::string& previousId)
+{
+    GP_ASSERT(node && node->_nodeIndex == this);
+
+    std::unordered_map<std::string, std::vector<Node*> >::iterator itr = _ids.find(previousId);
+    GP_ASSERT(itr != _ids.end());
+    removeFrom(itr->second, node);
+    if (itr->second.empty())
+        _ids.erase(itr);
+
+    _ids[node->_id].push_back(node);
+}
+
+void NodeIndex::setTag(Node* node, unsigned int id, bool tagged)
+{
+    GP_ASSERT(node && node->_nodeIndex == this);
+
+    if (tagged)
+    {
+        _tags[id].push_back(node);
+        return;
+    }
+
+    std::unordered_map<unsigned int, std::vector<Node*> >::iterator itr = _tags.find(id);
+    GP_ASSERT(itr != _tags.end());
+    removeFrom(itr->second, node);
+    if (itr->second.empty())
+        _tags.erase(itr);
+}
+
+bool NodeIndex::find(const Node* node, const char* id, bool skipSkin, Node** match) const
+{
+    GP_ASSERT(id);
+    GP_ASSERT(match);
+
+    if (!_complete)
+        return false;
+
+    // Only the hierarchy of a node that is indexed along with its skins is entirely indexed.
+    if (node && (node->_nodeIndex != this || (!skipSkin && node->_nodeIndexPaths == 0)))
+        return false;
+
+    std::unordered_map<std::string, std::vector<Node*> >::const_iterator itr = _ids.find(id);
+    if (itr == _ids.end())
+    {
+        *match = NULL;
+        return true;
+    }
+    if (itr->second.size() != 1)
+        return false;
+
+    Node* candidate = itr->second[0];
+    if (node == NULL)
+    {
+        *match = candidate;
+        return true;
+    }
+
+    for (Node* parent = candidate->_parent; parent != NULL; parent = parent->_parent)
+    {
+        if (parent == node)
+        {
+            *match = candidate;
+            return true;
+        }
+    }
+
+    // A node outside of the hierarchy can still be found through a skin within it.
+    if (skipSkin || candidate->_nodeIndexSkinPaths == 0)
+    {
+        *match = NULL;
+        return true;
+    }
+    return false;
+}
+
+Node* NodeIndex::getSkinRoot(const Node* node)
+{
+    Model* model = dynamic_cast<Model*>(node->_drawable);
+    if (model && model->getSkin())
+        return model->getSkin()->_rootNode;
+    return NULL;
+}
+
+void NodeIndex::insert(Node* node)
+{
+    _ids[node->_id].push_back(node);
+    for (size_t i = 0, count = node->_tags.size(); i < count; ++i)
+    {
+        _tags[node->_tags[i].id].push_back(node);
+    }
+    ++_nodeCount;
+}
+
+void NodeIndex::unlink(Node* node)
+{
+    std::unordered_map<std::string, std::vector<Node*> >::iterator itr = _ids.find(node->_id);
+    GP_ASSERT(itr != _ids.end());
+    removeFrom(itr->second, node);
+    if (itr->second.empty())
+        _ids.erase(itr);
+
+    for (size_t i = 0, count = node->_tags.size(); i < count; ++i)
+    {
+        std::unordered_map<unsigned int, std::vector<Node*> >::iterator tagged = _tags.find(node->_tags[i].id);
+        GP_ASSERT(tagged != _tags.end());
+        removeFrom(tagged->second, node);
+        if (tagged->second.empty())
+            _tags.erase(tagged);
+    }
+    --_nodeCount;
+}
+
+void NodeIndex::removeFrom(std::vector<Node*>& nodes, Node* node)
+{
+    std::vector<Node*>::iterator itr = std::find(nodes.begin(), nodes.end(), node);
+    GP_ASSERT(itr != nodes.end());
+    *itr = nodes.back();
+    nodes.pop_back();
+}
+
+}
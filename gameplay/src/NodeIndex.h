@@ -0,0 +1,177 @@
+#ifndef NODEINDEX_H_
+#define NODEINDEX_H_
+
+namespace gameplay
+{
+
+class Node;
+
+/**
+ * Defines an index of the nodes of a scene by their id and by their tags.
+ *
+ * Every node that a search of the scene can reach is indexed, which includes the joint
+ * hierarchies of the skins of the models in the scene. The index is kept up to date as
+ * nodes are added, removed, renamed and tagged, and as models and skins change.
+ *
+ * Since a hierarchy can be reachable along several paths, such as a joint hierarchy
+ * that is part of the scene and the skin of a model at once, each node counts the paths
+ * it is reachable along, and is only removed from the index once it can't be reached.
+ *
+ * Exact matches of an id that only a single node of the scene has are answered from the
+ * index. Searches for ids that several nodes share fall back to searching the hierarchy,
+ * which returns the node that was always found first.
+ *
+ * @see Scene::findNode
+ * @script{ignore}
+ */
+class NodeIndex
+{
+    friend class Scene;
+    friend class Node;
+    friend class Model;
+    friend class MeshSkin;
+
+public:
+
+    /**
+     * Returns the number of nodes stored in the index.
+     *
+     * @return The number of indexed nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Finds all indexed nodes that have the given tag.
+     *
+     * @param name The name of the tag.
+     * @param nodes Vector of nodes to be populated with matches, in no particular order.
+     * @param value The value the tag must have, or NULL to match any value.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodesByTag(const char* name, std::vector<Node*>& nodes, const char* value = NULL) const;
+
+    /**
+     * Finds all indexed nodes that have the tag with the given id.
+     *
+     * @param id The id of the name of the tag, as returned by Node::getTagId.
+     * @param nodes Vector of nodes to be populated with matches, in no particular order.
+     * @param value The value the tag must have, or NULL to match any value.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodesByTag(unsigned int id, std::vector<Node*>& nodes, const char* value = NULL) const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    NodeIndex();
+
+    /**
+     * Destructor.
+     */
+    ~NodeIndex();
+
+    /**
+     * Hidden copy constructor.
+     */
+    NodeIndex(const NodeIndex& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    NodeIndex& operator=(const NodeIndex&);
+
+    /**
+     * Adds paths to a node and its hierarchy.
+     *
+     * @param node The node.
+     * @param paths The number of paths through the scene hierarchy.
+     * @param skinPaths The number of paths through skins, along which the skins of
+     *      the hierarchy are not searched.
+     */
+    void add(Node* node, unsigned int paths, unsigned int skinPaths);
+
+    /**
+     * Removes paths to a node and its hierarchy that were added with add.
+     */
+    void remove(Node* node, unsigned int paths, unsigned int skinPaths);
+
+    /**
+     * Adds a child along the paths that reach its new parent.
+     */
+    void addChild(Node* parent, Node* child);
+
+    /**
+     * Removes a child along the paths that reach its parent, before it is unlinked.
+     */
+    void removeChild(Node* parent, Node* child);
+
+    /**
+     * Removes the paths through the skin of the model of a node, before the skin changes.
+     */
+    void removeSkin(Node* node);
+
+    /**
+     * Adds the paths through the skin of the model of a node, after the skin changed.
+     */
+    void addSkin(Node* node);
+
+    /**
+     * Moves a node to its new id, after it was renamed.
+     */
+    void setId(Node* node, const std::string& previousId);
+
+    /**
+     * Updates the tag lists of a node, after one of its tags was set or removed.
+     */
+    void setTag(Node* node, unsigned int id, bool tagged);
+
+    /**
+     * Removes a node that is destroyed from the index, whatever paths still reach it.
+     */
+    void erase(Node* node);
+
+    /**
+     * Looks up the match of an exact search of the hierarchy of a node for an id.
+     *
+     * @param node The node whose hierarchy is searched, or NULL to search the whole scene.
+     * @param id The id to search for.
+     * @param skipSkin Whether the skin of the node is skipped.
+     * @param match Populated with the match, or NULL if there is none.
+     *
+     * @return true if the index found the answer, false if the hierarchy must be searched.
+     */
+    bool find(const Node* node, const char* id, bool skipSkin, Node** match) const;
+
+    /**
+     * Returns the root node of the joint hierarchy of the skin of the model of a node, or NULL.
+     */
+    static Node* getSkinRoot(const Node* node);
+
+    /**
+     * Inserts a node that became reachable into the id and tag lists.
+     */
+    void insert(Node* node);
+
+    /**
+     * Removes a node that is no longer reachable from the id and tag lists.
+     */
+    void unlink(Node* node);
+
+    /**
+     * Removes a node from a list of nodes.
+     */
+    static void removeFrom(std::vector<Node*>& nodes, Node* node);
+
+    std::unordered_map<std::string, std::vector<Node*> > _ids;
+    std::unordered_map<unsigned int, std::vector<Node*> > _tags;
+    unsigned int _nodeCount;
+    bool _complete;
+};
+
+}
+
+#endif
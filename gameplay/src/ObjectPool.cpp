@@ -0,0 +1,98 @@
+#include "Base.h"
+#include "ObjectPool.h"
+
+// The alignment of every object in a pool, which is enough for any type used by the engine.
+#define OBJECT_POOL_ALIGNMENT 16
+
+namespace gameplay
+{
+
+ObjectPool::ObjectPool(size_t objectSize, unsigned int slabCapacity)
+    : _objectSize(0), _slabCapacity(slabCapacity), _free(NULL), _objectCount(0), _capacity(0)
+{
+    GP_ASSERT(slabCapacity > 0);
+
+    // Free blocks store the pointer to the next free block in place.
+    _objectSize = std::max(objectSize, sizeof(void*));
+    _objectSize = (_objectSize + OBJECT_POOL_ALIGNMENT - 1) & ~(size_t)(OBJECT_POOL_ALIGNMENT - 1);
+}
+
+ObjectPool::~ObjectPool()
+{
+    GP_ASSERT(_objectCount == 0);
+
+    for (size_t i = 0, count = _slabs.size(); i < count; ++i)
+    {
+        free(_slabs[i]);
+    }
+}
+
+void* ObjectPool::allocate()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_free == NULL && !allocateSlab(_slabCapacity))
+        return NULL;
+
+    void* object = _free;
+    _free = *(void**)object;
+    ++_objectCount;
+    return object;
+}
+
+void ObjectPool::reserve(unsigned int count)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if (_capacity - _objectCount < count)
+        allocateSlab(std::max(count, _slabCapacity));
+}
+
+void ObjectPool::deallocate(void* object)
+{
+    if (object == NULL)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    GP_ASSERT(_objectCount > 0);
+    *(void**)object = _free;
+    _free = object;
+    --_objectCount;
+}
+
+bool ObjectPool::allocateSlab(unsigned int capacity)
+{
+    unsigned char* slab = (unsigned char*)malloc(_objectSize * capacity);
+    if (slab == NULL)
+    {
+        GP_ERROR("Failed to allocate a slab of %u objects of size %u.", capacity, (unsigned int)_objectSize);
+        return false;
+    }
+    _slabs.push_back(slab);
+    _capacity += capacity;
+
+    // Link the blocks of the slab in address order, so that objects allocated
+    // one after another end up next to each other in memory.
+    for (unsigned int i = capacity; i > 0; --i)
+    {
+        void* block = slab + (i - 1) * _objectSize;
+        *(void**)block = _free;
+        _free = block;
+    }
+    return true;
+}
+
+unsigned int ObjectPool::getObjectCount() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _objectCount;
+}
+
+unsigned int ObjectPool::getCapacity() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _capacity;
+}
+
+}
@@ -0,0 +1,153 @@
+#ifndef OBJECTPOOL_H_
+#define OBJECTPOOL_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a pool of fixed-size memory blocks for allocating many small objects of the same type.
+ *
+ * The pool allocates memory in slabs that hold a fixed number of objects each,
+ * and keeps the blocks of destroyed objects on a free list for reuse. Slabs are
+ * never returned to the system, which avoids fragmenting the heap over long
+ * sessions and keeps objects of the same type close together in memory.
+ *
+ * Classes opt into pooled allocation by adding GP_POOLED_OBJECT to their public
+ * section, which declares class-specific new and delete operators that allocate
+ * from a pool shared by all objects of that class. Subclasses that are larger than
+ * the pooled class are allocated from the heap as usual. Pooling is only enabled
+ * when GP_USE_OBJECT_POOLS is defined, and it is always disabled together with
+ * memory leak detection, which replaces the new operator.
+ *
+ * Allocation and deallocation are thread-safe.
+ *
+ * @script{ignore}
+ */
+class ObjectPool
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param objectSize The size of the objects allocated from the pool.
+     * @param slabCapacity The number of objects per slab.
+     */
+    ObjectPool(size_t objectSize, unsigned int slabCapacity = 256);
+
+    /**
+     * Destructor.
+     *
+     * All objects allocated from the pool must have been deallocated.
+     */
+    ~ObjectPool();
+
+    /**
+     * Allocates memory for a single object.
+     *
+     * @return The allocated memory.
+     */
+    void* allocate();
+
+    /**
+     * Returns the memory of an object to the pool.
+     *
+     * @param object The memory to deallocate, or NULL.
+     */
+    void deallocate(void* object);
+
+    /**
+     * Makes sure that the given number of objects can be allocated without allocating
+     * another slab in between.
+     *
+     * If the free blocks of the pool don't suffice, a slab large enough for all of the
+     * objects is allocated, and its blocks are handed out before any other free block.
+     * Objects that are allocated one after another after reserving them are therefore
+     * next to each other in memory, which keeps batches of objects created together,
+     * such as the nodes of a batch of prefab instances, contiguous.
+     *
+     * @param count The number of objects to reserve memory for.
+     */
+    void reserve(unsigned int count);
+
+    /**
+     * Returns the number of objects currently allocated from the pool.
+     *
+     * @return The number of allocated objects.
+     */
+    unsigned int getObjectCount() const;
+
+    /**
+     * Returns the number of objects that fit into the slabs of the pool.
+     *
+     * @return The number of objects the pool can hold without allocating another slab.
+     */
+    unsigned int getCapacity() const;
+
+    /**
+     * Returns the pool shared by all objects of the given type.
+     *
+     * The pool is created on first use and lives until the process exits, so that
+     * objects can still be destroyed during static destruction.
+     *
+     * @return The pool for objects of type T.
+     */
+    template <class T>
+    static ObjectPool* get();
+
+private:
+
+    /**
+     * Hidden copy constructor.
+     */
+    ObjectPool(const ObjectPool&);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ObjectPool& operator=(const ObjectPool&);
+
+    /**
+     * Allocates a slab for the given number of objects and puts its blocks at the front of
+     * the free list, in address order.
+     *
+     * @return true if the slab was allocated.
+     */
+    bool allocateSlab(unsigned int capacity);
+
+    size_t _objectSize;
+    unsigned int _slabCapacity;
+    std::vector<unsigned char*> _slabs;
+    void* _free;
+    unsigned int _objectCount;
+    unsigned int _capacity;
+    mutable std::mutex _mutex;
+};
+
+template <class T>
+ObjectPool* ObjectPool::get()
+{
+    static ObjectPool* pool = new ObjectPool(sizeof(T));
+    return pool;
+}
+
+}
+
+#if defined(GP_USE_OBJECT_POOLS) && !defined(GP_USE_MEM_LEAK_DETECTION)
+#define GP_POOLED_OBJECT(type) \
+    static void* operator new(size_t size) \
+    { \
+        return size == sizeof(type) ? gameplay::ObjectPool::get<type>()->allocate() : ::operator new(size); \
+    } \
+    static void operator delete(void* p, size_t size) \
+    { \
+        if (size == sizeof(type)) \
+            gameplay::ObjectPool::get<type>()->deallocate(p); \
+        else \
+            ::operator delete(p); \
+    }
+#else
+#define GP_POOLED_OBJECT(type)
+#endif
+
+#endif
@@ -0,0 +1,317 @@
+#include "Base.h"
+#include "OcclusionBuffer.h"
+#include "Camera.h"
+#include "Node.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define OCCLUSION_USE_SSE
+#elif defined(GP_USE_NEON) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define OCCLUSION_USE_NEON
+#endif
+
+namespace gameplay
+{
+
+OcclusionBuffer::OcclusionBuffer(unsigned int width, unsigned int height)
+    : _width(width), _height(height)
+{
+    _depth.resize(_width * _height, 1.0f);
+}
+
+OcclusionBuffer::~OcclusionBuffer()
+{
+    for (size_t i = 0, count = _occluders.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_occluders[i]->node);
+        SAFE_DELETE(_occluders[i]);
+    }
+}
+
+OcclusionBuffer* OcclusionBuffer::create(unsigned int width, unsigned int height)
+{
+    GP_ASSERT(width > 0 && height > 0);
+
+    // Rows are processed four pixels at a time, so they are padded to a multiple of four.
+    return new OcclusionBuffer((width + 3) & ~3, height);
+}
+
+unsigned int OcclusionBuffer::getWidth() const
+{
+    return _width;
+}
+
+unsigned int OcclusionBuffer::getHeight() const
+{
+    return _height;
+}
+
+void OcclusionBuffer::addOccluder(Node* node, const Vector3* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(vertices && vertexCount > 0);
+    GP_ASSERT(indices && indexCount % 3 == 0);
+
+    Occluder* occluder = new Occluder();
+    occluder->node = node;
+    node->addRef();
+    occluder->vertices.assign(vertices, vertices + vertexCount);
+    occluder->indices.assign(indices, indices + indexCount);
+    occluder->bounds.set(vertices[0], vertices[0]);
+    for (unsigned int i = 1; i < vertexCount; ++i)
+    {
+        occluder->bounds.merge(BoundingBox(vertices[i], vertices[i]));
+    }
+    _occluders.push_back(occluder);
+}
+
+void OcclusionBuffer::addOccluder(Node* node, const BoundingBox& box)
+{
+    GP_ASSERT(node);
+
+    // BoundingBox::getCorners lists the front face and then the back face, each
+    // counter-clockwise when seen from outside the box.
+    Vector3 corners[8];
+    box.getCorners(corners);
+    static const unsigned int indices[36] =
+    {
+        0, 1, 2, 0, 2, 3, // front
+        4, 5, 6, 4, 6, 7, // back
+        7, 6, 1, 7, 1, 0, // left
+        3, 2, 5, 3, 5, 4, // right
+        7, 0, 3, 7, 3, 4, // top
+        1, 6, 5, 1, 5, 2  // bottom
+    };
+    addOccluder(node, corners, 8, indices, 36);
+}
+
+void OcclusionBuffer::removeOccluders(Node* node)
+{
+    for (size_t i = 0; i < _occluders.size();)
+    {
+        if (_occluders[i]->node == node)
+        {
+            SAFE_RELEASE(_occluders[i]->node);
+            SAFE_DELETE(_occluders[i]);
+            _occluders.erase(_occluders.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+unsigned int OcclusionBuffer::getOccluderCount() const
+{
+    return (unsigned int)_occluders.size();
+}
+
+unsigned int OcclusionBuffer::rasterize(Camera* camera)
+{
+    GP_ASSERT(camera);
+    GP_PROFILE("OcclusionBuffer::rasterize");
+
+    std::fill(_depth.begin(), _depth.end(), 1.0f);
+    _viewProjection = camera->getViewProjectionMatrix();
+    const Frustum& frustum = camera->getFrustum();
+
+    unsigned int count = 0;
+    for (size_t i = 0, occluderCount = _occluders.size(); i < occluderCount; ++i)
+    {
+        const Occluder* occluder = _occluders[i];
+        if (!occluder->node->isEnabledInHierarchy())
+            continue;
+
+        const Matrix& world = occluder->node->getWorldMatrix();
+        BoundingBox bounds(occluder->bounds);
+        bounds.transform(world);
+        if (!bounds.intersects(frustum))
+            continue;
+        ++count;
+
+        // Project the vertices to pixels. Triangles with a vertex behind the eye are
+        // skipped instead of being clipped, which only makes the buffer less occluding.
+        Matrix transform;
+        Matrix::multiply(_viewProjection, world, &transform);
+        size_t vertexCount = occluder->vertices.size();
+        _screenVertices.resize(vertexCount);
+        _clipped.resize(vertexCount);
+        for (size_t j = 0; j < vertexCount; ++j)
+        {
+            const Vector3& v = occluder->vertices[j];
+            Vector4 clip;
+            transform.transformVector(Vector4(v.x, v.y, v.z, 1.0f), &clip);
+            _clipped[j] = clip.w <= MATH_EPSILON;
+            if (!_clipped[j])
+            {
+                float invW = 1.0f / clip.w;
+                _screenVertices[j].set((clip.x * invW * 0.5f + 0.5f) * _width, (clip.y * invW * 0.5f + 0.5f) * _height, clip.z * invW);
+            }
+        }
+
+        const unsigned int* indices = &occluder->indices[0];
+        for (size_t j = 0, indexCount = occluder->indices.size(); j < indexCount; j += 3)
+        {
+            unsigned int i0 = indices[j], i1 = indices[j + 1], i2 = indices[j + 2];
+            if (!_clipped[i0] && !_clipped[i1] && !_clipped[i2])
+                rasterizeTriangle(_screenVertices[i0], _screenVertices[i1], _screenVertices[i2]);
+        }
+    }
+    return count;
+}
+
+void OcclusionBuffer::rasterizeTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2)
+{
+    // Front faces are counter-clockwise on screen and have a positive area.
+    float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+    if (area <= 0.0f)
+        return;
+
+    int minX = std::max(0, (int)floorf(std::min(v0.x, std::min(v1.x, v2.x))));
+    int maxX = std::min((int)_width - 1, (int)floorf(std::max(v0.x, std::max(v1.x, v2.x))));
+    int minY = std::max(0, (int)floorf(std::min(v0.y, std::min(v1.y, v2.y))));
+    int maxY = std::min((int)_height - 1, (int)floorf(std::max(v0.y, std::max(v1.y, v2.y))));
+    if (minX > maxX || minY > maxY)
+        return;
+    minX &= ~3;
+
+    // The edge functions a * x + b * y + c are positive on the inner side of each edge,
+    // evaluated at the pixel centers. Depth is interpolated linearly in screen space,
+    // as z - x * dzdx - y * dzdy is constant over the triangle.
+    float a0 = v1.y - v2.y, b0 = v2.x - v1.x, c0 = -(a0 * v1.x + b0 * v1.y);
+    float a1 = v2.y - v0.y, b1 = v0.x - v2.x, c1 = -(a1 * v2.x + b1 * v2.y);
+    float a2 = v0.y - v1.y, b2 = v1.x - v0.x, c2 = -(a2 * v0.x + b2 * v0.y);
+    float dzdx = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+    float dzdy = ((v1.x - v0.x) * (v2.z - v0.z) - (v2.x - v0.x) * (v1.z - v0.z)) / area;
+    float z0 = v0.z - v0.x * dzdx - v0.y * dzdy;
+
+#if defined(OCCLUSION_USE_SSE)
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+    const __m128 a0v = _mm_set1_ps(a0), a1v = _mm_set1_ps(a1), a2v = _mm_set1_ps(a2);
+    const __m128 dzdxv = _mm_set1_ps(dzdx);
+#elif defined(OCCLUSION_USE_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    const float offsetValues[4] = { 0.5f, 1.5f, 2.5f, 3.5f };
+    const float32x4_t offsets = vld1q_f32(offsetValues);
+    const float32x4_t a0v = vdupq_n_f32(a0), a1v = vdupq_n_f32(a1), a2v = vdupq_n_f32(a2);
+    const float32x4_t dzdxv = vdupq_n_f32(dzdx);
+#endif
+
+    for (int y = minY; y <= maxY; ++y)
+    {
+        float py = y + 0.5f;
+        float e0 = b0 * py + c0;
+        float e1 = b1 * py + c1;
+        float e2 = b2 * py + c2;
+        float z = z0 + dzdy * py;
+        float* row = &_depth[y * _width];
+
+        for (int x = minX; x <= maxX; x += 4)
+        {
+#if defined(OCCLUSION_USE_SSE)
+            __m128 px = _mm_add_ps(_mm_set1_ps((float)x), offsets);
+            __m128 inside = _mm_and_ps(_mm_and_ps(
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a0v, px), _mm_set1_ps(e0)), zero),
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a1v, px), _mm_set1_ps(e1)), zero)),
+                _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a2v, px), _mm_set1_ps(e2)), zero));
+            __m128 depth = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(depth, _mm_add_ps(_mm_mul_ps(dzdxv, px), _mm_set1_ps(z)));
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, depth)));
+#elif defined(OCCLUSION_USE_NEON)
+            float32x4_t px = vaddq_f32(vdupq_n_f32((float)x), offsets);
+            uint32x4_t inside = vandq_u32(vandq_u32(
+                vcgeq_f32(vaddq_f32(vmulq_f32(a0v, px), vdupq_n_f32(e0)), zero),
+                vcgeq_f32(vaddq_f32(vmulq_f32(a1v, px), vdupq_n_f32(e1)), zero)),
+                vcgeq_f32(vaddq_f32(vmulq_f32(a2v, px), vdupq_n_f32(e2)), zero));
+            float32x4_t depth = vld1q_f32(row + x);
+            float32x4_t nearer = vminq_f32(depth, vaddq_f32(vmulq_f32(dzdxv, px), vdupq_n_f32(z)));
+            vst1q_f32(row + x, vbslq_f32(inside, nearer, depth));
+#else
+            for (int i = 0; i < 4; ++i)
+            {
+                float px = x + i + 0.5f;
+                if (a0 * px + e0 >= 0.0f && a1 * px + e1 >= 0.0f && a2 * px + e2 >= 0.0f)
+                    row[x + i] = std::min(row[x + i], dzdx * px + z);
+            }
+#endif
+        }
+    }
+}
+
+bool OcclusionBuffer::isVisible(const BoundingBox& box) const
+{
+    Vector3 corners[8];
+    box.getCorners(corners);
+
+    // Find the screen rectangle and the nearest depth of the box. Boxes that reach
+    // behind the eye are always visible.
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX, minZ = FLT_MAX;
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        Vector4 clip;
+        _viewProjection.transformVector(Vector4(corners[i].x, corners[i].y, corners[i].z, 1.0f), &clip);
+        if (clip.w <= MATH_EPSILON)
+            return true;
+        float invW = 1.0f / clip.w;
+        float x = (clip.x * invW * 0.5f + 0.5f) * _width;
+        float y = (clip.y * invW * 0.5f + 0.5f) * _height;
+        minX = std::min(minX, x);
+        maxX = std::max(maxX, x);
+        minY = std::min(minY, y);
+        maxY = std::max(maxY, y);
+        minZ = std::min(minZ, clip.z * invW);
+    }
+    if (minZ <= -1.0f)
+        return true;
+
+    int x0 = std::max(0, (int)floorf(minX));
+    int x1 = std::min((int)_width - 1, (int)floorf(maxX));
+    int y0 = std::max(0, (int)floorf(minY));
+    int y1 = std::min((int)_height - 1, (int)floorf(maxY));
+    if (x0 > x1 || y0 > y1)
+        return false;
+
+    // Testing whole groups of four pixels only widens the rectangle, which keeps the test conservative.
+    x0 &= ~3;
+#if defined(OCCLUSION_USE_SSE)
+    const __m128 z = _mm_set1_ps(minZ);
+#elif defined(OCCLUSION_USE_NEON)
+    const float32x4_t z = vdupq_n_f32(minZ);
+#endif
+    for (int y = y0; y <= y1; ++y)
+    {
+        const float* row = &_depth[y * _width];
+        for (int x = x0; x <= x1; x += 4)
+        {
+#if defined(OCCLUSION_USE_SSE)
+            if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), z)))
+                return true;
+#elif defined(OCCLUSION_USE_NEON)
+            uint32x4_t farther = vcgeq_f32(vld1q_f32(row + x), z);
+            uint32x2_t any = vorr_u32(vget_low_u32(farther), vget_high_u32(farther));
+            if (vget_lane_u32(vpmax_u32(any, any), 0))
+                return true;
+#else
+            if (row[x] >= minZ || row[x + 1] >= minZ || row[x + 2] >= minZ || row[x + 3] >= minZ)
+                return true;
+#endif
+        }
+    }
+    return false;
+}
+
+bool OcclusionBuffer::isVisible(const BoundingSphere& sphere) const
+{
+    Vector3 extent(sphere.radius, sphere.radius, sphere.radius);
+    return isVisible(BoundingBox(sphere.center - extent, sphere.center + extent));
+}
+
+const float* OcclusionBuffer::getDepthBuffer() const
+{
+    return &_depth[0];
+}
+
+}
@@ -0,0 +1,186 @@
+#ifndef OCCLUSIONBUFFER_H_
+#define OCCLUSIONBUFFER_H_
+
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include "Matrix.h"
+
+namespace gameplay
+{
+
+class Camera;
+class Node;
+
+/**
+ * Defines a low resolution depth buffer that is rasterised on the CPU to cull nodes
+ * that are hidden behind large occluders, such as buildings, walls and terrain.
+ *
+ * Occluders are simple triangle meshes, or boxes, that are attached to a node and
+ * should lie entirely inside the geometry the node draws. Every frame, rasterize
+ * transforms the occluders that are inside the view frustum of the camera and writes
+ * their nearest depth into the buffer. Bounding volumes can then be tested against
+ * the buffer: a volume is hidden when every pixel its screen rectangle covers holds
+ * an occluder that is nearer than the nearest point of the volume.
+ *
+ * Tests are conservative, so a volume that crosses the near plane of the camera is
+ * always visible. Four pixels are processed at a time with SSE or NEON instructions
+ * where they are available.
+ *
+ * A render queue culls the nodes it adds from a scene with an occlusion buffer once
+ * it is given one through RenderQueue::setOcclusionBuffer, using the spatial index
+ * of the scene to skip entire hidden cells when it is enabled.
+ *
+ * @see SpatialIndex::findNodes(const Frustum&, const OcclusionBuffer&, std::vector<Node*>&)
+ * @script{ignore}
+ */
+class OcclusionBuffer
+{
+public:
+
+    /**
+     * Creates a new occlusion buffer without any occluders.
+     *
+     * @param width The width of the buffer in pixels, which is rounded up to a multiple of four.
+     * @param height The height of the buffer in pixels.
+     *
+     * @return A new occlusion buffer.
+     */
+    static OcclusionBuffer* create(unsigned int width = 256, unsigned int height = 128);
+
+    /**
+     * Destructor.
+     */
+    ~OcclusionBuffer();
+
+    /**
+     * Returns the width of the buffer in pixels.
+     *
+     * @return The width of the buffer.
+     */
+    unsigned int getWidth() const;
+
+    /**
+     * Returns the height of the buffer in pixels.
+     *
+     * @return The height of the buffer.
+     */
+    unsigned int getHeight() const;
+
+    /**
+     * Adds an occluder mesh to the given node.
+     *
+     * The vertices and indices are copied. Triangles must be wound counter-clockwise
+     * when seen from outside, since back faces are not rasterised.
+     *
+     * @param node The node whose world transform the occluder moves with.
+     * @param vertices The positions of the vertices, relative to the node.
+     * @param vertexCount The number of vertices.
+     * @param indices The indices of the vertices of each triangle.
+     * @param indexCount The number of indices, which must be a multiple of three.
+     */
+    void addOccluder(Node* node, const Vector3* vertices, unsigned int vertexCount, const unsigned int* indices, unsigned int indexCount);
+
+    /**
+     * Adds an occluder box to the given node.
+     *
+     * @param node The node whose world transform the occluder moves with.
+     * @param box The box, relative to the node.
+     */
+    void addOccluder(Node* node, const BoundingBox& box);
+
+    /**
+     * Removes all occluders of the given node.
+     *
+     * @param node The node to remove the occluders of.
+     */
+    void removeOccluders(Node* node);
+
+    /**
+     * Returns the number of occluders.
+     *
+     * @return The number of occluders.
+     */
+    unsigned int getOccluderCount() const;
+
+    /**
+     * Clears the buffer and rasterises the occluders of all enabled nodes for the given camera.
+     *
+     * @param camera The camera to rasterise the occluders for.
+     *
+     * @return The number of occluders that were inside the view frustum of the camera.
+     */
+    unsigned int rasterize(Camera* camera);
+
+    /**
+     * Determines if any part of the given world space box may be visible.
+     *
+     * @param box The box to test.
+     *
+     * @return False if the box is hidden by the occluders, true otherwise.
+     */
+    bool isVisible(const BoundingBox& box) const;
+
+    /**
+     * Determines if any part of the given world space sphere may be visible.
+     *
+     * The sphere is tested by the box that encloses it.
+     *
+     * @param sphere The sphere to test.
+     *
+     * @return False if the sphere is hidden by the occluders, true otherwise.
+     */
+    bool isVisible(const BoundingSphere& sphere) const;
+
+    /**
+     * Returns the depth of each pixel of the buffer, row by row from the bottom, as the
+     * normalized device depth of the nearest occluder or one where there is none.
+     *
+     * @return The depth buffer.
+     */
+    const float* getDepthBuffer() const;
+
+private:
+
+    /**
+     * A mesh that occludes the nodes behind it.
+     */
+    struct Occluder
+    {
+        Node* node;
+        std::vector<Vector3> vertices;
+        std::vector<unsigned int> indices;
+        BoundingBox bounds;
+    };
+
+    /**
+     * Constructor.
+     */
+    OcclusionBuffer(unsigned int width, unsigned int height);
+
+    /**
+     * Hidden copy constructor.
+     */
+    OcclusionBuffer(const OcclusionBuffer& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    OcclusionBuffer& operator=(const OcclusionBuffer&);
+
+    /**
+     * Rasterises a triangle whose vertices are given in pixels, with the depth in z.
+     */
+    void rasterizeTriangle(const Vector3& v0, const Vector3& v1, const Vector3& v2);
+
+    unsigned int _width;
+    unsigned int _height;
+    std::vector<float> _depth;
+    std::vector<Occluder*> _occluders;
+    std::vector<Vector3> _screenVertices;
+    std::vector<bool> _clipped;
+    Matrix _viewProjection;
+};
+
+}
+
+#endif
@@ -0,0 +1,290 @@
+#include "Base.h"
+#include "OcclusionCuller.h"
+#include "Camera.h"
+#include "Game.h"
+#include "Model.h"
+#include "Node.h"
+
+namespace gameplay
+{
+
+// Vertex shader for drawing the bounds of nodes.
+static const char* OCCLUSION_VS =
+{
+    "uniform mat4 u_worldViewProjectionMatrix;\n"
+    "attribute vec4 a_position;\n"
+    "void main(void) {\n"
+    "    gl_Position = u_worldViewProjectionMatrix * a_position;\n"
+    "}"
+};
+
+// Fragment shader for drawing the bounds of nodes, whose color is never written.
+static const char* OCCLUSION_FS =
+{
+#ifdef OPENGL_ES
+    "precision highp float;\n"
+#endif
+    "void main(void) {\n"
+    "    gl_FragColor = vec4(1.0);\n"
+    "}"
+};
+
+OcclusionCuller::OcclusionCuller()
+    : _queryInterval(8), _pendingCount(0), _effect(NULL), _matrixUniform(NULL), _box(NULL), _binding(NULL), _stateBlock(NULL)
+{
+}
+
+OcclusionCuller::~OcclusionCuller()
+{
+    SAFE_RELEASE(_binding);
+    SAFE_RELEASE(_box);
+    SAFE_RELEASE(_effect);
+    SAFE_RELEASE(_stateBlock);
+}
+
+OcclusionCuller* OcclusionCuller::create()
+{
+    OcclusionCuller* culler = new OcclusionCuller();
+    if (!isSupported())
+        return culler;
+
+    culler->_effect = Effect::createFromSource(OCCLUSION_VS, OCCLUSION_FS);
+    if (!culler->_effect)
+    {
+        GP_WARN("Failed to create the occlusion query effect.");
+        return culler;
+    }
+    culler->_matrixUniform = culler->_effect->getUniform("u_worldViewProjectionMatrix");
+
+    // The unit cube from -1 to 1, as a list of triangles so that it needs no index buffer.
+    static const float corners[8][3] =
+    {
+        { -1, 1, 1 }, { -1, -1, 1 }, { 1, -1, 1 }, { 1, 1, 1 },
+        { 1, 1, -1 }, { 1, -1, -1 }, { -1, -1, -1 }, { -1, 1, -1 }
+    };
+    static const unsigned char indices[36] =
+    {
+        0, 1, 2, 0, 2, 3,   4, 5, 6, 4, 6, 7,   7, 6, 1, 7, 1, 0,
+        3, 2, 5, 3, 5, 4,   7, 0, 3, 7, 3, 4,   1, 6, 5, 1, 5, 2
+    };
+    float vertices[36 * 3];
+    for (unsigned int i = 0; i < 36; ++i)
+    {
+        vertices[i * 3] = corners[indices[i]][0];
+        vertices[i * 3 + 1] = corners[indices[i]][1];
+        vertices[i * 3 + 2] = corners[indices[i]][2];
+    }
+
+    VertexFormat::Element elements[] =
+    {
+        VertexFormat::Element(VertexFormat::POSITION, 3)
+    };
+    culler->_box = Mesh::createMesh(VertexFormat(elements, 1), 36, false);
+    culler->_box->setPrimitiveType(Mesh::TRIANGLES);
+    culler->_box->setVertexData(vertices, 0, 36);
+    culler->_binding = VertexAttributeBinding::create(culler->_box, culler->_effect);
+
+    // The bounds are tested against the depth of the frame without changing it, and are
+    // drawn from both sides so that the query still passes when the camera is inside them.
+    culler->_stateBlock = RenderState::StateBlock::create();
+    culler->_stateBlock->setDepthTest(true);
+    culler->_stateBlock->setDepthWrite(false);
+    culler->_stateBlock->setDepthFunction(RenderState::DEPTH_LEQUAL);
+    culler->_stateBlock->setCullFace(false);
+    culler->_stateBlock->setBlend(false);
+
+    return culler;
+}
+
+bool OcclusionCuller::isSupported()
+{
+#ifdef GP_USE_OCCLUSION_QUERIES
+    return true;
+#else
+    return false;
+#endif
+}
+
+void OcclusionCuller::setQueryInterval(unsigned int frames)
+{
+    _queryInterval = std::max(frames, 1u);
+}
+
+unsigned int OcclusionCuller::getQueryInterval() const
+{
+    return _queryInterval;
+}
+
+unsigned int OcclusionCuller::getPendingQueryCount() const
+{
+    return _pendingCount;
+}
+
+void OcclusionCuller::getBoundsTransform(Node* node, Matrix* dst)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(dst);
+
+    // The box of the mesh is exact for a single model, while instanced models and other
+    // drawables are tested by the box of their bounding sphere, which covers every instance.
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    if (model && model->getMesh() && model->getInstanceCount() == 0)
+    {
+        const BoundingBox& box = model->getMesh()->getBoundingBox();
+        Vector3 center = box.getCenter();
+        Vector3 half = (box.max - box.min) * 0.5f;
+        Matrix local;
+        Matrix::createTranslation(center, &local);
+        local.scale(std::max(half.x, MATH_EPSILON), std::max(half.y, MATH_EPSILON), std::max(half.z, MATH_EPSILON));
+        Matrix::multiply(node->getWorldMatrix(), local, dst);
+    }
+    else
+    {
+        const BoundingSphere& sphere = node->getBoundingSphere();
+        Matrix::createTranslation(sphere.center, dst);
+        dst->scale(std::max(sphere.radius, MATH_EPSILON));
+    }
+}
+
+unsigned int OcclusionCuller::cull(Camera* camera, std::vector<Node*>& nodes)
+{
+    GP_PROFILE("OcclusionCuller::cull");
+
+    _queued.clear();
+    _queuedTransforms.clear();
+    if (!_effect || !camera)
+        return 0;
+
+#ifdef GP_USE_OCCLUSION_QUERIES
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    Vector3 eye = camera->getNode() ? camera->getNode()->getTranslationWorld() : Vector3::zero();
+    float nearPlane = camera->getNearPlane();
+
+    size_t kept = 0;
+    for (size_t i = 0, count = nodes.size(); i < count; ++i)
+    {
+        Node* node = nodes[i];
+        GP_ASSERT(node);
+
+        // Results are only read once the GPU has them, so a node keeps its previous
+        // visibility until then and the CPU never stalls.
+        if (node->_occlusionQueryPending)
+        {
+            GLuint available = 0;
+            GL_ASSERT( glGetQueryObjectuiv(node->_occlusionQuery, GL_QUERY_RESULT_AVAILABLE, &available) );
+            if (available)
+            {
+                GLuint samples = 0;
+                GL_ASSERT( glGetQueryObjectuiv(node->_occlusionQuery, GL_QUERY_RESULT, &samples) );
+                node->_occlusionQueryPending = false;
+                --_pendingCount;
+
+                bool visible = samples > 0;
+                if (visible && !node->_visible)
+                {
+                    // Nodes that just became visible are tested again soon, in case they were only
+                    // glimpsed, but not all on the same frame.
+                    node->_occlusionQueryFrame = frame + 1 + rand() % _queryInterval;
+                }
+                else if (visible)
+                {
+                    node->_occlusionQueryFrame = frame + _queryInterval / 2 + rand() % (_queryInterval / 2 + 1);
+                }
+                node->_visible = visible;
+            }
+        }
+
+        // A camera inside the bounds of a node, or close enough to them for the near plane to
+        // clip them, would give a wrong result, so such nodes are always visible.
+        Matrix transform;
+        getBoundsTransform(node, &transform);
+        Matrix inverse;
+        bool inside = !transform.invert(&inverse);
+        if (!inside)
+        {
+            Vector3 local;
+            inverse.transformPoint(eye, &local);
+            Vector3 scale;
+            transform.getScale(&scale);
+            float margin = nearPlane * 2.0f;
+            inside = fabs(local.x) <= 1.0f + margin / std::max(scale.x, MATH_EPSILON) &&
+                     fabs(local.y) <= 1.0f + margin / std::max(scale.y, MATH_EPSILON) &&
+                     fabs(local.z) <= 1.0f + margin / std::max(scale.z, MATH_EPSILON);
+        }
+        if (inside)
+        {
+            node->_visible = true;
+            node->_occlusionQueryFrame = frame + _queryInterval;
+        }
+        else if (!node->_occlusionQueryPending && (!node->_visible || (int)(frame - node->_occlusionQueryFrame) >= 0))
+        {
+            // Hidden nodes are tested every frame, visible ones once their interval has passed.
+            _queued.push_back(node);
+            _queuedTransforms.push_back(transform);
+        }
+
+        if (node->_visible)
+        {
+            node->_visibleFrame = frame;
+            nodes[kept++] = node;
+        }
+    }
+
+    unsigned int removed = (unsigned int)(nodes.size() - kept);
+    nodes.resize(kept);
+    return removed;
+#else
+    return 0;
+#endif
+}
+
+unsigned int OcclusionCuller::issueQueries(Camera* camera)
+{
+    GP_PROFILE("OcclusionCuller::issueQueries");
+
+    if (_queued.empty() || !_effect || !camera)
+    {
+        _queued.clear();
+        _queuedTransforms.clear();
+        return 0;
+    }
+
+#ifdef GP_USE_OCCLUSION_QUERIES
+    _stateBlock->bind();
+    GL_ASSERT( glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE) );
+    _effect->bind();
+    _binding->bind();
+
+    const Matrix& viewProjection = camera->getViewProjectionMatrix();
+    for (size_t i = 0, count = _queued.size(); i < count; ++i)
+    {
+        Node* node = _queued[i];
+        if (!node->_occlusionQuery)
+        {
+            GL_ASSERT( glGenQueries(1, &node->_occlusionQuery) );
+        }
+
+        Matrix worldViewProjection;
+        Matrix::multiply(viewProjection, _queuedTransforms[i], &worldViewProjection);
+        _effect->setValue(_matrixUniform, worldViewProjection);
+
+        GL_ASSERT( glBeginQuery(GL_SAMPLES_PASSED, node->_occlusionQuery) );
+        GL_ASSERT( glDrawArrays(GL_TRIANGLES, 0, 36) );
+        GL_ASSERT( glEndQuery(GL_SAMPLES_PASSED) );
+        node->_occlusionQueryPending = true;
+        ++_pendingCount;
+    }
+
+    _binding->unbind();
+    GL_ASSERT( glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
+
+    unsigned int count = (unsigned int)_queued.size();
+    _queued.clear();
+    _queuedTransforms.clear();
+    return count;
+#else
+    return 0;
+#endif
+}
+
+}
@@ -0,0 +1,146 @@
+#ifndef OCCLUSIONCULLER_H_
+#define OCCLUSIONCULLER_H_
+
+#include "Effect.h"
+#include "Mesh.h"
+#include "RenderState.h"
+#include "VertexAttributeBinding.h"
+
+namespace gameplay
+{
+
+class Camera;
+class Node;
+
+/**
+ * Defines a culler that skips drawing nodes which hardware occlusion queries found
+ * to be hidden behind other geometry.
+ *
+ * Queries are asynchronous: the bounds of a node are drawn with a query after the
+ * opaque geometry of a frame, and the result is only read in a later frame once it
+ * is available, so the CPU never waits for the GPU. The culler follows the temporal
+ * coherence of coherent hierarchical culling: nodes keep the visibility of their
+ * last result, hidden nodes are tested every frame so that they reappear at most one
+ * frame late, and visible nodes are only tested again after the query interval, which
+ * is spread randomly over the nodes so that their queries don't all fall on the same frame.
+ *
+ * A frame is culled in three steps:
+ *
+ * 1. cull removes the nodes that are hidden from a list of nodes that passed frustum
+ *    culling, for example from SpatialIndex::findNodes.
+ * 2. The remaining nodes are drawn, starting with the opaque ones.
+ * 3. issueQueries draws the bounds of the nodes that are due to be tested, with the
+ *    depth buffer of the opaque geometry still bound.
+ *
+ * Node::isVisible and Node::getVisibleFrame expose the results, so that game code can
+ * also skip updating animations and physics of nodes that are hidden.
+ *
+ * Occlusion queries are not available with OpenGL ES 2.0, where every node is visible.
+ *
+ * @script{ignore}
+ */
+class OcclusionCuller
+{
+public:
+
+    /**
+     * Creates a new occlusion culler.
+     *
+     * @return A new occlusion culler.
+     */
+    static OcclusionCuller* create();
+
+    /**
+     * Destructor.
+     */
+    ~OcclusionCuller();
+
+    /**
+     * Determines if the current device supports occlusion queries.
+     *
+     * @return True if occlusion queries are supported, false otherwise.
+     */
+    static bool isSupported();
+
+    /**
+     * Sets the number of frames after which a visible node is tested again.
+     *
+     * @param frames The query interval in frames, at least one.
+     */
+    void setQueryInterval(unsigned int frames);
+
+    /**
+     * Returns the number of frames after which a visible node is tested again.
+     *
+     * @return The query interval in frames.
+     */
+    unsigned int getQueryInterval() const;
+
+    /**
+     * Reads the available query results of the given nodes, removes the nodes that
+     * are hidden and selects the nodes to test in issueQueries.
+     *
+     * Nodes whose bounds contain the camera are always visible and are not tested.
+     *
+     * @param camera The camera the nodes are drawn with.
+     * @param nodes The nodes that passed frustum culling, from which the hidden nodes are removed.
+     *
+     * @return The number of nodes that were removed.
+     */
+    unsigned int cull(Camera* camera, std::vector<Node*>& nodes);
+
+    /**
+     * Draws the bounds of the nodes selected by the last call to cull with occlusion queries.
+     *
+     * This should be called after the opaque geometry has been drawn, with its depth
+     * buffer still bound. Neither color nor depth are written.
+     *
+     * @param camera The camera the nodes were drawn with.
+     *
+     * @return The number of queries issued.
+     */
+    unsigned int issueQueries(Camera* camera);
+
+    /**
+     * Returns the number of nodes that are waiting for the result of their query.
+     *
+     * @return The number of pending queries.
+     */
+    unsigned int getPendingQueryCount() const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    OcclusionCuller();
+
+    /**
+     * Hidden copy constructor.
+     */
+    OcclusionCuller(const OcclusionCuller& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    OcclusionCuller& operator=(const OcclusionCuller&);
+
+    /**
+     * Computes the transform of the unit cube that encloses the given node, in world space.
+     */
+    static void getBoundsTransform(Node* node, Matrix* dst);
+
+    unsigned int _queryInterval;
+    std::vector<Node*> _queued;
+    std::vector<Matrix> _queuedTransforms;
+    unsigned int _pendingCount;
+    Effect* _effect;
+    Uniform* _matrixUniform;
+    Mesh* _box;
+    VertexAttributeBinding* _binding;
+    RenderState::StateBlock* _stateBlock;
+};
+
+}
+
+#endif
@@ -5,15 +5,435 @@
 #include "Scene.h"
 #include "Quaternion.h"
 #include "Properties.h"
+#include "JobController.h"
+#include "Material.h"
+#include "Technique.h"
+#include "Pass.h"
+#include "Effect.h"
+#include "Model.h"
+#include "FileSystem.h"
+#include "RenderStats.h"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define PARTICLE_USE_SSE
+#elif defined(GP_USE_NEON) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PARTICLE_USE_NEON
+#endif
 
 #define PARTICLE_COUNT_MAX                       100
 #define PARTICLE_EMISSION_RATE                   10
 #define PARTICLE_EMISSION_RATE_TIME_INTERVAL     1000.0f / (float)PARTICLE_EMISSION_RATE
 #define PARTICLE_UPDATE_RATE_MAX                 8
+#define PARTICLE_STREAM_COUNT                    33
+#define PARTICLE_BLOCK_SIZE                      256
+#define PARTICLE_PARALLEL_COUNT_MIN              4096
+#define PARTICLE_PARALLEL_GRAIN_SIZE             2048
+#define PARTICLE_GPU_UPDATE_VSH                  "res/shaders/particle-update.vert"
+#define PARTICLE_GPU_VSH                         "res/shaders/particle.vert"
+#define PARTICLE_INSTANCED_VSH                   "res/shaders/particle-instanced.vert"
+#define PARTICLE_FSH                             "res/shaders/particle.frag"
+#define PARTICLE_INSTANCE_SIZE                   10
+#define PARTICLE_GPU_ATTRIBUTE_COUNT             4
+#define PARTICLE_GPU_STRIDE                      (PARTICLE_GPU_ATTRIBUTE_COUNT * 4 * sizeof(float))
+#define PARTICLE_FRAME_COUNT_MAX                 64
 
 namespace gameplay
 {
 
+// Computes dst[i] += src[i] * scale.
+static void multiplyAdd(float* dst, const float* src, float scale, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(PARTICLE_USE_SSE)
+    __m128 s = _mm_set1_ps(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_mul_ps(_mm_loadu_ps(src + i), s)));
+    }
+#elif defined(PARTICLE_USE_NEON)
+    float32x4_t s = vdupq_n_f32(scale);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(dst + i, vmlaq_f32(vld1q_f32(dst + i), vld1q_f32(src + i), s));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] += src[i] * scale;
+    }
+}
+
+// Computes dst[i] = start[i] + (end[i] - start[i]) * t[i].
+static void lerp(float* dst, const float* start, const float* end, const float* t, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(PARTICLE_USE_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 a = _mm_loadu_ps(start + i);
+        _mm_storeu_ps(dst + i, _mm_add_ps(a, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(end + i), a), _mm_loadu_ps(t + i))));
+    }
+#elif defined(PARTICLE_USE_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t a = vld1q_f32(start + i);
+        vst1q_f32(dst + i, vmlaq_f32(a, vsubq_f32(vld1q_f32(end + i), a), vld1q_f32(t + i)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        dst[i] = start[i] + (end[i] - start[i]) * t[i];
+    }
+}
+
+// Subtracts the elapsed time from the energy of particles and computes how much of their life has passed.
+static void age(float* energy, const float* energyStart, float elapsed, float* percent, unsigned int count)
+{
+    unsigned int i = 0;
+#if defined(PARTICLE_USE_SSE)
+    __m128 e = _mm_set1_ps(elapsed);
+    __m128 one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_sub_ps(_mm_loadu_ps(energy + i), e);
+        _mm_storeu_ps(energy + i, x);
+        _mm_storeu_ps(percent + i, _mm_sub_ps(one, _mm_div_ps(x, _mm_loadu_ps(energyStart + i))));
+    }
+#elif defined(PARTICLE_USE_NEON)
+    float32x4_t e = vdupq_n_f32(elapsed);
+    float32x4_t one = vdupq_n_f32(1.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t x = vsubq_f32(vld1q_f32(energy + i), e);
+        vst1q_f32(energy + i, x);
+
+        // Refine the reciprocal estimate twice for full precision.
+        float32x4_t start = vld1q_f32(energyStart + i);
+        float32x4_t r = vrecpeq_f32(start);
+        r = vmulq_f32(vrecpsq_f32(start, r), r);
+        r = vmulq_f32(vrecpsq_f32(start, r), r);
+        vst1q_f32(percent + i, vmlsq_f32(one, x, r));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        energy[i] -= elapsed;
+        percent[i] = 1.0f - energy[i] / energyStart[i];
+    }
+}
+
+ParticleEmitter::Particles::Particles(unsigned int capacity)
+    : _capacity((capacity + 3) & ~3u), _data(NULL)
+{
+    float** streams[PARTICLE_STREAM_COUNT] =
+    {
+        &_positionX, &_positionY, &_positionZ,
+        &_velocityX, &_velocityY, &_velocityZ,
+        &_accelerationX, &_accelerationY, &_accelerationZ,
+        &_colorStartR, &_colorStartG, &_colorStartB, &_colorStartA,
+        &_colorEndR, &_colorEndG, &_colorEndB, &_colorEndA,
+        &_colorR, &_colorG, &_colorB, &_colorA,
+        &_rotationPerParticleSpeed,
+        &_rotationAxisX, &_rotationAxisY, &_rotationAxisZ,
+        &_rotationSpeed, &_angle,
+        &_energyStart, &_energy,
+        &_sizeStart, &_sizeEnd, &_size,
+        &_timeOnCurrentFrame
+    };
+
+    // All the arrays share one allocation and start on a 16 byte boundary within it.
+    _data = new float[PARTICLE_STREAM_COUNT * _capacity];
+    memset(_data, 0, sizeof(float) * PARTICLE_STREAM_COUNT * _capacity);
+    for (unsigned int i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+    {
+        *streams[i] = _data + i * _capacity;
+    }
+    _frame = new unsigned int[_capacity];
+    memset(_frame, 0, sizeof(unsigned int) * _capacity);
+}
+
+ParticleEmitter::Particles::~Particles()
+{
+    SAFE_DELETE_ARRAY(_data);
+    SAFE_DELETE_ARRAY(_frame);
+}
+
+void ParticleEmitter::Particles::copy(unsigned int dst, unsigned int src)
+{
+    GP_ASSERT(dst < _capacity && src < _capacity);
+
+    for (unsigned int i = 0; i < PARTICLE_STREAM_COUNT; ++i)
+    {
+        _data[i * _capacity + dst] = _data[i * _capacity + src];
+    }
+    _frame[dst] = _frame[src];
+}
+
+#ifdef GP_USE_TRANSFORM_FEEDBACK
+
+// The attributes of a particle simulated on the GPU, and the outputs of the update shader that replace them.
+static const char* __gpuAttributes[PARTICLE_GPU_ATTRIBUTE_COUNT] = { "a_positionEnergy", "a_velocityLifetime", "a_accelerationAngle", "a_seed" };
+static const char* __gpuVaryings[PARTICLE_GPU_ATTRIBUTE_COUNT] = { "v_positionEnergy", "v_velocityLifetime", "v_accelerationAngle", "v_seed" };
+
+// The uniforms of the update shader.
+enum GpuUniform
+{
+    GPU_ELAPSED_TIME,
+    GPU_TIME,
+    GPU_EMIT_START,
+    GPU_EMIT_COUNT,
+    GPU_PARTICLE_COUNT_MAX,
+    GPU_POSITION,
+    GPU_POSITION_VAR,
+    GPU_VELOCITY,
+    GPU_VELOCITY_VAR,
+    GPU_ACCELERATION,
+    GPU_ACCELERATION_VAR,
+    GPU_ENERGY,
+    GPU_ROTATION_PER_PARTICLE_SPEED,
+    GPU_SIZE,
+    GPU_ELLIPSOID,
+    GPU_ORBIT,
+    GPU_WORLD_MATRIX,
+    GPU_UNIFORM_COUNT
+};
+static const char* __gpuUniforms[GPU_UNIFORM_COUNT] =
+{
+    "u_elapsedTime", "u_time", "u_emitStart", "u_emitCount", "u_particleCountMax",
+    "u_position", "u_positionVar", "u_velocity", "u_velocityVar", "u_acceleration", "u_accelerationVar",
+    "u_energy", "u_rotationPerParticleSpeed", "u_size", "u_ellipsoid", "u_orbit", "u_worldMatrix"
+};
+
+// Creates the program that updates the particles, capturing the outputs of its vertex shader.
+static GLuint createUpdateProgram(const char* vshPath)
+{
+    char* source = FileSystem::readAll(vshPath);
+    if (!source)
+    {
+        GP_WARN("Failed to read vertex shader from file '%s'.", vshPath);
+        return 0;
+    }
+
+    const GLchar* sources[2] = { "#version 130\n", source };
+    GLuint shader;
+    GL_ASSERT( shader = glCreateShader(GL_VERTEX_SHADER) );
+    GL_ASSERT( glShaderSource(shader, 2, sources, NULL) );
+    GL_ASSERT( glCompileShader(shader) );
+    SAFE_DELETE_ARRAY(source);
+
+    GLint success;
+    char log[1024];
+    GL_ASSERT( glGetShaderiv(shader, GL_COMPILE_STATUS, &success) );
+    if (success != GL_TRUE)
+    {
+        GL_ASSERT( glGetShaderInfoLog(shader, sizeof(log), NULL, log) );
+        GP_WARN("Compile failed for vertex shader '%s' with error '%s'.", vshPath, log);
+        GL_ASSERT( glDeleteShader(shader) );
+        return 0;
+    }
+
+    GLuint program;
+    GL_ASSERT( program = glCreateProgram() );
+    GL_ASSERT( glAttachShader(program, shader) );
+    for (unsigned int i = 0; i < PARTICLE_GPU_ATTRIBUTE_COUNT; ++i)
+    {
+        GL_ASSERT( glBindAttribLocation(program, i, __gpuAttributes[i]) );
+    }
+    GL_ASSERT( glTransformFeedbackVaryings(program, PARTICLE_GPU_ATTRIBUTE_COUNT, __gpuVaryings, GL_INTERLEAVED_ATTRIBS) );
+    GL_ASSERT( glLinkProgram(program) );
+    GL_ASSERT( glDeleteShader(shader) );
+
+    GL_ASSERT( glGetProgramiv(program, GL_LINK_STATUS, &success) );
+    if (success != GL_TRUE)
+    {
+        GL_ASSERT( glGetProgramInfoLog(program, sizeof(log), NULL, log) );
+        GP_WARN("Linking program failed for vertex shader '%s' with error '%s'.", vshPath, log);
+        GL_ASSERT( glDeleteProgram(program) );
+        return 0;
+    }
+
+    return program;
+}
+
+class ParticleEmitter::GpuSimulation
+{
+public:
+
+    GpuSimulation(unsigned int capacity);
+
+    ~GpuSimulation();
+
+    bool initialize();
+
+    // Queues particles to emit on the next step and returns how many can be emitted.
+    unsigned int emit(unsigned int count);
+
+    // Advances the time and returns how many particles may still be alive.
+    unsigned int advance(float elapsedTime);
+
+    // A batch of particles emitted on the same step, all of which are dead once the time passes its expiry.
+    struct Batch
+    {
+        double expires;
+        unsigned int count;
+    };
+
+    unsigned int capacity;
+    unsigned int current;
+    unsigned int emitStart;
+    unsigned int emitCount;
+    float elapsedTime;
+    double time;
+    std::deque<Batch> batches;
+    unsigned int alive;
+    GLuint buffers[2];
+    GLuint updateArrays[2];
+    GLuint drawArrays[2];
+    GLuint cornerBuffer;
+    GLuint program;
+    GLint uniforms[GPU_UNIFORM_COUNT];
+    Material* material;
+};
+
+ParticleEmitter::GpuSimulation::GpuSimulation(unsigned int capacity)
+    : capacity(capacity), current(0), emitStart(0), emitCount(0), elapsedTime(0.0f), time(0.0), alive(0),
+      cornerBuffer(0), program(0), material(NULL)
+{
+    buffers[0] = buffers[1] = 0;
+    updateArrays[0] = updateArrays[1] = 0;
+    drawArrays[0] = drawArrays[1] = 0;
+}
+
+ParticleEmitter::GpuSimulation::~GpuSimulation()
+{
+    if (buffers[0])
+    {
+        GL_ASSERT( glDeleteVertexArrays(2, updateArrays) );
+        GL_ASSERT( glDeleteVertexArrays(2, drawArrays) );
+        GL_ASSERT( glDeleteBuffers(2, buffers) );
+        GL_ASSERT( glDeleteBuffers(1, &cornerBuffer) );
+        RenderStats::removeMemory(RenderStats::VERTEX_BUFFER_MEMORY, 2 * capacity * PARTICLE_GPU_STRIDE + 8 * sizeof(float), this);
+    }
+    if (program)
+    {
+        GL_ASSERT( glDeleteProgram(program) );
+    }
+    SAFE_RELEASE(material);
+}
+
+bool ParticleEmitter::GpuSimulation::initialize()
+{
+    program = createUpdateProgram(PARTICLE_GPU_UPDATE_VSH);
+    if (!program)
+        return false;
+    for (unsigned int i = 0; i < GPU_UNIFORM_COUNT; ++i)
+    {
+        GL_ASSERT( uniforms[i] = glGetUniformLocation(program, __gpuUniforms[i]) );
+    }
+
+    material = Material::create(PARTICLE_GPU_VSH, PARTICLE_FSH);
+    if (!material)
+        return false;
+    material->getStateBlock()->setDepthWrite(false);
+    material->getStateBlock()->setDepthTest(true);
+    Effect* effect = material->getTechnique()->getPassByIndex(0)->getEffect();
+    GP_ASSERT(effect);
+
+    // Two buffers hold the particles: each update reads one of them and writes the other. All particles start out dead.
+    std::vector<float> particles(capacity * PARTICLE_GPU_STRIDE / sizeof(float), 0.0f);
+    GL_ASSERT( glGenBuffers(2, buffers) );
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, buffers[i]) );
+        GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, capacity * PARTICLE_GPU_STRIDE, &particles[0], GL_DYNAMIC_COPY) );
+    }
+
+    // The corners of the quad drawn for every particle, as a triangle strip.
+    static const float corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f };
+    GL_ASSERT( glGenBuffers(1, &cornerBuffer) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW) );
+    RenderStats::addMemory(RenderStats::VERTEX_BUFFER_MEMORY, 2 * capacity * PARTICLE_GPU_STRIDE + sizeof(corners), this, "particle simulation");
+
+    GL_ASSERT( glGenVertexArrays(2, updateArrays) );
+    GL_ASSERT( glGenVertexArrays(2, drawArrays) );
+    VertexAttribute cornerAttrib = effect->getVertexAttribute("a_position");
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        GL_ASSERT( glBindVertexArray(updateArrays[i]) );
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, buffers[i]) );
+        for (unsigned int j = 0; j < PARTICLE_GPU_ATTRIBUTE_COUNT; ++j)
+        {
+            GL_ASSERT( glVertexAttribPointer(j, 4, GL_FLOAT, GL_FALSE, PARTICLE_GPU_STRIDE, (GLvoid*)(j * 4 * sizeof(float))) );
+            GL_ASSERT( glEnableVertexAttribArray(j) );
+        }
+
+        // Every particle is drawn as an instance of the quad.
+        GL_ASSERT( glBindVertexArray(drawArrays[i]) );
+        if (cornerAttrib != -1)
+        {
+            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, cornerBuffer) );
+            GL_ASSERT( glVertexAttribPointer(cornerAttrib, 2, GL_FLOAT, GL_FALSE, 0, 0) );
+            GL_ASSERT( glEnableVertexAttribArray(cornerAttrib) );
+        }
+        GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, buffers[i]) );
+        for (unsigned int j = 0; j < PARTICLE_GPU_ATTRIBUTE_COUNT; ++j)
+        {
+            VertexAttribute attrib = effect->getVertexAttribute(__gpuAttributes[j]);
+            if (attrib != -1)
+            {
+                GL_ASSERT( glVertexAttribPointer(attrib, 4, GL_FLOAT, GL_FALSE, PARTICLE_GPU_STRIDE, (GLvoid*)(j * 4 * sizeof(float))) );
+                GL_ASSERT( glEnableVertexAttribArray(attrib) );
+                GL_ASSERT( glVertexAttribDivisor(attrib, 1) );
+            }
+        }
+    }
+    GL_ASSERT( glBindVertexArray(0) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    return true;
+}
+
+unsigned int ParticleEmitter::GpuSimulation::emit(unsigned int count)
+{
+    // New particles overwrite the oldest slots of the buffer, so never emit more than the slots known to be free.
+    count = std::min(count, capacity - alive);
+    emitCount += count;
+    alive += count;
+    return count;
+}
+
+unsigned int ParticleEmitter::GpuSimulation::advance(float elapsed)
+{
+    elapsedTime += elapsed;
+    time += elapsed;
+    while (!batches.empty() && batches.front().expires <= time)
+    {
+        alive -= batches.front().count;
+        batches.pop_front();
+    }
+    return alive;
+}
+
+#else
+
+class ParticleEmitter::GpuSimulation
+{
+public:
+
+    GpuSimulation(unsigned int capacity) { }
+
+    bool initialize() { return false; }
+
+    unsigned int emit(unsigned int count) { return 0; }
+
+    unsigned int advance(float elapsedTime) { return 0; }
+};
+
+#endif
+
 ParticleEmitter::ParticleEmitter(unsigned int particleCountMax) : Drawable(),
     _particleCountMax(particleCountMax), _particleCount(0), _particles(NULL),
     _emissionRate(PARTICLE_EMISSION_RATE), _started(false), _ellipsoid(false),
@@ -25,21 +445,31 @@ ParticleEmitter::ParticleEmitter(unsigned int particleCountMax) : Drawable(),
     _acceleration(Vector3::zero()), _accelerationVar(Vector3::zero()),
     _rotationPerParticleSpeedMin(0.0f), _rotationPerParticleSpeedMax(0.0f),
     _rotationSpeedMin(0.0f), _rotationSpeedMax(0.0f),
-    _rotationAxis(Vector3::zero()), _rotation(Matrix::identity()),
+    _rotationAxis(Vector3::zero()),
     _spriteBatch(NULL), _spriteBlendMode(BLEND_ALPHA),  _spriteTextureWidth(0), _spriteTextureHeight(0), _spriteTextureWidthRatio(0), _spriteTextureHeightRatio(0), _spriteTextureCoords(NULL),
     _spriteAnimated(false),  _spriteLooped(false), _spriteFrameCount(1), _spriteFrameRandomOffset(0),_spriteFrameDuration(0L), _spriteFrameDurationSecs(0.0f), _spritePercentPerFrame(0.0f),
     _orbitPosition(false), _orbitVelocity(false), _orbitAcceleration(false),
-    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _emitTime(0), _lastUpdated(0)
+    _timePerEmission(PARTICLE_EMISSION_RATE_TIME_INTERVAL), _emitTime(0), _runningTime(0), _gpuSimulation(NULL),
+    _instancedMaterial(NULL), _instancedQuad(NULL), _instanceBuffer(0),
+    _sleepInterval(0.0f), _lodNearDistance(0.0f), _lodFarDistance(0.0f)
 {
     GP_ASSERT(particleCountMax);
-    _particles = new Particle[particleCountMax];
+    _particles = new Particles(particleCountMax);
 }
 
 ParticleEmitter::~ParticleEmitter()
 {
     SAFE_DELETE(_spriteBatch);
-    SAFE_DELETE_ARRAY(_particles);
+    SAFE_DELETE(_particles);
     SAFE_DELETE_ARRAY(_spriteTextureCoords);
+    SAFE_DELETE(_gpuSimulation);
+    SAFE_RELEASE(_instancedMaterial);
+    SAFE_RELEASE(_instancedQuad);
+    if (_instanceBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &_instanceBuffer) );
+        RenderStats::removeMemory(RenderStats::VERTEX_BUFFER_MEMORY, _instanceData.size() * sizeof(float), this);
+    }
 }
 
 ParticleEmitter* ParticleEmitter::create(const char* textureFile, BlendMode blendMode, unsigned int particleCountMax)
@@ -175,6 +605,10 @@ ParticleEmitter* ParticleEmitter::create(Properties* properties)
     bool orbitPosition = properties->getBool("orbitPosition");
     bool orbitVelocity = properties->getBool("orbitVelocity");
     bool orbitAcceleration = properties->getBool("orbitAcceleration");
+    Simulation simulation = getSimulationFromString(properties->getString("simulation"));
+    float sleepInterval = properties->getFloat("sleepInterval");
+    float lodNear = properties->getFloat("lodNear");
+    float lodFar = properties->getFloat("lodFar");
 
     // Apply all properties to a newly created ParticleEmitter.
     ParticleEmitter* emitter = ParticleEmitter::create(texturePath.c_str(), blendMode, particleCountMax);
@@ -199,6 +633,9 @@ ParticleEmitter* ParticleEmitter::create(Properties* properties)
     emitter->setSpriteFrameDuration(spriteFrameDuration);
     emitter->setSpriteFrameCoords(spriteFrameCount, spriteWidth, spriteHeight);
     emitter->setOrbit(orbitPosition, orbitVelocity, orbitAcceleration);
+    emitter->setSimulation(simulation);
+    emitter->setSleepInterval(sleepInterval);
+    emitter->setLodDistance(lodNear, lodFar);
 
     return emitter;
 }
@@ -231,6 +668,11 @@ void ParticleEmitter::setTexture(Texture* texture, BlendMode blendMode)
     _spriteBatch->getStateBlock()->setDepthWrite(false);
     _spriteBatch->getStateBlock()->setDepthTest(true);
 
+    if (!_instancedMaterial)
+    {
+        createInstancedDraw();
+    }
+
     setBlendMode(blendMode);
     _spriteTextureWidth = texture->getWidth();
     _spriteTextureHeight = texture->getHeight();
@@ -273,7 +715,7 @@ void ParticleEmitter::setEmissionRate(unsigned int rate)
 void ParticleEmitter::start()
 {
     _started = true;
-    _lastUpdated = 0;
+    _runningTime = 0;
 }
 
 void ParticleEmitter::stop()
@@ -308,6 +750,13 @@ void ParticleEmitter::emitOnce(unsigned int particleCount)
         particleCount = _particleCountMax - _particleCount;
     }
 
+    if (_gpuSimulation)
+    {
+        // Particles simulated on the GPU are emitted by the next simulation step.
+        _particleCount += _gpuSimulation->emit(particleCount);
+        return;
+    }
+
     Vector3 translation;
     Matrix world = _node->getWorldMatrix();
     world.getTranslation(&translation);
@@ -318,63 +767,90 @@ void ParticleEmitter::emitOnce(unsigned int particleCount)
     world.m[14] = 0.0f;
 
     // Emit the new particles.
-    for (unsigned int i = 0; i < particleCount; i++)
+    Particles& p = *_particles;
+    for (unsigned int n = 0; n < particleCount; n++)
     {
-        Particle* p = &_particles[_particleCount];
-
-        generateColor(_colorStart, _colorStartVar, &p->_colorStart);
-        generateColor(_colorEnd, _colorEndVar, &p->_colorEnd);
-        p->_color.set(p->_colorStart);
-
-        p->_energy = p->_energyStart = generateScalar(_energyMin, _energyMax);
-        p->_size = p->_sizeStart = generateScalar(_sizeStartMin, _sizeStartMax);
-        p->_sizeEnd = generateScalar(_sizeEndMin, _sizeEndMax);
-        p->_rotationPerParticleSpeed = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
-        p->_angle = generateScalar(0.0f, p->_rotationPerParticleSpeed);
-        p->_rotationSpeed = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
+        unsigned int i = _particleCount;
+
+        Vector4 colorStart;
+        Vector4 colorEnd;
+        generateColor(_colorStart, _colorStartVar, &colorStart);
+        generateColor(_colorEnd, _colorEndVar, &colorEnd);
+        p._colorStartR[i] = p._colorR[i] = colorStart.x;
+        p._colorStartG[i] = p._colorG[i] = colorStart.y;
+        p._colorStartB[i] = p._colorB[i] = colorStart.z;
+        p._colorStartA[i] = p._colorA[i] = colorStart.w;
+        p._colorEndR[i] = colorEnd.x;
+        p._colorEndG[i] = colorEnd.y;
+        p._colorEndB[i] = colorEnd.z;
+        p._colorEndA[i] = colorEnd.w;
+
+        p._energy[i] = p._energyStart[i] = generateScalar(_energyMin, _energyMax);
+        p._size[i] = p._sizeStart[i] = generateScalar(_sizeStartMin, _sizeStartMax);
+        p._sizeEnd[i] = generateScalar(_sizeEndMin, _sizeEndMax);
+        p._rotationPerParticleSpeed[i] = generateScalar(_rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax);
+        p._angle[i] = generateScalar(0.0f, p._rotationPerParticleSpeed[i]);
+        p._rotationSpeed[i] = generateScalar(_rotationSpeedMin, _rotationSpeedMax);
 
         // Only initial position can be generated within an ellipsoidal domain.
-        generateVector(_position, _positionVar, &p->_position, _ellipsoid);
-        generateVector(_velocity, _velocityVar, &p->_velocity, false);
-        generateVector(_acceleration, _accelerationVar, &p->_acceleration, false);
-        generateVector(_rotationAxis, _rotationAxisVar, &p->_rotationAxis, false);
+        Vector3 position;
+        Vector3 velocity;
+        Vector3 acceleration;
+        Vector3 rotationAxis;
+        generateVector(_position, _positionVar, &position, _ellipsoid);
+        generateVector(_velocity, _velocityVar, &velocity, false);
+        generateVector(_acceleration, _accelerationVar, &acceleration, false);
+        generateVector(_rotationAxis, _rotationAxisVar, &rotationAxis, false);
 
         // Initial position, velocity and acceleration can all be relative to the emitter's transform.
         // Rotate specified properties by the node's rotation.
         if (_orbitPosition)
         {
-            world.transformPoint(p->_position, &p->_position);
+            world.transformPoint(position, &position);
         }
 
         if (_orbitVelocity)
         {
-            world.transformPoint(p->_velocity, &p->_velocity);
+            world.transformPoint(velocity, &velocity);
         }
 
         if (_orbitAcceleration)
         {
-            world.transformPoint(p->_acceleration, &p->_acceleration);
+            world.transformPoint(acceleration, &acceleration);
         }
 
         // The rotation axis always orbits the node.
-        if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+        if (p._rotationSpeed[i] != 0.0f && !rotationAxis.isZero())
         {
-            world.transformPoint(p->_rotationAxis, &p->_rotationAxis);
+            world.transformPoint(rotationAxis, &rotationAxis);
         }
 
         // Translate position relative to the node's world space.
-        p->_position.add(translation);
+        position.add(translation);
+
+        p._positionX[i] = position.x;
+        p._positionY[i] = position.y;
+        p._positionZ[i] = position.z;
+        p._velocityX[i] = velocity.x;
+        p._velocityY[i] = velocity.y;
+        p._velocityZ[i] = velocity.z;
+        p._accelerationX[i] = acceleration.x;
+        p._accelerationY[i] = acceleration.y;
+        p._accelerationZ[i] = acceleration.z;
+        p._rotationAxisX[i] = rotationAxis.x;
+        p._rotationAxisY[i] = rotationAxis.y;
+        p._rotationAxisZ[i] = rotationAxis.z;
 
         // Initial sprite frame.
         if (_spriteFrameRandomOffset > 0)
         {
-            p->_frame = rand() % _spriteFrameRandomOffset;
+            p._frame[i] = rand() % _spriteFrameRandomOffset;
         }
         else
         {
-            p->_frame = 0;
+            p._frame[i] = 0;
         }
-        p->_timeOnCurrentFrame = 0.0f;
+        p._timeOnCurrentFrame[i] = 0.0f;
 
         ++_particleCount;
     }
@@ -559,35 +1035,52 @@ const Vector3& ParticleEmitter::getRotationAxisVariance() const
     return _rotationAxisVar;
 }
 
-void ParticleEmitter::setBlendMode(BlendMode blendMode)
+// Sets the blending of a state block used to draw particles.
+static void setBlendState(RenderState::StateBlock* stateBlock, ParticleEmitter::BlendMode blendMode)
 {
-    GP_ASSERT(_spriteBatch);
-    GP_ASSERT(_spriteBatch->getStateBlock());
+    GP_ASSERT(stateBlock);
 
     switch (blendMode)
     {
-        case BLEND_NONE:
-            _spriteBatch->getStateBlock()->setBlend(false);
+        case ParticleEmitter::BLEND_NONE:
+            stateBlock->setBlend(false);
             break;
-        case BLEND_ALPHA:
-            _spriteBatch->getStateBlock()->setBlend(true);
-            _spriteBatch->getStateBlock()->setBlendSrc(RenderState::BLEND_SRC_ALPHA);
-            _spriteBatch->getStateBlock()->setBlendDst(RenderState::BLEND_ONE_MINUS_SRC_ALPHA);
+        case ParticleEmitter::BLEND_ALPHA:
+            stateBlock->setBlend(true);
+            stateBlock->setBlendSrc(RenderState::BLEND_SRC_ALPHA);
+            stateBlock->setBlendDst(RenderState::BLEND_ONE_MINUS_SRC_ALPHA);
             break;
-        case BLEND_ADDITIVE:
-            _spriteBatch->getStateBlock()->setBlend(true);
-            _spriteBatch->getStateBlock()->setBlendSrc(RenderState::BLEND_SRC_ALPHA);
-            _spriteBatch->getStateBlock()->setBlendDst(RenderState::BLEND_ONE);
+        case ParticleEmitter::BLEND_ADDITIVE:
+            stateBlock->setBlend(true);
+            stateBlock->setBlendSrc(RenderState::BLEND_SRC_ALPHA);
+            stateBlock->setBlendDst(RenderState::BLEND_ONE);
             break;
-        case BLEND_MULTIPLIED:
-            _spriteBatch->getStateBlock()->setBlend(true);
-            _spriteBatch->getStateBlock()->setBlendSrc(RenderState::BLEND_ZERO);
-            _spriteBatch->getStateBlock()->setBlendDst(RenderState::BLEND_SRC_COLOR);
+        case ParticleEmitter::BLEND_MULTIPLIED:
+            stateBlock->setBlend(true);
+            stateBlock->setBlendSrc(RenderState::BLEND_ZERO);
+            stateBlock->setBlendDst(RenderState::BLEND_SRC_COLOR);
             break;
         default:
             GP_ERROR("Unsupported blend mode (%d).", blendMode);
             break;
     }
+}
+
+void ParticleEmitter::setBlendMode(BlendMode blendMode)
+{
+    GP_ASSERT(_spriteBatch);
+
+    setBlendState(_spriteBatch->getStateBlock(), blendMode);
+    if (_instancedMaterial)
+    {
+        setBlendState(_instancedMaterial->getStateBlock(), blendMode);
+    }
+#ifdef GP_USE_TRANSFORM_FEEDBACK
+    if (_gpuSimulation)
+    {
+        setBlendState(_gpuSimulation->material->getStateBlock(), blendMode);
+    }
+#endif
 
     _spriteBlendMode = blendMode;
 }
@@ -856,6 +1349,147 @@ ParticleEmitter::BlendMode ParticleEmitter::getBlendModeFromString(const char* s
     }
 }
 
+ParticleEmitter::Simulation ParticleEmitter::getSimulationFromString(const char* str)
+{
+    if (str && (strcmp(str, "SIMULATION_GPU") == 0 || strcmp(str, "GPU") == 0))
+    {
+        return SIMULATION_GPU;
+    }
+    else
+    {
+        return SIMULATION_CPU;
+    }
+}
+
+void ParticleEmitter::setSimulation(Simulation simulation)
+{
+    if (simulation == getSimulation())
+        return;
+
+    SAFE_DELETE(_gpuSimulation);
+    _particleCount = 0;
+
+    if (simulation == SIMULATION_GPU)
+    {
+        if (!isGpuSimulationSupported())
+        {
+            GP_WARN("GPU particle simulation is not supported, simulating on the CPU instead.");
+            return;
+        }
+
+        _gpuSimulation = new GpuSimulation(_particleCountMax);
+        if (!_gpuSimulation->initialize())
+        {
+            GP_WARN("Failed to create GPU particle simulation, simulating on the CPU instead.");
+            SAFE_DELETE(_gpuSimulation);
+            return;
+        }
+        setBlendMode(_spriteBlendMode);
+    }
+}
+
+ParticleEmitter::Simulation ParticleEmitter::getSimulation() const
+{
+    return _gpuSimulation ? SIMULATION_GPU : SIMULATION_CPU;
+}
+
+bool ParticleEmitter::isGpuSimulationSupported()
+{
+#ifdef GP_USE_TRANSFORM_FEEDBACK
+    // Transform feedback is only available if the device supports OpenGL 3.0.
+    return glTransformFeedbackVaryings && glBeginTransformFeedback && glGenVertexArrays && Model::isInstancingSupported();
+#else
+    return false;
+#endif
+}
+
+BoundingSphere ParticleEmitter::getBoundingSphere() const
+{
+    Matrix world;
+    if (_node)
+    {
+        world = _node->getWorldMatrix();
+    }
+
+    // Particles are emitted within the position variance, around a position that may orbit the node.
+    Vector3 center;
+    if (_orbitPosition)
+    {
+        world.transformVector(_position, &center);
+    }
+    else
+    {
+        center = _position;
+    }
+    Vector3 translation;
+    world.getTranslation(&translation);
+    center.add(translation);
+
+    // Then they move at most as far as the fastest particle can during the longest lifetime.
+    float energy = (float)std::max(_energyMin, _energyMax) * 0.001f;
+    float speed = _velocity.length() + _velocityVar.length();
+    float acceleration = _acceleration.length() + _accelerationVar.length();
+    float size = std::max(std::max(_sizeStartMin, _sizeStartMax), std::max(_sizeEndMin, _sizeEndMax));
+    // The corners of a rotated particle are at most half its diagonal away from its position.
+    float radius = _positionVar.length() + speed * energy + 0.5f * acceleration * energy * energy + size * 0.7072f;
+
+    return BoundingSphere(center, radius);
+}
+
+void ParticleEmitter::setSleepInterval(float interval)
+{
+    _sleepInterval = interval;
+}
+
+float ParticleEmitter::getSleepInterval() const
+{
+    return _sleepInterval;
+}
+
+void ParticleEmitter::setLodDistance(float nearDistance, float farDistance)
+{
+    _lodNearDistance = nearDistance;
+    _lodFarDistance = farDistance;
+}
+
+float ParticleEmitter::getLodNearDistance() const
+{
+    return _lodNearDistance;
+}
+
+float ParticleEmitter::getLodFarDistance() const
+{
+    return _lodFarDistance;
+}
+
+bool ParticleEmitter::isInView() const
+{
+    Scene* scene = _node ? _node->getScene() : NULL;
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (!camera)
+        return true;
+
+    return getBoundingSphere().intersects(camera->getFrustum());
+}
+
+float ParticleEmitter::getLodScale() const
+{
+    if (_lodFarDistance <= 0.0f)
+        return 1.0f;
+
+    Scene* scene = _node ? _node->getScene() : NULL;
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (!camera || !camera->getNode())
+        return 1.0f;
+
+    float distance = camera->getNode()->getTranslationWorld().distance(_node->getTranslationWorld());
+    if (distance <= _lodNearDistance)
+        return 1.0f;
+    if (distance >= _lodFarDistance)
+        return 0.0f;
+    return 1.0f - (distance - _lodNearDistance) / (_lodFarDistance - _lodNearDistance);
+}
+
 void ParticleEmitter::update(float elapsedTime)
 {
     if (!isActive())
@@ -864,24 +1498,27 @@ void ParticleEmitter::update(float elapsedTime)
     // Cap particle updates at a maximum rate. This saves processing
     // and also improves precision since updating with very small
     // time increments is more lossy.
-    static double runningTime = 0;
-    runningTime += elapsedTime;
-    if (runningTime < PARTICLE_UPDATE_RATE_MAX)
-        return;    
+    _runningTime += elapsedTime;
+    if (_runningTime < PARTICLE_UPDATE_RATE_MAX)
+        return;
 
-    float elapsedMs = runningTime;
-    runningTime = 0;
+    // Off-screen emitters sleep until their update interval has passed.
+    if (_runningTime < _sleepInterval && !isInView())
+        return;
 
-    float elapsedSecs = elapsedMs * 0.001f;
+    float elapsedMs = _runningTime;
+    _runningTime = 0;
 
+    unsigned int emitCount = 0;
     if (_started && _emissionRate)
     {
-        // Calculate how much time has passed since we last emitted particles.
-        _emitTime += elapsedMs; //+= elapsedTime;
+        // Calculate how much time has passed since we last emitted particles,
+        // which passes more slowly for distant emitters.
+        _emitTime += elapsedMs * getLodScale();
 
         // How many particles should we emit this frame?
         GP_ASSERT(_timePerEmission);
-        unsigned int emitCount = (unsigned int)(_emitTime / _timePerEmission);
+        emitCount = (unsigned int)(_emitTime / _timePerEmission);
 
         if (emitCount)
         {
@@ -889,93 +1526,163 @@ void ParticleEmitter::update(float elapsedTime)
             {
                 _emitTime = fmod((double)_emitTime, (double)_timePerEmission);
             }
+        }
+    }
+
+    if (_gpuSimulation)
+    {
+        if (emitCount)
+        {
             emitOnce(emitCount);
         }
+
+        // Particles simulated on the GPU are moved when the emitter is drawn.
+        _particleCount = _gpuSimulation->advance(elapsedMs);
+        return;
     }
 
-    // Now update all currently living particles.
+    // Now update all currently living particles. Large emitters are split among the job workers.
     GP_ASSERT(_particles);
-    for (unsigned int particlesIndex = 0; particlesIndex < _particleCount; ++particlesIndex)
+    JobController* jobController = Game::getInstance()->getJobController();
+    if (jobController && _particleCount >= PARTICLE_PARALLEL_COUNT_MIN)
     {
-        Particle* p = &_particles[particlesIndex];
-        p->_energy -= elapsedMs;
+        jobController->parallelFor(_particleCount, [this, elapsedMs](unsigned int begin, unsigned int end, unsigned int worker)
+        {
+            updateParticles(begin, end, elapsedMs);
+        }, PARTICLE_PARALLEL_GRAIN_SIZE);
+    }
+    else
+    {
+        updateParticles(0, _particleCount, elapsedMs);
+    }
+
+    // Emit the new particles, spreading their emission over the elapsed time. This keeps
+    // the particles emitted by a sleeping emitter from bunching up when it wakes up.
+    if (emitCount)
+    {
+        unsigned int first = _particleCount;
+        emitOnce(emitCount);
+        unsigned int count = _particleCount - first;
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            updateParticles(first + i, first + i + 1, elapsedMs * ((float)(count - i) - 0.5f) / (float)count);
+        }
+    }
 
-        if (p->_energy > 0L)
+    // Move the particle furthest from the start of the array down to take the place of
+    // each dead particle, and re-use the slot at the end of the list of living particles.
+    for (unsigned int i = 0; i < _particleCount;)
+    {
+        if (_particles->_energy[i] > 0.0f)
         {
-            if (p->_rotationSpeed != 0.0f && !p->_rotationAxis.isZero())
+            ++i;
+        }
+        else
+        {
+            --_particleCount;
+            if (i != _particleCount)
             {
-                Matrix::createRotation(p->_rotationAxis, p->_rotationSpeed * elapsedSecs, &_rotation);
+                _particles->copy(i, _particleCount);
+            }
+        }
+    }
+}
+
+void ParticleEmitter::updateParticles(unsigned int begin, unsigned int end, float elapsedMs)
+{
+    Particles& p = *_particles;
+    float elapsedSecs = elapsedMs * 0.001f;
 
-                _rotation.transformPoint(p->_velocity, &p->_velocity);
-                _rotation.transformPoint(p->_acceleration, &p->_acceleration);
+    // Rotate the velocity and acceleration of rotating particles.
+    for (unsigned int i = begin; i < end; ++i)
+    {
+        if (p._rotationSpeed[i] != 0.0f)
+        {
+            Vector3 axis(p._rotationAxisX[i], p._rotationAxisY[i], p._rotationAxisZ[i]);
+            if (!axis.isZero())
+            {
+                Matrix rotation;
+                Matrix::createRotation(axis, p._rotationSpeed[i] * elapsedSecs, &rotation);
+
+                Vector3 velocity(p._velocityX[i], p._velocityY[i], p._velocityZ[i]);
+                Vector3 acceleration(p._accelerationX[i], p._accelerationY[i], p._accelerationZ[i]);
+                rotation.transformPoint(&velocity);
+                rotation.transformPoint(&acceleration);
+                p._velocityX[i] = velocity.x;
+                p._velocityY[i] = velocity.y;
+                p._velocityZ[i] = velocity.z;
+                p._accelerationX[i] = acceleration.x;
+                p._accelerationY[i] = acceleration.y;
+                p._accelerationZ[i] = acceleration.z;
             }
+        }
+    }
 
-            // Particle is still alive.
-            p->_velocity.x += p->_acceleration.x * elapsedSecs;
-            p->_velocity.y += p->_acceleration.y * elapsedSecs;
-            p->_velocity.z += p->_acceleration.z * elapsedSecs;
+    // Integrate the remaining properties in blocks, so the life percentage of a block stays in cache.
+    float percent[PARTICLE_BLOCK_SIZE];
+    for (unsigned int first = begin; first < end; first += PARTICLE_BLOCK_SIZE)
+    {
+        unsigned int count = std::min(end - first, (unsigned int)PARTICLE_BLOCK_SIZE);
 
-            p->_position.x += p->_velocity.x * elapsedSecs;
-            p->_position.y += p->_velocity.y * elapsedSecs;
-            p->_position.z += p->_velocity.z * elapsedSecs;
+        age(p._energy + first, p._energyStart + first, elapsedMs, percent, count);
 
-            p->_angle += p->_rotationPerParticleSpeed * elapsedSecs;
+        // Integrate exactly under constant acceleration, so long updates stay accurate.
+        multiplyAdd(p._positionX + first, p._velocityX + first, elapsedSecs, count);
+        multiplyAdd(p._positionY + first, p._velocityY + first, elapsedSecs, count);
+        multiplyAdd(p._positionZ + first, p._velocityZ + first, elapsedSecs, count);
+        multiplyAdd(p._positionX + first, p._accelerationX + first, 0.5f * elapsedSecs * elapsedSecs, count);
+        multiplyAdd(p._positionY + first, p._accelerationY + first, 0.5f * elapsedSecs * elapsedSecs, count);
+        multiplyAdd(p._positionZ + first, p._accelerationZ + first, 0.5f * elapsedSecs * elapsedSecs, count);
 
-            // Simple linear interpolation of color and size.
-            float percent = 1.0f - ((float)p->_energy / (float)p->_energyStart);
+        multiplyAdd(p._velocityX + first, p._accelerationX + first, elapsedSecs, count);
+        multiplyAdd(p._velocityY + first, p._accelerationY + first, elapsedSecs, count);
+        multiplyAdd(p._velocityZ + first, p._accelerationZ + first, elapsedSecs, count);
 
-            p->_color.x = p->_colorStart.x + (p->_colorEnd.x - p->_colorStart.x) * percent;
-            p->_color.y = p->_colorStart.y + (p->_colorEnd.y - p->_colorStart.y) * percent;
-            p->_color.z = p->_colorStart.z + (p->_colorEnd.z - p->_colorStart.z) * percent;
-            p->_color.w = p->_colorStart.w + (p->_colorEnd.w - p->_colorStart.w) * percent;
+        multiplyAdd(p._angle + first, p._rotationPerParticleSpeed + first, elapsedSecs, count);
 
-            p->_size = p->_sizeStart + (p->_sizeEnd - p->_sizeStart) * percent;
+        // Simple linear interpolation of color and size.
+        lerp(p._colorR + first, p._colorStartR + first, p._colorEndR + first, percent, count);
+        lerp(p._colorG + first, p._colorStartG + first, p._colorEndG + first, percent, count);
+        lerp(p._colorB + first, p._colorStartB + first, p._colorEndB + first, percent, count);
+        lerp(p._colorA + first, p._colorStartA + first, p._colorEndA + first, percent, count);
+        lerp(p._size + first, p._sizeStart + first, p._sizeEnd + first, percent, count);
 
-            // Handle sprite animations.
-            if (_spriteAnimated)
+        // Handle sprite animations.
+        if (_spriteAnimated)
+        {
+            for (unsigned int j = 0; j < count; ++j)
             {
+                unsigned int i = first + j;
                 if (!_spriteLooped)
                 {
                     // The last frame should finish exactly when the particle dies.
-                    float percentSpent = 0.0f;
-                    for (unsigned int i = 0; i < p->_frame; i++)
-                    {
-                        percentSpent += _spritePercentPerFrame;
-                    }
-                    p->_timeOnCurrentFrame = percent - percentSpent;
-                    if (p->_frame < _spriteFrameCount - 1 &&
-                        p->_timeOnCurrentFrame >= _spritePercentPerFrame)
+                    float percentSpent = p._frame[i] * _spritePercentPerFrame;
+                    p._timeOnCurrentFrame[i] = percent[j] - percentSpent;
+                    if (p._frame[i] < _spriteFrameCount - 1 &&
+                        p._timeOnCurrentFrame[i] >= _spritePercentPerFrame)
                     {
-                        ++p->_frame;
+                        ++p._frame[i];
                     }
                 }
                 else
                 {
                     // _spriteFrameDurationSecs is an absolute time measured in seconds,
                     // and the animation repeats indefinitely.
-                    p->_timeOnCurrentFrame += elapsedSecs;
-                    if (p->_timeOnCurrentFrame >= _spriteFrameDurationSecs)
+                    p._timeOnCurrentFrame[i] += elapsedSecs;
+                    if (p._timeOnCurrentFrame[i] >= _spriteFrameDurationSecs)
                     {
-                        p->_timeOnCurrentFrame -= _spriteFrameDurationSecs;
-                        ++p->_frame;
-                        if (p->_frame == _spriteFrameCount)
+                        // Long updates can pass several frames at once.
+                        unsigned int frames = 1;
+                        if (_spriteFrameDurationSecs > 0.0f)
                         {
-                            p->_frame = 0;
+                            frames = (unsigned int)(p._timeOnCurrentFrame[i] / _spriteFrameDurationSecs);
                         }
+                        p._timeOnCurrentFrame[i] -= frames * _spriteFrameDurationSecs;
+                        p._frame[i] = (p._frame[i] + frames) % _spriteFrameCount;
                     }
                 }
             }
         }
-        else
-        {
-            // Particle is dead.  Move the particle furthest from the start of the array
-            // down to take its place, and re-use the slot at the end of the list of living particles.
-            if (particlesIndex != _particleCount - 1)
-            {
-                _particles[particlesIndex] = _particles[_particleCount - 1];
-            }
-            --_particleCount;
-        }
     }
 }
 
@@ -984,7 +1691,14 @@ unsigned int ParticleEmitter::draw(bool wireframe)
     if (!isActive())
         return 0;
 
-    if (_particleCount > 0)
+    if (_gpuSimulation)
+        return drawGpu();
+
+    if (_particleCount > 0 && _instancedMaterial && _spriteFrameCount <= PARTICLE_FRAME_COUNT_MAX)
+    {
+        drawInstanced();
+    }
+    else if (_particleCount > 0)
     {
         GP_ASSERT(_spriteBatch);
         GP_ASSERT(_particles);
@@ -1011,13 +1725,13 @@ unsigned int ParticleEmitter::draw(bool wireframe)
         Vector3 up;
         cameraWorldMatrix.getUpVector(&up);
 
+        const Particles& p = *_particles;
         for (unsigned int i = 0; i < _particleCount; i++)
         {
-            Particle* p = &_particles[i];
-
-            _spriteBatch->draw(p->_position, right, up, p->_size, p->_size,
-                                _spriteTextureCoords[p->_frame * 4], _spriteTextureCoords[p->_frame * 4 + 1], _spriteTextureCoords[p->_frame * 4 + 2], _spriteTextureCoords[p->_frame * 4 + 3],
-                                p->_color, pivot, p->_angle);
+            const float* coords = &_spriteTextureCoords[p._frame[i] * 4];
+            _spriteBatch->draw(Vector3(p._positionX[i], p._positionY[i], p._positionZ[i]), right, up, p._size[i], p._size[i],
+                                coords[0], coords[1], coords[2], coords[3],
+                                Vector4(p._colorR[i], p._colorG[i], p._colorB[i], p._colorA[i]), pivot, p._angle[i]);
         }
 
         // Render.
@@ -1026,12 +1740,268 @@ unsigned int ParticleEmitter::draw(bool wireframe)
     return 1;
 }
 
+bool ParticleEmitter::createInstancedDraw()
+{
+    if (!Model::isInstancingSupported())
+        return false;
+
+    Material* material = Material::create(PARTICLE_INSTANCED_VSH, PARTICLE_FSH);
+    if (!material)
+    {
+        GP_WARN("Failed to create material for instanced particles, drawing with a sprite batch instead.");
+        return false;
+    }
+    material->getStateBlock()->setDepthWrite(false);
+    material->getStateBlock()->setDepthTest(true);
+
+    // Every particle is drawn as an instance of a quad, as a triangle strip.
+    static const float corners[] = { -0.5f, -0.5f, 0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f };
+    VertexFormat::Element element(VertexFormat::POSITION, 2);
+    Mesh* quad = Mesh::createMesh(VertexFormat(&element, 1), 4, false);
+    if (!quad)
+    {
+        GP_WARN("Failed to create mesh for instanced particles, drawing with a sprite batch instead.");
+        SAFE_RELEASE(material);
+        return false;
+    }
+    quad->setPrimitiveType(Mesh::TRIANGLE_STRIP);
+    quad->setVertexData(corners, 0, 4);
+
+    Pass* pass = material->getTechnique()->getPassByIndex(0);
+    GP_ASSERT(pass);
+    VertexAttributeBinding* binding = VertexAttributeBinding::create(quad, pass->getEffect());
+    pass->setVertexAttributeBinding(binding);
+    SAFE_RELEASE(binding);
+
+    // The buffer holds a record for every particle and is refilled each time the emitter is drawn.
+    _instanceData.resize(_particleCountMax * PARTICLE_INSTANCE_SIZE);
+    GL_ASSERT( glGenBuffers(1, &_instanceBuffer) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, _instanceData.size() * sizeof(float), NULL, GL_STREAM_DRAW) );
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+    RenderStats::addMemory(RenderStats::VERTEX_BUFFER_MEMORY, _instanceData.size() * sizeof(float), this, "particle instances");
+
+    _instancedMaterial = material;
+    _instancedQuad = quad;
+    return true;
+}
+
+void ParticleEmitter::drawInstanced()
+{
+    GP_ASSERT(_instancedMaterial);
+    GP_ASSERT(_instanceBuffer);
+    GP_ASSERT(_particles);
+    GP_ASSERT(_spriteBatch);
+    GP_ASSERT(_spriteTextureCoords);
+
+    // Particles always face the camera.
+    GP_ASSERT(_node && _node->getScene() && _node->getScene()->getActiveCamera() && _node->getScene()->getActiveCamera()->getNode());
+    const Matrix& cameraWorldMatrix = _node->getScene()->getActiveCamera()->getNode()->getWorldMatrix();
+
+    Vector3 right;
+    cameraWorldMatrix.getRightVector(&right);
+    Vector3 up;
+    cameraWorldMatrix.getUpVector(&up);
+
+    // Pack a record for every particle: its position and size, color, rotation angle and sprite frame.
+    unsigned int count = std::min(_particleCount, (unsigned int)(_instanceData.size() / PARTICLE_INSTANCE_SIZE));
+    const Particles& p = *_particles;
+    float* data = &_instanceData[0];
+    for (unsigned int i = 0; i < count; ++i, data += PARTICLE_INSTANCE_SIZE)
+    {
+        data[0] = p._positionX[i];
+        data[1] = p._positionY[i];
+        data[2] = p._positionZ[i];
+        data[3] = p._size[i];
+        data[4] = p._colorR[i];
+        data[5] = p._colorG[i];
+        data[6] = p._colorB[i];
+        data[7] = p._colorA[i];
+        data[8] = p._angle[i];
+        data[9] = (float)p._frame[i];
+    }
+
+    _instancedMaterial->getParameter("u_viewProjectionMatrix")->setValue(_node->getViewProjectionMatrix());
+    _instancedMaterial->getParameter("u_cameraRight")->setValue(right);
+    _instancedMaterial->getParameter("u_cameraUp")->setValue(up);
+    _instancedMaterial->getParameter("u_texture")->setValue(_spriteBatch->getSampler());
+    _instancedMaterial->getParameter("u_frameCoords")->setValue((const Vector4*)_spriteTextureCoords, _spriteFrameCount);
+
+    Pass* pass = _instancedMaterial->getTechnique()->getPassByIndex(0);
+    GP_ASSERT(pass);
+    pass->bind();
+
+    // Orphan the previous contents of the buffer so the upload does not wait for the last draw.
+    GLsizei stride = PARTICLE_INSTANCE_SIZE * sizeof(float);
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer) );
+    GL_ASSERT( glBufferData(GL_ARRAY_BUFFER, _instanceData.size() * sizeof(float), NULL, GL_STREAM_DRAW) );
+    GL_ASSERT( glBufferSubData(GL_ARRAY_BUFFER, 0, count * stride, &_instanceData[0]) );
+    RenderStats::count(RenderStats::BUFFER_BINDS);
+
+    static const char* names[] = { "a_positionSize", "a_color", "a_angleFrame" };
+    static const GLint sizes[] = { 4, 4, 2 };
+    static const unsigned int offsets[] = { 0, 4, 8 };
+    Effect* effect = pass->getEffect();
+    VertexAttribute attribs[3];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        attribs[i] = effect->getVertexAttribute(names[i]);
+        if (attribs[i] != -1)
+        {
+            GL_ASSERT( glVertexAttribPointer(attribs[i], sizes[i], GL_FLOAT, GL_FALSE, stride, (void*)(offsets[i] * sizeof(float))) );
+            GL_ASSERT( glEnableVertexAttribArray(attribs[i]) );
+            GL_ASSERT( glVertexAttribDivisor(attribs[i], 1) );
+        }
+    }
+    GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+
+    GL_ASSERT( glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, count) );
+    RenderStats::count(RenderStats::DRAW_CALLS);
+
+    // The attribute state may belong to the vertex array object of the quad, so reset it while it is still bound.
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        if (attribs[i] != -1)
+        {
+            GL_ASSERT( glVertexAttribDivisor(attribs[i], 0) );
+            GL_ASSERT( glDisableVertexAttribArray(attribs[i]) );
+        }
+    }
+    pass->unbind();
+}
+
+#ifdef GP_USE_TRANSFORM_FEEDBACK
+
+void ParticleEmitter::simulateGpu()
+{
+    GpuSimulation* gpu = _gpuSimulation;
+    GP_ASSERT(gpu);
+    GP_ASSERT(_node);
+
+    const Matrix& world = _node->getWorldMatrix();
+    const GLint* uniforms = gpu->uniforms;
+    GL_ASSERT( glUseProgram(gpu->program) );
+    GL_ASSERT( glUniform1f(uniforms[GPU_ELAPSED_TIME], gpu->elapsedTime) );
+    GL_ASSERT( glUniform1f(uniforms[GPU_TIME], (float)fmod(gpu->time, 1000.0)) );
+    GL_ASSERT( glUniform1i(uniforms[GPU_EMIT_START], (GLint)gpu->emitStart) );
+    GL_ASSERT( glUniform1i(uniforms[GPU_EMIT_COUNT], (GLint)gpu->emitCount) );
+    GL_ASSERT( glUniform1i(uniforms[GPU_PARTICLE_COUNT_MAX], (GLint)gpu->capacity) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_POSITION], _position.x, _position.y, _position.z) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_POSITION_VAR], _positionVar.x, _positionVar.y, _positionVar.z) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_VELOCITY], _velocity.x, _velocity.y, _velocity.z) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_VELOCITY_VAR], _velocityVar.x, _velocityVar.y, _velocityVar.z) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_ACCELERATION], _acceleration.x, _acceleration.y, _acceleration.z) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_ACCELERATION_VAR], _accelerationVar.x, _accelerationVar.y, _accelerationVar.z) );
+    GL_ASSERT( glUniform2f(uniforms[GPU_ENERGY], (float)_energyMin, (float)_energyMax) );
+    GL_ASSERT( glUniform2f(uniforms[GPU_ROTATION_PER_PARTICLE_SPEED], _rotationPerParticleSpeedMin, _rotationPerParticleSpeedMax) );
+    GL_ASSERT( glUniform4f(uniforms[GPU_SIZE], _sizeStartMin, _sizeStartMax, _sizeEndMin, _sizeEndMax) );
+    GL_ASSERT( glUniform1i(uniforms[GPU_ELLIPSOID], _ellipsoid ? 1 : 0) );
+    GL_ASSERT( glUniform3f(uniforms[GPU_ORBIT], _orbitPosition ? 1.0f : 0.0f, _orbitVelocity ? 1.0f : 0.0f, _orbitAcceleration ? 1.0f : 0.0f) );
+    GL_ASSERT( glUniformMatrix4fv(uniforms[GPU_WORLD_MATRIX], 1, GL_FALSE, world.m) );
+    RenderStats::count(RenderStats::PROGRAM_BINDS);
+
+    // Only the outputs of the vertex shader are needed, so nothing is rasterized.
+    GL_ASSERT( glEnable(GL_RASTERIZER_DISCARD) );
+    GL_ASSERT( glBindVertexArray(gpu->updateArrays[gpu->current]) );
+    GL_ASSERT( glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, gpu->buffers[1 - gpu->current]) );
+    GL_ASSERT( glBeginTransformFeedback(GL_POINTS) );
+    GL_ASSERT( glDrawArrays(GL_POINTS, 0, gpu->capacity) );
+    GL_ASSERT( glEndTransformFeedback() );
+    GL_ASSERT( glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0) );
+    GL_ASSERT( glBindVertexArray(0) );
+    GL_ASSERT( glDisable(GL_RASTERIZER_DISCARD) );
+    RenderStats::count(RenderStats::DRAW_CALLS);
+
+    // Effect only binds its program when it changes, so restore the program it last bound.
+    Effect* effect = Effect::getCurrentEffect();
+    GL_ASSERT( glUseProgram(effect ? effect->_program : 0) );
+
+    if (gpu->emitCount)
+    {
+        GpuSimulation::Batch batch = { gpu->time + _energyMax, gpu->emitCount };
+        gpu->batches.push_back(batch);
+        gpu->emitStart = (gpu->emitStart + gpu->emitCount) % gpu->capacity;
+        gpu->emitCount = 0;
+    }
+    gpu->elapsedTime = 0.0f;
+    gpu->current = 1 - gpu->current;
+}
+
+unsigned int ParticleEmitter::drawGpu()
+{
+    GpuSimulation* gpu = _gpuSimulation;
+    GP_ASSERT(gpu);
+    GP_ASSERT(gpu->material);
+    GP_ASSERT(_spriteBatch);
+    GP_ASSERT(_spriteTextureCoords);
+
+    if (gpu->elapsedTime > 0.0f || gpu->emitCount)
+    {
+        simulateGpu();
+    }
+
+    if (_particleCount > 0)
+    {
+        // Particles always face the camera.
+        GP_ASSERT(_node && _node->getScene() && _node->getScene()->getActiveCamera() && _node->getScene()->getActiveCamera()->getNode());
+        const Matrix& cameraWorldMatrix = _node->getScene()->getActiveCamera()->getNode()->getWorldMatrix();
+
+        Vector3 right;
+        cameraWorldMatrix.getRightVector(&right);
+        Vector3 up;
+        cameraWorldMatrix.getUpVector(&up);
+
+        unsigned int frameCount = std::min(_spriteFrameCount, (unsigned int)PARTICLE_FRAME_COUNT_MAX);
+        float animation = !_spriteAnimated ? 0.0f : (_spriteLooped ? 2.0f : 1.0f);
+
+        Material* material = gpu->material;
+        material->getParameter("u_viewProjectionMatrix")->setValue(_node->getViewProjectionMatrix());
+        material->getParameter("u_cameraRight")->setValue(right);
+        material->getParameter("u_cameraUp")->setValue(up);
+        material->getParameter("u_colorStart")->setValue(_colorStart);
+        material->getParameter("u_colorStartVar")->setValue(_colorStartVar);
+        material->getParameter("u_colorEnd")->setValue(_colorEnd);
+        material->getParameter("u_colorEndVar")->setValue(_colorEndVar);
+        material->getParameter("u_texture")->setValue(_spriteBatch->getSampler());
+        material->getParameter("u_frameCoords")->setValue((const Vector4*)_spriteTextureCoords, frameCount);
+        material->getParameter("u_frameCount")->setValue((float)frameCount);
+        material->getParameter("u_frameRandomOffset")->setValue((float)std::min(_spriteFrameRandomOffset, frameCount));
+        material->getParameter("u_frameDuration")->setValue(_spriteFrameDurationSecs);
+        material->getParameter("u_animation")->setValue(animation);
+
+        // A single instanced draw call draws a quad for every slot; dead particles are culled by the vertex shader.
+        Pass* pass = material->getTechnique()->getPassByIndex(0);
+        GP_ASSERT(pass);
+        pass->bind();
+        GL_ASSERT( glBindVertexArray(gpu->drawArrays[gpu->current]) );
+        GL_ASSERT( glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, gpu->capacity) );
+        GL_ASSERT( glBindVertexArray(0) );
+        pass->unbind();
+        RenderStats::count(RenderStats::DRAW_CALLS);
+    }
+    return 1;
+}
+
+#else
+
+void ParticleEmitter::simulateGpu()
+{
+}
+
+unsigned int ParticleEmitter::drawGpu()
+{
+    return 0;
+}
+
+#endif
+
 Drawable* ParticleEmitter::clone(NodeCloneContext& context)
 {
     // Create a clone of this emitter
     ParticleEmitter* clone = ParticleEmitter::create(_spriteBatch->getSampler()->getTexture(),
                                                      _spriteBlendMode, _particleCountMax);
     // Clone properties
+    clone->setSimulation(getSimulation());
     clone->setEmissionRate(_emissionRate);
     clone->_ellipsoid = _ellipsoid;
     clone->_sizeStartMin = _sizeStartMin;
@@ -1064,6 +2034,9 @@ Drawable* ParticleEmitter::clone(NodeCloneContext& context)
     clone->_orbitPosition = _orbitPosition;
     clone->_orbitVelocity = _orbitVelocity;
     clone->_orbitAcceleration = _orbitAcceleration;
+    clone->_sleepInterval = _sleepInterval;
+    clone->_lodNearDistance = _lodNearDistance;
+    clone->_lodFarDistance = _lodFarDistance;
 
     return clone;
 }
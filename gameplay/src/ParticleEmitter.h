@@ -7,9 +7,11 @@
 #include "Vector4.h"
 #include "Texture.h"
 #include "Rectangle.h"
+#include "BoundingSphere.h"
 #include "SpriteBatch.h"
 #include "Properties.h"
 #include "Drawable.h"
+#include "Material.h"
 
 namespace gameplay
 {
@@ -137,6 +139,28 @@ class Node;
  * be set before rendering the particle system and then will be reset to their original
  * values.  Accepts the same symbolic constants as glBlendFunc().
  *
+ * <h2>Simulation:</h2>
+ *
+ * By default particles are simulated on the CPU.  Where instancing is supported they are
+ * drawn as instanced quads, uploading one compact record per particle and expanding the
+ * camera-facing quads in the vertex shader; otherwise, or when more than 64 sprite frames
+ * are used, they are drawn with a sprite batch.  Emitters
+ * can instead be simulated on the GPU, which allows for hundreds of thousands of particles:
+ * particles are emitted, moved and retired by a vertex shader using transform feedback, and
+ * drawn with a single instanced draw call.  The CPU only passes the emitter properties to
+ * the shaders, so getParticlesCount() returns an estimate in this mode.  Particles are then
+ * simulated when the emitter is drawn rather than when it is updated.  GPU simulation does
+ * not support the RotationSpeed and RotationAxis properties, and supports at most 64 sprite
+ * frames.  It requires OpenGL 3.0 on the desktop.  Emitters fall back to the CPU simulation
+ * where it is not supported.  The simulation is selected with the 'simulation' property of a
+ * .particle file, which is either CPU or GPU.
+ *
+ * <h2>Culling:</h2>
+ *
+ * Off-screen emitters can be made to sleep with the 'sleepInterval' property, and their
+ * emission rate can be reduced with the camera distance using the 'lodNear' and 'lodFar'
+ * properties.  See setSleepInterval() and setLodDistance().
+ *
  * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-Particles
  */
 class ParticleEmitter : public Ref, public Drawable
@@ -156,6 +180,15 @@ public:
         BLEND_MULTIPLIED
     };
 
+    /**
+     * Defines where the particles of an emitter are simulated.
+     */
+    enum Simulation
+    {
+        SIMULATION_CPU,
+        SIMULATION_GPU
+    };
+
     /**
      * Creates a particle emitter using the data from the Properties object defined at the specified URL, 
      * where the URL is of the format "<file-path>.<extension>#<namespace-id>/<namespace-id>/.../<namespace-id>"
@@ -700,6 +733,87 @@ public:
      */
     BlendMode getBlendMode() const;
 
+    /**
+     * Sets where the particles of this emitter are simulated.
+     *
+     * Changing the simulation removes all particles currently alive. If GPU simulation
+     * is requested but is not supported, the emitter keeps simulating on the CPU.
+     *
+     * @param simulation The simulation to use.
+     */
+    void setSimulation(Simulation simulation);
+
+    /**
+     * Gets where the particles of this emitter are simulated.
+     *
+     * @return The simulation in use.
+     */
+    Simulation getSimulation() const;
+
+    /**
+     * Returns whether particles can be simulated on the GPU on this device.
+     *
+     * @return true if GPU simulation is supported, false otherwise.
+     */
+    static bool isGpuSimulationSupported();
+
+    /**
+     * Gets a conservative world-space bounding sphere of the particles of this emitter.
+     *
+     * The bounds are computed from the emitter's properties rather than from its particles:
+     * they contain every particle that can be emitted at the node's current transform during
+     * its maximum energy, given the maximum velocity and acceleration.
+     *
+     * @return The bounding sphere of the particles.
+     */
+    BoundingSphere getBoundingSphere() const;
+
+    /**
+     * Sets the interval between updates of this emitter while its bounds are outside of the
+     * view frustum of the scene's active camera.
+     *
+     * An emitter that is off-screen sleeps: it only updates once the interval has passed,
+     * and then advances its particles over the whole time it slept. Particles emitted
+     * during that time are spread over it, so the emitter looks as if it had been updated
+     * all along when it becomes visible again. An interval of zero disables sleeping.
+     *
+     * @param interval The update interval in milliseconds.
+     */
+    void setSleepInterval(float interval);
+
+    /**
+     * Gets the interval between updates while this emitter is off-screen.
+     *
+     * @return The update interval in milliseconds.
+     */
+    float getSleepInterval() const;
+
+    /**
+     * Sets the camera distances between which the emission rate of this emitter is reduced.
+     *
+     * Closer than the near distance particles are emitted at the full emission rate, which
+     * is scaled down linearly to zero at the far distance. The distances are measured from
+     * the scene's active camera to the node. A far distance of zero disables the scaling.
+     *
+     * @param nearDistance The distance up to which the full emission rate is used.
+     * @param farDistance The distance from which no more particles are emitted.
+     */
+    void setLodDistance(float nearDistance, float farDistance);
+
+    /**
+     * Gets the distance up to which the full emission rate is used.
+     *
+     * @return The near level of detail distance.
+     */
+    float getLodNearDistance() const;
+
+    /**
+     * Gets the distance from which no more particles are emitted.
+     *
+     * @return The far level of detail distance.
+     */
+    float getLodFarDistance() const;
+
     /**
      * Updates the particles currently being emitted.
      *
@@ -765,35 +879,112 @@ private:
     // Gets the blend mode from string.
     static ParticleEmitter::BlendMode getBlendModeFromString(const char* src);
 
+    // Gets the simulation from string.
+    static ParticleEmitter::Simulation getSimulationFromString(const char* src);
+
     /**
-     * Defines the data for a single particle in the system.
+     * Defines the GPU resources of an emitter that is simulated on the GPU.
      */
-    class Particle
-    {
+    class GpuSimulation;
+
+    // Runs the GPU simulation for the time and emissions accumulated since the last draw.
+    void simulateGpu();
+
+    // Draws the particles simulated on the GPU.
+    unsigned int drawGpu();
+
+    // Creates the material and quad used to draw particles simulated on the CPU as instances.
+    bool createInstancedDraw();
+
+    // Draws the particles simulated on the CPU as instanced quads.
+    void drawInstanced();
+
+    // Returns whether the bounds of the particles intersect the view frustum of the active camera.
+    bool isInView() const;
 
+    // Returns the scale applied to the emission rate at the distance of the active camera.
+    float getLodScale() const;
+
+    /**
+     * Defines the data of all particles in the system as a structure of arrays.
+     *
+     * Every property of the particles is stored in its own array, so that the
+     * update can process four particles at a time with SIMD instructions.
+     */
+    class Particles
+    {
     public:
-        Vector3 _position;
-        Vector3 _velocity;
-        Vector3 _acceleration;
-        Vector4 _colorStart;
-        Vector4 _colorEnd;
-        Vector4 _color;
-        float _rotationPerParticleSpeed;
-        Vector3 _rotationAxis;
-        float _rotationSpeed;
-        float _angle;
-        long _energyStart;
-        long _energy;
-        float _sizeStart;
-        float _sizeEnd;
-        float _size;
-        unsigned int _frame;
-        float _timeOnCurrentFrame;
+
+        /**
+         * Constructor.
+         *
+         * @param capacity The maximum number of particles.
+         */
+        Particles(unsigned int capacity);
+
+        /**
+         * Destructor.
+         */
+        ~Particles();
+
+        /**
+         * Copies all the properties of a particle over another particle.
+         *
+         * @param dst The index of the particle to overwrite.
+         * @param src The index of the particle to copy.
+         */
+        void copy(unsigned int dst, unsigned int src);
+
+        float* _positionX;
+        float* _positionY;
+        float* _positionZ;
+        float* _velocityX;
+        float* _velocityY;
+        float* _velocityZ;
+        float* _accelerationX;
+        float* _accelerationY;
+        float* _accelerationZ;
+        float* _colorStartR;
+        float* _colorStartG;
+        float* _colorStartB;
+        float* _colorStartA;
+        float* _colorEndR;
+        float* _colorEndG;
+        float* _colorEndB;
+        float* _colorEndA;
+        float* _colorR;
+        float* _colorG;
+        float* _colorB;
+        float* _colorA;
+        float* _rotationPerParticleSpeed;
+        float* _rotationAxisX;
+        float* _rotationAxisY;
+        float* _rotationAxisZ;
+        float* _rotationSpeed;
+        float* _angle;
+        float* _energyStart;
+        float* _energy;
+        float* _sizeStart;
+        float* _sizeEnd;
+        float* _size;
+        float* _timeOnCurrentFrame;
+        unsigned int* _frame;
+
+    private:
+
+        Particles(const Particles& copy);
+        Particles& operator=(const Particles&);
+
+        unsigned int _capacity;
+        float* _data;
     };
 
+    // Updates the particles in the range [begin, end) without emitting or removing any.
+    void updateParticles(unsigned int begin, unsigned int end, float elapsedMs);
+
     unsigned int _particleCountMax;
     unsigned int _particleCount;
-    Particle* _particles;
+    Particles* _particles;
     unsigned int _emissionRate;
     bool _started;
     bool _ellipsoid;
@@ -819,7 +1010,6 @@ private:
     float _rotationSpeedMax;
     Vector3 _rotationAxis;
     Vector3 _rotationAxisVar;
-    Matrix _rotation;
     SpriteBatch* _spriteBatch;
     BlendMode _spriteBlendMode;
     float _spriteTextureWidth;
@@ -839,7 +1029,15 @@ private:
     bool _orbitAcceleration;
     float _timePerEmission;
     float _emitTime;
-    double _lastUpdated;
+    double _runningTime;
+    GpuSimulation* _gpuSimulation;
+    Material* _instancedMaterial;
+    Mesh* _instancedQuad;
+    std::vector<float> _instanceData;
+    VertexBufferHandle _instanceBuffer;
+    float _sleepInterval;
+    float _lodNearDistance;
+    float _lodFarDistance;
 };
 
 }
@@ -8,13 +8,14 @@ namespace gameplay
 {
 
 Pass::Pass(const char* id, Technique* technique) :
-    _id(id ? id : ""), _technique(technique), _effect(NULL), _vaBinding(NULL)
+    _id(id ? id : ""), _technique(technique), _effect(NULL), _vaBinding(NULL), _depthPass(NULL), _depthPassLoaded(false)
 {
     RenderState::_parent = _technique;
 }
 
 Pass::~Pass()
 {
+    SAFE_RELEASE(_depthPass);
     SAFE_RELEASE(_effect);
     SAFE_RELEASE(_vaBinding);
 }
@@ -24,11 +25,10 @@ bool Pass::initialize(const char* vshPath, const char* fshPath, const char* defi
     GP_ASSERT(vshPath);
     GP_ASSERT(fshPath);
 
-    SAFE_RELEASE(_effect);
-    SAFE_RELEASE(_vaBinding);
-
     // Attempt to create/load the effect.
-    _effect = Effect::createFromFile(vshPath, fshPath, defines);
+    Effect* effect = Effect::createFromFile(vshPath, fshPath, defines);
+    setEffect(effect);
+    SAFE_RELEASE(effect);
     if (_effect == NULL)
     {
         GP_WARN("Failed to create effect for pass. vertexShader = %s, fragmentShader = %s, defines = %s", vshPath, fshPath, defines ? defines : "");
@@ -38,6 +38,18 @@ bool Pass::initialize(const char* vshPath, const char* fshPath, const char* defi
     return true;
 }
 
+void Pass::setEffect(Effect* effect)
+{
+    SAFE_RELEASE(_effect);
+    SAFE_RELEASE(_vaBinding);
+    SAFE_RELEASE(_depthPass);
+    _depthPassLoaded = false;
+
+    _effect = effect;
+    if (_effect)
+        _effect->addRef();
+}
+
 const char* Pass::getId() const
 {
     return _id.c_str();
@@ -90,6 +102,37 @@ void Pass::unbind()
     }
 }
 
+Pass* Pass::getDepthPass()
+{
+    if (!isDepthPrePassCompatible())
+        return NULL;
+
+    if (!_depthPassLoaded)
+    {
+        _depthPassLoaded = true;
+        Effect* effect = _effect ? _effect->getDepthEffect() : NULL;
+        if (effect)
+        {
+            // The depth pass has no parameters or state of its own, and inherits those of this pass.
+            effect->addRef();
+            std::string id = _id + "_depth";
+            _depthPass = new Pass(id.c_str(), _technique);
+            _depthPass->_effect = effect;
+            _depthPass->_parent = this;
+            _depthPass->setNodeBinding(_nodeBinding);
+        }
+    }
+    return (_depthPass && _depthPass->_effect->isReady()) ? _depthPass : NULL;
+}
+
+void Pass::setNodeBinding(Node* node)
+{
+    RenderState::setNodeBinding(node);
+
+    if (_depthPass)
+        _depthPass->setNodeBinding(node);
+}
+
 Pass* Pass::clone(Technique* technique, NodeCloneContext &context) const
 {
     GP_ASSERT(_effect);
@@ -97,6 +140,7 @@ Pass* Pass::clone(Technique* technique, NodeCloneContext &context) const
 
     Pass* pass = new Pass(getId(), technique);
     pass->_effect = _effect;
+    pass->_callbackDefines = _callbackDefines;
 
     RenderState::cloneInto(pass, context);
     pass->_parent = technique;
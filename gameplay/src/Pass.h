@@ -22,6 +22,7 @@ class Pass : public RenderState
     friend class Technique;
     friend class Material;
     friend class RenderState;
+    friend class Model;
 
 public:
 
@@ -68,6 +69,24 @@ public:
      */
     void unbind();
 
+    /**
+     * Returns the pass that lays down the depth of this pass in a depth pre-pass.
+     *
+     * The depth pass draws with the depth variant of the effect of this pass, and inherits
+     * the parameters and render state of this pass. Passes that blend, do not test or write
+     * depth, or set a depth function other than DEPTH_LEQUAL have no depth pass.
+     *
+     * @return The depth pass, or NULL if this pass has none or its effect is still compiling.
+     * @see Effect::getDepthEffect
+     * @script{ignore}
+     */
+    Pass* getDepthPass();
+
+    /**
+     * @see RenderState::setNodeBinding
+     */
+    void setNodeBinding(Node* node);
+
 private:
 
     /**
@@ -90,6 +109,12 @@ private:
      */
     bool initialize(const char* vshPath, const char* fshPath, const char* defines);
 
+    /**
+     * Replaces the effect of this pass, along with the vertex attribute binding and the
+     * depth pass made for the previous effect.
+     */
+    void setEffect(Effect* effect);
+
     /**
      * Hidden copy assignment operator.
      */
@@ -109,6 +134,10 @@ private:
     Technique* _technique;
     Effect* _effect;
     VertexAttributeBinding* _vaBinding;
+    Pass* _depthPass;
+    bool _depthPassLoaded;
+    // The defines added by the pass callback of the material, which are kept for reloading it.
+    std::string _callbackDefines;
 };
 
 }
@@ -34,9 +34,9 @@ public:
     btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace)
     {
         PhysicsCollisionObject* object = reinterpret_cast<PhysicsCollisionObject*>(convexResult.m_hitCollisionObject->getUserPointer());
-        
-        GP_ASSERT(object);
-        if (object == _me || object->getType() == PhysicsCollisionObject::GHOST_OBJECT)
+
+        // Objects without a user pointer are static batches of the physics controller.
+        if (object == _me || (object && object->getType() == PhysicsCollisionObject::GHOST_OBJECT))
             return 1.0f;
 
         return ClosestConvexResultCallback::addSingleResult(convexResult, normalInWorldSpace);
@@ -52,28 +52,30 @@ protected:
 PhysicsCharacter::PhysicsCharacter(Node* node, const PhysicsCollisionShape::Definition& shape, float mass, int group, int mask)
     : PhysicsGhostObject(node, shape, group, mask), _moveVelocity(0,0,0), _forwardVelocity(0.0f), _rightVelocity(0.0f),
     _verticalVelocity(0, 0, 0), _currentVelocity(0,0,0), _normalizedVelocity(0,0,0),
-    _colliding(false), _collisionNormal(0,0,0), _currentPosition(0,0,0), _stepHeight(0.1f),
-    _slopeAngle(0.0f), _cosSlopeAngle(1.0f), _physicsEnabled(true), _mass(mass), _actionInterface(NULL)
+    _colliding(false), _collisionNormal(0,0,0), _currentPosition(0,0,0), _previousPosition(0,0,0), _renderPosition(0,0,0),
+    _lastStep(0), _interpolating(false), _stepHeight(0.1f),
+    _slopeAngle(0.0f), _cosSlopeAngle(1.0f), _physicsEnabled(true), _mass(mass), _acting(false), _startPosition(0, 0, 0)
 {
     setMaxSlopeAngle(45.0f);
 
     // Set the collision flags on the ghost object to indicate it's a character.
     GP_ASSERT(_ghostObject);
     _ghostObject->setCollisionFlags(_ghostObject->getCollisionFlags() | btCollisionObject::CF_CHARACTER_OBJECT | btCollisionObject::CF_NO_CONTACT_RESPONSE);
+    _renderPosition = _previousPosition = _ghostObject->getWorldTransform().getOrigin();
 
-    // Register ourselves as an action on the physics world so we are called back during physics ticks.
-    GP_ASSERT(Game::getInstance()->getPhysicsController() && Game::getInstance()->getPhysicsController()->_world);
-    _actionInterface = new ActionInterface(this);
-    Game::getInstance()->getPhysicsController()->_world->addAction(_actionInterface);
+    // Register ourselves with the controller so we are updated during physics ticks.
+    GP_ASSERT(Game::getInstance()->getPhysicsController());
+    Game::getInstance()->getPhysicsController()->_characters.push_back(this);
 }
 
 PhysicsCharacter::~PhysicsCharacter()
 {
-    // Unregister ourselves as action from world.
-    GP_ASSERT(Game::getInstance()->getPhysicsController() && Game::getInstance()->getPhysicsController()->_world);
-    Game::getInstance()->getPhysicsController()->_world->removeAction(_actionInterface);
-    SAFE_DELETE(_actionInterface);
-
+    // Unregister ourselves from the controller.
+    GP_ASSERT(Game::getInstance()->getPhysicsController());
+    std::vector<PhysicsCharacter*>& characters = Game::getInstance()->getPhysicsController()->_characters;
+    std::vector<PhysicsCharacter*>::iterator itr = std::find(characters.begin(), characters.end(), this);
+    if (itr != characters.end())
+        characters.erase(itr);
 }
 
 PhysicsCharacter* PhysicsCharacter::create(Node* node, Properties* properties)
@@ -330,8 +332,6 @@ void PhysicsCharacter::stepUp(btCollisionWorld* collisionWorld, btScalar time)
 
 void PhysicsCharacter::stepForwardAndStrafe(btCollisionWorld* collisionWorld, float time)
 {
-    updateCurrentVelocity();
-
     // Calculate final velocity
     btVector3 velocity(_currentVelocity);
     velocity *= time; // since velocity is in meters per second
@@ -391,13 +391,12 @@ void PhysicsCharacter::stepForwardAndStrafe(btCollisionWorld* collisionWorld, fl
         {
             Vector3 normal(callback.m_hitNormalWorld.x(), callback.m_hitNormalWorld.y(), callback.m_hitNormalWorld.z());
             PhysicsCollisionObject* o = Game::getInstance()->getPhysicsController()->getCollisionObject(callback.m_hitCollisionObject);
-            GP_ASSERT(o);
-            if (o->getType() == PhysicsCollisionObject::RIGID_BODY && o->isDynamic())
+            if (o && o->getType() == PhysicsCollisionObject::RIGID_BODY && o->isDynamic())
             {
                 PhysicsRigidBody* rb = static_cast<PhysicsRigidBody*>(o);
                 GP_ASSERT(rb);
                 normal.normalize();
-                rb->applyImpulse(_mass * -normal * velocity.length());
+                _impulses.push_back(std::make_pair(rb, _mass * -normal * velocity.length()));
             }
 
             updateTargetPositionFromCollision(targetPosition, callback.m_hitNormalWorld);
@@ -481,13 +480,12 @@ void PhysicsCharacter::stepDown(btCollisionWorld* collisionWorld, btScalar time)
             else
             {
                 PhysicsCollisionObject* o = Game::getInstance()->getPhysicsController()->getCollisionObject(callback.m_hitCollisionObject);
-                GP_ASSERT(o);
-                if (o->getType() == PhysicsCollisionObject::RIGID_BODY && o->isDynamic())
+                if (o && o->getType() == PhysicsCollisionObject::RIGID_BODY && o->isDynamic())
                 {
                     PhysicsRigidBody* rb = static_cast<PhysicsRigidBody*>(o);
                     GP_ASSERT(rb);
                     normal.normalize();
-                    rb->applyImpulse(_mass * -normal * sqrt(BV(normal).dot(_verticalVelocity)));
+                    _impulses.push_back(std::make_pair(rb, _mass * -normal * sqrt(BV(normal).dot(_verticalVelocity))));
                 }
 
                 updateTargetPositionFromCollision(targetPosition, BV(normal));
@@ -605,10 +603,10 @@ bool PhysicsCharacter::fixCollision(btCollisionWorld* world)
             // Get the direction of the contact points (used to scale normal vector in the correct direction).
             btScalar directionSign = manifold->getBody0() == _ghostObject ? -1.0f : 1.0f;
 
-            // Skip ghost objects.
+            // Skip ghost objects (objects without a gameplay object are static batches).
             PhysicsCollisionObject* object = Game::getInstance()->getPhysicsController()->getCollisionObject(
                 (btCollisionObject*)(manifold->getBody0() == _ghostObject ? manifold->getBody1() : manifold->getBody0()));
-            if (!object || object->getType() == PhysicsCollisionObject::GHOST_OBJECT)
+            if (object && object->getType() == PhysicsCollisionObject::GHOST_OBJECT)
                 continue;
 
             for (int p = 0, contactCount = manifold->getNumContacts(); p < contactCount; ++p)
@@ -644,23 +642,10 @@ bool PhysicsCharacter::fixCollision(btCollisionWorld* world)
     return collision;
 }
 
-PhysicsCharacter::ActionInterface::ActionInterface(PhysicsCharacter* character) : character(character)
-{
-}
-
-void PhysicsCharacter::ActionInterface::updateAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep)
-{
-    character->updateAction(collisionWorld, deltaTimeStep);
-}
-
-void PhysicsCharacter::ActionInterface::debugDraw(btIDebugDraw* debugDrawer)
-{
-    // Not used yet.
-}
-
-void PhysicsCharacter::updateAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep)
+void PhysicsCharacter::beginAction(btCollisionWorld* collisionWorld)
 {
-    if (!isEnabled())
+    _acting = isEnabled();
+    if (!_acting)
         return;
 
     GP_ASSERT(_ghostObject);
@@ -689,8 +674,17 @@ void PhysicsCharacter::updateAction(btCollisionWorld* collisionWorld, btScalar d
     }
 
     // Update current and target world positions.
-    btVector3 startPosition = _ghostObject->getWorldTransform().getOrigin();
-    _currentPosition = startPosition;
+    _startPosition = _ghostObject->getWorldTransform().getOrigin();
+    _currentPosition = _startPosition;
+
+    // The velocity depends on the world matrix of the node, which is computed lazily.
+    updateCurrentVelocity();
+}
+
+void PhysicsCharacter::stepAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep)
+{
+    if (!_acting)
+        return;
 
     // Process movement in the up direction.
     if (_physicsEnabled)
@@ -702,13 +696,69 @@ void PhysicsCharacter::updateAction(btCollisionWorld* collisionWorld, btScalar d
     // Process movement in the down direction.
     if (_physicsEnabled)
         stepDown(collisionWorld, deltaTimeStep);
+}
+
+void PhysicsCharacter::endAction()
+{
+    if (!_acting)
+        return;
+    _acting = false;
+
+    for (size_t i = 0; i < _impulses.size(); ++i)
+        _impulses[i].first->applyImpulse(_impulses[i].second);
+    _impulses.clear();
+
+    PhysicsController* controller = Game::getInstance()->getPhysicsController();
+    GP_ASSERT(controller);
+    if (controller->_interpolation)
+    {
+        // The ghost object holds the simulated position; the node is moved towards it when interpolating.
+        _ghostObject->getWorldTransform().setOrigin(_currentPosition);
+        _previousPosition = _startPosition;
+        _lastStep = controller->_stepCount + 1;
+        return;
+    }
 
     // Set new position.
-    btVector3 newPosition = _currentPosition - startPosition;
+    btVector3 newPosition = _currentPosition - _startPosition;
     Vector3 translation = Vector3(newPosition.x(), newPosition.y(), newPosition.z());
     if (translation !=  Vector3::zero())
         _node->translate(translation);
 }
 
+void PhysicsCharacter::interpolate(unsigned int stepCount, float alpha)
+{
+    GP_ASSERT(_ghostObject);
+    GP_ASSERT(_node);
+
+    const btVector3& position = _ghostObject->getWorldTransform().getOrigin();
+    btVector3 target = _lastStep == stepCount ? _previousPosition.lerp(position, alpha) : position;
+    btVector3 delta = target - _renderPosition;
+    if (delta.isZero())
+        return;
+
+    _interpolating = true;
+    _node->translate(delta.x(), delta.y(), delta.z());
+    _interpolating = false;
+    _renderPosition = target;
+}
+
+void PhysicsCharacter::transformChanged(Transform* transform, long cookie)
+{
+    if (_interpolating)
+        return;
+
+    // Keep the simulated movement that the node does not show yet when the node is moved by other code.
+    GP_ASSERT(_ghostObject);
+    GP_ASSERT(Game::getInstance()->getPhysicsController());
+    btVector3 pending = _ghostObject->getWorldTransform().getOrigin() - _renderPosition;
+    PhysicsGhostObject::transformChanged(transform, cookie);
+    btVector3 position = _ghostObject->getWorldTransform().getOrigin();
+    _previousPosition += position - _renderPosition;
+    _renderPosition = position;
+    if (Game::getInstance()->getPhysicsController()->_interpolation)
+        _ghostObject->getWorldTransform().setOrigin(position + pending);
+}
+
 
 }
@@ -8,6 +8,8 @@
 namespace gameplay
 {
 
+class PhysicsRigidBody;
+
 /**
  * Defines a physics controller class for a game character.
  *
@@ -24,6 +26,7 @@ namespace gameplay
 class PhysicsCharacter : public PhysicsGhostObject
 {
     friend class Node;
+    friend class PhysicsController;
 
 public:
 
@@ -195,6 +198,11 @@ protected:
      */
     btCollisionObject* getCollisionObject() const;
 
+    /**
+     * @see Transform::Listener::transformChanged
+     */
+    void transformChanged(Transform* transform, long cookie);
+
 private:
 
     /**
@@ -240,23 +248,37 @@ private:
     bool fixCollision(btCollisionWorld* world);
 
     /**
-     * Hides the callback interfaces within the PhysicsCharacter.
-     * @script{ignore}
+     * Moves the character out of penetrations and prepares its movement for a simulation step.
+     *
+     * This modifies the node, so it is called for one character at a time.
+     *
+     * @param collisionWorld The world being stepped.
      */
-    class ActionInterface : public btActionInterface
-    {
-    public:
+    void beginAction(btCollisionWorld* collisionWorld);
 
-        ActionInterface(PhysicsCharacter* character);
-
-        void updateAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep);
+    /**
+     * Sweeps the character through the world to find its position after a simulation step.
+     *
+     * This only queries the world, so it can be called for several characters in parallel.
+     * Impulses on the rigid bodies the character pushes are kept until endAction.
+     *
+     * @param collisionWorld The world being stepped.
+     * @param deltaTimeStep The duration of the step, in seconds.
+     */
+    void stepAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep);
 
-        void debugDraw(btIDebugDraw* debugDrawer);
-        
-        PhysicsCharacter* character;
-    };
+    /**
+     * Moves the node to the position found by stepAction and applies the pending impulses.
+     */
+    void endAction();
 
-    void updateAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep);
+    /**
+     * Places the node between the positions of the last two simulation steps.
+     *
+     * @param stepCount The number of simulation steps performed so far.
+     * @param alpha The fraction of a step that has elapsed since the last step.
+     */
+    void interpolate(unsigned int stepCount, float alpha);
 
     btVector3 _moveVelocity;
     float _forwardVelocity;
@@ -267,13 +289,20 @@ private:
     bool _colliding;
     btVector3 _collisionNormal;
     btVector3 _currentPosition;
+    btVector3 _previousPosition;
+    btVector3 _renderPosition;
+    unsigned int _lastStep;
+    bool _interpolating;
     btManifoldArray _manifoldArray;
     float _stepHeight;
     float _slopeAngle;
     float _cosSlopeAngle;
     bool _physicsEnabled;
     float _mass;
-    ActionInterface* _actionInterface;
+    // True between beginAction and endAction if the character takes part in the step.
+    bool _acting;
+    btVector3 _startPosition;
+    std::vector<std::pair<PhysicsRigidBody*, Vector3> > _impulses;
 };
 
 }
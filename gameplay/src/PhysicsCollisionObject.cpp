@@ -210,8 +210,13 @@ bool PhysicsCollisionObject::CollisionPair::operator < (const CollisionPair& col
     return false;
 }
 
+bool PhysicsCollisionObject::CollisionPair::operator == (const CollisionPair& collisionPair) const
+{
+    return (objectA == collisionPair.objectA && objectB == collisionPair.objectB) || (objectA == collisionPair.objectB && objectB == collisionPair.objectA);
+}
+
 PhysicsCollisionObject::PhysicsMotionState::PhysicsMotionState(Node* node, PhysicsCollisionObject* collisionObject, const Vector3* centerOfMassOffset) :
-    _node(node), _collisionObject(collisionObject), _centerOfMassOffset(btTransform::getIdentity())
+    _node(node), _collisionObject(collisionObject), _centerOfMassOffset(btTransform::getIdentity()), _lastStep(0), _interpolated(false)
 {
     if (centerOfMassOffset)
     {
@@ -241,10 +246,46 @@ void PhysicsCollisionObject::PhysicsMotionState::setWorldTransform(const btTrans
 {
     GP_ASSERT(_node);
 
+    _previousTransform = _worldTransform;
     _worldTransform = transform * _centerOfMassOffset;
-        
-    const btQuaternion& rot = _worldTransform.getRotation();
-    const btVector3& pos = _worldTransform.getOrigin();
+
+    PhysicsController* controller = Game::getInstance()->getPhysicsController();
+    GP_ASSERT(controller);
+    if (controller->_interpolation && controller->_isUpdating)
+    {
+        // The node is placed once all steps of the update are done.
+        _lastStep = controller->_stepCount + 1;
+        return;
+    }
+
+    setNodeTransform(_worldTransform);
+}
+
+void PhysicsCollisionObject::PhysicsMotionState::interpolate(unsigned int stepCount, float alpha)
+{
+    if (_lastStep != stepCount)
+    {
+        // The object did not move during the last step, so it rests at its last simulated transform.
+        if (_interpolated)
+        {
+            setNodeTransform(_worldTransform);
+            _interpolated = false;
+        }
+        return;
+    }
+
+    btTransform transform(_previousTransform.getRotation().slerp(_worldTransform.getRotation(), alpha),
+                          _previousTransform.getOrigin().lerp(_worldTransform.getOrigin(), alpha));
+    setNodeTransform(transform);
+    _interpolated = true;
+}
+
+void PhysicsCollisionObject::PhysicsMotionState::setNodeTransform(const btTransform& transform)
+{
+    GP_ASSERT(_node);
+
+    const btQuaternion& rot = transform.getRotation();
+    const btVector3& pos = transform.getOrigin();
 
     _node->setRotation(rot.x(), rot.y(), rot.z(), rot.w());
     _node->setTranslation(pos.x(), pos.y(), pos.z());
@@ -274,6 +315,7 @@ void PhysicsCollisionObject::PhysicsMotionState::updateTransformFromNode() const
     {
         _worldTransform = btTransform(BQ(rotation), btVector3(m.m[12], m.m[13], m.m[14]));
     }
+    _previousTransform = _worldTransform;
 }
 
 void PhysicsCollisionObject::PhysicsMotionState::setCenterOfMassOffset(const Vector3& centerOfMassOffset)
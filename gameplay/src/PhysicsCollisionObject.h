@@ -88,6 +88,16 @@ public:
          */
         bool operator < (const CollisionPair& collisionPair) const;
 
+        /**
+         * Equality operator (needed for use as a key in a hashed map).
+         *
+         * Pairs are equal if they contain the same objects, in either order.
+         *
+         * @param collisionPair The collision pair to compare.
+         * @return True if the pairs are equal; false otherwise.
+         */
+        bool operator == (const CollisionPair& collisionPair) const;
+
         /**
          * The first object in the collision.
          */
@@ -385,13 +395,26 @@ private:
          * Sets the center of mass offset for the associated collision shape.
          */
         void setCenterOfMassOffset(const Vector3& centerOfMassOffset);
+
+        /**
+         * Places the node between the transforms of the last two simulation steps.
+         *
+         * @param stepCount The number of simulation steps performed so far.
+         * @param alpha The fraction of a step that has elapsed since the last step.
+         */
+        void interpolate(unsigned int stepCount, float alpha);
         
     private:
         
+        void setNodeTransform(const btTransform& transform);
+
         Node* _node;
         PhysicsCollisionObject* _collisionObject;
         btTransform _centerOfMassOffset;
         mutable btTransform _worldTransform;
+        mutable btTransform _previousTransform;
+        unsigned int _lastStep;
+        bool _interpolated;
     };
 
     /** 
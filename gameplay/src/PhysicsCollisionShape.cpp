@@ -31,6 +31,8 @@ PhysicsCollisionShape::~PhysicsCollisionShape()
                 {
                     SAFE_DELETE_ARRAY(_shapeData.meshData->indexData[i]);
                 }
+                if (_shapeData.meshData->bvhData)
+                    btAlignedFree(_shapeData.meshData->bvhData);
                 SAFE_DELETE(_shapeData.meshData);
             }
 
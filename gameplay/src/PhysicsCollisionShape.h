@@ -241,6 +241,12 @@ private:
     {
         float* vertexData;
         std::vector<unsigned char*> indexData;
+        // Hash of the mesh url, scale and dynamic flag the shape was created from.
+        unsigned long long sourceHash;
+        // Hash of the scaled vertices and indices of the shape.
+        unsigned long long contentHash;
+        // Buffer of the BVH of static shapes that were loaded from the shape cache (NULL otherwise).
+        void* bvhData;
     };
 
     struct HeightfieldData
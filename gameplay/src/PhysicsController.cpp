@@ -6,12 +6,21 @@
 #include "MeshPart.h"
 #include "Bundle.h"
 #include "Terrain.h"
+#include "Scene.h"
+#include "Camera.h"
+#include "FileSystem.h"
+#include "MemoryTracker.h"
 
 #ifdef GP_USE_MEM_LEAK_DETECTION
 #undef new
 #endif
 #include "BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h"
 #include "BulletCollision/CollisionShapes/btShapeHull.h"
+#if BT_THREADSAFE
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#include "BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#endif
 #ifdef GP_USE_MEM_LEAK_DETECTION
 #define new DEBUG_NEW
 #endif
@@ -19,19 +28,122 @@
 // The initial capacity of the Bullet debug drawer's vertex batch.
 #define INITIAL_CAPACITY 280
 
+// The number of queries of a batched ray or sweep test that are run by a single job.
+#define QUERY_BATCH_SIZE 16
+
+// The number of characters whose movement is swept by a single job.
+#define CHARACTER_BATCH_SIZE 4
+
 namespace gameplay
 {
 
-const int PhysicsController::DIRTY         = 0x01;
+#if BT_THREADSAFE
+/**
+ * Runs the parallel loops of Bullet on the workers of the job controller.
+ */
+class JobTaskScheduler : public btITaskScheduler
+{
+public:
+
+    JobTaskScheduler(JobController* jobController)
+        : btITaskScheduler("JobController"), _jobController(jobController)
+    {
+    }
+
+    int getMaxNumThreads() const
+    {
+        return (int)_jobController->getWorkerCount();
+    }
+
+    int getNumThreads() const
+    {
+        return (int)_jobController->getWorkerCount();
+    }
+
+    void setNumThreads(int numThreads)
+    {
+        // The workers are owned by the job controller.
+    }
+
+    void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body)
+    {
+        _jobController->parallelFor((unsigned int)(iEnd - iBegin), [&](unsigned int begin, unsigned int end, unsigned int worker)
+        {
+            body.forLoop(iBegin + (int)begin, iBegin + (int)end);
+        }, (unsigned int)grainSize);
+    }
+
+    btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body)
+    {
+        // Every worker only adds to its own sum.
+        std::vector<btScalar> sums(_jobController->getWorkerCount(), btScalar(0));
+        _jobController->parallelFor((unsigned int)(iEnd - iBegin), [&](unsigned int begin, unsigned int end, unsigned int worker)
+        {
+            sums[worker] += body.sumLoop(iBegin + (int)begin, iBegin + (int)end);
+        }, (unsigned int)grainSize);
+
+        btScalar sum = btScalar(0);
+        for (size_t i = 0, count = sums.size(); i < count; ++i)
+            sum += sums[i];
+        return sum;
+    }
+
+private:
+
+    JobController* _jobController;
+};
+
+static JobTaskScheduler* __taskScheduler = NULL;
+static unsigned int __taskSchedulerUsers = 0;
+static std::mutex __taskSchedulerMutex;
+#endif
+
+/**
+ * Allocates the memory of Bullet, which is tracked as physics memory.
+ */
+static void* allocatePhysicsMemory(size_t size, int alignment)
+{
+    // The unaligned block and the size are stored right in front of the aligned block,
+    // so that the size can be tracked when the block is freed.
+    size_t offset = 2 * sizeof(size_t) + alignment - 1;
+    unsigned char* block = (unsigned char*)malloc(size + offset);
+    if (block == NULL)
+        return NULL;
+
+    size_t* aligned = (size_t*)(((size_t)block + offset) & ~(size_t)(alignment - 1));
+    aligned[-2] = (size_t)block;
+    aligned[-1] = size;
+    MemoryTracker::add(MemoryTracker::PHYSICS, size);
+    return aligned;
+}
+
+/**
+ * Frees memory allocated with allocatePhysicsMemory.
+ */
+static void freePhysicsMemory(void* memory)
+{
+    if (memory == NULL)
+        return;
+
+    size_t* aligned = (size_t*)memory;
+    MemoryTracker::remove(MemoryTracker::PHYSICS, aligned[-1]);
+    free((void*)aligned[-2]);
+}
+
 const int PhysicsController::COLLISION     = 0x02;
 const int PhysicsController::REGISTERED    = 0x04;
 const int PhysicsController::REMOVE        = 0x08;
+const int PhysicsController::STATIC_BATCH  = 0x42415443;
 
 PhysicsController::PhysicsController()
   : _isUpdating(false), _collisionConfiguration(NULL), _dispatcher(NULL),
-    _overlappingPairCache(NULL), _solver(NULL), _world(NULL), _ghostPairCallback(NULL),
-    _debugDrawer(NULL), _status(PhysicsController::Listener::DEACTIVATED), _listeners(NULL),
-    _gravity(btScalar(0.0), btScalar(-9.8), btScalar(0.0)), _collisionCallback(NULL)
+    _overlappingPairCache(NULL), _axisSweepBroadphase(false), _solver(NULL), _solverPool(NULL), _taskScheduler(NULL), _world(NULL), _ghostPairCallback(NULL),
+    _shapeCache(false), _characterAction(NULL), _debugDrawer(NULL), _status(PhysicsController::Listener::DEACTIVATED), _listeners(NULL),
+    _gravity(btScalar(0.0), btScalar(-9.8), btScalar(0.0)), _fixedTimeStep(1000.0f / 60.0f), _maxSubSteps(10),
+    _stepTimeBudget(0.0f), _timeAccumulator(0.0f), _interpolation(false), _interpolationAlpha(0.0f), _stepCount(0),
+    _collisionGeneration(0), _collisionRemovals(false), _linearSleepingThreshold(0.8f), _angularSleepingThreshold(1.0f),
+    _freezeDistance(0.0f), _activeBodyCount(0), _sleepingBodyCount(0), _frozenBodyCount(0), _islandCount(0),
+    _largestIslandSize(0), _collisionCallback(NULL)
 {
     GP_REGISTER_SCRIPT_EVENTS();
 
@@ -160,13 +272,166 @@ void PhysicsController::setGravity(const Vector3& gravity)
         _world->setGravity(BV(_gravity));
 }
 
+bool PhysicsController::isMultithreaded() const
+{
+    return _taskScheduler != NULL;
+}
+
+float PhysicsController::getTickRate() const
+{
+    return 1000.0f / _fixedTimeStep;
+}
+
+void PhysicsController::setTickRate(float ticksPerSecond)
+{
+    GP_ASSERT(ticksPerSecond > 0.0f);
+    _fixedTimeStep = 1000.0f / ticksPerSecond;
+}
+
+unsigned int PhysicsController::getMaxSubSteps() const
+{
+    return _maxSubSteps;
+}
+
+void PhysicsController::setMaxSubSteps(unsigned int maxSubSteps)
+{
+    GP_ASSERT(maxSubSteps > 0);
+    _maxSubSteps = maxSubSteps;
+}
+
+float PhysicsController::getStepTimeBudget() const
+{
+    return _stepTimeBudget;
+}
+
+void PhysicsController::setStepTimeBudget(float budget)
+{
+    _stepTimeBudget = budget > 0.0f ? budget : 0.0f;
+}
+
+bool PhysicsController::isInterpolationEnabled() const
+{
+    return _interpolation;
+}
+
+void PhysicsController::setInterpolationEnabled(bool enabled)
+{
+    _interpolation = enabled;
+}
+
+float PhysicsController::getInterpolationAlpha() const
+{
+    return _interpolationAlpha;
+}
+
+void PhysicsController::setSleepingThresholds(float linear, float angular)
+{
+    GP_ASSERT(_world);
+
+    _linearSleepingThreshold = linear;
+    _angularSleepingThreshold = angular;
+    for (int i = 0; i < _world->getNumCollisionObjects(); i++)
+    {
+        btRigidBody* body = btRigidBody::upcast(_world->getCollisionObjectArray()[i]);
+        if (body)
+            body->setSleepingThresholds(linear, angular);
+    }
+}
+
+float PhysicsController::getLinearSleepingThreshold() const
+{
+    return _linearSleepingThreshold;
+}
+
+float PhysicsController::getAngularSleepingThreshold() const
+{
+    return _angularSleepingThreshold;
+}
+
+void PhysicsController::setDeactivationTime(float time)
+{
+    // Bullet only supports a single deactivation time for all worlds, in seconds.
+    gDeactivationTime = time * 0.001f;
+}
+
+float PhysicsController::getDeactivationTime() const
+{
+    return gDeactivationTime * 1000.0f;
+}
+
+void PhysicsController::setFreezeDistance(float distance)
+{
+    _freezeDistance = distance > 0.0f ? distance : 0.0f;
+}
+
+float PhysicsController::getFreezeDistance() const
+{
+    return _freezeDistance;
+}
+
+unsigned int PhysicsController::getActiveBodyCount() const
+{
+    return _activeBodyCount;
+}
+
+unsigned int PhysicsController::getSleepingBodyCount() const
+{
+    return _sleepingBodyCount;
+}
+
+unsigned int PhysicsController::getFrozenBodyCount() const
+{
+    return _frozenBodyCount;
+}
+
+unsigned int PhysicsController::getIslandCount() const
+{
+    return _islandCount;
+}
+
+unsigned int PhysicsController::getLargestIslandSize() const
+{
+    return _largestIslandSize;
+}
+
+unsigned int PhysicsController::getBroadphaseProxyCount() const
+{
+    GP_ASSERT(_overlappingPairCache);
+
+    if (_axisSweepBroadphase)
+    {
+        // Both axis sweep versions share their interface but not a base class.
+        const btAxisSweep3* sweep = dynamic_cast<const btAxisSweep3*>(_overlappingPairCache);
+        if (sweep)
+            return sweep->getNumHandles();
+        const bt32BitAxisSweep3* sweep32 = static_cast<const bt32BitAxisSweep3*>(_overlappingPairCache);
+        return sweep32->getNumHandles();
+    }
+
+    const btDbvtBroadphase* dbvt = static_cast<const btDbvtBroadphase*>(_overlappingPairCache);
+    return (unsigned int)(dbvt->m_sets[0].m_leaves + dbvt->m_sets[1].m_leaves);
+}
+
+unsigned int PhysicsController::getBroadphasePairCount() const
+{
+    GP_ASSERT(_overlappingPairCache);
+    return (unsigned int)_overlappingPairCache->getOverlappingPairCache()->getNumOverlappingPairs();
+}
+
 void PhysicsController::drawDebug(const Matrix& viewProjection)
 {
-    GP_ASSERT(_debugDrawer);
     GP_ASSERT(_world);
 
+    // The debug drawer compiles its shader the first time it is needed, so that the
+    // controller can be initialized without the graphics context.
+    if (!_debugDrawer)
+    {
+        _debugDrawer = new DebugDrawer();
+        _world->setDebugDrawer(_debugDrawer);
+    }
+
     _debugDrawer->begin(viewProjection);
-    _world->debugDrawWorld();
+    _debugDrawer->drawWorld(_world, viewProjection);
     _debugDrawer->end();
 }
 
@@ -194,7 +459,7 @@ bool PhysicsController::rayTest(const Ray& ray, float distance, PhysicsControlle
             btCollisionObject* co = reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
             PhysicsCollisionObject* object = reinterpret_cast<PhysicsCollisionObject*>(co->getUserPointer());
             if (object == NULL)
-                return false;
+                return co->getUserIndex() == STATIC_BATCH; // filtered once the batched object is known
 
             return filter ? !filter->filter(object) : true;
         }
@@ -203,6 +468,14 @@ bool PhysicsController::rayTest(const Ray& ray, float distance, PhysicsControlle
         {
             GP_ASSERT(rayResult.m_collisionObject);
             PhysicsCollisionObject* object = reinterpret_cast<PhysicsCollisionObject*>(rayResult.m_collisionObject->getUserPointer());
+            if (object == NULL)
+            {
+                btVector3 point;
+                point.setInterpolate3(m_rayFromWorld, m_rayToWorld, rayResult.m_hitFraction);
+                object = Game::getInstance()->getPhysicsController()->getBatchedObject(rayResult.m_collisionObject, point);
+                if (object && filter && filter->filter(object))
+                    return 1.0f;
+            }
 
             if (object == NULL)
                 return 1.0f; // ignore
@@ -232,7 +505,7 @@ bool PhysicsController::rayTest(const Ray& ray, float distance, PhysicsControlle
     {
         if (result)
         {
-            result->object = getCollisionObject(callback.m_collisionObject);
+            result->object = callback.hitResult.object;
             result->point.set(callback.m_hitPointWorld.x(), callback.m_hitPointWorld.y(), callback.m_hitPointWorld.z());
             result->fraction = callback.m_closestHitFraction;
             result->normal.set(callback.m_hitNormalWorld.x(), callback.m_hitNormalWorld.y(), callback.m_hitNormalWorld.z());
@@ -268,7 +541,9 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
 
             btCollisionObject* co = reinterpret_cast<btCollisionObject*>(proxy0->m_clientObject);
             PhysicsCollisionObject* object = reinterpret_cast<PhysicsCollisionObject*>(co->getUserPointer());
-            if (object == NULL || object == me)
+            if (object == NULL)
+                return co->getUserIndex() == STATIC_BATCH; // filtered once the batched object is known
+            if (object == me)
                 return false;
 
             return filter ? !filter->filter(object) : true;
@@ -278,6 +553,13 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
         {
             GP_ASSERT(convexResult.m_hitCollisionObject);
             PhysicsCollisionObject* object = reinterpret_cast<PhysicsCollisionObject*>(convexResult.m_hitCollisionObject->getUserPointer());
+            if (object == NULL)
+            {
+                // The hit point of convex results is in world space.
+                object = Game::getInstance()->getPhysicsController()->getBatchedObject(convexResult.m_hitCollisionObject, convexResult.m_hitPointLocal);
+                if (object && filter && filter->filter(object))
+                    return 1.0f;
+            }
 
             if (object == NULL)
                 return 1.0f;
@@ -348,7 +630,7 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
     {
         if (result)
         {
-            result->object = getCollisionObject(callback.m_hitCollisionObject);
+            result->object = callback.hitResult.object;
             result->point.set(callback.m_hitPointWorld.x(), callback.m_hitPointWorld.y(), callback.m_hitPointWorld.z());
             result->fraction = callback.m_closestHitFraction;
             result->normal.set(callback.m_hitNormalWorld.x(), callback.m_hitNormalWorld.y(), callback.m_hitNormalWorld.z());
@@ -360,6 +642,51 @@ bool PhysicsController::sweepTest(PhysicsCollisionObject* object, const Vector3&
     return false;
 }
 
+void PhysicsController::CharacterAction::updateAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep)
+{
+    GP_ASSERT(_pc);
+
+    std::vector<PhysicsCharacter*>& characters = _pc->_characters;
+    if (characters.empty())
+        return;
+
+    // Resolving penetrations dispatches the overlapping pairs of the ghost objects and moves
+    // the nodes, so it is done for one character at a time.
+    for (size_t i = 0; i < characters.size(); ++i)
+        characters[i]->beginAction(collisionWorld);
+
+    // The movement sweeps only query the cached overlapping pairs of each
+    // ghost object, so the characters can be swept in parallel.
+    struct Stage
+    {
+        PhysicsCharacter** characters;
+        btCollisionWorld* world;
+        btScalar timeStep;
+    } stage;
+    stage.characters = &characters[0];
+    stage.world = collisionWorld;
+    stage.timeStep = deltaTimeStep;
+
+    // Only a single pointer is captured so that the function does not allocate.
+    Stage* s = &stage;
+    std::function<void(unsigned int, unsigned int, unsigned int)> sweep = [s](unsigned int begin, unsigned int end, unsigned int worker)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+            s->characters[i]->stepAction(s->world, s->timeStep);
+    };
+
+    // Bullet can only query the world from several threads when it is built thread safe.
+    unsigned int count = (unsigned int)characters.size();
+    if (_pc->_taskScheduler && count > CHARACTER_BATCH_SIZE)
+        Game::getInstance()->getJobController()->parallelFor(count, sweep, CHARACTER_BATCH_SIZE);
+    else
+        sweep(0, count, 0);
+
+    // Impulses and node movement are applied in order once every character is swept.
+    for (size_t i = 0; i < characters.size(); ++i)
+        characters[i]->endAction();
+}
+
 btScalar PhysicsController::CollisionCallback::addSingleResult(btManifoldPoint& cp, const btCollisionObjectWrapper* a, int partIdA, int indexA, 
     const btCollisionObjectWrapper* b, int partIdB, int indexB)
 {
@@ -368,6 +695,12 @@ btScalar PhysicsController::CollisionCallback::addSingleResult(btManifoldPoint&
     // Get pointers to the PhysicsCollisionObject objects.
     PhysicsCollisionObject* objectA = _pc->getCollisionObject(a->m_collisionObject);
     PhysicsCollisionObject* objectB = _pc->getCollisionObject(b->m_collisionObject);
+    if (objectA == NULL)
+        objectA = _pc->getBatchedObject(a->m_collisionObject, cp.getPositionWorldOnA());
+    if (objectB == NULL)
+        objectB = _pc->getBatchedObject(b->m_collisionObject, cp.getPositionWorldOnB());
+    if (objectA == NULL || objectB == NULL)
+        return 0.0f;
 
     // If the given collision object pair has collided in the past, then
     // we notify the listeners only if the pair was not colliding
@@ -375,73 +708,133 @@ btScalar PhysicsController::CollisionCallback::addSingleResult(btManifoldPoint&
     // new entry to the cache with the appropriate listeners and notify them.
     PhysicsCollisionObject::CollisionPair pair(objectA, objectB);
 
-    CollisionInfo* collisionInfo;
-    if (_pc->_collisionStatus.count(pair) > 0)
-    {
-        collisionInfo = &_pc->_collisionStatus[pair];
-    }
-    else
+    int index = _pc->findCollisionInfo(pair);
+    if (index < 0)
     {
-        // Add a new collision pair for these objects.
-        collisionInfo = &_pc->_collisionStatus[pair];
-
-        // Add the appropriate listeners.
-        PhysicsCollisionObject::CollisionPair p1(pair.objectA, NULL);
-        if (_pc->_collisionStatus.count(p1) > 0)
+        // Gather the listeners that were registered for all collisions of either object.
+        std::vector<PhysicsCollisionObject::CollisionListener*> listeners;
+        int indexA = _pc->findCollisionInfo(PhysicsCollisionObject::CollisionPair(pair.objectA, NULL));
+        if (indexA >= 0)
         {
-            const CollisionInfo& ci = _pc->_collisionStatus[p1];
-            std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = ci._listeners.begin();
-            for (; iter != ci._listeners.end(); iter++)
-            {
-                GP_ASSERT(*iter);
-                collisionInfo->_listeners.push_back(*iter);
-            }
+            const CollisionInfo& ci = _pc->_collisionStatus[indexA];
+            listeners.insert(listeners.end(), ci._listeners.begin(), ci._listeners.end());
         }
-        PhysicsCollisionObject::CollisionPair p2(pair.objectB, NULL);
-        if (_pc->_collisionStatus.count(p2) > 0)
+        int indexB = _pc->findCollisionInfo(PhysicsCollisionObject::CollisionPair(pair.objectB, NULL));
+        if (indexB >= 0)
         {
-            const CollisionInfo& ci = _pc->_collisionStatus[p2];
-            std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = ci._listeners.begin();
-            for (; iter != ci._listeners.end(); iter++)
-            {
-                GP_ASSERT(*iter);
-                collisionInfo->_listeners.push_back(*iter);
-            }
+            const CollisionInfo& ci = _pc->_collisionStatus[indexB];
+            listeners.insert(listeners.end(), ci._listeners.begin(), ci._listeners.end());
         }
+
+        // Pairs that nobody listens to are not tracked.
+        if (listeners.empty())
+            return 0.0f;
+
+        // Add a new collision pair for these objects.
+        index = (int)_pc->getCollisionInfo(pair);
+        _pc->_collisionStatus[index]._listeners.swap(listeners);
     }
 
-    // Fire collision event.
-    if ((collisionInfo->_status & COLLISION) == 0)
+    // Only the first contact of the pair in an update is processed.
+    if (_pc->_collisionStatus[index]._generation == _pc->_collisionGeneration)
+        return 0.0f;
+    _pc->_collisionStatus[index]._generation = _pc->_collisionGeneration;
+
+    // Fire collision event. Entries are looked up by index on every iteration, since
+    // listeners can add collision listeners (and so entries) from within the event.
+    if ((_pc->_collisionStatus[index]._status & (COLLISION | REMOVE)) == 0)
     {
-        std::vector<PhysicsCollisionObject::CollisionListener*>::const_iterator iter = collisionInfo->_listeners.begin();
-        for (; iter != collisionInfo->_listeners.end(); iter++)
+        Vector3 pointA(cp.getPositionWorldOnA().x(), cp.getPositionWorldOnA().y(), cp.getPositionWorldOnA().z());
+        Vector3 pointB(cp.getPositionWorldOnB().x(), cp.getPositionWorldOnB().y(), cp.getPositionWorldOnB().z());
+        for (size_t i = 0; i < _pc->_collisionStatus[index]._listeners.size(); i++)
         {
-            GP_ASSERT(*iter);
-            if ((collisionInfo->_status & REMOVE) == 0)
-            {
-                (*iter)->collisionEvent(PhysicsCollisionObject::CollisionListener::COLLIDING, pair, Vector3(cp.getPositionWorldOnA().x(), cp.getPositionWorldOnA().y(), cp.getPositionWorldOnA().z()),
-                    Vector3(cp.getPositionWorldOnB().x(), cp.getPositionWorldOnB().y(), cp.getPositionWorldOnB().z()));
-            }
+            PhysicsCollisionObject::CollisionListener* listener = _pc->_collisionStatus[index]._listeners[i];
+            GP_ASSERT(listener);
+            listener->collisionEvent(PhysicsCollisionObject::CollisionListener::COLLIDING, pair, pointA, pointB);
         }
     }
 
-    // Update the collision status cache (we remove the dirty bit
-    // set in the controller's update so that this particular collision pair's
-    // status is not reset to 'no collision' when the controller's update completes).
-    collisionInfo->_status &= ~DIRTY;
-    collisionInfo->_status |= COLLISION;
+    // Update the collision status cache (the generation of this pair is now
+    // current, so its status is not reset to 'no collision' when the controller's
+    // update completes).
+    _pc->_collisionStatus[index]._status |= COLLISION;
     return 0.0f;
 }
 
 void PhysicsController::initialize()
 {
+    // Bullet uses a single allocator for everything, which must be replaced before its first allocation.
+    static std::once_flag allocatorFlag;
+    std::call_once(allocatorFlag, []()
+    {
+        btAlignedAllocSetCustomAligned(&allocatePhysicsMemory, &freePhysicsMemory);
+    });
+
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("physics", true);
+
     _collisionConfiguration = bullet_new<btDefaultCollisionConfiguration>();
-    _dispatcher = bullet_new<btCollisionDispatcher>(_collisionConfiguration);
-    _overlappingPairCache = bullet_new<btDbvtBroadphase>();
-    _solver = bullet_new<btSequentialImpulseConstraintSolver>();
+    if (config && config->exists("broadphase") && strcmp(config->getString("broadphase"), "axisSweep") == 0)
+    {
+        Vector3 worldMin, worldMax;
+        if (config->getVector3("worldMin", &worldMin) && config->getVector3("worldMax", &worldMax) &&
+            worldMin.x < worldMax.x && worldMin.y < worldMax.y && worldMin.z < worldMax.z)
+        {
+            // The 16-bit version quantizes bounds more coarsely but only supports up to 32766 objects.
+            int maxProxies = config->exists("maxProxies") ? config->getInt("maxProxies") : 16384;
+            if (maxProxies <= 0)
+                maxProxies = 16384;
+            if (maxProxies < 32767)
+                _overlappingPairCache = bullet_new<btAxisSweep3>(BV(worldMin), BV(worldMax), (unsigned short)maxProxies);
+            else
+                _overlappingPairCache = bullet_new<bt32BitAxisSweep3>(BV(worldMin), BV(worldMax), (unsigned int)maxProxies);
+            _axisSweepBroadphase = true;
+        }
+        else
+        {
+            GP_WARN("The axis sweep broadphase requires valid 'worldMin' and 'worldMax' bounds; using a dynamic tree broadphase.");
+        }
+    }
+    else if (config && config->exists("broadphase") && strcmp(config->getString("broadphase"), "dbvt") != 0)
+    {
+        GP_WARN("Unsupported broadphase '%s'; using a dynamic tree broadphase.", config->getString("broadphase"));
+    }
+    if (!_overlappingPairCache)
+        _overlappingPairCache = bullet_new<btDbvtBroadphase>();
+
+    if (config && config->getBool("multithreaded"))
+    {
+#if BT_THREADSAFE
+        JobController* jobController = Game::getInstance()->getJobController();
+        GP_ASSERT(jobController);
+
+        // Bullet uses a single global task scheduler for the parallel loops of its worlds, which
+        // is shared by the physics controllers of the game and of every World.
+        std::lock_guard<std::mutex> lock(__taskSchedulerMutex);
+        if (__taskSchedulerUsers++ == 0)
+        {
+            __taskScheduler = new JobTaskScheduler(jobController);
+            btSetTaskScheduler(__taskScheduler);
+        }
+        _taskScheduler = __taskScheduler;
+
+        // Islands are solved by a pool of solvers in parallel and large islands by the parallel solver.
+        _dispatcher = bullet_new<btCollisionDispatcherMt>(_collisionConfiguration);
+        _solverPool = bullet_new<btConstraintSolverPoolMt>((int)jobController->getWorkerCount());
+        _solver = bullet_new<btSequentialImpulseConstraintSolverMt>();
+        _world = bullet_new<btDiscreteDynamicsWorldMt>(_dispatcher, _overlappingPairCache, static_cast<btConstraintSolverPoolMt*>(_solverPool), _solver, _collisionConfiguration);
+#else
+        GP_WARN("Bullet was built without BT_THREADSAFE; using a single threaded physics world.");
+#endif
+    }
 
-    // Create the world.
-    _world = bullet_new<btDiscreteDynamicsWorld>(_dispatcher, _overlappingPairCache, _solver, _collisionConfiguration);
+    if (!_world)
+    {
+        _dispatcher = bullet_new<btCollisionDispatcher>(_collisionConfiguration);
+        _solver = bullet_new<btSequentialImpulseConstraintSolver>();
+
+        // Create the world.
+        _world = bullet_new<btDiscreteDynamicsWorld>(_dispatcher, _overlappingPairCache, _solver, _collisionConfiguration);
+    }
     _world->setGravity(BV(_gravity));
 
     // Register ghost pair callback so bullet detects collisions with ghost objects (used for character collisions).
@@ -450,20 +843,67 @@ void PhysicsController::initialize()
     _world->getPairCache()->setInternalGhostPairCallback(_ghostPairCallback);
     _world->getDispatchInfo().m_allowedCcdPenetration = 0.0001f;
 
-    // Set up debug drawing.
-    _debugDrawer = new DebugDrawer();
-    _world->setDebugDrawer(_debugDrawer);
+    // All of the characters are updated by a single action, so that their sweeps can run in parallel.
+    _characterAction = new CharacterAction(this);
+    _world->addAction(_characterAction);
+
+    if (config)
+    {
+        if (config->exists("tickRate") && config->getFloat("tickRate") > 0.0f)
+            setTickRate(config->getFloat("tickRate"));
+        if (config->exists("maxSubSteps") && config->getInt("maxSubSteps") > 0)
+            setMaxSubSteps((unsigned int)config->getInt("maxSubSteps"));
+        if (config->exists("stepBudget"))
+            setStepTimeBudget(config->getFloat("stepBudget"));
+        if (config->exists("interpolation"))
+            setInterpolationEnabled(config->getBool("interpolation"));
+
+        _shapeCache = config->getBool("shapeCache");
+        const char* shapeCachePath = config->getString("shapeCachePath");
+        _shapeCachePath = shapeCachePath ? shapeCachePath : "";
+        if (_shapeCachePath.length() > 0 && _shapeCachePath[_shapeCachePath.length() - 1] != '/')
+            _shapeCachePath += '/';
+    }
 }
 
 void PhysicsController::finalize()
 {
+    // Give the batched rigid bodies back their own collision objects.
+    for (size_t i = 0; i < _staticBatches.size(); ++i)
+    {
+        StaticBatch* batch = _staticBatches[i];
+        for (size_t j = 0; j < batch->objects.size(); ++j)
+            batch->objects[j]->_batched = false;
+        _world->removeRigidBody(batch->body);
+        SAFE_DELETE(batch->body);
+        SAFE_DELETE(batch->shape);
+        SAFE_DELETE(batch);
+    }
+    _staticBatches.clear();
+
+    _world->removeAction(_characterAction);
+    SAFE_DELETE(_characterAction);
+
     // Clean up the world and its various components.
     SAFE_DELETE(_world);
     SAFE_DELETE(_ghostPairCallback);
     SAFE_DELETE(_solver);
+    SAFE_DELETE(_solverPool);
     SAFE_DELETE(_overlappingPairCache);
     SAFE_DELETE(_dispatcher);
     SAFE_DELETE(_collisionConfiguration);
+#if BT_THREADSAFE
+    if (_taskScheduler)
+    {
+        _taskScheduler = NULL;
+        std::lock_guard<std::mutex> lock(__taskSchedulerMutex);
+        if (--__taskSchedulerUsers == 0)
+        {
+            btSetTaskScheduler(btGetSequentialTaskScheduler());
+            SAFE_DELETE(__taskScheduler);
+        }
+    }
+#endif
 }
 
 void PhysicsController::pause()
@@ -478,15 +918,38 @@ void PhysicsController::resume()
 
 void PhysicsController::update(float elapsedTime)
 {
+    GP_PROFILE("PhysicsController::update");
+
     GP_ASSERT(_world);
     _isUpdating = true;
 
-    // Update the physics simulation, with a maximum
-    // of 10 simulation steps being performed in a given frame.
+    // Advance the physics simulation in fixed steps, carrying the remainder over to the next update.
+    // When the maximum number of steps or the time budget is reached, the remaining time is dropped
+    // so that a slow frame does not make the following frames slower still.
     //
     // Note that stepSimulation takes elapsed time in seconds
     // so we divide by 1000 to convert from milliseconds.
-    _world->stepSimulation(elapsedTime * 0.001f, 10);
+    _timeAccumulator += elapsedTime;
+    double startTime = _stepTimeBudget > 0.0f ? Game::getAbsoluteTime() : 0.0;
+    unsigned int stepCount = 0;
+    const float fixedTimeStep = _fixedTimeStep * 0.001f;
+    while (_timeAccumulator >= _fixedTimeStep)
+    {
+        if (stepCount >= _maxSubSteps || (stepCount > 0 && _stepTimeBudget > 0.0f && Game::getAbsoluteTime() - startTime >= _stepTimeBudget))
+        {
+            _timeAccumulator = fmodf(_timeAccumulator, _fixedTimeStep);
+            break;
+        }
+        _world->stepSimulation(fixedTimeStep, 1, fixedTimeStep);
+        _timeAccumulator -= _fixedTimeStep;
+        ++stepCount;
+        ++_stepCount;
+    }
+    _interpolationAlpha = _timeAccumulator / _fixedTimeStep;
+    if (_interpolation)
+        interpolate();
+
+    updateActivation();
 
     // If we have status listeners, then check if our status has changed.
     if (_listeners || hasScriptListener(GP_GET_SCRIPT_EVENT(PhysicsController, statusEvent)))
@@ -538,76 +1001,214 @@ void PhysicsController::update(float elapsedTime)
         }
     }
 
-    // All statuses are set with the DIRTY bit before collision processing occurs.
-    // During collision processing, if a collision occurs, the status is 
-    // set to COLLISION and the DIRTY bit is cleared. Then, after collision processing 
-    // is finished, if a given status is still dirty, the COLLISION bit is cleared.
+    // Every update starts a new generation of the collision status cache. During collision
+    // processing, a colliding pair is stamped with the current generation and its status is
+    // set to COLLISION. Then, after collision processing is finished, a pair that is still
+    // marked as colliding but was not stamped in this generation stopped colliding.
     //
     // If an entry was marked for removal in the last frame, fire NOT_COLLIDING if appropriate and remove it now.
+    if (_collisionRemovals)
+        removeCollisionInfos();
+    ++_collisionGeneration;
+
+    // Go through the collision status cache and perform all registered collision tests.
+    // (In the case where we register for all collisions with a rigid body, there will be a lot
+    // of collision pairs in the status cache that we did not explicitly register for.)
+    // Entries added by the tests are never registered, so they are not visited.
+    for (size_t i = 0, count = _collisionStatus.size(); i < count; i++)
+    {
+        const CollisionInfo& info = _collisionStatus[i];
+        if ((info._status & REGISTERED) != 0 && (info._status & REMOVE) == 0)
+        {
+            PhysicsCollisionObject::CollisionPair pair = info._pair;
+            if (pair.objectB)
+                _world->contactPairTest(pair.objectA->getCollisionObject(), pair.objectB->getCollisionObject(), *_collisionCallback);
+            else
+                _world->contactTest(pair.objectA->getCollisionObject(), *_collisionCallback);
+        }
+    }
 
-    // Dirty the collision status cache entries.
-    std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.begin();
-    for (; iter != _collisionStatus.end();)
+    // Update all the collision status cache entries.
+    for (size_t i = 0; i < _collisionStatus.size(); i++)
     {
-        if ((iter->second._status & REMOVE) != 0)
+        if ((_collisionStatus[i]._status & COLLISION) != 0 && _collisionStatus[i]._generation != _collisionGeneration)
         {
-            if ((iter->second._status & COLLISION) != 0 && iter->first.objectB)
+            _collisionStatus[i]._status &= ~COLLISION;
+            if (_collisionStatus[i]._pair.objectB)
             {
-                size_t size = iter->second._listeners.size();
-                for (size_t i = 0; i < size; i++)
+                PhysicsCollisionObject::CollisionPair pair = _collisionStatus[i]._pair;
+                for (size_t j = 0; j < _collisionStatus[i]._listeners.size(); j++)
                 {
-                    PhysicsCollisionObject::CollisionPair cp(iter->first.objectA, NULL);
-                    iter->second._listeners[i]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, cp);
+                    _collisionStatus[i]._listeners[j]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, pair);
                 }
             }
-
-            std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator eraseIter = iter;
-            iter++;
-            _collisionStatus.erase(eraseIter);
-        }
-        else
-        {
-            iter->second._status |= DIRTY;
-            iter++;
         }
     }
 
-    // Go through the collision status cache and perform all registered collision tests.
-    iter = _collisionStatus.begin();
-    for (; iter != _collisionStatus.end(); iter++)
+    _isUpdating = false;
+}
+
+void PhysicsController::interpolate()
+{
+    GP_ASSERT(_world);
+
+    for (int i = 0; i < _world->getNumCollisionObjects(); i++)
     {
-        // If this collision pair was one that was registered for listening, then perform the collision test.
-        // (In the case where we register for all collisions with a rigid body, there will be a lot
-        // of collision pairs in the status cache that we did not explicitly register for.)
-        if ((iter->second._status & REGISTERED) != 0 && (iter->second._status & REMOVE) == 0)
+        btCollisionObject* collisionObject = _world->getCollisionObjectArray()[i];
+        GP_ASSERT(collisionObject);
+        PhysicsCollisionObject* object = getCollisionObject(collisionObject);
+        if (!object)
+            continue;
+
+        switch (object->getType())
         {
-            if (iter->first.objectB)
-                _world->contactPairTest(iter->first.objectA->getCollisionObject(), iter->first.objectB->getCollisionObject(), *_collisionCallback);
-            else
-                _world->contactTest(iter->first.objectA->getCollisionObject(), *_collisionCallback);
+        case PhysicsCollisionObject::RIGID_BODY:
+            // Kinematic bodies are driven by their nodes and dynamic bodies by the simulation.
+            if (!object->isKinematic() && object->_motionState)
+                object->_motionState->interpolate(_stepCount, _interpolationAlpha);
+            break;
+        case PhysicsCollisionObject::CHARACTER:
+            static_cast<PhysicsCharacter*>(object)->interpolate(_stepCount, _interpolationAlpha);
+            break;
+        default:
+            break;
         }
     }
+}
 
-    // Update all the collision status cache entries.
-    iter = _collisionStatus.begin();
-    for ( ; iter != _collisionStatus.end(); iter++)
+void PhysicsController::updateActivation()
+{
+    GP_ASSERT(_world);
+
+    const int objectCount = _world->getNumCollisionObjects();
+    _islandSizes.assign(objectCount, 0);
+    _activeBodyCount = 0;
+    _sleepingBodyCount = 0;
+    _frozenBodyCount = 0;
+    _islandCount = 0;
+    _largestIslandSize = 0;
+
+    // Most bodies belong to the same scene, so its camera is only looked up when the scene changes.
+    Scene* scene = NULL;
+    Camera* camera = NULL;
+    Vector3 cameraPosition;
+    const float freezeDistanceSquared = _freezeDistance * _freezeDistance;
+
+    for (int i = 0; i < objectCount; i++)
     {
-        if ((iter->second._status & DIRTY) != 0)
+        btCollisionObject* collisionObject = _world->getCollisionObjectArray()[i];
+        GP_ASSERT(collisionObject);
+        btRigidBody* body = btRigidBody::upcast(collisionObject);
+        if (!body || body->isStaticOrKinematicObject())
+            continue;
+
+        PhysicsCollisionObject* object = getCollisionObject(collisionObject);
+        if (_freezeDistance > 0.0f && object && object->getType() == PhysicsCollisionObject::RIGID_BODY && object->getNode())
         {
-            if ((iter->second._status & COLLISION) != 0 && iter->first.objectB)
+            Node* node = object->getNode();
+            if (node->getScene() != scene)
             {
-                size_t size = iter->second._listeners.size();
-                for (size_t i = 0; i < size; i++)
+                scene = node->getScene();
+                camera = scene ? scene->getActiveCamera() : NULL;
+                if (camera && camera->getNode())
+                    cameraPosition = camera->getNode()->getTranslationWorld();
+                else
+                    camera = NULL;
+            }
+
+            if (camera)
+            {
+                PhysicsRigidBody* rigidBody = static_cast<PhysicsRigidBody*>(object);
+                bool distant = cameraPosition.distanceSquared(node->getTranslationWorld()) > freezeDistanceSquared;
+                int state = body->getActivationState();
+                if (distant && !rigidBody->_frozen && (state == ACTIVE_TAG || state == WANTS_DEACTIVATION))
+                {
+                    body->setActivationState(ISLAND_SLEEPING);
+                    body->setLinearVelocity(btVector3(0, 0, 0));
+                    body->setAngularVelocity(btVector3(0, 0, 0));
+                    rigidBody->_frozen = true;
+                }
+                else if (rigidBody->_frozen && (!distant || state != ISLAND_SLEEPING))
                 {
-                    iter->second._listeners[i]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, iter->first);
+                    // Either back within range or woken up by another object.
+                    if (!distant)
+                        body->activate();
+                    rigidBody->_frozen = false;
                 }
+                if (rigidBody->_frozen)
+                    ++_frozenBodyCount;
             }
+        }
 
-            iter->second._status &= ~COLLISION;
+        if (body->isActive())
+        {
+            ++_activeBodyCount;
+            int island = body->getIslandTag();
+            if (island >= 0 && island < objectCount && ++_islandSizes[island] == 1)
+                ++_islandCount;
+        }
+        else
+        {
+            ++_sleepingBodyCount;
         }
     }
 
-    _isUpdating = false;
+    for (int i = 0; i < objectCount && _islandCount > 0; i++)
+    {
+        if (_islandSizes[i] > _largestIslandSize)
+            _largestIslandSize = _islandSizes[i];
+    }
+}
+
+int PhysicsController::findCollisionInfo(const PhysicsCollisionObject::CollisionPair& pair) const
+{
+    std::unordered_map<PhysicsCollisionObject::CollisionPair, unsigned int, CollisionPairHash>::const_iterator itr = _collisionIndices.find(pair);
+    return itr != _collisionIndices.end() ? (int)itr->second : -1;
+}
+
+unsigned int PhysicsController::getCollisionInfo(const PhysicsCollisionObject::CollisionPair& pair)
+{
+    std::unordered_map<PhysicsCollisionObject::CollisionPair, unsigned int, CollisionPairHash>::iterator itr = _collisionIndices.find(pair);
+    if (itr != _collisionIndices.end())
+        return itr->second;
+
+    unsigned int index = (unsigned int)_collisionStatus.size();
+    _collisionStatus.push_back(CollisionInfo(pair));
+    _collisionIndices[pair] = index;
+    return index;
+}
+
+void PhysicsController::removeCollisionInfos()
+{
+    for (size_t i = 0; i < _collisionStatus.size();)
+    {
+        CollisionInfo& info = _collisionStatus[i];
+        if ((info._status & REMOVE) == 0)
+        {
+            i++;
+            continue;
+        }
+
+        if ((info._status & COLLISION) != 0 && info._pair.objectB)
+        {
+            size_t size = info._listeners.size();
+            for (size_t j = 0; j < size; j++)
+            {
+                PhysicsCollisionObject::CollisionPair cp(info._pair.objectA, NULL);
+                info._listeners[j]->collisionEvent(PhysicsCollisionObject::CollisionListener::NOT_COLLIDING, cp);
+            }
+        }
+
+        // Move the last entry into the slot of the removed one.
+        _collisionIndices.erase(info._pair);
+        if (i + 1 < _collisionStatus.size())
+        {
+            std::swap(info, _collisionStatus.back());
+            _collisionIndices[info._pair] = (unsigned int)i;
+        }
+        _collisionStatus.pop_back();
+    }
+    _collisionRemovals = false;
 }
 
 void PhysicsController::addCollisionListener(PhysicsCollisionObject::CollisionListener* listener, PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB)
@@ -618,8 +1219,14 @@ void PhysicsController::addCollisionListener(PhysicsCollisionObject::CollisionLi
     GP_ASSERT(objectA || objectB);
     PhysicsCollisionObject::CollisionPair pair(objectA, objectB);
 
+    // Contacts are only tested for objects that are in the world themselves.
+    if (objectA && objectA->getType() == PhysicsCollisionObject::RIGID_BODY && static_cast<PhysicsRigidBody*>(objectA)->_batched)
+        unbatchStaticObject(static_cast<PhysicsRigidBody*>(objectA), true);
+    if (objectB && objectB->getType() == PhysicsCollisionObject::RIGID_BODY && static_cast<PhysicsRigidBody*>(objectB)->_batched)
+        unbatchStaticObject(static_cast<PhysicsRigidBody*>(objectB), true);
+
     // Add the listener and ensure the status includes that this collision pair is registered.
-    CollisionInfo& info = _collisionStatus[pair];
+    CollisionInfo& info = _collisionStatus[getCollisionInfo(pair)];
     info._listeners.push_back(listener);
     info._status |= PhysicsController::REGISTERED;
 }
@@ -631,9 +1238,11 @@ void PhysicsController::removeCollisionListener(PhysicsCollisionObject::Collisio
     PhysicsCollisionObject::CollisionPair pair(objectA, objectB);
 
     // Mark the collision pair for these objects for removal.
-    if (_collisionStatus.count(pair) > 0)
+    int index = findCollisionInfo(pair);
+    if (index >= 0)
     {
-        _collisionStatus[pair]._status |= REMOVE;
+        _collisionStatus[index]._status |= REMOVE;
+        _collisionRemovals = true;
     }
 }
 
@@ -652,6 +1261,7 @@ void PhysicsController::addCollisionObject(PhysicsCollisionObject* object)
     switch (object->getType())
     {
     case PhysicsCollisionObject::RIGID_BODY:
+        static_cast<btRigidBody*>(object->getCollisionObject())->setSleepingThresholds(_linearSleepingThreshold, _angularSleepingThreshold);
         _world->addRigidBody(static_cast<btRigidBody*>(object->getCollisionObject()), group, mask);
         break;
 
@@ -681,7 +1291,10 @@ void PhysicsController::removeCollisionObject(PhysicsCollisionObject* object, bo
         switch (object->getType())
         {
         case PhysicsCollisionObject::RIGID_BODY:
-            _world->removeRigidBody(static_cast<btRigidBody*>(object->getCollisionObject()));
+            if (static_cast<PhysicsRigidBody*>(object)->_batched)
+                unbatchStaticObject(static_cast<PhysicsRigidBody*>(object), false);
+            else
+                _world->removeRigidBody(static_cast<btRigidBody*>(object->getCollisionObject()));
             break;
 
         case PhysicsCollisionObject::CHARACTER:
@@ -698,15 +1311,120 @@ void PhysicsController::removeCollisionObject(PhysicsCollisionObject* object, bo
     // Find all references to the object in the collision status cache and mark them for removal.
     if (removeListeners)
     {
-        std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo>::iterator iter = _collisionStatus.begin();
-        for (; iter != _collisionStatus.end(); iter++)
+        for (size_t i = 0, count = _collisionStatus.size(); i < count; i++)
         {
-            if (iter->first.objectA == object || iter->first.objectB == object)
-                iter->second._status |= REMOVE;
+            CollisionInfo& info = _collisionStatus[i];
+            if (info._pair.objectA == object || info._pair.objectB == object)
+            {
+                info._status |= REMOVE;
+                _collisionRemovals = true;
+            }
         }
     }
 }
 
+unsigned int PhysicsController::rayTest(const Ray* rays, const float* distances, unsigned int count, PhysicsController::HitResult* results, PhysicsController::HitFilter* filter)
+{
+    GP_ASSERT(rays);
+    GP_ASSERT(distances);
+    GP_ASSERT(results);
+
+    struct Batch
+    {
+        PhysicsController* controller;
+        const Ray* rays;
+        const float* distances;
+        HitResult* results;
+        HitFilter* filter;
+        std::atomic<unsigned int> hitCount;
+    } batch;
+    batch.controller = this;
+    batch.rays = rays;
+    batch.distances = distances;
+    batch.results = results;
+    batch.filter = filter;
+    batch.hitCount = 0;
+
+    // Only a single pointer is captured so that the function does not allocate.
+    Batch* b = &batch;
+    std::function<void(unsigned int, unsigned int, unsigned int)> test = [b](unsigned int begin, unsigned int end, unsigned int worker)
+    {
+        unsigned int hitCount = 0;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            HitResult& result = b->results[i];
+            if (b->controller->rayTest(b->rays[i], b->distances[i], &result, b->filter))
+            {
+                ++hitCount;
+            }
+            else
+            {
+                result.object = NULL;
+                result.fraction = 1.0f;
+            }
+        }
+        b->hitCount += hitCount;
+    };
+
+    // Bullet can only query the broadphase from several threads when it is built thread safe.
+    if (_taskScheduler)
+        Game::getInstance()->getJobController()->parallelFor(count, test, QUERY_BATCH_SIZE);
+    else
+        test(0, count, 0);
+    return batch.hitCount;
+}
+
+unsigned int PhysicsController::sweepTest(PhysicsCollisionObject** objects, const Vector3* endPositions, unsigned int count, PhysicsController::HitResult* results, PhysicsController::HitFilter* filter)
+{
+    GP_ASSERT(objects);
+    GP_ASSERT(endPositions);
+    GP_ASSERT(results);
+
+    struct Batch
+    {
+        PhysicsController* controller;
+        PhysicsCollisionObject** objects;
+        const Vector3* endPositions;
+        HitResult* results;
+        HitFilter* filter;
+        std::atomic<unsigned int> hitCount;
+    } batch;
+    batch.controller = this;
+    batch.objects = objects;
+    batch.endPositions = endPositions;
+    batch.results = results;
+    batch.filter = filter;
+    batch.hitCount = 0;
+
+    // Only a single pointer is captured so that the function does not allocate.
+    Batch* b = &batch;
+    std::function<void(unsigned int, unsigned int, unsigned int)> test = [b](unsigned int begin, unsigned int end, unsigned int worker)
+    {
+        unsigned int hitCount = 0;
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            HitResult& result = b->results[i];
+            if (b->controller->sweepTest(b->objects[i], b->endPositions[i], &result, b->filter))
+            {
+                ++hitCount;
+            }
+            else
+            {
+                result.object = NULL;
+                result.fraction = 1.0f;
+            }
+        }
+        b->hitCount += hitCount;
+    };
+
+    // Bullet can only query the broadphase from several threads when it is built thread safe.
+    if (_taskScheduler)
+        Game::getInstance()->getJobController()->parallelFor(count, test, QUERY_BATCH_SIZE);
+    else
+        test(0, count, 0);
+    return batch.hitCount;
+}
+
 PhysicsCollisionObject* PhysicsController::getCollisionObject(const btCollisionObject* collisionObject) const
 {
     // Gameplay collision objects are stored in the userPointer data of Bullet collision objects.
@@ -714,6 +1432,178 @@ PhysicsCollisionObject* PhysicsController::getCollisionObject(const btCollisionO
     return reinterpret_cast<PhysicsCollisionObject*>(collisionObject->getUserPointer());
 }
 
+unsigned int PhysicsController::batchStaticObjects(Scene* scene, float cellSize)
+{
+    GP_ASSERT(scene);
+    GP_ASSERT(_world);
+    GP_ASSERT(!_isUpdating);
+
+    // Gather the candidates first, since batching removes them from the world.
+    std::vector<PhysicsRigidBody*> bodies;
+    for (int i = 0; i < _world->getNumCollisionObjects(); i++)
+    {
+        PhysicsCollisionObject* object = getCollisionObject(_world->getCollisionObjectArray()[i]);
+        if (!object || object->getType() != PhysicsCollisionObject::RIGID_BODY || !object->isStatic() || !object->isEnabled())
+            continue;
+        PhysicsRigidBody* body = static_cast<PhysicsRigidBody*>(object);
+        if (body->_batched || !body->getNode() || body->getNode()->getScene() != scene ||
+            body->getShapeType() == PhysicsCollisionShape::SHAPE_HEIGHTFIELD || (body->_constraints && !body->_constraints->empty()))
+            continue;
+
+        // Collision events are only reported for objects that are in the world themselves.
+        bool listened = false;
+        for (size_t j = 0; j < _collisionStatus.size() && !listened; j++)
+        {
+            const CollisionInfo& info = _collisionStatus[j];
+            listened = (info._pair.objectA == object || info._pair.objectB == object) && !info._listeners.empty();
+        }
+        if (!listened)
+            bodies.push_back(body);
+    }
+
+    std::vector<StaticBatch*> changed;
+    for (size_t i = 0; i < bodies.size(); i++)
+    {
+        PhysicsRigidBody* body = bodies[i];
+        GP_ASSERT(body->_body);
+        const btTransform& transform = body->_body->getWorldTransform();
+
+        int cell[3] = { 0, 0, 0 };
+        if (cellSize > 0.0f)
+        {
+            for (int j = 0; j < 3; j++)
+                cell[j] = (int)floorf(transform.getOrigin()[j] / cellSize);
+        }
+
+        // Find the batch of the cell that the body can be merged into.
+        StaticBatch* batch = NULL;
+        for (size_t j = 0; j < _staticBatches.size() && !batch; j++)
+        {
+            StaticBatch* b = _staticBatches[j];
+            if (b->scene == scene && b->group == body->_group && b->mask == body->_mask &&
+                b->friction == body->_body->getFriction() && b->restitution == body->_body->getRestitution() &&
+                b->cell[0] == cell[0] && b->cell[1] == cell[1] && b->cell[2] == cell[2])
+            {
+                batch = b;
+            }
+        }
+        if (!batch)
+        {
+            batch = new StaticBatch();
+            batch->body = NULL;
+            batch->shape = bullet_new<btCompoundShape>(true);
+            batch->scene = scene;
+            batch->group = body->_group;
+            batch->mask = body->_mask;
+            batch->friction = body->_body->getFriction();
+            batch->restitution = body->_body->getRestitution();
+            memcpy(batch->cell, cell, sizeof(cell));
+            _staticBatches.push_back(batch);
+        }
+        if (std::find(changed.begin(), changed.end(), batch) == changed.end())
+            changed.push_back(batch);
+
+        // The compound object is at the origin, so the children keep the world transforms of the bodies.
+        _world->removeRigidBody(body->_body);
+        batch->shape->addChildShape(transform, body->_body->getCollisionShape());
+        batch->objects.push_back(body);
+        body->_batched = true;
+    }
+
+    for (size_t i = 0; i < changed.size(); i++)
+    {
+        StaticBatch* batch = changed[i];
+        if (batch->body)
+        {
+            _world->updateSingleAabb(batch->body);
+            continue;
+        }
+
+        btRigidBody::btRigidBodyConstructionInfo info(0.0f, NULL, batch->shape);
+        info.m_friction = batch->friction;
+        info.m_restitution = batch->restitution;
+        batch->body = bullet_new<btRigidBody>(info);
+        batch->body->setUserPointer(NULL);
+        batch->body->setUserIndex(STATIC_BATCH);
+        _world->addRigidBody(batch->body, (short)batch->group, (short)batch->mask);
+    }
+
+    return (unsigned int)bodies.size();
+}
+
+PhysicsCollisionObject* PhysicsController::getBatchedObject(const btCollisionObject* collisionObject, const btVector3& point) const
+{
+    GP_ASSERT(collisionObject);
+    if (collisionObject->getUserIndex() != STATIC_BATCH)
+        return NULL;
+
+    for (size_t i = 0; i < _staticBatches.size(); i++)
+    {
+        const StaticBatch* batch = _staticBatches[i];
+        if (batch->body != collisionObject)
+            continue;
+
+        // Hits lie on the surface of a child, so the child whose bounds are closest to the point is the one that was hit.
+        PhysicsCollisionObject* closest = NULL;
+        btScalar closestDistance = BT_LARGE_FLOAT;
+        for (int j = 0; j < batch->shape->getNumChildShapes() && closestDistance > 0; j++)
+        {
+            btVector3 min, max;
+            batch->shape->getChildShape(j)->getAabb(batch->shape->getChildTransform(j), min, max);
+            btVector3 p(point);
+            p.setMax(min);
+            p.setMin(max);
+            btScalar distance = p.distance2(point);
+            if (distance < closestDistance)
+            {
+                closestDistance = distance;
+                closest = batch->objects[j];
+            }
+        }
+        return closest;
+    }
+    return NULL;
+}
+
+void PhysicsController::unbatchStaticObject(PhysicsRigidBody* body, bool addToWorld)
+{
+    GP_ASSERT(body && body->_batched);
+    GP_ASSERT(_world);
+
+    for (size_t i = 0; i < _staticBatches.size(); i++)
+    {
+        StaticBatch* batch = _staticBatches[i];
+        std::vector<PhysicsRigidBody*>::iterator itr = std::find(batch->objects.begin(), batch->objects.end(), body);
+        if (itr == batch->objects.end())
+            continue;
+
+        // Bullet removes children by moving the last child into their place, so the objects do the same.
+        int index = (int)(itr - batch->objects.begin());
+        batch->shape->removeChildShapeByIndex(index);
+        batch->objects[index] = batch->objects.back();
+        batch->objects.pop_back();
+
+        if (batch->objects.empty())
+        {
+            _world->removeRigidBody(batch->body);
+            SAFE_DELETE(batch->body);
+            SAFE_DELETE(batch->shape);
+            SAFE_DELETE(batch);
+            _staticBatches.erase(_staticBatches.begin() + i);
+        }
+        else
+        {
+            batch->shape->recalculateLocalAabb();
+            _world->updateSingleAabb(batch->body);
+        }
+        break;
+    }
+
+    body->_batched = false;
+    if (addToWorld)
+        addCollisionObject(body);
+}
+
 static void getBoundingBox(Node* node, BoundingBox* out, bool merge = false)
 {
     GP_ASSERT(node);
@@ -1074,6 +1964,96 @@ PhysicsCollisionShape* PhysicsController::createHeightfield(Node* node, HeightFi
     return shape;
 }
 
+// Identifies shape cache files and their layout version.
+#define SHAPE_CACHE_MAGIC 0x48564247
+#define SHAPE_CACHE_VERSION 1
+
+// Header written at the start of every shape cache file.
+struct ShapeCacheHeader
+{
+    unsigned int magic;
+    unsigned int version;
+    unsigned int bulletVersion;
+    unsigned long long key;
+    unsigned int length;
+};
+
+static unsigned long long hashBytes(unsigned long long hash, const void* data, size_t size)
+{
+    // 64-bit FNV-1a.
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * Loads the BVH of a static mesh shape from the given cache file, or returns NULL if
+ * there is no valid BVH for the given key. The returned BVH lives in the buffer that
+ * is returned in data, which must be freed with btAlignedFree once the shape is destroyed.
+ */
+static btOptimizedBvh* loadShapeBvh(const char* path, unsigned long long key, void** data)
+{
+    *data = NULL;
+    if (!FileSystem::fileExists(path))
+        return NULL;
+
+    int size = 0;
+    char* file = FileSystem::readAll(path, &size);
+    if (file == NULL)
+        return NULL;
+
+    btOptimizedBvh* bvh = NULL;
+    const ShapeCacheHeader* header = (const ShapeCacheHeader*)file;
+    if (size >= (int)sizeof(ShapeCacheHeader) && header->magic == SHAPE_CACHE_MAGIC && header->version == SHAPE_CACHE_VERSION &&
+        header->bulletVersion == BT_BULLET_VERSION && header->key == key && header->length == (unsigned int)(size - sizeof(ShapeCacheHeader)))
+    {
+        // The BVH is deserialized in place, so it needs an aligned buffer that outlives the shape.
+        *data = btAlignedAlloc(header->length, 16);
+        memcpy(*data, file + sizeof(ShapeCacheHeader), header->length);
+        bvh = btOptimizedBvh::deSerializeInPlace(*data, header->length, false);
+        if (bvh == NULL)
+        {
+            btAlignedFree(*data);
+            *data = NULL;
+        }
+    }
+    SAFE_DELETE_ARRAY(file);
+
+    return bvh;
+}
+
+/**
+ * Writes the BVH of a static mesh shape to the given cache file.
+ */
+static void saveShapeBvh(const btOptimizedBvh* bvh, const char* path, unsigned long long key)
+{
+    GP_ASSERT(bvh);
+
+    ShapeCacheHeader header;
+    header.magic = SHAPE_CACHE_MAGIC;
+    header.version = SHAPE_CACHE_VERSION;
+    header.bulletVersion = BT_BULLET_VERSION;
+    header.key = key;
+    header.length = bvh->calculateSerializeBufferSize();
+
+    void* data = btAlignedAlloc(header.length, 16);
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::WRITE));
+    if (bvh->serializeInPlace(data, header.length, false) && stream.get() != NULL && stream->canWrite())
+    {
+        stream->write(&header, sizeof(ShapeCacheHeader), 1);
+        stream->write(data, 1, header.length);
+    }
+    else
+    {
+        GP_WARN("Failed to write shape cache file '%s'.", path);
+    }
+    btAlignedFree(data);
+}
+
 PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3& scale, bool dynamic)
 {
     GP_ASSERT(mesh);
@@ -1115,6 +2095,15 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
         }
     }
 
+    // Return the mesh shape from the cache if one was already created from the same source.
+    unsigned long long sourceHash = 14695981039346656037ULL;
+    sourceHash = hashBytes(sourceHash, mesh->getUrl(), strlen(mesh->getUrl()));
+    sourceHash = hashBytes(sourceHash, &scale.x, sizeof(float) * 3);
+    sourceHash = hashBytes(sourceHash, &dynamic, sizeof(bool));
+    PhysicsCollisionShape* shape = findMeshShape(sourceHash, 0);
+    if (shape)
+        return shape;
+
     // Read mesh data from URL
     Bundle::MeshData* data = Bundle::readMeshData(mesh->getUrl());
     if (data == NULL)
@@ -1134,15 +2123,46 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
     shapeMeshData->vertexData = new float[vertexCount * 3];
     Vector3 v;
     int vertexStride = data->vertexFormat.getVertexSize();
+    const VertexFormat::Element& position = data->vertexFormat.getElement(0);
+    GP_ASSERT(position.usage == VertexFormat::POSITION && position.size >= 3);
     for (unsigned int i = 0; i < data->vertexCount; i++)
     {
-        v.set(*((float*)&data->vertexData[i * vertexStride + 0 * sizeof(float)]),
-                *((float*)&data->vertexData[i * vertexStride + 1 * sizeof(float)]),
-                *((float*)&data->vertexData[i * vertexStride + 2 * sizeof(float)]));
+        // Positions can be stored as half floats or integers, so they are converted to floats.
+        float p[4];
+        position.read(&data->vertexData[i * vertexStride], p);
+        v.set(p[0], p[1], p[2]);
         v *= m;
         memcpy(&(shapeMeshData->vertexData[i * 3]), &v, sizeof(float) * 3);
     }
 
+    // Other bundles (or other scales of the same mesh) can hold the same geometry, so the
+    // shapes are also shared by the contents of their vertices and indices.
+    unsigned long long contentHash = 14695981039346656037ULL;
+    contentHash = hashBytes(contentHash, &dynamic, sizeof(bool));
+    contentHash = hashBytes(contentHash, shapeMeshData->vertexData, sizeof(float) * 3 * vertexCount);
+    if (!dynamic)
+    {
+        for (size_t i = 0; i < data->parts.size(); i++)
+        {
+            Bundle::MeshPartData* meshPart = data->parts[i];
+            GP_ASSERT(meshPart);
+            unsigned int indexSize = meshPart->indexFormat == Mesh::INDEX32 ? 4 : (meshPart->indexFormat == Mesh::INDEX16 ? 2 : 1);
+            contentHash = hashBytes(contentHash, &meshPart->indexFormat, sizeof(Mesh::IndexFormat));
+            contentHash = hashBytes(contentHash, meshPart->indexData, indexSize * meshPart->indexCount);
+        }
+    }
+    shape = findMeshShape(0, contentHash);
+    if (shape)
+    {
+        SAFE_DELETE_ARRAY(shapeMeshData->vertexData);
+        SAFE_DELETE(shapeMeshData);
+        SAFE_DELETE(data);
+        return shape;
+    }
+    shapeMeshData->sourceHash = sourceHash;
+    shapeMeshData->contentHash = contentHash;
+    shapeMeshData->bvhData = NULL;
+
     btCollisionShape* collisionShape = NULL;
     btTriangleIndexVertexArray* meshInterface = NULL;
 
@@ -1244,11 +2264,34 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
         }
 
         // Create our collision shape object and store shapeMeshData in it.
-        collisionShape = bullet_new<btBvhTriangleMeshShape>(meshInterface, true);
+        if (_shapeCache)
+        {
+            char name[32];
+            sprintf(name, "%016llx.bvh", contentHash);
+            std::string path = _shapeCachePath + name;
+
+            btOptimizedBvh* bvh = loadShapeBvh(path.c_str(), contentHash, &shapeMeshData->bvhData);
+            if (bvh)
+            {
+                btBvhTriangleMeshShape* triangleMeshShape = bullet_new<btBvhTriangleMeshShape>(meshInterface, true, false);
+                triangleMeshShape->setOptimizedBvh(bvh);
+                collisionShape = triangleMeshShape;
+            }
+            else
+            {
+                btBvhTriangleMeshShape* triangleMeshShape = bullet_new<btBvhTriangleMeshShape>(meshInterface, true);
+                saveShapeBvh(triangleMeshShape->getOptimizedBvh(), path.c_str(), contentHash);
+                collisionShape = triangleMeshShape;
+            }
+        }
+        else
+        {
+            collisionShape = bullet_new<btBvhTriangleMeshShape>(meshInterface, true);
+        }
     }
 
     // Create our collision shape object and store shapeMeshData in it.
-    PhysicsCollisionShape* shape = new PhysicsCollisionShape(PhysicsCollisionShape::SHAPE_MESH, collisionShape, meshInterface);
+    shape = new PhysicsCollisionShape(PhysicsCollisionShape::SHAPE_MESH, collisionShape, meshInterface);
     shape->_shapeData.meshData = shapeMeshData;
 
     _shapes.push_back(shape);
@@ -1259,6 +2302,23 @@ PhysicsCollisionShape* PhysicsController::createMesh(Mesh* mesh, const Vector3&
     return shape;
 }
 
+PhysicsCollisionShape* PhysicsController::findMeshShape(unsigned long long sourceHash, unsigned long long contentHash)
+{
+    for (unsigned int i = 0; i < _shapes.size(); ++i)
+    {
+        PhysicsCollisionShape* shape = _shapes[i];
+        GP_ASSERT(shape);
+        if (shape->getType() == PhysicsCollisionShape::SHAPE_MESH && shape->_shapeData.meshData &&
+            ((sourceHash != 0 && shape->_shapeData.meshData->sourceHash == sourceHash) ||
+             (contentHash != 0 && shape->_shapeData.meshData->contentHash == contentHash)))
+        {
+            shape->addRef();
+            return shape;
+        }
+    }
+    return NULL;
+}
+
 void PhysicsController::destroyShape(PhysicsCollisionShape* shape)
 {
     if (shape)
@@ -1329,6 +2389,38 @@ void PhysicsController::removeConstraint(PhysicsConstraint* constraint)
     }
 }
 
+// The number of lines that the debug drawer batches into a single draw call.
+#define DEBUG_DRAW_LINE_CAPACITY 32768
+
+/**
+ * Draws the edges of the triangles of concave shapes.
+ */
+class DebugTriangleCallback : public btTriangleCallback
+{
+public:
+
+    DebugTriangleCallback(btIDebugDraw* drawer, const btTransform& transform, const btVector3& color)
+        : _drawer(drawer), _transform(transform), _color(color)
+    {
+    }
+
+    void processTriangle(btVector3* triangle, int partId, int triangleIndex)
+    {
+        btVector3 a = _transform * triangle[0];
+        btVector3 b = _transform * triangle[1];
+        btVector3 c = _transform * triangle[2];
+        _drawer->drawLine(a, b, _color);
+        _drawer->drawLine(b, c, _color);
+        _drawer->drawLine(c, a, _color);
+    }
+
+private:
+
+    btIDebugDraw* _drawer;
+    const btTransform& _transform;
+    btVector3 _color;
+};
+
 PhysicsController::DebugDrawer::DebugDrawer()
     : _mode(btIDebugDraw::DBG_DrawAabb | btIDebugDraw::DBG_DrawConstraintLimits | btIDebugDraw::DBG_DrawConstraints | 
        btIDebugDraw::DBG_DrawContactPoints | btIDebugDraw::DBG_DrawWireframe), _meshBatch(NULL), _lineCount(0)
@@ -1369,7 +2461,8 @@ PhysicsController::DebugDrawer::DebugDrawer()
         VertexFormat::Element(VertexFormat::POSITION, 3),
         VertexFormat::Element(VertexFormat::COLOR, 4),
     };
-    _meshBatch = MeshBatch::create(VertexFormat(elements, 2), Mesh::LINES, material, false, 4096, 4096);
+    // The batch is flushed whenever it is full, so it never needs to grow.
+    _meshBatch = MeshBatch::create(VertexFormat(elements, 2), Mesh::LINES, material, false, DEBUG_DRAW_LINE_CAPACITY * 2, 0);
     SAFE_RELEASE(material);
     SAFE_RELEASE(effect);
 }
@@ -1394,6 +2487,62 @@ void PhysicsController::DebugDrawer::end()
     _lineCount = 0;
 }
 
+void PhysicsController::DebugDrawer::drawWorld(btCollisionWorld* world, const Matrix& viewProjection)
+{
+    GP_ASSERT(world);
+
+    Frustum frustum(viewProjection);
+    Vector3 corners[8];
+    frustum.getCorners(corners);
+
+    // Bullet draws every object of the world, so the objects outside of the frustum are hidden
+    // from it. Concave shapes are large level geometry, so they are drawn here instead with only
+    // the triangles that are within the bounds of the frustum.
+    for (int i = 0; i < world->getNumCollisionObjects(); i++)
+    {
+        btCollisionObject* object = world->getCollisionObjectArray()[i];
+        GP_ASSERT(object);
+        if (object->getCollisionFlags() & btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT)
+            continue;
+
+        btVector3 min, max;
+        object->getCollisionShape()->getAabb(object->getWorldTransform(), min, max);
+        if (frustum.intersects(BoundingBox(min.x(), min.y(), min.z(), max.x(), max.y(), max.z())))
+        {
+            if (!object->getCollisionShape()->isConcave())
+                continue;
+
+            if (_mode & btIDebugDraw::DBG_DrawWireframe)
+            {
+                // Find the bounds of the frustum in the local space of the shape.
+                btTransform inverse = object->getWorldTransform().inverse();
+                btVector3 localMin(BT_LARGE_FLOAT, BT_LARGE_FLOAT, BT_LARGE_FLOAT);
+                btVector3 localMax(-BT_LARGE_FLOAT, -BT_LARGE_FLOAT, -BT_LARGE_FLOAT);
+                for (unsigned int j = 0; j < 8; j++)
+                {
+                    btVector3 corner = inverse * BV(corners[j]);
+                    localMin.setMin(corner);
+                    localMax.setMax(corner);
+                }
+                btVector3 color = object->isActive() ? btVector3(1, 1, 1) : btVector3(0, 1, 0);
+                DebugTriangleCallback callback(this, object->getWorldTransform(), color);
+                static_cast<btConcaveShape*>(object->getCollisionShape())->processAllTriangles(&callback, localMin, localMax);
+            }
+            if (_mode & btIDebugDraw::DBG_DrawAabb)
+                drawAabb(min, max, btVector3(1, 0, 0));
+        }
+
+        object->setCollisionFlags(object->getCollisionFlags() | btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT);
+        _hiddenObjects.push_back(object);
+    }
+
+    world->debugDrawWorld();
+
+    for (size_t i = 0; i < _hiddenObjects.size(); i++)
+        _hiddenObjects[i]->setCollisionFlags(_hiddenObjects[i]->getCollisionFlags() & ~btCollisionObject::CF_DISABLE_VISUALIZE_OBJECT);
+    _hiddenObjects.clear();
+}
+
 void PhysicsController::DebugDrawer::drawLine(const btVector3& from, const btVector3& to, const btVector3& fromColor, const btVector3& toColor)
 {
     GP_ASSERT(_meshBatch);
@@ -1419,7 +2568,7 @@ void PhysicsController::DebugDrawer::drawLine(const btVector3& from, const btVec
     _meshBatch->add(vertices, 2);
 
     ++_lineCount;
-    if (_lineCount >= 4096)
+    if (_lineCount >= DEBUG_DRAW_LINE_CAPACITY)
     {
         // Flush the batch when it gets full (don't want to to grow infinitely)
         end();
@@ -12,19 +12,38 @@
 #include "HeightField.h"
 #include "ScriptTarget.h"
 
+class btITaskScheduler;
+
 namespace gameplay
 {
 
+class Scene;
 class ScriptListener;
 
 /**
  * Defines a class for controlling game physics.
  *
+ * Mesh collision shapes are shared between all collision objects that are created from
+ * the same geometry at the same scale, even when it is loaded from different bundles.
+ * When the 'shapeCache' property of the 'physics' namespace in the game configuration
+ * is true, the bounding volume hierarchies of static mesh shapes are also stored in the
+ * directory set by the 'shapeCachePath' property, so that later loads of large level meshes
+ * skip building them. Cached hierarchies are keyed by the contents of the mesh and are
+ * built again whenever a file is missing or does not match.
+ *
+ * The broadphase is a dynamic bounding volume tree by default, which suits worlds of
+ * any size. Bounded worlds can instead use sweep and prune by setting the 'broadphase'
+ * property of the 'physics' namespace to 'axisSweep', along with the 'worldMin' and
+ * 'worldMax' bounds of the world and optionally the 'maxProxies' count of objects
+ * (16384 by default). Objects outside of the bounds of an axis sweep broadphase
+ * do not collide correctly.
+ *
  * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-Physics
  */
 class PhysicsController : public ScriptTarget
 {
     friend class Game;
+    friend class World;
     friend class PhysicsConstraint;
     friend class PhysicsRigidBody;
     friend class PhysicsCharacter;
@@ -301,8 +320,232 @@ public:
      */
     void setGravity(const Vector3& gravity);
 
+    /**
+     * Gets the number of fixed simulation steps per second.
+     *
+     * @return The tick rate, in steps per second.
+     */
+    float getTickRate() const;
+
+    /**
+     * Sets the number of fixed simulation steps per second.
+     *
+     * The world is always advanced in steps of the same size, so lowering the tick rate
+     * (for example to 30 steps per second on slower devices) reduces the cost of the
+     * simulation at the expense of accuracy. The default is 60 steps per second.
+     * This can also be set with the 'tickRate' property of the 'physics' namespace of game.config.
+     *
+     * @param ticksPerSecond The tick rate, in steps per second.
+     */
+    void setTickRate(float ticksPerSecond);
+
+    /**
+     * Gets the maximum number of simulation steps that are performed in a single update.
+     *
+     * @return The maximum number of steps.
+     */
+    unsigned int getMaxSubSteps() const;
+
+    /**
+     * Sets the maximum number of simulation steps that are performed in a single update.
+     *
+     * When more steps would be needed to catch up with the elapsed time, the remaining time
+     * is dropped instead of being simulated in later updates, so a long frame is not followed
+     * by even longer ones. The default is 10 steps.
+     * This can also be set with the 'maxSubSteps' property of the 'physics' namespace of game.config.
+     *
+     * @param maxSubSteps The maximum number of steps.
+     */
+    void setMaxSubSteps(unsigned int maxSubSteps);
+
+    /**
+     * Gets the time budget for the simulation steps of a single update.
+     *
+     * @return The time budget, in milliseconds, or zero if it is unlimited.
+     */
+    float getStepTimeBudget() const;
+
+    /**
+     * Sets the time budget for the simulation steps of a single update.
+     *
+     * Once the steps performed in an update have taken longer than the budget, no more steps
+     * are started and the remaining time is dropped, just like when the maximum number of
+     * steps is reached. At least one step is always performed when one is due.
+     * This can also be set with the 'stepBudget' property of the 'physics' namespace of game.config.
+     *
+     * @param budget The time budget, in milliseconds, or zero for no budget (the default).
+     */
+    void setStepTimeBudget(float budget);
+
+    /**
+     * Determines if the transforms of simulated objects are interpolated between simulation steps.
+     *
+     * @return True if interpolation is enabled, false otherwise.
+     */
+    bool isInterpolationEnabled() const;
+
+    /**
+     * Sets whether the transforms of simulated objects are interpolated between simulation steps.
+     *
+     * Without interpolation, the nodes of rigid bodies, vehicles and characters are placed at
+     * their state after the last simulation step, which appears to stutter when the tick rate
+     * is lower than the frame rate. With interpolation, the nodes are placed between the states
+     * of the last two steps based on the interpolation alpha, which is smooth at the cost of
+     * rendering the simulation up to one step late. Interpolation is disabled by default.
+     * This can also be set with the 'interpolation' property of the 'physics' namespace of game.config.
+     *
+     * @param enabled True to enable interpolation, false to disable it.
+     */
+    void setInterpolationEnabled(bool enabled);
+
+    /**
+     * Gets the fraction of a simulation step that has elapsed since the last step was performed.
+     *
+     * This can be used to interpolate custom state that is updated from the simulation.
+     *
+     * @return The interpolation alpha, between 0 and 1.
+     */
+    float getInterpolationAlpha() const;
+
+    /**
+     * Sets the velocities below which rigid bodies are deactivated.
+     *
+     * A rigid body whose linear and angular velocities stay below these thresholds for the
+     * deactivation time goes to sleep, and is not simulated until another object wakes it.
+     * The thresholds apply to all existing and future rigid bodies. The defaults are 0.8
+     * and 1.0. This can also be set with the 'linearSleepingThreshold' and
+     * 'angularSleepingThreshold' properties of the 'physics' namespace of a scene.
+     *
+     * @param linear The linear velocity threshold.
+     * @param angular The angular velocity threshold, in radians per second.
+     */
+    void setSleepingThresholds(float linear, float angular);
+
+    /**
+     * Gets the linear velocity below which rigid bodies are deactivated.
+     *
+     * @return The linear velocity threshold.
+     */
+    float getLinearSleepingThreshold() const;
+
+    /**
+     * Gets the angular velocity below which rigid bodies are deactivated.
+     *
+     * @return The angular velocity threshold, in radians per second.
+     */
+    float getAngularSleepingThreshold() const;
+
+    /**
+     * Sets the time that a rigid body must be below the sleeping thresholds before it is deactivated.
+     *
+     * The default is 2000 milliseconds. This can also be set with the 'deactivationTime'
+     * property of the 'physics' namespace of a scene.
+     *
+     * @param time The deactivation time, in milliseconds.
+     */
+    void setDeactivationTime(float time);
+
+    /**
+     * Gets the time that a rigid body must be below the sleeping thresholds before it is deactivated.
+     *
+     * @return The deactivation time, in milliseconds.
+     */
+    float getDeactivationTime() const;
+
+    /**
+     * Sets the distance from the active camera beyond which rigid bodies are frozen.
+     *
+     * Every update, dynamic rigid bodies that are further than this distance from the active
+     * camera of their node's scene are deactivated, as if they had gone to sleep. A frozen body
+     * is woken up again once it is within the distance, or when another object collides
+     * with it. The velocities of a body are lost when it is frozen. This can also be set
+     * with the 'freezeDistance' property of the 'physics' namespace of a scene.
+     *
+     * @param distance The freeze distance, or zero to never freeze bodies (the default).
+     */
+    void setFreezeDistance(float distance);
+
+    /**
+     * Gets the distance from the active camera beyond which rigid bodies are frozen.
+     *
+     * @return The freeze distance, or zero if bodies are never frozen.
+     */
+    float getFreezeDistance() const;
+
+    /**
+     * Gets the number of dynamic rigid bodies that were simulated in the last update.
+     *
+     * @return The number of active rigid bodies.
+     */
+    unsigned int getActiveBodyCount() const;
+
+    /**
+     * Gets the number of dynamic rigid bodies that were deactivated after the last update,
+     * including the bodies that are frozen.
+     *
+     * @return The number of sleeping rigid bodies.
+     */
+    unsigned int getSleepingBodyCount() const;
+
+    /**
+     * Gets the number of dynamic rigid bodies that were frozen after the last update for
+     * being beyond the freeze distance.
+     *
+     * @return The number of frozen rigid bodies.
+     */
+    unsigned int getFrozenBodyCount() const;
+
+    /**
+     * Gets the number of simulation islands with at least one active body in the last update.
+     *
+     * An island is a group of objects that touch or are constrained to each other, directly
+     * or through other objects of the island, and that are solved together.
+     *
+     * @return The number of active islands.
+     */
+    unsigned int getIslandCount() const;
+
+    /**
+     * Gets the number of objects in the largest active simulation island of the last update.
+     *
+     * @return The size of the largest active island.
+     */
+    unsigned int getLargestIslandSize() const;
+
+    /**
+     * Gets the number of collision objects in the broadphase.
+     *
+     * @return The number of broadphase proxies.
+     */
+    unsigned int getBroadphaseProxyCount() const;
+
+    /**
+     * Gets the number of pairs of collision objects whose bounds overlap in the broadphase.
+     *
+     * Every overlapping pair is tested by the narrowphase in each simulation step.
+     *
+     * @return The number of overlapping pairs.
+     */
+    unsigned int getBroadphasePairCount() const;
+
+    /**
+     * Determines if the physics world steps its simulation on multiple threads.
+     *
+     * A multithreaded world performs the narrowphase collision detection and solves the
+     * constraints of independent simulation islands in parallel, using the workers of the
+     * job controller. It is enabled with the 'multithreaded' property of the 'physics'
+     * namespace of game.config and requires Bullet to be built with BT_THREADSAFE.
+     *
+     * @return True if the world is multithreaded, false otherwise.
+     */
+    bool isMultithreaded() const;
+
     /**
      * Draws debugging information (rigid body outlines, etc.) using the given view projection matrix.
+     *
+     * Only the collision objects whose bounds intersect the view frustum of the matrix are
+     * drawn, and only the triangles of mesh and heightfield shapes that are within the bounds
+     * of the frustum, so that debug drawing stays usable on large levels.
      * 
      * @param viewProjection The view projection matrix to use when drawing.
      */
@@ -341,6 +584,79 @@ public:
      */
     bool sweepTest(PhysicsCollisionObject* object, const Vector3& endPosition, PhysicsController::HitResult* result = NULL, PhysicsController::HitFilter* filter = NULL);
 
+    /**
+     * Performs ray tests on the physics world for a batch of rays.
+     *
+     * Each ray is tested as if by rayTest, and its result is written to the element of
+     * the results array with the same index. Rays that do not hit anything have a result
+     * with a NULL object and a fraction of 1. No memory is allocated for the results, so
+     * the same buffers can be reused every frame.
+     *
+     * When the physics world is multithreaded, the rays are tested in parallel on the
+     * workers of the job controller, in which case the filter is called from several
+     * threads at once and must be safe to use concurrently.
+     *
+     * @param rays The rays to test.
+     * @param distances How far along each ray to test for intersections.
+     * @param count The number of rays.
+     * @param results The array to store the result of each ray test in.
+     * @param filter Optional filter pointer used to control which objects are tested.
+     *
+     * @return The number of rays that collided with a physics object.
+     * @script{ignore}
+     */
+    unsigned int rayTest(const Ray* rays, const float* distances, unsigned int count, PhysicsController::HitResult* results, PhysicsController::HitFilter* filter = NULL);
+
+    /**
+     * Performs sweep tests on the physics world for a batch of collision objects.
+     *
+     * Each object is swept as if by sweepTest, and its result is written to the element
+     * of the results array with the same index. Sweeps that do not hit anything have a
+     * result with a NULL object and a fraction of 1. No memory is allocated for the
+     * results, so the same buffers can be reused every frame.
+     *
+     * When the physics world is multithreaded, the sweeps are tested in parallel on the
+     * workers of the job controller, in which case the filter is called from several
+     * threads at once and must be safe to use concurrently.
+     *
+     * @param objects The collision objects to sweep.
+     * @param endPositions The end position of each sweep test, in world space.
+     * @param count The number of collision objects.
+     * @param results The array to store the result of each sweep test in.
+     * @param filter Optional filter pointer used to control which objects are tested.
+     *
+     * @return The number of objects that intersect any other physics objects.
+     * @script{ignore}
+     */
+    unsigned int sweepTest(PhysicsCollisionObject** objects, const Vector3* endPositions, unsigned int count, PhysicsController::HitResult* results, PhysicsController::HitFilter* filter = NULL);
+
+    /**
+     * Merges the static rigid bodies of the given scene into compound collision objects.
+     *
+     * Levels built from many small static props otherwise add one object per prop to the
+     * broadphase. The static rigid bodies of the scene are grouped by location into cubic
+     * cells, and the bodies of each cell that share the same collision group, mask, friction
+     * and restitution are replaced in the world by a single compound object, whose children
+     * are searched through their own bounding volume hierarchy.
+     *
+     * Batched rigid bodies are still reported as themselves by ray and sweep tests and by
+     * collision events. Bodies that have collision listeners or constraints, heightfields
+     * and bodies that are not enabled are not batched. A batched rigid body is taken out of
+     * its batch when it is disabled, made kinematic or given a collision listener. Changes
+     * to the friction or restitution of a batched rigid body have no effect.
+     *
+     * This can also be done when a scene is loaded with the 'staticBatching' and
+     * 'staticBatchCellSize' properties of the 'physics' namespace of the scene.
+     *
+     * @param scene The scene whose static rigid bodies are merged.
+     * @param cellSize The size of the cells, or zero to merge all of the static rigid bodies
+     *      that share the same properties into one compound object.
+     *
+     * @return The number of rigid bodies that were merged.
+     * @script{ignore}
+     */
+    unsigned int batchStaticObjects(Scene* scene, float cellSize = 0.0f);
+
 private:
 
     /**
@@ -366,8 +682,34 @@ private:
         PhysicsController* _pc;
     };
 
+    /**
+     * Internal class that updates all of the characters as a single stage of each simulation step.
+     */
+    class CharacterAction : public btActionInterface
+    {
+    public:
+        /**
+         * Constructor.
+         *
+         * @param pc The physics controller that owns the action.
+         */
+        CharacterAction(PhysicsController* pc) : _pc(pc) {}
+
+        /**
+         * Internal function used for Bullet integration (do not use or override).
+         */
+        void updateAction(btCollisionWorld* collisionWorld, btScalar deltaTimeStep);
+
+        /**
+         * Internal function used for Bullet integration (do not use or override).
+         */
+        void debugDraw(btIDebugDraw* debugDrawer) {}
+
+    private:
+        PhysicsController* _pc;
+    };
+
     // Internal constants for the collision status cache.
-    static const int DIRTY;
     static const int COLLISION;
     static const int REGISTERED;
     static const int REMOVE;
@@ -375,10 +717,40 @@ private:
     // Represents the collision listeners and status for a given collision pair (used by the collision status cache).
     struct CollisionInfo
     {
-        CollisionInfo() : _status(0) { }
+        CollisionInfo(const PhysicsCollisionObject::CollisionPair& pair) : _pair(pair), _status(0), _generation(0) { }
 
+        PhysicsCollisionObject::CollisionPair _pair;
         std::vector<PhysicsCollisionObject::CollisionListener*> _listeners;
         int _status;
+        // The update in which the pair last collided.
+        unsigned int _generation;
+    };
+
+    // User index of the Bullet rigid bodies of static batches, which have no user pointer.
+    static const int STATIC_BATCH;
+
+    // A compound object that replaces several static rigid bodies in the world.
+    struct StaticBatch
+    {
+        btRigidBody* body;
+        btCompoundShape* shape;
+        // The rigid body of every child shape, in the order of the children.
+        std::vector<PhysicsRigidBody*> objects;
+        Scene* scene;
+        int group;
+        int mask;
+        btScalar friction;
+        btScalar restitution;
+        int cell[3];
+    };
+
+    // Hashes a collision pair independently of the order of its objects.
+    struct CollisionPairHash
+    {
+        size_t operator()(const PhysicsCollisionObject::CollisionPair& pair) const
+        {
+            return std::hash<const void*>()(pair.objectA) + std::hash<const void*>()(pair.objectB);
+        }
     };
 
     /**
@@ -416,6 +788,27 @@ private:
      */
     void update(float elapsedTime);
 
+    // Places the nodes of simulated objects between the states of the last two simulation steps.
+    void interpolate();
+
+    // Freezes the rigid bodies beyond the freeze distance and gathers the activation statistics.
+    void updateActivation();
+
+    // Returns the batched rigid body of the static batch that is closest to the given point, or NULL.
+    PhysicsCollisionObject* getBatchedObject(const btCollisionObject* collisionObject, const btVector3& point) const;
+
+    // Removes the given rigid body from its static batch, and adds it back to the world if requested.
+    void unbatchStaticObject(PhysicsRigidBody* body, bool addToWorld);
+
+    // Returns the index of the collision status cache entry of the given pair, or -1 if there is none.
+    int findCollisionInfo(const PhysicsCollisionObject::CollisionPair& pair) const;
+
+    // Returns the index of the collision status cache entry of the given pair, adding one if there is none.
+    unsigned int getCollisionInfo(const PhysicsCollisionObject::CollisionPair& pair);
+
+    // Removes the collision status cache entries that were marked for removal.
+    void removeCollisionInfos();
+
     // Adds the given collision listener for the two given collision objects.
     void addCollisionListener(PhysicsCollisionObject::CollisionListener* listener, PhysicsCollisionObject* objectA, PhysicsCollisionObject* objectB);
 
@@ -450,6 +843,9 @@ private:
     // Creates a triangle mesh collision shape.
     PhysicsCollisionShape* createMesh(Mesh* mesh, const Vector3& scale, bool dynamic);
 
+    // Returns a new reference to the mesh shape with the given source or content hash, or NULL if there is none.
+    PhysicsCollisionShape* findMeshShape(unsigned long long sourceHash, unsigned long long contentHash);
+
     // Destroys a collision shape created through PhysicsController
     void destroyShape(PhysicsCollisionShape* shape);
 
@@ -489,6 +885,9 @@ private:
         void begin(const Matrix& viewProjection);
         void end();
 
+        // Draws the collision objects of the world that are within the frustum of the view projection matrix.
+        void drawWorld(btCollisionWorld* world, const Matrix& viewProjection);
+
         // Overridden Bullet functions from btIDebugDraw.
         void drawLine(const btVector3& from, const btVector3& to, const btVector3& fromColor, const btVector3& toColor);        
         void drawLine(const btVector3& from, const btVector3& to, const btVector3& color);        
@@ -541,21 +940,50 @@ private:
         int _mode;
         MeshBatch* _meshBatch;
         int _lineCount;
+        // Objects that are hidden from Bullet's debug drawing while drawing a world.
+        std::vector<btCollisionObject*> _hiddenObjects;
     };
 
     bool _isUpdating;
     btDefaultCollisionConfiguration* _collisionConfiguration;
     btCollisionDispatcher* _dispatcher;
     btBroadphaseInterface* _overlappingPairCache;
-    btSequentialImpulseConstraintSolver* _solver;
+    bool _axisSweepBroadphase;
+    btConstraintSolver* _solver;
+    btConstraintSolver* _solverPool;
+    btITaskScheduler* _taskScheduler;
     btDynamicsWorld* _world;
     btGhostPairCallback* _ghostPairCallback;
     std::vector<PhysicsCollisionShape*> _shapes;
+    std::string _shapeCachePath;
+    bool _shapeCache;
+    std::vector<StaticBatch*> _staticBatches;
+    std::vector<PhysicsCharacter*> _characters;
+    CharacterAction* _characterAction;
     DebugDrawer* _debugDrawer;
     Listener::EventType _status;
     std::vector<Listener*>* _listeners;
     Vector3 _gravity;
-    std::map<PhysicsCollisionObject::CollisionPair, CollisionInfo> _collisionStatus;
+    float _fixedTimeStep;
+    unsigned int _maxSubSteps;
+    float _stepTimeBudget;
+    float _timeAccumulator;
+    bool _interpolation;
+    float _interpolationAlpha;
+    unsigned int _stepCount;
+    std::vector<CollisionInfo> _collisionStatus;
+    std::unordered_map<PhysicsCollisionObject::CollisionPair, unsigned int, CollisionPairHash> _collisionIndices;
+    unsigned int _collisionGeneration;
+    bool _collisionRemovals;
+    float _linearSleepingThreshold;
+    float _angularSleepingThreshold;
+    float _freezeDistance;
+    unsigned int _activeBodyCount;
+    unsigned int _sleepingBodyCount;
+    unsigned int _frozenBodyCount;
+    unsigned int _islandCount;
+    unsigned int _largestIslandSize;
+    std::vector<unsigned int> _islandSizes;
     CollisionCallback* _collisionCallback;
 };
 
@@ -11,7 +11,7 @@ namespace gameplay
 {
 
 PhysicsRigidBody::PhysicsRigidBody(Node* node, const PhysicsCollisionShape::Definition& shape, const Parameters& parameters, int group, int mask)
-        : PhysicsCollisionObject(node, group, mask), _body(NULL), _mass(parameters.mass), _constraints(NULL), _inDestructor(false)
+        : PhysicsCollisionObject(node, group, mask), _body(NULL), _mass(parameters.mass), _constraints(NULL), _inDestructor(false), _frozen(false), _batched(false)
 {
     GP_ASSERT(Game::getInstance()->getPhysicsController());
     GP_ASSERT(_node);
@@ -260,6 +260,10 @@ void PhysicsRigidBody::setKinematic(bool kinematic)
 {
     GP_ASSERT(_body);
 
+    // Kinematic bodies move with their nodes, so they can't stay in a static batch.
+    if (kinematic && _batched)
+        Game::getInstance()->getPhysicsController()->unbatchStaticObject(this, true);
+
     if (kinematic)
     {
         _body->setCollisionFlags(_body->getCollisionFlags() | btCollisionObject::CF_KINEMATIC_OBJECT);
@@ -361,6 +365,20 @@ bool PhysicsRigidBody::supportsConstraints()
     return (getShapeType() != PhysicsCollisionShape::SHAPE_HEIGHTFIELD && getShapeType() != PhysicsCollisionShape::SHAPE_MESH);
 }
 
+void PhysicsRigidBody::resetTransformFromNode()
+{
+    GP_ASSERT(_body);
+    GP_ASSERT(_motionState);
+
+    _motionState->updateTransformFromNode();
+    btTransform transform;
+    _motionState->getWorldTransform(transform);
+    _body->setWorldTransform(transform);
+    _body->setInterpolationWorldTransform(transform);
+    _body->clearForces();
+    _body->activate(true);
+}
+
 void PhysicsRigidBody::transformChanged(Transform* transform, long cookie)
 {
     if (getShapeType() == PhysicsCollisionShape::SHAPE_HEIGHTFIELD)
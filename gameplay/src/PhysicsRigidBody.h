@@ -34,6 +34,7 @@ class PhysicsRigidBody : public PhysicsCollisionObject, public Transform::Listen
     friend class PhysicsHingeConstraint;
     friend class PhysicsSocketConstraint;
     friend class PhysicsSpringConstraint;
+    friend class SceneSnapshot;
 
 public:
 
@@ -438,10 +439,17 @@ private:
     // Used for implementing getHeight() when the heightfield has a transform that can change.
     void transformChanged(Transform* transform, long cookie);
 
+    // Moves the body to the transform of its node, such as when a scene snapshot is restored.
+    void resetTransformFromNode();
+
     btRigidBody* _body;
     float _mass;
     std::vector<PhysicsConstraint*>* _constraints;
     bool _inDestructor;
+    // True while the body is deactivated for being beyond the freeze distance.
+    bool _frozen;
+    // True while the body is merged into a static batch of the controller instead of being in the world.
+    bool _batched;
 
 };
 
@@ -0,0 +1,238 @@
+#include "Base.h"
+#include "PlanarReflection.h"
+#include "Scene.h"
+#include "Game.h"
+#include "FrameBuffer.h"
+#include "RenderQueue.h"
+#include "SpatialIndex.h"
+
+namespace gameplay
+{
+
+static unsigned int __planarReflectionCount = 0;
+
+PlanarReflection::PlanarReflection(Node* node)
+    : _node(node), _cameraNode(NULL), _camera(NULL), _frameBuffer(NULL), _sampler(NULL), _queue(NULL), _width(0), _height(0),
+      _clipOffset(0.0f), _updateInterval(1), _drawnFrame(0), _drawn(false), _drawnNodes(0), _clearColor(0.0f, 0.0f, 0.0f, 1.0f)
+{
+    _node->addRef();
+}
+
+PlanarReflection::~PlanarReflection()
+{
+    SAFE_DELETE(_queue);
+    SAFE_RELEASE(_camera);
+    SAFE_RELEASE(_cameraNode);
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_frameBuffer);
+    SAFE_RELEASE(_node);
+}
+
+PlanarReflection* PlanarReflection::create(Node* node, unsigned int width, unsigned int height)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(width > 0 && height > 0);
+
+    char id[32];
+    sprintf(id, "reflection%u", __planarReflectionCount++);
+    FrameBuffer* frameBuffer = FrameBuffer::create(id, width, height);
+    if (!frameBuffer)
+    {
+        GP_WARN("Failed to create the frame buffer for a reflection of %ux%u texels.", width, height);
+        return NULL;
+    }
+    DepthStencilTarget* depthTarget = DepthStencilTarget::create(id, DepthStencilTarget::DEPTH, width, height);
+    frameBuffer->setDepthStencilTarget(depthTarget);
+    SAFE_RELEASE(depthTarget);
+
+    PlanarReflection* reflection = new PlanarReflection(node);
+    reflection->_frameBuffer = frameBuffer;
+    reflection->_width = width;
+    reflection->_height = height;
+    reflection->_sampler = Texture::Sampler::create(frameBuffer->getRenderTarget(0)->getTexture());
+    reflection->_sampler->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+    reflection->_sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+
+    // The projection of the camera is replaced by every update.
+    reflection->_cameraNode = Node::create(id);
+    reflection->_camera = Camera::createPerspective(45.0f, (float)width / (float)height, 0.1f, 100.0f);
+    reflection->_cameraNode->setCamera(reflection->_camera);
+    reflection->_queue = RenderQueue::create();
+    return reflection;
+}
+
+Node* PlanarReflection::getNode() const
+{
+    return _node;
+}
+
+void PlanarReflection::setClipOffset(float offset)
+{
+    _clipOffset = offset;
+}
+
+float PlanarReflection::getClipOffset() const
+{
+    return _clipOffset;
+}
+
+void PlanarReflection::setUpdateInterval(unsigned int frames)
+{
+    _updateInterval = std::max(frames, 1u);
+}
+
+unsigned int PlanarReflection::getUpdateInterval() const
+{
+    return _updateInterval;
+}
+
+void PlanarReflection::setClearColor(const Vector4& color)
+{
+    _clearColor = color;
+}
+
+bool PlanarReflection::update(Camera* camera)
+{
+    GP_PROFILE("PlanarReflection::update");
+
+    Scene* scene = _node->getScene();
+    if (!camera && scene)
+        camera = scene->getActiveCamera();
+    if (!scene || !camera || !camera->getNode())
+        return false;
+
+    unsigned int frameIndex = Game::getInstance()->getFrameIndex();
+    if (_drawn && frameIndex - _drawnFrame < _updateInterval)
+        return false;
+
+    Vector3 normal = _node->getUpVectorWorld();
+    normal.normalize();
+    _plane.set(normal, -Vector3::dot(normal, _node->getTranslationWorld()));
+    if (_plane.distance(camera->getNode()->getTranslationWorld()) <= 0.0f)
+        return false;
+
+    computeCamera(camera);
+
+    // The oblique near plane of the frustum culls every node that is behind the plane.
+    _nodes.clear();
+    SpatialIndex* spatialIndex = scene->getSpatialIndex();
+    if (spatialIndex)
+    {
+        spatialIndex->findNodes(_camera->getFrustum(), _nodes);
+        size_t count = 0;
+        for (size_t i = 0, nodeCount = _nodes.size(); i < nodeCount; ++i)
+        {
+            Node* node = _nodes[i];
+            if (node != _node && node->isReflected() && node->getDrawable() && node->isEnabledInHierarchy())
+                _nodes[count++] = node;
+        }
+        _nodes.resize(count);
+    }
+    else
+    {
+        scene->visit(this, &PlanarReflection::gatherNode);
+    }
+
+    _queue->clear();
+    _queue->setCamera(_camera);
+    Rectangle viewport((float)_width, (float)_height);
+    _queue->setViews(&_camera, &viewport, 1);
+    for (size_t i = 0, count = _nodes.size(); i < count; ++i)
+        _queue->add(_nodes[i]);
+
+    FrameBuffer* previous = _frameBuffer->bind();
+    Game::getInstance()->clear(Game::CLEAR_COLOR_DEPTH, _clearColor, 1.0f, 0);
+    _queue->draw();
+    previous->bind();
+    _queue->clear();
+
+    _drawnNodes = (unsigned int)_nodes.size();
+    _drawnFrame = frameIndex;
+    _drawn = true;
+    return true;
+}
+
+void PlanarReflection::computeCamera(Camera* camera)
+{
+    // The position and the basis of the camera are mirrored in the plane. Building the view
+    // from the mirrored forward and up vectors keeps it a rotation, so that the winding of
+    // triangles doesn't change. The image is flipped in the texture instead, which sampling
+    // it through the view projection matrix of the reflection undoes.
+    const Vector3& normal = _plane.getNormal();
+    Node* node = camera->getNode();
+    Vector3 eye = node->getTranslationWorld();
+    Vector3 forward = node->getForwardVectorWorld();
+    Vector3 up = node->getUpVectorWorld();
+    eye -= normal * (2.0f * _plane.distance(eye));
+    forward -= normal * (2.0f * Vector3::dot(normal, forward));
+    up -= normal * (2.0f * Vector3::dot(normal, up));
+
+    Matrix view;
+    Matrix::createLookAt(eye, eye + forward, up, &view);
+    Matrix world;
+    view.invert(&world);
+    Vector3 scale;
+    Quaternion rotation;
+    Vector3 translation;
+    world.decompose(&scale, &rotation, &translation);
+    _cameraNode->set(Vector3::one(), rotation, translation);
+
+    // The near plane of the projection is replaced by the clipping plane, in the view space
+    // of the reflection camera, so that the depth range stays the same everywhere else
+    // (Lengyel, "Oblique View Frustum Depth Projection and Clipping"). This only works when
+    // the camera is behind the clipping plane, which a large clip offset can prevent.
+    Vector3 viewNormal;
+    view.transformVector(normal, &viewNormal);
+    Vector3 viewPoint;
+    view.transformPoint(normal * -(_plane.getDistance() + _clipOffset), &viewPoint);
+    Vector4 clip(viewNormal.x, viewNormal.y, viewNormal.z, -Vector3::dot(viewNormal, viewPoint));
+
+    Matrix projection = camera->getProjectionMatrix();
+    Matrix inverse;
+    if (clip.w < 0.0f && projection.invert(&inverse))
+    {
+        // The corner of the view volume opposite the clipping plane becomes the far corner.
+        Vector4 corner(clip.x > 0.0f ? 1.0f : (clip.x < 0.0f ? -1.0f : 0.0f), clip.y > 0.0f ? 1.0f : (clip.y < 0.0f ? -1.0f : 0.0f), 1.0f, 1.0f);
+        Vector4 q;
+        inverse.transformVector(corner, &q);
+        Vector4 c = clip * (2.0f / Vector4::dot(clip, q));
+        projection.m[2] = c.x - projection.m[3];
+        projection.m[6] = c.y - projection.m[7];
+        projection.m[10] = c.z - projection.m[11];
+        projection.m[14] = c.w - projection.m[15];
+    }
+    _camera->setProjectionMatrix(projection);
+    _viewProjection = _camera->getViewProjectionMatrix();
+}
+
+bool PlanarReflection::gatherNode(Node* node)
+{
+    if (!node->isEnabled())
+        return false;
+
+    if (node != _node && node->isReflected() && node->getDrawable() && _camera->getFrustum().intersects(node->getBoundingSphere()))
+        _nodes.push_back(node);
+    return true;
+}
+
+unsigned int PlanarReflection::getDrawnNodeCount() const
+{
+    return _drawnNodes;
+}
+
+Texture::Sampler* PlanarReflection::getSampler() const
+{
+    return _sampler;
+}
+
+const Matrix& PlanarReflection::getViewProjectionMatrix() const
+{
+    return _viewProjection;
+}
+
+const Plane& PlanarReflection::getPlane() const
+{
+    return _plane;
+}
+
+}
@@ -0,0 +1,196 @@
+#ifndef PLANARREFLECTION_H_
+#define PLANARREFLECTION_H_
+
+#include "Texture.h"
+#include "Matrix.h"
+#include "Vector4.h"
+#include "Plane.h"
+
+namespace gameplay
+{
+
+class Node;
+class Camera;
+class FrameBuffer;
+class RenderQueue;
+
+/**
+ * Defines the reflection of a scene in a plane, such as the surface of water or a mirror.
+ *
+ * The plane goes through the origin of a node, facing along its up vector, and the scene
+ * is drawn into a texture from a camera that mirrors the camera of the scene in it. The
+ * projection of the reflection camera is given an oblique near plane that matches the
+ * reflecting plane, so that the geometry behind the plane is clipped by the hardware
+ * without any clip plane in the shaders.
+ *
+ * Reflections cost less than drawing the scene again at full size and rate:
+ *
+ * - The texture is usually smaller than the screen, since reflections are distorted and
+ *   blurred by the surfaces that show them.
+ * - The texture can be drawn every few frames instead of every frame.
+ * - The nodes that are drawn are culled against the frustum of the reflection camera,
+ *   found through the spatial index of the scene when it is enabled, so that the geometry
+ *   behind the plane is never drawn. Nodes whose reflected flag is cleared are skipped,
+ *   as is the node of the plane itself.
+ *
+ * Materials of the reflecting surface project their world positions with the matrix
+ * returned by getViewProjectionMatrix to sample the texture.
+ *
+ * @see Node::setReflected
+ * @script{ignore}
+ */
+class PlanarReflection
+{
+public:
+
+    /**
+     * Creates a reflection in the plane of a node.
+     *
+     * @param node The node whose origin and up vector define the plane, which is not drawn into the reflection.
+     * @param width The width of the reflection texture.
+     * @param height The height of the reflection texture.
+     *
+     * @return The new reflection, or NULL if its frame buffer could not be created.
+     */
+    static PlanarReflection* create(Node* node, unsigned int width, unsigned int height);
+
+    /**
+     * Destructor.
+     */
+    ~PlanarReflection();
+
+    /**
+     * Returns the node whose plane reflects the scene.
+     *
+     * @return The node of the plane.
+     */
+    Node* getNode() const;
+
+    /**
+     * Sets the distance that the clipping plane is moved behind the reflecting plane, so that
+     * the geometry that meets the plane doesn't leave a gap at the edges of surfaces that
+     * are displaced, such as waves.
+     *
+     * @param offset The clip offset, in world units.
+     */
+    void setClipOffset(float offset);
+
+    /**
+     * Returns the distance that the clipping plane is moved behind the reflecting plane.
+     *
+     * @return The clip offset, in world units.
+     */
+    float getClipOffset() const;
+
+    /**
+     * Sets the number of frames between two draws of the reflection.
+     *
+     * @param frames The update interval, where 1 draws the reflection every frame.
+     */
+    void setUpdateInterval(unsigned int frames);
+
+    /**
+     * Returns the number of frames between two draws of the reflection.
+     *
+     * @return The update interval.
+     */
+    unsigned int getUpdateInterval() const;
+
+    /**
+     * Sets the color that the reflection texture is cleared to.
+     *
+     * @param color The clear color.
+     */
+    void setClearColor(const Vector4& color);
+
+    /**
+     * Mirrors the given camera in the plane and draws the reflection if it is due. This
+     * should be called once per frame, after the scene and its camera have moved and
+     * before the reflecting surface is drawn.
+     *
+     * Nothing is drawn while the camera is behind the plane.
+     *
+     * @param camera The camera to reflect, or NULL to use the active camera of the scene.
+     *
+     * @return true if the reflection was drawn.
+     */
+    bool update(Camera* camera = NULL);
+
+    /**
+     * Returns the number of nodes that were drawn by the last draw of the reflection.
+     *
+     * @return The number of nodes drawn.
+     */
+    unsigned int getDrawnNodeCount() const;
+
+    /**
+     * Returns the sampler of the texture that the reflection is drawn into.
+     *
+     * @return The sampler of the reflection texture.
+     */
+    Texture::Sampler* getSampler() const;
+
+    /**
+     * Returns the view projection matrix of the reflection camera of the last draw, which
+     * transforms world positions to the clip space of the reflection texture.
+     *
+     * @return The view projection matrix of the reflection.
+     */
+    const Matrix& getViewProjectionMatrix() const;
+
+    /**
+     * Returns the reflecting plane of the last update, in world space.
+     *
+     * @return The reflecting plane.
+     */
+    const Plane& getPlane() const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    PlanarReflection(Node* node);
+
+    /**
+     * Hidden copy constructor.
+     */
+    PlanarReflection(const PlanarReflection& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    PlanarReflection& operator=(const PlanarReflection&);
+
+    /**
+     * Places the reflection camera at the mirror image of a camera and gives it an oblique projection.
+     */
+    void computeCamera(Camera* camera);
+
+    /**
+     * Adds the node to the nodes to draw if it has a drawable that is in the reflection.
+     */
+    bool gatherNode(Node* node);
+
+    Node* _node;
+    Node* _cameraNode;
+    Camera* _camera;
+    FrameBuffer* _frameBuffer;
+    Texture::Sampler* _sampler;
+    RenderQueue* _queue;
+    unsigned int _width;
+    unsigned int _height;
+    float _clipOffset;
+    unsigned int _updateInterval;
+    unsigned int _drawnFrame;
+    bool _drawn;
+    unsigned int _drawnNodes;
+    Vector4 _clearColor;
+    Plane _plane;
+    Matrix _viewProjection;
+    std::vector<Node*> _nodes;
+};
+
+}
+
+#endif
@@ -4,20 +4,48 @@
 #include "Game.h"
 #include "ScriptController.h"
 #include "Form.h"
+#include "InputQueue.h"
+#include "InputRecorder.h"
 
 namespace gameplay
 {
 
-void Platform::touchEventInternal(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse)
+void Platform::dispatchTouch(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse)
 {
+    if (InputQueue::queueTouch(evt, x, y, contactIndex, actuallyMouse))
+        return;
+
     if (actuallyMouse || !Form::touchEventInternal(evt, x, y, contactIndex))
     {
         Game::getInstance()->touchEventInternal(evt, x, y, contactIndex);
     }
 }
 
+bool Platform::dispatchMouse(Mouse::MouseEvent evt, int x, int y, int wheelDelta)
+{
+    // The caller needs to know whether the event is consumed, so it is dispatched right away.
+    InputQueue::dispatch();
+
+    if (Form::mouseEventInternal(evt, x, y, wheelDelta))
+        return true;
+
+    return Game::getInstance()->mouseEventInternal(evt, x, y, wheelDelta);
+}
+
+void Platform::touchEventInternal(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse)
+{
+    if (InputRecorder::captureTouch(evt, x, y, contactIndex, actuallyMouse))
+        dispatchTouch(evt, x, y, contactIndex, actuallyMouse);
+}
+
 void Platform::keyEventInternal(Keyboard::KeyEvent evt, int key)
 {
+    if (!InputRecorder::captureKey(evt, key))
+        return;
+
+    if (InputQueue::queueKey(evt, key))
+        return;
+
     if (!Form::keyEventInternal(evt, key))
     {
         Game::getInstance()->keyEventInternal(evt, key);
@@ -26,39 +54,95 @@ void Platform::keyEventInternal(Keyboard::KeyEvent evt, int key)
 
 bool Platform::mouseEventInternal(Mouse::MouseEvent evt, int x, int y, int wheelDelta)
 {
-    if (Form::mouseEventInternal(evt, x, y, wheelDelta))
+    // Events ignored by a replay are consumed, so that the platform doesn't turn them into touches.
+    if (!InputRecorder::captureMouse(evt, x, y, wheelDelta))
         return true;
 
-    return Game::getInstance()->mouseEventInternal(evt, x, y, wheelDelta);
+    return dispatchMouse(evt, x, y, wheelDelta);
+}
+
+void Platform::pointerEventInternal(Mouse::MouseEvent evt, int x, int y, int wheelDelta, bool touchFallback)
+{
+    if (!InputRecorder::capturePointer(evt, x, y, wheelDelta, touchFallback))
+        return;
+
+    if (InputQueue::queueMouse(evt, x, y, wheelDelta, touchFallback))
+        return;
+
+    if (dispatchMouse(evt, x, y, wheelDelta) || !touchFallback)
+        return;
+
+    switch (evt)
+    {
+    case Mouse::MOUSE_PRESS_LEFT_BUTTON:
+    case Mouse::MOUSE_PRESS_MIDDLE_BUTTON:
+    case Mouse::MOUSE_PRESS_RIGHT_BUTTON:
+        dispatchTouch(Touch::TOUCH_PRESS, x, y, 0, true);
+        break;
+    case Mouse::MOUSE_RELEASE_LEFT_BUTTON:
+    case Mouse::MOUSE_RELEASE_MIDDLE_BUTTON:
+    case Mouse::MOUSE_RELEASE_RIGHT_BUTTON:
+        dispatchTouch(Touch::TOUCH_RELEASE, x, y, 0, true);
+        break;
+    case Mouse::MOUSE_MOVE:
+        dispatchTouch(Touch::TOUCH_MOVE, x, y, 0, true);
+        break;
+    default:
+        break;
+    }
 }
 
 void Platform::gestureSwipeEventInternal(int x, int y, int direction)
 {
+    if (!InputRecorder::captureGesture(InputRecorder::GESTURE_SWIPE, x, y, direction, 0.0f))
+        return;
+
+    InputQueue::dispatch();
     Game::getInstance()->gestureSwipeEventInternal(x, y, direction);
 }
 
 void Platform::gesturePinchEventInternal(int x, int y, float scale)
 {
+    if (!InputRecorder::captureGesture(InputRecorder::GESTURE_PINCH, x, y, 0, scale))
+        return;
+
+    InputQueue::dispatch();
     Game::getInstance()->gesturePinchEventInternal(x, y, scale);
 }
 
 void Platform::gestureTapEventInternal(int x, int y)
 {
+    if (!InputRecorder::captureGesture(InputRecorder::GESTURE_TAP, x, y, 0, 0.0f))
+        return;
+
+    InputQueue::dispatch();
     Game::getInstance()->gestureTapEventInternal(x, y);
 }
 
 void Platform::gestureLongTapEventInternal(int x, int y, float duration)
 {
+    if (!InputRecorder::captureGesture(InputRecorder::GESTURE_LONG_TAP, x, y, 0, duration))
+        return;
+
+    InputQueue::dispatch();
     Game::getInstance()->gestureLongTapEventInternal(x, y, duration);
 }
 
 void Platform::gestureDragEventInternal(int x, int y)
 {
+    if (!InputRecorder::captureGesture(InputRecorder::GESTURE_DRAG, x, y, 0, 0.0f))
+        return;
+
+    InputQueue::dispatch();
     Game::getInstance()->gestureDragEventInternal(x, y);
 }
 
 void Platform::gestureDropEventInternal(int x, int y)
 {
+    if (!InputRecorder::captureGesture(InputRecorder::GESTURE_DROP, x, y, 0, 0.0f))
+        return;
+
+    InputQueue::dispatch();
     Game::getInstance()->gestureDropEventInternal(x, y);
 }
 
@@ -80,6 +164,9 @@ void Platform::gamepadEventDisconnectedInternal(GamepadHandle handle)
 
 void Platform::gamepadButtonPressedEventInternal(GamepadHandle handle, Gamepad::ButtonMapping mapping)
 {
+    if (!InputRecorder::captureGamepad())
+        return;
+
     Gamepad* gamepad = Gamepad::getGamepad(handle);
     if (gamepad)
     {
@@ -91,6 +178,9 @@ void Platform::gamepadButtonPressedEventInternal(GamepadHandle handle, Gamepad::
 
 void Platform::gamepadButtonReleasedEventInternal(GamepadHandle handle, Gamepad::ButtonMapping mapping)
 {
+    if (!InputRecorder::captureGamepad())
+        return;
+
     Gamepad* gamepad = Gamepad::getGamepad(handle);
     if (gamepad)
     {
@@ -102,6 +192,9 @@ void Platform::gamepadButtonReleasedEventInternal(GamepadHandle handle, Gamepad:
 
 void Platform::gamepadTriggerChangedEventInternal(GamepadHandle handle, unsigned int index, float value)
 {
+    if (!InputRecorder::captureGamepad())
+        return;
+
     Gamepad* gamepad = Gamepad::getGamepad(handle);
     if (gamepad)
     {
@@ -112,6 +205,9 @@ void Platform::gamepadTriggerChangedEventInternal(GamepadHandle handle, unsigned
 
 void Platform::gamepadJoystickChangedEventInternal(GamepadHandle handle, unsigned int index, float x, float y)
 {
+    if (!InputRecorder::captureGamepad())
+        return;
+
     Gamepad* gamepad = Gamepad::getGamepad(handle);
     if (gamepad)
     {
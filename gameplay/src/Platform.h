@@ -316,6 +316,17 @@ public:
      */
     static bool mouseEventInternal(Mouse::MouseEvent evt, int x, int y, int wheelDelta);
 
+    /**
+     * Internal method used only from static code in various platform implementation.
+     *
+     * Dispatches a mouse event, followed by a touch event of the first contact if the mouse
+     * event is not consumed and touchFallback is set. Unlike mouseEventInternal, the event
+     * is queued while input is buffered.
+     *
+     * @script{ignore}
+     */
+    static void pointerEventInternal(Mouse::MouseEvent evt, int x, int y, int wheelDelta, bool touchFallback);
+
     /**
      * Internal method used only from static code in various platform implementation.
      *
@@ -441,6 +452,16 @@ public:
 
 private:
 
+    /**
+     * Dispatches a touch event without recording it, such as one derived from a pointer event.
+     */
+    static void dispatchTouch(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex, bool actuallyMouse);
+
+    /**
+     * Dispatches a mouse event without recording it, such as one derived from a pointer event.
+     */
+    static bool dispatchMouse(Mouse::MouseEvent evt, int x, int y, int wheelDelta);
+
     Game* _game;                // The game this platform is interfacing with.
 };
 
@@ -1,4 +1,4 @@
-#ifndef GP_NO_PLATFORM
+#if !defined(GP_NO_PLATFORM) && !defined(GP_HEADLESS)
 #ifdef __ANDROID__
 
 #include "Base.h"
@@ -55,6 +55,33 @@ PFNGLISVERTEXARRAYOESPROC glIsVertexArray = NULL;
 PFNGLMAPBUFFEROESPROC glMapBuffer = NULL;
 PFNGLUNMAPBUFFEROESPROC glUnmapBuffer = NULL;
 
+// OpenGL instancing functions.
+PFNGLDRAWARRAYSINSTANCEDEXTPROC glDrawArraysInstanced = NULL;
+PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstanced = NULL;
+PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisor = NULL;
+
+// OpenGL program binary functions.
+PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinary = NULL;
+PFNGLPROGRAMBINARYOESPROC glProgramBinary = NULL;
+
+// OpenGL frame buffer discard functions.
+PFNGLDISCARDFRAMEBUFFEREXTPROC glDiscardFramebuffer = NULL;
+
+// OpenGL timer query functions.
+#ifdef GL_EXT_disjoint_timer_query
+PFNGLGENQUERIESEXTPROC glGenQueries = NULL;
+PFNGLDELETEQUERIESEXTPROC glDeleteQueries = NULL;
+PFNGLBEGINQUERYEXTPROC glBeginQuery = NULL;
+PFNGLENDQUERYEXTPROC glEndQuery = NULL;
+PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuiv = NULL;
+PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64v = NULL;
+#endif
+
+// OpenGL parallel shader compile functions.
+#ifdef GL_KHR_parallel_shader_compile
+PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR = NULL;
+#endif
+
 #define GESTURE_TAP_DURATION_MAX			200
 #define GESTURE_LONG_TAP_DURATION_MIN   	GESTURE_TAP_DURATION_MAX
 #define GESTURE_DRAG_START_DURATION_MIN		GESTURE_LONG_TAP_DURATION_MIN
@@ -334,6 +361,43 @@ static bool initEGL()
         glMapBuffer = (PFNGLMAPBUFFEROESPROC)eglGetProcAddress("glMapBufferOES");
         glUnmapBuffer = (PFNGLUNMAPBUFFEROESPROC)eglGetProcAddress("glUnmapBufferOES");
     }
+
+    if (strstr(__glExtensions, "GL_EXT_instanced_arrays"))
+    {
+        glDrawArraysInstanced = (PFNGLDRAWARRAYSINSTANCEDEXTPROC)eglGetProcAddress("glDrawArraysInstancedEXT");
+        glDrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDEXTPROC)eglGetProcAddress("glDrawElementsInstancedEXT");
+        glVertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISOREXTPROC)eglGetProcAddress("glVertexAttribDivisorEXT");
+    }
+
+    if (strstr(__glExtensions, "GL_OES_get_program_binary"))
+    {
+        glGetProgramBinary = (PFNGLGETPROGRAMBINARYOESPROC)eglGetProcAddress("glGetProgramBinaryOES");
+        glProgramBinary = (PFNGLPROGRAMBINARYOESPROC)eglGetProcAddress("glProgramBinaryOES");
+    }
+
+    if (strstr(__glExtensions, "GL_EXT_discard_framebuffer"))
+    {
+        glDiscardFramebuffer = (PFNGLDISCARDFRAMEBUFFEREXTPROC)eglGetProcAddress("glDiscardFramebufferEXT");
+    }
+
+#ifdef GL_EXT_disjoint_timer_query
+    if (strstr(__glExtensions, "GL_EXT_disjoint_timer_query"))
+    {
+        glGenQueries = (PFNGLGENQUERIESEXTPROC)eglGetProcAddress("glGenQueriesEXT");
+        glDeleteQueries = (PFNGLDELETEQUERIESEXTPROC)eglGetProcAddress("glDeleteQueriesEXT");
+        glBeginQuery = (PFNGLBEGINQUERYEXTPROC)eglGetProcAddress("glBeginQueryEXT");
+        glEndQuery = (PFNGLENDQUERYEXTPROC)eglGetProcAddress("glEndQueryEXT");
+        glGetQueryObjectuiv = (PFNGLGETQUERYOBJECTUIVEXTPROC)eglGetProcAddress("glGetQueryObjectuivEXT");
+        glGetQueryObjectui64v = (PFNGLGETQUERYOBJECTUI64VEXTPROC)eglGetProcAddress("glGetQueryObjectui64vEXT");
+    }
+#endif
+
+#ifdef GL_KHR_parallel_shader_compile
+    if (strstr(__glExtensions, "GL_KHR_parallel_shader_compile"))
+    {
+        glMaxShaderCompilerThreadsKHR = (PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)eglGetProcAddress("glMaxShaderCompilerThreadsKHR");
+    }
+#endif
     
     return true;
     
@@ -1366,7 +1430,7 @@ int Platform::enterMessagePump()
     __sensorEventQueue = ASensorManager_createEventQueue(__sensorManager, __state->looper, LOOPER_ID_USER, NULL, NULL);
     
     // Get the initial time.
-    clock_gettime(CLOCK_REALTIME, &__timespec);
+    clock_gettime(CLOCK_MONOTONIC, &__timespec);
     __timeStart = timespec2millis(&__timespec);
     __timeAbsolute = 0L;
     
@@ -1376,7 +1440,12 @@ int Platform::enterMessagePump()
         int ident;
         int events;
         struct android_poll_source* source;
-        
+
+        // Paced frames wait for their time before the events are read, so that the frame
+        // handles the most recent input.
+        if (__initialized && !__suspended)
+            _game->waitForFrame();
+
         while ((ident=ALooper_pollAll(!__suspended ? 0 : -1, NULL, &events, (void**)&source)) >= 0) 
         {
             // Process this event.
@@ -1475,7 +1544,7 @@ unsigned int Platform::getDisplayHeight()
     
 double Platform::getAbsoluteTime()
 {
-    clock_gettime(CLOCK_REALTIME, &__timespec);
+    clock_gettime(CLOCK_MONOTONIC, &__timespec);
     double now = timespec2millis(&__timespec);
     __timeAbsolute = now - __timeStart;
 
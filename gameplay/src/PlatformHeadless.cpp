@@ -0,0 +1,289 @@
+#ifndef GP_NO_PLATFORM
+#ifdef GP_HEADLESS
+
+#include "Base.h"
+#include "Platform.h"
+#include "FileSystem.h"
+#include "Game.h"
+#include <csignal>
+#ifndef WIN32
+#include <strings.h>
+#endif
+
+// The rate that the game is updated at when the game sets no target frame rate.
+#define HEADLESS_DEFAULT_FRAME_RATE 60
+
+int __headlessArgc = 0;
+char** __headlessArgv = NULL;
+
+static unsigned int __width = 1280;
+static unsigned int __height = 800;
+static std::chrono::steady_clock::time_point __timeStart;
+static double __timeAbsolute;
+static volatile std::sig_atomic_t __quitRequested = 0;
+
+static void quitHandler(int signal)
+{
+    __quitRequested = 1;
+}
+
+namespace gameplay
+{
+
+extern void print(const char* format, ...)
+{
+    GP_ASSERT(format);
+    va_list argptr;
+    va_start(argptr, format);
+    vfprintf(stderr, format, argptr);
+    va_end(argptr);
+}
+
+extern int strcmpnocase(const char* s1, const char* s2)
+{
+#ifdef WIN32
+    return _strcmpi(s1, s2);
+#else
+    return strcasecmp(s1, s2);
+#endif
+}
+
+Platform::Platform(Game* game) : _game(game)
+{
+}
+
+Platform::~Platform()
+{
+}
+
+Platform* Platform::create(Game* game)
+{
+    GP_ASSERT(game);
+
+    FileSystem::setResourcePath("./");
+    Platform* platform = new Platform(game);
+
+    // There is no window, but the size of the window in the game config is still reported as the
+    // size of the display, which games use for their viewports and the aspect ratio of cameras.
+    if (game->getConfig())
+    {
+        Properties* config = game->getConfig()->getNamespace("window", true);
+        if (config)
+        {
+            int width = config->getInt("width");
+            int height = config->getInt("height");
+            if (width > 0) __width = (unsigned int)width;
+            if (height > 0) __height = (unsigned int)height;
+        }
+    }
+
+    // Shut down cleanly when the process is asked to stop.
+    std::signal(SIGINT, quitHandler);
+    std::signal(SIGTERM, quitHandler);
+
+    return platform;
+}
+
+int Platform::enterMessagePump()
+{
+    GP_ASSERT(_game);
+
+    __timeStart = std::chrono::steady_clock::now();
+    __timeAbsolute = 0.0;
+
+    if (_game->getState() != Game::RUNNING)
+        _game->run();
+
+    // Without a display to synchronize with, frames are paced to a fixed rate.
+    if (_game->getTargetFrameRate() == 0)
+        _game->setTargetFrameRate(HEADLESS_DEFAULT_FRAME_RATE);
+
+    while (_game->getState() != Game::UNINITIALIZED)
+    {
+        if (__quitRequested)
+        {
+            shutdownInternal();
+            break;
+        }
+
+        _game->waitForFrame();
+        _game->frame();
+    }
+
+    return 0;
+}
+
+void Platform::signalShutdown()
+{
+}
+
+bool Platform::canExit()
+{
+    return true;
+}
+
+unsigned int Platform::getDisplayWidth()
+{
+    return __width;
+}
+
+unsigned int Platform::getDisplayHeight()
+{
+    return __height;
+}
+
+double Platform::getAbsoluteTime()
+{
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - __timeStart;
+    __timeAbsolute = elapsed.count();
+
+    return __timeAbsolute;
+}
+
+void Platform::setAbsoluteTime(double time)
+{
+    __timeAbsolute = time;
+}
+
+bool Platform::isVsync()
+{
+    return false;
+}
+
+void Platform::setVsync(bool enable)
+{
+}
+
+void Platform::swapBuffers()
+{
+}
+
+void Platform::sleep(long ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void Platform::setMultiSampling(bool enabled)
+{
+}
+
+bool Platform::isMultiSampling()
+{
+    return false;
+}
+
+void Platform::setMultiTouch(bool enabled)
+{
+}
+
+bool Platform::isMultiTouch()
+{
+    return false;
+}
+
+bool Platform::hasMouse()
+{
+    return false;
+}
+
+void Platform::setMouseCaptured(bool captured)
+{
+}
+
+bool Platform::isMouseCaptured()
+{
+    return false;
+}
+
+void Platform::setCursorVisible(bool visible)
+{
+}
+
+bool Platform::isCursorVisible()
+{
+    return false;
+}
+
+bool Platform::hasAccelerometer()
+{
+    return false;
+}
+
+void Platform::getAccelerometerValues(float* pitch, float* roll)
+{
+    GP_ASSERT(pitch);
+    GP_ASSERT(roll);
+
+    *pitch = 0;
+    *roll = 0;
+}
+
+void Platform::getSensorValues(float* accelX, float* accelY, float* accelZ, float* gyroX, float* gyroY, float* gyroZ)
+{
+    if (accelX)
+        *accelX = 0;
+    if (accelY)
+        *accelY = 0;
+    if (accelZ)
+        *accelZ = 0;
+    if (gyroX)
+        *gyroX = 0;
+    if (gyroY)
+        *gyroY = 0;
+    if (gyroZ)
+        *gyroZ = 0;
+}
+
+void Platform::getArguments(int* argc, char*** argv)
+{
+    if (argc)
+        *argc = __headlessArgc;
+    if (argv)
+        *argv = __headlessArgv;
+}
+
+void Platform::displayKeyboard(bool display)
+{
+}
+
+void Platform::shutdownInternal()
+{
+    Game::getInstance()->shutdown();
+}
+
+bool Platform::isGestureSupported(Gesture::GestureEvent evt)
+{
+    return false;
+}
+
+void Platform::registerGesture(Gesture::GestureEvent evt)
+{
+}
+
+void Platform::unregisterGesture(Gesture::GestureEvent evt)
+{
+}
+
+bool Platform::isGestureRegistered(Gesture::GestureEvent evt)
+{
+    return false;
+}
+
+void Platform::pollGamepadState(Gamepad* gamepad)
+{
+}
+
+bool Platform::launchURL(const char* url)
+{
+    return false;
+}
+
+std::string Platform::displayFileDialog(size_t mode, const char* title, const char* filterDescription, const char* filterExtensions, const char* initialDirectory)
+{
+    return "";
+}
+
+}
+
+#endif
+#endif
@@ -1,4 +1,4 @@
-#ifndef GP_NO_PLATFORM
+#if !defined(GP_NO_PLATFORM) && !defined(GP_HEADLESS)
 #ifdef __linux__
 
 #include "Base.h"
@@ -1129,7 +1129,7 @@ int Platform::enterMessagePump()
     static XEvent evt;
 
     // Get the initial time.
-    clock_gettime(CLOCK_REALTIME, &__timespec);
+    clock_gettime(CLOCK_MONOTONIC, &__timespec);
     __timeStart = timespec2millis(&__timespec);
     __timeAbsolute = 0L;
 
@@ -1146,7 +1146,12 @@ int Platform::enterMessagePump()
     // Message loop.
     while (true)
     {
-        poll( xpolls, 1, 16 );
+        // Paced frames wait for their time before the events are read, so that the frame
+        // handles the most recent input.
+        if (_game && _game->getTargetFrameRate() > 0)
+            _game->waitForFrame();
+        else
+            poll( xpolls, 1, 16 );
         // handle all pending events in one block
         while (XPending(__display))
         {
@@ -1246,10 +1251,7 @@ int Platform::enterMessagePump()
                             else if (evt.xbutton.button == 3)
                                 mouseEvt = gameplay::Mouse::MOUSE_PRESS_RIGHT_BUTTON;
 
-                            if (!gameplay::Platform::mouseEventInternal(mouseEvt, evt.xbutton.x, evt.xbutton.y, 0))
-                            {
-                                gameplay::Platform::touchEventInternal(gameplay::Touch::TOUCH_PRESS, evt.xbutton.x, evt.xbutton.y, 0, true);
-                            }
+                            gameplay::Platform::pointerEventInternal(mouseEvt, evt.xbutton.x, evt.xbutton.y, 0, true);
                         }
                         else if (evt.xbutton.button >= 4 && evt.xbutton.button <= 5)
                         {
@@ -1261,7 +1263,7 @@ int Platform::enterMessagePump()
                             else
                                 wheelDelta = 0;
 
-                            gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_WHEEL, evt.xbutton.x, evt.xbutton.y, wheelDelta);
+                            gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_WHEEL, evt.xbutton.x, evt.xbutton.y, wheelDelta, false);
                         }
                     }
                     break;
@@ -1279,10 +1281,7 @@ int Platform::enterMessagePump()
                             else if (evt.xbutton.button == 3)
                                 mouseEvt = gameplay::Mouse::MOUSE_RELEASE_RIGHT_BUTTON;
 
-                            if (!gameplay::Platform::mouseEventInternal(mouseEvt, evt.xbutton.x, evt.xbutton.y, 0))
-                            {
-                                gameplay::Platform::touchEventInternal(gameplay::Touch::TOUCH_RELEASE, evt.xbutton.x, evt.xbutton.y, 0, true);
-                            }
+                            gameplay::Platform::pointerEventInternal(mouseEvt, evt.xbutton.x, evt.xbutton.y, 0, true);
                         }
                     }
                     break;
@@ -1307,13 +1306,7 @@ int Platform::enterMessagePump()
                             XWarpPointer(__display, None, __window, 0, 0, 0, 0, __mouseCapturePointX, __mouseCapturePointY);
                         }
 
-                        if (!gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_MOVE, x, y, 0))
-                        {
-                            if (evt.xmotion.state & Button1Mask)
-                            {
-                                gameplay::Platform::touchEventInternal(gameplay::Touch::TOUCH_MOVE, x, y, 0, true);
-                            }
-                        }
+                        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_MOVE, x, y, 0, (evt.xmotion.state & Button1Mask) != 0);
                     }
                     break;
 
@@ -1363,7 +1356,7 @@ unsigned int Platform::getDisplayHeight()
 double Platform::getAbsoluteTime()
 {
 
-    clock_gettime(CLOCK_REALTIME, &__timespec);
+    clock_gettime(CLOCK_MONOTONIC, &__timespec);
     double now = timespec2millis(&__timespec);
     __timeAbsolute = now - __timeStart;
 
@@ -1656,7 +1649,7 @@ void Platform::pollGamepadState(Gamepad* gamepad)
                 GP_WARN("unhandled gamepad event: %x\n", jevent.type);
         }
     }
-    if(errno == ENODEV)
+    if(errno == ENODEV && !gamepad->deferDisconnect())
     {
         unregisterGamepad(gamepad->_handle);
         gamepadEventDisconnectedInternal(gamepad->_handle);
@@ -1,4 +1,4 @@
-#ifndef GP_NO_PLATFORM
+#if !defined(GP_NO_PLATFORM) && !defined(GP_HEADLESS)
 #ifdef WIN32
 
 #include "Base.h"
@@ -12,10 +12,13 @@
 #include <windowsx.h>
 #include <Commdlg.h>
 #include <shellapi.h>
+#include <mmsystem.h>
 #ifdef GP_USE_GAMEPAD
 #include <XInput.h>
 #endif
 
+#pragma comment(lib, "winmm.lib")
+
 using gameplay::print;
 
 // Window defaults
@@ -365,10 +368,7 @@ LRESULT CALLBACK __WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
         int y = GET_Y_LPARAM(lParam);
 
         UpdateCapture(wParam);
-        if (!gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_PRESS_LEFT_BUTTON, x, y, 0))
-        {
-            gameplay::Platform::touchEventInternal(gameplay::Touch::TOUCH_PRESS, x, y, 0, true);
-        }
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_PRESS_LEFT_BUTTON, x, y, 0, true);
         return 0;
     }
     case WM_LBUTTONUP:
@@ -376,30 +376,27 @@ LRESULT CALLBACK __WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
         int x = GET_X_LPARAM(lParam);
         int y = GET_Y_LPARAM(lParam);
 
-        if (!gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_RELEASE_LEFT_BUTTON, x, y, 0))
-        {
-            gameplay::Platform::touchEventInternal(gameplay::Touch::TOUCH_RELEASE, x, y, 0, true);
-        }
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_RELEASE_LEFT_BUTTON, x, y, 0, true);
         UpdateCapture(wParam);
         return 0;
     }
     case WM_RBUTTONDOWN:
         UpdateCapture(wParam);
-        gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_PRESS_RIGHT_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0);
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_PRESS_RIGHT_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0, false);
         break;
 
     case WM_RBUTTONUP:
-        gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_RELEASE_RIGHT_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0);
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_RELEASE_RIGHT_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0, false);
         UpdateCapture(wParam);
         break;
 
     case WM_MBUTTONDOWN:
         UpdateCapture(wParam);
-        gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_PRESS_MIDDLE_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0);
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_PRESS_MIDDLE_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0, false);
         break;
 
     case WM_MBUTTONUP:
-        gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_RELEASE_MIDDLE_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0);
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_RELEASE_MIDDLE_BUTTON, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam), 0, false);
         UpdateCapture(wParam);
         break;
 
@@ -423,16 +420,8 @@ LRESULT CALLBACK __WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
             WarpMouse(__mouseCapturePoint.x, __mouseCapturePoint.y);
         }
 
-        // Allow Game::mouseEvent a chance to handle (and possibly consume) the event.
-        if (!gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_MOVE, x, y, 0))
-        {
-            if ((wParam & MK_LBUTTON) == MK_LBUTTON)
-            {
-                // Mouse move events should be interpreted as touch move only if left mouse is held and the game did not consume the mouse event.
-                gameplay::Platform::touchEventInternal(gameplay::Touch::TOUCH_MOVE, x, y, 0, true);
-                return 0;
-            }
-        }
+        // Mouse move events should be interpreted as touch move only if left mouse is held and the game did not consume the mouse event.
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_MOVE, x, y, 0, (wParam & MK_LBUTTON) == MK_LBUTTON);
         break;
     }
 
@@ -441,7 +430,7 @@ LRESULT CALLBACK __WndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
         point.x = GET_X_LPARAM(lParam);
         point.y = GET_Y_LPARAM(lParam);
         ScreenToClient(__hwnd, &point);
-        gameplay::Platform::mouseEventInternal(gameplay::Mouse::MOUSE_WHEEL, point.x, point.y, GET_WHEEL_DELTA_WPARAM(wParam) / 120);
+        gameplay::Platform::pointerEventInternal(gameplay::Mouse::MOUSE_WHEEL, point.x, point.y, GET_WHEEL_DELTA_WPARAM(wParam) / 120, false);
         break;
 
     case WM_KEYDOWN:
@@ -974,7 +963,7 @@ int Platform::enterMessagePump()
     // Get the initial time.
     LARGE_INTEGER tps;
     QueryPerformanceFrequency(&tps);
-    __timeTicksPerMillis = (double)(tps.QuadPart / 1000L);
+    __timeTicksPerMillis = (double)tps.QuadPart / 1000.0;
     LARGE_INTEGER queryTime;
     QueryPerformanceCounter(&queryTime);
     GP_ASSERT(__timeTicksPerMillis);
@@ -985,6 +974,9 @@ int Platform::enterMessagePump()
     if (_game->getState() != Game::RUNNING)
         _game->run();
 
+    // Raise the resolution of the system timer so that paced frames sleep close to their time.
+    timeBeginPeriod(1);
+
     // Enter event dispatch loop.
     MSG msg;
     while (true)
@@ -996,12 +988,18 @@ int Platform::enterMessagePump()
 
             if (msg.message == WM_QUIT)
             {
+                timeEndPeriod(1);
                 gameplay::Platform::shutdownInternal();
                 return msg.wParam;
             }
         }
         else
         {
+            // Paced frames wait for their time, then handle the messages that arrived meanwhile
+            // before the frame, so that it handles the most recent input.
+            if (_game->waitForFrame())
+                continue;
+
 #ifdef GP_USE_GAMEPAD
             // Check for connected XInput gamepads.
             for (DWORD i = 0; i < XUSER_MAX_COUNT; i++)
@@ -1028,6 +1026,7 @@ int Platform::enterMessagePump()
         if (_game->getState() == Game::UNINITIALIZED)
             break;
     }
+    timeEndPeriod(1);
     return 0;
 }
 
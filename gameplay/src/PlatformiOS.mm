@@ -1,4 +1,4 @@
-#ifndef GP_NO_PLATFORM
+#if !defined(GP_NO_PLATFORM) && !defined(GP_HEADLESS)
 #ifdef __APPLE__
 
 #include "Base.h"
@@ -0,0 +1,525 @@
+#include "Base.h"
+#include "PostProcess.h"
+#include "Game.h"
+#include "FrameBuffer.h"
+#include "DepthStencilTarget.h"
+#include "Material.h"
+#include "Technique.h"
+#include "Pass.h"
+#include "Effect.h"
+#include "Model.h"
+
+#define POSTPROCESS_SCENE_ID "org.gameplay3d.postprocess.scene"
+#define POSTPROCESS_TARGET_ID "org.gameplay3d.postprocess.target"
+#define POSTPROCESS_VSH "res/shaders/postprocess.vert"
+
+// The time after which pooled frame buffers that have not been used are released, in milliseconds.
+#define POSTPROCESS_TARGET_TIMEOUT 2000.0
+
+// The source index of the scene, and of an unknown stage.
+#define POSTPROCESS_SOURCE_SCENE -1
+#define POSTPROCESS_SOURCE_NONE -2
+
+namespace gameplay
+{
+
+std::vector<PostProcess::Target*> PostProcess::_pool;
+unsigned int PostProcess::_chainCount = 0;
+
+// Returns whether a pass of the current technique of a material has the given uniform.
+static bool hasUniform(Material* material, const char* name)
+{
+    Technique* technique = material->getTechnique();
+    if (!technique)
+        return false;
+    for (unsigned int i = 0, count = technique->getPassCount(); i < count; ++i)
+    {
+        Effect* effect = technique->getPassByIndex(i)->getEffect();
+        if (effect && effect->getUniform(name))
+            return true;
+    }
+    return false;
+}
+
+// Creates the material of a built-in stage, which draws without depth testing or culling.
+static Material* createStageMaterial(const char* fshPath, const char* defines = NULL)
+{
+    Material* material = Material::create(POSTPROCESS_VSH, fshPath, defines);
+    if (!material)
+        return NULL;
+    RenderState::StateBlock* stateBlock = material->getStateBlock();
+    stateBlock->setDepthTest(false);
+    stateBlock->setDepthWrite(false);
+    stateBlock->setCullFace(false);
+    stateBlock->setBlend(false);
+    return material;
+}
+
+// Creates a sampler that filters linearly and clamps to the edges of a texture.
+static Texture::Sampler* createTargetSampler(FrameBuffer* frameBuffer)
+{
+    Texture::Sampler* sampler = Texture::Sampler::create(frameBuffer->getRenderTarget()->getTexture());
+    sampler->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+    sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    return sampler;
+}
+
+PostProcess::PostProcess(unsigned int width, unsigned int height, Texture::Format format)
+    : _width(0), _height(0), _format(format), _sceneBuffer(NULL), _sceneSampler(NULL), _quad(NULL),
+      _dirty(true), _sceneLoad(LOAD), _sceneStore(DONT_STORE), _destinationLoad(LOAD), _destinationStore(STORE),
+      _previousBuffer(NULL), _copyModel(NULL)
+{
+    _quad = Mesh::createQuadFullscreen();
+    ++_chainCount;
+    resize(width, height);
+}
+
+PostProcess::~PostProcess()
+{
+    removeAllStages();
+    SAFE_RELEASE(_copyModel);
+    SAFE_RELEASE(_sceneSampler);
+    SAFE_RELEASE(_sceneBuffer);
+    SAFE_RELEASE(_quad);
+
+    if (--_chainCount == 0)
+        trimTargets(true);
+}
+
+PostProcess* PostProcess::create(unsigned int width, unsigned int height, Texture::Format format)
+{
+    GP_ASSERT(width > 0 && height > 0);
+    return new PostProcess(width, height, format);
+}
+
+void PostProcess::resize(unsigned int width, unsigned int height)
+{
+    GP_ASSERT(width > 0 && height > 0);
+    if (width == _width && height == _height)
+        return;
+
+    _width = width;
+    _height = height;
+
+    SAFE_RELEASE(_sceneSampler);
+    SAFE_RELEASE(_sceneBuffer);
+    _sceneBuffer = FrameBuffer::create(POSTPROCESS_SCENE_ID, width, height, _format);
+    DepthStencilTarget* depthStencil = DepthStencilTarget::create(POSTPROCESS_SCENE_ID, DepthStencilTarget::DEPTH_STENCIL, width, height);
+    _sceneBuffer->setDepthStencilTarget(depthStencil);
+    SAFE_RELEASE(depthStencil);
+    _sceneSampler = createTargetSampler(_sceneBuffer);
+}
+
+unsigned int PostProcess::getWidth() const
+{
+    return _width;
+}
+
+unsigned int PostProcess::getHeight() const
+{
+    return _height;
+}
+
+void PostProcess::addStage(const char* id, Material* material, Resolution resolution)
+{
+    GP_ASSERT(id);
+    GP_ASSERT(material);
+
+    if (findStage(id) != POSTPROCESS_SOURCE_NONE)
+    {
+        GP_WARN("Post process stage '%s' already exists.", id);
+        return;
+    }
+
+    Stage stage;
+    stage.id = id;
+    stage.model = Model::create(_quad);
+    stage.model->setMaterial(material);
+    stage.resolution = resolution;
+    stage.lastRead = POSTPROCESS_SOURCE_NONE;
+    stage.load = DONT_LOAD;
+    stage.store = STORE;
+
+    // Read the previous stage, or the scene for the first stage.
+    Input input;
+    input.samplerName = "u_texture";
+    input.source = (int)_stages.size() - 1;
+    stage.inputs.push_back(input);
+
+    _stages.push_back(stage);
+    _dirty = true;
+}
+
+void PostProcess::setInput(const char* id, const char* samplerName, const char* sourceId)
+{
+    GP_ASSERT(id);
+    GP_ASSERT(samplerName);
+    GP_ASSERT(sourceId);
+
+    int index = findStage(id);
+    if (index < 0)
+    {
+        GP_WARN("Post process stage '%s' does not exist.", id);
+        return;
+    }
+    int source = findStage(sourceId);
+    if (source == POSTPROCESS_SOURCE_NONE || source >= index)
+    {
+        GP_WARN("Post process stage '%s' can't read '%s', which is not the scene or an earlier stage.", id, sourceId);
+        return;
+    }
+
+    std::vector<Input>& inputs = _stages[index].inputs;
+    for (size_t i = 0, count = inputs.size(); i < count; ++i)
+    {
+        if (inputs[i].samplerName == samplerName)
+        {
+            inputs[i].source = source;
+            _dirty = true;
+            return;
+        }
+    }
+    Input input;
+    input.samplerName = samplerName;
+    input.source = source;
+    inputs.push_back(input);
+    _dirty = true;
+}
+
+void PostProcess::setLoadAction(const char* id, LoadAction action)
+{
+    GP_ASSERT(id);
+
+    if (strcmp(id, "destination") == 0)
+    {
+        _destinationLoad = action;
+        return;
+    }
+    int index = findStage(id);
+    if (index == POSTPROCESS_SOURCE_SCENE)
+        _sceneLoad = action;
+    else if (index >= 0)
+        _stages[index].load = action;
+    else
+        GP_WARN("Post process stage '%s' does not exist.", id);
+}
+
+void PostProcess::setStoreAction(const char* id, StoreAction action)
+{
+    GP_ASSERT(id);
+
+    if (strcmp(id, "destination") == 0)
+    {
+        _destinationStore = action;
+        return;
+    }
+    int index = findStage(id);
+    if (index == POSTPROCESS_SOURCE_SCENE)
+        _sceneStore = action;
+    else if (index >= 0)
+        _stages[index].store = action;
+    else
+        GP_WARN("Post process stage '%s' does not exist.", id);
+}
+
+void PostProcess::addBloom(float threshold, float intensity, Resolution resolution)
+{
+    // The image that the bloom is added to.
+    std::string sourceId = _stages.empty() ? "scene" : _stages.back().id;
+
+    Material* material = createStageMaterial("res/shaders/postprocess-bright.frag");
+    if (!material)
+        return;
+    material->getParameter("u_threshold")->setValue(threshold);
+    addStage("bloom-bright", material, resolution);
+    SAFE_RELEASE(material);
+
+    material = createStageMaterial("res/shaders/postprocess-blur.frag");
+    if (!material)
+        return;
+    material->getParameter("u_direction")->setValue(Vector2(1.0f, 0.0f));
+    addStage("bloom-blur-x", material, resolution);
+    SAFE_RELEASE(material);
+
+    material = createStageMaterial("res/shaders/postprocess-blur.frag");
+    if (!material)
+        return;
+    material->getParameter("u_direction")->setValue(Vector2(0.0f, 1.0f));
+    addStage("bloom-blur-y", material, resolution);
+    SAFE_RELEASE(material);
+
+    material = createStageMaterial("res/shaders/postprocess-bloom.frag");
+    if (!material)
+        return;
+    material->getParameter("u_intensity")->setValue(intensity);
+    addStage("bloom", material);
+    SAFE_RELEASE(material);
+    setInput("bloom", "u_texture", sourceId.c_str());
+    setInput("bloom", "u_bloomTexture", "bloom-blur-y");
+}
+
+void PostProcess::addToneMapping(float exposure)
+{
+    Material* material = createStageMaterial("res/shaders/postprocess-tonemap.frag");
+    if (!material)
+        return;
+    material->getParameter("u_exposure")->setValue(exposure);
+    addStage("tonemap", material);
+    SAFE_RELEASE(material);
+}
+
+void PostProcess::addFxaa()
+{
+    Material* material = createStageMaterial("res/shaders/postprocess-fxaa.frag");
+    if (!material)
+        return;
+    addStage("fxaa", material);
+    SAFE_RELEASE(material);
+}
+
+Material* PostProcess::getStageMaterial(const char* id) const
+{
+    int index = findStage(id);
+    return index >= 0 ? _stages[index].model->getMaterial() : NULL;
+}
+
+unsigned int PostProcess::getStageCount() const
+{
+    return (unsigned int)_stages.size();
+}
+
+void PostProcess::removeAllStages()
+{
+    for (size_t i = 0, count = _stages.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_stages[i].model);
+    }
+    _stages.clear();
+    _dirty = true;
+}
+
+FrameBuffer* PostProcess::begin()
+{
+    GP_ASSERT(_sceneBuffer);
+
+    Game* game = Game::getInstance();
+    _previousViewport = game->getViewport();
+    _previousBuffer = _sceneBuffer->bind();
+    game->setViewport(Rectangle((float)_width, (float)_height));
+    applyLoadAction(_sceneLoad, _sceneBuffer, true);
+    return _sceneBuffer;
+}
+
+void PostProcess::end()
+{
+    GP_ASSERT(_previousBuffer);
+
+    if (_sceneStore == DONT_STORE)
+        _sceneBuffer->discard(FrameBuffer::ATTACHMENT_DEPTH_STENCIL);
+
+    Game* game = Game::getInstance();
+    if (_stages.empty())
+    {
+        if (!_copyModel)
+        {
+            Material* material = createStageMaterial("res/shaders/postprocess.frag");
+            if (material)
+            {
+                _copyModel = Model::create(_quad);
+                _copyModel->setMaterial(material);
+                SAFE_RELEASE(material);
+            }
+        }
+        _previousBuffer->bind();
+        game->setViewport(_previousViewport);
+        applyLoadAction(_destinationLoad, _previousBuffer, true);
+        if (_copyModel)
+        {
+            _copyModel->getMaterial()->getParameter("u_texture")->setValue(_sceneSampler);
+            _copyModel->draw();
+        }
+        if (_destinationStore == DONT_STORE)
+            _previousBuffer->discard(FrameBuffer::ATTACHMENT_DEPTH_STENCIL);
+        _previousBuffer = NULL;
+        trimTargets(false);
+        return;
+    }
+
+    if (_dirty)
+        computeLifetimes();
+
+    size_t stageCount = _stages.size();
+    _outputs.assign(stageCount, NULL);
+
+    for (size_t i = 0; i < stageCount; ++i)
+    {
+        Stage& stage = _stages[i];
+        Material* material = stage.model->getMaterial();
+
+        // Bind the outputs of the earlier stages that this stage reads.
+        for (size_t j = 0, count = stage.inputs.size(); j < count; ++j)
+        {
+            const Input& input = stage.inputs[j];
+            Texture::Sampler* sampler = input.source == POSTPROCESS_SOURCE_SCENE ? _sceneSampler : _outputs[input.source]->sampler;
+            GP_ASSERT(sampler);
+            material->getParameter(input.samplerName.c_str())->setValue(sampler);
+            if (j == 0 && hasUniform(material, "u_texelSize"))
+            {
+                Texture* texture = sampler->getTexture();
+                material->getParameter("u_texelSize")->setValue(Vector2(1.0f / texture->getWidth(), 1.0f / texture->getHeight()));
+            }
+        }
+
+        FrameBuffer* frameBuffer;
+        LoadAction load;
+        StoreAction store;
+        if (i + 1 == stageCount)
+        {
+            frameBuffer = _previousBuffer;
+            frameBuffer->bind();
+            game->setViewport(_previousViewport);
+            load = _destinationLoad;
+            store = _destinationStore;
+        }
+        else
+        {
+            unsigned int divisor = (unsigned int)stage.resolution;
+            Target* target = acquireTarget(std::max(_width / divisor, 1u), std::max(_height / divisor, 1u), _format);
+            _outputs[i] = target;
+            frameBuffer = target->frameBuffer;
+            frameBuffer->bind();
+            game->setViewport(Rectangle((float)target->width, (float)target->height));
+            load = stage.load;
+            store = stage.store;
+        }
+
+        applyLoadAction(load, frameBuffer, frameBuffer->getDepthStencilTarget() != NULL || frameBuffer->isDefault());
+        stage.model->draw();
+        if (store == DONT_STORE)
+            frameBuffer->discard(FrameBuffer::ATTACHMENT_DEPTH_STENCIL);
+
+        // Return the outputs that no later stage reads to the pool, so that the following
+        // stages can draw into them.
+        for (size_t j = 0; j <= i; ++j)
+        {
+            if (_outputs[j] && _stages[j].lastRead <= (int)i)
+            {
+                releaseTarget(_outputs[j]);
+                _outputs[j] = NULL;
+            }
+        }
+    }
+
+    _previousBuffer = NULL;
+    trimTargets(false);
+}
+
+unsigned int PostProcess::getPooledTargetCount()
+{
+    return (unsigned int)_pool.size();
+}
+
+int PostProcess::findStage(const char* id) const
+{
+    GP_ASSERT(id);
+
+    if (strcmp(id, "scene") == 0)
+        return POSTPROCESS_SOURCE_SCENE;
+    for (size_t i = 0, count = _stages.size(); i < count; ++i)
+    {
+        if (_stages[i].id == id)
+            return (int)i;
+    }
+    return POSTPROCESS_SOURCE_NONE;
+}
+
+void PostProcess::computeLifetimes()
+{
+    for (size_t i = 0, count = _stages.size(); i < count; ++i)
+    {
+        _stages[i].lastRead = POSTPROCESS_SOURCE_NONE;
+    }
+    for (size_t i = 0, count = _stages.size(); i < count; ++i)
+    {
+        const std::vector<Input>& inputs = _stages[i].inputs;
+        for (size_t j = 0, inputCount = inputs.size(); j < inputCount; ++j)
+        {
+            int source = inputs[j].source;
+            if (source >= 0)
+                _stages[source].lastRead = std::max(_stages[source].lastRead, (int)i);
+        }
+    }
+    _dirty = false;
+}
+
+void PostProcess::applyLoadAction(LoadAction action, FrameBuffer* frameBuffer, bool depthStencil)
+{
+    switch (action)
+    {
+    case CLEAR:
+        Game::getInstance()->clear(depthStencil ? Game::CLEAR_COLOR_DEPTH_STENCIL : Game::CLEAR_COLOR, Vector4::zero(), 1.0f, 0);
+        break;
+    case DONT_LOAD:
+        frameBuffer->discard(depthStencil ? FrameBuffer::ATTACHMENT_ALL : FrameBuffer::ATTACHMENT_COLOR);
+        break;
+    default:
+        break;
+    }
+}
+
+PostProcess::Target* PostProcess::acquireTarget(unsigned int width, unsigned int height, Texture::Format format)
+{
+    Target* target = NULL;
+    for (size_t i = 0, count = _pool.size(); i < count; ++i)
+    {
+        Target* pooled = _pool[i];
+        if (!pooled->used && pooled->width == width && pooled->height == height && pooled->format == format)
+        {
+            target = pooled;
+            break;
+        }
+    }
+
+    if (!target)
+    {
+        target = new Target();
+        target->frameBuffer = FrameBuffer::create(POSTPROCESS_TARGET_ID, width, height, format);
+        target->sampler = createTargetSampler(target->frameBuffer);
+        target->width = width;
+        target->height = height;
+        target->format = format;
+        _pool.push_back(target);
+    }
+
+    target->used = true;
+    target->lastUsed = Game::getAbsoluteTime();
+    return target;
+}
+
+void PostProcess::releaseTarget(Target* target)
+{
+    GP_ASSERT(target && target->used);
+    target->used = false;
+}
+
+void PostProcess::trimTargets(bool all)
+{
+    double time = Game::getAbsoluteTime();
+    for (size_t i = 0; i < _pool.size();)
+    {
+        Target* target = _pool[i];
+        if (!target->used && (all || time - target->lastUsed > POSTPROCESS_TARGET_TIMEOUT))
+        {
+            SAFE_RELEASE(target->sampler);
+            SAFE_RELEASE(target->frameBuffer);
+            SAFE_DELETE(target);
+            _pool.erase(_pool.begin() + i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+}
@@ -0,0 +1,327 @@
+#ifndef POSTPROCESS_H_
+#define POSTPROCESS_H_
+
+#include "Ref.h"
+#include "Texture.h"
+#include "Rectangle.h"
+
+namespace gameplay
+{
+
+class FrameBuffer;
+class DepthStencilTarget;
+class Material;
+class Mesh;
+class Model;
+
+/**
+ * Defines a chain of full screen stages that are applied to a drawn scene.
+ *
+ * The scene is drawn into the frame buffer bound by begin(), and end() draws each stage in
+ * the order it was added, with the last stage drawing into the frame buffer that was bound
+ * before begin(). Each stage reads the output of the previous stage, or of the scene for the
+ * first stage, with the "u_texture" sampler, and the size of a texel of that input is set to
+ * the "u_texelSize" uniform when the material has one. setInput binds the output of any
+ * earlier stage, or of the scene, to other samplers of a stage.
+ *
+ * The outputs of the stages are not owned by the chain. They are acquired from a pool that
+ * is shared by every chain each time end() is called, and are returned to it as soon as the
+ * last stage that reads them has been drawn, so that stages whose outputs don't overlap in
+ * time draw into the same frame buffers. Stages can be drawn at half or quarter resolution.
+ * Frame buffers that have not been used for a while are released from the pool.
+ *
+ * Each stage has a load action, which tells what happens to the previous contents of the
+ * frame buffer it draws into, and a store action, which tells whether its depth and stencil
+ * are kept once it has been drawn. The color that a stage draws is always kept. The scene and
+ * the destination have their own actions, and the actions of the destination are used by
+ * the last stage. By default the outputs of stages are never loaded, since every pixel is
+ * drawn, the scene is loaded but its depth and stencil are not stored, and the destination
+ * is loaded and stored. Contents that are not loaded or stored are discarded, which tiled
+ * GPUs don't need to move between tile memory and memory.
+ *
+ * @script{ignore}
+ */
+class PostProcess : public Ref
+{
+public:
+
+    /**
+     * The resolution of a stage, as a divisor of the size of the chain.
+     */
+    enum Resolution
+    {
+        FULL_RESOLUTION = 1,
+        HALF_RESOLUTION = 2,
+        QUARTER_RESOLUTION = 4
+    };
+
+    /**
+     * Defines what happens to the previous contents of a frame buffer before it is drawn to.
+     */
+    enum LoadAction
+    {
+        /** The previous contents are kept. */
+        LOAD,
+        /** The frame buffer is cleared to transparent black, a depth of 1 and a stencil of 0. */
+        CLEAR,
+        /** The previous contents are discarded, which is only correct if every pixel is drawn. */
+        DONT_LOAD
+    };
+
+    /**
+     * Defines what happens to the depth and stencil of a frame buffer once it has been drawn to.
+     */
+    enum StoreAction
+    {
+        /** The depth and stencil are kept. */
+        STORE,
+        /** The depth and stencil are discarded. */
+        DONT_STORE
+    };
+
+    /**
+     * Creates a post process chain.
+     *
+     * @param width The width of the scene and of full resolution stages.
+     * @param height The height of the scene and of full resolution stages.
+     * @param format The format of the scene and of the outputs of the stages.
+     *
+     * @return The new post process chain.
+     */
+    static PostProcess* create(unsigned int width, unsigned int height, Texture::Format format = Texture::RGBA);
+
+    /**
+     * Changes the size of the scene and of the stages.
+     *
+     * @param width The width of the scene and of full resolution stages.
+     * @param height The height of the scene and of full resolution stages.
+     */
+    void resize(unsigned int width, unsigned int height);
+
+    /**
+     * Returns the width of the scene.
+     *
+     * @return The width of the scene.
+     */
+    unsigned int getWidth() const;
+
+    /**
+     * Returns the height of the scene.
+     *
+     * @return The height of the scene.
+     */
+    unsigned int getHeight() const;
+
+    /**
+     * Adds a stage to the end of the chain.
+     *
+     * @param id The id of the stage, which names its output for setInput.
+     * @param material The material that draws the stage.
+     * @param resolution The resolution of the output of the stage. The last stage always
+     *      draws at the size of the destination.
+     */
+    void addStage(const char* id, Material* material, Resolution resolution = FULL_RESOLUTION);
+
+    /**
+     * Binds the output of an earlier stage, or of the scene, to a sampler of a stage.
+     *
+     * @param id The id of the stage.
+     * @param samplerName The name of the sampler of the stage's material.
+     * @param sourceId The id of an earlier stage, or "scene".
+     */
+    void setInput(const char* id, const char* samplerName, const char* sourceId);
+
+    /**
+     * Sets the load action of a stage, of the scene or of the destination.
+     *
+     * @param id The id of the stage, "scene" or "destination".
+     * @param action The load action.
+     */
+    void setLoadAction(const char* id, LoadAction action);
+
+    /**
+     * Sets the store action of a stage, of the scene or of the destination.
+     *
+     * @param id The id of the stage, "scene" or "destination".
+     * @param action The store action.
+     */
+    void setStoreAction(const char* id, StoreAction action);
+
+    /**
+     * Adds the stages of a bloom: the parts of the image brighter than the threshold are
+     * blurred at the given resolution and added back to the image.
+     *
+     * @param threshold The brightness above which pixels bloom.
+     * @param intensity The scale of the blurred image that is added back.
+     * @param resolution The resolution at which the bright parts are blurred.
+     */
+    void addBloom(float threshold = 0.8f, float intensity = 1.0f, Resolution resolution = QUARTER_RESOLUTION);
+
+    /**
+     * Adds a stage that maps high dynamic range colors to the displayable range.
+     *
+     * @param exposure The scale applied to the colors before they are mapped.
+     */
+    void addToneMapping(float exposure = 1.0f);
+
+    /**
+     * Adds a stage that smooths the aliased edges of the image with FXAA.
+     */
+    void addFxaa();
+
+    /**
+     * Returns the material of a stage.
+     *
+     * @param id The id of the stage.
+     *
+     * @return The material of the stage, or NULL if there is no stage with this id.
+     */
+    Material* getStageMaterial(const char* id) const;
+
+    /**
+     * Returns the number of stages of the chain.
+     *
+     * @return The number of stages.
+     */
+    unsigned int getStageCount() const;
+
+    /**
+     * Removes all of the stages of the chain.
+     */
+    void removeAllStages();
+
+    /**
+     * Binds the frame buffer that the scene is drawn into, sets the viewport to its size and
+     * applies the load action of the scene.
+     *
+     * @return The frame buffer of the scene.
+     */
+    FrameBuffer* begin();
+
+    /**
+     * Draws the stages of the chain, with the last one drawing into the frame buffer and the
+     * viewport that were bound before begin(), which are bound again.
+     */
+    void end();
+
+    /**
+     * Returns the number of frame buffers held by the pool shared by all chains.
+     *
+     * @return The number of pooled frame buffers.
+     */
+    static unsigned int getPooledTargetCount();
+
+private:
+
+    /**
+     * A sampler of a stage that reads the output of another stage, or of the scene.
+     */
+    struct Input
+    {
+        std::string samplerName;
+        int source;
+    };
+
+    /**
+     * A full screen stage of the chain.
+     */
+    struct Stage
+    {
+        std::string id;
+        Model* model;
+        Resolution resolution;
+        std::vector<Input> inputs;
+        int lastRead;
+        LoadAction load;
+        StoreAction store;
+    };
+
+    /**
+     * A frame buffer of the pool.
+     */
+    struct Target
+    {
+        FrameBuffer* frameBuffer;
+        Texture::Sampler* sampler;
+        unsigned int width;
+        unsigned int height;
+        Texture::Format format;
+        double lastUsed;
+        bool used;
+    };
+
+    /**
+     * Constructor.
+     */
+    PostProcess(unsigned int width, unsigned int height, Texture::Format format);
+
+    /**
+     * Destructor.
+     */
+    ~PostProcess();
+
+    /**
+     * Hidden copy constructor.
+     */
+    PostProcess(const PostProcess& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    PostProcess& operator=(const PostProcess&);
+
+    /**
+     * Returns the index of the stage with the given id, -1 for the scene, or -2 if there is none.
+     */
+    int findStage(const char* id) const;
+
+    /**
+     * Computes the last stage that reads the output of each stage.
+     */
+    void computeLifetimes();
+
+    /**
+     * Applies a load action to the bound frame buffer.
+     */
+    static void applyLoadAction(LoadAction action, FrameBuffer* frameBuffer, bool depthStencil);
+
+    /**
+     * Acquires an unused frame buffer of the given size and format from the pool.
+     */
+    static Target* acquireTarget(unsigned int width, unsigned int height, Texture::Format format);
+
+    /**
+     * Returns a frame buffer to the pool.
+     */
+    static void releaseTarget(Target* target);
+
+    /**
+     * Releases the frame buffers that have not been used for a while, or all of the unused
+     * frame buffers when no chains are left.
+     */
+    static void trimTargets(bool all);
+
+    unsigned int _width;
+    unsigned int _height;
+    Texture::Format _format;
+    FrameBuffer* _sceneBuffer;
+    Texture::Sampler* _sceneSampler;
+    Mesh* _quad;
+    std::vector<Stage> _stages;
+    std::vector<Target*> _outputs;
+    bool _dirty;
+    LoadAction _sceneLoad;
+    StoreAction _sceneStore;
+    LoadAction _destinationLoad;
+    StoreAction _destinationStore;
+    FrameBuffer* _previousBuffer;
+    Rectangle _previousViewport;
+    Model* _copyModel;
+
+    static std::vector<Target*> _pool;
+    static unsigned int _chainCount;
+};
+
+}
+
+#endif
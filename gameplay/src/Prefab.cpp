@@ -0,0 +1,77 @@
+#include "Base.h"
+#include "Prefab.h"
+#include "Node.h"
+#include "Model.h"
+
+namespace gameplay
+{
+
+Prefab::Prefab(Node* node)
+    : _node(node), _nodeCount(0), _modelCount(0)
+{
+    GP_ASSERT(node);
+    countObjects(node);
+}
+
+Prefab::~Prefab()
+{
+    SAFE_RELEASE(_node);
+}
+
+Prefab* Prefab::create(Node* node)
+{
+    GP_ASSERT(node);
+
+    Node* copy = node->clone();
+    if (copy == NULL)
+    {
+        GP_ERROR("Failed to clone node '%s' for prefab.", node->getId());
+        return NULL;
+    }
+    return new Prefab(copy);
+}
+
+Node* Prefab::getNode() const
+{
+    return _node;
+}
+
+Node* Prefab::instantiate() const
+{
+    NodeCloneContext context;
+    context.setShareMaterials(true);
+    return _node->cloneRecursive(context);
+}
+
+void Prefab::instantiate(unsigned int count, Node** nodes) const
+{
+    GP_ASSERT(nodes || count == 0);
+
+#if defined(GP_USE_OBJECT_POOLS) && !defined(GP_USE_MEM_LEAK_DETECTION)
+    // Allocate the nodes and models of the batch from one slab each.
+    ObjectPool::get<Node>()->reserve(_nodeCount * count);
+    if (_modelCount > 0)
+        ObjectPool::get<Model>()->reserve(_modelCount * count);
+#endif
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        nodes[i] = instantiate();
+    }
+}
+
+void Prefab::countObjects(const Node* node)
+{
+    // Joints and other subclasses of nodes are allocated from the heap.
+    if (node->getType() == Node::NODE)
+        ++_nodeCount;
+    if (dynamic_cast<Model*>(node->getDrawable()))
+        ++_modelCount;
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        countObjects(child);
+    }
+}
+
+}
@@ -0,0 +1,105 @@
+#ifndef PREFAB_H_
+#define PREFAB_H_
+
+#include "Ref.h"
+
+namespace gameplay
+{
+
+class Node;
+
+/**
+ * Defines a template node hierarchy that is instantiated many times, such as an enemy
+ * or a prop that is spawned throughout a level.
+ *
+ * Instantiating a prefab is much faster than cloning a node. The instances share the
+ * immutable data of the prefab instead of copying it: the meshes and materials of its
+ * models, and the curves of its animations. Each instance has its own nodes, transforms,
+ * skins, cameras, lights, audio sources and animation clips.
+ *
+ * A material that is shared by the instances is bound to the node of each model when
+ * the model is drawn. Changing a shared material changes it for every instance, so an
+ * instance that needs a material of its own gets it from Model::getUniqueMaterial,
+ * which clones the material the first time it is called.
+ *
+ * Instances can be created in batches, in which case the nodes and models of the whole
+ * batch are allocated next to each other in memory when object pools are enabled.
+ *
+ * @script{ignore}
+ */
+class Prefab : public Ref
+{
+public:
+
+    /**
+     * Creates a prefab from a node hierarchy.
+     *
+     * The prefab clones the hierarchy once, so that the node can be changed or destroyed
+     * afterwards without affecting the prefab or its instances.
+     *
+     * @param node The root node of the hierarchy to instantiate.
+     *
+     * @return The new prefab.
+     */
+    static Prefab* create(Node* node);
+
+    /**
+     * Returns the root node of the hierarchy that is instantiated.
+     *
+     * The hierarchy must not be added to a scene. Changes made to its materials are seen
+     * by every instance.
+     *
+     * @return The root node of the prefab.
+     */
+    Node* getNode() const;
+
+    /**
+     * Creates an instance of the prefab.
+     *
+     * @return The root node of the new instance, which the caller must release.
+     */
+    Node* instantiate() const;
+
+    /**
+     * Creates a batch of instances of the prefab.
+     *
+     * @param count The number of instances to create.
+     * @param nodes Populated with the root nodes of the new instances, which the caller must release.
+     */
+    void instantiate(unsigned int count, Node** nodes) const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    Prefab(Node* node);
+
+    /**
+     * Destructor.
+     */
+    ~Prefab();
+
+    /**
+     * Hidden copy constructor.
+     */
+    Prefab(const Prefab& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    Prefab& operator=(const Prefab&);
+
+    /**
+     * Counts the pooled nodes and models in the given hierarchy.
+     */
+    void countObjects(const Node* node);
+
+    Node* _node;
+    unsigned int _nodeCount;
+    unsigned int _modelCount;
+};
+
+}
+
+#endif
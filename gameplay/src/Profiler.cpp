@@ -0,0 +1,579 @@
+#include "Base.h"
+#include "Profiler.h"
+#include "Font.h"
+#include "FileSystem.h"
+#include "Game.h"
+#include "ScriptController.h"
+
+// The number of completed frames that are retained for the overlay and for exporting.
+#define PROFILER_HISTORY_FRAMES 120
+
+// The number of frames that GPU queries are kept in flight before their results are read.
+#define PROFILER_GPU_LATENCY 4
+
+// The thread index used for GPU zones.
+#define PROFILER_GPU_THREAD 0xFFFFFFFF
+
+namespace gameplay
+{
+
+struct ProfilerEvent
+{
+    const char* name;
+    long long start;
+    long long end;
+    unsigned int thread;
+};
+
+struct ProfilerFrame
+{
+    unsigned int index;
+    long long start;
+    long long end;
+    std::vector<ProfilerEvent> events;
+};
+
+#ifndef OPENGL_ES
+struct ProfilerGpuQuery
+{
+    const char* name;
+    GLuint begin;
+    GLuint end;
+};
+
+struct ProfilerGpuFrame
+{
+    unsigned int index;
+    long long start;
+    GLuint base;
+    std::vector<ProfilerGpuQuery> queries;
+};
+
+static ProfilerGpuFrame __gpuFrames[PROFILER_GPU_LATENCY];
+static ProfilerGpuFrame* __gpuFrame = NULL;
+static std::vector<GLuint> __gpuFreeQueries;
+static int __gpuSupported = -1;
+#endif
+
+static bool __enabled = false;
+static bool __materialTimingEnabled = false;
+static bool __frameActive = false;
+static unsigned int __frameIndex = 0;
+static std::mutex __mutex;
+static std::vector<std::thread::id> __threads;
+static ProfilerFrame __currentFrame;
+static std::deque<ProfilerFrame> __frames;
+
+static long long getTime()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+static unsigned int getThreadIndex()
+{
+    // The thread that begins the first frame is the main thread and registers first.
+    std::thread::id id = std::this_thread::get_id();
+    for (size_t i = 0, count = __threads.size(); i < count; ++i)
+    {
+        if (__threads[i] == id)
+            return (unsigned int)i;
+    }
+    __threads.push_back(id);
+    return (unsigned int)__threads.size() - 1;
+}
+
+static void addEvent(const char* name, long long start, long long end, unsigned int thread)
+{
+    ProfilerEvent event;
+    event.name = name;
+    event.start = start;
+    event.end = end;
+    event.thread = thread;
+    __currentFrame.events.push_back(event);
+}
+
+#ifndef OPENGL_ES
+static bool isGpuSupported()
+{
+    if (__gpuSupported < 0)
+    {
+        // Timestamp queries are core in OpenGL 3.3 and are otherwise provided by ARB_timer_query.
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        __gpuSupported = (major > 3 || (major == 3 && minor >= 3) || (extensions && strstr(extensions, "GL_ARB_timer_query"))) ? 1 : 0;
+        glGetError();
+    }
+    return __gpuSupported == 1;
+}
+
+static GLuint createGpuQuery()
+{
+    GLuint query = 0;
+    if (__gpuFreeQueries.empty())
+    {
+        glGenQueries(1, &query);
+    }
+    else
+    {
+        query = __gpuFreeQueries.back();
+        __gpuFreeQueries.pop_back();
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    return query;
+}
+
+static void resolveGpuFrame(ProfilerGpuFrame* frame)
+{
+    GP_ASSERT(frame);
+
+    if (frame->base == 0)
+        return;
+
+    GLuint64 base = 0;
+    glGetQueryObjectui64v(frame->base, GL_QUERY_RESULT, &base);
+    __gpuFreeQueries.push_back(frame->base);
+    frame->base = 0;
+
+    // Convert the GPU timestamps into CPU time relative to the start of the frame.
+    std::vector<ProfilerEvent> events;
+    for (size_t i = 0, count = frame->queries.size(); i < count; ++i)
+    {
+        ProfilerGpuQuery& query = frame->queries[i];
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(query.begin, GL_QUERY_RESULT, &begin);
+        __gpuFreeQueries.push_back(query.begin);
+        if (query.end)
+        {
+            glGetQueryObjectui64v(query.end, GL_QUERY_RESULT, &end);
+            __gpuFreeQueries.push_back(query.end);
+        }
+        else
+        {
+            end = begin;
+        }
+
+        ProfilerEvent event;
+        event.name = query.name;
+        event.start = frame->start + (long long)(begin - base) / 1000;
+        event.end = frame->start + (long long)(end - base) / 1000;
+        event.thread = PROFILER_GPU_THREAD;
+        events.push_back(event);
+    }
+    frame->queries.clear();
+
+    std::lock_guard<std::mutex> lock(__mutex);
+    for (size_t i = 0, count = __frames.size(); i < count; ++i)
+    {
+        if (__frames[i].index == frame->index)
+        {
+            __frames[i].events.insert(__frames[i].events.end(), events.begin(), events.end());
+            break;
+        }
+    }
+}
+#endif
+
+Profiler::Zone::Zone(const char* name)
+    : _name(name), _start(__enabled ? getTime() : -1)
+{
+}
+
+Profiler::Zone::~Zone()
+{
+    if (_start < 0)
+        return;
+
+    long long end = getTime();
+    std::lock_guard<std::mutex> lock(__mutex);
+    if (__frameActive)
+        addEvent(_name, _start, end, getThreadIndex());
+}
+
+Profiler::GpuZone::GpuZone(const char* name)
+    : _query(-1)
+{
+#ifndef OPENGL_ES
+    if (__enabled && __gpuFrame && name)
+    {
+        ProfilerGpuQuery query;
+        query.name = name;
+        query.begin = createGpuQuery();
+        query.end = 0;
+        _query = (int)__gpuFrame->queries.size();
+        __gpuFrame->queries.push_back(query);
+    }
+#endif
+}
+
+Profiler::GpuZone::~GpuZone()
+{
+#ifndef OPENGL_ES
+    if (_query >= 0 && __gpuFrame && _query < (int)__gpuFrame->queries.size())
+    {
+        __gpuFrame->queries[_query].end = createGpuQuery();
+    }
+#endif
+}
+
+void Profiler::setEnabled(bool enabled)
+{
+    __enabled = enabled;
+}
+
+bool Profiler::isEnabled()
+{
+    return __enabled;
+}
+
+void Profiler::setMaterialTimingEnabled(bool enabled)
+{
+    __materialTimingEnabled = enabled;
+}
+
+bool Profiler::isMaterialTimingEnabled()
+{
+    return __materialTimingEnabled;
+}
+
+float Profiler::getZoneTime(const char* name, bool gpu)
+{
+    GP_ASSERT(name);
+
+    std::lock_guard<std::mutex> lock(__mutex);
+
+    // GPU results arrive a few frames late, so use the most recent frame that has them.
+    for (std::deque<ProfilerFrame>::reverse_iterator itr = __frames.rbegin(); itr != __frames.rend(); ++itr)
+    {
+        long long time = 0;
+        bool found = false;
+        for (size_t i = 0, count = itr->events.size(); i < count; ++i)
+        {
+            const ProfilerEvent& event = itr->events[i];
+            if ((event.thread == PROFILER_GPU_THREAD) != gpu)
+                continue;
+            found = true;
+            if (strcmp(event.name, name) == 0)
+                time += event.end - event.start;
+        }
+        if (found || !gpu)
+            return (float)time / 1000.0f;
+    }
+    return 0.0f;
+}
+
+float Profiler::getFrameTime()
+{
+    std::lock_guard<std::mutex> lock(__mutex);
+    return __frames.empty() ? 0.0f : (float)(__frames.back().end - __frames.back().start) / 1000.0f;
+}
+
+/**
+ * Sorts the events of a frame by thread and start time, with enclosing events first.
+ */
+static bool compareEvents(const ProfilerEvent& a, const ProfilerEvent& b)
+{
+    if (a.thread != b.thread)
+        return a.thread < b.thread;
+    if (a.start != b.start)
+        return a.start < b.start;
+    return a.end > b.end;
+}
+
+void Profiler::drawOverlay(Font* font, int x, int y, const Vector4& color)
+{
+    GP_ASSERT(font);
+
+    std::vector<ProfilerEvent> events;
+    long long frameTime = 0;
+    {
+        std::lock_guard<std::mutex> lock(__mutex);
+        if (__frames.empty())
+            return;
+
+        // Use the most recent frame for CPU zones and the most recent resolved frame for GPU zones.
+        const ProfilerFrame& frame = __frames.back();
+        frameTime = frame.end - frame.start;
+        for (size_t i = 0, count = frame.events.size(); i < count; ++i)
+        {
+            if (frame.events[i].thread != PROFILER_GPU_THREAD)
+                events.push_back(frame.events[i]);
+        }
+        for (std::deque<ProfilerFrame>::reverse_iterator itr = __frames.rbegin(); itr != __frames.rend(); ++itr)
+        {
+            size_t count = events.size();
+            for (size_t i = 0, eventCount = itr->events.size(); i < eventCount; ++i)
+            {
+                if (itr->events[i].thread == PROFILER_GPU_THREAD)
+                    events.push_back(itr->events[i]);
+            }
+            if (events.size() > count)
+                break;
+        }
+    }
+    std::sort(events.begin(), events.end(), compareEvents);
+
+    // Merge zones with the same name and parent into lines, keeping the order in which they first started.
+    struct Line
+    {
+        unsigned int thread;
+        unsigned int depth;
+        const char* name;
+        long long time;
+        unsigned int count;
+        int parent;
+    };
+    std::vector<Line> lines;
+    std::vector<std::pair<long long, int> > stack;
+    unsigned int thread = 0;
+    for (size_t i = 0, count = events.size(); i < count; ++i)
+    {
+        const ProfilerEvent& event = events[i];
+        if (i == 0 || event.thread != thread)
+        {
+            thread = event.thread;
+            stack.clear();
+        }
+        while (!stack.empty() && stack.back().first <= event.start)
+        {
+            stack.pop_back();
+        }
+
+        int parent = stack.empty() ? -1 : stack.back().second;
+        int line = -1;
+        for (size_t j = 0, lineCount = lines.size(); j < lineCount; ++j)
+        {
+            if (lines[j].thread == thread && lines[j].parent == parent && strcmp(lines[j].name, event.name) == 0)
+            {
+                line = (int)j;
+                break;
+            }
+        }
+        if (line < 0)
+        {
+            Line newLine;
+            newLine.thread = thread;
+            newLine.depth = (unsigned int)stack.size();
+            newLine.name = event.name;
+            newLine.time = 0;
+            newLine.count = 0;
+            newLine.parent = parent;
+
+            // Children are listed right after the last line that belongs to their parent.
+            size_t position = lines.size();
+            if (parent >= 0)
+            {
+                position = parent + 1;
+                while (position < lines.size() && lines[position].depth > lines[parent].depth)
+                {
+                    ++position;
+                }
+                for (size_t j = 0, lineCount = lines.size(); j < lineCount; ++j)
+                {
+                    if (lines[j].parent >= (int)position)
+                        ++lines[j].parent;
+                }
+                for (size_t j = 0, stackCount = stack.size(); j < stackCount; ++j)
+                {
+                    if (stack[j].second >= (int)position)
+                        ++stack[j].second;
+                }
+            }
+            lines.insert(lines.begin() + position, newLine);
+            line = (int)position;
+        }
+        lines[line].time += event.end - event.start;
+        ++lines[line].count;
+        stack.push_back(std::make_pair(event.end, line));
+    }
+
+    unsigned int size = font->getSize();
+    char text[256];
+    font->start();
+    sprintf(text, "Frame %.2f ms", (float)frameTime / 1000.0f);
+    font->drawText(text, x, y, color, size);
+    y += size;
+    for (size_t i = 0, count = lines.size(); i < count; ++i)
+    {
+        const Line& line = lines[i];
+        if (i == 0 || line.thread != lines[i - 1].thread)
+        {
+            if (line.thread == PROFILER_GPU_THREAD)
+                strcpy(text, "GPU");
+            else if (line.thread == 0)
+                strcpy(text, "Main thread");
+            else
+                sprintf(text, "Thread %u", line.thread);
+            font->drawText(text, x, y, color, size);
+            y += size;
+        }
+        if (line.count > 1)
+            snprintf(text, sizeof(text), "%*s%s %.2f ms (%u)", (line.depth + 1) * 2, "", line.name, (float)line.time / 1000.0f, line.count);
+        else
+            snprintf(text, sizeof(text), "%*s%s %.2f ms", (line.depth + 1) * 2, "", line.name, (float)line.time / 1000.0f);
+        font->drawText(text, x, y, color, size);
+        y += size;
+    }
+    font->finish();
+
+    // The hot spots of the scripts follow the zones while they are sampled.
+    ScriptController* sc = Game::getInstance() ? Game::getInstance()->getScriptController() : NULL;
+    if (sc && sc->getProfiler()->isEnabled())
+        sc->getProfiler()->drawOverlay(font, x, y + size, color);
+}
+
+/**
+ * Appends a string to a JSON document, escaping it as needed.
+ */
+static void appendJsonString(std::string* json, const char* value)
+{
+    json->push_back('"');
+    for (const char* c = value; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            json->push_back('\\');
+        if ((unsigned char)*c >= 0x20)
+            json->push_back(*c);
+    }
+    json->push_back('"');
+}
+
+bool Profiler::exportTrace(const char* path)
+{
+    GP_ASSERT(path);
+
+    std::string json = "{\"traceEvents\":[";
+    char buffer[256];
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(__mutex);
+
+        for (size_t i = 0, count = __threads.size(); i < count; ++i)
+        {
+            sprintf(buffer, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":", first ? "" : ",", (unsigned int)i);
+            json += buffer;
+            if (i == 0)
+            {
+                appendJsonString(&json, "Main thread");
+            }
+            else
+            {
+                sprintf(buffer, "Thread %u", (unsigned int)i);
+                appendJsonString(&json, buffer);
+            }
+            json += "}}";
+            first = false;
+        }
+        sprintf(buffer, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"GPU\"}}", first ? "" : ",", PROFILER_GPU_THREAD);
+        json += buffer;
+
+        for (size_t i = 0, frameCount = __frames.size(); i < frameCount; ++i)
+        {
+            const ProfilerFrame& frame = __frames[i];
+            sprintf(buffer, ",{\"name\":\"Frame %u\",\"ph\":\"X\",\"pid\":0,\"tid\":0,\"ts\":%lld,\"dur\":%lld}", frame.index, frame.start, frame.end - frame.start);
+            json += buffer;
+            for (size_t j = 0, eventCount = frame.events.size(); j < eventCount; ++j)
+            {
+                const ProfilerEvent& event = frame.events[j];
+                json += ",{\"name\":";
+                appendJsonString(&json, event.name);
+                sprintf(buffer, ",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%lld,\"dur\":%lld}", event.thread, event.start, event.end - event.start);
+                json += buffer;
+            }
+        }
+    }
+    json += "]}";
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::WRITE));
+    if (stream.get() == NULL || stream->write(json.c_str(), 1, json.size()) != json.size())
+    {
+        GP_WARN("Failed to write profiler trace file '%s'.", path);
+        return false;
+    }
+    stream->close();
+    return true;
+}
+
+void Profiler::beginFrame()
+{
+    if (!__enabled)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(__mutex);
+        getThreadIndex();
+        __currentFrame.index = __frameIndex++;
+        __currentFrame.start = getTime();
+        __currentFrame.events.clear();
+        __frameActive = true;
+    }
+
+#ifndef OPENGL_ES
+    if (isGpuSupported())
+    {
+        // Reuse the oldest set of queries, whose results should be available by now.
+        __gpuFrame = &__gpuFrames[__currentFrame.index % PROFILER_GPU_LATENCY];
+        resolveGpuFrame(__gpuFrame);
+        __gpuFrame->index = __currentFrame.index;
+        __gpuFrame->start = __currentFrame.start;
+        __gpuFrame->base = createGpuQuery();
+    }
+#endif
+}
+
+void Profiler::endFrame()
+{
+#ifndef OPENGL_ES
+    __gpuFrame = NULL;
+#endif
+
+    std::lock_guard<std::mutex> lock(__mutex);
+    if (!__frameActive)
+        return;
+    __frameActive = false;
+
+    __currentFrame.end = getTime();
+    __frames.push_back(ProfilerFrame());
+    __frames.back().index = __currentFrame.index;
+    __frames.back().start = __currentFrame.start;
+    __frames.back().end = __currentFrame.end;
+    __frames.back().events.swap(__currentFrame.events);
+    while (__frames.size() > PROFILER_HISTORY_FRAMES)
+    {
+        __frames.pop_front();
+    }
+}
+
+void Profiler::finalize()
+{
+#ifndef OPENGL_ES
+    for (unsigned int i = 0; i < PROFILER_GPU_LATENCY; ++i)
+    {
+        ProfilerGpuFrame& frame = __gpuFrames[i];
+        if (frame.base)
+            __gpuFreeQueries.push_back(frame.base);
+        for (size_t j = 0, count = frame.queries.size(); j < count; ++j)
+        {
+            __gpuFreeQueries.push_back(frame.queries[j].begin);
+            if (frame.queries[j].end)
+                __gpuFreeQueries.push_back(frame.queries[j].end);
+        }
+        frame.base = 0;
+        frame.queries.clear();
+    }
+    if (!__gpuFreeQueries.empty())
+        glDeleteQueries((GLsizei)__gpuFreeQueries.size(), &__gpuFreeQueries[0]);
+    __gpuFreeQueries.clear();
+    __gpuFrame = NULL;
+    __gpuSupported = -1;
+#endif
+
+    std::lock_guard<std::mutex> lock(__mutex);
+    __frames.clear();
+    __currentFrame.events.clear();
+    __frameActive = false;
+}
+
+}
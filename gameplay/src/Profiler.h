@@ -0,0 +1,206 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+namespace gameplay
+{
+
+class Font;
+class Vector4;
+
+/**
+ * Defines a frame profiler that measures named zones of CPU and GPU work.
+ *
+ * CPU zones are measured by placing a GP_PROFILE statement at the start of a scope.
+ * The zone starts when the statement is reached and ends when the scope is left, so
+ * zones nest naturally. Zones can be measured on any thread and are recorded per
+ * thread. GPU zones are placed with GP_PROFILE_GPU on the render thread and measure
+ * the time the GPU spends on the OpenGL commands issued inside of the zone, using
+ * timestamp queries where the platform supports them. GPU results become available
+ * a few frames after they were issued.
+ *
+ * The profiler keeps the zones of the most recent frames. The zones of the last
+ * completed frame can be drawn as an overlay with drawOverlay, and all retained
+ * frames can be written to a file in the Chrome trace event format with exportTrace,
+ * which can be opened in chrome://tracing or compatible viewers.
+ *
+ * Profiling is disabled by default and can be enabled with setEnabled or with the
+ * 'profiler' property of the game configuration file. Disabled zones only cost a
+ * single check. Defining GP_NO_PROFILER compiles all zones out entirely.
+ *
+ * Zone names are stored by pointer, so they must be string literals or otherwise
+ * outlive the profiler.
+ *
+ * @script{ignore}
+ */
+class Profiler
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Measures a CPU zone for as long as the zone exists.
+     */
+    class Zone
+    {
+    public:
+
+        /**
+         * Starts the zone.
+         *
+         * @param name The name of the zone.
+         */
+        Zone(const char* name);
+
+        /**
+         * Ends the zone.
+         */
+        ~Zone();
+
+    private:
+
+        Zone(const Zone&);
+        Zone& operator=(const Zone&);
+
+        const char* _name;
+        long long _start;
+    };
+
+    /**
+     * Measures a GPU zone for as long as the zone exists.
+     *
+     * GPU zones must only be used on the thread that owns the OpenGL context.
+     */
+    class GpuZone
+    {
+    public:
+
+        /**
+         * Starts the zone.
+         *
+         * @param name The name of the zone, or NULL to not measure the zone.
+         */
+        GpuZone(const char* name);
+
+        /**
+         * Ends the zone.
+         */
+        ~GpuZone();
+
+    private:
+
+        GpuZone(const GpuZone&);
+        GpuZone& operator=(const GpuZone&);
+
+        int _query;
+    };
+
+    /**
+     * Sets whether zones are measured.
+     *
+     * @param enabled true to measure zones, false to ignore them.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * Returns whether zones are measured.
+     *
+     * @return true if the profiler is enabled.
+     */
+    static bool isEnabled();
+
+    /**
+     * Sets whether the draws of every material are measured, each as a GPU zone named
+     * after the material file, or after the shaders of materials created in code.
+     *
+     * This adds two timestamp queries to every draw, so it should only be enabled while
+     * looking for the materials that take the most GPU time.
+     *
+     * @param enabled true to measure the draws of materials.
+     */
+    static void setMaterialTimingEnabled(bool enabled);
+
+    /**
+     * Returns whether the draws of every material are measured.
+     *
+     * @return true if the draws of materials are measured.
+     */
+    static bool isMaterialTimingEnabled();
+
+    /**
+     * Returns the total time spent in all zones with the given name during the last completed frame.
+     *
+     * @param name The name of the zone.
+     * @param gpu true to return the time of GPU zones, false for CPU zones.
+     *
+     * @return The time in milliseconds.
+     */
+    static float getZoneTime(const char* name, bool gpu = false);
+
+    /**
+     * Returns the duration of the last completed frame.
+     *
+     * @return The frame time in milliseconds.
+     */
+    static float getFrameTime();
+
+    /**
+     * Draws the zones of the last completed frame as a text overlay.
+     *
+     * CPU zones of every thread are listed in the order they started and are indented
+     * by their depth, followed by the GPU zones. Zones with the same name and parent
+     * are merged into a single line. While the script profiler is enabled, the script
+     * functions that take the most time are listed below the zones.
+     *
+     * @param font The font to draw with.
+     * @param x The x coordinate of the top left corner of the overlay.
+     * @param y The y coordinate of the top left corner of the overlay.
+     * @param color The color of the text.
+     */
+    static void drawOverlay(Font* font, int x, int y, const Vector4& color);
+
+    /**
+     * Writes all retained frames to a file in the Chrome trace event format.
+     *
+     * @param path The path of the file to write.
+     *
+     * @return true if the file was written, false otherwise.
+     */
+    static bool exportTrace(const char* path);
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    Profiler();
+
+    /**
+     * Starts measuring a new frame. Called by the game at the start of every frame.
+     */
+    static void beginFrame();
+
+    /**
+     * Completes the current frame. Called by the game at the end of every frame.
+     */
+    static void endFrame();
+
+    /**
+     * Releases all retained frames and GPU queries. Called by the game on shutdown.
+     */
+    static void finalize();
+};
+
+}
+
+#ifdef GP_NO_PROFILER
+#define GP_PROFILE(name)
+#define GP_PROFILE_GPU(name)
+#else
+#define GP_PROFILE_CONCAT_(a, b) a##b
+#define GP_PROFILE_CONCAT(a, b) GP_PROFILE_CONCAT_(a, b)
+#define GP_PROFILE(name) gameplay::Profiler::Zone GP_PROFILE_CONCAT(__profilerZone, __LINE__)(name)
+#define GP_PROFILE_GPU(name) gameplay::Profiler::GpuZone GP_PROFILE_CONCAT(__profilerGpuZone, __LINE__)(name)
+#endif
+
+#endif
@@ -19,6 +19,54 @@ static signed char readChar(Stream* stream)
     return c;
 }
 
+// The identifier and version of compiled properties files.
+static const char PROPERTIES_IDENTIFIER[] = { '\xAB', 'G', 'P', 'P', '\xBB', '\r', '\n', '\x1A', '\n' };
+static const unsigned char PROPERTIES_VERSION[] = { 1, 0 };
+
+static bool __cacheEnabled = false;
+
+/**
+ * Determines if the stream is over a compiled properties file, and rewinds it.
+ */
+static bool isCompiled(Stream* stream)
+{
+    char identifier[sizeof(PROPERTIES_IDENTIFIER)];
+    bool compiled = stream->read(identifier, 1, sizeof(identifier)) == sizeof(identifier) &&
+                    memcmp(identifier, PROPERTIES_IDENTIFIER, sizeof(identifier)) == 0;
+    stream->rewind();
+    return compiled;
+}
+
+/**
+ * Returns the FNV-1a hash of the contents of the stream, and rewinds it.
+ */
+static unsigned int hashStream(Stream* stream, unsigned int* size)
+{
+    unsigned int hash = 2166136261u;
+    unsigned int length = 0;
+    const unsigned char* data = (const unsigned char*)stream->getData();
+    if (data)
+    {
+        length = (unsigned int)stream->length();
+        for (unsigned int i = 0; i < length; ++i)
+            hash = (hash ^ data[i]) * 16777619u;
+    }
+    else
+    {
+        unsigned char buffer[4096];
+        size_t read;
+        while ((read = stream->read(buffer, 1, sizeof(buffer))) > 0)
+        {
+            for (size_t i = 0; i < read; ++i)
+                hash = (hash ^ buffer[i]) * 16777619u;
+            length += (unsigned int)read;
+        }
+    }
+    stream->rewind();
+    *size = length;
+    return hash;
+}
+
 // Utility functions (shared with SceneLoader).
 /** @script{ignore} */
 void calculateNamespacePath(const std::string& urlString, std::string& fileString, std::vector<std::string>& namespacePath);
@@ -26,12 +74,12 @@ void calculateNamespacePath(const std::string& urlString, std::string& fileStrin
 Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath);
 
 Properties::Properties()
-    : _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
+    : _indexed(false), _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
 {
 }
 
 Properties::Properties(const Properties& copy)
-    : _namespace(copy._namespace), _id(copy._id), _parentID(copy._parentID), _properties(copy._properties), _variables(NULL), _dirPath(NULL), _visited(false), _parent(copy._parent)
+    : _namespace(copy._namespace), _id(copy._id), _parentID(copy._parentID), _properties(copy._properties), _indexed(false), _variables(NULL), _dirPath(NULL), _visited(false), _parent(copy._parent)
 {
     setDirectoryPath(copy._dirPath);
     _namespaces = std::vector<Properties*>();
@@ -45,14 +93,14 @@ Properties::Properties(const Properties& copy)
 }
 
 Properties::Properties(Stream* stream)
-    : _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
+    : _indexed(false), _variables(NULL), _dirPath(NULL), _visited(false), _parent(NULL)
 {
     readProperties(stream);
     rewind();
 }
 
 Properties::Properties(Stream* stream, const char* name, const char* id, const char* parentID, Properties* parent)
-    : _namespace(name), _variables(NULL), _dirPath(NULL), _visited(false), _parent(parent)
+    : _namespace(name), _indexed(false), _variables(NULL), _dirPath(NULL), _visited(false), _parent(parent)
 {
     if (id)
     {
@@ -80,16 +128,17 @@ Properties* Properties::create(const char* url)
     std::vector<std::string> namespacePath;
     calculateNamespacePath(urlString, fileString, namespacePath);
 
-    std::unique_ptr<Stream> stream(FileSystem::open(fileString.c_str()));
+    std::unique_ptr<Stream> stream(FileSystem::open(fileString.c_str(), FileSystem::READ | FileSystem::MAPPED));
     if (stream.get() == NULL)
     {
         GP_WARN("Failed to open file '%s'.", fileString.c_str());
         return NULL;
     }
 
-    Properties* properties = new Properties(stream.get());
-    properties->resolveInheritance();
+    Properties* properties = load(stream.get(), fileString.c_str());
     stream->close();
+    if (!properties)
+        return NULL;
 
     // Get the specified properties object.
     Properties* p = getPropertiesFromNamespacePath(properties, namespacePath);
@@ -128,6 +177,351 @@ static bool isVariable(const char* str, char* outName, size_t outSize)
     return false;
 }
 
+bool Properties::compile(const char* path, const char* compiledPath)
+{
+    GP_ASSERT(path);
+    GP_ASSERT(compiledPath);
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED));
+    if (stream.get() == NULL)
+    {
+        GP_WARN("Failed to open file '%s'.", path);
+        return false;
+    }
+    if (isCompiled(stream.get()))
+    {
+        GP_WARN("File '%s' is already compiled.", path);
+        return false;
+    }
+
+    unsigned int sourceSize;
+    unsigned int sourceHash = hashStream(stream.get(), &sourceSize);
+    std::unique_ptr<Properties> properties(new Properties(stream.get()));
+    properties->resolveInheritance();
+
+    std::unique_ptr<Stream> output(FileSystem::open(compiledPath, FileSystem::WRITE));
+    if (output.get() == NULL || !properties->writeBinary(output.get(), sourceSize, sourceHash))
+    {
+        GP_WARN("Failed to write compiled properties file '%s'.", compiledPath);
+        return false;
+    }
+    return true;
+}
+
+void Properties::setCacheEnabled(bool enabled)
+{
+    __cacheEnabled = enabled;
+}
+
+bool Properties::isCacheEnabled()
+{
+    return __cacheEnabled;
+}
+
+Properties* Properties::load(Stream* stream, const char* path)
+{
+    if (isCompiled(stream))
+    {
+        Properties* properties = readBinary(stream, 0, 0);
+        if (!properties)
+            GP_WARN("Invalid compiled properties file '%s'.", path);
+        return properties;
+    }
+
+    if (!__cacheEnabled)
+    {
+        Properties* properties = new Properties(stream);
+        properties->resolveInheritance();
+        return properties;
+    }
+
+    // The cached file is only used while the text file is the one it was compiled from.
+    unsigned int sourceSize;
+    unsigned int sourceHash = hashStream(stream, &sourceSize);
+    std::string cachePath(path);
+    cachePath += ".gpp";
+    {
+        std::unique_ptr<Stream> cache(FileSystem::open(cachePath.c_str(), FileSystem::READ | FileSystem::MAPPED));
+        if (cache.get())
+        {
+            Properties* properties = readBinary(cache.get(), sourceSize, sourceHash);
+            if (properties)
+                return properties;
+        }
+    }
+
+    Properties* properties = new Properties(stream);
+    properties->resolveInheritance();
+
+    std::unique_ptr<Stream> cache(FileSystem::open(cachePath.c_str(), FileSystem::WRITE));
+    if (cache.get())
+        properties->writeBinary(cache.get(), sourceSize, sourceHash);
+    return properties;
+}
+
+Properties* Properties::readBinary(Stream* stream, unsigned int sourceSize, unsigned int sourceHash)
+{
+    GP_ASSERT(stream);
+
+    // The header is followed by the size and hash of the text file, and the length of the string table.
+    char identifier[sizeof(PROPERTIES_IDENTIFIER)];
+    unsigned char version[2];
+    unsigned int header[3];
+    if (stream->read(identifier, 1, sizeof(identifier)) != sizeof(identifier) ||
+        memcmp(identifier, PROPERTIES_IDENTIFIER, sizeof(identifier)) != 0 ||
+        stream->read(version, 1, 2) != 2 || version[0] != PROPERTIES_VERSION[0] ||
+        stream->read(header, 4, 3) != 3)
+    {
+        return NULL;
+    }
+    if ((sourceSize != 0 || sourceHash != 0) && (header[0] != sourceSize || header[1] != sourceHash))
+        return NULL;
+
+    // The string table is used in place when the file is mapped.
+    unsigned int stringsLength = header[2];
+    std::vector<char> buffer;
+    const char* strings = (const char*)stream->getData();
+    if (strings)
+    {
+        strings += stream->position();
+        if (!stream->seek(stringsLength, SEEK_CUR))
+            return NULL;
+    }
+    else
+    {
+        buffer.resize(stringsLength + 1);
+        if (stream->read(&buffer[0], 1, stringsLength) != stringsLength)
+            return NULL;
+        strings = &buffer[0];
+    }
+    if (stringsLength == 0 || strings[stringsLength - 1] != '\0')
+        return NULL;
+
+    Properties* properties = new Properties();
+    if (!properties->readNamespace(stream, strings, stringsLength))
+    {
+        SAFE_DELETE(properties);
+        return NULL;
+    }
+    properties->rewind();
+    return properties;
+}
+
+bool Properties::readNamespace(Stream* stream, const char* strings, unsigned int stringsLength)
+{
+    // Each namespace starts with the offsets of its name, ID and parent ID, and its number of properties.
+    unsigned int header[4];
+    if (stream->read(header, 4, 4) != 4 || header[0] >= stringsLength || header[1] >= stringsLength || header[2] >= stringsLength)
+        return false;
+    _namespace = strings + header[0];
+    _id = strings + header[1];
+    _parentID = strings + header[2];
+
+    for (unsigned int i = 0; i < header[3]; ++i)
+    {
+        // The offsets of the name and value, the parsed flag, color components and number count, and the color.
+        unsigned int offsets[2];
+        unsigned char flags[4];
+        unsigned int color;
+        if (stream->read(offsets, 4, 2) != 2 || offsets[0] >= stringsLength || offsets[1] >= stringsLength ||
+            stream->read(flags, 1, 4) != 4 || stream->read(&color, 4, 1) != 1 || flags[2] > 16)
+        {
+            return false;
+        }
+        _properties.push_back(Property(strings + offsets[0], strings + offsets[1]));
+        Property& property = _properties.back();
+        property.parsed = flags[0] != 0;
+        property.colorComponents = flags[1];
+        property.color = color;
+        if (flags[2] > 0)
+        {
+            property.numbers.resize(flags[2]);
+            if (stream->read(&property.numbers[0], 4, flags[2]) != flags[2])
+                return false;
+        }
+    }
+
+    unsigned int count;
+    if (stream->read(&count, 4, 1) != 1)
+        return false;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int offsets[2];
+        if (stream->read(offsets, 4, 2) != 2 || offsets[0] >= stringsLength || offsets[1] >= stringsLength)
+            return false;
+        if (!_variables)
+            _variables = new std::vector<Property>();
+        _variables->push_back(Property(strings + offsets[0], strings + offsets[1]));
+    }
+
+    if (stream->read(&count, 4, 1) != 1)
+        return false;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Properties* space = new Properties();
+        space->_parent = this;
+        _namespaces.push_back(space);
+        if (!space->readNamespace(stream, strings, stringsLength))
+            return false;
+        space->rewind();
+    }
+    return true;
+}
+
+bool Properties::writeBinary(Stream* stream, unsigned int sourceSize, unsigned int sourceHash) const
+{
+    GP_ASSERT(stream);
+
+    StringTable strings;
+    std::string data;
+    addStrings(strings, data);
+
+    unsigned int header[3] = { sourceSize, sourceHash, (unsigned int)data.length() };
+    if (stream->write(PROPERTIES_IDENTIFIER, 1, sizeof(PROPERTIES_IDENTIFIER)) != sizeof(PROPERTIES_IDENTIFIER) ||
+        stream->write(PROPERTIES_VERSION, 1, sizeof(PROPERTIES_VERSION)) != sizeof(PROPERTIES_VERSION) ||
+        stream->write(header, 4, 3) != 3 ||
+        stream->write(data.c_str(), 1, data.length()) != data.length())
+    {
+        return false;
+    }
+    writeNamespace(stream, strings);
+    return true;
+}
+
+void Properties::addString(StringTable& strings, std::string& data, const std::string& str)
+{
+    if (strings.find(str) == strings.end())
+    {
+        strings[str] = (unsigned int)data.length();
+        data.append(str.c_str(), str.length() + 1);
+    }
+}
+
+void Properties::addStrings(StringTable& strings, std::string& data) const
+{
+    addString(strings, data, _namespace);
+    addString(strings, data, _id);
+    addString(strings, data, _parentID);
+    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+    {
+        addString(strings, data, itr->name);
+        addString(strings, data, itr->value);
+    }
+    if (_variables)
+    {
+        for (size_t i = 0, count = _variables->size(); i < count; ++i)
+        {
+            addString(strings, data, (*_variables)[i].name);
+            addString(strings, data, (*_variables)[i].value);
+        }
+    }
+    for (size_t i = 0, count = _namespaces.size(); i < count; ++i)
+    {
+        _namespaces[i]->addStrings(strings, data);
+    }
+}
+
+void Properties::writeNamespace(Stream* stream, const StringTable& strings) const
+{
+    unsigned int header[4] = { strings.at(_namespace), strings.at(_id), strings.at(_parentID), (unsigned int)_properties.size() };
+    stream->write(header, 4, 4);
+    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+    {
+        Property property = *itr;
+        if (!property.parsed)
+            parseValue(property);
+
+        unsigned int offsets[2] = { strings.at(property.name), strings.at(property.value) };
+        unsigned char flags[4] = { 1, property.colorComponents, (unsigned char)property.numbers.size(), 0 };
+        stream->write(offsets, 4, 2);
+        stream->write(flags, 1, 4);
+        stream->write(&property.color, 4, 1);
+        if (!property.numbers.empty())
+            stream->write(&property.numbers[0], 4, property.numbers.size());
+    }
+
+    unsigned int count = _variables ? (unsigned int)_variables->size() : 0;
+    stream->write(&count, 4, 1);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int offsets[2] = { strings.at((*_variables)[i].name), strings.at((*_variables)[i].value) };
+        stream->write(offsets, 4, 2);
+    }
+
+    count = (unsigned int)_namespaces.size();
+    stream->write(&count, 4, 1);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _namespaces[i]->writeNamespace(stream, strings);
+    }
+}
+
+void Properties::parseValue(Property& property)
+{
+    // The numbers are read like the typed getters read them with sscanf, which stops at
+    // the first number that isn't directly followed by a comma.
+    property.numbers.clear();
+    const char* str = property.value.c_str();
+    while (property.numbers.size() < 16)
+    {
+        float number;
+        int length = 0;
+        if (sscanf(str, "%f%n", &number, &length) != 1)
+            break;
+        property.numbers.push_back(number);
+        str += length;
+        if (*str != ',')
+            break;
+        ++str;
+    }
+
+    size_t length = property.value.length();
+    unsigned int color;
+    property.colorComponents = 0;
+    if ((length == 7 || length == 9) && property.value[0] == '#' && sscanf(property.value.c_str() + 1, "%x", &color) == 1)
+    {
+        property.color = color;
+        property.colorComponents = length == 7 ? 3 : 4;
+    }
+    property.parsed = true;
+}
+
+const Properties::Property* Properties::findProperty(const char* name) const
+{
+    if (!name)
+        return _propertiesItr != _properties.end() ? &(*_propertiesItr) : NULL;
+
+    // The index is built by the first lookup after the properties are read or replaced.
+    if (!_indexed)
+    {
+        _index.clear();
+        for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+        {
+            _index.insert(std::make_pair(itr->name, const_cast<Property*>(&(*itr))));
+        }
+        _indexed = true;
+    }
+
+    std::unordered_map<std::string, Property*>::const_iterator itr = _index.find(name);
+    return itr != _index.end() ? itr->second : NULL;
+}
+
+const Properties::Property* Properties::getParsedProperty(const char* name) const
+{
+    char variable[256];
+    if (name && isVariable(name, variable, 256))
+        return NULL;
+
+    const Property* property = findProperty(name);
+    if (!property || isVariable(property->value.c_str(), variable, 256))
+        return NULL;
+
+    // Values are parsed once, by the first typed getter that reads them.
+    if (!property->parsed)
+        parseValue(const_cast<Property&>(*property));
+    return property;
+}
+
 void Properties::readProperties(Stream* stream)
 {
     GP_ASSERT(stream);
@@ -477,6 +871,7 @@ void Properties::resolveInheritance(const char* id)
 
                 // Copy data from the parent into the child.
                 derived->_properties = parent->_properties;
+                derived->_indexed = false;
                 derived->_namespaces = std::vector<Properties*>();
                 std::vector<Properties*>::const_iterator itt;
                 for (itt = parent->_namespaces.begin(); itt < parent->_namespaces.end(); ++itt)
@@ -637,13 +1032,7 @@ bool Properties::exists(const char* name) const
     if (name == NULL)
         return false;
 
-    for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
-    {
-        if (itr->name == name)
-            return true;
-    }
-
-    return false;
+    return findProperty(name) != NULL;
 }
 
 static const bool isStringNumeric(const char* str)
@@ -727,14 +1116,9 @@ const char* Properties::getString(const char* name, const char* defaultValue) co
             return getVariable(variable, defaultValue);
         }
 
-        for (std::list<Property>::const_iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
-        {
-            if (itr->name == name)
-            {
-                value = itr->value.c_str();
-                break;
-            }
-        }
+        const Property* property = findProperty(name);
+        if (property)
+            value = property->value.c_str();
     }
     else
     {
@@ -761,18 +1145,19 @@ bool Properties::setString(const char* name, const char* value)
 {
     if (name)
     {
-        for (std::list<Property>::iterator itr = _properties.begin(); itr != _properties.end(); ++itr)
+        Property* property = const_cast<Property*>(findProperty(name));
+        if (property)
         {
-            if (itr->name == name)
-            {
-                // Update the first property that matches this name
-                itr->value = value ? value : "";
-                return true;
-            }
+            // Update the first property that matches this name
+            property->value = value ? value : "";
+            property->parsed = false;
+            return true;
         }
 
         // There is no property with this name, so add one
         _properties.push_back(Property(name, value ? value : ""));
+        if (_indexed)
+            _index[_properties.back().name] = &_properties.back();
     }
     else
     {
@@ -781,6 +1166,7 @@ bool Properties::setString(const char* name, const char* value)
             return false;
 
         _propertiesItr->value = value ? value : "";
+        _propertiesItr->parsed = false;
     }
 
     return true;
@@ -818,6 +1204,10 @@ int Properties::getInt(const char* name) const
 
 float Properties::getFloat(const char* name) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && !property->numbers.empty())
+        return property->numbers[0];
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -858,6 +1248,13 @@ bool Properties::getMatrix(const char* name, Matrix* out) const
 {
     GP_ASSERT(out);
 
+    const Property* property = getParsedProperty(name);
+    if (property && property->numbers.size() >= 16)
+    {
+        out->set(&property->numbers[0]);
+        return true;
+    }
+
     const char* valueString = getString(name);
     if (valueString)
     {
@@ -884,31 +1281,73 @@ bool Properties::getMatrix(const char* name, Matrix* out) const
 
 bool Properties::getVector2(const char* name, Vector2* out) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && property->numbers.size() >= 2)
+    {
+        if (out)
+            out->set(property->numbers[0], property->numbers[1]);
+        return true;
+    }
     return parseVector2(getString(name), out);
 }
 
 bool Properties::getVector3(const char* name, Vector3* out) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && property->numbers.size() >= 3)
+    {
+        if (out)
+            out->set(property->numbers[0], property->numbers[1], property->numbers[2]);
+        return true;
+    }
     return parseVector3(getString(name), out);
 }
 
 bool Properties::getVector4(const char* name, Vector4* out) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && property->numbers.size() >= 4)
+    {
+        if (out)
+            out->set(property->numbers[0], property->numbers[1], property->numbers[2], property->numbers[3]);
+        return true;
+    }
     return parseVector4(getString(name), out);
 }
 
 bool Properties::getQuaternionFromAxisAngle(const char* name, Quaternion* out) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && property->numbers.size() >= 4)
+    {
+        if (out)
+            out->set(Vector3(property->numbers[0], property->numbers[1], property->numbers[2]), MATH_DEG_TO_RAD(property->numbers[3]));
+        return true;
+    }
     return parseAxisAngle(getString(name), out);
 }
 
 bool Properties::getColor(const char* name, Vector3* out) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && property->colorComponents == 3)
+    {
+        if (out)
+            out->set(Vector3::fromColor(property->color));
+        return true;
+    }
     return parseColor(getString(name), out);
 }
 
 bool Properties::getColor(const char* name, Vector4* out) const
 {
+    const Property* property = getParsedProperty(name);
+    if (property && property->colorComponents == 4)
+    {
+        if (out)
+            out->set(Vector4::fromColor(property->color));
+        return true;
+    }
     return parseColor(getString(name), out);
 }
 
@@ -1015,6 +1454,7 @@ Properties* Properties::clone()
     p->_parentID = _parentID;
     p->_properties = _properties;
     p->_propertiesItr = p->_properties.end();
+    p->_indexed = false;
     p->setDirectoryPath(_dirPath);
 
     for (size_t i = 0, count = _namespaces.size(); i < count; i++)
@@ -126,6 +126,7 @@ class Properties;
 class Properties
 {
     friend class Game;
+    friend class ListView;
 
 public:
 
@@ -155,6 +156,40 @@ public:
      */
     static Properties* create(const char* url);
 
+    /**
+     * Compiles a properties file into the binary form that create() loads without parsing text.
+     *
+     * Inheritance is resolved while compiling, and the numbers, vectors, matrices and colors
+     * of properties are stored already parsed. A compiled file can replace its text file under
+     * the same name, since create() recognizes compiled files by their identifier.
+     *
+     * @param path The path of the properties file to compile.
+     * @param compiledPath The path of the compiled file to write.
+     *
+     * @return True if the file was compiled, false otherwise.
+     * @script{ignore}
+     */
+    static bool compile(const char* path, const char* compiledPath);
+
+    /**
+     * Sets whether create() caches the compiled form of the text files it loads, each in a file
+     * named after its text file with ".gpp" appended, such as "game.scene.gpp".
+     *
+     * A cached file is loaded instead of its text file as long as the size and hash of the text
+     * file match those it was compiled from, and is compiled again otherwise. Cached files are written
+     * under the resource path, and aren't written where it is read-only. Caching is disabled by default.
+     *
+     * @param enabled true to cache compiled files, false otherwise.
+     */
+    static void setCacheEnabled(bool enabled);
+
+    /**
+     * Determines if create() caches the compiled form of the text files it loads.
+     *
+     * @return true if compiled files are cached, false otherwise.
+     */
+    static bool isCacheEnabled();
+
     /**
      * Destructor.
      */
@@ -515,9 +550,21 @@ private:
     {
         std::string name;
         std::string value;
-        Property(const char* name, const char* value) : name(name), value(value) { }
+        // The comma-separated numbers the value starts with, up to 16, and the color it specifies,
+        // if parsed is true. They are parsed by the first typed getter that reads the property,
+        // and compiled files store them parsed.
+        std::vector<float> numbers;
+        unsigned int color;
+        unsigned char colorComponents;
+        bool parsed;
+        Property(const char* name, const char* value) : name(name), value(value), color(0), colorComponents(0), parsed(false) { }
     };
 
+    /**
+     * Maps each string of a compiled file to its offset in the string table.
+     */
+    typedef std::unordered_map<std::string, unsigned int> StringTable;
+
     /**
      * Constructor.
      */
@@ -555,11 +602,68 @@ private:
     // Called after create(); copies info from parents into derived namespaces.
     void resolveInheritance(const char* id = NULL);
 
+    /**
+     * Loads the properties from a stream over a text or compiled file, using or updating the
+     * cached compiled file of a text file if caching is enabled.
+     */
+    static Properties* load(Stream* stream, const char* path);
+
+    /**
+     * Reads a compiled file, which must have been compiled from a text file of the given size and hash unless both are zero.
+     *
+     * @return The root namespace, or NULL if the file isn't a valid compiled file or was compiled from another text file.
+     */
+    static Properties* readBinary(Stream* stream, unsigned int sourceSize, unsigned int sourceHash);
+
+    /**
+     * Writes the namespace and all of its children as a compiled file.
+     */
+    bool writeBinary(Stream* stream, unsigned int sourceSize, unsigned int sourceHash) const;
+
+    /**
+     * Adds the strings of this namespace and its children to the string table of a compiled file.
+     */
+    void addStrings(StringTable& strings, std::string& data) const;
+
+    /**
+     * Adds a string to the string table of a compiled file, unless it is already there.
+     */
+    static void addString(StringTable& strings, std::string& data, const std::string& str);
+
+    /**
+     * Writes this namespace and its children to a compiled file.
+     */
+    void writeNamespace(Stream* stream, const StringTable& strings) const;
+
+    /**
+     * Reads this namespace and its children from a compiled file.
+     */
+    bool readNamespace(Stream* stream, const char* strings, unsigned int stringsLength);
+
+    /**
+     * Parses the numbers and color of a property value.
+     */
+    static void parseValue(Property& property);
+
+    /**
+     * Returns the property with the given name, or the current property if name is NULL.
+     */
+    const Property* findProperty(const char* name) const;
+
+    /**
+     * Returns the property with the given name, after parsing its numbers and color if they
+     * haven't been yet, or NULL if it doesn't exist or references a variable.
+     */
+    const Property* getParsedProperty(const char* name) const;
+
     std::string _namespace;
     std::string _id;
     std::string _parentID;
     std::list<Property> _properties;
     std::list<Property>::iterator _propertiesItr;
+    // Maps the name of each property to the first property with that name, once it is built by a lookup.
+    mutable std::unordered_map<std::string, Property*> _index;
+    mutable bool _indexed;
     std::vector<Properties*> _namespaces;
     std::vector<Properties*>::const_iterator _namespacesItr;
     std::vector<Property>* _variables;
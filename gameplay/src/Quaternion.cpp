@@ -1,5 +1,6 @@
 #include "Base.h"
 #include "Quaternion.h"
+#include "MathUtil.h"
 
 namespace gameplay
 {
@@ -321,6 +322,19 @@ void Quaternion::slerp(const Quaternion& q1, const Quaternion& q2, float t, Quat
     slerp(q1.x, q1.y, q1.z, q1.w, q2.x, q2.y, q2.z, q2.w, t, &dst->x, &dst->y, &dst->z, &dst->w);
 }
 
+void Quaternion::slerp(const Quaternion* q1, const Quaternion* q2, float t, unsigned int count, Quaternion* dst)
+{
+    GP_ASSERT(q1 && q2 && dst);
+    GP_ASSERT(!(t < 0.0f || t > 1.0f));
+
+#if defined(GP_USE_FAST_SLERP)
+    MathUtil::slerpQuaternions(&q1->x, &q2->x, t, &dst->x, count);
+#else
+    for (unsigned int i = 0; i < count; ++i)
+        slerp(q1[i].x, q1[i].y, q1[i].z, q1[i].w, q2[i].x, q2[i].y, q2[i].z, q2[i].w, t, &dst[i].x, &dst[i].y, &dst[i].z, &dst[i].w);
+#endif
+}
+
 void Quaternion::squad(const Quaternion& q1, const Quaternion& q2, const Quaternion& s1, const Quaternion& s2, float t, Quaternion* dst)
 {
     GP_ASSERT(!(t < 0.0f || t > 1.0f));
@@ -335,10 +349,6 @@ void Quaternion::squad(const Quaternion& q1, const Quaternion& q2, const Quatern
 
 void Quaternion::slerp(float q1x, float q1y, float q1z, float q1w, float q2x, float q2y, float q2z, float q2w, float t, float* dstx, float* dsty, float* dstz, float* dstw)
 {
-    // Fast slerp implementation by kwhatmough:
-    // It contains no division operations, no trig, no inverse trig
-    // and no sqrt. Not only does this code tolerate small constraint
-    // errors in the input quaternions, it actually corrects for them.
     GP_ASSERT(dstx && dsty && dstz && dstw);
     GP_ASSERT(!(t < 0.0f || t > 1.0f));
 
@@ -368,6 +378,55 @@ void Quaternion::slerp(float q1x, float q1y, float q1z, float q1w, float q2x, fl
         return;
     }
 
+#if defined(GP_USE_FAST_SLERP)
+    float q1[4] = { q1x, q1y, q1z, q1w };
+    float q2[4] = { q2x, q2y, q2z, q2w };
+    float dst[4];
+    MathUtil::slerpQuaternions(q1, q2, t, dst, 1);
+    *dstx = dst[0];
+    *dsty = dst[1];
+    *dstz = dst[2];
+    *dstw = dst[3];
+#elif defined(GP_USE_EXACT_SLERP)
+    // The shorter arc is taken by negating q2 when the quaternions are more than 90 degrees
+    // apart, and nearly equal quaternions are lerped, where sin(theta) would lose precision.
+    float cosTheta = q1w * q2w + q1x * q2x + q1y * q2y + q1z * q2z;
+    float sign = 1.0f;
+    if (cosTheta < 0.0f)
+    {
+        cosTheta = -cosTheta;
+        sign = -1.0f;
+    }
+
+    float r1, r2;
+    if (cosTheta > 0.9995f)
+    {
+        r1 = 1.0f - t;
+        r2 = t;
+    }
+    else
+    {
+        float theta = acos(cosTheta);
+        float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+        r1 = sin((1.0f - t) * theta) / sinTheta;
+        r2 = sin(t * theta) / sinTheta;
+    }
+    r2 *= sign;
+
+    float x = r1 * q1x + r2 * q2x;
+    float y = r1 * q1y + r2 * q2y;
+    float z = r1 * q1z + r2 * q2z;
+    float w = r1 * q1w + r2 * q2w;
+    float n = 1.0f / sqrt(x * x + y * y + z * z + w * w);
+    *dstx = x * n;
+    *dsty = y * n;
+    *dstz = z * n;
+    *dstw = w * n;
+#else
+    // Fast slerp implementation by kwhatmough:
+    // It contains no division operations, no trig, no inverse trig
+    // and no sqrt. Not only does this code tolerate small constraint
+    // errors in the input quaternions, it actually corrects for them.
     float halfY, alpha, beta;
     float u, f1, f2a, f2b;
     float ratio1, ratio2;
@@ -430,7 +489,31 @@ void Quaternion::slerp(float q1x, float q1y, float q1z, float q1w, float q2x, fl
     *dstx = x * f1;
     *dsty = y * f1;
     *dstz = z * f1;
+#endif
+}
+
+#if defined(GP_USE_FAST_SLERP)
+/**
+ * Approximates acos(x) with the polynomial of Abramowitz and Stegun, to within 7e-5 radians.
+ */
+static float acosApprox(float x)
+{
+    float a = fabs(x);
+    float r = sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f - a * 0.0187293f)));
+    return x < 0.0f ? MATH_PI - r : r;
+}
+
+/**
+ * Approximates sin(x) for x in [0, pi], which is reflected onto [0, pi / 2] for its Taylor series.
+ */
+static float sinApprox(float x)
+{
+    if (x > MATH_PIOVER2)
+        x = MATH_PI - x;
+    float x2 = x * x;
+    return x * (1.0f + x2 * (-0.166666667f + x2 * (0.00833333333f + x2 * (-0.000198412698f + x2 * 0.00000275573192f))));
 }
+#endif
 
 void Quaternion::slerpForSquad(const Quaternion& q1, const Quaternion& q2, float t, Quaternion* dst)
 {
@@ -451,7 +534,11 @@ void Quaternion::slerpForSquad(const Quaternion& q1, const Quaternion& q2, float
         return;
     }
 
+#if defined(GP_USE_FAST_SLERP)
+    float omega = acosApprox(c);
+#else
     float omega = acos(c);
+#endif
     float s = sqrt(1.0f - c * c);
     if (fabs(s) <= 0.00001f)
     {
@@ -462,8 +549,13 @@ void Quaternion::slerpForSquad(const Quaternion& q1, const Quaternion& q2, float
         return;
     }
 
+#if defined(GP_USE_FAST_SLERP)
+    float r1 = sinApprox((1 - t) * omega) / s;
+    float r2 = sinApprox(t * omega) / s;
+#else
     float r1 = sin((1 - t) * omega) / s;
     float r2 = sin(t * omega) / s;
+#endif
     dst->x = (q1.x * r1 + q2.x * r2);
     dst->y = (q1.y * r1 + q2.y * r2);
     dst->z = (q1.z * r1 + q2.z * r2);
@@ -38,7 +38,7 @@ class Matrix;
  * q4 = (-0.8, 0.0, -0.6, 0.0).
  * For the point p = (1.0, 1.0, 1.0), the following figures show the trajectories of p using lerp, slerp, and squad.
  */
-class Quaternion
+class GP_MATH_ALIGN Quaternion
 {
     friend class Curve;
     friend class Transform;
@@ -346,7 +346,23 @@ public:
      * @param dst A quaternion to store the result in.
      */
     static void slerp(const Quaternion& q1, const Quaternion& q2, float t, Quaternion* dst);
-    
+
+    /**
+     * Interpolates between two arrays of quaternions using spherical linear interpolation,
+     * with the same interpolation coefficient for each pair.
+     *
+     * When built with GP_USE_FAST_SLERP, the arrays are interpolated with SIMD where it is
+     * available. The destination may be either source array.
+     *
+     * @param q1 The first quaternions.
+     * @param q2 The second quaternions.
+     * @param t The interpolation coefficient.
+     * @param count The number of quaternions in each array.
+     * @param dst The array to store the results in.
+     * @script{ignore}
+     */
+    static void slerp(const Quaternion* q1, const Quaternion* q2, float t, unsigned int count, Quaternion* dst);
+
     /**
      * Interpolates over a series of quaternions using spherical spline interpolation.
      *
@@ -0,0 +1,538 @@
+#include "Base.h"
+#include "RenderQueue.h"
+#include "Scene.h"
+#include "Node.h"
+#include "Model.h"
+#include "MeshPart.h"
+#include "Technique.h"
+#include "Pass.h"
+#include "Terrain.h"
+#include "Sprite.h"
+#include "Text.h"
+#include "TileSet.h"
+#include "SpriteBatch.h"
+#include "OcclusionBuffer.h"
+#include "Game.h"
+
+// Items are drawn in ascending order of their 64-bit sort keys. The highest bit separates
+// translucent items from opaque items. Opaque items are then sorted by effect, texture and
+// pass, and finally front-to-back. Translucent items are sorted back-to-front first.
+#define RENDER_QUEUE_TRANSLUCENT (1ULL << 63)
+#define RENDER_QUEUE_EFFECT_BITS 12
+#define RENDER_QUEUE_TEXTURE_BITS 12
+#define RENDER_QUEUE_PASS_BITS 15
+#define RENDER_QUEUE_DEPTH_BITS 24
+
+namespace gameplay
+{
+
+RenderQueue::RenderQueue()
+    : _camera(NULL), _occlusion(NULL), _multiview(false), _depthPrePass(false), _scene(NULL), _sorted(true)
+{
+    Properties* graphicsConfig = Game::getInstance()->getConfig()->getNamespace("graphics", true);
+    _depthPrePass = graphicsConfig && graphicsConfig->exists("depthPrePass") && graphicsConfig->getBool("depthPrePass");
+}
+
+RenderQueue::~RenderQueue()
+{
+    setViews(NULL, NULL, 0);
+    SAFE_RELEASE(_camera);
+}
+
+RenderQueue* RenderQueue::create()
+{
+    return new RenderQueue();
+}
+
+void RenderQueue::setCamera(Camera* camera)
+{
+    if (_camera != camera)
+    {
+        SAFE_RELEASE(_camera);
+        _camera = camera;
+        if (_camera)
+            _camera->addRef();
+    }
+}
+
+Camera* RenderQueue::getCamera() const
+{
+    return _camera;
+}
+
+void RenderQueue::setOcclusionBuffer(OcclusionBuffer* occlusion)
+{
+    _occlusion = occlusion;
+}
+
+OcclusionBuffer* RenderQueue::getOcclusionBuffer() const
+{
+    return _occlusion;
+}
+
+void RenderQueue::setDepthPrePassEnabled(bool enabled)
+{
+    _depthPrePass = enabled;
+}
+
+bool RenderQueue::isDepthPrePassEnabled() const
+{
+    return _depthPrePass;
+}
+
+void RenderQueue::setViews(Camera* const* cameras, const Rectangle* viewports, unsigned int count, bool multiview)
+{
+    GP_ASSERT(cameras || count == 0);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        GP_ASSERT(cameras[i]);
+        cameras[i]->addRef();
+    }
+    for (size_t i = 0, viewCount = _views.size(); i < viewCount; ++i)
+    {
+        SAFE_RELEASE(_views[i].camera);
+    }
+
+    _views.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _views[i].camera = cameras[i];
+        _views[i].viewport = viewports ? viewports[i] : Rectangle();
+    }
+    _multiview = multiview;
+    if (count > 0)
+        setCamera(cameras[0]);
+}
+
+unsigned int RenderQueue::getViewCount() const
+{
+    return (unsigned int)_views.size();
+}
+
+Camera* RenderQueue::getViewCamera(unsigned int index) const
+{
+    GP_ASSERT(index < _views.size());
+    return _views[index].camera;
+}
+
+bool RenderQueue::isMultiviewSupported()
+{
+    static int __multiviewSupported = -1;
+    if (__multiviewSupported == -1)
+    {
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        __multiviewSupported = (extensions && strstr(extensions, "GL_OVR_multiview")) ? 1 : 0;
+    }
+    return __multiviewSupported == 1;
+}
+
+void RenderQueue::add(Node* node)
+{
+    GP_ASSERT(node);
+
+    Drawable* drawable = node->getDrawable();
+    if (!drawable)
+        return;
+
+    if (!_scene)
+        _scene = node->getScene();
+
+    float depth = getDepth(node);
+    Model* model = dynamic_cast<Model*>(drawable);
+    if (model)
+    {
+        add(model, depth);
+        return;
+    }
+
+    // Other drawables bind their own state, so they can only be sorted by depth.
+    unsigned long long quantized = (unsigned long long)(depth * ((1 << RENDER_QUEUE_DEPTH_BITS) - 1));
+    Item item;
+    item.drawable = drawable;
+    item.part = NULL;
+    item.technique = NULL;
+    item.sprites = false;
+    if (dynamic_cast<Terrain*>(drawable))
+    {
+        item.key = quantized;
+    }
+    else
+    {
+        // Sprites, text and tile sets are drawn with merged sprite batches, and sprites at
+        // the same depth are sorted by texture so that those of an atlas are drawn together.
+        unsigned long long texture = 0;
+        Sprite* sprite = dynamic_cast<Sprite*>(drawable);
+        if (sprite)
+            texture = getId(_textureIds, sprite->getSampler()->getTexture()) & ((1 << RENDER_QUEUE_TEXTURE_BITS) - 1);
+        item.sprites = sprite || dynamic_cast<Text*>(drawable) || dynamic_cast<TileSet*>(drawable);
+
+        quantized = ((1 << RENDER_QUEUE_DEPTH_BITS) - 1) - quantized;
+        item.key = RENDER_QUEUE_TRANSLUCENT | (quantized << (63 - RENDER_QUEUE_DEPTH_BITS)) | (texture << RENDER_QUEUE_PASS_BITS);
+    }
+    _items.push_back(item);
+    _sorted = false;
+}
+
+void RenderQueue::add(Scene* scene, bool cull)
+{
+    GP_ASSERT(scene);
+
+    if (!_camera)
+        setCamera(scene->getActiveCamera());
+    _scene = scene;
+
+    // Every view culls the nodes gathered by a single visit of the scene.
+    std::vector<const Frustum*> frusta;
+    if (cull && !_views.empty())
+    {
+        for (size_t i = 0, count = _views.size(); i < count; ++i)
+            frusta.push_back(&_views[i].camera->getFrustum());
+    }
+    else if (cull && _camera)
+    {
+        frusta.push_back(&_camera->getFrustum());
+    }
+    const Frustum* frustum = frusta.empty() ? NULL : frusta[0];
+    OcclusionBuffer* occlusion = frusta.size() == 1 ? _occlusion : NULL;
+    if (frustum && occlusion)
+        occlusion->rasterize(_camera);
+
+    SpatialIndex* spatialIndex = scene->getSpatialIndex();
+    if (frustum && spatialIndex)
+    {
+        std::vector<Node*> nodes;
+        if (occlusion)
+            spatialIndex->findNodes(*frustum, *occlusion, nodes);
+        else
+            spatialIndex->findNodes(*frustum, nodes);
+        if (frusta.size() > 1)
+        {
+            // Nodes that several views see are only added once.
+            for (size_t i = 1, count = frusta.size(); i < count; ++i)
+                spatialIndex->findNodes(*frusta[i], nodes);
+            std::sort(nodes.begin(), nodes.end());
+            nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+        }
+        for (size_t i = 0, count = nodes.size(); i < count; ++i)
+        {
+            Node* node = nodes[i];
+            if (node->getDrawable() && node->isEnabledInHierarchy())
+                add(node);
+        }
+    }
+    else if (frustum)
+    {
+        // The nodes with drawables are gathered and then culled together.
+        scene->visit(this, &RenderQueue::visitNode, true);
+        cullNodes(&frusta[0], (unsigned int)frusta.size());
+    }
+    else
+    {
+        scene->visit(this, &RenderQueue::visitNode, false);
+    }
+}
+
+bool RenderQueue::visitNode(Node* node, bool cull)
+{
+    if (!node->isEnabled())
+        return false;
+
+    if (node->getDrawable())
+    {
+        if (cull)
+            _cullNodes.push_back(node);
+        else
+            add(node);
+    }
+
+    return true;
+}
+
+void RenderQueue::cullNodes(const Frustum* const* frusta, unsigned int frustumCount)
+{
+    GP_ASSERT(frusta && frustumCount > 0);
+
+    unsigned int count = (unsigned int)_cullNodes.size();
+    if (count == 0)
+        return;
+
+    // The plane cache is indexed by the order that the nodes are visited in, which
+    // only changes when nodes are added or removed, so it stays useful between frames.
+    // Each view has a cache of its own.
+    unsigned int words = (count + 31) / 32;
+    _cullBounds.resize(count);
+    _cullPlanes.resize(count * frustumCount, 0);
+    _cullVisibility.resize(words);
+    for (unsigned int i = 0; i < count; ++i)
+        _cullBounds[i] = _cullNodes[i]->getBoundingSphere();
+
+    frusta[0]->cull(&_cullBounds[0], count, &_cullVisibility[0], &_cullPlanes[0]);
+    if (frustumCount > 1)
+    {
+        // A node is visible if any view sees it.
+        _cullViewVisibility.resize(words);
+        for (unsigned int i = 1; i < frustumCount; ++i)
+        {
+            frusta[i]->cull(&_cullBounds[0], count, &_cullViewVisibility[0], &_cullPlanes[i * count]);
+            for (unsigned int j = 0; j < words; ++j)
+                _cullVisibility[j] |= _cullViewVisibility[j];
+        }
+    }
+
+    OcclusionBuffer* occlusion = frustumCount == 1 ? _occlusion : NULL;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        // Occlusion culling only applies when culling against the frustum of a single view.
+        if ((_cullVisibility[i >> 5] & (1u << (i & 31))) && (!occlusion || occlusion->isVisible(_cullBounds[i])))
+            add(_cullNodes[i]);
+    }
+    _cullNodes.clear();
+}
+
+void RenderQueue::add(Model* model, float depth)
+{
+    GP_ASSERT(model);
+
+    Mesh* mesh = model->selectLOD(_camera);
+    GP_ASSERT(mesh);
+
+    unsigned int partCount = mesh->getPartCount();
+    if (partCount == 0)
+    {
+        if (model->_material)
+            add(model, NULL, model->_material, depth);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < partCount; ++i)
+        {
+            Material* material = model->getMaterial(i);
+            if (material)
+                add(model, mesh->getPart(i), material, depth);
+        }
+    }
+}
+
+void RenderQueue::add(Model* model, MeshPart* part, Material* material, float depth)
+{
+    Technique* technique = material->getReadyTechnique();
+    if (technique == NULL || technique->getPassCount() == 0)
+        return;
+
+    // Sort techniques with several passes by their first pass.
+    Pass* pass = technique->getPassByIndex(0);
+    GP_ASSERT(pass);
+
+    unsigned long long effect = getId(_effectIds, pass->getEffect()) & ((1 << RENDER_QUEUE_EFFECT_BITS) - 1);
+    unsigned long long texture = getId(_textureIds, getTexture(pass)) & ((1 << RENDER_QUEUE_TEXTURE_BITS) - 1);
+    unsigned long long passId = getId(_passIds, pass) & ((1 << RENDER_QUEUE_PASS_BITS) - 1);
+    unsigned long long quantized = (unsigned long long)(depth * ((1 << RENDER_QUEUE_DEPTH_BITS) - 1));
+
+    Item item;
+    item.drawable = model;
+    item.part = part;
+    item.technique = technique;
+    item.sprites = false;
+    if (pass->isBlendEnabled())
+    {
+        quantized = ((1 << RENDER_QUEUE_DEPTH_BITS) - 1) - quantized;
+        item.key = RENDER_QUEUE_TRANSLUCENT |
+                   (quantized << (63 - RENDER_QUEUE_DEPTH_BITS)) |
+                   (effect << (RENDER_QUEUE_TEXTURE_BITS + RENDER_QUEUE_PASS_BITS)) |
+                   (texture << RENDER_QUEUE_PASS_BITS) |
+                   passId;
+    }
+    else
+    {
+        item.key = (effect << (63 - RENDER_QUEUE_EFFECT_BITS)) |
+                   (texture << (RENDER_QUEUE_PASS_BITS + RENDER_QUEUE_DEPTH_BITS)) |
+                   (passId << RENDER_QUEUE_DEPTH_BITS) |
+                   quantized;
+    }
+    _items.push_back(item);
+    _sorted = false;
+}
+
+unsigned int RenderQueue::getItemCount() const
+{
+    return (unsigned int)_items.size();
+}
+
+void RenderQueue::sort()
+{
+    if (!_sorted)
+    {
+        std::sort(_items.begin(), _items.end(), compareItems);
+        _sorted = true;
+    }
+}
+
+unsigned int RenderQueue::draw(bool wireframe)
+{
+    sort();
+
+    if (_views.empty())
+    {
+        drawItems(wireframe);
+        return (unsigned int)_items.size();
+    }
+
+    std::vector<Matrix> viewProjections(_views.size());
+    for (size_t i = 0, count = _views.size(); i < count; ++i)
+        viewProjections[i] = _views[i].camera->getViewProjectionMatrix();
+    RenderState::setViewProjectionMatrices(&viewProjections[0], (unsigned int)viewProjections.size());
+
+    // The camera of a view is made active without notifying the listeners of the scene, so
+    // that the auto bindings of the items resolve for that view. With multi-view draws, the
+    // first view serves the shaders that do not select their view.
+    Camera* activeCamera = _scene ? _scene->_activeCamera : NULL;
+    if (_multiview && isMultiviewSupported())
+    {
+        if (_scene)
+            _scene->_activeCamera = _views[0].camera;
+        drawItems(wireframe);
+    }
+    else
+    {
+        Game* game = Game::getInstance();
+        Rectangle viewport = game->getViewport();
+        for (size_t i = 0, count = _views.size(); i < count; ++i)
+        {
+            const View& view = _views[i];
+            if (!view.viewport.isEmpty())
+                game->setViewport(view.viewport);
+            if (_scene)
+                _scene->_activeCamera = view.camera;
+            drawItems(wireframe);
+        }
+        game->setViewport(viewport);
+    }
+    if (_scene)
+        _scene->_activeCamera = activeCamera;
+
+    RenderState::setViewProjectionMatrices(NULL, 0);
+    return (unsigned int)_items.size();
+}
+
+void RenderQueue::drawItems(bool wireframe)
+{
+    // Wireframes don't occlude, so they are drawn without a pre-pass.
+    bool depthPrePass = _depthPrePass && !wireframe && !_items.empty() && !(_items[0].key & RENDER_QUEUE_TRANSLUCENT);
+    if (depthPrePass)
+    {
+        drawDepthPrePass();
+        RenderState::StateBlock::setDefaultDepthFunction(RenderState::DEPTH_LEQUAL);
+    }
+
+    // Consecutive sprites, text and tile sets share their draws where they can.
+    bool merging = false;
+    for (size_t i = 0, count = _items.size(); i < count; ++i)
+    {
+        const Item& item = _items[i];
+        if (item.sprites != merging)
+        {
+            merging = item.sprites;
+            if (merging)
+                SpriteBatch::beginMerging();
+            else
+                SpriteBatch::endMerging();
+        }
+
+        if (item.technique)
+        {
+            Model* model = static_cast<Model*>(item.drawable);
+            for (unsigned int j = 0, passCount = item.technique->getPassCount(); j < passCount; ++j)
+            {
+                model->drawPass(item.part, item.technique->getPassByIndex(j), wireframe);
+            }
+        }
+        else
+        {
+            item.drawable->draw(wireframe);
+        }
+    }
+    if (merging)
+        SpriteBatch::endMerging();
+
+    if (depthPrePass)
+        RenderState::StateBlock::setDefaultDepthFunction(RenderState::DEPTH_LESS);
+}
+
+void RenderQueue::drawDepthPrePass()
+{
+    Model::setDepthPrePass(true);
+    GL_ASSERT( glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE) );
+
+    for (size_t i = 0, count = _items.size(); i < count && !(_items[i].key & RENDER_QUEUE_TRANSLUCENT); ++i)
+    {
+        const Item& item = _items[i];
+        if (item.technique)
+            static_cast<Model*>(item.drawable)->drawPass(item.part, item.technique->getPassByIndex(0), false);
+        else
+            item.drawable->draw(false);
+    }
+
+    GL_ASSERT( glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
+    Model::setDepthPrePass(false);
+}
+
+void RenderQueue::clear()
+{
+    _items.clear();
+    _effectIds.clear();
+    _textureIds.clear();
+    _passIds.clear();
+    _scene = NULL;
+    _sorted = true;
+}
+
+bool RenderQueue::compareItems(const Item& a, const Item& b)
+{
+    return a.key < b.key;
+}
+
+float RenderQueue::getDepth(Node* node) const
+{
+    if (!_camera)
+        return 0.0f;
+
+    // Use the center of the bounds since the origin of a node may lie far outside of its geometry.
+    Vector3 position;
+    _camera->getViewMatrix().transformPoint(node->getBoundingSphere().center, &position);
+    float nearPlane = _camera->getNearPlane();
+    float farPlane = _camera->getFarPlane();
+    float depth = (-position.z - nearPlane) / (farPlane - nearPlane);
+    return MATH_CLAMP(depth, 0.0f, 1.0f);
+}
+
+unsigned int RenderQueue::getId(std::unordered_map<const void*, unsigned int>& ids, const void* object)
+{
+    if (!object)
+        return 0;
+
+    // Ids are handed out in the order objects are first seen, starting at 1.
+    std::unordered_map<const void*, unsigned int>::iterator itr = ids.find(object);
+    if (itr != ids.end())
+        return itr->second;
+
+    unsigned int id = (unsigned int)ids.size() + 1;
+    ids[object] = id;
+    return id;
+}
+
+Texture* RenderQueue::getTexture(Pass* pass)
+{
+    for (RenderState* rs = pass; rs != NULL; rs = rs->_parent)
+    {
+        for (size_t i = 0, count = rs->_parameters.size(); i < count; ++i)
+        {
+            Texture::Sampler* sampler = rs->_parameters[i]->getSampler();
+            if (sampler && sampler->getTexture())
+                return sampler->getTexture();
+        }
+    }
+    return NULL;
+}
+
+}
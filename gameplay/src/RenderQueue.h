@@ -0,0 +1,339 @@
+#ifndef RENDERQUEUE_H_
+#define RENDERQUEUE_H_
+
+#include "Camera.h"
+#include "Rectangle.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+class Drawable;
+class Model;
+class MeshPart;
+class Material;
+class Technique;
+class Pass;
+class Texture;
+class OcclusionBuffer;
+
+/**
+ * Defines a queue of draw items that are sorted to minimize render state changes before being drawn.
+ *
+ * Instead of drawing each node as soon as it is reached while visiting a scene, the nodes
+ * that pass culling are added to a render queue. Every pass of every mesh part of a model
+ * becomes a separate draw item with a 64-bit sort key. Opaque items are sorted by effect,
+ * texture and pass before being sorted front-to-back, which minimizes program, texture and
+ * state block changes and lets the depth test reject hidden fragments early. Translucent
+ * items, which are items whose pass has blending enabled, are drawn after all opaque items
+ * and sorted back-to-front.
+ *
+ * Drawables other than models are drawn as a whole: terrains are drawn along with the opaque
+ * items and all other drawables, such as particle emitters, text and sprites, are drawn along
+ * with the translucent items. Sprites at the same depth are sorted by texture, and consecutive
+ * sprites, text and tile sets are drawn with merged sprite batches, so that those sharing a
+ * texture and render state take a single draw call.
+ *
+ * Techniques that have more than one pass are kept together in a single item so that their
+ * passes are still drawn in order.
+ *
+ * A queue can lay down the depth of its opaque items in a depth pre-pass before drawing them.
+ * The pre-pass draws every opaque model and terrain with the depth variants of their
+ * effects, with color writes disabled, and the items are then shaded with the DEPTH_LEQUAL
+ * depth function, so that expensive fragment shaders run about once per pixel however much
+ * of the geometry overlaps. Passes that set another depth function, or that do not test or
+ * write depth, are only drawn when shading. The pre-pass is disabled by default, and can be
+ * enabled with the 'depthPrePass' property of the 'graphics' namespace in the game
+ * configuration file.
+ *
+ * A queue can draw several views of the same scene, such as the two eyes of a stereo display
+ * or the players of a split screen, from a single pass of culling and sorting. When the views
+ * are drawn into the layers of a multi-view frame buffer and OVR_multiview is supported, every
+ * item is submitted once for all views, and shaders select their view with the multi-view
+ * auto bindings of RenderState. Otherwise, the sorted items are drawn into the viewport of
+ * each view in turn.
+ *
+ * The queue does not hold references to the nodes or drawables it contains, so it
+ * should be filled, drawn and cleared within a single frame.
+ *
+ * @script{ignore}
+ */
+class RenderQueue
+{
+public:
+
+    /**
+     * Creates a new, empty render queue.
+     *
+     * @return A new render queue.
+     */
+    static RenderQueue* create();
+
+    /**
+     * Destructor.
+     */
+    ~RenderQueue();
+
+    /**
+     * Sets the camera used to compute the depth of items that are added to the queue.
+     *
+     * This camera is also used for culling when adding a scene to the queue.
+     * If no camera is set, items are not sorted by depth.
+     *
+     * @param camera The camera to sort items with.
+     */
+    void setCamera(Camera* camera);
+
+    /**
+     * Returns the camera used to compute the depth of items that are added to the queue.
+     *
+     * @return The camera, or NULL if no camera is set.
+     */
+    Camera* getCamera() const;
+
+    /**
+     * Sets the occlusion buffer used to cull nodes when adding a scene to the queue.
+     *
+     * When a scene is added with culling, the occluders of the buffer are rasterized for
+     * the camera of the queue first, and nodes that they hide are not added. The queue
+     * does not own the buffer.
+     *
+     * @param occlusion The occlusion buffer, or NULL to only cull against the view frustum.
+     */
+    void setOcclusionBuffer(OcclusionBuffer* occlusion);
+
+    /**
+     * Returns the occlusion buffer used to cull nodes when adding a scene to the queue.
+     *
+     * @return The occlusion buffer, or NULL if none is set.
+     */
+    OcclusionBuffer* getOcclusionBuffer() const;
+
+    /**
+     * Sets whether the opaque items are drawn in a depth pre-pass before being shaded.
+     *
+     * @param enabled True to lay down depth before shading.
+     *
+     * @see Effect::getDepthEffect
+     */
+    void setDepthPrePassEnabled(bool enabled);
+
+    /**
+     * Returns whether the opaque items are drawn in a depth pre-pass before being shaded.
+     *
+     * @return True if a depth pre-pass is drawn.
+     */
+    bool isDepthPrePassEnabled() const;
+
+    /**
+     * Sets the views that the queue is culled for and drawn into.
+     *
+     * Scenes added with culling keep the nodes that are visible in any of the views, and
+     * the first view sorts the items and selects the levels of detail of models. The camera
+     * of the queue is set to the camera of the first view. Occlusion culling only applies
+     * to a single view.
+     *
+     * When multiview is true and supported, the caller binds a frame buffer whose layers are
+     * attached with glFramebufferTextureMultiviewOVR, one per view, and the viewports are
+     * ignored. Otherwise each view is drawn into its viewport, with its camera made active.
+     *
+     * @param cameras The camera of each view.
+     * @param viewports The viewport of each view, or NULL to draw every view into the whole viewport of the game.
+     * @param count The number of views, or 0 to draw a single view with the camera of the queue.
+     * @param multiview True to draw all views with single draws, if supported.
+     *
+     * @see RenderState::VIEW_PROJECTION_MATRICES
+     * @see isMultiviewSupported
+     */
+    void setViews(Camera* const* cameras, const Rectangle* viewports, unsigned int count, bool multiview = false);
+
+    /**
+     * Returns the number of views that the queue is drawn into.
+     *
+     * @return The number of views set with setViews, or 0 if none are set.
+     */
+    unsigned int getViewCount() const;
+
+    /**
+     * Returns the camera of the view at the given index.
+     *
+     * @param index The index of the view.
+     *
+     * @return The camera of the view.
+     */
+    Camera* getViewCamera(unsigned int index) const;
+
+    /**
+     * Returns whether OVR_multiview is supported to draw all views with single draws.
+     *
+     * @return true if the device supports OVR_multiview.
+     */
+    static bool isMultiviewSupported();
+
+    /**
+     * Adds the drawable attached to the given node to the queue.
+     *
+     * Nothing is added if the node has no drawable. The node is not culled.
+     *
+     * @param node The node to add.
+     */
+    void add(Node* node);
+
+    /**
+     * Adds the drawables of all enabled nodes of the given scene to the queue.
+     *
+     * If no camera has been set on the queue, the active camera of the scene is used.
+     * Nodes are culled against the frustum of the camera, and the occlusion buffer if one
+     * is set, when cull is true. The spatial index of the scene is used for culling if it
+     * is enabled.
+     *
+     * @param scene The scene to add.
+     * @param cull True to skip nodes that are outside of the view frustum of the camera.
+     */
+    void add(Scene* scene, bool cull = true);
+
+    /**
+     * Returns the number of items in the queue.
+     *
+     * @return The number of items.
+     */
+    unsigned int getItemCount() const;
+
+    /**
+     * Sorts the items of the queue by their sort key.
+     *
+     * The queue is sorted automatically when it is drawn, so calling this
+     * method directly is only necessary before inspecting the order of items.
+     */
+    void sort();
+
+    /**
+     * Sorts and draws all items in the queue.
+     *
+     * The items remain in the queue, so the same items can be drawn
+     * again, for example into another frame buffer.
+     *
+     * @param wireframe True to draw meshes with wireframe, if supported.
+     *
+     * @return The number of items drawn.
+     */
+    unsigned int draw(bool wireframe = false);
+
+    /**
+     * Removes all items from the queue.
+     */
+    void clear();
+
+private:
+
+    /**
+     * A mesh part of a model drawn with all passes of a technique,
+     * or a whole drawable if the technique is NULL.
+     */
+    struct Item
+    {
+        unsigned long long key;
+        Drawable* drawable;
+        MeshPart* part;
+        Technique* technique;
+        bool sprites;
+    };
+
+    /**
+     * A view that the queue is drawn into.
+     */
+    struct View
+    {
+        Camera* camera;
+        Rectangle viewport;
+    };
+
+    /**
+     * Constructor.
+     */
+    RenderQueue();
+
+    /**
+     * Hidden copy constructor.
+     */
+    RenderQueue(const RenderQueue& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    RenderQueue& operator=(const RenderQueue&);
+
+    /**
+     * Adds an item for every pass of every mesh part of the given model.
+     */
+    void add(Model* model, float depth);
+
+    /**
+     * Adds an item that draws the given part of the model with the given material.
+     */
+    void add(Model* model, MeshPart* part, Material* material, float depth);
+
+    /**
+     * Visits the nodes of a scene being added to the queue, and gathers those that
+     * have a drawable to be culled by cullNodes if cull is true.
+     */
+    bool visitNode(Node* node, bool cull);
+
+    /**
+     * Culls the gathered nodes against the frustum of every view as a batch, and adds those
+     * that intersect any of them and are not hidden by the occlusion buffer.
+     */
+    void cullNodes(const Frustum* const* frusta, unsigned int frustumCount);
+
+    /**
+     * Draws the sorted items once, into the bound frame buffer and viewport.
+     */
+    void drawItems(bool wireframe);
+
+    /**
+     * Lays down the depth of the opaque items, which are the first items once sorted.
+     */
+    void drawDepthPrePass();
+
+    /**
+     * Compares the sort keys of two items.
+     */
+    static bool compareItems(const Item& a, const Item& b);
+
+    /**
+     * Returns the depth of the given node in the range [0, 1] from the near to the far plane of the camera.
+     */
+    float getDepth(Node* node) const;
+
+    /**
+     * Returns a small integer that identifies the given object within the queue.
+     */
+    static unsigned int getId(std::unordered_map<const void*, unsigned int>& ids, const void* object);
+
+    /**
+     * Returns the first texture bound by the given pass, if any.
+     */
+    static Texture* getTexture(Pass* pass);
+
+    Camera* _camera;
+    OcclusionBuffer* _occlusion;
+    std::vector<View> _views;
+    bool _multiview;
+    bool _depthPrePass;
+    Scene* _scene;
+    std::vector<Item> _items;
+    std::unordered_map<const void*, unsigned int> _effectIds;
+    std::unordered_map<const void*, unsigned int> _textureIds;
+    std::unordered_map<const void*, unsigned int> _passIds;
+    bool _sorted;
+    std::vector<Node*> _cullNodes;
+    std::vector<BoundingSphere> _cullBounds;
+    std::vector<unsigned char> _cullPlanes;
+    std::vector<unsigned int> _cullVisibility;
+    std::vector<unsigned int> _cullViewVisibility;
+};
+
+}
+
+#endif
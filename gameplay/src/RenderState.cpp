@@ -1,10 +1,12 @@
 #include "Base.h"
 #include "RenderState.h"
+#include "RenderStats.h"
 #include "Node.h"
 #include "Pass.h"
 #include "Technique.h"
 #include "Node.h"
 #include "Scene.h"
+#include "Model.h"
 
 // Render state override bits
 #define RS_BLEND 1
@@ -22,26 +24,92 @@
 
 #define RS_ALL_ONES 0xFFFFFFFF
 
+// The number of lights of each type that the light auto bindings bind per node
+#define RENDERSTATE_MAX_NODE_LIGHTS 8
+
 namespace gameplay
 {
 
 RenderState::StateBlock* RenderState::StateBlock::_defaultState = NULL;
+static RenderState::DepthFunction __defaultDepthFunction = RenderState::DEPTH_LESS;
 std::vector<RenderState::AutoBindingResolver*> RenderState::_customAutoBindingResolvers;
+unsigned int RenderState::_parametersVersion = 1;
+unsigned int RenderState::_autoBindingResolversVersion = 1;
+const float* RenderState::_objectBlockData = NULL;
+std::vector<Matrix> RenderState::_viewProjectionMatrices;
+static Texture::Sampler* __whiteLightmap = NULL;
+
+#ifdef GP_USE_UNIFORM_BUFFERS
+
+// Contents of the per-frame uniform block (std140 layout).
+struct FrameBlock
+{
+    Matrix viewMatrix;
+    Matrix projectionMatrix;
+    Matrix viewProjectionMatrix;
+    Vector4 cameraWorldPosition;
+    Vector4 cameraViewPosition;
+    Vector4 ambientColor;
+};
+
+// Contents of the per-object uniform block (std140 layout).
+struct ObjectBlock
+{
+    Matrix worldMatrix;
+    Matrix worldViewMatrix;
+    Matrix worldViewProjectionMatrix;
+    Matrix inverseTransposeWorldMatrix;
+    Matrix inverseTransposeWorldViewMatrix;
+};
+
+static GLuint __frameBlockBuffer = 0;
+static GLuint __objectBlockBuffer = 0;
+static FrameBlock __frameBlock;
+static ObjectBlock __objectBlock;
+
+// Uploads the given block contents into the buffer attached to the given binding point,
+// creating the buffer on first use. Nothing is uploaded if the contents did not change.
+static void updateUniformBlock(GLuint* buffer, GLuint binding, void* current, const void* data, size_t size)
+{
+    if (*buffer == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, buffer) );
+        GL_ASSERT( glBindBuffer(GL_UNIFORM_BUFFER, *buffer) );
+        GL_ASSERT( glBufferData(GL_UNIFORM_BUFFER, size, data, GL_DYNAMIC_DRAW) );
+        GL_ASSERT( glBindBufferBase(GL_UNIFORM_BUFFER, binding, *buffer) );
+    }
+    else if (memcmp(current, data, size) != 0)
+    {
+        GL_ASSERT( glBindBuffer(GL_UNIFORM_BUFFER, *buffer) );
+        GL_ASSERT( glBufferSubData(GL_UNIFORM_BUFFER, 0, size, data) );
+        RenderStats::count(RenderStats::BUFFER_BINDS);
+    }
+    else
+    {
+        return;
+    }
+    memcpy(current, data, size);
+}
+
+#endif
 
 RenderState::RenderState()
-    : _nodeBinding(NULL), _state(NULL), _parent(NULL)
+    : _nodeBinding(NULL), _state(NULL), _nodeLights(NULL), _parent(NULL), _boundParametersVersion(0), _autoBindingsVersion(0)
 {
 }
 
 RenderState::~RenderState()
 {
     SAFE_RELEASE(_state);
+    SAFE_DELETE(_nodeLights);
 
     // Destroy all the material parameters
     for (size_t i = 0, count = _parameters.size(); i < count; ++i)
     {
         SAFE_RELEASE(_parameters[i]);
     }
+    if (!_parameters.empty())
+        ++_parametersVersion;
 }
 
 void RenderState::initialize()
@@ -55,27 +123,47 @@ void RenderState::initialize()
 void RenderState::finalize()
 {
     SAFE_RELEASE(StateBlock::_defaultState);
+    SAFE_RELEASE(__whiteLightmap);
+
+#ifdef GP_USE_UNIFORM_BUFFERS
+    if (__frameBlockBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &__frameBlockBuffer) );
+        __frameBlockBuffer = 0;
+    }
+    if (__objectBlockBuffer)
+    {
+        GL_ASSERT( glDeleteBuffers(1, &__objectBlockBuffer) );
+        __objectBlockBuffer = 0;
+    }
+#endif
 }
 
 MaterialParameter* RenderState::getParameter(const char* name) const
 {
     GP_ASSERT(name);
 
-    // Search for an existing parameter with this name.
+    return getParameterById(MaterialParameter::getId(name));
+}
+
+MaterialParameter* RenderState::getParameterById(unsigned int id) const
+{
+    // Search for an existing parameter with this id.
     MaterialParameter* param;
     for (size_t i = 0, count = _parameters.size(); i < count; ++i)
     {
         param = _parameters[i];
         GP_ASSERT(param);
-        if (strcmp(param->getName(), name) == 0)
+        if (param->_id == id)
         {
             return param;
         }
     }
 
     // Create a new parameter and store it in our list.
-    param = new MaterialParameter(name);
+    param = new MaterialParameter(MaterialParameter::getIdName(id));
     _parameters.push_back(param);
+    ++_parametersVersion;
 
     return param;
 }
@@ -94,17 +182,20 @@ void RenderState::addParameter(MaterialParameter* param)
 {
     _parameters.push_back(param);
     param->addRef();
+    ++_parametersVersion;
 }
 
 void RenderState::removeParameter(const char* name)
 {
+    unsigned int id = MaterialParameter::getId(name);
     for (size_t i = 0, count = _parameters.size(); i < count; ++i)
     {
         MaterialParameter* p = _parameters[i];
-        if (p->_name == name)
+        if (p->_id == id)
         {
             _parameters.erase(_parameters.begin() + i);
             SAFE_RELEASE(p);
+            ++_parametersVersion;
             break;
         }
     }
@@ -151,9 +242,75 @@ const char* autoBindingToString(RenderState::AutoBinding autoBinding)
     case RenderState::MATRIX_PALETTE:
         return "MATRIX_PALETTE";
 
+    case RenderState::DUAL_QUATERNION_PALETTE:
+        return "DUAL_QUATERNION_PALETTE";
+
     case RenderState::SCENE_AMBIENT_COLOR:
         return "SCENE_AMBIENT_COLOR";
 
+    case RenderState::LIGHT_CLUSTER_TEXTURE:
+        return "LIGHT_CLUSTER_TEXTURE";
+
+    case RenderState::LIGHT_CLUSTER_PARAMETERS:
+        return "LIGHT_CLUSTER_PARAMETERS";
+
+    case RenderState::DIRECTIONAL_LIGHT_DIRECTION:
+        return "DIRECTIONAL_LIGHT_DIRECTION";
+
+    case RenderState::DIRECTIONAL_LIGHT_COLOR:
+        return "DIRECTIONAL_LIGHT_COLOR";
+
+    case RenderState::POINT_LIGHT_POSITION:
+        return "POINT_LIGHT_POSITION";
+
+    case RenderState::POINT_LIGHT_COLOR:
+        return "POINT_LIGHT_COLOR";
+
+    case RenderState::POINT_LIGHT_RANGE_INVERSE:
+        return "POINT_LIGHT_RANGE_INVERSE";
+
+    case RenderState::SPOT_LIGHT_POSITION:
+        return "SPOT_LIGHT_POSITION";
+
+    case RenderState::SPOT_LIGHT_DIRECTION:
+        return "SPOT_LIGHT_DIRECTION";
+
+    case RenderState::SPOT_LIGHT_COLOR:
+        return "SPOT_LIGHT_COLOR";
+
+    case RenderState::SPOT_LIGHT_RANGE_INVERSE:
+        return "SPOT_LIGHT_RANGE_INVERSE";
+
+    case RenderState::SPOT_LIGHT_INNER_ANGLE_COS:
+        return "SPOT_LIGHT_INNER_ANGLE_COS";
+
+    case RenderState::SPOT_LIGHT_OUTER_ANGLE_COS:
+        return "SPOT_LIGHT_OUTER_ANGLE_COS";
+
+    case RenderState::SHADOW_MAP_TEXTURE:
+        return "SHADOW_MAP_TEXTURE";
+
+    case RenderState::SHADOW_MATRICES:
+        return "SHADOW_MATRICES";
+
+    case RenderState::SHADOW_CASCADE_SPLITS:
+        return "SHADOW_CASCADE_SPLITS";
+
+    case RenderState::SHADOW_PARAMETERS:
+        return "SHADOW_PARAMETERS";
+
+    case RenderState::VIEW_PROJECTION_MATRICES:
+        return "VIEW_PROJECTION_MATRICES";
+
+    case RenderState::WORLD_VIEW_PROJECTION_MATRICES:
+        return "WORLD_VIEW_PROJECTION_MATRICES";
+
+    case RenderState::LIGHTMAP_TEXTURE:
+        return "LIGHTMAP_TEXTURE";
+
+    case RenderState::LIGHTMAP_SCALE_OFFSET:
+        return "LIGHTMAP_SCALE_OFFSET";
+
     default:
         return "";
     }
@@ -187,6 +344,10 @@ void RenderState::setParameterAutoBinding(const char* name, const char* autoBind
     {
         applyAutoBinding(name, autoBinding);
     }
+    else
+    {
+        _autoBindingsVersion = 0;
+    }
 }
 
 void RenderState::setStateBlock(StateBlock* state)
@@ -220,9 +381,13 @@ void RenderState::setNodeBinding(Node* node)
     {
         _nodeBinding = node;
 
-        if (_nodeBinding)
+        // The built-in auto bindings read the bound node when they are bound, so once every
+        // auto binding resolved to one of them, binding another node only swaps the pointer.
+        // This keeps materials that are shared by many models cheap to rebind for every draw.
+        if (_nodeBinding && _autoBindingsVersion != _autoBindingResolversVersion)
         {
             // Apply all existing auto-bindings using this node.
+            _autoBindingsVersion = _autoBindingResolversVersion;
             std::map<std::string, std::string>::const_iterator itr = _autoBindings.begin();
             while (itr != _autoBindings.end())
             {
@@ -247,7 +412,8 @@ void RenderState::applyAutoBinding(const char* uniformName, const char* autoBind
     {
         if (_customAutoBindingResolvers[i]->resolveAutoBinding(autoBinding, _nodeBinding, param))
         {
-            // Handled by custom auto binding resolver
+            // Handled by custom auto binding resolver, which may have bound the node itself.
+            _autoBindingsVersion = 0;
             bound = true;
             break;
         }
@@ -290,6 +456,14 @@ void RenderState::applyAutoBinding(const char* uniformName, const char* autoBind
         {
             param->bindValue(this, &RenderState::autoBindingGetInverseTransposeWorldViewMatrix);
         }
+        else if (strcmp(autoBinding, "VIEW_PROJECTION_MATRICES") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetViewProjectionMatrices, &RenderState::autoBindingGetViewCount);
+        }
+        else if (strcmp(autoBinding, "WORLD_VIEW_PROJECTION_MATRICES") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetWorldViewProjectionMatrices, &RenderState::autoBindingGetViewCount);
+        }
         else if (strcmp(autoBinding, "CAMERA_WORLD_POSITION") == 0)
         {
             param->bindValue(this, &RenderState::autoBindingGetCameraWorldPosition);
@@ -302,10 +476,109 @@ void RenderState::applyAutoBinding(const char* uniformName, const char* autoBind
         {
             param->bindValue(this, &RenderState::autoBindingGetMatrixPalette, &RenderState::autoBindingGetMatrixPaletteSize);
         }
+        else if (strcmp(autoBinding, "DUAL_QUATERNION_PALETTE") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetDualQuaternionPalette, &RenderState::autoBindingGetDualQuaternionPaletteSize);
+        }
         else if (strcmp(autoBinding, "SCENE_AMBIENT_COLOR") == 0)
         {
             param->bindValue(this, &RenderState::autoBindingGetAmbientColor);
         }
+        else if (strcmp(autoBinding, "LIGHT_CLUSTER_TEXTURE") == 0)
+        {
+            // A sampler can't be bound to nothing, so the clusters must exist when the binding is resolved.
+            if (hasLightClusters(autoBinding))
+                param->bindValue(this, &RenderState::autoBindingGetLightClusterTexture);
+            else
+                bound = false;
+        }
+        else if (strcmp(autoBinding, "LIGHT_CLUSTER_PARAMETERS") == 0)
+        {
+            if (hasLightClusters(autoBinding))
+                param->bindValue(this, &RenderState::autoBindingGetLightClusterParameters, &RenderState::autoBindingGetLightClusterParameterCount);
+            else
+                bound = false;
+        }
+        else if (strcmp(autoBinding, "DIRECTIONAL_LIGHT_DIRECTION") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetDirectionalLightDirection, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "DIRECTIONAL_LIGHT_COLOR") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetDirectionalLightColor, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "POINT_LIGHT_POSITION") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetPointLightPosition, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "POINT_LIGHT_COLOR") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetPointLightColor, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "POINT_LIGHT_RANGE_INVERSE") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetPointLightRangeInverse, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SPOT_LIGHT_POSITION") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetSpotLightPosition, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SPOT_LIGHT_DIRECTION") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetSpotLightDirection, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SPOT_LIGHT_COLOR") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetSpotLightColor, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SPOT_LIGHT_RANGE_INVERSE") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetSpotLightRangeInverse, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SPOT_LIGHT_INNER_ANGLE_COS") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetSpotLightInnerAngleCos, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SPOT_LIGHT_OUTER_ANGLE_COS") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetSpotLightOuterAngleCos, &RenderState::autoBindingGetNodeLightCount);
+        }
+        else if (strcmp(autoBinding, "SHADOW_MAP_TEXTURE") == 0)
+        {
+            if (hasShadowMaps(autoBinding))
+                param->bindValue(this, &RenderState::autoBindingGetShadowMapTexture);
+            else
+                bound = false;
+        }
+        else if (strcmp(autoBinding, "SHADOW_MATRICES") == 0)
+        {
+            if (hasShadowMaps(autoBinding))
+                param->bindValue(this, &RenderState::autoBindingGetShadowMatrices, &RenderState::autoBindingGetShadowMatrixCount);
+            else
+                bound = false;
+        }
+        else if (strcmp(autoBinding, "SHADOW_CASCADE_SPLITS") == 0)
+        {
+            if (hasShadowMaps(autoBinding))
+                param->bindValue(this, &RenderState::autoBindingGetShadowCascadeSplits);
+            else
+                bound = false;
+        }
+        else if (strcmp(autoBinding, "SHADOW_PARAMETERS") == 0)
+        {
+            if (hasShadowMaps(autoBinding))
+                param->bindValue(this, &RenderState::autoBindingGetShadowParameters);
+            else
+                bound = false;
+        }
+        else if (strcmp(autoBinding, "LIGHTMAP_TEXTURE") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetLightmapTexture);
+        }
+        else if (strcmp(autoBinding, "LIGHTMAP_SCALE_OFFSET") == 0)
+        {
+            param->bindValue(this, &RenderState::autoBindingGetLightmapScaleOffset);
+        }
         else
         {
             bound = false;
@@ -319,6 +592,11 @@ void RenderState::applyAutoBinding(const char* uniformName, const char* autoBind
         if (param->_type == MaterialParameter::METHOD && param->_value.method)
             param->_value.method->_autoBinding = true;
     }
+    else
+    {
+        // Try again with the next node, since shadow maps and light clusters may exist by then.
+        _autoBindingsVersion = 0;
+    }
 }
 
 const Matrix& RenderState::autoBindingGetWorldMatrix() const
@@ -361,6 +639,34 @@ const Matrix& RenderState::autoBindingGetInverseTransposeWorldViewMatrix() const
     return _nodeBinding ? _nodeBinding->getInverseTransposeWorldViewMatrix() : Matrix::identity();
 }
 
+const Matrix* RenderState::autoBindingGetViewProjectionMatrices() const
+{
+    if (!_viewProjectionMatrices.empty())
+        return &_viewProjectionMatrices[0];
+    return _nodeBinding ? &_nodeBinding->getViewProjectionMatrix() : &Matrix::identity();
+}
+
+const Matrix* RenderState::autoBindingGetWorldViewProjectionMatrices() const
+{
+    if (_viewProjectionMatrices.empty())
+        return _nodeBinding ? &_nodeBinding->getWorldViewProjectionMatrix() : &Matrix::identity();
+
+    // The matrices are only read while the parameter is bound, so one array serves all nodes.
+    static std::vector<Matrix> worldViewProjectionMatrices;
+    const Matrix& world = _nodeBinding ? _nodeBinding->getWorldMatrix() : Matrix::identity();
+    worldViewProjectionMatrices.resize(_viewProjectionMatrices.size());
+    for (size_t i = 0, count = _viewProjectionMatrices.size(); i < count; ++i)
+    {
+        Matrix::multiply(_viewProjectionMatrices[i], world, &worldViewProjectionMatrices[i]);
+    }
+    return &worldViewProjectionMatrices[0];
+}
+
+unsigned int RenderState::autoBindingGetViewCount() const
+{
+    return _viewProjectionMatrices.empty() ? 1 : (unsigned int)_viewProjectionMatrices.size();
+}
+
 Vector3 RenderState::autoBindingGetCameraWorldPosition() const
 {
     return _nodeBinding ? _nodeBinding->getActiveCameraTranslationWorld() : Vector3::zero();
@@ -395,12 +701,292 @@ unsigned int RenderState::autoBindingGetMatrixPaletteSize() const
     return 0;
 }
 
+const Vector4* RenderState::autoBindingGetDualQuaternionPalette() const
+{
+    Model* model = dynamic_cast<Model*>(_nodeBinding->getDrawable());
+    if (model)
+    {
+        MeshSkin* skin = model->getSkin();
+        if (skin)
+            return skin->getDualQuaternionPalette();
+    }
+    return NULL;
+}
+
+unsigned int RenderState::autoBindingGetDualQuaternionPaletteSize() const
+{
+    Model* model = dynamic_cast<Model*>(_nodeBinding->getDrawable());
+    if (model)
+    {
+        MeshSkin* skin = model->getSkin();
+        if (skin)
+            return skin->getDualQuaternionPaletteSize();
+    }
+    return 0;
+}
+
 const Vector3& RenderState::autoBindingGetAmbientColor() const
 {
     Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
     return scene ? scene->getAmbientColor() : Vector3::zero();
 }
 
+struct RenderState::NodeLights
+{
+    Node* node;
+    unsigned int frames[3];
+    unsigned int counts[3];
+    Light* lights[3][RENDERSTATE_MAX_NODE_LIGHTS];
+    Vector3 vectors[RENDERSTATE_MAX_NODE_LIGHTS];
+    float floats[RENDERSTATE_MAX_NODE_LIGHTS];
+};
+
+RenderState::NodeLights* RenderState::getNodeLights(unsigned int type) const
+{
+    GP_ASSERT(type >= Light::DIRECTIONAL && type <= Light::SPOT);
+
+    if (_nodeLights == NULL)
+    {
+        _nodeLights = new NodeLights();
+        _nodeLights->node = NULL;
+    }
+
+    // Find the lights once per frame, since every light auto binding of a type uses the same lights.
+    NodeLights* nodeLights = _nodeLights;
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    unsigned int index = type - Light::DIRECTIONAL;
+    if (nodeLights->node != _nodeBinding)
+    {
+        nodeLights->node = _nodeBinding;
+        for (unsigned int i = 0; i < 3; ++i)
+            nodeLights->frames[i] = UINT_MAX;
+    }
+    if (nodeLights->frames[index] != frame)
+    {
+        Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+        nodeLights->counts[index] = scene ? scene->findLights(_nodeBinding, (Light::Type)type, nodeLights->lights[index], RENDERSTATE_MAX_NODE_LIGHTS) : 0;
+        nodeLights->frames[index] = frame;
+    }
+    return nodeLights;
+}
+
+const Vector3* RenderState::autoBindingGetDirectionalLightDirection() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::DIRECTIONAL);
+    const Matrix& view = _nodeBinding ? _nodeBinding->getViewMatrix() : Matrix::identity();
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+    {
+        if (i < nodeLights->counts[0])
+            view.transformVector(nodeLights->lights[0][i]->getNode()->getForwardVectorWorld(), &nodeLights->vectors[i]);
+        else
+            nodeLights->vectors[i].set(0.0f, 0.0f, -1.0f);
+    }
+    return nodeLights->vectors;
+}
+
+const Vector3* RenderState::autoBindingGetDirectionalLightColor() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::DIRECTIONAL);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->vectors[i] = i < nodeLights->counts[0] ? nodeLights->lights[0][i]->getColor() : Vector3::zero();
+    return nodeLights->vectors;
+}
+
+const Vector3* RenderState::autoBindingGetPointLightPosition() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::POINT);
+    const Matrix& view = _nodeBinding ? _nodeBinding->getViewMatrix() : Matrix::identity();
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+    {
+        if (i < nodeLights->counts[1])
+            view.transformPoint(nodeLights->lights[1][i]->getNode()->getTranslationWorld(), &nodeLights->vectors[i]);
+        else
+            nodeLights->vectors[i].set(0.0f, 0.0f, 0.0f);
+    }
+    return nodeLights->vectors;
+}
+
+const Vector3* RenderState::autoBindingGetPointLightColor() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::POINT);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->vectors[i] = i < nodeLights->counts[1] ? nodeLights->lights[1][i]->getColor() : Vector3::zero();
+    return nodeLights->vectors;
+}
+
+const float* RenderState::autoBindingGetPointLightRangeInverse() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::POINT);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->floats[i] = i < nodeLights->counts[1] ? nodeLights->lights[1][i]->getRangeInverse() : 1.0f;
+    return nodeLights->floats;
+}
+
+const Vector3* RenderState::autoBindingGetSpotLightPosition() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::SPOT);
+    const Matrix& view = _nodeBinding ? _nodeBinding->getViewMatrix() : Matrix::identity();
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+    {
+        if (i < nodeLights->counts[2])
+            view.transformPoint(nodeLights->lights[2][i]->getNode()->getTranslationWorld(), &nodeLights->vectors[i]);
+        else
+            nodeLights->vectors[i].set(0.0f, 0.0f, 0.0f);
+    }
+    return nodeLights->vectors;
+}
+
+const Vector3* RenderState::autoBindingGetSpotLightDirection() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::SPOT);
+    const Matrix& view = _nodeBinding ? _nodeBinding->getViewMatrix() : Matrix::identity();
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+    {
+        if (i < nodeLights->counts[2])
+            view.transformVector(nodeLights->lights[2][i]->getNode()->getForwardVectorWorld(), &nodeLights->vectors[i]);
+        else
+            nodeLights->vectors[i].set(0.0f, 0.0f, -1.0f);
+    }
+    return nodeLights->vectors;
+}
+
+const Vector3* RenderState::autoBindingGetSpotLightColor() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::SPOT);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->vectors[i] = i < nodeLights->counts[2] ? nodeLights->lights[2][i]->getColor() : Vector3::zero();
+    return nodeLights->vectors;
+}
+
+const float* RenderState::autoBindingGetSpotLightRangeInverse() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::SPOT);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->floats[i] = i < nodeLights->counts[2] ? nodeLights->lights[2][i]->getRangeInverse() : 1.0f;
+    return nodeLights->floats;
+}
+
+const float* RenderState::autoBindingGetSpotLightInnerAngleCos() const
+{
+    // Unused lights get distinct cone angles so that smoothstep stays defined in the shaders.
+    NodeLights* nodeLights = getNodeLights(Light::SPOT);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->floats[i] = i < nodeLights->counts[2] ? nodeLights->lights[2][i]->getInnerAngleCos() : 1.0f;
+    return nodeLights->floats;
+}
+
+const float* RenderState::autoBindingGetSpotLightOuterAngleCos() const
+{
+    NodeLights* nodeLights = getNodeLights(Light::SPOT);
+    for (unsigned int i = 0; i < RENDERSTATE_MAX_NODE_LIGHTS; ++i)
+        nodeLights->floats[i] = i < nodeLights->counts[2] ? nodeLights->lights[2][i]->getOuterAngleCos() : 0.0f;
+    return nodeLights->floats;
+}
+
+unsigned int RenderState::autoBindingGetNodeLightCount() const
+{
+    return RENDERSTATE_MAX_NODE_LIGHTS;
+}
+
+bool RenderState::hasLightClusters(const char* autoBinding) const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    if (scene && scene->getLightClusters())
+        return true;
+
+    GP_WARN("Auto binding %s requires the node to be in a scene with light clusters enabled.", autoBinding);
+    return false;
+}
+
+const Texture::Sampler* RenderState::autoBindingGetLightClusterTexture() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    GP_ASSERT(scene && scene->getLightClusters());
+    return scene->getLightClusters()->getSampler();
+}
+
+const Vector4* RenderState::autoBindingGetLightClusterParameters() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    GP_ASSERT(scene && scene->getLightClusters());
+    return scene->getLightClusters()->getParameters();
+}
+
+unsigned int RenderState::autoBindingGetLightClusterParameterCount() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    return scene && scene->getLightClusters() ? scene->getLightClusters()->getParameterCount() : 0;
+}
+
+bool RenderState::hasShadowMaps(const char* autoBinding) const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    if (scene && scene->getShadowMaps() && scene->getShadowMaps()->getSampler())
+        return true;
+
+    GP_WARN("Auto binding %s requires the node to be in a scene with shadows enabled.", autoBinding);
+    return false;
+}
+
+const Texture::Sampler* RenderState::autoBindingGetShadowMapTexture() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    GP_ASSERT(scene && scene->getShadowMaps());
+    return scene->getShadowMaps()->getSampler();
+}
+
+const Matrix* RenderState::autoBindingGetShadowMatrices() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    GP_ASSERT(scene && scene->getShadowMaps());
+    return scene->getShadowMaps()->getMatrices();
+}
+
+unsigned int RenderState::autoBindingGetShadowMatrixCount() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    return scene && scene->getShadowMaps() ? scene->getShadowMaps()->getMatrixCount() : 0;
+}
+
+const Vector4& RenderState::autoBindingGetShadowCascadeSplits() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    GP_ASSERT(scene && scene->getShadowMaps());
+    return scene->getShadowMaps()->getCascadeSplits();
+}
+
+const Vector4& RenderState::autoBindingGetShadowParameters() const
+{
+    Scene* scene = _nodeBinding ? _nodeBinding->getScene() : NULL;
+    GP_ASSERT(scene && scene->getShadowMaps());
+    return scene->getShadowMaps()->getParameters();
+}
+
+const Texture::Sampler* RenderState::autoBindingGetLightmapTexture() const
+{
+    // The model is looked up on every draw, since materials shared by the instances of a
+    // model are bound to the node of each instance in turn.
+    Model* model = _nodeBinding ? dynamic_cast<Model*>(_nodeBinding->getDrawable()) : NULL;
+    if (model && model->getLightmap())
+        return model->getLightmap();
+
+    if (!__whiteLightmap)
+    {
+        const unsigned char white[] = { 255, 255, 255, 255 };
+        Texture* texture = Texture::create(Texture::RGBA, 1, 1, white);
+        __whiteLightmap = Texture::Sampler::create(texture);
+        SAFE_RELEASE(texture);
+    }
+    return __whiteLightmap;
+}
+
+const Vector4& RenderState::autoBindingGetLightmapScaleOffset() const
+{
+    static const Vector4 identity(1.0f, 1.0f, 0.0f, 0.0f);
+    Model* model = _nodeBinding ? dynamic_cast<Model*>(_nodeBinding->getDrawable()) : NULL;
+    return model ? model->getLightmapScaleOffset() : identity;
+}
+
 void RenderState::bind(Pass* pass)
 {
     GP_ASSERT(pass);
@@ -423,19 +1009,151 @@ void RenderState::bind(Pass* pass)
     // Apply parameter bindings and renderer state for the entire hierarchy, top-down.
     rs = NULL;
     Effect* effect = pass->getEffect();
+    GP_ASSERT(effect);
+    if (effect->_frameBlock || effect->_objectBlock)
+    {
+        bindUniformBlocks(effect);
+    }
+    if (_boundParametersVersion != _parametersVersion)
+    {
+        updateBoundParameters();
+    }
+    for (size_t i = 0, count = _boundParameters.size(); i < count; ++i)
+    {
+        _boundParameters[i]->bind(effect);
+    }
+
+    while ((rs = getTopmost(rs)))
+    {
+        if (rs->_state)
+        {
+            rs->_state->bindNoRestore();
+        }
+    }
+}
+
+void RenderState::updateBoundParameters()
+{
+    _boundParameters.clear();
+
+    RenderState* rs = NULL;
     while ((rs = getTopmost(rs)))
     {
         for (size_t i = 0, count = rs->_parameters.size(); i < count; ++i)
         {
             GP_ASSERT(rs->_parameters[i]);
-            rs->_parameters[i]->bind(effect);
+            _boundParameters.push_back(rs->_parameters[i]);
         }
+    }
+    _boundParametersVersion = _parametersVersion;
+}
 
-        if (rs->_state)
+void RenderState::bindUniformBlocks(Effect* effect)
+{
+#ifdef GP_USE_UNIFORM_BUFFERS
+    // Without a node binding the blocks keep the values of the last bound node.
+    if (_nodeBinding == NULL)
+        return;
+
+    if (effect->_frameBlock)
+    {
+        FrameBlock block;
+        block.viewMatrix = _nodeBinding->getViewMatrix();
+        block.projectionMatrix = _nodeBinding->getProjectionMatrix();
+        block.viewProjectionMatrix = _nodeBinding->getViewProjectionMatrix();
+        Vector3 cameraWorldPosition = _nodeBinding->getActiveCameraTranslationWorld();
+        block.cameraWorldPosition.set(cameraWorldPosition.x, cameraWorldPosition.y, cameraWorldPosition.z, 1.0f);
+        Vector3 cameraViewPosition = _nodeBinding->getActiveCameraTranslationView();
+        block.cameraViewPosition.set(cameraViewPosition.x, cameraViewPosition.y, cameraViewPosition.z, 1.0f);
+        Scene* scene = _nodeBinding->getScene();
+        const Vector3& ambientColor = scene ? scene->getAmbientColor() : Vector3::zero();
+        block.ambientColor.set(ambientColor.x, ambientColor.y, ambientColor.z, 1.0f);
+        updateUniformBlock(&__frameBlockBuffer, UNIFORM_BLOCK_FRAME_BINDING, &__frameBlock, &block, sizeof(FrameBlock));
+    }
+
+    if (effect->_objectBlock && _objectBlockData)
+    {
+        GP_ASSERT(sizeof(ObjectBlock) == OBJECT_BLOCK_FLOAT_COUNT * sizeof(float));
+        updateUniformBlock(&__objectBlockBuffer, UNIFORM_BLOCK_OBJECT_BINDING, &__objectBlock, _objectBlockData, sizeof(ObjectBlock));
+    }
+    else if (effect->_objectBlock)
+    {
+        ObjectBlock block;
+        block.worldMatrix = _nodeBinding->getWorldMatrix();
+        block.worldViewMatrix = _nodeBinding->getWorldViewMatrix();
+        block.worldViewProjectionMatrix = _nodeBinding->getWorldViewProjectionMatrix();
+        block.inverseTransposeWorldMatrix = _nodeBinding->getInverseTransposeWorldMatrix();
+        block.inverseTransposeWorldViewMatrix = _nodeBinding->getInverseTransposeWorldViewMatrix();
+        updateUniformBlock(&__objectBlockBuffer, UNIFORM_BLOCK_OBJECT_BINDING, &__objectBlock, &block, sizeof(ObjectBlock));
+    }
+#endif
+}
+
+void RenderState::computeObjectBlock(const Matrix& world, const Matrix& view, const Matrix& viewProjection, float* data)
+{
+    GP_ASSERT(data);
+
+    // Matches the layout of the ObjectBlock uniform block.
+    Matrix* block = reinterpret_cast<Matrix*>(data);
+    block[0] = world;
+    Matrix::multiply(view, world, &block[1]);
+    Matrix::multiply(viewProjection, world, &block[2]);
+    block[3] = world;
+    block[3].invert();
+    block[3].transpose();
+    block[4] = block[1];
+    block[4].invert();
+    block[4].transpose();
+}
+
+void RenderState::setViewProjectionMatrices(const Matrix* matrices, unsigned int count)
+{
+    GP_ASSERT(matrices || count == 0);
+    _viewProjectionMatrices.assign(matrices, matrices + count);
+}
+
+bool RenderState::isDepthPrePassCompatible() const
+{
+    if (isBlendEnabled())
+        return false;
+
+    // Depth testing is disabled and depth writing enabled unless a state block sets them.
+    bool depthTest = false;
+    bool depthWrite = true;
+    bool depthTestSet = false;
+    bool depthWriteSet = false;
+    for (const RenderState* rs = this; rs != NULL; rs = rs->_parent)
+    {
+        if (!rs->_state)
+            continue;
+
+        // Other depth functions than the default would reject the depth laid down by the pre-pass.
+        long bits = rs->_state->_bits;
+        if ((bits & RS_DEPTH_FUNC) && rs->_state->_depthFunction != DEPTH_LEQUAL)
+            return false;
+        if ((bits & RS_DEPTH_TEST) && !depthTestSet)
         {
-            rs->_state->bindNoRestore();
+            depthTest = rs->_state->_depthTestEnabled;
+            depthTestSet = true;
+        }
+        if ((bits & RS_DEPTH_WRITE) && !depthWriteSet)
+        {
+            depthWrite = rs->_state->_depthWriteEnabled;
+            depthWriteSet = true;
         }
     }
+    return depthTest && depthWrite;
+}
+
+bool RenderState::isBlendEnabled() const
+{
+    // The closest state block that sets blending wins, just like when binding top-down.
+    for (const RenderState* rs = this; rs != NULL; rs = rs->_parent)
+    {
+        if (rs->_state && (rs->_state->_bits & RS_BLEND))
+            return rs->_state->_blendEnabled;
+    }
+    return false;
 }
 
 RenderState* RenderState::getTopmost(RenderState* below)
@@ -483,6 +1201,7 @@ void RenderState::cloneInto(RenderState* renderState, NodeCloneContext& context)
         param->cloneInto(paramCopy);
 
         renderState->_parameters.push_back(paramCopy);
+        ++_parametersVersion;
     }
 
     // Clone our state block
@@ -536,6 +1255,8 @@ void RenderState::StateBlock::bindNoRestore()
 {
     GP_ASSERT(_defaultState);
 
+    RenderStats::count(RenderStats::STATE_BLOCK_BINDS);
+
     // Update any state that differs from _defaultState and flip _defaultState bits
     if ((_bits & RS_BLEND) && (_blendEnabled != _defaultState->_blendEnabled))
     {
@@ -632,71 +1353,83 @@ void RenderState::StateBlock::restore(long stateOverrideBits)
         return;
     }
 
-    // Restore any state that is not overridden and is not default
+    // Restore any state that is not overridden and is not default. State blocks may set a
+    // state to its default value, in which case there is nothing to pass to GL.
     if (!(stateOverrideBits & RS_BLEND) && (_defaultState->_bits & RS_BLEND))
     {
-        GL_ASSERT( glDisable(GL_BLEND) );
+        if (_defaultState->_blendEnabled)
+            GL_ASSERT( glDisable(GL_BLEND) );
         _defaultState->_bits &= ~RS_BLEND;
         _defaultState->_blendEnabled = false;
     }
     if (!(stateOverrideBits & RS_BLEND_FUNC) && (_defaultState->_bits & RS_BLEND_FUNC))
     {
-        GL_ASSERT( glBlendFunc(GL_ONE, GL_ZERO) );
+        if (_defaultState->_blendSrc != RenderState::BLEND_ONE || _defaultState->_blendDst != RenderState::BLEND_ZERO)
+            GL_ASSERT( glBlendFunc(GL_ONE, GL_ZERO) );
         _defaultState->_bits &= ~RS_BLEND_FUNC;
         _defaultState->_blendSrc = RenderState::BLEND_ONE;
         _defaultState->_blendDst = RenderState::BLEND_ZERO;
     }
     if (!(stateOverrideBits & RS_CULL_FACE) && (_defaultState->_bits & RS_CULL_FACE))
     {
-        GL_ASSERT( glDisable(GL_CULL_FACE) );
+        if (_defaultState->_cullFaceEnabled)
+            GL_ASSERT( glDisable(GL_CULL_FACE) );
         _defaultState->_bits &= ~RS_CULL_FACE;
         _defaultState->_cullFaceEnabled = false;
     }
     if (!(stateOverrideBits & RS_CULL_FACE_SIDE) && (_defaultState->_bits & RS_CULL_FACE_SIDE))
     {
-        GL_ASSERT( glCullFace((GLenum)GL_BACK) );
+        if (_defaultState->_cullFaceSide != RenderState::CULL_FACE_SIDE_BACK)
+            GL_ASSERT( glCullFace((GLenum)GL_BACK) );
         _defaultState->_bits &= ~RS_CULL_FACE_SIDE;
         _defaultState->_cullFaceSide = RenderState::CULL_FACE_SIDE_BACK;
     }
     if (!(stateOverrideBits & RS_FRONT_FACE) && (_defaultState->_bits & RS_FRONT_FACE))
     {
-        GL_ASSERT( glFrontFace((GLenum)GL_CCW) );
+        if (_defaultState->_frontFace != RenderState::FRONT_FACE_CCW)
+            GL_ASSERT( glFrontFace((GLenum)GL_CCW) );
         _defaultState->_bits &= ~RS_FRONT_FACE;
         _defaultState->_frontFace = RenderState::FRONT_FACE_CCW;
     }
     if (!(stateOverrideBits & RS_DEPTH_TEST) && (_defaultState->_bits & RS_DEPTH_TEST))
     {
-        GL_ASSERT( glDisable(GL_DEPTH_TEST) );
+        if (_defaultState->_depthTestEnabled)
+            GL_ASSERT( glDisable(GL_DEPTH_TEST) );
         _defaultState->_bits &= ~RS_DEPTH_TEST;
         _defaultState->_depthTestEnabled = false;
     }
     if (!(stateOverrideBits & RS_DEPTH_WRITE) && (_defaultState->_bits & RS_DEPTH_WRITE))
     {
-        GL_ASSERT( glDepthMask(GL_TRUE) );
+        if (!_defaultState->_depthWriteEnabled)
+            GL_ASSERT( glDepthMask(GL_TRUE) );
         _defaultState->_bits &= ~RS_DEPTH_WRITE;
         _defaultState->_depthWriteEnabled = true;
     }
     if (!(stateOverrideBits & RS_DEPTH_FUNC) && (_defaultState->_bits & RS_DEPTH_FUNC))
     {
-        GL_ASSERT( glDepthFunc((GLenum)GL_LESS) );
+        if (_defaultState->_depthFunction != __defaultDepthFunction)
+            GL_ASSERT( glDepthFunc((GLenum)__defaultDepthFunction) );
         _defaultState->_bits &= ~RS_DEPTH_FUNC;
-        _defaultState->_depthFunction = RenderState::DEPTH_LESS;
+        _defaultState->_depthFunction = __defaultDepthFunction;
     }
 	if (!(stateOverrideBits & RS_STENCIL_TEST) && (_defaultState->_bits & RS_STENCIL_TEST))
     {
-        GL_ASSERT( glDisable(GL_STENCIL_TEST) );
+        if (_defaultState->_stencilTestEnabled)
+            GL_ASSERT( glDisable(GL_STENCIL_TEST) );
         _defaultState->_bits &= ~RS_STENCIL_TEST;
         _defaultState->_stencilTestEnabled = false;
     }
 	if (!(stateOverrideBits & RS_STENCIL_WRITE) && (_defaultState->_bits & RS_STENCIL_WRITE))
     {
-		GL_ASSERT( glStencilMask(RS_ALL_ONES) );
+        if (_defaultState->_stencilWrite != RS_ALL_ONES)
+            GL_ASSERT( glStencilMask(RS_ALL_ONES) );
         _defaultState->_bits &= ~RS_STENCIL_WRITE;
 		_defaultState->_stencilWrite = RS_ALL_ONES;
     }
 	if (!(stateOverrideBits & RS_STENCIL_FUNC) && (_defaultState->_bits & RS_STENCIL_FUNC))
     {
-		GL_ASSERT( glStencilFunc((GLenum)RenderState::STENCIL_ALWAYS, 0, RS_ALL_ONES) );
+        if (_defaultState->_stencilFunction != RenderState::STENCIL_ALWAYS || _defaultState->_stencilFunctionRef != 0 || _defaultState->_stencilFunctionMask != RS_ALL_ONES)
+            GL_ASSERT( glStencilFunc((GLenum)RenderState::STENCIL_ALWAYS, 0, RS_ALL_ONES) );
         _defaultState->_bits &= ~RS_STENCIL_FUNC;
         _defaultState->_stencilFunction = RenderState::STENCIL_ALWAYS;
 		_defaultState->_stencilFunctionRef = 0;
@@ -704,7 +1437,8 @@ void RenderState::StateBlock::restore(long stateOverrideBits)
     }
 	if (!(stateOverrideBits & RS_STENCIL_OP) && (_defaultState->_bits & RS_STENCIL_OP))
     {
-		GL_ASSERT( glStencilOp((GLenum)RenderState::STENCIL_OP_KEEP, (GLenum)RenderState::STENCIL_OP_KEEP, (GLenum)RenderState::STENCIL_OP_KEEP) );
+        if (_defaultState->_stencilOpSfail != RenderState::STENCIL_OP_KEEP || _defaultState->_stencilOpDpfail != RenderState::STENCIL_OP_KEEP || _defaultState->_stencilOpDppass != RenderState::STENCIL_OP_KEEP)
+            GL_ASSERT( glStencilOp((GLenum)RenderState::STENCIL_OP_KEEP, (GLenum)RenderState::STENCIL_OP_KEEP, (GLenum)RenderState::STENCIL_OP_KEEP) );
         _defaultState->_bits &= ~RS_STENCIL_OP;
         _defaultState->_stencilOpSfail = RenderState::STENCIL_OP_KEEP;
 		_defaultState->_stencilOpDpfail = RenderState::STENCIL_OP_KEEP;
@@ -727,6 +1461,19 @@ void RenderState::StateBlock::enableDepthWrite()
     }
 }
 
+void RenderState::StateBlock::setDefaultDepthFunction(DepthFunction func)
+{
+    GP_ASSERT(_defaultState);
+
+    // A depth function set by a state block is replaced by the new default when it is restored.
+    __defaultDepthFunction = func;
+    if (!(_defaultState->_bits & RS_DEPTH_FUNC) && _defaultState->_depthFunction != func)
+    {
+        GL_ASSERT( glDepthFunc((GLenum)func) );
+        _defaultState->_depthFunction = func;
+    }
+}
+
 void RenderState::StateBlock::cloneInto(StateBlock* state)
 {
     GP_ASSERT(state);
@@ -1225,6 +1972,7 @@ void RenderState::StateBlock::setStencilOperation(StencilOperation sfail, Stenci
 RenderState::AutoBindingResolver::AutoBindingResolver()
 {
     _customAutoBindingResolvers.push_back(this);
+    ++_autoBindingResolversVersion;
 }
 
 RenderState::AutoBindingResolver::~AutoBindingResolver()
@@ -1232,6 +1980,7 @@ RenderState::AutoBindingResolver::~AutoBindingResolver()
     std::vector<RenderState::AutoBindingResolver*>::iterator itr = std::find(_customAutoBindingResolvers.begin(), _customAutoBindingResolvers.end(), this);
     if (itr != _customAutoBindingResolvers.end())
         _customAutoBindingResolvers.erase(itr);
+    ++_autoBindingResolversVersion;
 }
 
 }
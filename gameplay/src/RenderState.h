@@ -4,17 +4,47 @@
 #include "Ref.h"
 #include "Vector3.h"
 #include "Vector4.h"
+#include "Texture.h"
 
 namespace gameplay
 {
 
 class MaterialParameter;
+class Effect;
 class Node;
 class NodeCloneContext;
 class Pass;
 
 /**
  * Defines the rendering state of the graphics device.
+ *
+ * On desktop OpenGL, shaders may declare the built-in matrix and camera auto bindings
+ * in two std140 uniform blocks instead of as separate uniforms. The values of these blocks
+ * are kept in uniform buffers that are only updated when they change, rather than being
+ * resolved and set for every material parameter of every draw:
+ *
+ * @verbatim
+    layout(std140) uniform FrameBlock
+    {
+        mat4 u_viewMatrix;
+        mat4 u_projectionMatrix;
+        mat4 u_viewProjectionMatrix;
+        vec4 u_cameraWorldPosition;
+        vec4 u_cameraViewPosition;
+        vec4 u_ambientColor;
+    };
+
+    layout(std140) uniform ObjectBlock
+    {
+        mat4 u_worldMatrix;
+        mat4 u_worldViewMatrix;
+        mat4 u_worldViewProjectionMatrix;
+        mat4 u_inverseTransposeWorldMatrix;
+        mat4 u_inverseTransposeWorldViewMatrix;
+    };
+   @endverbatim
+ *
+ * Material parameters for uniforms that are declared within a block are ignored.
  */
 class RenderState : public Ref
 {
@@ -23,6 +53,8 @@ class RenderState : public Ref
     friend class Technique;
     friend class Pass;
     friend class Model;
+    friend class RenderQueue;
+    friend class CommandBuffer;
 
 public:
 
@@ -156,10 +188,172 @@ public:
          */
         MATRIX_PALETTE,
 
+        /**
+         * Binds the dual quaternion palette of MeshSkin attached to a node's model.
+         */
+        DUAL_QUATERNION_PALETTE,
+
         /**
          * Binds the current scene's ambient color (Vector3).
          */
-        SCENE_AMBIENT_COLOR
+        SCENE_AMBIENT_COLOR,
+
+        /**
+         * Binds the texture that the lights and light clusters of the current scene are packed into.
+         *
+         * @see LightClusters
+         */
+        LIGHT_CLUSTER_TEXTURE,
+
+        /**
+         * Binds the values (Vector4 array) that describe the light clusters of the current scene.
+         *
+         * @see LightClusters
+         */
+        LIGHT_CLUSTER_PARAMETERS,
+
+        /**
+         * Binds the view-space directions (Vector3 array) of the brightest directional lights of the node's scene.
+         *
+         * Each light auto binding binds up to 8 lights, found with Scene::findLights and ordered by
+         * their contribution, and arrays are clamped to the size of the uniform. Unused elements
+         * are set to black lights, so a shader compiled for N lights always draws the N most
+         * relevant lights of each node.
+         */
+        DIRECTIONAL_LIGHT_DIRECTION,
+
+        /**
+         * Binds the colors (Vector3 array) of the brightest directional lights of the node's scene.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        DIRECTIONAL_LIGHT_COLOR,
+
+        /**
+         * Binds the view-space positions (Vector3 array) of the point lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        POINT_LIGHT_POSITION,
+
+        /**
+         * Binds the colors (Vector3 array) of the point lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        POINT_LIGHT_COLOR,
+
+        /**
+         * Binds the inverse ranges (float array) of the point lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        POINT_LIGHT_RANGE_INVERSE,
+
+        /**
+         * Binds the view-space positions (Vector3 array) of the spot lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        SPOT_LIGHT_POSITION,
+
+        /**
+         * Binds the view-space directions (Vector3 array) of the spot lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        SPOT_LIGHT_DIRECTION,
+
+        /**
+         * Binds the colors (Vector3 array) of the spot lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        SPOT_LIGHT_COLOR,
+
+        /**
+         * Binds the inverse ranges (float array) of the spot lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        SPOT_LIGHT_RANGE_INVERSE,
+
+        /**
+         * Binds the inner cone angle cosines (float array) of the spot lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        SPOT_LIGHT_INNER_ANGLE_COS,
+
+        /**
+         * Binds the outer cone angle cosines (float array) of the spot lights that contribute the most to a node.
+         *
+         * @see DIRECTIONAL_LIGHT_DIRECTION
+         */
+        SPOT_LIGHT_OUTER_ANGLE_COS,
+
+        /**
+         * Binds the depth texture that the shadow maps of the current scene are drawn into.
+         *
+         * @see ShadowMaps
+         */
+        SHADOW_MAP_TEXTURE,
+
+        /**
+         * Binds the matrices (Matrix array) that transform view space positions to the shadow maps of the current scene.
+         *
+         * @see ShadowMaps
+         */
+        SHADOW_MATRICES,
+
+        /**
+         * Binds the view depths (Vector4) at which the shadow cascades of the current scene end.
+         *
+         * @see ShadowMaps
+         */
+        SHADOW_CASCADE_SPLITS,
+
+        /**
+         * Binds the texel size, depth bias and distance (Vector4) of the shadow maps of the current scene.
+         *
+         * @see ShadowMaps
+         */
+        SHADOW_PARAMETERS,
+
+        /**
+         * Binds the ViewProjection matrices (Matrix array) of the views that a render queue draws at once.
+         *
+         * Shaders that draw all views with a single draw, using OVR_multiview, select the
+         * matrix of their view with gl_ViewID_OVR. Outside of a multi-view draw, the array
+         * holds the ViewProjection matrix of the active camera for the node's scene.
+         *
+         * @see RenderQueue::setViews
+         */
+        VIEW_PROJECTION_MATRICES,
+
+        /**
+         * Binds a node's WorldViewProjection matrices (Matrix array) for the views that a render queue draws at once.
+         *
+         * @see VIEW_PROJECTION_MATRICES
+         */
+        WORLD_VIEW_PROJECTION_MATRICES,
+
+        /**
+         * Binds the baked lightmap of a node's model.
+         *
+         * Models without a lightmap bind a white texture, so that materials which share a
+         * lightmapped technique are still lit evenly.
+         *
+         * @see Model::setLightmap
+         */
+        LIGHTMAP_TEXTURE,
+
+        /**
+         * Binds the scale and offset (Vector4) of the area of the lightmap of a node's model.
+         *
+         * @see Model::setLightmapScaleOffset
+         */
+        LIGHTMAP_SCALE_OFFSET
     };
 
     /**
@@ -272,6 +466,8 @@ public:
     {
         friend class RenderState;
         friend class Game;
+        friend class SpriteBatch;
+        friend class RenderQueue;
 
     public:
 
@@ -440,6 +636,12 @@ public:
 
         static void enableDepthWrite();
 
+        /**
+         * Sets the depth function that is restored for render states that do not set one,
+         * which is DEPTH_LEQUAL while shading over the depth of a depth pre-pass.
+         */
+        static void setDefaultDepthFunction(DepthFunction func);
+
         void cloneInto(StateBlock* state);
 
         // States
@@ -480,6 +682,23 @@ public:
      */
     MaterialParameter* getParameter(const char* name) const;
 
+    /**
+     * Gets a MaterialParameter for the specified parameter id.
+     *
+     * This is equivalent to calling getParameter with the name of the id, but does
+     * not compare any strings, which makes it the preferred way to look parameters
+     * up every frame.
+     *
+     * Note that this method causes a new MaterialParameter to be created if one
+     * does not already exist for the given parameter id.
+     *
+     * @param id Material parameter id, as returned by MaterialParameter::getId.
+     *
+     * @return A MaterialParameter for the specified id.
+     * @script{ignore}
+     */
+    MaterialParameter* getParameterById(unsigned int id) const;
+
     /**
      * Gets the number of material parameters.
      *
@@ -607,11 +826,46 @@ protected:
      */
     void bind(Pass* pass);
 
+    /**
+     * Updates the per-frame and per-object uniform block buffers used by the given effect
+     * with the auto binding values of the node bound to this RenderState.
+     */
+    void bindUniformBlocks(Effect* effect);
+
+    /**
+     * Writes the per-object uniform block for an object with the given world matrix
+     * into the given array of OBJECT_BLOCK_FLOAT_COUNT floats.
+     *
+     * This method only reads its arguments, so it can be called from any thread.
+     */
+    static void computeObjectBlock(const Matrix& world, const Matrix& view, const Matrix& viewProjection, float* data);
+
+    /**
+     * Sets the ViewProjection matrices that the multi-view auto bindings bind, or clears them if count is 0.
+     */
+    static void setViewProjectionMatrices(const Matrix* matrices, unsigned int count);
+
+    /**
+     * Rebuilds the list of parameters bound for the hierarchy of this RenderState.
+     */
+    void updateBoundParameters();
+
     /**
      * Returns the topmost RenderState in the hierarchy below the given RenderState.
      */
     RenderState* getTopmost(RenderState* below);
 
+    /**
+     * Returns whether blending is enabled by this RenderState or one of its parents.
+     */
+    bool isBlendEnabled() const;
+
+    /**
+     * Returns whether this RenderState and its parents test and write depth with the default
+     * depth function, so that their depth can be laid down by a depth pre-pass.
+     */
+    bool isDepthPrePassCompatible() const;
+
     /**
      * Copies the data from this RenderState into the given RenderState.
      * 
@@ -632,6 +886,16 @@ private:
      */
     RenderState& operator=(const RenderState&);
 
+    /**
+     * Determines whether the scene of the bound node has light clusters, and warns if it doesn't.
+     */
+    bool hasLightClusters(const char* autoBinding) const;
+
+    /**
+     * Determines whether the scene of the bound node has shadow maps, and warns if it doesn't.
+     */
+    bool hasShadowMaps(const char* autoBinding) const;
+
     // Internal auto binding handler methods.
     const Matrix& autoBindingGetWorldMatrix() const;
     const Matrix& autoBindingGetViewMatrix() const;
@@ -645,7 +909,44 @@ private:
     Vector3 autoBindingGetCameraViewPosition() const;
     const Vector4* autoBindingGetMatrixPalette() const;
     unsigned int autoBindingGetMatrixPaletteSize() const;
+    const Vector4* autoBindingGetDualQuaternionPalette() const;
+    unsigned int autoBindingGetDualQuaternionPaletteSize() const;
     const Vector3& autoBindingGetAmbientColor() const;
+    const Texture::Sampler* autoBindingGetLightClusterTexture() const;
+    const Vector4* autoBindingGetLightClusterParameters() const;
+    unsigned int autoBindingGetLightClusterParameterCount() const;
+    const Vector3* autoBindingGetDirectionalLightDirection() const;
+    const Vector3* autoBindingGetDirectionalLightColor() const;
+    const Vector3* autoBindingGetPointLightPosition() const;
+    const Vector3* autoBindingGetPointLightColor() const;
+    const float* autoBindingGetPointLightRangeInverse() const;
+    const Vector3* autoBindingGetSpotLightPosition() const;
+    const Vector3* autoBindingGetSpotLightDirection() const;
+    const Vector3* autoBindingGetSpotLightColor() const;
+    const float* autoBindingGetSpotLightRangeInverse() const;
+    const float* autoBindingGetSpotLightInnerAngleCos() const;
+    const float* autoBindingGetSpotLightOuterAngleCos() const;
+    unsigned int autoBindingGetNodeLightCount() const;
+    const Texture::Sampler* autoBindingGetShadowMapTexture() const;
+    const Matrix* autoBindingGetShadowMatrices() const;
+    unsigned int autoBindingGetShadowMatrixCount() const;
+    const Vector4& autoBindingGetShadowCascadeSplits() const;
+    const Vector4& autoBindingGetShadowParameters() const;
+    const Matrix* autoBindingGetViewProjectionMatrices() const;
+    const Matrix* autoBindingGetWorldViewProjectionMatrices() const;
+    unsigned int autoBindingGetViewCount() const;
+    const Texture::Sampler* autoBindingGetLightmapTexture() const;
+    const Vector4& autoBindingGetLightmapScaleOffset() const;
+
+    /**
+     * The lights found for the bound node, and the values passed for them.
+     */
+    struct NodeLights;
+
+    /**
+     * Returns the lights of the given type found for the bound node in the current frame.
+     */
+    NodeLights* getNodeLights(unsigned int type) const;
     const Vector3& autoBindingGetLightColor() const;
     const Vector3& autoBindingGetLightDirection() const;
 
@@ -671,11 +972,59 @@ protected:
      */
     mutable StateBlock* _state;
 
+    /**
+     * The lights found for the bound node by the light auto bindings, or NULL.
+     */
+    mutable NodeLights* _nodeLights;
+
     /**
      * The RenderState's parent.
      */
     RenderState* _parent;
 
+    /**
+     * The parameters of this RenderState and all of its parents, top-down, in the order
+     * in which they are bound. Only used by the RenderState that is bound for a pass.
+     */
+    std::vector<MaterialParameter*> _boundParameters;
+
+    /**
+     * The value of _parametersVersion when _boundParameters was last built.
+     */
+    unsigned int _boundParametersVersion;
+
+    /**
+     * Incremented whenever parameters are added to or removed from any RenderState.
+     */
+    static unsigned int _parametersVersion;
+
+    /**
+     * The value of _autoBindingResolversVersion when the auto bindings were last applied,
+     * or 0 if they must be applied again the next time a node is bound.
+     */
+    unsigned int _autoBindingsVersion;
+
+    /**
+     * Incremented whenever a custom auto binding resolver is registered or unregistered.
+     */
+    static unsigned int _autoBindingResolversVersion;
+
+    /**
+     * The number of floats in the per-object uniform block.
+     */
+    static const unsigned int OBJECT_BLOCK_FLOAT_COUNT = 80;
+
+    /**
+     * Precomputed per-object uniform block contents to use instead of the values
+     * of the bound node, or NULL.
+     */
+    static const float* _objectBlockData;
+
+    /**
+     * The ViewProjection matrices of the views being drawn at once, if any.
+     */
+    static std::vector<Matrix> _viewProjectionMatrices;
+
     /**
      * Map of custom auto binding resolvers.
      */
@@ -0,0 +1,165 @@
+#include "Base.h"
+#include "RenderStats.h"
+#include "MemoryTracker.h"
+
+namespace gameplay
+{
+
+static unsigned int __counts[RenderStats::COUNTER_COUNT] = { 0 };
+static unsigned int __frameCounts[RenderStats::COUNTER_COUNT] = { 0 };
+static size_t __memory[RenderStats::MEMORY_COUNT] = { 0 };
+static size_t __peakMemory[RenderStats::MEMORY_COUNT] = { 0 };
+static std::unordered_map<const void*, RenderStats::Allocation> __allocations[RenderStats::MEMORY_COUNT];
+static const char* __memoryNames[RenderStats::MEMORY_COUNT] = { "texture", "vertex buffer", "index buffer", "render buffer" };
+
+static bool compareAllocations(const RenderStats::Allocation& a, const RenderStats::Allocation& b)
+{
+    return a.size > b.size;
+}
+
+unsigned int RenderStats::getCount(Counter counter)
+{
+    GP_ASSERT(counter < COUNTER_COUNT);
+    return __counts[counter];
+}
+
+size_t RenderStats::getMemory(Memory memory)
+{
+    GP_ASSERT(memory < MEMORY_COUNT);
+    return __memory[memory];
+}
+
+size_t RenderStats::getTotalMemory()
+{
+    size_t total = 0;
+    for (unsigned int i = 0; i < MEMORY_COUNT; ++i)
+    {
+        total += __memory[i];
+    }
+    return total;
+}
+
+size_t RenderStats::getPeakMemory(Memory memory)
+{
+    GP_ASSERT(memory < MEMORY_COUNT);
+    return __peakMemory[memory];
+}
+
+unsigned int RenderStats::getAllocationCount(Memory memory)
+{
+    GP_ASSERT(memory < MEMORY_COUNT);
+    return (unsigned int)__allocations[memory].size();
+}
+
+unsigned int RenderStats::getLargestAllocations(std::vector<Allocation>& allocations, unsigned int count, Memory memory)
+{
+    GP_ASSERT(memory <= MEMORY_COUNT);
+
+    std::vector<Allocation> candidates;
+    for (unsigned int i = 0; i < MEMORY_COUNT; ++i)
+    {
+        if (memory != MEMORY_COUNT && memory != i)
+            continue;
+        for (std::unordered_map<const void*, Allocation>::const_iterator itr = __allocations[i].begin(); itr != __allocations[i].end(); ++itr)
+        {
+            candidates.push_back(itr->second);
+        }
+    }
+
+    count = std::min(count, (unsigned int)candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + count, candidates.end(), compareAllocations);
+    allocations.insert(allocations.end(), candidates.begin(), candidates.begin() + count);
+    return count;
+}
+
+void RenderStats::printLargestAllocations(unsigned int count)
+{
+    std::vector<Allocation> allocations;
+    getLargestAllocations(allocations, count);
+
+    Logger::log(Logger::LEVEL_INFO, "Graphics memory: %.2f MB in %u allocations\n", getTotalMemory() / (1024.0 * 1024.0),
+        getAllocationCount(TEXTURE_MEMORY) + getAllocationCount(VERTEX_BUFFER_MEMORY) + getAllocationCount(INDEX_BUFFER_MEMORY) + getAllocationCount(RENDER_BUFFER_MEMORY));
+    for (size_t i = 0, allocationCount = allocations.size(); i < allocationCount; ++i)
+    {
+        const Allocation& allocation = allocations[i];
+        Logger::log(Logger::LEVEL_INFO, "  %10.2f KB  %-13s  %s (%p)\n", allocation.size / 1024.0, __memoryNames[allocation.memory],
+            allocation.name.empty() ? "<unnamed>" : allocation.name.c_str(), allocation.resource);
+    }
+}
+
+void RenderStats::print()
+{
+    Logger::log(Logger::LEVEL_INFO, "Draw calls: %u, program binds: %u, texture binds: %u, buffer binds: %u, state block binds: %u\n",
+        __counts[DRAW_CALLS], __counts[PROGRAM_BINDS], __counts[TEXTURE_BINDS], __counts[BUFFER_BINDS], __counts[STATE_BLOCK_BINDS]);
+    Logger::log(Logger::LEVEL_INFO, "Texture memory: %.2f MB, vertex buffer memory: %.2f MB, index buffer memory: %.2f MB, render buffer memory: %.2f MB\n",
+        __memory[TEXTURE_MEMORY] / (1024.0 * 1024.0), __memory[VERTEX_BUFFER_MEMORY] / (1024.0 * 1024.0),
+        __memory[INDEX_BUFFER_MEMORY] / (1024.0 * 1024.0), __memory[RENDER_BUFFER_MEMORY] / (1024.0 * 1024.0));
+}
+
+void RenderStats::count(Counter counter, unsigned int count)
+{
+    GP_ASSERT(counter < COUNTER_COUNT);
+    __frameCounts[counter] += count;
+}
+
+void RenderStats::addMemory(Memory memory, size_t size, const void* resource, const char* name)
+{
+    GP_ASSERT(memory < MEMORY_COUNT);
+    GP_ASSERT(resource);
+    __memory[memory] += size;
+    __peakMemory[memory] = std::max(__peakMemory[memory], __memory[memory]);
+    MemoryTracker::add(MemoryTracker::RENDER, size);
+
+    std::unordered_map<const void*, Allocation>::iterator itr = __allocations[memory].find(resource);
+    if (itr == __allocations[memory].end())
+    {
+        Allocation allocation;
+        allocation.resource = resource;
+        allocation.memory = memory;
+        allocation.size = 0;
+        itr = __allocations[memory].insert(std::make_pair(resource, allocation)).first;
+    }
+    itr->second.size += size;
+    if (name)
+        itr->second.name = name;
+}
+
+void RenderStats::removeMemory(Memory memory, size_t size, const void* resource)
+{
+    GP_ASSERT(memory < MEMORY_COUNT);
+    GP_ASSERT(__memory[memory] >= size);
+    __memory[memory] -= size;
+    MemoryTracker::remove(MemoryTracker::RENDER, size);
+
+    std::unordered_map<const void*, Allocation>::iterator itr = __allocations[memory].find(resource);
+    GP_ASSERT(itr != __allocations[memory].end() && itr->second.size >= size);
+    if (itr != __allocations[memory].end())
+    {
+        itr->second.size -= size;
+        if (itr->second.size == 0)
+            __allocations[memory].erase(itr);
+    }
+}
+
+void RenderStats::setMemoryName(const void* resource, const char* name)
+{
+    GP_ASSERT(name);
+
+    for (unsigned int i = 0; i < MEMORY_COUNT; ++i)
+    {
+        std::unordered_map<const void*, Allocation>::iterator itr = __allocations[i].find(resource);
+        if (itr != __allocations[i].end())
+            itr->second.name = name;
+    }
+}
+
+void RenderStats::endFrame()
+{
+    for (unsigned int i = 0; i < COUNTER_COUNT; ++i)
+    {
+        __counts[i] = __frameCounts[i];
+        __frameCounts[i] = 0;
+    }
+}
+
+}
@@ -0,0 +1,207 @@
+#ifndef RENDERSTATS_H_
+#define RENDERSTATS_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines counters for the rendering work done per frame and the graphics memory in use.
+ *
+ * The engine counts draw calls and the programs, textures, buffers and state blocks
+ * it binds while rendering. The counts of the frame in progress are moved into the
+ * counts returned by getCount at the end of every frame, so the values always refer
+ * to the last completed frame.
+ *
+ * The memory held by textures, by the vertex and index buffers of meshes and by
+ * the render buffers of frame buffers is tracked as they are created and destroyed.
+ * Memory sizes are estimates computed from the dimensions and formats of the
+ * resources, since OpenGL does not report how much memory the driver actually uses.
+ * Each allocation is also recorded along with the resource that holds it, so that the
+ * largest allocations can be listed when hunting down where graphics memory goes.
+ *
+ * All counters are only updated on the render thread.
+ */
+class RenderStats
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines the per-frame counters.
+     */
+    enum Counter
+    {
+        DRAW_CALLS,
+        PROGRAM_BINDS,
+        TEXTURE_BINDS,
+        BUFFER_BINDS,
+        STATE_BLOCK_BINDS,
+        COUNTER_COUNT
+    };
+
+    /**
+     * Defines the kinds of graphics memory that are tracked.
+     */
+    enum Memory
+    {
+        TEXTURE_MEMORY,
+        VERTEX_BUFFER_MEMORY,
+        INDEX_BUFFER_MEMORY,
+        RENDER_BUFFER_MEMORY,
+        MEMORY_COUNT
+    };
+
+    /**
+     * Defines the graphics memory held by a single resource.
+     *
+     * @script{ignore}
+     */
+    struct Allocation
+    {
+        /**
+         * The resource that holds the memory, such as a texture or a mesh.
+         */
+        const void* resource;
+
+        /**
+         * The kind of memory.
+         */
+        Memory memory;
+
+        /**
+         * The memory size in bytes.
+         */
+        size_t size;
+
+        /**
+         * The name of the resource, such as the path of a texture, or an empty string.
+         */
+        std::string name;
+    };
+
+    /**
+     * Returns the value of a counter for the last completed frame.
+     *
+     * @param counter The counter to return.
+     *
+     * @return The value of the counter.
+     */
+    static unsigned int getCount(Counter counter);
+
+    /**
+     * Returns the number of bytes currently held by a kind of graphics memory.
+     *
+     * @param memory The kind of memory to return.
+     *
+     * @return The memory size in bytes.
+     */
+    static size_t getMemory(Memory memory);
+
+    /**
+     * Returns the number of bytes currently held by all kinds of graphics memory.
+     *
+     * @return The memory size in bytes.
+     */
+    static size_t getTotalMemory();
+
+    /**
+     * Returns the largest number of bytes a kind of graphics memory has held at once.
+     *
+     * @param memory The kind of memory to return.
+     *
+     * @return The peak memory size in bytes.
+     */
+    static size_t getPeakMemory(Memory memory);
+
+    /**
+     * Returns the number of resources that currently hold a kind of graphics memory.
+     *
+     * @param memory The kind of memory.
+     *
+     * @return The number of allocations.
+     */
+    static unsigned int getAllocationCount(Memory memory);
+
+    /**
+     * Returns the largest allocations of graphics memory, largest first.
+     *
+     * @param allocations The vector to populate with the allocations.
+     * @param count The maximum number of allocations to return.
+     * @param memory The kind of memory, or MEMORY_COUNT to return allocations of every kind.
+     *
+     * @return The number of allocations added to the vector.
+     * @script{ignore}
+     */
+    static unsigned int getLargestAllocations(std::vector<Allocation>& allocations, unsigned int count, Memory memory = MEMORY_COUNT);
+
+    /**
+     * Prints the largest allocations of graphics memory of every kind to the log.
+     *
+     * @param count The maximum number of allocations to print.
+     */
+    static void printLargestAllocations(unsigned int count = 10);
+
+    /**
+     * Prints the counters of the last completed frame and the memory in use to the log.
+     */
+    static void print();
+
+    /**
+     * Adds to a counter of the frame in progress.
+     *
+     * @param counter The counter to increment.
+     * @param count The amount to add.
+     * @script{ignore}
+     */
+    static void count(Counter counter, unsigned int count = 1);
+
+    /**
+     * Records that graphics memory was allocated.
+     *
+     * The memory held by a resource adds up over calls, so a resource can hold several
+     * buffers of the same kind.
+     *
+     * @param memory The kind of memory.
+     * @param size The allocated size in bytes.
+     * @param resource The resource that holds the memory.
+     * @param name The name of the resource, or NULL to keep the name it was given.
+     * @script{ignore}
+     */
+    static void addMemory(Memory memory, size_t size, const void* resource, const char* name = NULL);
+
+    /**
+     * Records that graphics memory was released.
+     *
+     * @param memory The kind of memory.
+     * @param size The released size in bytes.
+     * @param resource The resource that held the memory.
+     * @script{ignore}
+     */
+    static void removeMemory(Memory memory, size_t size, const void* resource);
+
+    /**
+     * Names the allocations of a resource, for resources that are named after they are created.
+     *
+     * @param resource The resource that holds the memory.
+     * @param name The name of the resource.
+     * @script{ignore}
+     */
+    static void setMemoryName(const void* resource, const char* name);
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    RenderStats();
+
+    /**
+     * Completes the counts of the current frame. Called by the game at the end of every frame.
+     */
+    static void endFrame();
+};
+
+}
+
+#endif
@@ -1,5 +1,6 @@
 #include "Base.h"
 #include "RenderTarget.h"
+#include "RenderStats.h"
 
 namespace gameplay
 {
@@ -33,6 +34,9 @@ RenderTarget* RenderTarget::create(const char* id, unsigned int width, unsigned
         return NULL;
     }
 
+    if (id && id[0])
+        RenderStats::setMemoryName(texture, id);
+
     RenderTarget* rt = create(id, texture);
     texture->release();
 
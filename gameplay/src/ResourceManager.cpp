@@ -0,0 +1,259 @@
+#include "Base.h"
+#include "ResourceManager.h"
+#include "Ref.h"
+
+namespace gameplay
+{
+
+/**
+ * A cached resource.
+ */
+struct ResourceEntry
+{
+    Ref* resource;
+    size_t size;
+    unsigned int lastUsed;
+};
+
+typedef std::unordered_map<std::string, ResourceEntry> ResourceCache;
+
+static ResourceCache __caches[ResourceManager::TYPE_COUNT];
+static size_t __usage[ResourceManager::TYPE_COUNT] = { 0 };
+static size_t __totalUsage = 0;
+static size_t __budget = 0;
+static bool __typeBudgeted[ResourceManager::TYPE_COUNT] = { false };
+static size_t __typeBudgets[ResourceManager::TYPE_COUNT] = { 0 };
+
+// Counts the requests of resources, to order them by when they were last requested.
+static unsigned int __clock = 0;
+
+// Guards the caches, which are shared by the threads that load resources. It is recursive
+// since releasing an evicted resource can release other cached resources it references.
+static std::recursive_mutex __mutex;
+
+void ResourceManager::setMemoryBudget(size_t bytes)
+{
+    __budget = bytes;
+}
+
+size_t ResourceManager::getMemoryBudget()
+{
+    return __budget;
+}
+
+void ResourceManager::setMemoryBudget(Type type, size_t bytes)
+{
+    GP_ASSERT(type < TYPE_COUNT);
+    __typeBudgeted[type] = true;
+    __typeBudgets[type] = bytes;
+}
+
+size_t ResourceManager::getMemoryBudget(Type type)
+{
+    GP_ASSERT(type < TYPE_COUNT);
+    return __typeBudgeted[type] ? __typeBudgets[type] : __budget;
+}
+
+size_t ResourceManager::getMemoryUsage()
+{
+    return __totalUsage;
+}
+
+size_t ResourceManager::getMemoryUsage(Type type)
+{
+    GP_ASSERT(type < TYPE_COUNT);
+    return __usage[type];
+}
+
+size_t ResourceManager::getUnreferencedMemoryUsage()
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    size_t size = 0;
+    for (unsigned int i = 0; i < TYPE_COUNT; ++i)
+    {
+        for (ResourceCache::const_iterator itr = __caches[i].begin(); itr != __caches[i].end(); ++itr)
+        {
+            if (itr->second.resource->getRefCount() == 1)
+                size += itr->second.size;
+        }
+    }
+    return size;
+}
+
+unsigned int ResourceManager::getResourceCount(Type type)
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    GP_ASSERT(type < TYPE_COUNT);
+    return (unsigned int)__caches[type].size();
+}
+
+bool ResourceManager::isCached(Type type, const char* key)
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    GP_ASSERT(type < TYPE_COUNT);
+    return key && __caches[type].find(key) != __caches[type].end();
+}
+
+/**
+ * Evicts the least recently requested unreferenced resources of the given types until
+ * these types use at most the given number of bytes, or every one of them if it is zero.
+ */
+static size_t evict(const bool* types, size_t bytes)
+{
+    size_t usage = 0;
+    for (unsigned int i = 0; i < ResourceManager::TYPE_COUNT; ++i)
+    {
+        if (types[i])
+            usage += __usage[i];
+    }
+    if (usage <= bytes && bytes > 0)
+        return 0;
+
+    // Only the caches reference the resources that can be evicted.
+    struct Candidate
+    {
+        unsigned int lastUsed;
+        unsigned int type;
+        ResourceCache::iterator itr;
+        bool operator<(const Candidate& other) const { return lastUsed < other.lastUsed; }
+    };
+    std::vector<Candidate> candidates;
+    for (unsigned int i = 0; i < ResourceManager::TYPE_COUNT; ++i)
+    {
+        if (!types[i])
+            continue;
+        for (ResourceCache::iterator itr = __caches[i].begin(); itr != __caches[i].end(); ++itr)
+        {
+            if (itr->second.resource->getRefCount() == 1)
+            {
+                Candidate candidate = { itr->second.lastUsed, i, itr };
+                candidates.push_back(candidate);
+            }
+        }
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    size_t evicted = 0;
+    for (size_t i = 0, count = candidates.size(); i < count && (bytes == 0 || usage > bytes); ++i)
+    {
+        const Candidate& candidate = candidates[i];
+        ResourceEntry entry = candidate.itr->second;
+        __caches[candidate.type].erase(candidate.itr);
+        __usage[candidate.type] -= entry.size;
+        __totalUsage -= entry.size;
+        usage -= entry.size;
+        evicted += entry.size;
+        SAFE_RELEASE(entry.resource);
+    }
+    return evicted;
+}
+
+size_t ResourceManager::trim(size_t bytes)
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    bool types[TYPE_COUNT];
+    for (unsigned int i = 0; i < TYPE_COUNT; ++i)
+        types[i] = true;
+    return evict(types, bytes);
+}
+
+void ResourceManager::print()
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    static const char* names[TYPE_COUNT] = { "Textures", "Effects", "Audio buffers", "Fonts" };
+    for (unsigned int i = 0; i < TYPE_COUNT; ++i)
+    {
+        Logger::log(Logger::LEVEL_INFO, "%s: %u cached, %.2f MB\n", names[i], (unsigned int)__caches[i].size(), __usage[i] / (1024.0 * 1024.0));
+    }
+    Logger::log(Logger::LEVEL_INFO, "Resource memory: %.2f MB, unreferenced: %.2f MB, budget: %.2f MB\n",
+        __totalUsage / (1024.0 * 1024.0), getUnreferencedMemoryUsage() / (1024.0 * 1024.0), __budget / (1024.0 * 1024.0));
+}
+
+Ref* ResourceManager::find(Type type, const std::string& key)
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    GP_ASSERT(type < TYPE_COUNT);
+
+    ResourceCache::iterator itr = __caches[type].find(key);
+    if (itr == __caches[type].end())
+        return NULL;
+
+    itr->second.lastUsed = ++__clock;
+    itr->second.resource->addRef();
+    return itr->second.resource;
+}
+
+void ResourceManager::add(Type type, const std::string& key, Ref* resource, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    GP_ASSERT(type < TYPE_COUNT);
+    GP_ASSERT(resource);
+
+    // Another thread may have loaded and cached the same resource since it was looked up,
+    // in which case the resource of the caller is used without being cached.
+    if (__caches[type].find(key) != __caches[type].end())
+        return;
+
+    ResourceEntry entry = { resource, size, ++__clock };
+    __caches[type][key] = entry;
+    __usage[type] += size;
+    __totalUsage += size;
+    resource->addRef();
+}
+
+void ResourceManager::setMemorySize(Type type, const std::string& key, size_t size)
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    GP_ASSERT(type < TYPE_COUNT);
+
+    ResourceCache::iterator itr = __caches[type].find(key);
+    if (itr == __caches[type].end())
+        return;
+
+    __usage[type] = __usage[type] - itr->second.size + size;
+    __totalUsage = __totalUsage - itr->second.size + size;
+    itr->second.size = size;
+}
+
+void ResourceManager::update()
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    // The types with a budget of their own are evicted apart from those sharing the budget.
+    bool shared[TYPE_COUNT];
+    size_t sharedUsage = 0;
+    for (unsigned int i = 0; i < TYPE_COUNT; ++i)
+    {
+        shared[i] = !__typeBudgeted[i];
+        if (shared[i])
+        {
+            sharedUsage += __usage[i];
+        }
+        else if (__usage[i] > __typeBudgets[i])
+        {
+            bool types[TYPE_COUNT] = { false };
+            types[i] = true;
+            evict(types, __typeBudgets[i]);
+        }
+    }
+    if (sharedUsage > __budget)
+        evict(shared, __budget);
+}
+
+void ResourceManager::finalize()
+{
+    std::lock_guard<std::recursive_mutex> lock(__mutex);
+    // Resources that are still referenced elsewhere are destroyed once their last reference is released.
+    for (unsigned int i = 0; i < TYPE_COUNT; ++i)
+    {
+        ResourceCache cache;
+        cache.swap(__caches[i]);
+        for (ResourceCache::iterator itr = cache.begin(); itr != cache.end(); ++itr)
+        {
+            SAFE_RELEASE(itr->second.resource);
+        }
+        __usage[i] = 0;
+    }
+    __totalUsage = 0;
+}
+
+}
@@ -0,0 +1,201 @@
+#ifndef RESOURCEMANAGER_H_
+#define RESOURCEMANAGER_H_
+
+namespace gameplay
+{
+
+class Ref;
+
+/**
+ * Defines the cache that shares the resources loaded from files, such as textures,
+ * effects, sounds and fonts, among everything that loads them.
+ *
+ * Each type of resource has a cache indexed by a hash of its key, which is the path
+ * the resource was loaded from, along with the options it was loaded with when they
+ * change the result, such as the preprocessor defines of effects. The caches hold a
+ * reference to each of their resources and keep track of the memory they use, and of
+ * when each resource was last requested.
+ *
+ * A resource that is no longer referenced by anything but its cache stays cached while
+ * the memory used by all caches is within the memory budget, so that loading it again,
+ * for example when the player returns to an area, doesn't read it from disk. Once the
+ * budget is exceeded, the least recently requested unreferenced resources are evicted
+ * at the end of the frame until the caches fit the budget again. Resources that are
+ * still referenced are never evicted, so the budget can be exceeded by what is in use.
+ *
+ * The default budget is zero, which evicts every resource at the end of the frame it
+ * stops being referenced.
+ *
+ * A type of resource can be given a budget of its own, which its unreferenced resources are
+ * then evicted to fit, apart from the other types and the shared budget. For example, sound
+ * effects decoded ahead of time with a sound bank can stay cached within an audio budget
+ * while textures are evicted as soon as they are no longer used.
+ *
+ * Memory sizes are estimates, like those of RenderStats.
+ *
+ * The caches can be used from several threads at once, such as the threads that load the
+ * scenes of different worlds.
+ */
+class ResourceManager
+{
+    friend class Game;
+
+public:
+
+    /**
+     * Defines the types of cached resources.
+     */
+    enum Type
+    {
+        TEXTURE,
+        EFFECT,
+        AUDIO_BUFFER,
+        FONT,
+        TYPE_COUNT
+    };
+
+    /**
+     * Sets the number of bytes that the cached resources may use before unreferenced ones are evicted.
+     *
+     * @param bytes The memory budget in bytes.
+     */
+    static void setMemoryBudget(size_t bytes);
+
+    /**
+     * Returns the number of bytes that the cached resources may use before unreferenced ones are evicted.
+     *
+     * @return The memory budget in bytes.
+     */
+    static size_t getMemoryBudget();
+
+    /**
+     * Sets the number of bytes that the cached resources of a type may use before unreferenced
+     * ones are evicted, instead of sharing the budget of the types that have none of their own.
+     *
+     * @param type The type of resources.
+     * @param bytes The memory budget in bytes.
+     */
+    static void setMemoryBudget(Type type, size_t bytes);
+
+    /**
+     * Returns the number of bytes that the cached resources of a type may use before unreferenced
+     * ones are evicted, which is the shared budget unless the type has a budget of its own.
+     *
+     * @param type The type of resources.
+     *
+     * @return The memory budget in bytes.
+     */
+    static size_t getMemoryBudget(Type type);
+
+    /**
+     * Returns the number of bytes used by all cached resources.
+     *
+     * @return The memory size in bytes.
+     */
+    static size_t getMemoryUsage();
+
+    /**
+     * Returns the number of bytes used by the cached resources of a type.
+     *
+     * @param type The type of resources.
+     *
+     * @return The memory size in bytes.
+     */
+    static size_t getMemoryUsage(Type type);
+
+    /**
+     * Returns the number of bytes used by cached resources that are no longer referenced
+     * by anything but their cache, and can be evicted.
+     *
+     * @return The memory size in bytes.
+     */
+    static size_t getUnreferencedMemoryUsage();
+
+    /**
+     * Returns the number of cached resources of a type.
+     *
+     * @param type The type of resources.
+     *
+     * @return The number of resources.
+     */
+    static unsigned int getResourceCount(Type type);
+
+    /**
+     * Determines if a resource is cached.
+     *
+     * @param type The type of the resource.
+     * @param key The key of the resource, which is usually its path.
+     *
+     * @return true if the resource is cached, false otherwise.
+     */
+    static bool isCached(Type type, const char* key);
+
+    /**
+     * Evicts the least recently requested unreferenced resources until the cached
+     * resources use at most the given number of bytes, or until only referenced ones remain.
+     *
+     * @param bytes The number of bytes to trim the caches to, or zero to evict every unreferenced resource.
+     *
+     * @return The number of bytes that were evicted.
+     */
+    static size_t trim(size_t bytes = 0);
+
+    /**
+     * Prints the memory used by each type of resource to the log.
+     */
+    static void print();
+
+    /**
+     * Returns the cached resource with the given key, and adds a reference to it.
+     *
+     * @param type The type of the resource.
+     * @param key The key of the resource.
+     *
+     * @return The resource, or NULL if it is not cached.
+     * @script{ignore}
+     */
+    static Ref* find(Type type, const std::string& key);
+
+    /**
+     * Adds a resource to its cache, which keeps a reference to it.
+     *
+     * @param type The type of the resource.
+     * @param key The key of the resource. If another thread has cached a resource with
+     *      the same key since it was looked up, the resource is not cached.
+     * @param resource The resource.
+     * @param size The estimated number of bytes the resource uses.
+     * @script{ignore}
+     */
+    static void add(Type type, const std::string& key, Ref* resource, size_t size);
+
+    /**
+     * Updates the number of bytes that a cached resource uses, after it has changed.
+     *
+     * @param type The type of the resource.
+     * @param key The key of the resource. Nothing is updated if it is not cached.
+     * @param size The estimated number of bytes the resource uses.
+     * @script{ignore}
+     */
+    static void setMemorySize(Type type, const std::string& key, size_t size);
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    ResourceManager();
+
+    /**
+     * Evicts unreferenced resources while the budget is exceeded. Called by the game at the end of every frame.
+     */
+    static void update();
+
+    /**
+     * Releases the references of the caches to all of their resources. Called by the game during shutdown.
+     */
+    static void finalize();
+};
+
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "Joint.h"
 #include "Terrain.h"
 #include "Bundle.h"
+#include "MeshBVH.h"
 
 namespace gameplay
 {
@@ -13,6 +14,51 @@ namespace gameplay
 // Global list of active scenes
 static std::vector<Scene*> __sceneList;
 
+// A light found by Scene::findLights and its contribution.
+struct LightScore
+{
+    Light* light;
+    float score;
+};
+
+static bool isBrighterLight(const LightScore& a, const LightScore& b)
+{
+    return a.score > b.score;
+}
+
+// Returns the contribution of a light to a bounding sphere, or zero if it doesn't reach the sphere.
+static float getLightScore(Light* light, const BoundingSphere& bounds)
+{
+    const Vector3& color = light->getColor();
+    float luminance = color.x * 0.2126f + color.y * 0.7152f + color.z * 0.0722f;
+    if (light->getLightType() == Light::DIRECTIONAL)
+        return luminance;
+
+    Node* node = light->getNode();
+    Vector3 toCenter = bounds.center - node->getTranslationWorld();
+    float distance = toCenter.length();
+
+    // Attenuate the light at the closest point of the sphere as the shaders do.
+    float closest = std::max(distance - bounds.radius, 0.0f) * light->getRangeInverse();
+    if (closest >= 1.0f)
+        return 0.0f;
+
+    if (light->getLightType() == Light::SPOT && distance > bounds.radius)
+    {
+        // Skip spheres that are outside of the outer cone.
+        Vector3 direction = node->getForwardVectorWorld();
+        direction.normalize();
+        float along = toCenter.dot(direction);
+        float cosAngle = light->getOuterAngleCos();
+        float sinAngle = sqrt(std::max(1.0f - cosAngle * cosAngle, 0.0f));
+        float across = sqrt(std::max(distance * distance - along * along, 0.0f));
+        if (cosAngle * across - along * sinAngle > bounds.radius)
+            return 0.0f;
+    }
+
+    return luminance * (1.0f - closest * closest);
+}
+
 static inline char lowercase(char c)
 {
     if (c >= 'A' && c <='Z')
@@ -61,8 +107,10 @@ static bool endsWith(const char* str, const char* suffix, bool ignoreCase)
 
 Scene::Scene()
     : _id(""), _activeCamera(NULL), _firstNode(NULL), _lastNode(NULL), _nodeCount(0), _bindAudioListenerToCamera(true), 
-      _nextItr(NULL), _nextReset(true)
+      _nextItr(NULL), _nextReset(true), _transformHierarchy(NULL), _spatialIndex(NULL), _nodeIndex(NULL), _lightClusters(NULL),
+      _shadowMaps(NULL), _lightsFrame(UINT_MAX)
 {
+    _nodeIndex = new NodeIndex();
     __sceneList.push_back(this);
 }
 
@@ -80,8 +128,15 @@ Scene::~Scene()
         SAFE_RELEASE(_activeCamera);
     }
 
+    // Detach all nodes from the transform hierarchy and spatial index before removing them
+    SAFE_DELETE(_transformHierarchy);
+    SAFE_DELETE(_spatialIndex);
+    SAFE_DELETE(_lightClusters);
+    SAFE_DELETE(_shadowMaps);
+
     // Remove all nodes from the scene
     removeAllNodes();
+    SAFE_DELETE(_nodeIndex);
 
     // Remove the scene from global list
     std::vector<Scene*>::iterator itr = std::find(__sceneList.begin(), __sceneList.end(), this);
@@ -141,6 +196,11 @@ Node* Scene::findNode(const char* id, bool recursive, bool exactMatch) const
 {
     GP_ASSERT(id);
 
+    // Exact matches of an id that is unique in the scene are answered by the node index.
+    Node* indexed;
+    if (exactMatch && recursive && _nodeIndex->find(NULL, id, false, &indexed))
+        return indexed;
+
     // Search immediate children first.
     for (Node* child = getFirstNode(); child != NULL; child = child->getNextSibling())
     {
@@ -170,6 +230,17 @@ unsigned int Scene::findNodes(const char* id, std::vector<Node*>& nodes, bool re
 {
     GP_ASSERT(id);
 
+    // A node that is reachable along a single path is found once, like by the search.
+    Node* indexed;
+    if (exactMatch && recursive && _nodeIndex->find(NULL, id, false, &indexed) &&
+        (indexed == NULL || indexed->_nodeIndexPaths + indexed->_nodeIndexSkinPaths == 1))
+    {
+        if (indexed == NULL)
+            return 0;
+        nodes.push_back(indexed);
+        return 1;
+    }
+
     unsigned int count = 0;
 
     // Search immediate children first.
@@ -195,6 +266,84 @@ unsigned int Scene::findNodes(const char* id, std::vector<Node*>& nodes, bool re
     return count;
 }
 
+unsigned int Scene::findNodesByTag(const char* name, std::vector<Node*>& nodes, const char* value) const
+{
+    return _nodeIndex->findNodesByTag(name, nodes, value);
+}
+
+unsigned int Scene::findNodesByTag(unsigned int id, std::vector<Node*>& nodes, const char* value) const
+{
+    return _nodeIndex->findNodesByTag(id, nodes, value);
+}
+
+/**
+ * Returns whether a node has a drawable, camera or light of the given type.
+ */
+static bool isNodeOfType(Node* node, const char* typeName)
+{
+    Drawable* drawable = node->getDrawable();
+    if (strcmp(typeName, "Drawable") == 0)
+        return drawable != NULL;
+    if (strcmp(typeName, "Camera") == 0)
+        return node->getCamera() != NULL;
+    if (strcmp(typeName, "Light") == 0)
+        return node->getLight() != NULL;
+    if (!drawable)
+        return false;
+    if (strcmp(typeName, "Model") == 0)
+        return dynamic_cast<Model*>(drawable) != NULL;
+    if (strcmp(typeName, "Terrain") == 0)
+        return dynamic_cast<Terrain*>(drawable) != NULL;
+    if (strcmp(typeName, "Sprite") == 0)
+        return dynamic_cast<Sprite*>(drawable) != NULL;
+    if (strcmp(typeName, "Text") == 0)
+        return dynamic_cast<Text*>(drawable) != NULL;
+    if (strcmp(typeName, "TileSet") == 0)
+        return dynamic_cast<TileSet*>(drawable) != NULL;
+    if (strcmp(typeName, "ParticleEmitter") == 0)
+        return dynamic_cast<ParticleEmitter*>(drawable) != NULL;
+    if (strcmp(typeName, "Form") == 0)
+        return dynamic_cast<Form*>(drawable) != NULL;
+    return false;
+}
+
+unsigned int Scene::findNodesByType(Node* node, const char* typeName, std::vector<Node*>& nodes) const
+{
+    unsigned int count = 0;
+    if (isNodeOfType(node, typeName))
+    {
+        nodes.push_back(node);
+        ++count;
+    }
+
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    if (model && model->_skin && model->_skin->_rootNode)
+        count += findNodesByType(model->_skin->_rootNode, typeName, nodes);
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        count += findNodesByType(child, typeName, nodes);
+    }
+    return count;
+}
+
+unsigned int Scene::findNodesByType(const char* typeName, std::vector<Node*>& nodes) const
+{
+    GP_ASSERT(typeName);
+
+    unsigned int count = 0;
+    for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        count += findNodesByType(node, typeName, nodes);
+    }
+    return count;
+}
+
+const NodeIndex* Scene::getNodeIndex() const
+{
+    return _nodeIndex;
+}
+
 void Scene::visitNode(Node* node, const char* visitMethod)
 {
     ScriptController* sc = Game::getInstance()->getScriptController();
@@ -270,9 +419,16 @@ void Scene::addNode(Node* node)
     }
 
     node->_scene = this;
+    _nodeIndex->add(node, 1, 0);
 
     ++_nodeCount;
 
+    // The new node is picked up by the transform hierarchy on its next rebuild.
+    if (_transformHierarchy)
+        _transformHierarchy->invalidate();
+    if (_spatialIndex)
+        _spatialIndex->add(node);
+
     // If we don't have an active camera set, then check for one and set it.
     if (_activeCamera == NULL)
     {
@@ -300,6 +456,7 @@ void Scene::removeNode(Node* node)
         _lastNode = node->_prevSibling;
     }
 
+    _nodeIndex->remove(node, 1, 0);
     node->remove();
     node->_scene = NULL;
 
@@ -386,6 +543,266 @@ void Scene::setAmbientColor(float red, float green, float blue)
     _ambientColor.set(red, green, blue);
 }
 
+void Scene::setTransformHierarchyEnabled(bool enabled)
+{
+    if (enabled == (_transformHierarchy != NULL))
+        return;
+
+    if (enabled)
+    {
+        _transformHierarchy = new TransformHierarchy(this);
+        _transformHierarchy->rebuild();
+    }
+    else
+    {
+        SAFE_DELETE(_transformHierarchy);
+    }
+}
+
+bool Scene::isTransformHierarchyEnabled() const
+{
+    return _transformHierarchy != NULL;
+}
+
+TransformHierarchy* Scene::getTransformHierarchy() const
+{
+    return _transformHierarchy;
+}
+
+void Scene::setSpatialIndexEnabled(bool enabled)
+{
+    if (enabled == (_spatialIndex != NULL))
+        return;
+
+    if (enabled)
+    {
+        _spatialIndex = new SpatialIndex(this);
+    }
+    else
+    {
+        SAFE_DELETE(_spatialIndex);
+    }
+}
+
+bool Scene::isSpatialIndexEnabled() const
+{
+    return _spatialIndex != NULL;
+}
+
+SpatialIndex* Scene::getSpatialIndex() const
+{
+    return _spatialIndex;
+}
+
+/**
+ * Gathers the nodes with a model whose bounds, which contain those of their children, a ray hits.
+ */
+static void findPickNodes(Node* node, const Ray& ray, float maxDistance, std::vector<Node*>& nodes)
+{
+    for (; node != NULL; node = node->getNextSibling())
+    {
+        float distance = ray.intersects(node->getBoundingSphere());
+        if (distance == Ray::INTERSECTS_NONE || distance > maxDistance)
+            continue;
+        if (dynamic_cast<Model*>(node->getDrawable()))
+            nodes.push_back(node);
+        findPickNodes(node->getFirstChild(), ray, maxDistance, nodes);
+    }
+}
+
+bool Scene::pick(const Ray& ray, PickResult* result, float maxDistance) const
+{
+    GP_ASSERT(result);
+
+    std::vector<Node*> nodes;
+    if (_spatialIndex)
+        _spatialIndex->findNodes(ray, nodes, maxDistance);
+    else
+        findPickNodes(getFirstNode(), ray, maxDistance, nodes);
+
+    // Candidates are tested from the nearest bounds, until the bounds start beyond the closest hit.
+    std::vector<std::pair<float, Node*> > candidates;
+    candidates.reserve(nodes.size());
+    for (size_t i = 0, count = nodes.size(); i < count; ++i)
+    {
+        Node* node = nodes[i];
+        Model* model = dynamic_cast<Model*>(node->getDrawable());
+        if (!model || !model->getMesh() || !node->isEnabledInHierarchy())
+            continue;
+
+        BoundingSphere bounds(model->getMesh()->getBoundingSphere());
+        bounds.transform(node->getWorldMatrix());
+        float distance = ray.intersects(bounds);
+        if (distance != Ray::INTERSECTS_NONE && distance <= maxDistance)
+            candidates.push_back(std::make_pair(distance, node));
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    float closest = maxDistance;
+    bool found = false;
+    for (size_t i = 0, count = candidates.size(); i < count && candidates[i].first <= closest; ++i)
+    {
+        Node* node = candidates[i].second;
+        Model* model = static_cast<Model*>(node->getDrawable());
+        const MeshBVH* bvh = model->getSkin() ? NULL : model->getMesh()->getBVH();
+        if (!bvh)
+        {
+            closest = candidates[i].first;
+            result->node = node;
+            result->point = ray.getOrigin() + ray.getDirection() * closest;
+            result->normal = -ray.getDirection();
+            result->distance = closest;
+            result->part = 0;
+            result->triangle = 0;
+            result->exact = false;
+            found = true;
+            continue;
+        }
+
+        // The triangles are tested in the space of the mesh, and the hit is brought back to world space.
+        const Matrix& world = node->getWorldMatrix();
+        Matrix inverse;
+        if (!world.invert(&inverse))
+            continue;
+        Ray local(ray);
+        local.transform(inverse);
+        MeshBVH::Hit hit;
+        if (!bvh->intersects(local, &hit))
+            continue;
+
+        Vector3 point;
+        world.transformPoint(hit.point, &point);
+        float distance = ray.getOrigin().distance(point);
+        if (distance > closest)
+            continue;
+
+        closest = distance;
+        result->node = node;
+        result->point = point;
+        node->getInverseTransposeWorldMatrix().transformVector(hit.normal, &result->normal);
+        result->normal.normalize();
+        result->distance = distance;
+        result->part = hit.part;
+        result->triangle = hit.triangle;
+        result->exact = true;
+        found = true;
+    }
+    return found;
+}
+
+void Scene::setLightClustersEnabled(bool enabled)
+{
+    if (enabled == (_lightClusters != NULL))
+        return;
+
+    if (enabled)
+    {
+        _lightClusters = new LightClusters(this);
+    }
+    else
+    {
+        SAFE_DELETE(_lightClusters);
+    }
+}
+
+bool Scene::isLightClustersEnabled() const
+{
+    return _lightClusters != NULL;
+}
+
+LightClusters* Scene::getLightClusters() const
+{
+    return _lightClusters;
+}
+
+void Scene::setShadowsEnabled(bool enabled)
+{
+    if (enabled == (_shadowMaps != NULL))
+        return;
+
+    if (enabled)
+    {
+        _shadowMaps = new ShadowMaps(this);
+    }
+    else
+    {
+        SAFE_DELETE(_shadowMaps);
+    }
+}
+
+bool Scene::isShadowsEnabled() const
+{
+    return _shadowMaps != NULL;
+}
+
+ShadowMaps* Scene::getShadowMaps() const
+{
+    return _shadowMaps;
+}
+
+bool Scene::gatherLight(Node* node)
+{
+    if (node->getLight() && node->isEnabledInHierarchy())
+        _lights.push_back(node->getLight());
+    return true;
+}
+
+unsigned int Scene::findLights(Node* node, Light::Type type, Light** lights, unsigned int count)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(lights || count == 0);
+
+    const BoundingSphere& bounds = node->getBoundingSphere();
+
+    // Find the candidate lights.
+    std::vector<Light*> candidates;
+    if (_spatialIndex && type != Light::DIRECTIONAL)
+    {
+        _lightQuery.clear();
+        _spatialIndex->findNodes(bounds, _lightQuery);
+        for (size_t i = 0, nodeCount = _lightQuery.size(); i < nodeCount; ++i)
+        {
+            Node* lightNode = _lightQuery[i];
+            if (lightNode->getLight() && lightNode->isEnabledInHierarchy())
+                candidates.push_back(lightNode->getLight());
+        }
+    }
+    else
+    {
+        unsigned int frame = Game::getInstance()->getFrameIndex();
+        if (_lightsFrame != frame)
+        {
+            _lights.clear();
+            visit(this, &Scene::gatherLight);
+            _lightsFrame = frame;
+        }
+        candidates = _lights;
+    }
+
+    // Rank the lights that reach the node.
+    std::vector<LightScore> scores;
+    for (size_t i = 0, candidateCount = candidates.size(); i < candidateCount; ++i)
+    {
+        Light* light = candidates[i];
+        if (light->getLightType() != type)
+            continue;
+
+        LightScore score;
+        score.light = light;
+        score.score = getLightScore(light, bounds);
+        if (score.score > 0.0f)
+            scores.push_back(score);
+    }
+
+    unsigned int found = std::min((unsigned int)scores.size(), count);
+    std::partial_sort(scores.begin(), scores.begin() + found, scores.end(), isBrighterLight);
+    for (unsigned int i = 0; i < found; ++i)
+    {
+        lights[i] = scores[i].light;
+    }
+    return found;
+}
+
 void Scene::update(float elapsedTime)
 {
     for (Node* node = _firstNode; node != NULL; node = node->_nextSibling)
@@ -395,6 +812,73 @@ void Scene::update(float elapsedTime)
     }
 }
 
+void Scene::updateTransforms()
+{
+    if (_transformHierarchy)
+        _transformHierarchy->update();
+
+    for (Node* node = _firstNode; node != NULL; node = node->_nextSibling)
+    {
+        updateTransforms(node);
+    }
+
+    if (_spatialIndex)
+        _spatialIndex->update();
+}
+
+void Scene::prepareParallelVisit()
+{
+    updateTransforms();
+
+    // Camera matrices are computed lazily as well, so resolve them for the active
+    // camera before it can be read from several threads at once.
+    if (_activeCamera)
+    {
+        _activeCamera->getInverseViewMatrix();
+        _activeCamera->getInverseViewProjectionMatrix();
+        _activeCamera->getFrustum();
+    }
+}
+
+void Scene::updateTransforms(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (!(node->_dirtyBits & (NODE_DIRTY_WORLD | NODE_DIRTY_WORLD_VIEW | NODE_DIRTY_BOUNDS | NODE_DIRTY_CHILDREN)))
+        return;
+
+    // Only nodes that draw something need their world-view matrix.
+    node->getWorldMatrix();
+    if (node->_drawable)
+        node->getWorldViewMatrix();
+
+    // Resolve the joint hierarchy of skinned models as well, since it is not part of the scene.
+    Model* model = dynamic_cast<Model*>(node->_drawable);
+    if (model && model->_skin && model->_skin->_rootNode)
+    {
+        updateTransforms(model->_skin->_rootNode);
+    }
+
+    node->_dirtyBits &= ~NODE_DIRTY_CHILDREN;
+    for (Node* child = node->_firstChild; child != NULL; child = child->_nextSibling)
+    {
+        updateTransforms(child);
+    }
+
+    // Our children are up to date now, so merging their bounds is cheap.
+    node->getBoundingSphere();
+}
+
+void Scene::updateTransformsInternal()
+{
+    GP_PROFILE("Scene::updateTransforms");
+
+    for (size_t i = 0, count = __sceneList.size(); i < count; ++i)
+    {
+        __sceneList[i]->updateTransforms();
+    }
+}
+
 void Scene::reset()
 {
     _nextItr = NULL;
@@ -6,6 +6,11 @@
 #include "ScriptController.h"
 #include "Light.h"
 #include "Model.h"
+#include "TransformHierarchy.h"
+#include "SpatialIndex.h"
+#include "NodeIndex.h"
+#include "LightClusters.h"
+#include "ShadowMaps.h"
 
 namespace gameplay
 {
@@ -17,6 +22,9 @@ namespace gameplay
  */
 class Scene : public Ref
 {
+    friend class Game;
+    friend class RenderQueue;
+
 public:
 
     /**
@@ -90,6 +98,56 @@ public:
      */
     unsigned int findNodes(const char* id, std::vector<Node*>& nodes, bool recursive = true, bool exactMatch = true) const;
 
+    /**
+     * Returns all nodes in the scene that have the given tag, including the joints of skins.
+     *
+     * The nodes are looked up in the node index of the scene instead of being searched for.
+     *
+     * @param name The name of the tag.
+     * @param nodes Vector of nodes to be populated with matches, in no particular order.
+     * @param value The value the tag must have, or NULL to match any value.
+     *
+     * @return The number of matches found.
+     * @script{ignore}
+     */
+    unsigned int findNodesByTag(const char* name, std::vector<Node*>& nodes, const char* value = NULL) const;
+
+    /**
+     * Returns all nodes in the scene that have the tag with the given id, including the joints of skins.
+     *
+     * @param id The id of the name of the tag, as returned by Node::getTagId.
+     * @param nodes Vector of nodes to be populated with matches, in no particular order.
+     * @param value The value the tag must have, or NULL to match any value.
+     *
+     * @return The number of matches found.
+     * @script{ignore}
+     */
+    unsigned int findNodesByTag(unsigned int id, std::vector<Node*>& nodes, const char* value = NULL) const;
+
+    /**
+     * Returns all nodes in the scene that have a drawable, camera or light of the given type,
+     * including the joints of skins.
+     *
+     * The type is the name of a class: "Model", "Terrain", "Sprite", "Text", "TileSet",
+     * "ParticleEmitter" or "Form" match nodes by their drawable, "Drawable" matches any
+     * node with a drawable, and "Camera" and "Light" match nodes that they are attached to.
+     *
+     * @param typeName The name of the type.
+     * @param nodes Vector of nodes to be populated with matches, in depth-first order.
+     *
+     * @return The number of matches found.
+     * @script{ignore}
+     */
+    unsigned int findNodesByType(const char* typeName, std::vector<Node*>& nodes) const;
+
+    /**
+     * Returns the index of the nodes of the scene by their id and tags.
+     *
+     * @return The node index.
+     * @script{ignore}
+     */
+    const NodeIndex* getNodeIndex() const;
+
     /**
      * Creates and adds a new node to the scene.
      *
@@ -177,6 +235,210 @@ public:
      */
     void setAmbientColor(float red, float green, float blue);
 
+    /**
+     * Enables or disables the flat transform hierarchy of the scene.
+     *
+     * When enabled, the scene keeps a breadth-first sorted, structure-of-arrays copy
+     * of the local and world transforms of all its nodes and nodes resolve their
+     * world matrix through it. This avoids walking the node hierarchy recursively
+     * for every dirty node and is recommended for scenes with a large number of nodes.
+     *
+     * The transform hierarchy is disabled by default.
+     *
+     * @param enabled true to enable the transform hierarchy, false to disable it.
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+
+    /**
+     * Determines whether the flat transform hierarchy of the scene is enabled.
+     *
+     * @return true if the transform hierarchy is enabled, false otherwise.
+     * @see setTransformHierarchyEnabled
+     */
+    bool isTransformHierarchyEnabled() const;
+
+    /**
+     * Returns the flat transform hierarchy of the scene.
+     *
+     * @return The transform hierarchy, or NULL if it is not enabled.
+     * @script{ignore}
+     */
+    TransformHierarchy* getTransformHierarchy() const;
+
+    /**
+     * Enables or disables the spatial index of the scene.
+     *
+     * When enabled, all nodes in the scene that have a drawable or a light attached
+     * are stored in a loose octree that is kept up to date as their bounds change.
+     * The index can be used to quickly find nodes within a frustum, sphere, box or
+     * along a ray, for example for view frustum culling or picking.
+     *
+     * The spatial index is disabled by default.
+     *
+     * @param enabled true to enable the spatial index, false to disable it.
+     * @see getSpatialIndex
+     */
+    void setSpatialIndexEnabled(bool enabled);
+
+    /**
+     * Determines whether the spatial index of the scene is enabled.
+     *
+     * @return true if the spatial index is enabled, false otherwise.
+     */
+    bool isSpatialIndexEnabled() const;
+
+    /**
+     * Returns the spatial index of the scene.
+     *
+     * @return The spatial index, or NULL if it is not enabled.
+     * @script{ignore}
+     */
+    SpatialIndex* getSpatialIndex() const;
+
+    /**
+     * Defines the closest model that a ray picked.
+     */
+    struct PickResult
+    {
+        /**
+         * The node of the model that was hit.
+         */
+        Node* node;
+
+        /**
+         * The point that was hit, in world space.
+         */
+        Vector3 point;
+
+        /**
+         * The unit normal of the surface that was hit, in world space.
+         */
+        Vector3 normal;
+
+        /**
+         * The distance along the ray to the hit, in world space.
+         */
+        float distance;
+
+        /**
+         * The mesh part of the triangle that was hit.
+         */
+        unsigned int part;
+
+        /**
+         * The index of the triangle that was hit within the mesh.
+         */
+        unsigned int triangle;
+
+        /**
+         * Whether a triangle was hit, or only the bounding sphere of a model without one.
+         */
+        bool exact;
+    };
+
+    /**
+     * Finds the closest model of the enabled nodes that a ray hits.
+     *
+     * The candidates are found with the spatial index if it is enabled, and otherwise by
+     * descending the bounding spheres of the nodes. Their triangles are then tested with
+     * the bounding volume hierarchies of their meshes, so picking needs no collision
+     * objects. Skinned models, and models whose mesh has no hierarchy, are hit at their
+     * bounding sphere.
+     *
+     * @param ray The ray, in world space.
+     * @param result Populated with the closest hit, if any.
+     * @param maxDistance The distance along the ray beyond which nothing is hit.
+     *
+     * @return true if a model was hit.
+     * @see Mesh::getBVH
+     * @script{ignore}
+     */
+    bool pick(const Ray& ray, PickResult* result, float maxDistance = FLT_MAX) const;
+
+    /**
+     * Enables or disables clustered lighting for the scene.
+     *
+     * When enabled, the scene keeps a grid of light clusters that materials compiled
+     * with the CLUSTERED_LIGHTING define read their lights from, through the
+     * LIGHT_CLUSTER_TEXTURE and LIGHT_CLUSTER_PARAMETERS auto bindings. The clusters
+     * must be updated once per frame with LightClusters::update before drawing, and
+     * enabled before materials that use the auto bindings are bound to nodes.
+     *
+     * Clustered lighting is disabled by default.
+     *
+     * @param enabled true to enable clustered lighting, false to disable it.
+     * @see getLightClusters
+     */
+    void setLightClustersEnabled(bool enabled);
+
+    /**
+     * Determines whether clustered lighting is enabled for the scene.
+     *
+     * @return true if clustered lighting is enabled, false otherwise.
+     */
+    bool isLightClustersEnabled() const;
+
+    /**
+     * Returns the light clusters of the scene.
+     *
+     * @return The light clusters, or NULL if clustered lighting is not enabled.
+     * @script{ignore}
+     */
+    LightClusters* getLightClusters() const;
+
+    /**
+     * Enables or disables shadow maps for the scene.
+     *
+     * When enabled, the scene keeps the shadow maps of one of its directional or spot
+     * lights, which materials compiled with the SHADOWS define read through the
+     * SHADOW_MAP_TEXTURE, SHADOW_MATRICES, SHADOW_CASCADE_SPLITS and SHADOW_PARAMETERS
+     * auto bindings. The light is set with ShadowMaps::setLight, and the maps must be
+     * updated once per frame with ShadowMaps::update before drawing. Shadows must be
+     * enabled before materials that use the auto bindings are bound to nodes.
+     *
+     * Shadows are disabled by default.
+     *
+     * @param enabled true to enable shadows, false to disable them.
+     * @see getShadowMaps
+     */
+    void setShadowsEnabled(bool enabled);
+
+    /**
+     * Determines whether shadow maps are enabled for the scene.
+     *
+     * @return true if shadows are enabled, false otherwise.
+     */
+    bool isShadowsEnabled() const;
+
+    /**
+     * Returns the shadow maps of the scene.
+     *
+     * @return The shadow maps, or NULL if shadows are not enabled.
+     * @script{ignore}
+     */
+    ShadowMaps* getShadowMaps() const;
+
+    /**
+     * Finds the lights of the given type that contribute the most to the given node.
+     *
+     * Point and spot lights are ranked by their color, attenuated by their range at the
+     * point of the node's bounding sphere closest to them, and lights whose range or cone
+     * doesn't reach the sphere are skipped. Directional lights are ranked by their color.
+     * Candidate point and spot lights are found through the spatial index of the scene if
+     * it is enabled; otherwise the enabled lights of the scene are gathered once per frame.
+     *
+     * This is used by the light auto bindings of RenderState, such as POINT_LIGHT_POSITION.
+     *
+     * @param node The node to find lights for.
+     * @param type The type of lights to find.
+     * @param lights The array to store the lights in, ordered by their contribution.
+     * @param count The size of the array.
+     *
+     * @return The number of lights stored in the array.
+     * @script{ignore}
+     */
+    unsigned int findLights(Node* node, Light::Type type, Light** lights, unsigned int count);
+
     /**
      * Updates all active nodes in the scene.
      *
@@ -188,6 +450,18 @@ public:
      */
     void update(float elapsedTime);
 
+    /**
+     * Resolves the world matrices, world-view matrices and bounding volumes of all
+     * nodes in the scene whose transform changed since the last update.
+     *
+     * Only dirty subtrees of the scene are visited. This method is called
+     * automatically once per frame for all scenes, after the game has been updated
+     * and before it is rendered, so that transforms are not lazily recomputed at
+     * unpredictable times during the frame. It can also be called manually after
+     * moving a large number of nodes.
+     */
+    void updateTransforms();
+
     /**
      * Visits each node in the scene and calls the specified method pointer.
      *
@@ -228,6 +502,32 @@ public:
     template <class T, class C>
     void visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie);
 
+    /**
+     * Visits each node in the scene in parallel and calls the specified method pointer.
+     *
+     * The top-level nodes of the scene are split into batches that are visited on the
+     * worker threads of the game's job controller. The visitMethod parameter must be a
+     * pointer to a method that has a bool return type and accepts two parameters: a Node
+     * pointer and a pointer to the result of the thread that visits the node. The results
+     * vector is resized to hold one default constructed result per worker thread, which
+     * can be merged once this method returns.
+     *
+     * Transforms are resolved with a call to updateTransforms() before visiting the scene,
+     * so that visit methods only read from nodes. Visit methods must not modify the scene,
+     * its nodes or any other state shared between threads, which makes this suitable for
+     * read-only visitors such as culling, LOD selection and gathering of bounds.
+     *
+     * Subtrees are traversed depth-first as with visit(), but the order in which
+     * subtrees are visited is undefined.
+     *
+     * @param instance The pointer to an instance of the object that contains visitMethod.
+     * @param visitMethod The pointer to the class method to call for each node in the scene.
+     * @param results The vector to populate with the result of each worker thread.
+     * @script{ignore}
+     */
+    template <class T, class R>
+    void visitParallel(T* instance, bool (T::*visitMethod)(Node*,R*), std::vector<R>& results);
+
     /**
      * Visits each node in the scene and calls the specified Lua function.
      *
@@ -242,6 +542,11 @@ public:
      * returns true. Returning false will stop traversing further children for
      * the given node and the traversal will continue at the next sibling.
      *
+     * Scripts can also pass the function itself instead of its name, in which case it is
+     * resolved once for the whole traversal instead of being looked up for each node.
+     * Scripts that only need the nodes of a given tag or type should rather get them all in
+     * one call with findNodesByTag or findNodesByType.
+     *
      * @param visitMethod The name of the Lua function to call for each node in the scene.
      */
     inline void visit(const char* visitMethod);
@@ -295,6 +600,31 @@ private:
      */
     void visitNode(Node* node, const char* visitMethod);
 
+    /**
+     * Adds the given node and its descendants of the given type, including the joints of skins.
+     */
+    unsigned int findNodesByType(Node* node, const char* typeName, std::vector<Node*>& nodes) const;
+
+    /**
+     * Resolves the transforms of the given node and its dirty descendants.
+     */
+    void updateTransforms(Node* node);
+
+    /**
+     * Resolves the transforms of all active scenes. Called once per frame by the game.
+     */
+    static void updateTransformsInternal();
+
+    /**
+     * Resolves any lazily computed state that visitors of the scene may read from multiple threads.
+     */
+    void prepareParallelVisit();
+
+    /**
+     * Adds the light of the given node, if any, to the lights gathered for the frame.
+     */
+    bool gatherLight(Node* node);
+
     Node* findNextVisibleSibling(Node* node);
 
     bool isNodeVisible(Node* node);
@@ -308,11 +638,21 @@ private:
     bool _bindAudioListenerToCamera;
     Node* _nextItr;
     bool _nextReset;
+    TransformHierarchy* _transformHierarchy;
+    SpatialIndex* _spatialIndex;
+    NodeIndex* _nodeIndex;
+    LightClusters* _lightClusters;
+    ShadowMaps* _shadowMaps;
+    std::vector<Light*> _lights;
+    std::vector<Node*> _lightQuery;
+    unsigned int _lightsFrame;
 };
 
 template <class T>
 void Scene::visit(T* instance, bool (T::*visitMethod)(Node*))
 {
+    GP_PROFILE("Scene::visit");
+
     for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
     {
         visitNode(node, instance, visitMethod);
@@ -322,14 +662,85 @@ void Scene::visit(T* instance, bool (T::*visitMethod)(Node*))
 template <class T, class C>
 void Scene::visit(T* instance, bool (T::*visitMethod)(Node*,C), C cookie)
 {
+    GP_PROFILE("Scene::visit");
+
     for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
     {
         visitNode(node, instance, visitMethod, cookie);
     }
 }
 
+template <class T, class R>
+void Scene::visitParallel(T* instance, bool (T::*visitMethod)(Node*,R*), std::vector<R>& results)
+{
+    GP_PROFILE("Scene::visitParallel");
+
+    // Visits a contiguous range of the top-level nodes of the scene.
+    class VisitJob : public JobController::Job
+    {
+    public:
+        VisitJob(Scene* scene, T* instance, bool (T::*visitMethod)(Node*,R*), std::vector<R>* results, Node** nodes, unsigned int count)
+            : _scene(scene), _instance(instance), _visitMethod(visitMethod), _results(results), _nodes(nodes), _count(count)
+        {
+        }
+
+        void execute(unsigned int worker)
+        {
+            R* result = &(*_results)[worker];
+            for (unsigned int i = 0; i < _count; ++i)
+            {
+                _scene->visitNode(_nodes[i], _instance, _visitMethod, result);
+            }
+        }
+
+    private:
+        Scene* _scene;
+        T* _instance;
+        bool (T::*_visitMethod)(Node*,R*);
+        std::vector<R>* _results;
+        Node** _nodes;
+        unsigned int _count;
+    };
+
+    JobController* jobController = Game::getInstance()->getJobController();
+    GP_ASSERT(jobController);
+
+    results.clear();
+    results.resize(jobController->getWorkerCount());
+
+    prepareParallelVisit();
+
+    std::vector<Node*> nodes;
+    nodes.reserve(_nodeCount);
+    for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        nodes.push_back(node);
+    }
+    if (nodes.empty())
+        return;
+
+    // A few batches per worker keep threads busy when subtrees differ in size.
+    unsigned int nodeCount = (unsigned int)nodes.size();
+    unsigned int jobCount = std::min(nodeCount, jobController->getWorkerCount() * 4);
+    std::vector<VisitJob> jobs;
+    std::vector<JobController::Job*> jobPointers;
+    jobs.reserve(jobCount);
+    jobPointers.reserve(jobCount);
+    for (unsigned int i = 0; i < jobCount; ++i)
+    {
+        unsigned int first = nodeCount * i / jobCount;
+        unsigned int last = nodeCount * (i + 1) / jobCount;
+        jobs.push_back(VisitJob(this, instance, visitMethod, &results, &nodes[first], last - first));
+        jobPointers.push_back(&jobs.back());
+    }
+
+    jobController->execute(&jobPointers[0], jobCount);
+}
+
 inline void Scene::visit(const char* visitMethod)
 {
+    GP_PROFILE("Scene::visit");
+
     for (Node* node = getFirstNode(); node != NULL; node = node->getNextSibling())
     {
         visitNode(node, visitMethod);
@@ -17,92 +17,272 @@ namespace gameplay
 extern void calculateNamespacePath(const std::string& urlString, std::string& fileString, std::vector<std::string>& namespacePath);
 extern Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath);
 
-SceneLoader::SceneLoader() : _scene(NULL)
+static bool __loadTimesLogged = false;
+
+SceneLoader::SceneLoader(const char* url, Properties* properties)
+    : _scene(NULL), _url(url ? url : ""), _rootProperties(properties), _sceneProperties(NULL), _stage(PARSE),
+      _stepIndex(0), _stepsDone(0), _stepCount(0)
+{
+}
+
+SceneLoader::~SceneLoader()
+{
+    clear();
+    SAFE_RELEASE(_scene);
+}
+
+SceneLoader* SceneLoader::create(const char* url)
+{
+    return new SceneLoader(url, NULL);
+}
+
+SceneLoader* SceneLoader::create(const char* url, Properties* properties)
 {
+    return new SceneLoader(url, properties);
 }
 
 Scene* SceneLoader::load(const char* url)
 {
-    SceneLoader loader;
-    return loader.loadInternal(url);
+    SceneLoader loader(url, NULL);
+    return loader.loadInternal();
+}
+
+Scene* SceneLoader::loadInternal()
+{
+    while (!step());
+
+    // The caller takes over the scene.
+    Scene* scene = _scene;
+    _scene = NULL;
+    return scene;
+}
+
+bool SceneLoader::update(float milliseconds)
+{
+    GP_PROFILE("SceneLoader::update");
+
+    double start = Game::getAbsoluteTime();
+    while (!step())
+    {
+        if (Game::getAbsoluteTime() - start >= milliseconds)
+            return false;
+    }
+    return true;
+}
+
+float SceneLoader::getProgress() const
+{
+    if (_stage == DONE)
+        return 1.0f;
+    return _stepCount > 0 ? (float)_stepsDone / (float)_stepCount : 0.0f;
+}
+
+bool SceneLoader::isComplete() const
+{
+    return _stage == DONE;
+}
+
+Scene* SceneLoader::getScene() const
+{
+    return _stage == DONE ? _scene : NULL;
+}
+
+void SceneLoader::setLoadTimesLogged(bool logged)
+{
+    __loadTimesLogged = logged;
+}
+
+bool SceneLoader::step()
+{
+    switch (_stage)
+    {
+    case PARSE:
+        if (!parse())
+        {
+            clear();
+            _stage = DONE;
+            return true;
+        }
+        _stage = LOAD_FILES;
+        break;
+
+    case LOAD_FILES:
+        if (_stepIndex < _referencedUrls.size())
+        {
+            const std::string& url = _referencedUrls[_stepIndex++];
+            loadReferencedFile(url, &_properties[url]);
+            break;
+        }
+        _stepIndex = 0;
+        _stage = LOAD_BUNDLE;
+        // Fall through: the stage has no steps left.
+
+    case LOAD_BUNDLE:
+        // Load the main scene data from GPB and apply the global scene properties.
+        if (!_gpbPath.empty())
+        {
+            // Load scene from bundle
+            _scene = loadMainSceneData(_sceneProperties);
+            if (!_scene)
+            {
+                GP_WARN("Failed to load main scene from bundle.");
+                clear();
+                _stage = DONE;
+                return true;
+            }
+        }
+        else
+        {
+            // Create a new empty scene
+            _scene = Scene::create(_sceneProperties->getId());
+        }
+        _stage = APPLY_URLS;
+        break;
+
+    case APPLY_URLS:
+        // First apply the node url properties, so that when the other node
+        // properties are applied, the nodes are in the scene.
+        if (_stepIndex < _sceneNodes.size())
+        {
+            applyNodeUrls(_sceneNodes[_stepIndex++], NULL);
+            break;
+        }
+        _stepIndex = 0;
+        _stage = APPLY_PROPERTIES;
+        // Fall through: the stage has no steps left.
+
+    case APPLY_PROPERTIES:
+        // Following that, apply the normal node properties.
+        if (_stepIndex < _flatSceneNodes.size())
+        {
+            applyNodeProperties(*_flatSceneNodes[_stepIndex++], _sceneProperties,
+                SceneNodeProperty::AUDIO | 
+                SceneNodeProperty::MATERIAL | 
+                SceneNodeProperty::PARTICLE |
+                SceneNodeProperty::TERRAIN |
+                SceneNodeProperty::LIGHT |
+                SceneNodeProperty::CAMERA |
+                SceneNodeProperty::ROTATE |
+                SceneNodeProperty::SCALE |
+                SceneNodeProperty::TRANSLATE |
+                SceneNodeProperty::SCRIPT |
+                SceneNodeProperty::SPRITE |
+                SceneNodeProperty::TILESET |
+                SceneNodeProperty::TEXT |
+                SceneNodeProperty::ENABLED |
+                SceneNodeProperty::REFLECTED, false);
+            break;
+        }
+        _stepIndex = 0;
+        _stage = APPLY_PHYSICS;
+        // Fall through: the stage has no steps left.
+
+    case APPLY_PHYSICS:
+        // We apply physics properties after all other node properties
+        // so that the transform (SRT) properties get applied before
+        // processing physics collision objects.
+        if (_stepIndex < _flatSceneNodes.size())
+        {
+            SceneNode* sceneNode = _flatSceneNodes[_stepIndex++];
+            applyNodeProperties(*sceneNode, _sceneProperties, SceneNodeProperty::COLLISION_OBJECT, false);
+
+            // The new collision objects wait for the rest of the scene before they simulate.
+            for (size_t i = 0, count = sceneNode->_nodes.size(); i < count; ++i)
+            {
+                PhysicsCollisionObject* object = sceneNode->_nodes[i]->getCollisionObject();
+                if (object && object->isEnabled())
+                {
+                    object->setEnabled(false);
+                    _disabledObjects.push_back(object);
+                }
+            }
+            break;
+        }
+        _stepIndex = 0;
+        _stage = FINISH;
+        // Fall through: the stage has no steps left.
+
+    case FINISH:
+        finish();
+        if (__loadTimesLogged)
+            _io.print(_url.c_str());
+        clear();
+        _stage = DONE;
+        return true;
+
+    default:
+        return true;
+    }
+
+    ++_stepsDone;
+    return false;
 }
 
-Scene* SceneLoader::loadInternal(const char* url)
+bool SceneLoader::parse()
 {
     // Get the file part of the url that we are loading the scene from.
-    std::string urlStr = url ? url : "";
     std::string id;
-    splitURL(urlStr, &_path, &id);
+    splitURL(_url, &_path, &id);
 
-    // Load the scene properties from file.
-    Properties* properties = Properties::create(url);
-    if (properties == NULL)
+    // Load the scene properties from file, unless they already were.
+    if (_rootProperties == NULL)
+        _rootProperties = Properties::create(_url.c_str());
+    if (_rootProperties == NULL)
     {
-        GP_ERROR("Failed to load scene file '%s'.", url);
-        return NULL;
+        GP_ERROR("Failed to load scene file '%s'.", _url.c_str());
+        return false;
     }
 
     // Check if the properties object is valid and has a valid namespace.
-    Properties* sceneProperties = (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
-    if (!sceneProperties || !(strcmp(sceneProperties->getNamespace(), "scene") == 0))
+    _sceneProperties = (strlen(_rootProperties->getNamespace()) > 0) ? _rootProperties : _rootProperties->getNextNamespace();
+    if (!_sceneProperties || !(strcmp(_sceneProperties->getNamespace(), "scene") == 0))
     {
         GP_ERROR("Failed to load scene from properties object: must be non-null object and have namespace equal to 'scene'.");
-        SAFE_DELETE(properties);
-        return NULL;
+        return false;
     }
 
     // Get the path to the main GPB.
     std::string path;
-    if (sceneProperties->getPath("path", &path))
+    if (_sceneProperties->getPath("path", &path))
     {
         _gpbPath = path;
     }
 
-    // Build the node URL/property and animation reference tables and load the referenced files/store the inline properties objects.
-    buildReferenceTables(sceneProperties);
-    loadReferencedFiles();
-
-    // Load the main scene data from GPB and apply the global scene properties.
-    if (!_gpbPath.empty())
+    // Build the node URL/property and animation reference tables, and list the referenced files to load.
+    buildReferenceTables(_sceneProperties);
+    std::map<std::string, Properties*>::const_iterator iter = _properties.begin();
+    for (; iter != _properties.end(); ++iter)
     {
-        // Load scene from bundle
-        _scene = loadMainSceneData(sceneProperties);
-        if (!_scene)
-        {
-            GP_WARN("Failed to load main scene from bundle.");
-            SAFE_DELETE(properties);
-            return NULL;
-        }
+        if (iter->second == NULL)
+            _referencedUrls.push_back(iter->first);
     }
-    else
+
+    // The properties of parents are applied before those of their children.
+    for (size_t i = 0, count = _sceneNodes.size(); i < count; ++i)
     {
-        // Create a new empty scene
-        _scene = Scene::create(sceneProperties->getId());
+        collectSceneNodes(_sceneNodes[i]);
     }
 
-    // First apply the node url properties. Following that,
-    // apply the normal node properties and create the animations.
-    // We apply physics properties after all other node properties
-    // so that the transform (SRT) properties get applied before
-    // processing physics collision objects.
-    applyNodeUrls();
-    applyNodeProperties(sceneProperties, 
-        SceneNodeProperty::AUDIO | 
-        SceneNodeProperty::MATERIAL | 
-        SceneNodeProperty::PARTICLE |
-        SceneNodeProperty::TERRAIN |
-        SceneNodeProperty::LIGHT |
-        SceneNodeProperty::CAMERA |
-        SceneNodeProperty::ROTATE |
-        SceneNodeProperty::SCALE |
-        SceneNodeProperty::TRANSLATE |
-        SceneNodeProperty::SCRIPT |
-        SceneNodeProperty::SPRITE |
-        SceneNodeProperty::TILESET |
-        SceneNodeProperty::TEXT |
-        SceneNodeProperty::ENABLED);
-    applyNodeProperties(sceneProperties, SceneNodeProperty::COLLISION_OBJECT);
+    // Every file is read ahead, so that the disk is busy while the files read before are loaded.
+    queueReads();
+
+    // Parsing, then each referenced file, the bundle, the URLs of each top level node,
+    // and the properties and physics of each node, and finishing.
+    _stepCount = (unsigned int)(3 + _referencedUrls.size() + _sceneNodes.size() + _flatSceneNodes.size() * 2);
+    return true;
+}
+
+void SceneLoader::collectSceneNodes(SceneNode& sceneNode)
+{
+    _flatSceneNodes.push_back(&sceneNode);
+    for (size_t i = 0, count = sceneNode._children.size(); i < count; ++i)
+    {
+        collectSceneNodes(sceneNode._children[i]);
+    }
+}
 
+void SceneLoader::finish()
+{
     // Apply node tags
     for (size_t i = 0, sncount = _sceneNodes.size(); i < sncount; ++i)
     {
@@ -110,7 +290,7 @@ Scene* SceneLoader::loadInternal(const char* url)
     }
 
     // Set active camera
-    const char* activeCamera = sceneProperties->getString("activeCamera");
+    const char* activeCamera = _sceneProperties->getString("activeCamera");
     if (activeCamera)
     {
         Node* camera = _scene->findNode(activeCamera);
@@ -120,7 +300,7 @@ Scene* SceneLoader::loadInternal(const char* url)
 
     // Set ambient and light properties
     Vector3 vec3;
-    if (sceneProperties->getVector3("ambientColor", &vec3))
+    if (_sceneProperties->getVector3("ambientColor", &vec3))
         _scene->setAmbientColor(vec3.x, vec3.y, vec3.z);
 
     // Create animations for scene
@@ -128,10 +308,10 @@ Scene* SceneLoader::loadInternal(const char* url)
 
     // Find the physics properties object.
     Properties* physics = NULL;
-    sceneProperties->rewind();
+    _sceneProperties->rewind();
     while (true)
     {
-        Properties* ns = sceneProperties->getNextNamespace();
+        Properties* ns = _sceneProperties->getNextNamespace();
         if (ns == NULL || strcmp(ns->getNamespace(), "physics") == 0)
         {
             physics = ns;
@@ -143,17 +323,40 @@ Scene* SceneLoader::loadInternal(const char* url)
     if (physics)
         loadPhysics(physics);
 
+    // The scene is complete, so its collision objects can simulate.
+    for (size_t i = 0, count = _disabledObjects.size(); i < count; ++i)
+    {
+        _disabledObjects[i]->setEnabled(true);
+    }
+    _disabledObjects.clear();
+}
+
+void SceneLoader::clear()
+{
     // Clean up all loaded properties objects.
     std::map<std::string, Properties*>::iterator iter = _propertiesFromFile.begin();
     for (; iter != _propertiesFromFile.end(); ++iter)
     {
         SAFE_DELETE(iter->second);
     }
+    _propertiesFromFile.clear();
+    _properties.clear();
+    _sceneNodes.clear();
+    _flatSceneNodes.clear();
+    _referencedUrls.clear();
+    _animations.clear();
+    _disabledObjects.clear();
+
+    // Release the bundles opened for the scene.
+    for (std::map<std::string, Bundle*>::iterator itr = _bundles.begin(); itr != _bundles.end(); ++itr)
+    {
+        SAFE_RELEASE(itr->second);
+    }
+    _bundles.clear();
 
     // Clean up the .scene file's properties object.
-    SAFE_DELETE(properties);
-
-    return _scene;
+    _sceneProperties = NULL;
+    SAFE_DELETE(_rootProperties);
 }
 
 void SceneLoader::applyTags(SceneNode& sceneNode)
@@ -218,15 +421,7 @@ void SceneLoader::addSceneNodeProperty(SceneNode& sceneNode, SceneNodeProperty::
     sceneNode._properties.push_back(prop);
 }
 
-void SceneLoader::applyNodeProperties(const Properties* sceneProperties, unsigned int typeFlags)
-{
-    for (size_t i = 0, count = _sceneNodes.size(); i < count; ++i)
-    {
-        applyNodeProperties(_sceneNodes[i], sceneProperties, typeFlags);
-    }
-}
-
-void SceneLoader::applyNodeProperties(SceneNode& sceneNode, const Properties* sceneProperties, unsigned int typeFlags)
+void SceneLoader::applyNodeProperties(SceneNode& sceneNode, const Properties* sceneProperties, unsigned int typeFlags, bool recursive)
 {
     // Apply properties for this node
     for (size_t i = 0, pcount = sceneNode._properties.size(); i < pcount; ++i)
@@ -240,6 +435,8 @@ void SceneLoader::applyNodeProperties(SceneNode& sceneNode, const Properties* sc
     }
 
     // Apply properties to child nodes
+    if (!recursive)
+        return;
     for (size_t i = 0, ccount = sceneNode._children.size(); i < ccount; ++i)
     {
         applyNodeProperties(sceneNode._children[i], sceneProperties, typeFlags);
@@ -286,6 +483,8 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
             if (model)
             {
                 Material* material = Material::create(p);
+                if (material)
+                    material->setUrl(snp._value.c_str());
                 model->setMaterial(material, snp._index);
                 SAFE_RELEASE(material);
             }
@@ -443,6 +642,9 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
         case SceneNodeProperty::ENABLED:
             node->setEnabled(snp._value.compare("true") == 0);
             break;
+        case SceneNodeProperty::REFLECTED:
+            node->setReflected(snp._value.compare("true") == 0);
+            break;
         default:
             GP_ERROR("Unsupported node property type (%d).", snp._type);
             break;
@@ -450,16 +652,6 @@ void SceneLoader::applyNodeProperty(SceneNode& sceneNode, Node* node, const Prop
     }
 }
 
-void SceneLoader::applyNodeUrls()
-{
-    // Apply all URL node properties so that when we go to apply
-    // the other node properties, the node is in the scene.
-    for (size_t i = 0, count = _sceneNodes.size(); i < count; ++i)
-    {
-        applyNodeUrls(_sceneNodes[i], NULL);
-    }
-}
-
 void SceneLoader::applyNodeUrls(SceneNode& sceneNode, Node* parent)
 {
     // Iterate backwards over the properties list so we can remove properties as we go
@@ -522,13 +714,11 @@ void SceneLoader::applyNodeUrls(SceneNode& sceneNode, Node* parent)
         else
         {
             // An external file was referenced, so load the node(s) from file and then insert it into the scene with the new ID.
-
-            // TODO: Revisit this to determine if we should cache Bundle objects for the duration of the scene
-            // load to prevent constantly creating/destroying the same externally referenced bundles each time
-            // a url with a file is encountered.
-            Bundle* tmpBundle = Bundle::create(file.c_str());
+            // The bundle stays open for the rest of the load, so that other nodes from it don't open it again.
+            Bundle* tmpBundle = openBundle(file);
             if (tmpBundle)
             {
+                double start = Game::getAbsoluteTime();
                 if (sceneNode._exactMatch)
                 {
                     Node* node = tmpBundle->loadNode(id.c_str(), _scene);
@@ -576,7 +766,7 @@ void SceneLoader::applyNodeUrls(SceneNode& sceneNode, Node* parent)
                     }
                 }
 
-                SAFE_RELEASE(tmpBundle);
+                _io.addLoadTime(file.c_str(), (float)(Game::getAbsoluteTime() - start));
             }
             else
             {
@@ -860,6 +1050,10 @@ void SceneLoader::parseNode(Properties* ns, SceneNode* parent, const std::string
         {
             addSceneNodeProperty(sceneNode, SceneNodeProperty::ENABLED, ns->getString());
         }
+        else if (strcmp(name, "reflected") == 0)
+        {
+            addSceneNodeProperty(sceneNode, SceneNodeProperty::REFLECTED, ns->getString());
+        }
         else
         {
             GP_ERROR("Unsupported node property: %s = %s", name, ns->getString());
@@ -1002,7 +1196,7 @@ Scene* SceneLoader::loadMainSceneData(const Properties* sceneProperties)
     GP_ASSERT(sceneProperties);
 
     // Load the main scene from the specified path.
-    Bundle* bundle = Bundle::create(_gpbPath.c_str());
+    Bundle* bundle = openBundle(_gpbPath);
     if (!bundle)
     {
         GP_WARN("Failed to load scene GPB file '%s'.", _gpbPath.c_str());
@@ -1010,15 +1204,15 @@ Scene* SceneLoader::loadMainSceneData(const Properties* sceneProperties)
     }
 
     // TODO: Support loading a specific scene from a GPB file using the URL syntax (i.e. "res/scene.gpb#myscene").
+    double start = Game::getAbsoluteTime();
     Scene* scene = bundle->loadScene(NULL);
+    _io.addLoadTime(_gpbPath.c_str(), (float)(Game::getAbsoluteTime() - start));
     if (!scene)
     {
         GP_WARN("Failed to load scene from '%s'.", _gpbPath.c_str());
-        SAFE_RELEASE(bundle);
         return NULL;
     }
 
-    SAFE_RELEASE(bundle);
     return scene;
 }
 
@@ -1032,6 +1226,18 @@ void SceneLoader::loadPhysics(Properties* physics)
     if (physics->getVector3("gravity", &gravity))
         Game::getInstance()->getPhysicsController()->setGravity(gravity);
 
+    PhysicsController* controller = Game::getInstance()->getPhysicsController();
+    if (physics->exists("linearSleepingThreshold") || physics->exists("angularSleepingThreshold"))
+    {
+        float linear = physics->exists("linearSleepingThreshold") ? physics->getFloat("linearSleepingThreshold") : controller->getLinearSleepingThreshold();
+        float angular = physics->exists("angularSleepingThreshold") ? physics->getFloat("angularSleepingThreshold") : controller->getAngularSleepingThreshold();
+        controller->setSleepingThresholds(linear, angular);
+    }
+    if (physics->exists("deactivationTime"))
+        controller->setDeactivationTime(physics->getFloat("deactivationTime"));
+    if (physics->exists("freezeDistance"))
+        controller->setFreezeDistance(physics->getFloat("freezeDistance"));
+
     Properties* constraint;
     const char* name;
     while ((constraint = physics->getNextNamespace()) != NULL)
@@ -1128,47 +1334,92 @@ void SceneLoader::loadPhysics(Properties* physics)
             GP_ERROR("Unsupported 'physics' child namespace '%s'.", physics->getNamespace());
         }
     }
+
+    // Merge the static rigid bodies once all of the constraints are created, since constrained bodies are not batched.
+    if (physics->getBool("staticBatching"))
+        controller->batchStaticObjects(_scene, physics->getFloat("staticBatchCellSize"));
 }
 
-void SceneLoader::loadReferencedFiles()
+void SceneLoader::loadReferencedFile(const std::string& url, Properties** properties)
 {
-    // Load all referenced properties files.
-    std::map<std::string, Properties*>::iterator iter = _properties.begin();
-    for (; iter != _properties.end(); ++iter)
+    GP_ASSERT(properties);
+
+    std::string fileString;
+    std::vector<std::string> namespacePath;
+    calculateNamespacePath(url, fileString, namespacePath);
+
+    // Check if the referenced properties file has already been loaded.
+    Properties* fileProperties = NULL;
+    std::map<std::string, Properties*>::iterator pffIter = _propertiesFromFile.find(fileString);
+    if (pffIter != _propertiesFromFile.end() && pffIter->second)
     {
-        if (iter->second == NULL)
+        fileProperties = pffIter->second;
+    }
+    else
+    {
+        _io.wait(fileString.c_str());
+        double start = Game::getAbsoluteTime();
+        fileProperties = Properties::create(fileString.c_str());
+        _io.addLoadTime(fileString.c_str(), (float)(Game::getAbsoluteTime() - start));
+        if (fileProperties == NULL)
         {
-            std::string fileString;
-            std::vector<std::string> namespacePath;
-            calculateNamespacePath(iter->first, fileString, namespacePath);
+            GP_WARN("Failed to load referenced properties file '%s'.", fileString.c_str());
+            return;
+        }
 
-            // Check if the referenced properties file has already been loaded.
-            Properties* properties = NULL;
-            std::map<std::string, Properties*>::iterator pffIter = _propertiesFromFile.find(fileString);
-            if (pffIter != _propertiesFromFile.end() && pffIter->second)
-            {
-                properties = pffIter->second;
-            }
-            else
-            {
-                properties = Properties::create(fileString.c_str());
-                if (properties == NULL)
-                {
-                    GP_WARN("Failed to load referenced properties file '%s'.", fileString.c_str());
-                    continue;
-                }
+        // Add the properties object to the cache.
+        _propertiesFromFile.insert(std::make_pair(fileString, fileProperties));
+    }
 
-                // Add the properties object to the cache.
-                _propertiesFromFile.insert(std::make_pair(fileString, properties));
-            }
+    Properties* p = getPropertiesFromNamespacePath(fileProperties, namespacePath);
+    if (!p)
+    {
+        GP_WARN("Failed to load referenced properties from url '%s'.", url.c_str());
+        return;
+    }
+    *properties = p;
+}
 
-            Properties* p = getPropertiesFromNamespacePath(properties, namespacePath);
-            if (!p)
-            {
-                GP_WARN("Failed to load referenced properties from url '%s'.", iter->first.c_str());
+Bundle* SceneLoader::openBundle(const std::string& path)
+{
+    std::map<std::string, Bundle*>::iterator itr = _bundles.find(path);
+    if (itr != _bundles.end())
+        return itr->second;
+
+    _io.wait(path.c_str());
+    double start = Game::getAbsoluteTime();
+    Bundle* bundle = Bundle::create(path.c_str());
+    _io.addLoadTime(path.c_str(), (float)(Game::getAbsoluteTime() - start));
+    if (bundle)
+        _bundles[path] = bundle;
+    return bundle;
+}
+
+void SceneLoader::queueReads()
+{
+    // The files of the referenced properties, in the order they are loaded.
+    for (size_t i = 0, count = _referencedUrls.size(); i < count; ++i)
+    {
+        std::string file;
+        std::vector<std::string> namespacePath;
+        calculateNamespacePath(_referencedUrls[i], file, namespacePath);
+        _io.read(file.c_str());
+    }
+
+    // The main bundle, followed by the bundles that nodes are stitched in from.
+    _io.read(_gpbPath.c_str());
+    for (size_t i = 0, count = _flatSceneNodes.size(); i < count; ++i)
+    {
+        const std::vector<SceneNodeProperty>& properties = _flatSceneNodes[i]->_properties;
+        for (size_t j = 0, propertyCount = properties.size(); j < propertyCount; ++j)
+        {
+            if (properties[j]._type != SceneNodeProperty::URL)
                 continue;
-            }
-            iter->second = p;
+
+            std::string file;
+            std::string id;
+            splitURL(properties[j]._value, &file, &id);
+            _io.read(file.c_str());
         }
     }
 }
@@ -2,6 +2,7 @@
 #define SCENELOADER_H_
 
 #include "Base.h"
+#include "IOQueue.h"
 #include "Mesh.h"
 #include "PhysicsRigidBody.h"
 #include "Properties.h"
@@ -10,17 +11,123 @@
 namespace gameplay
 {
 
+class Bundle;
+
 /**
- * Defines an internal helper class for loading scenes from .scene files.
+ * Defines a helper class for loading scenes from .scene files.
+ *
+ * Scenes are usually loaded all at once with Scene::load. A scene loader created with
+ * create instead loads its scene in small steps, for as long as each call to update
+ * allows, so that a game can keep running its current scene and animate a loading
+ * screen while the next one loads. The steps are parsing the scene file, loading
+ * each referenced properties file, loading the bundle, and applying the URLs of
+ * each top level node and the properties of each node. The bundle is loaded in a
+ * single step.
+ *
+ * The files referenced by the scene, including its bundles, are all read on the workers of
+ * the job controller as soon as the scene file is parsed, so that reading them overlaps with
+ * loading the ones read before. Each bundle is opened once for the whole load.
+ *
+ * The collision objects of the scene are disabled until it has completed loading,
+ * so that its rigid bodies don't start simulating in the physics world meanwhile.
+ *
+ * \code
+ * void update(float elapsedTime)
+ * {
+ *     if (_loader && _loader->update(2.0f))
+ *     {
+ *         _nextScene = _loader->getScene();
+ *         _nextScene->addRef();
+ *         SAFE_DELETE(_loader);
+ *     }
+ *     _progressBar->setValue(_loader ? _loader->getProgress() : 1.0f);
+ * }
+ * \endcode
  *
  * @script{ignore}
  */
 class SceneLoader
 {
     friend class Scene;
+    friend class AssetLoader;
+
+public:
+
+    /**
+     * Creates a loader that loads the scene at the specified URL incrementally,
+     * where the URL is of the format "<file-path>.<extension>#<namespace-id>/<namespace-id>/.../<namespace-id>"
+     * (and "#<namespace-id>/<namespace-id>/.../<namespace-id>" is optional).
+     *
+     * Nothing is loaded until the first call to update.
+     *
+     * @param url The URL pointing to the Properties object defining the scene.
+     *
+     * @return The new scene loader, which the caller must delete.
+     */
+    static SceneLoader* create(const char* url);
+
+    /**
+     * Destructor.
+     *
+     * Releases the scene, including a partially loaded one.
+     */
+    ~SceneLoader();
+
+    /**
+     * Runs the steps of loading the scene for the given time, and at least one step.
+     *
+     * @param milliseconds The time in milliseconds that the steps may take.
+     *
+     * @return true if the scene has completed loading, or failed to load, false otherwise.
+     */
+    bool update(float milliseconds);
+
+    /**
+     * Returns the fraction of the steps of loading the scene that have run.
+     *
+     * @return The progress between 0 and 1.
+     */
+    float getProgress() const;
+
+    /**
+     * Determines if the scene has completed loading, or failed to load.
+     *
+     * @return true if the loader is complete, false otherwise.
+     */
+    bool isComplete() const;
+
+    /**
+     * Returns the loaded scene, which is owned by the loader.
+     *
+     * @return The scene, or NULL if it hasn't completed loading or failed to load.
+     */
+    Scene* getScene() const;
+
+    /**
+     * Sets whether scene loaders log how long each file of their scene took to read and
+     * to load once the scene has loaded, to find the assets that slow loading down.
+     *
+     * @param logged true to log the times of each file, false otherwise (the default).
+     */
+    static void setLoadTimesLogged(bool logged);
 
 private:
 
+    /**
+     * The stages of loading a scene, in order.
+     */
+    enum Stage
+    {
+        PARSE,
+        LOAD_FILES,
+        LOAD_BUNDLE,
+        APPLY_URLS,
+        APPLY_PROPERTIES,
+        APPLY_PHYSICS,
+        FINISH,
+        DONE
+    };
+
     /**
      * Loads a scene using the data from the Properties object defined at the specified URL, 
      * where the URL is of the format "<file-path>.<extension>#<namespace-id>/<namespace-id>/.../<namespace-id>"
@@ -62,7 +169,8 @@ private:
             SPRITE = 4096,
             TILESET = 8192,
             TEXT = 16384,
-            ENABLED = 32768
+            ENABLED = 32768,
+            REFLECTED = 65536
         };
 
         SceneNodeProperty(Type type, const std::string& value, int index, bool isUrl);
@@ -86,9 +194,35 @@ private:
         std::map<std::string, std::string> _tags;
     };
 
-    SceneLoader();
+    SceneLoader(const char* url, Properties* properties);
+
+    /**
+     * Hidden copy constructor.
+     */
+    SceneLoader(const SceneLoader& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    SceneLoader& operator=(const SceneLoader&);
+
+    /**
+     * Creates a loader for the scene defined by the given Properties object, which was already
+     * loaded from the specified URL and which the loader deletes.
+     */
+    static SceneLoader* create(const char* url, Properties* properties);
+
+    Scene* loadInternal();
+
+    bool step();
+
+    bool parse();
 
-    Scene* loadInternal(const char* url);
+    void collectSceneNodes(SceneNode& sceneNode);
+
+    void finish();
+
+    void clear();
 
     void applyTags(SceneNode& sceneNode);
 
@@ -96,14 +230,10 @@ private:
 
     void addSceneNodeProperty(SceneNode& sceneNode, SceneNodeProperty::Type type, const char* value = NULL, bool supportsUrl = false, int index = 0);
 
-    void applyNodeProperties(const Properties* sceneProperties, unsigned int typeFlags);
-
-    void applyNodeProperties(SceneNode& sceneNode, const Properties* sceneProperties, unsigned int typeFlags);
+    void applyNodeProperties(SceneNode& sceneNode, const Properties* sceneProperties, unsigned int typeFlags, bool recursive = true);
 
     void applyNodeProperty(SceneNode& sceneNode, Node* node, const Properties* sceneProperties, const SceneNodeProperty& snp);
 
-    void applyNodeUrls();
-
     void applyNodeUrls(SceneNode& sceneNode, Node* parent);
 
     void buildReferenceTables(Properties* sceneProperties);
@@ -122,7 +252,11 @@ private:
 
     void loadPhysics(Properties* physics);
 
-    void loadReferencedFiles();
+    void loadReferencedFile(const std::string& url, Properties** properties);
+
+    Bundle* openBundle(const std::string& path);
+
+    void queueReads();
 
     PhysicsConstraint* loadSocketConstraint(const Properties* constraint, PhysicsRigidBody* rbA, PhysicsRigidBody* rbB);
 
@@ -135,6 +269,18 @@ private:
     std::string _gpbPath;                                   // The path of the main GPB for the scene being loaded.
     std::string _path;                                      // The path of the scene file being loaded.
     Scene* _scene;                                          // The scene being loaded
+    std::string _url;                                       // The URL of the scene being loaded.
+    Properties* _rootProperties;                            // The properties loaded from the URL, which the loader owns.
+    Properties* _sceneProperties;                           // The 'scene' namespace of the root properties.
+    Stage _stage;                                           // The stage of loading the scene.
+    size_t _stepIndex;                                      // The index of the next step within the stage.
+    unsigned int _stepsDone;                                // The number of steps that have run.
+    unsigned int _stepCount;                                // The number of steps in total, known once parsed.
+    std::vector<std::string> _referencedUrls;               // The URLs of the properties to load from referenced files.
+    std::vector<SceneNode*> _flatSceneNodes;                // The scene nodes in the order their properties are applied.
+    std::vector<PhysicsCollisionObject*> _disabledObjects;  // The collision objects disabled until the scene is loaded.
+    std::map<std::string, Bundle*> _bundles;                // The bundles opened for the scene, by path.
+    IOQueue _io;                                            // Reads the files of the scene ahead of loading them.
 };
 
 /**
@@ -0,0 +1,642 @@
+#include "Base.h"
+#include "SceneSnapshot.h"
+#include "Scene.h"
+#include "Game.h"
+#include "FileSystem.h"
+#include "Animation.h"
+#include "AnimationClip.h"
+#include "PhysicsRigidBody.h"
+#include "MeshSkin.h"
+#include "Joint.h"
+
+// The identifier and version at the start of the data of a snapshot.
+#define SNAPSHOT_MAGIC      0x53535047
+#define SNAPSHOT_VERSION    1
+
+// The flags of a node.
+#define SNAPSHOT_NODE_ENABLED       0x01
+#define SNAPSHOT_NODE_RIGID_BODY    0x02
+
+// The flags of an animation clip.
+#define SNAPSHOT_CLIP_PLAYING       0x01
+#define SNAPSHOT_CLIP_PAUSED        0x02
+
+namespace gameplay
+{
+
+/**
+ * A registered serializer, or a pair of Lua functions.
+ */
+struct SnapshotSerializer
+{
+    std::string name;
+    SceneSnapshot::Serializer* serializer;
+    std::string saveFunction;
+    std::string loadFunction;
+};
+
+static std::vector<SnapshotSerializer> __serializers;
+
+/**
+ * Appends values to the data of a snapshot.
+ */
+class SnapshotWriter
+{
+public:
+
+    SnapshotWriter(std::vector<unsigned char>& data) : _data(data)
+    {
+    }
+
+    void write(const void* values, size_t size)
+    {
+        size_t offset = _data.size();
+        _data.resize(offset + size);
+        if (size > 0)
+            memcpy(&_data[offset], values, size);
+    }
+
+    template <class T>
+    void write(T value)
+    {
+        write(&value, sizeof(T));
+    }
+
+    void writeString(const char* str)
+    {
+        size_t length = str ? strlen(str) : 0;
+        GP_ASSERT(length < 65536);
+        write((unsigned short)length);
+        write(str, length);
+    }
+
+    /**
+     * Writes a placeholder for a value that is known later, and returns its offset.
+     */
+    size_t reserve(size_t size)
+    {
+        size_t offset = _data.size();
+        _data.resize(offset + size);
+        return offset;
+    }
+
+    template <class T>
+    void writeAt(size_t offset, T value)
+    {
+        memcpy(&_data[offset], &value, sizeof(T));
+    }
+
+private:
+
+    std::vector<unsigned char>& _data;
+};
+
+/**
+ * Reads values from the data of a snapshot, failing once the data is exhausted.
+ */
+class SnapshotReader
+{
+public:
+
+    SnapshotReader(const unsigned char* data, size_t size) : _data(data), _size(size), _offset(0)
+    {
+    }
+
+    bool read(void* values, size_t size)
+    {
+        if (size > _size - _offset)
+            return false;
+        if (size > 0)
+            memcpy(values, _data + _offset, size);
+        _offset += size;
+        return true;
+    }
+
+    template <class T>
+    bool read(T* value)
+    {
+        return read(value, sizeof(T));
+    }
+
+    /**
+     * Reads a string, which points into the data and is not null-terminated.
+     */
+    bool readString(const char** str, unsigned short* length)
+    {
+        if (!read(length) || *length > _size - _offset)
+            return false;
+        *str = (const char*)_data + _offset;
+        _offset += *length;
+        return true;
+    }
+
+    /**
+     * Returns the next bytes of the data and skips over them.
+     */
+    const unsigned char* readBytes(size_t size)
+    {
+        if (size > _size - _offset)
+            return NULL;
+        const unsigned char* bytes = _data + _offset;
+        _offset += size;
+        return bytes;
+    }
+
+private:
+
+    const unsigned char* _data;
+    size_t _size;
+    size_t _offset;
+};
+
+static bool matchesId(const char* id, const char* str, unsigned short length)
+{
+    return strncmp(id, str, length) == 0 && id[length] == '\0';
+}
+
+/**
+ * Adds a node and its descendants in the order that snapshots store them.
+ */
+static void listNodes(Node* node, std::vector<Node*>& nodes)
+{
+    nodes.push_back(node);
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        listNodes(child, nodes);
+    }
+}
+
+static SnapshotSerializer* findSerializer(const char* name)
+{
+    for (size_t i = 0, count = __serializers.size(); i < count; ++i)
+    {
+        if (__serializers[i].name == name)
+            return &__serializers[i];
+    }
+    return NULL;
+}
+
+SceneSnapshot::SceneSnapshot()
+{
+    _saveJob.result = true;
+}
+
+SceneSnapshot::~SceneSnapshot()
+{
+    waitForSave();
+}
+
+void SceneSnapshot::addSerializer(const char* name, Serializer* serializer)
+{
+    GP_ASSERT(name);
+    GP_ASSERT(serializer);
+
+    removeSerializer(name);
+    SnapshotSerializer entry;
+    entry.name = name;
+    entry.serializer = serializer;
+    __serializers.push_back(entry);
+}
+
+void SceneSnapshot::addScriptSerializer(const char* name, const char* saveFunction, const char* loadFunction)
+{
+    GP_ASSERT(name);
+    GP_ASSERT(saveFunction);
+    GP_ASSERT(loadFunction);
+
+    removeSerializer(name);
+    SnapshotSerializer entry;
+    entry.name = name;
+    entry.serializer = NULL;
+    entry.saveFunction = saveFunction;
+    entry.loadFunction = loadFunction;
+    __serializers.push_back(entry);
+}
+
+void SceneSnapshot::removeSerializer(const char* name)
+{
+    GP_ASSERT(name);
+
+    for (size_t i = 0, count = __serializers.size(); i < count; ++i)
+    {
+        if (__serializers[i].name == name)
+        {
+            __serializers.erase(__serializers.begin() + i);
+            return;
+        }
+    }
+}
+
+void SceneSnapshot::gatherAnimations(Node* node, std::vector<Animation*>& animations)
+{
+    GP_ASSERT(node);
+
+    if (node->_animationChannels)
+    {
+        for (size_t i = 0, count = node->_animationChannels->size(); i < count; ++i)
+        {
+            Animation* animation = (*node->_animationChannels)[i]->_animation;
+            if (animation && std::find(animations.begin(), animations.end(), animation) == animations.end())
+                animations.push_back(animation);
+        }
+    }
+
+    // The joints of a skin are only reached through its model, from the top level node of its hierarchy.
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    if (model && model->getSkin() && model->getSkin()->getRootJoint())
+    {
+        Node* root = model->getSkin()->getRootJoint();
+        while (root->getParent())
+            root = root->getParent();
+
+        std::vector<Node*> joints;
+        listNodes(root, joints);
+        for (size_t i = 0, jointCount = joints.size(); i < jointCount; ++i)
+        {
+            Node* joint = joints[i];
+            if (!joint->_animationChannels)
+                continue;
+            for (size_t j = 0, count = joint->_animationChannels->size(); j < count; ++j)
+            {
+                Animation* animation = (*joint->_animationChannels)[j]->_animation;
+                if (animation && std::find(animations.begin(), animations.end(), animation) == animations.end())
+                    animations.push_back(animation);
+            }
+        }
+    }
+}
+
+void SceneSnapshot::captureNode(Node* node, std::vector<Animation*>& animations, unsigned int* nodeCount)
+{
+    GP_ASSERT(node);
+    GP_ASSERT(nodeCount);
+
+    SnapshotWriter writer(_data);
+    writer.writeString(node->getId());
+
+    PhysicsCollisionObject* object = node->getCollisionObject();
+    PhysicsRigidBody* body = object && object->getType() == PhysicsCollisionObject::RIGID_BODY && object->isDynamic() ? static_cast<PhysicsRigidBody*>(object) : NULL;
+    unsigned char flags = (node->isEnabled() ? SNAPSHOT_NODE_ENABLED : 0) | (body ? SNAPSHOT_NODE_RIGID_BODY : 0);
+    writer.write(flags);
+
+    const Vector3& scale = node->getScale();
+    const Quaternion& rotation = node->getRotation();
+    const Vector3& translation = node->getTranslation();
+    float transform[10] = { scale.x, scale.y, scale.z, rotation.x, rotation.y, rotation.z, rotation.w, translation.x, translation.y, translation.z };
+    writer.write(transform, sizeof(transform));
+
+    if (body)
+    {
+        Vector3 linear = body->getLinearVelocity();
+        Vector3 angular = body->getAngularVelocity();
+        float velocities[6] = { linear.x, linear.y, linear.z, angular.x, angular.y, angular.z };
+        writer.write(velocities, sizeof(velocities));
+    }
+    ++(*nodeCount);
+
+    gatherAnimations(node, animations);
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        captureNode(child, animations, nodeCount);
+    }
+}
+
+void SceneSnapshot::capture(Scene* scene)
+{
+    GP_ASSERT(scene);
+    GP_PROFILE("SceneSnapshot::capture");
+
+    // The buffer keeps its capacity from the previous capture.
+    waitForSave();
+    _data.clear();
+
+    SnapshotWriter writer(_data);
+    writer.write((unsigned int)SNAPSHOT_MAGIC);
+    writer.write((unsigned int)SNAPSHOT_VERSION);
+    size_t nodeCountOffset = writer.reserve(sizeof(unsigned int));
+
+    unsigned int nodeCount = 0;
+    std::vector<Animation*> animations;
+    for (Node* node = scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        captureNode(node, animations, &nodeCount);
+    }
+    writer.writeAt(nodeCountOffset, nodeCount);
+
+    writer.write((unsigned int)animations.size());
+    for (size_t i = 0, count = animations.size(); i < count; ++i)
+    {
+        Animation* animation = animations[i];
+        writer.writeString(animation->getId());
+        unsigned int clipCount = animation->getClipCount();
+        writer.write(clipCount);
+        for (unsigned int j = 0; j < clipCount; ++j)
+        {
+            AnimationClip* clip = animation->getClip(j);
+            GP_ASSERT(clip);
+            writer.writeString(clip->getId());
+            bool playing = clip->isClipStateBitSet(AnimationClip::CLIP_IS_PLAYING_BIT) && !clip->isClipStateBitSet(AnimationClip::CLIP_IS_MARKED_FOR_REMOVAL_BIT);
+            unsigned char flags = (playing ? SNAPSHOT_CLIP_PLAYING : 0) | (clip->isClipStateBitSet(AnimationClip::CLIP_IS_PAUSED_BIT) ? SNAPSHOT_CLIP_PAUSED : 0);
+            writer.write(flags);
+            float state[3] = { clip->getElapsedTime(), clip->getSpeed(), clip->getBlendWeight() };
+            writer.write(state, sizeof(state));
+        }
+    }
+
+    writer.write((unsigned int)__serializers.size());
+    std::vector<unsigned char> blob;
+    for (size_t i = 0, count = __serializers.size(); i < count; ++i)
+    {
+        const SnapshotSerializer& entry = __serializers[i];
+        writer.writeString(entry.name.c_str());
+        blob.clear();
+        if (entry.serializer)
+        {
+            entry.serializer->serialize(&blob);
+        }
+        else
+        {
+            std::string str;
+            if (Game::getInstance()->getScriptController()->executeFunction<std::string>(entry.saveFunction.c_str(), &str))
+                blob.assign(str.begin(), str.end());
+        }
+        writer.write((unsigned int)blob.size());
+        writer.write(blob.empty() ? NULL : &blob[0], blob.size());
+    }
+}
+
+void SceneSnapshot::restoreClip(AnimationClip* clip, unsigned char flags, float elapsedTime, float speed, float blendWeight)
+{
+    GP_ASSERT(clip);
+
+    clip->setSpeed(speed);
+    clip->setBlendWeight(blendWeight);
+
+    bool playing = clip->isClipStateBitSet(AnimationClip::CLIP_IS_PLAYING_BIT) && !clip->isClipStateBitSet(AnimationClip::CLIP_IS_MARKED_FOR_REMOVAL_BIT);
+    if (!(flags & SNAPSHOT_CLIP_PLAYING))
+    {
+        if (playing)
+            clip->stop();
+        return;
+    }
+
+    // Playing a clip that runs would restart it, and playing a paused clip resumes it.
+    if (!playing || clip->isClipStateBitSet(AnimationClip::CLIP_IS_PAUSED_BIT))
+        clip->play();
+
+    // A running clip continues from its elapsed time, and a clip that begins with its next
+    // update computes it from the time it was started at.
+    clip->_elapsedTime = elapsedTime;
+    if (speed > 0.0f)
+        clip->_timeStarted = Game::getGameTime() - elapsedTime / speed;
+    else if (speed < 0.0f)
+        clip->_timeStarted = Game::getGameTime() - (elapsedTime - (float)clip->_activeDuration) / speed;
+
+    if (flags & SNAPSHOT_CLIP_PAUSED)
+        clip->pause();
+}
+
+bool SceneSnapshot::restore(Scene* scene) const
+{
+    GP_ASSERT(scene);
+    GP_PROFILE("SceneSnapshot::restore");
+
+    SnapshotReader reader(_data.empty() ? NULL : &_data[0], _data.size());
+    unsigned int magic, version, nodeCount;
+    if (!reader.read(&magic) || magic != SNAPSHOT_MAGIC || !reader.read(&version) || version != SNAPSHOT_VERSION || !reader.read(&nodeCount))
+    {
+        GP_WARN("Invalid scene snapshot.");
+        return false;
+    }
+
+    // Nodes are expected in the order that they are found in the scene, so the node at the
+    // same place is tried before looking the node up by id.
+    std::vector<Node*> nodes;
+    for (Node* node = scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        listNodes(node, nodes);
+    }
+    std::vector<std::pair<PhysicsRigidBody*, const float*> > bodies;
+    std::string id;
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+        const char* str;
+        unsigned short length;
+        unsigned char flags;
+        const float* transform;
+        if (!reader.readString(&str, &length) || !reader.read(&flags) || (transform = (const float*)reader.readBytes(sizeof(float) * 10)) == NULL)
+        {
+            GP_WARN("Invalid node %u of scene snapshot.", i);
+            return false;
+        }
+        const float* velocities = NULL;
+        if ((flags & SNAPSHOT_NODE_RIGID_BODY) && (velocities = (const float*)reader.readBytes(sizeof(float) * 6)) == NULL)
+        {
+            GP_WARN("Invalid rigid body of node %u of scene snapshot.", i);
+            return false;
+        }
+
+        Node* node = i < nodes.size() ? nodes[i] : NULL;
+        if (!node || !matchesId(node->getId(), str, length))
+        {
+            id.assign(str, length);
+            node = scene->findNode(id.c_str());
+            if (!node)
+                continue;
+        }
+
+        // The floats may not be aligned within the data.
+        float values[10];
+        memcpy(values, transform, sizeof(values));
+        node->set(Vector3(values[0], values[1], values[2]), Quaternion(values[3], values[4], values[5], values[6]), Vector3(values[7], values[8], values[9]));
+        node->setEnabled((flags & SNAPSHOT_NODE_ENABLED) != 0);
+
+        PhysicsCollisionObject* object = node->getCollisionObject();
+        if (velocities && object && object->getType() == PhysicsCollisionObject::RIGID_BODY)
+            bodies.push_back(std::make_pair(static_cast<PhysicsRigidBody*>(object), velocities));
+    }
+
+    // Bodies are moved once all transforms are restored, since they follow world transforms.
+    for (size_t i = 0, count = bodies.size(); i < count; ++i)
+    {
+        float values[6];
+        memcpy(values, bodies[i].second, sizeof(values));
+        PhysicsRigidBody* body = bodies[i].first;
+        body->resetTransformFromNode();
+        body->setLinearVelocity(values[0], values[1], values[2]);
+        body->setAngularVelocity(values[3], values[4], values[5]);
+    }
+
+    unsigned int animationCount;
+    if (!reader.read(&animationCount))
+    {
+        GP_WARN("Invalid animations of scene snapshot.");
+        return false;
+    }
+    std::vector<Animation*> animations;
+    for (size_t i = 0, count = animationCount > 0 ? nodes.size() : 0; i < count; ++i)
+    {
+        gatherAnimations(nodes[i], animations);
+    }
+    for (unsigned int i = 0; i < animationCount; ++i)
+    {
+        const char* str;
+        unsigned short length;
+        unsigned int clipCount;
+        if (!reader.readString(&str, &length) || !reader.read(&clipCount))
+        {
+            GP_WARN("Invalid animation %u of scene snapshot.", i);
+            return false;
+        }
+        Animation* animation = NULL;
+        for (size_t j = 0, count = animations.size(); j < count && !animation; ++j)
+        {
+            if (matchesId(animations[j]->getId(), str, length))
+                animation = animations[j];
+        }
+
+        for (unsigned int j = 0; j < clipCount; ++j)
+        {
+            unsigned char flags;
+            float state[3];
+            if (!reader.readString(&str, &length) || !reader.read(&flags) || !reader.read(state, sizeof(state)))
+            {
+                GP_WARN("Invalid animation clip %u of scene snapshot.", j);
+                return false;
+            }
+            if (!animation)
+                continue;
+            id.assign(str, length);
+            AnimationClip* clip = animation->getClip(id.c_str());
+            if (clip)
+                restoreClip(clip, flags, state[0], state[1], state[2]);
+        }
+    }
+
+    unsigned int blobCount;
+    if (!reader.read(&blobCount))
+    {
+        GP_WARN("Invalid blobs of scene snapshot.");
+        return false;
+    }
+    for (unsigned int i = 0; i < blobCount; ++i)
+    {
+        const char* str;
+        unsigned short length;
+        unsigned int size;
+        const unsigned char* blob;
+        if (!reader.readString(&str, &length) || !reader.read(&size) || ((blob = reader.readBytes(size)) == NULL && size > 0))
+        {
+            GP_WARN("Invalid blob %u of scene snapshot.", i);
+            return false;
+        }
+        id.assign(str, length);
+        SnapshotSerializer* entry = findSerializer(id.c_str());
+        if (!entry)
+            continue;
+        if (entry->serializer)
+        {
+            entry->serializer->deserialize(blob, size);
+        }
+        else
+        {
+            std::string value((const char*)blob, size);
+            Game::getInstance()->getScriptController()->executeFunction<void>(entry->loadFunction.c_str(), "s", NULL, value.c_str());
+        }
+    }
+    return true;
+}
+
+const unsigned char* SceneSnapshot::getData() const
+{
+    return _data.empty() ? NULL : &_data[0];
+}
+
+unsigned int SceneSnapshot::getSize() const
+{
+    return (unsigned int)_data.size();
+}
+
+void SceneSnapshot::setData(const unsigned char* data, unsigned int size)
+{
+    GP_ASSERT(data || size == 0);
+
+    waitForSave();
+    _data.assign(data, data + size);
+}
+
+void SceneSnapshot::SaveJob::execute(unsigned int worker)
+{
+    Stream* stream = FileSystem::open(path.c_str(), FileSystem::WRITE);
+    if (!stream)
+    {
+        result = false;
+        return;
+    }
+    result = data.empty() || stream->write(&data[0], 1, data.size()) == data.size();
+    stream->close();
+    SAFE_DELETE(stream);
+}
+
+bool SceneSnapshot::save(const char* path, bool async)
+{
+    GP_ASSERT(path);
+
+    // The data is copied, so that the snapshot can be captured again while it is written.
+    waitForSave();
+    _saveJob.path = path;
+    _saveJob.data = _data;
+    if (async)
+    {
+        Game::getInstance()->getJobController()->submit(&_saveJob, &_saveGroup);
+        return true;
+    }
+
+    _saveJob.execute(0);
+    if (!_saveJob.result)
+        GP_WARN("Failed to write scene snapshot to '%s'.", path);
+    return _saveJob.result;
+}
+
+bool SceneSnapshot::isSaving() const
+{
+    return !_saveGroup.isComplete();
+}
+
+bool SceneSnapshot::waitForSave()
+{
+    if (!_saveGroup.isComplete())
+    {
+        Game::getInstance()->getJobController()->wait(&_saveGroup);
+        if (!_saveJob.result)
+            GP_WARN("Failed to write scene snapshot to '%s'.", _saveJob.path.c_str());
+    }
+    return _saveJob.result;
+}
+
+bool SceneSnapshot::load(const char* path)
+{
+    GP_ASSERT(path);
+
+    waitForSave();
+    Stream* stream = FileSystem::open(path);
+    if (!stream)
+    {
+        GP_WARN("Failed to open scene snapshot '%s'.", path);
+        return false;
+    }
+    size_t length = stream->length();
+    _data.resize(length);
+    bool result = length == 0 || stream->read(&_data[0], 1, length) == length;
+    stream->close();
+    SAFE_DELETE(stream);
+    if (!result)
+    {
+        GP_WARN("Failed to read scene snapshot '%s'.", path);
+        _data.clear();
+    }
+    return result;
+}
+
+}
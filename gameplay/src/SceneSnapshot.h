@@ -0,0 +1,230 @@
+#ifndef SCENESNAPSHOT_H_
+#define SCENESNAPSHOT_H_
+
+#include "JobController.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+class Animation;
+class AnimationClip;
+
+/**
+ * Defines a binary snapshot of the state of a scene, for save games and checkpoints.
+ *
+ * A snapshot holds the local transform and the enabled flag of every node of a scene,
+ * the velocities of their dynamic rigid bodies, the time, speed, weight and play state
+ * of the clips of the animations that target them, and the blobs of the registered
+ * serializers. Everything is packed into a single buffer that grows to the size of the
+ * scene once and is reused by later captures, so that capturing a scene costs little
+ * more than reading its nodes.
+ *
+ * Nodes are stored in the order that they are found in the scene, with their ids, and are
+ * restored to the node found at the same place if it has the same id, or otherwise to the
+ * node found by id. The joint hierarchies of skins are not stored, since their animations
+ * pose them again.
+ *
+ * Snapshots can be written to disk on a worker thread of the job controller, so that an
+ * autosave only takes the time of a capture on the main thread. A snapshot waits for its
+ * pending write when it is destroyed.
+ *
+ * @script{ignore}
+ */
+class SceneSnapshot
+{
+public:
+
+    /**
+     * Defines an interface for game state that is stored in snapshots as an opaque blob.
+     */
+    class Serializer
+    {
+    public:
+
+        /**
+         * Destructor.
+         */
+        virtual ~Serializer() { }
+
+        /**
+         * Called when a snapshot is captured to append the state to the given blob.
+         *
+         * @param data The blob to append the state to, which is empty when called.
+         */
+        virtual void serialize(std::vector<unsigned char>* data) = 0;
+
+        /**
+         * Called when a snapshot is restored with the blob that serialize appended to.
+         *
+         * @param data The data of the blob.
+         * @param size The size of the blob in bytes.
+         */
+        virtual void deserialize(const unsigned char* data, unsigned int size) = 0;
+    };
+
+    /**
+     * Constructor.
+     */
+    SceneSnapshot();
+
+    /**
+     * Destructor.
+     *
+     * Waits for a pending write to disk.
+     */
+    ~SceneSnapshot();
+
+    /**
+     * Registers a serializer that stores a blob under the given name in every snapshot.
+     *
+     * @param name The name of the blob, which replaces any serializer of the same name.
+     * @param serializer The serializer, which must remain valid until it is removed.
+     */
+    static void addSerializer(const char* name, Serializer* serializer);
+
+    /**
+     * Registers a pair of Lua functions that store a blob under the given name in every snapshot.
+     *
+     * The save function takes no parameters and returns a string, which the load function
+     * is called with when the snapshot is restored. Since the strings are passed through
+     * the script controller, they must not contain null characters.
+     *
+     * @param name The name of the blob, which replaces any serializer of the same name.
+     * @param saveFunction The name of the Lua function that returns the blob.
+     * @param loadFunction The name of the Lua function that is called with the blob.
+     */
+    static void addScriptSerializer(const char* name, const char* saveFunction, const char* loadFunction);
+
+    /**
+     * Unregisters the serializer with the given name.
+     *
+     * @param name The name of the blob.
+     */
+    static void removeSerializer(const char* name);
+
+    /**
+     * Captures the state of a scene, replacing the previous contents of the snapshot.
+     *
+     * Waits for a pending write of the previous contents to disk.
+     *
+     * @param scene The scene to capture.
+     */
+    void capture(Scene* scene);
+
+    /**
+     * Restores the state of a scene from the snapshot.
+     *
+     * Nodes, animations and blobs that are in the snapshot but not in the scene, or the
+     * serializers that are registered, are skipped.
+     *
+     * @param scene The scene to restore.
+     *
+     * @return true if the snapshot was restored, false if its data is invalid.
+     */
+    bool restore(Scene* scene) const;
+
+    /**
+     * Returns the data of the snapshot.
+     *
+     * @return The data, or NULL if the snapshot is empty.
+     */
+    const unsigned char* getData() const;
+
+    /**
+     * Returns the size of the data of the snapshot.
+     *
+     * @return The size in bytes.
+     */
+    unsigned int getSize() const;
+
+    /**
+     * Replaces the data of the snapshot, such as with data that was stored elsewhere.
+     *
+     * @param data The data of a snapshot.
+     * @param size The size of the data in bytes.
+     */
+    void setData(const unsigned char* data, unsigned int size);
+
+    /**
+     * Writes the snapshot to a file.
+     *
+     * @param path The path of the file.
+     * @param async true to write the file on a worker thread of the job controller and
+     *      return immediately, false to write it before returning.
+     *
+     * @return true if the file was written or the write was submitted.
+     */
+    bool save(const char* path, bool async = false);
+
+    /**
+     * Returns whether a write of the snapshot to disk is still pending.
+     *
+     * @return true if a write is pending.
+     */
+    bool isSaving() const;
+
+    /**
+     * Waits for a pending write of the snapshot to disk.
+     *
+     * @return true if the last write succeeded.
+     */
+    bool waitForSave();
+
+    /**
+     * Reads a snapshot from a file, replacing the contents of the snapshot.
+     *
+     * @param path The path of the file.
+     *
+     * @return true if the file was read.
+     */
+    bool load(const char* path);
+
+private:
+
+    /**
+     * The job that writes a copy of the data of a snapshot to a file.
+     */
+    class SaveJob : public JobController::Job
+    {
+    public:
+        void execute(unsigned int worker);
+        std::string path;
+        std::vector<unsigned char> data;
+        bool result;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    SceneSnapshot(const SceneSnapshot& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    SceneSnapshot& operator=(const SceneSnapshot&);
+
+    /**
+     * Writes a node and its descendants, and gathers the animations that target them.
+     */
+    void captureNode(Node* node, std::vector<Animation*>& animations, unsigned int* nodeCount);
+
+    /**
+     * Adds the animations that target a node and its descendants, including the joints of skins.
+     */
+    static void gatherAnimations(Node* node, std::vector<Animation*>& animations);
+
+    /**
+     * Restores the state of an animation clip.
+     */
+    static void restoreClip(AnimationClip* clip, unsigned char flags, float elapsedTime, float speed, float blendWeight);
+
+    std::vector<unsigned char> _data;
+    SaveJob _saveJob;
+    JobController::Group _saveGroup;
+};
+
+}
+
+#endif
@@ -0,0 +1,233 @@
+#include "Base.h"
+#include "ScriptContext.h"
+#include "ScriptController.h"
+#include "FileSystem.h"
+#include "Game.h"
+#include "MemoryTracker.h"
+
+namespace gameplay
+{
+
+extern void appendLuaPath(lua_State* state, const char* path);
+
+ScriptContext::UpdateJob::UpdateJob(ScriptContext* context) : context(context), elapsedTime(0.0f)
+{
+}
+
+void ScriptContext::UpdateJob::execute(unsigned int worker)
+{
+    context->update(elapsedTime);
+}
+
+ScriptContext::ScriptContext(const char* path) : _path(path), _lua(NULL), _job(this)
+{
+    GP_REGISTER_SCRIPT_EVENTS();
+}
+
+ScriptContext::~ScriptContext()
+{
+    // Stop the update of the context before its state is closed.
+    Game::getInstance()->getScriptController()->removeContext(this);
+
+    if (_lua)
+    {
+        Game::getInstance()->getScriptController()->_profiler->detach(_lua);
+        lua_close(_lua);
+        _lua = NULL;
+    }
+}
+
+ScriptContext* ScriptContext::create(const char* path)
+{
+    GP_ASSERT(path);
+
+    ScriptContext* context = new ScriptContext(path);
+    if (!context->load())
+    {
+        SAFE_RELEASE(context);
+        return NULL;
+    }
+    Game::getInstance()->getScriptController()->addContext(context);
+    return context;
+}
+
+const char* ScriptContext::getTypeName() const
+{
+    return "ScriptContext";
+}
+
+const char* ScriptContext::getPath() const
+{
+    return _path.c_str();
+}
+
+void ScriptContext::post(const char* name, const char* data)
+{
+    GP_ASSERT(name);
+
+    Message message;
+    message.name = name;
+    message.data = data ? data : "";
+
+    std::lock_guard<std::mutex> lock(_inboxMutex);
+    _inbox.push_back(message);
+}
+
+bool ScriptContext::load()
+{
+#ifdef GP_USE_LUAJIT
+    _lua = luaL_newstate();
+#else
+    _lua = lua_newstate(&ScriptContext::allocate, NULL);
+#endif
+    if (!_lua)
+    {
+        GP_WARN("Failed to create the Lua state of script context: %s.", _path.c_str());
+        return false;
+    }
+    luaL_openlibs(_lua);
+    appendLuaPath(_lua, FileSystem::getResourcePath());
+
+    lua_pushlightuserdata(_lua, this);
+    lua_pushcclosure(_lua, &ScriptContext::lua_post, 1);
+    lua_setglobal(_lua, "post");
+    lua_pushcfunction(_lua, &ScriptContext::lua_print);
+    lua_setglobal(_lua, "print");
+
+    if (!FileSystem::fileExists(_path.c_str()))
+    {
+        GP_WARN("Failed to load script context: %s. File does not exist.", _path.c_str());
+        return false;
+    }
+
+    int size = 0;
+    char* source = FileSystem::readAll(_path.c_str(), &size);
+    int ret = luaL_loadbuffer(_lua, source, size, _path.c_str());
+    SAFE_DELETE_ARRAY(source);
+    if (ret == LUA_OK)
+        ret = lua_pcall(_lua, 0, 0, 0);
+    if (ret != LUA_OK)
+    {
+        GP_WARN("Failed to load script context: %s. %s.", _path.c_str(), lua_tostring(_lua, -1));
+        lua_pop(_lua, 1);
+        return false;
+    }
+
+    return true;
+}
+
+void ScriptContext::update(float elapsedTime)
+{
+    {
+        std::lock_guard<std::mutex> lock(_inboxMutex);
+        _updateInbox.swap(_inbox);
+    }
+
+    for (size_t i = 0, count = _updateInbox.size(); i < count; ++i)
+    {
+        const Message& message = _updateInbox[i];
+        lua_pushlstring(_lua, message.name.c_str(), message.name.size());
+        lua_pushlstring(_lua, message.data.c_str(), message.data.size());
+        call("message", 2);
+    }
+    _updateInbox.clear();
+
+    lua_pushnumber(_lua, elapsedTime);
+    call("update", 1);
+}
+
+void ScriptContext::dispatchMessages()
+{
+    for (size_t i = 0, count = _outbox.size(); i < count; ++i)
+    {
+        const Message& message = _outbox[i];
+        fireScriptEvent<void>(GP_GET_SCRIPT_EVENT(ScriptContext, message), dynamic_cast<void*>(this), message.name.c_str(), message.data.c_str());
+    }
+    _outbox.clear();
+}
+
+void ScriptContext::call(const char* function, int argumentCount)
+{
+    lua_getglobal(_lua, function);
+    if (!lua_isfunction(_lua, -1))
+    {
+        lua_pop(_lua, argumentCount + 1);
+        return;
+    }
+
+    // Move the function below its arguments.
+    lua_insert(_lua, -(argumentCount + 1));
+    ScriptProfiler* profiler = Game::getInstance()->getScriptController()->_profiler;
+    profiler->enter(_lua);
+    int ret = lua_pcall(_lua, argumentCount, 0, 0);
+    profiler->leave(_lua);
+    if (ret != LUA_OK)
+    {
+        GP_WARN("Failed to call function '%s' of script context %s with error: %s.", function, _path.c_str(), lua_tostring(_lua, -1));
+        lua_pop(_lua, 1);
+    }
+}
+
+void* ScriptContext::allocate(void* userData, void* ptr, size_t oldSize, size_t newSize)
+{
+    // Lua passes the type of the new object instead of a size when allocating.
+    if (ptr == NULL)
+        oldSize = 0;
+
+    if (newSize == 0)
+    {
+        if (ptr)
+        {
+            free(ptr);
+            MemoryTracker::remove(MemoryTracker::SCRIPT, oldSize);
+        }
+        return NULL;
+    }
+
+    void* block = realloc(ptr, newSize);
+    if (block && ptr)
+        MemoryTracker::resize(MemoryTracker::SCRIPT, oldSize, newSize);
+    else if (block)
+        MemoryTracker::add(MemoryTracker::SCRIPT, newSize);
+    return block;
+}
+
+int ScriptContext::lua_post(lua_State* state)
+{
+    ScriptContext* context = (ScriptContext*)lua_touserdata(state, lua_upvalueindex(1));
+    GP_ASSERT(context);
+
+    size_t nameLength = 0;
+    size_t dataLength = 0;
+    const char* name = luaL_checklstring(state, 1, &nameLength);
+    const char* data = luaL_optlstring(state, 2, "", &dataLength);
+
+    // Only the worker updating the context posts, and the main thread reads the
+    // messages once the update has completed.
+    Message message;
+    message.name.assign(name, nameLength);
+    message.data.assign(data, dataLength);
+    context->_outbox.push_back(message);
+    return 0;
+}
+
+int ScriptContext::lua_print(lua_State* state)
+{
+    std::string str;
+    for (int i = 1, count = lua_gettop(state); i <= count; ++i)
+    {
+        if (i > 1)
+            str += '\t';
+        const char* s = lua_tostring(state, i);
+        if (s)
+            str += s;
+        else if (lua_isboolean(state, i))
+            str += lua_toboolean(state, i) ? "true" : "false";
+        else
+            str += luaL_typename(state, i);
+    }
+    gameplay::print("%s\n", str.c_str());
+    return 0;
+}
+
+}
@@ -0,0 +1,203 @@
+#ifndef SCRIPTCONTEXT_H_
+#define SCRIPTCONTEXT_H_
+
+#include "Ref.h"
+#include "ScriptTarget.h"
+#include "JobController.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines a script that runs in its own Lua state, in parallel with the main thread.
+ *
+ * Scripts that run in a context are isolated from the game: their state has the
+ * standard Lua libraries but none of the engine bindings, since objects of the
+ * engine may only be accessed from the main thread. A context exchanges messages
+ * with the game instead, each made of a name and a string of data that the scripts
+ * are free to encode their data in. This suits work such as planning AI decisions
+ * or computing UI models, which can run alongside the update and rendering of each
+ * frame and whose results are then applied by the main thread.
+ *
+ * Once per frame, every context executes on a worker of the JobController, while
+ * the main thread updates and renders the frame. A context first calls the script
+ * function message(name, data) for each message posted to it since its last
+ * update, and then calls update(elapsedTime). Both functions are optional. The
+ * script posts messages to the game with the global function post(name, data),
+ * which are delivered after the frame is rendered, through the "message" script
+ * event of the context:
+ *
+ * @code
+ * -- res/ai/planner.lua, running in the context.
+ * function message(name, data)
+ *     if name == "target" then target = data end
+ * end
+ *
+ * function update(elapsedTime)
+ *     post("path", computePath(target))
+ * end
+ *
+ * -- In the game script.
+ * planner = ScriptContext.create("res/ai/planner.lua")
+ * planner:addScriptCallback(planner:getScriptEvent("message"), "onPlanner")
+ *
+ * function onPlanner(context, name, data)
+ *     ...
+ * end
+ * @endcode
+ *
+ * Scripts of different contexts execute in parallel, while each context executes
+ * on one thread at a time, so splitting work across several contexts, such as one
+ * per group of agents, spreads it across the workers. Modules can be loaded with
+ * require from the resource path.
+ */
+class ScriptContext : public Ref, public ScriptTarget
+{
+    friend class ScriptController;
+    friend class ScriptProfiler;
+
+    GP_SCRIPT_EVENTS_START();
+    GP_SCRIPT_EVENT(message, "<ScriptContext>ss");
+    GP_SCRIPT_EVENTS_END();
+
+public:
+
+    /**
+     * Creates a context and loads the given script into it.
+     *
+     * The script is executed once on the calling thread, which must be the main
+     * thread, before the context starts to update with the next frame.
+     *
+     * @param path The path of the script to load.
+     *
+     * @return The new context, or NULL if the script could not be loaded.
+     * @script{create}
+     */
+    static ScriptContext* create(const char* path);
+
+    /**
+     * Extends ScriptTarget::getTypeName() to return the type name of this class.
+     *
+     * @return The type name of this class: "ScriptContext"
+     * @see ScriptTarget::getTypeName()
+     */
+    const char* getTypeName() const;
+
+    /**
+     * Returns the path of the script of the context.
+     *
+     * @return The script path.
+     */
+    const char* getPath() const;
+
+    /**
+     * Posts a message to the script of the context, which receives it in its next update.
+     *
+     * Messages can be posted from any thread.
+     *
+     * @param name The name of the message.
+     * @param data The data of the message (optional).
+     */
+    void post(const char* name, const char* data = NULL);
+
+private:
+
+    /**
+     * A message between a context and the game.
+     */
+    struct Message
+    {
+        std::string name;
+        std::string data;
+    };
+
+    /**
+     * The job that updates a context on a worker.
+     */
+    class UpdateJob : public JobController::Job
+    {
+    public:
+
+        UpdateJob(ScriptContext* context);
+
+        void execute(unsigned int worker);
+
+        ScriptContext* context;
+        float elapsedTime;
+    };
+
+    /**
+     * Constructor.
+     */
+    ScriptContext(const char* path);
+
+    /**
+     * Destructor.
+     */
+    ~ScriptContext();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ScriptContext(const ScriptContext& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ScriptContext& operator=(const ScriptContext&);
+
+    /**
+     * Creates the Lua state of the context and executes its script.
+     *
+     * @return True if the script was loaded, false otherwise.
+     */
+    bool load();
+
+    /**
+     * Delivers the messages posted to the context and updates its script, on a worker.
+     *
+     * @param elapsedTime The elapsed game time.
+     */
+    void update(float elapsedTime);
+
+    /**
+     * Fires the message event for the messages that the script posted during its update,
+     * on the main thread.
+     */
+    void dispatchMessages();
+
+    /**
+     * Calls a function of the script, if it exists, with the arguments on the stack.
+     *
+     * @param function The name of the function.
+     * @param argumentCount The number of arguments on the stack, which are popped.
+     */
+    void call(const char* function, int argumentCount);
+
+    /**
+     * The allocator of the Lua states of contexts, which tracks their memory.
+     */
+    static void* allocate(void* userData, void* ptr, size_t oldSize, size_t newSize);
+
+    /**
+     * The post(name, data) function of the scripts of contexts.
+     */
+    static int lua_post(lua_State* state);
+
+    /**
+     * The print(...) function of the scripts of contexts.
+     */
+    static int lua_print(lua_State* state);
+
+    std::string _path;
+    lua_State* _lua;
+    std::mutex _inboxMutex;
+    std::vector<Message> _inbox;
+    std::vector<Message> _updateInbox;
+    std::vector<Message> _outbox;
+    UpdateJob _job;
+};
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "FileSystem.h"
 #include "ScriptController.h"
+#include "MemoryTracker.h"
 
 #ifndef GP_NO_LUA_BINDINGS
 #include "lua/lua_all_bindings.h"
@@ -98,10 +99,10 @@ static bool getNestedVariable(lua_State* lua, const char* name, int env = 0)
         return true;
     }
 
-    static std::string str;
     // Copy the input string to a std::string so we can modify it because 
-    // some of the Lua functions require NULL terminated c-strings.
-    str.assign(name);
+    // some of the Lua functions require NULL terminated c-strings. It is not static
+    // since the script contexts are updated on several threads at once.
+    std::string str(name);
 
     // Find the first table, which will be a global variable.
     char* start = const_cast<char*>(str.c_str());
@@ -219,19 +220,32 @@ bool ScriptController::loadScript(Script* script)
 {
     GP_ASSERT(script);
 
-    if (!FileSystem::fileExists(script->_path.c_str()))
+    // Loading a script may define functions that callbacks refer to by name.
+    ++_generation;
+
+    // Scripts precompiled by the encoder are loaded in place of their source when only the
+    // bytecode is shipped.
+    std::string path = script->_path;
+    if (!FileSystem::fileExists(path.c_str()))
     {
-        GP_WARN("Failed to load script: %s. File does not exist.", script->_path.c_str());
-        return false;
+        path += 'c';
+        if (script->_path.size() < 4 || script->_path.compare(script->_path.size() - 4, 4, ".lua") != 0 || !FileSystem::fileExists(path.c_str()))
+        {
+            GP_WARN("Failed to load script: %s. File does not exist.", script->_path.c_str());
+            return false;
+        }
     }
 
     // Insert an entry into _scripts before loading the script, to prevent load recursion
     std::vector<Script*>& scripts = _scripts[script->_path];
     scripts.push_back(script);
 
-    // Load the contents of the script, but don't execute it yet
-    const char* scriptSource = FileSystem::readAll(script->_path.c_str());
-    int ret = luaL_loadstring(_lua, scriptSource); // [chunk]
+    // Load the contents of the script, but don't execute it yet. Lua detects whether the
+    // contents are source or precompiled bytecode, which is loaded without being parsed.
+    int size = 0;
+    const char* scriptSource = FileSystem::readAll(path.c_str(), &size);
+    std::string chunkName = "@" + script->_path;
+    int ret = luaL_loadbuffer(_lua, scriptSource, size, chunkName.c_str()); // [chunk]
     SAFE_DELETE_ARRAY(scriptSource);
 
     if (ret == LUA_OK)
@@ -265,15 +279,22 @@ bool ScriptController::loadScript(Script* script)
             lua_pushvalue(_lua, -1); // [chunk, env, env]
             lua_setfield(_lua, -2, "_THIS"); // [chunk, env]
 
+#ifdef GP_USE_LUAJIT
+            // Set the function environment of our chunk to the new environment table
+            if (lua_setfenv(_lua, -2) == 0) // [chunk]
+#else
             // Set the first upvalue (_ENV) for our chunk to the new environment table
             if (lua_setupvalue(_lua, -2, 1) == NULL) // [chunk]
+#endif
             {
                 GP_WARN("Error setting environment table for script: %s.", script->_path.c_str());
             }
         }
 
         // Execute the script
+        _profiler->enter(_lua);
         ret = lua_pcall(_lua, 0, 0, 0);
+        _profiler->leave(_lua);
     }
 
     if (ret != LUA_OK)
@@ -288,6 +309,8 @@ bool ScriptController::loadScript(Script* script)
 
 void ScriptController::unloadScript(Script* script)
 {
+    ++_generation;
+
     if (script->_env != 0)
     {
         // Release the reference to the environment table for this non-global script
@@ -657,12 +680,23 @@ void ScriptController::print(const char* str1, const char* str2)
     gameplay::print("%s%s", str1, str2);
 }
 
-ScriptController::ScriptController() : _lua(NULL)
+ScriptController::ScriptController() : _lua(NULL), _generation(0), _stateGeneration(0), _allocationCount(0), _frameAllocationCount(0),
+    _collectorBudget(1.0f), _collectorTime(0.0f), _collectorCycleCount(0), _collectorThreshold(0),
+    _contextsRunning(false), _profiler(new ScriptProfiler())
 {
+    for (unsigned int i = 0; i < SCRIPT_POOL_COUNT; ++i)
+    {
+        _pools[i] = new ObjectPool((i + 1) * 16);
+    }
 }
 
 ScriptController::~ScriptController()
 {
+    for (unsigned int i = 0; i < SCRIPT_POOL_COUNT; ++i)
+    {
+        SAFE_DELETE(_pools[i]);
+    }
+    SAFE_DELETE(_profiler);
 }
 
 static const char* lua_print_function = 
@@ -670,29 +704,131 @@ static const char* lua_print_function =
     "    ScriptController.print(table.concat({...},\"\\t\"), \"\\n\")\n"
     "end\n";
 
-static const char* lua_loadfile_function = 
-    "do\n"
-    "    local oldLoadfile = loadfile\n"
-    "    loadfile = function(filename)\n"
-    "        if filename ~= nil and not FileSystem.isAbsolutePath(filename) then\n"
-    "            FileSystem.createFileFromAsset(filename)\n"
-    "            filename = FileSystem.getResourcePath() .. filename\n"
-    "        end\n"
-    "        return oldLoadfile(filename)\n"
-    "    end\n"
-    "end\n";
+/**
+ * Loads a chunk from a file relative to the resource path through FileSystem, which reads the
+ * assets of the APK on Android and the entries of mounted archives in place.
+ *
+ * @return The number of values pushed: the chunk, or nil and an error message.
+ * @script{ignore}
+ */
+static int loadResourceChunk(lua_State* state, const char* path)
+{
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED));
+    if (stream.get() == NULL)
+    {
+        lua_pushnil(state);
+        lua_pushfstring(state, "cannot open %s", path);
+        return 2;
+    }
 
-static const char* lua_dofile_function = 
-    "do\n"
-    "    local oldDofile = dofile\n"
-    "    dofile = function(filename)\n"
-    "        if filename ~= nil and not FileSystem.isAbsolutePath(filename) then\n"
-    "            FileSystem.createFileFromAsset(filename)\n"
-    "            filename = FileSystem.getResourcePath() .. filename\n"
-    "        end\n"
-    "        return oldDofile(filename)\n"
-    "    end\n"
-    "end\n";
+    size_t length = stream->length();
+    const char* data = (const char*)stream->getData();
+    std::vector<char> buffer;
+    if (data == NULL && length > 0)
+    {
+        buffer.resize(length);
+        if (stream->read(&buffer[0], 1, length) != length)
+        {
+            lua_pushnil(state);
+            lua_pushfstring(state, "cannot read %s", path);
+            return 2;
+        }
+        data = &buffer[0];
+    }
+
+    std::string chunkName = "@";
+    chunkName += path;
+    if (luaL_loadbuffer(state, data ? data : "", length, chunkName.c_str()) != LUA_OK)
+    {
+        lua_pushnil(state);
+        lua_insert(state, -2);
+        return 2;
+    }
+    return 1;
+}
+
+/**
+ * Calls the original function of a replaced loadfile() or dofile(), for standard input and
+ * absolute paths.
+ *
+ * @script{ignore}
+ */
+static int callOriginal(lua_State* state)
+{
+    lua_pushvalue(state, lua_upvalueindex(1));
+    lua_insert(state, 1);
+    lua_call(state, lua_gettop(state) - 1, LUA_MULTRET);
+    return lua_gettop(state);
+}
+
+/**
+ * Replaces loadfile() to load relative paths through FileSystem.
+ *
+ * @script{ignore}
+ */
+static int lua_loadfile(lua_State* state)
+{
+    const char* filename = luaL_optstring(state, 1, NULL);
+    if (filename == NULL || FileSystem::isAbsolutePath(filename))
+        return callOriginal(state);
+    return loadResourceChunk(state, filename);
+}
+
+/**
+ * Replaces dofile() to load relative paths through FileSystem.
+ *
+ * @script{ignore}
+ */
+static int lua_dofile(lua_State* state)
+{
+    const char* filename = luaL_optstring(state, 1, NULL);
+    if (filename == NULL || FileSystem::isAbsolutePath(filename))
+        return callOriginal(state);
+
+    lua_settop(state, 1);
+    if (loadResourceChunk(state, filename) != 1)
+        return lua_error(state);
+    lua_call(state, 0, LUA_MULTRET);
+    return lua_gettop(state) - 1;
+}
+
+/**
+ * Finds the modules of require() in the resources through FileSystem, before the files on the
+ * paths of package.path, which only exist on disk.
+ *
+ * @script{ignore}
+ */
+static int lua_searchResources(lua_State* state)
+{
+    const char* name = luaL_checkstring(state, 1);
+    static const char* extensions[] = { ".lua", ".luac" };
+
+    // The strings are released before an error is raised, which does not unwind the stack.
+    bool failed = false;
+    {
+        std::string path(name);
+        std::replace(path.begin(), path.end(), '.', '/');
+        for (unsigned int i = 0; i < sizeof(extensions) / sizeof(extensions[0]) && !failed; ++i)
+        {
+            std::string file = path + extensions[i];
+            if (!FileSystem::fileExists(file.c_str()))
+                continue;
+
+            if (loadResourceChunk(state, file.c_str()) == 1)
+            {
+                lua_pushstring(state, file.c_str());
+                return 2;
+            }
+            lua_pushfstring(state, "error loading module '%s' from resource '%s':\n\t%s", name, file.c_str(), lua_tostring(state, -1));
+            failed = true;
+        }
+        if (!failed)
+            lua_pushfstring(state, "\n\tno resource '%s.lua'", path.c_str());
+    }
+    if (failed)
+        return lua_error(state);
+    return 1;
+}
 
 /**
  * @script{ignore}
@@ -710,6 +846,9 @@ void appendLuaPath(lua_State* state, const char* path)
     cur_path += ';';
     cur_path += path;
     cur_path += "?.lua";
+    cur_path += ';';
+    cur_path += path;
+    cur_path += "?.luac";
 
     // Push the new path
     lua_pushstring(state, cur_path.c_str());
@@ -719,9 +858,15 @@ void appendLuaPath(lua_State* state, const char* path)
 
 void ScriptController::initialize()
 {
+#ifdef GP_USE_LUAJIT
+    // LuaJIT manages its own memory, and does not support other allocators on 64-bit platforms.
     _lua = luaL_newstate();
+#else
+    _lua = lua_newstate(&ScriptController::allocate, this);
+#endif
     if (!_lua)
         GP_ERROR("Failed to initialize Lua scripting engine.");
+    _stateGeneration = ++_generation;
     luaL_openlibs(_lua);
 
 #ifndef GP_NO_LUA_BINDINGS
@@ -735,11 +880,37 @@ void ScriptController::initialize()
     if (luaL_dostring(_lua, lua_print_function))
         GP_ERROR("Failed to load custom print() function with error: '%s'.", lua_tostring(_lua, -1));
 
-    // Change the functions that read a file to use FileSystem.getResourcePath as their base path.
-    if (luaL_dostring(_lua, lua_loadfile_function))
-        GP_ERROR("Failed to load custom loadfile() function with error: '%s'.", lua_tostring(_lua, -1));
-    if (luaL_dostring(_lua, lua_dofile_function))
-        GP_ERROR("Failed to load custom dofile() function with error: '%s'.", lua_tostring(_lua, -1));
+    // Change the functions that read a file to read relative paths through FileSystem, so that
+    // scripts are read from the APK on Android instead of being extracted to storage first.
+    lua_getglobal(_lua, "loadfile");
+    lua_pushcclosure(_lua, &lua_loadfile, 1);
+    lua_setglobal(_lua, "loadfile");
+    lua_getglobal(_lua, "dofile");
+    lua_pushcclosure(_lua, &lua_dofile, 1);
+    lua_setglobal(_lua, "dofile");
+
+    // Search the resources for modules right after the preloaded ones (package.loaders in Lua 5.1).
+    lua_getglobal(_lua, "package");
+    lua_getfield(_lua, -1, "searchers");
+    if (lua_isnil(_lua, -1))
+    {
+        lua_pop(_lua, 1);
+        lua_getfield(_lua, -1, "loaders");
+    }
+    if (lua_istable(_lua, -1))
+    {
+        lua_len(_lua, -1);
+        int count = (int)lua_tointeger(_lua, -1);
+        lua_pop(_lua, 1);
+        for (int i = count; i >= 2; --i)
+        {
+            lua_rawgeti(_lua, -1, i);
+            lua_rawseti(_lua, -2, i + 1);
+        }
+        lua_pushcfunction(_lua, &lua_searchResources);
+        lua_rawseti(_lua, -2, 2);
+    }
+    lua_pop(_lua, 2);
 
     // Write game command-line arguments to a global lua "arg" table
     std::ostringstream args;
@@ -757,6 +928,11 @@ void ScriptController::initialize()
         if (luaL_dostring(_lua, argsStr.c_str()))
             GP_ERROR("Failed to pass command-line arguments with error: '%s'.", lua_tostring(_lua, -1));
     }
+
+    // Start collecting at the end of frames, from the memory used by the bindings.
+    _collectorThreshold = getMemoryUsage() * 2;
+    if (_collectorBudget > 0)
+        lua_gc(_lua, LUA_GCSTOP, 0);
 }
 
 void ScriptController::finalize()
@@ -776,13 +952,196 @@ void ScriptController::finalize()
         // closing the state (lua_close) will those variables be released.
         lua_gc(_lua, LUA_GCCOLLECT, 0);
 
+        _profiler->detach(_lua);
         lua_close(_lua);
         _lua = NULL;
     }
+
+    // References to functions die with the state.
+    ++_generation;
+}
+
+void ScriptController::setCollectorBudget(float milliseconds)
+{
+    milliseconds = std::max(milliseconds, 0.0f);
+    if (_lua && (milliseconds > 0) != (_collectorBudget > 0))
+        lua_gc(_lua, milliseconds > 0 ? LUA_GCSTOP : LUA_GCRESTART, 0);
+    _collectorBudget = milliseconds;
+}
+
+float ScriptController::getCollectorBudget() const
+{
+    return _collectorBudget;
+}
+
+float ScriptController::getCollectorTime() const
+{
+    return _collectorTime;
+}
+
+unsigned int ScriptController::getCollectorCycleCount() const
+{
+    return _collectorCycleCount;
+}
+
+unsigned int ScriptController::getMemoryUsage() const
+{
+    if (!_lua)
+        return 0;
+    return (unsigned int)lua_gc(_lua, LUA_GCCOUNT, 0) * 1024 + (unsigned int)lua_gc(_lua, LUA_GCCOUNTB, 0);
+}
+
+unsigned int ScriptController::getAllocationCount() const
+{
+    return _frameAllocationCount;
+}
+
+ScriptProfiler* ScriptController::getProfiler() const
+{
+    return _profiler;
+}
+
+void ScriptController::updateCollector()
+{
+    // The contexts have finished, so the results of their states can be collected.
+    _profiler->update();
+
+    _frameAllocationCount = _allocationCount;
+    _allocationCount = 0;
+    _collectorTime = 0.0f;
+    if (!_lua || _collectorBudget <= 0)
+        return;
+
+    GP_PROFILE("ScriptController::updateCollector");
+
+    // Step until the budget is spent, or a cycle completes, unless the memory
+    // has grown so much that the cycle must be completed now.
+    double start = Game::getAbsoluteTime();
+    bool complete = getMemoryUsage() > _collectorThreshold;
+    do
+    {
+        if (lua_gc(_lua, LUA_GCSTEP, 0))
+        {
+            ++_collectorCycleCount;
+            _collectorThreshold = getMemoryUsage() * 2;
+            break;
+        }
+    }
+    while (complete || Game::getAbsoluteTime() - start < _collectorBudget);
+    _collectorTime = (float)(Game::getAbsoluteTime() - start);
+}
+
+void ScriptController::startContexts(float elapsedTime)
+{
+    if (_contexts.empty())
+        return;
+
+    JobController* jobController = Game::getInstance()->getJobController();
+    for (size_t i = 0, count = _contexts.size(); i < count; ++i)
+    {
+        ScriptContext::UpdateJob& job = _contexts[i]->_job;
+        job.elapsedTime = elapsedTime;
+        jobController->submit(&job, &_contextGroup);
+    }
+    _contextsRunning = true;
+}
+
+void ScriptController::finishContexts()
+{
+    if (!_contextsRunning)
+        return;
+
+    GP_PROFILE("ScriptController::finishContexts");
+
+    Game::getInstance()->getJobController()->wait(&_contextGroup);
+    _contextsRunning = false;
+
+    // Scripts receiving the messages may release contexts, including the one being dispatched.
+    std::vector<ScriptContext*> contexts(_contexts);
+    for (size_t i = 0, count = contexts.size(); i < count; ++i)
+        contexts[i]->addRef();
+    for (size_t i = 0, count = contexts.size(); i < count; ++i)
+    {
+        contexts[i]->dispatchMessages();
+        contexts[i]->release();
+    }
+}
+
+void ScriptController::addContext(ScriptContext* context)
+{
+    GP_ASSERT(context);
+    GP_ASSERT(!_contextsRunning);
+
+    _contexts.push_back(context);
+}
+
+void ScriptController::removeContext(ScriptContext* context)
+{
+    std::vector<ScriptContext*>::iterator itr = std::find(_contexts.begin(), _contexts.end(), context);
+    if (itr == _contexts.end())
+        return;
+
+    if (_contextsRunning)
+        Game::getInstance()->getJobController()->wait(&_contextGroup);
+    _contexts.erase(itr);
+}
+
+void* ScriptController::allocate(void* userData, void* ptr, size_t oldSize, size_t newSize)
+{
+    ScriptController* sc = (ScriptController*)userData;
+
+    // Lua passes the type of the new object instead of a size when allocating.
+    if (ptr == NULL)
+        oldSize = 0;
+
+    // Blocks of up to 16 * SCRIPT_POOL_COUNT bytes come from the pool for their size.
+    unsigned int oldPool = oldSize > 0 && oldSize <= 16 * SCRIPT_POOL_COUNT ? (unsigned int)(oldSize - 1) / 16 : SCRIPT_POOL_COUNT;
+    unsigned int newPool = newSize > 0 && newSize <= 16 * SCRIPT_POOL_COUNT ? (unsigned int)(newSize - 1) / 16 : SCRIPT_POOL_COUNT;
+
+    if (newSize == 0)
+    {
+        if (ptr)
+        {
+            if (oldPool < SCRIPT_POOL_COUNT)
+                sc->_pools[oldPool]->deallocate(ptr);
+            else
+                free(ptr);
+            MemoryTracker::remove(MemoryTracker::SCRIPT, oldSize);
+        }
+        return NULL;
+    }
+
+    if (ptr && oldPool == newPool)
+    {
+        // A pooled block already fits the new size.
+        void* block = newPool < SCRIPT_POOL_COUNT ? ptr : realloc(ptr, newSize);
+        if (block)
+            MemoryTracker::resize(MemoryTracker::SCRIPT, oldSize, newSize);
+        return block;
+    }
+
+    ++sc->_allocationCount;
+    void* block = newPool < SCRIPT_POOL_COUNT ? sc->_pools[newPool]->allocate() : malloc(newSize);
+    if (block && ptr)
+    {
+        memcpy(block, ptr, std::min(oldSize, newSize));
+        if (oldPool < SCRIPT_POOL_COUNT)
+            sc->_pools[oldPool]->deallocate(ptr);
+        else
+            free(ptr);
+        MemoryTracker::resize(MemoryTracker::SCRIPT, oldSize, newSize);
+    }
+    else if (block)
+    {
+        MemoryTracker::add(MemoryTracker::SCRIPT, newSize);
+    }
+    return block;
 }
 
 bool ScriptController::executeFunctionHelper(int resultCount, const char* func, const char* args, va_list* list, Script* script)
 {
+    GP_PROFILE("ScriptController::executeFunction");
+
     if (!_lua)
         return false; // handles calling this method after script is finalized
 
@@ -914,7 +1273,9 @@ bool ScriptController::executeFunctionHelper(int resultCount, const char* func,
     // Perform the function call.
     // This will push 'resultCount' values onto the stack if it succeeds.
     // Otherwise (if it fails) it will push an error string onto the stack.
+    _profiler->enter(_lua);
     bool success = lua_pcall(_lua, argumentCount, resultCount, 0) == 0;
+    _profiler->leave(_lua);
     if (!success)
     {
         GP_WARN("Failed to call function '%s' with error '%s'.", func, lua_tostring(_lua, -1));
@@ -926,6 +1287,140 @@ bool ScriptController::executeFunctionHelper(int resultCount, const char* func,
     return success;
 }
 
+bool ScriptController::updateFunctionRef(const char* func, Script* script, int* ref, unsigned int* generation)
+{
+    GP_ASSERT(func);
+    GP_ASSERT(ref);
+    GP_ASSERT(generation);
+
+    if (*generation == _generation)
+        return *ref != LUA_NOREF;
+
+    releaseFunctionRef(ref, generation);
+    if (!_lua)
+        return false;
+
+    int top = lua_gettop(_lua);
+    if (getNestedVariable(_lua, func, script ? script->_env : 0) && lua_isfunction(_lua, -1))
+    {
+        // Pops the function.
+        *ref = luaL_ref(_lua, LUA_REGISTRYINDEX);
+    }
+    else
+    {
+        GP_WARN("Failed to find function '%s'.", func);
+    }
+    lua_settop(_lua, top);
+    *generation = _generation;
+
+    return *ref != LUA_NOREF;
+}
+
+void ScriptController::releaseFunctionRef(int* ref, unsigned int* generation)
+{
+    GP_ASSERT(ref);
+    GP_ASSERT(generation);
+
+    // References taken before the state was created died with the previous state.
+    if (*ref != LUA_NOREF && _lua && *generation >= _stateGeneration)
+        luaL_unref(_lua, LUA_REGISTRYINDEX, *ref);
+    *ref = LUA_NOREF;
+    *generation = 0;
+}
+
+bool ScriptController::executeFunctionRef(int ref, const char* func, Script* script, const ScriptTarget::Event* event,
+                                          const ScriptTarget::Argument* arguments, unsigned int count, bool* result)
+{
+    GP_PROFILE("ScriptController::executeFunction");
+    GP_ASSERT(event);
+    GP_ASSERT(count == event->parameters.size());
+
+    if (!_lua || ref == LUA_NOREF)
+        return false;
+
+    // Callbacks of global functions run in the environment of the running script, like executeFunction.
+    if (!script && !_envStack.empty())
+        script = _envStack.back();
+
+    int top = lua_gettop(_lua);
+    luaL_checkstack(_lua, count + 1, "Too many arguments.");
+    lua_rawgeti(_lua, LUA_REGISTRYINDEX, ref);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        pushArgument(event->parameters[i], arguments[i]);
+    }
+
+    pushScript(script);
+
+    _profiler->enter(_lua);
+    bool success = lua_pcall(_lua, count, result ? 1 : 0, 0) == 0;
+    _profiler->leave(_lua);
+    if (!success)
+    {
+        GP_WARN("Failed to call function '%s' with error '%s'.", func, lua_tostring(_lua, -1));
+    }
+    else if (result)
+    {
+        *result = ScriptUtil::luaCheckBool(_lua, -1);
+    }
+
+    popScript();
+
+    lua_settop(_lua, top);
+    return success;
+}
+
+void ScriptController::pushArgument(const ScriptTarget::Event::Parameter& parameter, const ScriptTarget::Argument& argument)
+{
+    bool number = argument.type == ScriptTarget::Argument::NUMBER;
+    switch (parameter.type)
+    {
+    case 'i':
+        GP_ASSERT(argument.type != ScriptTarget::Argument::POINTER);
+        lua_pushinteger(_lua, number ? (lua_Integer)argument.number : (lua_Integer)argument.integer);
+        break;
+    case 'u':
+        GP_ASSERT(argument.type != ScriptTarget::Argument::POINTER);
+        lua_pushunsigned(_lua, number ? (lua_Unsigned)argument.number : (lua_Unsigned)argument.integer);
+        break;
+    case 'b':
+        GP_ASSERT(argument.type != ScriptTarget::Argument::POINTER);
+        lua_pushboolean(_lua, number ? argument.number != 0 : argument.integer != 0);
+        break;
+    case 'f':
+        GP_ASSERT(argument.type != ScriptTarget::Argument::POINTER);
+        lua_pushnumber(_lua, number ? (lua_Number)argument.number : (lua_Number)argument.integer);
+        break;
+    default:
+    {
+        // Pointers passed as NULL arrive as integers.
+        const void* pointer = argument.type == ScriptTarget::Argument::POINTER ? argument.pointer : NULL;
+        GP_ASSERT(pointer || argument.type == ScriptTarget::Argument::POINTER || argument.integer == 0);
+        if (parameter.type == 'p')
+        {
+            lua_pushlightuserdata(_lua, const_cast<void*>(pointer));
+        }
+        else if (pointer == NULL)
+        {
+            lua_pushnil(_lua);
+        }
+        else if (parameter.type == 's')
+        {
+            lua_pushstring(_lua, (const char*)pointer);
+        }
+        else
+        {
+            ScriptUtil::LuaObject* object = (ScriptUtil::LuaObject*)lua_newuserdata(_lua, sizeof(ScriptUtil::LuaObject));
+            object->instance = const_cast<void*>(pointer);
+            object->owns = false;
+            luaL_getmetatable(_lua, parameter.typeName.c_str());
+            lua_setmetatable(_lua, -2);
+        }
+        break;
+    }
+    }
+}
+
 void ScriptController::schedule(float timeOffset, const char* function)
 {
     // Get the currently execute script
@@ -1492,6 +1987,7 @@ void ScriptUtil::registerLibrary(const char* name, const luaL_Reg* functions)
     {
         lua_pushcfunction(sc->_lua, iter->func);
         lua_setfield(sc->_lua, -2, iter->name);
+        sc->_profiler->registerBinding(iter->func, name, iter->name);
     }
 
     lua_setglobal(sc->_lua, name);
@@ -1634,6 +2130,14 @@ void ScriptUtil::registerClass(const char* name, const luaL_Reg* members, lua_CF
 {
     ScriptController* sc = Game::getInstance()->getScriptController();
 
+    // Name the functions of the class for the call counts of the profiler.
+    for (const luaL_Reg* iter = members; iter && iter->name; iter++)
+        sc->_profiler->registerBinding(iter->func, name, iter->name);
+    for (const luaL_Reg* iter = statics; iter && iter->name; iter++)
+        sc->_profiler->registerBinding(iter->func, name, iter->name);
+    sc->_profiler->registerBinding(newFunction, name, "new");
+    sc->_profiler->registerBinding(deleteFunction, name, "__gc");
+
     // If the type is an inner type, get the correct parent 
     // table on the stack before creating the table for the class.
     if (!scopePath.empty())
@@ -1719,6 +2223,7 @@ void ScriptUtil::registerClass(const char* name, const luaL_Reg* members, lua_CF
 
 void ScriptUtil::registerFunction(const char* luaFunction, lua_CFunction cppFunction)
 {
+    Game::getInstance()->getScriptController()->_profiler->registerBinding(cppFunction, NULL, luaFunction);
     lua_pushcfunction(Game::getInstance()->getScriptController()->_lua, cppFunction);
     lua_setglobal(Game::getInstance()->getScriptController()->_lua, luaFunction);
 }
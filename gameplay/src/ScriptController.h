@@ -2,7 +2,14 @@
 #define SCRIPTCONTROLLER_H_
 
 #include "Script.h"
+#include "ScriptTarget.h"
 #include "Game.h"
+#include "ObjectPool.h"
+#include "ScriptContext.h"
+#include "ScriptProfiler.h"
+
+// The number of block sizes allocated from pools for the Lua state, in steps of 16 bytes.
+#define SCRIPT_POOL_COUNT 8
 
 namespace gameplay
 {
@@ -17,6 +24,9 @@ class ScriptController
     friend class Script;
     friend class ScriptUtil;
     friend class ScriptTimeListener;
+    friend class ScriptTarget;
+    friend class ScriptContext;
+    friend class ScriptProfiler;
 
 public:
 
@@ -28,6 +38,10 @@ public:
      * If the script scope is GLOBAL and the forceReload parameter is false, a
      * previously-loaded script object may be returned. PROTECTED scope always results
      * in a new script being loaded and executed.
+     *
+     * The script may be Lua bytecode precompiled by gameplay-encoder, which is loaded
+     * without being parsed. If a ".lua" script does not exist, its compiled ".luac"
+     * file is loaded in its place.
      * 
      * @param path The path to the script.
      * @param scope The scope for the script to be executed in.
@@ -525,6 +539,68 @@ public:
      */
     Script* getCurrentScript() const;
 
+    /**
+     * Sets the time that the garbage collector may take at the end of each frame.
+     *
+     * With a budget, the collector does not run while scripts allocate, which can
+     * happen in the middle of a frame, but in steps once per frame after it is rendered,
+     * until the budget is spent or a collection cycle completes. When scripts release
+     * memory faster than the budget lets the collector reclaim it, and their memory grows
+     * to twice what it was after the last cycle, the cycle is completed regardless of the
+     * budget. The default budget is one millisecond, and it can also be set with the
+     * 'scriptCollectorBudget' property of the game config file.
+     *
+     * @param milliseconds The collector time per frame, or 0 to let the collector
+     *      run whenever scripts allocate enough memory.
+     */
+    void setCollectorBudget(float milliseconds);
+
+    /**
+     * Returns the time that the garbage collector may take at the end of each frame.
+     *
+     * @return The collector time per frame, in milliseconds, or 0 if the collector
+     *      runs whenever scripts allocate enough memory.
+     */
+    float getCollectorBudget() const;
+
+    /**
+     * Returns the time the garbage collector took at the end of the last frame.
+     *
+     * @return The collector time, in milliseconds.
+     */
+    float getCollectorTime() const;
+
+    /**
+     * Returns the number of garbage collection cycles completed at the end of frames.
+     *
+     * @return The number of completed collection cycles.
+     */
+    unsigned int getCollectorCycleCount() const;
+
+    /**
+     * Returns the memory that is currently allocated by scripts.
+     *
+     * @return The allocated memory, in bytes.
+     */
+    unsigned int getMemoryUsage() const;
+
+    /**
+     * Returns the number of memory blocks that scripts allocated during the last frame.
+     *
+     * Allocations are not counted when scripts run on LuaJIT, which manages its own memory.
+     *
+     * @return The number of allocations.
+     */
+    unsigned int getAllocationCount() const;
+
+    /**
+     * Returns the sampling profiler of the scripts.
+     *
+     * @return The script profiler.
+     * @script{ignore}
+     */
+    ScriptProfiler* getProfiler() const;
+
     /**
      * Prints the string to the platform's output stream or log file.
      * Used for overriding Lua's print function.
@@ -595,6 +671,52 @@ private:
      */
     void finalize();
 
+    /**
+     * Runs the garbage collector within its budget, once per frame.
+     */
+    void updateCollector();
+
+    /**
+     * Starts the update of every script context on the workers, once per frame.
+     *
+     * @param elapsedTime The elapsed game time.
+     */
+    void startContexts(float elapsedTime);
+
+    /**
+     * Waits for the script contexts to complete their update and delivers the
+     * messages they posted, once per frame.
+     */
+    void finishContexts();
+
+    /**
+     * Adds a script context to those updated every frame.
+     *
+     * @param context The script context.
+     */
+    void addContext(ScriptContext* context);
+
+    /**
+     * Removes a script context from those updated every frame, waiting for its
+     * update to complete if it is running.
+     *
+     * @param context The script context.
+     */
+    void removeContext(ScriptContext* context);
+
+    /**
+     * Allocates, reallocates and frees the memory of the Lua state, with small blocks
+     * taken from pools of fixed-size blocks.
+     *
+     * @param userData The script controller.
+     * @param ptr The block to reallocate or free, or NULL to allocate a new block.
+     * @param oldSize The size of the block, or the type of the object being allocated if ptr is NULL.
+     * @param newSize The new size of the block, or 0 to free it.
+     *
+     * @return The allocated block, or NULL if the block was freed.
+     */
+    static void* allocate(void* userData, void* ptr, size_t oldSize, size_t newSize);
+
     /**
      * Internal loadScript variant that supports loading into an existing Script object
      * for reloading purposes.
@@ -655,6 +777,52 @@ private:
      */
     bool executeFunctionHelper(int resultCount, const char* func, const char* args, va_list* list, Script* script = NULL);
 
+    /**
+     * Looks up a function by name, unless the given reference to it was taken since scripts
+     * were last loaded or unloaded, which is when the function a name refers to may change.
+     *
+     * Calling a function through its reference skips walking the tables of its name.
+     *
+     * @param func The name of the function.
+     * @param script The script to look up the function in, or NULL for the global environment.
+     * @param ref The reference to the function, which is replaced by a reference to the function
+     *      that was looked up.
+     * @param generation The generation of scripts that the reference was taken in, which is updated.
+     *
+     * @return True if the reference refers to a function, false if there is no such function.
+     */
+    bool updateFunctionRef(const char* func, Script* script, int* ref, unsigned int* generation);
+
+    /**
+     * Releases a reference to a function taken by updateFunctionRef.
+     *
+     * @param ref The reference to the function, which is cleared.
+     * @param generation The generation of scripts that the reference was taken in.
+     */
+    void releaseFunctionRef(int* ref, unsigned int* generation);
+
+    /**
+     * Calls a function through a reference taken by updateFunctionRef, passing the arguments
+     * of a script event.
+     *
+     * @param ref The reference to the function.
+     * @param func The name of the function, for error messages.
+     * @param script Optional script to execute the function in, or NULL for to execute it in the global environment.
+     * @param event The script event, whose parameters the arguments are converted to.
+     * @param arguments The arguments of the event.
+     * @param count The number of arguments.
+     * @param result Set to the boolean returned by the function, or NULL if the function returns nothing.
+     *
+     * @return True if the function is executed, false if an error occurred.
+     */
+    bool executeFunctionRef(int ref, const char* func, Script* script, const ScriptTarget::Event* event,
+                            const ScriptTarget::Argument* arguments, unsigned int count, bool* result);
+
+    /**
+     * Pushes the argument of a script event onto the stack, as the type of its parameter.
+     */
+    void pushArgument(const ScriptTarget::Event::Parameter& parameter, const ScriptTarget::Argument& argument);
+
     /**
      * Converts a Gameplay userdata value to the type with the given class name.
      * This function will change the metatable of the userdata value to the metatable that matches the given string.
@@ -700,6 +868,19 @@ private:
     std::map<std::string, std::vector<Script*> > _scripts;
     std::vector<Script*> _envStack;
     std::list<ScriptTimeListener*> _timeListeners;
+    unsigned int _generation;
+    unsigned int _stateGeneration;
+    ObjectPool* _pools[SCRIPT_POOL_COUNT];
+    unsigned int _allocationCount;
+    unsigned int _frameAllocationCount;
+    float _collectorBudget;
+    float _collectorTime;
+    unsigned int _collectorCycleCount;
+    unsigned int _collectorThreshold;
+    std::vector<ScriptContext*> _contexts;
+    JobController::Group _contextGroup;
+    bool _contextsRunning;
+    ScriptProfiler* _profiler;
 };
 
 /** Template specialization. */
@@ -1146,6 +1327,33 @@ public:
      */
     static void* getUserDataObjectPointer(int index, const char* type);
 
+    /**
+     * Pushes a copy of a value object onto the stack.
+     *
+     * The copy is stored in the userdata itself, so that returning small value types
+     * such as vectors and matrices to scripts does not allocate them on the heap. The
+     * type must be copyable with memcpy and must not need to be destroyed.
+     *
+     * @param value The value to push.
+     * @param type The type of the value.
+     */
+    template <typename T>
+    static void pushValueObject(const T& value, const char* type);
+
+    /**
+     * Copies a value into the object at the given stack index and pushes that object
+     * onto the stack, for scripts that reuse an object to receive results in.
+     *
+     * @param index The stack index of the object.
+     * @param value The value to copy.
+     * @param type The type of the value.
+     *
+     * @return True if the value was copied, or false if the object at the stack index
+     *      is not of the given type, in which case nothing is pushed.
+     */
+    template <typename T>
+    static bool setValueObject(int index, const T& value, const char* type);
+
     /**
      * Gets a string for the given stack index.
      * 
@@ -161,6 +161,35 @@ ScriptUtil::LuaArray<T> ScriptUtil::getObjectPointer(int index, const char* type
     return LuaArray<T>((T*)p);
 }
 
+template <typename T>
+void ScriptUtil::pushValueObject(const T& value, const char* type)
+{
+    ScriptController* sc = Game::getInstance()->getScriptController();
+
+    // The value follows the object in the same block, which Lua frees along with the
+    // userdata, so the object does not own it.
+    LuaObject* object = (LuaObject*)lua_newuserdata(sc->_lua, sizeof(LuaObject) + sizeof(T));
+    memcpy(object + 1, &value, sizeof(T));
+    object->instance = object + 1;
+    object->owns = false;
+    luaL_getmetatable(sc->_lua, type);
+    lua_setmetatable(sc->_lua, -2);
+}
+
+template <typename T>
+bool ScriptUtil::setValueObject(int index, const T& value, const char* type)
+{
+    ScriptController* sc = Game::getInstance()->getScriptController();
+
+    T* object = (T*)getUserDataObjectPointer(index, type);
+    if (object == NULL)
+        return false;
+
+    *object = value;
+    lua_pushvalue(sc->_lua, index);
+    return true;
+}
+
 template<typename T> bool ScriptController::executeFunction(const char* func, T* out)
 {
     return executeFunction<T>((Script*)NULL, func, out);
@@ -0,0 +1,583 @@
+#include "Base.h"
+#include "ScriptProfiler.h"
+#include "ScriptController.h"
+#include "ScriptContext.h"
+#include "Font.h"
+#include "FileSystem.h"
+
+namespace gameplay
+{
+
+struct ScriptFunctionSample
+{
+    ScriptFunctionSample() : line(0), samples(0), inclusive(0), exclusive(0), mark(0) { }
+
+    std::string name;
+    std::string source;
+    int line;
+    unsigned int samples;
+    long long inclusive;
+    long long exclusive;
+    unsigned int mark;
+};
+
+struct ScriptSourceSample
+{
+    ScriptSourceSample() : inclusive(0), exclusive(0), mark(0) { }
+
+    long long inclusive;
+    long long exclusive;
+    unsigned int mark;
+};
+
+struct ScriptBindingSample
+{
+    ScriptBindingSample() : calls(0) { }
+
+    std::string name;
+    unsigned int calls;
+};
+
+struct ScriptProfileData
+{
+    ScriptProfileData() : profiler(NULL), state(NULL), interval(0), start(0), carried(0), depth(0), sampleIndex(0), total(0) { }
+
+    ScriptProfiler* profiler;
+    lua_State* state;
+    long long interval;
+    long long start;
+    long long carried;
+    unsigned int depth;
+    unsigned int sampleIndex;
+    long long total;
+    std::map<std::string, ScriptFunctionSample> functions;
+    std::map<std::string, ScriptSourceSample> scripts;
+    std::map<lua_CFunction, ScriptBindingSample> bindings;
+    std::string key;
+};
+
+// The address of this variable is the registry key of the profile data of a state.
+static char __registryKey = 0;
+
+static long long getTime()
+{
+    static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+static ScriptProfileData* getData(lua_State* state)
+{
+    lua_pushlightuserdata(state, &__registryKey);
+    lua_rawget(state, LUA_REGISTRYINDEX);
+    ScriptProfileData* data = (ScriptProfileData*)lua_touserdata(state, -1);
+    lua_pop(state, 1);
+    return data;
+}
+
+/**
+ * Adds a sample of the call stack of a state, of the given time.
+ */
+static void addSample(ScriptProfileData* data, lua_State* state, long long time)
+{
+    // Marks count the functions and the scripts that are on the stack more than once only once.
+    unsigned int mark = ++data->sampleIndex;
+    bool top = true;
+    data->total += time;
+
+    lua_Debug ar;
+    char line[16];
+    for (int level = 0; lua_getstack(state, level, &ar); ++level)
+    {
+        if (!lua_getinfo(state, "Sn", &ar) || ar.what[0] == 'C')
+            continue;
+
+        sprintf(line, ":%d", ar.linedefined);
+        data->key = ar.short_src;
+        data->key += line;
+        ScriptFunctionSample& function = data->functions[data->key];
+        if (function.samples == 0)
+        {
+            function.source = ar.short_src;
+            function.line = ar.linedefined;
+            function.name = ar.name ? ar.name : (ar.what[0] == 'm' ? "main chunk" : "?");
+        }
+        if (function.mark != mark)
+        {
+            function.mark = mark;
+            function.inclusive += time;
+            ++function.samples;
+        }
+
+        ScriptSourceSample& script = data->scripts[ar.short_src];
+        if (script.mark != mark)
+        {
+            script.mark = mark;
+            script.inclusive += time;
+        }
+
+        if (top)
+        {
+            function.exclusive += time;
+            script.exclusive += time;
+            top = false;
+        }
+    }
+}
+
+/**
+ * Adds the results of a state to the totals and clears them.
+ */
+static void mergeData(ScriptProfileData* totals, ScriptProfileData* data)
+{
+    totals->total += data->total;
+    data->total = 0;
+
+    for (std::map<std::string, ScriptFunctionSample>::iterator itr = data->functions.begin(); itr != data->functions.end(); ++itr)
+    {
+        ScriptFunctionSample& function = totals->functions[itr->first];
+        if (function.samples == 0 || function.name == "?")
+        {
+            function.name = itr->second.name;
+            function.source = itr->second.source;
+            function.line = itr->second.line;
+        }
+        function.samples += itr->second.samples;
+        function.inclusive += itr->second.inclusive;
+        function.exclusive += itr->second.exclusive;
+    }
+    data->functions.clear();
+
+    for (std::map<std::string, ScriptSourceSample>::iterator itr = data->scripts.begin(); itr != data->scripts.end(); ++itr)
+    {
+        ScriptSourceSample& script = totals->scripts[itr->first];
+        script.inclusive += itr->second.inclusive;
+        script.exclusive += itr->second.exclusive;
+    }
+    data->scripts.clear();
+
+    for (std::map<lua_CFunction, ScriptBindingSample>::iterator itr = data->bindings.begin(); itr != data->bindings.end(); ++itr)
+    {
+        ScriptBindingSample& binding = totals->bindings[itr->first];
+        if (binding.calls == 0)
+            binding.name = itr->second.name;
+        binding.calls += itr->second.calls;
+    }
+    data->bindings.clear();
+}
+
+static bool compareFunctions(const ScriptProfiler::Function& a, const ScriptProfiler::Function& b)
+{
+    return a.exclusiveTime > b.exclusiveTime;
+}
+
+static bool compareScripts(const ScriptProfiler::Script& a, const ScriptProfiler::Script& b)
+{
+    return a.exclusiveTime > b.exclusiveTime;
+}
+
+static bool compareBindings(const ScriptProfiler::Binding& a, const ScriptProfiler::Binding& b)
+{
+    return a.calls > b.calls;
+}
+
+/**
+ * Appends a field to a comma separated document, quoting it as needed.
+ */
+static void appendCsvString(std::string* csv, const std::string& value)
+{
+    if (value.find_first_of(",\"\n") == std::string::npos)
+    {
+        *csv += value;
+        return;
+    }
+    csv->push_back('"');
+    for (size_t i = 0, length = value.size(); i < length; ++i)
+    {
+        if (value[i] == '"')
+            csv->push_back('"');
+        csv->push_back(value[i]);
+    }
+    csv->push_back('"');
+}
+
+ScriptProfiler::ScriptProfiler()
+    : _enabled(false), _callCountEnabled(false), _interval(250), _instructionCount(1000), _frameCount(0), _totals(new ScriptProfileData())
+{
+}
+
+ScriptProfiler::~ScriptProfiler()
+{
+    // The states are detached by their owners before they are closed.
+    GP_ASSERT(_samplers.empty());
+    for (size_t i = 0, count = _samplers.size(); i < count; ++i)
+    {
+        SAFE_DELETE(_samplers[i]);
+    }
+    SAFE_DELETE(_totals);
+}
+
+void ScriptProfiler::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+bool ScriptProfiler::isEnabled() const
+{
+    return _enabled;
+}
+
+void ScriptProfiler::setInterval(float milliseconds)
+{
+    _interval = std::max((long long)(milliseconds * 1000.0f), 1LL);
+}
+
+float ScriptProfiler::getInterval() const
+{
+    return (float)_interval / 1000.0f;
+}
+
+void ScriptProfiler::setInstructionCount(unsigned int count)
+{
+    _instructionCount = std::max(count, 1u);
+}
+
+unsigned int ScriptProfiler::getInstructionCount() const
+{
+    return _instructionCount;
+}
+
+void ScriptProfiler::setCallCountEnabled(bool enabled)
+{
+    _callCountEnabled = enabled;
+}
+
+bool ScriptProfiler::isCallCountEnabled() const
+{
+    return _callCountEnabled;
+}
+
+void ScriptProfiler::reset()
+{
+    _frameCount = 0;
+    _totals->total = 0;
+    _totals->functions.clear();
+    _totals->scripts.clear();
+    _totals->bindings.clear();
+}
+
+unsigned int ScriptProfiler::getFrameCount() const
+{
+    return _frameCount;
+}
+
+float ScriptProfiler::getTotalTime() const
+{
+    return (float)_totals->total / 1000.0f;
+}
+
+void ScriptProfiler::getFunctions(std::vector<Function>* functions) const
+{
+    GP_ASSERT(functions);
+
+    functions->clear();
+    for (std::map<std::string, ScriptFunctionSample>::const_iterator itr = _totals->functions.begin(); itr != _totals->functions.end(); ++itr)
+    {
+        Function function;
+        function.name = itr->second.name;
+        function.source = itr->second.source;
+        function.line = itr->second.line;
+        function.samples = itr->second.samples;
+        function.inclusiveTime = (float)itr->second.inclusive / 1000.0f;
+        function.exclusiveTime = (float)itr->second.exclusive / 1000.0f;
+        functions->push_back(function);
+    }
+    std::sort(functions->begin(), functions->end(), compareFunctions);
+}
+
+void ScriptProfiler::getScripts(std::vector<Script>* scripts) const
+{
+    GP_ASSERT(scripts);
+
+    scripts->clear();
+    for (std::map<std::string, ScriptSourceSample>::const_iterator itr = _totals->scripts.begin(); itr != _totals->scripts.end(); ++itr)
+    {
+        Script script;
+        script.source = itr->first;
+        script.inclusiveTime = (float)itr->second.inclusive / 1000.0f;
+        script.exclusiveTime = (float)itr->second.exclusive / 1000.0f;
+        scripts->push_back(script);
+    }
+    std::sort(scripts->begin(), scripts->end(), compareScripts);
+}
+
+void ScriptProfiler::getBindings(std::vector<Binding>* bindings) const
+{
+    GP_ASSERT(bindings);
+
+    bindings->clear();
+    for (std::map<lua_CFunction, ScriptBindingSample>::const_iterator itr = _totals->bindings.begin(); itr != _totals->bindings.end(); ++itr)
+    {
+        Binding binding;
+        binding.name = itr->second.name;
+        binding.calls = itr->second.calls;
+        bindings->push_back(binding);
+    }
+    std::sort(bindings->begin(), bindings->end(), compareBindings);
+}
+
+void ScriptProfiler::drawOverlay(Font* font, int x, int y, const Vector4& color, unsigned int count)
+{
+    GP_ASSERT(font);
+
+    std::vector<Function> functions;
+    getFunctions(&functions);
+    std::vector<Binding> bindings;
+    getBindings(&bindings);
+    float frames = (float)std::max(_frameCount, 1u);
+
+    unsigned int size = font->getSize();
+    char text[256];
+    font->start();
+    sprintf(text, "Scripts %.2f ms", getTotalTime() / frames);
+    font->drawText(text, x, y, color, size);
+    y += size;
+    for (size_t i = 0, functionCount = std::min(functions.size(), (size_t)count); i < functionCount; ++i)
+    {
+        const Function& function = functions[i];
+        snprintf(text, sizeof(text), "  %s (%s:%d) %.2f ms, %.2f ms inclusive", function.name.c_str(), function.source.c_str(), function.line,
+            function.exclusiveTime / frames, function.inclusiveTime / frames);
+        font->drawText(text, x, y, color, size);
+        y += size;
+    }
+    if (!bindings.empty())
+    {
+        font->drawText("C calls", x, y, color, size);
+        y += size;
+        for (size_t i = 0, bindingCount = std::min(bindings.size(), (size_t)count); i < bindingCount; ++i)
+        {
+            snprintf(text, sizeof(text), "  %s %.1f", bindings[i].name.c_str(), (float)bindings[i].calls / frames);
+            font->drawText(text, x, y, color, size);
+            y += size;
+        }
+    }
+    font->finish();
+}
+
+bool ScriptProfiler::exportResults(const char* path) const
+{
+    GP_ASSERT(path);
+
+    char buffer[128];
+    std::string csv = "function,source,line,samples,inclusiveTime,exclusiveTime\n";
+    std::vector<Function> functions;
+    getFunctions(&functions);
+    for (size_t i = 0, count = functions.size(); i < count; ++i)
+    {
+        const Function& function = functions[i];
+        appendCsvString(&csv, function.name);
+        csv += ',';
+        appendCsvString(&csv, function.source);
+        sprintf(buffer, ",%d,%u,%.3f,%.3f\n", function.line, function.samples, function.inclusiveTime, function.exclusiveTime);
+        csv += buffer;
+    }
+
+    csv += "\nscript,inclusiveTime,exclusiveTime\n";
+    std::vector<Script> scripts;
+    getScripts(&scripts);
+    for (size_t i = 0, count = scripts.size(); i < count; ++i)
+    {
+        appendCsvString(&csv, scripts[i].source);
+        sprintf(buffer, ",%.3f,%.3f\n", scripts[i].inclusiveTime, scripts[i].exclusiveTime);
+        csv += buffer;
+    }
+
+    csv += "\nbinding,calls\n";
+    std::vector<Binding> bindings;
+    getBindings(&bindings);
+    for (size_t i = 0, count = bindings.size(); i < count; ++i)
+    {
+        appendCsvString(&csv, bindings[i].name);
+        sprintf(buffer, ",%u\n", bindings[i].calls);
+        csv += buffer;
+    }
+
+    sprintf(buffer, "\nframes,%u\ntotalTime,%.3f\n", _frameCount, getTotalTime());
+    csv += buffer;
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::WRITE));
+    if (stream.get() == NULL || stream->write(csv.c_str(), 1, csv.size()) != csv.size())
+    {
+        GP_WARN("Failed to write script profile file '%s'.", path);
+        return false;
+    }
+    stream->close();
+    return true;
+}
+
+void ScriptProfiler::attach(lua_State* state)
+{
+    GP_ASSERT(state);
+
+    ScriptProfileData* data = new ScriptProfileData();
+    data->profiler = this;
+    data->state = state;
+    data->interval = _interval;
+    _samplers.push_back(data);
+
+    lua_pushlightuserdata(state, &__registryKey);
+    lua_pushlightuserdata(state, data);
+    lua_rawset(state, LUA_REGISTRYINDEX);
+    lua_sethook(state, &ScriptProfiler::hook, LUA_MASKCOUNT | (_callCountEnabled ? LUA_MASKCALL : 0), (int)_instructionCount);
+}
+
+void ScriptProfiler::detach(lua_State* state)
+{
+    for (size_t i = 0, count = _samplers.size(); i < count; ++i)
+    {
+        ScriptProfileData* data = _samplers[i];
+        if (data->state != state)
+            continue;
+
+        // Coroutines keep the hook that they inherited, which ignores the state from now on.
+        lua_sethook(state, NULL, 0, 0);
+        lua_pushlightuserdata(state, &__registryKey);
+        lua_pushnil(state);
+        lua_rawset(state, LUA_REGISTRYINDEX);
+
+        mergeData(_totals, data);
+        SAFE_DELETE(data);
+        _samplers.erase(_samplers.begin() + i);
+        return;
+    }
+}
+
+void ScriptProfiler::updateHooks()
+{
+    ScriptController* sc = Game::getInstance()->getScriptController();
+    GP_ASSERT(sc);
+
+    if (!_enabled || !sc->_lua)
+    {
+        while (!_samplers.empty())
+        {
+            detach(_samplers.back()->state);
+        }
+        return;
+    }
+
+    std::vector<lua_State*> states;
+    states.push_back(sc->_lua);
+    for (size_t i = 0, count = sc->_contexts.size(); i < count; ++i)
+    {
+        states.push_back(sc->_contexts[i]->_lua);
+    }
+
+    int mask = LUA_MASKCOUNT | (_callCountEnabled ? LUA_MASKCALL : 0);
+    for (size_t i = 0, count = states.size(); i < count; ++i)
+    {
+        ScriptProfileData* data = getData(states[i]);
+        if (!data)
+        {
+            attach(states[i]);
+        }
+        else if (data->interval != _interval || lua_gethookmask(states[i]) != mask || lua_gethookcount(states[i]) != (int)_instructionCount)
+        {
+            data->interval = _interval;
+            lua_sethook(states[i], &ScriptProfiler::hook, mask, (int)_instructionCount);
+        }
+    }
+}
+
+void ScriptProfiler::enter(lua_State* state)
+{
+    if (_samplers.empty())
+        return;
+
+    // Scripts that the engine calls from inside of other scripts are part of their samples.
+    ScriptProfileData* data = getData(state);
+    if (data && data->depth++ == 0)
+        data->start = getTime();
+}
+
+void ScriptProfiler::leave(lua_State* state)
+{
+    if (_samplers.empty())
+        return;
+
+    ScriptProfileData* data = getData(state);
+    if (data && data->depth > 0 && --data->depth == 0)
+        data->carried += getTime() - data->start;
+}
+
+void ScriptProfiler::update()
+{
+    updateHooks();
+    if (_samplers.empty())
+        return;
+
+    ++_frameCount;
+    for (size_t i = 0, count = _samplers.size(); i < count; ++i)
+    {
+        mergeData(_totals, _samplers[i]);
+    }
+}
+
+void ScriptProfiler::registerBinding(lua_CFunction function, const char* className, const char* name)
+{
+    if (function && _bindingNames.find(function) == _bindingNames.end())
+        _bindingNames[function] = std::make_pair(className, name);
+}
+
+void ScriptProfiler::hook(lua_State* state, lua_Debug* ar)
+{
+    ScriptProfileData* data = getData(state);
+    if (!data)
+        return;
+
+    if (ar->event == LUA_HOOKCOUNT)
+    {
+        // Lua runs outside of the calls from the engine, such as in finalizers, are not sampled.
+        if (data->depth == 0)
+            return;
+
+        // The time since the last sample, across the calls from the engine, is attributed to this one.
+        long long time = getTime();
+        long long elapsed = data->carried + time - data->start;
+        if (elapsed < data->interval)
+            return;
+        addSample(data, state, elapsed);
+        data->carried = 0;
+        data->start = time;
+        return;
+    }
+
+    // Only the calls to C functions are counted.
+    if (!lua_getinfo(state, "f", ar))
+        return;
+    lua_CFunction function = lua_tocfunction(state, -1);
+    lua_pop(state, 1);
+    if (!function)
+        return;
+
+    ScriptBindingSample& binding = data->bindings[function];
+    if (binding.calls++ == 0 && binding.name.empty())
+    {
+        const std::map<lua_CFunction, std::pair<const char*, const char*> >& names = data->profiler->_bindingNames;
+        std::map<lua_CFunction, std::pair<const char*, const char*> >::const_iterator itr = names.find(function);
+        if (itr != names.end())
+        {
+            if (itr->second.first)
+            {
+                binding.name = itr->second.first;
+                binding.name += '.';
+            }
+            binding.name += itr->second.second;
+        }
+        else
+        {
+            binding.name = lua_getinfo(state, "n", ar) && ar->name ? ar->name : "?";
+        }
+    }
+}
+
+}
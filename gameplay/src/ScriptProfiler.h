@@ -0,0 +1,321 @@
+#ifndef SCRIPTPROFILER_H_
+#define SCRIPTPROFILER_H_
+
+namespace gameplay
+{
+
+class Font;
+class Vector4;
+struct ScriptProfileData;
+
+/**
+ * Defines a sampling profiler that measures where scripts spend their time.
+ *
+ * While the profiler is enabled, a count hook is installed in the Lua state of the
+ * script controller and in the states of the script contexts. The hook is called by
+ * Lua every few hundred instructions and only reads the clock, unless the sample
+ * interval has elapsed since the last sample, in which case it walks the call stack
+ * and adds the time since the last sample to the exclusive time of the function that
+ * is running and to the inclusive time of every function that is on the stack, and
+ * likewise to the scripts that define them. Only the time spent in scripts called by
+ * the engine is sampled, so time spent in the engine between script calls is never
+ * attributed to scripts. Time spent in C functions, such as the generated bindings,
+ * is attributed to the script function that called them, since Lua does not run the
+ * hook while a C function runs. Coroutines are sampled if they are created while the
+ * profiler is enabled.
+ *
+ * The profiler can optionally count the calls to C functions, which are named by the
+ * classes and functions they were registered with when they are generated bindings.
+ * This adds a hook to every function call, so it costs more than sampling.
+ *
+ * The results accumulate from the frames since the profiler was enabled or reset. They
+ * are drawn by Profiler::drawOverlay while the profiler is enabled, and can be written
+ * to a file in the comma separated format with exportResults.
+ *
+ * The profiler can be enabled with the 'scriptProfiler' property of the game
+ * configuration file, and its sample interval can be set with the
+ * 'scriptProfilerInterval' property.
+ *
+ * @see ScriptController::getProfiler
+ * @script{ignore}
+ */
+class ScriptProfiler
+{
+    friend class ScriptController;
+    friend class ScriptContext;
+    friend class ScriptUtil;
+
+public:
+
+    /**
+     * The sampled time of a script function.
+     */
+    struct Function
+    {
+        /**
+         * The name that the function was first called by, or "?" if it is unknown.
+         */
+        std::string name;
+
+        /**
+         * The source of the script that defines the function.
+         */
+        std::string source;
+
+        /**
+         * The line where the function is defined, or 0 for the main chunk of a script.
+         */
+        int line;
+
+        /**
+         * The number of samples taken while the function was on the call stack.
+         */
+        unsigned int samples;
+
+        /**
+         * The time spent in the function and in the functions that it called, in milliseconds.
+         */
+        float inclusiveTime;
+
+        /**
+         * The time spent in the function itself and in the C functions that it called, in milliseconds.
+         */
+        float exclusiveTime;
+    };
+
+    /**
+     * The sampled time of a script source.
+     */
+    struct Script
+    {
+        /**
+         * The source of the script.
+         */
+        std::string source;
+
+        /**
+         * The time spent while functions of the script were on the call stack, in milliseconds.
+         */
+        float inclusiveTime;
+
+        /**
+         * The time spent in functions of the script, in milliseconds.
+         */
+        float exclusiveTime;
+    };
+
+    /**
+     * The number of calls to a C function.
+     */
+    struct Binding
+    {
+        /**
+         * The name of the function, prefixed by the name of its class for generated bindings.
+         */
+        std::string name;
+
+        /**
+         * The number of calls.
+         */
+        unsigned int calls;
+    };
+
+    /**
+     * Sets whether scripts are sampled.
+     *
+     * The hooks are installed or removed at the end of the frame, as are the changes
+     * to the other settings, since the script contexts may be running until then.
+     *
+     * @param enabled true to sample scripts.
+     */
+    void setEnabled(bool enabled);
+
+    /**
+     * Returns whether scripts are sampled.
+     *
+     * @return true if the profiler is enabled.
+     */
+    bool isEnabled() const;
+
+    /**
+     * Sets the time between two samples. The default interval is a quarter of a millisecond.
+     *
+     * @param milliseconds The sample interval.
+     */
+    void setInterval(float milliseconds);
+
+    /**
+     * Returns the time between two samples.
+     *
+     * @return The sample interval, in milliseconds.
+     */
+    float getInterval() const;
+
+    /**
+     * Sets the number of Lua instructions between two checks of the clock, which
+     * bounds how precisely the samples are taken. The default is 1000 instructions.
+     *
+     * @param count The number of instructions.
+     */
+    void setInstructionCount(unsigned int count);
+
+    /**
+     * Returns the number of Lua instructions between two checks of the clock.
+     *
+     * @return The number of instructions.
+     */
+    unsigned int getInstructionCount() const;
+
+    /**
+     * Sets whether the calls to C functions are counted.
+     *
+     * @param enabled true to count calls.
+     */
+    void setCallCountEnabled(bool enabled);
+
+    /**
+     * Returns whether the calls to C functions are counted.
+     *
+     * @return true if calls are counted.
+     */
+    bool isCallCountEnabled() const;
+
+    /**
+     * Discards the results of all frames so far.
+     */
+    void reset();
+
+    /**
+     * Returns the number of frames that the results accumulate from.
+     *
+     * @return The number of frames.
+     */
+    unsigned int getFrameCount() const;
+
+    /**
+     * Returns the total sampled time of all scripts.
+     *
+     * @return The time in milliseconds.
+     */
+    float getTotalTime() const;
+
+    /**
+     * Gets the sampled functions, from the one with the most exclusive time.
+     *
+     * @param functions The vector to fill with the functions.
+     */
+    void getFunctions(std::vector<Function>* functions) const;
+
+    /**
+     * Gets the sampled scripts, from the one with the most exclusive time.
+     *
+     * @param scripts The vector to fill with the scripts.
+     */
+    void getScripts(std::vector<Script>* scripts) const;
+
+    /**
+     * Gets the counted C functions, from the one with the most calls.
+     *
+     * @param bindings The vector to fill with the C functions.
+     */
+    void getBindings(std::vector<Binding>* bindings) const;
+
+    /**
+     * Draws the functions with the most exclusive time, and the C functions with the
+     * most calls, as a text overlay. The times are averaged over the sampled frames.
+     *
+     * @param font The font to draw with.
+     * @param x The x coordinate of the top left corner of the overlay.
+     * @param y The y coordinate of the top left corner of the overlay.
+     * @param color The color of the text.
+     * @param count The maximum number of functions of each kind to draw.
+     */
+    void drawOverlay(Font* font, int x, int y, const Vector4& color, unsigned int count = 8);
+
+    /**
+     * Writes the results to a file in the comma separated format, with a section of
+     * functions, a section of scripts and a section of C functions.
+     *
+     * @param path The path of the file to write.
+     *
+     * @return true if the file was written, false otherwise.
+     */
+    bool exportResults(const char* path) const;
+
+private:
+
+    /**
+     * Constructor.
+     */
+    ScriptProfiler();
+
+    /**
+     * Destructor.
+     */
+    ~ScriptProfiler();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ScriptProfiler(const ScriptProfiler& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ScriptProfiler& operator=(const ScriptProfiler&);
+
+    /**
+     * Installs the hook in a state.
+     */
+    void attach(lua_State* state);
+
+    /**
+     * Removes the hook from a state and keeps its results.
+     */
+    void detach(lua_State* state);
+
+    /**
+     * Installs or removes the hooks of the script controller and of the script contexts.
+     * The contexts must not be running.
+     */
+    void updateHooks();
+
+    /**
+     * Starts the sample clock of a state before the engine calls a script in it.
+     */
+    void enter(lua_State* state);
+
+    /**
+     * Stops the sample clock of a state after a script called by the engine returns.
+     */
+    void leave(lua_State* state);
+
+    /**
+     * Collects the results of all states at the end of a frame, while the contexts are not running.
+     */
+    void update();
+
+    /**
+     * Names a C function after the class and the name it is registered with, which
+     * must outlive the profiler, as the string literals of the generated bindings do.
+     */
+    void registerBinding(lua_CFunction function, const char* className, const char* name);
+
+    /**
+     * The hook installed in the sampled states.
+     */
+    static void hook(lua_State* state, lua_Debug* ar);
+
+    bool _enabled;
+    bool _callCountEnabled;
+    long long _interval;
+    unsigned int _instructionCount;
+    unsigned int _frameCount;
+    ScriptProfileData* _totals;
+    std::vector<ScriptProfileData*> _samplers;
+    std::map<lua_CFunction, std::pair<const char*, const char*> > _bindingNames;
+};
+
+}
+
+#endif
@@ -9,6 +9,9 @@ namespace gameplay
 
 extern void splitURL(const std::string& url, std::string* file, std::string* id);
 
+// The number of events added to all registries, which assigns the bits of their masks.
+static unsigned int __eventCount = 0;
+
 const char* ScriptTarget::Event::getName() const
 {
     return name.c_str();
@@ -38,6 +41,64 @@ const ScriptTarget::Event* ScriptTarget::EventRegistry::addEvent(const char* nam
     Event* evt = new Event;
     evt->name = name;
     evt->args = args ? args : "";
+    evt->mask = 1ull << (__eventCount++ % 64);
+
+    // Parse the arguments once, so that firing the event pushes its arguments without parsing them.
+    const char* sig = evt->args.c_str();
+    while (*sig)
+    {
+        Event::Parameter parameter;
+        parameter.type = *sig++;
+        switch (parameter.type)
+        {
+        case 'c':
+        case 'h':
+        case 'l':
+            parameter.type = 'i';
+            break;
+        case 'd':
+            parameter.type = 'f';
+            break;
+        case 'u':
+            // Skip past the actual type (long, int, short, char).
+            if (*sig)
+                sig++;
+            break;
+        case '[':
+        {
+            // Enums are pushed as the integer values they represent.
+            parameter.type = 'i';
+            const char* end = strchr(sig, ']');
+            sig = end ? end + 1 : sig + strlen(sig);
+            break;
+        }
+        case '<':
+        {
+            const char* end = strchr(sig, '>');
+            parameter.typeName.assign(sig, end ? end - sig : strlen(sig));
+            sig = end ? end + 1 : sig + strlen(sig);
+
+            // The Lua type name drops the scopes of the qualified type name, like the bindings do.
+            size_t i = parameter.typeName.find("::");
+            while (i != std::string::npos)
+            {
+                parameter.typeName.erase(i, 2);
+                i = parameter.typeName.find("::");
+            }
+            break;
+        }
+        case 'i':
+        case 'b':
+        case 'f':
+        case 's':
+        case 'p':
+            break;
+        default:
+            GP_ERROR("Invalid argument type '%c' for script event '%s'.", parameter.type, name);
+            break;
+        }
+        evt->parameters.push_back(parameter);
+    }
 
     _events.push_back(evt);
 
@@ -69,13 +130,23 @@ const ScriptTarget::Event* ScriptTarget::EventRegistry::getEvent(const char* nam
     return NULL;
 }
 
-ScriptTarget::ScriptTarget() : _scriptRegistries(NULL), _scripts(NULL), _scriptCallbacks(NULL)
+ScriptTarget::ScriptTarget() : _scriptRegistries(NULL), _scripts(NULL), _scriptCallbacks(NULL), _scriptEventMask(0)
 {
 }
 
 ScriptTarget::~ScriptTarget()
 {
     // Free callbacks
+    if (_scriptCallbacks)
+    {
+        std::map<const Event*, std::vector<CallbackFunction>>::iterator itr = _scriptCallbacks->begin();
+        for (; itr != _scriptCallbacks->end(); ++itr)
+        {
+            std::vector<CallbackFunction>& callbacks = itr->second;
+            for (size_t i = 0, count = callbacks.size(); i < count; ++i)
+                releaseCallback(callbacks[i]);
+        }
+    }
     SAFE_DELETE(_scriptCallbacks);
 
     // Free scripts
@@ -160,6 +231,7 @@ Script* ScriptTarget::addScript(const char* path)
                 if (!_scriptCallbacks)
                     _scriptCallbacks = new std::map<const Event*, std::vector<CallbackFunction>>();
                 (*_scriptCallbacks)[event].push_back(CallbackFunction(script, event->name.c_str()));
+                _scriptEventMask |= event->mask;
             }
         }
         re = re->next;
@@ -220,11 +292,15 @@ void ScriptTarget::removeScript(ScriptEntry* se)
             while (itr2 != callbacks.end())
             {
                 if (itr2->script == script)
+                {
+                    releaseCallback(*itr2);
                     itr2 = callbacks.erase(itr2);
+                }
                 else
                     ++itr2;
             }
         }
+        updateScriptEventMask();
     }
 
     // Free the script
@@ -299,6 +375,7 @@ void ScriptTarget::addScriptCallback(const Event* event, const char* function)
         if (!_scriptCallbacks)
             _scriptCallbacks = new std::map<const Event*, std::vector<CallbackFunction>>();
         (*_scriptCallbacks)[event].push_back(CallbackFunction(script, func.c_str()));
+        _scriptEventMask |= event->mask;
     }
 }
 
@@ -350,6 +427,7 @@ void ScriptTarget::removeScriptCallback(const Event* event, const char* function
                     ++totalCallbacks; // sum total number of callbacks found for this script
                     if (forEvent && itr2->function == func)
                     {
+                        releaseCallback(*itr2);
                         itr2 = callbacks.erase(itr2);
                         ++removedCallbacks; // sum number of callbacks removed
                     }
@@ -358,6 +436,7 @@ void ScriptTarget::removeScriptCallback(const Event* event, const char* function
                 }
             }
         }
+        updateScriptEventMask();
     }
 
     // Cleanup the script if there are no remaining callbacks for it
@@ -402,6 +481,9 @@ bool ScriptTarget::hasScriptListener(const Event* event) const
 {
     GP_ASSERT(event);
 
+    if ((_scriptEventMask & event->mask) == 0)
+        return false;
+
     if (_scriptCallbacks)
     {
         std::map<const Event*, std::vector<CallbackFunction>>::iterator itr = _scriptCallbacks->find(event);
@@ -414,64 +496,75 @@ bool ScriptTarget::hasScriptListener(const Event* event) const
     return false;
 }
 
-template<> void ScriptTarget::fireScriptEvent<void>(const Event* event, ...)
+void ScriptTarget::fireScriptEvent(const Event* event, const Argument* arguments, unsigned int count, void* result)
 {
     GP_ASSERT(event);
 
     if (!_scriptCallbacks)
         return; // no registered callbacks
 
-    va_list list;
-    va_start(list, event);
-
     // Lookup registered callbacks for this event and fire them
     std::map<const Event*, std::vector<CallbackFunction>>::iterator itr = _scriptCallbacks->find(event);
     if (itr != _scriptCallbacks->end())
     {
         ScriptController* sc = Game::getInstance()->getScriptController();
         std::vector<CallbackFunction>& callbacks = itr->second;
-        for (size_t i = 0, count = callbacks.size(); i < count; ++i)
+        for (size_t i = 0, callbackCount = callbacks.size(); i < callbackCount; ++i)
         {
             CallbackFunction& cb = callbacks[i];
-            sc->executeFunction<void>(cb.script, cb.function.c_str(), event->args.c_str(), NULL, &list);
+            if (sc->updateFunctionRef(cb.function.c_str(), cb.script, &cb.ref, &cb.generation))
+                sc->executeFunctionRef(cb.ref, cb.function.c_str(), cb.script, event, arguments, count, NULL);
         }
     }
-
-    va_end(list);
 }
 
-template<> bool ScriptTarget::fireScriptEvent<bool>(const Event* event, ...)
+bool ScriptTarget::fireScriptEvent(const Event* event, const Argument* arguments, unsigned int count, bool* result)
 {
     GP_ASSERT(event);
 
     if (!_scriptCallbacks)
         return false; // no registered callbacks
 
-    va_list list;
-    va_start(list, event);
-
     // Lookup registered callbacks for this event and fire them
     std::map<const Event*, std::vector<CallbackFunction>>::iterator itr = _scriptCallbacks->find(event);
     if (itr != _scriptCallbacks->end())
     {
         ScriptController* sc = Game::getInstance()->getScriptController();
         std::vector<CallbackFunction>& callbacks = itr->second;
-        for (size_t i = 0, count = callbacks.size(); i < count; ++i)
+        for (size_t i = 0, callbackCount = callbacks.size(); i < callbackCount; ++i)
         {
             CallbackFunction& cb = callbacks[i];
-            bool result = false;
-            if (sc->executeFunction<bool>(cb.script, cb.function.c_str(), event->args.c_str(), &result, &list) && result)
+            bool handled = false;
+            if (sc->updateFunctionRef(cb.function.c_str(), cb.script, &cb.ref, &cb.generation) &&
+                sc->executeFunctionRef(cb.ref, cb.function.c_str(), cb.script, event, arguments, count, &handled) && handled)
             {
                 // Handled, break out early
-                va_end(list);
                 return true;
             }
         }
     }
 
-    va_end(list);
-
     return false;
 }
 
+void ScriptTarget::updateScriptEventMask()
+{
+    _scriptEventMask = 0;
+    if (_scriptCallbacks)
+    {
+        std::map<const Event*, std::vector<CallbackFunction>>::iterator itr = _scriptCallbacks->begin();
+        for (; itr != _scriptCallbacks->end(); ++itr)
+        {
+            if (!itr->second.empty())
+                _scriptEventMask |= itr->first->mask;
+        }
+    }
+}
+
+void ScriptTarget::releaseCallback(CallbackFunction& callback)
+{
+    if (callback.ref != LUA_NOREF)
+        Game::getInstance()->getScriptController()->releaseFunctionRef(&callback.ref, &callback.generation);
+}
+
 }
@@ -109,6 +109,7 @@ public: \
 class ScriptTarget
 {
     friend class Game;
+    friend class ScriptController;
 
 public:
 
@@ -118,6 +119,7 @@ public:
     class Event
     {
         friend class ScriptTarget;
+        friend class ScriptController;
 
     public:
 
@@ -137,6 +139,17 @@ public:
 
     private:
 
+        /**
+         * A parameter of the event, parsed from its argument string.
+         */
+        struct Parameter
+        {
+            /** The type of the parameter: 'i' for signed integers and enums, 'u', 'b', 'f', 's', 'p' or '<' for objects. */
+            char type;
+            /** The Lua type name of the objects passed for the parameter. */
+            std::string typeName;
+        };
+
         /**
          * The event name.
          */
@@ -148,6 +161,16 @@ public:
          */
         std::string args;
 
+        /**
+         * The event parameters, parsed once from the event arguments.
+         */
+        std::vector<Parameter> parameters;
+
+        /**
+         * The bit of the event in the event masks of script targets, which
+         * every 64th event shares.
+         */
+        unsigned long long mask;
     };
 
     /**
@@ -301,13 +324,16 @@ public:
      * given script event, event delegation will stop at the first script
      * that returns a value of true.
      * 
+     * The arguments are passed to scripts as the types of the script event argument definition,
+     * converting the numbers passed as other numeric types.
+     *
      * @param event The script event to fire, which was returned from EventRegistry::addEvent.
-     * @param ... Optional list of arguments to pass to the script event (should match the
+     * @param args Optional list of arguments to pass to the script event (should match the
      *      script event argument definition).
      *
      * @script{ignore}
      */
-    template<typename T> T fireScriptEvent(const Event* event, ...);
+    template<typename T, typename... Args> T fireScriptEvent(const Event* event, Args... args);
 
 protected:
 
@@ -359,13 +385,74 @@ protected:
         Script* script;
         /** The function within the script to call. */
         std::string function;
+        /** The reference to the function, which is looked up when the callback is first fired. */
+        int ref;
+        /** The generation of scripts that the function was looked up in. */
+        unsigned int generation;
 
         /**
          * The callback function to registry script function to.
          * @param script The script.
          * @param function The script function.
          */
-        CallbackFunction(Script* script, const char* function) : script(script), function(function) { }
+        CallbackFunction(Script* script, const char* function) : script(script), function(function), ref(LUA_NOREF), generation(0) { }
+    };
+
+    /**
+     * Stores an argument of a script event as the type that it was passed as, so that firing
+     * an event neither walks a variable argument list nor parses the event arguments.
+     */
+    struct Argument
+    {
+        /** The kinds of arguments. */
+        enum Type
+        {
+            INTEGER,
+            NUMBER,
+            POINTER
+        };
+
+        /** The kind of the argument. */
+        Type type;
+
+        union
+        {
+            /** The value of integer, boolean and enum arguments. */
+            long long integer;
+            /** The value of floating point arguments. */
+            double number;
+            /** The value of string and object arguments. */
+            const void* pointer;
+        };
+
+        /**
+         * Constructor.
+         */
+        Argument() : type(INTEGER), integer(0) { }
+
+        /**
+         * Constructor for integer, boolean and enum arguments.
+         * @param value The value.
+         */
+        template<typename T> Argument(T value) : type(INTEGER), integer((long long)value) { }
+
+        /**
+         * Constructor for string and object arguments.
+         * @param value The value.
+         */
+        template<typename T> Argument(T* value) : type(POINTER), pointer(value) { }
+
+        /**
+         * Constructor for floating point arguments.
+         * @param value The value.
+         */
+        Argument(float value) : type(NUMBER), number(value) { }
+
+        /**
+         * Constructor for floating point arguments.
+         * @param value The value.
+         */
+        Argument(double value) : type(NUMBER), number(value) { }
     };
 
     /**
@@ -400,42 +487,71 @@ protected:
      */
     void registerEvents(EventRegistry* registry);
 
+    /**
+     * Fires a script event that returns nothing.
+     *
+     * @param event The script event to fire.
+     * @param arguments The arguments to pass to the script event.
+     * @param count The number of arguments.
+     * @param result Unused, selects the return type of the event.
+     */
+    void fireScriptEvent(const Event* event, const Argument* arguments, unsigned int count, void* result);
+
+    /**
+     * Fires a script event that returns a boolean, stopping at the first callback that returns true.
+     *
+     * @param event The script event to fire.
+     * @param arguments The arguments to pass to the script event.
+     * @param count The number of arguments.
+     * @param result Unused, selects the return type of the event.
+     *
+     * @return True if a callback handled the event, false otherwise.
+     */
+    bool fireScriptEvent(const Event* event, const Argument* arguments, unsigned int count, bool* result);
+
+    /**
+     * Releases the reference to the function of a callback that is being removed.
+     *
+     * @param callback The callback.
+     */
+    static void releaseCallback(CallbackFunction& callback);
+
+    /**
+     * Updates the mask of the events with callbacks, after callbacks are removed.
+     */
+    void updateScriptEventMask();
+
     /** Holds the event registries for this script target. */
     RegistryEntry* _scriptRegistries;
     /** Holds the list of scripts referenced by this ScriptTarget. */
     ScriptEntry* _scripts;
     /** Holds the list of callback functions registered for this ScriptTarget. */
     std::map<const Event*, std::vector<CallbackFunction> >* _scriptCallbacks;
+    /** Holds the bits of the events with callbacks, so that other events are skipped without a lookup. */
+    unsigned long long _scriptEventMask;
 };
 
 /**
- * The fire script event template specialization.
+ * The fire script event template.
+ *
+ * The only supported return types are void and bool, which select the overload that
+ * fires the event.
  *
  * @param event The event fired.
- * @param ... Optional list of arguments to pass to the script event.
+ * @param args Optional list of arguments to pass to the script event.
  */
-template<typename T> T ScriptTarget::fireScriptEvent(const Event* event, ...)
+template<typename T, typename... Args> T ScriptTarget::fireScriptEvent(const Event* event, Args... args)
 {
-    GP_ERROR("Unsupported return type for template function ScriptTarget::fireScriptEvent.");
-}
+    GP_ASSERT(event);
 
-/** 
- * Template specialization. 
- *
- * @param evt The event fired.
- * @param ... Optional list of arguments to pass to the script event (should match the
- *      script event argument definition).
- */
-template<> void ScriptTarget::fireScriptEvent<void>(const Event* evt, ...);
+    // Events that no script listens to cost a single test.
+    if ((_scriptEventMask & event->mask) == 0)
+        return T();
 
-/** 
- * Template specialization.
- *
- * @param evt The event fired.
- * @param ... Optional list of arguments to pass to the script event (should match the
- *      script event argument definition).
- */
-template<> bool ScriptTarget::fireScriptEvent<bool>(const Event* evt, ...);
+    // The last argument keeps the array from being empty for events without arguments.
+    const Argument arguments[] = { Argument(args)..., Argument() };
+    return fireScriptEvent(event, arguments, sizeof...(Args), (T*)NULL);
+}
 
 }
 
@@ -0,0 +1,608 @@
+#include "Base.h"
+#include "ShadowMaps.h"
+#include "Scene.h"
+#include "Game.h"
+#include "FrameBuffer.h"
+#include "Effect.h"
+#include "Model.h"
+#include "MeshPart.h"
+#include "VertexAttributeBinding.h"
+#include "RenderStats.h"
+
+// The fraction of its radius that a cached cascade is enlarged by, and the fraction of its
+// radius that its center is snapped to. Snapping moves the center by less than the margin,
+// so the enlarged cascade always covers its slice.
+#define SHADOW_CACHED_MARGIN 0.5f
+
+// The widest field of view of a spot light shadow map, in degrees.
+#define SHADOW_MAX_SPOT_FIELD_OF_VIEW 170.0f
+
+namespace gameplay
+{
+
+// Vertex shader for drawing the depth of shadow casters.
+static const char* SHADOW_VS =
+{
+    "uniform mat4 u_worldViewProjectionMatrix;\n"
+    "attribute vec4 a_position;\n"
+    "void main(void) {\n"
+    "    gl_Position = u_worldViewProjectionMatrix * a_position;\n"
+    "}"
+};
+
+// Fragment shader for drawing the depth of shadow casters, which have no color.
+static const char* SHADOW_FS =
+{
+#ifdef OPENGL_ES
+    "precision mediump float;\n"
+#endif
+    "void main(void) {\n"
+    "    gl_FragColor = vec4(1.0);\n"
+    "}"
+};
+
+static unsigned int __shadowMapsCount = 0;
+
+// Returns the model of a node if it casts shadows.
+static Model* getCasterModel(Node* node)
+{
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    if (!model || model->getSkin() || model->getInstanceCount() > 0)
+        return NULL;
+    return model;
+}
+
+static inline unsigned int hashValue(unsigned int hash, unsigned int value)
+{
+    // FNV-1a over the bytes of the value.
+    for (unsigned int i = 0; i < 4; ++i)
+    {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static inline unsigned int hashFloat(unsigned int hash, float value)
+{
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return hashValue(hash, bits);
+}
+
+ShadowMaps::ShadowMaps(Scene* scene)
+    : _scene(scene), _light(NULL), _cascadeCount(4), _mapSize(1024), _distance(100.0f), _splitLambda(0.75f),
+      _casterDistance(100.0f), _depthBias(0.002f), _cachedStart(2), _nextCached(0), _drawnCasters(0), _drawnMaps(0),
+      _frameBuffer(NULL), _sampler(NULL), _effect(NULL), _matrixUniform(NULL), _stateBlock(NULL), _casterFrustum(NULL)
+{
+    GP_ASSERT(_scene);
+
+    for (unsigned int i = 0; i < SHADOW_MAX_CASCADES; ++i)
+    {
+        _cascades[i].signature = 0;
+        _cascades[i].valid = false;
+    }
+
+    _effect = Effect::createFromSource(SHADOW_VS, SHADOW_FS);
+    if (_effect)
+        _matrixUniform = _effect->getUniform("u_worldViewProjectionMatrix");
+    else
+        GP_WARN("Failed to create the shadow caster effect.");
+
+    // Back faces are drawn into the maps, which keeps the lit faces of casters from shadowing themselves.
+    _stateBlock = RenderState::StateBlock::create();
+    _stateBlock->setDepthTest(true);
+    _stateBlock->setDepthWrite(true);
+    _stateBlock->setDepthFunction(RenderState::DEPTH_LESS);
+    _stateBlock->setCullFace(true);
+    _stateBlock->setCullFaceSide(RenderState::CULL_FACE_SIDE_FRONT);
+    _stateBlock->setBlend(false);
+
+    resize();
+}
+
+ShadowMaps::~ShadowMaps()
+{
+    for (std::map<Mesh*, VertexAttributeBinding*>::iterator itr = _bindings.begin(); itr != _bindings.end(); ++itr)
+    {
+        SAFE_RELEASE(itr->second);
+    }
+    SAFE_RELEASE(_light);
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_frameBuffer);
+    SAFE_RELEASE(_effect);
+    SAFE_RELEASE(_stateBlock);
+}
+
+void ShadowMaps::setLight(Light* light)
+{
+    GP_ASSERT(!light || light->getLightType() == Light::DIRECTIONAL || light->getLightType() == Light::SPOT);
+
+    if (light == _light)
+        return;
+
+    unsigned int mapCount = getMapCount();
+    SAFE_RELEASE(_light);
+    _light = light;
+    if (_light)
+        _light->addRef();
+
+    if (getMapCount() != mapCount)
+        resize();
+    else
+        invalidate();
+}
+
+Light* ShadowMaps::getLight() const
+{
+    return _light;
+}
+
+void ShadowMaps::setCascadeCount(unsigned int count)
+{
+    GP_ASSERT(count > 0 && count <= SHADOW_MAX_CASCADES);
+
+    count = std::max(std::min(count, (unsigned int)SHADOW_MAX_CASCADES), 1u);
+    if (count == _cascadeCount)
+        return;
+
+    unsigned int mapCount = getMapCount();
+    _cascadeCount = count;
+    if (getMapCount() != mapCount)
+        resize();
+}
+
+unsigned int ShadowMaps::getCascadeCount() const
+{
+    return _cascadeCount;
+}
+
+void ShadowMaps::setMapSize(unsigned int size)
+{
+    GP_ASSERT(size > 0);
+
+    if (size == _mapSize)
+        return;
+
+    _mapSize = size;
+    resize();
+}
+
+unsigned int ShadowMaps::getMapSize() const
+{
+    return _mapSize;
+}
+
+void ShadowMaps::setDistance(float distance)
+{
+    _distance = distance;
+}
+
+float ShadowMaps::getDistance() const
+{
+    return _distance;
+}
+
+void ShadowMaps::setSplitLambda(float lambda)
+{
+    _splitLambda = MATH_CLAMP(lambda, 0.0f, 1.0f);
+}
+
+void ShadowMaps::setCasterDistance(float distance)
+{
+    _casterDistance = std::max(distance, 0.0f);
+}
+
+void ShadowMaps::setDepthBias(float bias)
+{
+    _depthBias = bias;
+}
+
+void ShadowMaps::setCachedCascadeStart(unsigned int cascade)
+{
+    _cachedStart = cascade;
+    invalidate();
+}
+
+unsigned int ShadowMaps::getCachedCascadeStart() const
+{
+    return _cachedStart;
+}
+
+void ShadowMaps::invalidate()
+{
+    for (unsigned int i = 0; i < SHADOW_MAX_CASCADES; ++i)
+    {
+        _cascades[i].valid = false;
+    }
+}
+
+unsigned int ShadowMaps::getDrawnCasterCount() const
+{
+    return _drawnCasters;
+}
+
+unsigned int ShadowMaps::getDrawnMapCount() const
+{
+    return _drawnMaps;
+}
+
+const Texture::Sampler* ShadowMaps::getSampler() const
+{
+    return _sampler;
+}
+
+const Matrix* ShadowMaps::getMatrices() const
+{
+    return _matrices;
+}
+
+unsigned int ShadowMaps::getMatrixCount() const
+{
+    return SHADOW_MAX_CASCADES;
+}
+
+const Vector4& ShadowMaps::getCascadeSplits() const
+{
+    return _splits;
+}
+
+const Vector4& ShadowMaps::getParameters() const
+{
+    return _parameters;
+}
+
+unsigned int ShadowMaps::getMapCount() const
+{
+    return (_light && _light->getLightType() == Light::SPOT) ? 1 : _cascadeCount;
+}
+
+void ShadowMaps::resize()
+{
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_frameBuffer);
+    invalidate();
+
+    // The maps are laid out in one row, so each map is a column of the texture.
+    unsigned int mapCount = getMapCount();
+    char id[32];
+    sprintf(id, "shadowmaps%u", __shadowMapsCount++);
+    _frameBuffer = FrameBuffer::create(id, _mapSize * mapCount, _mapSize, Texture::DEPTH);
+    if (!_frameBuffer)
+    {
+        GP_WARN("Failed to create the frame buffer for shadow maps of %ux%u texels.", _mapSize * mapCount, _mapSize);
+        return;
+    }
+
+    _sampler = Texture::Sampler::create(_frameBuffer->getRenderTarget(0)->getTexture());
+    _sampler->setFilterMode(Texture::NEAREST, Texture::NEAREST);
+    _sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+
+    _parameters.x = 1.0f / (_mapSize * mapCount);
+    _parameters.y = 1.0f / _mapSize;
+}
+
+void ShadowMaps::update(Camera* camera)
+{
+    GP_PROFILE("ShadowMaps::update");
+
+    _drawnCasters = 0;
+    _drawnMaps = 0;
+
+    // Receivers are lit beyond the shadow distance, which is zero until there are shadows.
+    _parameters.z = _depthBias;
+    _parameters.w = 0.0f;
+
+    if (!camera)
+        camera = _scene->getActiveCamera();
+    if (!_light || !_light->getNode() || !camera || !camera->getNode() || !_frameBuffer || !_effect)
+        return;
+
+    // Release the vertex bindings of meshes that only the bindings still hold on to.
+    for (std::map<Mesh*, VertexAttributeBinding*>::iterator itr = _bindings.begin(); itr != _bindings.end();)
+    {
+        if (itr->first->getRefCount() == 1)
+        {
+            SAFE_RELEASE(itr->second);
+            _bindings.erase(itr++);
+        }
+        else
+        {
+            ++itr;
+        }
+    }
+
+    Matrix views[SHADOW_MAX_CASCADES];
+    unsigned int mapCount = getMapCount();
+    if (_light->getLightType() == Light::SPOT)
+        computeSpotView(camera, views);
+    else
+        computeDirectionalViews(camera, views);
+
+    Game* game = Game::getInstance();
+    Rectangle viewport = game->getViewport();
+    FrameBuffer* previousFrameBuffer = _frameBuffer->bind();
+
+    // Cascades before the cached ones are drawn every update.
+    unsigned int cachedStart = std::min(_cachedStart, mapCount);
+    for (unsigned int i = 0; i < cachedStart; ++i)
+    {
+        Frustum frustum(views[i]);
+        findCasters(frustum);
+        drawCasters(views[i], i);
+        _cascades[i].viewProjection = views[i];
+        _cascades[i].valid = true;
+    }
+
+    // Cached cascades are checked in turn, and only the first one that changed is drawn.
+    // Cascades that were never drawn since they were invalidated are always drawn.
+    unsigned int cachedCount = mapCount - cachedStart;
+    bool drawnChanged = false;
+    for (unsigned int j = 0; j < cachedCount; ++j)
+    {
+        unsigned int i = cachedStart + (_nextCached + j) % cachedCount;
+        Cascade& cascade = _cascades[i];
+
+        Frustum frustum(views[i]);
+        findCasters(frustum);
+        unsigned int signature = computeSignature(views[i]);
+        if (cascade.valid && (cascade.signature == signature || drawnChanged))
+            continue;
+
+        if (cascade.valid)
+        {
+            drawnChanged = true;
+            _nextCached = (i - cachedStart + 1) % cachedCount;
+        }
+        drawCasters(views[i], i);
+        cascade.viewProjection = views[i];
+        cascade.signature = signature;
+        cascade.valid = true;
+    }
+
+    previousFrameBuffer->bind();
+    game->setViewport(viewport);
+
+    // Receivers transform their view space position by the inverse view of the camera and the
+    // view of the light that their map was drawn with, then map it into the column of the map.
+    const Matrix& inverseView = camera->getInverseViewMatrix();
+    for (unsigned int i = 0; i < mapCount; ++i)
+    {
+        Matrix bias(0.5f / mapCount, 0.0f, 0.0f, (i + 0.5f) / mapCount,
+                    0.0f, 0.5f, 0.0f, 0.5f,
+                    0.0f, 0.0f, 0.5f, 0.5f,
+                    0.0f, 0.0f, 0.0f, 1.0f);
+        Matrix::multiply(bias, _cascades[i].viewProjection, &_matrices[i]);
+        Matrix::multiply(_matrices[i], inverseView, &_matrices[i]);
+    }
+}
+
+void ShadowMaps::computeDirectionalViews(Camera* camera, Matrix* views)
+{
+    Vector3 direction = _light->getNode()->getForwardVectorWorld();
+    direction.normalize();
+
+    // The light looks from the origin of the world, so that views are snapped to the same
+    // grid wherever the camera is.
+    Matrix lightView;
+    Matrix::createLookAt(Vector3::zero(), direction, fabs(direction.y) < 0.99f ? Vector3::unitY() : Vector3::unitX(), &lightView);
+
+    float nearPlane = camera->getNearPlane();
+    float farPlane = std::max(std::min(camera->getFarPlane(), _distance), nearPlane * 1.01f);
+    float halfWidth = 0.0f;
+    float halfHeight = 0.0f;
+    if (camera->getCameraType() == Camera::PERSPECTIVE)
+    {
+        halfHeight = tan(MATH_DEG_TO_RAD(camera->getFieldOfView()) * 0.5f);
+        halfWidth = halfHeight * camera->getAspectRatio();
+    }
+    const Matrix& cameraWorld = camera->getInverseViewMatrix();
+
+    float splits[SHADOW_MAX_CASCADES];
+    float sliceNear = nearPlane;
+    for (unsigned int i = 0; i < _cascadeCount; ++i)
+    {
+        // Blend evenly spaced and logarithmic splits of the shadow distance.
+        float t = (float)(i + 1) / _cascadeCount;
+        float sliceFar = _splitLambda * nearPlane * powf(farPlane / nearPlane, t) + (1.0f - _splitLambda) * (nearPlane + (farPlane - nearPlane) * t);
+        splits[i] = sliceFar;
+
+        // The bounding sphere of the slice doesn't change size as the camera turns.
+        Vector3 center(0.0f, 0.0f, -(sliceNear + sliceFar) * 0.5f);
+        float radius;
+        if (camera->getCameraType() == Camera::PERSPECTIVE)
+        {
+            Vector3 nearCorner(halfWidth * sliceNear, halfHeight * sliceNear, -sliceNear);
+            Vector3 farCorner(halfWidth * sliceFar, halfHeight * sliceFar, -sliceFar);
+            radius = std::max(center.distance(nearCorner), center.distance(farCorner));
+        }
+        else
+        {
+            Vector3 corner(camera->getZoomX() * 0.5f, camera->getZoomY() * 0.5f, -sliceFar);
+            radius = center.distance(corner);
+        }
+        cameraWorld.transformPoint(&center);
+        lightView.transformPoint(&center);
+
+        if (i >= _cachedStart)
+        {
+            // Cached cascades are enlarged and move in steps of a fraction of their size.
+            float step = radius * SHADOW_CACHED_MARGIN;
+            radius += step;
+            center.x = floor(center.x / step + 0.5f) * step;
+            center.y = floor(center.y / step + 0.5f) * step;
+            center.z = floor(center.z / step + 0.5f) * step;
+        }
+        else
+        {
+            // Other cascades move in steps of one texel.
+            float step = radius * 2.0f / _mapSize;
+            center.x = floor(center.x / step) * step;
+            center.y = floor(center.y / step) * step;
+        }
+
+        // The light looks down its negative z axis, and casters up to the caster distance
+        // towards the light are drawn.
+        Matrix projection;
+        Matrix::createOrthographicOffCenter(center.x - radius, center.x + radius, center.y - radius, center.y + radius,
+                                            -center.z - radius - _casterDistance, -center.z + radius, &projection);
+        Matrix::multiply(projection, lightView, &views[i]);
+
+        sliceNear = sliceFar;
+    }
+    for (unsigned int i = _cascadeCount; i < SHADOW_MAX_CASCADES; ++i)
+    {
+        splits[i] = farPlane;
+    }
+    _splits.set(splits);
+    _parameters.w = farPlane;
+}
+
+void ShadowMaps::computeSpotView(Camera* camera, Matrix* view)
+{
+    Node* node = _light->getNode();
+    Vector3 position = node->getTranslationWorld();
+    Vector3 direction = node->getForwardVectorWorld();
+    direction.normalize();
+    Vector3 up = node->getUpVectorWorld();
+    up.normalize();
+
+    Matrix lightView;
+    Matrix::createLookAt(position, position + direction, up, &lightView);
+
+    float range = _light->getRange();
+    float fieldOfView = std::min(MATH_RAD_TO_DEG(_light->getOuterAngle()) * 2.0f, SHADOW_MAX_SPOT_FIELD_OF_VIEW);
+    Matrix projection;
+    Matrix::createPerspective(fieldOfView, 1.0f, range * 0.01f, range, &projection);
+    Matrix::multiply(projection, lightView, view);
+
+    // There is a single map, which receivers use at any depth.
+    float farPlane = camera->getFarPlane();
+    _splits.set(farPlane, farPlane, farPlane, farPlane);
+    _parameters.w = farPlane;
+}
+
+void ShadowMaps::findCasters(const Frustum& frustum)
+{
+    _casters.clear();
+
+    SpatialIndex* spatialIndex = _scene->getSpatialIndex();
+    if (spatialIndex)
+    {
+        spatialIndex->findNodes(frustum, _casters);
+        for (size_t i = 0; i < _casters.size();)
+        {
+            Node* node = _casters[i];
+            if (getCasterModel(node) && node->isEnabledInHierarchy())
+            {
+                ++i;
+            }
+            else
+            {
+                _casters[i] = _casters.back();
+                _casters.pop_back();
+            }
+        }
+    }
+    else
+    {
+        _casterFrustum = &frustum;
+        _scene->visit(this, &ShadowMaps::gatherCaster);
+        _casterFrustum = NULL;
+    }
+}
+
+bool ShadowMaps::gatherCaster(Node* node)
+{
+    // The children of disabled nodes are disabled too.
+    if (!node->isEnabled())
+        return false;
+
+    GP_ASSERT(_casterFrustum);
+    if (getCasterModel(node) && _casterFrustum->intersects(node->getBoundingSphere()))
+        _casters.push_back(node);
+    return true;
+}
+
+unsigned int ShadowMaps::computeSignature(const Matrix& view) const
+{
+    unsigned int hash = 2166136261u;
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        hash = hashFloat(hash, view.m[i]);
+    }
+
+    // Casters are hashed in any order, so that a different order of the spatial index
+    // doesn't count as a change.
+    unsigned int casters = 0;
+    for (size_t i = 0, count = _casters.size(); i < count; ++i)
+    {
+        Node* node = _casters[i];
+        const BoundingSphere& bounds = node->getBoundingSphere();
+        unsigned int caster = hashValue(2166136261u, (unsigned int)(size_t)node);
+        caster = hashFloat(caster, bounds.center.x);
+        caster = hashFloat(caster, bounds.center.y);
+        caster = hashFloat(caster, bounds.center.z);
+        caster = hashFloat(caster, bounds.radius);
+        casters += caster;
+    }
+    return hashValue(hashValue(hash, casters), (unsigned int)_casters.size());
+}
+
+void ShadowMaps::drawCasters(const Matrix& view, unsigned int index)
+{
+    // Only the column of the map is cleared, which keeps the cached maps next to it.
+    Game* game = Game::getInstance();
+    game->setViewport(Rectangle((float)(index * _mapSize), 0.0f, (float)_mapSize, (float)_mapSize));
+    GL_ASSERT( glEnable(GL_SCISSOR_TEST) );
+    GL_ASSERT( glScissor(index * _mapSize, 0, _mapSize, _mapSize) );
+    game->clear(Game::CLEAR_DEPTH, Vector4::zero(), 1.0f, 0);
+    GL_ASSERT( glDisable(GL_SCISSOR_TEST) );
+
+    _stateBlock->bind();
+    GL_ASSERT( glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE) );
+    _effect->bind();
+
+    for (size_t i = 0, count = _casters.size(); i < count; ++i)
+    {
+        Node* node = _casters[i];
+        Mesh* mesh = getCasterModel(node)->getMesh();
+        GP_ASSERT(mesh);
+
+        std::map<Mesh*, VertexAttributeBinding*>::iterator itr = _bindings.find(mesh);
+        VertexAttributeBinding* binding = itr != _bindings.end() ? itr->second : NULL;
+        if (!binding)
+        {
+            binding = VertexAttributeBinding::create(mesh, _effect);
+            if (!binding)
+                continue;
+            _bindings[mesh] = binding;
+        }
+
+        Matrix worldViewProjection;
+        Matrix::multiply(view, node->getWorldMatrix(), &worldViewProjection);
+        _effect->setValue(_matrixUniform, worldViewProjection);
+        binding->bind();
+
+        unsigned int partCount = mesh->getPartCount();
+        if (partCount == 0)
+        {
+            GL_ASSERT( glDrawArrays(mesh->getPrimitiveType(), 0, mesh->getVertexCount()) );
+            RenderStats::count(RenderStats::DRAW_CALLS);
+        }
+        for (unsigned int j = 0; j < partCount; ++j)
+        {
+            MeshPart* part = mesh->getPart(j);
+            binding->bindIndexBuffer(part->getIndexBuffer());
+            GL_ASSERT( glDrawElements(part->getPrimitiveType(), part->getIndexCount(), part->getIndexFormat(), (const GLvoid*)(size_t)part->getIndexOffset()) );
+            RenderStats::count(RenderStats::DRAW_CALLS);
+        }
+        binding->unbind();
+    }
+
+    GL_ASSERT( glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE) );
+    _drawnCasters += (unsigned int)_casters.size();
+    ++_drawnMaps;
+}
+
+}
@@ -0,0 +1,320 @@
+#ifndef SHADOWMAPS_H_
+#define SHADOWMAPS_H_
+
+#include "Texture.h"
+#include "Matrix.h"
+#include "Vector4.h"
+#include "Frustum.h"
+#include "RenderState.h"
+
+// The largest number of cascades of a directional light, whose splits are passed in a Vector4.
+#define SHADOW_MAX_CASCADES 4
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+class Camera;
+class Light;
+class Model;
+class Effect;
+class Uniform;
+class FrameBuffer;
+class Mesh;
+class VertexAttributeBinding;
+
+/**
+ * Defines the shadow maps that one directional or spot light of a scene casts.
+ *
+ * A directional light casts cascaded shadow maps: the view of the camera, up to the shadow
+ * distance, is split into slices that grow with depth, and each slice is covered by an
+ * orthographic view of the light that encloses its bounding sphere. The views are snapped
+ * to the texels of their maps so that shadow edges don't shimmer as the camera moves. A spot
+ * light casts a single perspective shadow map that covers its cone and range.
+ *
+ * The casters of each map are the enabled models whose bounds intersect the view of the
+ * light, found through the spatial index of the scene when it is enabled. Skinned and
+ * instanced models don't cast shadows.
+ *
+ * Distant cascades, from the cascade set with setCachedCascadeStart, are cached: they are
+ * enlarged and placed on a coarse grid so that their views only change after the camera has
+ * moved by a fraction of their size, and they are only drawn again when their view changes
+ * or when the casters found in them move, appear or disappear. At most one cached cascade is
+ * drawn per update, which keeps the cost of static geometry in the distance bounded.
+ *
+ * All maps are drawn side by side into one depth texture, which is bound with the
+ * SHADOW_MAP_TEXTURE auto binding. Materials that are compiled with the SHADOWS define
+ * darken the first directional light with it, or the first spot light when SPOT_SHADOWS is
+ * also defined, using the SHADOW_MATRICES, SHADOW_CASCADE_SPLITS and SHADOW_PARAMETERS auto
+ * bindings. SHADOW_CASCADE_COUNT must be defined to the number of cascades when it is more
+ * than one.
+ *
+ * Depth textures require OpenGL ES 3.0 or OES_depth_texture on OpenGL ES 2.0.
+ *
+ * @see Scene::setShadowsEnabled
+ * @script{ignore}
+ */
+class ShadowMaps
+{
+    friend class Scene;
+
+public:
+
+    /**
+     * Sets the light that casts the shadows.
+     *
+     * @param light The directional or spot light that casts the shadows, or NULL for no shadows.
+     */
+    void setLight(Light* light);
+
+    /**
+     * Returns the light that casts the shadows.
+     *
+     * @return The light that casts the shadows, or NULL.
+     */
+    Light* getLight() const;
+
+    /**
+     * Sets the number of cascades of a directional light. Spot lights always have one map.
+     *
+     * @param count The number of cascades, from 1 to SHADOW_MAX_CASCADES.
+     */
+    void setCascadeCount(unsigned int count);
+
+    /**
+     * Returns the number of cascades of a directional light.
+     *
+     * @return The number of cascades.
+     */
+    unsigned int getCascadeCount() const;
+
+    /**
+     * Sets the width and height of each shadow map, in texels.
+     *
+     * @param size The size of each shadow map.
+     */
+    void setMapSize(unsigned int size);
+
+    /**
+     * Returns the width and height of each shadow map, in texels.
+     *
+     * @return The size of each shadow map.
+     */
+    unsigned int getMapSize() const;
+
+    /**
+     * Sets the distance from the camera up to which directional shadows are drawn.
+     *
+     * @param distance The shadow distance.
+     */
+    void setDistance(float distance);
+
+    /**
+     * Returns the distance from the camera up to which directional shadows are drawn.
+     *
+     * @return The shadow distance.
+     */
+    float getDistance() const;
+
+    /**
+     * Sets how the cascades are split, from evenly spaced slices at 0 to slices that grow
+     * logarithmically with depth at 1.
+     *
+     * @param lambda The blend between even and logarithmic splits.
+     */
+    void setSplitLambda(float lambda);
+
+    /**
+     * Sets how far behind each cascade, towards a directional light, casters are drawn.
+     *
+     * @param distance The distance that the views of the light are extended by.
+     */
+    void setCasterDistance(float distance);
+
+    /**
+     * Sets the depth bias that receivers subtract from their depth to avoid shadow acne.
+     *
+     * @param bias The depth bias, in the range of the depth texture.
+     */
+    void setDepthBias(float bias);
+
+    /**
+     * Sets the first cascade that is cached.
+     *
+     * @param cascade The first cached cascade, or a value of at least the cascade count to draw every cascade each update.
+     */
+    void setCachedCascadeStart(unsigned int cascade);
+
+    /**
+     * Returns the first cascade that is cached.
+     *
+     * @return The first cached cascade.
+     */
+    unsigned int getCachedCascadeStart() const;
+
+    /**
+     * Forces the cached cascades to be drawn again by the following updates.
+     */
+    void invalidate();
+
+    /**
+     * Computes the views of the light for the given camera and draws the shadow maps that
+     * need to be drawn. This should be called once per frame, after the casters, the light
+     * and the camera have moved and before the scene is drawn.
+     *
+     * @param camera The camera to draw the shadows for, or NULL to use the active camera of the scene.
+     */
+    void update(Camera* camera = NULL);
+
+    /**
+     * Returns the number of casters that were drawn by the last update.
+     *
+     * @return The number of casters that were drawn.
+     */
+    unsigned int getDrawnCasterCount() const;
+
+    /**
+     * Returns the number of maps that were drawn by the last update.
+     *
+     * @return The number of maps that were drawn.
+     */
+    unsigned int getDrawnMapCount() const;
+
+    /**
+     * Returns the sampler of the depth texture that the maps are drawn into.
+     *
+     * @return The sampler of the shadow map texture.
+     */
+    const Texture::Sampler* getSampler() const;
+
+    /**
+     * Returns the matrices that transform view space positions to the shadow map texture, one per map.
+     *
+     * @return An array of SHADOW_MAX_CASCADES matrices.
+     */
+    const Matrix* getMatrices() const;
+
+    /**
+     * Returns the number of matrices returned by getMatrices.
+     *
+     * @return The number of matrices, which is SHADOW_MAX_CASCADES.
+     */
+    unsigned int getMatrixCount() const;
+
+    /**
+     * Returns the view depths at which each cascade ends.
+     *
+     * @return The far distance of each cascade, padded with the shadow distance.
+     */
+    const Vector4& getCascadeSplits() const;
+
+    /**
+     * Returns the width and height of a texel of the shadow map texture, the depth bias
+     * and the shadow distance.
+     *
+     * @return The shadow parameters.
+     */
+    const Vector4& getParameters() const;
+
+private:
+
+    /**
+     * The view of the light that a shadow map was last drawn with.
+     */
+    struct Cascade
+    {
+        Matrix viewProjection;
+        unsigned int signature;
+        bool valid;
+    };
+
+    /**
+     * Constructor.
+     */
+    ShadowMaps(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~ShadowMaps();
+
+    /**
+     * Hidden copy constructor.
+     */
+    ShadowMaps(const ShadowMaps& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    ShadowMaps& operator=(const ShadowMaps&);
+
+    /**
+     * Returns the number of maps of the light.
+     */
+    unsigned int getMapCount() const;
+
+    /**
+     * Recreates the frame buffer for the current map size and map count.
+     */
+    void resize();
+
+    /**
+     * Computes the views of the cascades of a directional light.
+     */
+    void computeDirectionalViews(Camera* camera, Matrix* views);
+
+    /**
+     * Computes the view of a spot light.
+     */
+    void computeSpotView(Camera* camera, Matrix* view);
+
+    /**
+     * Finds the casters in the given view of the light.
+     */
+    void findCasters(const Frustum& frustum);
+
+    /**
+     * Adds the node to the casters if it has a model that casts shadows in the current view.
+     */
+    bool gatherCaster(Node* node);
+
+    /**
+     * Computes a signature of a view and of the casters found in it.
+     */
+    unsigned int computeSignature(const Matrix& view) const;
+
+    /**
+     * Draws the found casters into a shadow map.
+     */
+    void drawCasters(const Matrix& view, unsigned int index);
+
+    Scene* _scene;
+    Light* _light;
+    unsigned int _cascadeCount;
+    unsigned int _mapSize;
+    float _distance;
+    float _splitLambda;
+    float _casterDistance;
+    float _depthBias;
+    unsigned int _cachedStart;
+    unsigned int _nextCached;
+    unsigned int _drawnCasters;
+    unsigned int _drawnMaps;
+    Cascade _cascades[SHADOW_MAX_CASCADES];
+    Matrix _matrices[SHADOW_MAX_CASCADES];
+    Vector4 _splits;
+    Vector4 _parameters;
+    FrameBuffer* _frameBuffer;
+    Texture::Sampler* _sampler;
+    Effect* _effect;
+    Uniform* _matrixUniform;
+    RenderState::StateBlock* _stateBlock;
+    const Frustum* _casterFrustum;
+    std::vector<Node*> _casters;
+    std::map<Mesh*, VertexAttributeBinding*> _bindings;
+};
+
+}
+
+#endif
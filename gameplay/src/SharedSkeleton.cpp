@@ -0,0 +1,163 @@
+#include "Base.h"
+#include "SharedSkeleton.h"
+#include "AnimationClip.h"
+#include "Material.h"
+#include "MeshSkin.h"
+#include "Model.h"
+
+namespace gameplay
+{
+
+SharedSkeleton::SharedSkeleton(MeshSkin* skin, AnimationClip* clip, unsigned int poseCount)
+    : _skin(skin), _clip(clip), _poseCount(poseCount), _paletteSize(0), _time(0.0f), _sampler(NULL), _texelSize(Vector2::zero())
+{
+    // The skin is owned by its model, so the model is kept alive instead.
+    if (_skin->getModel())
+        _skin->getModel()->addRef();
+    _clip->addRef();
+}
+
+SharedSkeleton::~SharedSkeleton()
+{
+    SAFE_RELEASE(_sampler);
+    SAFE_RELEASE(_clip);
+    Model* model = _skin->getModel();
+    SAFE_RELEASE(model);
+}
+
+SharedSkeleton* SharedSkeleton::create(MeshSkin* skin, AnimationClip* clip, unsigned int poseCount)
+{
+    GP_ASSERT(skin);
+    GP_ASSERT(clip);
+    GP_ASSERT(poseCount > 0);
+
+    SharedSkeleton* skeleton = new SharedSkeleton(skin, clip, poseCount);
+    skeleton->_paletteSize = skin->getMatrixPaletteSize();
+    skeleton->_palettes.resize(poseCount * skeleton->_paletteSize);
+
+    if (isPaletteTextureSupported())
+    {
+        // Every row of the texture holds the palette of one pose, one texel per palette row.
+        Texture* texture = Texture::create(Texture::RGBA32F, skeleton->_paletteSize, poseCount, NULL, false);
+        if (texture)
+        {
+            skeleton->_sampler = Texture::Sampler::create(texture);
+            skeleton->_sampler->setFilterMode(Texture::NEAREST, Texture::NEAREST);
+            skeleton->_sampler->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+            skeleton->_texelSize.set(1.0f / skeleton->_paletteSize, 1.0f / poseCount);
+            SAFE_RELEASE(texture);
+        }
+    }
+    else
+    {
+        GP_WARN("Palette textures are not supported; shared skeleton poses must be bound as uniforms.");
+    }
+
+    skeleton->update(0.0f);
+    return skeleton;
+}
+
+MeshSkin* SharedSkeleton::getSkin() const
+{
+    return _skin;
+}
+
+AnimationClip* SharedSkeleton::getClip() const
+{
+    return _clip;
+}
+
+unsigned int SharedSkeleton::getPoseCount() const
+{
+    return _poseCount;
+}
+
+unsigned int SharedSkeleton::getPose(float timeOffset) const
+{
+    float duration = (float)_clip->getDuration();
+    if (duration <= 0.0f)
+        return 0;
+
+    float offset = fmodf(timeOffset, duration);
+    if (offset < 0.0f)
+        offset += duration;
+    unsigned int pose = (unsigned int)(offset / duration * _poseCount + 0.5f);
+    return pose % _poseCount;
+}
+
+void SharedSkeleton::update(float elapsedTime)
+{
+    float duration = (float)_clip->getDuration();
+    _time += elapsedTime * _clip->getSpeed();
+    if (duration > 0.0f)
+    {
+        _time = fmodf(_time, duration);
+        if (_time < 0.0f)
+            _time += duration;
+    }
+
+    // Each pose applies the clip to the joints of the skin and reads back the palette,
+    // which the skin only recomputes because the joints moved.
+    float step = duration / _poseCount;
+    size_t size = _paletteSize * sizeof(Vector4);
+    for (unsigned int i = 0; i < _poseCount; ++i)
+    {
+        _clip->evaluate(_time + step * i);
+        memcpy(&_palettes[i * _paletteSize], _skin->getMatrixPalette(), size);
+    }
+
+    if (_sampler)
+    {
+        GP_ASSERT(_sampler->getTexture());
+        _sampler->getTexture()->setData((const unsigned char*)&_palettes[0]);
+    }
+}
+
+const Vector4* SharedSkeleton::getMatrixPalette(unsigned int pose) const
+{
+    GP_ASSERT(pose < _poseCount);
+    return &_palettes[pose * _paletteSize];
+}
+
+unsigned int SharedSkeleton::getMatrixPaletteSize() const
+{
+    return _paletteSize;
+}
+
+Texture::Sampler* SharedSkeleton::getPaletteSampler() const
+{
+    return _sampler;
+}
+
+void SharedSkeleton::bind(Material* material)
+{
+    GP_ASSERT(material);
+
+    if (!_sampler)
+    {
+        GP_WARN("Failed to bind shared skeleton palette; palette textures are not supported.");
+        return;
+    }
+    material->getParameter("u_posePalette")->setValue(_sampler);
+    material->getParameter("u_posePaletteTexelSize")->setValue(_texelSize);
+}
+
+bool SharedSkeleton::isPaletteTextureSupported()
+{
+    static int __paletteTextureSupported = -1;
+    if (__paletteTextureSupported == -1)
+    {
+        // Vertex shaders must be able to sample textures, which is optional in OpenGL ES 2.0.
+        GLint vertexTextureUnits = 0;
+        GL_ASSERT( glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vertexTextureUnits) );
+        bool floatTextures = true;
+#if defined(OPENGL_ES) && !defined(GL_ES_VERSION_3_0)
+        const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+        floatTextures = extensions && strstr(extensions, "GL_OES_texture_float");
+#endif
+        __paletteTextureSupported = (vertexTextureUnits > 0 && floatTextures) ? 1 : 0;
+    }
+    return __paletteTextureSupported == 1;
+}
+
+}
@@ -0,0 +1,170 @@
+#ifndef SHAREDSKELETON_H_
+#define SHAREDSKELETON_H_
+
+#include "Ref.h"
+#include "Texture.h"
+#include "Vector2.h"
+#include "Vector4.h"
+
+namespace gameplay
+{
+
+class AnimationClip;
+class Material;
+class MeshSkin;
+
+/**
+ * Defines a set of poses of an animated skeleton that is shared by many instances.
+ *
+ * Every skinned model normally owns its own joint hierarchy, so a crowd playing the
+ * same clip evaluates one skeleton per character. A shared skeleton instead samples
+ * a single skin at a fixed number of time offsets spread evenly over the duration of
+ * a clip, and instances only reference one of these poses. The cost of evaluating
+ * the skeleton therefore depends on the number of poses and not on the number of
+ * instances that are drawn.
+ *
+ * The matrix palette of every pose is stored in a floating point texture with one
+ * row per pose, which allows all instances of a skinned model to be drawn with a
+ * single instanced draw call. The effect must be compiled with SKINNING_POSE_TEXTURE
+ * (in addition to SKINNING and INSTANCING) and reads the pose of each instance from
+ * the a_instancePose attribute, which is set through Model::setInstancePoses.
+ *
+ * The clip must not be played while it is used by a shared skeleton, since every
+ * update applies all of the poses to the joints of the skin in turn. The skin is
+ * usually the skin of the instanced model itself, attached to a node that is not
+ * transformed, since the joint transforms of the poses are relative to the skin.
+ *
+ * @script{ignore}
+ */
+class SharedSkeleton : public Ref
+{
+public:
+
+    /**
+     * Creates a shared skeleton that samples the given clip into a number of poses.
+     *
+     * @param skin The skin whose joints are animated by the clip.
+     * @param clip The clip to sample.
+     * @param poseCount The number of time offset poses to evaluate every update.
+     *
+     * @return The new shared skeleton.
+     */
+    static SharedSkeleton* create(MeshSkin* skin, AnimationClip* clip, unsigned int poseCount);
+
+    /**
+     * Returns the skin that is animated by this shared skeleton.
+     *
+     * @return The skin.
+     */
+    MeshSkin* getSkin() const;
+
+    /**
+     * Returns the clip that is sampled by this shared skeleton.
+     *
+     * @return The clip.
+     */
+    AnimationClip* getClip() const;
+
+    /**
+     * Returns the number of poses that are evaluated every update.
+     *
+     * @return The number of poses.
+     */
+    unsigned int getPoseCount() const;
+
+    /**
+     * Returns the pose that is closest to the given time offset within the clip.
+     *
+     * Instances that should not move in lockstep are usually given a random time
+     * offset, which this method maps to one of the evenly spaced poses.
+     *
+     * @param timeOffset The time offset within the clip, in milliseconds.
+     *
+     * @return The index of the pose.
+     */
+    unsigned int getPose(float timeOffset) const;
+
+    /**
+     * Advances the clip and evaluates every pose.
+     *
+     * @param elapsedTime The elapsed time since the last update, in milliseconds.
+     */
+    void update(float elapsedTime);
+
+    /**
+     * Returns the matrix palette of the given pose, as computed by the last update.
+     *
+     * The palette has the same layout as MeshSkin::getMatrixPalette, so it can also
+     * be bound to u_matrixPalette to draw the instances of one pose on devices that
+     * don't support the palette texture.
+     *
+     * @param pose The index of the pose.
+     *
+     * @return The matrix palette of the pose.
+     */
+    const Vector4* getMatrixPalette(unsigned int pose) const;
+
+    /**
+     * Returns the number of elements in the matrix palette of each pose.
+     *
+     * @return The matrix palette size.
+     */
+    unsigned int getMatrixPaletteSize() const;
+
+    /**
+     * Returns the sampler of the texture that holds the matrix palettes of all poses.
+     *
+     * @return The sampler, or NULL if palette textures are not supported.
+     */
+    Texture::Sampler* getPaletteSampler() const;
+
+    /**
+     * Binds the palette texture to the u_posePalette and u_posePaletteTexelSize
+     * uniforms of the given material.
+     *
+     * @param material The material to bind the palette texture to.
+     */
+    void bind(Material* material);
+
+    /**
+     * Determines if the current device supports sampling the palette texture in vertex shaders.
+     *
+     * @return True if palette textures are supported, false otherwise.
+     */
+    static bool isPaletteTextureSupported();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    SharedSkeleton(MeshSkin* skin, AnimationClip* clip, unsigned int poseCount);
+
+    /**
+     * Destructor.
+     */
+    ~SharedSkeleton();
+
+    /**
+     * Hidden copy constructor.
+     */
+    SharedSkeleton(const SharedSkeleton& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    SharedSkeleton& operator=(const SharedSkeleton&);
+
+    MeshSkin* _skin;
+    AnimationClip* _clip;
+    unsigned int _poseCount;
+    unsigned int _paletteSize;
+    float _time;
+    std::vector<Vector4> _palettes;
+    Texture::Sampler* _sampler;
+    Vector2 _texelSize;
+};
+
+}
+
+#endif
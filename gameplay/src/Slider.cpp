@@ -67,6 +67,7 @@ const char* Slider::getTypeName() const
 void Slider::setMin(float min)
 {
     _min = min;
+    setGeometryDirty();
 }
 
 float Slider::getMin() const
@@ -77,6 +78,7 @@ float Slider::getMin() const
 void Slider::setMax(float max)
 {
     _max = max;
+    setGeometryDirty();
 }
 
 float Slider::getMax() const
@@ -106,6 +108,7 @@ void Slider::setValue(float value)
     if (value != _value)
     {
         _value = value;
+        setGeometryDirty();
         notifyListeners(Control::Listener::VALUE_CHANGED);
     }
 
@@ -123,6 +126,7 @@ void Slider::setValueTextVisible(bool valueTextVisible)
     if (valueTextVisible != _valueTextVisible)
     {
         _valueTextVisible = valueTextVisible;
+        setGeometryDirty();
         if (_autoSize & AUTO_SIZE_HEIGHT)
             setDirty(DIRTY_BOUNDS);
     }
@@ -136,6 +140,7 @@ bool Slider::isValueTextVisible() const
 void Slider::setValueTextAlignment(Font::Justify alignment)
 {
     _valueTextAlignment = alignment;
+    setGeometryDirty();
 }
 
 Font::Justify Slider::getValueTextAlignment() const
@@ -146,6 +151,7 @@ Font::Justify Slider::getValueTextAlignment() const
 void Slider::setValueTextPrecision(unsigned int precision)
 {
     _valueTextPrecision = precision;
+    setGeometryDirty();
 }
 
 unsigned int Slider::getValueTextPrecision() const
@@ -0,0 +1,467 @@
+#include "Base.h"
+#include "SpatialIndex.h"
+#include "Scene.h"
+#include "Node.h"
+#include "OcclusionBuffer.h"
+
+// The maximum depth of the octree below the root cell.
+#define SPATIAL_INDEX_MAX_DEPTH 8
+
+// The minimum number of nodes outside of the octree before it is resized.
+#define SPATIAL_INDEX_RESIZE_THRESHOLD 16
+
+namespace gameplay
+{
+
+SpatialIndex::Cell::Cell(Cell* parent, const Vector3& center, float halfSize)
+    : parent(parent), center(center), halfSize(halfSize), count(0)
+{
+    memset(children, 0, sizeof(children));
+
+    // Loose cells extend half their size past their tight bounds on every side.
+    float looseSize = halfSize * 2.0f;
+    looseBounds.set(center.x - looseSize, center.y - looseSize, center.z - looseSize,
+                    center.x + looseSize, center.y + looseSize, center.z + looseSize);
+}
+
+SpatialIndex::Cell::~Cell()
+{
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        SAFE_DELETE(children[i]);
+    }
+}
+
+SpatialIndex::SpatialIndex(Scene* scene)
+    : _scene(scene), _root(NULL), _nodeCount(0), _outsideCount(0)
+{
+    GP_ASSERT(_scene);
+
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        add(node);
+    }
+}
+
+SpatialIndex::~SpatialIndex()
+{
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        remove(node);
+    }
+    SAFE_DELETE(_root);
+}
+
+unsigned int SpatialIndex::getNodeCount() const
+{
+    return _nodeCount;
+}
+
+const BoundingBox& SpatialIndex::getBounds() const
+{
+    return _root ? _root->looseBounds : BoundingBox::empty();
+}
+
+void SpatialIndex::update()
+{
+    if (_dirtyEntries.empty())
+        return;
+
+    // Entries may be queued more than once or freed after being queued, so only
+    // entries that are still flagged dirty are processed.
+    for (size_t i = 0, count = _dirtyEntries.size(); i < count; ++i)
+    {
+        int index = _dirtyEntries[i];
+        Entry& entry = _entries[index];
+        if (!entry.dirty)
+            continue;
+        entry.dirty = false;
+
+        Node* node = entry.node;
+        GP_ASSERT(node);
+        if (node->_drawable == NULL && node->_light == NULL)
+        {
+            // The node no longer has anything worth indexing.
+            removeEntry(index);
+            continue;
+        }
+
+        if (entry.cell)
+            unlink(index);
+        entry.bounds = node->getBoundingSphere();
+        insert(index);
+    }
+    _dirtyEntries.clear();
+
+    if (_outsideCount > SPATIAL_INDEX_RESIZE_THRESHOLD && _outsideCount > _nodeCount / 4)
+    {
+        resize();
+    }
+}
+
+unsigned int SpatialIndex::findNodes(const Frustum& frustum, std::vector<Node*>& nodes)
+{
+    update();
+    size_t count = nodes.size();
+    if (_root)
+    {
+        findEntries(_root, frustum, NULL);
+        cullEntries(frustum, NULL, nodes);
+    }
+    return (unsigned int)(nodes.size() - count);
+}
+
+unsigned int SpatialIndex::findNodes(const Frustum& frustum, const OcclusionBuffer& occlusion, std::vector<Node*>& nodes)
+{
+    update();
+    size_t count = nodes.size();
+    if (_root)
+    {
+        findEntries(_root, frustum, &occlusion);
+        cullEntries(frustum, &occlusion, nodes);
+    }
+    return (unsigned int)(nodes.size() - count);
+}
+
+unsigned int SpatialIndex::findNodes(const BoundingSphere& sphere, std::vector<Node*>& nodes)
+{
+    update();
+    size_t count = nodes.size();
+    if (_root)
+        findNodes(_root, sphere, nodes);
+    return (unsigned int)(nodes.size() - count);
+}
+
+unsigned int SpatialIndex::findNodes(const BoundingBox& box, std::vector<Node*>& nodes)
+{
+    update();
+    size_t count = nodes.size();
+    if (_root)
+        findNodes(_root, box, nodes);
+    return (unsigned int)(nodes.size() - count);
+}
+
+unsigned int SpatialIndex::findNodes(const Ray& ray, std::vector<Node*>& nodes, float maxDistance)
+{
+    update();
+    size_t count = nodes.size();
+    if (_root)
+        findNodes(_root, ray, nodes, maxDistance);
+    return (unsigned int)(nodes.size() - count);
+}
+
+template <class T>
+void SpatialIndex::findNodes(Cell* cell, const T& volume, std::vector<Node*>& nodes) const
+{
+    // The root cell may hold nodes outside of its bounds, so it is never culled.
+    if (cell != _root && !cell->looseBounds.intersects(volume))
+        return;
+
+    for (size_t i = 0, count = cell->entries.size(); i < count; ++i)
+    {
+        const Entry& entry = _entries[cell->entries[i]];
+        if (entry.bounds.intersects(volume))
+            nodes.push_back(entry.node);
+    }
+
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        if (cell->children[i])
+            findNodes(cell->children[i], volume, nodes);
+    }
+}
+
+void SpatialIndex::findNodes(Cell* cell, const Ray& ray, std::vector<Node*>& nodes, float maxDistance) const
+{
+    if (cell != _root)
+    {
+        float distance = cell->looseBounds.intersects(ray);
+        if (distance == Ray::INTERSECTS_NONE || distance > maxDistance)
+            return;
+    }
+
+    for (size_t i = 0, count = cell->entries.size(); i < count; ++i)
+    {
+        const Entry& entry = _entries[cell->entries[i]];
+        float distance = entry.bounds.intersects(ray);
+        if (distance != Ray::INTERSECTS_NONE && distance <= maxDistance)
+            nodes.push_back(entry.node);
+    }
+
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        if (cell->children[i])
+            findNodes(cell->children[i], ray, nodes, maxDistance);
+    }
+}
+
+void SpatialIndex::findEntries(Cell* cell, const Frustum& frustum, const OcclusionBuffer* occlusion)
+{
+    if (cell != _root && (!cell->looseBounds.intersects(frustum) || (occlusion && !occlusion->isVisible(cell->looseBounds))))
+        return;
+
+    _cullEntries.insert(_cullEntries.end(), cell->entries.begin(), cell->entries.end());
+
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        if (cell->children[i])
+            findEntries(cell->children[i], frustum, occlusion);
+    }
+}
+
+void SpatialIndex::cullEntries(const Frustum& frustum, const OcclusionBuffer* occlusion, std::vector<Node*>& nodes)
+{
+    unsigned int count = (unsigned int)_cullEntries.size();
+    if (count == 0)
+        return;
+
+    // The bounds and plane caches of the entries are gathered so that they are culled together.
+    _cullBounds.resize(count);
+    _cullPlanes.resize(count);
+    _cullVisibility.resize((count + 31) / 32);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        const Entry& entry = _entries[_cullEntries[i]];
+        _cullBounds[i] = entry.bounds;
+        _cullPlanes[i] = entry.cullPlane;
+    }
+
+    frustum.cull(&_cullBounds[0], count, &_cullVisibility[0], &_cullPlanes[0]);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        Entry& entry = _entries[_cullEntries[i]];
+        entry.cullPlane = _cullPlanes[i];
+        if ((_cullVisibility[i >> 5] & (1u << (i & 31))) && (!occlusion || occlusion->isVisible(entry.bounds)))
+            nodes.push_back(entry.node);
+    }
+    _cullEntries.clear();
+}
+
+void SpatialIndex::add(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->_spatialIndex == this)
+        return;
+    GP_ASSERT(node->_spatialIndex == NULL);
+
+    node->_spatialIndex = this;
+    node->_spatialIndexEntry = -1;
+    setDirty(node);
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        add(child);
+    }
+}
+
+void SpatialIndex::remove(Node* node)
+{
+    GP_ASSERT(node);
+
+    if (node->_spatialIndex != this)
+        return;
+
+    if (node->_spatialIndexEntry >= 0)
+        removeEntry(node->_spatialIndexEntry);
+    node->_spatialIndex = NULL;
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        remove(child);
+    }
+}
+
+void SpatialIndex::setDirty(Node* node)
+{
+    GP_ASSERT(node && node->_spatialIndex == this);
+
+    int index = node->_spatialIndexEntry;
+    if (index < 0)
+    {
+        // Only nodes with something to cull or query for are stored.
+        if (node->_drawable == NULL && node->_light == NULL)
+            return;
+
+        if (_freeEntries.empty())
+        {
+            index = (int)_entries.size();
+            _entries.push_back(Entry());
+        }
+        else
+        {
+            index = _freeEntries.back();
+            _freeEntries.pop_back();
+        }
+
+        Entry& entry = _entries[index];
+        entry.node = node;
+        entry.cell = NULL;
+        entry.slot = 0;
+        entry.dirty = false;
+        entry.cullPlane = 0;
+        node->_spatialIndexEntry = index;
+        ++_nodeCount;
+    }
+
+    Entry& entry = _entries[index];
+    if (!entry.dirty)
+    {
+        entry.dirty = true;
+        _dirtyEntries.push_back(index);
+    }
+}
+
+void SpatialIndex::removeEntry(int index)
+{
+    Entry& entry = _entries[index];
+    if (entry.cell)
+        unlink(index);
+
+    entry.node->_spatialIndexEntry = -1;
+    entry.node = NULL;
+    entry.dirty = false;
+    _freeEntries.push_back(index);
+    --_nodeCount;
+}
+
+void SpatialIndex::insert(int index)
+{
+    Entry& entry = _entries[index];
+    GP_ASSERT(entry.cell == NULL);
+
+    if (_root == NULL)
+    {
+        // Start with a cell that comfortably holds the first entry.
+        _root = new Cell(NULL, entry.bounds.center, max(entry.bounds.radius * 4.0f, 1.0f));
+    }
+
+    const Vector3& center = entry.bounds.center;
+    float radius = entry.bounds.radius;
+
+    Cell* cell = _root;
+    if (fabs(center.x - cell->center.x) > cell->halfSize ||
+        fabs(center.y - cell->center.y) > cell->halfSize ||
+        fabs(center.z - cell->center.z) > cell->halfSize ||
+        radius > cell->halfSize)
+    {
+        // The entry doesn't fit into the octree, so it stays in the root cell.
+        ++_outsideCount;
+    }
+    else
+    {
+        // Descend into the octant containing the center of the entry for as long as
+        // the loose bounds of the child cell are still guaranteed to contain it.
+        for (unsigned int depth = 0; depth < SPATIAL_INDEX_MAX_DEPTH; ++depth)
+        {
+            float childHalfSize = cell->halfSize * 0.5f;
+            if (radius > childHalfSize)
+                break;
+
+            unsigned int octant = (center.x >= cell->center.x ? 1 : 0) |
+                                  (center.y >= cell->center.y ? 2 : 0) |
+                                  (center.z >= cell->center.z ? 4 : 0);
+            if (cell->children[octant] == NULL)
+            {
+                Vector3 childCenter(cell->center.x + ((octant & 1) ? childHalfSize : -childHalfSize),
+                                    cell->center.y + ((octant & 2) ? childHalfSize : -childHalfSize),
+                                    cell->center.z + ((octant & 4) ? childHalfSize : -childHalfSize));
+                cell->children[octant] = new Cell(cell, childCenter, childHalfSize);
+            }
+            cell = cell->children[octant];
+        }
+    }
+
+    entry.cell = cell;
+    entry.slot = (unsigned int)cell->entries.size();
+    cell->entries.push_back(index);
+    for (Cell* c = cell; c != NULL; c = c->parent)
+    {
+        ++c->count;
+    }
+}
+
+void SpatialIndex::unlink(int index)
+{
+    Entry& entry = _entries[index];
+    Cell* cell = entry.cell;
+    GP_ASSERT(cell);
+
+    // Swap the last entry of the cell into our slot.
+    int last = cell->entries.back();
+    cell->entries[entry.slot] = last;
+    _entries[last].slot = entry.slot;
+    cell->entries.pop_back();
+    entry.cell = NULL;
+
+    if (cell == _root && _outsideCount > 0)
+    {
+        const Vector3& center = entry.bounds.center;
+        if (fabs(center.x - cell->center.x) > cell->halfSize ||
+            fabs(center.y - cell->center.y) > cell->halfSize ||
+            fabs(center.z - cell->center.z) > cell->halfSize ||
+            entry.bounds.radius > cell->halfSize)
+        {
+            --_outsideCount;
+        }
+    }
+
+    // Update the entry counts and release cells that no longer hold any entries.
+    // A cell without entries has already released all of its children.
+    Cell* c = cell;
+    while (c)
+    {
+        --c->count;
+        Cell* parent = c->parent;
+        if (c->count == 0 && parent)
+        {
+            for (unsigned int i = 0; i < 8; ++i)
+            {
+                if (parent->children[i] == c)
+                    parent->children[i] = NULL;
+            }
+            SAFE_DELETE(c);
+        }
+        c = parent;
+    }
+}
+
+void SpatialIndex::resize()
+{
+    BoundingBox bounds;
+    bool empty = true;
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        Entry& entry = _entries[i];
+        if (entry.node == NULL)
+            continue;
+        if (empty)
+        {
+            bounds.set(entry.bounds);
+            empty = false;
+        }
+        else
+        {
+            bounds.merge(entry.bounds);
+        }
+        entry.cell = NULL;
+    }
+    SAFE_DELETE(_root);
+    _outsideCount = 0;
+    if (empty)
+        return;
+
+    // Use a cube that encloses all entries.
+    Vector3 size = bounds.max - bounds.min;
+    float halfSize = max(max(size.x, max(size.y, size.z)) * 0.5f, 1.0f);
+    _root = new Cell(NULL, bounds.getCenter(), halfSize);
+
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        if (_entries[i].node)
+            insert((int)i);
+    }
+}
+
+}
@@ -0,0 +1,238 @@
+#ifndef SPATIALINDEX_H_
+#define SPATIALINDEX_H_
+
+#include "BoundingBox.h"
+#include "BoundingSphere.h"
+#include "Frustum.h"
+#include "Ray.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+class OcclusionBuffer;
+
+/**
+ * Defines a loose octree that indexes the nodes of a scene by their bounding volume.
+ *
+ * Every node in the scene that has a drawable or a light attached is stored in the
+ * smallest octree cell that can hold its bounding sphere, where each cell is allowed
+ * to overlap its neighbours by half its size. This allows frustum, sphere, box and
+ * ray queries to skip entire regions of the scene instead of testing every node.
+ *
+ * The index is kept up to date incrementally: node bounds that become dirty are
+ * queued and re-inserted the next time the index is updated, which happens once
+ * per frame in Scene::updateTransforms() and before every query.
+ *
+ * The octree resizes itself to fit the contents of the scene whenever too many
+ * nodes fall outside of its current bounds.
+ *
+ * Note that queries return nodes regardless of whether they are enabled.
+ *
+ * @see Scene::setSpatialIndexEnabled
+ * @script{ignore}
+ */
+class SpatialIndex
+{
+    friend class Scene;
+    friend class Node;
+
+public:
+
+    /**
+     * Returns the number of nodes stored in the index.
+     *
+     * @return The number of indexed nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Returns the bounds of the root cell of the octree.
+     *
+     * @return The bounds of the octree.
+     */
+    const BoundingBox& getBounds() const;
+
+    /**
+     * Re-inserts all nodes whose bounds changed since the last update.
+     */
+    void update();
+
+    /**
+     * Finds all nodes whose bounding sphere intersects the given frustum.
+     *
+     * @param frustum The frustum to test against.
+     * @param nodes Vector of nodes to be populated with matches.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodes(const Frustum& frustum, std::vector<Node*>& nodes);
+
+    /**
+     * Finds all nodes whose bounding sphere intersects the given frustum and is not
+     * hidden by the occluders of the given occlusion buffer.
+     *
+     * Cells whose loose bounds are hidden are skipped along with all of their nodes
+     * and children. The occlusion buffer must have been rasterized for the camera
+     * of the frustum.
+     *
+     * @param frustum The frustum to test against.
+     * @param occlusion The occlusion buffer to test against.
+     * @param nodes Vector of nodes to be populated with matches.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodes(const Frustum& frustum, const OcclusionBuffer& occlusion, std::vector<Node*>& nodes);
+
+    /**
+     * Finds all nodes whose bounding sphere intersects the given sphere.
+     *
+     * @param sphere The sphere to test against.
+     * @param nodes Vector of nodes to be populated with matches.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodes(const BoundingSphere& sphere, std::vector<Node*>& nodes);
+
+    /**
+     * Finds all nodes whose bounding sphere intersects the given box.
+     *
+     * @param box The box to test against.
+     * @param nodes Vector of nodes to be populated with matches.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodes(const BoundingBox& box, std::vector<Node*>& nodes);
+
+    /**
+     * Finds all nodes whose bounding sphere is hit by the given ray.
+     *
+     * @param ray The ray to test against.
+     * @param nodes Vector of nodes to be populated with matches.
+     * @param maxDistance The maximum distance along the ray to consider.
+     *
+     * @return The number of matches found.
+     */
+    unsigned int findNodes(const Ray& ray, std::vector<Node*>& nodes, float maxDistance = FLT_MAX);
+
+private:
+
+    /**
+     * A cell of the octree.
+     */
+    struct Cell
+    {
+        Cell(Cell* parent, const Vector3& center, float halfSize);
+        ~Cell();
+
+        Cell* parent;
+        Cell* children[8];
+        Vector3 center;
+        float halfSize;
+        BoundingBox looseBounds;
+        std::vector<int> entries;
+        unsigned int count;
+    };
+
+    /**
+     * A node stored in the octree.
+     */
+    struct Entry
+    {
+        Node* node;
+        BoundingSphere bounds;
+        Cell* cell;
+        unsigned int slot;
+        bool dirty;
+        unsigned char cullPlane;
+    };
+
+    /**
+     * Constructor.
+     */
+    SpatialIndex(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~SpatialIndex();
+
+    /**
+     * Hidden copy constructor.
+     */
+    SpatialIndex(const SpatialIndex& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    SpatialIndex& operator=(const SpatialIndex&);
+
+    /**
+     * Attaches the given node and all of its descendants to the index.
+     */
+    void add(Node* node);
+
+    /**
+     * Detaches the given node and all of its descendants from the index.
+     */
+    void remove(Node* node);
+
+    /**
+     * Queues the given node for re-insertion on the next update.
+     */
+    void setDirty(Node* node);
+
+    /**
+     * Removes the entry with the given index from the octree and frees it.
+     */
+    void removeEntry(int index);
+
+    /**
+     * Inserts the entry with the given index into the smallest cell that can hold it.
+     */
+    void insert(int index);
+
+    /**
+     * Removes the entry with the given index from the cell it is stored in.
+     */
+    void unlink(int index);
+
+    /**
+     * Recreates the octree so that it encloses all entries.
+     */
+    void resize();
+
+    template <class T>
+    void findNodes(Cell* cell, const T& volume, std::vector<Node*>& nodes) const;
+
+    void findNodes(Cell* cell, const Ray& ray, std::vector<Node*>& nodes, float maxDistance) const;
+
+    /**
+     * Collects the entries of the cells that intersect the frustum, and are not hidden
+     * by the occlusion buffer if one is given, to be culled by cullEntries.
+     */
+    void findEntries(Cell* cell, const Frustum& frustum, const OcclusionBuffer* occlusion);
+
+    /**
+     * Culls the collected entries against the frustum as a batch, and adds the nodes of
+     * those that intersect it, and are not hidden by the occlusion buffer if one is given.
+     */
+    void cullEntries(const Frustum& frustum, const OcclusionBuffer* occlusion, std::vector<Node*>& nodes);
+
+    Scene* _scene;
+    Cell* _root;
+    std::vector<Entry> _entries;
+    std::vector<int> _freeEntries;
+    std::vector<int> _dirtyEntries;
+    unsigned int _nodeCount;
+    unsigned int _outsideCount;
+    std::vector<int> _cullEntries;
+    std::vector<BoundingSphere> _cullBounds;
+    std::vector<unsigned char> _cullPlanes;
+    std::vector<unsigned int> _cullVisibility;
+};
+
+}
+
+#endif
@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "Sprite.h"
 #include "Scene.h"
+#include "TextureAtlas.h"
 
 namespace gameplay
 {
@@ -36,14 +37,27 @@ Sprite* Sprite::create(const char* imagePath, float width, float height,
     GP_ASSERT(source.width >= -1 && source.height >= -1);
     GP_ASSERT(frameCount > 0);
     
-    SpriteBatch* batch = SpriteBatch::create(imagePath, effect);
+    // Images packed into an atlas are drawn from their page, which the sprites, tile sets
+    // and controls of the atlas share instead of each loading their own texture.
+    TextureAtlas::Region region;
+    TextureAtlas* atlas = TextureAtlas::find(imagePath, &region);
+    SpriteBatch* batch;
+    if (atlas)
+    {
+        batch = SpriteBatch::create(atlas->getPage(region.page), effect);
+    }
+    else
+    {
+        batch = SpriteBatch::create(imagePath, effect);
+        region.bounds.set(0, 0, batch->getSampler()->getTexture()->getWidth(), batch->getSampler()->getTexture()->getHeight());
+    }
     batch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
     batch->getSampler()->setFilterMode(Texture::Filter::LINEAR, Texture::Filter::LINEAR);
     batch->getStateBlock()->setDepthWrite(false);
     batch->getStateBlock()->setDepthTest(true);
     
-    unsigned int imageWidth = batch->getSampler()->getTexture()->getWidth();
-    unsigned int imageHeight = batch->getSampler()->getTexture()->getHeight();
+    unsigned int imageWidth = (unsigned int)region.bounds.width;
+    unsigned int imageHeight = (unsigned int)region.bounds.height;
     if (width == -1)
         width = imageWidth;
     if (height == -1)
@@ -53,6 +67,7 @@ Sprite* Sprite::create(const char* imagePath, float width, float height,
     sprite->_width = width;
     sprite->_height = height;
     sprite->_batch = batch;
+    sprite->_imageBounds = region.bounds;
     sprite->_frameCount = frameCount;
     sprite->_frames = new Rectangle[frameCount];
     sprite->_frames[0] = source;
@@ -273,8 +288,9 @@ Sprite* Sprite::create(Properties* properties)
     if (properties->exists("source"))
     {
         // Get source frame
-        Rectangle source;
-        properties->getVector4("source", (Vector4*)&source);
+        Vector4 frame;
+        properties->getVector4("source", &frame);
+        Rectangle source(frame.x, frame.y, frame.z, frame.w);
 
         // Get frame count
         int frameCount = properties->getInt("frameCount");
@@ -429,8 +445,8 @@ void Sprite::computeFrames(unsigned int frameStride, unsigned int framePadding)
     
     if (_frameCount < 2)
         return;
-    unsigned int imageWidth = _batch->getSampler()->getTexture()->getWidth();
-    unsigned int imageHeight = _batch->getSampler()->getTexture()->getHeight();
+    unsigned int imageWidth = (unsigned int)_imageBounds.width;
+    unsigned int imageHeight = (unsigned int)_imageBounds.height;
     float textureWidthRatio = 1.0f / imageWidth;
     float textureHeightRatio = 1.0f / imageHeight;
     
@@ -636,9 +652,14 @@ unsigned int Sprite::draw(bool wireframe)
         scale.y = -scale.y;
     }
     
+    // Frames are relative to the image, wherever it is in its texture.
+    Rectangle source(_frames[_frameIndex]);
+    source.x += _imageBounds.x;
+    source.y += _imageBounds.y;
+
     // TODO: Proper batching from cache based on batching rules (image, layers, etc)
     _batch->start();
-    _batch->draw(position, _frames[_frameIndex], scale, Vector4(_color.x, _color.y, _color.z, _color.w * _opacity),
+    _batch->draw(position, source, scale, Vector4(_color.x, _color.y, _color.z, _color.w * _opacity),
                  _anchor, rotationAngle);
     _batch->finish();
     
@@ -678,6 +699,7 @@ Drawable* Sprite::clone(NodeCloneContext& context)
     spriteClone->_framePadding = _framePadding;
     spriteClone->_frameIndex = _frameIndex;
     spriteClone->_batch = _batch;
+    spriteClone->_imageBounds = _imageBounds;
 
     return spriteClone;
 }
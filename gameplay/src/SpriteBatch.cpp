@@ -19,31 +19,126 @@
 #define SPRITE_VSH "res/shaders/sprite.vert"
 #define SPRITE_FSH "res/shaders/sprite.frag"
 
+// The number of sprites added to the batch at once when drawing many sprites
+#define SPRITE_INSTANCE_CHUNK 1024
+
+// The number of vertices that 16-bit indices can address
+#define SPRITE_MAX_VERTICES 65536
+
+// The corners of sprites are computed four at a time with the vector instructions of the target.
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define SPRITE_USE_SSE
+#elif defined(GP_USE_NEON) || defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SPRITE_USE_NEON
+#endif
+
 namespace gameplay
 {
 
 static Effect* __spriteEffect = NULL;
 
+// The number of sprite batches that hold a reference to the default sprite effect. Its reference
+// count doesn't tell, since the effect cache may also hold one.
+static unsigned int __spriteEffectUsers = 0;
+
+// The depth of nested merging, and the batch whose draw the sprites of other batches are merged into.
+static int __merging = 0;
+static SpriteBatch* __pendingBatch = NULL;
+
+#if defined(SPRITE_USE_SSE)
+
+typedef __m128 SpriteLanes;
+typedef __m128 SpriteMask;
+
+static inline SpriteLanes lanesSet(float a, float b, float c, float d) { return _mm_setr_ps(a, b, c, d); }
+static inline SpriteLanes lanesSplat(float a) { return _mm_set1_ps(a); }
+static inline SpriteLanes lanesAdd(SpriteLanes a, SpriteLanes b) { return _mm_add_ps(a, b); }
+static inline SpriteLanes lanesSub(SpriteLanes a, SpriteLanes b) { return _mm_sub_ps(a, b); }
+static inline SpriteLanes lanesMul(SpriteLanes a, SpriteLanes b) { return _mm_mul_ps(a, b); }
+static inline SpriteLanes lanesMin(SpriteLanes a, SpriteLanes b) { return _mm_min_ps(a, b); }
+static inline SpriteLanes lanesMax(SpriteLanes a, SpriteLanes b) { return _mm_max_ps(a, b); }
+static inline SpriteMask lanesLessEqual(SpriteLanes a, SpriteLanes b) { return _mm_cmple_ps(a, b); }
+static inline SpriteMask lanesNotEqual(SpriteLanes a, SpriteLanes b) { return _mm_cmpneq_ps(a, b); }
+static inline SpriteMask maskAnd(SpriteMask a, SpriteMask b) { return _mm_and_ps(a, b); }
+static inline SpriteLanes lanesSelect(SpriteMask mask, SpriteLanes a, SpriteLanes b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline void lanesStore(float* out, SpriteLanes a) { _mm_storeu_ps(out, a); }
+static inline int maskBits(SpriteMask mask) { return _mm_movemask_ps(mask); }
+
+#elif defined(SPRITE_USE_NEON)
+
+typedef float32x4_t SpriteLanes;
+typedef uint32x4_t SpriteMask;
+
+static inline SpriteLanes lanesSet(float a, float b, float c, float d) { const float v[4] = { a, b, c, d }; return vld1q_f32(v); }
+static inline SpriteLanes lanesSplat(float a) { return vdupq_n_f32(a); }
+static inline SpriteLanes lanesAdd(SpriteLanes a, SpriteLanes b) { return vaddq_f32(a, b); }
+static inline SpriteLanes lanesSub(SpriteLanes a, SpriteLanes b) { return vsubq_f32(a, b); }
+static inline SpriteLanes lanesMul(SpriteLanes a, SpriteLanes b) { return vmulq_f32(a, b); }
+static inline SpriteLanes lanesMin(SpriteLanes a, SpriteLanes b) { return vminq_f32(a, b); }
+static inline SpriteLanes lanesMax(SpriteLanes a, SpriteLanes b) { return vmaxq_f32(a, b); }
+static inline SpriteMask lanesLessEqual(SpriteLanes a, SpriteLanes b) { return vcleq_f32(a, b); }
+static inline SpriteMask lanesNotEqual(SpriteLanes a, SpriteLanes b) { return vmvnq_u32(vceqq_f32(a, b)); }
+static inline SpriteMask maskAnd(SpriteMask a, SpriteMask b) { return vandq_u32(a, b); }
+static inline SpriteLanes lanesSelect(SpriteMask mask, SpriteLanes a, SpriteLanes b) { return vbslq_f32(mask, a, b); }
+static inline void lanesStore(float* out, SpriteLanes a) { vst1q_f32(out, a); }
+static inline int maskBits(SpriteMask mask)
+{
+    unsigned int m[4];
+    vst1q_u32(m, mask);
+    return (m[0] & 1) | (m[1] & 2) | (m[2] & 4) | (m[3] & 8);
+}
+
+#else
+
+struct SpriteLanes { float v[4]; };
+typedef int SpriteMask;
+
+static inline SpriteLanes lanesSet(float a, float b, float c, float d) { SpriteLanes r = { { a, b, c, d } }; return r; }
+static inline SpriteLanes lanesSplat(float a) { return lanesSet(a, a, a, a); }
+static inline SpriteLanes lanesAdd(SpriteLanes a, SpriteLanes b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+static inline SpriteLanes lanesSub(SpriteLanes a, SpriteLanes b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+static inline SpriteLanes lanesMul(SpriteLanes a, SpriteLanes b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+static inline SpriteLanes lanesMin(SpriteLanes a, SpriteLanes b) { for (int i = 0; i < 4; ++i) a.v[i] = std::min(a.v[i], b.v[i]); return a; }
+static inline SpriteLanes lanesMax(SpriteLanes a, SpriteLanes b) { for (int i = 0; i < 4; ++i) a.v[i] = std::max(a.v[i], b.v[i]); return a; }
+static inline SpriteMask lanesLessEqual(SpriteLanes a, SpriteLanes b) { int m = 0; for (int i = 0; i < 4; ++i) m |= (a.v[i] <= b.v[i]) << i; return m; }
+static inline SpriteMask lanesNotEqual(SpriteLanes a, SpriteLanes b) { int m = 0; for (int i = 0; i < 4; ++i) m |= (a.v[i] != b.v[i]) << i; return m; }
+static inline SpriteMask maskAnd(SpriteMask a, SpriteMask b) { return a & b; }
+static inline SpriteLanes lanesSelect(SpriteMask mask, SpriteLanes a, SpriteLanes b) { for (int i = 0; i < 4; ++i) if (!(mask & (1 << i))) a.v[i] = b.v[i]; return a; }
+static inline void lanesStore(float* out, SpriteLanes a) { memcpy(out, a.v, sizeof(a.v)); }
+static inline int maskBits(SpriteMask mask) { return mask; }
+
+#endif
+
+static void releaseSpriteEffect()
+{
+    GP_ASSERT(__spriteEffect && __spriteEffectUsers > 0);
+    if (--__spriteEffectUsers == 0)
+    {
+        SAFE_RELEASE(__spriteEffect);
+    }
+    else
+    {
+        __spriteEffect->release();
+    }
+}
+
 SpriteBatch::SpriteBatch()
-    : _batch(NULL), _sampler(NULL), _textureWidthRatio(0.0f), _textureHeightRatio(0.0f)
+    : _batch(NULL), _sampler(NULL), _textureWidthRatio(0.0f), _textureHeightRatio(0.0f), _merged(NULL), _started(false)
 {
 }
 
 SpriteBatch::~SpriteBatch()
 {
+    if (__pendingBatch == this)
+        flushMerged();
+
     SAFE_DELETE(_batch);
     SAFE_RELEASE(_sampler);
     if (!_customEffect)
     {
-        if (__spriteEffect && __spriteEffect->getRefCount() == 1)
-        {
-            __spriteEffect->release();
-            __spriteEffect = NULL;
-        }
-        else
-        {
-            __spriteEffect->release();
-        }
+        releaseSpriteEffect();
     }
 }
 
@@ -79,6 +174,7 @@ SpriteBatch* SpriteBatch::create(Texture* texture,  Effect* effect, unsigned int
             effect = __spriteEffect;
             __spriteEffect->addRef();
         }
+        ++__spriteEffectUsers;
     }
 
     // Search for the first sampler uniform in the effect.
@@ -95,7 +191,14 @@ SpriteBatch* SpriteBatch::create(Texture* texture,  Effect* effect, unsigned int
     if (!samplerUniform)
     {
         GP_ERROR("No uniform of type GL_SAMPLER_2D found in sprite effect.");
-        SAFE_RELEASE(effect);
+        if (customEffect)
+        {
+            SAFE_RELEASE(effect);
+        }
+        else
+        {
+            releaseSpriteEffect();
+        }
         return NULL;
     }
 
@@ -142,12 +245,30 @@ SpriteBatch* SpriteBatch::create(Texture* texture,  Effect* effect, unsigned int
 
 void SpriteBatch::start()
 {
+    _started = true;
+    if (__merging == 0)
+    {
+        _batch->start();
+        return;
+    }
+
+    // While merging, the sprites of the batch are added to the pending draw if they can
+    // share it, and otherwise the pending draw is issued and this batch takes its place.
+    if (__pendingBatch == this)
+        return;
+    if (__pendingBatch && canMerge(__pendingBatch))
+    {
+        _merged = __pendingBatch;
+        return;
+    }
+    flushMerged();
     _batch->start();
+    __pendingBatch = this;
 }
 
 bool SpriteBatch::isStarted() const
 {
-    return _batch->isStarted();
+    return _started;
 }
 
 void SpriteBatch::draw(const Rectangle& dst, const Rectangle& src, const Vector4& color)
@@ -232,7 +353,7 @@ void SpriteBatch::draw(float x, float y, float z, float width, float height, flo
     
     static unsigned short indices[4] = { 0, 1, 2, 3 };
 
-    _batch->add(v, 4, indices, 4);
+    addVertices(v, 4, indices, 4);
 }
 
 void SpriteBatch::draw(const Vector3& position, const Vector3& right, const Vector3& forward, float width, float height,
@@ -297,7 +418,7 @@ void SpriteBatch::draw(const Vector3& position, const Vector3& right, const Vect
     SPRITE_ADD_VERTEX(v[3], p3.x, p3.y, p3.z, u2, v2, color.x, color.y, color.z, color.w);
     
     static const unsigned short indices[4] = { 0, 1, 2, 3 };
-    _batch->add(v, 4, const_cast<unsigned short*>(indices), 4);
+    addVertices(v, 4, indices, 4);
 }
 
 void SpriteBatch::draw(float x, float y, float width, float height, float u1, float v1, float u2, float v2, const Vector4& color)
@@ -352,7 +473,7 @@ void SpriteBatch::draw(SpriteBatch::SpriteVertex* vertices, unsigned int vertexC
     GP_ASSERT(vertices);
     GP_ASSERT(indices);
 
-    _batch->add(vertices, vertexCount, indices, indexCount);
+    addVertices(vertices, vertexCount, indices, indexCount);
 }
 
 void SpriteBatch::draw(float x, float y, float z, float width, float height, float u1, float v1, float u2, float v2, const Vector4& color, bool positionIsCenter)
@@ -375,16 +496,114 @@ void SpriteBatch::draw(float x, float y, float z, float width, float height, flo
 
     static unsigned short indices[4] = { 0, 1, 2, 3 };
 
-    _batch->add(v, 4, indices, 4);
+    addVertices(v, 4, indices, 4);
+}
+
+SpriteBatch::SpriteInstance::SpriteInstance()
+    : x(0), y(0), z(0), width(0), height(0), u1(0), v1(0), u2(1), v2(1), color(Vector4::one()), rotationPoint(0.5f, 0.5f), rotationAngle(0)
+{
+}
+
+void SpriteBatch::draw(const SpriteInstance* sprites, unsigned int count, bool positionIsCenter)
+{
+    addSprites(sprites, count, NULL, positionIsCenter);
+}
+
+void SpriteBatch::draw(const SpriteInstance* sprites, unsigned int count, const Rectangle& clip, bool positionIsCenter)
+{
+    addSprites(sprites, count, &clip, positionIsCenter);
 }
 
 void SpriteBatch::finish()
 {
+    GP_PROFILE("SpriteBatch::finish");
+
+    // Merged sprites are drawn by the pending draw.
+    _started = false;
+    if (_merged)
+    {
+        _merged = NULL;
+        return;
+    }
+    if (__pendingBatch == this)
+        return;
+
     // Finish and draw the batch
     _batch->finish();
     _batch->draw();
 }
 
+void SpriteBatch::beginMerging()
+{
+    ++__merging;
+}
+
+void SpriteBatch::endMerging()
+{
+    GP_ASSERT(__merging > 0);
+    if (--__merging == 0)
+        flushMerged();
+}
+
+void SpriteBatch::flushMerged()
+{
+    SpriteBatch* batch = __pendingBatch;
+    if (batch == NULL)
+        return;
+
+    __pendingBatch = NULL;
+    batch->_batch->finish();
+    batch->_batch->draw();
+
+    // A batch that is still being drawn to goes on with a draw of its own.
+    if (batch->_started)
+        batch->_batch->start();
+}
+
+void SpriteBatch::addVertices(const SpriteVertex* vertices, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount)
+{
+    MeshBatch* batch = _merged ? _merged->_batch : _batch;
+
+    // Draw what the batch holds so far when the vertices would take its indices past 16 bits.
+    if (batch->_vertexCount > 0 && batch->_vertexCount + vertexCount > SPRITE_MAX_VERTICES)
+    {
+        batch->finish();
+        batch->draw();
+        batch->start();
+    }
+    batch->add(vertices, vertexCount, indices, indexCount);
+}
+
+bool SpriteBatch::canMerge(const SpriteBatch* batch) const
+{
+    GP_ASSERT(batch);
+
+    // Custom effects may have parameters of their own.
+    if (_customEffect || batch->_customEffect)
+        return false;
+
+    const Texture::Sampler* a = _sampler;
+    const Texture::Sampler* b = batch->_sampler;
+    if (a->_texture != b->_texture || a->_wrapS != b->_wrapS || a->_wrapT != b->_wrapT ||
+        a->_minFilter != b->_minFilter || a->_magFilter != b->_magFilter)
+        return false;
+
+    const RenderState::StateBlock* s = getStateBlock();
+    const RenderState::StateBlock* t = batch->getStateBlock();
+    if (s != t && (s->_bits != t->_bits ||
+        s->_cullFaceEnabled != t->_cullFaceEnabled || s->_depthTestEnabled != t->_depthTestEnabled ||
+        s->_depthWriteEnabled != t->_depthWriteEnabled || s->_depthFunction != t->_depthFunction ||
+        s->_blendEnabled != t->_blendEnabled || s->_blendSrc != t->_blendSrc || s->_blendDst != t->_blendDst ||
+        s->_cullFaceSide != t->_cullFaceSide || s->_frontFace != t->_frontFace ||
+        s->_stencilTestEnabled != t->_stencilTestEnabled || s->_stencilWrite != t->_stencilWrite ||
+        s->_stencilFunction != t->_stencilFunction || s->_stencilFunctionRef != t->_stencilFunctionRef ||
+        s->_stencilFunctionMask != t->_stencilFunctionMask || s->_stencilOpSfail != t->_stencilOpSfail ||
+        s->_stencilOpDpfail != t->_stencilOpDpfail || s->_stencilOpDppass != t->_stencilOpDppass))
+        return false;
+
+    return memcmp(_projectionMatrix.m, batch->_projectionMatrix.m, sizeof(_projectionMatrix.m)) == 0;
+}
+
 RenderState::StateBlock* SpriteBatch::getStateBlock() const
 {
     return _batch->getMaterial()->getStateBlock();
@@ -402,6 +621,9 @@ Material* SpriteBatch::getMaterial() const
 
 void SpriteBatch::setProjectionMatrix(const Matrix& matrix)
 {
+    // The pending sprites are drawn with the projection they were added with.
+    if (__pendingBatch == this && memcmp(_projectionMatrix.m, matrix.m, sizeof(matrix.m)) != 0)
+        flushMerged();
     _projectionMatrix = matrix;
 }
 
@@ -472,4 +694,154 @@ bool SpriteBatch::clipSprite(const Rectangle& clip, float& x, float& y, float& w
     return true;
 }
 
+void SpriteBatch::addSprites(const SpriteInstance* sprites, unsigned int count, const Rectangle* clip, bool positionIsCenter)
+{
+    GP_ASSERT(sprites || count == 0);
+    GP_PROFILE("SpriteBatch::addSprites");
+
+    // The strip indices of a chunk of sprites, joined by degenerate triangles, are the same for
+    // every chunk, so they are built once for the largest one.
+    if (_spriteIndices.empty())
+    {
+        _spriteIndices.reserve(SPRITE_INSTANCE_CHUNK * 6);
+        for (unsigned short i = 0; i < SPRITE_INSTANCE_CHUNK; ++i)
+        {
+            unsigned short first = i * 4;
+            if (i > 0)
+            {
+                _spriteIndices.push_back(first - 1);
+                _spriteIndices.push_back(first);
+            }
+            _spriteIndices.push_back(first);
+            _spriteIndices.push_back(first + 1);
+            _spriteIndices.push_back(first + 2);
+            _spriteIndices.push_back(first + 3);
+        }
+    }
+    _spriteVertices.resize(SPRITE_INSTANCE_CHUNK * 4);
+
+    // Without a clip rectangle, clipping against the whole float range leaves sprites as they are.
+    const float maxValue = std::numeric_limits<float>::max();
+    const SpriteLanes clipX = lanesSplat(clip ? clip->x : -maxValue);
+    const SpriteLanes clipY = lanesSplat(clip ? clip->y : -maxValue);
+    const SpriteLanes clipX2 = lanesSplat(clip ? clip->x + clip->width : maxValue);
+    const SpriteLanes clipY2 = lanesSplat(clip ? clip->y + clip->height : maxValue);
+    const SpriteLanes zero = lanesSplat(0.0f);
+    const SpriteLanes centerOffset = lanesSplat(positionIsCenter ? 0.5f : 0.0f);
+
+    float x1s[4], y1s[4], x2s[4], y2s[4], x3s[4], y3s[4], x4s[4], y4s[4];
+    float u1s[4], v1s[4], u2s[4], v2s[4];
+
+    for (unsigned int chunkStart = 0; chunkStart < count; chunkStart += SPRITE_INSTANCE_CHUNK)
+    {
+        unsigned int chunkEnd = std::min(chunkStart + SPRITE_INSTANCE_CHUNK, count);
+        SpriteVertex* v = &_spriteVertices[0];
+        unsigned int spriteCount = 0;
+
+        for (unsigned int first = chunkStart; first < chunkEnd; first += 4)
+        {
+            // Gather four sprites into lanes, repeating the last one past the end of the chunk.
+            const SpriteInstance* s[4];
+            float sinAngle[4], cosAngle[4], uRatio[4], vRatio[4];
+            for (unsigned int lane = 0; lane < 4; ++lane)
+            {
+                const SpriteInstance& sprite = sprites[std::min(first + lane, chunkEnd - 1)];
+                s[lane] = &sprite;
+                sinAngle[lane] = sprite.rotationAngle != 0 ? sinf(sprite.rotationAngle) : 0.0f;
+                cosAngle[lane] = sprite.rotationAngle != 0 ? cosf(sprite.rotationAngle) : 1.0f;
+                uRatio[lane] = sprite.width != 0 ? (sprite.u2 - sprite.u1) / sprite.width : 0.0f;
+                vRatio[lane] = sprite.height != 0 ? (sprite.v2 - sprite.v1) / sprite.height : 0.0f;
+            }
+            SpriteLanes width = lanesSet(s[0]->width, s[1]->width, s[2]->width, s[3]->width);
+            SpriteLanes height = lanesSet(s[0]->height, s[1]->height, s[2]->height, s[3]->height);
+            SpriteLanes x = lanesSub(lanesSet(s[0]->x, s[1]->x, s[2]->x, s[3]->x), lanesMul(width, centerOffset));
+            SpriteLanes y = lanesSub(lanesSet(s[0]->y, s[1]->y, s[2]->y, s[3]->y), lanesMul(height, centerOffset));
+            SpriteLanes x2 = lanesAdd(x, width);
+            SpriteLanes y2 = lanesAdd(y, height);
+            SpriteLanes u1 = lanesSet(s[0]->u1, s[1]->u1, s[2]->u1, s[3]->u1);
+            SpriteLanes v1 = lanesSet(s[0]->v1, s[1]->v1, s[2]->v1, s[3]->v1);
+            SpriteLanes u2 = lanesSet(s[0]->u2, s[1]->u2, s[2]->u2, s[3]->u2);
+            SpriteLanes v2 = lanesSet(s[0]->v2, s[1]->v2, s[2]->v2, s[3]->v2);
+            SpriteLanes sine = lanesSet(sinAngle[0], sinAngle[1], sinAngle[2], sinAngle[3]);
+            SpriteLanes cosine = lanesSet(cosAngle[0], cosAngle[1], cosAngle[2], cosAngle[3]);
+            SpriteMask rotated = lanesNotEqual(lanesSet(s[0]->rotationAngle, s[1]->rotationAngle, s[2]->rotationAngle, s[3]->rotationAngle), zero);
+
+            // The pivot is relative to the sprite before it is clipped.
+            SpriteLanes pivotX = lanesAdd(x, lanesMul(width, lanesSet(s[0]->rotationPoint.x, s[1]->rotationPoint.x, s[2]->rotationPoint.x, s[3]->rotationPoint.x)));
+            SpriteLanes pivotY = lanesAdd(y, lanesMul(height, lanesSet(s[0]->rotationPoint.y, s[1]->rotationPoint.y, s[2]->rotationPoint.y, s[3]->rotationPoint.y)));
+
+            // Clip the sprites that aren't rotated, moving their texture coordinates along.
+            SpriteLanes clippedX = lanesSelect(rotated, x, lanesMax(x, clipX));
+            SpriteLanes clippedY = lanesSelect(rotated, y, lanesMax(y, clipY));
+            SpriteLanes clippedX2 = lanesSelect(rotated, x2, lanesMin(x2, clipX2));
+            SpriteLanes clippedY2 = lanesSelect(rotated, y2, lanesMin(y2, clipY2));
+            SpriteLanes ur = lanesSet(uRatio[0], uRatio[1], uRatio[2], uRatio[3]);
+            SpriteLanes vr = lanesSet(vRatio[0], vRatio[1], vRatio[2], vRatio[3]);
+            u1 = lanesAdd(u1, lanesMul(lanesSub(clippedX, x), ur));
+            v1 = lanesAdd(v1, lanesMul(lanesSub(clippedY, y), vr));
+            u2 = lanesSub(u2, lanesMul(lanesSub(x2, clippedX2), ur));
+            v2 = lanesSub(v2, lanesMul(lanesSub(y2, clippedY2), vr));
+            SpriteMask visible = maskAnd(lanesLessEqual(clippedX, clippedX2), lanesLessEqual(clippedY, clippedY2));
+
+            // Rotate the corners around the pivots.
+            SpriteLanes dx1 = lanesSub(clippedX, pivotX);
+            SpriteLanes dy1 = lanesSub(clippedY, pivotY);
+            SpriteLanes dx2 = lanesSub(clippedX2, pivotX);
+            SpriteLanes dy2 = lanesSub(clippedY2, pivotY);
+            SpriteLanes dx1Cos = lanesMul(dx1, cosine), dx1Sin = lanesMul(dx1, sine);
+            SpriteLanes dy1Cos = lanesMul(dy1, cosine), dy1Sin = lanesMul(dy1, sine);
+            SpriteLanes dx2Cos = lanesMul(dx2, cosine), dx2Sin = lanesMul(dx2, sine);
+            SpriteLanes dy2Cos = lanesMul(dy2, cosine), dy2Sin = lanesMul(dy2, sine);
+            SpriteLanes cx1 = lanesSelect(rotated, lanesAdd(lanesSub(dx1Cos, dy1Sin), pivotX), clippedX);
+            SpriteLanes cy1 = lanesSelect(rotated, lanesAdd(lanesAdd(dy1Cos, dx1Sin), pivotY), clippedY);
+            SpriteLanes cx2 = lanesSelect(rotated, lanesAdd(lanesSub(dx1Cos, dy2Sin), pivotX), clippedX);
+            SpriteLanes cy2 = lanesSelect(rotated, lanesAdd(lanesAdd(dy2Cos, dx1Sin), pivotY), clippedY2);
+            SpriteLanes cx3 = lanesSelect(rotated, lanesAdd(lanesSub(dx2Cos, dy1Sin), pivotX), clippedX2);
+            SpriteLanes cy3 = lanesSelect(rotated, lanesAdd(lanesAdd(dy1Cos, dx2Sin), pivotY), clippedY);
+            SpriteLanes cx4 = lanesSelect(rotated, lanesAdd(lanesSub(dx2Cos, dy2Sin), pivotX), clippedX2);
+            SpriteLanes cy4 = lanesSelect(rotated, lanesAdd(lanesAdd(dy2Cos, dx2Sin), pivotY), clippedY2);
+
+            // Cull the rotated sprites whose bounds are outside the clip rectangle.
+            SpriteLanes minX = lanesMin(lanesMin(cx1, cx2), lanesMin(cx3, cx4));
+            SpriteLanes minY = lanesMin(lanesMin(cy1, cy2), lanesMin(cy3, cy4));
+            SpriteLanes maxX = lanesMax(lanesMax(cx1, cx2), lanesMax(cx3, cx4));
+            SpriteLanes maxY = lanesMax(lanesMax(cy1, cy2), lanesMax(cy3, cy4));
+            visible = maskAnd(visible, maskAnd(lanesLessEqual(clipX, maxX), lanesLessEqual(minX, clipX2)));
+            visible = maskAnd(visible, maskAnd(lanesLessEqual(clipY, maxY), lanesLessEqual(minY, clipY2)));
+
+            int visibleBits = maskBits(visible);
+            if (visibleBits == 0)
+                continue;
+
+            lanesStore(x1s, cx1); lanesStore(y1s, cy1);
+            lanesStore(x2s, cx2); lanesStore(y2s, cy2);
+            lanesStore(x3s, cx3); lanesStore(y3s, cy3);
+            lanesStore(x4s, cx4); lanesStore(y4s, cy4);
+            lanesStore(u1s, u1); lanesStore(v1s, v1);
+            lanesStore(u2s, u2); lanesStore(v2s, v2);
+
+            // Write the vertices of the visible sprites in the order of the other draw methods.
+            for (unsigned int lane = 0, lanes = std::min(4u, chunkEnd - first); lane < lanes; ++lane)
+            {
+                if ((visibleBits & (1 << lane)) == 0)
+                    continue;
+
+                const Vector4& color = s[lane]->color;
+                const float z = s[lane]->z;
+                SPRITE_ADD_VERTEX(v[0], x1s[lane], y1s[lane], z, u1s[lane], v1s[lane], color.x, color.y, color.z, color.w);
+                SPRITE_ADD_VERTEX(v[1], x2s[lane], y2s[lane], z, u1s[lane], v2s[lane], color.x, color.y, color.z, color.w);
+                SPRITE_ADD_VERTEX(v[2], x3s[lane], y3s[lane], z, u2s[lane], v1s[lane], color.x, color.y, color.z, color.w);
+                SPRITE_ADD_VERTEX(v[3], x4s[lane], y4s[lane], z, u2s[lane], v2s[lane], color.x, color.y, color.z, color.w);
+                v += 4;
+                ++spriteCount;
+            }
+        }
+
+        if (spriteCount == 0)
+            continue;
+
+        addVertices(&_spriteVertices[0], spriteCount * 4, &_spriteIndices[0], spriteCount * 6 - 2);
+    }
+}
+
 }
@@ -21,12 +21,20 @@ namespace gameplay
  * implicit sorting to minimize state changes. Therefore, it is highly
  * recommended to combine multiple small textures into larger texture atlases
  * where possible when drawing sprites.
+ *
+ * Batches can also be merged while they are drawn: between beginMerging() and
+ * endMerging(), the sprites of consecutive batches that use the default effect
+ * and share their texture, sampler state, render state and projection are added
+ * to a single draw, which is only issued once a batch that differs starts or
+ * merging ends. The render queue merges the sprites, text and tile sets that it
+ * draws, so that sprites of the same texture atlas draw together.
  */
 class SpriteBatch
 {
     friend class Bundle;
     friend class Font;
     friend class Text;
+    friend class Form;
 
 public:
 
@@ -286,6 +294,75 @@ public:
         /** Vertex color alpha component */
         float a;
     };
+
+    /**
+     * Sprite structure used for drawing many sprites at once.
+     */
+    struct SpriteInstance
+    {
+        /** Sprite position x */
+        float x;
+        /** Sprite position y */
+        float y;
+        /** Sprite position z */
+        float z;
+        /** Sprite width */
+        float width;
+        /** Sprite height */
+        float height;
+        /** Texture coordinate u of the corner at the position */
+        float u1;
+        /** Texture coordinate v of the corner at the position */
+        float v1;
+        /** Texture coordinate u of the opposite corner */
+        float u2;
+        /** Texture coordinate v of the opposite corner */
+        float v2;
+        /** The color to tint the sprite */
+        Vector4 color;
+        /** The point to rotate around, as a fraction of the size of the sprite from its position */
+        Vector2 rotationPoint;
+        /** The rotation angle in radians */
+        float rotationAngle;
+
+        /**
+         * Constructor, for a white and unrotated sprite covering the whole texture.
+         */
+        SpriteInstance();
+    };
+
+    /**
+     * Draws many sprites at once.
+     *
+     * The corners of the sprites are computed four sprites at a time, with SSE or NEON where
+     * available, and added to the batch in strips of up to a thousand sprites, which is much
+     * faster than drawing them one at a time in scenes with thousands of sprites. The batch
+     * is drawn and started again if the sprites would exceed its 16-bit indices.
+     *
+     * Texture coordinates are mapped as for draw(float, float, float, float, float, float, float, float, float, const Vector4&, bool),
+     * and sprites are rotated around their rotation point.
+     *
+     * @param sprites The sprites to draw.
+     * @param count The number of sprites.
+     * @param positionIsCenter Whether the positions of the sprites are their centers (if not, they are their bottom-left corners).
+     * @script{ignore}
+     */
+    void draw(const SpriteInstance* sprites, unsigned int count, bool positionIsCenter = false);
+
+    /**
+     * Draws many sprites at once, clipped within a rectangle.
+     *
+     * Sprites that are not rotated are clipped within the rectangle, with their texture
+     * coordinates scaled accordingly. Rotated sprites are only culled when their bounds are
+     * entirely outside the rectangle.
+     *
+     * @param sprites The sprites to draw.
+     * @param count The number of sprites.
+     * @param clip The clip rectangle.
+     * @param positionIsCenter Whether the positions of the sprites are their centers (if not, they are their bottom-left corners).
+     * @script{ignore}
+     */
+    void draw(const SpriteInstance* sprites, unsigned int count, const Rectangle& clip, bool positionIsCenter = false);
     
     /**
      * Draws an array of vertices.
@@ -353,6 +430,23 @@ public:
      */
     const Matrix& getProjectionMatrix() const;
 
+    /**
+     * Starts merging the sprites of consecutive batches into shared draws.
+     *
+     * Nothing else may be drawn until merging ends, since a merged draw is only issued
+     * when a batch that cannot share it starts. Calls can be nested.
+     *
+     * @script{ignore}
+     */
+    static void beginMerging();
+
+    /**
+     * Ends merging the sprites of consecutive batches, and issues the pending draw.
+     *
+     * @script{ignore}
+     */
+    static void endMerging();
+
 private:
 
     /**
@@ -402,12 +496,37 @@ private:
 
     bool clipSprite(const Rectangle& clip, float& x, float& y, float& width, float& height, float& u1, float& v1, float& u2, float& v2);
 
+    /**
+     * Adds the vertices of many sprites to the batch, optionally clipped within a rectangle.
+     */
+    void addSprites(const SpriteInstance* sprites, unsigned int count, const Rectangle* clip, bool positionIsCenter);
+
+    /**
+     * Adds vertices to the mesh batch that the sprites of this batch are drawn with, which is
+     * the batch of the pending draw if this batch is merged into it.
+     */
+    void addVertices(const SpriteVertex* vertices, unsigned int vertexCount, const unsigned short* indices, unsigned int indexCount);
+
+    /**
+     * Returns whether the sprites of this batch can be drawn along with those of another batch.
+     */
+    bool canMerge(const SpriteBatch* batch) const;
+
+    /**
+     * Issues the draw of the batch that other batches are merged into, if any.
+     */
+    static void flushMerged();
+
     MeshBatch* _batch;
     Texture::Sampler* _sampler;
     bool _customEffect;
     float _textureWidthRatio;
     float _textureHeightRatio;
     mutable Matrix _projectionMatrix;
+    std::vector<SpriteVertex> _spriteVertices;
+    std::vector<unsigned short> _spriteIndices;
+    SpriteBatch* _merged;
+    bool _started;
 };
 
 }
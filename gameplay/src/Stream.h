@@ -155,6 +155,17 @@ public:
      */
     virtual bool rewind() = 0;
 
+    /**
+     * Returns the entire contents of the stream, when they are held in memory.
+     *
+     * Streams that are opened with FileSystem::MAPPED map their file into memory where
+     * the platform supports it, so that its contents can be used in place instead of
+     * being read into a copy. The data remains valid until the stream is closed.
+     *
+     * @return The contents of the stream, or NULL if they are not held in memory.
+     */
+    virtual const void* getData() { return NULL; }
+
 protected:
     Stream() {};
 private:
@@ -0,0 +1,116 @@
+#include "Base.h"
+#include "StringPool.h"
+
+// The size of the blocks that interned strings are packed into.
+#define STRING_POOL_BLOCK_SIZE 16384
+
+namespace gameplay
+{
+
+/**
+ * A range of characters used as a key of the pool, so that lookups don't copy the string.
+ */
+struct StringPoolKey
+{
+    const char* str;
+    size_t length;
+};
+
+struct StringPoolHash
+{
+    size_t operator()(const StringPoolKey& key) const
+    {
+        // FNV-1a.
+        size_t hash = 2166136261u;
+        for (size_t i = 0; i < key.length; ++i)
+        {
+            hash ^= (unsigned char)key.str[i];
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+};
+
+struct StringPoolEqual
+{
+    bool operator()(const StringPoolKey& a, const StringPoolKey& b) const
+    {
+        return a.length == b.length && memcmp(a.str, b.str, a.length) == 0;
+    }
+};
+
+static std::unordered_map<StringPoolKey, const char*, StringPoolHash, StringPoolEqual> __strings;
+static std::vector<char*> __blocks;
+static size_t __blockUsed = STRING_POOL_BLOCK_SIZE;
+static size_t __memory = 0;
+static std::mutex __mutex;
+
+const char* StringPool::intern(const char* str)
+{
+    GP_ASSERT(str);
+    return intern(str, strlen(str));
+}
+
+const char* StringPool::intern(const char* str, size_t length)
+{
+    GP_ASSERT(str || length == 0);
+
+    StringPoolKey key = { str ? str : "", length };
+    std::lock_guard<std::mutex> lock(__mutex);
+    std::unordered_map<StringPoolKey, const char*, StringPoolHash, StringPoolEqual>::const_iterator itr = __strings.find(key);
+    if (itr != __strings.end())
+        return itr->second;
+
+    // Strings that don't fit in the rest of the current block start a new one, and strings
+    // larger than a block get a block of their own.
+    char* copy;
+    size_t size = length + 1;
+    if (size > STRING_POOL_BLOCK_SIZE / 4)
+    {
+        copy = new char[size];
+        __blocks.insert(__blocks.begin(), copy);
+        __memory += size;
+    }
+    else
+    {
+        if (__blockUsed + size > STRING_POOL_BLOCK_SIZE)
+        {
+            __blocks.push_back(new char[STRING_POOL_BLOCK_SIZE]);
+            __blockUsed = 0;
+            __memory += STRING_POOL_BLOCK_SIZE;
+        }
+        copy = __blocks.back() + __blockUsed;
+        __blockUsed += size;
+    }
+    if (length > 0)
+        memcpy(copy, key.str, length);
+    copy[length] = '\0';
+
+    key.str = copy;
+    __strings[key] = copy;
+    return copy;
+}
+
+const char* StringPool::find(const char* str)
+{
+    GP_ASSERT(str);
+
+    StringPoolKey key = { str, strlen(str) };
+    std::lock_guard<std::mutex> lock(__mutex);
+    std::unordered_map<StringPoolKey, const char*, StringPoolHash, StringPoolEqual>::const_iterator itr = __strings.find(key);
+    return itr != __strings.end() ? itr->second : NULL;
+}
+
+unsigned int StringPool::getCount()
+{
+    std::lock_guard<std::mutex> lock(__mutex);
+    return (unsigned int)__strings.size();
+}
+
+size_t StringPool::getMemory()
+{
+    std::lock_guard<std::mutex> lock(__mutex);
+    return __memory;
+}
+
+}
@@ -0,0 +1,79 @@
+#ifndef STRINGPOOL_H_
+#define STRINGPOOL_H_
+
+namespace gameplay
+{
+
+/**
+ * Defines a global pool of interned strings, such as the ids that bundles are made of.
+ *
+ * Interning a string returns a pointer to the single copy of it in the pool, so that
+ * interned strings are equal only if their pointers are, and compare without reading
+ * their characters. The copies are packed into large blocks instead of being allocated
+ * one by one, and remain valid until the game exits.
+ *
+ * The pool is meant for the small and recurring set of ids of the content of a game,
+ * not for arbitrary strings built at runtime, since it never shrinks.
+ *
+ * @script{ignore}
+ */
+class StringPool
+{
+public:
+
+    /**
+     * Returns the interned copy of a string, adding it to the pool if it isn't in it yet.
+     *
+     * @param str The null-terminated string.
+     *
+     * @return The interned string.
+     */
+    static const char* intern(const char* str);
+
+    /**
+     * Returns the interned copy of a range of characters, adding it to the pool if it isn't in it yet.
+     *
+     * @param str The characters, which don't need to be null-terminated.
+     * @param length The number of characters.
+     *
+     * @return The interned string, which is null-terminated.
+     */
+    static const char* intern(const char* str, size_t length);
+
+    /**
+     * Returns the interned copy of a string, if it is in the pool.
+     *
+     * Since no interned string equals a string that isn't in the pool, lookups of
+     * interned strings can use this to fail early without adding to the pool.
+     *
+     * @param str The null-terminated string.
+     *
+     * @return The interned string, or NULL if the string isn't in the pool.
+     */
+    static const char* find(const char* str);
+
+    /**
+     * Returns the number of strings in the pool.
+     *
+     * @return The number of interned strings.
+     */
+    static unsigned int getCount();
+
+    /**
+     * Returns the memory taken by the blocks that the strings are packed into.
+     *
+     * @return The size of the blocks in bytes.
+     */
+    static size_t getMemory();
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    StringPool();
+};
+
+}
+
+#endif
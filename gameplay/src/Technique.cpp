@@ -31,6 +31,17 @@ unsigned int Technique::getPassCount() const
     return (unsigned int)_passes.size();
 }
 
+bool Technique::isReady() const
+{
+    for (size_t i = 0, count = _passes.size(); i < count; ++i)
+    {
+        Effect* effect = _passes[i]->getEffect();
+        if (effect && !effect->isReady())
+            return false;
+    }
+    return true;
+}
+
 Pass* Technique::getPassByIndex(unsigned int index) const
 {
     GP_ASSERT(index < _passes.size());
@@ -55,6 +55,14 @@ public:
      */
     Pass* getPass(const char* id) const;
 
+    /**
+     * Returns whether the effects of all passes in this technique are ready.
+     *
+     * @return True if the technique can be drawn without waiting for shaders to compile.
+     * @see Effect::isReady
+     */
+    bool isReady() const;
+
     /**
      * @see RenderState::setNodeBinding
      */
@@ -2,7 +2,11 @@
 #include "Terrain.h"
 #include "TerrainPatch.h"
 #include "Node.h"
+#include "MeshPart.h"
+#include "Scene.h"
+#include "Game.h"
 #include "FileSystem.h"
+#include "Image.h"
 
 namespace gameplay
 {
@@ -22,14 +26,30 @@ static const unsigned int DEFAULT_TERRAIN_PATCH_SIZE = 32;
 //
 static const float DEFAULT_TERRAIN_HEIGHT_RATIO = 0.3f;
 
+// The number of terrain patches whose geometry is generated in parallel before
+// their meshes are created.
+static const unsigned int TERRAIN_PATCH_BATCH_SIZE = 64;
+
+// The number of points that batched height queries transform and interpolate at a time.
+static const unsigned int TERRAIN_HEIGHT_BATCH_SIZE = 256;
+
+// The number of layers that a splatting terrain packs into its layer atlas, which is
+// the base layer and one layer for each channel of the splat map.
+static const unsigned int TERRAIN_MAX_SPLAT_LAYERS = 5;
+
 // Terrain dirty flags
 static const unsigned int DIRTY_FLAG_INVERSE_WORLD = 1;
+static const unsigned int DIRTY_FLAG_QUADTREE_BOUNDS = 2;
+static const unsigned int DIRTY_FLAG_SPLATTING = 4;
 
 static float getDefaultHeight(unsigned int width, unsigned int height);
 
+static int classifyBox(const Frustum& frustum, const BoundingBox& box);
+
 Terrain::Terrain() : Drawable(),
-    _heightfield(NULL), _normalMap(NULL), _flags(FRUSTUM_CULLING | LEVEL_OF_DETAIL),
-    _dirtyFlags(DIRTY_FLAG_INVERSE_WORLD)
+    _heightfield(NULL), _normalMap(NULL), _heightMap(NULL), _lodDistance(0.0f),
+    _splatting(false), _layerAtlas(NULL), _splatMap(NULL), _material(NULL), _flags(FRUSTUM_CULLING | LEVEL_OF_DETAIL),
+    _heightScale(1.0f), _dirtyFlags(DIRTY_FLAG_INVERSE_WORLD | DIRTY_FLAG_QUADTREE_BOUNDS)
 {
 }
 
@@ -39,6 +59,14 @@ Terrain::~Terrain()
     {
         SAFE_DELETE(_patches[i]);
     }
+    for (size_t i = 0, count = _gridMeshes.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_gridMeshes[i]);
+    }
+    SAFE_RELEASE(_material);
+    SAFE_RELEASE(_splatMap);
+    SAFE_RELEASE(_layerAtlas);
+    SAFE_RELEASE(_heightMap);
     SAFE_RELEASE(_normalMap);
     SAFE_RELEASE(_heightfield);
 }
@@ -54,12 +82,16 @@ Terrain* Terrain::create(Properties* properties)
 }
 
 Terrain* Terrain::create(const char* path, Properties* properties)
+{
+    return create(path, properties, NULL);
+}
+
+Terrain* Terrain::create(const char* path, Properties* properties, HeightField* heightfield)
 {
     // Terrain properties
     Properties* p = properties;
     Properties* pTerrain = NULL;
     bool externalProperties = (p != NULL);
-    HeightField* heightfield = NULL;
     Vector3 terrainSize;
     int patchSize = 0;
     int detailLevels = 1;
@@ -75,6 +107,7 @@ Terrain* Terrain::create(const char* path, Properties* properties)
     if (!p)
     {
         GP_WARN("Failed to properties for terrain: %s", path ? path : "");
+        SAFE_RELEASE(heightfield);
         return NULL;
     }
 
@@ -82,88 +115,15 @@ Terrain* Terrain::create(const char* path, Properties* properties)
     if (pTerrain == NULL)
     {
         GP_WARN("Invalid terrain definition.");
+        SAFE_RELEASE(heightfield);
         if (!externalProperties)
             SAFE_DELETE(p);
         return NULL;
     }
 
-    // Read heightmap info
-    Properties* pHeightmap = pTerrain->getNamespace("heightmap", true);
-    if (pHeightmap)
-    {
-        // Read heightmap path
-        std::string heightmap;
-        if (!pHeightmap->getPath("path", &heightmap))
-        {
-            GP_WARN("No 'path' property supplied in heightmap section of terrain definition: %s", path);
-            if (!externalProperties)
-                SAFE_DELETE(p);
-            return NULL;
-        }
-
-        std::string ext = FileSystem::getExtension(heightmap.c_str());
-        if (ext == ".PNG")
-        {
-            // Read normalized height values from heightmap image
-            heightfield = HeightField::createFromImage(heightmap.c_str(), 0, 1);
-        }
-        else if (ext == ".RAW" || ext == ".R16")
-        {
-            // Require additional properties to be specified for RAW files
-            Vector2 imageSize;
-            if (!pHeightmap->getVector2("size", &imageSize))
-            {
-                GP_WARN("Invalid or missing 'size' attribute in heightmap defintion of terrain definition: %s", path);
-                if (!externalProperties)
-                    SAFE_DELETE(p);
-                return NULL;
-            }
-
-            // Read normalized height values from RAW file
-            heightfield = HeightField::createFromRAW(heightmap.c_str(), (unsigned int)imageSize.x, (unsigned int)imageSize.y, 0, 1);
-        }
-        else
-        {
-            // Unsupported heightmap format
-            GP_WARN("Unsupported heightmap format ('%s') in terrain definition: %s", heightmap.c_str(), path);
-            if (!externalProperties)
-                SAFE_DELETE(p);
-            return NULL;
-        }
-    }
-    else
-    {
-        // Try to read 'heightmap' as a simple string property
-        std::string heightmap;
-        if (!pTerrain->getPath("heightmap", &heightmap))
-        {
-            GP_WARN("No 'heightmap' property supplied in terrain definition: %s", path);
-            if (!externalProperties)
-                SAFE_DELETE(p);
-            return NULL;
-        }
-
-        std::string ext = FileSystem::getExtension(heightmap.c_str());
-        if (ext == ".PNG")
-        {
-            // Read normalized height values from heightmap image
-            heightfield = HeightField::createFromImage(heightmap.c_str(), 0, 1);
-        }
-        else if (ext == ".RAW" || ext == ".R16")
-        {
-            GP_WARN("RAW heightmaps must be specified inside a heightmap block with width and height properties.");
-            if (!externalProperties)
-                SAFE_DELETE(p);
-            return NULL;
-        }
-        else
-        {
-            GP_WARN("Unsupported 'heightmap' format ('%s') in terrain definition: %s.", heightmap.c_str(), path);
-            if (!externalProperties)
-                SAFE_DELETE(p);
-            return NULL;
-        }
-    }
+    // Read heightmap, unless it was already loaded by the caller
+    if (heightfield == NULL)
+        heightfield = loadHeightField(pTerrain, path);
 
     // Read terrain 'size'
     if (pTerrain->exists("size"))
@@ -234,6 +194,77 @@ Terrain* Terrain::create(const char* path, Properties* properties)
     return terrain;
 }
 
+HeightField* Terrain::loadHeightField(Properties* pTerrain, const char* path)
+{
+    GP_ASSERT(pTerrain);
+
+    // Read heightmap info
+    Properties* pHeightmap = pTerrain->getNamespace("heightmap", true);
+    if (pHeightmap)
+    {
+        // Read heightmap path
+        std::string heightmap;
+        if (!pHeightmap->getPath("path", &heightmap))
+        {
+            GP_WARN("No 'path' property supplied in heightmap section of terrain definition: %s", path);
+            return NULL;
+        }
+
+        std::string ext = FileSystem::getExtension(heightmap.c_str());
+        if (ext == ".PNG")
+        {
+            // Read normalized height values from heightmap image
+            return HeightField::createFromImage(heightmap.c_str(), 0, 1);
+        }
+        else if (ext == ".RAW" || ext == ".R16")
+        {
+            // Require additional properties to be specified for RAW files
+            Vector2 imageSize;
+            if (!pHeightmap->getVector2("size", &imageSize))
+            {
+                GP_WARN("Invalid or missing 'size' attribute in heightmap defintion of terrain definition: %s", path);
+                return NULL;
+            }
+
+            // Read normalized height values from RAW file
+            return HeightField::createFromRAW(heightmap.c_str(), (unsigned int)imageSize.x, (unsigned int)imageSize.y, 0, 1);
+        }
+        else
+        {
+            // Unsupported heightmap format
+            GP_WARN("Unsupported heightmap format ('%s') in terrain definition: %s", heightmap.c_str(), path);
+            return NULL;
+        }
+    }
+    else
+    {
+        // Try to read 'heightmap' as a simple string property
+        std::string heightmap;
+        if (!pTerrain->getPath("heightmap", &heightmap))
+        {
+            GP_WARN("No 'heightmap' property supplied in terrain definition: %s", path);
+            return NULL;
+        }
+
+        std::string ext = FileSystem::getExtension(heightmap.c_str());
+        if (ext == ".PNG")
+        {
+            // Read normalized height values from heightmap image
+            return HeightField::createFromImage(heightmap.c_str(), 0, 1);
+        }
+        else if (ext == ".RAW" || ext == ".R16")
+        {
+            GP_WARN("RAW heightmaps must be specified inside a heightmap block with width and height properties.");
+            return NULL;
+        }
+        else
+        {
+            GP_WARN("Unsupported 'heightmap' format ('%s') in terrain definition: %s.", heightmap.c_str(), path);
+            return NULL;
+        }
+    }
+}
+
 Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale, unsigned int patchSize, unsigned int detailLevels, float skirtScale, const char* normalMapPath, const char* materialPath)
 {
     return create(heightfield, scale, patchSize, detailLevels, skirtScale, normalMapPath, materialPath, NULL);
@@ -274,7 +305,35 @@ Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale,
     // level detail terrain patch.
     unsigned int maxStep = (unsigned int)std::pow(2.0, (double)(detailLevels-1));
 
-    // Create terrain patches
+    // Geomorphing terrains share one grid mesh per level between all patches and read
+    // the heights from a texture.
+    if (properties && properties->getBool("geomorphing"))
+    {
+        if (terrain->createHeightMap(patchSize, maxStep))
+        {
+            for (unsigned int step = 1; step <= maxStep; step *= 2)
+                terrain->_gridMeshes.push_back(TerrainPatch::createGridMesh(patchSize, step));
+
+            // Adjacent patches may only differ by one level, which holds as long as the first
+            // level covers twice the extent of a patch.
+            Vector3 patchExtent(patchSize * scale.x, terrain->_heightRange.y, patchSize * scale.z);
+            float minDistance = patchExtent.length() * 2.0f;
+            terrain->_lodDistance = properties->exists("lodDistance") ? properties->getFloat("lodDistance") : minDistance;
+            if (terrain->_lodDistance < minDistance)
+            {
+                GP_WARN("Terrain 'lodDistance' of %f is too small for geomorphing, using %f instead.", terrain->_lodDistance, minDistance);
+                terrain->_lodDistance = minDistance;
+            }
+        }
+    }
+
+    // Compute the extents of the terrain patches
+    struct PatchExtents
+    {
+        unsigned int row, column;
+        unsigned int x1, z1, x2, z2;
+    };
+    std::vector<PatchExtents> extents;
     unsigned int x1, x2, z1, z2;
     unsigned int row = 0, column = 0;
     for (unsigned int z = 0; z < height-1; z = z2, ++row)
@@ -287,8 +346,40 @@ Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale,
             x1 = x;
             x2 = std::min(x1 + patchSize, width-1);
 
-            // Create this patch
-            TerrainPatch* patch = TerrainPatch::create(terrain, terrain->_patches.size(), row, column, heightfield->getArray(), width, height, x1, z1, x2, z2, -halfWidth, -halfHeight, maxStep, skirtScale);
+            PatchExtents patchExtents = { row, column, x1, z1, x2, z2 };
+            extents.push_back(patchExtents);
+        }
+    }
+
+    // Create terrain patches. The vertices, normals and bounds of each batch of patches are
+    // generated on the job workers, and only their meshes are created on this thread. Batches
+    // bound the memory that is held by the generated geometry before it is uploaded.
+    JobController* jobController = Game::getInstance()->getJobController();
+    float* heights = heightfield->getArray();
+    std::vector<TerrainPatch::Geometry> geometry;
+    for (size_t first = 0, patchCount = extents.size(); first < patchCount; first += TERRAIN_PATCH_BATCH_SIZE)
+    {
+        unsigned int count = (unsigned int)std::min(patchCount - first, (size_t)TERRAIN_PATCH_BATCH_SIZE);
+        geometry.clear();
+        geometry.resize(count);
+
+        std::function<void(unsigned int, unsigned int, unsigned int)> build = [&](unsigned int begin, unsigned int end, unsigned int worker)
+        {
+            for (unsigned int i = begin; i < end; ++i)
+            {
+                const PatchExtents& e = extents[first + i];
+                TerrainPatch::buildGeometry(terrain, &geometry[i], heights, width, height, e.x1, e.z1, e.x2, e.z2, -halfWidth, -halfHeight, maxStep, skirtScale);
+            }
+        };
+        if (jobController && count > 1)
+            jobController->parallelFor(count, build, 1);
+        else
+            build(0, count, 0);
+
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            const PatchExtents& e = extents[first + i];
+            TerrainPatch* patch = TerrainPatch::create(terrain, terrain->_patches.size(), e.row, e.column, e.x1, e.z1, e.x2, e.z2, &geometry[i]);
             terrain->_patches.push_back(patch);
 
             // Append the new patch's local bounds to the terrain local bounds
@@ -296,6 +387,17 @@ Terrain* Terrain::create(HeightField* heightfield, const Vector3& scale,
         }
     }
 
+    // Patches are created row by row, so the quadtree can be built over the patch grid
+    unsigned int patchRows = (height - 2) / patchSize + 1;
+    unsigned int patchColumns = (width - 2) / patchSize + 1;
+    GP_ASSERT(patchRows * patchColumns == terrain->_patches.size());
+    terrain->buildQuadtree(0, patchRows, 0, patchColumns, patchColumns);
+
+    // Splatting terrains keep their layers until the first patch material is created,
+    // which packs them into the layer atlas.
+    if (properties && properties->getBool("splatting"))
+        terrain->_splatting = true;
+
     // Read additional layer information from properties (if specified)
     if (properties)
     {
@@ -393,14 +495,19 @@ void Terrain::setNode(Node* node)
         for (size_t i = 0, count = _patches.size(); i < count; ++i)
         {
             _patches[i]->updateNodeBindings();
+            _patches[i]->setBoundsDirty();
         }
-        _dirtyFlags |= DIRTY_FLAG_INVERSE_WORLD;
+        _dirtyFlags |= DIRTY_FLAG_INVERSE_WORLD | DIRTY_FLAG_QUADTREE_BOUNDS;
     }
 }
 
 void Terrain::transformChanged(Transform* transform, long cookie)
 {
-    _dirtyFlags |= DIRTY_FLAG_INVERSE_WORLD;
+    for (size_t i = 0, count = _patches.size(); i < count; ++i)
+    {
+        _patches[i]->setBoundsDirty();
+    }
+    _dirtyFlags |= DIRTY_FLAG_INVERSE_WORLD | DIRTY_FLAG_QUADTREE_BOUNDS;
 }
 
 const Matrix& Terrain::getInverseWorldMatrix() const
@@ -419,8 +526,13 @@ const Matrix& Terrain::getInverseWorldMatrix() const
         }
         // Apply local scale and invert
         _inverseWorldMatrix.scale(_localScale);
+
+        // Heightfield values are scaled to world heights by the Y scale of the same transform.
+        Vector3 scale;
+        _inverseWorldMatrix.getScale(&scale);
+        _heightScale = scale.y;
+
         _inverseWorldMatrix.invert();
-        
     }
     return _inverseWorldMatrix;
 }
@@ -430,6 +542,36 @@ bool Terrain::setLayer(int index, const char* texturePath, const Vector2& textur
     if (!texturePath)
         return false;
 
+    if (_splatting)
+    {
+        if (!FileSystem::fileExists(texturePath))
+            return false;
+        if (row != -1 || column != -1)
+            GP_WARN("Layer %d is applied to the entire terrain, since splatting terrains don't support per-patch layers.", index);
+
+        // Layers are kept sorted by index, replacing any existing layer with the same index.
+        SplatLayer layer;
+        layer.index = index;
+        layer.texturePath = texturePath;
+        layer.textureRepeat = textureRepeat;
+        layer.blendPath = blendPath ? blendPath : "";
+        layer.blendChannel = blendChannel;
+        std::vector<SplatLayer>::iterator itr = _splatLayers.begin();
+        while (itr != _splatLayers.end() && itr->index < index)
+            ++itr;
+        if (itr != _splatLayers.end() && itr->index == index)
+            *itr = layer;
+        else
+            _splatLayers.insert(itr, layer);
+
+        // The shared material is recreated for the new layer count when the patches are drawn.
+        _dirtyFlags |= DIRTY_FLAG_SPLATTING;
+        SAFE_RELEASE(_material);
+        for (size_t i = 0, count = _patches.size(); i < count; ++i)
+            _patches[i]->setMaterialDirty();
+        return true;
+    }
+
     // Set layer on applicable patches
     bool result = true;
     for (size_t i = 0, count = _patches.size(); i < count; ++i)
@@ -512,29 +654,168 @@ float Terrain::getHeight(float x, float z) const
     x = v.x + (cols - 1) * 0.5f;
     z = v.z + (rows - 1) * 0.5f;
 
-    // Get the unscaled height value from the HeightField
-    float height = _heightfield->getHeight(x, z);
+    // Get the unscaled height value from the HeightField and apply the world and local scale
+    return _heightfield->getHeight(x, z) * _heightScale;
+}
 
-    // Apply world scale to the height value
-    if (_node)
+void Terrain::getHeights(const Vector2* positions, unsigned int count, float* heights, Vector3* normals) const
+{
+    GP_ASSERT(positions);
+    GP_ASSERT(heights);
+
+    float offsetX = (_heightfield->getColumnCount() - 1) * 0.5f;
+    float offsetZ = (_heightfield->getRowCount() - 1) * 0.5f;
+
+    // Only the X and Z rows of the inverse world matrix are needed, since the
+    // world positions lie on the X,Z plane.
+    const float* m = getInverseWorldMatrix().m;
+    float columns[TERRAIN_HEIGHT_BATCH_SIZE];
+    float rows[TERRAIN_HEIGHT_BATCH_SIZE];
+    float samples[TERRAIN_HEIGHT_BATCH_SIZE * 2];
+
+    for (unsigned int first = 0; first < count; first += TERRAIN_HEIGHT_BATCH_SIZE)
     {
-        Vector3 worldScale;
-        _node->getWorldMatrix().getScale(&worldScale);
-        height *= worldScale.y;
-    }
+        unsigned int batch = std::min(count - first, TERRAIN_HEIGHT_BATCH_SIZE);
+        const Vector2* p = positions + first;
+        for (unsigned int i = 0; i < batch; ++i)
+        {
+            columns[i] = m[0] * p[i].x + m[8] * p[i].y + m[12] + offsetX;
+            rows[i] = m[2] * p[i].x + m[10] * p[i].y + m[14] + offsetZ;
+        }
 
-    // Apply local scale
-    height *= _localScale.y;
+        float* h = heights + first;
+        _heightfield->getHeights(columns, rows, h, batch);
 
-    return height;
+        if (normals)
+        {
+            // The slope of the heightfield is taken from the central differences of the
+            // unscaled heights, and the normal is transformed to world space by the
+            // transpose of the inverse world matrix.
+            Vector3* n = normals + first;
+            float* left = samples;
+            float* right = samples + TERRAIN_HEIGHT_BATCH_SIZE;
+            for (unsigned int i = 0; i < batch; ++i)
+                columns[i] -= 1.0f;
+            _heightfield->getHeights(columns, rows, left, batch);
+            for (unsigned int i = 0; i < batch; ++i)
+                columns[i] += 2.0f;
+            _heightfield->getHeights(columns, rows, right, batch);
+            for (unsigned int i = 0; i < batch; ++i)
+            {
+                columns[i] -= 1.0f;
+                n[i].x = (left[i] - right[i]) * 0.5f;
+                rows[i] -= 1.0f;
+            }
+            _heightfield->getHeights(columns, rows, left, batch);
+            for (unsigned int i = 0; i < batch; ++i)
+                rows[i] += 2.0f;
+            _heightfield->getHeights(columns, rows, right, batch);
+            for (unsigned int i = 0; i < batch; ++i)
+            {
+                float nx = n[i].x;
+                float nz = (left[i] - right[i]) * 0.5f;
+                n[i].set(m[0] * nx + m[1] + m[2] * nz, m[4] * nx + m[5] + m[6] * nz, m[8] * nx + m[9] + m[10] * nz);
+                n[i].normalize();
+            }
+        }
+
+        for (unsigned int i = 0; i < batch; ++i)
+            h[i] *= _heightScale;
+    }
 }
 
 unsigned int Terrain::draw(bool wireframe)
 {
-    size_t visibleCount = 0;
-    for (size_t i = 0, count = _patches.size(); i < count; ++i)
+    Scene* scene = _node ? _node->getScene() : NULL;
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (!camera || _quadtree.empty())
+        return 0;
+
+    if (_dirtyFlags & DIRTY_FLAG_QUADTREE_BOUNDS)
+    {
+        _dirtyFlags &= ~DIRTY_FLAG_QUADTREE_BOUNDS;
+        for (size_t i = 0, count = _quadtree.size(); i < count; ++i)
+        {
+            Quad& quad = _quadtree[i];
+            quad.worldBounds.set(quad.bounds);
+            quad.worldBounds.transform(_node->getWorldMatrix());
+        }
+    }
+
+    return drawQuadtree(0, camera, isFlagSet(FRUSTUM_CULLING), -1, wireframe);
+}
+
+int Terrain::buildQuadtree(unsigned int row1, unsigned int row2, unsigned int column1, unsigned int column2, unsigned int columns)
+{
+    int index = (int)_quadtree.size();
+    _quadtree.push_back(Quad());
+
+    if (row2 - row1 == 1 && column2 - column1 == 1)
     {
-        visibleCount += _patches[i]->draw(wireframe);
+        Quad& quad = _quadtree[index];
+        quad.patch = (int)(row1 * columns + column1);
+        quad.bounds.set(_patches[quad.patch]->getBoundingBox(false));
+        return index;
+    }
+
+    // Split the range in half along both axes, where the second half of an axis
+    // that only spans a single patch is empty.
+    unsigned int rowSplit = row1 + (row2 - row1 + 1) / 2;
+    unsigned int columnSplit = column1 + (column2 - column1 + 1) / 2;
+    unsigned int rows[3] = { row1, rowSplit, row2 };
+    unsigned int cols[3] = { column1, columnSplit, column2 };
+    unsigned int childCount = 0;
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+        for (unsigned int j = 0; j < 2; ++j)
+        {
+            if (rows[i] >= rows[i + 1] || cols[j] >= cols[j + 1])
+                continue;
+
+            // Building the child may reallocate the quadtree, so the node is looked up again.
+            int child = buildQuadtree(rows[i], rows[i + 1], cols[j], cols[j + 1], columns);
+            Quad& quad = _quadtree[index];
+            if (childCount == 0)
+                quad.bounds.set(_quadtree[child].bounds);
+            else
+                quad.bounds.merge(_quadtree[child].bounds);
+            quad.children[childCount++] = child;
+        }
+    }
+    return index;
+}
+
+unsigned int Terrain::drawQuadtree(int index, Camera* camera, bool cull, int level, bool wireframe)
+{
+    const Quad& quad = _quadtree[index];
+
+    if (cull)
+    {
+        int intersection = classifyBox(camera->getFrustum(), quad.worldBounds);
+        if (intersection < 0)
+            return 0;
+
+        // Nothing below a node that is completely within the frustum can be culled.
+        if (intersection > 0)
+            cull = false;
+    }
+
+    if (quad.patch >= 0)
+        return _patches[quad.patch]->draw(camera, level, wireframe);
+
+    // The patches of a node project to a smaller area than the node itself, so once the node
+    // uses the lowest level of detail, all of its patches do as well.
+    if (level < 0 && isFlagSet(LEVEL_OF_DETAIL))
+    {
+        size_t levelCount = _patches[0]->_levels.size();
+        if (levelCount > 1 && computeLevel(camera, quad.worldBounds, levelCount) == levelCount - 1)
+            level = (int)levelCount - 1;
+    }
+
+    unsigned int visibleCount = 0;
+    for (unsigned int i = 0; i < 4 && quad.children[i] >= 0; ++i)
+    {
+        visibleCount += drawQuadtree(quad.children[i], camera, cull, level, wireframe);
     }
     return visibleCount;
 }
@@ -545,6 +826,356 @@ Drawable* Terrain::clone(NodeCloneContext& context)
     return NULL;
 }
 
+size_t Terrain::getMemoryUsage() const
+{
+    size_t size = 0;
+    if (_heightfield)
+        size += _heightfield->getRowCount() * _heightfield->getColumnCount() * sizeof(float);
+
+    // Meshes and textures are usually shared between patches, so each one is only counted once.
+    std::set<Mesh*> meshes;
+    std::set<Texture*> textures;
+    if (_normalMap)
+        textures.insert(_normalMap->getTexture());
+    if (_heightMap)
+        textures.insert(_heightMap->getTexture());
+    if (_layerAtlas)
+        textures.insert(_layerAtlas->getTexture());
+    if (_splatMap)
+        textures.insert(_splatMap->getTexture());
+    for (size_t i = 0, count = _patches.size(); i < count; ++i)
+    {
+        TerrainPatch* patch = _patches[i];
+        for (size_t j = 0, levelCount = patch->_levels.size(); j < levelCount; ++j)
+            meshes.insert(patch->_levels[j]->model->getMesh());
+        for (size_t j = 0, samplerCount = patch->_samplers.size(); j < samplerCount; ++j)
+            textures.insert(patch->_samplers[j]->getTexture());
+    }
+    for (std::set<Mesh*>::const_iterator itr = meshes.begin(); itr != meshes.end(); ++itr)
+    {
+        Mesh* mesh = *itr;
+        size += mesh->getVertexCount() * mesh->getVertexSize();
+        for (unsigned int k = 0, partCount = mesh->getPartCount(); k < partCount; ++k)
+        {
+            MeshPart* part = mesh->getPart(k);
+            size += part->getIndexCount() * (part->getIndexFormat() == Mesh::INDEX32 ? 4 : (part->getIndexFormat() == Mesh::INDEX16 ? 2 : 1));
+        }
+    }
+    for (std::set<Texture*>::const_iterator itr = textures.begin(); itr != textures.end(); ++itr)
+    {
+        // Assume four bytes per texel plus a third for the mipmap chain.
+        size += (*itr)->getWidth() * (*itr)->getHeight() * 4 * 4 / 3;
+    }
+    return size;
+}
+
+bool Terrain::createHeightMap(unsigned int patchSize, unsigned int maxStep)
+{
+    GP_ASSERT(_heightfield);
+
+    unsigned int width = _heightfield->getColumnCount();
+    unsigned int height = _heightfield->getRowCount();
+
+    // Heights are read in the vertex shader, which is optional in OpenGL ES 2.0.
+    GLint vertexTextureUnits = 0;
+    GLint maxTextureSize = 0;
+    GL_ASSERT( glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vertexTextureUnits) );
+    GL_ASSERT( glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize) );
+    if (vertexTextureUnits <= 0)
+    {
+        GP_WARN("Vertex textures are not supported; terrain geomorphing is disabled.");
+        return false;
+    }
+    if (width > (unsigned int)maxTextureSize || height > (unsigned int)maxTextureSize)
+    {
+        GP_WARN("Heightfield of %ux%u exceeds the maximum texture size of %d; terrain geomorphing is disabled.", width, height, maxTextureSize);
+        return false;
+    }
+    if (patchSize % maxStep != 0)
+    {
+        GP_WARN("Terrain patch size %u is not a multiple of the lowest detail step %u; terrain geomorphing is disabled.", patchSize, maxStep);
+        return false;
+    }
+
+    // Store the normalized heights as 16 bit values in the red and green channels.
+    const float* heights = _heightfield->getArray();
+    unsigned int count = width * height;
+    float minHeight = FLT_MAX;
+    float maxHeight = -FLT_MAX;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        minHeight = std::min(minHeight, heights[i]);
+        maxHeight = std::max(maxHeight, heights[i]);
+    }
+    float range = maxHeight - minHeight;
+    float invRange = range > 0.0f ? 1.0f / range : 0.0f;
+
+    std::vector<unsigned char> data(count * 4);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        unsigned int value = (unsigned int)((heights[i] - minHeight) * invRange * 65535.0f + 0.5f);
+        data[i * 4] = (unsigned char)(value >> 8);
+        data[i * 4 + 1] = (unsigned char)(value & 0xff);
+        data[i * 4 + 2] = 0;
+        data[i * 4 + 3] = 0;
+    }
+
+    Texture* texture = Texture::create(Texture::RGBA, width, height, &data[0], false);
+    if (!texture)
+    {
+        GP_WARN("Failed to create terrain height map; terrain geomorphing is disabled.");
+        return false;
+    }
+    _heightMap = Texture::Sampler::create(texture);
+    _heightMap->setFilterMode(Texture::NEAREST, Texture::NEAREST);
+    _heightMap->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    SAFE_RELEASE(texture);
+
+    _heightRange.set(minHeight * _localScale.y, range * _localScale.y);
+    return true;
+}
+
+void Terrain::updateSplatting()
+{
+    if (!_splatting || !(_dirtyFlags & DIRTY_FLAG_SPLATTING))
+        return;
+    _dirtyFlags &= ~DIRTY_FLAG_SPLATTING;
+
+    SAFE_RELEASE(_layerAtlas);
+    SAFE_RELEASE(_splatMap);
+    _layerRects.clear();
+    _layerRepeats.clear();
+
+    size_t layerCount = _splatLayers.size();
+    if (layerCount == 0)
+        return;
+    if (layerCount > TERRAIN_MAX_SPLAT_LAYERS)
+    {
+        GP_WARN("Splatting terrains support at most %u layers; ignoring %u layers.", TERRAIN_MAX_SPLAT_LAYERS, (unsigned int)(layerCount - TERRAIN_MAX_SPLAT_LAYERS));
+        layerCount = TERRAIN_MAX_SPLAT_LAYERS;
+    }
+
+    // All layer textures must have the same power of two size, so that they fit into
+    // the cells of an atlas that can be mipmapped.
+    std::vector<Image*> images;
+    unsigned int width = 0;
+    unsigned int height = 0;
+    bool valid = true;
+    for (size_t i = 0; i < layerCount && valid; ++i)
+    {
+        const char* path = _splatLayers[i].texturePath.c_str();
+        Image* image = Image::create(path);
+        if (!image)
+        {
+            GP_WARN("Failed to load terrain layer image for splatting: %s", path);
+            valid = false;
+            break;
+        }
+        images.push_back(image);
+        if (i == 0)
+        {
+            width = image->getWidth();
+            height = image->getHeight();
+        }
+        if (image->getWidth() != width || image->getHeight() != height || (width & (width - 1)) != 0 || (height & (height - 1)) != 0)
+        {
+            GP_WARN("Terrain layer image %s must be a power of two size that matches the base layer for splatting.", path);
+            valid = false;
+        }
+    }
+
+    // Each layer is stored at twice its size in both directions, starting half way
+    // into the texture, so that a full repetition is surrounded by wrapped texels.
+    unsigned int cellWidth = width * 2;
+    unsigned int cellHeight = height * 2;
+    unsigned int columns = 1;
+    unsigned int rows = 1;
+    while (columns * columns < layerCount)
+        columns *= 2;
+    while (columns * rows < layerCount)
+        rows *= 2;
+    unsigned int atlasWidth = columns * cellWidth;
+    unsigned int atlasHeight = rows * cellHeight;
+    GLint maxTextureSize = 0;
+    GL_ASSERT( glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize) );
+
+    if (valid && (atlasWidth > (unsigned int)maxTextureSize || atlasHeight > (unsigned int)maxTextureSize))
+    {
+        GP_WARN("Terrain layer atlas of %ux%u exceeds the maximum texture size of %d.", atlasWidth, atlasHeight, maxTextureSize);
+        valid = false;
+    }
+    if (!valid)
+    {
+        for (size_t i = 0; i < images.size(); ++i)
+            SAFE_RELEASE(images[i]);
+        GP_WARN("Terrain layers can't be packed for splatting; using per-patch layers instead.");
+        disableSplatting();
+        return;
+    }
+
+    std::vector<unsigned char> atlas((size_t)atlasWidth * atlasHeight * 4);
+    for (size_t i = 0; i < layerCount; ++i)
+    {
+        Image* image = images[i];
+        unsigned int pixelSize = image->getFormat() == Image::RGBA ? 4 : 3;
+        const unsigned char* data = image->getData();
+        unsigned int cellX = (unsigned int)(i % columns) * cellWidth;
+        unsigned int cellY = (unsigned int)(i / columns) * cellHeight;
+        for (unsigned int y = 0; y < cellHeight; ++y)
+        {
+            const unsigned char* src = data + (size_t)((y + height / 2) % height) * width * pixelSize;
+            unsigned char* dst = &atlas[((size_t)(cellY + y) * atlasWidth + cellX) * 4];
+            for (unsigned int x = 0; x < cellWidth; ++x, dst += 4)
+            {
+                const unsigned char* texel = src + ((x + width / 2) % width) * pixelSize;
+                dst[0] = texel[0];
+                dst[1] = texel[1];
+                dst[2] = texel[2];
+                dst[3] = pixelSize == 4 ? texel[3] : 255;
+            }
+        }
+        SAFE_RELEASE(images[i]);
+
+        _layerRects.push_back(Vector4((cellX + width * 0.5f) / atlasWidth, (cellY + height * 0.5f) / atlasHeight,
+            (float)width / atlasWidth, (float)height / atlasHeight));
+        _layerRepeats.push_back(_splatLayers[i].textureRepeat);
+    }
+
+    Texture* texture = Texture::create(Texture::RGBA, atlasWidth, atlasHeight, &atlas[0], true);
+    GP_ASSERT(texture);
+    _layerAtlas = Texture::Sampler::create(texture);
+    _layerAtlas->setFilterMode(Texture::LINEAR_MIPMAP_LINEAR, Texture::LINEAR);
+    _layerAtlas->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    SAFE_RELEASE(texture);
+
+    // The blend channel of each layer above the base layer is copied into one channel of
+    // the splat map, which has the size of the first blend map. Layers without a blend
+    // map completely cover the layers below them, as they do without splatting.
+    std::map<std::string, Image*> blendImages;
+    for (size_t i = 1; i < layerCount; ++i)
+    {
+        const std::string& path = _splatLayers[i].blendPath;
+        if (!path.empty() && blendImages.find(path) == blendImages.end())
+        {
+            Image* image = Image::create(path.c_str());
+            if (!image)
+                GP_WARN("Failed to load terrain blend map for splatting: %s", path.c_str());
+            blendImages[path] = image;
+        }
+    }
+    unsigned int splatWidth = 1;
+    unsigned int splatHeight = 1;
+    for (size_t i = 1; i < layerCount; ++i)
+    {
+        std::map<std::string, Image*>::const_iterator itr = blendImages.find(_splatLayers[i].blendPath);
+        if (itr != blendImages.end() && itr->second)
+        {
+            splatWidth = itr->second->getWidth();
+            splatHeight = itr->second->getHeight();
+            break;
+        }
+    }
+
+    std::vector<unsigned char> splat((size_t)splatWidth * splatHeight * 4, 0);
+    for (size_t i = 1; i < layerCount; ++i)
+    {
+        std::map<std::string, Image*>::const_iterator itr = blendImages.find(_splatLayers[i].blendPath);
+        Image* image = itr != blendImages.end() ? itr->second : NULL;
+        unsigned int pixelSize = image && image->getFormat() == Image::RGBA ? 4 : 3;
+        int channel = _splatLayers[i].blendChannel;
+        for (unsigned int y = 0; y < splatHeight; ++y)
+        {
+            for (unsigned int x = 0; x < splatWidth; ++x)
+            {
+                unsigned char weight = 255;
+                if (image && channel < (int)pixelSize)
+                {
+                    // Blend maps of a different size are resampled to the nearest texel.
+                    unsigned int bx = x * image->getWidth() / splatWidth;
+                    unsigned int by = y * image->getHeight() / splatHeight;
+                    weight = image->getData()[((size_t)by * image->getWidth() + bx) * pixelSize + channel];
+                }
+                splat[((size_t)y * splatWidth + x) * 4 + i - 1] = weight;
+            }
+        }
+    }
+    for (std::map<std::string, Image*>::iterator itr = blendImages.begin(); itr != blendImages.end(); ++itr)
+        SAFE_RELEASE(itr->second);
+
+    texture = Texture::create(Texture::RGBA, splatWidth, splatHeight, &splat[0], false);
+    GP_ASSERT(texture);
+    _splatMap = Texture::Sampler::create(texture);
+    _splatMap->setFilterMode(Texture::LINEAR, Texture::LINEAR);
+    _splatMap->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    SAFE_RELEASE(texture);
+}
+
+void Terrain::disableSplatting()
+{
+    _splatting = false;
+    SAFE_RELEASE(_material);
+
+    std::vector<SplatLayer> layers;
+    layers.swap(_splatLayers);
+    for (size_t i = 0, count = layers.size(); i < count; ++i)
+    {
+        const SplatLayer& layer = layers[i];
+        if (!setLayer(layer.index, layer.texturePath.c_str(), layer.textureRepeat,
+            layer.blendPath.empty() ? NULL : layer.blendPath.c_str(), layer.blendChannel))
+        {
+            GP_WARN("Failed to load terrain layer: %s", layer.texturePath.c_str());
+        }
+    }
+    for (size_t i = 0, count = _patches.size(); i < count; ++i)
+        _patches[i]->setMaterialDirty();
+}
+
+unsigned int Terrain::computeLevel(Camera* camera, const BoundingBox& worldBounds, size_t levelCount) const
+{
+    if (!_heightMap)
+        return TerrainPatch::computeLevel(camera, worldBounds, levelCount);
+
+    // Geomorphing terrains select levels by the distance to the camera, since vertices morph
+    // towards the next level based on their own distance to the camera. Level i is used up
+    // to a distance of lodDistance * 2^i.
+    Vector3 eye = camera->getNode() ? camera->getNode()->getTranslationWorld() : Vector3::zero();
+    float dx = std::max(std::max(worldBounds.min.x - eye.x, eye.x - worldBounds.max.x), 0.0f);
+    float dy = std::max(std::max(worldBounds.min.y - eye.y, eye.y - worldBounds.max.y), 0.0f);
+    float dz = std::max(std::max(worldBounds.min.z - eye.z, eye.z - worldBounds.max.z), 0.0f);
+    float distance = sqrt(dx * dx + dy * dy + dz * dz);
+
+    unsigned int level = 0;
+    float range = _lodDistance;
+    while (level + 1 < levelCount && distance >= range)
+    {
+        ++level;
+        range *= 2.0f;
+    }
+    return level;
+}
+
+Terrain::Quad::Quad() : patch(-1)
+{
+    children[0] = children[1] = children[2] = children[3] = -1;
+}
+
+static int classifyBox(const Frustum& frustum, const BoundingBox& box)
+{
+    // Returns -1 if the box is outside of the frustum, 1 if it is completely inside and 0 otherwise.
+    const Plane* planes[6] = { &frustum.getNear(), &frustum.getFar(), &frustum.getLeft(),
+                               &frustum.getRight(), &frustum.getBottom(), &frustum.getTop() };
+    int result = 1;
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+        float intersection = box.intersects(*planes[i]);
+        if (intersection == Plane::INTERSECTS_BACK)
+            return -1;
+        if (intersection == Plane::INTERSECTS_INTERSECTING)
+            result = 0;
+    }
+    return result;
+}
+
 static float getDefaultHeight(unsigned int width, unsigned int height)
 {
     // When terrain height is not specified, we'll use a default height of ~ 0.3 of the image dimensions
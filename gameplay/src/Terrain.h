@@ -79,6 +79,35 @@ class TerrainAutoBindingResolver;
  * approaches. In practice, the skirts are often not noticeable at all unless the LOD variation
  * is very large and the terrain is excessively hilly on the edge of a LOD transition.
  *
+ * Alternatively, setting geomorphing to true in the terrain file removes both the cracks and
+ * the popping between levels. All patches then draw the same grid mesh for each level, and the
+ * heights are stored in a 16 bit height map texture that is read in the vertex shader, which
+ * uses far less memory than the meshes that are otherwise generated for every patch and level.
+ * Level i is used for patches within lodDistance * 2^i of the camera (lodDistance defaults to
+ * twice the extent of a patch), and vertices smoothly morph towards the grid of the next level
+ * as they approach the end of that range, so neighbouring patches always match. Skirts are not
+ * generated for geomorphing terrains. Geomorphing requires vertex texture support and a patch
+ * size that is a multiple of 2^(detailLevels-1); otherwise the terrain falls back to generated
+ * meshes. A custom terrain material must handle the GEOMORPHING define like terrain.vert does.
+ *
+ * Terrains with many layers normally compile a shader for every combination of layers that
+ * touch a patch, and bind the textures of each patch separately. Setting splatting to true in
+ * the terrain file instead packs up to five layers into a single atlas texture and the blend
+ * maps of the upper four layers into the channels of a single splat map that covers the whole
+ * terrain. All patches then share one shader, and unless geomorphing or DEBUG_PATCHES require
+ * per-patch parameters, one material, so that the whole terrain is drawn with the same state.
+ * The layer textures must be PNG images of the same power of two size, and layers are always
+ * applied to the entire terrain. Each layer occupies four times its size in the atlas, which
+ * keeps the mipmaps of neighbouring layers from bleeding into each other. Terrains whose
+ * layers can't be packed fall back to per-patch layers. A custom terrain material must handle
+ * the SPLAT_LAYER_COUNT define like terrain.frag does.
+ *
+ * Terrain patches are organized into a quadtree, which is traversed when the terrain is
+ * drawn. Frustum culling rejects entire quadrants of patches with a single test and stops
+ * testing the patches of quadrants that are completely within the view frustum. Quadrants
+ * that are far enough away to use the lowest level of detail assign it to all of their
+ * patches without computing it for each patch.
+ *
  * @see http://gameplay3d.github.io/GamePlay/docs/file-formats.html#wiki-Terrain
  */
 class Terrain : public Ref, public Drawable, public Transform::Listener
@@ -88,6 +117,7 @@ class Terrain : public Ref, public Drawable, public Transform::Listener
     friend class PhysicsRigidBody;
     friend class TerrainPatch;
     friend class TerrainAutoBindingResolver;
+    friend class TiledTerrain;
 
 public:
 
@@ -222,6 +252,23 @@ public:
      */
     float getHeight(float x, float z) const;
 
+    /**
+     * Gets the world-space heights, and optionally the world-space normals, of the terrain at
+     * a number of positions on the X,Z plane.
+     *
+     * This returns the same heights as calling getHeight for every position, but transforms and
+     * interpolates the positions in batches, which is considerably faster for large numbers of
+     * queries such as when placing foliage or grounding many characters every frame.
+     *
+     * @param positions The positions to query, whose X and Y components hold the world X and Z coordinates.
+     * @param count The number of positions.
+     * @param heights Receives the height at each position, clamped to the boundaries of the terrain.
+     * @param normals Receives the normalized surface normal at each position, or NULL.
+     *
+     * @script{ignore}
+     */
+    void getHeights(const Vector2* positions, unsigned int count, float* heights, Vector3* normals = NULL) const;
+
     /**
      * Sets the detail textures information for a terrain layer.
      *
@@ -281,6 +328,31 @@ protected:
 
 private:
 
+    /**
+     * A node of the quadtree of patches.
+     */
+    struct Quad
+    {
+        Quad();
+
+        BoundingBox bounds;
+        BoundingBox worldBounds;
+        int children[4];
+        int patch;
+    };
+
+    /**
+     * A layer of a splatting terrain, which is packed into the layer atlas.
+     */
+    struct SplatLayer
+    {
+        int index;
+        std::string texturePath;
+        Vector2 textureRepeat;
+        std::string blendPath;
+        int blendChannel;
+    };
+
     /**
      * Constructor.
      */
@@ -313,6 +385,71 @@ private:
      */
     static Terrain* create(const char* path, Properties* properties);
 
+    /**
+     * Internal method for creating terrain from a heightfield that was already loaded
+     * for the given terrain definition, such as one loaded by a TiledTerrain worker.
+     *
+     * The terrain takes ownership of the heightfield, which may be NULL to load it from
+     * the definition instead.
+     */
+    static Terrain* create(const char* path, Properties* properties, HeightField* heightfield);
+
+    /**
+     * Loads the heightfield referenced by the 'heightmap' of the given terrain definition.
+     *
+     * This method does not call into OpenGL and may be called from any thread.
+     */
+    static HeightField* loadHeightField(Properties* pTerrain, const char* path);
+
+    /**
+     * Returns an estimate of the memory used by the heightfield, patch geometry and
+     * textures of the terrain, in bytes.
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * Creates the texture that geomorphing patches read their heights from.
+     *
+     * @return True if geomorphing is supported for the terrain, false otherwise.
+     */
+    bool createHeightMap(unsigned int patchSize, unsigned int maxStep);
+
+    /**
+     * Packs the layers of a splatting terrain into the layer atlas and their blend maps into
+     * the channels of the splat map, if the layers changed since they were last packed.
+     *
+     * If the layers can't be packed, the terrain falls back to creating the layers for each patch.
+     */
+    void updateSplatting();
+
+    /**
+     * Hands the layers of a splatting terrain to its patches and stops splatting.
+     */
+    void disableSplatting();
+
+    /**
+     * Returns the level of detail to use for patches within the given bounds.
+     */
+    unsigned int computeLevel(Camera* camera, const BoundingBox& worldBounds, size_t levelCount) const;
+
+    /**
+     * Builds the quadtree node that covers the given range of patch rows and columns,
+     * returning its index.
+     */
+    int buildQuadtree(unsigned int row1, unsigned int row2, unsigned int column1, unsigned int column2, unsigned int columns);
+
+    /**
+     * Draws the patches of a quadtree node that are visible from the given camera.
+     *
+     * @param index The index of the quadtree node.
+     * @param camera The camera to cull and select the level of detail for.
+     * @param cull Whether the node must be tested against the view frustum, which is only
+     *      false when one of its parents is completely within the frustum.
+     * @param level The level of detail of all patches of the node, or -1 if it must be computed.
+     * @param wireframe Whether to draw wireframe geometry.
+     */
+    unsigned int drawQuadtree(int index, Camera* camera, bool cull, int level, bool wireframe);
+
     /**
      * @see Transform::Listener::transformChanged.
      */
@@ -320,7 +457,8 @@ private:
 
     /**
      * Returns the terrain's inverse world matrix, used for transforming world-space positions
-     * to local positions for height lookups.
+     * to local positions for height lookups, and updates the scale of heightfield values
+     * to world heights along with it.
      */
     const Matrix& getInverseWorldMatrix() const;
 
@@ -333,9 +471,22 @@ private:
     HeightField* _heightfield;
     Vector3 _localScale;
     std::vector<TerrainPatch*> _patches;
+    std::vector<Quad> _quadtree;
     Texture::Sampler* _normalMap;
+    Texture::Sampler* _heightMap;
+    Vector2 _heightRange;
+    std::vector<Mesh*> _gridMeshes;
+    float _lodDistance;
+    bool _splatting;
+    std::vector<SplatLayer> _splatLayers;
+    Texture::Sampler* _layerAtlas;
+    Texture::Sampler* _splatMap;
+    std::vector<Vector4> _layerRects;
+    std::vector<Vector2> _layerRepeats;
+    Material* _material;
     unsigned int _flags;
     mutable Matrix _inverseWorldMatrix;
+    mutable float _heightScale;
     mutable unsigned int _dirtyFlags;
     BoundingBox _boundingBox;
 };
@@ -56,12 +56,50 @@ TerrainPatch::~TerrainPatch()
     }
 }
 
+void TerrainPatch::buildGeometry(const Terrain* terrain, Geometry* geometry,
+                                 float* heights, unsigned int width, unsigned int height,
+                                 unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
+                                 float xOffset, float zOffset,
+                                 unsigned int maxStep, float verticalSkirtSize)
+{
+    if (!terrain->_gridMeshes.empty())
+    {
+        // Geomorphing patches share the grid meshes of the terrain, so only the bounding box
+        // is computed from the heights.
+        float minHeight = FLT_MAX;
+        float maxHeight = -FLT_MAX;
+        for (unsigned int z = z1; z <= z2; ++z)
+        {
+            for (unsigned int x = x1; x <= x2; ++x)
+            {
+                float h = computeHeight(terrain, heights, width, x, z);
+                minHeight = std::min(minHeight, h);
+                maxHeight = std::max(maxHeight, h);
+            }
+        }
+        const Vector3& scale = terrain->_localScale;
+        geometry->bounds.set(Vector3((x1 + xOffset) * scale.x, minHeight, (z1 + zOffset) * scale.z),
+                             Vector3((x2 + xOffset) * scale.x, maxHeight, (z2 + zOffset) * scale.z));
+        return;
+    }
+
+    // Build patch lods
+    for (unsigned int step = 1; step <= maxStep; step *= 2)
+    {
+        geometry->levels.push_back(LevelGeometry());
+        if (!buildLOD(terrain, &geometry->levels.back(), heights, width, height, x1, z1, x2, z2, xOffset, zOffset, step, verticalSkirtSize))
+            geometry->levels.pop_back();
+    }
+
+    // Set our bounding box using the base LOD mesh
+    if (!geometry->levels.empty())
+        geometry->bounds.set(geometry->levels[0].bounds);
+}
+
 TerrainPatch* TerrainPatch::create(Terrain* terrain, unsigned int index,
                                    unsigned int row, unsigned int column,
-                                   float* heights, unsigned int width, unsigned int height,
                                    unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                                   float xOffset, float zOffset,
-                                   unsigned int maxStep, float verticalSkirtSize)
+                                   Geometry* geometry)
 {
     // Create patch
     TerrainPatch* patch = new TerrainPatch();
@@ -69,20 +107,126 @@ TerrainPatch* TerrainPatch::create(Terrain* terrain, unsigned int index,
     patch->_index = index;
     patch->_row = row;
     patch->_column = column;
+    patch->_boundingBox.set(geometry->bounds);
 
-    // Add patch lods
-    for (unsigned int step = 1; step <= maxStep; step *= 2)
+    if (!terrain->_gridMeshes.empty())
     {
-        patch->addLOD(heights, width, height, x1, z1, x2, z2, xOffset, zOffset, step, verticalSkirtSize);
+        // Geomorphing patches share the grid meshes of the terrain, which places them
+        // and reads their heights in the vertex shader.
+        patch->_sampleBounds.set((float)x1, (float)z1, (float)x2, (float)z2);
+        for (size_t i = 0, count = terrain->_gridMeshes.size(); i < count; ++i)
+        {
+            Level* level = new Level();
+            level->model = Model::create(terrain->_gridMeshes[i]);
+            patch->_levels.push_back(level);
+        }
+        return patch;
     }
 
-    // Set our bounding box using the base LOD mesh
-    BoundingBox& bounds = patch->_boundingBox;
-    bounds.set(patch->_levels[0]->model->getMesh()->getBoundingBox());
+    // Upload patch lods
+    for (size_t i = 0, count = geometry->levels.size(); i < count; ++i)
+    {
+        patch->addLOD(&geometry->levels[i]);
+    }
 
     return patch;
 }
 
+Mesh* TerrainPatch::createGridMesh(unsigned int patchSize, unsigned int step)
+{
+    GP_ASSERT(patchSize % step == 0);
+
+    // The grid holds the offsets of the vertices from the first sample of a patch.
+    unsigned int gridSize = patchSize / step + 1;
+    unsigned int vertexCount = gridSize * gridSize;
+    std::vector<float> vertices(vertexCount * 2);
+    for (unsigned int z = 0; z < gridSize; ++z)
+    {
+        for (unsigned int x = 0; x < gridSize; ++x)
+        {
+            float* v = &vertices[(z * gridSize + x) * 2];
+            v[0] = (float)(x * step);
+            v[1] = (float)(z * step);
+        }
+    }
+
+    VertexFormat::Element elements[] = { VertexFormat::Element(VertexFormat::POSITION, 2) };
+    Mesh* mesh = Mesh::createMesh(VertexFormat(elements, 1), vertexCount);
+    mesh->setVertexData(&vertices[0]);
+
+    unsigned int indexCount = getStripIndexCount(gridSize, gridSize);
+    if (indexCount > USHRT_MAX)
+    {
+        GP_WARN("Index count of %d for terrain grid exceeds the limit of 65535. Please specifiy a smaller patch size.", indexCount);
+        GP_ASSERT(indexCount <= USHRT_MAX);
+    }
+
+    std::vector<unsigned short> indices(indexCount);
+    buildStripIndices(&indices[0], gridSize, gridSize);
+    MeshPart* part = mesh->addPart(Mesh::TRIANGLE_STRIP, Mesh::INDEX16, indexCount);
+    part->setIndexData(&indices[0], 0, indexCount);
+
+    return mesh;
+}
+
+unsigned int TerrainPatch::getStripIndexCount(unsigned int patchWidth, unsigned int patchHeight)
+{
+    return
+        (patchWidth * 2) *      // # indices per row of tris
+        (patchHeight - 1) +     // # rows of tris
+        (patchHeight-2) * 2;    // # degenerate tris
+}
+
+void TerrainPatch::buildStripIndices(unsigned short* indices, unsigned int patchWidth, unsigned int patchHeight)
+{
+    unsigned int index = 0;
+    for (unsigned int z = 0; z < patchHeight-1; ++z)
+    {
+        unsigned int i1 = z * patchWidth;
+        unsigned int i2 = (z+1) * patchWidth;
+
+        // Move left to right for even rows and right to left for odd rows.
+        // Note that this results in two degenerate triangles between rows
+        // for stitching purposes, but actually does not require any extra
+        // indices to achieve this.
+        if (z % 2 == 0)
+        {
+            if (z > 0)
+            {
+                // Add degenerate indices to connect strips
+                indices[index] = indices[index-1];
+                ++index;
+                indices[index++] = i1;
+            }
+
+            // Add row strip
+            for (unsigned int x = 0; x < patchWidth; ++x)
+            {
+                indices[index++] = i1 + x;
+                indices[index++] = i2 + x;
+            }
+        }
+        else
+        {
+            // Add degenerate indices to connect strips
+            if (z > 0)
+            {
+                indices[index] = indices[index-1];
+                ++index;
+                indices[index++] = i2 + ((int)patchWidth-1);
+            }
+
+            // Add row strip
+            for (int x = (int)patchWidth-1; x >= 0; --x)
+            {
+                indices[index++] = i2 + x;
+                indices[index++] = i1 + x;
+            }
+        }
+    }
+    GP_ASSERT(index == getStripIndexCount(patchWidth, patchHeight));
+}
+
 unsigned int TerrainPatch::getMaterialCount() const
 {
     return _levels.size();
@@ -107,10 +251,10 @@ Material* TerrainPatch::getMaterial(int index) const
     return _levels[index]->model->getMaterial();
 }
 
-void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int height,
-                          unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                          float xOffset, float zOffset,
-                          unsigned int step, float verticalSkirtSize)
+bool TerrainPatch::buildLOD(const Terrain* terrain, LevelGeometry* geometry, float* heights, unsigned int width, unsigned int height,
+                            unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
+                            float xOffset, float zOffset,
+                            unsigned int step, float verticalSkirtSize)
 {
     // Allocate vertex data for this patch
     unsigned int patchWidth;
@@ -127,7 +271,7 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
     }
 
     if (patchWidth < 2 || patchHeight < 2)
-        return; // ignore this level, not enough geometry
+        return false; // ignore this level, not enough geometry
 
     if (verticalSkirtSize > 0.0f)
     {
@@ -136,13 +280,14 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
     }
 
     unsigned int vertexCount = patchHeight * patchWidth;
-    unsigned int vertexElements = _terrain->_normalMap ? 5 : 8; //<x,y,z>[i,j,k]<u,v>
-    float* vertices = new float[vertexCount * vertexElements];
+    unsigned int vertexElements = terrain->_normalMap ? 5 : 8; //<x,y,z>[i,j,k]<u,v>
+    geometry->vertices.resize(vertexCount * vertexElements);
+    float* vertices = &geometry->vertices[0];
     unsigned int index = 0;
     Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
     Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
-    float stepXScaled = step * _terrain->_localScale.x;
-    float stepZScaled = step * _terrain->_localScale.z;
+    float stepXScaled = step * terrain->_localScale.x;
+    float stepZScaled = step * terrain->_localScale.z;
     bool zskirt = verticalSkirtSize > 0 ? true : false;
     for (unsigned int z = z1; ; )
     {
@@ -155,11 +300,11 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
             index++;
 
             // Compute position - apply the local scale of the terrain into the vertex data
-            v[0] = (x + xOffset) * _terrain->_localScale.x;
-            v[1] = computeHeight(heights, width, x, z);
+            v[0] = (x + xOffset) * terrain->_localScale.x;
+            v[1] = computeHeight(terrain, heights, width, x, z);
             if (xskirt || zskirt)
-                v[1] -= verticalSkirtSize * _terrain->_localScale.y;
-            v[2] = (z + zOffset) * _terrain->_localScale.z;
+                v[1] -= verticalSkirtSize * terrain->_localScale.y;
+            v[2] = (z + zOffset) * terrain->_localScale.z;
 
             // Update bounding box min/max (don't include vertical skirt vertices in bounding box)
             if (!(xskirt || zskirt))
@@ -179,13 +324,13 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
             }
 
             // Compute normal
-            if (!_terrain->_normalMap)
+            if (!terrain->_normalMap)
             {
-                Vector3 p(v[0], computeHeight(heights, width, x, z), v[2]);
-                Vector3 w(Vector3(x>=step ? v[0]-stepXScaled : v[0], computeHeight(heights, width, x>=step ? x-step : x, z), v[2]), p);
-                Vector3 e(Vector3(x<width-step ? v[0]+stepXScaled : v[0], computeHeight(heights, width, x<width-step ? x+step : x, z), v[2]), p);
-                Vector3 s(Vector3(v[0], computeHeight(heights, width, x, z>=step ? z-step : z), z>=step ? v[2]-stepZScaled : v[2]), p);
-                Vector3 n(Vector3(v[0], computeHeight(heights, width, x, z<height-step ? z+step : z), z<height-step ? v[2]+stepZScaled : v[2]), p);
+                Vector3 p(v[0], computeHeight(terrain, heights, width, x, z), v[2]);
+                Vector3 w(Vector3(x>=step ? v[0]-stepXScaled : v[0], computeHeight(terrain, heights, width, x>=step ? x-step : x, z), v[2]), p);
+                Vector3 e(Vector3(x<width-step ? v[0]+stepXScaled : v[0], computeHeight(terrain, heights, width, x<width-step ? x+step : x, z), v[2]), p);
+                Vector3 s(Vector3(v[0], computeHeight(terrain, heights, width, x, z>=step ? z-step : z), z>=step ? v[2]-stepZScaled : v[2]), p);
+                Vector3 n(Vector3(v[0], computeHeight(terrain, heights, width, x, z<height-step ? z+step : z), z<height-step ? v[2]+stepZScaled : v[2]), p);
                 Vector3 normals[4];
                 Vector3::cross(n, w, &normals[0]);
                 Vector3::cross(w, s, &normals[1]);
@@ -250,6 +395,29 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
     }
     GP_ASSERT(index == vertexCount);
 
+    geometry->vertexCount = vertexCount;
+    geometry->bounds.set(min, max);
+
+    // Build indices
+    unsigned int indexCount = getStripIndexCount(patchWidth, patchHeight);
+
+    // Support a maximum number of indices of USHRT_MAX. Any more indices we will require breaking up the
+    // terrain into smaller patches.
+    if (indexCount > USHRT_MAX)
+    {
+        GP_WARN("Index count of %d for terrain patch exceeds the limit of 65535. Please specifiy a smaller patch size.", indexCount);
+        GP_ASSERT(indexCount <= USHRT_MAX);
+    }
+
+    geometry->indices.resize(indexCount);
+    buildStripIndices(&geometry->indices[0], patchWidth, patchHeight);
+    return true;
+}
+
+void TerrainPatch::addLOD(LevelGeometry* geometry)
+{
+    const Vector3& min = geometry->bounds.min;
+    const Vector3& max = geometry->bounds.max;
     Vector3 center(min + ((max - min) * 0.5f));
 
     // Create mesh
@@ -265,77 +433,19 @@ void TerrainPatch::addLOD(float* heights, unsigned int width, unsigned int heigh
         elements[2] = VertexFormat::Element(VertexFormat::TEXCOORD0, 2);
     }
     VertexFormat format(elements, _terrain->_normalMap ? 2 : 3);
-    Mesh* mesh = Mesh::createMesh(format, vertexCount);
-    mesh->setVertexData(vertices);
-    mesh->setBoundingBox(BoundingBox(min, max));
+    Mesh* mesh = Mesh::createMesh(format, geometry->vertexCount);
+    mesh->setVertexData(&geometry->vertices[0]);
+    mesh->setBoundingBox(geometry->bounds);
     mesh->setBoundingSphere(BoundingSphere(center, center.distance(max)));
 
     // Add mesh part for indices
-    unsigned int indexCount =
-        (patchWidth * 2) *      // # indices per row of tris
-        (patchHeight - 1) +     // # rows of tris
-        (patchHeight-2) * 2;    // # degenerate tris
-
-    // Support a maximum number of indices of USHRT_MAX. Any more indices we will require breaking up the
-    // terrain into smaller patches.
-    if (indexCount > USHRT_MAX)
-    {
-        GP_WARN("Index count of %d for terrain patch exceeds the limit of 65535. Please specifiy a smaller patch size.", indexCount);
-        GP_ASSERT(indexCount <= USHRT_MAX);
-    }
-
+    unsigned int indexCount = (unsigned int)geometry->indices.size();
     MeshPart* part = mesh->addPart(Mesh::TRIANGLE_STRIP, Mesh::INDEX16, indexCount);
-    unsigned short* indices = new unsigned short[indexCount];
-    index = 0;
-    for (unsigned int z = 0; z < patchHeight-1; ++z)
-    {
-        unsigned int i1 = z * patchWidth;
-        unsigned int i2 = (z+1) * patchWidth;
-
-        // Move left to right for even rows and right to left for odd rows.
-        // Note that this results in two degenerate triangles between rows
-        // for stitching purposes, but actually does not require any extra
-        // indices to achieve this.
-        if (z % 2 == 0)
-        {
-            if (z > 0)
-            {
-                // Add degenerate indices to connect strips
-                indices[index] = indices[index-1];
-                ++index;
-                indices[index++] = i1;
-            }
-
-            // Add row strip
-            for (unsigned int x = 0; x < patchWidth; ++x)
-            {
-                indices[index++] = i1 + x;
-                indices[index++] = i2 + x;
-            }
-        }
-        else
-        {
-            // Add degenerate indices to connect strips
-            if (z > 0)
-            {
-                indices[index] = indices[index-1];
-                ++index;
-                indices[index++] = i2 + ((int)patchWidth-1);
-            }
+    part->setIndexData(&geometry->indices[0], 0, indexCount);
 
-            // Add row strip
-            for (int x = (int)patchWidth-1; x >= 0; --x)
-            {
-                indices[index++] = i2 + x;
-                indices[index++] = i1 + x;
-            }
-        }
-    }
-    GP_ASSERT(index == indexCount);
-    part->setIndexData(indices, 0, indexCount);
-
-    SAFE_DELETE_ARRAY(vertices);
-    SAFE_DELETE_ARRAY(indices);
+    // The data has been uploaded, so it is released right away
+    std::vector<float>().swap(geometry->vertices);
+    std::vector<unsigned short>().swap(geometry->indices);
 
     // Create model
     Model* model = Model::create(mesh);
@@ -492,6 +602,10 @@ std::string TerrainPatch::passCreated(Pass* pass)
     defines << "LAYER_COUNT " << _layers.size();
     defines << ";SAMPLER_COUNT " << _samplers.size();
 
+    // Splatting terrains read all layers from the atlas, so every patch uses the same defines.
+    if (_terrain->_layerAtlas)
+        defines << ";SPLAT_LAYER_COUNT " << _terrain->_layerRects.size();
+
     if (_terrain->isFlagSet(Terrain::DEBUG_PATCHES))
     {
         defines << ";DEBUG_PATCHES";
@@ -502,6 +616,9 @@ std::string TerrainPatch::passCreated(Pass* pass)
     if (_terrain->_normalMap)
         defines << ";NORMAL_MAP";
 
+    if (_terrain->_heightMap)
+        defines << ";GEOMORPHING";
+
     // Append texture and blend index constants to preprocessor definition.
     // We need to do this since older versions of GLSL only allow sampler arrays
     // to be indexed using constant expressions (otherwise we could simply pass an
@@ -532,10 +649,37 @@ bool TerrainPatch::updateMaterial()
     if (!(_bits & TERRAINPATCH_DIRTY_MATERIAL))
         return true;
 
+    // Packing the layers of a splatting terrain may hand them to the patches instead,
+    // which dirties their materials again.
+    _terrain->updateSplatting();
+
     _bits &= ~TERRAINPATCH_DIRTY_MATERIAL;
 
     __currentPatchIndex = _index;
 
+    // Without per-patch parameters, all patches and levels of a splatting terrain share one material.
+    if (_terrain->_splatting && !_terrain->_heightMap && !_terrain->isFlagSet(Terrain::DEBUG_PATCHES))
+    {
+        if (!_terrain->_material)
+        {
+            _terrain->_material = Material::create(_terrain->_materialPath.c_str(), &passCallback, this);
+            if (!_terrain->_material)
+            {
+                GP_WARN("Failed to load material for terrain: %s", _terrain->_materialPath.c_str());
+                __currentPatchIndex = -1;
+                return false;
+            }
+            _terrain->_material->setNodeBinding(_terrain->_node);
+            bindSplatting(_terrain->_material);
+        }
+
+        for (size_t i = 0, count = _levels.size(); i < count; ++i)
+            _levels[i]->model->setMaterial(_terrain->_material);
+
+        __currentPatchIndex = -1;
+        return true;
+    }
+
     for (size_t i = 0, count = _levels.size(); i < count; ++i)
     {
         Material* material = Material::create(_terrain->_materialPath.c_str(), &passCallback, this);
@@ -549,6 +693,11 @@ bool TerrainPatch::updateMaterial()
 
         material->setNodeBinding(_terrain->_node);
 
+        if (_terrain->_heightMap)
+            bindGeomorphing(material, (unsigned int)i);
+        if (_terrain->_layerAtlas)
+            bindSplatting(material);
+
         // Set material on this lod level
         _levels[i]->model->setMaterial(material);
 
@@ -560,6 +709,39 @@ bool TerrainPatch::updateMaterial()
     return true;
 }
 
+void TerrainPatch::bindGeomorphing(Material* material, unsigned int level)
+{
+    Texture* texture = _terrain->_heightMap->getTexture();
+    material->getParameter("u_heightMap")->setValue(_terrain->_heightMap);
+    material->getParameter("u_heightMapSize")->setValue(Vector2((float)texture->getWidth(), (float)texture->getHeight()));
+    material->getParameter("u_heightRange")->setValue(_terrain->_heightRange);
+    material->getParameter("u_terrainScale")->setValue(_terrain->_localScale);
+    material->getParameter("u_terrainOffset")->setValue(Vector2((texture->getWidth() - 1) * -0.5f, (texture->getHeight() - 1) * -0.5f));
+    material->getParameter("u_patchBounds")->setValue(_sampleBounds);
+    material->getParameter("u_gridStep")->setValue((float)(1 << level));
+
+    // Vertices morph towards the next level over the last fifth of the range of their level.
+    // The lowest level of detail never morphs.
+    Vector2 morphRange(FLT_MAX, 0.0f);
+    if (level + 1 < _levels.size())
+    {
+        float end = _terrain->_lodDistance * (float)(1 << level);
+        float start = end * 0.8f;
+        morphRange.set(start, 1.0f / (end - start));
+    }
+    material->getParameter("u_morphRange")->setValue(morphRange);
+    material->setParameterAutoBinding("u_worldMatrix", RenderState::WORLD_MATRIX);
+    material->setParameterAutoBinding("u_cameraPosition", RenderState::CAMERA_WORLD_POSITION);
+}
+
+void TerrainPatch::bindSplatting(Material* material)
+{
+    material->getParameter("u_layerAtlas")->setValue(_terrain->_layerAtlas);
+    material->getParameter("u_splatMap")->setValue(_terrain->_splatMap);
+    material->getParameter("u_layerRects")->setValue(&_terrain->_layerRects[0], (unsigned int)_terrain->_layerRects.size());
+    material->getParameter("u_layerRepeats")->setValue(&_terrain->_layerRepeats[0], (unsigned int)_terrain->_layerRepeats.size());
+}
+
 void TerrainPatch::updateNodeBindings()
 {
     __currentPatchIndex = _index;
@@ -570,25 +752,18 @@ void TerrainPatch::updateNodeBindings()
     __currentPatchIndex = -1;
 }
 
-unsigned int TerrainPatch::draw(bool wireframe)
+unsigned int TerrainPatch::draw(Camera* camera, int level, bool wireframe)
 {
-    Scene* scene = _terrain->_node ? _terrain->_node->getScene() : NULL;
-    Camera* camera = scene ? scene->getActiveCamera() : NULL;
-    if (!camera)
-        return 0;
-
-    // Get our world-space bounding box
-    BoundingBox bounds = getBoundingBox(true);
-
-    // If the box does not intersect the view frustum, cull it
-    if (_terrain->isFlagSet(Terrain::FRUSTUM_CULLING) && !camera->getFrustum().intersects(bounds))
-        return 0;
+    GP_ASSERT(camera);
 
     if (!updateMaterial())
         return 0;
 
-    // Compute the LOD level from the camera's perspective
-    _level = computeLOD(camera, bounds);
+    // Compute the LOD level from the camera's perspective, unless the terrain already chose it
+    if (level >= 0)
+        _level = std::min((size_t)level, _levels.size() - 1);
+    else
+        _level = computeLOD(camera, getBoundingBox(true));
 
     // Draw the model for the current LOD
     return _levels[_level]->model->draw(wireframe);
@@ -619,6 +794,11 @@ void TerrainPatch::cameraChanged(Camera* camera)
     _bits |= TERRAINPATCH_DIRTY_LEVEL;
 }
 
+void TerrainPatch::setBoundsDirty()
+{
+    _bits |= TERRAINPATCH_DIRTY_BOUNDS | TERRAINPATCH_DIRTY_LEVEL;
+}
+
 unsigned int TerrainPatch::computeLOD(Camera* camera, const BoundingBox& worldBounds) 
 {
     if (camera != _camera)
@@ -643,6 +823,13 @@ unsigned int TerrainPatch::computeLOD(Camera* camera, const BoundingBox& worldBo
 
     _bits &= ~TERRAINPATCH_DIRTY_LEVEL;
 
+    _level = _terrain->computeLevel(camera, worldBounds, _levels.size());
+
+    return _level;
+}
+
+unsigned int TerrainPatch::computeLevel(Camera* camera, const BoundingBox& worldBounds, size_t levelCount)
+{
     // Compute LOD to use based on very simple distance metric. TODO: Optimize me.
     Game* game = Game::getInstance();
     Rectangle vp(0, 0, game->getWidth(), game->getHeight());
@@ -669,13 +856,11 @@ unsigned int TerrainPatch::computeLOD(Camera* camera, const BoundingBox& worldBo
     float error = screenArea / area;
 
     // Level LOD based on distance from camera
-    size_t maxLod = _levels.size()-1;
+    size_t maxLod = levelCount-1;
     size_t lod = (size_t)error;
     lod = std::max(lod, (size_t)0);
     lod = std::min(lod, maxLod);
-    _level = lod;
-
-    return _level;
+    return (unsigned int)lod;
 }
 
 const Vector3& TerrainPatch::getAmbientColor() const
@@ -689,9 +874,9 @@ void TerrainPatch::setMaterialDirty()
     _bits |= TERRAINPATCH_DIRTY_MATERIAL;
 }
 
-float TerrainPatch::computeHeight(float* heights, unsigned int width, unsigned int x, unsigned int z)
+float TerrainPatch::computeHeight(const Terrain* terrain, float* heights, unsigned int width, unsigned int x, unsigned int z)
 {
-    return heights[z * width + x] * _terrain->_localScale.y;
+    return heights[z * width + x] * terrain->_localScale.y;
 }
 
 TerrainPatch::Layer::Layer() :
@@ -105,15 +105,47 @@ private:
         bool operator() (const Layer* lhs, const Layer* rhs) const;
     };
 
+    /**
+     * The vertices and indices of a level, generated before the mesh is created.
+     */
+    struct LevelGeometry
+    {
+        std::vector<float> vertices;
+        std::vector<unsigned short> indices;
+        unsigned int vertexCount;
+        BoundingBox bounds;
+    };
+
+    /**
+     * The generated geometry of all levels of a patch.
+     */
+    struct Geometry
+    {
+        std::vector<LevelGeometry> levels;
+        BoundingBox bounds;
+    };
+
+    static void buildGeometry(const Terrain* terrain, Geometry* geometry,
+                              float* heights, unsigned int width, unsigned int height,
+                              unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
+                              float xOffset, float zOffset, unsigned int maxStep, float verticalSkirtSize);
+
     static TerrainPatch* create(Terrain* terrain, unsigned int index,
                                 unsigned int row, unsigned int column,
-                                float* heights, unsigned int width, unsigned int height,
                                 unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                                float xOffset, float zOffset, unsigned int maxStep, float verticalSkirtSize);
+                                Geometry* geometry);
+
+    static Mesh* createGridMesh(unsigned int patchSize, unsigned int step);
+
+    static unsigned int getStripIndexCount(unsigned int patchWidth, unsigned int patchHeight);
+
+    static void buildStripIndices(unsigned short* indices, unsigned int patchWidth, unsigned int patchHeight);
+
+    static bool buildLOD(const Terrain* terrain, LevelGeometry* geometry, float* heights, unsigned int width, unsigned int height,
+                         unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
+                         float xOffset, float zOffset, unsigned int step, float verticalSkirtSize);
 
-    void addLOD(float* heights, unsigned int width, unsigned int height,
-                unsigned int x1, unsigned int z1, unsigned int x2, unsigned int z2,
-                float xOffset, float zOffset, unsigned int step, float verticalSkirtSize);
+    void addLOD(LevelGeometry* geometry);
 
 
     bool setLayer(int index, const char* texturePath, const Vector2& textureRepeat, const char* blendPath, int blendChannel);
@@ -122,17 +154,25 @@ private:
 
     int addSampler(const char* path);
 
-    unsigned int draw(bool wireframe);
+    unsigned int draw(Camera* camera, int level, bool wireframe);
 
     bool updateMaterial();
 
+    void bindGeomorphing(Material* material, unsigned int level);
+
+    void bindSplatting(Material* material);
+
     unsigned int computeLOD(Camera* camera, const BoundingBox& worldBounds);
 
+    static unsigned int computeLevel(Camera* camera, const BoundingBox& worldBounds, size_t levelCount);
+
     const Vector3& getAmbientColor() const;
 
     void setMaterialDirty();
 
-    float computeHeight(float* heights, unsigned int width, unsigned int x, unsigned int z);
+    void setBoundsDirty();
+
+    static float computeHeight(const Terrain* terrain, float* heights, unsigned int width, unsigned int x, unsigned int z);
 
     void updateNodeBindings();
 
@@ -145,6 +185,7 @@ private:
     std::vector<Level*> _levels;
     std::set<Layer*, LayerCompare> _layers;
     std::vector<Texture::Sampler*> _samplers;
+    Vector4 _sampleBounds;
     mutable BoundingBox _boundingBox;
     mutable BoundingBox _boundingBoxWorld;
     mutable Camera* _camera;
@@ -36,13 +36,14 @@ Text* Text::create(const char* fontPath, const char* str, const Vector4& color,
     if (size == 0)
     {
         size = font->_size;
-        drawFont = font;
+        drawFont = font->findClosestSize(size);
     }
     else
     {
-        // Delegate to closest sized font
+        // Delegate to closest sized font. Distance fields are drawn at the requested size.
         drawFont = font->findClosestSize(size);
-        size = drawFont->_size;
+        if (drawFont->_format != Font::DISTANCE_FIELD)
+            size = drawFont->_size;
     }
     unsigned int widthOut, heightOut;
     font->measureText(str, size, &widthOut, &heightOut);
@@ -68,6 +68,7 @@ void TextBox::setCaretLocation(unsigned int index)
     _caretLocation = index;
     if (_caretLocation > _text.length())
         _caretLocation = (unsigned int)_text.length();
+    setGeometryDirty();
 }
 
 bool TextBox::touchEvent(Touch::TouchEvent evt, int x, int y, unsigned int contactIndex)
@@ -139,6 +140,9 @@ static unsigned int findNextWord(const std::string& text, unsigned int from, boo
 
 bool TextBox::keyEvent(Keyboard::KeyEvent evt, int key)
 {
+    // Keys edit the text and move the caret without changing the state of the text box.
+    setGeometryDirty();
+
     switch (evt)
     {
         case Keyboard::KEY_PRESS:
@@ -278,8 +282,23 @@ bool TextBox::keyEvent(Keyboard::KeyEvent evt, int key)
                     {
                         if (_caretLocation <= _text.length())
                         {
-                            _text.insert(_caretLocation, 1, (char)key);
-                            ++_caretLocation;
+                            // Characters beyond ASCII, which only fonts rasterised at runtime
+                            // support, are inserted as UTF-8.
+                            char bytes[4];
+                            unsigned int length = 1;
+                            if (key < 0x80)
+                            {
+                                bytes[0] = (char)key;
+                            }
+                            else
+                            {
+                                length = key < 0x800 ? 2 : (key < 0x10000 ? 3 : 4);
+                                bytes[0] = (char)((0xF00 >> length) | (key >> (6 * (length - 1))));
+                                for (unsigned int i = 1; i < length; ++i)
+                                    bytes[i] = (char)(0x80 | ((key >> (6 * (length - 1 - i))) & 0x3F));
+                            }
+                            _text.insert(_caretLocation, bytes, length);
+                            _caretLocation += length;
                         }
 
                         notifyListeners(Control::Listener::TEXT_CHANGED);
@@ -481,6 +500,7 @@ void TextBox::getCaretLocation(Vector2* p)
 void TextBox::setPasswordChar(char character)
 {
     _passwordChar = character;
+    setGeometryDirty();
 }
 
 char TextBox::getPasswordChar() const
@@ -491,6 +511,7 @@ char TextBox::getPasswordChar() const
 void TextBox::setInputMode(InputMode inputMode)
 {
     _inputMode = inputMode;
+    setGeometryDirty();
 }
 
 TextBox::InputMode TextBox::getInputMode() const
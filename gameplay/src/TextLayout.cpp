@@ -0,0 +1,74 @@
+#include "Base.h"
+#include "TextLayout.h"
+
+namespace gameplay
+{
+
+TextLayout::TextLayout(Font* font, bool referenced)
+    : _font(font), _referenced(referenced), _size(0), _justify(Font::ALIGN_TOP_LEFT), _wrap(true), _rightToLeft(false), _generation(0), _lastDrawn(0)
+{
+    GP_ASSERT(font);
+
+    if (_referenced)
+        _font->addRef();
+}
+
+TextLayout::~TextLayout()
+{
+    if (_referenced)
+        SAFE_RELEASE(_font);
+}
+
+TextLayout* TextLayout::create(Font* font, const char* text, const Rectangle& area, unsigned int size, Font::Justify justify, bool wrap, bool rightToLeft)
+{
+    GP_ASSERT(font);
+    GP_ASSERT(font->_size);
+    GP_ASSERT(text);
+
+    // The glyphs are positioned and drawn by the size of the font closest to the size of the text.
+    if (size == 0)
+        size = font->_size;
+    Font* drawFont = font->findClosestSize(size);
+
+    TextLayout* layout = new TextLayout(drawFont, true);
+    layout->_text = text;
+    layout->_area = area;
+    layout->_size = size;
+    layout->_justify = justify;
+    layout->_wrap = wrap;
+    layout->_rightToLeft = rightToLeft;
+    drawFont->layoutText(layout);
+    return layout;
+}
+
+Font* TextLayout::getFont() const
+{
+    return _font;
+}
+
+const char* TextLayout::getText() const
+{
+    return _text.c_str();
+}
+
+const Rectangle& TextLayout::getArea() const
+{
+    return _area;
+}
+
+unsigned int TextLayout::getGlyphCount() const
+{
+    return (unsigned int)_quads.size();
+}
+
+void TextLayout::draw(const Vector4& color, const Rectangle& clip)
+{
+    _font->drawLayout(this, color, clip);
+}
+
+bool TextLayout::matches(const char* text, const Rectangle& area, unsigned int size, Font::Justify justify, bool wrap, bool rightToLeft) const
+{
+    return _size == size && _justify == justify && _wrap == wrap && _rightToLeft == rightToLeft && _area == area && _text == text;
+}
+
+}
@@ -0,0 +1,150 @@
+#ifndef TEXTLAYOUT_H_
+#define TEXTLAYOUT_H_
+
+#include "Ref.h"
+#include "Font.h"
+#include "Rectangle.h"
+#include "Vector4.h"
+
+namespace gameplay
+{
+
+/**
+ * Defines the glyphs of a text laid out within a rectangular area, positioned once so that
+ * the text can be drawn any number of times without being measured again.
+ *
+ * Font::drawText keeps the layouts of the texts it draws within an area in a cache, which it
+ * looks up by their text, size, area, justification and wrapping, so that texts that do not
+ * change are only laid out once. A layout can also be created and kept for a text that is
+ * drawn often, which skips the cache lookup as well.
+ *
+ * The layouts of fonts created with Font::createDynamic are laid out again when they are drawn
+ * after glyphs of the font have been evicted from its glyph page.
+ *
+ * A layout is the text as it was laid out when created: changing the character spacing of its
+ * font, or the text it was created from, requires creating a new layout.
+ */
+class TextLayout : public Ref
+{
+    friend class Font;
+
+public:
+
+    /**
+     * Lays out the specified text within a rectangular area.
+     *
+     * @param font The font to draw the text with.
+     * @param text The text to lay out.
+     * @param area The viewport area to lay out the text within. Text is clipped outside this rectangle.
+     * @param size The size to draw text (0 for default size).
+     * @param justify Justification of text within the viewport.
+     * @param wrap Wraps text to fit within the width of the viewport if true.
+     * @param rightToLeft Whether to draw text from right to left.
+     *
+     * @return The new layout.
+     * @script{create}
+     */
+    static TextLayout* create(Font* font, const char* text, const Rectangle& area, unsigned int size = 0,
+                              Font::Justify justify = Font::ALIGN_TOP_LEFT, bool wrap = true, bool rightToLeft = false);
+
+    /**
+     * Returns the font that draws the glyphs of the layout, which is the size of the font
+     * that the layout was created with that is the closest to the size of the text.
+     *
+     * @return The font.
+     */
+    Font* getFont() const;
+
+    /**
+     * Returns the text that was laid out.
+     *
+     * @return The text.
+     */
+    const char* getText() const;
+
+    /**
+     * Returns the viewport area that the text was laid out within.
+     *
+     * @return The area.
+     */
+    const Rectangle& getArea() const;
+
+    /**
+     * Returns the number of glyphs drawn by the layout.
+     *
+     * @return The number of glyphs.
+     */
+    unsigned int getGlyphCount() const;
+
+    /**
+     * Draws the glyphs of the layout into the sprite batch of its font, which is started
+     * if needed as for Font::drawText.
+     *
+     * @param color The color of text.
+     * @param clip A region to clip text within after applying justification to the viewport area.
+     */
+    void draw(const Vector4& color, const Rectangle& clip = Rectangle(0, 0, 0, 0));
+
+private:
+
+    /**
+     * A glyph positioned within the area of the layout.
+     */
+    struct Quad
+    {
+        float x;
+        float y;
+        float width;
+        float height;
+        float u1;
+        float v1;
+        float u2;
+        float v2;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param font The font that draws the glyphs.
+     * @param referenced Whether the layout keeps a reference to the font, which the layouts
+     *        cached by the font itself do not.
+     */
+    TextLayout(Font* font, bool referenced);
+
+    /**
+     * Destructor.
+     */
+    ~TextLayout();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TextLayout(const TextLayout& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TextLayout& operator=(const TextLayout&);
+
+    /**
+     * Determines whether the layout was laid out with the given parameters.
+     */
+    bool matches(const char* text, const Rectangle& area, unsigned int size, Font::Justify justify, bool wrap, bool rightToLeft) const;
+
+    Font* _font;
+    bool _referenced;
+    std::string _text;
+    Rectangle _area;
+    unsigned int _size;
+    Font::Justify _justify;
+    bool _wrap;
+    bool _rightToLeft;
+    std::vector<Quad> _quads;
+    std::vector<unsigned int> _slots;
+    unsigned int _generation;
+    unsigned int _lastDrawn;
+};
+
+}
+
+#endif
@@ -1,6 +1,9 @@
 #include "Base.h"
 #include "Image.h"
+#include "RenderStats.h"
+#include "ResourceManager.h"
 #include "Texture.h"
+#include "TextureStreamer.h"
 #include "FileSystem.h"
 
 // PVRTC (GL_IMG_texture_compression_pvrtc) : Imagination based gpus
@@ -44,60 +47,161 @@
 #define ETC1_RGB8 0x8D64
 #endif
 
+// ETC2 and EAC (OpenGL ES 3.0, ARB_ES3_compatibility) : All OpenGL ES 3.0 chipsets
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2 0x9274
+#endif
+
+// ASTC (KHR_texture_compression_astc_ldr) : Mali, Adreno 4xx and later, Apple A8 and later
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR 0x93B0
+#endif
+
+// The endianness field of KTX files, as read on a machine of the same and of the other endianness.
+#define KTX_ENDIANNESS 0x04030201
+#define KTX_ENDIANNESS_SWAPPED 0x01020304
+
 namespace gameplay
 {
 
-static std::vector<Texture*> __textureCache;
-static TextureHandle __currentTextureId = 0;
-static Texture::Type __currentTextureType = Texture::TEXTURE_2D;
+// The number of texture units whose bindings are tracked to skip redundant binds.
+#define TEXTURE_UNIT_COUNT 32
+
+static TextureHandle __currentTextureId[TEXTURE_UNIT_COUNT] = { 0 };
+static Texture::Type __currentTextureType[TEXTURE_UNIT_COUNT] = { (Texture::Type)0 };
+static unsigned int __currentTextureUnit = 0;
+
+#ifdef GP_USE_SAMPLER_OBJECTS
+/**
+ * A sampler object, which is shared by all samplers with the same state.
+ */
+struct SamplerObject
+{
+    Texture::Wrap wrapS;
+    Texture::Wrap wrapT;
+    Texture::Wrap wrapR;
+    Texture::Filter minFilter;
+    Texture::Filter magFilter;
+    GLuint handle;
+};
+
+static std::vector<SamplerObject> __samplerObjects;
+static GLuint __currentSamplerObject[TEXTURE_UNIT_COUNT] = { 0 };
+
+/**
+ * Returns whether the device supports sampler objects.
+ */
+static bool isSamplerObjectSupported()
+{
+    static int supported = -1;
+    if (supported < 0)
+        supported = (glGenSamplers && glBindSampler && glSamplerParameteri) ? 1 : 0;
+    return supported == 1;
+}
+
+/**
+ * Returns the sampler object with the given state, creating it the first time it is needed.
+ */
+static GLuint getSamplerObject(Texture::Wrap wrapS, Texture::Wrap wrapT, Texture::Wrap wrapR, Texture::Filter minFilter, Texture::Filter magFilter)
+{
+    // There are only ever a few distinct sampler states.
+    for (size_t i = 0, count = __samplerObjects.size(); i < count; ++i)
+    {
+        const SamplerObject& o = __samplerObjects[i];
+        if (o.wrapS == wrapS && o.wrapT == wrapT && o.wrapR == wrapR && o.minFilter == minFilter && o.magFilter == magFilter)
+            return o.handle;
+    }
+
+    SamplerObject o = { wrapS, wrapT, wrapR, minFilter, magFilter, 0 };
+    GL_ASSERT( glGenSamplers(1, &o.handle) );
+    GL_ASSERT( glSamplerParameteri(o.handle, GL_TEXTURE_MIN_FILTER, (GLenum)minFilter) );
+    GL_ASSERT( glSamplerParameteri(o.handle, GL_TEXTURE_MAG_FILTER, (GLenum)magFilter) );
+    GL_ASSERT( glSamplerParameteri(o.handle, GL_TEXTURE_WRAP_S, (GLenum)wrapS) );
+    GL_ASSERT( glSamplerParameteri(o.handle, GL_TEXTURE_WRAP_T, (GLenum)wrapT) );
+    GL_ASSERT( glSamplerParameteri(o.handle, GL_TEXTURE_WRAP_R, (GLenum)wrapR) );
+    __samplerObjects.push_back(o);
+    return o.handle;
+}
+#endif
+
+// Rebinds the texture that was bound to the active unit before a texture was created or modified.
+static void restoreCurrentTexture()
+{
+    Texture::Type type = __currentTextureType[__currentTextureUnit];
+    GL_ASSERT( glBindTexture(type ? (GLenum)type : GL_TEXTURE_2D, __currentTextureId[__currentTextureUnit]) );
+}
+
+// Pixel buffer objects are core in OpenGL 2.1 and OpenGL ES 3.0.
+#if !defined(OPENGL_ES) || defined(GL_ES_VERSION_3_0)
+#define TEXTURE_PIXEL_BUFFER
+#endif
 
-Texture::Texture() : _handle(0), _format(UNKNOWN), _type((Texture::Type)0), _width(0), _height(0), _mipmapped(false), _cached(false), _compressed(false),
-    _wrapS(Texture::REPEAT), _wrapT(Texture::REPEAT), _wrapR(Texture::REPEAT), _minFilter(Texture::NEAREST_MIPMAP_LINEAR), _magFilter(Texture::LINEAR)
+struct Texture::PixelBuffer
+{
+    GLuint handle;
+    unsigned char* mapped;
+    unsigned int x;
+    unsigned int y;
+    unsigned int width;
+    unsigned int height;
+    CubeFace face;
+    std::vector<unsigned char> staging;
+};
+
+Texture::Texture() : _handle(0), _format(UNKNOWN), _type((Texture::Type)0), _width(0), _height(0), _mipmapped(false), _cached(false), _compressed(false), _streamed(false),
+    _wrapS(Texture::REPEAT), _wrapT(Texture::REPEAT), _wrapR(Texture::REPEAT), _minFilter(Texture::NEAREST_MIPMAP_LINEAR), _magFilter(Texture::LINEAR),
+    _memorySize(0), _pixelBuffer(NULL)
 {
 }
 
 Texture::~Texture()
 {
+    if (_streamed)
+        TextureStreamer::remove(this);
+
     if (_handle)
     {
+        // Deleting a texture unbinds it from all units, and its handle may be reused.
+        for (unsigned int i = 0; i < TEXTURE_UNIT_COUNT; ++i)
+        {
+            if (__currentTextureId[i] == _handle)
+                __currentTextureId[i] = 0;
+        }
+
         GL_ASSERT( glDeleteTextures(1, &_handle) );
         _handle = 0;
     }
-
-    // Remove ourself from the texture cache.
-    if (_cached)
+    if (_pixelBuffer)
     {
-        std::vector<Texture*>::iterator itr = std::find(__textureCache.begin(), __textureCache.end(), this);
-        if (itr != __textureCache.end())
+        if (_pixelBuffer->handle)
         {
-            __textureCache.erase(itr);
+            GL_ASSERT( glDeleteBuffers(1, &_pixelBuffer->handle) );
         }
+        SAFE_DELETE(_pixelBuffer);
     }
+    setMemorySize(0);
 }
 
 Texture* Texture::create(const char* path, bool generateMipmaps)
+{
+    return createCached(path, NULL, generateMipmaps);
+}
+
+Texture* Texture::createCached(const char* path, Image* image, bool generateMipmaps)
 {
     GP_ASSERT( path );
 
     // Search texture cache first.
-    for (size_t i = 0, count = __textureCache.size(); i < count; ++i)
+    Texture* t = static_cast<Texture*>(ResourceManager::find(ResourceManager::TEXTURE, path));
+    if (t)
     {
-        Texture* t = __textureCache[i];
-        GP_ASSERT( t );
-        if (t->_path == path)
+        // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the
+        // texture to generate its mipmap chain if it hasn't already done so.
+        if (generateMipmaps)
         {
-            // If 'generateMipmaps' is true, call Texture::generateMipamps() to force the
-            // texture to generate its mipmap chain if it hasn't already done so.
-            if (generateMipmaps)
-            {
-                t->generateMipmaps();
-            }
-
-            // Found a match.
-            t->addRef();
-
-            return t;
+            t->generateMipmaps();
         }
+        return t;
     }
 
     Texture* texture = NULL;
@@ -111,10 +215,17 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
         case 4:
             if (tolower(ext[1]) == 'p' && tolower(ext[2]) == 'n' && tolower(ext[3]) == 'g')
             {
-                Image* image = Image::create(path);
                 if (image)
+                {
                     texture = create(image, generateMipmaps);
-                SAFE_RELEASE(image);
+                }
+                else
+                {
+                    image = Image::create(path);
+                    if (image)
+                        texture = create(image, generateMipmaps);
+                    SAFE_RELEASE(image);
+                }
             }
             else if (tolower(ext[1]) == 'p' && tolower(ext[2]) == 'v' && tolower(ext[3]) == 'r')
             {
@@ -126,6 +237,11 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
                 // DDS file format (DXT/S3TC) compressed textures
                 texture = createCompressedDDS(path);
             }
+            else if (tolower(ext[1]) == 'k' && tolower(ext[2]) == 't' && tolower(ext[3]) == 'x')
+            {
+                // KTX file format (ETC1/ETC2/ASTC/BC/PVRTC/ATC) compressed textures
+                texture = createCompressedKTX(path);
+            }
             break;
         }
     }
@@ -134,9 +250,10 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     {
         texture->_path = path;
         texture->_cached = true;
+        RenderStats::setMemoryName(texture, path);
 
         // Add to texture cache.
-        __textureCache.push_back(texture);
+        ResourceManager::add(ResourceManager::TEXTURE, texture->_path, texture, texture->_memorySize);
 
         return texture;
     }
@@ -145,6 +262,36 @@ Texture* Texture::create(const char* path, bool generateMipmaps)
     return NULL;
 }
 
+bool Texture::isCompressionSupported(Compression compression)
+{
+    // A family is supported if the device lists one of its formats, or its extension.
+    static const GLint formats[] = { ETC1_RGB8, GL_COMPRESSED_RGB8_ETC2, GL_COMPRESSED_RGBA_ASTC_4x4_KHR,
+        GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, GL_COMPRESSED_RGBA_PVRTC_4BPPV1_IMG, ATC_RGBA_INTERPOLATED_ALPHA_AMD };
+    static const char* extensions[] = { "GL_OES_compressed_ETC1_RGB8_texture", "GL_ARB_ES3_compatibility", "GL_KHR_texture_compression_astc_ldr",
+        "GL_EXT_texture_compression_s3tc", "GL_IMG_texture_compression_pvrtc", "GL_AMD_compressed_ATC_texture" };
+    static int __supported[COMPRESSION_ATC + 1] = { -1, -1, -1, -1, -1, -1 };
+
+    GP_ASSERT( compression <= COMPRESSION_ATC );
+    if (__supported[compression] == -1)
+    {
+        GLint count = 0;
+        GL_ASSERT( glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count) );
+        std::vector<GLint> supportedFormats(std::max(count, 0));
+        if (count > 0)
+            GL_ASSERT( glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, &supportedFormats[0]) );
+        bool supported = std::find(supportedFormats.begin(), supportedFormats.end(), formats[compression]) != supportedFormats.end();
+
+        const char* extensionString = (const char*)glGetString(GL_EXTENSIONS);
+        supported |= extensionString && strstr(extensionString, extensions[compression]) != NULL;
+#if defined(OPENGL_ES) && defined(GL_ES_VERSION_3_0)
+        // OpenGL ES 3.0 requires ETC2, which decodes ETC1 as well.
+        supported |= compression == COMPRESSION_ETC1 || compression == COMPRESSION_ETC2;
+#endif
+        __supported[compression] = supported ? 1 : 0;
+    }
+    return __supported[compression] == 1;
+}
+
 Texture* Texture::create(Image* image, bool generateMipmaps)
 {
     GP_ASSERT( image );
@@ -179,6 +326,12 @@ GLint Texture::getFormatInternal(Format format)
             return GL_DEPTH_COMPONENT32F;
 #else
             return GL_DEPTH_COMPONENT;
+#endif
+        case Texture::RGBA32F:
+#if !defined(OPENGL_ES) || defined(GL_ES_VERSION_3_0)
+            return GL_RGBA32F;
+#else
+            return GL_RGBA;
 #endif
         default:
             return 0;
@@ -205,6 +358,8 @@ GLenum Texture::getFormatTexel(Format format)
 #else
             return GL_UNSIGNED_INT;
 #endif
+        case Texture::RGBA32F:
+            return GL_FLOAT;
         default:
             return 0;
     }
@@ -224,11 +379,27 @@ size_t Texture::getFormatBPP(Format format)
                 return 4;
             case Texture::ALPHA:
                 return 1;
+            case Texture::RGBA32F:
+                return 16;
             default:
                 return 0;
         }
 }
 
+GLenum Texture::getFormatData(Format format)
+{
+    // Sized internal formats must be uploaded with their unsized base format.
+    switch (format)
+    {
+        case Texture::DEPTH:
+            return GL_DEPTH_COMPONENT;
+        case Texture::RGBA32F:
+            return GL_RGBA;
+        default:
+            return (GLenum)getFormatInternal(format);
+    }
+}
+
 Texture* Texture::create(Format format, unsigned int width, unsigned int height, const unsigned char* data, bool generateMipmaps, Texture::Type type)
 {
     GP_ASSERT( type == Texture::TEXTURE_2D || type == Texture::TEXTURE_CUBE );
@@ -257,8 +428,7 @@ Texture* Texture::create(Format format, unsigned int width, unsigned int height,
     size_t bpp = getFormatBPP(format);
     if (type == Texture::TEXTURE_2D)
     {
-        GLenum f = (format == Texture::DEPTH) ? GL_DEPTH_COMPONENT : internalFormat;
-        GL_ASSERT( glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, f, texelType, data) );
+        GL_ASSERT( glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, getFormatData(format), texelType, data) );
     }
     else
     {
@@ -275,7 +445,7 @@ Texture* Texture::create(Format format, unsigned int width, unsigned int height,
         for (unsigned int i = 0; i < 6; i++)
         {
             const unsigned char* texturePtr = (data == NULL) ? NULL : &data[i * textureSize];
-            GL_ASSERT( glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, width, height, 0, internalFormat, texelType, texturePtr) );
+            GL_ASSERT( glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, internalFormat, width, height, 0, getFormatData(format), texelType, texturePtr) );
         }
     }
 
@@ -308,12 +478,13 @@ Texture* Texture::create(Format format, unsigned int width, unsigned int height,
     texture->_internalFormat = internalFormat;
     texture->_texelType = texelType;
     texture->_bpp = bpp;
+    texture->setMemorySize((size_t)width * height * bpp * (type == Texture::TEXTURE_CUBE ? 6 : 1));
     if (generateMipmaps)
         texture->generateMipmaps();
 
 
     // Restore the texture id
-    GL_ASSERT( glBindTexture((GLenum)__currentTextureType, __currentTextureId) );
+    restoreCurrentTexture();
 
     return texture;
 }
@@ -338,7 +509,7 @@ Texture* Texture::create(TextureHandle handle, int width, int height, Format for
         }
 
         // Restore the texture id
-        GL_ASSERT( glBindTexture((GLenum)__currentTextureType, __currentTextureId) );
+        restoreCurrentTexture();
     }
     texture->_handle = handle;
     texture->_format = format;
@@ -347,6 +518,7 @@ Texture* Texture::create(TextureHandle handle, int width, int height, Format for
     texture->_internalFormat = getFormatInternal(format);
     texture->_texelType = getFormatTexel(format);
     texture->_bpp = getFormatBPP(format);
+    texture->setMemorySize((size_t)width * height * texture->_bpp * (texture->_type == TEXTURE_CUBE ? 6 : 1));
 
     return texture;
 }
@@ -360,29 +532,121 @@ void Texture::setData(const unsigned char* data)
 
     GL_ASSERT( glBindTexture((GLenum)_type, _handle) );
 
-    if (_type == Texture::TEXTURE_2D)
+    // Each face goes through the pixel buffer, and the mipmaps are generated once for all of them.
+    size_t faceSize = (size_t)_width * _height * _bpp;
+    unsigned int faceCount = _type == Texture::TEXTURE_2D ? 1 : 6;
+    for (unsigned int i = 0; i < faceCount; i++)
     {
-        GL_ASSERT( glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, _width, _height, _internalFormat, _texelType, data) );
+        unsigned char* mapped = mapData(0, 0, _width, _height, (CubeFace)i);
+        memcpy(mapped, &data[i * faceSize], faceSize);
+        uploadPixelBuffer();
     }
-    else
+
+    if (_mipmapped)
     {
-        // Get texture size
-        unsigned int textureSize = _width * _height;
-        textureSize *= _bpp;
-        // Texture Cube
-        for (unsigned int i = 0; i < 6; i++)
-        {
-            GL_ASSERT( glTexSubImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, 0, 0, _width, _height, _internalFormat, _texelType, &data[i * textureSize]) );
-        }
+        GL_ASSERT( glGenerateMipmap((GLenum)_type) );
+    }
+
+    // Restore the texture id
+    restoreCurrentTexture();
+}
+
+void Texture::setData(unsigned int x, unsigned int y, unsigned int width, unsigned int height, const unsigned char* data, CubeFace face)
+{
+    GP_ASSERT( data );
+
+    unsigned char* mapped = mapData(x, y, width, height, face);
+    memcpy(mapped, data, (size_t)width * height * _bpp);
+    unmapData();
+}
+
+unsigned char* Texture::mapData(unsigned int x, unsigned int y, unsigned int width, unsigned int height, CubeFace face)
+{
+    // Don't work with any compressed or cached textures
+    GP_ASSERT( (!_compressed) );
+    GP_ASSERT( (!_cached) );
+    GP_ASSERT( x + width <= _width && y + height <= _height );
+    GP_ASSERT( _pixelBuffer == NULL || _pixelBuffer->mapped == NULL );
+
+    if (_pixelBuffer == NULL)
+    {
+        _pixelBuffer = new PixelBuffer();
+        _pixelBuffer->handle = 0;
+        _pixelBuffer->mapped = NULL;
     }
+    _pixelBuffer->x = x;
+    _pixelBuffer->y = y;
+    _pixelBuffer->width = width;
+    _pixelBuffer->height = height;
+    _pixelBuffer->face = face;
+
+    size_t size = std::max((size_t)width * height * _bpp, (size_t)1);
+#ifdef TEXTURE_PIXEL_BUFFER
+    if (_pixelBuffer->handle == 0)
+    {
+        GL_ASSERT( glGenBuffers(1, &_pixelBuffer->handle) );
+    }
+    if (_pixelBuffer->handle)
+    {
+        // Orphaning the storage lets the driver keep transferring its previous content
+        // while the new content is written, instead of waiting for the previous update.
+        GL_ASSERT( glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pixelBuffer->handle) );
+        GL_ASSERT( glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, NULL, GL_STREAM_DRAW) );
+        _pixelBuffer->mapped = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size,
+            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+        GL_ASSERT( glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+        if (_pixelBuffer->mapped)
+            return _pixelBuffer->mapped;
+
+        // Buffers that cannot be mapped are not used again.
+        GP_WARN("Failed to map the pixel buffer of texture '%s'.", _path.c_str());
+        GL_ASSERT( glDeleteBuffers(1, &_pixelBuffer->handle) );
+        _pixelBuffer->handle = 0;
+    }
+#endif
+
+    _pixelBuffer->staging.resize(size);
+    _pixelBuffer->mapped = &_pixelBuffer->staging[0];
+    return _pixelBuffer->mapped;
+}
+
+void Texture::unmapData()
+{
+    GP_ASSERT( _pixelBuffer && _pixelBuffer->mapped );
+
+    GL_ASSERT( glBindTexture((GLenum)_type, _handle) );
+    uploadPixelBuffer();
 
     if (_mipmapped)
     {
-        generateMipmaps();
+        GL_ASSERT( glGenerateMipmap((GLenum)_type) );
     }
 
     // Restore the texture id
-    GL_ASSERT( glBindTexture((GLenum)__currentTextureType, __currentTextureId) );
+    restoreCurrentTexture();
+}
+
+void Texture::uploadPixelBuffer()
+{
+    GP_ASSERT( _pixelBuffer && _pixelBuffer->mapped );
+
+    PixelBuffer* buffer = _pixelBuffer;
+    GLenum target = _type == Texture::TEXTURE_2D ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP_POSITIVE_X + (GLenum)buffer->face;
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 1) );
+#ifdef TEXTURE_PIXEL_BUFFER
+    if (buffer->handle)
+    {
+        // The texture is sourced from the start of the bound buffer.
+        GL_ASSERT( glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer->handle) );
+        GL_ASSERT( glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) );
+        GL_ASSERT( glTexSubImage2D(target, 0, buffer->x, buffer->y, buffer->width, buffer->height, getFormatData(_format), _texelType, NULL) );
+        GL_ASSERT( glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0) );
+        buffer->mapped = NULL;
+        return;
+    }
+#endif
+    GL_ASSERT( glTexSubImage2D(target, 0, buffer->x, buffer->y, buffer->width, buffer->height, getFormatData(_format), _texelType, buffer->mapped) );
+    buffer->mapped = NULL;
 }
 
 // Computes the size of a PVRTC data chunk for a mipmap level of the given size.
@@ -481,9 +745,11 @@ Texture* Texture::createCompressedPVRTC(const char* path)
 
     // Load the data for each level.
     GLubyte* ptr = data;
+    size_t memorySize = 0;
     for (unsigned int level = 0; level < mipMapCount; ++level)
     {
         unsigned int dataSize = computePVRTCDataSize(width, height, bpp);
+        memorySize += dataSize * faceCount;
 
         for (unsigned int face = 0; face < faceCount; ++face)
         {
@@ -495,12 +761,13 @@ Texture* Texture::createCompressedPVRTC(const char* path)
         height = std::max(height >> 1, 1);
         ptr += dataSize * faceCount;
     }
+    texture->setMemorySize(memorySize);
 
     // Free data.
     SAFE_DELETE_ARRAY(data);
 
     // Restore the texture id
-    GL_ASSERT( glBindTexture((GLenum)__currentTextureType, __currentTextureId) );
+    restoreCurrentTexture();
 
     return texture;
 }
@@ -774,6 +1041,221 @@ GLubyte* Texture::readCompressedPVRTCLegacy(const char* path, Stream* stream, GL
     return data;
 }
 
+Texture* Texture::createCompressedKTX(const char* path)
+{
+    GP_ASSERT( path );
+
+    // KTX file header, which follows the identifier.
+    struct ktx_header
+    {
+        unsigned int endianness;
+        unsigned int glType;
+        unsigned int glTypeSize;
+        unsigned int glFormat;
+        unsigned int glInternalFormat;
+        unsigned int glBaseInternalFormat;
+        unsigned int pixelWidth;
+        unsigned int pixelHeight;
+        unsigned int pixelDepth;
+        unsigned int numberOfArrayElements;
+        unsigned int numberOfFaces;
+        unsigned int numberOfMipmapLevels;
+        unsigned int bytesOfKeyValueData;
+    };
+
+    // Open the KTX file, mapped where possible so that its levels are uploaded in place.
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::READ | FileSystem::MAPPED));
+    if (stream.get() == NULL || !stream->canRead())
+    {
+        GP_ERROR("Failed to open file '%s'.", path);
+        return NULL;
+    }
+
+    // Validate KTX identifier.
+    static const unsigned char identifier[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+    unsigned char code[12];
+    if (stream->read(code, 1, 12) != 12 || memcmp(code, identifier, 12) != 0)
+    {
+        GP_ERROR("Failed to read KTX file '%s': invalid KTX identifier.", path);
+        return NULL;
+    }
+
+    // Read KTX header, swapping its fields if it was written with the other endianness.
+    ktx_header header;
+    if (stream->read(&header, sizeof(ktx_header), 1) != 1)
+    {
+        GP_ERROR("Failed to read header for KTX file '%s'.", path);
+        return NULL;
+    }
+    bool swapped = header.endianness == KTX_ENDIANNESS_SWAPPED;
+    if (swapped)
+    {
+        unsigned int* fields = (unsigned int*)&header;
+        for (unsigned int i = 0; i < sizeof(ktx_header) / sizeof(unsigned int); ++i)
+            fields[i] = (fields[i] >> 24) | ((fields[i] >> 8) & 0xFF00) | ((fields[i] << 8) & 0xFF0000) | (fields[i] << 24);
+    }
+    else if (header.endianness != KTX_ENDIANNESS)
+    {
+        GP_ERROR("Failed to read KTX file '%s': invalid endianness.", path);
+        return NULL;
+    }
+
+    // Compressed data has a type of 0, and uncompressed data is only supported as bytes.
+    bool compressed = header.glType == 0;
+    if (!compressed && (header.glType != GL_UNSIGNED_BYTE || header.glTypeSize != 1 ||
+        (header.glFormat != GL_RGB && header.glFormat != GL_RGBA && header.glFormat != GL_ALPHA)))
+    {
+        GP_ERROR("Failed to create texture from KTX file '%s': unsupported uncompressed format (0x%x, 0x%x).", path, header.glFormat, header.glType);
+        return NULL;
+    }
+    if (header.pixelDepth > 1 || header.numberOfArrayElements > 0 || (header.numberOfFaces != 1 && header.numberOfFaces != 6))
+    {
+        GP_ERROR("Failed to create texture from KTX file '%s': volume and array textures are unsupported.", path);
+        return NULL;
+    }
+
+    // Skip the key and value pairs.
+    if (stream->seek(header.bytesOfKeyValueData, SEEK_CUR) == false)
+    {
+        GP_ERROR("Failed to skip key and value data of KTX file '%s'.", path);
+        return NULL;
+    }
+
+    // Generate GL texture.
+    unsigned int faceCount = header.numberOfFaces;
+    unsigned int mipMapCount = std::max(header.numberOfMipmapLevels, 1u);
+    GLenum target = faceCount > 1 ? GL_TEXTURE_CUBE_MAP : GL_TEXTURE_2D;
+    GLuint textureId;
+    GL_ASSERT( glGenTextures(1, &textureId) );
+    GL_ASSERT( glBindTexture(target, textureId) );
+
+    Filter minFilter = mipMapCount > 1 ? NEAREST_MIPMAP_LINEAR : LINEAR;
+    GL_ASSERT( glTexParameteri(target, GL_TEXTURE_MIN_FILTER, minFilter) );
+
+    // Create gameplay texture.
+    Texture* texture = new Texture();
+    texture->_handle = textureId;
+    texture->_type = (Type)target;
+    texture->_width = header.pixelWidth;
+    texture->_height = std::max(header.pixelHeight, 1u);
+    texture->_compressed = compressed;
+    texture->_mipmapped = mipMapCount > 1;
+    texture->_minFilter = minFilter;
+    texture->_internalFormat = compressed ? header.glInternalFormat : header.glBaseInternalFormat;
+    texture->_texelType = GL_UNSIGNED_BYTE;
+    if (!compressed)
+        texture->_format = header.glFormat == GL_RGB ? RGB : (header.glFormat == GL_RGBA ? RGBA : ALPHA);
+
+    // Streamed textures are created with only their levels no larger than the minimum size
+    // of the streamer, which reads the larger levels once the texture is drawn.
+    unsigned int firstLevel = 0;
+    if (TextureStreamer::isEnabled() && faceCount == 1)
+    {
+        unsigned int size = std::max(texture->_width, texture->_height);
+        while (firstLevel + 1 < mipMapCount && (size >> firstLevel) > TextureStreamer::getMinimumSize())
+            ++firstLevel;
+    }
+    std::vector<size_t> offsets(mipMapCount);
+    std::vector<unsigned int> sizes(mipMapCount);
+
+    // Rows of uncompressed data are padded to four bytes.
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 4) );
+
+    // Load the data for each level, each face of which is padded to four bytes.
+    const GLubyte* data = (const GLubyte*)stream->getData();
+    std::vector<GLubyte> buffer;
+    GLsizei width = texture->_width;
+    GLsizei height = texture->_height;
+    size_t memorySize = 0;
+    for (unsigned int level = 0; level < mipMapCount; ++level)
+    {
+        unsigned int imageSize;
+        if (stream->read(&imageSize, sizeof(unsigned int), 1) != 1)
+        {
+            GP_ERROR("Failed to read image size of level %d of KTX file '%s'.", level, path);
+            SAFE_RELEASE(texture);
+            restoreCurrentTexture();
+            return NULL;
+        }
+        if (swapped)
+            imageSize = (imageSize >> 24) | ((imageSize >> 8) & 0xFF00) | ((imageSize << 8) & 0xFF0000) | (imageSize << 24);
+        offsets[level] = (size_t)stream->position();
+        sizes[level] = imageSize;
+
+        unsigned int padding = (4 - imageSize % 4) % 4;
+        if (level < firstLevel)
+        {
+            // The level is read by the streamer once the texture is drawn.
+            if (!stream->seek(imageSize + padding, SEEK_CUR))
+            {
+                GP_ERROR("Failed to read level %d of KTX file '%s'.", level, path);
+                SAFE_RELEASE(texture);
+                restoreCurrentTexture();
+                return NULL;
+            }
+            width = std::max(width >> 1, 1);
+            height = std::max(height >> 1, 1);
+            continue;
+        }
+
+        for (unsigned int face = 0; face < faceCount; ++face)
+        {
+            const GLubyte* image = NULL;
+            long position = stream->position();
+            if (data && position >= 0 && (size_t)position + imageSize <= stream->length())
+            {
+                image = data + position;
+                stream->seek(imageSize, SEEK_CUR);
+            }
+            else
+            {
+                buffer.resize(std::max(imageSize, 1u));
+                if (stream->read(&buffer[0], 1, imageSize) == imageSize)
+                    image = &buffer[0];
+            }
+            if (image == NULL)
+            {
+                GP_ERROR("Failed to read level %d of KTX file '%s'.", level, path);
+                SAFE_RELEASE(texture);
+                restoreCurrentTexture();
+                return NULL;
+            }
+
+            GLenum faceTarget = faceCount > 1 ? GL_TEXTURE_CUBE_MAP_POSITIVE_X + face : GL_TEXTURE_2D;
+            if (compressed)
+            {
+                GL_ASSERT( glCompressedTexImage2D(faceTarget, level - firstLevel, header.glInternalFormat, width, height, 0, imageSize, image) );
+            }
+            else
+            {
+                GL_ASSERT( glTexImage2D(faceTarget, level - firstLevel, header.glBaseInternalFormat, width, height, 0, header.glFormat, GL_UNSIGNED_BYTE, image) );
+            }
+            memorySize += imageSize;
+
+            if (padding > 0)
+                stream->seek(padding, SEEK_CUR);
+        }
+
+        width = std::max(width >> 1, 1);
+        height = std::max(height >> 1, 1);
+    }
+    texture->setMemorySize(memorySize);
+
+    // The other uploads assume tightly packed rows.
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 1) );
+
+    if (firstLevel > 0)
+    {
+        texture->_streamed = true;
+        TextureStreamer::add(texture, path, &offsets[0], &sizes[0], mipMapCount, firstLevel);
+    }
+
+    // Restore the texture id
+    restoreCurrentTexture();
+
+    return texture;
+}
+
 int Texture::getMaskByteIndex(unsigned int mask)
 {
     switch (mask)
@@ -1123,12 +1605,14 @@ Texture* Texture::createCompressedDDS(const char* path)
     texture->_minFilter = minFilter;
 
     // Load texture data.
+    size_t memorySize = 0;
     for (unsigned int face = 0; face < facecount; ++face)
     {
         GLenum texImageTarget = faces[face];
         for (unsigned int i = 0; i < header.dwMipMapCount; ++i)
         {
             dds_mip_level& level = mipLevels[i + face * header.dwMipMapCount];
+            memorySize += level.size;
             if (compressed)
             {
                 GL_ASSERT(glCompressedTexImage2D(texImageTarget, i, format, level.width, level.height, 0, level.size, level.data));
@@ -1143,11 +1627,13 @@ Texture* Texture::createCompressedDDS(const char* path)
         }
     }
 
+    texture->setMemorySize(memorySize);
+
     // Clean up mip levels structure.
     SAFE_DELETE_ARRAY(mipLevels);
 
     // Restore the texture id
-    GL_ASSERT( glBindTexture((GLenum)__currentTextureType, __currentTextureId) );
+    restoreCurrentTexture();
 
     return texture;
 }
@@ -1182,6 +1668,69 @@ TextureHandle Texture::getHandle() const
     return _handle;
 }
 
+void Texture::setMemorySize(size_t size)
+{
+    if (_memorySize)
+        RenderStats::removeMemory(RenderStats::TEXTURE_MEMORY, _memorySize, this);
+    _memorySize = size;
+    if (_memorySize)
+        RenderStats::addMemory(RenderStats::TEXTURE_MEMORY, _memorySize, this, _path.empty() ? NULL : _path.c_str());
+    if (_cached)
+        ResourceManager::setMemorySize(ResourceManager::TEXTURE, _path, _memorySize);
+}
+
+void Texture::setStreamedLevels(unsigned int level, const unsigned int* sizes, unsigned int levelCount, const unsigned char* const* data)
+{
+    GP_ASSERT( _streamed && _type == TEXTURE_2D );
+    GP_ASSERT( sizes && data && levelCount > 0 );
+
+    GLuint textureId;
+    GL_ASSERT( glGenTextures(1, &textureId) );
+    GL_ASSERT( glBindTexture(GL_TEXTURE_2D, textureId) );
+    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, (GLenum)_minFilter) );
+    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, (GLenum)_magFilter) );
+    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, (GLenum)_wrapS) );
+    GL_ASSERT( glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, (GLenum)_wrapT) );
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 4) );
+
+    // The uncompressed formats of KTX files that are supported have the same format as their base internal format.
+    GLsizei width = std::max(_width >> level, 1u);
+    GLsizei height = std::max(_height >> level, 1u);
+    size_t memorySize = 0;
+    for (unsigned int i = 0; i < levelCount; ++i)
+    {
+        if (_compressed)
+        {
+            GL_ASSERT( glCompressedTexImage2D(GL_TEXTURE_2D, i, _internalFormat, width, height, 0, sizes[i], data[i]) );
+        }
+        else
+        {
+            GL_ASSERT( glTexImage2D(GL_TEXTURE_2D, i, _internalFormat, width, height, 0, (GLenum)_internalFormat, _texelType, data[i]) );
+        }
+        memorySize += sizes[i];
+        width = std::max(width >> 1, 1);
+        height = std::max(height >> 1, 1);
+    }
+    GL_ASSERT( glPixelStorei(GL_UNPACK_ALIGNMENT, 1) );
+
+    // Deleting the previous texture object unbinds it from all units.
+    for (unsigned int i = 0; i < TEXTURE_UNIT_COUNT; ++i)
+    {
+        if (__currentTextureId[i] == _handle)
+            __currentTextureId[i] = textureId;
+    }
+    GL_ASSERT( glDeleteTextures(1, &_handle) );
+    _handle = textureId;
+    setMemorySize(memorySize);
+
+    restoreCurrentTexture();
+}
+
+size_t Texture::getMemorySize() const
+{
+    return _memorySize;
+}
+
 void Texture::generateMipmaps()
 {
     if (!_mipmapped)
@@ -1194,8 +1743,11 @@ void Texture::generateMipmaps()
 
         _mipmapped = true;
 
+        // A full mipmap chain adds a third of the base level.
+        setMemorySize(_memorySize + _memorySize / 3);
+
         // Restore the texture id
-        GL_ASSERT( glBindTexture((GLenum)__currentTextureType, __currentTextureId) );
+        restoreCurrentTexture();
     }
 }
 
@@ -1210,7 +1762,7 @@ bool Texture::isCompressed() const
 }
 
 Texture::Sampler::Sampler(Texture* texture)
-    : _texture(texture), _wrapS(Texture::REPEAT), _wrapT(Texture::REPEAT), _wrapR(Texture::REPEAT)
+    : _texture(texture), _wrapS(Texture::REPEAT), _wrapT(Texture::REPEAT), _wrapR(Texture::REPEAT), _object(0)
 {
     GP_ASSERT( texture );
     _minFilter = texture->_minFilter;
@@ -1238,15 +1790,34 @@ Texture::Sampler* Texture::Sampler::create(const char* path, bool generateMipmap
 
 void Texture::Sampler::setWrapMode(Wrap wrapS, Wrap wrapT, Wrap wrapR)
 {
-    _wrapS = wrapS;
-    _wrapT = wrapT;
-    _wrapR = wrapR;
+    if (_wrapS != wrapS || _wrapT != wrapT || _wrapR != wrapR)
+    {
+        _wrapS = wrapS;
+        _wrapT = wrapT;
+        _wrapR = wrapR;
+        _object = 0;
+    }
 }
 
 void Texture::Sampler::setFilterMode(Filter minificationFilter, Filter magnificationFilter)
 {
-    _minFilter = minificationFilter;
-    _magFilter = magnificationFilter;
+    if (_minFilter != minificationFilter || _magFilter != magnificationFilter)
+    {
+        _minFilter = minificationFilter;
+        _magFilter = magnificationFilter;
+        _object = 0;
+    }
+}
+
+void Texture::setActiveUnit(unsigned int unit)
+{
+    GP_ASSERT(unit < TEXTURE_UNIT_COUNT);
+
+    if (__currentTextureUnit != unit)
+    {
+        GL_ASSERT( glActiveTexture(GL_TEXTURE0 + unit) );
+        __currentTextureUnit = unit;
+    }
 }
 
 Texture* Texture::Sampler::getTexture() const
@@ -1258,14 +1829,33 @@ void Texture::Sampler::bind()
 {
     GP_ASSERT( _texture );
 
+    if (_texture->_streamed)
+        TextureStreamer::request(_texture);
+
     GLenum target = (GLenum)_texture->_type;
-    if (__currentTextureId != _texture->_handle)
+    if (__currentTextureId[__currentTextureUnit] != _texture->_handle || __currentTextureType[__currentTextureUnit] != _texture->_type)
     {
         GL_ASSERT( glBindTexture(target, _texture->_handle) );
-        __currentTextureId = _texture->_handle;
-        __currentTextureType = _texture->_type;
+        RenderStats::count(RenderStats::TEXTURE_BINDS);
+        __currentTextureId[__currentTextureUnit] = _texture->_handle;
+        __currentTextureType[__currentTextureUnit] = _texture->_type;
     }
 
+#ifdef GP_USE_SAMPLER_OBJECTS
+    // A sampler object overrides the parameters of the texture, which are left as they are.
+    if (isSamplerObjectSupported())
+    {
+        if (_object == 0)
+            _object = getSamplerObject(_wrapS, _wrapT, _wrapR, _minFilter, _magFilter);
+        if (__currentSamplerObject[__currentTextureUnit] != _object)
+        {
+            GL_ASSERT( glBindSampler(__currentTextureUnit, _object) );
+            __currentSamplerObject[__currentTextureUnit] = _object;
+        }
+        return;
+    }
+#endif
+
     if (_texture->_minFilter != _minFilter)
     {
         _texture->_minFilter = _minFilter;
@@ -15,6 +15,10 @@ class Image;
 class Texture : public Ref
 {
     friend class Sampler;
+    friend class Effect;
+    friend class AssetLoader;
+    friend class TextureStreamer;
+    friend class InstanceCuller;
 
 public:
 
@@ -33,6 +37,7 @@ public:
         RGBA5551,
         ALPHA,
         DEPTH,
+        RGBA32F,
     };
 
     /**
@@ -78,6 +83,19 @@ public:
         POSITIVE_Z,
         NEGATIVE_Z
     };
+
+    /**
+     * Defines the families of compressed texture formats, which devices support depending on their GPU.
+     */
+    enum Compression
+    {
+        COMPRESSION_ETC1,
+        COMPRESSION_ETC2,
+        COMPRESSION_ASTC,
+        COMPRESSION_BC,
+        COMPRESSION_PVRTC,
+        COMPRESSION_ATC
+    };
     
     /**
      * Defines a texture sampler.
@@ -90,6 +108,7 @@ public:
     class Sampler : public Ref
     {
         friend class Texture;
+        friend class SpriteBatch;
 
     public:
 
@@ -145,6 +164,10 @@ public:
 
         /**
          * Binds the texture of this sampler to the renderer and applies the sampler state.
+         *
+         * Where sampler objects are supported, the state is applied by binding a sampler
+         * object shared by all samplers with the same state. Otherwise the parameters of
+         * the texture are only set when they differ from those last applied to it.
          */
         void bind();
 
@@ -166,6 +189,7 @@ public:
         Wrap _wrapR;
         Filter _minFilter;
         Filter _magFilter;
+        GLuint _object;
     };
 
     /**
@@ -182,6 +206,20 @@ public:
      */
     static Texture* create(const char* path, bool generateMipmaps = false);
 
+    /**
+     * Determines if the device can sample textures compressed in the given family of formats.
+     *
+     * PNG, PVR, DDS and KTX files can be loaded with create, and KTX files hold ETC1, ETC2
+     * and EAC, ASTC, BC (DXT/S3TC, RGTC and BPTC), PVRTC or ATC data with their mip chain.
+     * Games that ship textures in several formats select the one each device supports
+     * with the texture aliases of their game config, see FileSystem::loadResourceAliases.
+     *
+     * @param compression The family of compressed formats.
+     *
+     * @return true if the device supports the formats, false otherwise.
+     */
+    static bool isCompressionSupported(Compression compression);
+
     /**
      * Creates a texture from the given image.
      *
@@ -241,6 +279,50 @@ public:
      */
     void setData(const unsigned char* data);
 
+    /**
+     * Sets the data of a rectangle of the first level of the texture, or of one of its faces
+     * if it is a cube texture.
+     *
+     * Where pixel buffer objects are supported (OpenGL and OpenGL ES 3), the data is copied into
+     * a buffer that is orphaned by every update, and transferred to the texture by the driver
+     * without waiting for the draws that use its previous content. Dynamic content such as video
+     * frames and minimaps can be updated every frame without blocking the CPU.
+     *
+     * @param x The x position of the rectangle, in pixels.
+     * @param y The y position of the rectangle, in pixels.
+     * @param width The width of the rectangle, in pixels.
+     * @param height The height of the rectangle, in pixels.
+     * @param data The tightly packed data of the rectangle.
+     * @param face The face to update if the texture is a cube texture.
+     */
+    void setData(unsigned int x, unsigned int y, unsigned int width, unsigned int height, const unsigned char* data, CubeFace face = POSITIVE_X);
+
+    /**
+     * Returns memory into which the data of a rectangle of the texture can be written, which is
+     * uploaded by unmapData.
+     *
+     * Where pixel buffer objects are supported, the memory is that of the pixel buffer of the
+     * texture, so that data generated for every frame, such as decoded video frames, is written
+     * straight into the memory that the driver transfers from.
+     *
+     * @param x The x position of the rectangle, in pixels.
+     * @param y The y position of the rectangle, in pixels.
+     * @param width The width of the rectangle, in pixels.
+     * @param height The height of the rectangle, in pixels.
+     * @param face The face to update if the texture is a cube texture.
+     *
+     * @return The memory of the tightly packed data of the rectangle.
+     * @script{ignore}
+     */
+    unsigned char* mapData(unsigned int x, unsigned int y, unsigned int width, unsigned int height, CubeFace face = POSITIVE_X);
+
+    /**
+     * Uploads the data written into the memory returned by mapData, which is no longer valid.
+     *
+     * @script{ignore}
+     */
+    void unmapData();
+
     /**
      * Returns the path that the texture was originally loaded from (if applicable).
      *
@@ -293,6 +375,13 @@ public:
      */
     bool isCompressed() const;
 
+    /**
+     * Returns the estimated number of bytes of graphics memory that this texture uses.
+     *
+     * @return The memory size in bytes.
+     */
+    size_t getMemorySize() const;
+
     /**
      * Returns the texture handle.
      *
@@ -322,18 +411,66 @@ private:
      */
     Texture& operator=(const Texture&);
 
+    /**
+     * Returns the cached texture for the given path, or creates it and adds it to the cache.
+     *
+     * @param path The path of the texture file.
+     * @param image The image already decoded from a PNG file at the path, or NULL to decode it here.
+     * @param generateMipmaps true to auto-generate a full mipmap chain, false otherwise.
+     */
+    static Texture* createCached(const char* path, Image* image, bool generateMipmaps);
+
     static Texture* createCompressedPVRTC(const char* path);
 
     static Texture* createCompressedDDS(const char* path);
 
+    static Texture* createCompressedKTX(const char* path);
+
     static GLubyte* readCompressedPVRTC(const char* path, Stream* stream, GLsizei* width, GLsizei* height, GLenum* format, unsigned int* mipMapCount, unsigned int* faceCount, GLenum faces[6]);
 
     static GLubyte* readCompressedPVRTCLegacy(const char* path, Stream* stream, GLsizei* width, GLsizei* height, GLenum* format, unsigned int* mipMapCount, unsigned int* faceCount, GLenum faces[6]);
 
+    /**
+     * Makes the given texture unit active, unless it is active already.
+     */
+    static void setActiveUnit(unsigned int unit);
+
     static int getMaskByteIndex(unsigned int mask);
     static GLint getFormatInternal(Format format);
     static GLenum getFormatTexel(Format format);
     static size_t getFormatBPP(Format format);
+    static GLenum getFormatData(Format format);
+
+    /**
+     * Records the estimated graphics memory used by the texture in the render stats.
+     *
+     * @param size The memory size in bytes.
+     */
+    void setMemorySize(size_t size);
+
+    /**
+     * Replaces the levels of a texture streamed from a KTX file with the levels of its mipmap
+     * chain from the given level on.
+     *
+     * The levels are uploaded into a new texture object that replaces the current one, since
+     * levels can't be removed from a texture object on every device.
+     *
+     * @param level The level of the full mipmap chain that becomes the top level.
+     * @param sizes The size in bytes of each level.
+     * @param levelCount The number of levels, up to the end of the chain.
+     * @param data The data of each level.
+     */
+    void setStreamedLevels(unsigned int level, const unsigned int* sizes, unsigned int levelCount, const unsigned char* const* data);
+
+    /**
+     * Uploads the mapped rectangle of the pixel buffer of the texture, which must be bound.
+     */
+    void uploadPixelBuffer();
+
+    /**
+     * The buffer that the data of dynamic textures is mapped from.
+     */
+    struct PixelBuffer;
 
     std::string _path;
     TextureHandle _handle;
@@ -344,6 +481,7 @@ private:
     bool _mipmapped;
     bool _cached;
     bool _compressed;
+    bool _streamed;
     Wrap _wrapS;
     Wrap _wrapT;
     Wrap _wrapR;
@@ -353,6 +491,8 @@ private:
     GLint _internalFormat;
     GLenum _texelType;
     size_t _bpp;
+    size_t _memorySize;
+    PixelBuffer* _pixelBuffer;
 };
 
 }
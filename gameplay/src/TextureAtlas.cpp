@@ -0,0 +1,396 @@
+#include "Base.h"
+#include "TextureAtlas.h"
+#include "SpriteBatch.h"
+#include "Image.h"
+#include "FileSystem.h"
+#include "Properties.h"
+#include "Game.h"
+
+// The default size of the pages of an atlas.
+#define ATLAS_PAGE_SIZE 1024
+
+// The default number of pixels around each image of an atlas.
+#define ATLAS_PADDING 2
+
+namespace gameplay
+{
+
+static std::vector<TextureAtlas*> __atlasCache;
+
+/**
+ * A row of images in a page being packed, as high as its first (and highest) image.
+ */
+struct AtlasShelf
+{
+    unsigned int page;
+    unsigned int y;
+    unsigned int height;
+    unsigned int width;
+};
+
+/**
+ * An image being packed, with the index of its entry in the atlas.
+ */
+struct AtlasImage
+{
+    Image* image;
+    size_t entry;
+};
+
+/**
+ * Decodes an image of an atlas on a worker of the job controller.
+ */
+class AtlasImageDecode : public JobController::Job
+{
+public:
+
+    void execute(unsigned int worker)
+    {
+        image = Image::create(path);
+    }
+
+    const char* path;
+    Image* image;
+};
+
+static bool compareImageHeight(const AtlasImage& a, const AtlasImage& b)
+{
+    return a.image->getHeight() > b.image->getHeight();
+}
+
+/**
+ * Copies an image into page data, repeating its edge pixels into the padding around it.
+ * Like the data of images, the rows of pages go from the bottom to the top.
+ */
+static void copyImage(const Image* image, const Rectangle& bounds, unsigned int padding, unsigned char* page, unsigned int pageWidth, unsigned int pageHeight)
+{
+    unsigned int width = image->getWidth();
+    unsigned int height = image->getHeight();
+    unsigned int bpp = image->getFormat() == Image::RGBA ? 4 : 3;
+    const unsigned char* data = image->getData();
+    int left = (int)bounds.x;
+    int top = (int)bounds.y;
+    for (int y = -(int)padding; y < (int)(height + padding); ++y)
+    {
+        int sy = std::min(std::max(y, 0), (int)height - 1);
+        const unsigned char* src = data + (size_t)(height - 1 - sy) * width * bpp;
+        unsigned char* dst = page + (size_t)(pageHeight - 1 - (top + y)) * pageWidth * 4;
+        for (int x = -(int)padding; x < (int)(width + padding); ++x)
+        {
+            int sx = std::min(std::max(x, 0), (int)width - 1);
+            const unsigned char* s = src + sx * bpp;
+            unsigned char* d = dst + (left + x) * 4;
+            d[0] = s[0];
+            d[1] = s[1];
+            d[2] = s[2];
+            d[3] = bpp == 4 ? s[3] : 255;
+        }
+    }
+}
+
+TextureAtlas::TextureAtlas() : _mipmapped(false)
+{
+}
+
+TextureAtlas::~TextureAtlas()
+{
+    for (size_t i = 0, count = _batches.size(); i < count; ++i)
+    {
+        SAFE_DELETE(_batches[i]);
+    }
+    for (size_t i = 0, count = _pages.size(); i < count; ++i)
+    {
+        SAFE_RELEASE(_pages[i]);
+    }
+
+    std::vector<TextureAtlas*>::iterator itr = std::find(__atlasCache.begin(), __atlasCache.end(), this);
+    if (itr != __atlasCache.end())
+    {
+        __atlasCache.erase(itr);
+    }
+}
+
+TextureAtlas* TextureAtlas::create(const char* url)
+{
+    GP_ASSERT(url);
+
+    for (size_t i = 0, count = __atlasCache.size(); i < count; ++i)
+    {
+        TextureAtlas* atlas = __atlasCache[i];
+        if (atlas->_url == url)
+        {
+            atlas->addRef();
+            return atlas;
+        }
+    }
+
+    Properties* properties = Properties::create(url);
+    if (properties == NULL)
+    {
+        GP_WARN("Failed to load texture atlas '%s'.", url);
+        return NULL;
+    }
+
+    Properties* atlasProperties = (strlen(properties->getNamespace()) > 0) ? properties : properties->getNextNamespace();
+    if (!atlasProperties || strcmp(atlasProperties->getNamespace(), "atlas") != 0)
+    {
+        GP_WARN("Texture atlas '%s' does not define an 'atlas' namespace.", url);
+        SAFE_DELETE(properties);
+        return NULL;
+    }
+
+    TextureAtlas* atlas = new TextureAtlas();
+    atlas->_url = url;
+    if (!atlas->load(atlasProperties))
+    {
+        GP_WARN("Failed to load texture atlas '%s'.", url);
+        SAFE_RELEASE(atlas);
+        SAFE_DELETE(properties);
+        return NULL;
+    }
+    SAFE_DELETE(properties);
+
+    __atlasCache.push_back(atlas);
+    return atlas;
+}
+
+TextureAtlas* TextureAtlas::find(const char* path, Region* region)
+{
+    if (path == NULL)
+        return NULL;
+
+    for (size_t i = 0, count = __atlasCache.size(); i < count; ++i)
+    {
+        if (__atlasCache[i]->getRegionByPath(path, region))
+            return __atlasCache[i];
+    }
+    return NULL;
+}
+
+bool TextureAtlas::load(Properties* properties)
+{
+    GP_ASSERT(properties);
+
+    unsigned int pageWidth = properties->exists("width") ? (unsigned int)std::max(properties->getInt("width"), 1) : ATLAS_PAGE_SIZE;
+    unsigned int pageHeight = properties->exists("height") ? (unsigned int)std::max(properties->getInt("height"), 1) : ATLAS_PAGE_SIZE;
+    unsigned int padding = properties->exists("padding") ? (unsigned int)std::max(properties->getInt("padding"), 0) : ATLAS_PADDING;
+    _mipmapped = properties->getBool("mipmaps");
+
+    // Gather the images of the directory and of the image namespaces.
+    std::vector<Entry> entries;
+    const char* directory = properties->getString("directory");
+    if (directory)
+    {
+        std::string dir(directory);
+        if (!dir.empty() && dir[dir.size() - 1] != '/')
+            dir += '/';
+
+        std::vector<std::string> files;
+        if (!FileSystem::listFiles(directory, files))
+        {
+            GP_WARN("Failed to list the files of texture atlas directory '%s'.", directory);
+        }
+        std::sort(files.begin(), files.end());
+        for (size_t i = 0, count = files.size(); i < count; ++i)
+        {
+            if (FileSystem::getExtension(files[i].c_str()) != ".PNG")
+                continue;
+
+            Entry entry;
+            entry.name = files[i].substr(0, files[i].find_last_of('.'));
+            entry.path = dir + files[i];
+            entries.push_back(entry);
+        }
+    }
+    Properties* space;
+    while ((space = properties->getNextNamespace()) != NULL)
+    {
+        if (strcmp(space->getNamespace(), "image") != 0)
+            continue;
+
+        Entry entry;
+        entry.name = space->getId();
+        if (!space->getPath("path", &entry.path))
+        {
+            GP_WARN("Texture atlas image '%s' has no valid path.", space->getId());
+            continue;
+        }
+        entries.push_back(entry);
+    }
+
+    // Decode the images on the workers, since an atlas can hold hundreds of them.
+    std::vector<AtlasImageDecode> decodes(entries.size());
+    std::vector<JobController::Job*> jobs(entries.size());
+    for (size_t i = 0, count = entries.size(); i < count; ++i)
+    {
+        decodes[i].path = entries[i].path.c_str();
+        decodes[i].image = NULL;
+        jobs[i] = &decodes[i];
+    }
+    if (!jobs.empty())
+    {
+        JobController* jobController = Game::getInstance()->getJobController();
+        JobController::Group group;
+        jobController->submit(&jobs[0], (unsigned int)jobs.size(), &group);
+        jobController->wait(&group);
+    }
+
+    std::vector<AtlasImage> images;
+    for (size_t i = 0, count = entries.size(); i < count; ++i)
+    {
+        Image* image = decodes[i].image;
+        if (image == NULL)
+            continue;
+        if (image->getWidth() + 2 * padding > pageWidth || image->getHeight() + 2 * padding > pageHeight)
+        {
+            GP_WARN("Image '%s' is larger than the pages of texture atlas '%s'.", entries[i].path.c_str(), _url.c_str());
+            SAFE_RELEASE(image);
+            continue;
+        }
+        AtlasImage atlasImage;
+        atlasImage.image = image;
+        atlasImage.entry = i;
+        images.push_back(atlasImage);
+    }
+
+    // Pack the images from the highest into shelves, opening a shelf below the last one
+    // of a page, or a new page, when no shelf has room left.
+    std::sort(images.begin(), images.end(), compareImageHeight);
+    std::vector<AtlasShelf> shelves;
+    std::vector<unsigned int> pageHeights;
+    for (size_t i = 0, count = images.size(); i < count; ++i)
+    {
+        unsigned int width = images[i].image->getWidth() + 2 * padding;
+        unsigned int height = images[i].image->getHeight() + 2 * padding;
+        AtlasShelf* shelf = NULL;
+        for (size_t j = 0, shelfCount = shelves.size(); j < shelfCount && !shelf; ++j)
+        {
+            if (shelves[j].width + width <= pageWidth && height <= shelves[j].height)
+                shelf = &shelves[j];
+        }
+        if (!shelf)
+        {
+            unsigned int page = 0;
+            while (page < pageHeights.size() && pageHeights[page] + height > pageHeight)
+                ++page;
+            if (page == pageHeights.size())
+                pageHeights.push_back(0);
+
+            AtlasShelf newShelf;
+            newShelf.page = page;
+            newShelf.y = pageHeights[page];
+            newShelf.height = height;
+            newShelf.width = 0;
+            pageHeights[page] += height;
+            shelves.push_back(newShelf);
+            shelf = &shelves.back();
+        }
+
+        Entry& entry = entries[images[i].entry];
+        entry.region.page = shelf->page;
+        entry.region.bounds.set((float)(shelf->width + padding), (float)(shelf->y + padding),
+            (float)images[i].image->getWidth(), (float)images[i].image->getHeight());
+        shelf->width += width;
+        _entries.push_back(entry);
+    }
+
+    // Pages are only as high as the power of two that holds their shelves.
+    for (size_t page = 0, pageCount = pageHeights.size(); page < pageCount; ++page)
+    {
+        unsigned int height = 1;
+        while (height < pageHeights[page])
+            height <<= 1;
+        height = std::min(height, pageHeight);
+
+        std::vector<unsigned char> data((size_t)pageWidth * height * 4, 0);
+        for (size_t i = 0, count = images.size(); i < count; ++i)
+        {
+            const Entry& entry = entries[images[i].entry];
+            if (entry.region.page == page)
+                copyImage(images[i].image, entry.region.bounds, padding, &data[0], pageWidth, height);
+        }
+
+        Texture* texture = Texture::create(Texture::RGBA, pageWidth, height, &data[0], _mipmapped);
+        if (texture == NULL)
+        {
+            for (size_t i = 0, count = images.size(); i < count; ++i)
+                SAFE_RELEASE(images[i].image);
+            return false;
+        }
+        _pages.push_back(texture);
+        _batches.push_back(NULL);
+    }
+
+    for (size_t i = 0, count = images.size(); i < count; ++i)
+        SAFE_RELEASE(images[i].image);
+    return true;
+}
+
+const char* TextureAtlas::getUrl() const
+{
+    return _url.c_str();
+}
+
+unsigned int TextureAtlas::getPageCount() const
+{
+    return (unsigned int)_pages.size();
+}
+
+Texture* TextureAtlas::getPage(unsigned int index) const
+{
+    GP_ASSERT(index < _pages.size());
+    return _pages[index];
+}
+
+SpriteBatch* TextureAtlas::getSpriteBatch(unsigned int index)
+{
+    GP_ASSERT(index < _pages.size());
+
+    if (_batches[index] == NULL)
+    {
+        SpriteBatch* batch = SpriteBatch::create(_pages[index]);
+        batch->getSampler()->setFilterMode(_mipmapped ? Texture::LINEAR_MIPMAP_LINEAR : Texture::LINEAR, Texture::LINEAR);
+        batch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+        _batches[index] = batch;
+    }
+    return _batches[index];
+}
+
+unsigned int TextureAtlas::getImageCount() const
+{
+    return (unsigned int)_entries.size();
+}
+
+bool TextureAtlas::getRegion(const char* name, Region* region) const
+{
+    GP_ASSERT(name);
+
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        if (_entries[i].name == name)
+        {
+            if (region)
+                *region = _entries[i].region;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool TextureAtlas::getRegionByPath(const char* path, Region* region) const
+{
+    GP_ASSERT(path);
+
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        if (_entries[i].path == path)
+        {
+            if (region)
+                *region = _entries[i].region;
+            return true;
+        }
+    }
+    return false;
+}
+
+}
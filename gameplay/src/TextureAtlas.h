@@ -0,0 +1,194 @@
+#ifndef TEXTUREATLAS_H_
+#define TEXTUREATLAS_H_
+
+#include "Ref.h"
+#include "Texture.h"
+#include "Rectangle.h"
+#include "Properties.h"
+
+namespace gameplay
+{
+
+class SpriteBatch;
+
+/**
+ * Defines a set of images packed at load time into shared texture pages.
+ *
+ * An atlas is created from a Properties file that lists the images to pack:
+ *
+ * @code
+ * atlas ui
+ * {
+ *     width = 1024
+ *     height = 1024
+ *     padding = 2
+ *     mipmaps = false
+ *
+ *     // Every PNG file in the directory, named after its file name without extension.
+ *     directory = res/ui/icons
+ *
+ *     image logo
+ *     {
+ *         path = res/ui/logo.png
+ *     }
+ * }
+ * @endcode
+ *
+ * Images are packed into as few pages as possible, with their edge pixels repeated
+ * into the padding around them so that filtering does not bleed neighbouring images.
+ * Images larger than a page are not packed.
+ *
+ * While an atlas exists, the sprites, tile sets, image controls and themes created from
+ * one of its image files draw with its page instead of loading their own texture, and the
+ * image controls and themes of a form that use the same page share a single sprite batch,
+ * so that a whole screen draws in a few batches. Games typically create their atlases
+ * before loading their scenes and forms, and release them once they are no longer needed.
+ */
+class TextureAtlas : public Ref
+{
+public:
+
+    /**
+     * The location of an image in an atlas.
+     */
+    struct Region
+    {
+        /**
+         * The index of the page holding the image.
+         */
+        unsigned int page;
+
+        /**
+         * The bounds of the image in the page, in pixels from the top left corner.
+         */
+        Rectangle bounds;
+    };
+
+    /**
+     * Creates an atlas from the given Properties file, or returns the atlas already
+     * created from it.
+     *
+     * @param url The URL of the Properties object defining the atlas.
+     *
+     * @return The atlas, or NULL if the file could not be loaded.
+     * @script{create}
+     */
+    static TextureAtlas* create(const char* url);
+
+    /**
+     * Finds the atlas that holds the image loaded from the given file, among the atlases
+     * that currently exist.
+     *
+     * @param path The path of the image file.
+     * @param region Set to the location of the image in the atlas, if found.
+     *
+     * @return The atlas, or NULL if no atlas holds the image.
+     * @script{ignore}
+     */
+    static TextureAtlas* find(const char* path, Region* region);
+
+    /**
+     * Returns the URL that the atlas was created from.
+     *
+     * @return The URL.
+     */
+    const char* getUrl() const;
+
+    /**
+     * Returns the number of pages of the atlas.
+     *
+     * @return The number of pages.
+     */
+    unsigned int getPageCount() const;
+
+    /**
+     * Returns the texture of a page.
+     *
+     * @param index The index of the page.
+     *
+     * @return The texture of the page.
+     */
+    Texture* getPage(unsigned int index) const;
+
+    /**
+     * Returns the sprite batch that draws a page, which is shared by the image controls
+     * and themes that draw the images of the page.
+     *
+     * @param index The index of the page.
+     *
+     * @return The sprite batch of the page.
+     * @script{ignore}
+     */
+    SpriteBatch* getSpriteBatch(unsigned int index);
+
+    /**
+     * Returns the number of images in the atlas.
+     *
+     * @return The number of images.
+     */
+    unsigned int getImageCount() const;
+
+    /**
+     * Returns the location of the image with the given name.
+     *
+     * @param name The name of the image.
+     * @param region Set to the location of the image, if found.
+     *
+     * @return true if the atlas holds the image; false otherwise.
+     * @script{ignore}
+     */
+    bool getRegion(const char* name, Region* region) const;
+
+    /**
+     * Returns the location of the image loaded from the given file.
+     *
+     * @param path The path of the image file.
+     * @param region Set to the location of the image, if found.
+     *
+     * @return true if the atlas holds the image; false otherwise.
+     * @script{ignore}
+     */
+    bool getRegionByPath(const char* path, Region* region) const;
+
+private:
+
+    /**
+     * An image packed into the atlas.
+     */
+    struct Entry
+    {
+        std::string name;
+        std::string path;
+        Region region;
+    };
+
+    /**
+     * Constructor.
+     */
+    TextureAtlas();
+
+    /**
+     * Destructor.
+     */
+    ~TextureAtlas();
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TextureAtlas& operator=(const TextureAtlas&);
+
+    /**
+     * Loads and packs the images listed by the given properties into pages.
+     */
+    bool load(Properties* properties);
+
+    std::string _url;
+    std::vector<Texture*> _pages;
+    std::vector<SpriteBatch*> _batches;
+    std::vector<Entry> _entries;
+    bool _mipmapped;
+};
+
+}
+
+#endif
@@ -0,0 +1,363 @@
+#include "Base.h"
+#include "TextureStreamer.h"
+#include "Texture.h"
+#include "FileSystem.h"
+#include "Game.h"
+
+// The number of textures whose levels can be read at the same time.
+#define STREAM_PENDING_MAX 4
+
+// The number of frames after which a texture that is no longer drawn is released to its
+// minimum level, before the textures that are still drawn lose any level.
+#define STREAM_IDLE_FRAMES 60
+
+namespace gameplay
+{
+
+/**
+ * Reads the levels of a streamed texture on a worker, from a level to the end of its mipmap chain.
+ */
+class TextureStreamLoad : public JobController::Job
+{
+public:
+
+    void execute(unsigned int worker);
+
+    std::string path;
+    unsigned int level;
+    size_t offset;
+    size_t size;
+    std::vector<unsigned char> data;
+    bool result;
+    JobController::Group group;
+};
+
+/**
+ * A streamed texture.
+ */
+struct StreamedTexture
+{
+    Texture* texture;
+    std::string path;
+    std::vector<size_t> offsets;
+    std::vector<unsigned int> sizes;
+    unsigned int residentLevel;
+    unsigned int minimumLevel;
+    unsigned int requestedLevel;
+    unsigned int lastDrawn;
+    bool failed;
+    TextureStreamLoad* load;
+
+    /**
+     * Returns the number of bytes used by the levels from the given level to the end of the chain.
+     */
+    size_t getMemorySize(unsigned int level) const
+    {
+        size_t size = 0;
+        for (size_t i = level, count = sizes.size(); i < count; ++i)
+            size += sizes[i];
+        return size;
+    }
+};
+
+typedef std::unordered_map<Texture*, StreamedTexture*> StreamedTextureMap;
+
+static StreamedTextureMap __textures;
+static bool __enabled = false;
+static size_t __budget = 0;
+static size_t __usage = 0;
+static unsigned int __minimumSize = 64;
+static unsigned int __pendingCount = 0;
+static float __drawResolution = 0.0f;
+
+// The requested level of a texture that hasn't been requested since the last update.
+static const unsigned int NOT_REQUESTED = std::numeric_limits<unsigned int>::max();
+
+void TextureStreamLoad::execute(unsigned int worker)
+{
+    result = false;
+    std::unique_ptr<Stream> stream(FileSystem::open(path.c_str()));
+    if (stream.get() && stream->seek((long int)offset, SEEK_SET))
+    {
+        data.resize(size);
+        result = stream->read(&data[0], 1, size) == size;
+    }
+}
+
+void TextureStreamer::setEnabled(bool enabled)
+{
+    __enabled = enabled;
+}
+
+bool TextureStreamer::isEnabled()
+{
+    return __enabled;
+}
+
+void TextureStreamer::setMemoryBudget(size_t bytes)
+{
+    __budget = bytes;
+}
+
+size_t TextureStreamer::getMemoryBudget()
+{
+    return __budget;
+}
+
+size_t TextureStreamer::getMemoryUsage()
+{
+    return __usage;
+}
+
+void TextureStreamer::setMinimumSize(unsigned int size)
+{
+    __minimumSize = std::max(size, 1u);
+}
+
+unsigned int TextureStreamer::getMinimumSize()
+{
+    return __minimumSize;
+}
+
+unsigned int TextureStreamer::getTextureCount()
+{
+    return (unsigned int)__textures.size();
+}
+
+unsigned int TextureStreamer::getPendingCount()
+{
+    return __pendingCount;
+}
+
+void TextureStreamer::setDrawResolution(float pixels)
+{
+    __drawResolution = pixels;
+}
+
+float TextureStreamer::getDrawResolution()
+{
+    return __drawResolution;
+}
+
+void TextureStreamer::print()
+{
+    Logger::log(Logger::LEVEL_INFO, "TextureStreamer: %u textures, %.2f MB of %.2f MB budget, %u pending\n", (unsigned int)__textures.size(),
+        __usage / (1024.0 * 1024.0), __budget / (1024.0 * 1024.0), __pendingCount);
+    for (StreamedTextureMap::const_iterator itr = __textures.begin(); itr != __textures.end(); ++itr)
+    {
+        const StreamedTexture* t = itr->second;
+        Logger::log(Logger::LEVEL_INFO, "  level %u of %u (%ux%u) %8u KB  %s\n", t->residentLevel, (unsigned int)t->sizes.size(),
+            std::max(t->texture->_width >> t->residentLevel, 1u), std::max(t->texture->_height >> t->residentLevel, 1u),
+            (unsigned int)(t->getMemorySize(t->residentLevel) / 1024), t->path.c_str());
+    }
+}
+
+void TextureStreamer::initialize()
+{
+    Properties* config = Game::getInstance()->getConfig()->getNamespace("textureStreaming", true);
+    if (config)
+    {
+        if (config->exists("enabled"))
+            __enabled = config->getBool("enabled");
+        if (config->exists("memoryBudget"))
+            __budget = (size_t)(std::max(config->getFloat("memoryBudget"), 0.0f) * 1024.0f * 1024.0f);
+        if (config->exists("minimumSize"))
+            setMinimumSize((unsigned int)std::max(config->getInt("minimumSize"), 1));
+    }
+}
+
+void TextureStreamer::add(Texture* texture, const char* path, const size_t* offsets, const unsigned int* sizes, unsigned int levelCount, unsigned int level)
+{
+    GP_ASSERT(texture);
+    GP_ASSERT(path);
+    GP_ASSERT(level < levelCount);
+    GP_ASSERT(__textures.find(texture) == __textures.end());
+
+    StreamedTexture* t = new StreamedTexture();
+    t->texture = texture;
+    t->path = path;
+    t->offsets.assign(offsets, offsets + levelCount);
+    t->sizes.assign(sizes, sizes + levelCount);
+    t->residentLevel = level;
+    t->minimumLevel = level;
+    t->requestedLevel = NOT_REQUESTED;
+    t->lastDrawn = Game::getInstance()->getFrameIndex();
+    t->failed = false;
+    t->load = NULL;
+    __textures[texture] = t;
+    __usage += t->getMemorySize(level);
+}
+
+void TextureStreamer::remove(Texture* texture)
+{
+    StreamedTextureMap::iterator itr = __textures.find(texture);
+    if (itr == __textures.end())
+        return;
+
+    StreamedTexture* t = itr->second;
+    if (t->load)
+    {
+        Game::getInstance()->getJobController()->wait(&t->load->group);
+        SAFE_DELETE(t->load);
+        --__pendingCount;
+    }
+    __usage -= t->getMemorySize(t->residentLevel);
+    SAFE_DELETE(t);
+    __textures.erase(itr);
+}
+
+void TextureStreamer::request(Texture* texture)
+{
+    StreamedTextureMap::iterator itr = __textures.find(texture);
+    if (itr == __textures.end())
+        return;
+
+    // The smallest level that still has at least as many texels across as the pixels drawn.
+    StreamedTexture* t = itr->second;
+    unsigned int level = 0;
+    if (__drawResolution > 0.0f)
+    {
+        unsigned int size = std::max(texture->_width, texture->_height);
+        while (level < t->minimumLevel && (float)(size >> (level + 1)) >= __drawResolution)
+            ++level;
+    }
+    t->requestedLevel = std::min(t->requestedLevel, level);
+    t->lastDrawn = Game::getInstance()->getFrameIndex();
+}
+
+/**
+ * Starts reading the levels of a texture from the given level to the end of its mipmap chain.
+ */
+static void streamLevels(StreamedTexture* t, unsigned int level)
+{
+    GP_ASSERT(t->load == NULL);
+
+    TextureStreamLoad* load = new TextureStreamLoad();
+    load->path = t->path;
+    load->level = level;
+    load->offset = t->offsets[level];
+    load->size = t->offsets.back() + t->sizes.back() - load->offset;
+    load->result = false;
+    t->load = load;
+    ++__pendingCount;
+    Game::getInstance()->getJobController()->submit(load, &load->group);
+}
+
+static bool compareLeastRecentlyDrawn(const StreamedTexture* a, const StreamedTexture* b)
+{
+    return a->lastDrawn < b->lastDrawn;
+}
+
+static bool compareMostBlurred(const StreamedTexture* a, const StreamedTexture* b)
+{
+    return a->residentLevel - a->requestedLevel > b->residentLevel - b->requestedLevel;
+}
+
+void TextureStreamer::update()
+{
+    if (__textures.empty())
+        return;
+
+    // Upload the levels that have been read.
+    std::vector<const unsigned char*> levels;
+    for (StreamedTextureMap::iterator itr = __textures.begin(); itr != __textures.end(); ++itr)
+    {
+        StreamedTexture* t = itr->second;
+        if (t->load == NULL || !t->load->group.isComplete())
+            continue;
+
+        TextureStreamLoad* load = t->load;
+        if (load->result)
+        {
+            // Each level of the data follows the size of its image.
+            levels.clear();
+            for (size_t i = load->level, count = t->sizes.size(); i < count; ++i)
+                levels.push_back(&load->data[t->offsets[i] - load->offset]);
+            t->texture->setStreamedLevels(load->level, &t->sizes[load->level], (unsigned int)levels.size(), &levels[0]);
+            __usage = __usage - t->getMemorySize(t->residentLevel) + t->getMemorySize(load->level);
+            t->residentLevel = load->level;
+        }
+        else
+        {
+            GP_WARN("Failed to read the levels of streamed texture '%s'.", t->path.c_str());
+            t->failed = true;
+        }
+        SAFE_DELETE(t->load);
+        --__pendingCount;
+    }
+
+    // The memory that the textures will use once the levels being read have been uploaded.
+    unsigned int frame = Game::getInstance()->getFrameIndex();
+    size_t usage = 0;
+    std::vector<StreamedTexture*> releasable;
+    std::vector<StreamedTexture*> requested;
+    for (StreamedTextureMap::iterator itr = __textures.begin(); itr != __textures.end(); ++itr)
+    {
+        StreamedTexture* t = itr->second;
+        usage += t->getMemorySize(t->load ? t->load->level : t->residentLevel);
+        if (t->load == NULL && !t->failed)
+        {
+            if (t->residentLevel < t->minimumLevel)
+                releasable.push_back(t);
+            if (t->requestedLevel < t->residentLevel)
+                requested.push_back(t);
+        }
+    }
+
+    // Release the levels of the textures drawn the longest ago while the budget is exceeded.
+    if (__budget > 0 && usage > __budget)
+    {
+        std::sort(releasable.begin(), releasable.end(), compareLeastRecentlyDrawn);
+        for (size_t i = 0, count = releasable.size(); i < count && usage > __budget && __pendingCount < STREAM_PENDING_MAX; ++i)
+        {
+            StreamedTexture* t = releasable[i];
+            unsigned int level = frame - t->lastDrawn > STREAM_IDLE_FRAMES ? t->minimumLevel : t->residentLevel + 1;
+            usage -= t->getMemorySize(t->residentLevel) - t->getMemorySize(level);
+            t->requestedLevel = NOT_REQUESTED;
+            streamLevels(t, level);
+        }
+    }
+
+    // Read the levels of the textures that are the most blurred compared to what was requested,
+    // up to the largest level that fits the budget.
+    std::sort(requested.begin(), requested.end(), compareMostBlurred);
+    for (size_t i = 0, count = requested.size(); i < count && __pendingCount < STREAM_PENDING_MAX; ++i)
+    {
+        StreamedTexture* t = requested[i];
+        if (t->load)
+            continue;
+
+        size_t size = t->getMemorySize(t->residentLevel);
+        unsigned int level = t->requestedLevel;
+        while (level < t->residentLevel && __budget > 0 && usage + t->getMemorySize(level) - size > __budget)
+            ++level;
+        if (level < t->residentLevel)
+        {
+            usage += t->getMemorySize(level) - size;
+            streamLevels(t, level);
+        }
+    }
+
+    for (StreamedTextureMap::iterator itr = __textures.begin(); itr != __textures.end(); ++itr)
+        itr->second->requestedLevel = NOT_REQUESTED;
+}
+
+void TextureStreamer::finalize()
+{
+    JobController* jobs = Game::getInstance()->getJobController();
+    for (StreamedTextureMap::iterator itr = __textures.begin(); itr != __textures.end(); ++itr)
+    {
+        StreamedTexture* t = itr->second;
+        if (t->load)
+        {
+            jobs->wait(&t->load->group);
+            SAFE_DELETE(t->load);
+        }
+        SAFE_DELETE(t);
+    }
+    __textures.clear();
+    __usage = 0;
+    __pendingCount = 0;
+}
+
+}
@@ -0,0 +1,172 @@
+#ifndef TEXTURESTREAMER_H_
+#define TEXTURESTREAMER_H_
+
+namespace gameplay
+{
+
+class Texture;
+
+/**
+ * Defines the streaming of the mipmap levels of textures, which keeps only the levels that
+ * are drawn resident in graphics memory.
+ *
+ * When streaming is enabled, textures loaded from KTX files that hold a mipmap chain are
+ * created with only their levels no larger than the minimum size, which are small enough
+ * to load at once. Every time a streamed texture is bound, it is requested at the resolution
+ * set with setDrawResolution, which models set to the number of pixels they cover before
+ * binding the textures of their passes. Textures bound without a draw resolution, such
+ * as those of sprites and forms, are requested at their full resolution.
+ *
+ * At the end of every frame, textures are upgraded to the largest level that was requested,
+ * as long as the streamed textures fit the memory budget. Once they exceed it, the levels of
+ * the textures drawn the longest ago are released first. The levels are read from their
+ * file on the workers of the job controller, and uploaded on the main thread once they have
+ * been read, into a new texture object that replaces the previous one.
+ *
+ * Streaming is configured in the 'textureStreaming' namespace of the game configuration
+ * file, with the 'enabled', 'memoryBudget' (in megabytes) and 'minimumSize' (in pixels)
+ * properties. The default budget of zero lets textures use as much memory as they request.
+ */
+class TextureStreamer
+{
+    friend class Game;
+    friend class Texture;
+
+public:
+
+    /**
+     * Sets whether the textures created from now on are streamed.
+     *
+     * @param enabled true to stream the textures created from now on.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * Returns whether textures are streamed.
+     *
+     * @return true if textures are streamed.
+     */
+    static bool isEnabled();
+
+    /**
+     * Sets the number of bytes that the levels of streamed textures may use.
+     *
+     * @param bytes The memory budget in bytes, or zero for no budget.
+     */
+    static void setMemoryBudget(size_t bytes);
+
+    /**
+     * Returns the number of bytes that the levels of streamed textures may use.
+     *
+     * @return The memory budget in bytes.
+     */
+    static size_t getMemoryBudget();
+
+    /**
+     * Returns the number of bytes used by the resident levels of streamed textures.
+     *
+     * @return The memory size in bytes.
+     */
+    static size_t getMemoryUsage();
+
+    /**
+     * Sets the size in pixels of the largest level that streamed textures are created with,
+     * and that is never released.
+     *
+     * @param size The minimum size in pixels.
+     */
+    static void setMinimumSize(unsigned int size);
+
+    /**
+     * Returns the size in pixels of the largest level that streamed textures are created with.
+     *
+     * @return The minimum size in pixels.
+     */
+    static unsigned int getMinimumSize();
+
+    /**
+     * Returns the number of streamed textures.
+     *
+     * @return The number of textures.
+     */
+    static unsigned int getTextureCount();
+
+    /**
+     * Returns the number of streamed textures whose levels are being read.
+     *
+     * @return The number of textures.
+     */
+    static unsigned int getPendingCount();
+
+    /**
+     * Sets the number of pixels covered by what is being drawn, at which the streamed textures
+     * it binds are requested.
+     *
+     * Models set the draw resolution to the number of pixels covered by their bounding sphere
+     * while they draw. Custom renderers can do the same for the textures they bind.
+     *
+     * @param pixels The number of pixels, or zero to request the full resolution of textures.
+     */
+    static void setDrawResolution(float pixels);
+
+    /**
+     * Returns the number of pixels covered by what is being drawn.
+     *
+     * @return The number of pixels, or zero if textures are requested at their full resolution.
+     */
+    static float getDrawResolution();
+
+    /**
+     * Prints the resident levels of each streamed texture to the log.
+     */
+    static void print();
+
+private:
+
+    /**
+     * Hidden constructor.
+     */
+    TextureStreamer();
+
+    /**
+     * Reads the configuration of the streamer from the game configuration. Called by the game during startup.
+     */
+    static void initialize();
+
+    /**
+     * Adds a texture whose levels from the given level on are resident.
+     *
+     * @param texture The texture.
+     * @param path The path of the KTX file of the texture.
+     * @param offsets The offset in the file of the data of each level.
+     * @param sizes The size in bytes of each level.
+     * @param levelCount The number of levels of the full mipmap chain.
+     * @param level The first resident level.
+     */
+    static void add(Texture* texture, const char* path, const size_t* offsets, const unsigned int* sizes, unsigned int levelCount, unsigned int level);
+
+    /**
+     * Removes a texture that is being destroyed, waiting for its levels if they are being read.
+     */
+    static void remove(Texture* texture);
+
+    /**
+     * Requests a texture at the current draw resolution. Called when the texture is bound.
+     */
+    static void request(Texture* texture);
+
+    /**
+     * Uploads the levels that have been read, and reads the levels that textures are requested
+     * at or releases those exceeding the budget. Called by the game at the end of every frame.
+     */
+    static void update();
+
+    /**
+     * Waits for the levels being read and stops streaming textures. Called by the game during shutdown.
+     */
+    static void finalize();
+};
+
+}
+
+#endif
@@ -8,9 +8,20 @@ namespace gameplay
 {
 
 static std::vector<Theme*> __themeCache;
+
+/**
+ * Returns the key that a style id is looked up with, since style names are not case sensitive.
+ */
+static std::string getStyleKey(const char* id)
+{
+    std::string key(id);
+    for (size_t i = 0, length = key.length(); i < length; ++i)
+        key[i] = (char)tolower(key[i]);
+    return key;
+}
 static Theme* __defaultTheme = NULL;
 
-Theme::Theme() : _texture(NULL), _spriteBatch(NULL), _emptyImage(NULL)
+Theme::Theme() : _texture(NULL), _spriteBatch(NULL), _atlas(NULL), _emptyImage(NULL)
 {
 }
 
@@ -41,8 +52,10 @@ Theme::~Theme()
         SAFE_RELEASE(skin);
     }
 
-    SAFE_DELETE(_spriteBatch);
+    if (!_atlas)
+        SAFE_DELETE(_spriteBatch);
     SAFE_RELEASE(_texture);
+    SAFE_RELEASE(_atlas);
 
     // Remove ourself from the theme cache.
     std::vector<Theme*>::iterator itr = std::find(__themeCache.begin(), __themeCache.end(), this);
@@ -77,7 +90,7 @@ Theme* Theme::getDefault()
             __defaultTheme = new Theme();
             unsigned int color = 0x00000000;
             __defaultTheme->_texture = Texture::create(Texture::RGBA, 1, 1, (unsigned char*)&color, false);
-            __defaultTheme->_emptyImage = new Theme::ThemeImage(1.0f, 1.0f, Rectangle::empty(), Vector4::zero());
+            __defaultTheme->_emptyImage = new Theme::ThemeImage(1.0f, 1.0f, Rectangle::empty(), Vector4::zero(), Vector2::zero());
             __defaultTheme->_spriteBatch = SpriteBatch::create(__defaultTheme->_texture);
             __defaultTheme->_spriteBatch->getSampler()->setFilterMode(Texture::LINEAR_MIPMAP_LINEAR, Texture::LINEAR);
             __defaultTheme->_spriteBatch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
@@ -136,17 +149,34 @@ Theme* Theme::create(const char* url)
     // Parse the Properties object and set up the theme.
     std::string textureFile;
     themeProperties->getPath("texture", &textureFile);
-    theme->_texture = Texture::create(textureFile.c_str(), true);
-    GP_ASSERT(theme->_texture);
-    theme->_spriteBatch = SpriteBatch::create(theme->_texture);
-    GP_ASSERT(theme->_spriteBatch);
-    theme->_spriteBatch->getSampler()->setFilterMode(Texture::LINEAR_MIPMAP_LINEAR, Texture::LINEAR);
-    theme->_spriteBatch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+
+    // Themes packed into an atlas draw with the batch of their page, which the image
+    // controls that use the same page share.
+    TextureAtlas::Region atlasRegion;
+    theme->_atlas = TextureAtlas::find(textureFile.c_str(), &atlasRegion);
+    if (theme->_atlas)
+    {
+        theme->_atlas->addRef();
+        theme->_texture = theme->_atlas->getPage(atlasRegion.page);
+        theme->_texture->addRef();
+        theme->_spriteBatch = theme->_atlas->getSpriteBatch(atlasRegion.page);
+        theme->_origin.set(atlasRegion.bounds.x, atlasRegion.bounds.y);
+    }
+    else
+    {
+        theme->_texture = Texture::create(textureFile.c_str(), true);
+        GP_ASSERT(theme->_texture);
+        theme->_spriteBatch = SpriteBatch::create(theme->_texture);
+        GP_ASSERT(theme->_spriteBatch);
+        theme->_spriteBatch->getSampler()->setFilterMode(Texture::LINEAR_MIPMAP_LINEAR, Texture::LINEAR);
+        theme->_spriteBatch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
+    }
+    const Vector2& origin = theme->_origin;
 
     float tw = 1.0f / theme->_texture->getWidth();
     float th = 1.0f / theme->_texture->getHeight();
 
-    theme->_emptyImage = new Theme::ThemeImage(tw, th, Rectangle::empty(), Vector4::zero());
+    theme->_emptyImage = new Theme::ThemeImage(tw, th, Rectangle::empty(), Vector4::zero(), Vector2::zero());
 
     Properties* space = themeProperties->getNextNamespace();
     while (space != NULL)
@@ -156,11 +186,11 @@ Theme* Theme::create(const char* url)
             
         if (strcmpnocase(spacename, "image") == 0)
         {
-            theme->_images.push_back(ThemeImage::create(tw, th, space, Vector4::one()));
+            theme->_images.push_back(ThemeImage::create(tw, th, space, Vector4::one(), origin));
         }
         else if (strcmpnocase(spacename, "imageList") == 0)
         {
-            theme->_imageLists.push_back(ImageList::create(tw, th, space));
+            theme->_imageLists.push_back(ImageList::create(tw, th, space, origin));
         }
         else if (strcmpnocase(spacename, "skin") == 0)
         {
@@ -188,7 +218,7 @@ Theme* Theme::create(const char* url)
                 space->getColor("color", &color);
             }
 
-            Skin* skin = Skin::create(space->getId(), tw, th, region, border, color);
+            Skin* skin = Skin::create(space->getId(), tw, th, region, border, color, origin);
             GP_ASSERT(skin);
             theme->_skins.push_back(skin);
         }
@@ -489,6 +519,7 @@ Theme* Theme::create(const char* url)
             Theme::Style* s = new Theme::Style(theme, space->getId(), tw, th, margin, padding, normal, focus, active, disabled, hover);
             GP_ASSERT(s);
             theme->_styles.push_back(s);
+            theme->_styleIds.insert(std::make_pair(getStyleKey(s->getId()), s));
         }
 
         space = themeProperties->getNextNamespace();
@@ -506,16 +537,8 @@ Theme::Style* Theme::getStyle(const char* name) const
 {
     GP_ASSERT(name);
 
-    for (size_t i = 0, count = _styles.size(); i < count; ++i)
-    {
-        GP_ASSERT(_styles[i]);
-        if (strcmpnocase(name, _styles[i]->getId()) == 0)
-        {
-            return _styles[i];
-        }
-    }
-
-    return NULL;
+    std::map<std::string, Style*>::const_iterator itr = _styleIds.find(getStyleKey(name));
+    return itr != _styleIds.end() ? itr->second : NULL;
 }
 
 Theme::Style* Theme::getEmptyStyle()
@@ -531,6 +554,7 @@ Theme::Style* Theme::getEmptyStyle()
             Theme::Margin::empty(), Theme::Border::empty(), overlay, overlay, NULL, overlay, NULL);
 
         _styles.push_back(emptyStyle);
+        _styleIds[getStyleKey("EMPTY_STYLE")] = emptyStyle;
     }
 
     return emptyStyle;
@@ -584,17 +608,17 @@ const Theme::SideRegions& Theme::SideRegions::empty()
 /*********************
  * Theme::ThemeImage *
  *********************/
-Theme::ThemeImage::ThemeImage(float tw, float th, const Rectangle& region, const Vector4& color)
+Theme::ThemeImage::ThemeImage(float tw, float th, const Rectangle& region, const Vector4& color, const Vector2& origin)
     : _region(region), _color(color)
 {
-    generateUVs(tw, th, region.x, region.y, region.width, region.height, &_uvs);
+    generateUVs(tw, th, origin.x + region.x, origin.y + region.y, region.width, region.height, &_uvs);
 }
 
 Theme::ThemeImage::~ThemeImage()
 {
 }
 
-Theme::ThemeImage* Theme::ThemeImage::create(float tw, float th, Properties* properties, const Vector4& defaultColor)
+Theme::ThemeImage* Theme::ThemeImage::create(float tw, float th, Properties* properties, const Vector4& defaultColor, const Vector2& origin)
 {
     GP_ASSERT(properties);
 
@@ -612,7 +636,7 @@ Theme::ThemeImage* Theme::ThemeImage::create(float tw, float th, Properties* pro
         color.set(defaultColor);
     }
 
-    ThemeImage* image = new ThemeImage(tw, th, region, color);
+    ThemeImage* image = new ThemeImage(tw, th, region, color, origin);
     const char* id = properties->getId();
     if (id)
     {
@@ -671,7 +695,7 @@ Theme::ImageList::~ImageList()
     }
 }
 
-Theme::ImageList* Theme::ImageList::create(float tw, float th, Properties* properties)
+Theme::ImageList* Theme::ImageList::create(float tw, float th, Properties* properties, const Vector2& origin)
 {
     GP_ASSERT(properties);
 
@@ -692,7 +716,7 @@ Theme::ImageList* Theme::ImageList::create(float tw, float th, Properties* prope
     Properties* space = properties->getNextNamespace();
     while (space != NULL)
     {
-        ThemeImage* image = ThemeImage::create(tw, th, space, color);
+        ThemeImage* image = ThemeImage::create(tw, th, space, color, origin);
         GP_ASSERT(image);
         imageList->_images.push_back(image);
         space = properties->getNextNamespace();
@@ -727,9 +751,9 @@ Theme::ThemeImage* Theme::ImageList::getImage(const char* imageId) const
 /***************
  * Theme::Skin *
  ***************/
-Theme::Skin* Theme::Skin::create(const char* id, float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color)
+Theme::Skin* Theme::Skin::create(const char* id, float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color, const Vector2& origin)
 {
-    Skin* skin = new Skin(tw, th, region, border, color);
+    Skin* skin = new Skin(tw, th, region, border, color, origin);
 
     if (id)
     {
@@ -739,10 +763,10 @@ Theme::Skin* Theme::Skin::create(const char* id, float tw, float th, const Recta
     return skin;
 }
 
-Theme::Skin::Skin(float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color)
+Theme::Skin::Skin(float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color, const Vector2& origin)
     : _border(border), _color(color), _region(region)
 {
-    setRegion(region, tw, th);
+    setRegion(region, tw, th, origin);
 }
 
 Theme::Skin::~Skin()
@@ -764,18 +788,20 @@ const Rectangle& Theme::Skin::getRegion() const
     return _region;
 }
 
-void Theme::Skin::setRegion(const Rectangle& region, float tw, float th)
+void Theme::Skin::setRegion(const Rectangle& region, float tw, float th, const Vector2& origin)
 {
     // Can calculate all measurements in advance.
-    float leftEdge = region.x * tw;
-    float rightEdge = (region.x + region.width) * tw;
-    float leftBorder = (region.x + _border.left) * tw;
-    float rightBorder = (region.x + region.width - _border.right) * tw;
-
-    float topEdge = 1.0f - (region.y * th);
-    float bottomEdge = 1.0f - ((region.y + region.height) * th);
-    float topBorder = 1.0f - ((region.y + _border.top) * th);
-    float bottomBorder = 1.0f - ((region.y + region.height - _border.bottom) * th);
+    float x = origin.x + region.x;
+    float y = origin.y + region.y;
+    float leftEdge = x * tw;
+    float rightEdge = (x + region.width) * tw;
+    float leftBorder = (x + _border.left) * tw;
+    float rightBorder = (x + region.width - _border.right) * tw;
+
+    float topEdge = 1.0f - (y * th);
+    float bottomEdge = 1.0f - ((y + region.height) * th);
+    float topBorder = 1.0f - ((y + _border.top) * th);
+    float bottomBorder = 1.0f - ((y + region.height - _border.bottom) * th);
 
     // There are 9 sets of UVs to set.
     _uvs[TOP_LEFT].u1 = leftEdge;
@@ -7,6 +7,7 @@
 #include "Rectangle.h"
 #include "Texture.h"
 #include "Properties.h"
+#include "TextureAtlas.h"
 
 namespace gameplay
 {
@@ -178,11 +179,11 @@ public:
 
     private:
 
-        ThemeImage(float tw, float th, const Rectangle& region, const Vector4& color);
+        ThemeImage(float tw, float th, const Rectangle& region, const Vector4& color, const Vector2& origin);
 
         ~ThemeImage();
 
-        static ThemeImage* create(float tw, float th, Properties* properties, const Vector4& defaultColor);
+        static ThemeImage* create(float tw, float th, Properties* properties, const Vector4& defaultColor, const Vector2& origin);
 
         std::string _id;
         UVs _uvs;
@@ -265,7 +266,7 @@ private:
          */
         ImageList& operator=(const ImageList&);
 
-        static ImageList* create(float tw, float th, Properties* properties);
+        static ImageList* create(float tw, float th, Properties* properties, const Vector2& origin);
 
         std::string _id;
         std::vector<ThemeImage*> _images;
@@ -325,7 +326,7 @@ private:
 
     private:
 
-        Skin(float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color);
+        Skin(float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color, const Vector2& origin);
         
         ~Skin();
 
@@ -334,9 +335,9 @@ private:
          */
         Skin& operator=(const Skin&);
 
-        static Skin* create(const char* id, float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color);
+        static Skin* create(const char* id, float tw, float th, const Rectangle& region, const Theme::Border& border, const Vector4& color, const Vector2& origin);
 
-        void setRegion(const Rectangle& region, float tw, float th);
+        void setRegion(const Rectangle& region, float tw, float th, const Vector2& origin);
     
         std::string _id;
         Theme::Border _border;
@@ -380,8 +381,14 @@ private:
     std::string _url;
     Texture* _texture;
     SpriteBatch* _spriteBatch;
+    // The atlas whose shared batch draws the theme, or NULL if the batch is owned.
+    TextureAtlas* _atlas;
+    // The position of the theme image in its texture, which its regions are relative to.
+    Vector2 _origin;
     Theme::ThemeImage* _emptyImage;
     std::vector<Style*> _styles;
+    // The styles by their lowercase ids, since every control looks its style up by name.
+    std::map<std::string, Style*> _styleIds;
     std::vector<ThemeImage*> _images;
     std::vector<ImageList*> _imageLists;
     std::vector<Skin*> _skins;
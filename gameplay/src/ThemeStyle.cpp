@@ -189,10 +189,10 @@ const Vector4& Theme::Style::Overlay::getSkinColor() const
     return Vector4::one();
 }
 
-void Theme::Style::Overlay::setSkinRegion(const Rectangle& region, float tw, float th)
+void Theme::Style::Overlay::setSkinRegion(const Rectangle& region, float tw, float th, const Vector2& origin)
 {
     GP_ASSERT(_skin);
-    _skin->setRegion(region, tw, th);
+    _skin->setRegion(region, tw, th, origin);
 }
 
 const Rectangle& Theme::Style::Overlay::getSkinRegion() const
@@ -293,13 +293,13 @@ const Rectangle& Theme::Style::Overlay::getImageRegion(const char* id) const
     }
 }
     
-void Theme::Style::Overlay::setImageRegion(const char* id, const Rectangle& region, float tw, float th)
+void Theme::Style::Overlay::setImageRegion(const char* id, const Rectangle& region, float tw, float th, const Vector2& origin)
 {
     GP_ASSERT(_imageList);
     ThemeImage* image = _imageList->getImage(id);
     GP_ASSERT(image);
     image->_region.set(region);
-    generateUVs(tw, th, region.x, region.y, region.width, region.height, &(image->_uvs));
+    generateUVs(tw, th, origin.x + region.x, origin.y + region.y, region.width, region.height, &(image->_uvs));
 }
 
 const Vector4& Theme::Style::Overlay::getImageColor(const char* id) const
@@ -350,11 +350,11 @@ const Rectangle& Theme::Style::Overlay::getCursorRegion() const
     }
 }
     
-void Theme::Style::Overlay::setCursorRegion(const Rectangle& region, float tw, float th)
+void Theme::Style::Overlay::setCursorRegion(const Rectangle& region, float tw, float th, const Vector2& origin)
 {
     GP_ASSERT(_cursor);
     _cursor->_region.set(region);
-    generateUVs(tw, th, region.x, region.y, region.width, region.height, &(_cursor->_uvs));
+    generateUVs(tw, th, origin.x + region.x, origin.y + region.y, region.width, region.height, &(_cursor->_uvs));
 }
 
 const Vector4& Theme::Style::Overlay::getCursorColor() const
@@ -94,7 +94,7 @@ private:
 
         const Vector4& getSkinColor() const;
 
-        void setSkinRegion(const Rectangle& region, float tw, float th);
+        void setSkinRegion(const Rectangle& region, float tw, float th, const Vector2& origin);
 
         const Rectangle& getSkinRegion() const;
 
@@ -122,7 +122,7 @@ private:
 
         const Rectangle& getImageRegion(const char* id) const;
 
-        void setImageRegion(const char* id, const Rectangle& region, float tw, float th);
+        void setImageRegion(const char* id, const Rectangle& region, float tw, float th, const Vector2& origin);
 
         const Vector4& getImageColor(const char* id) const;
 
@@ -132,7 +132,7 @@ private:
 
         const Rectangle& getCursorRegion() const;
 
-        void setCursorRegion(const Rectangle& region, float tw, float th);
+        void setCursorRegion(const Rectangle& region, float tw, float th, const Vector2& origin);
 
         const Vector4& getCursorColor() const;
 
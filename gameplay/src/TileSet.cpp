@@ -2,14 +2,22 @@
 #include "TileSet.h"
 #include "Matrix.h"
 #include "Scene.h"
+#include "TextureAtlas.h"
+
+// The number of tiles along each side of the chunks that tiles are drawn in
+#define TILESET_CHUNK_SIZE 16
 
 namespace gameplay
 {
-  
+
+// The strip indices of the tiles of a chunk, joined by degenerate triangles.
+static std::vector<unsigned short> __chunkIndices;
+
 TileSet::TileSet() : Drawable(),
     _tiles(NULL), _tileWidth(0), _tileHeight(0),
     _rowCount(0), _columnCount(0), _width(0), _height(0),
-    _opacity(1.0f), _color(Vector4::one()), _batch(NULL)
+    _opacity(1.0f), _color(Vector4::one()), _batch(NULL),
+    _chunkColumnCount(0), _chunkRowCount(0)
 {
 }
 
@@ -32,7 +40,11 @@ TileSet* TileSet::create(const char* imagePath,
     GP_ASSERT(tileWidth > 0 && tileHeight > 0);
     GP_ASSERT(rowCount > 0 && columnCount > 0);
     
-    SpriteBatch* batch = SpriteBatch::create(imagePath);
+    // Images packed into an atlas are drawn from their page, with tiles offset by the
+    // position of the image in it.
+    TextureAtlas::Region region;
+    TextureAtlas* atlas = TextureAtlas::find(imagePath, &region);
+    SpriteBatch* batch = atlas ? SpriteBatch::create(atlas->getPage(region.page)) : SpriteBatch::create(imagePath);
     batch->getSampler()->setWrapMode(Texture::CLAMP, Texture::CLAMP);
     batch->getSampler()->setFilterMode(Texture::Filter::NEAREST, Texture::Filter::NEAREST);
     batch->getStateBlock()->setDepthWrite(false);
@@ -40,6 +52,8 @@ TileSet* TileSet::create(const char* imagePath,
     
     TileSet* tileset = new TileSet();
     tileset->_batch = batch;
+    if (atlas)
+        tileset->_imageOrigin.set(region.bounds.x, region.bounds.y);
     tileset->_tiles = new Vector2[rowCount * columnCount];
     memset(tileset->_tiles, -1, sizeof(float) * rowCount * columnCount * 2);
     tileset->_tileWidth = tileWidth;
@@ -48,6 +62,8 @@ TileSet* TileSet::create(const char* imagePath,
     tileset->_columnCount = columnCount;
     tileset->_width = tileWidth * columnCount;
     tileset->_height = tileHeight * rowCount;
+    tileset->_projectionMatrix = batch->getProjectionMatrix();
+    tileset->createChunks();
     return tileset;
 }
     
@@ -126,19 +142,39 @@ TileSet* TileSet::create(Properties* properties)
         set->setOpacity(properties->getFloat("opacity"));
     }
 
+    // Tile sets that are written in chunks of the size they are drawn in list every chunk that
+    // holds tiles, so the others start out empty.
+    bool useBounds = properties->exists("chunkSize") && properties->getInt("chunkSize") == TILESET_CHUNK_SIZE;
+    if (useBounds)
+    {
+        for (size_t i = 0, count = set->_chunks.size(); i < count; ++i)
+        {
+            Chunk& chunk = set->_chunks[i];
+            chunk.minColumn = chunk.minRow = 1;
+            chunk.maxColumn = chunk.maxRow = 0;
+        }
+    }
+
     // Get tile sources
     properties->rewind();
     Properties* tileProperties = NULL;
     while ((tileProperties = properties->getNextNamespace()))
     {
-        if (strcmp(tileProperties->getNamespace(), "tile") == 0)
+        if (strcmp(tileProperties->getNamespace(), "chunk") == 0)
+        {
+            if (!set->loadChunk(tileProperties, useBounds))
+            {
+                GP_WARN("TileSet chunk has invalid tiles.");
+            }
+        }
+        else if (strcmp(tileProperties->getNamespace(), "tile") == 0)
         {
             Vector2 cell;
             Vector2 source;
             if (tileProperties->getVector2("cell", &cell) && tileProperties->getVector2("source", &source) &&
                 (cell.x >= 0 && cell.y >= 0 && cell.x < set->_columnCount && cell.y < set->_rowCount))
             {
-                set->_tiles[(int)cell.y * set->_columnCount + (int)cell.x] = source;
+                set->setTileSource((unsigned int)cell.x, (unsigned int)cell.y, source);
             }
         }
     }
@@ -152,6 +188,25 @@ void TileSet::setTileSource(unsigned int column, unsigned int row, const Vector2
     GP_ASSERT(row < _rowCount);
     
     _tiles[row * _columnCount + column] = source;
+    Chunk& chunk = _chunks[(row / TILESET_CHUNK_SIZE) * _chunkColumnCount + column / TILESET_CHUNK_SIZE];
+    chunk.dirty = true;
+
+    // The bounds only grow here and shrink again when the chunk is built.
+    if (source.x >= 0 && source.y >= 0)
+    {
+        if (chunk.minColumn > chunk.maxColumn)
+        {
+            chunk.minColumn = chunk.maxColumn = column;
+            chunk.minRow = chunk.maxRow = row;
+        }
+        else
+        {
+            chunk.minColumn = std::min(chunk.minColumn, column);
+            chunk.maxColumn = std::max(chunk.maxColumn, column);
+            chunk.minRow = std::min(chunk.minRow, row);
+            chunk.maxRow = std::max(chunk.maxRow, row);
+        }
+    }
 }
 
 void TileSet::getTileSource(unsigned int column, unsigned int row, Vector2* source)
@@ -196,7 +251,11 @@ float TileSet::getHeight() const
     
 void TileSet::setOpacity(float opacity)
 {
-    _opacity = opacity;
+    if (opacity != _opacity)
+    {
+        _opacity = opacity;
+        invalidateChunks();
+    }
 }
 
 float TileSet::getOpacity() const
@@ -206,7 +265,11 @@ float TileSet::getOpacity() const
 
 void TileSet::setColor(const Vector4& color)
 {
-    _color = color;
+    if (color != _color)
+    {
+        _color = color;
+        invalidateChunks();
+    }
 }
 
 const Vector4& TileSet::getColor() const
@@ -214,10 +277,176 @@ const Vector4& TileSet::getColor() const
     return _color;
 }
 
+void TileSet::createChunks()
+{
+    _chunkColumnCount = (_columnCount + TILESET_CHUNK_SIZE - 1) / TILESET_CHUNK_SIZE;
+    _chunkRowCount = (_rowCount + TILESET_CHUNK_SIZE - 1) / TILESET_CHUNK_SIZE;
+    _chunks.resize(_chunkColumnCount * _chunkRowCount);
+    invalidateChunks();
+
+    // Until a chunk is built, its bounds cover all of its tiles.
+    for (unsigned int chunkRow = 0; chunkRow < _chunkRowCount; ++chunkRow)
+    {
+        for (unsigned int chunkColumn = 0; chunkColumn < _chunkColumnCount; ++chunkColumn)
+        {
+            Chunk& chunk = _chunks[chunkRow * _chunkColumnCount + chunkColumn];
+            chunk.minColumn = chunkColumn * TILESET_CHUNK_SIZE;
+            chunk.minRow = chunkRow * TILESET_CHUNK_SIZE;
+            chunk.maxColumn = std::min((chunkColumn + 1) * TILESET_CHUNK_SIZE, _columnCount) - 1;
+            chunk.maxRow = std::min((chunkRow + 1) * TILESET_CHUNK_SIZE, _rowCount) - 1;
+        }
+    }
+
+    if (__chunkIndices.empty())
+    {
+        for (unsigned short i = 0; i < TILESET_CHUNK_SIZE * TILESET_CHUNK_SIZE; ++i)
+        {
+            unsigned short first = i * 4;
+            if (i > 0)
+            {
+                __chunkIndices.push_back(first - 1);
+                __chunkIndices.push_back(first);
+            }
+            __chunkIndices.push_back(first);
+            __chunkIndices.push_back(first + 1);
+            __chunkIndices.push_back(first + 2);
+            __chunkIndices.push_back(first + 3);
+        }
+    }
+}
+
+void TileSet::invalidateChunks()
+{
+    for (size_t i = 0, count = _chunks.size(); i < count; ++i)
+    {
+        _chunks[i].dirty = true;
+    }
+}
+
+void TileSet::buildChunk(unsigned int chunkColumn, unsigned int chunkRow)
+{
+    Chunk& chunk = _chunks[chunkRow * _chunkColumnCount + chunkColumn];
+    chunk.vertices.clear();
+    chunk.dirty = false;
+
+    Texture* texture = _batch->getSampler()->getTexture();
+    GP_ASSERT(texture);
+    const float widthRatio = 1.0f / (float)texture->getWidth();
+    const float heightRatio = 1.0f / (float)texture->getHeight();
+    const Vector4 color(_color.x, _color.y, _color.z, _color.w * _opacity);
+
+    unsigned int rowEnd = std::min((chunkRow + 1) * TILESET_CHUNK_SIZE, _rowCount);
+    unsigned int colEnd = std::min((chunkColumn + 1) * TILESET_CHUNK_SIZE, _columnCount);
+    chunk.minColumn = colEnd;
+    chunk.minRow = rowEnd;
+    chunk.maxColumn = chunk.maxRow = 0;
+    for (unsigned int row = chunkRow * TILESET_CHUNK_SIZE; row < rowEnd; row++)
+    {
+        // The first row is at the top of the tile set.
+        const float y = _tileHeight * (_rowCount - 1 - row);
+        const float y2 = y + _tileHeight;
+        for (unsigned int col = chunkColumn * TILESET_CHUNK_SIZE; col < colEnd; col++)
+        {
+            // Negative values are skipped to allow blank tiles
+            const Vector2& source = _tiles[row * _columnCount + col];
+            if (source.x < 0 || source.y < 0)
+                continue;
+
+            chunk.minColumn = std::min(chunk.minColumn, col);
+            chunk.minRow = std::min(chunk.minRow, row);
+            chunk.maxColumn = std::max(chunk.maxColumn, col);
+            chunk.maxRow = std::max(chunk.maxRow, row);
+
+            const float x = _tileWidth * col;
+            const float x2 = x + _tileWidth;
+            const float u1 = widthRatio * (_imageOrigin.x + source.x);
+            const float v1 = 1.0f - heightRatio * (_imageOrigin.y + source.y);
+            const float u2 = u1 + widthRatio * _tileWidth;
+            const float v2 = v1 - heightRatio * _tileHeight;
+
+            SpriteBatch::SpriteVertex v[4] =
+            {
+                { x, y2, 0, u1, v1, color.x, color.y, color.z, color.w },
+                { x, y, 0, u1, v2, color.x, color.y, color.z, color.w },
+                { x2, y2, 0, u2, v1, color.x, color.y, color.z, color.w },
+                { x2, y, 0, u2, v2, color.x, color.y, color.z, color.w }
+            };
+            chunk.vertices.insert(chunk.vertices.end(), v, v + 4);
+        }
+    }
+}
+
+bool TileSet::loadChunk(Properties* chunkProperties, bool useBounds)
+{
+    GP_ASSERT(chunkProperties);
+
+    // Each run is the column and row of its first tile followed by the source of each tile.
+    bool valid = true;
+    const char* name;
+    chunkProperties->rewind();
+    while ((name = chunkProperties->getNextProperty()))
+    {
+        if (strcmp(name, "run") != 0)
+            continue;
+
+        const char* str = chunkProperties->getString();
+        char* end;
+        unsigned long column = strtoul(str, &end, 10);
+        if (end == str || *end != ',')
+        {
+            valid = false;
+            continue;
+        }
+        str = end + 1;
+        unsigned long row = strtoul(str, &end, 10);
+        if (end == str || row >= _rowCount)
+        {
+            valid = false;
+            continue;
+        }
+        for (str = end; *str == ','; ++column)
+        {
+            Vector2 source;
+            source.x = (float)strtod(str + 1, &end);
+            if (end == str + 1 || *end != ',')
+                break;
+            str = end + 1;
+            source.y = (float)strtod(str, &end);
+            if (end == str || column >= _columnCount)
+                break;
+            str = end;
+            setTileSource((unsigned int)column, (unsigned int)row, source);
+        }
+        valid = valid && *str == '\0';
+    }
+
+    // The bounds of the tiles are only trusted if their chunk is the one they are drawn in.
+    Vector4 bounds;
+    if (useBounds && chunkProperties->getVector4("bounds", &bounds))
+    {
+        unsigned int minColumn = (unsigned int)bounds.x;
+        unsigned int minRow = (unsigned int)bounds.y;
+        unsigned int maxColumn = (unsigned int)bounds.z;
+        unsigned int maxRow = (unsigned int)bounds.w;
+        if (bounds.x < 0 || bounds.y < 0 || minColumn > maxColumn || minRow > maxRow || maxColumn >= _columnCount || maxRow >= _rowCount ||
+            minColumn / TILESET_CHUNK_SIZE != maxColumn / TILESET_CHUNK_SIZE || minRow / TILESET_CHUNK_SIZE != maxRow / TILESET_CHUNK_SIZE)
+        {
+            return false;
+        }
+        Chunk& chunk = _chunks[(minRow / TILESET_CHUNK_SIZE) * _chunkColumnCount + minColumn / TILESET_CHUNK_SIZE];
+        chunk.minColumn = minColumn;
+        chunk.minRow = minRow;
+        chunk.maxColumn = maxColumn;
+        chunk.maxRow = maxRow;
+    }
+    return valid;
+}
+
 unsigned int TileSet::draw(bool wireframe)
 {
     // Apply scene camera projection and translation offsets
     Vector3 position = Vector3::zero();
+    Matrix projectionMatrix = _projectionMatrix;
     if (_node && _node->getScene())
     {
         Camera* activeCamera = _node->getScene()->getActiveCamera();
@@ -227,9 +456,7 @@ unsigned int TileSet::draw(bool wireframe)
             if (cameraNode)
             {
                 // Scene projection
-                Matrix projectionMatrix;
                 projectionMatrix = _node->getProjectionMatrix();
-                _batch->setProjectionMatrix(projectionMatrix);
 
                 position.x -= cameraNode->getTranslationWorld().x;
                 position.y -= cameraNode->getTranslationWorld().y;
@@ -242,31 +469,62 @@ unsigned int TileSet::draw(bool wireframe)
         position.y += translation.y;
         position.z += translation.z;
     }
-    
-    // Draw each cell in the tile set
-    position.y += _tileHeight * (_rowCount - 1);
-    float xStart = position.x;
+
+    // The vertices of the chunks are relative to the tile set, which the projection moves into place.
+    projectionMatrix.translate(position);
+    _batch->setProjectionMatrix(projectionMatrix);
+
+    // Find the part of the tile set within the view from the corners of the clip space, for
+    // the projections that keep straight lines parallel, like those of 2D cameras.
+    float minX = 0, minY = 0, maxX = _width, maxY = _height;
+    Matrix inverse;
+    const float* m = projectionMatrix.m;
+    if (m[3] == 0 && m[7] == 0 && m[11] == 0 && m[15] == 1 && projectionMatrix.invert(&inverse))
+    {
+        minX = minY = std::numeric_limits<float>::max();
+        maxX = maxY = -std::numeric_limits<float>::max();
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            Vector3 corner((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, 0);
+            inverse.transformPoint(&corner);
+            minX = std::min(minX, corner.x);
+            minY = std::min(minY, corner.y);
+            maxX = std::max(maxX, corner.x);
+            maxY = std::max(maxY, corner.y);
+        }
+    }
+
+    // Draw the chunks within the view, building those whose tiles changed.
+    const float chunkHeight = _tileHeight * TILESET_CHUNK_SIZE;
     _batch->start();
-    for (unsigned int row = 0; row < _rowCount; row++)
+    for (unsigned int chunkRow = 0; chunkRow < _chunkRowCount; chunkRow++)
     {
-        for (unsigned int col = 0; col < _columnCount; col++)
+        // Chunk rows go down from the top of the tile set like tile rows.
+        const float top = _height - chunkHeight * chunkRow;
+        if (top < minY || top - chunkHeight > maxY)
+            continue;
+
+        for (unsigned int chunkColumn = 0; chunkColumn < _chunkColumnCount; chunkColumn++)
         {
-            Vector2 scale = Vector2(_tileWidth, _tileHeight);
-            
-            // Negative values are skipped to allow blank tiles
-            if (_tiles[row * _columnCount + col].x >= 0 &&
-                _tiles[row * _columnCount + col].y >= 0)
-            {
-                Rectangle source = Rectangle(_tiles[row * _columnCount + col].x,
-                                             _tiles[row * _columnCount + col].y, _tileWidth, _tileHeight);
-                _batch->draw(position, source, scale, Vector4(_color.x, _color.y, _color.z, _color.w * _opacity),
-                             Vector2(0.5f, 0.5f), 0);
-            }
-            
-            position.x += _tileWidth;
+            // Chunks are culled to the bounds of their tiles and skipped if they have none.
+            Chunk& chunk = _chunks[chunkRow * _chunkColumnCount + chunkColumn];
+            if (chunk.minColumn > chunk.maxColumn || chunk.minRow > chunk.maxRow)
+                continue;
+            const float left = _tileWidth * chunk.minColumn;
+            const float right = _tileWidth * (chunk.maxColumn + 1);
+            const float boundsTop = _height - _tileHeight * chunk.minRow;
+            const float boundsBottom = _height - _tileHeight * (chunk.maxRow + 1);
+            if (right < minX || left > maxX || boundsTop < minY || boundsBottom > maxY)
+                continue;
+
+            if (chunk.dirty)
+                buildChunk(chunkColumn, chunkRow);
+            if (chunk.vertices.empty())
+                continue;
+
+            unsigned int tileCount = (unsigned int)chunk.vertices.size() / 4;
+            _batch->draw(&chunk.vertices[0], tileCount * 4, &__chunkIndices[0], tileCount * 6 - 2);
         }
-        position.x = xStart;
-        position.y -= _tileHeight;
     }
     _batch->finish();
     return 1;
@@ -277,18 +535,28 @@ Drawable* TileSet::clone(NodeCloneContext& context)
     TileSet* tilesetClone = new TileSet();
 
     // Clone properties
+    tilesetClone->_rowCount = _rowCount;
+    tilesetClone->_columnCount = _columnCount;
     tilesetClone->_tiles = new Vector2[tilesetClone->_rowCount * tilesetClone->_columnCount];
-    memset(tilesetClone->_tiles, -1, sizeof(float) * tilesetClone->_rowCount * tilesetClone->_columnCount * 2);
     memcpy(tilesetClone->_tiles, _tiles, sizeof(Vector2) * tilesetClone->_rowCount * tilesetClone->_columnCount);
     tilesetClone->_tileWidth = _tileWidth;
     tilesetClone->_tileHeight = _tileHeight;
-    tilesetClone->_rowCount = _rowCount;
-    tilesetClone->_columnCount = _columnCount;
     tilesetClone->_width = _tileWidth * _columnCount;
     tilesetClone->_height = _tileHeight * _rowCount;
     tilesetClone->_opacity = _opacity;
     tilesetClone->_color = _color;
     tilesetClone->_batch = _batch;
+    tilesetClone->_imageOrigin = _imageOrigin;
+    tilesetClone->_projectionMatrix = _projectionMatrix;
+    tilesetClone->createChunks();
+    for (size_t i = 0, count = _chunks.size(); i < count; ++i)
+    {
+        Chunk& chunk = tilesetClone->_chunks[i];
+        chunk.minColumn = _chunks[i].minColumn;
+        chunk.minRow = _chunks[i].minRow;
+        chunk.maxColumn = _chunks[i].maxColumn;
+        chunk.maxRow = _chunks[i].maxRow;
+    }
 
     return tilesetClone;
 }
@@ -26,6 +26,16 @@ namespace gameplay
  * a gutter of duplicate pixels on each side of the region.
  *
  * The tile set does not support rotation or scaling.
+ *
+ * Tiles are drawn in square chunks whose vertices are kept between frames,
+ * and only the chunks within the view of the camera are drawn. Changing the
+ * source of a tile only rebuilds its chunk, so that large maps with a few
+ * animated tiles draw as quickly as the part of them that is on screen.
+ *
+ * Tile sets written by the encoder list their tiles in chunk namespaces, each
+ * with the bounds of its tiles and runs of adjacent tiles along its rows, so
+ * the chunks that hold no tiles are never built and the others are culled to
+ * the area their tiles cover. Single tile namespaces are still read.
  */
 class TileSet : public Ref, public Drawable
 {
@@ -176,6 +186,41 @@ protected:
 
 private:
 
+    /**
+     * A square block of tiles whose vertices are kept until one of its tiles changes.
+     */
+    struct Chunk
+    {
+        std::vector<SpriteBatch::SpriteVertex> vertices;
+        bool dirty;
+        /** The first and last columns and rows that hold tiles, empty if the first is past the last. */
+        unsigned int minColumn;
+        unsigned int minRow;
+        unsigned int maxColumn;
+        unsigned int maxRow;
+    };
+
+    /**
+     * Creates the chunks covering the tiles, to be built when first drawn.
+     */
+    void createChunks();
+
+    /**
+     * Marks every chunk to be built again, for changes that affect all the tiles.
+     */
+    void invalidateChunks();
+
+    /**
+     * Builds the vertices of the tiles of a chunk, relative to the bottom left corner of the tile set.
+     */
+    void buildChunk(unsigned int chunkColumn, unsigned int chunkRow);
+
+    /**
+     * Loads the tiles of a chunk written by the encoder, with the bounds of its tiles and the
+     * runs of adjacent tiles along its rows.
+     */
+    bool loadChunk(Properties* chunkProperties, bool useBounds);
+
     Vector2* _tiles;
     float _tileWidth;
     float _tileHeight;
@@ -184,8 +229,13 @@ private:
     float _width;
     float _height;
     SpriteBatch* _batch;
+    Vector2 _imageOrigin;
     float _opacity;
     Vector4 _color;
+    Matrix _projectionMatrix;
+    std::vector<Chunk> _chunks;
+    unsigned int _chunkColumnCount;
+    unsigned int _chunkRowCount;
 };
     
 }
@@ -0,0 +1,422 @@
+#include "Base.h"
+#include "TiledTerrain.h"
+#include "Game.h"
+#include "Node.h"
+#include "Scene.h"
+
+namespace gameplay
+{
+
+// The number of tiles that are decoded at the same time by default.
+static const unsigned int DEFAULT_MAX_LOADS = 2;
+
+// The default load distance, as a number of tiles.
+static const float DEFAULT_LOAD_DISTANCE = 2.0f;
+
+// The default unload distance, as a ratio of the load distance.
+static const float DEFAULT_UNLOAD_DISTANCE_RATIO = 1.25f;
+
+static bool isValidTilePattern(const char* pattern);
+
+TiledTerrain::Tile::Tile()
+    : row(0), column(0), state(TILE_UNLOADED), node(NULL), memory(0), distance(0.0f), wanted(false),
+      properties(NULL), definition(NULL), heightfield(NULL)
+{
+}
+
+TiledTerrain::Tile::~Tile()
+{
+    SAFE_RELEASE(heightfield);
+    SAFE_DELETE(properties);
+    SAFE_RELEASE(node);
+}
+
+void TiledTerrain::Tile::execute(unsigned int worker)
+{
+    // Only the definition and heights are read here, everything that calls into OpenGL
+    // is created once the tile is built on the main thread.
+    properties = Properties::create(path.c_str());
+    if (properties)
+    {
+        definition = strlen(properties->getNamespace()) > 0 ? properties : properties->getNextNamespace();
+        if (definition)
+            heightfield = Terrain::loadHeightField(definition, path.c_str());
+    }
+}
+
+TiledTerrain::TiledTerrain(Node* node)
+    : _node(node), _rows(0), _columns(0), _loadDistance(0.0f), _unloadDistance(0.0f), _memoryBudget(0), _memoryUsage(0),
+      _maxLoads(DEFAULT_MAX_LOADS), _maxBuildsPerFrame(1), _physics(false), _loadedCount(0), _pendingCount(0)
+{
+    GP_ASSERT(_node);
+    _node->addRef();
+}
+
+TiledTerrain::~TiledTerrain()
+{
+    JobController* jobController = Game::getInstance()->getJobController();
+    for (size_t i = 0, count = _tiles.size(); i < count; ++i)
+    {
+        Tile* tile = _tiles[i];
+        if (tile->state == TILE_LOADING)
+            jobController->wait(&tile->group);
+        else if (tile->state == TILE_LOADED)
+            unloadTile(tile);
+        SAFE_DELETE(tile);
+    }
+    SAFE_RELEASE(_node);
+}
+
+TiledTerrain* TiledTerrain::create(const char* path, Node* node)
+{
+    Properties* properties = Properties::create(path);
+    if (!properties)
+    {
+        GP_WARN("Failed to load tiled terrain definition: %s", path);
+        return NULL;
+    }
+
+    Properties* definition = strlen(properties->getNamespace()) > 0 ? properties : properties->getNextNamespace();
+    TiledTerrain* terrain = NULL;
+    if (definition)
+        terrain = create(definition, node);
+    else
+        GP_WARN("Invalid tiled terrain definition: %s", path);
+
+    SAFE_DELETE(properties);
+    return terrain;
+}
+
+TiledTerrain* TiledTerrain::create(Properties* properties, Node* node)
+{
+    GP_ASSERT(properties);
+    GP_ASSERT(node);
+
+    const char* tiles = properties->getString("tiles");
+    if (!isValidTilePattern(tiles))
+    {
+        GP_WARN("Invalid or missing 'tiles' pattern in tiled terrain definition; it must contain the column and row as two %%d.");
+        return NULL;
+    }
+
+    int rows = properties->getInt("rows");
+    int columns = properties->getInt("columns");
+    if (rows <= 0 || columns <= 0)
+    {
+        GP_WARN("Invalid or missing 'rows' and 'columns' in tiled terrain definition.");
+        return NULL;
+    }
+
+    Vector2 tileSize;
+    if (!properties->getVector2("tileSize", &tileSize) || tileSize.x <= 0.0f || tileSize.y <= 0.0f)
+    {
+        GP_WARN("Invalid or missing 'tileSize' in tiled terrain definition.");
+        return NULL;
+    }
+
+    TiledTerrain* terrain = new TiledTerrain(node);
+    terrain->_rows = (unsigned int)rows;
+    terrain->_columns = (unsigned int)columns;
+    terrain->_tileSize = tileSize;
+
+    float loadDistance = properties->exists("loadDistance") ? properties->getFloat("loadDistance") : std::max(tileSize.x, tileSize.y) * DEFAULT_LOAD_DISTANCE;
+    float unloadDistance = properties->exists("unloadDistance") ? properties->getFloat("unloadDistance") : loadDistance * DEFAULT_UNLOAD_DISTANCE_RATIO;
+    terrain->setDistances(loadDistance, unloadDistance);
+
+    if (properties->exists("memoryBudget"))
+        terrain->_memoryBudget = (size_t)(std::max(properties->getFloat("memoryBudget"), 0.0f) * 1024.0f * 1024.0f);
+    if (properties->exists("maxLoads"))
+        terrain->_maxLoads = (unsigned int)std::max(properties->getInt("maxLoads"), 1);
+    if (properties->exists("maxBuildsPerFrame"))
+        terrain->_maxBuildsPerFrame = (unsigned int)std::max(properties->getInt("maxBuildsPerFrame"), 1);
+    terrain->_physics = properties->getBool("physics");
+
+    size_t length = strlen(tiles) + 32;
+    std::vector<char> path(length);
+    terrain->_tiles.reserve(rows * columns);
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int column = 0; column < columns; ++column)
+        {
+            Tile* tile = new Tile();
+            tile->row = (unsigned int)row;
+            tile->column = (unsigned int)column;
+            snprintf(&path[0], length, tiles, column, row);
+            tile->path = &path[0];
+            terrain->_tiles.push_back(tile);
+        }
+    }
+    terrain->_sortedTiles = terrain->_tiles;
+
+    return terrain;
+}
+
+Node* TiledTerrain::getNode() const
+{
+    return _node;
+}
+
+unsigned int TiledTerrain::getRowCount() const
+{
+    return _rows;
+}
+
+unsigned int TiledTerrain::getColumnCount() const
+{
+    return _columns;
+}
+
+const Vector2& TiledTerrain::getTileSize() const
+{
+    return _tileSize;
+}
+
+void TiledTerrain::setDistances(float loadDistance, float unloadDistance)
+{
+    _loadDistance = std::max(loadDistance, 0.0f);
+    _unloadDistance = std::max(unloadDistance, _loadDistance);
+}
+
+float TiledTerrain::getLoadDistance() const
+{
+    return _loadDistance;
+}
+
+float TiledTerrain::getUnloadDistance() const
+{
+    return _unloadDistance;
+}
+
+void TiledTerrain::setMemoryBudget(size_t budget)
+{
+    _memoryBudget = budget;
+}
+
+size_t TiledTerrain::getMemoryBudget() const
+{
+    return _memoryBudget;
+}
+
+size_t TiledTerrain::getMemoryUsage() const
+{
+    return _memoryUsage;
+}
+
+unsigned int TiledTerrain::getLoadedTileCount() const
+{
+    return _loadedCount;
+}
+
+unsigned int TiledTerrain::getPendingTileCount() const
+{
+    return _pendingCount;
+}
+
+Terrain* TiledTerrain::getTerrain(unsigned int row, unsigned int column) const
+{
+    if (row >= _rows || column >= _columns)
+        return NULL;
+
+    Tile* tile = _tiles[row * _columns + column];
+    return tile->node ? dynamic_cast<Terrain*>(tile->node->getDrawable()) : NULL;
+}
+
+float TiledTerrain::getHeight(float x, float z) const
+{
+    Matrix inverse;
+    _node->getWorldMatrix().invert(&inverse);
+    Vector3 local;
+    inverse.transformPoint(Vector3(x, 0.0f, z), &local);
+
+    float column = (local.x / _tileSize.x) + _columns * 0.5f;
+    float row = (local.z / _tileSize.y) + _rows * 0.5f;
+    if (column < 0.0f || row < 0.0f)
+        return 0.0f;
+
+    Terrain* terrain = getTerrain((unsigned int)row, (unsigned int)column);
+    return terrain ? terrain->getHeight(x, z) : 0.0f;
+}
+
+void TiledTerrain::update()
+{
+    Scene* scene = _node->getScene();
+    Camera* camera = scene ? scene->getActiveCamera() : NULL;
+    if (camera && camera->getNode())
+        update(camera->getNode()->getTranslationWorld());
+}
+
+void TiledTerrain::update(const Vector3& position)
+{
+    // Tiles are laid out in the local space of the node, centered around its origin.
+    Matrix inverse;
+    _node->getWorldMatrix().invert(&inverse);
+    Vector3 local;
+    inverse.transformPoint(position, &local);
+
+    float originX = -0.5f * _columns * _tileSize.x;
+    float originZ = -0.5f * _rows * _tileSize.y;
+    for (size_t i = 0, count = _tiles.size(); i < count; ++i)
+    {
+        Tile* tile = _tiles[i];
+        float minX = originX + tile->column * _tileSize.x;
+        float minZ = originZ + tile->row * _tileSize.y;
+        float dx = std::max(std::max(minX - local.x, local.x - (minX + _tileSize.x)), 0.0f);
+        float dz = std::max(std::max(minZ - local.z, local.z - (minZ + _tileSize.y)), 0.0f);
+        tile->distance = sqrt(dx * dx + dz * dz);
+    }
+
+    // Keep the nearest tiles that fit into the memory budget. Tiles that are not loaded yet
+    // are assumed to cost as much as the average loaded tile, and loaded tiles are kept up
+    // to the unload distance.
+    std::sort(_sortedTiles.begin(), _sortedTiles.end(), [](const Tile* lhs, const Tile* rhs) { return lhs->distance < rhs->distance; });
+    size_t averageMemory = _loadedCount > 0 ? _memoryUsage / _loadedCount : 0;
+    size_t memory = 0;
+    for (size_t i = 0, count = _sortedTiles.size(); i < count; ++i)
+    {
+        Tile* tile = _sortedTiles[i];
+        tile->wanted = false;
+        if (tile->state == TILE_FAILED || tile->distance > (tile->state == TILE_UNLOADED ? _loadDistance : _unloadDistance))
+            continue;
+
+        size_t cost = tile->state == TILE_LOADED ? tile->memory : averageMemory;
+        if (_memoryBudget > 0 && memory > 0 && memory + cost > _memoryBudget)
+            continue;
+
+        memory += cost;
+        tile->wanted = true;
+    }
+
+    // Release the tiles that are no longer wanted, build the decoded ones and start
+    // decoding the nearest missing tiles.
+    JobController* jobController = Game::getInstance()->getJobController();
+    unsigned int builds = 0;
+    for (size_t i = 0, count = _sortedTiles.size(); i < count; ++i)
+    {
+        Tile* tile = _sortedTiles[i];
+        switch (tile->state)
+        {
+        case TILE_LOADED:
+            if (!tile->wanted)
+                unloadTile(tile);
+            break;
+
+        case TILE_LOADING:
+            if (!tile->group.isComplete())
+                break;
+            if (tile->wanted)
+            {
+                if (builds < _maxBuildsPerFrame)
+                {
+                    buildTile(tile);
+                    ++builds;
+                }
+            }
+            else
+            {
+                SAFE_RELEASE(tile->heightfield);
+                SAFE_DELETE(tile->properties);
+                tile->definition = NULL;
+                tile->state = TILE_UNLOADED;
+                --_pendingCount;
+            }
+            break;
+
+        case TILE_UNLOADED:
+            if (tile->wanted && _pendingCount < _maxLoads)
+            {
+                tile->state = TILE_LOADING;
+                ++_pendingCount;
+
+                // Without worker threads submitted jobs only run when they are waited for.
+                if (jobController->getWorkerCount() > 1)
+                    jobController->submit(tile, &tile->group);
+                else
+                    tile->execute(0);
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+void TiledTerrain::buildTile(Tile* tile)
+{
+    GP_ASSERT(tile->state == TILE_LOADING);
+    --_pendingCount;
+
+    Terrain* terrain = NULL;
+    if (tile->heightfield)
+    {
+        // The terrain takes ownership of the decoded heightfield.
+        terrain = Terrain::create(tile->path.c_str(), tile->definition, tile->heightfield);
+        tile->heightfield = NULL;
+    }
+    SAFE_DELETE(tile->properties);
+    tile->definition = NULL;
+
+    if (!terrain)
+    {
+        GP_WARN("Failed to load terrain tile: %s", tile->path.c_str());
+        tile->state = TILE_FAILED;
+        return;
+    }
+
+    char id[32];
+    sprintf(id, "tile_%u_%u", tile->column, tile->row);
+    tile->node = Node::create(id);
+    tile->node->setDrawable(terrain);
+    tile->node->setTranslation(-0.5f * _columns * _tileSize.x + (tile->column + 0.5f) * _tileSize.x, 0.0f,
+                               -0.5f * _rows * _tileSize.y + (tile->row + 0.5f) * _tileSize.y);
+    _node->addChild(tile->node);
+
+    if (_physics)
+    {
+        // The heightfield body is static and must be created once the node is positioned.
+        PhysicsRigidBody::Parameters parameters;
+        tile->node->setCollisionObject(PhysicsCollisionObject::RIGID_BODY, PhysicsCollisionShape::heightfield(), &parameters);
+    }
+
+    tile->memory = terrain->getMemoryUsage();
+    SAFE_RELEASE(terrain);
+
+    tile->state = TILE_LOADED;
+    _memoryUsage += tile->memory;
+    ++_loadedCount;
+}
+
+void TiledTerrain::unloadTile(Tile* tile)
+{
+    GP_ASSERT(tile->state == TILE_LOADED);
+    GP_ASSERT(tile->node);
+
+    _node->removeChild(tile->node);
+    SAFE_RELEASE(tile->node);
+
+    tile->state = TILE_UNLOADED;
+    _memoryUsage -= tile->memory;
+    tile->memory = 0;
+    --_loadedCount;
+}
+
+static bool isValidTilePattern(const char* pattern)
+{
+    if (pattern == NULL)
+        return false;
+
+    // The pattern is used as a format string, so it may only contain the two integers.
+    unsigned int count = 0;
+    for (const char* c = pattern; *c; ++c)
+    {
+        if (*c != '%')
+            continue;
+        if (c[1] != 'd')
+            return false;
+        ++count;
+        ++c;
+    }
+    return count == 2;
+}
+
+}
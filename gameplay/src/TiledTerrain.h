@@ -0,0 +1,299 @@
+#ifndef TILEDTERRAIN_H_
+#define TILEDTERRAIN_H_
+
+#include "Ref.h"
+#include "Terrain.h"
+#include "JobController.h"
+
+namespace gameplay
+{
+
+class Node;
+
+/**
+ * Defines a large terrain that is split into a grid of tiles which are streamed in
+ * and out around a position, usually the active camera.
+ *
+ * Each tile is an ordinary terrain definition file (see Terrain) with its own
+ * heightmap, layers and blend maps. Only the tiles within the load distance are kept
+ * in memory, each attached to its own child node of the node the tiled terrain was
+ * created for. The heightmap of a tile is read and decoded on a worker thread of the
+ * job controller, while the patches, textures and the optional physics heightfield
+ * are created on the main thread during update, at a limited number of tiles per frame.
+ *
+ * Tiles that move beyond the unload distance are released, as are the tiles furthest
+ * away once the estimated memory of all loaded tiles exceeds the memory budget. The
+ * unload distance should be somewhat larger than the load distance so that tiles are
+ * not reloaded repeatedly while the camera moves along a tile boundary.
+ *
+ * Tiled terrains are defined in a properties file with the following format:
+ *
+ @verbatim
+    tiledTerrain
+    {
+        // Path of the terrain definition of each tile, where the first %d is
+        // replaced by the column and the second %d by the row of the tile.
+        tiles = res/terrain/tile_%d_%d.terrain
+
+        // Number of rows and columns of tiles in the grid.
+        rows = 16
+        columns = 16
+
+        // Size of a tile on the X and Z axes, which should match the size of the
+        // terrain definitions. The grid is centered around the node.
+        tileSize = 256 256
+
+        // Distance from the camera to the edge of a tile within which tiles are
+        // loaded, and beyond which they are released again (optional).
+        loadDistance = 512
+        unloadDistance = 640
+
+        // Estimated memory that loaded tiles may use, in megabytes, zero for no limit (optional).
+        memoryBudget = 64
+
+        // Number of tiles that are decoded at the same time (optional, defaults to two)
+        // and created on the main thread per frame (optional, defaults to one).
+        maxLoads = 2
+        maxBuildsPerFrame = 1
+
+        // Whether to create a static heightfield rigid body for each tile (optional).
+        physics = true
+    }
+ @endverbatim
+ *
+ * Neighbouring tiles should share the heights along their common edges, otherwise
+ * the seams between them are visible.
+ *
+ * @script{ignore}
+ */
+class TiledTerrain : public Ref
+{
+public:
+
+    /**
+     * Creates a tiled terrain from the given properties file.
+     *
+     * @param path The path of the tiled terrain definition.
+     * @param node The node the tiles of the terrain are attached to.
+     *
+     * @return The new tiled terrain, or NULL if the definition is invalid.
+     */
+    static TiledTerrain* create(const char* path, Node* node);
+
+    /**
+     * Creates a tiled terrain from the given properties namespace.
+     *
+     * @param properties The tiled terrain definition.
+     * @param node The node the tiles of the terrain are attached to.
+     *
+     * @return The new tiled terrain, or NULL if the definition is invalid.
+     */
+    static TiledTerrain* create(Properties* properties, Node* node);
+
+    /**
+     * Returns the node the tiles of the terrain are attached to.
+     *
+     * @return The node of the terrain.
+     */
+    Node* getNode() const;
+
+    /**
+     * Returns the number of rows of tiles.
+     *
+     * @return The number of rows.
+     */
+    unsigned int getRowCount() const;
+
+    /**
+     * Returns the number of columns of tiles.
+     *
+     * @return The number of columns.
+     */
+    unsigned int getColumnCount() const;
+
+    /**
+     * Returns the size of a tile on the local X and Z axes of the node.
+     *
+     * @return The size of a tile.
+     */
+    const Vector2& getTileSize() const;
+
+    /**
+     * Sets the distance within which tiles are loaded and beyond which they are released.
+     *
+     * @param loadDistance The distance from the camera to the edge of a tile within which it is loaded.
+     * @param unloadDistance The distance beyond which a loaded tile is released, at least the load distance.
+     */
+    void setDistances(float loadDistance, float unloadDistance);
+
+    /**
+     * Returns the distance within which tiles are loaded.
+     *
+     * @return The load distance.
+     */
+    float getLoadDistance() const;
+
+    /**
+     * Returns the distance beyond which tiles are released.
+     *
+     * @return The unload distance.
+     */
+    float getUnloadDistance() const;
+
+    /**
+     * Sets the estimated memory that the loaded tiles may use.
+     *
+     * @param budget The memory budget in bytes, or zero for no limit.
+     */
+    void setMemoryBudget(size_t budget);
+
+    /**
+     * Returns the estimated memory that the loaded tiles may use.
+     *
+     * @return The memory budget in bytes, or zero for no limit.
+     */
+    size_t getMemoryBudget() const;
+
+    /**
+     * Returns the estimated memory used by the loaded tiles.
+     *
+     * @return The memory used, in bytes.
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * Returns the number of tiles that are loaded.
+     *
+     * @return The number of loaded tiles.
+     */
+    unsigned int getLoadedTileCount() const;
+
+    /**
+     * Returns the number of tiles that are being decoded or waiting to be created.
+     *
+     * @return The number of pending tiles.
+     */
+    unsigned int getPendingTileCount() const;
+
+    /**
+     * Returns the terrain of the given tile.
+     *
+     * @param row The row of the tile.
+     * @param column The column of the tile.
+     *
+     * @return The terrain of the tile, or NULL if the tile is not loaded.
+     */
+    Terrain* getTerrain(unsigned int row, unsigned int column) const;
+
+    /**
+     * Returns the world height of the terrain at the given world position.
+     *
+     * @param x The world X coordinate.
+     * @param z The world Z coordinate.
+     *
+     * @return The height at the position, or zero if the tile below it is not loaded.
+     */
+    float getHeight(float x, float z) const;
+
+    /**
+     * Streams tiles in and out around the translation of the active camera of
+     * the scene of the node.
+     */
+    void update();
+
+    /**
+     * Streams tiles in and out around the given position.
+     *
+     * @param position The world position to load tiles around.
+     */
+    void update(const Vector3& position);
+
+private:
+
+    /**
+     * The state of a tile.
+     */
+    enum TileState
+    {
+        TILE_UNLOADED,
+        TILE_LOADING,
+        TILE_LOADED,
+        TILE_FAILED
+    };
+
+    /**
+     * A tile of the terrain, which is also the job that reads its definition and
+     * decodes its heightfield on a worker.
+     */
+    struct Tile : public JobController::Job
+    {
+        Tile();
+
+        ~Tile();
+
+        void execute(unsigned int worker);
+
+        unsigned int row;
+        unsigned int column;
+        TileState state;
+        std::string path;
+        Node* node;
+        size_t memory;
+        float distance;
+        bool wanted;
+        Properties* properties;
+        Properties* definition;
+        HeightField* heightfield;
+        JobController::Group group;
+    };
+
+    /**
+     * Constructor.
+     */
+    TiledTerrain(Node* node);
+
+    /**
+     * Destructor.
+     */
+    ~TiledTerrain();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TiledTerrain(const TiledTerrain&);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TiledTerrain& operator=(const TiledTerrain&);
+
+    /**
+     * Creates the terrain and node of a tile whose heightfield has been decoded.
+     */
+    void buildTile(Tile* tile);
+
+    /**
+     * Releases the terrain and node of a tile.
+     */
+    void unloadTile(Tile* tile);
+
+    Node* _node;
+    unsigned int _rows;
+    unsigned int _columns;
+    Vector2 _tileSize;
+    float _loadDistance;
+    float _unloadDistance;
+    size_t _memoryBudget;
+    size_t _memoryUsage;
+    unsigned int _maxLoads;
+    unsigned int _maxBuildsPerFrame;
+    bool _physics;
+    std::vector<Tile*> _tiles;
+    std::vector<Tile*> _sortedTiles;
+    unsigned int _loadedCount;
+    unsigned int _pendingCount;
+};
+
+}
+
+#endif
@@ -0,0 +1,287 @@
+#include "Base.h"
+#include "TimerWheel.h"
+
+// The bits of an id that hold the index of its timer, above which is the generation of the timer.
+#define TIMER_INDEX_BITS 22
+#define TIMER_INDEX_MASK ((1u << TIMER_INDEX_BITS) - 1)
+#define TIMER_GENERATION_COUNT ((1u << (32 - TIMER_INDEX_BITS)) - 1)
+
+// The bits of a tick that select the slot of a level.
+#define TIMER_SLOT_BITS 8
+
+// The list of the timers whose millisecond has already been processed, after the slots of the wheel.
+#define TIMER_LIST_LATE (TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS)
+#define TIMER_LIST_FREE -1
+#define TIMER_LIST_DUE -2
+#define TIMER_INVALID 0xFFFFFFFF
+
+namespace gameplay
+{
+
+TimerWheel::TimerWheel()
+    : _free(TIMER_INVALID), _count(0), _wheelCount(0), _sequence(0), _tick(0)
+{
+    for (unsigned int i = 0; i <= TIMER_LIST_LATE; ++i)
+        _heads[i] = TIMER_INVALID;
+    for (unsigned int i = 0; i < TIMER_WHEEL_LEVELS; ++i)
+        _levelCounts[i] = 0;
+}
+
+TimerWheel::~TimerWheel()
+{
+}
+
+unsigned int TimerWheel::schedule(double time, TimeListener* listener, void* cookie)
+{
+    unsigned int index = _free;
+    if (index != TIMER_INVALID)
+    {
+        _free = _timers[index].next;
+    }
+    else
+    {
+        GP_ASSERT(_timers.size() < TIMER_INDEX_MASK);
+        index = (unsigned int)_timers.size();
+        _timers.push_back(Timer());
+        _timers[index].generation = 1;
+    }
+
+    Timer& timer = _timers[index];
+    timer.time = time;
+    timer.listener = listener;
+    timer.cookie = cookie;
+    timer.sequence = _sequence++;
+    ++_count;
+    insert(index);
+
+    return (timer.generation << TIMER_INDEX_BITS) | index;
+}
+
+bool TimerWheel::cancel(unsigned int id)
+{
+    int index = find(id);
+    if (index < 0)
+        return false;
+
+    release((unsigned int)index);
+    return true;
+}
+
+bool TimerWheel::isScheduled(unsigned int id) const
+{
+    return find(id) >= 0;
+}
+
+void TimerWheel::clear()
+{
+    for (unsigned int i = 0; i < _timers.size(); ++i)
+    {
+        if (_timers[i].list != TIMER_LIST_FREE)
+            release(i);
+    }
+    _due.clear();
+}
+
+unsigned int TimerWheel::getCount() const
+{
+    return _count;
+}
+
+void TimerWheel::update(double time)
+{
+    unsigned long long target = (unsigned long long)std::max(time, 0.0);
+    while (_tick < target)
+    {
+        if (_wheelCount == 0)
+        {
+            _tick = target;
+            break;
+        }
+
+        // Skip the turns of the lowest levels while they are empty up to the tick before
+        // they wrap around, which would move the timers of the next level down.
+        unsigned long long span = 1;
+        for (unsigned int level = 0; _levelCounts[level] == 0; ++level)
+            span *= TIMER_WHEEL_SLOTS;
+        if (span > 1)
+        {
+            unsigned long long last = (_tick / span + 1) * span - 1;
+            if (last > _tick)
+            {
+                _tick = std::min(last, target);
+                if (_tick == target)
+                    break;
+            }
+        }
+
+        ++_tick;
+        unsigned int slot = (unsigned int)(_tick & (TIMER_WHEEL_SLOTS - 1));
+        for (unsigned int level = 1; slot == 0 && level < TIMER_WHEEL_LEVELS; ++level)
+            slot = cascade(level);
+        collect((int)(_tick & (TIMER_WHEEL_SLOTS - 1)), time);
+    }
+    collect(TIMER_LIST_LATE, time);
+
+    if (_due.empty())
+        return;
+
+    // Fire in the order of the times. A listener can cancel the events that follow it, or
+    // clear all of them, so each event is looked up again before it is fired.
+    std::sort(_due.begin(), _due.end());
+    for (size_t i = 0; i < _due.size(); ++i)
+    {
+        int index = find(_due[i].id);
+        if (index < 0)
+            continue;
+
+        TimeListener* listener = _timers[index].listener;
+        void* cookie = _timers[index].cookie;
+        double dueTime = _timers[index].time;
+        release((unsigned int)index);
+
+        if (listener)
+            listener->timeEvent((long)(time - dueTime), cookie);
+    }
+    _due.clear();
+}
+
+bool TimerWheel::Due::operator<(const Due& other) const
+{
+    return time < other.time || (time == other.time && sequence < other.sequence);
+}
+
+int TimerWheel::find(unsigned int id) const
+{
+    unsigned int index = id & TIMER_INDEX_MASK;
+    if (index >= _timers.size())
+        return -1;
+
+    const Timer& timer = _timers[index];
+    if (timer.list == TIMER_LIST_FREE || timer.generation != (id >> TIMER_INDEX_BITS))
+        return -1;
+
+    return (int)index;
+}
+
+void TimerWheel::insert(unsigned int index)
+{
+    double time = _timers[index].time;
+    unsigned long long tick = (unsigned long long)std::max(time, 0.0);
+    if (tick <= _tick)
+    {
+        link(index, TIMER_LIST_LATE);
+        return;
+    }
+
+    // Find the lowest level whose span covers the time until the timer is due. Timers beyond
+    // the span of the whole wheel wait in the furthest slot of the last level.
+    unsigned long long delta = tick - _tick;
+    unsigned long long span = TIMER_WHEEL_SLOTS;
+    unsigned int level = 0;
+    while (delta >= span && level < TIMER_WHEEL_LEVELS - 1)
+    {
+        span *= TIMER_WHEEL_SLOTS;
+        ++level;
+    }
+
+    unsigned int shift = level * TIMER_SLOT_BITS;
+    unsigned long long position = delta < span ? tick >> shift : (_tick >> shift) + TIMER_WHEEL_SLOTS - 1;
+    link(index, (int)(level * TIMER_WHEEL_SLOTS + (unsigned int)(position & (TIMER_WHEEL_SLOTS - 1))));
+}
+
+void TimerWheel::link(unsigned int index, int list)
+{
+    Timer& timer = _timers[index];
+    timer.list = list;
+    timer.prev = TIMER_INVALID;
+    timer.next = _heads[list];
+    if (timer.next != TIMER_INVALID)
+        _timers[timer.next].prev = index;
+    _heads[list] = index;
+
+    if (list < TIMER_LIST_LATE)
+    {
+        ++_wheelCount;
+        ++_levelCounts[list / TIMER_WHEEL_SLOTS];
+    }
+}
+
+void TimerWheel::unlink(unsigned int index)
+{
+    Timer& timer = _timers[index];
+    GP_ASSERT(timer.list >= 0);
+
+    if (timer.prev != TIMER_INVALID)
+        _timers[timer.prev].next = timer.next;
+    else
+        _heads[timer.list] = timer.next;
+    if (timer.next != TIMER_INVALID)
+        _timers[timer.next].prev = timer.prev;
+
+    if (timer.list < TIMER_LIST_LATE)
+    {
+        --_wheelCount;
+        --_levelCounts[timer.list / TIMER_WHEEL_SLOTS];
+    }
+    timer.list = TIMER_LIST_DUE;
+}
+
+unsigned int TimerWheel::cascade(unsigned int level)
+{
+    unsigned int slot = (unsigned int)((_tick >> (level * TIMER_SLOT_BITS)) & (TIMER_WHEEL_SLOTS - 1));
+
+    // Timers are inserted at the head of their list, so the ones that land back in this slot
+    // are not visited again.
+    unsigned int index = _heads[level * TIMER_WHEEL_SLOTS + slot];
+    while (index != TIMER_INVALID)
+    {
+        unsigned int next = _timers[index].next;
+        unlink(index);
+        insert(index);
+        index = next;
+    }
+
+    return slot;
+}
+
+void TimerWheel::collect(int list, double time)
+{
+    unsigned int index = _heads[list];
+    while (index != TIMER_INVALID)
+    {
+        Timer& timer = _timers[index];
+        unsigned int next = timer.next;
+        if (timer.time <= time)
+        {
+            unlink(index);
+            Due due;
+            due.time = timer.time;
+            due.sequence = timer.sequence;
+            due.id = (timer.generation << TIMER_INDEX_BITS) | index;
+            _due.push_back(due);
+        }
+        else if (list != TIMER_LIST_LATE)
+        {
+            // The millisecond of the timer is the current one but its time is later within it.
+            unlink(index);
+            link(index, TIMER_LIST_LATE);
+        }
+        index = next;
+    }
+}
+
+void TimerWheel::release(unsigned int index)
+{
+    Timer& timer = _timers[index];
+    if (timer.list >= 0)
+        unlink(index);
+
+    timer.generation = timer.generation % TIMER_GENERATION_COUNT + 1;
+    timer.list = TIMER_LIST_FREE;
+    timer.listener = NULL;
+    timer.next = _free;
+    _free = index;
+    --_count;
+}
+
+}
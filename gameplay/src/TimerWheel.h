@@ -0,0 +1,185 @@
+#ifndef TIMERWHEEL_H_
+#define TIMERWHEEL_H_
+
+#include "TimeListener.h"
+
+// The number of levels of the wheel and the number of slots of each level.
+#define TIMER_WHEEL_LEVELS 4
+#define TIMER_WHEEL_SLOTS 256
+
+namespace gameplay
+{
+
+/**
+ * Defines a scheduler of time events that stays cheap with many thousands of pending events.
+ *
+ * Events are kept in a hierarchical timer wheel with a resolution of one millisecond. Each
+ * level of the wheel has TIMER_WHEEL_SLOTS slots, and each slot of a level spans as much time
+ * as the whole level below it. An event is placed in the lowest level whose span covers the
+ * time until it is due, and moves down a level each time the lower level wraps around, so
+ * scheduling and cancelling an event take constant time and updating only visits the slots
+ * of the milliseconds that have passed.
+ *
+ * The events of an update are fired in the order of their times, and events with the same
+ * time in the order they were scheduled. Events never fire before their time. Events that
+ * are scheduled while events are fired are fired by the next update at the earliest.
+ *
+ * Events are identified by the value returned by schedule, which stays unique for as long
+ * as the event is pending and can be used to cancel it.
+ *
+ * @see Game::schedule
+ * @script{ignore}
+ */
+class TimerWheel
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    TimerWheel();
+
+    /**
+     * Destructor.
+     */
+    ~TimerWheel();
+
+    /**
+     * Schedules a time event to be sent to the given listener once the given time is reached.
+     *
+     * @param time The time of the event, in milliseconds.
+     * @param listener The TimeListener that will receive the event.
+     * @param cookie The cookie data that the time event will contain.
+     *
+     * @return The id of the event, which is never 0.
+     */
+    unsigned int schedule(double time, TimeListener* listener, void* cookie = 0);
+
+    /**
+     * Cancels a pending time event.
+     *
+     * @param id The id of the event.
+     *
+     * @return true if the event was pending, false if it has already fired or been cancelled.
+     */
+    bool cancel(unsigned int id);
+
+    /**
+     * Returns whether a time event is pending.
+     *
+     * @param id The id of the event.
+     *
+     * @return true if the event has neither fired nor been cancelled.
+     */
+    bool isScheduled(unsigned int id) const;
+
+    /**
+     * Cancels all pending time events.
+     */
+    void clear();
+
+    /**
+     * Returns the number of pending time events.
+     *
+     * @return The number of pending events.
+     */
+    unsigned int getCount() const;
+
+    /**
+     * Fires the time events whose time has been reached.
+     *
+     * @param time The current time, in milliseconds, which should not go backwards.
+     */
+    void update(double time);
+
+private:
+
+    /**
+     * A scheduled time event.
+     */
+    struct Timer
+    {
+        double time;
+        TimeListener* listener;
+        void* cookie;
+        unsigned int sequence;
+        unsigned int generation;
+        int list;
+        unsigned int prev;
+        unsigned int next;
+    };
+
+    /**
+     * A time event that is due in the current update.
+     */
+    struct Due
+    {
+        double time;
+        unsigned int sequence;
+        unsigned int id;
+
+        bool operator<(const Due& other) const;
+    };
+
+    /**
+     * Hidden copy constructor.
+     */
+    TimerWheel(const TimerWheel& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TimerWheel& operator=(const TimerWheel&);
+
+    /**
+     * Returns the index of the timer with the given id, or -1 if the id is not pending.
+     */
+    int find(unsigned int id) const;
+
+    /**
+     * Places a timer in the slot of the wheel for its time, or in the late list when the
+     * millisecond of its time has already been processed.
+     */
+    void insert(unsigned int index);
+
+    /**
+     * Links a timer into a list.
+     */
+    void link(unsigned int index, int list);
+
+    /**
+     * Unlinks a timer from its list.
+     */
+    void unlink(unsigned int index);
+
+    /**
+     * Moves the timers of a slot of a level above the first into the levels below.
+     *
+     * @return The index of the slot.
+     */
+    unsigned int cascade(unsigned int level);
+
+    /**
+     * Moves the timers of a list whose time has been reached to the due timers.
+     */
+    void collect(int list, double time);
+
+    /**
+     * Returns a timer to the free list.
+     */
+    void release(unsigned int index);
+
+    std::vector<Timer> _timers;
+    unsigned int _heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS + 1];
+    unsigned int _levelCounts[TIMER_WHEEL_LEVELS];
+    unsigned int _free;
+    unsigned int _count;
+    unsigned int _wheelCount;
+    unsigned int _sequence;
+    unsigned long long _tick;
+    std::vector<Due> _due;
+};
+
+}
+
+#endif
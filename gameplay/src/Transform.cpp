@@ -9,6 +9,10 @@ namespace gameplay
 int Transform::_suspendTransformChanged(0);
 std::vector<Transform*> Transform::_transformsChanged;
 
+// The deferred notification phases of the thread, and the transforms whose listeners they notify.
+static thread_local int __deferTransformChanged = 0;
+static thread_local std::vector<Transform*> __transformsDeferred;
+
 Transform::Transform()
     : _matrixDirtyBits(0), _listeners(NULL)
 {
@@ -47,9 +51,62 @@ Transform::Transform(const Transform& copy)
 
 Transform::~Transform()
 {
+    // A transform that is destroyed while it waits for a notification is skipped.
+    if (_matrixDirtyBits & DIRTY_LISTENERS)
+    {
+        std::vector<Transform*>::iterator itr = std::find(__transformsDeferred.begin(), __transformsDeferred.end(), this);
+        if (itr != __transformsDeferred.end())
+            *itr = NULL;
+    }
+    if (_matrixDirtyBits & DIRTY_NOTIFY)
+    {
+        std::vector<Transform*>::iterator itr = std::find(_transformsChanged.begin(), _transformsChanged.end(), this);
+        if (itr != _transformsChanged.end())
+            *itr = NULL;
+    }
     SAFE_DELETE(_listeners);
 }
 
+#ifdef GP_USE_ALIGNED_MATH
+#ifdef GP_USE_MEM_LEAK_DETECTION
+#undef new
+#endif
+void* Transform::operator new(size_t size)
+{
+#ifdef GP_USE_MEM_LEAK_DETECTION
+    // The allocations of DebugNew are aligned for the math types.
+    return ::operator new(size);
+#else
+    void* ptr = alignedMalloc(size, GP_MATH_ALIGNMENT);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+#endif
+}
+
+void Transform::operator delete(void* ptr)
+{
+#ifdef GP_USE_MEM_LEAK_DETECTION
+    ::operator delete(ptr);
+#else
+    alignedFree(ptr);
+#endif
+}
+
+#ifdef GP_USE_MEM_LEAK_DETECTION
+void* Transform::operator new(size_t size, const char* file, int line)
+{
+    return ::operator new(size, file, line);
+}
+
+void Transform::operator delete(void* ptr, const char* file, int line)
+{
+    ::operator delete(ptr, file, line);
+}
+#define new DEBUG_NEW
+#endif
+#endif
+
 void Transform::suspendTransformChanged()
 {
     _suspendTransformChanged++;
@@ -67,8 +124,8 @@ void Transform::resumeTransformChanged()
         for (size_t i = 0; i < transformCount; i++)
         {
             Transform* t = _transformsChanged.at(i);
-            GP_ASSERT(t);
-            t->transformChanged();
+            if (t)
+                t->transformChanged();
         }
 
         // Go through list and reset DIRTY_NOTIFY bit. The list could potentially be larger here if the 
@@ -77,8 +134,8 @@ void Transform::resumeTransformChanged()
         for (size_t i = 0; i < transformCount; i++)
         {
             Transform* t = _transformsChanged.at(i);
-            GP_ASSERT(t);
-            t->_matrixDirtyBits &= ~DIRTY_NOTIFY;
+            if (t)
+                t->_matrixDirtyBits &= ~DIRTY_NOTIFY;
         }
 
         // empty list for next frame.
@@ -92,6 +149,39 @@ bool Transform::isTransformChangedSuspended()
     return (_suspendTransformChanged > 0);
 }
 
+void Transform::deferTransformChanged()
+{
+    __deferTransformChanged++;
+}
+
+void Transform::flushTransformChanged()
+{
+    if (__deferTransformChanged == 0)
+        return;
+
+    if (__deferTransformChanged == 1)
+    {
+        // Listeners that change other transforms append them to the list, and they are notified in turn.
+        for (size_t i = 0; i < __transformsDeferred.size(); i++)
+        {
+            Transform* t = __transformsDeferred[i];
+            if (t)
+            {
+                t->_matrixDirtyBits &= ~DIRTY_LISTENERS;
+                __transformsDeferred[i] = NULL;
+                t->notifyTransformChanged();
+            }
+        }
+        __transformsDeferred.clear();
+    }
+    __deferTransformChanged--;
+}
+
+bool Transform::isTransformChangedDeferred()
+{
+    return (__deferTransformChanged > 0);
+}
+
 const char* Transform::getTypeName() const
 {
     return "Transform";
@@ -103,20 +193,9 @@ const Matrix& Transform::getMatrix() const
     {
         if (!isStatic())
         {
-            bool hasScale = !_scale.isOne();
-            bool hasRotation = !_rotation.isIdentity();
-
             // Compose the matrix in TRS order since we use column-major matrices with column vectors and
             // multiply M*v (as opposed to XNA and DirectX that use row-major matrices with row vectors and multiply v*M).
-            Matrix::createTranslation(_translation, &_matrix);
-            if (hasRotation)
-            {
-                _matrix.rotate(_rotation);
-            }
-            if (hasScale)
-            {
-                _matrix.scale(_scale);
-            }
+            Matrix::createTransform(_translation, _rotation, _scale, &_matrix);
         }
 
         _matrixDirtyBits &= ~(DIRTY_TRANSLATION | DIRTY_ROTATION | DIRTY_SCALE);
@@ -948,7 +1027,7 @@ void Transform::addListener(Transform::Listener* listener, long cookie)
     GP_ASSERT(listener);
 
     if (_listeners == NULL)
-        _listeners = new std::list<TransformListener>();
+        _listeners = new std::vector<TransformListener>();
 
     TransformListener l;
     l.listener = listener;
@@ -962,7 +1041,7 @@ void Transform::removeListener(Transform::Listener* listener)
 
     if (_listeners)
     {
-        for (std::list<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); ++itr)
+        for (std::vector<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); ++itr)
         {
             if ((*itr).listener == listener)
             {
@@ -974,12 +1053,29 @@ void Transform::removeListener(Transform::Listener* listener)
 }
 
 void Transform::transformChanged()
+{
+    if (__deferTransformChanged > 0)
+    {
+        // The transform is listed once however often it changes, and only if anything listens to it.
+        if ((_matrixDirtyBits & DIRTY_LISTENERS) == 0 &&
+            ((_listeners && !_listeners->empty()) || hasScriptListener(GP_GET_SCRIPT_EVENT(Transform, transformChanged))))
+        {
+            _matrixDirtyBits |= DIRTY_LISTENERS;
+            __transformsDeferred.push_back(this);
+        }
+        return;
+    }
+    notifyTransformChanged();
+}
+
+void Transform::notifyTransformChanged()
 {
     if (_listeners)
     {
-        for (std::list<TransformListener>::iterator itr = _listeners->begin(); itr != _listeners->end(); ++itr)
+        // Listeners are indexed since they may add or remove listeners when they are notified.
+        for (size_t i = 0; i < _listeners->size(); ++i)
         {
-            TransformListener& l = *itr;
+            TransformListener l = (*_listeners)[i];
             GP_ASSERT(l.listener);
             l.listener->transformChanged(this, l.cookie);
         }
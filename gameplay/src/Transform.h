@@ -123,6 +123,39 @@ public:
      */
     static bool isTransformChangedSuspended();
 
+    /**
+     * Begins a phase during which the listeners of the transforms that change are notified
+     * once when the phase ends, rather than on every change.
+     *
+     * Unlike suspending transform changed events, the transforms and the nodes that change
+     * still update their own state right away, so world matrices and bounds stay correct
+     * during the phase. Only the listeners and the transformChanged script event wait.
+     *
+     * The game defers the notifications of the changes made by animation, physics, AI,
+     * gamepads, forms, scripts and the game update of every frame. Phases nest and are
+     * tracked per thread, and only the outermost flush notifies the listeners.
+     *
+     * @script{ignore}
+     */
+    static void deferTransformChanged();
+
+    /**
+     * Ends a phase begun with deferTransformChanged, and notifies the listeners of every
+     * transform that changed during the phase once.
+     *
+     * @script{ignore}
+     */
+    static void flushTransformChanged();
+
+    /**
+     * Gets whether the listeners of the transforms that change are notified when the
+     * current phase ends.
+     *
+     * @return true if transform changed notifications are deferred on this thread.
+     * @script{ignore}
+     */
+    static bool isTransformChangedDeferred();
+
     /**
      * Listener interface for Transform events.
      */
@@ -176,6 +209,38 @@ public:
      */
     virtual ~Transform();
 
+#ifdef GP_USE_ALIGNED_MATH
+#ifdef GP_USE_MEM_LEAK_DETECTION
+#undef new
+#endif
+    /**
+     * Allocates a transform aligned for the SIMD paths of its matrices and quaternions.
+     * @script{ignore}
+     */
+    static void* operator new(size_t size);
+
+    /**
+     * Frees a transform allocated by operator new.
+     * @script{ignore}
+     */
+    static void operator delete(void* ptr);
+
+#ifdef GP_USE_MEM_LEAK_DETECTION
+    /**
+     * Allocates a transform with the memory tracking of DebugNew.
+     * @script{ignore}
+     */
+    static void* operator new(size_t size, const char* file, int line);
+
+    /**
+     * Frees a transform allocated with the memory tracking of DebugNew.
+     * @script{ignore}
+     */
+    static void operator delete(void* ptr, const char* file, int line);
+#define new DEBUG_NEW
+#endif
+#endif
+
     /**
      * Extends ScriptTarget::getTypeName() to return the type name of this class.
      *
@@ -825,7 +890,8 @@ protected:
         DIRTY_TRANSLATION = 0x01,
         DIRTY_SCALE = 0x02,
         DIRTY_ROTATION = 0x04,
-        DIRTY_NOTIFY = 0x08
+        DIRTY_NOTIFY = 0x08,
+        DIRTY_LISTENERS = 0x10
     };
 
     /**
@@ -852,6 +918,11 @@ protected:
      */
     virtual void transformChanged();
 
+    /**
+     * Notifies the listeners and the scripts of the transform that it changed.
+     */
+    void notifyTransformChanged();
+
     /**
      * Copies from data from this node into transform for the purpose of cloning.
      * 
@@ -888,7 +959,7 @@ protected:
     /** 
      * List of TransformListener's on the Transform.
      */
-    std::list<TransformListener>* _listeners;
+    std::vector<TransformListener>* _listeners;
 
 private:
    
@@ -0,0 +1,206 @@
+#include "Base.h"
+#include "TransformHierarchy.h"
+#include "Scene.h"
+#include "Node.h"
+
+namespace gameplay
+{
+
+TransformHierarchy::TransformHierarchy(Scene* scene)
+    : _scene(scene), _dirtyNodes(false), _rebuild(true)
+{
+    GP_ASSERT(_scene);
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+    clear();
+}
+
+unsigned int TransformHierarchy::getNodeCount() const
+{
+    return (unsigned int)_nodes.size();
+}
+
+void TransformHierarchy::update()
+{
+    if (_rebuild)
+        rebuild();
+
+    if (!_dirtyNodes)
+        return;
+    _dirtyNodes = false;
+
+    // Parents are always stored before their children, so by the time we reach a node
+    // the world matrix of its parent has already been resolved for this pass.
+    Matrix local;
+    for (size_t i = 0, count = _nodes.size(); i < count; ++i)
+    {
+        if (!_dirty[i])
+            continue;
+        _dirty[i] = 0;
+
+        Node* node = _nodes[i];
+        if (node == NULL)
+            continue;
+        node->_dirtyBits &= ~NODE_DIRTY_WORLD;
+
+        if (node->isStatic())
+            continue;
+
+        // Compose the local matrix in TRS order (see Transform::getMatrix).
+        Matrix::createTransform(_translations[i], _rotations[i], _scales[i], &local);
+
+        int parent = _parents[i];
+        if (parent >= 0 && (!node->_collisionObject || node->_collisionObject->isKinematic()))
+        {
+            Matrix::multiplyAffine(_worlds[parent], local, &_worlds[i]);
+        }
+        else
+        {
+            _worlds[i] = local;
+        }
+    }
+}
+
+void TransformHierarchy::rebuild()
+{
+    _rebuild = false;
+
+    // Keep the previously resolved world matrices around so that nodes which are
+    // already attached don't lose their current world transform while being sorted.
+    std::vector<Matrix> worlds;
+    worlds.swap(_worlds);
+
+    size_t capacity = _nodes.size();
+    _nodes.clear();
+    _parents.clear();
+    _scales.clear();
+    _rotations.clear();
+    _translations.clear();
+    _dirty.clear();
+
+    _nodes.reserve(capacity);
+    _parents.reserve(capacity);
+    _scales.reserve(capacity);
+    _rotations.reserve(capacity);
+    _translations.reserve(capacity);
+    _worlds.reserve(capacity);
+    _dirty.reserve(capacity);
+
+    for (Node* node = _scene->getFirstNode(); node != NULL; node = node->getNextSibling())
+    {
+        add(node, -1, worlds);
+    }
+
+    // Breadth-first: the children of a node are appended once the node itself is visited.
+    for (size_t i = 0; i < _nodes.size(); ++i)
+    {
+        for (Node* child = _nodes[i]->getFirstChild(); child != NULL; child = child->getNextSibling())
+        {
+            add(child, (int)i, worlds);
+        }
+    }
+}
+
+void TransformHierarchy::add(Node* node, int parent, const std::vector<Matrix>& worlds)
+{
+    GP_ASSERT(node);
+
+    bool dirty = (node->_dirtyBits & NODE_DIRTY_WORLD) != 0;
+
+    _nodes.push_back(node);
+    _parents.push_back(parent);
+    _scales.push_back(node->_scale);
+    _rotations.push_back(node->_rotation);
+    _translations.push_back(node->_translation);
+    _worlds.push_back(node->_transformHierarchy == this ? worlds[node->_transformHierarchyIndex] : node->_world);
+    _dirty.push_back(dirty ? 1 : 0);
+    if (dirty)
+        _dirtyNodes = true;
+
+    node->_transformHierarchy = this;
+    node->_transformHierarchyIndex = (int)_nodes.size() - 1;
+}
+
+void TransformHierarchy::clear()
+{
+    for (size_t i = 0, count = _nodes.size(); i < count; ++i)
+    {
+        Node* node = _nodes[i];
+        if (node)
+        {
+            node->_world = _worlds[i];
+            node->_transformHierarchy = NULL;
+            node->_transformHierarchyIndex = -1;
+        }
+    }
+
+    _nodes.clear();
+    _parents.clear();
+    _scales.clear();
+    _rotations.clear();
+    _translations.clear();
+    _worlds.clear();
+    _dirty.clear();
+    _dirtyNodes = false;
+    _rebuild = true;
+}
+
+void TransformHierarchy::remove(Node* node)
+{
+    GP_ASSERT(node);
+
+    // Nodes below a detached node are never attached themselves,
+    // so there is no need to search any further.
+    if (node->_transformHierarchy != this)
+        return;
+
+    int index = node->_transformHierarchyIndex;
+    node->_world = _worlds[index];
+    node->_transformHierarchy = NULL;
+    node->_transformHierarchyIndex = -1;
+    _nodes[index] = NULL;
+    _dirty[index] = 0;
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        remove(child);
+    }
+
+    _rebuild = true;
+}
+
+void TransformHierarchy::invalidate()
+{
+    _rebuild = true;
+}
+
+void TransformHierarchy::setDirty(Node* node)
+{
+    GP_ASSERT(node && node->_transformHierarchy == this);
+
+    int index = node->_transformHierarchyIndex;
+    _scales[index] = node->_scale;
+    _rotations[index] = node->_rotation;
+    _translations[index] = node->_translation;
+    _dirty[index] = 1;
+    _dirtyNodes = true;
+}
+
+const Matrix& TransformHierarchy::getWorldMatrix(const Node* node)
+{
+    GP_ASSERT(node && node->_transformHierarchy == this);
+
+    if (node->_dirtyBits & NODE_DIRTY_WORLD)
+    {
+        _dirty[node->_transformHierarchyIndex] = 1;
+        _dirtyNodes = true;
+        update();
+    }
+
+    // Read the index after updating since a rebuild may have moved the node.
+    return _worlds[node->_transformHierarchyIndex];
+}
+
+}
@@ -0,0 +1,130 @@
+#ifndef TRANSFORMHIERARCHY_H_
+#define TRANSFORMHIERARCHY_H_
+
+#include "Vector3.h"
+#include "Quaternion.h"
+#include "Matrix.h"
+
+namespace gameplay
+{
+
+class Scene;
+class Node;
+
+/**
+ * Defines a flat, data-oriented copy of the transform hierarchy of a scene.
+ *
+ * The hierarchy stores the local scale, rotation and translation, the resolved
+ * world matrix, the parent index and a dirty flag of every node in the scene in
+ * separate contiguous arrays. Nodes are sorted breadth-first so that a parent is
+ * always stored before any of its children, which allows all dirty world matrices
+ * to be resolved in a single linear pass over the arrays instead of recursively
+ * walking the linked list of nodes.
+ *
+ * Nodes that are attached to a scene with an enabled transform hierarchy proxy
+ * their world matrix into the hierarchy. Nodes that are added to the scene after
+ * the hierarchy was built fall back to the regular recursive path until the next
+ * rebuild, which happens automatically on the next update.
+ *
+ * Joint hierarchies of mesh skins are not part of the scene graph and are therefore
+ * never stored in the hierarchy.
+ *
+ * @see Scene::setTransformHierarchyEnabled
+ * @script{ignore}
+ */
+class TransformHierarchy
+{
+    friend class Scene;
+    friend class Node;
+
+public:
+
+    /**
+     * Returns the number of nodes currently stored in the hierarchy.
+     *
+     * @return The number of stored nodes.
+     */
+    unsigned int getNodeCount() const;
+
+    /**
+     * Resolves the world matrices of all dirty nodes in a single pass.
+     *
+     * If the structure of the scene changed since the last update, the
+     * hierarchy is rebuilt first.
+     */
+    void update();
+
+private:
+
+    /**
+     * Constructor.
+     */
+    TransformHierarchy(Scene* scene);
+
+    /**
+     * Destructor.
+     */
+    ~TransformHierarchy();
+
+    /**
+     * Hidden copy constructor.
+     */
+    TransformHierarchy(const TransformHierarchy& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    TransformHierarchy& operator=(const TransformHierarchy&);
+
+    /**
+     * Sorts all nodes of the scene breadth-first and refills the arrays.
+     */
+    void rebuild();
+
+    /**
+     * Appends the given node to the arrays.
+     */
+    void add(Node* node, int parent, const std::vector<Matrix>& worlds);
+
+    /**
+     * Detaches all nodes from the hierarchy.
+     */
+    void clear();
+
+    /**
+     * Detaches the given node and all of its descendants from the hierarchy.
+     *
+     * The nodes keep their last resolved world matrix.
+     */
+    void remove(Node* node);
+
+    /**
+     * Marks the structure of the hierarchy as changed so that it gets rebuilt on the next update.
+     */
+    void invalidate();
+
+    /**
+     * Copies the local transform of the given node into the hierarchy and marks it dirty.
+     */
+    void setDirty(Node* node);
+
+    /**
+     * Returns the world matrix stored for the given node.
+     */
+    const Matrix& getWorldMatrix(const Node* node);
+
+    Scene* _scene;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    std::vector<Vector3> _scales;
+    std::vector<Quaternion> _rotations;
+    std::vector<Vector3> _translations;
+    std::vector<Matrix> _worlds;
+    std::vector<unsigned char> _dirty;
+    bool _dirtyNodes;
+    bool _rebuild;
+};
+
+}
+
+#endif
@@ -9,7 +9,7 @@ class Matrix;
 /**
  * Defines 4-element floating point vector.
  */
-class Vector4
+class GP_MATH_ALIGN Vector4
 {
 public:
 
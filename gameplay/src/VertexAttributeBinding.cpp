@@ -1,28 +1,74 @@
 #include "Base.h"
 #include "VertexAttributeBinding.h"
+#include "RenderStats.h"
 #include "Mesh.h"
 #include "Effect.h"
 
 namespace gameplay
 {
 
+// Hashes the mesh and effect pair that identifies a cached vertex attribute binding.
+struct VertexAttributeBindingKeyHash
+{
+    size_t operator()(const std::pair<Mesh*, Effect*>& key) const
+    {
+        size_t seed = std::hash<Mesh*>()(key.first);
+        return seed ^ (std::hash<Effect*>()(key.second) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+};
+
+typedef std::unordered_map<std::pair<Mesh*, Effect*>, VertexAttributeBinding*, VertexAttributeBindingKeyHash> VertexAttributeBindingCache;
+
 static GLuint __maxVertexAttribs = 0;
-static std::vector<VertexAttributeBinding*> __vertexAttributeBindingCache;
+static VertexAttributeBindingCache __vertexAttributeBindingCache;
+
+// State of the generic vertex attribute arrays while no vertex array object is bound,
+// used to only change attributes that differ from the previously bound software binding.
+static std::vector<bool> __enabledVertexAttribs;
+static const VertexAttributeBinding* __currentSoftwareBinding = NULL;
+
+// Returns the OpenGL type of the values of a vertex element.
+static GLenum getGLType(VertexFormat::Type type)
+{
+    switch (type)
+    {
+    case VertexFormat::HALF_FLOAT:
+        return GL_HALF_FLOAT;
+    case VertexFormat::BYTE:
+        return GL_BYTE;
+    case VertexFormat::UNSIGNED_BYTE:
+        return GL_UNSIGNED_BYTE;
+    case VertexFormat::SHORT:
+        return GL_SHORT;
+    case VertexFormat::UNSIGNED_SHORT:
+        return GL_UNSIGNED_SHORT;
+    case VertexFormat::INT_2_10_10_10_REV:
+        return GL_INT_2_10_10_10_REV;
+    default:
+        return GL_FLOAT;
+    }
+}
 
 VertexAttributeBinding::VertexAttributeBinding() :
-    _handle(0), _attributes(NULL), _mesh(NULL), _effect(NULL)
+    _handle(0), _attributes(NULL), _mesh(NULL), _effect(NULL), _buffer(0), _bufferOffset(0), _indexBuffer(0)
 {
 }
 
 VertexAttributeBinding::~VertexAttributeBinding()
 {
     // Delete from the vertex attribute binding cache.
-    std::vector<VertexAttributeBinding*>::iterator itr = std::find(__vertexAttributeBindingCache.begin(), __vertexAttributeBindingCache.end(), this);
-    if (itr != __vertexAttributeBindingCache.end())
+    VertexAttributeBindingCache::iterator itr = __vertexAttributeBindingCache.find(std::make_pair(_mesh, _effect));
+    if (itr != __vertexAttributeBindingCache.end() && itr->second == this)
     {
         __vertexAttributeBindingCache.erase(itr);
     }
 
+    // Forget about our attribute pointers so that a new binding at the same address re-specifies them.
+    if (__currentSoftwareBinding == this)
+    {
+        __currentSoftwareBinding = NULL;
+    }
+
     SAFE_RELEASE(_mesh);
     SAFE_RELEASE(_effect);
     SAFE_DELETE_ARRAY(_attributes);
@@ -39,25 +85,22 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, Effect* effec
     GP_ASSERT(mesh);
 
     // Search for an existing vertex attribute binding that can be used.
-    VertexAttributeBinding* b;
-    for (size_t i = 0, count = __vertexAttributeBindingCache.size(); i < count; ++i)
+    std::pair<Mesh*, Effect*> key(mesh, effect);
+    VertexAttributeBindingCache::iterator itr = __vertexAttributeBindingCache.find(key);
+    if (itr != __vertexAttributeBindingCache.end())
     {
-        b = __vertexAttributeBindingCache[i];
-        GP_ASSERT(b);
-        if (b->_mesh == mesh && b->_effect == effect)
-        {
-            // Found a match!
-            b->addRef();
-            return b;
-        }
+        // Found a match!
+        GP_ASSERT(itr->second);
+        itr->second->addRef();
+        return itr->second;
     }
 
-    b = create(mesh, mesh->getVertexFormat(), 0, effect);
+    VertexAttributeBinding* b = create(mesh, mesh->getVertexFormat(), 0, effect);
 
     // Add the new vertex attribute binding to the cache.
     if (b)
     {
-        __vertexAttributeBindingCache.push_back(b);
+        __vertexAttributeBindingCache[key] = b;
     }
 
     return b;
@@ -84,6 +127,16 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
             GP_ERROR("The maximum number of vertex attributes supported by OpenGL on the current device is 0 or less.");
             return NULL;
         }
+        __enabledVertexAttribs.resize(__maxVertexAttribs, false);
+
+#ifndef OPENGL_ES
+        // Desktop OpenGL always draws meshes through vertex array objects.
+        if (!glGenVertexArrays)
+        {
+            GP_ERROR("Vertex array objects are not supported by OpenGL on the current device.");
+            return NULL;
+        }
+#endif
     }
 
     // Create a new VertexAttributeBinding.
@@ -110,9 +163,13 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
 
         // Bind the Mesh VBO so our glVertexAttribPointer calls use it.
         GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer()) );
+        b->_buffer = mesh->getVertexBuffer();
     }
-    else
 #endif
+
+    // Dynamic meshes can rotate through several vertex buffers, so their hardware bindings
+    // also keep the attribute pointers to specify them again for another buffer.
+    if (b->_handle == 0 || mesh->isDynamic())
     {
         // Construct a software representation of a VAO.
         VertexAttribute* attribs = new VertexAttribute[__maxVertexAttribs];
@@ -138,9 +195,10 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
     b->_effect = effect;
     effect->addRef();
 
-    // Call setVertexAttribPointer for each vertex element.
+    // Call setVertexAttribPointer for each vertex element. The vertices of a mesh start
+    // at its offset in a vertex buffer that it may share with other meshes.
     std::string name;
-    size_t offset = 0;
+    size_t offset = mesh ? mesh->getVertexOffset() : 0;
     for (size_t i = 0, count = vertexFormat.getElementCount(); i < count; ++i)
     {
         const VertexFormat::Element& e = vertexFormat.getElement(i);
@@ -198,10 +256,10 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
         else
         {
             void* pointer = vertexPointer ? (void*)(((unsigned char*)vertexPointer) + offset) : (void*)offset;
-            b->setVertexAttribPointer(attrib, (GLint)e.size, GL_FLOAT, GL_FALSE, (GLsizei)vertexFormat.getVertexSize(), pointer);
+            b->setVertexAttribPointer(attrib, (GLint)e.size, getGLType(e.type), e.normalized ? GL_TRUE : GL_FALSE, (GLsizei)vertexFormat.getVertexSize(), pointer);
         }
 
-        offset += e.size * sizeof(float);
+        offset += e.getByteSize();
     }
 
     if (b->_handle)
@@ -212,6 +270,21 @@ VertexAttributeBinding* VertexAttributeBinding::create(Mesh* mesh, const VertexF
     return b;
 }
 
+void VertexAttributeBinding::setVertexBuffer(GLuint buffer, size_t offset)
+{
+    GP_ASSERT(_handle == 0);
+
+    if (_buffer != buffer || _bufferOffset != offset)
+    {
+        _buffer = buffer;
+        _bufferOffset = offset;
+
+        // Specify the attribute pointers again the next time the binding is bound.
+        if (__currentSoftwareBinding == this)
+            __currentSoftwareBinding = NULL;
+    }
+}
+
 void VertexAttributeBinding::setVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalize, GLsizei stride, void* pointer)
 {
     GP_ASSERT(indx < (GLuint)__maxVertexAttribs);
@@ -222,10 +295,9 @@ void VertexAttributeBinding::setVertexAttribPointer(GLuint indx, GLint size, GLe
         GL_ASSERT( glVertexAttribPointer(indx, size, type, normalize, stride, pointer) );
         GL_ASSERT( glEnableVertexAttribArray(indx) );
     }
-    else
+    if (_attributes)
     {
-        // Software mode.
-        GP_ASSERT(_attributes);
+        // Software mode, or a hardware binding of a dynamic mesh.
         _attributes[indx].enabled = true;
         _attributes[indx].size = size;
         _attributes[indx].type = type;
@@ -241,32 +313,76 @@ void VertexAttributeBinding::bind()
     {
         // Hardware mode
         GL_ASSERT( glBindVertexArray(_handle) );
+        RenderStats::count(RenderStats::BUFFER_BINDS);
+
+        // Point the attributes of the vertex array object at the current buffer of a mesh
+        // that moved to another buffer of its ring since it was last bound.
+        if (_attributes && _mesh->getVertexBuffer() != _buffer)
+        {
+            _buffer = _mesh->getVertexBuffer();
+            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _buffer) );
+            for (unsigned int i = 0; i < __maxVertexAttribs; ++i)
+            {
+                const VertexAttribute& a = _attributes[i];
+                if (a.enabled)
+                    GL_ASSERT( glVertexAttribPointer(i, a.size, a.type, a.normalized, a.stride, a.pointer) );
+            }
+        }
     }
     else
     {
         // Software mode
-        if (_mesh)
-        {
-            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _mesh->getVertexBuffer()) );
-        }
-        else
+        // Attribute pointers only need to be specified again when a different binding was
+        // bound in between or the mesh moved to another buffer of its ring, and only attributes
+        // that differ need to be enabled or disabled.
+        GP_ASSERT(_attributes);
+        bool specifyPointers = __currentSoftwareBinding != this || (_mesh && _mesh->getVertexBuffer() != _buffer);
+        if (specifyPointers)
         {
-            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
+            if (_mesh)
+                _buffer = _mesh->getVertexBuffer();
+            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, _buffer) );
+            RenderStats::count(RenderStats::BUFFER_BINDS);
         }
-
-        GP_ASSERT(_attributes);
         for (unsigned int i = 0; i < __maxVertexAttribs; ++i)
         {
             VertexAttribute& a = _attributes[i];
             if (a.enabled)
             {
-                GL_ASSERT( glVertexAttribPointer(i, a.size, a.type, a.normalized, a.stride, a.pointer) );
-                GL_ASSERT( glEnableVertexAttribArray(i) );
+                if (specifyPointers)
+                {
+                    GL_ASSERT( glVertexAttribPointer(i, a.size, a.type, a.normalized, a.stride, (unsigned char*)a.pointer + _bufferOffset) );
+                }
+                if (!__enabledVertexAttribs[i])
+                {
+                    GL_ASSERT( glEnableVertexAttribArray(i) );
+                    __enabledVertexAttribs[i] = true;
+                }
+            }
+            else if (__enabledVertexAttribs[i])
+            {
+                GL_ASSERT( glDisableVertexAttribArray(i) );
+                __enabledVertexAttribs[i] = false;
             }
         }
+        __currentSoftwareBinding = this;
     }
 }
 
+void VertexAttributeBinding::bindIndexBuffer(GLuint buffer)
+{
+    // The index buffer is part of the state of a VAO, so parts that share an index buffer
+    // only bind it once.
+    if (_handle && _indexBuffer == buffer)
+        return;
+
+    GL_ASSERT( glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer) );
+    if (buffer)
+        RenderStats::count(RenderStats::BUFFER_BINDS);
+    if (_handle)
+        _indexBuffer = buffer;
+}
+
 void VertexAttributeBinding::unbind()
 {
     if (_handle)
@@ -276,20 +392,9 @@ void VertexAttributeBinding::unbind()
     }
     else
     {
-        // Software mode
-        if (_mesh)
-        {
-            GL_ASSERT( glBindBuffer(GL_ARRAY_BUFFER, 0) );
-        }
-
+        // Software mode: attribute arrays are left enabled, since the next binding
+        // only enables and disables the attributes that differ from ours.
         GP_ASSERT(_attributes);
-        for (unsigned int i = 0; i < __maxVertexAttribs; ++i)
-        {
-            if (_attributes[i].enabled)
-            {
-                GL_ASSERT( glDisableVertexAttribArray(i) );
-            }
-        }
     }
 }
 
@@ -31,6 +31,8 @@ class Effect;
  */
 class VertexAttributeBinding : public Ref
 {
+    friend class MeshBatch;
+
 public:
 
     /**
@@ -73,6 +75,14 @@ public:
      */
     void bind();
 
+    /**
+     * Binds an index buffer to draw with while this vertex array object is bound.
+     *
+     * @param buffer The index buffer, or 0 to draw without indices.
+     * @script{ignore}
+     */
+    void bindIndexBuffer(GLuint buffer);
+
     /**
      * Unbinds this vertex array object.
      */
@@ -110,10 +120,20 @@ private:
 
     void setVertexAttribPointer(GLuint indx, GLint size, GLenum type, GLboolean normalize, GLsizei stride, void* pointer);
 
+    /**
+     * Sets the vertex buffer that the attribute pointers of a client-side binding created
+     * without a vertex pointer are offsets into, and the offset of its first vertex in it.
+     * Mesh batches stream their vertices into buffers at an offset that changes with every draw.
+     */
+    void setVertexBuffer(GLuint buffer, size_t offset);
+
     GLuint _handle;
     VertexAttribute* _attributes;
     Mesh* _mesh;
     Effect* _effect;
+    GLuint _buffer;
+    size_t _bufferOffset;
+    GLuint _indexBuffer;
 };
 
 }
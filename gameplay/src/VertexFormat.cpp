@@ -4,6 +4,93 @@
 namespace gameplay
 {
 
+/**
+ * Converts a float to a half float, rounding to the nearest value and keeping infinities and NaNs.
+ */
+static unsigned short floatToHalf(float value)
+{
+    unsigned int f;
+    memcpy(&f, &value, sizeof(float));
+    unsigned int sign = (f >> 16) & 0x8000;
+    int exponent = (int)((f >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = f & 0x7fffff;
+
+    if (((f >> 23) & 0xff) == 0xff)
+        return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31)
+        return (unsigned short)(sign | 0x7c00);
+    if (exponent <= 0)
+    {
+        // Denormals, or zero if the value is too small.
+        if (exponent < -10)
+            return (unsigned short)sign;
+        mantissa |= 0x800000;
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+            half++;
+        return (unsigned short)(sign | half);
+    }
+
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000)
+        half++;
+    return (unsigned short)half;
+}
+
+/**
+ * Converts a half float to a float.
+ */
+static float halfToFloat(unsigned short value)
+{
+    unsigned int sign = (unsigned int)(value & 0x8000) << 16;
+    unsigned int exponent = (value >> 10) & 0x1f;
+    unsigned int mantissa = value & 0x3ff;
+    unsigned int f;
+
+    if (exponent == 0x1f)
+    {
+        f = sign | 0x7f800000 | (mantissa << 13);
+    }
+    else if (exponent == 0)
+    {
+        // Zero or denormals, which are normalized.
+        if (mantissa == 0)
+        {
+            f = sign;
+        }
+        else
+        {
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400))
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+            f = sign | (exponent << 23) | ((mantissa & 0x3ff) << 13);
+        }
+    }
+    else
+    {
+        f = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    memcpy(&result, &f, sizeof(float));
+    return result;
+}
+
+/**
+ * Converts a float to an integer of the given range, which is normalized to [-1, 1] or [0, 1]
+ * when scale is the maximum of the range and is taken as it is when scale is 1.
+ */
+static int floatToInteger(float value, float scale, int min, int max)
+{
+    float v = value * scale;
+    int i = (int)(v < 0.0f ? v - 0.5f : v + 0.5f);
+    return i < min ? min : (i > max ? max : i);
+}
+
 VertexFormat::VertexFormat(const Element* elements, unsigned int elementCount)
     : _vertexSize(0)
 {
@@ -17,7 +104,8 @@ VertexFormat::VertexFormat(const Element* elements, unsigned int elementCount)
         memcpy(&element, &elements[i], sizeof(Element));
         _elements.push_back(element);
 
-        _vertexSize += element.size * sizeof(float);
+        GP_ASSERT(element.type != INT_2_10_10_10_REV || element.size == 4);
+        _vertexSize += element.getByteSize();
     }
 }
 
@@ -41,6 +129,16 @@ unsigned int VertexFormat::getVertexSize() const
     return _vertexSize;
 }
 
+unsigned int VertexFormat::getElementOffset(unsigned int index) const
+{
+    GP_ASSERT(index < _elements.size());
+
+    unsigned int offset = 0;
+    for (unsigned int i = 0; i < index; ++i)
+        offset += _elements[i].getByteSize();
+    return offset;
+}
+
 bool VertexFormat::operator == (const VertexFormat& f) const
 {
     if (_elements.size() != f._elements.size())
@@ -62,18 +160,161 @@ bool VertexFormat::operator != (const VertexFormat& f) const
 }
 
 VertexFormat::Element::Element() :
-    usage(POSITION), size(0)
+    usage(POSITION), size(0), type(FLOAT), normalized(false)
 {
 }
 
 VertexFormat::Element::Element(Usage usage, unsigned int size) :
-    usage(usage), size(size)
+    usage(usage), size(size), type(FLOAT), normalized(false)
+{
+}
+
+VertexFormat::Element::Element(Usage usage, unsigned int size, Type type, bool normalized) :
+    usage(usage), size(size), type(type), normalized(normalized)
+{
+}
+
+unsigned int VertexFormat::Element::getByteSize() const
+{
+    switch (type)
+    {
+    case HALF_FLOAT:
+    case SHORT:
+    case UNSIGNED_SHORT:
+        return size * 2;
+    case BYTE:
+    case UNSIGNED_BYTE:
+        return size;
+    case INT_2_10_10_10_REV:
+        return 4;
+    default:
+        return size * sizeof(float);
+    }
+}
+
+void VertexFormat::Element::read(const void* data, float* dst) const
+{
+    GP_ASSERT(data);
+    GP_ASSERT(dst);
+
+    switch (type)
+    {
+    case HALF_FLOAT:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            unsigned short h;
+            memcpy(&h, (const unsigned char*)data + i * 2, 2);
+            dst[i] = halfToFloat(h);
+        }
+        break;
+    case BYTE:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            float v = (float)((const signed char*)data)[i];
+            dst[i] = normalized ? std::max(v / 127.0f, -1.0f) : v;
+        }
+        break;
+    case UNSIGNED_BYTE:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            float v = (float)((const unsigned char*)data)[i];
+            dst[i] = normalized ? v / 255.0f : v;
+        }
+        break;
+    case SHORT:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            short s;
+            memcpy(&s, (const unsigned char*)data + i * 2, 2);
+            dst[i] = normalized ? std::max((float)s / 32767.0f, -1.0f) : (float)s;
+        }
+        break;
+    case UNSIGNED_SHORT:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            unsigned short s;
+            memcpy(&s, (const unsigned char*)data + i * 2, 2);
+            dst[i] = normalized ? (float)s / 65535.0f : (float)s;
+        }
+        break;
+    case INT_2_10_10_10_REV:
+        {
+            unsigned int packed;
+            memcpy(&packed, data, 4);
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                // Sign extend each field from its width.
+                unsigned int bits = i < 3 ? 10 : 2;
+                int v = (int)((packed >> (i * 10)) << (32 - bits)) >> (32 - bits);
+                float max = (float)((1 << (bits - 1)) - 1);
+                dst[i] = normalized ? std::max((float)v / max, -1.0f) : (float)v;
+            }
+        }
+        break;
+    default:
+        memcpy(dst, data, size * sizeof(float));
+        break;
+    }
+}
+
+void VertexFormat::Element::write(const float* values, void* data) const
 {
+    GP_ASSERT(values);
+    GP_ASSERT(data);
+
+    switch (type)
+    {
+    case HALF_FLOAT:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            unsigned short h = floatToHalf(values[i]);
+            memcpy((unsigned char*)data + i * 2, &h, 2);
+        }
+        break;
+    case BYTE:
+        for (unsigned int i = 0; i < size; ++i)
+            ((signed char*)data)[i] = (signed char)floatToInteger(values[i], normalized ? 127.0f : 1.0f, -128, 127);
+        break;
+    case UNSIGNED_BYTE:
+        for (unsigned int i = 0; i < size; ++i)
+            ((unsigned char*)data)[i] = (unsigned char)floatToInteger(values[i], normalized ? 255.0f : 1.0f, 0, 255);
+        break;
+    case SHORT:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            short s = (short)floatToInteger(values[i], normalized ? 32767.0f : 1.0f, -32768, 32767);
+            memcpy((unsigned char*)data + i * 2, &s, 2);
+        }
+        break;
+    case UNSIGNED_SHORT:
+        for (unsigned int i = 0; i < size; ++i)
+        {
+            unsigned short s = (unsigned short)floatToInteger(values[i], normalized ? 65535.0f : 1.0f, 0, 65535);
+            memcpy((unsigned char*)data + i * 2, &s, 2);
+        }
+        break;
+    case INT_2_10_10_10_REV:
+        {
+            unsigned int packed = 0;
+            for (unsigned int i = 0; i < 4; ++i)
+            {
+                unsigned int bits = i < 3 ? 10 : 2;
+                int max = (1 << (bits - 1)) - 1;
+                int v = floatToInteger(values[i], normalized ? (float)max : 1.0f, -max - 1, max);
+                packed |= ((unsigned int)v & ((1u << bits) - 1)) << (i * 10);
+            }
+            memcpy(data, &packed, 4);
+        }
+        break;
+    default:
+        memcpy(data, values, size * sizeof(float));
+        break;
+    }
 }
 
 bool VertexFormat::Element::operator == (const VertexFormat::Element& e) const
 {
-    return (size == e.size && usage == e.usage);
+    return (size == e.size && usage == e.usage && type == e.type && normalized == e.normalized);
 }
 
 bool VertexFormat::Element::operator != (const VertexFormat::Element& e) const
@@ -120,4 +361,27 @@ const char* VertexFormat::toString(Usage usage)
     }
 }
 
+const char* VertexFormat::toString(Type type)
+{
+    switch (type)
+    {
+    case FLOAT:
+        return "FLOAT";
+    case HALF_FLOAT:
+        return "HALF_FLOAT";
+    case BYTE:
+        return "BYTE";
+    case UNSIGNED_BYTE:
+        return "UNSIGNED_BYTE";
+    case SHORT:
+        return "SHORT";
+    case UNSIGNED_SHORT:
+        return "UNSIGNED_SHORT";
+    case INT_2_10_10_10_REV:
+        return "INT_2_10_10_10_REV";
+    default:
+        return "UNKNOWN";
+    }
+}
+
 }
@@ -35,13 +35,40 @@ public:
         TEXCOORD7 = 15
     };
 
+    /**
+     * Defines the data types of the components of vertex elements.
+     *
+     * Integer components are either converted to floats as they are, or normalized to
+     * [0, 1] (unsigned types) or [-1, 1] (signed types) when the element is normalized.
+     * HALF_FLOAT requires OpenGL 3.0, OpenGL ES 3.0 or the OES_vertex_half_float extension,
+     * and INT_2_10_10_10_REV requires OpenGL 3.3 or OpenGL ES 3.0.
+     */
+    enum Type
+    {
+        /** 32-bit floats. */
+        FLOAT = 0,
+        /** 16-bit floats. */
+        HALF_FLOAT = 1,
+        /** 8-bit signed integers. */
+        BYTE = 2,
+        /** 8-bit unsigned integers. */
+        UNSIGNED_BYTE = 3,
+        /** 16-bit signed integers. */
+        SHORT = 4,
+        /** 16-bit unsigned integers. */
+        UNSIGNED_SHORT = 5,
+        /** Four signed integers packed into 32 bits, with 10 bits for x, y and z and 2 bits for w. */
+        INT_2_10_10_10_REV = 6
+    };
+
     /**
      * Defines a single element within a vertex format.
      *
-     * All vertex elements are assumed to be of type float, but can
-     * have a varying number of float values (1-4), which is represented
-     * by the size attribute. Additionally, vertex elements are assumed
-     * to be tightly packed.
+     * Vertex elements have a varying number of values (1-4), which is represented
+     * by the size attribute, of the data type represented by the type attribute,
+     * which is FLOAT unless specified otherwise. Additionally, vertex elements are
+     * assumed to be tightly packed, so elements of 1 and 2 byte types should have
+     * sizes that keep the elements after them aligned to 4 bytes.
      */
     class Element
     {
@@ -56,6 +83,16 @@ public:
          */
         unsigned int size;
 
+        /**
+         * The data type of the values in the vertex element.
+         */
+        Type type;
+
+        /**
+         * Whether the integer values of the vertex element are normalized.
+         */
+        bool normalized;
+
         /**
          * Constructor.
          */
@@ -69,6 +106,43 @@ public:
          */
         Element(Usage usage, unsigned int size);
 
+        /**
+         * Constructor.
+         *
+         * @param usage The vertex element usage semantic.
+         * @param size The number of values in the vertex element, which must be 4 for INT_2_10_10_10_REV.
+         * @param type The data type of the values.
+         * @param normalized Whether integer values are normalized.
+         */
+        Element(Usage usage, unsigned int size, Type type, bool normalized);
+
+        /**
+         * Gets the size (in bytes) of the vertex element.
+         *
+         * @return The size of the values of the vertex element.
+         */
+        unsigned int getByteSize() const;
+
+        /**
+         * Reads the values of the vertex element from vertex data and converts them to floats.
+         *
+         * @param data The values of the vertex element.
+         * @param dst The array to store the size converted values in.
+         * @script{ignore}
+         */
+        void read(const void* data, float* dst) const;
+
+        /**
+         * Converts floats to the values of the vertex element and writes them to vertex data.
+         *
+         * Normalized values are clamped to the range of the type and integer values are rounded.
+         *
+         * @param values The size values to convert.
+         * @param data The vertex data to write the values of the vertex element to.
+         * @script{ignore}
+         */
+        void write(const float* values, void* data) const;
+
         /**
          * Compares two vertex elements for equality.
          *
@@ -122,6 +196,15 @@ public:
      */
     unsigned int getVertexSize() const;
 
+    /**
+     * Gets the offset (in bytes) of the vertex element at the specified index within a vertex.
+     *
+     * @param index The index of the element.
+     *
+     * @return The sum of the sizes of the elements before the element.
+     */
+    unsigned int getElementOffset(unsigned int index) const;
+
     /**
      * Compares two vertex formats for equality.
      *
@@ -145,6 +228,12 @@ public:
      */
     static const char* toString(Usage usage);
 
+    /**
+     * Returns a string representation of a Type enumeration value.
+     * @script{ignore}
+     */
+    static const char* toString(Type type);
+
 private:
 
     std::vector<Element> _elements;
@@ -0,0 +1,108 @@
+#include "Base.h"
+#include "World.h"
+#include "Game.h"
+
+namespace gameplay
+{
+
+static thread_local World* __currentWorld = NULL;
+
+World::World()
+    : _animationController(NULL), _physicsController(NULL), _aiController(NULL)
+{
+}
+
+World::~World()
+{
+    // Whatever is still registered with the controllers unregisters from this world.
+    World* previous = setCurrent(this);
+
+    _aiController->finalize();
+    SAFE_DELETE(_aiController);
+    _physicsController->finalize();
+    SAFE_DELETE(_physicsController);
+    _animationController->finalize();
+    SAFE_DELETE(_animationController);
+
+    setCurrent(previous);
+}
+
+World* World::create()
+{
+    World* world = new World();
+    World* previous = setCurrent(world);
+
+    world->_animationController = new AnimationController();
+    world->_animationController->initialize();
+
+    world->_physicsController = new PhysicsController();
+    world->_physicsController->initialize();
+
+    world->_aiController = new AIController();
+    world->_aiController->initialize();
+
+    Properties* config = Game::getInstance()->getConfig();
+    if (config && config->exists("aiUpdateBudget"))
+        world->_aiController->setUpdateBudget(config->getFloat("aiUpdateBudget"));
+    if (config && config->exists("aiLodDistance"))
+        world->_aiController->setLodDistance(config->getFloat("aiLodDistance"));
+
+    setCurrent(previous);
+    return world;
+}
+
+World* World::getCurrent()
+{
+    return __currentWorld;
+}
+
+World* World::setCurrent(World* world)
+{
+    World* previous = __currentWorld;
+    __currentWorld = world;
+    return previous;
+}
+
+void World::update(World** worlds, unsigned int count, float elapsedTime)
+{
+    GP_ASSERT(worlds || count == 0);
+
+    Game::getInstance()->getJobController()->parallelFor(count, [worlds, elapsedTime](unsigned int begin, unsigned int end, unsigned int worker)
+    {
+        for (unsigned int i = begin; i < end; ++i)
+        {
+            GP_ASSERT(worlds[i]);
+            worlds[i]->update(elapsedTime);
+        }
+    }, 1);
+}
+
+AnimationController* World::getAnimationController() const
+{
+    return _animationController;
+}
+
+PhysicsController* World::getPhysicsController() const
+{
+    return _physicsController;
+}
+
+AIController* World::getAIController() const
+{
+    return _aiController;
+}
+
+void World::update(float elapsedTime)
+{
+    GP_PROFILE("World::update");
+
+    World* previous = setCurrent(this);
+
+    _animationController->update(elapsedTime);
+    _physicsController->update(elapsedTime);
+    _aiController->update(elapsedTime);
+
+    setCurrent(previous);
+}
+
+}
@@ -0,0 +1,131 @@
+#ifndef WORLD_H_
+#define WORLD_H_
+
+#include "Ref.h"
+
+namespace gameplay
+{
+
+class AnimationController;
+class PhysicsController;
+class AIController;
+
+/**
+ * Defines a simulation world with animation, physics and AI controllers of its own.
+ *
+ * The game owns a world of controllers that everything uses by default. Additional worlds
+ * simulate independently of it and of each other, such as the matches hosted by a server or
+ * the next level of a game that is loaded and warmed up in the background.
+ *
+ * A world can be made current on a thread, and while it is, the controllers returned by
+ * Game::getAnimationController, Game::getPhysicsController and Game::getAIController are
+ * those of the world. Everything that registers with these controllers, such as scenes that
+ * are loaded, nodes that are given collision objects, agents and animation clips that are
+ * played, registers with the world that is current on the thread where it happens. Objects
+ * must therefore be created, changed and destroyed with their world current.
+ *
+ * Each world is only used by one thread at a time, but different worlds can be updated on
+ * different threads at once. The jobs that a world runs on the job controller while it is
+ * updated, such as parallel physics queries and agent updates, run with the world current.
+ * Scripts, rendering, audio and forms are not part of a world and stay on the main thread.
+ *
+ * @script{ignore}
+ */
+class World : public Ref
+{
+public:
+
+    /**
+     * Creates a world with initialized controllers.
+     *
+     * The controllers are configured from the game configuration like those of the game.
+     *
+     * @return The new world.
+     */
+    static World* create();
+
+    /**
+     * Returns the world that is current on the calling thread.
+     *
+     * @return The current world, or NULL when the controllers of the game are used.
+     */
+    static World* getCurrent();
+
+    /**
+     * Makes a world current on the calling thread.
+     *
+     * @param world The world to make current, or NULL to use the controllers of the game.
+     *
+     * @return The world that was current before, which should be made current again.
+     */
+    static World* setCurrent(World* world);
+
+    /**
+     * Updates several worlds in parallel on the workers of the job controller and returns
+     * once all of them have been updated.
+     *
+     * @param worlds The worlds to update.
+     * @param count The number of worlds.
+     * @param elapsedTime The time since the last update of the worlds, in milliseconds.
+     */
+    static void update(World** worlds, unsigned int count, float elapsedTime);
+
+    /**
+     * Returns the animation controller of the world.
+     *
+     * @return The animation controller.
+     */
+    AnimationController* getAnimationController() const;
+
+    /**
+     * Returns the physics controller of the world.
+     *
+     * @return The physics controller.
+     */
+    PhysicsController* getPhysicsController() const;
+
+    /**
+     * Returns the AI controller of the world.
+     *
+     * @return The AI controller.
+     */
+    AIController* getAIController() const;
+
+    /**
+     * Updates the animations, physics and AI of the world in the same order as the game
+     * updates its own, with the world current for the duration of the update.
+     *
+     * @param elapsedTime The time since the last update of the world, in milliseconds.
+     */
+    void update(float elapsedTime);
+
+private:
+
+    /**
+     * Constructor.
+     */
+    World();
+
+    /**
+     * Destructor.
+     */
+    ~World();
+
+    /**
+     * Hidden copy constructor.
+     */
+    World(const World& copy);
+
+    /**
+     * Hidden copy assignment operator.
+     */
+    World& operator=(const World&);
+
+    AnimationController* _animationController;
+    PhysicsController* _physicsController;
+    AIController* _aiController;
+};
+
+}
+
+#endif
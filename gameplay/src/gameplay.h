@@ -11,6 +11,15 @@
 #include "Bundle.h"
 #include "MathUtil.h"
 #include "Logger.h"
+#include "Profiler.h"
+#include "JobController.h"
+#include "IOQueue.h"
+#include "AssetLoader.h"
+#include "FrameAllocator.h"
+#include "ObjectPool.h"
+#include "StringPool.h"
+#include "TimerWheel.h"
+#include "World.h"
 
 // Math
 #include "Rectangle.h"
@@ -23,31 +32,57 @@
 #include "Ray.h"
 #include "Plane.h"
 #include "Frustum.h"
+#include "OcclusionBuffer.h"
+#include "OcclusionCuller.h"
 #include "BoundingSphere.h"
 #include "BoundingBox.h"
 #include "Curve.h"
 
 // Graphics
 #include "Image.h"
+#include "Impostor.h"
 #include "Texture.h"
+#include "TextureAtlas.h"
+#include "TextureStreamer.h"
 #include "Mesh.h"
 #include "MeshPart.h"
+#include "MeshBuffer.h"
+#include "MeshBVH.h"
 #include "Effect.h"
 #include "Material.h"
 #include "RenderState.h"
+#include "RenderStats.h"
+#include "MemoryTracker.h"
+#include "InputQueue.h"
+#include "InputRecorder.h"
+#include "ResourceManager.h"
 #include "VertexFormat.h"
 #include "VertexAttributeBinding.h"
 #include "Drawable.h"
 #include "Model.h"
+#include "SharedSkeleton.h"
 #include "Camera.h"
 #include "Light.h"
+#include "LightClusters.h"
+#include "ShadowMaps.h"
+#include "PlanarReflection.h"
+#include "PostProcess.h"
+#include "Prefab.h"
+#include "DynamicResolution.h"
 #include "Node.h"
+#include "NodeIndex.h"
 #include "Joint.h"
 #include "Scene.h"
+#include "SceneSnapshot.h"
+#include "TransformHierarchy.h"
+#include "SpatialIndex.h"
+#include "RenderQueue.h"
+#include "CommandBuffer.h"
 #include "Font.h"
 #include "SpriteBatch.h"
 #include "Sprite.h"
 #include "Text.h"
+#include "TextLayout.h"
 #include "TileSet.h"
 #include "ParticleEmitter.h"
 #include "FrameBuffer.h"
@@ -56,6 +91,7 @@
 #include "ScreenDisplayer.h"
 #include "HeightField.h"
 #include "Terrain.h"
+#include "TiledTerrain.h"
 #include "TerrainPatch.h"
 
 // Audio
@@ -92,12 +128,14 @@
 #include "AIAgent.h"
 #include "AIState.h"
 #include "AIStateMachine.h"
+#include "NavigationMesh.h"
 
 // UI
 #include "Theme.h"
 #include "Control.h"
 #include "ControlFactory.h"
 #include "Container.h"
+#include "ListView.h"
 #include "Form.h"
 #include "Label.h"
 #include "Button.h"
@@ -126,6 +126,41 @@ static int lua_AIAgent_getId(lua_State* state)
     return 0;
 }
 
+static int lua_AIAgent_getImportance(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AIAgent* instance = getInstance(state);
+                float result = instance->getImportance();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AIAgent_getImportance - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AIAgent_getNode(lua_State* state)
 {
     // Get the number of parameters.
@@ -284,6 +319,41 @@ static int lua_AIAgent_isEnabled(lua_State* state)
     return 0;
 }
 
+static int lua_AIAgent_isParallel(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AIAgent* instance = getInstance(state);
+                bool result = instance->isParallel();
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AIAgent_isParallel - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AIAgent_release(lua_State* state)
 {
     // Get the number of parameters.
@@ -352,6 +422,42 @@ static int lua_AIAgent_setEnabled(lua_State* state)
     return 0;
 }
 
+static int lua_AIAgent_setImportance(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AIAgent* instance = getInstance(state);
+                instance->setImportance(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AIAgent_setImportance - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AIAgent_setListener(lua_State* state)
 {
     // Get the number of parameters.
@@ -445,6 +551,42 @@ static void* __convertTo(void* ptr, const char* typeName)
     return NULL;
 }
 
+static int lua_AIAgent_setParallel(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TBOOLEAN)
+            {
+                // Get parameter 1 off the stack.
+                bool param1 = gameplay::ScriptUtil::luaCheckBool(state, 2);
+
+                AIAgent* instance = getInstance(state);
+                instance->setParallel(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AIAgent_setParallel - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AIAgent_to(lua_State* state)
 {
     // There should be only a single parameter (this instance)
@@ -481,13 +623,17 @@ void luaRegister_AIAgent()
     {
         {"addRef", lua_AIAgent_addRef},
         {"getId", lua_AIAgent_getId},
+        {"getImportance", lua_AIAgent_getImportance},
         {"getNode", lua_AIAgent_getNode},
         {"getRefCount", lua_AIAgent_getRefCount},
         {"getStateMachine", lua_AIAgent_getStateMachine},
         {"isEnabled", lua_AIAgent_isEnabled},
+        {"isParallel", lua_AIAgent_isParallel},
         {"release", lua_AIAgent_release},
         {"setEnabled", lua_AIAgent_setEnabled},
+        {"setImportance", lua_AIAgent_setImportance},
         {"setListener", lua_AIAgent_setListener},
+        {"setParallel", lua_AIAgent_setParallel},
         {"to", lua_AIAgent_to},
         {NULL, NULL}
     };
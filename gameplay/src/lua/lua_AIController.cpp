@@ -64,6 +64,111 @@ static int lua_AIController_findAgent(lua_State* state)
     return 0;
 }
 
+static int lua_AIController_getLodDistance(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AIController* instance = getInstance(state);
+                float result = instance->getLodDistance();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AIController_getLodDistance - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AIController_getMaxUpdateInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AIController* instance = getInstance(state);
+                unsigned int result = instance->getMaxUpdateInterval();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AIController_getMaxUpdateInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AIController_getUpdateBudget(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AIController* instance = getInstance(state);
+                float result = instance->getUpdateBudget();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AIController_getUpdateBudget - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AIController_sendMessage(lua_State* state)
 {
     // Get the number of parameters.
@@ -134,12 +239,126 @@ static int lua_AIController_sendMessage(lua_State* state)
     return 0;
 }
 
+static int lua_AIController_setLodDistance(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AIController* instance = getInstance(state);
+                instance->setLodDistance(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AIController_setLodDistance - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AIController_setMaxUpdateInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                AIController* instance = getInstance(state);
+                instance->setMaxUpdateInterval(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AIController_setMaxUpdateInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AIController_setUpdateBudget(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AIController* instance = getInstance(state);
+                instance->setUpdateBudget(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AIController_setUpdateBudget - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 void luaRegister_AIController()
 {
     const luaL_Reg lua_members[] = 
     {
         {"findAgent", lua_AIController_findAgent},
+        {"getLodDistance", lua_AIController_getLodDistance},
+        {"getMaxUpdateInterval", lua_AIController_getMaxUpdateInterval},
+        {"getUpdateBudget", lua_AIController_getUpdateBudget},
         {"sendMessage", lua_AIController_sendMessage},
+        {"setLodDistance", lua_AIController_setLodDistance},
+        {"setMaxUpdateInterval", lua_AIController_setMaxUpdateInterval},
+        {"setUpdateBudget", lua_AIController_setUpdateBudget},
         {NULL, NULL}
     };
     const luaL_Reg* lua_statics = NULL;
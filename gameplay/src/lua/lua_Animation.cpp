@@ -95,6 +95,42 @@ static int lua_Animation_addRef(lua_State* state)
     return 0;
 }
 
+static int lua_Animation_bake(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                Animation* instance = getInstance(state);
+                instance->bake(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Animation_bake - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Animation_createClip(lua_State* state)
 {
     // Get the number of parameters.
@@ -710,6 +746,7 @@ void luaRegister_Animation()
     const luaL_Reg lua_members[] = 
     {
         {"addRef", lua_Animation_addRef},
+        {"bake", lua_Animation_bake},
         {"createClip", lua_Animation_createClip},
         {"createClips", lua_Animation_createClips},
         {"getClip", lua_Animation_getClip},
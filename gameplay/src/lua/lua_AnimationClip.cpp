@@ -398,6 +398,42 @@ static int lua_AnimationClip_crossFade(lua_State* state)
     return 0;
 }
 
+static int lua_AnimationClip_evaluate(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AnimationClip* instance = getInstance(state);
+                instance->evaluate(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AnimationClip_evaluate - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AnimationClip_getActiveDuration(lua_State* state)
 {
     // Get the number of parameters.
@@ -1608,6 +1644,7 @@ void luaRegister_AnimationClip()
         {"addScriptCallback", lua_AnimationClip_addScriptCallback},
         {"clearScripts", lua_AnimationClip_clearScripts},
         {"crossFade", lua_AnimationClip_crossFade},
+        {"evaluate", lua_AnimationClip_evaluate},
         {"getActiveDuration", lua_AnimationClip_getActiveDuration},
         {"getAnimation", lua_AnimationClip_getAnimation},
         {"getBlendWeight", lua_AnimationClip_getBlendWeight},
@@ -17,6 +17,219 @@ static AnimationController* getInstance(lua_State* state)
     return (AnimationController*)((gameplay::ScriptUtil::LuaObject*)userdata)->instance;
 }
 
+static int lua_AnimationController_getLodScreenSize(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AnimationController* instance = getInstance(state);
+                float result = instance->getLodScreenSize();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AnimationController_getLodScreenSize - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AnimationController_getLodUpdateInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AnimationController* instance = getInstance(state);
+                float result = instance->getLodUpdateInterval();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AnimationController_getLodUpdateInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AnimationController_getOffscreenUpdateInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AnimationController* instance = getInstance(state);
+                float result = instance->getOffscreenUpdateInterval();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AnimationController_getOffscreenUpdateInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AnimationController_setLodScreenSize(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AnimationController* instance = getInstance(state);
+                instance->setLodScreenSize(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AnimationController_setLodScreenSize - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AnimationController_setLodUpdateInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AnimationController* instance = getInstance(state);
+                instance->setLodUpdateInterval(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AnimationController_setLodUpdateInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_AnimationController_setOffscreenUpdateInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AnimationController* instance = getInstance(state);
+                instance->setOffscreenUpdateInterval(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AnimationController_setOffscreenUpdateInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AnimationController_stopAllAnimations(lua_State* state)
 {
     // Get the number of parameters.
@@ -53,6 +266,12 @@ void luaRegister_AnimationController()
 {
     const luaL_Reg lua_members[] = 
     {
+        {"getLodScreenSize", lua_AnimationController_getLodScreenSize},
+        {"getLodUpdateInterval", lua_AnimationController_getLodUpdateInterval},
+        {"getOffscreenUpdateInterval", lua_AnimationController_getOffscreenUpdateInterval},
+        {"setLodScreenSize", lua_AnimationController_setLodScreenSize},
+        {"setLodUpdateInterval", lua_AnimationController_setLodUpdateInterval},
+        {"setOffscreenUpdateInterval", lua_AnimationController_setOffscreenUpdateInterval},
         {"stopAllAnimations", lua_AnimationController_stopAllAnimations},
         {NULL, NULL}
     };
@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_ASSETLOADER_H_
+#define LUA_ASSETLOADER_H_
+
+namespace gameplay
+{
+
+void luaRegister_AssetLoader();
+
+}
+
+#endif
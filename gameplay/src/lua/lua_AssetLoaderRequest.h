@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_ASSETLOADERREQUEST_H_
+#define LUA_ASSETLOADERREQUEST_H_
+
+namespace gameplay
+{
+
+void luaRegister_AssetLoaderRequest();
+
+}
+
+#endif
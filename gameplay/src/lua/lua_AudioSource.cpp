@@ -135,6 +135,41 @@ static int lua_AudioSource_getGain(lua_State* state)
     return 0;
 }
 
+static int lua_AudioSource_getMaxDistance(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AudioSource* instance = getInstance(state);
+                float result = instance->getMaxDistance();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AudioSource_getMaxDistance - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AudioSource_getNode(lua_State* state)
 {
     // Get the number of parameters.
@@ -214,6 +249,41 @@ static int lua_AudioSource_getPitch(lua_State* state)
     return 0;
 }
 
+static int lua_AudioSource_getPriority(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AudioSource* instance = getInstance(state);
+                int result = instance->getPriority();
+
+                // Push the return value onto the stack.
+                lua_pushinteger(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AudioSource_getPriority - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AudioSource_getRefCount(lua_State* state)
 {
     // Get the number of parameters.
@@ -398,6 +468,41 @@ static int lua_AudioSource_isStreamed(lua_State* state)
     return 0;
 }
 
+static int lua_AudioSource_isVirtual(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                AudioSource* instance = getInstance(state);
+                bool result = instance->isVirtual();
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_AudioSource_isVirtual - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AudioSource_pause(lua_State* state)
 {
     // Get the number of parameters.
@@ -630,6 +735,42 @@ static int lua_AudioSource_setLooped(lua_State* state)
     return 0;
 }
 
+static int lua_AudioSource_setMaxDistance(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                AudioSource* instance = getInstance(state);
+                instance->setMaxDistance(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AudioSource_setMaxDistance - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AudioSource_setPitch(lua_State* state)
 {
     // Get the number of parameters.
@@ -666,6 +807,42 @@ static int lua_AudioSource_setPitch(lua_State* state)
     return 0;
 }
 
+static int lua_AudioSource_setPriority(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                int param1 = (int)luaL_checkint(state, 2);
+
+                AudioSource* instance = getInstance(state);
+                instance->setPriority(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_AudioSource_setPriority - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_AudioSource_setVelocity(lua_State* state)
 {
     // Get the number of parameters.
@@ -935,13 +1112,16 @@ void luaRegister_AudioSource()
     {
         {"addRef", lua_AudioSource_addRef},
         {"getGain", lua_AudioSource_getGain},
+        {"getMaxDistance", lua_AudioSource_getMaxDistance},
         {"getNode", lua_AudioSource_getNode},
         {"getPitch", lua_AudioSource_getPitch},
+        {"getPriority", lua_AudioSource_getPriority},
         {"getRefCount", lua_AudioSource_getRefCount},
         {"getState", lua_AudioSource_getState},
         {"getVelocity", lua_AudioSource_getVelocity},
         {"isLooped", lua_AudioSource_isLooped},
         {"isStreamed", lua_AudioSource_isStreamed},
+        {"isVirtual", lua_AudioSource_isVirtual},
         {"pause", lua_AudioSource_pause},
         {"play", lua_AudioSource_play},
         {"release", lua_AudioSource_release},
@@ -949,7 +1129,9 @@ void luaRegister_AudioSource()
         {"rewind", lua_AudioSource_rewind},
         {"setGain", lua_AudioSource_setGain},
         {"setLooped", lua_AudioSource_setLooped},
+        {"setMaxDistance", lua_AudioSource_setMaxDistance},
         {"setPitch", lua_AudioSource_setPitch},
+        {"setPriority", lua_AudioSource_setPriority},
         {"setVelocity", lua_AudioSource_setVelocity},
         {"stop", lua_AudioSource_stop},
         {"to", lua_AudioSource_to},
@@ -2227,6 +2227,41 @@ static int lua_Container_getRefCount(lua_State* state)
     return 0;
 }
 
+static int lua_Container_getRefreshInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Container* instance = getInstance(state);
+                float result = instance->getRefreshInterval();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Container_getRefreshInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Container_getScriptEvent(lua_State* state)
 {
     // Get the number of parameters.
@@ -3279,6 +3314,41 @@ static int lua_Container_insertControl(lua_State* state)
     return 0;
 }
 
+static int lua_Container_isCached(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Container* instance = getInstance(state);
+                bool result = instance->isCached();
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Container_isCached - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Container_isChild(lua_State* state)
 {
     // Get the number of parameters.
@@ -4330,6 +4400,42 @@ static int lua_Container_setBounds(lua_State* state)
     return 0;
 }
 
+static int lua_Container_setCached(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TBOOLEAN)
+            {
+                // Get parameter 1 off the stack.
+                bool param1 = gameplay::ScriptUtil::luaCheckBool(state, 2);
+
+                Container* instance = getInstance(state);
+                instance->setCached(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Container_setCached - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Container_setCanFocus(lua_State* state)
 {
     // Get the number of parameters.
@@ -5209,6 +5315,42 @@ static int lua_Container_setPosition(lua_State* state)
     return 0;
 }
 
+static int lua_Container_setRefreshInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                Container* instance = getInstance(state);
+                instance->setRefreshInterval(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Container_setRefreshInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Container_setScroll(lua_State* state)
 {
     // Get the number of parameters.
@@ -6473,6 +6615,7 @@ void luaRegister_Container()
         {"getPadding", lua_Container_getPadding},
         {"getParent", lua_Container_getParent},
         {"getRefCount", lua_Container_getRefCount},
+        {"getRefreshInterval", lua_Container_getRefreshInterval},
         {"getScriptEvent", lua_Container_getScriptEvent},
         {"getScroll", lua_Container_getScroll},
         {"getScrollPosition", lua_Container_getScrollPosition},
@@ -6496,6 +6639,7 @@ void luaRegister_Container()
         {"hasFocus", lua_Container_hasFocus},
         {"hasScriptListener", lua_Container_hasScriptListener},
         {"insertControl", lua_Container_insertControl},
+        {"isCached", lua_Container_isCached},
         {"isChild", lua_Container_isChild},
         {"isContainer", lua_Container_isContainer},
         {"isEnabled", lua_Container_isEnabled},
@@ -6521,6 +6665,7 @@ void luaRegister_Container()
         {"setAutoSize", lua_Container_setAutoSize},
         {"setBorder", lua_Container_setBorder},
         {"setBounds", lua_Container_setBounds},
+        {"setCached", lua_Container_setCached},
         {"setCanFocus", lua_Container_setCanFocus},
         {"setConsumeInputEvents", lua_Container_setConsumeInputEvents},
         {"setCursorColor", lua_Container_setCursorColor},
@@ -6539,6 +6684,7 @@ void luaRegister_Container()
         {"setOpacity", lua_Container_setOpacity},
         {"setPadding", lua_Container_setPadding},
         {"setPosition", lua_Container_setPosition},
+        {"setRefreshInterval", lua_Container_setRefreshInterval},
         {"setScroll", lua_Container_setScroll},
         {"setScrollBarsAutoHide", lua_Container_setScrollBarsAutoHide},
         {"setScrollPosition", lua_Container_setScrollPosition},
@@ -91,6 +91,42 @@ static int lua_Curve_addRef(lua_State* state)
     return 0;
 }
 
+static int lua_Curve_bake(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                Curve* instance = getInstance(state);
+                instance->bake(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Curve_bake - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Curve_evaluate(lua_State* state)
 {
     // Get the number of parameters.
@@ -472,6 +508,41 @@ static int lua_Curve_getStartTime(lua_State* state)
     return 0;
 }
 
+static int lua_Curve_isBaked(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Curve* instance = getInstance(state);
+                bool result = instance->isBaked();
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Curve_isBaked - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Curve_release(lua_State* state)
 {
     // Get the number of parameters.
@@ -788,6 +859,7 @@ void luaRegister_Curve()
     const luaL_Reg lua_members[] = 
     {
         {"addRef", lua_Curve_addRef},
+        {"bake", lua_Curve_bake},
         {"evaluate", lua_Curve_evaluate},
         {"getComponentCount", lua_Curve_getComponentCount},
         {"getEndTime", lua_Curve_getEndTime},
@@ -797,6 +869,7 @@ void luaRegister_Curve()
         {"getPointValues", lua_Curve_getPointValues},
         {"getRefCount", lua_Curve_getRefCount},
         {"getStartTime", lua_Curve_getStartTime},
+        {"isBaked", lua_Curve_isBaked},
         {"release", lua_Curve_release},
         {"setPoint", lua_Curve_setPoint},
         {"setTangent", lua_Curve_setTangent},
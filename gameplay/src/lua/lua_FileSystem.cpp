@@ -347,6 +347,66 @@ static int lua_FileSystem_static_loadResourceAliases(lua_State* state)
     return 0;
 }
 
+static int lua_FileSystem_static_mountArchive(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TSTRING || lua_type(state, 1) == LUA_TNIL))
+            {
+                // Get parameter 1 off the stack.
+                const char* param1 = gameplay::ScriptUtil::getString(1, false);
+
+                bool result = FileSystem::mountArchive(param1);
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_FileSystem_static_mountArchive - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TSTRING || lua_type(state, 1) == LUA_TNIL) &&
+                (lua_type(state, 2) == LUA_TSTRING || lua_type(state, 2) == LUA_TNIL))
+            {
+                // Get parameter 1 off the stack.
+                const char* param1 = gameplay::ScriptUtil::getString(1, false);
+
+                // Get parameter 2 off the stack.
+                const char* param2 = gameplay::ScriptUtil::getString(2, false);
+
+                bool result = FileSystem::mountArchive(param1, param2);
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_FileSystem_static_mountArchive - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1 or 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_FileSystem_static_readAll(lua_State* state)
 {
     // Get the number of parameters.
@@ -512,6 +572,40 @@ static int lua_FileSystem_static_setResourcePath(lua_State* state)
     return 0;
 }
 
+static int lua_FileSystem_static_unmountArchive(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TSTRING || lua_type(state, 1) == LUA_TNIL))
+            {
+                // Get parameter 1 off the stack.
+                const char* param1 = gameplay::ScriptUtil::getString(1, false);
+
+                FileSystem::unmountArchive(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_FileSystem_static_unmountArchive - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 void luaRegister_FileSystem()
 {
     const luaL_Reg lua_members[] = 
@@ -528,10 +622,12 @@ void luaRegister_FileSystem()
         {"getResourcePath", lua_FileSystem_static_getResourcePath},
         {"isAbsolutePath", lua_FileSystem_static_isAbsolutePath},
         {"loadResourceAliases", lua_FileSystem_static_loadResourceAliases},
+        {"mountArchive", lua_FileSystem_static_mountArchive},
         {"readAll", lua_FileSystem_static_readAll},
         {"resolvePath", lua_FileSystem_static_resolvePath},
         {"setAssetPath", lua_FileSystem_static_setAssetPath},
         {"setResourcePath", lua_FileSystem_static_setResourcePath},
+        {"unmountArchive", lua_FileSystem_static_unmountArchive},
         {NULL, NULL}
     };
     std::vector<std::string> scopePath;
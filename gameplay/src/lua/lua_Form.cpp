@@ -2329,6 +2329,41 @@ static int lua_Form_getRefCount(lua_State* state)
     return 0;
 }
 
+static int lua_Form_getRefreshInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Form* instance = getInstance(state);
+                float result = instance->getRefreshInterval();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Form_getRefreshInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Form_getScriptEvent(lua_State* state)
 {
     // Get the number of parameters.
@@ -3416,6 +3451,41 @@ static int lua_Form_isBatchingEnabled(lua_State* state)
     return 0;
 }
 
+static int lua_Form_isCached(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Form* instance = getInstance(state);
+                bool result = instance->isCached();
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Form_isCached - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Form_isChild(lua_State* state)
 {
     // Get the number of parameters.
@@ -3636,6 +3706,41 @@ static int lua_Form_isHeightPercentage(lua_State* state)
     return 0;
 }
 
+static int lua_Form_isRetainedModeEnabled(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Form* instance = getInstance(state);
+                bool result = instance->isRetainedModeEnabled();
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Form_isRetainedModeEnabled - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Form_isScrollBarsAutoHide(lua_State* state)
 {
     // Get the number of parameters.
@@ -4503,6 +4608,42 @@ static int lua_Form_setBounds(lua_State* state)
     return 0;
 }
 
+static int lua_Form_setCached(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TBOOLEAN)
+            {
+                // Get parameter 1 off the stack.
+                bool param1 = gameplay::ScriptUtil::luaCheckBool(state, 2);
+
+                Form* instance = getInstance(state);
+                instance->setCached(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Form_setCached - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Form_setCanFocus(lua_State* state)
 {
     // Get the number of parameters.
@@ -5382,6 +5523,78 @@ static int lua_Form_setPosition(lua_State* state)
     return 0;
 }
 
+static int lua_Form_setRefreshInterval(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                Form* instance = getInstance(state);
+                instance->setRefreshInterval(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Form_setRefreshInterval - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_Form_setRetainedModeEnabled(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TBOOLEAN)
+            {
+                // Get parameter 1 off the stack.
+                bool param1 = gameplay::ScriptUtil::luaCheckBool(state, 2);
+
+                Form* instance = getInstance(state);
+                instance->setRetainedModeEnabled(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Form_setRetainedModeEnabled - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Form_setScroll(lua_State* state)
 {
     // Get the number of parameters.
@@ -6860,6 +7073,7 @@ void luaRegister_Form()
         {"getPadding", lua_Form_getPadding},
         {"getParent", lua_Form_getParent},
         {"getRefCount", lua_Form_getRefCount},
+        {"getRefreshInterval", lua_Form_getRefreshInterval},
         {"getScriptEvent", lua_Form_getScriptEvent},
         {"getScroll", lua_Form_getScroll},
         {"getScrollPosition", lua_Form_getScrollPosition},
@@ -6884,12 +7098,14 @@ void luaRegister_Form()
         {"hasScriptListener", lua_Form_hasScriptListener},
         {"insertControl", lua_Form_insertControl},
         {"isBatchingEnabled", lua_Form_isBatchingEnabled},
+        {"isCached", lua_Form_isCached},
         {"isChild", lua_Form_isChild},
         {"isContainer", lua_Form_isContainer},
         {"isEnabled", lua_Form_isEnabled},
         {"isEnabledInHierarchy", lua_Form_isEnabledInHierarchy},
         {"isForm", lua_Form_isForm},
         {"isHeightPercentage", lua_Form_isHeightPercentage},
+        {"isRetainedModeEnabled", lua_Form_isRetainedModeEnabled},
         {"isScrollBarsAutoHide", lua_Form_isScrollBarsAutoHide},
         {"isScrolling", lua_Form_isScrolling},
         {"isVisible", lua_Form_isVisible},
@@ -6910,6 +7126,7 @@ void luaRegister_Form()
         {"setBatchingEnabled", lua_Form_setBatchingEnabled},
         {"setBorder", lua_Form_setBorder},
         {"setBounds", lua_Form_setBounds},
+        {"setCached", lua_Form_setCached},
         {"setCanFocus", lua_Form_setCanFocus},
         {"setConsumeInputEvents", lua_Form_setConsumeInputEvents},
         {"setCursorColor", lua_Form_setCursorColor},
@@ -6928,6 +7145,8 @@ void luaRegister_Form()
         {"setOpacity", lua_Form_setOpacity},
         {"setPadding", lua_Form_setPadding},
         {"setPosition", lua_Form_setPosition},
+        {"setRefreshInterval", lua_Form_setRefreshInterval},
+        {"setRetainedModeEnabled", lua_Form_setRetainedModeEnabled},
         {"setScroll", lua_Form_setScroll},
         {"setScrollBarsAutoHide", lua_Form_setScrollBarsAutoHide},
         {"setScrollPosition", lua_Form_setScrollPosition},
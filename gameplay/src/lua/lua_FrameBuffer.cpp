@@ -165,6 +165,42 @@ static int lua_FrameBuffer_bind(lua_State* state)
     return 0;
 }
 
+static int lua_FrameBuffer_discard(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                FrameBuffer* instance = getInstance(state);
+                instance->discard(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_FrameBuffer_discard - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_FrameBuffer_getDepthStencilTarget(lua_State* state)
 {
     // Get the number of parameters.
@@ -209,6 +245,41 @@ static int lua_FrameBuffer_getDepthStencilTarget(lua_State* state)
     return 0;
 }
 
+static int lua_FrameBuffer_getDiscardOnUnbind(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                FrameBuffer* instance = getInstance(state);
+                unsigned int result = instance->getDiscardOnUnbind();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_FrameBuffer_getDiscardOnUnbind - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_FrameBuffer_getHeight(lua_State* state)
 {
     // Get the number of parameters.
@@ -567,6 +638,42 @@ static int lua_FrameBuffer_setDepthStencilTarget(lua_State* state)
     return 0;
 }
 
+static int lua_FrameBuffer_setDiscardOnUnbind(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                FrameBuffer* instance = getInstance(state);
+                instance->setDiscardOnUnbind(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_FrameBuffer_setDiscardOnUnbind - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_FrameBuffer_setRenderTarget(lua_State* state)
 {
     // Get the number of parameters.
@@ -1154,7 +1261,9 @@ void luaRegister_FrameBuffer()
     {
         {"addRef", lua_FrameBuffer_addRef},
         {"bind", lua_FrameBuffer_bind},
+        {"discard", lua_FrameBuffer_discard},
         {"getDepthStencilTarget", lua_FrameBuffer_getDepthStencilTarget},
+        {"getDiscardOnUnbind", lua_FrameBuffer_getDiscardOnUnbind},
         {"getHeight", lua_FrameBuffer_getHeight},
         {"getId", lua_FrameBuffer_getId},
         {"getRefCount", lua_FrameBuffer_getRefCount},
@@ -1164,6 +1273,7 @@ void luaRegister_FrameBuffer()
         {"isDefault", lua_FrameBuffer_isDefault},
         {"release", lua_FrameBuffer_release},
         {"setDepthStencilTarget", lua_FrameBuffer_setDepthStencilTarget},
+        {"setDiscardOnUnbind", lua_FrameBuffer_setDiscardOnUnbind},
         {"setRenderTarget", lua_FrameBuffer_setRenderTarget},
         {"to", lua_FrameBuffer_to},
         {NULL, NULL}
@@ -4,6 +4,7 @@
 #include "lua_Global.h"
 #include "AIMessage.h"
 #include "AnimationClip.h"
+#include "AssetLoader.h"
 #include "AudioSource.h"
 #include "Camera.h"
 #include "Container.h"
@@ -11,6 +12,7 @@
 #include "Curve.h"
 #include "DepthStencilTarget.h"
 #include "Font.h"
+#include "FrameBuffer.h"
 #include "Game.h"
 #include "Gamepad.h"
 #include "Gesture.h"
@@ -28,6 +30,8 @@
 #include "PhysicsController.h"
 #include "Properties.h"
 #include "RenderState.h"
+#include "RenderStats.h"
+#include "ResourceManager.h"
 #include "Script.h"
 #include "Sprite.h"
 #include "Terrain.h"
@@ -68,6 +72,7 @@ void luaRegister_lua_Global()
     setHierarchyPair("AnimationTarget", "Sprite");
     setHierarchyPair("AnimationTarget", "Text");
     setHierarchyPair("AnimationTarget", "Transform");
+    setHierarchyPair("AssetLoader::Request", "Ref");
     setHierarchyPair("AudioBuffer", "Ref");
     setHierarchyPair("AudioListener", "Camera::Listener");
     setHierarchyPair("AudioSource", "Ref");
@@ -83,6 +88,7 @@ void luaRegister_lua_Global()
     setHierarchyPair("CheckBox", "Button");
     setHierarchyPair("Container", "Control");
     setHierarchyPair("Container", "Form");
+    setHierarchyPair("Container", "ListView");
     setHierarchyPair("Control", "AnimationTarget");
     setHierarchyPair("Control", "Container");
     setHierarchyPair("Control", "ImageControl");
@@ -119,6 +125,7 @@ void luaRegister_lua_Global()
     setHierarchyPair("Layout", "Ref");
     setHierarchyPair("Layout", "VerticalLayout");
     setHierarchyPair("Light", "Ref");
+    setHierarchyPair("ListView", "Container");
     setHierarchyPair("Material", "RenderState");
     setHierarchyPair("MaterialParameter", "AnimationTarget");
     setHierarchyPair("MaterialParameter", "Ref");
@@ -126,6 +133,7 @@ void luaRegister_lua_Global()
     setHierarchyPair("MeshSkin", "Transform::Listener");
     setHierarchyPair("Model", "Drawable");
     setHierarchyPair("Model", "Ref");
+    setHierarchyPair("NavigationMesh", "Ref");
     setHierarchyPair("Node", "Joint");
     setHierarchyPair("Node", "Ref");
     setHierarchyPair("Node", "Transform");
@@ -161,6 +169,7 @@ void luaRegister_lua_Global()
     setHierarchyPair("Ref", "AIState");
     setHierarchyPair("Ref", "Animation");
     setHierarchyPair("Ref", "AnimationClip");
+    setHierarchyPair("Ref", "AssetLoader::Request");
     setHierarchyPair("Ref", "AudioBuffer");
     setHierarchyPair("Ref", "AudioSource");
     setHierarchyPair("Ref", "Bundle");
@@ -178,6 +187,7 @@ void luaRegister_lua_Global()
     setHierarchyPair("Ref", "MaterialParameter");
     setHierarchyPair("Ref", "Mesh");
     setHierarchyPair("Ref", "Model");
+    setHierarchyPair("Ref", "NavigationMesh");
     setHierarchyPair("Ref", "Node");
     setHierarchyPair("Ref", "ParticleEmitter");
     setHierarchyPair("Ref", "PhysicsCollisionShape");
@@ -186,11 +196,14 @@ void luaRegister_lua_Global()
     setHierarchyPair("Ref", "RenderTarget");
     setHierarchyPair("Ref", "Scene");
     setHierarchyPair("Ref", "Script");
+    setHierarchyPair("Ref", "ScriptContext");
     setHierarchyPair("Ref", "Sprite");
     setHierarchyPair("Ref", "Terrain");
     setHierarchyPair("Ref", "Text");
+    setHierarchyPair("Ref", "TextLayout");
     setHierarchyPair("Ref", "Texture");
     setHierarchyPair("Ref", "Texture::Sampler");
+    setHierarchyPair("Ref", "TextureAtlas");
     setHierarchyPair("Ref", "Theme");
     setHierarchyPair("Ref", "Theme::ThemeImage");
     setHierarchyPair("Ref", "TileSet");
@@ -203,9 +216,12 @@ void luaRegister_lua_Global()
     setHierarchyPair("RenderTarget", "Ref");
     setHierarchyPair("Scene", "Ref");
     setHierarchyPair("Script", "Ref");
+    setHierarchyPair("ScriptContext", "Ref");
+    setHierarchyPair("ScriptContext", "ScriptTarget");
     setHierarchyPair("ScriptTarget", "AnimationClip");
     setHierarchyPair("ScriptTarget", "Control");
     setHierarchyPair("ScriptTarget", "PhysicsController");
+    setHierarchyPair("ScriptTarget", "ScriptContext");
     setHierarchyPair("ScriptTarget", "Transform");
     setHierarchyPair("Slider", "Label");
     setHierarchyPair("Sprite", "AnimationTarget");
@@ -220,8 +236,10 @@ void luaRegister_lua_Global()
     setHierarchyPair("Text", "Drawable");
     setHierarchyPair("Text", "Ref");
     setHierarchyPair("TextBox", "Label");
+    setHierarchyPair("TextLayout", "Ref");
     setHierarchyPair("Texture", "Ref");
     setHierarchyPair("Texture::Sampler", "Ref");
+    setHierarchyPair("TextureAtlas", "Ref");
     setHierarchyPair("Theme", "Ref");
     setHierarchyPair("Theme::ThemeImage", "Ref");
     setHierarchyPair("TileSet", "Drawable");
@@ -261,6 +279,31 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(AnimationClip::Listener::TIME, "TIME", scopePath);
     }
 
+    // Register enumeration AssetLoader::Request::State.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("AssetLoader");
+        scopePath.push_back("Request");
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::Request::LOADING, "LOADING", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::Request::COMPLETE, "COMPLETE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::Request::FAILED, "FAILED", scopePath);
+    }
+
+    // Register enumeration AssetLoader::Type.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("AssetLoader");
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::UNKNOWN, "UNKNOWN", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::TEXTURE, "TEXTURE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::EFFECT, "EFFECT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::AUDIO_SOURCE, "AUDIO_SOURCE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::SCENE, "SCENE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::PROPERTIES, "PROPERTIES", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::NODE, "NODE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::MESH, "MESH", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(AssetLoader::SOUND_BANK, "SOUND_BANK", scopePath);
+    }
+
     // Register enumeration AudioSource::State.
     {
         std::vector<std::string> scopePath;
@@ -460,6 +503,17 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(Font::BOLD_ITALIC, "BOLD_ITALIC", scopePath);
     }
 
+    // Register enumeration FrameBuffer::Attachments.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("FrameBuffer");
+        gameplay::ScriptUtil::registerEnumValue(FrameBuffer::ATTACHMENT_COLOR, "ATTACHMENT_COLOR", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(FrameBuffer::ATTACHMENT_DEPTH, "ATTACHMENT_DEPTH", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(FrameBuffer::ATTACHMENT_STENCIL, "ATTACHMENT_STENCIL", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(FrameBuffer::ATTACHMENT_DEPTH_STENCIL, "ATTACHMENT_DEPTH_STENCIL", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(FrameBuffer::ATTACHMENT_ALL, "ATTACHMENT_ALL", scopePath);
+    }
+
     // Register enumeration Game::ClearFlags.
     {
         std::vector<std::string> scopePath;
@@ -855,7 +909,29 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(RenderState::CAMERA_WORLD_POSITION, "CAMERA_WORLD_POSITION", scopePath);
         gameplay::ScriptUtil::registerEnumValue(RenderState::CAMERA_VIEW_POSITION, "CAMERA_VIEW_POSITION", scopePath);
         gameplay::ScriptUtil::registerEnumValue(RenderState::MATRIX_PALETTE, "MATRIX_PALETTE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::DUAL_QUATERNION_PALETTE, "DUAL_QUATERNION_PALETTE", scopePath);
         gameplay::ScriptUtil::registerEnumValue(RenderState::SCENE_AMBIENT_COLOR, "SCENE_AMBIENT_COLOR", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::LIGHT_CLUSTER_TEXTURE, "LIGHT_CLUSTER_TEXTURE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::LIGHT_CLUSTER_PARAMETERS, "LIGHT_CLUSTER_PARAMETERS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::DIRECTIONAL_LIGHT_DIRECTION, "DIRECTIONAL_LIGHT_DIRECTION", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::DIRECTIONAL_LIGHT_COLOR, "DIRECTIONAL_LIGHT_COLOR", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::POINT_LIGHT_POSITION, "POINT_LIGHT_POSITION", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::POINT_LIGHT_COLOR, "POINT_LIGHT_COLOR", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::POINT_LIGHT_RANGE_INVERSE, "POINT_LIGHT_RANGE_INVERSE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SPOT_LIGHT_POSITION, "SPOT_LIGHT_POSITION", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SPOT_LIGHT_DIRECTION, "SPOT_LIGHT_DIRECTION", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SPOT_LIGHT_COLOR, "SPOT_LIGHT_COLOR", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SPOT_LIGHT_RANGE_INVERSE, "SPOT_LIGHT_RANGE_INVERSE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SPOT_LIGHT_INNER_ANGLE_COS, "SPOT_LIGHT_INNER_ANGLE_COS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SPOT_LIGHT_OUTER_ANGLE_COS, "SPOT_LIGHT_OUTER_ANGLE_COS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SHADOW_MAP_TEXTURE, "SHADOW_MAP_TEXTURE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SHADOW_MATRICES, "SHADOW_MATRICES", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SHADOW_CASCADE_SPLITS, "SHADOW_CASCADE_SPLITS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::SHADOW_PARAMETERS, "SHADOW_PARAMETERS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::VIEW_PROJECTION_MATRICES, "VIEW_PROJECTION_MATRICES", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::WORLD_VIEW_PROJECTION_MATRICES, "WORLD_VIEW_PROJECTION_MATRICES", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::LIGHTMAP_TEXTURE, "LIGHTMAP_TEXTURE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderState::LIGHTMAP_SCALE_OFFSET, "LIGHTMAP_SCALE_OFFSET", scopePath);
     }
 
     // Register enumeration RenderState::Blend.
@@ -936,6 +1012,40 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(RenderState::STENCIL_OP_DECR_WRAP, "STENCIL_OP_DECR_WRAP", scopePath);
     }
 
+    // Register enumeration RenderStats::Counter.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("RenderStats");
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::DRAW_CALLS, "DRAW_CALLS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::PROGRAM_BINDS, "PROGRAM_BINDS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::TEXTURE_BINDS, "TEXTURE_BINDS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::BUFFER_BINDS, "BUFFER_BINDS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::STATE_BLOCK_BINDS, "STATE_BLOCK_BINDS", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::COUNTER_COUNT, "COUNTER_COUNT", scopePath);
+    }
+
+    // Register enumeration RenderStats::Memory.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("RenderStats");
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::TEXTURE_MEMORY, "TEXTURE_MEMORY", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::VERTEX_BUFFER_MEMORY, "VERTEX_BUFFER_MEMORY", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::INDEX_BUFFER_MEMORY, "INDEX_BUFFER_MEMORY", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::RENDER_BUFFER_MEMORY, "RENDER_BUFFER_MEMORY", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(RenderStats::MEMORY_COUNT, "MEMORY_COUNT", scopePath);
+    }
+
+    // Register enumeration ResourceManager::Type.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("ResourceManager");
+        gameplay::ScriptUtil::registerEnumValue(ResourceManager::TEXTURE, "TEXTURE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(ResourceManager::EFFECT, "EFFECT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(ResourceManager::AUDIO_BUFFER, "AUDIO_BUFFER", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(ResourceManager::FONT, "FONT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(ResourceManager::TYPE_COUNT, "TYPE_COUNT", scopePath);
+    }
+
     // Register enumeration Script::Scope.
     {
         std::vector<std::string> scopePath;
@@ -1002,6 +1112,18 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(TextBox::PASSWORD, "PASSWORD", scopePath);
     }
 
+    // Register enumeration Texture::Compression.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("Texture");
+        gameplay::ScriptUtil::registerEnumValue(Texture::COMPRESSION_ETC1, "COMPRESSION_ETC1", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(Texture::COMPRESSION_ETC2, "COMPRESSION_ETC2", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(Texture::COMPRESSION_ASTC, "COMPRESSION_ASTC", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(Texture::COMPRESSION_BC, "COMPRESSION_BC", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(Texture::COMPRESSION_PVRTC, "COMPRESSION_PVRTC", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(Texture::COMPRESSION_ATC, "COMPRESSION_ATC", scopePath);
+    }
+
     // Register enumeration Texture::CubeFace.
     {
         std::vector<std::string> scopePath;
@@ -1040,6 +1162,7 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(Texture::RGBA5551, "RGBA5551", scopePath);
         gameplay::ScriptUtil::registerEnumValue(Texture::ALPHA, "ALPHA", scopePath);
         gameplay::ScriptUtil::registerEnumValue(Texture::DEPTH, "DEPTH", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(Texture::RGBA32F, "RGBA32F", scopePath);
     }
 
     // Register enumeration Texture::Type.
@@ -1087,6 +1210,19 @@ void luaRegister_lua_Global()
         gameplay::ScriptUtil::registerEnumValue(VertexFormat::TEXCOORD6, "TEXCOORD6", scopePath);
         gameplay::ScriptUtil::registerEnumValue(VertexFormat::TEXCOORD7, "TEXCOORD7", scopePath);
     }
+
+    // Register enumeration VertexFormat::Type.
+    {
+        std::vector<std::string> scopePath;
+        scopePath.push_back("VertexFormat");
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::FLOAT, "FLOAT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::HALF_FLOAT, "HALF_FLOAT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::BYTE, "BYTE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::UNSIGNED_BYTE, "UNSIGNED_BYTE", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::SHORT, "SHORT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::UNSIGNED_SHORT, "UNSIGNED_SHORT", scopePath);
+        gameplay::ScriptUtil::registerEnumValue(VertexFormat::INT_2_10_10_10_REV, "INT_2_10_10_10_REV", scopePath);
+    }
 }
 
 const std::vector<std::string>& luaGetClassRelatives(const char* type)
@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_LISTVIEW_H_
+#define LUA_LISTVIEW_H_
+
+namespace gameplay
+{
+
+void luaRegister_ListView();
+
+}
+
+#endif
@@ -72,6 +72,85 @@ static int lua_MeshSkin_getBindShape(lua_State* state)
     return 0;
 }
 
+static int lua_MeshSkin_getDualQuaternionPalette(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                MeshSkin* instance = getInstance(state);
+                void* returnPtr = ((void*)instance->getDualQuaternionPalette());
+                if (returnPtr)
+                {
+                    gameplay::ScriptUtil::LuaObject* object = (gameplay::ScriptUtil::LuaObject*)lua_newuserdata(state, sizeof(gameplay::ScriptUtil::LuaObject));
+                    object->instance = returnPtr;
+                    object->owns = false;
+                    luaL_getmetatable(state, "Vector4");
+                    lua_setmetatable(state, -2);
+                }
+                else
+                {
+                    lua_pushnil(state);
+                }
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_MeshSkin_getDualQuaternionPalette - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_MeshSkin_getDualQuaternionPaletteSize(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                MeshSkin* instance = getInstance(state);
+                unsigned int result = instance->getDualQuaternionPaletteSize();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_MeshSkin_getDualQuaternionPaletteSize - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_MeshSkin_getJoint(lua_State* state)
 {
     // Get the number of parameters.
@@ -570,6 +649,8 @@ void luaRegister_MeshSkin()
     const luaL_Reg lua_members[] = 
     {
         {"getBindShape", lua_MeshSkin_getBindShape},
+        {"getDualQuaternionPalette", lua_MeshSkin_getDualQuaternionPalette},
+        {"getDualQuaternionPaletteSize", lua_MeshSkin_getDualQuaternionPaletteSize},
         {"getJoint", lua_MeshSkin_getJoint},
         {"getJointCount", lua_MeshSkin_getJointCount},
         {"getJointIndex", lua_MeshSkin_getJointIndex},
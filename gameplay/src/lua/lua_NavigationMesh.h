@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_NAVIGATIONMESH_H_
+#define LUA_NAVIGATIONMESH_H_
+
+namespace gameplay
+{
+
+void luaRegister_NavigationMesh();
+
+}
+
+#endif
@@ -1287,6 +1287,34 @@ static int lua_Properties_static_create(lua_State* state)
     return 0;
 }
 
+static int lua_Properties_static_isCacheEnabled(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 0:
+        {
+            bool result = Properties::isCacheEnabled();
+
+            // Push the return value onto the stack.
+            lua_pushboolean(state, result);
+
+            return 1;
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 0).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Properties_static_parseAxisAngle(lua_State* state)
 {
     // Get the number of parameters.
@@ -1545,6 +1573,40 @@ static int lua_Properties_static_parseVector4(lua_State* state)
     return 0;
 }
 
+static int lua_Properties_static_setCacheEnabled(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if (lua_type(state, 1) == LUA_TBOOLEAN)
+            {
+                // Get parameter 1 off the stack.
+                bool param1 = gameplay::ScriptUtil::luaCheckBool(state, 1);
+
+                Properties::setCacheEnabled(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Properties_static_setCacheEnabled - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 void luaRegister_Properties()
 {
     const luaL_Reg lua_members[] = 
@@ -1575,11 +1637,13 @@ void luaRegister_Properties()
     const luaL_Reg lua_statics[] = 
     {
         {"create", lua_Properties_static_create},
+        {"isCacheEnabled", lua_Properties_static_isCacheEnabled},
         {"parseAxisAngle", lua_Properties_static_parseAxisAngle},
         {"parseColor", lua_Properties_static_parseColor},
         {"parseVector2", lua_Properties_static_parseVector2},
         {"parseVector3", lua_Properties_static_parseVector3},
         {"parseVector4", lua_Properties_static_parseVector4},
+        {"setCacheEnabled", lua_Properties_static_setCacheEnabled},
         {NULL, NULL}
     };
     std::vector<std::string> scopePath;
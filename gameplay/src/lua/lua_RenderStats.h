@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_RENDERSTATS_H_
+#define LUA_RENDERSTATS_H_
+
+namespace gameplay
+{
+
+void luaRegister_RenderStats();
+
+}
+
+#endif
@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_RESOURCEMANAGER_H_
+#define LUA_RESOURCEMANAGER_H_
+
+namespace gameplay
+{
+
+void luaRegister_ResourceManager();
+
+}
+
+#endif
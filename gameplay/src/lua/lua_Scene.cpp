@@ -1103,6 +1103,137 @@ static int lua_Scene_update(lua_State* state)
     return 0;
 }
 
+// Pushes a table of the given nodes, so that scripts get all matches of a query in one call.
+static void pushNodeTable(lua_State* state, const std::vector<Node*>& nodes)
+{
+    lua_createtable(state, (int)nodes.size(), 0);
+    for (size_t i = 0, count = nodes.size(); i < count; ++i)
+    {
+        gameplay::ScriptUtil::LuaObject* object = (gameplay::ScriptUtil::LuaObject*)lua_newuserdata(state, sizeof(gameplay::ScriptUtil::LuaObject));
+        object->instance = (void*)nodes[i];
+        object->owns = false;
+        luaL_getmetatable(state, "Node");
+        lua_setmetatable(state, -2);
+        lua_rawseti(state, -2, (int)i + 1);
+    }
+}
+
+static int lua_Scene_findNodesByTag(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        case 3:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                (lua_type(state, 2) == LUA_TSTRING) &&
+                (paramCount == 2 || lua_type(state, 3) == LUA_TSTRING || lua_type(state, 3) == LUA_TNIL))
+            {
+                // Get parameters 1 and 2 off the stack.
+                const char* param1 = gameplay::ScriptUtil::getString(2, false);
+                const char* param2 = paramCount == 3 ? gameplay::ScriptUtil::getString(3, false) : NULL;
+
+                Scene* instance = getInstance(state);
+                std::vector<Node*> nodes;
+                instance->findNodesByTag(param1, nodes, param2);
+                pushNodeTable(state, nodes);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Scene_findNodesByTag - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2 or 3).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_Scene_findNodesByType(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                (lua_type(state, 2) == LUA_TSTRING))
+            {
+                // Get parameter 1 off the stack.
+                const char* param1 = gameplay::ScriptUtil::getString(2, false);
+
+                Scene* instance = getInstance(state);
+                std::vector<Node*> nodes;
+                instance->findNodesByType(param1, nodes);
+                pushNodeTable(state, nodes);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Scene_findNodesByType - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+// Calls the function at the given stack index for a node and its descendants, as Scene::visitNode
+// does for a function name, without looking the function up again for each node.
+static void visitNodeFunction(lua_State* state, int function, Node* node)
+{
+    lua_pushvalue(state, function);
+    gameplay::ScriptUtil::LuaObject* object = (gameplay::ScriptUtil::LuaObject*)lua_newuserdata(state, sizeof(gameplay::ScriptUtil::LuaObject));
+    object->instance = (void*)node;
+    object->owns = false;
+    luaL_getmetatable(state, "Node");
+    lua_setmetatable(state, -2);
+    if (lua_pcall(state, 1, 1, 0) != 0)
+    {
+        GP_WARN("Failed to call the visit function with error '%s'.", lua_tostring(state, -1));
+        lua_pop(state, 1);
+        return;
+    }
+    bool result = lua_toboolean(state, -1) != 0;
+    lua_pop(state, 1);
+    if (!result)
+        return;
+
+    // Visit the joint hierarchy of a skin from its top level node, as Scene::visitNode does.
+    Model* model = dynamic_cast<Model*>(node->getDrawable());
+    if (model && model->getSkin() && model->getSkin()->getRootJoint())
+    {
+        Node* root = model->getSkin()->getRootJoint();
+        while (root->getParent())
+            root = root->getParent();
+        visitNodeFunction(state, function, root);
+    }
+
+    for (Node* child = node->getFirstChild(); child != NULL; child = child->getNextSibling())
+    {
+        visitNodeFunction(state, function, child);
+    }
+}
+
 static int lua_Scene_visit(lua_State* state)
 {
     // Get the number of parameters.
@@ -1124,6 +1255,17 @@ static int lua_Scene_visit(lua_State* state)
                 
                 return 0;
             }
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                (lua_type(state, 2) == LUA_TFUNCTION))
+            {
+                Scene* instance = getInstance(state);
+                for (Node* node = instance->getFirstNode(); node != NULL; node = node->getNextSibling())
+                {
+                    visitNodeFunction(state, 2, node);
+                }
+
+                return 0;
+            }
 
             lua_pushstring(state, "lua_Scene_visit - Failed to match the given parameters to a valid function signature.");
             lua_error(state);
@@ -1191,6 +1333,8 @@ void luaRegister_Scene()
         {"addRef", lua_Scene_addRef},
         {"bindAudioListenerToCamera", lua_Scene_bindAudioListenerToCamera},
         {"findNode", lua_Scene_findNode},
+        {"findNodesByTag", lua_Scene_findNodesByTag},
+        {"findNodesByType", lua_Scene_findNodesByType},
         {"getActiveCamera", lua_Scene_getActiveCamera},
         {"getAmbientColor", lua_Scene_getAmbientColor},
         {"getFirstNode", lua_Scene_getFirstNode},
@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_SCRIPTCONTEXT_H_
+#define LUA_SCRIPTCONTEXT_H_
+
+namespace gameplay
+{
+
+void luaRegister_ScriptContext();
+
+}
+
+#endif
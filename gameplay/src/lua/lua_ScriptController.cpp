@@ -86,6 +86,146 @@ static int lua_ScriptController_functionExists(lua_State* state)
     return 0;
 }
 
+static int lua_ScriptController_getAllocationCount(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                ScriptController* instance = getInstance(state);
+                unsigned int result = instance->getAllocationCount();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_ScriptController_getAllocationCount - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_ScriptController_getCollectorBudget(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                ScriptController* instance = getInstance(state);
+                float result = instance->getCollectorBudget();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_ScriptController_getCollectorBudget - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_ScriptController_getCollectorCycleCount(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                ScriptController* instance = getInstance(state);
+                unsigned int result = instance->getCollectorCycleCount();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_ScriptController_getCollectorCycleCount - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
+static int lua_ScriptController_getCollectorTime(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                ScriptController* instance = getInstance(state);
+                float result = instance->getCollectorTime();
+
+                // Push the return value onto the stack.
+                lua_pushnumber(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_ScriptController_getCollectorTime - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_ScriptController_getCurrentScript(lua_State* state)
 {
     // Get the number of parameters.
@@ -130,6 +270,41 @@ static int lua_ScriptController_getCurrentScript(lua_State* state)
     return 0;
 }
 
+static int lua_ScriptController_getMemoryUsage(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                ScriptController* instance = getInstance(state);
+                unsigned int result = instance->getMemoryUsage();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_ScriptController_getMemoryUsage - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_ScriptController_loadScript(lua_State* state)
 {
     // Get the number of parameters.
@@ -250,6 +425,42 @@ static int lua_ScriptController_loadScript(lua_State* state)
     return 0;
 }
 
+static int lua_ScriptController_setCollectorBudget(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                float param1 = (float)luaL_checknumber(state, 2);
+
+                ScriptController* instance = getInstance(state);
+                instance->setCollectorBudget(param1);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_ScriptController_setCollectorBudget - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_ScriptController_static_print(lua_State* state)
 {
     // Get the number of parameters.
@@ -315,8 +526,14 @@ void luaRegister_ScriptController()
     const luaL_Reg lua_members[] = 
     {
         {"functionExists", lua_ScriptController_functionExists},
+        {"getAllocationCount", lua_ScriptController_getAllocationCount},
+        {"getCollectorBudget", lua_ScriptController_getCollectorBudget},
+        {"getCollectorCycleCount", lua_ScriptController_getCollectorCycleCount},
+        {"getCollectorTime", lua_ScriptController_getCollectorTime},
         {"getCurrentScript", lua_ScriptController_getCurrentScript},
+        {"getMemoryUsage", lua_ScriptController_getMemoryUsage},
         {"loadScript", lua_ScriptController_loadScript},
+        {"setCollectorBudget", lua_ScriptController_setCollectorBudget},
         {NULL, NULL}
     };
     const luaL_Reg lua_statics[] = 
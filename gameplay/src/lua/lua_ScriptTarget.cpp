@@ -16,6 +16,7 @@
 #include "Node.h"
 #include "PhysicsController.h"
 #include "RadioButton.h"
+#include "ScriptContext.h"
 #include "ScriptController.h"
 #include "ScriptTarget.h"
 #include "Slider.h"
@@ -24,6 +25,7 @@
 #include "AnimationClip.h"
 #include "Control.h"
 #include "PhysicsController.h"
+#include "ScriptContext.h"
 #include "Transform.h"
 
 namespace gameplay
@@ -412,6 +414,10 @@ static void* __convertTo(void* ptr, const char* typeName)
     {
         return reinterpret_cast<void*>(static_cast<PhysicsController*>(ptrObject));
     }
+    else if (strcmp(typeName, "ScriptContext") == 0)
+    {
+        return reinterpret_cast<void*>(static_cast<ScriptContext*>(ptrObject));
+    }
     else if (strcmp(typeName, "Transform") == 0)
     {
         return reinterpret_cast<void*>(static_cast<Transform*>(ptrObject));
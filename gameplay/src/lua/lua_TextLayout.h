@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_TEXTLAYOUT_H_
+#define LUA_TEXTLAYOUT_H_
+
+namespace gameplay
+{
+
+void luaRegister_TextLayout();
+
+}
+
+#endif
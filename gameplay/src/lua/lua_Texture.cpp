@@ -238,6 +238,41 @@ static int lua_Texture_getHeight(lua_State* state)
     return 0;
 }
 
+static int lua_Texture_getMemorySize(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Texture* instance = getInstance(state);
+                size_t result = instance->getMemorySize();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Texture_getMemorySize - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Texture_getPath(lua_State* state)
 {
     // Get the number of parameters.
@@ -506,9 +541,81 @@ static int lua_Texture_setData(lua_State* state)
             lua_error(state);
             break;
         }
+        case 6:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER &&
+                lua_type(state, 3) == LUA_TNUMBER &&
+                lua_type(state, 4) == LUA_TNUMBER &&
+                lua_type(state, 5) == LUA_TNUMBER &&
+                (lua_type(state, 6) == LUA_TTABLE || lua_type(state, 6) == LUA_TLIGHTUSERDATA))
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                // Get parameter 2 off the stack.
+                unsigned int param2 = (unsigned int)luaL_checkunsigned(state, 3);
+
+                // Get parameter 3 off the stack.
+                unsigned int param3 = (unsigned int)luaL_checkunsigned(state, 4);
+
+                // Get parameter 4 off the stack.
+                unsigned int param4 = (unsigned int)luaL_checkunsigned(state, 5);
+
+                // Get parameter 5 off the stack.
+                gameplay::ScriptUtil::LuaArray<unsigned char> param5 = gameplay::ScriptUtil::getUnsignedCharPointer(6);
+
+                Texture* instance = getInstance(state);
+                instance->setData(param1, param2, param3, param4, param5);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Texture_setData - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        case 7:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER &&
+                lua_type(state, 3) == LUA_TNUMBER &&
+                lua_type(state, 4) == LUA_TNUMBER &&
+                lua_type(state, 5) == LUA_TNUMBER &&
+                (lua_type(state, 6) == LUA_TTABLE || lua_type(state, 6) == LUA_TLIGHTUSERDATA) &&
+                lua_type(state, 7) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                // Get parameter 2 off the stack.
+                unsigned int param2 = (unsigned int)luaL_checkunsigned(state, 3);
+
+                // Get parameter 3 off the stack.
+                unsigned int param3 = (unsigned int)luaL_checkunsigned(state, 4);
+
+                // Get parameter 4 off the stack.
+                unsigned int param4 = (unsigned int)luaL_checkunsigned(state, 5);
+
+                // Get parameter 5 off the stack.
+                gameplay::ScriptUtil::LuaArray<unsigned char> param5 = gameplay::ScriptUtil::getUnsignedCharPointer(6);
+
+                // Get parameter 6 off the stack.
+                Texture::CubeFace param6 = (Texture::CubeFace)luaL_checkint(state, 7);
+
+                Texture* instance = getInstance(state);
+                instance->setData(param1, param2, param3, param4, param5, param6);
+                
+                return 0;
+            }
+
+            lua_pushstring(state, "lua_Texture_setData - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
         default:
         {
-            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_pushstring(state, "Invalid number of parameters (expected 2, 6 or 7).");
             lua_error(state);
             break;
         }
@@ -884,6 +991,43 @@ static int lua_Texture_static_create(lua_State* state)
 }
 
 // Provides support for conversion to all known relative types of Texture
+static int lua_Texture_static_isCompressionSupported(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if (lua_type(state, 1) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                Texture::Compression param1 = (Texture::Compression)luaL_checkint(state, 1);
+
+                bool result = Texture::isCompressionSupported(param1);
+
+                // Push the return value onto the stack.
+                lua_pushboolean(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Texture_static_isCompressionSupported - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static void* __convertTo(void* ptr, const char* typeName)
 {
     Texture* ptrObject = reinterpret_cast<Texture*>(ptr);
@@ -936,6 +1080,7 @@ void luaRegister_Texture()
         {"getFormat", lua_Texture_getFormat},
         {"getHandle", lua_Texture_getHandle},
         {"getHeight", lua_Texture_getHeight},
+        {"getMemorySize", lua_Texture_getMemorySize},
         {"getPath", lua_Texture_getPath},
         {"getRefCount", lua_Texture_getRefCount},
         {"getType", lua_Texture_getType},
@@ -950,6 +1095,7 @@ void luaRegister_Texture()
     const luaL_Reg lua_statics[] = 
     {
         {"create", lua_Texture_static_create},
+        {"isCompressionSupported", lua_Texture_static_isCompressionSupported},
         {NULL, NULL}
     };
     std::vector<std::string> scopePath;
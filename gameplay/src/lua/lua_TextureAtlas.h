@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_TEXTUREATLAS_H_
+#define LUA_TEXTUREATLAS_H_
+
+namespace gameplay
+{
+
+void luaRegister_TextureAtlas();
+
+}
+
+#endif
@@ -0,0 +1,12 @@
+// Autogenerated by gameplay-luagen
+#ifndef LUA_TEXTURESTREAMER_H_
+#define LUA_TEXTURESTREAMER_H_
+
+namespace gameplay
+{
+
+void luaRegister_TextureStreamer();
+
+}
+
+#endif
@@ -97,6 +97,41 @@ static int lua_Uniform_getName(lua_State* state)
     return 0;
 }
 
+static int lua_Uniform_getSize(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 1:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA))
+            {
+                Uniform* instance = getInstance(state);
+                unsigned int result = instance->getSize();
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_Uniform_getSize - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 1).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_Uniform_getType(lua_State* state)
 {
     // Get the number of parameters.
@@ -139,6 +174,7 @@ void luaRegister_Uniform()
     {
         {"getEffect", lua_Uniform_getEffect},
         {"getName", lua_Uniform_getName},
+        {"getSize", lua_Uniform_getSize},
         {"getType", lua_Uniform_getType},
         {NULL, NULL}
     };
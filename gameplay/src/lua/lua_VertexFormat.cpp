@@ -192,6 +192,45 @@ static int lua_VertexFormat_getElementCount(lua_State* state)
     return 0;
 }
 
+static int lua_VertexFormat_getElementOffset(lua_State* state)
+{
+    // Get the number of parameters.
+    int paramCount = lua_gettop(state);
+
+    // Attempt to match the parameters to a valid binding.
+    switch (paramCount)
+    {
+        case 2:
+        {
+            if ((lua_type(state, 1) == LUA_TUSERDATA) &&
+                lua_type(state, 2) == LUA_TNUMBER)
+            {
+                // Get parameter 1 off the stack.
+                unsigned int param1 = (unsigned int)luaL_checkunsigned(state, 2);
+
+                VertexFormat* instance = getInstance(state);
+                unsigned int result = instance->getElementOffset(param1);
+
+                // Push the return value onto the stack.
+                lua_pushunsigned(state, result);
+
+                return 1;
+            }
+
+            lua_pushstring(state, "lua_VertexFormat_getElementOffset - Failed to match the given parameters to a valid function signature.");
+            lua_error(state);
+            break;
+        }
+        default:
+        {
+            lua_pushstring(state, "Invalid number of parameters (expected 2).");
+            lua_error(state);
+            break;
+        }
+    }
+    return 0;
+}
+
 static int lua_VertexFormat_getVertexSize(lua_State* state)
 {
     // Get the number of parameters.
@@ -270,6 +309,7 @@ void luaRegister_VertexFormat()
     {
         {"getElement", lua_VertexFormat_getElement},
         {"getElementCount", lua_VertexFormat_getElementCount},
+        {"getElementOffset", lua_VertexFormat_getElementOffset},
         {"getVertexSize", lua_VertexFormat_getVertexSize},
         {NULL, NULL}
     };
@@ -21,6 +21,8 @@ void lua_RegisterAllBindings()
     luaRegister_AnimationController();
     luaRegister_AnimationTarget();
     luaRegister_AnimationValue();
+    luaRegister_AssetLoader();
+    luaRegister_AssetLoaderRequest();
     luaRegister_AudioBuffer();
     luaRegister_AudioController();
     luaRegister_AudioListener();
@@ -57,6 +59,7 @@ void lua_RegisterAllBindings()
     luaRegister_Label();
     luaRegister_Layout();
     luaRegister_Light();
+    luaRegister_ListView();
     luaRegister_Logger();
     luaRegister_Material();
     luaRegister_MaterialParameter();
@@ -68,6 +71,7 @@ void lua_RegisterAllBindings()
     luaRegister_MeshSkin();
     luaRegister_Model();
     luaRegister_Mouse();
+    luaRegister_NavigationMesh();
     luaRegister_Node();
     luaRegister_NodeCloneContext();
     luaRegister_ParticleEmitter();
@@ -103,10 +107,13 @@ void lua_RegisterAllBindings()
     luaRegister_Ref();
     luaRegister_RenderState();
     luaRegister_RenderStateStateBlock();
+    luaRegister_RenderStats();
     luaRegister_RenderTarget();
+    luaRegister_ResourceManager();
     luaRegister_Scene();
     luaRegister_ScreenDisplayer();
     luaRegister_Script();
+    luaRegister_ScriptContext();
     luaRegister_ScriptController();
     luaRegister_ScriptTarget();
     luaRegister_ScriptTargetEvent();
@@ -120,8 +127,11 @@ void lua_RegisterAllBindings()
     luaRegister_TerrainPatch();
     luaRegister_Text();
     luaRegister_TextBox();
+    luaRegister_TextLayout();
     luaRegister_Texture();
+    luaRegister_TextureAtlas();
     luaRegister_TextureSampler();
+    luaRegister_TextureStreamer();
     luaRegister_Theme();
     luaRegister_ThemeSideRegions();
     luaRegister_ThemeStyle();
@@ -16,6 +16,8 @@
 #include "lua_AnimationController.h"
 #include "lua_AnimationTarget.h"
 #include "lua_AnimationValue.h"
+#include "lua_AssetLoader.h"
+#include "lua_AssetLoaderRequest.h"
 #include "lua_AudioBuffer.h"
 #include "lua_AudioController.h"
 #include "lua_AudioListener.h"
@@ -52,6 +54,7 @@
 #include "lua_Label.h"
 #include "lua_Layout.h"
 #include "lua_Light.h"
+#include "lua_ListView.h"
 #include "lua_Logger.h"
 #include "lua_Material.h"
 #include "lua_MaterialParameter.h"
@@ -63,6 +66,7 @@
 #include "lua_MeshSkin.h"
 #include "lua_Model.h"
 #include "lua_Mouse.h"
+#include "lua_NavigationMesh.h"
 #include "lua_Node.h"
 #include "lua_NodeCloneContext.h"
 #include "lua_ParticleEmitter.h"
@@ -98,10 +102,13 @@
 #include "lua_Ref.h"
 #include "lua_RenderState.h"
 #include "lua_RenderStateStateBlock.h"
+#include "lua_RenderStats.h"
 #include "lua_RenderTarget.h"
+#include "lua_ResourceManager.h"
 #include "lua_Scene.h"
 #include "lua_ScreenDisplayer.h"
 #include "lua_Script.h"
+#include "lua_ScriptContext.h"
 #include "lua_ScriptController.h"
 #include "lua_ScriptTarget.h"
 #include "lua_ScriptTargetEvent.h"
@@ -115,8 +122,11 @@
 #include "lua_TerrainPatch.h"
 #include "lua_Text.h"
 #include "lua_TextBox.h"
+#include "lua_TextLayout.h"
 #include "lua_Texture.h"
+#include "lua_TextureAtlas.h"
 #include "lua_TextureSampler.h"
+#include "lua_TextureStreamer.h"
 #include "lua_Theme.h"
 #include "lua_ThemeSideRegions.h"
 #include "lua_ThemeStyle.h"
@@ -0,0 +1,392 @@
+#include "BenchmarkGame.h"
+
+// Declare our game instance
+BenchmarkGame game;
+
+#define REFERENCE_BUNDLE "res/common/sample.gpb"
+#define REFERENCE_PROPERTIES "res/ui/default.theme"
+#define REFERENCE_PARTICLE "res/common/particles/fire.particle"
+#define REFERENCE_FONT "res/ui/arial.gpb"
+#define PHYSICS_BODY_COUNT 256
+#define FRAME_TIME 16.6667f
+
+static double getTime()
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static MeshSkin* findSkin(Node* node)
+{
+    for (; node; node = node->getNextSibling())
+    {
+        Model* model = dynamic_cast<Model*>(node->getDrawable());
+        if (model && model->getSkin())
+            return model->getSkin();
+        MeshSkin* skin = findSkin(node->getFirstChild());
+        if (skin)
+            return skin;
+    }
+    return NULL;
+}
+
+BenchmarkGame::BenchmarkGame()
+    : _repetitions(5), _physicsFrames(300), _physicsScene(NULL), _frame(0), _sink(0.0f)
+{
+}
+
+void BenchmarkGame::initialize()
+{
+    Properties* config = getConfig()->getNamespace("benchmark", true);
+    if (config)
+    {
+        if (config->exists("repetitions"))
+            _repetitions = std::max(config->getInt("repetitions"), 1);
+        if (config->exists("physicsFrames"))
+            _physicsFrames = std::max(config->getInt("physicsFrames"), 1);
+    }
+
+    benchmarkMath();
+    benchmarkCurve();
+    benchmarkNodes();
+    benchmarkBundle();
+    benchmarkProperties();
+    benchmarkParticles();
+    benchmarkSkin();
+    benchmarkFont();
+
+    // Physics is stepped by the game, so it is measured over the following frames.
+    createPhysicsScene();
+    Profiler::setEnabled(true);
+}
+
+void BenchmarkGame::finalize()
+{
+    SAFE_RELEASE(_physicsScene);
+}
+
+void BenchmarkGame::update(float elapsedTime)
+{
+    // The profiler reports the last completed frame, so the first frame has nothing to read yet.
+    if (_frame++ > 0 && _physicsSamples.size() < _physicsFrames)
+    {
+        _physicsSamples.push_back(Profiler::getZoneTime("PhysicsController::update"));
+        if (_physicsSamples.size() == _physicsFrames)
+        {
+            addResult("PhysicsController::update", 1, _physicsSamples);
+            writeResults();
+            exit();
+        }
+    }
+}
+
+void BenchmarkGame::render(float elapsedTime)
+{
+    clear(CLEAR_COLOR_DEPTH, Vector4::zero(), 1.0f, 0);
+}
+
+template<class Function>
+void BenchmarkGame::run(const char* name, unsigned int iterations, Function function)
+{
+    // Warm up caches and lazily created state first.
+    function(0);
+
+    std::vector<double> samples;
+    for (unsigned int r = 0; r < _repetitions; ++r)
+    {
+        double start = getTime();
+        for (unsigned int i = 0; i < iterations; ++i)
+        {
+            function(i);
+        }
+        samples.push_back((getTime() - start) / iterations);
+    }
+    addResult(name, iterations, samples);
+}
+
+void BenchmarkGame::addResult(const char* name, unsigned int iterations, std::vector<double>& samples)
+{
+    GP_ASSERT(!samples.empty());
+
+    std::sort(samples.begin(), samples.end());
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.repetitions = (unsigned int)samples.size();
+    result.minimum = samples.front();
+    result.median = samples[samples.size() / 2];
+    _results.push_back(result);
+
+    GP_WARN("%s: %f ms (min), %f ms (median)", name, result.minimum, result.median);
+}
+
+void BenchmarkGame::benchmarkMath()
+{
+    Matrix a, b, c;
+    Matrix::createRotation(Vector3(1.0f, 2.0f, 3.0f).normalize(), 0.5f, &a);
+    a.translate(1.0f, 2.0f, 3.0f);
+    Matrix::createRotation(Vector3(3.0f, 2.0f, 1.0f).normalize(), 0.25f, &b);
+
+    run("Matrix::multiply", 100000, [&](unsigned int i)
+    {
+        b.m[12] = (float)i;
+        Matrix::multiply(a, b, &c);
+        _sink += c.m[12];
+    });
+    run("Matrix::invert", 100000, [&](unsigned int i)
+    {
+        a.m[12] = (float)i;
+        a.invert(&c);
+        _sink += c.m[12];
+    });
+    run("Matrix::transformPoint", 100000, [&](unsigned int i)
+    {
+        Vector3 point((float)i, 1.0f, 2.0f);
+        a.transformPoint(&point);
+        _sink += point.x;
+    });
+    run("Vector3::cross", 100000, [&](unsigned int i)
+    {
+        Vector3 v;
+        Vector3::cross(Vector3((float)i, 1.0f, 0.0f), Vector3(0.0f, 1.0f, 1.0f), &v);
+        _sink += v.normalize().x;
+    });
+
+    Quaternion q1, q2, q;
+    Quaternion::createFromAxisAngle(Vector3::unitY(), 0.5f, &q1);
+    Quaternion::createFromAxisAngle(Vector3::unitX(), 2.0f, &q2);
+    run("Quaternion::multiply", 100000, [&](unsigned int i)
+    {
+        q2.w = (float)i;
+        Quaternion::multiply(q1, q2, &q);
+        _sink += q.w;
+    });
+    run("Quaternion::slerp", 100000, [&](unsigned int i)
+    {
+        Quaternion::slerp(q1, q2, (i % 100) * 0.01f, &q);
+        _sink += q.w;
+    });
+}
+
+void BenchmarkGame::benchmarkCurve()
+{
+    const unsigned int pointCount = 16;
+    Curve* linear = Curve::create(pointCount, 4);
+    Curve* bezier = Curve::create(pointCount, 4);
+    for (unsigned int i = 0; i < pointCount; ++i)
+    {
+        float time = (float)i / (pointCount - 1);
+        float value[4];
+        float in[4];
+        float out[4];
+        for (unsigned int j = 0; j < 4; ++j)
+        {
+            value[j] = sinf(time * (j + 1));
+            in[j] = -0.5f;
+            out[j] = 0.5f;
+        }
+        linear->setPoint(i, time, value, Curve::LINEAR);
+        bezier->setPoint(i, time, value, Curve::BEZIER, in, out);
+    }
+
+    float dst[4];
+    run("Curve::evaluate (linear)", 100000, [&](unsigned int i)
+    {
+        linear->evaluate((i % 1000) * 0.001f, dst);
+        _sink += dst[0];
+    });
+    run("Curve::evaluate (bezier)", 100000, [&](unsigned int i)
+    {
+        bezier->evaluate((i % 1000) * 0.001f, dst);
+        _sink += dst[0];
+    });
+
+    SAFE_RELEASE(linear);
+    SAFE_RELEASE(bezier);
+}
+
+void BenchmarkGame::benchmarkNodes()
+{
+    // A root with 32 children of 32 leaves each.
+    Node* root = Node::create("root");
+    std::vector<Node*> leaves;
+    for (unsigned int i = 0; i < 32; ++i)
+    {
+        Node* child = Node::create();
+        child->setTranslation((float)i, 0.0f, 0.0f);
+        root->addChild(child);
+        for (unsigned int j = 0; j < 32; ++j)
+        {
+            Node* leaf = Node::create();
+            leaf->setTranslation(0.0f, (float)j, 0.0f);
+            child->addChild(leaf);
+            leaves.push_back(leaf);
+            SAFE_RELEASE(leaf);
+        }
+        SAFE_RELEASE(child);
+    }
+
+    run("Node::getWorldMatrix", 100, [&](unsigned int i)
+    {
+        root->rotateY(0.01f);
+        for (size_t j = 0, count = leaves.size(); j < count; ++j)
+        {
+            _sink += leaves[j]->getWorldMatrix().m[12];
+        }
+    });
+
+    SAFE_RELEASE(root);
+}
+
+void BenchmarkGame::benchmarkBundle()
+{
+    run("Bundle::loadScene", 3, [&](unsigned int i)
+    {
+        Bundle* bundle = Bundle::create(REFERENCE_BUNDLE);
+        if (bundle)
+        {
+            Scene* scene = bundle->loadScene();
+            SAFE_RELEASE(scene);
+            SAFE_RELEASE(bundle);
+        }
+    });
+}
+
+void BenchmarkGame::benchmarkProperties()
+{
+    run("Properties::create", 100, [&](unsigned int i)
+    {
+        Properties* properties = Properties::create(REFERENCE_PROPERTIES);
+        SAFE_DELETE(properties);
+    });
+}
+
+void BenchmarkGame::benchmarkParticles()
+{
+    ParticleEmitter* emitter = ParticleEmitter::create(REFERENCE_PARTICLE);
+    if (!emitter)
+        return;
+
+    Node* node = Node::create();
+    node->setDrawable(emitter);
+    emitter->start();
+
+    // Fill the emitter before measuring.
+    for (unsigned int i = 0; i < 100; ++i)
+    {
+        emitter->update(FRAME_TIME);
+    }
+
+    run("ParticleEmitter::update", 1000, [&](unsigned int i)
+    {
+        emitter->update(FRAME_TIME);
+    });
+
+    SAFE_RELEASE(emitter);
+    SAFE_RELEASE(node);
+}
+
+void BenchmarkGame::benchmarkSkin()
+{
+    Bundle* bundle = Bundle::create(REFERENCE_BUNDLE);
+    if (!bundle)
+        return;
+
+    Scene* scene = bundle->loadScene();
+    SAFE_RELEASE(bundle);
+    if (!scene)
+        return;
+
+    MeshSkin* skin = findSkin(scene->getFirstNode());
+    if (skin && skin->getRootJoint())
+    {
+        run("MeshSkin::getMatrixPalette", 10000, [&](unsigned int i)
+        {
+            skin->getRootJoint()->rotateY(0.01f);
+            _sink += skin->getMatrixPalette()[0].x;
+        });
+    }
+
+    SAFE_RELEASE(scene);
+}
+
+void BenchmarkGame::benchmarkFont()
+{
+    Font* font = Font::create(REFERENCE_FONT);
+    if (!font)
+        return;
+
+    const char* text =
+        "The quick brown fox jumps over the lazy dog.\n"
+        "Pack my box with five dozen liquor jugs.\n"
+        "How vexingly quick daft zebras jump!\n"
+        "Sphinx of black quartz, judge my vow.";
+    const Rectangle clip(0.0f, 0.0f, 200.0f, 400.0f);
+
+    run("Font::measureText", 10000, [&](unsigned int i)
+    {
+        unsigned int width;
+        unsigned int height;
+        font->measureText(text, font->getSize(), &width, &height);
+        _sink += (float)width;
+    });
+    run("Font::measureText (wrapped)", 10000, [&](unsigned int i)
+    {
+        Rectangle out;
+        font->measureText(text, clip, font->getSize(), &out, Font::ALIGN_TOP_LEFT, true, false);
+        _sink += out.height;
+    });
+
+    SAFE_RELEASE(font);
+}
+
+void BenchmarkGame::createPhysicsScene()
+{
+    _physicsScene = Scene::create();
+
+    Node* ground = _physicsScene->addNode("ground");
+    PhysicsRigidBody::Parameters groundParams;
+    ground->setCollisionObject(PhysicsCollisionObject::RIGID_BODY,
+        PhysicsCollisionShape::box(Vector3(100.0f, 1.0f, 100.0f), Vector3::zero(), true), &groundParams);
+
+    // Stacks of boxes that fall onto the ground and come to rest on each other.
+    PhysicsRigidBody::Parameters boxParams(1.0f);
+    for (unsigned int i = 0; i < PHYSICS_BODY_COUNT; ++i)
+    {
+        Node* box = _physicsScene->addNode();
+        box->setTranslation((float)(i % 16) * 2.5f - 20.0f, 2.0f + (float)(i / 16) * 2.5f, 0.0f);
+        box->setCollisionObject(PhysicsCollisionObject::RIGID_BODY,
+            PhysicsCollisionShape::box(Vector3::one(), Vector3::zero(), true), &boxParams);
+    }
+}
+
+bool BenchmarkGame::writeResults()
+{
+    const char* path = "benchmark.json";
+    Properties* config = getConfig()->getNamespace("benchmark", true);
+    if (config && config->getString("output"))
+        path = config->getString("output");
+
+    std::unique_ptr<Stream> stream(FileSystem::open(path, FileSystem::WRITE));
+    if (stream.get() == NULL)
+    {
+        GP_ERROR("Failed to open file '%s' for writing benchmark results.", path);
+        return false;
+    }
+
+    // Times are reported per iteration, in milliseconds.
+    std::ostringstream json;
+    json << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0, count = _results.size(); i < count; ++i)
+    {
+        const Result& result = _results[i];
+        json << "    { \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations
+             << ", \"repetitions\": " << result.repetitions << ", \"min\": " << result.minimum
+             << ", \"median\": " << result.median << " }" << (i + 1 < count ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+
+    std::string data = json.str();
+    stream->write(data.c_str(), 1, data.size());
+    stream->close();
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef BENCHMARKGAME_H_
+#define BENCHMARKGAME_H_
+
+#include "gameplay.h"
+
+using namespace gameplay;
+
+/**
+ * Measures the hot paths of the engine and writes the results as JSON.
+ *
+ * The micro benchmarks run during initialize and time a fixed number of
+ * iterations of a single operation, repeated several times. The physics
+ * benchmark runs over a fixed number of frames and reads the time spent
+ * stepping the simulation from the profiler. Once all benchmarks are done
+ * the results are written to the file set by the 'output' property of the
+ * 'benchmark' namespace of game.config and the game exits.
+ */
+class BenchmarkGame: public Game
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    BenchmarkGame();
+
+protected:
+
+    /**
+     * @see Game::initialize
+     */
+    void initialize();
+
+    /**
+     * @see Game::finalize
+     */
+    void finalize();
+
+    /**
+     * @see Game::update
+     */
+    void update(float elapsedTime);
+
+    /**
+     * @see Game::render
+     */
+    void render(float elapsedTime);
+
+private:
+
+    struct Result
+    {
+        std::string name;
+        unsigned int iterations;
+        unsigned int repetitions;
+        double minimum;
+        double median;
+    };
+
+    template<class Function>
+    void run(const char* name, unsigned int iterations, Function function);
+
+    void addResult(const char* name, unsigned int iterations, std::vector<double>& samples);
+
+    void benchmarkMath();
+
+    void benchmarkCurve();
+
+    void benchmarkNodes();
+
+    void benchmarkBundle();
+
+    void benchmarkProperties();
+
+    void benchmarkParticles();
+
+    void benchmarkSkin();
+
+    void benchmarkFont();
+
+    void createPhysicsScene();
+
+    bool writeResults();
+
+    std::vector<Result> _results;
+    unsigned int _repetitions;
+    unsigned int _physicsFrames;
+    std::vector<double> _physicsSamples;
+    Scene* _physicsScene;
+    unsigned int _frame;
+    float _sink;
+};
+
+#endif
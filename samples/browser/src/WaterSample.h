@@ -45,7 +45,7 @@ private:
     Font* _font;
     Scene* _scene;
     Node* _cameraNode;
-    Node* _reflectCameraNode;
+    Node* _waterNode;
 
     Vector3 _cameraAcceleration;
     float _waterHeight;
@@ -55,7 +55,7 @@ private:
 
     FrameBuffer* _refractBuffer;
     SpriteBatch* _refractBatch;
-    FrameBuffer* _reflectBuffer;
+    PlanarReflection* _reflection;
     SpriteBatch* _reflectBatch;
 
     bool _showBuffers;
@@ -16,6 +16,8 @@ SOURCES += src/Mesh.cpp \
     src/Animation.cpp \
     src/Animations.cpp \
     src/Base.cpp \
+    src/BatchEncoder.cpp \
+    src/BuildCache.cpp \
     src/BoundingVolume.cpp \
     src/Camera.cpp \
     src/Constants.cpp \
@@ -35,22 +37,27 @@ SOURCES += src/Mesh.cpp \
     src/Light.cpp \
     src/main.cpp \
     src/Material.cpp \
+    src/MaterialAtlas.cpp \
     src/MaterialParameter.cpp \
     src/Matrix.cpp \
     src/MeshPart.cpp \
     src/MeshSkin.cpp \
     src/MeshSubSet.cpp \
     src/Model.cpp \
+    src/NavMeshGenerator.cpp \
     src/Node.cpp \
     src/NormalMapGenerator.cpp \
     src/Object.cpp \
+    src/PackEncoder.cpp \
     src/Quaternion.cpp \
     src/Reference.cpp \
     src/ReferenceTable.cpp \
     src/Sampler.cpp \
     src/Scene.cpp \
+    src/ScriptEncoder.cpp \
     src/StringUtil.cpp \
     src/Transform.cpp \
+    src/TextureEncoder.cpp \
     src/TTFFontEncoder.cpp \
     src/TMXSceneEncoder.cpp \
     src/TMXTypes.cpp \
@@ -65,6 +72,8 @@ HEADERS += src/AnimationChannel.h \
     src/Animation.h \
     src/Animations.h \
     src/Base.h \
+    src/BatchEncoder.h \
+    src/BuildCache.h \
     src/BoundingVolume.h \
     src/Camera.h \
     src/Constants.h \
@@ -84,6 +93,7 @@ HEADERS += src/AnimationChannel.h \
     src/Image.h \
     src/Light.h \
     src/Material.h \
+    src/MaterialAtlas.h \
     src/MaterialParameter.h \
     src/Matrix.h \
     src/Mesh.h \
@@ -91,16 +101,20 @@ HEADERS += src/AnimationChannel.h \
     src/MeshSkin.h \
     src/MeshSubSet.h \
     src/Model.h \
+    src/NavMeshGenerator.h \
     src/Node.h \
     src/NormalMapGenerator.h \
     src/Object.h \
+    src/PackEncoder.h \
     src/Quaternion.h \
     src/Quaternion.inl \
     src/Reference.h \
     src/ReferenceTable.h \
     src/Sampler.h \
     src/Scene.h \
+    src/ScriptEncoder.h \
     src/StringUtil.h \
+    src/TextureEncoder.h \
     src/Thread.h \
     src/Transform.h \
     src/TTFFontEncoder.h \
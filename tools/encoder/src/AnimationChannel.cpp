@@ -1,6 +1,7 @@
 #include "Base.h"
 #include "AnimationChannel.h"
 #include "Transform.h"
+#include "Quaternion.h"
 
 namespace gameplay
 {
@@ -29,14 +30,15 @@ void AnimationChannel::writeBinary(FILE* file)
     write(_targetId, file);
     write(_targetAttrib, file);
     write((unsigned int)_keytimes.size(), file);
+    writePadding(4, file);
     for (std::vector<float>::const_iterator i = _keytimes.begin(); i != _keytimes.end(); ++i)
     {
         write((unsigned int)*i, file);
     }
-    write(_keyValues, file);
-    write(_tangentsIn, file);
-    write(_tangentsOut, file);
-    write(_interpolations, file);
+    writeAligned(_keyValues, file);
+    writeAligned(_tangentsIn, file);
+    writeAligned(_tangentsOut, file);
+    writeAligned(_interpolations, file);
 }
 
 void AnimationChannel::writeText(FILE* file)
@@ -175,6 +177,125 @@ void AnimationChannel::removeDuplicates()
     LOG(3, "      Removed %d duplicate keyframes from channel.\n", startCount- _keytimes.size());
 }
 
+void AnimationChannel::reduceKeys(float tolerance)
+{
+    size_t propSize = Transform::getPropertySize(_targetAttrib);
+    size_t keyCount = _keytimes.size();
+    if (keyCount < 3 || _interpolations.empty())
+        return;
+    for (size_t i = 0, count = _interpolations.size(); i < count; ++i)
+    {
+        if (_interpolations[i] != LINEAR)
+            return;
+    }
+
+    bool rotation = false;
+    switch (_targetAttrib)
+    {
+    case Transform::ANIMATE_ROTATE:
+        rotation = true;
+        break;
+    case Transform::ANIMATE_SCALE:
+    case Transform::ANIMATE_SCALE_X:
+    case Transform::ANIMATE_SCALE_Y:
+    case Transform::ANIMATE_SCALE_Z:
+    case Transform::ANIMATE_TRANSLATE:
+    case Transform::ANIMATE_TRANSLATE_X:
+    case Transform::ANIMATE_TRANSLATE_Y:
+    case Transform::ANIMATE_TRANSLATE_Z:
+        break;
+    default:
+        // Channels that mix rotations with other properties are left untouched.
+        return;
+    }
+
+    LOG(3, "      Reducing keyframes for channel with target attribute: %u.\n", _targetAttrib);
+
+    // Extend the span from the last kept key for as long as all of the skipped keys stay within tolerance.
+    std::vector<bool> keep(keyCount, false);
+    keep[0] = true;
+    keep[keyCount - 1] = true;
+    size_t prevIndex = 0;
+    for (size_t i = 2; i < keyCount; ++i)
+    {
+        if (getInterpolationError(prevIndex, i, propSize, rotation) > tolerance)
+        {
+            prevIndex = i - 1;
+            keep[prevIndex] = true;
+        }
+    }
+
+    std::vector<float> keyTimes;
+    std::vector<float> keyValues;
+    std::vector<unsigned int> interpolations;
+    for (size_t i = 0; i < keyCount; ++i)
+    {
+        if (!keep[i])
+            continue;
+        keyTimes.push_back(_keytimes[i]);
+        keyValues.insert(keyValues.end(), _keyValues.begin() + i * propSize, _keyValues.begin() + (i + 1) * propSize);
+        if (_interpolations.size() > 1)
+            interpolations.push_back(_interpolations[i]);
+    }
+    if (_interpolations.size() > 1)
+        _interpolations.swap(interpolations);
+    _keytimes.swap(keyTimes);
+    _keyValues.swap(keyValues);
+
+    LOG(3, "      Removed %d keyframes within tolerance from channel.\n", (int)(keyCount - _keytimes.size()));
+}
+
+void AnimationChannel::quantize(unsigned int mantissaBits)
+{
+    const float scale = (float)(1 << mantissaBits);
+    for (size_t i = 0, count = _keyValues.size(); i < count; ++i)
+    {
+        int exponent;
+        float mantissa = frexpf(_keyValues[i], &exponent);
+        _keyValues[i] = ldexpf(floorf(mantissa * scale + 0.5f) / scale, exponent);
+    }
+}
+
+float AnimationChannel::getInterpolationError(size_t begin, size_t end, size_t propSize, bool rotation) const
+{
+    const float startTime = _keytimes[begin];
+    const float duration = _keytimes[end] - startTime;
+    const float* a = &_keyValues[begin * propSize];
+    const float* b = &_keyValues[end * propSize];
+    Quaternion qa, qb;
+    if (rotation)
+    {
+        qa.set(a[0], a[1], a[2], a[3]);
+        qb.set(b[0], b[1], b[2], b[3]);
+        qa.normalize();
+        qb.normalize();
+    }
+
+    float error = 0.0f;
+    for (size_t i = begin + 1; i < end; ++i)
+    {
+        float t = duration > 0.0f ? (_keytimes[i] - startTime) / duration : 0.0f;
+        const float* value = &_keyValues[i * propSize];
+        if (rotation)
+        {
+            Quaternion q;
+            Quaternion::slerp(qa, qb, t, &q);
+            Quaternion key(value[0], value[1], value[2], value[3]);
+            key.normalize();
+            float dot = std::fabs(q.x * key.x + q.y * key.y + q.z * key.z + q.w * key.w);
+            error = std::max(error, 2.0f * acosf(std::min(dot, 1.0f)));
+        }
+        else
+        {
+            for (size_t j = 0; j < propSize; ++j)
+            {
+                error = std::max(error, std::fabs(a[j] + (b[j] - a[j]) * t - value[j]));
+            }
+        }
+    }
+    return error;
+}
+
 unsigned int AnimationChannel::getInterpolationType(const char* str)
 {
     unsigned int value = 0;
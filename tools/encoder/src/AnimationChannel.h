@@ -65,6 +65,29 @@ public:
      */
     void removeDuplicates();
 
+    /**
+     * Removes key frames that can be reconstructed from their neighbours within the given tolerance.
+     *
+     * Keys are removed greedily: a key is only kept when linearly interpolating between the
+     * previously kept key and the next key would move one of the skipped keys further than
+     * the tolerance. Rotation channels are compared by the angle between the quaternions, in
+     * radians, and all other channels by the largest difference of any component.
+     * Only channels with linear interpolation and a single kind of property are reduced.
+     *
+     * @param tolerance The maximum error allowed for the removed key frames.
+     */
+    void reduceKeys(float tolerance);
+
+    /**
+     * Rounds every key value to the given number of mantissa bits.
+     *
+     * Values that only differ by noise become equal, which allows more key frames to be
+     * removed and makes the key values compress better.
+     *
+     * @param mantissaBits The number of mantissa bits to keep.
+     */
+    void quantize(unsigned int mantissaBits);
+
     /**
      * Returns the interpolation type value for the given string or zero if not valid.
      * Example: "LINEAR" returns AnimationChannel::LINEAR
@@ -86,6 +109,17 @@ private:
      */
     void deleteRange(size_t begin, size_t end, size_t propSize);
 
+    /**
+     * Returns the largest error of the key frames between the given keys when they are
+     * reconstructed by linearly interpolating the two keys.
+     *
+     * @param begin The index of the first key.
+     * @param end The index of the last key.
+     * @param propSize The size of the animation property.
+     * @param rotation True if the key values are quaternions.
+     */
+    float getInterpolationError(size_t begin, size_t end, size_t propSize, bool rotation) const;
+
 private:
 
     std::string _targetId;
@@ -0,0 +1,264 @@
+#include "Base.h"
+#include "BatchEncoder.h"
+#include "StringUtil.h"
+
+#ifdef WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #define mkdir(path, mode) _mkdir(path)
+    #define NULL_DEVICE "NUL"
+#else
+    #include <dirent.h>
+    #define NULL_DEVICE "/dev/null"
+#endif
+
+namespace gameplay
+{
+
+/**
+ * Creates the given directory and any of its parents that don't exist yet.
+ */
+static void createDirectories(const std::string& path)
+{
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1))
+    {
+        mkdir(path.substr(0, pos).c_str(), 0777);
+    }
+    mkdir(path.c_str(), 0777);
+}
+
+/**
+ * Returns the argument quoted for the command line of the encoder.
+ */
+static std::string quote(const std::string& argument)
+{
+    return "\"" + argument + "\"";
+}
+
+/**
+ * Returns true if the encoder can encode the file without options that name its contents.
+ */
+static bool isEncodable(const std::string& name)
+{
+    return endsWith(name, ".fbx") || endsWith(name, ".tmx") || endsWith(name, ".ttf") ||
+        endsWith(name, ".otf") || endsWith(name, ".lua");
+}
+
+BatchEncoder::BatchEncoder()
+{
+}
+
+BatchEncoder::~BatchEncoder()
+{
+}
+
+void BatchEncoder::addFiles(const std::string& directory, const std::string& output)
+{
+    std::vector<std::string> names;
+    std::vector<std::string> directories;
+#ifdef WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "/*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        std::string name(data.cFileName);
+        if (name == "." || name == "..")
+            continue;
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+            directories.push_back(name);
+        else
+            names.push_back(name);
+    } while (FindNextFileA(find, &data) != 0);
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return;
+    struct dirent* dp;
+    while ((dp = readdir(dir)) != NULL)
+    {
+        std::string name(dp->d_name);
+        if (name == "." || name == "..")
+            continue;
+        struct stat buf;
+        if (stat((directory + "/" + name).c_str(), &buf) != 0)
+            continue;
+        if (S_ISDIR(buf.st_mode))
+            directories.push_back(name);
+        else
+            names.push_back(name);
+    }
+    closedir(dir);
+#endif
+
+    // Sort the names so that batches run in the same order on every platform.
+    std::sort(names.begin(), names.end());
+    std::sort(directories.begin(), directories.end());
+    for (size_t i = 0, count = names.size(); i < count; ++i)
+    {
+        if (isEncodable(names[i]))
+            addJob(directory + "/" + names[i], output);
+    }
+    for (size_t i = 0, count = directories.size(); i < count; ++i)
+    {
+        addFiles(directory + "/" + directories[i], output + "/" + directories[i]);
+    }
+}
+
+bool BatchEncoder::addManifest(const std::string& manifest, const std::string& output)
+{
+    std::ifstream file(manifest.c_str());
+    if (!file)
+    {
+        LOG(1, "Error: Failed to open manifest: %s\n", manifest.c_str());
+        return false;
+    }
+
+    size_t pos = manifest.find_last_of('/');
+    std::string directory = pos == std::string::npos ? std::string(".") : manifest.substr(0, pos);
+    std::string line;
+    while (std::getline(file, line))
+    {
+        // Trim whitespace, including the carriage returns of manifests written on Windows.
+        size_t first = line.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+        std::string path = line.substr(first, line.find_last_not_of(" \t\r\n") - first + 1);
+        for (size_t i = 0; i < path.size(); ++i)
+        {
+            if (path[i] == '\\')
+                path[i] = '/';
+        }
+
+        bool absolute = path[0] == '/' || (path.size() > 1 && path[1] == ':');
+        size_t slash = path.find_last_of('/');
+        std::string relativeDirectory = (absolute || slash == std::string::npos) ? std::string() : "/" + path.substr(0, slash);
+        addJob(absolute ? path : directory + "/" + path, output + relativeDirectory);
+    }
+    return true;
+}
+
+void BatchEncoder::addJob(const std::string& input, const std::string& outputDirectory)
+{
+    // The log keeps the extension of the input, so that a font and a scene of the same name don't share one.
+    size_t slash = input.find_last_of('/');
+    std::string name = slash == std::string::npos ? input : input.substr(slash + 1);
+
+    Job job;
+    job.input = input;
+    job.outputDirectory = outputDirectory;
+    job.log = outputDirectory + "/" + name + ".log";
+    job.result = false;
+    _jobs.push_back(job);
+}
+
+bool BatchEncoder::write(const std::string& executable, const std::string& input, const std::string& output,
+                         const std::vector<std::string>& options, unsigned int threadCount)
+{
+    _jobs.clear();
+    struct stat buf;
+    if (stat(input.c_str(), &buf) == 0 && (buf.st_mode & S_IFDIR) != 0)
+    {
+        addFiles(input, output);
+    }
+    else if (!addManifest(input, output))
+    {
+        return false;
+    }
+    if (_jobs.empty())
+    {
+        LOG(1, "Warning: No files to encode found in: %s\n", input.c_str());
+        return true;
+    }
+
+    _command = quote(executable);
+    for (size_t i = 0, count = options.size(); i < count; ++i)
+    {
+        _command += " " + (options[i][0] == '-' ? options[i] : quote(options[i]));
+    }
+
+    if (threadCount == 0)
+        threadCount = getProcessorCount();
+    threadCount = std::min(threadCount, (unsigned int)_jobs.size());
+    LOG(1, "Encoding %u files on %u threads.\n", (unsigned int)_jobs.size(), threadCount);
+
+    // Each thread takes the next job that no thread has started yet, so that a few
+    // large files don't hold up the rest.
+    ThreadData data;
+    data.encoder = this;
+    data.next = 0;
+    data.finished = 0;
+    createMutex(&data.mutex);
+    time_t start = time(NULL);
+    THREAD_HANDLE* threads = new THREAD_HANDLE[threadCount];
+    unsigned int started = 0;
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        if (!createThread(&threads[i], &encodeJobs, &data))
+        {
+            LOG(1, "Error: Failed to spawn worker thread for encoding files.\n");
+            break;
+        }
+        ++started;
+    }
+    if (started == 0)
+        encodeJobs(&data);
+
+    // Wait for all threads to terminate
+    waitForThreads(started, threads);
+    for (unsigned int i = 0; i < started; ++i)
+        closeThread(threads[i]);
+    delete[] threads;
+    destroyMutex(&data.mutex);
+
+    unsigned int written = 0;
+    for (size_t i = 0, count = _jobs.size(); i < count; ++i)
+    {
+        if (_jobs[i].result)
+            ++written;
+        else
+            LOG(1, "Failed: %s (see %s)\n", _jobs[i].input.c_str(), _jobs[i].log.c_str());
+    }
+    LOG(1, "Encoded %u of %u files in %d seconds.\n", written, (unsigned int)_jobs.size(), (int)difftime(time(NULL), start));
+    return written == _jobs.size();
+}
+
+int BatchEncoder::encodeJobs(void* data)
+{
+    ThreadData* threadData = static_cast<ThreadData*>(data);
+    std::vector<Job>& jobs = threadData->encoder->_jobs;
+    while (true)
+    {
+        lockMutex(&threadData->mutex);
+        size_t i = threadData->next++;
+        unlockMutex(&threadData->mutex);
+        if (i >= jobs.size())
+            break;
+
+        jobs[i].result = threadData->encoder->encode(jobs[i]);
+
+        lockMutex(&threadData->mutex);
+        size_t finished = ++threadData->finished;
+        LOG(2, "[%u/%u] %s %s\n", (unsigned int)finished, (unsigned int)jobs.size(), jobs[i].result ? "Encoded" : "Failed", jobs[i].input.c_str());
+        unlockMutex(&threadData->mutex);
+    }
+    return 0;
+}
+
+bool BatchEncoder::encode(const Job& job) const
+{
+    createDirectories(job.outputDirectory);
+
+    // The encoder prompts for missing font sizes, so input comes from the null device to not block the batch.
+    std::string command = _command + " " + quote(job.input) + " " + quote(job.outputDirectory + "/") +
+        " < " NULL_DEVICE " > " + quote(job.log) + " 2>&1";
+#ifdef WIN32
+    // cmd.exe strips the first and last quotes of a command that starts with one.
+    command = "\"" + command + "\"";
+#endif
+    return system(command.c_str()) == 0;
+}
+
+}
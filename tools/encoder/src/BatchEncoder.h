@@ -0,0 +1,106 @@
+#ifndef BATCHENCODER_H_
+#define BATCHENCODER_H_
+
+#include "Thread.h"
+
+namespace gameplay
+{
+
+/**
+ * Encodes many files in parallel, such as all of the assets of a game.
+ *
+ * The input is either a directory, in which case every FBX, TMX, TTF, OTF and Lua file in it
+ * and in its subdirectories is encoded, or a manifest that lists one path per line relative to
+ * the manifest. Lines that are empty or start with '#' are skipped.
+ *
+ * Each file is encoded by a separate run of the encoder, because the scene and font encoders
+ * keep their state in globals and the FBX SDK is not thread safe. A pool of threads keeps the
+ * given number of runs going at a time. The output of each run goes to a .log file next to the
+ * file it writes, and a summary lists the files that failed.
+ */
+class BatchEncoder
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    BatchEncoder();
+
+    /**
+     * Destructor.
+     */
+    ~BatchEncoder();
+
+    /**
+     * Encodes the files of a directory or manifest.
+     *
+     * @param executable The path of the encoder executable.
+     * @param input The directory or manifest of the files to encode.
+     * @param output The directory to write the files into, under the same relative paths.
+     * @param options The options to encode each file with.
+     * @param threadCount The number of files to encode at the same time, or zero for one per processor.
+     *
+     * @return True if every file was encoded; false otherwise.
+     */
+    bool write(const std::string& executable, const std::string& input, const std::string& output,
+               const std::vector<std::string>& options, unsigned int threadCount);
+
+private:
+
+    /**
+     * A file to encode, which is the work done by one run of the encoder.
+     */
+    struct Job
+    {
+        std::string input;
+        std::string outputDirectory;
+        std::string log;
+        bool result;
+    };
+
+    /**
+     * The state that the threads of the pool share.
+     */
+    struct ThreadData
+    {
+        BatchEncoder* encoder;
+        MUTEX_HANDLE mutex;
+        size_t next;
+        size_t finished;
+    };
+
+    /**
+     * Adds a job for every file of a directory and its subdirectories that the encoder can encode.
+     */
+    void addFiles(const std::string& directory, const std::string& output);
+
+    /**
+     * Adds a job for every file listed in a manifest.
+     */
+    bool addManifest(const std::string& manifest, const std::string& output);
+
+    /**
+     * Adds a job that writes the file into the given output directory.
+     */
+    void addJob(const std::string& input, const std::string& outputDirectory);
+
+    /**
+     * Runs jobs until there are none left. This is the entry point of each thread of the pool.
+     *
+     * @param data The ThreadData of the pool.
+     */
+    static int encodeJobs(void* data);
+
+    /**
+     * Runs the encoder for the given job and returns true if it succeeded.
+     */
+    bool encode(const Job& job) const;
+
+    std::string _command;
+    std::vector<Job> _jobs;
+};
+
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include "Base.h"
+#include "BuildCache.h"
+#include "EncoderArguments.h"
+#include "GPBFile.h"
+
+// The 64-bit FNV-1a offset basis and prime.
+#define FNV_OFFSET_BASIS 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+namespace gameplay
+{
+
+static BuildCache* __instance = NULL;
+
+BuildCache::BuildCache(const EncoderArguments& arguments) :
+    _output(arguments.getOutputFilePath()),
+    _record(arguments.getOutputFilePath() + ".cache"),
+    _key(0),
+    _startTime(time(NULL))
+{
+    __instance = this;
+
+    // The key covers everything that decides the contents of the output other than the files it
+    // references. Verbosity only changes what is logged, so it is left out.
+    unsigned long long h = FNV_OFFSET_BASIS;
+    const char* version = EncoderArguments::getVersion();
+    h = hash(version, strlen(version) + 1, h);
+    h = hash(GPB_VERSION, sizeof(GPB_VERSION), h);
+    const std::vector<std::string>& options = arguments.getOptions();
+    for (size_t i = 0, count = options.size(); i < count; ++i)
+    {
+        if (options[i] == "-incremental")
+            continue;
+        if (options[i] == "-v")
+        {
+            ++i;
+            continue;
+        }
+        h = hash(options[i].c_str(), options[i].size() + 1, h);
+    }
+    unsigned long long input = hashFile(arguments.getFilePath());
+    _key = input ? hash(&input, sizeof(input), h) : 0;
+}
+
+BuildCache::~BuildCache()
+{
+    if (__instance == this)
+        __instance = NULL;
+}
+
+BuildCache* BuildCache::getInstance()
+{
+    return __instance;
+}
+
+void BuildCache::addDependency(const std::string& path)
+{
+    if (__instance && std::find(__instance->_dependencies.begin(), __instance->_dependencies.end(), path) == __instance->_dependencies.end())
+        __instance->_dependencies.push_back(path);
+}
+
+bool BuildCache::isUpToDate() const
+{
+    struct stat buf;
+    if (_key == 0 || stat(_output.c_str(), &buf) != 0)
+        return false;
+
+    std::ifstream file(_record.c_str());
+    if (!file)
+        return false;
+
+    // The first line is the key, and each line after it is the hash and path of a dependency.
+    std::string line;
+    if (!std::getline(file, line) || strtoull(line.c_str(), NULL, 16) != _key)
+        return false;
+    while (std::getline(file, line))
+    {
+        size_t space = line.find(' ');
+        if (space == std::string::npos)
+            return false;
+        std::string path = line.substr(space + 1);
+        if (strtoull(line.c_str(), NULL, 16) != hashFile(path))
+        {
+            LOG(2, "Dependency changed: %s\n", path.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BuildCache::write() const
+{
+    if (_key == 0)
+        return false;
+
+    // The scene encoders don't report failures, so an output that wasn't written during this run
+    // must be one left over from an earlier one.
+    struct stat buf;
+    if (stat(_output.c_str(), &buf) != 0 || buf.st_mtime < _startTime)
+    {
+        remove(_record.c_str());
+        return false;
+    }
+
+    FILE* file = fopen(_record.c_str(), "w");
+    if (!file)
+    {
+        LOG(1, "Warning: Failed to write build cache: %s\n", _record.c_str());
+        return false;
+    }
+    fprintf(file, "%016llx\n", _key);
+    for (size_t i = 0, count = _dependencies.size(); i < count; ++i)
+    {
+        fprintf(file, "%016llx %s\n", hashFile(_dependencies[i]), _dependencies[i].c_str());
+    }
+    fclose(file);
+    return true;
+}
+
+unsigned long long BuildCache::hashFile(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file)
+        return 0;
+
+    unsigned long long h = FNV_OFFSET_BASIS;
+    unsigned char buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        h = hash(buffer, read, h);
+    }
+    fclose(file);
+    return h;
+}
+
+unsigned long long BuildCache::hash(const void* data, size_t size, unsigned long long h)
+{
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; ++i)
+    {
+        h ^= bytes[i];
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+}
@@ -0,0 +1,85 @@
+#ifndef BUILDCACHE_H_
+#define BUILDCACHE_H_
+
+namespace gameplay
+{
+
+class EncoderArguments;
+
+/**
+ * Records what an output was built from, so that an incremental build can skip inputs that
+ * haven't changed since they were last encoded.
+ *
+ * The record is written next to the output, with a .cache extension. It holds a key, which is a
+ * hash of the contents of the input, the options that affect the output and the versions of the
+ * encoder and of the bundle format. It also holds the hashes of the other files that the encoders
+ * read while writing the output, such as the tilesets of a TMX map or the textures that the
+ * materials of an FBX scene reference. An output is up to date if it exists and the key and the
+ * hashes of all of its dependencies still match.
+ *
+ * Directories, such as the inputs of -pack and of -tex for a directory, are not cached.
+ */
+class BuildCache
+{
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param arguments The arguments the encoder was run with.
+     */
+    BuildCache(const EncoderArguments& arguments);
+
+    /**
+     * Destructor.
+     */
+    ~BuildCache();
+
+    /**
+     * Returns the build cache of the current run, or NULL if the build is not incremental.
+     */
+    static BuildCache* getInstance();
+
+    /**
+     * Records that the output being written depends on the given file. Does nothing if the
+     * build is not incremental.
+     *
+     * @param path The path of the file.
+     */
+    static void addDependency(const std::string& path);
+
+    /**
+     * Returns true if the output exists and was built from the same input, options and dependencies.
+     */
+    bool isUpToDate() const;
+
+    /**
+     * Writes the record of the output, after it has been written successfully. Removes the
+     * record instead if the output was not written since the cache was created.
+     *
+     * @return True if the record was written; false otherwise.
+     */
+    bool write() const;
+
+    /**
+     * Returns the 64-bit FNV-1a hash of the contents of a file, or zero if it can't be read.
+     */
+    static unsigned long long hashFile(const std::string& path);
+
+private:
+
+    /**
+     * Returns the 64-bit FNV-1a hash of the given bytes, continuing from the given hash.
+     */
+    static unsigned long long hash(const void* data, size_t size, unsigned long long h);
+
+    std::string _output;
+    std::string _record;
+    unsigned long long _key;
+    time_t _startTime;
+    std::vector<std::string> _dependencies;
+};
+
+}
+
+#endif
@@ -18,6 +18,8 @@ const std::string WORLD_VIEW_PROJECTION_MATRIX = "WORLD_VIEW_PROJECTION_MATRIX";
 
 const std::string TEXTURE_REPEAT = "TEXTURE_REPEAT";
 const std::string TEXTURE_OFFSET = "TEXTURE_OFFSET";
+const std::string LIGHTMAP = "LIGHTMAP";
+const std::string LIGHTMAP_SCALE_OFFSET = "LIGHTMAP_SCALE_OFFSET";
 
 const std::string u_diffuseTexture = "u_diffuseTexture";
 
@@ -21,6 +21,8 @@ extern const std::string WORLD_VIEW_PROJECTION_MATRIX;
 
 extern const std::string TEXTURE_REPEAT;
 extern const std::string TEXTURE_OFFSET;
+extern const std::string LIGHTMAP;
+extern const std::string LIGHTMAP_SCALE_OFFSET;
 
 extern const std::string u_diffuseTexture;
 
@@ -2,6 +2,7 @@
 
 #include "EncoderArguments.h"
 #include "StringUtil.h"
+#include "Transform.h"
 
 #ifdef WIN32
     #define PATH_MAX    _MAX_PATH
@@ -10,7 +11,7 @@
 
 // The encoder version number should be incremented when a feature is added to the encoder.
 // The encoder version is not the same as the GPB version.
-#define ENCODER_VERSION "3.0.0"
+#define ENCODER_VERSION "3.1.0"
 #define HEIGHTMAP_SIZE_MAX 2049
 
 namespace gameplay
@@ -18,6 +19,12 @@ namespace gameplay
 
 static EncoderArguments* __instance;
 
+static bool isDirectory(const std::string& path)
+{
+    struct stat buf;
+    return stat(path.c_str(), &buf) == 0 && (buf.st_mode & S_IFDIR) != 0;
+}
+
 extern int __logVerbosity = 1;
 
 EncoderArguments::EncoderArguments(size_t argc, const char** argv) :
@@ -25,11 +32,36 @@ EncoderArguments::EncoderArguments(size_t argc, const char** argv) :
     _parseError(false),
     _fontPreview(false),
     _fontFormat(Font::BITMAP),
+    _singleDistanceField(false),
     _textOutput(false),
+    _jsonOutput(false),
     _optimizeAnimations(false),
+    _optimizeMeshes(false),
+    _optimizeOverdraw(false),
+    _translateTolerance(0.0f),
+    _rotateTolerance(0.0f),
+    _scaleTolerance(0.0f),
+    _animationQuantizeBits(0),
     _animationGrouping(ANIMATIONGROUP_PROMPT),
+    _lodCount(0),
+    _lodRatio(0.5f),
+    _lodScreenSize(0.5f),
+    _mergeCellSize(0.0f),
+    _maxSkinJoints(0),
+    _atlasSize(0),
+    _quantizeVertices(false),
+    _quantizePositions(false),
     _outputMaterial(false),
-    _generateTextureGutter(false)
+    _generateTextureGutter(false),
+    _pack(false),
+    _packCompression(false),
+    _batch(false),
+    _batchThreadCount(0),
+    _incremental(false),
+    _texture(false),
+    _textureFormat(TextureEncoder::UNCOMPRESSED),
+    _premultipliedAlpha(false),
+    _stripDebug(false)
 {
     __instance = this;
 
@@ -48,8 +80,12 @@ EncoderArguments::EncoderArguments(size_t argc, const char** argv) :
         {
             if (arguments[i][0] == '-')
             {
+                // Keep every option but the batch option itself, along with its arguments
+                size_t start = i;
                 readOption(arguments, &i);
                 index = i + 1;
+                if (arguments[start].compare(0, 6, "-batch") != 0)
+                    _options.insert(_options.end(), arguments.begin() + start, arguments.begin() + index);
             }
         }
         if (arguments.size() - index == 2)
@@ -119,6 +155,12 @@ std::string EncoderArguments::getOutputFileExtension() const
     {
     case FILEFORMAT_TMX:
         return ".scene";
+    case FILEFORMAT_PACK:
+        return ".gpk";
+    case FILEFORMAT_TEXTURE:
+        return ".ktx";
+    case FILEFORMAT_LUA:
+        return ".luac";
     case FILEFORMAT_PNG:
     case FILEFORMAT_RAW:
         if (_normalMap)
@@ -136,6 +178,21 @@ std::string EncoderArguments::getOutputFilePath() const
         // Output file explicitly set
         return _fileOutputPath;
     }
+    else if (_pack)
+    {
+        // The pack is named after the directory it packs
+        return _filePath + getOutputFileExtension();
+    }
+    else if (_texture && isDirectory(_filePath))
+    {
+        // The textures of a directory are written next to their images
+        return _filePath;
+    }
+    else if (_batch)
+    {
+        // The files of a batch are written next to their inputs
+        return isDirectory(_filePath) ? _filePath : getFileDirPath();
+    }
     else
     {
         // Generate an output file path
@@ -190,6 +247,11 @@ const std::vector<EncoderArguments::HeightmapOption>& EncoderArguments::getHeigh
     return _heightmaps;
 }
 
+const std::vector<EncoderArguments::NavMeshOption>& EncoderArguments::getNavMeshOptions() const
+{
+    return _navMeshes;
+}
+
 unsigned int EncoderArguments::tangentBinormalIdCount() const
 {
     return _tangentBinormalId.size();
@@ -256,9 +318,16 @@ void EncoderArguments::printUsage() const
     "Supported file extensions:\n" \
     "  .fbx\t(FBX scenes)\n" \
     "  .ttf\t(TrueType fonts)\n" \
+    "  .png\t(PNG images, with -n or -tex)\n" \
+    "  .lua\t(Lua scripts)\n" \
+    "  .gpb\t(GPB bundles, to inspect)\n" \
+    "  <dir>\t(Directories, with -pack, -tex or -batch)\n" \
     "\n" \
     "General options:\n" \
     "  -v <verbosity>\tVerbosity level (0-4).\n" \
+    "  -incremental\tSkip the input if its output is up to date. A .cache file\n" \
+        "\t\tnext to the output records the hashes of the input, of the\n" \
+        "\t\tfiles it references, and of the options and encoder version.\n" \
     "\n" \
     "FBX file options:\n" \
     "  -i <id>\tFilter by node ID.\n" \
@@ -269,6 +338,13 @@ void EncoderArguments::printUsage() const
         "\t\tGroup all animation channels targeting the nodes into a \n" \
         "\t\tnew animation.\n" \
     "  -m\t\tOutput material file for scene.\n" \
+    "  -atlas <size>\n" \
+        "\t\tPacks the PNG diffuse textures of materials that differ only in\n" \
+        "\t\tthat texture into atlases of up to <size> pixels square and\n" \
+        "\t\treplaces them with one material per atlas (implies -m). Texture\n" \
+        "\t\tcoordinates are remapped into the atlas, so materials whose\n" \
+        "\t\ttextures repeat are left as they are. <size> must be a power of 2.\n" \
+        "\t\tExample: -atlas 2048\n" \
     "  -tb <node id>\n" \
         "\t\tGenerates tangents and binormals for the given node.\n" \
     "  -oa\n" \
@@ -276,6 +352,50 @@ void EncoderArguments::printUsage() const
         "\t\tremoving any channels that contain default/identity values\n" \
         "\t\tand removing any duplicate contiguous keyframes, which are \n" \
         "\t\tcommon when exporting baked animation data.\n" \
+    "  -oat <translate,rotate,scale>\n" \
+        "\t\tOptimizes animations (implies -oa) and also removes keyframes\n" \
+        "\t\tthat can be interpolated from their neighbours within the given\n" \
+        "\t\terror tolerances. Rotation tolerance is in degrees.\n" \
+        "\t\tExample: -oat 0.001,0.1,0.001\n" \
+    "  -oaq <bits>\n" \
+        "\t\tOptimizes animations (implies -oa) and rounds keyframe values\n" \
+        "\t\tto the given number of mantissa bits (1-23) before removing\n" \
+        "\t\tkeyframes.\n" \
+    "  -om\n" \
+        "\t\tOptimizes meshes by reordering triangles for the post-transform\n" \
+        "\t\tvertex cache and vertices in the order they are first used.\n" \
+    "  -omo\n" \
+        "\t\tOptimizes meshes (implies -om) and also reorders clusters of\n" \
+        "\t\ttriangles to reduce overdraw.\n" \
+    "  -lod <count>[,<ratio>[,<screen size>]]\n" \
+        "\t\tGenerates up to <count> simplified levels of detail for each\n" \
+        "\t\tmesh, each keeping <ratio> of the triangles of the level before\n" \
+        "\t\tit (default 0.5). The first level is drawn once the model covers\n" \
+        "\t\tless than <screen size> of the viewport height (default 0.5),\n" \
+        "\t\tand each following level below half the size of the one before.\n" \
+        "\t\tExample: -lod 3,0.4\n" \
+    "  -merge <cell size>\n" \
+        "\t\tMerges the meshes of static nodes that share a material into\n" \
+        "\t\tone mesh per cube of <cell size> world units, so that each cell\n" \
+        "\t\tis drawn with one draw call per material and keeps its own\n" \
+        "\t\tbounds for culling. Animated, skinned and joint nodes and the\n" \
+        "\t\tnodes of -heightmap and -navmesh are not merged. Merged nodes\n" \
+        "\t\tare kept without their models.\n" \
+        "\t\tExample: -merge 50\n" \
+    "  -joints <count>\n" \
+        "\t\tSplits skinned meshes into parts that each use at most <count>\n" \
+        "\t\tjoints (12 or more), so that each part is drawn with a matrix\n" \
+        "\t\tpalette that fits the uniforms of the device. Meshes shared by\n" \
+        "\t\tmore than one node are not split.\n" \
+        "\t\tExample: -joints 32\n" \
+    "  -vq\n" \
+        "\t\tQuantizes vertex attributes: normals, tangents and binormals\n" \
+        "\t\tare packed to 10-10-10-2 integers, colors and blend weights to\n" \
+        "\t\tnormalized bytes and shorts, texture coordinates to normalized\n" \
+        "\t\tshorts or half floats, and blend indices to bytes if possible.\n" \
+    "  -vqp\n" \
+        "\t\tQuantizes vertex attributes (implies -vq) and also stores\n" \
+        "\t\tpositions as half floats.\n" \
     "  -h <size> \"<node ids>\" <filename>\n" \
         "\t\tGenerates a single heightmap image using meshes from the \n" \
         "\t\tspecified nodes. \n" \
@@ -285,6 +405,12 @@ void EncoderArguments::printUsage() const
         "\t\tFilename is the name of the image (PNG) to be saved.\n" \
         "\t\tMultiple -h arguments can be supplied to generate more than one \n" \
         "\t\theightmap. For 24-bit packed height data use -hp instead of -h.\n" \
+    "  -navmesh <max slope> \"<node ids>\" <filename>\n" \
+        "\t\tGenerates a navigation mesh from the triangles of the meshes of\n" \
+        "\t\tthe specified nodes whose slope is at most <max slope> degrees.\n" \
+        "\t\t<node ids> should be in quotes with a space between each id.\n" \
+        "\t\tFilename is the name of the navigation mesh (NAV) to be saved.\n" \
+        "\t\tExample: -navmesh 45 \"ground stairs\" level.nav\n" \
     "\n" \
     "TMX file options:\n" \
     "  -tg\tEnable texture gutter's around tiles. This will modify any referenced\n" \
@@ -310,6 +436,43 @@ void EncoderArguments::printUsage() const
     "  -s <sizes>\tComma-separated list of font sizes (in pixels).\n" \
     "  -p\t\tOutput font preview.\n" \
     "  -f\t\tFormat of font. -f:b (BITMAP), -f:d (DISTANCE_FIELD).\n" \
+        "\t\t-f:d1 writes a DISTANCE_FIELD font in only the largest of the\n" \
+        "\t\tsizes, which the runtime draws every size from.\n" \
+    "\n" \
+    "GPB file options:\n" \
+    "  -json\t\tWrite the report to <input>.json instead of the log.\n" \
+        "\t\tThe report lists the size of each object, the vertex formats\n" \
+        "\t\tand index counts of meshes, the key counts of animation\n" \
+        "\t\tchannels and the size of the strings and reference table, and\n" \
+        "\t\tflags unindexed meshes, float attributes that -vq would\n" \
+        "\t\tquantize, redundant keys and skins with too many joints.\n" \
+    "\n" \
+    "Pack file options:\n" \
+    "  -pack\t\tWrite the files of the input directory into a pack file (.gpk)\n" \
+        "\t\tthat the game mounts with FileSystem::mountArchive.\n" \
+    "  -pack:lz4\tLike -pack, and compresses each file with LZ4 where that\n" \
+        "\t\tmakes it smaller.\n" \
+    "\n" \
+    "Texture options:\n" \
+    "  -tex[:<format>]\n" \
+        "\t\tWrite the PNG input, or every PNG file of the input directory,\n" \
+        "\t\tas a KTX texture with a full mipmap chain. <format> is one of\n" \
+        "\t\trgba (uncompressed, the default), etc1, bc1 (DXT1) or bc3 (DXT5).\n" \
+        "\t\tThe textures of a directory are encoded in parallel.\n" \
+    "  -pma\t\tMultiply the color of textures by their alpha before the\n" \
+        "\t\tmipmaps are generated.\n" \
+    "\n" \
+    "Batch options:\n" \
+    "  -batch[:<threads>]\n" \
+        "\t\tEncode every FBX, TMX, TTF, OTF and Lua file of the input\n" \
+        "\t\tdirectory and its subdirectories, or every file listed in the\n" \
+        "\t\tinput manifest (one path per line, relative to the manifest),\n" \
+        "\t\tin parallel on <threads> threads (default: one per processor).\n" \
+        "\t\tThe other options apply to each file. Outputs mirror the input\n" \
+        "\t\tdirectories under the output directory, each with a .log file.\n" \
+    "\n" \
+    "Lua file options:\n" \
+    "  -strip\tRemove the debug information from the compiled bytecode (.luac).\n" \
     "\n");
     exit(8);
 }
@@ -324,16 +487,102 @@ Font::FontFormat EncoderArguments::getFontFormat() const
     return _fontFormat;
 }
 
+bool EncoderArguments::singleDistanceFieldEnabled() const
+{
+    return _singleDistanceField;
+}
+
 bool EncoderArguments::textOutputEnabled() const
 {
     return _textOutput;
 }
 
+bool EncoderArguments::jsonOutputEnabled() const
+{
+    return _jsonOutput;
+}
+
 bool EncoderArguments::optimizeAnimationsEnabled() const
 {
     return _optimizeAnimations;
 }
 
+bool EncoderArguments::optimizeMeshesEnabled() const
+{
+    return _optimizeMeshes;
+}
+
+bool EncoderArguments::optimizeOverdrawEnabled() const
+{
+    return _optimizeOverdraw;
+}
+
+float EncoderArguments::getAnimationTolerance(unsigned int targetAttrib) const
+{
+    switch (targetAttrib)
+    {
+    case Transform::ANIMATE_TRANSLATE:
+    case Transform::ANIMATE_TRANSLATE_X:
+    case Transform::ANIMATE_TRANSLATE_Y:
+    case Transform::ANIMATE_TRANSLATE_Z:
+        return _translateTolerance;
+    case Transform::ANIMATE_ROTATE:
+        return _rotateTolerance;
+    case Transform::ANIMATE_SCALE:
+    case Transform::ANIMATE_SCALE_X:
+    case Transform::ANIMATE_SCALE_Y:
+    case Transform::ANIMATE_SCALE_Z:
+        return _scaleTolerance;
+    default:
+        return 0.0f;
+    }
+}
+
+unsigned int EncoderArguments::getAnimationQuantizeBits() const
+{
+    return _animationQuantizeBits;
+}
+
+unsigned int EncoderArguments::getLODCount() const
+{
+    return _lodCount;
+}
+
+float EncoderArguments::getLODRatio() const
+{
+    return _lodRatio;
+}
+
+float EncoderArguments::getLODScreenSize() const
+{
+    return _lodScreenSize;
+}
+
+float EncoderArguments::getMergeCellSize() const
+{
+    return _mergeCellSize;
+}
+
+unsigned int EncoderArguments::getMaxSkinJoints() const
+{
+    return _maxSkinJoints;
+}
+
+unsigned int EncoderArguments::getAtlasSize() const
+{
+    return _atlasSize;
+}
+
+bool EncoderArguments::quantizeVerticesEnabled() const
+{
+    return _quantizeVertices;
+}
+
+bool EncoderArguments::quantizePositionsEnabled() const
+{
+    return _quantizePositions;
+}
+
 bool EncoderArguments::outputMaterialEnabled() const
 {
     return _outputMaterial;
@@ -344,6 +593,46 @@ bool EncoderArguments::generateTextureGutter() const
     return _generateTextureGutter;
 }
 
+bool EncoderArguments::packCompressionEnabled() const
+{
+    return _packCompression;
+}
+
+unsigned int EncoderArguments::getBatchThreadCount() const
+{
+    return _batchThreadCount;
+}
+
+const std::vector<std::string>& EncoderArguments::getOptions() const
+{
+    return _options;
+}
+
+bool EncoderArguments::incrementalEnabled() const
+{
+    return _incremental;
+}
+
+const char* EncoderArguments::getVersion()
+{
+    return ENCODER_VERSION;
+}
+
+TextureEncoder::Format EncoderArguments::getTextureFormat() const
+{
+    return _textureFormat;
+}
+
+bool EncoderArguments::premultipliedAlphaEnabled() const
+{
+    return _premultipliedAlpha;
+}
+
+bool EncoderArguments::stripDebugEnabled() const
+{
+    return _stripDebug;
+}
+
 const char* EncoderArguments::getNodeId() const
 {
     if (_nodeId.length() == 0)
@@ -360,6 +649,18 @@ std::vector<unsigned int> EncoderArguments::getFontSizes() const
 
 EncoderArguments::FileFormat EncoderArguments::getFileFormat() const
 {
+    if (_batch)
+    {
+        return FILEFORMAT_BATCH;
+    }
+    if (_pack)
+    {
+        return FILEFORMAT_PACK;
+    }
+    if (_texture)
+    {
+        return FILEFORMAT_TEXTURE;
+    }
     if (_filePath.length() < 5)
     {
         return FILEFORMAT_UNKNOWN;
@@ -403,6 +704,10 @@ EncoderArguments::FileFormat EncoderArguments::getFileFormat() const
     {
         return FILEFORMAT_RAW;
     }
+    if (ext.compare("lua") == 0)
+    {
+        return FILEFORMAT_LUA;
+    }
 
     return FILEFORMAT_UNKNOWN;
 }
@@ -416,6 +721,46 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
     }
     switch (str[1])
     {
+    case 'a':
+        if (str.compare("-atlas") == 0)
+        {
+            // Pack the textures of compatible materials into atlases
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing size argument for -atlas.\n");
+                _parseError = true;
+                return;
+            }
+            int size = atoi(options[*index].c_str());
+            if (size < 64 || (size & (size - 1)) != 0)
+            {
+                LOG(1, "Error: size argument for -atlas must be a power of 2 of at least 64.\n");
+                _parseError = true;
+                return;
+            }
+            _atlasSize = (unsigned int)size;
+            _outputMaterial = true;
+        }
+        break;
+    case 'b':
+        if (str.compare("-batch") == 0)
+        {
+            _batch = true;
+        }
+        else if (str.compare(0, 7, "-batch:") == 0)
+        {
+            int threads = atoi(str.c_str() + 7);
+            if (threads < 1)
+            {
+                LOG(1, "Error: thread count for -batch must be at least 1.\n");
+                _parseError = true;
+                return;
+            }
+            _batch = true;
+            _batchThreadCount = (unsigned int)threads;
+        }
+        break;
     case 'f':
         if (str.compare("-f:b") == 0)
         {
@@ -425,6 +770,12 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
         {
             _fontFormat = Font::DISTANCE_FIELD;
         }
+        else if (str.compare("-f:d1") == 0)
+        {
+            // Distance field in the largest requested size only
+            _fontFormat = Font::DISTANCE_FIELD;
+            _singleDistanceField = true;
+        }
         break;
     case 'g':
         if (str.compare("-groupAnimations:auto") == 0 || str.compare("-g:auto") == 0)
@@ -450,7 +801,37 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
             _groupAnimationAnimationId.push_back(options[*index]);
         }
         break;
+    case 'j':
+        if (str.compare("-json") == 0)
+        {
+            _jsonOutput = true;
+        }
+        else if (str.compare("-joints") == 0)
+        {
+            // Split skinned meshes into parts with smaller joint palettes
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing joint count argument for -joints.\n");
+                _parseError = true;
+                return;
+            }
+            int count = atoi(options[*index].c_str());
+            if (count < 12)
+            {
+                LOG(1, "Error: joint count argument for -joints must be at least 12.\n");
+                _parseError = true;
+                return;
+            }
+            _maxSkinJoints = (unsigned int)count;
+        }
+        break;
     case 'i':
+        if (str.compare("-incremental") == 0)
+        {
+            _incremental = true;
+            break;
+        }
         // Node ID
         (*index)++;
         if (*index < options.size())
@@ -471,6 +852,66 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
             // Optimize animations
             _optimizeAnimations = true;
         }
+        else if (str == "-oat")
+        {
+            // Optimize animations and reduce keyframes within tolerance
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing tolerance argument for -oat.\n");
+                _parseError = true;
+                return;
+            }
+            std::vector<std::string> parts;
+            splitString(options[*index].c_str(), &parts);
+            if (parts.size() != 3)
+            {
+                LOG(1, "Error: invalid tolerance argument for -oat.\n");
+                _parseError = true;
+                return;
+            }
+            _translateTolerance = (float)atof(parts[0].c_str());
+            _rotateTolerance = MATH_DEG_TO_RAD((float)atof(parts[1].c_str()));
+            _scaleTolerance = (float)atof(parts[2].c_str());
+            if (_translateTolerance < 0 || _rotateTolerance < 0 || _scaleTolerance < 0)
+            {
+                LOG(1, "Error: tolerance arguments for -oat must not be negative.\n");
+                _parseError = true;
+                return;
+            }
+            _optimizeAnimations = true;
+        }
+        else if (str == "-oaq")
+        {
+            // Optimize animations and quantize keyframe values
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing bits argument for -oaq.\n");
+                _parseError = true;
+                return;
+            }
+            int bits = atoi(options[*index].c_str());
+            if (bits < 1 || bits > 23)
+            {
+                LOG(1, "Error: bits argument for -oaq must be between 1 and 23.\n");
+                _parseError = true;
+                return;
+            }
+            _animationQuantizeBits = (unsigned int)bits;
+            _optimizeAnimations = true;
+        }
+        else if (str == "-om")
+        {
+            // Optimize meshes for the vertex cache
+            _optimizeMeshes = true;
+        }
+        else if (str == "-omo")
+        {
+            // Optimize meshes and reduce overdraw
+            _optimizeMeshes = true;
+            _optimizeOverdraw = true;
+        }
         break;
     case 'h':
         {
@@ -538,15 +979,106 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
             }
         }
         break;
+    case 'l':
+        if (str.compare("-lod") == 0)
+        {
+            // Generate levels of detail
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing count argument for -lod.\n");
+                _parseError = true;
+                return;
+            }
+            std::vector<std::string> parts;
+            splitString(options[*index].c_str(), &parts);
+            int count = parts.empty() ? 0 : atoi(parts[0].c_str());
+            if (count < 1 || parts.size() > 3)
+            {
+                LOG(1, "Error: invalid argument for -lod.\n");
+                _parseError = true;
+                return;
+            }
+            _lodCount = (unsigned int)count;
+            if (parts.size() > 1)
+                _lodRatio = (float)atof(parts[1].c_str());
+            if (parts.size() > 2)
+                _lodScreenSize = (float)atof(parts[2].c_str());
+            if (_lodRatio <= 0.0f || _lodRatio >= 1.0f || _lodScreenSize <= 0.0f || _lodScreenSize > 1.0f)
+            {
+                LOG(1, "Error: ratio and screen size arguments for -lod must be between 0 and 1.\n");
+                _parseError = true;
+                return;
+            }
+        }
+        break;
     case 'm':
         if (str.compare("-m") == 0)
         {
             // generate a material file
             _outputMaterial = true;
         }
+        else if (str.compare("-merge") == 0)
+        {
+            // Merge static meshes within cells
+            (*index)++;
+            if (*index >= options.size())
+            {
+                LOG(1, "Error: missing cell size argument for -merge.\n");
+                _parseError = true;
+                return;
+            }
+            _mergeCellSize = (float)atof(options[*index].c_str());
+            if (_mergeCellSize <= 0.0f)
+            {
+                LOG(1, "Error: cell size argument for -merge must be greater than zero.\n");
+                _parseError = true;
+                return;
+            }
+        }
         break;
     case 'n':
-        _normalMap = true;
+        if (str.compare("-navmesh") == 0)
+        {
+            if (*index + 3 >= options.size())
+            {
+                LOG(1, "Error: missing argument for -navmesh.\n");
+                _parseError = true;
+                return;
+            }
+            _navMeshes.resize(_navMeshes.size() + 1);
+            NavMeshOption& navMesh = _navMeshes.back();
+
+            // Read the maximum walkable slope
+            (*index)++;
+            navMesh.maxSlope = (float)atof(options[*index].c_str());
+            if (navMesh.maxSlope <= 0.0f || navMesh.maxSlope >= 90.0f)
+            {
+                LOG(1, "Error: slope argument for -navmesh must be between 0 and 90 degrees.\n");
+                _parseError = true;
+                return;
+            }
+
+            // Split node id list into tokens
+            (*index)++;
+            splitString(options[*index].c_str(), &navMesh.nodeIds);
+
+            // Store output filename, with a .nav extension
+            (*index)++;
+            navMesh.filename = options[*index];
+            if (navMesh.filename.empty())
+            {
+                LOG(1, "Error: missing filename argument for -navmesh.\n");
+                _parseError = true;
+                return;
+            }
+            if (navMesh.filename.length() < 5 || navMesh.filename.compare(navMesh.filename.length() - 4, 4, ".nav") != 0)
+                navMesh.filename += ".nav";
+        }
+        else
+        {
+            _normalMap = true;
+        }
         break;
     case 'w':
         {
@@ -578,10 +1110,30 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
         }
         break;
     case 'p':
-        _fontPreview = true;
+        if (str.compare("-pack") == 0)
+        {
+            _pack = true;
+        }
+        else if (str.compare("-pack:lz4") == 0)
+        {
+            _pack = true;
+            _packCompression = true;
+        }
+        else if (str.compare("-pma") == 0)
+        {
+            _premultipliedAlpha = true;
+        }
+        else
+        {
+            _fontPreview = true;
+        }
         break;
     case 's':
-        if (_normalMap)
+        if (str.compare("-strip") == 0)
+        {
+            _stripDebug = true;
+        }
+        else if (_normalMap)
         {
             (*index)++;
             if (*index >= options.size())
@@ -681,6 +1233,23 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
                 _tangentBinormalId.insert(nodeId);
             }
         }
+        else if (str.compare("-tex") == 0 || str.compare(0, 5, "-tex:") == 0)
+        {
+            _texture = true;
+            if (str.compare("-tex") == 0 || str.compare("-tex:rgba") == 0)
+                _textureFormat = TextureEncoder::UNCOMPRESSED;
+            else if (str.compare("-tex:etc1") == 0)
+                _textureFormat = TextureEncoder::ETC1;
+            else if (str.compare("-tex:bc1") == 0 || str.compare("-tex:dxt1") == 0)
+                _textureFormat = TextureEncoder::BC1;
+            else if (str.compare("-tex:bc3") == 0 || str.compare("-tex:dxt5") == 0)
+                _textureFormat = TextureEncoder::BC3;
+            else
+            {
+                LOG(1, "Error: Unknown texture format: %s\n", str.c_str());
+                _parseError = true;
+            }
+        }
         else if (str.compare("-textureGutter:none") == 0 || str.compare("-tg:none") == 0)
         {
             _generateTextureGutter = false;
@@ -691,14 +1260,26 @@ void EncoderArguments::readOption(const std::vector<std::string>& options, size_
         }
         break;
     case 'v':
-        (*index)++;
-        if (*index < options.size())
+        if (str.compare("-vq") == 0)
+        {
+            _quantizeVertices = true;
+        }
+        else if (str.compare("-vqp") == 0)
         {
-            __logVerbosity = atoi(options[*index].c_str());
-            if (__logVerbosity < 0)
-                __logVerbosity = 0;
-            else if (__logVerbosity > 4)
-                __logVerbosity = 4;
+            _quantizeVertices = true;
+            _quantizePositions = true;
+        }
+        else
+        {
+            (*index)++;
+            if (*index < options.size())
+            {
+                __logVerbosity = atoi(options[*index].c_str());
+                if (__logVerbosity < 0)
+                    __logVerbosity = 0;
+                else if (__logVerbosity > 4)
+                    __logVerbosity = 4;
+            }
         }
         break;
     default:
@@ -715,7 +1296,15 @@ void EncoderArguments::setOutputfilePath(const std::string& outputPath)
 {
     std::string ext = getOutputFileExtension();
 
-    if (outputPath.size() > 0 && outputPath[0] != '\0')
+    if ((_texture && isDirectory(_filePath)) || _batch)
+    {
+        // The textures of a directory, and the files of a batch, are written into the output directory, which may not exist yet
+        _fileOutputPath.assign(outputPath);
+        replace_char(&_fileOutputPath[0], '\\', '/');
+        while (_fileOutputPath.size() > 1 && _fileOutputPath[_fileOutputPath.size() - 1] == '/')
+            _fileOutputPath.erase(_fileOutputPath.size() - 1);
+    }
+    else if (outputPath.size() > 0 && outputPath[0] != '\0')
     {
         std::string realPath = getRealPath(outputPath);
         if (endsWith(realPath.c_str(), ext.c_str()))
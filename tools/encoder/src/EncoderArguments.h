@@ -4,6 +4,7 @@
 #include <set>
 #include "Vector3.h"
 #include "Font.h"
+#include "TextureEncoder.h"
 
 namespace gameplay
 {
@@ -24,7 +25,11 @@ public:
         FILEFORMAT_OTF,
         FILEFORMAT_GPB,
         FILEFORMAT_PNG,
-        FILEFORMAT_RAW
+        FILEFORMAT_RAW,
+        FILEFORMAT_PACK,
+        FILEFORMAT_TEXTURE,
+        FILEFORMAT_LUA,
+        FILEFORMAT_BATCH
     };
 
     struct HeightmapOption
@@ -36,6 +41,13 @@ public:
         int height;
     };
 
+    struct NavMeshOption
+    {
+        std::vector<std::string> nodeIds;
+        std::string filename;
+        float maxSlope;
+    };
+
     struct NormalMapOption
     {
         std::string inputFile;
@@ -118,6 +130,8 @@ public:
 
     const std::vector<HeightmapOption>& getHeightmapOptions() const;
 
+    const std::vector<NavMeshOption>& getNavMeshOptions() const;
+
     /**
      * Returns the number of node IDs that were marked as needing to compute tangents and binormals.
      */
@@ -170,14 +184,145 @@ public:
 
     Font::FontFormat getFontFormat() const;
 
+    /**
+     * Returns true if a distance field font should only be written in its largest size. The
+     * runtime draws every size of a distance field font from its largest one.
+     */
+    bool singleDistanceFieldEnabled() const;
+
     bool textOutputEnabled() const;
 
+    /**
+     * Returns true if the report of a GPB file should be written as JSON.
+     */
+    bool jsonOutputEnabled() const;
+
     bool optimizeAnimationsEnabled() const;
 
+    /**
+     * Returns true if triangles and vertices should be reordered for the vertex cache.
+     */
+    bool optimizeMeshesEnabled() const;
+
+    /**
+     * Returns true if triangles should also be reordered to reduce overdraw.
+     */
+    bool optimizeOverdrawEnabled() const;
+
+    /**
+     * Returns the error tolerance used to remove key frames from animation channels
+     * that target the given transform property.
+     *
+     * Translation and scale tolerances are in the units of the property and rotation
+     * tolerances are in radians.
+     *
+     * @param targetAttrib The target attribute of the animation channel.
+     *
+     * @return The tolerance, or zero if key frames should not be reduced.
+     */
+    float getAnimationTolerance(unsigned int targetAttrib) const;
+
+    /**
+     * Returns the number of mantissa bits that animation key values are rounded to.
+     *
+     * @return The number of mantissa bits, or zero if key values are not quantized.
+     */
+    unsigned int getAnimationQuantizeBits() const;
+
+    /**
+     * Returns the number of simplified levels of detail to generate for each mesh.
+     *
+     * @return The number of levels of detail, or zero if none should be generated.
+     */
+    unsigned int getLODCount() const;
+
+    /**
+     * Returns the fraction of the triangles of each level of detail that the next level keeps.
+     */
+    float getLODRatio() const;
+
+    /**
+     * Returns the screen size below which the first level of detail is drawn.
+     */
+    float getLODScreenSize() const;
+
+    /**
+     * Returns the size of the cells that static meshes sharing a material are merged within.
+     *
+     * @return The cell size in world units, or zero if meshes should not be merged.
+     */
+    float getMergeCellSize() const;
+
+    /**
+     * Returns the number of joints that the parts of skinned meshes are split to use at most.
+     *
+     * @return The number of joints, or zero if skinned meshes should not be split.
+     */
+    unsigned int getMaxSkinJoints() const;
+
+    /**
+     * Returns the largest width and height of the atlases that the diffuse textures of
+     * compatible materials are packed into.
+     *
+     * @return The size in pixels, or zero if textures should not be packed.
+     */
+    unsigned int getAtlasSize() const;
+
+    /**
+     * Returns true if vertex attributes should be stored in compact types.
+     */
+    bool quantizeVerticesEnabled() const;
+
+    /**
+     * Returns true if vertex positions should also be stored as half floats.
+     */
+    bool quantizePositionsEnabled() const;
+
     bool outputMaterialEnabled() const;
 
     bool generateTextureGutter() const;
 
+    /**
+     * Returns true if the entries of a pack file should be compressed with LZ4.
+     */
+    bool packCompressionEnabled() const;
+
+    /**
+     * Returns the number of files that batch mode encodes at the same time.
+     */
+    unsigned int getBatchThreadCount() const;
+
+    /**
+     * Returns the options the encoder was run with, other than -batch, along with their arguments.
+     * Batch mode passes them on to the encoder for each file.
+     */
+    const std::vector<std::string>& getOptions() const;
+
+    /**
+     * Returns true if outputs that are up to date with their inputs should be skipped.
+     */
+    bool incrementalEnabled() const;
+
+    /**
+     * Returns the version of the encoder.
+     */
+    static const char* getVersion();
+
+    /**
+     * Returns the format that textures are written in.
+     */
+    TextureEncoder::Format getTextureFormat() const;
+
+    /**
+     * Returns true if the color of textures should be multiplied by their alpha.
+     */
+    bool premultipliedAlphaEnabled() const;
+
+    /**
+     * Returns true if the debug information should be stripped from compiled scripts.
+     */
+    bool stripDebugEnabled() const;
+
     const char* getNodeId() const;
 
     static std::string getRealPath(const std::string& filepath);
@@ -220,15 +365,42 @@ private:
     std::vector<unsigned int> _fontSizes;
     bool _fontPreview;
     Font::FontFormat _fontFormat;
+    bool _singleDistanceField;
     bool _textOutput;
+    bool _jsonOutput;
     bool _optimizeAnimations;
+    bool _optimizeMeshes;
+    bool _optimizeOverdraw;
+    float _translateTolerance;
+    float _rotateTolerance;
+    float _scaleTolerance;
+    unsigned int _animationQuantizeBits;
     AnimationGroupOption _animationGrouping;
+    unsigned int _lodCount;
+    float _lodRatio;
+    float _lodScreenSize;
+    float _mergeCellSize;
+    unsigned int _maxSkinJoints;
+    unsigned int _atlasSize;
+    bool _quantizeVertices;
+    bool _quantizePositions;
     bool _outputMaterial;
     bool _generateTextureGutter;
+    bool _pack;
+    bool _packCompression;
+    bool _batch;
+    unsigned int _batchThreadCount;
+    bool _incremental;
+    std::vector<std::string> _options;
+    bool _texture;
+    TextureEncoder::Format _textureFormat;
+    bool _premultipliedAlpha;
+    bool _stripDebug;
 
     std::vector<std::string> _groupAnimationNodeId;
     std::vector<std::string> _groupAnimationAnimationId;
     std::vector<HeightmapOption> _heightmaps;
+    std::vector<NavMeshOption> _navMeshes;
     std::set<std::string> _tangentBinormalId;
 
 };
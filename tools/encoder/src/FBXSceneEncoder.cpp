@@ -5,6 +5,7 @@
 #include "FBXSceneEncoder.h"
 #include "FBXUtil.h"
 #include "Sampler.h"
+#include "MaterialAtlas.h"
 
 using namespace gameplay;
 using std::string;
@@ -12,11 +13,17 @@ using std::vector;
 using std::map;
 using std::ostringstream;
 
+// The number of vertices that are read before the meshes that hold them are built.
+#define MESH_DATA_VERTEX_LIMIT 4000000
+
 // Fix bad material names
 static void fixMaterialName(string& name);
 
+// Finds the baked lightmap of a material and the scale and offset of its texture coordinates.
+static FbxFileTexture* findLightmap(FbxSurfaceMaterial* fbxMaterial, Vector4* scaleOffset);
+
 FBXSceneEncoder::FBXSceneEncoder()
-    : _groupAnimation(NULL), _autoGroupAnimations(false)
+    : _meshDataVertexCount(0), _groupAnimation(NULL), _autoGroupAnimations(false)
 {
 }
 
@@ -67,6 +74,20 @@ void FBXSceneEncoder::write(const string& filepath, const EncoderArguments& argu
     loadAnimations(fbxScene, arguments);
     sdkManager->Destroy();
 
+    // Pack textures before the meshes are adjusted, so that the meshes that now share a
+    // material can be merged.
+    if (arguments.getAtlasSize() > 0)
+    {
+        print("Packing material textures.");
+        std::vector<Model*> models;
+        for (map<FbxNode*, Node*>::const_iterator it = _nodeMap.begin(); it != _nodeMap.end(); ++it)
+        {
+            if (Model* model = it->second->getModel())
+                models.push_back(model);
+        }
+        MaterialAtlas::build(models, _materials, arguments.getAtlasSize(), arguments.getFileDirPath(), arguments.getOutputFilePath());
+    }
+
     print("Optimizing GamePlay Binary.");
     _gamePlayFile.adjust();
     if (_autoGroupAnimations)
@@ -175,6 +196,7 @@ void FBXSceneEncoder::loadScene(FbxScene* fbxScene)
                 scene->add(node);
             }
         }
+        buildMeshes();
     }
 
     // Load the MeshSkin information from the scene's poses.
@@ -925,6 +947,25 @@ void FBXSceneEncoder::loadMaterial(FbxNode* fbxNode)
             _materials[materialName] = material;
         }
 
+        if (model && model->getMesh() && index == 0)
+        {
+            // Models have a single lightmap, which is sampled with the second texture coordinates.
+            Vector4 scaleOffset;
+            if (FbxFileTexture* lightmap = findLightmap(fbxMaterial, &scaleOffset))
+            {
+                if (model->getMesh()->hasTexCoords(1))
+                {
+                    const char* path = lightmap->GetRelativeFileName();
+                    model->setLightmap(path && path[0] != '\0' ? path : lightmap->GetFileName(), scaleOffset);
+                }
+                else
+                {
+                    LOG(2, "Warning: Lightmap of material '%s' ignored on node '%s', whose mesh has no second texture coordinates.\n",
+                        materialName.c_str(), fbxNode->GetName());
+                }
+            }
+        }
+
         if (materialCount == 1 && material && model)
         {
             model->setMaterial(material); // TODO: add support for materials per mesh part
@@ -985,7 +1026,7 @@ void FBXSceneEncoder::loadMaterialTextures(FbxSurfaceMaterial* fbxMaterial, Mate
                     //no layered texture simply get on the property
                     if (FbxFileTexture* fileTexture = FbxCast<FbxFileTexture>(fbxTexture))
                     {
-                        loadMaterialFileTexture(fileTexture, material);
+                        loadMaterialFileTexture(fileTexture, FbxLayerElement::sTextureChannelNames[textureIndex], material);
                     }
                 }
             }
@@ -993,11 +1034,11 @@ void FBXSceneEncoder::loadMaterialTextures(FbxSurfaceMaterial* fbxMaterial, Mate
     }
 }
 
-void FBXSceneEncoder::loadMaterialFileTexture(FbxFileTexture* fileTexture, Material* material)
+void FBXSceneEncoder::loadMaterialFileTexture(FbxFileTexture* fileTexture, const char* channel, Material* material)
 {
     FbxTexture::ETextureUse textureUse = fileTexture->GetTextureUse();
     Sampler* sampler = NULL;
-    if (textureUse == FbxTexture::eStandard)
+    if (textureUse == FbxTexture::eStandard && strcmp(channel, FbxSurfaceMaterial::sAmbient) != 0)
     {
         if (!material->getSampler("u_diffuseTexture"))
             sampler = material->createSampler("u_diffuseTexture");
@@ -1099,11 +1140,26 @@ Material* FBXSceneEncoder::createMaterial(const string& name, FbxSurfaceMaterial
     {
         material->setUniform("u_matrixPalette", "MATRIX_PALETTE");
         material->addDefine("SKINNING");
+        // Skinned meshes that are split with -joints draw each part with a smaller palette.
+        unsigned int jointCount = skin->getJointCount();
+        const unsigned int maxSkinJoints = EncoderArguments::getInstance()->getMaxSkinJoints();
+        if (maxSkinJoints > 0 && jointCount > maxSkinJoints)
+            jointCount = maxSkinJoints;
         ostringstream stream;
-        stream << "SKINNING_JOINT_COUNT " << skin->getJointCount();
+        stream << "SKINNING_JOINT_COUNT " << jointCount;
         material->addDefine(stream.str());
     }
     loadMaterialTextures(fbxMaterial, material);
+    Vector4 scaleOffset;
+    if (mesh && mesh->hasTexCoords(1) && findLightmap(fbxMaterial, &scaleOffset))
+    {
+        // The lightmap itself belongs to the model, so that the material can be shared by
+        // models that are baked into different lightmaps.
+        material->addDefine(LIGHTMAP);
+        material->addDefine(LIGHTMAP_SCALE_OFFSET);
+        material->setUniform("u_lightmapTexture", "LIGHTMAP_TEXTURE");
+        material->setUniform("u_lightmapScaleOffset", "LIGHTMAP_SCALE_OFFSET");
+    }
     loadMaterialUniforms(fbxMaterial, material);
     material->setParent(findBaseMaterial(material));
     assert(material);
@@ -1177,13 +1233,10 @@ Mesh* FBXSceneEncoder::loadMesh(FbxMesh* fbxMesh)
 
     // The number of mesh parts is equal to the number of materials that affect this mesh.
     // There is always at least one mesh part.
-    vector<MeshPart*> meshParts;
+    MeshData* meshData = new MeshData();
+    meshData->mesh = mesh;
     const int materialCount = fbxMesh->GetNode()->GetMaterialCount();
-    int meshPartSize = (materialCount > 0) ? materialCount : 1;
-    for (int i = 0; i < meshPartSize; ++i)
-    {
-        meshParts.push_back(new MeshPart());
-    }
+    meshData->partCount = (materialCount > 0) ? materialCount : 1;
 
     // Find the blend weights and blend indices if this mesh is skinned.
     vector<vector<Vector2> > weights;
@@ -1194,11 +1247,23 @@ Mesh* FBXSceneEncoder::loadMesh(FbxMesh* fbxMesh)
     fbxMesh->GetUVSetNames(uvSetNameList);
     const int uvSetCount = uvSetNameList.GetCount();
 
+    // Only read the vertices here, since the FBX SDK isn't thread safe. They are welded by buildMeshes().
     int vertexIndex = 0;
     FbxVector4* controlPoints = fbxMesh->GetControlPoints();
     const int polygonCount = fbxMesh->GetPolygonCount();
+    meshData->vertices.reserve(fbxMesh->GetPolygonVertexCount());
+    meshData->partIndices.reserve(fbxMesh->GetPolygonVertexCount());
     for (int polyIndex = 0; polyIndex < polygonCount; ++polyIndex)
     {
+        // Determine which mesh part this polygon should be added to based on the material that affects it.
+        int meshPartIndex = 0;
+        const int elementMatrialCount = fbxMesh->GetElementMaterialCount();
+        for (int k = 0; k < elementMatrialCount; ++k)
+        {
+            FbxGeometryElementMaterial* elementMaterial = fbxMesh->GetElementMaterial(k);
+            meshPartIndex = elementMaterial->GetIndexArray().GetAt(polyIndex);
+        }
+
         const int polygonSize = fbxMesh->GetPolygonSize(polyIndex);
         for (int posInPoly = 0; posInPoly < polygonSize; ++posInPoly)
         {
@@ -1229,35 +1294,102 @@ Mesh* FBXSceneEncoder::loadMesh(FbxMesh* fbxMesh)
                 loadBlendData(weights[controlPointIndex], &vertex);
             }
 
-            // Determine which mesh part this vertex index should be added to based on the material that affects it.
-            int meshPartIndex = 0;
-            const int elementMatrialCount = fbxMesh->GetElementMaterialCount();
-            for (int k = 0; k < elementMatrialCount; ++k)
-            {
-                FbxGeometryElementMaterial* elementMaterial = fbxMesh->GetElementMaterial(k);
-                meshPartIndex = elementMaterial->GetIndexArray().GetAt(polyIndex);
-            }
-
-            // Add the vertex to the mesh if it hasn't already been added and find the vertex index.
-            unsigned int index;
-            if (mesh->contains(vertex))
-            {
-                index = mesh->getVertexIndex(vertex);
-            }
-            else
-            {
-                index = mesh->addVertex(vertex);
-            }
-            meshParts[meshPartIndex]->addIndex(index);
+            meshData->vertices.push_back(vertex);
+            meshData->partIndices.push_back(meshPartIndex);
             vertexIndex++;
         }
     }
 
+    _gamePlayFile.addMesh(mesh);
+    saveMesh(fbxMesh->GetUniqueID(), mesh);
+
+    // Build the meshes read so far once they hold a few million vertices, so that all of
+    // the vertices of a large scene aren't held twice at the same time.
+    _meshData.push_back(meshData);
+    _meshDataVertexCount += meshData->vertices.size();
+    if (_meshDataVertexCount >= MESH_DATA_VERTEX_LIMIT)
+    {
+        buildMeshes();
+    }
+    return mesh;
+}
+
+void FBXSceneEncoder::buildMeshes()
+{
+    if (_meshData.empty())
+        return;
+
+    MeshJobs jobs;
+    jobs.meshData = &_meshData;
+    jobs.next = 0;
+    createMutex(&jobs.mutex);
+
+    unsigned int threadCount = std::min(getProcessorCount(), (unsigned int)_meshData.size());
+    LOG(2, "Building %u meshes on %u threads.\n", (unsigned int)_meshData.size(), threadCount);
+    THREAD_HANDLE* threads = new THREAD_HANDLE[threadCount];
+    unsigned int started = 0;
+    for (unsigned int i = 1; i < threadCount; ++i)
+    {
+        if (!createThread(&threads[started], &buildMeshJobs, &jobs))
+            break;
+        ++started;
+    }
+
+    // This thread builds meshes too, so the meshes still get built if no thread could be started.
+    buildMeshJobs(&jobs);
+    waitForThreads(started, threads);
+    for (unsigned int i = 0; i < started; ++i)
+        closeThread(threads[i]);
+    delete[] threads;
+    destroyMutex(&jobs.mutex);
+
+    for (size_t i = 0, count = _meshData.size(); i < count; ++i)
+    {
+        delete _meshData[i];
+    }
+    _meshData.clear();
+    _meshDataVertexCount = 0;
+}
+
+int FBXSceneEncoder::buildMeshJobs(void* data)
+{
+    MeshJobs* jobs = static_cast<MeshJobs*>(data);
+    while (true)
+    {
+        lockMutex(&jobs->mutex);
+        size_t i = jobs->next++;
+        unlockMutex(&jobs->mutex);
+        if (i >= jobs->meshData->size())
+            break;
+
+        buildMesh(*(*jobs->meshData)[i]);
+    }
+    return 0;
+}
+
+void FBXSceneEncoder::buildMesh(const MeshData& meshData)
+{
+    Mesh* mesh = meshData.mesh;
+    vector<MeshPart*> meshParts;
+    for (int i = 0; i < meshData.partCount; ++i)
+    {
+        meshParts.push_back(new MeshPart());
+    }
+
+    // Add each vertex to the mesh if it hasn't already been added and find the vertex index.
+    mesh->vertexLookupTable.reserve(meshData.vertices.size());
+    for (size_t i = 0, count = meshData.vertices.size(); i < count; ++i)
+    {
+        meshParts[meshData.partIndices[i]]->addIndex(mesh->weldVertex(meshData.vertices[i]));
+    }
+
     const size_t meshpartsSize = meshParts.size();
     for (size_t i = 0; i < meshpartsSize; ++i)
     {
         if (meshParts[i]->getIndicesCount() > 0)
             mesh->addMeshPart(meshParts[i]);
+        else
+            delete meshParts[i];
     }
 
     // The order that the vertex elements are add to the list matters.
@@ -1301,10 +1433,6 @@ Mesh* FBXSceneEncoder::loadMesh(FbxMesh* fbxMesh)
         mesh->addVetexAttribute(BLENDWEIGHTS, Vertex::BLEND_WEIGHTS_COUNT);
         mesh->addVetexAttribute(BLENDINDICES, Vertex::BLEND_INDICES_COUNT);
     }
-
-    _gamePlayFile.addMesh(mesh);
-    saveMesh(fbxMesh->GetUniqueID(), mesh);
-    return mesh;
 }
 
 /*
@@ -1335,6 +1463,32 @@ void FBXSceneEncoder::triangulateRecursive(FbxNode* fbxNode)
 
 // Functions
 
+FbxFileTexture* findLightmap(FbxSurfaceMaterial* fbxMaterial, Vector4* scaleOffset)
+{
+    // Textures are lightmaps if they are used as such, or if they are on the ambient channel
+    // where most packages that bake lighting put them.
+    int textureIndex;
+    FBXSDK_FOR_EACH_TEXTURE(textureIndex)
+    {
+        const char* channel = FbxLayerElement::sTextureChannelNames[textureIndex];
+        FbxProperty fbxProperty = fbxMaterial->FindProperty(channel);
+        if (!fbxProperty.IsValid())
+            continue;
+        const int textureCount = fbxProperty.GetSrcObjectCount<FbxFileTexture>();
+        for (int i = 0; i < textureCount; ++i)
+        {
+            FbxFileTexture* fileTexture = fbxProperty.GetSrcObject<FbxFileTexture>(i);
+            if (fileTexture && (fileTexture->GetTextureUse() == FbxTexture::eLightMap || strcmp(channel, FbxSurfaceMaterial::sAmbient) == 0))
+            {
+                scaleOffset->set((float)fileTexture->GetScaleU(), (float)fileTexture->GetScaleV(),
+                    (float)fileTexture->GetTranslationU(), (float)fileTexture->GetTranslationV());
+                return fileTexture;
+            }
+        }
+    }
+    return NULL;
+}
+
 void fixMaterialName(string& name)
 {
     static int unnamedCount = 0;
@@ -31,6 +31,7 @@
 #include "Transform.h"
 #include "GPBFile.h"
 #include "EncoderArguments.h"
+#include "Thread.h"
 
 using namespace gameplay;
 
@@ -69,6 +70,28 @@ public:
 
 private:
 
+    /**
+     * The vertices of a mesh as they were read from the FBX SDK, one for each corner of each
+     * polygon, which are waiting to be welded into the mesh.
+     */
+    struct MeshData
+    {
+        Mesh* mesh;
+        std::vector<Vertex> vertices;
+        std::vector<int> partIndices;
+        int partCount;
+    };
+
+    /**
+     * The meshes that the threads of buildMeshes() share.
+     */
+    struct MeshJobs
+    {
+        std::vector<MeshData*>* meshData;
+        MUTEX_HANDLE mutex;
+        size_t next;
+    };
+
     /**
      * Loads the scene.
      * 
@@ -145,7 +168,7 @@ private:
 
     void loadMaterialTextures(FbxSurfaceMaterial* fbxMaterial, Material* material);
 
-    void loadMaterialFileTexture(FbxFileTexture* fileTexture, Material* material);
+    void loadMaterialFileTexture(FbxFileTexture* fileTexture, const char* channel, Material* material);
 
     void loadMaterialUniforms(FbxSurfaceMaterial* fbxMaterial, Material* material);
 
@@ -187,6 +210,27 @@ private:
      */
     Mesh* loadMesh(FbxMesh* fbxMesh);
 
+    /**
+     * Welds the vertices of the meshes that were loaded since the last call and builds their
+     * mesh parts. The meshes are independent of each other, so they are built on a thread per processor.
+     */
+    void buildMeshes();
+
+    /**
+     * Builds meshes until there are none left. This is the entry point of each thread of buildMeshes().
+     *
+     * @param data The MeshJobs being built.
+     */
+    static int buildMeshJobs(void* data);
+
+    /**
+     * Welds the vertices that were read for a mesh into its vertex list, builds its mesh parts
+     * and sets its vertex format. This doesn't call into the FBX SDK, which isn't thread safe.
+     *
+     * @param meshData The vertices that were read for the mesh.
+     */
+    static void buildMesh(const MeshData& meshData);
+
     /**
      * Gets the Mesh that was saved with the given ID. Returns NULL if a match is not found.
      * 
@@ -266,6 +310,16 @@ private:
      */
     std::map<FbxUInt64, Mesh*> _meshes;
 
+    /**
+     * The meshes that were loaded but not built yet.
+     */
+    std::vector<MeshData*> _meshData;
+
+    /**
+     * The number of vertices in _meshData, which bounds the memory used before the meshes are built.
+     */
+    size_t _meshDataVertexCount;
+
     /**
      * The list of child materials that were loaded.
      */
@@ -392,32 +392,56 @@ void loadVertexColor(FbxMesh* fbxMesh, int vertexIndex, int controlPointIndex, V
     }
 }
 
+/**
+ * The smallest blend weight that is kept. Smaller weights move the vertex by less than the
+ * precision of quantized weights but still add a joint to the palette of its mesh part.
+ */
+#define MIN_BLEND_WEIGHT 0.001f
+
+static bool isHeavierInfluence(const Vector2& a, const Vector2& b)
+{
+    return a.y > b.y;
+}
+
 void loadBlendData(const vector<Vector2>& vertexWeights, Vertex* vertex)
 {
-    size_t size = vertexWeights.size();
     vertex->hasWeights= true;
 
+    // Keep the heaviest influences, up to the 4 that a vertex can hold, and at least one.
+    vector<Vector2> influences(vertexWeights);
+    std::stable_sort(influences.begin(), influences.end(), isHeavierInfluence);
+    size_t size = 0;
+    while (size < influences.size() && size < Vertex::BLEND_WEIGHTS_COUNT && (size == 0 || influences[size].y >= MIN_BLEND_WEIGHT))
+    {
+        ++size;
+    }
+
     if (size >= 1)
     {
-        vertex->blendIndices.x = vertexWeights[0].x;
-        vertex->blendWeights.x = vertexWeights[0].y;
+        vertex->blendIndices.x = influences[0].x;
+        vertex->blendWeights.x = influences[0].y;
     }
     if (size >= 2)
     {
-        vertex->blendIndices.y = vertexWeights[1].x;
-        vertex->blendWeights.y = vertexWeights[1].y;
+        vertex->blendIndices.y = influences[1].x;
+        vertex->blendWeights.y = influences[1].y;
     }
     if (size >= 3)
     {
-        vertex->blendIndices.z = vertexWeights[2].x;
-        vertex->blendWeights.z = vertexWeights[2].y;
+        vertex->blendIndices.z = influences[2].x;
+        vertex->blendWeights.z = influences[2].y;
     }
     if (size >= 4)
     {
-        vertex->blendIndices.w = vertexWeights[3].x;
-        vertex->blendWeights.w = vertexWeights[3].y;
+        vertex->blendIndices.w = influences[3].x;
+        vertex->blendWeights.w = influences[3].y;
+    }
+
+    // The weights that are kept take over the share of the ones that were dropped.
+    if (size > 0 && size < influences.size())
+    {
+        vertex->normalizeBlendWeight();
     }
-    //vertex->normalizeBlendWeight();
 }
 
 bool loadBlendWeights(FbxMesh* fbxMesh, vector<vector<Vector2> >& weights)
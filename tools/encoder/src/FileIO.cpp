@@ -54,8 +54,27 @@ void write(const float* values, int length, FILE* file)
         write(values[i], file);
     }
 }
+static bool __stringTable = false;
+static std::vector<std::string> __strings;
+static std::map<std::string, unsigned int> __stringIndices;
+
 void write(const std::string& str, FILE* file)
 {
+    if (__stringTable)
+    {
+        std::map<std::string, unsigned int>::const_iterator i = __stringIndices.find(str);
+        if (i != __stringIndices.end())
+        {
+            write(i->second, file);
+            return;
+        }
+        unsigned int index = (unsigned int)__strings.size();
+        __strings.push_back(str);
+        __stringIndices[str] = index;
+        write(index, file);
+        return;
+    }
+
     // Write the length of the string
     write((unsigned int)str.size(), file);
     
@@ -71,6 +90,17 @@ void writeZero(FILE* file)
     write((unsigned int)0, file);
 }
 
+void writePadding(unsigned int alignment, FILE* file)
+{
+    long position = ftell(file);
+    if (position < 0)
+        return;
+    for (unsigned int i = (alignment - (unsigned int)(position % alignment)) % alignment; i > 0; --i)
+    {
+        write((unsigned char)0, file);
+    }
+}
+
 // Writing to a text file //
 
 void fprintfElement(FILE* file, const char* elementName, const float values[], int length)
@@ -122,8 +152,37 @@ void fprintfMatrix4f(FILE* file, const float* m)
         }
     }
 }
+void beginStringTable()
+{
+    __strings.clear();
+    __stringIndices.clear();
+    __strings.push_back(std::string());
+    __stringIndices[std::string()] = 0;
+    __stringTable = true;
+}
+
+void endStringTable(FILE* file)
+{
+    __stringTable = false;
+    write((unsigned int)__strings.size(), file);
+    for (std::vector<std::string>::const_iterator i = __strings.begin(); i != __strings.end(); ++i)
+    {
+        write(*i, file);
+    }
+    __strings.clear();
+    __stringIndices.clear();
+}
+
 void skipString(FILE* file)
 {
+    // A string of the string table is only its index, which the unsigned int that follows
+    // it is skipped along with, as below.
+    if (__stringTable)
+    {
+        fseek(file, sizeof(unsigned int) * 2, SEEK_CUR);
+        return;
+    }
+
     // get the size of the char array
     unsigned int length = 0;
     fread(&length, sizeof(unsigned int), 1, file);
@@ -70,12 +70,54 @@ void write(float value, FILE* file);
 void write(const float* values, int length, FILE* file);
 
 /**
- * Writes the length of the string and the string bytes to the binary file stream.
+ * Writes the length of the string and the string bytes to the binary file stream,
+ * or the index of the string in the string table while one is being built.
  */
 void write(const std::string& str, FILE* file);
 
+/**
+ * Starts writing strings as indices into a string table, so that each distinct string
+ * of a file is written once. The first string of the table is always the empty string.
+ */
+void beginStringTable();
+
+/**
+ * Writes the count and the strings of the string table to the binary file stream,
+ * and stops writing strings as indices.
+ *
+ * @param file The binary file stream.
+ */
+void endStringTable(FILE* file);
+
 void writeZero(FILE* file);
 
+/**
+ * Writes zero bytes until the position of the binary file stream is a multiple of the given alignment.
+ *
+ * @param alignment The alignment in bytes.
+ * @param file The binary file stream.
+ */
+void writePadding(unsigned int alignment, FILE* file);
+
+/**
+ * Writes the length of the vector, followed by padding to four bytes and each element value,
+ * so that the values can be used in place when the file is mapped into memory.
+ *
+ * @param vector The vector to write.
+ * @param file The binary file stream.
+ */
+template <class T>
+void writeAligned(const std::vector<T>& vector, FILE* file)
+{
+    write((unsigned int)vector.size(), file);
+    writePadding(4, file);
+    typename std::vector<T>::const_iterator i;
+    for (i = vector.begin(); i != vector.end(); ++i)
+    {
+        write(*i, file);
+    }
+}
+
 /**
  * Writes the length of the list and writes each element value to the binary file stream.
  * 
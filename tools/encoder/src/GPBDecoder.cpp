@@ -1,11 +1,37 @@
 #include "Base.h"
 #include "GPBDecoder.h"
+#include "GPBFile.h"
+#include "VertexElement.h"
+#include "MeshPart.h"
+#include "AnimationChannel.h"
+#include "Transform.h"
+#include "Camera.h"
+#include "Light.h"
+#include "Font.h"
+
+// Node types, which match those written by Node.
+#define NODE 1
+#define JOINT 2
+
+// The most joints a skin should have. Each joint takes three vec4 uniforms of the matrix palette,
+// and OpenGL ES 2.0 only guarantees 128 vertex uniforms in all.
+#define GPB_MAX_SKIN_JOINTS 32
+
+// The relative error within which an interpolated key matches the key it would replace.
+#define GPB_REDUNDANT_KEY_TOLERANCE 0.00001f
 
 namespace gameplay
 {
 
-GPBDecoder::GPBDecoder(void) : _file(NULL), _outFile(NULL)
+static std::string format(const char* str, ...);
+static void fprintfJson(FILE* file, const std::string& str);
+static const char* primitiveTypeStr(unsigned int primitiveType);
+static unsigned int indexSize(unsigned int indexFormat);
+
+GPBDecoder::GPBDecoder(void) :
+    _file(NULL), _fileSize(0), _refTableByteSize(0), _stringCount(0), _stringByteSize(0)
 {
+    _version[0] = _version[1] = 0;
 }
 
 
@@ -13,28 +39,56 @@ GPBDecoder::~GPBDecoder(void)
 {
 }
 
-void GPBDecoder::readBinary(const std::string& filepath)
+bool GPBDecoder::readBinary(const std::string& filepath, bool json)
 {
-    // open files
+    _path = filepath;
     _file = fopen(filepath.c_str(), "rb");
-    std::string outfilePath = filepath;
-    outfilePath += ".xml";
-    _outFile = fopen(outfilePath.c_str(), "w");
-
-    // read and write files
-    assert(validateHeading());
-
-    fprintf(_outFile, "<root>\n");
-    readRefs();
-    fprintf(_outFile, "</root>\n");
-
-
-    // close files
-    fclose(_outFile);
-    _outFile = NULL;
+    if (!_file)
+    {
+        LOG(1, "Error: Failed to open file: %s\n", filepath.c_str());
+        return false;
+    }
+    fseek(_file, 0, SEEK_END);
+    _fileSize = (unsigned int)ftell(_file);
+    fseek(_file, 0, SEEK_SET);
 
+    bool result = validateHeading();
+    if (!result)
+    {
+        _errors.push_back("Not a GPB file.");
+    }
+    else
+    {
+        if (_version[0] != GPB_VERSION[0] || _version[1] != GPB_VERSION[1])
+        {
+            _hazards.push_back(format("The bundle is version %u.%u, but the encoder reads version %u.%u. Objects may not be read correctly.",
+                _version[0], _version[1], GPB_VERSION[0], GPB_VERSION[1]));
+        }
+        result = readStringTable() && readRefs() && readObjects();
+    }
     fclose(_file);
     _file = NULL;
+
+    findHazards();
+    if (json)
+    {
+        std::string outfilePath = filepath;
+        outfilePath += ".json";
+        FILE* file = fopen(outfilePath.c_str(), "w");
+        if (!file)
+        {
+            LOG(1, "Error: Failed to open file: %s\n", outfilePath.c_str());
+            return false;
+        }
+        writeJson(file);
+        fclose(file);
+        LOG(1, "Report written to: %s\n", outfilePath.c_str());
+    }
+    else
+    {
+        writeText();
+    }
+    return result && _errors.empty();
 }
 
 bool GPBDecoder::validateHeading()
@@ -43,7 +97,10 @@ bool GPBDecoder::validateHeading()
     const char identifier[] = "\xABGPB\xBB\r\n\x1A\n";
 
     char heading[HEADING_SIZE];
-    fread(heading, sizeof(unsigned char), HEADING_SIZE, _file);
+    if (fread(heading, sizeof(unsigned char), HEADING_SIZE, _file) != HEADING_SIZE)
+    {
+        return false;
+    }
     for (size_t i = 0; i < HEADING_SIZE; ++i)
     {
         if (heading[i] != identifier[i])
@@ -52,38 +109,517 @@ bool GPBDecoder::validateHeading()
         }
     }
     // read version
-    unsigned char version[2];
-    fread(version, sizeof(unsigned char), 2, _file);
-    // don't care about version
+    return fread(_version, sizeof(unsigned char), 2, _file) == 2;
+}
 
+bool GPBDecoder::readStringTable()
+{
+    if (_version[0] < 1 || (_version[0] == 1 && _version[1] < 11))
+    {
+        return true;
+    }
+    unsigned int offset = 0;
+    if (!read(&offset))
+    {
+        _errors.push_back("Failed to read the string table offset.");
+        return false;
+    }
+    // Fonts have no string table and write their strings inline.
+    if (offset == 0)
+    {
+        return true;
+    }
+
+    long position = ftell(_file);
+    unsigned int count = 0;
+    if (offset >= _fileSize || fseek(_file, offset, SEEK_SET) != 0 || !read(&count) || count == 0 || count > _fileSize / sizeof(unsigned int))
+    {
+        _errors.push_back("Failed to read the string table.");
+        return false;
+    }
+    std::vector<std::string> strings(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!readString(&strings[i]))
+        {
+            _errors.push_back(format("Failed to read string %u of %u of the string table.", i, count));
+            return false;
+        }
+    }
+    _strings.swap(strings);
+    fseek(_file, position, SEEK_SET);
     return true;
 }
 
-void GPBDecoder::readRefs()
+bool GPBDecoder::readRefs()
 {
-    fprintf(_outFile, "<RefTable>\n");
+    long start = ftell(_file);
     // read number of refs
     unsigned int refCount = 0;
-    assert(read(&refCount));
+    if (!read(&refCount))
+    {
+        _errors.push_back("Failed to read the reference count.");
+        return false;
+    }
     for (size_t i = 0; i < refCount; ++i)
     {
-        readRef();
+        if (!readRef())
+        {
+            _errors.push_back(format("Failed to read reference %u of %u.", (unsigned int)i, refCount));
+            return false;
+        }
+    }
+    _refTableByteSize = (unsigned int)(ftell(_file) - start);
+    return true;
+}
+
+bool GPBDecoder::readRef()
+{
+    Ref ref;
+    if (!readString(&ref.xref) || !read(&ref.type) || !read(&ref.offset))
+    {
+        return false;
+    }
+    _refs.push_back(ref);
+    _ids[ref.offset] = ref.xref;
+    return true;
+}
+
+/**
+ * Orders references by their offset in the file.
+ */
+template <class T>
+static bool compareOffsets(const T& r1, const T& r2)
+{
+    return r1.offset < r2.offset;
+}
+
+bool GPBDecoder::readObjects()
+{
+    // Objects are read in the order they were written. The references to objects that are written
+    // inside other ones, such as the nodes of a scene or the cameras of nodes, point into the
+    // object that was read before them.
+    std::vector<Ref> refs(_refs);
+    std::stable_sort(refs.begin(), refs.end(), compareOffsets<Ref>);
+    unsigned int end = 0;
+    for (std::vector<Ref>::const_iterator i = refs.begin(); i != refs.end(); ++i)
+    {
+        const Ref& ref = *i;
+        if (ref.offset < end)
+            continue;
+        if (ref.offset == 0 || ref.offset >= _fileSize)
+        {
+            _errors.push_back(format("Reference '%s' has an invalid offset %u.", ref.xref.c_str(), ref.offset));
+            continue;
+        }
+        if (fseek(_file, ref.offset, SEEK_SET) != 0)
+            return false;
+
+        bool result;
+        switch (ref.type)
+        {
+        case Object::SCENE_ID:
+            result = readScene(ref);
+            break;
+        case Object::NODE_ID:
+            result = readSceneless(ref);
+            break;
+        case Object::MESH_ID:
+            result = readMesh(ref);
+            break;
+        case Object::ANIMATIONS_ID:
+            result = readAnimations(ref);
+            break;
+        case Object::FONT_ID:
+            result = readFont(ref);
+            break;
+        default:
+            _errors.push_back(format("Reference '%s' has an unexpected type %u.", ref.xref.c_str(), ref.type));
+            continue;
+        }
+        if (!result)
+        {
+            _errors.push_back(format("Failed to read '%s' at offset %u.", ref.xref.c_str(), ref.offset));
+            return false;
+        }
+        end = (unsigned int)ftell(_file);
+    }
+    return true;
+}
+
+void GPBDecoder::initialize(SceneInfo* scene, const Ref& ref)
+{
+    scene->id = ref.xref;
+    scene->sceneless = false;
+    scene->offset = ref.offset;
+    scene->byteSize = 0;
+    scene->nodeCount = 0;
+    scene->jointCount = 0;
+    scene->modelCount = 0;
+    scene->cameraCount = 0;
+    scene->lightCount = 0;
+}
+
+bool GPBDecoder::readScene(const Ref& ref)
+{
+    SceneInfo scene;
+    initialize(&scene, ref);
+
+    unsigned int nodeCount;
+    if (!read(&nodeCount))
+        return false;
+    for (unsigned int i = 0; i < nodeCount; ++i)
+    {
+        if (!readNode(&scene))
+            return false;
+    }
+
+    // active camera and ambient color
+    std::string camera;
+    if (!readString(&camera) || !skip(Light::COLOR_SIZE * sizeof(float)))
+        return false;
+
+    scene.byteSize = (unsigned int)ftell(_file) - ref.offset;
+    _scenes.push_back(scene);
+    return true;
+}
+
+bool GPBDecoder::readSceneless(const Ref& ref)
+{
+    SceneInfo scene;
+    initialize(&scene, ref);
+    scene.sceneless = true;
+    if (!readNode(&scene))
+        return false;
+
+    scene.byteSize = (unsigned int)ftell(_file) - ref.offset;
+    _scenes.push_back(scene);
+    return true;
+}
+
+bool GPBDecoder::readNode(SceneInfo* scene)
+{
+    unsigned int offset = (unsigned int)ftell(_file);
+    unsigned int type;
+    std::string parent;
+    unsigned int childCount;
+    if (!read(&type) || !skip(16 * sizeof(float)) || !readString(&parent) || !read(&childCount))
+        return false;
+
+    ++scene->nodeCount;
+    if (type == JOINT)
+        ++scene->jointCount;
+
+    for (unsigned int i = 0; i < childCount; ++i)
+    {
+        if (!readNode(scene))
+            return false;
+    }
+
+    // camera
+    unsigned char cameraType;
+    if (!read(&cameraType))
+        return false;
+    if (cameraType != 0)
+    {
+        ++scene->cameraCount;
+        if (!readCamera(cameraType))
+            return false;
+    }
+
+    // light
+    unsigned char lightType;
+    if (!read(&lightType))
+        return false;
+    if (lightType != 0)
+    {
+        ++scene->lightCount;
+        if (!readLight(lightType))
+            return false;
+    }
+
+    // model
+    std::map<unsigned int, std::string>::const_iterator id = _ids.find(offset);
+    return readModel(id != _ids.end() ? id->second : std::string(), scene);
+}
+
+bool GPBDecoder::readCamera(unsigned char type)
+{
+    // aspect ratio, near plane and far plane, followed by the field of view or the viewport size
+    switch (type)
+    {
+    case Camera::CameraPerspective:
+        return skip(4 * sizeof(float));
+    case Camera::CameraOrthographic:
+        return skip(5 * sizeof(float));
+    default:
+        return false;
+    }
+}
+
+bool GPBDecoder::readLight(unsigned char type)
+{
+    // color, followed by the range and the inner and outer angles
+    switch (type)
+    {
+    case Light::DirectionalLight:
+        return skip(Light::COLOR_SIZE * sizeof(float));
+    case Light::PointLight:
+        return skip((Light::COLOR_SIZE + 1) * sizeof(float));
+    case Light::SpotLight:
+        return skip((Light::COLOR_SIZE + 3) * sizeof(float));
+    default:
+        return false;
+    }
+}
+
+bool GPBDecoder::readModel(const std::string& nodeId, SceneInfo* scene)
+{
+    // A node without a model writes an empty mesh xref and nothing else.
+    std::string mesh;
+    if (!readString(&mesh))
+        return false;
+    if (mesh.length() <= 1 || mesh[0] != '#')
+        return true;
+
+    ++scene->modelCount;
+
+    unsigned char hasSkin;
+    if (!read(&hasSkin))
+        return false;
+    if (hasSkin)
+    {
+        SkinInfo skin;
+        skin.nodeId = nodeId;
+        std::string joint;
+        unsigned int bindPoseValueCount;
+        if (!skip(16 * sizeof(float)) || !read(&skin.jointCount))
+            return false;
+        for (unsigned int i = 0; i < skin.jointCount; ++i)
+        {
+            if (!readString(&joint))
+                return false;
+        }
+        if (!read(&bindPoseValueCount) || !skip(bindPoseValueCount * sizeof(float)))
+            return false;
+
+        // the joints of the palette of each mesh part, since version 1.9
+        skin.paletteCount = 0;
+        skin.maxPaletteJointCount = 0;
+        if (_version[0] > 1 || (_version[0] == 1 && _version[1] >= 9))
+        {
+            if (!read(&skin.paletteCount))
+                return false;
+            for (unsigned int i = 0; i < skin.paletteCount; ++i)
+            {
+                unsigned int paletteJointCount;
+                if (!read(&paletteJointCount) || !skip(paletteJointCount * sizeof(unsigned int)))
+                    return false;
+                skin.maxPaletteJointCount = std::max(skin.maxPaletteJointCount, paletteJointCount);
+            }
+        }
+
+        // the bounds of the vertices of each joint, since version 1.10
+        if (_version[0] > 1 || (_version[0] == 1 && _version[1] >= 10))
+        {
+            unsigned int jointBoundsCount;
+            if (!read(&jointBoundsCount) || !skip(jointBoundsCount * 6 * sizeof(float)))
+                return false;
+        }
+        _skins.push_back(skin);
+    }
+
+    // materials
+    unsigned int materialCount;
+    std::string material;
+    if (!read(&materialCount))
+        return false;
+    for (unsigned int i = 0; i < materialCount; ++i)
+    {
+        if (!readString(&material))
+            return false;
+    }
+
+    // levels of detail
+    unsigned int lodCount;
+    std::string lodMesh;
+    if (!read(&lodCount))
+        return false;
+    for (unsigned int i = 0; i < lodCount; ++i)
+    {
+        if (!readString(&lodMesh) || !skip(sizeof(float)))
+            return false;
+    }
+
+    // the lightmap path, scale and offset, since version 1.12
+    if (_version[0] > 1 || (_version[0] == 1 && _version[1] >= 12))
+    {
+        std::string lightmap;
+        if (!readString(&lightmap) || !skip(4 * sizeof(float)))
+            return false;
+    }
+    return true;
+}
+
+bool GPBDecoder::readMesh(const Ref& ref)
+{
+    MeshInfo mesh;
+    mesh.id = ref.xref;
+    mesh.offset = ref.offset;
+    mesh.vertexSize = 0;
+    mesh.vertexCount = 0;
+
+    // vertex format
+    unsigned int elementCount;
+    if (!read(&elementCount))
+        return false;
+    for (unsigned int i = 0; i < elementCount; ++i)
+    {
+        VertexElementInfo element;
+        unsigned int normalized;
+        if (!read(&element.usage) || !read(&element.size) || !read(&element.type) || !read(&normalized))
+            return false;
+        element.normalized = normalized != 0;
+        mesh.vertexFormat.push_back(element);
+        mesh.vertexSize += VertexElement(element.usage, element.size, (VertexElement::Type)element.type, element.normalized).byteSize();
+    }
+
+    // vertices, which are aligned unless there are none
+    if (!read(&mesh.vertexByteSize))
+        return false;
+    if (mesh.vertexByteSize > 0 && (!skipPadding(GPB_MESH_DATA_ALIGNMENT) || !skip(mesh.vertexByteSize)))
+        return false;
+    if (mesh.vertexSize > 0)
+        mesh.vertexCount = mesh.vertexByteSize / mesh.vertexSize;
+
+    // bounds: min, max, center and radius
+    if (!skip(10 * sizeof(float)))
+        return false;
+
+    // parts
+    unsigned int partCount;
+    if (!read(&partCount))
+        return false;
+    for (unsigned int i = 0; i < partCount; ++i)
+    {
+        MeshPartInfo part;
+        if (!read(&part.primitiveType) || !read(&part.indexFormat) || !read(&part.byteSize))
+            return false;
+        if (!skipPadding(GPB_MESH_DATA_ALIGNMENT) || !skip(part.byteSize))
+            return false;
+        part.indexCount = part.byteSize / indexSize(part.indexFormat);
+        mesh.parts.push_back(part);
+    }
+
+    mesh.byteSize = (unsigned int)ftell(_file) - ref.offset;
+    _meshes.push_back(mesh);
+    return true;
+}
+
+bool GPBDecoder::readAnimations(const Ref& ref)
+{
+    unsigned int animationCount;
+    if (!read(&animationCount))
+        return false;
+    for (unsigned int i = 0; i < animationCount; ++i)
+    {
+        // Animations write their own IDs because they are not listed in the ref table.
+        AnimationInfo animation;
+        animation.offset = (unsigned int)ftell(_file);
+        unsigned int channelCount;
+        if (!readString(&animation.id) || !read(&channelCount))
+            return false;
+        for (unsigned int j = 0; j < channelCount; ++j)
+        {
+            AnimationChannelInfo channel;
+            if (!readAnimationChannel(&channel))
+                return false;
+            animation.channels.push_back(channel);
+        }
+        animation.byteSize = (unsigned int)ftell(_file) - animation.offset;
+        _animations.push_back(animation);
+    }
+    return true;
+}
+
+bool GPBDecoder::readAnimationChannel(AnimationChannelInfo* channel)
+{
+    unsigned int offset = (unsigned int)ftell(_file);
+    if (!readString(&channel->targetId) || !read(&channel->targetAttrib))
+        return false;
+
+    // key times, key values, tangents in, tangents out and interpolations, each aligned to 4 bytes
+    std::vector<unsigned int> keyTimes;
+    std::vector<float> keyValues;
+    std::vector<unsigned int> interpolations;
+    unsigned int count;
+    if (!read(&count) || !skipPadding(4) || count > _fileSize / sizeof(unsigned int))
+        return false;
+    keyTimes.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!read(&keyTimes[i]))
+            return false;
+    }
+    if (!read(&count) || !skipPadding(4) || count > _fileSize / sizeof(float))
+        return false;
+    keyValues.resize(count);
+    if (count > 0 && !read(&keyValues[0], count))
+        return false;
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!read(&count) || !skipPadding(4) || !skip(count * sizeof(float)))
+            return false;
+    }
+    if (!read(&count) || !skipPadding(4) || count > _fileSize / sizeof(unsigned int))
+        return false;
+    interpolations.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        if (!read(&interpolations[i]))
+            return false;
     }
-    fprintf(_outFile, "</RefTable>\n");
+
+    channel->keyCount = (unsigned int)keyTimes.size();
+    channel->valueCount = (unsigned int)keyValues.size();
+    channel->redundantKeyCount = countRedundantKeys(keyTimes, keyValues, interpolations);
+    channel->byteSize = (unsigned int)ftell(_file) - offset;
+    return true;
 }
 
-void GPBDecoder::readRef()
+bool GPBDecoder::readFont(const Ref& ref)
 {
-    std::string xref = readString(_file);
-    unsigned int type = 0, offset = 0;
-    assert(read(&type));
-    assert(read(&offset));
-    
-    fprintf(_outFile, "<Reference>\n");
-    fprintfElement(_outFile, "xref", xref);
-    fprintfElement(_outFile, "type", type);
-    fprintfElement(_outFile, "offset", offset);
-    fprintf(_outFile, "</Reference>\n");
+    FontInfo font;
+    font.id = ref.xref;
+    font.offset = ref.offset;
+    font.glyphCount = 0;
+    font.textureByteSize = 0;
+    font.format = Font::BITMAP;
+
+    // family, style and the number of sizes
+    std::string family;
+    unsigned int style;
+    if (!readString(&family) || !read(&style) || !read(&font.sizeCount))
+        return false;
+    for (unsigned int i = 0; i < font.sizeCount; ++i)
+    {
+        // size, character set and glyphs: code, width, bearing, advance and texture coordinates
+        unsigned int size, glyphCount;
+        std::string charset;
+        if (!read(&size) || !readString(&charset) || !read(&glyphCount) || !skip(glyphCount * 8 * sizeof(unsigned int)))
+            return false;
+        font.glyphCount += glyphCount;
+
+        // texture width, height, data and format
+        unsigned int width, height, textureByteSize;
+        if (!read(&width) || !read(&height) || !read(&textureByteSize) || !skip(textureByteSize) || !read(&font.format))
+            return false;
+        font.textureByteSize += textureByteSize;
+    }
+
+    font.byteSize = (unsigned int)ftell(_file) - ref.offset;
+    _fonts.push_back(font);
+    return true;
 }
 
 bool GPBDecoder::read(unsigned int* ptr)
@@ -91,28 +627,405 @@ bool GPBDecoder::read(unsigned int* ptr)
     return fread(ptr, sizeof(unsigned int), 1, _file) == 1;
 }
 
-std::string GPBDecoder::readString(FILE* fp)
+bool GPBDecoder::read(unsigned char* ptr)
+{
+    return fread(ptr, sizeof(unsigned char), 1, _file) == 1;
+}
+
+bool GPBDecoder::read(float* ptr, unsigned int count)
 {
+    return fread(ptr, sizeof(float), count, _file) == count;
+}
+
+bool GPBDecoder::readString(std::string* str)
+{
+    if (!_strings.empty())
+    {
+        unsigned int index;
+        if (!read(&index) || index >= _strings.size())
+        {
+            return false;
+        }
+        *str = _strings[index];
+        return true;
+    }
+
     unsigned int length;
-    if (fread(&length, 4, 1, fp) != 1)
+    if (!read(&length) || length > _fileSize - (unsigned int)ftell(_file))
+    {
+        return false;
+    }
+
+    str->resize(length);
+    if (length > 0 && fread(&(*str)[0], 1, length, _file) != length)
+    {
+        return false;
+    }
+    ++_stringCount;
+    _stringByteSize += length + sizeof(unsigned int);
+    return true;
+}
+
+bool GPBDecoder::skip(unsigned int count)
+{
+    // Seeking past the end of the file succeeds, so check the size as well.
+    long position = ftell(_file);
+    return position >= 0 && count <= _fileSize - (unsigned int)position && fseek(_file, count, SEEK_CUR) == 0;
+}
+
+bool GPBDecoder::skipPadding(unsigned int alignment)
+{
+    long position = ftell(_file);
+    return position >= 0 && skip((alignment - (unsigned int)(position % alignment)) % alignment);
+}
+
+unsigned int GPBDecoder::countRedundantKeys(const std::vector<unsigned int>& keyTimes, const std::vector<float>& keyValues,
+                                            const std::vector<unsigned int>& interpolations)
+{
+    const size_t keyCount = keyTimes.size();
+    if (keyCount < 2 || keyValues.size() % keyCount != 0)
+        return 0;
+    for (size_t i = 0; i < interpolations.size(); ++i)
+    {
+        if (interpolations[i] != AnimationChannel::LINEAR)
+            return 0;
+    }
+
+    const size_t componentCount = keyValues.size() / keyCount;
+    bool constant = true;
+    unsigned int count = 0;
+    for (size_t i = 1; i < keyCount; ++i)
+    {
+        const float* prev = &keyValues[(i - 1) * componentCount];
+        const float* key = &keyValues[i * componentCount];
+        bool same = true;
+        bool interpolated = i + 1 < keyCount && keyTimes[i + 1] > keyTimes[i - 1];
+        for (size_t j = 0; j < componentCount; ++j)
+        {
+            float tolerance = GPB_REDUNDANT_KEY_TOLERANCE * std::max(1.0f, fabs(key[j]));
+            same &= fabs(key[j] - prev[j]) <= tolerance;
+            if (interpolated)
+            {
+                const float* next = &keyValues[(i + 1) * componentCount];
+                float t = (float)(keyTimes[i] - keyTimes[i - 1]) / (float)(keyTimes[i + 1] - keyTimes[i - 1]);
+                interpolated = fabs(prev[j] + (next[j] - prev[j]) * t - key[j]) <= tolerance;
+            }
+        }
+        constant &= same;
+        if (interpolated)
+            ++count;
+    }
+    return constant ? (unsigned int)keyCount - 1 : count;
+}
+
+void GPBDecoder::findHazards()
+{
+    for (std::vector<MeshInfo>::const_iterator i = _meshes.begin(); i != _meshes.end(); ++i)
+    {
+        const MeshInfo& mesh = *i;
+        if (mesh.vertexCount > 0 && mesh.parts.empty())
+        {
+            _hazards.push_back(format("Mesh '%s' has no parts, so its %u vertices are drawn without indices.", mesh.id.c_str(), mesh.vertexCount));
+        }
+        for (size_t j = 0; j < mesh.parts.size(); ++j)
+        {
+            if (mesh.parts[j].indexCount == 0)
+                _hazards.push_back(format("Part %u of mesh '%s' has no indices.", (unsigned int)j, mesh.id.c_str()));
+        }
+
+        // Positions are left out, since they usually need the precision.
+        std::string floats;
+        for (size_t j = 0; j < mesh.vertexFormat.size(); ++j)
+        {
+            const VertexElementInfo& element = mesh.vertexFormat[j];
+            if (element.type == VertexElement::FLOAT && element.usage != POSITION)
+            {
+                floats += floats.empty() ? "" : ", ";
+                floats += VertexElement::usageStr(element.usage);
+            }
+        }
+        if (!floats.empty())
+        {
+            _hazards.push_back(format("Mesh '%s' stores %s as floats, which -vq would quantize.", mesh.id.c_str(), floats.c_str()));
+        }
+    }
+
+    for (std::vector<SkinInfo>::const_iterator i = _skins.begin(); i != _skins.end(); ++i)
+    {
+        // A skin that is split into part palettes only uploads the palette of one part at a time.
+        if (i->paletteCount > 0 && i->maxPaletteJointCount > GPB_MAX_SKIN_JOINTS)
+        {
+            _hazards.push_back(format("The skin of node '%s' has part palettes of up to %u joints, more than the %u that fit in the vertex uniforms of most devices.",
+                i->nodeId.c_str(), i->maxPaletteJointCount, GPB_MAX_SKIN_JOINTS));
+        }
+        else if (i->paletteCount == 0 && i->jointCount > GPB_MAX_SKIN_JOINTS)
+        {
+            _hazards.push_back(format("The skin of node '%s' has %u joints, more than the %u that fit in the vertex uniforms of most devices.",
+                i->nodeId.c_str(), i->jointCount, GPB_MAX_SKIN_JOINTS));
+        }
+    }
+
+    for (std::vector<AnimationInfo>::const_iterator i = _animations.begin(); i != _animations.end(); ++i)
+    {
+        unsigned int keyCount = 0, redundantKeyCount = 0;
+        for (std::vector<AnimationChannelInfo>::const_iterator j = i->channels.begin(); j != i->channels.end(); ++j)
+        {
+            keyCount += j->keyCount;
+            redundantKeyCount += j->redundantKeyCount;
+        }
+        if (redundantKeyCount > 0)
+        {
+            _hazards.push_back(format("%u of the %u keys of animation '%s' are redundant, which -oa or -oat would remove.",
+                redundantKeyCount, keyCount, i->id.c_str()));
+        }
+    }
+}
+
+void GPBDecoder::writeText()
+{
+    LOG(1, "Bundle: %s\n", _path.c_str());
+    LOG(1, "  Version: %u.%u\n", _version[0], _version[1]);
+    LOG(1, "  Size: %u bytes\n", _fileSize);
+    LOG(1, "  Reference table: %u references, %u bytes\n", (unsigned int)_refs.size(), _refTableByteSize);
+    LOG(1, "  Strings: %u strings, %u bytes\n", _stringCount, _stringByteSize);
+
+    if (!_meshes.empty())
+    {
+        LOG(1, "\nMeshes: %u\n", (unsigned int)_meshes.size());
+    }
+    for (std::vector<MeshInfo>::const_iterator i = _meshes.begin(); i != _meshes.end(); ++i)
+    {
+        LOG(1, "  %s: %u bytes, %u vertices of %u bytes:", i->id.c_str(), i->byteSize, i->vertexCount, i->vertexSize);
+        for (std::vector<VertexElementInfo>::const_iterator j = i->vertexFormat.begin(); j != i->vertexFormat.end(); ++j)
+        {
+            LOG(1, " %s %ux%s%s", VertexElement::usageStr(j->usage), j->size, VertexElement::typeStr((VertexElement::Type)j->type), j->normalized ? " (normalized)" : "");
+        }
+        LOG(1, "\n");
+        for (size_t j = 0; j < i->parts.size(); ++j)
+        {
+            const MeshPartInfo& part = i->parts[j];
+            LOG(1, "    Part %u: %s, %u indices of %u bytes\n", (unsigned int)j, primitiveTypeStr(part.primitiveType), part.indexCount, indexSize(part.indexFormat));
+        }
+    }
+
+    if (!_scenes.empty())
+    {
+        LOG(1, "\nScenes: %u\n", (unsigned int)_scenes.size());
+    }
+    for (std::vector<SceneInfo>::const_iterator i = _scenes.begin(); i != _scenes.end(); ++i)
+    {
+        LOG(1, "  %s%s: %u bytes, %u nodes (%u joints), %u models, %u cameras, %u lights\n", i->id.c_str(), i->sceneless ? " (node)" : "",
+            i->byteSize, i->nodeCount, i->jointCount, i->modelCount, i->cameraCount, i->lightCount);
+    }
+    for (std::vector<SkinInfo>::const_iterator i = _skins.begin(); i != _skins.end(); ++i)
+    {
+        if (i->paletteCount > 0)
+        {
+            LOG(1, "  Skin of %s: %u joints, %u part palettes of up to %u joints\n", i->nodeId.c_str(), i->jointCount, i->paletteCount, i->maxPaletteJointCount);
+        }
+        else
+        {
+            LOG(1, "  Skin of %s: %u joints\n", i->nodeId.c_str(), i->jointCount);
+        }
+    }
+
+    if (!_animations.empty())
+    {
+        LOG(1, "\nAnimations: %u\n", (unsigned int)_animations.size());
+    }
+    for (std::vector<AnimationInfo>::const_iterator i = _animations.begin(); i != _animations.end(); ++i)
+    {
+        unsigned int keyCount = 0, redundantKeyCount = 0;
+        for (std::vector<AnimationChannelInfo>::const_iterator j = i->channels.begin(); j != i->channels.end(); ++j)
+        {
+            keyCount += j->keyCount;
+            redundantKeyCount += j->redundantKeyCount;
+        }
+        LOG(1, "  %s: %u bytes, %u channels, %u keys (%u redundant)\n", i->id.c_str(), i->byteSize, (unsigned int)i->channels.size(), keyCount, redundantKeyCount);
+        for (std::vector<AnimationChannelInfo>::const_iterator j = i->channels.begin(); j != i->channels.end(); ++j)
+        {
+            LOG(2, "    %s %s: %u bytes, %u keys of %u values (%u redundant)\n", j->targetId.c_str(), Transform::getPropertyString(j->targetAttrib),
+                j->byteSize, j->keyCount, j->keyCount > 0 ? j->valueCount / j->keyCount : 0, j->redundantKeyCount);
+        }
+    }
+
+    if (!_fonts.empty())
+    {
+        LOG(1, "\nFonts: %u\n", (unsigned int)_fonts.size());
+    }
+    for (std::vector<FontInfo>::const_iterator i = _fonts.begin(); i != _fonts.end(); ++i)
+    {
+        LOG(1, "  %s: %u bytes, %u sizes, %u glyphs, %u texture bytes, %s\n", i->id.c_str(), i->byteSize, i->sizeCount, i->glyphCount,
+            i->textureByteSize, i->format == Font::DISTANCE_FIELD ? "DISTANCE_FIELD" : "BITMAP");
+    }
+
+    if (!_hazards.empty())
+    {
+        LOG(1, "\nHazards: %u\n", (unsigned int)_hazards.size());
+    }
+    for (std::vector<std::string>::const_iterator i = _hazards.begin(); i != _hazards.end(); ++i)
+    {
+        LOG(1, "  %s\n", i->c_str());
+    }
+
+    if (!_errors.empty())
+    {
+        LOG(1, "\nErrors: %u\n", (unsigned int)_errors.size());
+    }
+    for (std::vector<std::string>::const_iterator i = _errors.begin(); i != _errors.end(); ++i)
+    {
+        LOG(1, "  %s\n", i->c_str());
+    }
+}
+
+void GPBDecoder::writeJson(FILE* file)
+{
+    fprintf(file, "{\n  \"path\": ");
+    fprintfJson(file, _path);
+    fprintf(file, ",\n  \"version\": \"%u.%u\",\n  \"size\": %u,\n", _version[0], _version[1], _fileSize);
+    fprintf(file, "  \"refTable\": { \"count\": %u, \"size\": %u },\n", (unsigned int)_refs.size(), _refTableByteSize);
+    fprintf(file, "  \"strings\": { \"count\": %u, \"size\": %u },\n", _stringCount, _stringByteSize);
+
+    fprintf(file, "  \"meshes\": [");
+    for (std::vector<MeshInfo>::const_iterator i = _meshes.begin(); i != _meshes.end(); ++i)
+    {
+        fprintf(file, "%s\n    { \"id\": ", i == _meshes.begin() ? "" : ",");
+        fprintfJson(file, i->id);
+        fprintf(file, ", \"offset\": %u, \"size\": %u, \"vertexCount\": %u, \"vertexSize\": %u,\n      \"vertexFormat\": [", i->offset, i->byteSize, i->vertexCount, i->vertexSize);
+        for (std::vector<VertexElementInfo>::const_iterator j = i->vertexFormat.begin(); j != i->vertexFormat.end(); ++j)
+        {
+            fprintf(file, "%s{ \"usage\": \"%s\", \"size\": %u, \"type\": \"%s\", \"normalized\": %s }", j == i->vertexFormat.begin() ? "" : ", ",
+                VertexElement::usageStr(j->usage), j->size, VertexElement::typeStr((VertexElement::Type)j->type), j->normalized ? "true" : "false");
+        }
+        fprintf(file, "],\n      \"parts\": [");
+        for (std::vector<MeshPartInfo>::const_iterator j = i->parts.begin(); j != i->parts.end(); ++j)
+        {
+            fprintf(file, "%s{ \"primitiveType\": \"%s\", \"indexCount\": %u, \"indexSize\": %u, \"size\": %u }", j == i->parts.begin() ? "" : ", ",
+                primitiveTypeStr(j->primitiveType), j->indexCount, indexSize(j->indexFormat), j->byteSize);
+        }
+        fprintf(file, "] }");
+    }
+    fprintf(file, "\n  ],\n");
+
+    fprintf(file, "  \"scenes\": [");
+    for (std::vector<SceneInfo>::const_iterator i = _scenes.begin(); i != _scenes.end(); ++i)
+    {
+        fprintf(file, "%s\n    { \"id\": ", i == _scenes.begin() ? "" : ",");
+        fprintfJson(file, i->id);
+        fprintf(file, ", \"sceneless\": %s, \"offset\": %u, \"size\": %u, \"nodeCount\": %u, \"jointCount\": %u, \"modelCount\": %u, \"cameraCount\": %u, \"lightCount\": %u }",
+            i->sceneless ? "true" : "false", i->offset, i->byteSize, i->nodeCount, i->jointCount, i->modelCount, i->cameraCount, i->lightCount);
+    }
+    fprintf(file, "\n  ],\n");
+
+    fprintf(file, "  \"skins\": [");
+    for (std::vector<SkinInfo>::const_iterator i = _skins.begin(); i != _skins.end(); ++i)
     {
-        return std::string();
+        fprintf(file, "%s\n    { \"node\": ", i == _skins.begin() ? "" : ",");
+        fprintfJson(file, i->nodeId);
+        fprintf(file, ", \"jointCount\": %u, \"paletteCount\": %u, \"maxPaletteJointCount\": %u }", i->jointCount, i->paletteCount, i->maxPaletteJointCount);
     }
+    fprintf(file, "\n  ],\n");
 
-    char* str = new char[length + 1];
-    if (length > 0)
+    fprintf(file, "  \"animations\": [");
+    for (std::vector<AnimationInfo>::const_iterator i = _animations.begin(); i != _animations.end(); ++i)
     {
-        if (fread(str, 1, length, fp) != length)
+        fprintf(file, "%s\n    { \"id\": ", i == _animations.begin() ? "" : ",");
+        fprintfJson(file, i->id);
+        fprintf(file, ", \"offset\": %u, \"size\": %u,\n      \"channels\": [", i->offset, i->byteSize);
+        for (std::vector<AnimationChannelInfo>::const_iterator j = i->channels.begin(); j != i->channels.end(); ++j)
         {
-            delete[] str;
-            return std::string();
+            fprintf(file, "%s\n        { \"target\": ", j == i->channels.begin() ? "" : ",");
+            fprintfJson(file, j->targetId);
+            fprintf(file, ", \"attribute\": \"%s\", \"size\": %u, \"keyCount\": %u, \"valueCount\": %u, \"redundantKeyCount\": %u }",
+                Transform::getPropertyString(j->targetAttrib), j->byteSize, j->keyCount, j->valueCount, j->redundantKeyCount);
         }
+        fprintf(file, "\n      ] }");
     }
+    fprintf(file, "\n  ],\n");
 
-    str[length] = '\0';
-    std::string result(str);
-    delete[] str;
-    return result;
+    fprintf(file, "  \"fonts\": [");
+    for (std::vector<FontInfo>::const_iterator i = _fonts.begin(); i != _fonts.end(); ++i)
+    {
+        fprintf(file, "%s\n    { \"id\": ", i == _fonts.begin() ? "" : ",");
+        fprintfJson(file, i->id);
+        fprintf(file, ", \"offset\": %u, \"size\": %u, \"sizeCount\": %u, \"glyphCount\": %u, \"textureSize\": %u, \"format\": \"%s\" }",
+            i->offset, i->byteSize, i->sizeCount, i->glyphCount, i->textureByteSize, i->format == Font::DISTANCE_FIELD ? "DISTANCE_FIELD" : "BITMAP");
+    }
+    fprintf(file, "\n  ],\n");
+
+    fprintf(file, "  \"hazards\": [");
+    for (std::vector<std::string>::const_iterator i = _hazards.begin(); i != _hazards.end(); ++i)
+    {
+        fprintf(file, "%s\n    ", i == _hazards.begin() ? "" : ",");
+        fprintfJson(file, *i);
+    }
+    fprintf(file, "\n  ],\n");
+
+    fprintf(file, "  \"errors\": [");
+    for (std::vector<std::string>::const_iterator i = _errors.begin(); i != _errors.end(); ++i)
+    {
+        fprintf(file, "%s\n    ", i == _errors.begin() ? "" : ",");
+        fprintfJson(file, *i);
+    }
+    fprintf(file, "\n  ]\n}\n");
+}
+
+std::string format(const char* str, ...)
+{
+    char buffer[1024];
+    va_list arguments;
+    va_start(arguments, str);
+    vsnprintf(buffer, sizeof(buffer), str, arguments);
+    va_end(arguments);
+    return buffer;
+}
+
+void fprintfJson(FILE* file, const std::string& str)
+{
+    fputc('"', file);
+    for (size_t i = 0; i < str.size(); ++i)
+    {
+        unsigned char c = (unsigned char)str[i];
+        if (c == '"' || c == '\\')
+            fprintf(file, "\\%c", c);
+        else if (c < 0x20)
+            fprintf(file, "\\u%04x", c);
+        else
+            fputc(c, file);
+    }
+    fputc('"', file);
+}
+
+const char* primitiveTypeStr(unsigned int primitiveType)
+{
+    switch (primitiveType)
+    {
+        case MeshPart::TRIANGLES:
+            return "TRIANGLES";
+        case MeshPart::TRIANGLE_STRIP:
+            return "TRIANGLE_STRIP";
+        case MeshPart::LINES:
+            return "LINES";
+        case MeshPart::LINE_STRIP:
+            return "LINE_STRIP";
+        case MeshPart::POINTS:
+            return "POINTS";
+        default:
+            return "";
+    }
+}
+
+unsigned int indexSize(unsigned int indexFormat)
+{
+    switch (indexFormat)
+    {
+        case MeshPart::INDEX32:
+            return 4;
+        case 0x1401: // GL_UNSIGNED_BYTE
+            return 1;
+        default: // INDEX16
+            return 2;
+    }
 }
 
 }
@@ -1,12 +1,19 @@
 #ifndef GPBDECODER_H_
 #define GPBDECODER_H_
 
+#include <map>
 #include "FileIO.h"
 
 namespace gameplay
 {
 /**
  * This class is used for decoding a GPB file for the purpose of debugging.
+ *
+ * The decoder reads every object of a bundle back and reports the size of each one, the vertex
+ * formats and index counts of meshes, the key counts of animation channels and the size of the
+ * strings and of the reference table. It also reports the performance hazards that it finds, such
+ * as unindexed meshes, float vertex attributes that could be quantized, redundant animation keys
+ * and skins with more joints than a matrix palette can hold on most devices.
  */
 class GPBDecoder
 {
@@ -22,19 +29,161 @@ public:
      */
     ~GPBDecoder(void);
 
-    void readBinary(const std::string& filepath);
+    /**
+     * Reads the bundle and logs a report of its contents.
+     *
+     * @param filepath The path of the bundle.
+     * @param json True to write the report as JSON to <filepath>.json instead of logging it.
+     *
+     * @return True if the whole bundle was read; false if it is not a valid bundle.
+     */
+    bool readBinary(const std::string& filepath, bool json = false);
+
+private:
+
+    struct Ref
+    {
+        std::string xref;
+        unsigned int type;
+        unsigned int offset;
+    };
+
+    struct VertexElementInfo
+    {
+        unsigned int usage;
+        unsigned int size;
+        unsigned int type;
+        bool normalized;
+    };
+
+    struct MeshPartInfo
+    {
+        unsigned int primitiveType;
+        unsigned int indexFormat;
+        unsigned int indexCount;
+        unsigned int byteSize;
+    };
+
+    struct MeshInfo
+    {
+        std::string id;
+        unsigned int offset;
+        unsigned int byteSize;
+        std::vector<VertexElementInfo> vertexFormat;
+        unsigned int vertexSize;
+        unsigned int vertexCount;
+        unsigned int vertexByteSize;
+        std::vector<MeshPartInfo> parts;
+    };
+
+    struct SkinInfo
+    {
+        std::string nodeId;
+        unsigned int jointCount;
+        unsigned int paletteCount;
+        unsigned int maxPaletteJointCount;
+    };
+
+    struct SceneInfo
+    {
+        std::string id;
+        bool sceneless;
+        unsigned int offset;
+        unsigned int byteSize;
+        unsigned int nodeCount;
+        unsigned int jointCount;
+        unsigned int modelCount;
+        unsigned int cameraCount;
+        unsigned int lightCount;
+    };
+
+    struct AnimationChannelInfo
+    {
+        std::string targetId;
+        unsigned int targetAttrib;
+        unsigned int keyCount;
+        unsigned int valueCount;
+        unsigned int redundantKeyCount;
+        unsigned int byteSize;
+    };
+
+    struct AnimationInfo
+    {
+        std::string id;
+        unsigned int offset;
+        unsigned int byteSize;
+        std::vector<AnimationChannelInfo> channels;
+    };
+
+    struct FontInfo
+    {
+        std::string id;
+        unsigned int offset;
+        unsigned int byteSize;
+        unsigned int sizeCount;
+        unsigned int glyphCount;
+        unsigned int textureByteSize;
+        unsigned int format;
+    };
+
     bool validateHeading();
 
-    void readRefs();
-    void readRef();
+    /**
+     * Reads the string table of a bundle from version 1.11 on, which its strings are indices into.
+     */
+    bool readStringTable();
+
+    bool readRefs();
+    bool readRef();
+    bool readObjects();
+
+    static void initialize(SceneInfo* scene, const Ref& ref);
+    bool readScene(const Ref& ref);
+    bool readNode(SceneInfo* scene);
+    bool readSceneless(const Ref& ref);
+    bool readCamera(unsigned char type);
+    bool readLight(unsigned char type);
+    bool readModel(const std::string& nodeId, SceneInfo* scene);
+    bool readMesh(const Ref& ref);
+    bool readAnimations(const Ref& ref);
+    bool readAnimationChannel(AnimationChannelInfo* channel);
+    bool readFont(const Ref& ref);
 
     bool read(unsigned int* ptr);
-    std::string readString(FILE* fp);
+    bool read(unsigned char* ptr);
+    bool read(float* ptr, unsigned int count);
+    bool readString(std::string* str);
+    bool skip(unsigned int count);
+    bool skipPadding(unsigned int alignment);
 
-private:
+    /**
+     * Returns the number of interior keys of a linear channel that the keys on each side of them
+     * interpolate to within a small tolerance, or all but one key if every key is the same.
+     */
+    static unsigned int countRedundantKeys(const std::vector<unsigned int>& keyTimes, const std::vector<float>& keyValues,
+                                           const std::vector<unsigned int>& interpolations);
+
+    void findHazards();
+    void writeText();
+    void writeJson(FILE* file);
 
     FILE* _file;
-    FILE* _outFile;
+    std::string _path;
+    unsigned char _version[2];
+    unsigned int _fileSize;
+    unsigned int _refTableByteSize;
+    unsigned int _stringCount;
+    unsigned int _stringByteSize;
+    std::vector<std::string> _strings;
+    std::vector<Ref> _refs;
+    std::map<unsigned int, std::string> _ids;
+    std::vector<MeshInfo> _meshes;
+    std::vector<SceneInfo> _scenes;
+    std::vector<SkinInfo> _skins;
+    std::vector<AnimationInfo> _animations;
+    std::vector<FontInfo> _fonts;
+    std::vector<std::string> _hazards;
+    std::vector<std::string> _errors;
 };
 
 }
@@ -1,12 +1,18 @@
+#include <climits>
+
 #include "Base.h"
 #include "GPBFile.h"
 #include "Transform.h"
 #include "StringUtil.h"
 #include "EncoderArguments.h"
 #include "Heightmap.h"
+#include "NavMeshGenerator.h"
 
 #define EPSILON 1.2e-7f;
 
+// The number of vertices that a merged mesh is kept below, so that it can use 16-bit indices.
+#define MERGED_MESH_VERTEX_LIMIT 65536
+
 namespace gameplay
 {
 
@@ -41,6 +47,36 @@ static Node* getCommonNodeAncestor(const std::vector<Node*>& nodes);
  */
 static void getNodeAncestors(Node* node, std::list<Node*>& ancestors);
 
+/**
+ * A triangle mesh part of a static node, which can be merged with those of other nodes.
+ */
+struct StaticMeshPart
+{
+    Node* node;
+    Mesh* mesh;
+    MeshPart* part;
+    Material* material;
+    unsigned int vertexCount;
+};
+
+/**
+ * Adds the triangle mesh parts of the static nodes under the given node to the group of their
+ * material, vertex format and cell. Nodes that are animated or are joints aren't static, and
+ * neither are their descendants.
+ */
+static void collectStaticMeshParts(Node* node, const std::set<std::string>& animatedIds, const std::set<std::string>& keepIds,
+                                   float cellSize, std::map<std::string, std::vector<StaticMeshPart> >& groups);
+
+/**
+ * Transforms a direction by the upper 3x3 of the given column-major matrix.
+ */
+static void transformDirection(const float* m, const Vector3& v, Vector3* dst);
+
+/**
+ * Appends the triangles of the given mesh part, transformed to world space, to a merged mesh and part.
+ */
+static void appendMeshPart(const StaticMeshPart& source, Mesh* mesh, MeshPart* part);
+
 
 GPBFile::GPBFile(void)
     : _file(NULL), _animationsAdded(false)
@@ -85,6 +121,11 @@ bool GPBFile::saveBinary(const std::string& filepath)
 
     // TODO: Check for errors on all file writing.
 
+    // The offset of the string table, which is written once all strings are known.
+    long stringTableOffsetPosition = ftell(_file);
+    write((unsigned int)0, _file);
+    beginStringTable();
+
     // write refs
     _refTable.writeBinary(_file);
 
@@ -103,7 +144,13 @@ bool GPBFile::saveBinary(const std::string& filepath)
     }
 
     _refTable.updateOffsets(_file);
-    
+
+    fseek(_file, 0, SEEK_END);
+    unsigned int stringTableOffset = (unsigned int)ftell(_file);
+    endStringTable(_file);
+    fseek(_file, stringTableOffsetPosition, SEEK_SET);
+    write(stringTableOffset, _file);
+
     fclose(_file);
     return true;
 }
@@ -315,6 +362,14 @@ void GPBFile::adjust()
         }
     }
 
+    // Merge before bounds are computed, so that each merged mesh gets the bounds of its cell.
+    const float mergeCellSize = EncoderArguments::getInstance()->getMergeCellSize();
+    if (mergeCellSize > 0.0f)
+    {
+        LOG(1, "Merging static meshes.\n");
+        mergeStaticMeshes(mergeCellSize);
+    }
+
     for (std::list<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
     {
         computeBounds(*i);
@@ -326,6 +381,33 @@ void GPBFile::adjust()
         optimizeAnimations();
     }
 
+    // Split after the joint bounds are computed from the blend indices of the whole skin, and
+    // before levels of detail are generated, so that every level has the parts of the mesh.
+    const unsigned int maxSkinJoints = EncoderArguments::getInstance()->getMaxSkinJoints();
+    if (maxSkinJoints > 0)
+    {
+        LOG(1, "Splitting skinned meshes.\n");
+        splitSkinnedMeshes(maxSkinJoints);
+    }
+
+    if (EncoderArguments::getInstance()->getLODCount() > 0)
+    {
+        LOG(1, "Generating levels of detail.\n");
+        generateLODs();
+    }
+
+    if (EncoderArguments::getInstance()->optimizeMeshesEnabled())
+    {
+        LOG(1, "Optimizing meshes.\n");
+        optimizeMeshes();
+    }
+
+    if (EncoderArguments::getInstance()->quantizeVerticesEnabled())
+    {
+        LOG(1, "Quantizing vertices.\n");
+        quantizeVertices();
+    }
+
     // TODO:
     // remove ambient _lights
     // for each node
@@ -345,6 +427,13 @@ void GPBFile::adjust()
     {
         Heightmap::generate(heightmaps[i].nodeIds, heightmaps[i].width, heightmaps[i].height, heightmaps[i].filename.c_str(), heightmaps[i].isHighPrecision);
     }
+
+    // Generate navigation meshes
+    const std::vector<EncoderArguments::NavMeshOption>& navMeshes = EncoderArguments::getInstance()->getNavMeshOptions();
+    for (unsigned int i = 0, count = navMeshes.size(); i < count; ++i)
+    {
+        NavMeshGenerator::generate(navMeshes[i].nodeIds, navMeshes[i].maxSlope, navMeshes[i].filename.c_str());
+    }
 }
 
 void GPBFile::groupMeshSkinAnimations()
@@ -398,6 +487,271 @@ void GPBFile::computeBounds(Node* node)
     }
 }
 
+void GPBFile::mergeStaticMeshes(float cellSize)
+{
+    // Nodes that are the targets of animation channels move at runtime.
+    std::set<std::string> animatedIds;
+    for (unsigned int i = 0, animationCount = _animations.getAnimationCount(); i < animationCount; ++i)
+    {
+        Animation* animation = _animations.getAnimation(i);
+        for (unsigned int j = 0, channelCount = animation->getAnimationChannelCount(); j < channelCount; ++j)
+        {
+            animatedIds.insert(animation->getAnimationChannel(j)->getTargetId());
+        }
+    }
+
+    // Heightmaps and navigation meshes are generated from the models of the nodes that they name.
+    std::set<std::string> keepIds;
+    const std::vector<EncoderArguments::HeightmapOption>& heightmaps = EncoderArguments::getInstance()->getHeightmapOptions();
+    for (size_t i = 0, count = heightmaps.size(); i < count; ++i)
+    {
+        keepIds.insert(heightmaps[i].nodeIds.begin(), heightmaps[i].nodeIds.end());
+    }
+    const std::vector<EncoderArguments::NavMeshOption>& navMeshes = EncoderArguments::getInstance()->getNavMeshOptions();
+    for (size_t i = 0, count = navMeshes.size(); i < count; ++i)
+    {
+        keepIds.insert(navMeshes[i].nodeIds.begin(), navMeshes[i].nodeIds.end());
+    }
+
+    std::set<Mesh*> sourceMeshes;
+    unsigned int mergedNodeCount = 0;
+    unsigned int mergedMeshCount = 0;
+    for (std::list<Object*>::const_iterator i = _objects.begin(); i != _objects.end(); ++i)
+    {
+        if ((*i)->getTypeId() != Object::SCENE_ID)
+            continue;
+        Scene* scene = static_cast<Scene*>(*i);
+
+        std::map<std::string, std::vector<StaticMeshPart> > groups;
+        const std::list<Node*>& roots = scene->getNodes();
+        for (std::list<Node*>::const_iterator j = roots.begin(); j != roots.end(); ++j)
+        {
+            collectStaticMeshParts(*j, animatedIds, keepIds, cellSize, groups);
+        }
+
+        // A node is merged only if every one of its parts is merged with another part, since it
+        // would still be drawn otherwise. Dropping a node can leave other groups alone, so repeat.
+        std::set<Node*> rejected;
+        bool changed = true;
+        while (changed)
+        {
+            changed = false;
+            for (std::map<std::string, std::vector<StaticMeshPart> >::iterator g = groups.begin(); g != groups.end(); ++g)
+            {
+                if (g->second.size() == 1 && rejected.insert(g->second[0].node).second)
+                    changed = true;
+            }
+            for (std::map<std::string, std::vector<StaticMeshPart> >::iterator g = groups.begin(); g != groups.end(); ++g)
+            {
+                std::vector<StaticMeshPart>& sources = g->second;
+                for (size_t k = 0; k < sources.size();)
+                {
+                    if (rejected.count(sources[k].node) > 0)
+                        sources.erase(sources.begin() + k);
+                    else
+                        ++k;
+                }
+            }
+        }
+
+        std::set<Node*> merged;
+        for (std::map<std::string, std::vector<StaticMeshPart> >::iterator g = groups.begin(); g != groups.end(); ++g)
+        {
+            const std::vector<StaticMeshPart>& sources = g->second;
+            Mesh* mesh = NULL;
+            MeshPart* part = NULL;
+            for (size_t k = 0, count = sources.size(); k < count; ++k)
+            {
+                const StaticMeshPart& source = sources[k];
+                if (mesh && mesh->getVertexCount() + source.vertexCount > MERGED_MESH_VERTEX_LIMIT)
+                {
+                    addMergedNode(scene, mesh, part, sources[0].material);
+                    ++mergedMeshCount;
+                    mesh = NULL;
+                }
+                if (!mesh)
+                {
+                    mesh = new Mesh();
+                    for (size_t e = 0, elementCount = source.mesh->getVertexElementCount(); e < elementCount; ++e)
+                    {
+                        const VertexElement& element = source.mesh->getVertexElement((unsigned int)e);
+                        mesh->addVetexAttribute(element.usage, element.size);
+                    }
+                    part = new MeshPart();
+                }
+                appendMeshPart(source, mesh, part);
+                sourceMeshes.insert(source.mesh);
+                merged.insert(source.node);
+            }
+            if (mesh)
+            {
+                addMergedNode(scene, mesh, part, sources[0].material);
+                ++mergedMeshCount;
+            }
+        }
+
+        for (std::set<Node*>::iterator j = merged.begin(); j != merged.end(); ++j)
+        {
+            (*j)->setModel(NULL);
+        }
+        mergedNodeCount += (unsigned int)merged.size();
+    }
+
+    // Remove the meshes that no model draws anymore, which keeps those of other instances.
+    for (std::list<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+    {
+        Model* model = (*i)->getModel();
+        if (model)
+            sourceMeshes.erase(model->getMesh());
+    }
+    for (std::list<Mesh*>::iterator i = _geometry.begin(); i != _geometry.end();)
+    {
+        if (sourceMeshes.count(*i) > 0)
+        {
+            if (!(*i)->getId().empty())
+                _refTable.remove((*i)->getId());
+            i = _geometry.erase(i);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+    LOG(1, "Merged the meshes of %u node(s) into %u mesh(es).\n", mergedNodeCount, mergedMeshCount);
+}
+
+void GPBFile::addMergedNode(Scene* scene, Mesh* mesh, MeshPart* part, Material* material)
+{
+    char id[32];
+    static unsigned int mergedId = 0;
+    do
+    {
+        sprintf(id, "merged%u", ++mergedId);
+    } while (idExists(id) || idExists(std::string(id) + "_Mesh"));
+
+    mesh->setId(std::string(id) + "_Mesh");
+    mesh->addMeshPart(part);
+    Model* model = new Model();
+    model->setMesh(mesh);
+    if (material)
+        model->setMaterial(material);
+    Node* node = new Node();
+    node->setId(id);
+    node->setModel(model);
+    scene->add(node);
+    addNode(node);
+    addMesh(mesh);
+}
+
+void GPBFile::splitSkinnedMeshes(unsigned int maxJoints)
+{
+    // A shared mesh can't be split for the palette of one skin.
+    std::map<Mesh*, unsigned int> modelCounts;
+    for (std::list<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+    {
+        Model* model = (*i)->getModel();
+        if (model && model->getMesh())
+            ++modelCounts[model->getMesh()];
+    }
+
+    for (std::list<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+    {
+        Model* model = (*i)->getModel();
+        Mesh* mesh = model ? model->getMesh() : NULL;
+        MeshSkin* skin = model ? model->getSkin() : NULL;
+        if (!skin || skin->getJointCount() <= maxJoints)
+            continue;
+        if (modelCounts[mesh] > 1)
+        {
+            LOG(1, "Warning: Skinned mesh '%s' is shared by more than one node and was not split.\n", mesh->getId().c_str());
+            continue;
+        }
+
+        const unsigned int partCount = (unsigned int)mesh->parts.size();
+        std::vector<std::vector<unsigned int> > palettes;
+        std::vector<unsigned int> partSources;
+        if (!mesh->splitJointPalettes(maxJoints, &palettes, &partSources))
+        {
+            LOG(1, "Warning: Skinned mesh '%s' has parts that are not triangle lists and was not split.\n", mesh->getId().c_str());
+            continue;
+        }
+        skin->setPartPalettes(palettes);
+        model->remapPartMaterials(partSources);
+        LOG(2, "Split skinned mesh '%s' with %u joints from %u into %u part(s).\n", mesh->getId().c_str(),
+            skin->getJointCount(), partCount, (unsigned int)mesh->parts.size());
+    }
+}
+
+void GPBFile::generateLODs()
+{
+    EncoderArguments* arguments = EncoderArguments::getInstance();
+    const unsigned int lodCount = arguments->getLODCount();
+    const float ratio = arguments->getLODRatio();
+
+    // Models that share a mesh also share its levels of detail.
+    std::map<Mesh*, std::vector<Mesh*> > lods;
+    for (std::list<Node*>::const_iterator i = _nodes.begin(); i != _nodes.end(); ++i)
+    {
+        Model* model = (*i)->getModel();
+        Mesh* mesh = model ? model->getMesh() : NULL;
+        if (!mesh)
+            continue;
+
+        std::map<Mesh*, std::vector<Mesh*> >::iterator itr = lods.find(mesh);
+        if (itr == lods.end())
+        {
+            std::vector<Mesh*>& levels = lods[mesh];
+            Mesh* previous = mesh;
+            for (unsigned int level = 1; level <= lodCount; ++level)
+            {
+                // Stop once the mesh can't be simplified much further.
+                Mesh* lod = previous->simplify(ratio);
+                if (!lod || lod->getTriangleCount() == 0 || lod->getTriangleCount() > previous->getTriangleCount() * (1.0f + ratio) * 0.5f)
+                {
+                    delete lod;
+                    break;
+                }
+                char id[16];
+                sprintf(id, "_lod%u", level);
+                lod->setId(mesh->getId() + id);
+                lod->computeBounds();
+                addMesh(lod);
+                levels.push_back(lod);
+                LOG(2, "Generated level of detail '%s' with %u of %u triangles.\n", lod->getId().c_str(),
+                    (unsigned int)lod->getTriangleCount(), (unsigned int)mesh->getTriangleCount());
+                previous = lod;
+            }
+            itr = lods.find(mesh);
+        }
+
+        // Each level is drawn below half the screen size of the level before it.
+        float screenSize = arguments->getLODScreenSize();
+        for (size_t j = 0; j < itr->second.size(); ++j)
+        {
+            model->addLOD(itr->second[j], screenSize);
+            screenSize *= 0.5f;
+        }
+    }
+}
+
+void GPBFile::optimizeMeshes()
+{
+    const bool overdraw = EncoderArguments::getInstance()->optimizeOverdrawEnabled();
+    for (std::list<Mesh*>::const_iterator i = _geometry.begin(); i != _geometry.end(); ++i)
+    {
+        (*i)->optimize(overdraw);
+    }
+}
+
+void GPBFile::quantizeVertices()
+{
+    const bool positions = EncoderArguments::getInstance()->quantizePositionsEnabled();
+    for (std::list<Mesh*>::const_iterator i = _geometry.begin(); i != _geometry.end(); ++i)
+    {
+        (*i)->quantize(positions);
+    }
+}
+
 void GPBFile::optimizeAnimations()
 {
     const unsigned int animationCount = _animations.getAnimationCount();
@@ -427,6 +781,10 @@ void GPBFile::optimizeAnimations()
                     animation->remove(channel);
                     SAFE_DELETE(channel);
                 }
+                else
+                {
+                    optimizeAnimationChannel(channel);
+                }
             }
         }
     }
@@ -484,7 +842,7 @@ void GPBFile::decomposeTransformAnimationChannel(Animation* animation, Animation
         scaleChannel->setInterpolations(channel->getInterpolationTypes());
         scaleChannel->setTargetAttribute(Transform::ANIMATE_SCALE);
         scaleChannel->setKeyValues(scaleKeyValues);
-        scaleChannel->removeDuplicates();
+        optimizeAnimationChannel(scaleChannel);
         animation->add(scaleChannel);
     }
 
@@ -522,7 +880,7 @@ void GPBFile::decomposeTransformAnimationChannel(Animation* animation, Animation
         rotateChannel->setInterpolations(channel->getInterpolationTypes());
         rotateChannel->setTargetAttribute(Transform::ANIMATE_ROTATE);
         rotateChannel->setKeyValues(rotateKeyValues);
-        rotateChannel->removeDuplicates();
+        optimizeAnimationChannel(rotateChannel);
         animation->add(rotateChannel);
     }
 
@@ -543,11 +901,30 @@ void GPBFile::decomposeTransformAnimationChannel(Animation* animation, Animation
         translateChannel->setInterpolations(channel->getInterpolationTypes());
         translateChannel->setTargetAttribute(Transform::ANIMATE_TRANSLATE);
         translateChannel->setKeyValues(translateKeyValues);
-        translateChannel->removeDuplicates();
+        optimizeAnimationChannel(translateChannel);
         animation->add(translateChannel);
     }
 }
 
+void GPBFile::optimizeAnimationChannel(AnimationChannel* channel)
+{
+    EncoderArguments* arguments = EncoderArguments::getInstance();
+
+    unsigned int quantizeBits = arguments->getAnimationQuantizeBits();
+    if (quantizeBits > 0)
+    {
+        channel->quantize(quantizeBits);
+    }
+
+    channel->removeDuplicates();
+
+    float tolerance = arguments->getAnimationTolerance(channel->getTargetAttribute());
+    if (tolerance > 0.0f)
+    {
+        channel->reduceKeys(tolerance);
+    }
+}
+
 void GPBFile::moveAnimationChannels(Node* node, Animation* dstAnimation)
 {
     // Loop through the animations and channels backwards because they will be removed when found.
@@ -576,6 +953,134 @@ void GPBFile::moveAnimationChannels(Node* node, Animation* dstAnimation)
     }
 }
 
+void collectStaticMeshParts(Node* node, const std::set<std::string>& animatedIds, const std::set<std::string>& keepIds,
+                                   float cellSize, std::map<std::string, std::vector<StaticMeshPart> >& groups)
+{
+    if (node->isJoint() || animatedIds.count(node->getId()) > 0)
+        return;
+
+    Model* model = node->getModel();
+    Mesh* mesh = model ? model->getMesh() : NULL;
+    if (mesh && !model->getSkin() && keepIds.count(node->getId()) == 0)
+    {
+        // The vertex format is part of the key, since only meshes with the same vertex elements can be merged.
+        std::ostringstream format;
+        for (size_t i = 0, count = mesh->getVertexElementCount(); i < count; ++i)
+        {
+            const VertexElement& element = mesh->getVertexElement((unsigned int)i);
+            format << element.usage << ':' << element.size << ';';
+        }
+
+        const Matrix& world = node->getWorldMatrix();
+        for (unsigned int i = 0, partCount = (unsigned int)mesh->parts.size(); i < partCount; ++i)
+        {
+            MeshPart* part = mesh->parts[i];
+            if (part->getPrimitiveType() != MeshPart::TRIANGLES || part->getIndicesCount() == 0)
+                continue;
+
+            // Each part goes into the cell that contains the center of its world space bounds.
+            std::vector<bool> used(mesh->vertices.size(), false);
+            unsigned int vertexCount = 0;
+            Vector3 min(FLT_MAX, FLT_MAX, FLT_MAX);
+            Vector3 max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (unsigned int j = 0, indexCount = (unsigned int)part->getIndicesCount(); j < indexCount; ++j)
+            {
+                unsigned int index = part->getIndex(j);
+                if (used[index])
+                    continue;
+                used[index] = true;
+                ++vertexCount;
+                Vector3 position;
+                world.transformPoint(mesh->vertices[index].position, &position);
+                min.set(std::min(min.x, position.x), std::min(min.y, position.y), std::min(min.z, position.z));
+                max.set(std::max(max.x, position.x), std::max(max.y, position.y), std::max(max.z, position.z));
+            }
+
+            StaticMeshPart source;
+            source.node = node;
+            source.mesh = mesh;
+            source.part = part;
+            source.material = model->getMaterial(i);
+            source.vertexCount = vertexCount;
+
+            std::ostringstream key;
+            key << (source.material ? source.material->getId() : std::string()) << '|' << format.str() << '|' <<
+                (int)floor((min.x + max.x) * 0.5f / cellSize) << ',' <<
+                (int)floor((min.y + max.y) * 0.5f / cellSize) << ',' <<
+                (int)floor((min.z + max.z) * 0.5f / cellSize);
+            groups[key.str()].push_back(source);
+        }
+    }
+
+    for (Node* child = node->getFirstChild(); child; child = child->getNextSibling())
+    {
+        collectStaticMeshParts(child, animatedIds, keepIds, cellSize, groups);
+    }
+}
+
+void transformDirection(const float* m, const Vector3& v, Vector3* dst)
+{
+    dst->set(v.x * m[0] + v.y * m[4] + v.z * m[8],
+             v.x * m[1] + v.y * m[5] + v.z * m[9],
+             v.x * m[2] + v.y * m[6] + v.z * m[10]);
+}
+
+void appendMeshPart(const StaticMeshPart& source, Mesh* mesh, MeshPart* part)
+{
+    const Matrix& world = source.node->getWorldMatrix();
+    const float* m = world.m;
+
+    // Normals are transformed by the inverse transpose, whose columns are the cross products of
+    // the columns of the matrix divided by its determinant. Only the sign of the determinant
+    // matters once the normals are normalized.
+    Vector3 c0(m[0], m[1], m[2]), c1(m[4], m[5], m[6]), c2(m[8], m[9], m[10]);
+    float normalMatrix[16];
+    Vector3 n0, n1, n2;
+    Vector3::cross(c1, c2, &n0);
+    Vector3::cross(c2, c0, &n1);
+    Vector3::cross(c0, c1, &n2);
+    const float determinant = c0.x * n0.x + c0.y * n0.y + c0.z * n0.z;
+    const float sign = determinant < 0.0f ? -1.0f : 1.0f;
+    Matrix::setIdentity(normalMatrix);
+    normalMatrix[0] = n0.x * sign; normalMatrix[1] = n0.y * sign; normalMatrix[2] = n0.z * sign;
+    normalMatrix[4] = n1.x * sign; normalMatrix[5] = n1.y * sign; normalMatrix[6] = n1.z * sign;
+    normalMatrix[8] = n2.x * sign; normalMatrix[9] = n2.y * sign; normalMatrix[10] = n2.z * sign;
+
+    std::vector<unsigned int> remap(source.mesh->vertices.size(), UINT_MAX);
+    const unsigned int indexCount = (unsigned int)source.part->getIndicesCount();
+    for (unsigned int i = 0; i < indexCount; ++i)
+    {
+        // A mirroring transform flips the winding of the triangles, so it is flipped back.
+        unsigned int corner = i;
+        if (determinant < 0.0f)
+            corner = i - i % 3 + (3 - i % 3) % 3;
+        unsigned int index = source.part->getIndex(corner);
+        if (remap[index] == UINT_MAX)
+        {
+            Vertex vertex = source.mesh->vertices[index];
+            world.transformPoint(source.mesh->vertices[index].position, &vertex.position);
+            if (vertex.hasNormal)
+            {
+                transformDirection(normalMatrix, source.mesh->vertices[index].normal, &vertex.normal);
+                vertex.normal.normalize();
+            }
+            if (vertex.hasTangent)
+            {
+                transformDirection(m, source.mesh->vertices[index].tangent, &vertex.tangent);
+                vertex.tangent.normalize();
+            }
+            if (vertex.hasBinormal)
+            {
+                transformDirection(m, source.mesh->vertices[index].binormal, &vertex.binormal);
+                vertex.binormal.normalize();
+            }
+            remap[index] = (unsigned int)mesh->vertices.size();
+            mesh->vertices.push_back(vertex);
+        }
+        part->addIndex(remap[index]);
+    }
+}
+
 bool isAlmostOne(float value)
 {
     return (value - 1.0f) < EPSILON;
@@ -21,7 +21,12 @@ namespace gameplay
  * Increment the version number when making a change that break binary compatibility.
  * [0] is major, [1] is minor.
  */
-const unsigned char GPB_VERSION[2] = {1, 5};
+const unsigned char GPB_VERSION[2] = {1, 12};
+
+/**
+ * The alignment in bytes of vertex and index data within the file, from version 1.7.
+ */
+const unsigned int GPB_MESH_DATA_ALIGNMENT = 16;
 
 /**
  * The GamePlay Binary file class handles writing the GamePlay Binary file.
@@ -132,6 +137,42 @@ private:
      */
     void optimizeAnimations();
 
+    /**
+     * Merges the mesh parts of static nodes that share a material and vertex format within
+     * each cell of a grid into one mesh per cell, on a new node at the root of the scene.
+     * The merged nodes keep their place in the hierarchy but lose their models.
+     *
+     * @param cellSize The size of the cubic cells in world units.
+     */
+    void mergeStaticMeshes(float cellSize);
+
+    /**
+     * Adds a node with a model for a merged mesh to the root of the given scene.
+     */
+    void addMergedNode(Scene* scene, Mesh* mesh, MeshPart* part, Material* material);
+
+    /**
+     * Splits the meshes of skinned models whose skins have more than the given number of
+     * joints into parts that each use at most that many, and gives the skins the palette
+     * of each part. Meshes that are used by more than one model are left as they are.
+     */
+    void splitSkinnedMeshes(unsigned int maxJoints);
+
+    /**
+     * Generates simplified levels of detail for the meshes of all models.
+     */
+    void generateLODs();
+
+    /**
+     * Reorders the triangles and vertices of all meshes for the vertex cache.
+     */
+    void optimizeMeshes();
+
+    /**
+     * Switches the vertex elements of all meshes to compact types.
+     */
+    void quantizeVertices();
+
     /**
      * Decomposes an ANIMATE_SCALE_ROTATE_TRANSLATE channel into 3 new channels. (Scale, Rotate and Translate)
      * 
@@ -141,6 +182,14 @@ private:
      */
     void decomposeTransformAnimationChannel(Animation* animation, AnimationChannel* channel, int channelIndex);
 
+    /**
+     * Removes the unneccessary keyframes of an animation channel, quantizing the
+     * key values first if requested.
+     * 
+     * @param channel The animation channel to optimize.
+     */
+    void optimizeAnimationChannel(AnimationChannel* channel);
+
     /**
      * Moves the animation channels that target the given node and its children to be under the given animation.
      * 
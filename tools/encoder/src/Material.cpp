@@ -181,6 +181,24 @@ void Material::setLit(bool value)
     _lit = value;
 }
 
+bool Material::isCompatible(const Material& material, const string& samplerId) const
+{
+    if (_parent != material._parent || _lit != material._lit ||
+        _vertexShader != material._vertexShader || _fragmentShader != material._fragmentShader ||
+        _defines != material._defines || _uniforms != material._uniforms || _renderStates != material._renderStates ||
+        _samplers.size() != material._samplers.size())
+    {
+        return false;
+    }
+    for (vector<Sampler*>::const_iterator it = _samplers.begin(); it != _samplers.end(); ++it)
+    {
+        const Sampler* sampler = material.getSampler((*it)->getId());
+        if (!sampler || !(*it)->equals(*sampler, (*it)->getId() == samplerId))
+            return false;
+    }
+    return true;
+}
+
 void Material::writeMaterial(FILE* file)
 {
     fprintf(file, "material");
@@ -65,6 +65,15 @@ public:
 
     void setLit(bool value);
 
+    /**
+     * Returns true if this material draws the same way as the given one except for the texture
+     * of one sampler, which means that the two can share an atlas of their textures.
+     *
+     * @param material The material to compare to.
+     * @param samplerId The ID of the sampler whose texture may differ.
+     */
+    bool isCompatible(const Material& material, const std::string& samplerId) const;
+
     /**
      * Writes this material to the given file.
      */
@@ -0,0 +1,389 @@
+#include <set>
+#include "Base.h"
+#include "MaterialAtlas.h"
+#include "Image.h"
+#include "StringUtil.h"
+
+// The pixels around each texture in an atlas that repeat its edges, so that filtering and
+// the smaller mipmaps don't blend in the textures next to it.
+#define ATLAS_PADDING 4
+
+// How far texture coordinates may be outside of [0, 1] before a texture is treated as repeating.
+#define ATLAS_UV_TOLERANCE 0.001f
+
+// The sampler of the textures that are packed.
+#define ATLAS_SAMPLER "u_diffuseTexture"
+
+namespace gameplay
+{
+
+/**
+ * A texture that is packed into an atlas.
+ */
+struct AtlasEntry
+{
+    Material* material;
+    Image* image;
+    unsigned int page;
+    unsigned int x;
+    unsigned int y;
+};
+
+/**
+ * An atlas image and the textures that are packed into it.
+ */
+struct AtlasPage
+{
+    std::vector<unsigned int> entries;
+    unsigned int width;
+    unsigned int height;
+    unsigned int shelfX;
+    unsigned int shelfY;
+    unsigned int shelfHeight;
+    Material* material;
+};
+
+typedef std::pair<Mesh*, unsigned int> MeshPartKey;
+
+static unsigned int nextPowerOfTwo(unsigned int value)
+{
+    unsigned int result = 1;
+    while (result < value)
+        result <<= 1;
+    return result;
+}
+
+static bool isTallerEntry(const AtlasEntry* a, const AtlasEntry* b)
+{
+    return a->image->getHeight() > b->image->getHeight();
+}
+
+/**
+ * Returns true if the texture coordinates of all the vertices of the part are within [0, 1].
+ */
+static bool isUnitTexCoords(const Mesh* mesh, const MeshPart* part)
+{
+    for (unsigned int i = 0, count = (unsigned int)part->getIndicesCount(); i < count; ++i)
+    {
+        const Vector2& uv = mesh->getVertex(part->getIndex(i)).texCoord[0];
+        if (uv.x < -ATLAS_UV_TOLERANCE || uv.x > 1.0f + ATLAS_UV_TOLERANCE || uv.y < -ATLAS_UV_TOLERANCE || uv.y > 1.0f + ATLAS_UV_TOLERANCE)
+            return false;
+    }
+    return true;
+}
+
+static Image* loadTexture(Material* material, const std::string& inputDirPath)
+{
+    Sampler* sampler = material->getSampler(ATLAS_SAMPLER);
+    const char* relativePath = sampler->getString("relativePath");
+    const char* absolutePath = sampler->getString("absolutePath");
+    std::string path;
+    if (relativePath && *relativePath)
+    {
+        path = inputDirPath + "/" + relativePath;
+        FILE* file = fopen(path.c_str(), "rb");
+        if (file)
+            fclose(file);
+        else if (absolutePath)
+            path = absolutePath;
+    }
+    else if (absolutePath)
+    {
+        path = absolutePath;
+    }
+    if (!endsWith(path, ".png"))
+        return NULL;
+    return Image::create(path.c_str());
+}
+
+/**
+ * Copies the image into the atlas with its top left corner at (x, y), and extends its edges
+ * into the padding around it.
+ */
+static void copyTexture(const Image* image, Image* atlas, unsigned int x, unsigned int y)
+{
+    const unsigned char* src = (const unsigned char*)image->getData();
+    unsigned char* dst = (unsigned char*)atlas->getData();
+    const unsigned int srcBpp = image->getBpp();
+    const unsigned int dstBpp = atlas->getBpp();
+    const int width = (int)image->getWidth();
+    const int height = (int)image->getHeight();
+    for (int row = -ATLAS_PADDING; row < height + ATLAS_PADDING; ++row)
+    {
+        const int srcRow = std::min(std::max(row, 0), height - 1);
+        unsigned char* out = dst + ((y + row) * atlas->getWidth() + x - ATLAS_PADDING) * dstBpp;
+        for (int column = -ATLAS_PADDING; column < width + ATLAS_PADDING; ++column, out += dstBpp)
+        {
+            const int srcColumn = std::min(std::max(column, 0), width - 1);
+            const unsigned char* in = src + (srcRow * width + srcColumn) * srcBpp;
+            unsigned char rgba[4] = { in[0], in[0], in[0], 255 };
+            if (srcBpp >= 3)
+            {
+                rgba[1] = in[1];
+                rgba[2] = in[2];
+            }
+            if (srcBpp == 4)
+                rgba[3] = in[3];
+            memcpy(out, rgba, dstBpp);
+        }
+    }
+}
+
+/**
+ * Duplicates the vertices of the mesh that are shared by parts that use different entries, and
+ * moves the texture coordinates of the parts that use an entry into its region of the atlas.
+ */
+static void remapTexCoords(Mesh* mesh, const std::map<unsigned int, unsigned int>& partEntries,
+                           const std::vector<AtlasEntry>& entries, const std::vector<AtlasPage>& pages)
+{
+    // Parts without an entry keep their vertices as they are.
+    const int none = -1;
+    std::vector<int> owners(mesh->vertices.size(), none - 1);
+    std::map<std::pair<unsigned int, int>, unsigned int> copies;
+    for (unsigned int i = 0; i < mesh->parts.size(); ++i)
+    {
+        MeshPart* part = mesh->parts[i];
+        std::map<unsigned int, unsigned int>::const_iterator it = partEntries.find(i);
+        const int entry = it != partEntries.end() ? (int)it->second : none;
+        for (unsigned int j = 0, count = (unsigned int)part->getIndicesCount(); j < count; ++j)
+        {
+            const unsigned int index = part->getIndex(j);
+            if (owners[index] < none)
+            {
+                owners[index] = entry;
+            }
+            else if (owners[index] != entry)
+            {
+                std::pair<unsigned int, int> key(index, entry);
+                std::map<std::pair<unsigned int, int>, unsigned int>::const_iterator copy = copies.find(key);
+                if (copy == copies.end())
+                {
+                    mesh->vertices.push_back(mesh->vertices[index]);
+                    owners.push_back(entry);
+                    copy = copies.insert(std::make_pair(key, (unsigned int)mesh->vertices.size() - 1)).first;
+                }
+                part->setIndex(j, copy->second);
+            }
+        }
+    }
+
+    // The rows of images go down from the top, and texture coordinates go up from the bottom.
+    for (size_t i = 0; i < mesh->vertices.size(); ++i)
+    {
+        if (owners[i] < 0)
+            continue;
+        const AtlasEntry& entry = entries[owners[i]];
+        const AtlasPage& page = pages[entry.page];
+        const float width = (float)entry.image->getWidth();
+        const float height = (float)entry.image->getHeight();
+        Vector2& uv = mesh->vertices[i].texCoord[0];
+        const float u = std::min(std::max(uv.x, 0.0f), 1.0f);
+        const float v = std::min(std::max(uv.y, 0.0f), 1.0f);
+        uv.x = (entry.x + u * width) / page.width;
+        uv.y = (page.height - entry.y - height + v * height) / page.height;
+    }
+
+    mesh->vertexLookupTable.clear();
+    for (unsigned int i = 0; i < (unsigned int)mesh->vertices.size(); ++i)
+    {
+        mesh->vertexLookupTable.insert(std::make_pair(mesh->vertices[i], i));
+    }
+}
+
+void MaterialAtlas::build(const std::vector<Model*>& models, std::map<std::string, Material*>& materials, unsigned int size,
+                          const std::string& inputDirPath, const std::string& outputFilePath)
+{
+    // A mesh part has one set of texture coordinates, so it can't be packed if models that
+    // share its mesh draw it with different materials.
+    std::map<MeshPartKey, Material*> partMaterials;
+    std::set<Material*> excluded;
+    for (size_t i = 0; i < models.size(); ++i)
+    {
+        Mesh* mesh = models[i]->getMesh();
+        for (unsigned int j = 0; mesh && j < mesh->parts.size(); ++j)
+        {
+            Material* material = models[i]->getMaterial(j);
+            if (!material)
+                continue;
+            std::map<MeshPartKey, Material*>::iterator it = partMaterials.insert(std::make_pair(MeshPartKey(mesh, j), material)).first;
+            if (it->second != material)
+            {
+                excluded.insert(material);
+                excluded.insert(it->second);
+            }
+        }
+    }
+    for (std::map<MeshPartKey, Material*>::const_iterator it = partMaterials.begin(); it != partMaterials.end(); ++it)
+    {
+        Material* material = it->second;
+        if (!material->getSampler(ATLAS_SAMPLER) || material->isTextureRepeat() || material->isDefined(TEXTURE_OFFSET) ||
+            !isUnitTexCoords(it->first.first, it->first.first->parts[it->first.second]))
+        {
+            excluded.insert(material);
+        }
+    }
+
+    // Group the materials that draw the same way except for their diffuse texture.
+    std::vector<std::vector<Material*> > groups;
+    std::set<Material*> used;
+    for (std::map<MeshPartKey, Material*>::const_iterator it = partMaterials.begin(); it != partMaterials.end(); ++it)
+    {
+        Material* material = it->second;
+        if (excluded.count(material) || !used.insert(material).second)
+            continue;
+        size_t group = 0;
+        while (group < groups.size() && !groups[group][0]->isCompatible(*material, ATLAS_SAMPLER))
+            ++group;
+        if (group == groups.size())
+            groups.push_back(std::vector<Material*>());
+        groups[group].push_back(material);
+    }
+
+    // Shelf pack the textures of each group, tallest first, into as many pages as they need.
+    std::vector<AtlasEntry> entries;
+    std::vector<AtlasPage> pages;
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        if (groups[i].size() < 2)
+            continue;
+
+        std::vector<AtlasEntry*> groupEntries;
+        for (size_t j = 0; j < groups[i].size(); ++j)
+        {
+            Image* image = loadTexture(groups[i][j], inputDirPath);
+            if (!image)
+                continue;
+            if (image->getWidth() + ATLAS_PADDING * 2 > size || image->getHeight() + ATLAS_PADDING * 2 > size)
+            {
+                LOG(1, "Warning: The texture of material '%s' is too large for an atlas of %u pixels.\n", groups[i][j]->getId().c_str(), size);
+                delete image;
+                continue;
+            }
+            AtlasEntry* entry = new AtlasEntry();
+            entry->material = groups[i][j];
+            entry->image = image;
+            groupEntries.push_back(entry);
+        }
+        std::stable_sort(groupEntries.begin(), groupEntries.end(), isTallerEntry);
+
+        const size_t firstPage = pages.size();
+        for (size_t j = 0; j < groupEntries.size(); ++j)
+        {
+            AtlasEntry* entry = groupEntries[j];
+            const unsigned int width = entry->image->getWidth() + ATLAS_PADDING * 2;
+            const unsigned int height = entry->image->getHeight() + ATLAS_PADDING * 2;
+            if (pages.size() > firstPage && pages.back().shelfX + width > size)
+            {
+                AtlasPage& page = pages.back();
+                page.shelfY += page.shelfHeight;
+                page.shelfX = page.shelfHeight = 0;
+            }
+            if (pages.size() == firstPage || pages.back().shelfY + height > size)
+            {
+                AtlasPage page;
+                page.width = page.height = 0;
+                page.shelfX = page.shelfY = page.shelfHeight = 0;
+                page.material = NULL;
+                pages.push_back(page);
+            }
+            AtlasPage& page = pages.back();
+            entry->page = (unsigned int)pages.size() - 1;
+            entry->x = page.shelfX + ATLAS_PADDING;
+            entry->y = page.shelfY + ATLAS_PADDING;
+            page.shelfX += width;
+            page.shelfHeight = std::max(page.shelfHeight, height);
+            page.width = std::max(page.width, page.shelfX);
+            page.height = std::max(page.height, page.shelfY + height);
+            page.entries.push_back((unsigned int)entries.size());
+            entries.push_back(*entry);
+            delete entry;
+        }
+    }
+
+    // Write each page that holds more than one texture and give it a material.
+    const std::string basePath = outputFilePath.substr(0, outputFilePath.find_last_of('.'));
+    unsigned int atlasCount = 0;
+    std::map<unsigned int, Material*> replacements;
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        AtlasPage& page = pages[i];
+        if (page.entries.size() < 2)
+            continue;
+        page.width = nextPowerOfTwo(page.width);
+        page.height = nextPowerOfTwo(page.height);
+
+        bool alpha = false;
+        for (size_t j = 0; j < page.entries.size(); ++j)
+        {
+            alpha = alpha || entries[page.entries[j]].image->getFormat() == Image::RGBA;
+        }
+        Image* image = Image::create(alpha ? Image::RGBA : Image::RGB, page.width, page.height);
+        for (size_t j = 0; j < page.entries.size(); ++j)
+        {
+            const AtlasEntry& entry = entries[page.entries[j]];
+            copyTexture(entry.image, image, entry.x, entry.y);
+        }
+        char suffix[32];
+        sprintf(suffix, "_atlas%u.png", atlasCount);
+        const std::string path = basePath + suffix;
+        image->save(path.c_str());
+        delete image;
+
+        // The material of the atlas is a copy of the first material packed into it.
+        const Material* first = entries[page.entries[0]].material;
+        std::string id;
+        do
+        {
+            sprintf(suffix, "_atlas%u", atlasCount++);
+            id = first->getId() + suffix;
+        } while (materials.find(id) != materials.end());
+        page.material = new Material(*first);
+        page.material->setId(id.c_str());
+        page.material->setLit(first->isLit());
+        Sampler* sampler = page.material->getSampler(ATLAS_SAMPLER);
+        sampler->set("absolutePath", path);
+        sampler->set("relativePath", getFilenameFromFilePath(path));
+        sampler->set("wrapS", CLAMP);
+        sampler->set("wrapT", CLAMP);
+        materials[id] = page.material;
+        LOG(1, "Packed the textures of %u materials into atlas '%s' (%ux%u).\n", (unsigned int)page.entries.size(), path.c_str(), page.width, page.height);
+    }
+
+    // Move the texture coordinates of each mesh part into the atlas of its material.
+    std::map<Material*, unsigned int> materialEntries;
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        if (pages[entries[i].page].material)
+            materialEntries[entries[i].material] = (unsigned int)i;
+    }
+    std::map<Mesh*, std::map<unsigned int, unsigned int> > meshEntries;
+    for (std::map<MeshPartKey, Material*>::const_iterator it = partMaterials.begin(); it != partMaterials.end(); ++it)
+    {
+        std::map<Material*, unsigned int>::const_iterator entry = materialEntries.find(it->second);
+        if (entry != materialEntries.end())
+            meshEntries[it->first.first][it->first.second] = entry->second;
+    }
+    for (std::map<Mesh*, std::map<unsigned int, unsigned int> >::const_iterator it = meshEntries.begin(); it != meshEntries.end(); ++it)
+    {
+        remapTexCoords(it->first, it->second, entries, pages);
+    }
+
+    // Replace the packed materials with the materials of their atlases.
+    for (std::map<Material*, unsigned int>::const_iterator it = materialEntries.begin(); it != materialEntries.end(); ++it)
+    {
+        Material* replacement = pages[entries[it->second].page].material;
+        for (size_t i = 0; i < models.size(); ++i)
+        {
+            models[i]->replaceMaterial(it->first, replacement);
+        }
+        materials.erase(it->first->getId());
+        delete it->first;
+    }
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        delete entries[i].image;
+    }
+}
+
+}
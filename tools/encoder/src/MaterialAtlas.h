@@ -0,0 +1,42 @@
+#ifndef MATERIALATLAS_H_
+#define MATERIALATLAS_H_
+
+#include "Material.h"
+#include "Model.h"
+
+namespace gameplay
+{
+
+/**
+ * Packs the diffuse textures of materials that differ only in that texture into atlas images,
+ * and replaces the materials packed into each atlas with one material that draws from it.
+ *
+ * The texture coordinates of the mesh parts drawn with a packed material are remapped into its
+ * region of the atlas, after duplicating the vertices that they share with parts drawn with
+ * other materials. Materials whose textures repeat, whose texture coordinates leave [0, 1] or
+ * whose mesh parts are drawn with other materials by other models are not packed.
+ */
+class MaterialAtlas
+{
+public:
+
+    /**
+     * Packs the textures of the materials of the given models into atlases.
+     *
+     * @param models The models whose materials may be packed.
+     * @param materials The materials by ID. Packed materials are replaced by the materials of their atlases.
+     * @param size The largest width and height of an atlas, which must be a power of two.
+     * @param inputDirPath The directory that the relative paths of textures start from.
+     * @param outputFilePath The path of the bundle, next to which the atlases are written.
+     */
+    static void build(const std::vector<Model*>& models, std::map<std::string, Material*>& materials, unsigned int size,
+                      const std::string& inputDirPath, const std::string& outputFilePath);
+
+private:
+
+    MaterialAtlas();
+};
+
+}
+
+#endif
@@ -1,10 +1,67 @@
+#include <set>
 #include "Base.h"
 #include "Mesh.h"
 #include "Model.h"
+#include "GPBFile.h"
 
 namespace gameplay
 {
 
+/**
+ * A symmetric 4x4 matrix that measures the sum of the squared distances of a point
+ * to a set of planes, stored as its upper triangle.
+ */
+struct Quadric
+{
+    double m[10];
+};
+
+/**
+ * A candidate collapse of the vertex from onto the vertex to.
+ */
+struct Collapse
+{
+    double cost;
+    unsigned int from;
+    unsigned int to;
+
+    bool operator<(const Collapse& c) const
+    {
+        return cost < c.cost;
+    }
+};
+
+static void addPlane(Quadric* q, double a, double b, double c, double d, double weight)
+{
+    q->m[0] += weight * a * a;
+    q->m[1] += weight * a * b;
+    q->m[2] += weight * a * c;
+    q->m[3] += weight * a * d;
+    q->m[4] += weight * b * b;
+    q->m[5] += weight * b * c;
+    q->m[6] += weight * b * d;
+    q->m[7] += weight * c * c;
+    q->m[8] += weight * c * d;
+    q->m[9] += weight * d * d;
+}
+
+static double evaluateQuadric(const Quadric& q, const Vector3& p)
+{
+    double x = p.x, y = p.y, z = p.z;
+    return q.m[0] * x * x + 2.0 * q.m[1] * x * y + 2.0 * q.m[2] * x * z + 2.0 * q.m[3] * x +
+           q.m[4] * y * y + 2.0 * q.m[5] * y * z + 2.0 * q.m[6] * y +
+           q.m[7] * z * z + 2.0 * q.m[8] * z + q.m[9];
+}
+
+static Vector3 triangleNormal(const Vector3& p0, const Vector3& p1, const Vector3& p2)
+{
+    Vector3 e1, e2, n;
+    Vector3::subtract(p1, p0, &e1);
+    Vector3::subtract(p2, p0, &e2);
+    Vector3::cross(e1, e2, &n);
+    return n;
+}
+
 Mesh::Mesh(void) : model(NULL)
 {
 }
@@ -42,16 +99,44 @@ void Mesh::writeBinaryVertices(FILE* file)
 {
     if (vertices.size() > 0)
     {
-        // Assumes that all vertices are the same size.
-        // Write the number of bytes for the vertex data
-        const Vertex& vertex = vertices.front();
-        write((unsigned int)(vertices.size() * vertex.byteSize()), file); // (vertex count) * (vertex size)
+        bool quantized = false;
+        unsigned int vertexSize = 0;
+        for (std::vector<VertexElement>::const_iterator i = _vertexFormat.begin(); i != _vertexFormat.end(); ++i)
+        {
+            quantized |= i->type != VertexElement::FLOAT;
+            vertexSize += i->byteSize();
+        }
 
-        // for each vertex
-        for (std::vector<Vertex>::const_iterator i = vertices.begin(); i != vertices.end(); ++i)
+        if (quantized)
         {
-            // Write this vertex
-            i->writeBinary(file);
+            write((unsigned int)(vertices.size() * vertexSize), file); // (vertex count) * (vertex size)
+            writePadding(GPB_MESH_DATA_ALIGNMENT, file);
+
+            // Write each element of each vertex in its own type
+            float values[4];
+            for (std::vector<Vertex>::const_iterator i = vertices.begin(); i != vertices.end(); ++i)
+            {
+                for (std::vector<VertexElement>::const_iterator j = _vertexFormat.begin(); j != _vertexFormat.end(); ++j)
+                {
+                    i->getValues(j->usage, values);
+                    j->writeValues(values, file);
+                }
+            }
+        }
+        else
+        {
+            // Assumes that all vertices are the same size.
+            // Write the number of bytes for the vertex data
+            const Vertex& vertex = vertices.front();
+            write((unsigned int)(vertices.size() * vertex.byteSize()), file); // (vertex count) * (vertex size)
+            writePadding(GPB_MESH_DATA_ALIGNMENT, file);
+
+            // for each vertex
+            for (std::vector<Vertex>::const_iterator i = vertices.begin(); i != vertices.end(); ++i)
+            {
+                // Write this vertex
+                i->writeBinary(file);
+            }
         }
     }
     else
@@ -136,6 +221,348 @@ const Vertex& Mesh::getVertex(unsigned int index) const
     return vertices[index];
 }
 
+void Mesh::optimize(bool overdraw)
+{
+    const unsigned int vertexCount = (unsigned int)vertices.size();
+    for (std::vector<MeshPart*>::iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        MeshPart* part = *i;
+        if (part->getPrimitiveType() != MeshPart::TRIANGLES)
+            continue;
+
+        const float before = part->getAverageCacheMissRatio(vertexCount);
+        part->optimizeVertexCache(vertexCount);
+        if (overdraw)
+            optimizeOverdraw(part, 1.05f);
+        LOG(2, "Optimized mesh '%s': ACMR %.3f -> %.3f.\n", getId().c_str(), before, part->getAverageCacheMissRatio(vertexCount));
+    }
+    optimizeVertexFetch();
+}
+
+void Mesh::optimizeOverdraw(MeshPart* part, float threshold)
+{
+    const std::vector<unsigned int>& indices = part->_indices;
+    const unsigned int triangleCount = (unsigned int)indices.size() / 3;
+    if (triangleCount < 2)
+        return;
+
+    // Count the cache misses of each triangle with the same FIFO cache that
+    // MeshPart::getAverageCacheMissRatio simulates.
+    std::vector<unsigned int> misses(triangleCount, 0);
+    std::vector<unsigned int> stamp(vertices.size(), 0);
+    unsigned int time = MeshPart::VERTEX_CACHE_SIZE + 1;
+    for (unsigned int t = 0; t < triangleCount; ++t)
+    {
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            const unsigned int v = indices[t * 3 + k];
+            if (time - stamp[v] > MeshPart::VERTEX_CACHE_SIZE)
+            {
+                stamp[v] = time++;
+                ++misses[t];
+            }
+        }
+    }
+
+    // Hard boundaries are where all three vertices miss, so the cache starts from scratch.
+    // Each run between them is split further wherever the miss ratio so far is already
+    // close to the ratio of the whole run.
+    std::vector<unsigned int> clusters;
+    unsigned int start = 0;
+    while (start < triangleCount)
+    {
+        unsigned int end = start + 1;
+        unsigned int runMisses = misses[start];
+        while (end < triangleCount && misses[end] < 3)
+            runMisses += misses[end++];
+        const float runRatio = (float)runMisses / (float)(end - start);
+
+        unsigned int clusterMisses = 0;
+        unsigned int clusterStart = start;
+        for (unsigned int t = start; t < end; ++t)
+        {
+            if (t == clusterStart)
+                clusters.push_back(t);
+            clusterMisses += misses[t];
+            if ((float)clusterMisses / (float)(t - clusterStart + 1) <= runRatio * threshold)
+            {
+                clusterStart = t + 1;
+                clusterMisses = 0;
+            }
+        }
+        start = end;
+    }
+    if (clusters.size() < 2)
+        return;
+    clusters.push_back(triangleCount);
+
+    // Clusters further out along their own normal from the center of the part are more
+    // likely to occlude the others.
+    std::vector<Vector3> centroids(clusters.size() - 1);
+    std::vector<Vector3> normals(clusters.size() - 1);
+    Vector3 center;
+    float totalArea = 0.0f;
+    for (size_t c = 0; c + 1 < clusters.size(); ++c)
+    {
+        float area = 0.0f;
+        for (unsigned int t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const Vector3& p0 = vertices[indices[t * 3]].position;
+            const Vector3& p1 = vertices[indices[t * 3 + 1]].position;
+            const Vector3& p2 = vertices[indices[t * 3 + 2]].position;
+            Vector3 normal;
+            Vector3::cross(Vector3(p0, p1), Vector3(p0, p2), &normal);
+            const float a = normal.length();
+            Vector3 centroid(p0.x + p1.x + p2.x, p0.y + p1.y + p2.y, p0.z + p1.z + p2.z);
+            centroids[c] += centroid * (a / 3.0f);
+            normals[c] += normal;
+            area += a;
+        }
+        center += centroids[c];
+        totalArea += area;
+        if (area > 0.0f)
+            centroids[c] *= 1.0f / area;
+        normals[c].normalize();
+    }
+    if (totalArea > 0.0f)
+        center *= 1.0f / totalArea;
+
+    std::vector<std::pair<float, unsigned int> > order(clusters.size() - 1);
+    for (size_t c = 0; c < order.size(); ++c)
+    {
+        order[c].first = -Vector3::dot(centroids[c] - center, normals[c]);
+        order[c].second = (unsigned int)c;
+    }
+    std::stable_sort(order.begin(), order.end());
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        const unsigned int c = order[i].second;
+        result.insert(result.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    part->_indices.swap(result);
+}
+
+void Mesh::optimizeVertexFetch()
+{
+    const unsigned int vertexCount = (unsigned int)vertices.size();
+    std::vector<unsigned int> remap(vertexCount, vertexCount);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertexCount);
+    for (std::vector<MeshPart*>::iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        std::vector<unsigned int>& indices = (*i)->_indices;
+        for (size_t j = 0; j < indices.size(); ++j)
+        {
+            unsigned int& index = indices[j];
+            if (remap[index] == vertexCount)
+            {
+                remap[index] = (unsigned int)reordered.size();
+                reordered.push_back(vertices[index]);
+            }
+            index = remap[index];
+        }
+    }
+
+    // Keep any vertices that no part uses at the end.
+    for (unsigned int v = 0; v < vertexCount; ++v)
+    {
+        if (remap[v] == vertexCount)
+        {
+            remap[v] = (unsigned int)reordered.size();
+            reordered.push_back(vertices[v]);
+        }
+    }
+    vertices.swap(reordered);
+
+    for (std::unordered_map<Vertex, unsigned int, VertexHash>::iterator i = vertexLookupTable.begin(); i != vertexLookupTable.end(); ++i)
+        i->second = remap[i->second];
+}
+
+void Mesh::quantize(bool positions)
+{
+    for (std::vector<VertexElement>::iterator i = _vertexFormat.begin(); i != _vertexFormat.end(); ++i)
+    {
+        VertexElement& e = *i;
+        switch (e.usage)
+        {
+            case POSITION:
+                if (positions)
+                {
+                    e.type = VertexElement::HALF_FLOAT;
+                    e.size = 4;
+                }
+                break;
+            case NORMAL:
+            case TANGENT:
+            case BINORMAL:
+                e.type = VertexElement::INT_2_10_10_10_REV;
+                e.size = 4;
+                e.normalized = true;
+                break;
+            case COLOR:
+                e.type = VertexElement::UNSIGNED_BYTE;
+                e.normalized = true;
+                break;
+            case BLENDWEIGHTS:
+                e.type = VertexElement::UNSIGNED_SHORT;
+                e.normalized = true;
+                break;
+            case BLENDINDICES:
+                {
+                    float maxIndex = 0.0f;
+                    for (std::vector<Vertex>::const_iterator v = vertices.begin(); v != vertices.end(); ++v)
+                    {
+                        maxIndex = std::max(maxIndex, std::max(std::max(v->blendIndices.x, v->blendIndices.y), std::max(v->blendIndices.z, v->blendIndices.w)));
+                    }
+                    e.type = maxIndex < 256.0f ? VertexElement::UNSIGNED_BYTE : VertexElement::UNSIGNED_SHORT;
+                    e.normalized = false;
+                }
+                break;
+            default:
+                if (e.usage >= TEXCOORD0 && e.usage <= TEXCOORD7)
+                {
+                    // Normalized shorts only cover [0, 1], so wrapping coordinates fall back to half floats.
+                    bool unit = true;
+                    const unsigned int set = e.usage - TEXCOORD0;
+                    for (std::vector<Vertex>::const_iterator v = vertices.begin(); v != vertices.end() && unit; ++v)
+                    {
+                        const Vector2& uv = v->texCoord[set];
+                        unit = uv.x >= 0.0f && uv.x <= 1.0f && uv.y >= 0.0f && uv.y <= 1.0f;
+                    }
+                    e.type = unit ? VertexElement::UNSIGNED_SHORT : VertexElement::HALF_FLOAT;
+                    e.normalized = unit;
+                }
+                break;
+        }
+    }
+}
+
+bool Mesh::splitJointPalettes(unsigned int maxJoints, std::vector<std::vector<unsigned int> >* palettes,
+                              std::vector<unsigned int>* partSources)
+{
+    assert(palettes && partSources && maxJoints >= 12);
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        if (parts[i]->getPrimitiveType() != MeshPart::TRIANGLES)
+            return false;
+    }
+
+    // Fill a new part with the triangles of each source part in order, starting another
+    // one whenever the next triangle would take its palette over the limit.
+    const unsigned int vertexCount = (unsigned int)vertices.size();
+    std::vector<MeshPart*> newParts;
+    std::vector<std::map<unsigned int, unsigned int> > localJoints;
+    std::vector<int> owners(vertexCount, -1);
+    std::vector<int> vertexParts;
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> copies;
+    palettes->clear();
+    partSources->clear();
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        const MeshPart* source = parts[i];
+        newParts.push_back(new MeshPart());
+        localJoints.push_back(std::map<unsigned int, unsigned int>());
+        palettes->push_back(std::vector<unsigned int>());
+        partSources->push_back((unsigned int)i);
+        for (unsigned int j = 0; j + 2 < source->getIndicesCount(); j += 3)
+        {
+            std::set<unsigned int> joints;
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                const Vertex& v = vertices[source->getIndex(j + k)];
+                const float* weights = &v.blendWeights.x;
+                const float* indices = &v.blendIndices.x;
+                for (unsigned int n = 0; n < Vertex::BLEND_INDICES_COUNT; ++n)
+                {
+                    if (weights[n] > 0.0f)
+                        joints.insert((unsigned int)indices[n]);
+                }
+            }
+            unsigned int added = 0;
+            for (std::set<unsigned int>::const_iterator n = joints.begin(); n != joints.end(); ++n)
+            {
+                if (localJoints.back().find(*n) == localJoints.back().end())
+                    ++added;
+            }
+            if (palettes->back().size() + added > maxJoints)
+            {
+                newParts.push_back(new MeshPart());
+                localJoints.push_back(std::map<unsigned int, unsigned int>());
+                palettes->push_back(std::vector<unsigned int>());
+                partSources->push_back((unsigned int)i);
+            }
+            const unsigned int partIndex = (unsigned int)newParts.size() - 1;
+            std::map<unsigned int, unsigned int>& local = localJoints.back();
+            for (std::set<unsigned int>::const_iterator n = joints.begin(); n != joints.end(); ++n)
+            {
+                if (local.find(*n) == local.end())
+                {
+                    local[*n] = (unsigned int)palettes->back().size();
+                    palettes->back().push_back(*n);
+                }
+            }
+
+            // The first part to use a vertex keeps it and the others get a copy of it.
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                unsigned int index = source->getIndex(j + k);
+                if (owners[index] < 0)
+                {
+                    owners[index] = (int)partIndex;
+                }
+                else if (owners[index] != (int)partIndex)
+                {
+                    std::pair<unsigned int, unsigned int> key(index, partIndex);
+                    std::map<std::pair<unsigned int, unsigned int>, unsigned int>::const_iterator copy = copies.find(key);
+                    if (copy == copies.end())
+                    {
+                        vertices.push_back(vertices[index]);
+                        vertexParts.push_back((int)partIndex);
+                        copy = copies.insert(std::make_pair(key, (unsigned int)vertices.size() - 1)).first;
+                    }
+                    index = copy->second;
+                }
+                newParts.back()->addIndex(index);
+            }
+        }
+    }
+
+    // Remap the blend indices of each vertex to the palette of its part. Indices without
+    // weight and those of unused vertices point at the first joint of the palette.
+    for (size_t i = 0; i < vertices.size(); ++i)
+    {
+        const int partIndex = i < vertexCount ? owners[i] : vertexParts[i - vertexCount];
+        Vertex& v = vertices[i];
+        const float* weights = &v.blendWeights.x;
+        float* indices = &v.blendIndices.x;
+        for (unsigned int n = 0; n < Vertex::BLEND_INDICES_COUNT; ++n)
+        {
+            unsigned int localIndex = 0;
+            if (partIndex >= 0 && weights[n] > 0.0f)
+            {
+                localIndex = localJoints[partIndex][(unsigned int)indices[n]];
+            }
+            indices[n] = (float)localIndex;
+        }
+    }
+
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        SAFE_DELETE(parts[i]);
+    }
+    parts = newParts;
+
+    vertexLookupTable.clear();
+    for (unsigned int i = 0; i < (unsigned int)vertices.size(); ++i)
+    {
+        vertexLookupTable.insert(std::make_pair(vertices[i], i));
+    }
+    return true;
+}
+
 size_t Mesh::getVertexElementCount() const
 {
     return _vertexFormat.size();
@@ -161,11 +588,22 @@ unsigned int Mesh::addVertex(const Vertex& vertex)
 
 unsigned int Mesh::getVertexIndex(const Vertex& vertex)
 {
-    std::map<Vertex,unsigned int>::iterator it;
+    std::unordered_map<Vertex, unsigned int, VertexHash>::iterator it;
     it = vertexLookupTable.find(vertex);
     return it->second;
 }
 
+unsigned int Mesh::weldVertex(const Vertex& vertex)
+{
+    std::pair<std::unordered_map<Vertex, unsigned int, VertexHash>::iterator, bool> result =
+        vertexLookupTable.insert(std::make_pair(vertex, (unsigned int)getVertexCount()));
+    if (result.second)
+    {
+        vertices.push_back(vertex);
+    }
+    return result.first->second;
+}
+
 bool Mesh::hasNormals() const
 {
     return !vertices.empty() && vertices[0].hasNormal;
@@ -176,6 +614,11 @@ bool Mesh::hasVertexColors() const
     return !vertices.empty() && vertices[0].hasDiffuse;
 }
 
+bool Mesh::hasTexCoords(unsigned int index) const
+{
+    return index < MAX_UV_SETS && !vertices.empty() && vertices[0].hasTexCoord[index];
+}
+
 void Mesh::computeBounds()
 {
     // If we have a Model with a MeshSkin associated with it,
@@ -230,4 +673,217 @@ void Mesh::computeBounds()
     bounds.radius = sqrt(bounds.radius);
 }
 
+size_t Mesh::getTriangleCount() const
+{
+    size_t count = 0;
+    for (std::vector<MeshPart*>::const_iterator i = parts.begin(); i != parts.end(); ++i)
+    {
+        size_t indexCount = (*i)->getIndicesCount();
+        if ((*i)->getPrimitiveType() == MeshPart::TRIANGLES)
+            count += indexCount / 3;
+        else if ((*i)->getPrimitiveType() == MeshPart::TRIANGLE_STRIP && indexCount > 2)
+            count += indexCount - 2;
+    }
+    return count;
+}
+
+Mesh* Mesh::simplify(float ratio) const
+{
+    if (parts.empty() || vertices.empty())
+        return NULL;
+
+    // Gather the triangles of all parts, so that vertices shared between parts are
+    // collapsed the same way in each of them.
+    std::vector<unsigned int> triangles;
+    std::vector<unsigned int> triangleParts;
+    for (unsigned int i = 0; i < parts.size(); ++i)
+    {
+        const MeshPart* part = parts[i];
+        if (part->getPrimitiveType() != MeshPart::TRIANGLES)
+            return NULL;
+        for (unsigned int j = 0; j + 2 < part->getIndicesCount(); j += 3)
+        {
+            triangles.push_back(part->getIndex(j));
+            triangles.push_back(part->getIndex(j + 1));
+            triangles.push_back(part->getIndex(j + 2));
+            triangleParts.push_back(i);
+        }
+    }
+    const size_t vertexCount = vertices.size();
+    const size_t triangleCount = triangleParts.size();
+    const size_t targetCount = (size_t)(triangleCount * ratio);
+
+    // Edges that belong to a single triangle are on the boundary of the mesh or on a
+    // seam between split vertices. Their vertices are locked so that the outline of
+    // the mesh and its texture coordinates stay in place.
+    std::map<std::pair<unsigned int, unsigned int>, unsigned int> edgeUses;
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            unsigned int a = triangles[t * 3 + k];
+            unsigned int b = triangles[t * 3 + (k + 1) % 3];
+            ++edgeUses[std::make_pair(std::min(a, b), std::max(a, b))];
+        }
+    }
+    std::vector<bool> locked(vertexCount, false);
+    for (std::map<std::pair<unsigned int, unsigned int>, unsigned int>::const_iterator i = edgeUses.begin(); i != edgeUses.end(); ++i)
+    {
+        if (i->second == 1)
+        {
+            locked[i->first.first] = true;
+            locked[i->first.second] = true;
+        }
+    }
+
+    // Every vertex starts with the planes of its triangles, weighted by their area.
+    std::vector<Quadric> quadrics(vertexCount);
+    memset(&quadrics[0], 0, sizeof(Quadric) * vertexCount);
+    std::vector<std::vector<unsigned int> > vertexTriangles(vertexCount);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        const Vector3& p0 = vertices[triangles[t * 3]].position;
+        Vector3 n = triangleNormal(p0, vertices[triangles[t * 3 + 1]].position, vertices[triangles[t * 3 + 2]].position);
+        float area = n.length();
+        if (area > 0.0f)
+        {
+            n.scale(1.0f / area);
+            float d = -Vector3::dot(n, p0);
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                addPlane(&quadrics[triangles[t * 3 + k]], n.x, n.y, n.z, d, area);
+            }
+        }
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            vertexTriangles[triangles[t * 3 + k]].push_back((unsigned int)t);
+        }
+    }
+
+    // Collapse the cheapest edges in passes. Each pass only collapses edges whose
+    // triangles were not changed by an earlier collapse in the same pass, so the
+    // costs that were computed at the start of the pass are still valid.
+    std::vector<bool> removed(triangleCount, false);
+    std::vector<bool> touched(vertexCount, false);
+    std::vector<Collapse> collapses;
+    size_t remaining = triangleCount;
+    while (remaining > targetCount)
+    {
+        collapses.clear();
+        for (size_t t = 0; t < triangleCount; ++t)
+        {
+            if (removed[t])
+                continue;
+            for (unsigned int k = 0; k < 3; ++k)
+            {
+                unsigned int a = triangles[t * 3 + k];
+                unsigned int b = triangles[t * 3 + (k + 1) % 3];
+                if (!locked[a])
+                {
+                    Collapse c = { evaluateQuadric(quadrics[a], vertices[b].position) + evaluateQuadric(quadrics[b], vertices[b].position), a, b };
+                    collapses.push_back(c);
+                }
+                if (!locked[b])
+                {
+                    Collapse c = { evaluateQuadric(quadrics[a], vertices[a].position) + evaluateQuadric(quadrics[b], vertices[a].position), b, a };
+                    collapses.push_back(c);
+                }
+            }
+        }
+        if (collapses.empty())
+            break;
+        std::sort(collapses.begin(), collapses.end());
+        std::fill(touched.begin(), touched.end(), false);
+
+        size_t collapsed = 0;
+        for (size_t i = 0; i < collapses.size() && remaining > targetCount; ++i)
+        {
+            unsigned int from = collapses[i].from;
+            unsigned int to = collapses[i].to;
+            if (touched[from] || touched[to])
+                continue;
+
+            // Reject collapses that would flip or degenerate any of the triangles that remain.
+            const Vector3& target = vertices[to].position;
+            bool valid = true;
+            const std::vector<unsigned int>& fromTriangles = vertexTriangles[from];
+            for (size_t j = 0; j < fromTriangles.size() && valid; ++j)
+            {
+                unsigned int t = fromTriangles[j];
+                unsigned int* tri = &triangles[t * 3];
+                if (removed[t] || tri[0] == to || tri[1] == to || tri[2] == to)
+                    continue;
+                const Vector3& p0 = vertices[tri[0]].position;
+                const Vector3& p1 = vertices[tri[1]].position;
+                const Vector3& p2 = vertices[tri[2]].position;
+                Vector3 before = triangleNormal(p0, p1, p2);
+                Vector3 after = triangleNormal(tri[0] == from ? target : p0, tri[1] == from ? target : p1, tri[2] == from ? target : p2);
+                float afterLength = after.length();
+                if (afterLength <= 1e-6f * before.length() || Vector3::dot(before, after) <= 0.0f)
+                    valid = false;
+            }
+            if (!valid)
+                continue;
+
+            for (size_t j = 0; j < fromTriangles.size(); ++j)
+            {
+                unsigned int t = fromTriangles[j];
+                if (removed[t])
+                    continue;
+                unsigned int* tri = &triangles[t * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                {
+                    removed[t] = true;
+                    --remaining;
+                }
+                else
+                {
+                    for (unsigned int k = 0; k < 3; ++k)
+                    {
+                        if (tri[k] == from)
+                            tri[k] = to;
+                    }
+                    vertexTriangles[to].push_back(t);
+                }
+                touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = true;
+            }
+            vertexTriangles[from].clear();
+            for (unsigned int k = 0; k < 10; ++k)
+            {
+                quadrics[to].m[k] += quadrics[from].m[k];
+            }
+            touched[from] = touched[to] = true;
+            ++collapsed;
+        }
+        if (collapsed == 0)
+            break;
+    }
+
+    // Copy the vertices that are still used, in the order they are first referenced.
+    Mesh* mesh = new Mesh();
+    mesh->_vertexFormat = _vertexFormat;
+    for (size_t i = 0; i < parts.size(); ++i)
+    {
+        mesh->addMeshPart(new MeshPart());
+    }
+    std::vector<int> remap(vertexCount, -1);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        if (removed[t])
+            continue;
+        MeshPart* part = mesh->parts[triangleParts[t]];
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            unsigned int index = triangles[t * 3 + k];
+            if (remap[index] < 0)
+            {
+                remap[index] = (int)mesh->vertices.size();
+                mesh->vertices.push_back(vertices[index]);
+            }
+            part->addIndex((unsigned int)remap[index]);
+        }
+    }
+    return mesh;
+}
+
 }
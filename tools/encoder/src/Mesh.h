@@ -1,6 +1,8 @@
 #ifndef MESH_H_
 #define MESH_H_
 
+#include <unordered_map>
+
 #include "Base.h"
 #include "Object.h"
 #include "MeshPart.h"
@@ -60,18 +62,99 @@ public:
 
     unsigned int getVertexIndex(const Vertex& vertex);
 
+    /**
+     * Returns the index of the given vertex, adding it to this mesh first if this mesh
+     * doesn't contain an equal vertex yet. This looks the vertex up only once.
+     */
+    unsigned int weldVertex(const Vertex& vertex);
+
     bool hasNormals() const;
     bool hasVertexColors() const;
+    bool hasTexCoords(unsigned int index) const;
 
     void computeBounds();
 
+    /**
+     * Creates a simplified copy of this mesh with about the given fraction of its
+     * triangles, by collapsing the edges whose removal changes the surface the least.
+     *
+     * Vertices on the boundary of the mesh, which includes the seams where vertices
+     * are split because their normals or texture coordinates differ, are never moved.
+     * The copy has the same vertex format and parts as this mesh.
+     *
+     * @param ratio The fraction of the triangles of this mesh to keep.
+     *
+     * @return The simplified mesh, or NULL if the mesh has parts that are not triangle lists.
+     */
+    Mesh* simplify(float ratio) const;
+
+    /**
+     * Reorders the triangles of each part for the post-transform vertex cache and then
+     * the vertices in the order the parts first use them, so that vertex fetches are
+     * mostly sequential. The geometry that is drawn does not change.
+     *
+     * @param overdraw true to also reorder clusters of triangles so that those facing out
+     *      from the center of the mesh are drawn first, which reduces overdraw.
+     */
+    void optimize(bool overdraw);
+
+    /**
+     * Switches the vertex elements of this mesh to compact types, which are used when
+     * the vertices are written to the binary file.
+     *
+     * Normals, tangents and binormals are packed to signed 10-10-10-2 integers, colors
+     * and blend weights to normalized bytes and shorts, texture coordinates to normalized
+     * shorts when they lie in [0, 1] and half floats otherwise, and blend indices to bytes
+     * when there are fewer than 256 joints. Positions stay as floats unless positions is true,
+     * in which case they are stored as four half floats.
+     *
+     * @param positions true to also quantize positions.
+     */
+    void quantize(bool positions);
+
+    /**
+     * Splits the parts of this skinned mesh so that the triangles of each new part are
+     * influenced by at most maxJoints joints, and remaps the blend indices of the vertices
+     * to the palette of the part that uses them. Vertices that are used by more than one
+     * new part are duplicated.
+     *
+     * @param maxJoints The most joints a part may use, which must be at least 12 so that
+     *      every triangle fits in a part.
+     * @param palettes Filled with the indices into the joints of the skin that make up the
+     *      palette of each new part.
+     * @param partSources Filled with the index of the part that each new part came from.
+     *
+     * @return False if the mesh has parts that are not triangle lists, in which case it is
+     *      not changed.
+     */
+    bool splitJointPalettes(unsigned int maxJoints, std::vector<std::vector<unsigned int> >* palettes,
+                            std::vector<unsigned int>* partSources);
+
+    /**
+     * Returns the number of triangles in all of the parts of this mesh.
+     */
+    size_t getTriangleCount() const;
+
     Model* model;
     std::vector<Vertex> vertices;
     std::vector<MeshPart*> parts;
     BoundingVolume bounds;
-    std::map<Vertex, unsigned int> vertexLookupTable;
+    std::unordered_map<Vertex, unsigned int, VertexHash> vertexLookupTable;
 
 private:
+
+    /**
+     * Reorders clusters of the triangles in part so that the ones that are likely to
+     * occlude the rest are drawn first. Clusters are split where the vertex cache restarts
+     * and, within those, where splitting raises the cache miss ratio by less than threshold.
+     */
+    void optimizeOverdraw(MeshPart* part, float threshold);
+
+    /**
+     * Reorders the vertices in the order the parts first use them.
+     */
+    void optimizeVertexFetch();
+
     std::vector<VertexElement> _vertexFormat;
 
 };
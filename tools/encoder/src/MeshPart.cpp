@@ -1,9 +1,34 @@
 #include "Base.h"
 #include "MeshPart.h"
+#include "GPBFile.h"
 
 namespace gameplay
 {
 
+/**
+ * Scores a vertex by its position in the vertex cache (-1 if not in the cache) and
+ * the number of triangles that still use it, from Forsyth's "Linear-Speed Vertex
+ * Cache Optimisation". Vertices that were just used and vertices with few remaining
+ * triangles score highest, so that triangles are emitted around them first.
+ */
+static float vertexCacheScore(int cachePosition, unsigned int remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f;
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // The last triangle's vertices get a fixed score so that its neighbours
+        // don't always win, which would make long thin strips.
+        if (cachePosition < 3)
+            score = 0.75f;
+        else
+            score = powf(1.0f - (float)(cachePosition - 3) / (MeshPart::VERTEX_CACHE_SIZE - 3), 1.5f);
+    }
+    return score + 2.0f * powf((float)remainingTriangles, -0.5f);
+}
+
 MeshPart::MeshPart(void) :
     _primitiveType(TRIANGLES),
     _indexFormat(INDEX16)
@@ -33,6 +58,7 @@ void MeshPart::writeBinary(FILE* file)
 
     // write the number of bytes
     write(indicesByteSize(), file);
+    writePadding(GPB_MESH_DATA_ALIGNMENT, file);
     // for each index
     for (std::vector<unsigned int>::const_iterator i = _indices.begin(); i != _indices.end(); ++i)
     {
@@ -76,6 +102,11 @@ unsigned int MeshPart::indexFormatSize() const
     }
 }
 
+unsigned int MeshPart::getPrimitiveType() const
+{
+    return _primitiveType;
+}
+
 MeshPart::IndexFormat MeshPart::getIndexFormat() const
 {
     return _indexFormat;
@@ -86,6 +117,138 @@ unsigned int MeshPart::getIndex(unsigned int i) const
     return _indices[i];
 }
 
+void MeshPart::setIndex(unsigned int i, unsigned int index)
+{
+    _indices[i] = index;
+    updateIndexFormat(index);
+}
+
+void MeshPart::optimizeVertexCache(unsigned int vertexCount)
+{
+    if (_primitiveType != TRIANGLES || _indices.size() < 6)
+        return;
+
+    const unsigned int triangleCount = (unsigned int)_indices.size() / 3;
+
+    // Lists of the triangles that use each vertex, and that haven't been emitted yet.
+    std::vector<unsigned int> remaining(vertexCount, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i)
+        ++remaining[_indices[i]];
+    std::vector<unsigned int> offsets(vertexCount + 1, 0);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + remaining[v];
+    std::vector<unsigned int> adjacency(triangleCount * 3);
+    std::vector<unsigned int> filled(offsets.begin(), offsets.end() - 1);
+    for (unsigned int t = 0; t < triangleCount; ++t)
+    {
+        for (unsigned int k = 0; k < 3; ++k)
+            adjacency[filled[_indices[t * 3 + k]]++] = t;
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (unsigned int v = 0; v < vertexCount; ++v)
+        vertexScore[v] = vertexCacheScore(-1, remaining[v]);
+
+    std::vector<bool> emitted(triangleCount, false);
+
+    std::vector<unsigned int> result;
+    result.reserve(triangleCount * 3);
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> newCache;
+    cache.reserve(VERTEX_CACHE_SIZE + 3);
+    newCache.reserve(VERTEX_CACHE_SIZE + 3);
+
+    unsigned int cursor = 0;
+    unsigned int best = 0;
+    while (true)
+    {
+        emitted[best] = true;
+        newCache.clear();
+        for (unsigned int k = 0; k < 3; ++k)
+        {
+            const unsigned int v = _indices[best * 3 + k];
+            result.push_back(v);
+            newCache.push_back(v);
+
+            // Remove the triangle from the vertex's list of remaining triangles.
+            unsigned int* begin = &adjacency[offsets[v]];
+            unsigned int* end = begin + remaining[v];
+            std::swap(*std::find(begin, end, best), *(end - 1));
+            --remaining[v];
+        }
+        for (size_t i = 0; i < cache.size(); ++i)
+        {
+            const unsigned int v = cache[i];
+            if (v != newCache[0] && v != newCache[1] && v != newCache[2])
+                newCache.push_back(v);
+        }
+
+        // Rescore the vertices in the cache, including the ones that just fell out of it.
+        for (size_t i = 0; i < newCache.size(); ++i)
+        {
+            const unsigned int v = newCache[i];
+            cachePosition[v] = i < VERTEX_CACHE_SIZE ? (int)i : -1;
+            vertexScore[v] = vertexCacheScore(cachePosition[v], remaining[v]);
+        }
+
+        // Pick the best triangle that uses a cached vertex.
+        float bestScore = -1.0f;
+        for (size_t i = 0; i < newCache.size(); ++i)
+        {
+            const unsigned int v = newCache[i];
+            for (unsigned int j = 0; j < remaining[v]; ++j)
+            {
+                const unsigned int t = adjacency[offsets[v] + j];
+                const float score = vertexScore[_indices[t * 3]] + vertexScore[_indices[t * 3 + 1]] + vertexScore[_indices[t * 3 + 2]];
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        if (newCache.size() > VERTEX_CACHE_SIZE)
+            newCache.resize(VERTEX_CACHE_SIZE);
+        cache.swap(newCache);
+
+        if (bestScore < 0.0f)
+        {
+            // Nothing in the cache is connected to what's left, so start again from the
+            // first triangle that hasn't been emitted.
+            while (cursor < triangleCount && emitted[cursor])
+                ++cursor;
+            if (cursor == triangleCount)
+                break;
+            best = cursor;
+        }
+    }
+
+    _indices.swap(result);
+}
+
+float MeshPart::getAverageCacheMissRatio(unsigned int vertexCount) const
+{
+    if (_primitiveType != TRIANGLES || _indices.size() < 3)
+        return 0.0f;
+
+    std::vector<unsigned int> stamp(vertexCount, 0);
+    unsigned int time = VERTEX_CACHE_SIZE + 1;
+    unsigned int misses = 0;
+    for (size_t i = 0; i < _indices.size(); ++i)
+    {
+        // Simulates a FIFO cache, which is what most GPUs implement.
+        const unsigned int v = _indices[i];
+        if (time - stamp[v] > VERTEX_CACHE_SIZE)
+        {
+            stamp[v] = time++;
+            ++misses;
+        }
+    }
+    return (float)misses / (float)(_indices.size() / 3);
+}
+
 void MeshPart::writeBinaryIndex(unsigned int index, FILE* file)
 {
     switch (_indexFormat)
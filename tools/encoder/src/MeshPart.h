@@ -10,6 +10,8 @@ namespace gameplay
 
 class MeshPart : public Object
 {
+    friend class Mesh;
+
 public:
 
     enum PrimitiveType
@@ -27,6 +29,11 @@ public:
         INDEX32 = 0x1405  // GL_UNSIGNED_INT
     };
 
+    /**
+     * The post-transform vertex cache size that optimizeVertexCache targets.
+     */
+    static const unsigned int VERTEX_CACHE_SIZE = 32;
+
     /**
      * Constructor.
      */
@@ -52,6 +59,11 @@ public:
      */
     size_t getIndicesCount() const;
 
+    /**
+     * Returns the primitive type.
+     */
+    unsigned int getPrimitiveType() const;
+
     /**
      * Returns the index format.
      */
@@ -62,6 +74,27 @@ public:
      */
     unsigned int getIndex(unsigned int i) const;
 
+    /**
+     * Sets the value of the index at the specified location.
+     */
+    void setIndex(unsigned int i, unsigned int index);
+
+    /**
+     * Reorders the triangles of this part so that consecutive triangles reuse the vertices
+     * still in the post-transform vertex cache, using Tom Forsyth's linear-speed algorithm.
+     *
+     * Does nothing if the part is not a triangle list.
+     *
+     * @param vertexCount The number of vertices in the mesh that owns this part.
+     */
+    void optimizeVertexCache(unsigned int vertexCount);
+
+    /**
+     * Returns the average number of vertices transformed per triangle (ACMR) when the
+     * indices are drawn through a FIFO vertex cache of the size the optimizer assumes.
+     */
+    float getAverageCacheMissRatio(unsigned int vertexCount) const;
+
 private:
 
     /**
@@ -46,19 +46,29 @@ void MeshSkin::writeBinary(FILE* file)
     {
         write(i->m, 16, file);
     }
+    write((unsigned int)_partPalettes.size(), file);
+    for (std::vector<std::vector<unsigned int> >::const_iterator i = _partPalettes.begin(); i != _partPalettes.end(); ++i)
+    {
+        write((unsigned int)i->size(), file);
+        for (std::vector<unsigned int>::const_iterator j = i->begin(); j != i->end(); ++j)
+        {
+            write(*j, file);
+        }
+    }
 
-    /*
-    // Write joint bounding spheres
+    // Write the box of the vertices each joint influences, in the space of the mesh vertices.
+    // Joints that influence no vertex have an empty box, with a minimum above the maximum.
     write((unsigned int)_jointBounds.size(), file);
     for (unsigned int i = 0; i < _jointBounds.size(); ++i)
     {
-        BoundingVolume& v = _jointBounds[i];
-        write(v.center.x, file);
-        write(v.center.y, file);
-        write(v.center.z, file);
-        write(v.radius, file);
+        const BoundingVolume& v = _jointBounds[i];
+        write(v.min.x, file);
+        write(v.min.y, file);
+        write(v.min.z, file);
+        write(v.max.x, file);
+        write(v.max.y, file);
+        write(v.max.z, file);
     }
-    */
 }
 
 void MeshSkin::writeText(FILE* file)
@@ -82,6 +92,21 @@ void MeshSkin::writeText(FILE* file)
         }
     }
     fprintf(file, "</bindPoses>\n");
+    for (std::vector<std::vector<unsigned int> >::const_iterator i = _partPalettes.begin(); i != _partPalettes.end(); ++i)
+    {
+        fprintf(file, "<palette count=\"%lu\">", i->size());
+        for (std::vector<unsigned int>::const_iterator j = i->begin(); j != i->end(); ++j)
+        {
+            fprintf(file, "%u ", *j);
+        }
+        fprintf(file, "</palette>\n");
+    }
+    fprintf(file, "<jointBounds count=\"%lu\">", _jointBounds.size() * 6);
+    for (std::vector<BoundingVolume>::const_iterator i = _jointBounds.begin(); i != _jointBounds.end(); ++i)
+    {
+        fprintf(file, "%f %f %f %f %f %f ", i->min.x, i->min.y, i->min.z, i->max.x, i->max.y, i->max.z);
+    }
+    fprintf(file, "</jointBounds>\n");
 
     fprintElementEnd(file);
 }
@@ -132,6 +157,11 @@ void MeshSkin::setBindPoses(std::vector<Matrix>& list)
     }
 }
 
+void MeshSkin::setPartPalettes(const std::vector<std::vector<unsigned int> >& palettes)
+{
+    _partPalettes = palettes;
+}
+
 bool MeshSkin::hasJoint(const char* id)
 {
     for (std::vector<std::string>::iterator i = _jointNames.begin(); i != _jointNames.end(); ++i)
@@ -50,6 +50,13 @@ public:
 
     void setBindPoses(std::vector<Matrix>& list);
 
+    /**
+     * Sets the joints that make up the palette of each part of the mesh, as indices into
+     * the joints of this skin. The blend indices of the vertices of each part index into
+     * its palette.
+     */
+    void setPartPalettes(const std::vector<std::vector<unsigned int> >& palettes);
+
     /**
      * Returns true if the MeshSkin contains a joint with the given ID.
      * 
@@ -70,6 +77,7 @@ private:
     std::vector<std::string> _jointNames;
     unsigned int _vertexInfluenceCount;
     std::vector<BoundingVolume> _jointBounds;
+    std::vector<std::vector<unsigned int> > _partPalettes;
 };
 
 }
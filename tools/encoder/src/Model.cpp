@@ -7,7 +7,8 @@ namespace gameplay
 Model::Model(void) :
     _mesh(NULL),
     _meshSkin(NULL),
-    _material(NULL)
+    _material(NULL),
+    _lightmapScaleOffset(1.0f, 1.0f, 0.0f, 0.0f)
 {
 }
 
@@ -72,6 +73,16 @@ void Model::writeBinary(FILE* file)
             }
         }
     }
+    // Write the levels of detail, each as a mesh xref followed by its screen size
+    write((unsigned int)_lodMeshes.size(), file);
+    for (unsigned int i = 0; i < _lodMeshes.size(); ++i)
+    {
+        _lodMeshes[i]->writeBinaryXref(file);
+        write(_lodScreenSizes[i], file);
+    }
+    // Write the lightmap path, which is empty if the model has no lightmap, and its scale and offset
+    write(_lightmapPath, file);
+    writeVectorBinary(_lightmapScaleOffset, file);
 }
 
 void Model::writeText(FILE* file)
@@ -98,6 +109,18 @@ void Model::writeText(FILE* file)
             fprintfElement(file, "material", mat->getId().c_str());
         }
     }
+    for (unsigned int i = 0; i < _lodMeshes.size(); ++i)
+    {
+        fprintfElement(file, "lod", _lodMeshes[i]->getId());
+        fprintfElement(file, "lodScreenSize", _lodScreenSizes[i]);
+    }
+    if (!_lightmapPath.empty())
+    {
+        fprintfElement(file, "lightmap", _lightmapPath);
+        fprintf(file, "<lightmapScaleOffset>\n");
+        writeVectorText(_lightmapScaleOffset, file);
+        fprintf(file, "</lightmapScaleOffset>\n");
+    }
     fprintElementEnd(file);
 }
 
@@ -152,4 +175,48 @@ void Model::setMaterial(Material* material, int partIndex)
     }
 }
 
+Material* Model::getMaterial(unsigned int partIndex) const
+{
+    // This matches writeBinary(), which only writes the material of the whole model if no part has one.
+    if (_materials.empty())
+    {
+        return _material;
+    }
+    return partIndex < _materials.size() ? _materials[partIndex] : NULL;
+}
+
+void Model::remapPartMaterials(const std::vector<unsigned int>& partSources)
+{
+    // The material of the whole model already covers every part.
+    if (_materials.empty())
+        return;
+
+    std::vector<Material*> materials(partSources.size(), (Material*)NULL);
+    for (size_t i = 0; i < partSources.size(); ++i)
+    {
+        if (partSources[i] < _materials.size())
+            materials[i] = _materials[partSources[i]];
+    }
+    _materials.swap(materials);
+}
+
+void Model::replaceMaterial(Material* material, Material* replacement)
+{
+    if (_material == material)
+        _material = replacement;
+    std::replace(_materials.begin(), _materials.end(), material, replacement);
+}
+
+void Model::addLOD(Mesh* mesh, float screenSize)
+{
+    _lodMeshes.push_back(mesh);
+    _lodScreenSizes.push_back(screenSize);
+}
+
+void Model::setLightmap(const std::string& path, const Vector4& scaleOffset)
+{
+    _lightmapPath = path;
+    _lightmapScaleOffset = scaleOffset;
+}
+
 }
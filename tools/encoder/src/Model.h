@@ -34,12 +34,47 @@ public:
     void setSkin(MeshSkin* skin);
     void setMaterial(Material* material, int partIndex = -1);
 
+    /**
+     * Returns the material of the given mesh part, or the material of the whole model
+     * if no part has a material of its own.
+     */
+    Material* getMaterial(unsigned int partIndex) const;
+
+    /**
+     * Gives each mesh part the material of the part it was split from, after the parts
+     * of the mesh have been split.
+     *
+     * @param partSources The index of the part that each new part came from.
+     */
+    void remapPartMaterials(const std::vector<unsigned int>& partSources);
+
+    /**
+     * Replaces the given material wherever this model uses it, for the whole model or any part.
+     */
+    void replaceMaterial(Material* material, Material* replacement);
+
+    /**
+     * Adds a level of detail that is drawn in place of the mesh once the model covers
+     * less than the given fraction of the height of the viewport.
+     */
+    void addLOD(Mesh* mesh, float screenSize);
+
+    /**
+     * Sets the baked lightmap of the model, which is sampled with the second texture
+     * coordinates of the mesh, scaled by xy and offset by zw of the given vector.
+     */
+    void setLightmap(const std::string& path, const Vector4& scaleOffset);
+
 private:
 
     Mesh* _mesh;
     MeshSkin* _meshSkin;
     std::vector<Material*> _materials;
     Material* _material;
+    std::vector<Mesh*> _lodMeshes;
+    std::vector<float> _lodScreenSizes;
+    std::string _lightmapPath;
+    Vector4 _lightmapScaleOffset;
 };
 
 }
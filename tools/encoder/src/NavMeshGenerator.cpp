@@ -0,0 +1,158 @@
+#include "Base.h"
+#include "NavMeshGenerator.h"
+#include "GPBFile.h"
+
+// The distance under which the vertices of neighboring triangles are welded
+#define NAVMESH_WELD_DISTANCE 0.001f
+
+namespace gameplay
+{
+
+/**
+ * The position of a vertex when snapped to the weld distance, which identifies welded vertices.
+ */
+struct WeldKey
+{
+    long long x;
+    long long y;
+    long long z;
+
+    bool operator<(const WeldKey& key) const
+    {
+        if (x != key.x)
+            return x < key.x;
+        if (y != key.y)
+            return y < key.y;
+        return z < key.z;
+    }
+};
+
+static unsigned int weldVertex(const Vector3& position, std::map<WeldKey, unsigned int>* welded, std::vector<Vector3>* vertices)
+{
+    WeldKey key;
+    key.x = (long long)floor(position.x / NAVMESH_WELD_DISTANCE + 0.5f);
+    key.y = (long long)floor(position.y / NAVMESH_WELD_DISTANCE + 0.5f);
+    key.z = (long long)floor(position.z / NAVMESH_WELD_DISTANCE + 0.5f);
+    std::map<WeldKey, unsigned int>::const_iterator itr = welded->find(key);
+    if (itr != welded->end())
+        return itr->second;
+
+    unsigned int index = (unsigned int)vertices->size();
+    vertices->push_back(position);
+    (*welded)[key] = index;
+    return index;
+}
+
+bool NavMeshGenerator::generate(const std::vector<std::string>& nodeIds, float maxSlope, const char* filename)
+{
+    LOG(1, "Generating navigation mesh: %s...\n", filename);
+
+    GPBFile* gpbFile = GPBFile::getInstance();
+
+    // A triangle is walkable when the angle between its normal and the up axis is within the slope.
+    float minNormalY = cos(MATH_DEG_TO_RAD(maxSlope));
+
+    std::map<WeldKey, unsigned int> welded;
+    std::vector<Vector3> vertices;
+    std::vector<unsigned int> indices;
+    unsigned int steepCount = 0;
+    for (unsigned int i = 0, count = nodeIds.size(); i < count; ++i)
+    {
+        Node* node = gpbFile->getNode(nodeIds[i].c_str());
+        Mesh* mesh = node && node->getModel() ? node->getModel()->getMesh() : NULL;
+        if (!mesh)
+        {
+            LOG(1, "WARNING: Node passed to navmesh argument does not have a mesh: %s\n", nodeIds[i].c_str());
+            continue;
+        }
+
+        const Matrix& worldMatrix = node->getWorldMatrix();
+        for (unsigned int j = 0, partCount = mesh->parts.size(); j < partCount; ++j)
+        {
+            MeshPart* part = mesh->parts[j];
+            if (part->getPrimitiveType() != MeshPart::TRIANGLES)
+            {
+                LOG(1, "WARNING: Skipping a mesh part that is not a triangle list in node: %s\n", nodeIds[i].c_str());
+                continue;
+            }
+
+            for (unsigned int k = 0, indexCount = part->getIndicesCount(); k + 2 < indexCount; k += 3)
+            {
+                Vector3 p[3];
+                for (unsigned int v = 0; v < 3; ++v)
+                    worldMatrix.transformPoint(mesh->vertices[part->getIndex(k + v)].position, &p[v]);
+
+                Vector3 normal;
+                Vector3::cross(p[1] - p[0], p[2] - p[0], &normal);
+                float length = normal.length();
+                if (length <= 0.0f)
+                    continue;
+
+                // Keep the triangles that face up, in either winding, and are not too steep.
+                bool flip = normal.y < 0.0f;
+                if (fabs(normal.y) / length < minNormalY)
+                {
+                    ++steepCount;
+                    continue;
+                }
+
+                unsigned int a = weldVertex(p[0], &welded, &vertices);
+                unsigned int b = weldVertex(p[flip ? 2 : 1], &welded, &vertices);
+                unsigned int c = weldVertex(p[flip ? 1 : 2], &welded, &vertices);
+                if (a == b || b == c || c == a)
+                    continue;
+
+                indices.push_back(a);
+                indices.push_back(b);
+                indices.push_back(c);
+            }
+        }
+    }
+
+    if (indices.empty())
+    {
+        LOG(1, "Error: No walkable triangles found for navigation mesh: %s\n", filename);
+        return false;
+    }
+
+    FILE* file = fopen(filename, "wb");
+    if (!file)
+    {
+        LOG(1, "Error: Failed to open file: %s\n", filename);
+        return false;
+    }
+
+    // identifier
+    char identifier[] = { '\xAB', 'G', 'P', 'N', '\xBB', '\r', '\n', '\x1A', '\n' };
+    fwrite(identifier, 1, sizeof(identifier), file);
+
+    // version
+    unsigned char version[] = { 1, 0 };
+    fwrite(version, 1, sizeof(version), file);
+
+    write((unsigned int)vertices.size(), file);
+    for (unsigned int i = 0, count = vertices.size(); i < count; ++i)
+    {
+        write(vertices[i].x, file);
+        write(vertices[i].y, file);
+        write(vertices[i].z, file);
+    }
+    write((unsigned int)(indices.size() / 3), file);
+    for (unsigned int i = 0, count = indices.size(); i < count; ++i)
+    {
+        write(indices[i], file);
+    }
+    bool failed = ferror(file) != 0;
+    fclose(file);
+    if (failed)
+    {
+        LOG(1, "Error: Failed to write file: %s\n", filename);
+        return false;
+    }
+
+    LOG(1, "Wrote navigation mesh with %u vertices and %u triangles (%u steep triangles removed).\n",
+        (unsigned int)vertices.size(), (unsigned int)(indices.size() / 3), steepCount);
+    return true;
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef NAVMESHGENERATOR_H_
+#define NAVMESHGENERATOR_H_
+
+#include "Node.h"
+
+namespace gameplay
+{
+
+/**
+ * Generates navigation meshes, which are loaded at runtime by gameplay::NavigationMesh.
+ *
+ * The navigation mesh keeps the triangles of the given nodes whose slope an agent can walk on,
+ * in world space, with the vertices that the triangles share welded so that the runtime can
+ * connect neighboring triangles by their edges.
+ */
+class NavMeshGenerator
+{
+public:
+
+    /**
+     * Generates a navigation mesh and saves the result to the specified filename (NAV file).
+     *
+     * @param nodeIds List of node ids whose meshes are included in the navigation mesh.
+     * @param maxSlope The maximum slope, in degrees, of the triangles that are walkable.
+     * @param filename Output NAV file to write the navigation mesh to.
+     *
+     * @return True if the navigation mesh was written; false otherwise.
+     */
+    static bool generate(const std::vector<std::string>& nodeIds, float maxSlope, const char* filename);
+
+};
+
+}
+
+#endif
@@ -1,6 +1,10 @@
 #include "NormalMapGenerator.h"
 #include "Image.h"
 #include "Base.h"
+#include "Thread.h"
+
+// The number of rows of the normal map that each thread computes at a time.
+#define NORMAL_MAP_BAND_ROWS 64
 
 namespace gameplay
 {
@@ -60,6 +64,47 @@ void calculateNormal(
     Vector3::cross(Q, P, normal);
 }
 
+/**
+ * The heights of a heightmap, which are read a band of rows at a time.
+ */
+struct HeightmapSource
+{
+    // PNG heightmaps are decoded whole, while RAW heightmaps are read from the file as needed.
+    Image* image;
+    FILE* file;
+    int bits;
+    int width;
+    int height;
+    float heightScale;
+};
+
+/**
+ * A band of rows of the normal map that one thread computes.
+ */
+struct NormalMapBand
+{
+    // The heights of the rows of the band and the row on each side of it, starting at heightsFirstRow.
+    const float* heights;
+    int heightsFirstRow;
+    int heightsRowCount;
+    int width;
+    int height;
+    int firstRow;
+    int endRow;
+    Vector2 scale;
+    // The RGB pixels of the rows of the band.
+    unsigned char* pixels;
+};
+
+/**
+ * The normals of the two triangles of a cell of the heightmap.
+ */
+struct NormalMapFace
+{
+    Vector3 normal1;
+    Vector3 normal2;
+};
+
 float normalizedHeightPacked(float r, float g, float b)
 {
     // This formula is intended for 24-bit packed heightmap images (that are generated
@@ -70,28 +115,17 @@ float normalizedHeightPacked(float r, float g, float b)
     return (256.0f*r + g + 0.00390625f*b) / 65536.0f;
 }
 
-void NormalMapGenerator::generate()
+/**
+ * Reads rowCount rows of heights starting at firstRow, scaled to world units.
+ */
+static bool readHeights(const HeightmapSource& source, int firstRow, int rowCount, float* heights)
 {
-    // Load the input heightmap
-    float* heights = NULL;
-    size_t pos = _inputFile.find_last_of('.');
-    std::string ext = pos == std::string::npos ? "" : _inputFile.substr(pos, _inputFile.size()-pos);
-    if (equalsIgnoreCase(ext, ".png"))
+    const int count = source.width * rowCount;
+    if (source.image)
     {
-        // Load heights from PNG image
-        Image* image = Image::create(_inputFile.c_str());
-        if (image == NULL)
-        {
-            LOG(1, "Failed to load input heightmap PNG: %s.\n", _inputFile.c_str());
-            return;
-        }
-
-        _resolutionX = image->getWidth();
-        _resolutionY = image->getHeight();
-        int size = _resolutionX * _resolutionY;
-        heights = new float[size];
-        unsigned char* data = (unsigned char*)image->getData();
-        for (int i = 0; i < size; ++i)
+        const Image* image = source.image;
+        const unsigned char* data = (const unsigned char*)image->getData() + (size_t)firstRow * source.width * image->getBpp();
+        for (int i = 0; i < count; ++i)
         {
             switch (image->getFormat())
             {
@@ -109,157 +143,90 @@ void NormalMapGenerator::generate()
                 heights[i] = 0.0f;
                 break;
             }
-            heights[i] = heights[i] * _worldSize.y;
+            heights[i] = heights[i] * source.heightScale;
         }
-        SAFE_DELETE(image);
+        return true;
     }
-    else if (equalsIgnoreCase(ext, ".raw"))
-    {
-        // Load heights from RAW 8 or 16-bit file
-        if (_resolutionX <= 0 || _resolutionY <= 0)
-        {
-            LOG(1, "Missing resolution argument - must be explicitly specified for RAW heightmap files: %s.\n", _inputFile.c_str());
-            return;
-        }
-
-        // Read all data from file
-        FILE* fp = fopen(_inputFile.c_str(), "rb");
-        if (fp == NULL)
-        {
-            LOG(1, "Failed to open input file: %s.\n", _inputFile.c_str());
-            return;
-        }
-
-        fseek(fp, 0, SEEK_END);
-        long fileSize = ftell(fp);
-        fseek(fp, 0, SEEK_SET);
-
-        unsigned char* data = new unsigned char[fileSize];
-        if (fread(data, 1, fileSize, fp) != (size_t)fileSize)
-        {
-            fclose(fp);
-            delete[] data;
-            LOG(1, "Failed to read bytes from input file: %s.\n", _inputFile.c_str());
-            return;
-        }
-        fclose(fp);
-
-        // Determine if the RAW file is 8-bit or 16-bit based on file size.
-        int bits = (fileSize / (_resolutionX * _resolutionY)) * 8;
-        if (bits != 8 && bits != 16)
-        {
-            LOG(1, "Invalid RAW file - must be 8-bit or 16-bit, but found neither: %s.", _inputFile.c_str());
-            delete[] data;
-            return;
-        }
 
-        int size = _resolutionX * _resolutionY;
-        heights = new float[size];
-        if (bits == 16)
-        {
-            // 16-bit (0-65535)
-            int idx;
-            for (unsigned int y = 0, i = 0; y < (unsigned int)_resolutionY; ++y)
-            {
-                for (unsigned int x = 0; x < (unsigned int)_resolutionX; ++x, ++i)
-                {
-                    idx = (y * _resolutionX + x) << 1;
-                    heights[i] = ((data[idx] | (int)data[idx+1] << 8) / 65535.0f) * _worldSize.y;
-                }
-            }
-        }
-        else
+    // RAW files hold 8-bit or little-endian 16-bit rows without a header.
+    const int bytes = source.bits / 8;
+    std::vector<unsigned char> data((size_t)count * bytes);
+    if (fseek(source.file, (long)firstRow * source.width * bytes, SEEK_SET) != 0 || fread(&data[0], 1, data.size(), source.file) != data.size())
+    {
+        return false;
+    }
+    if (bytes == 2)
+    {
+        // 16-bit (0-65535)
+        for (int i = 0; i < count; ++i)
         {
-            // 8-bit (0-255)
-            for (unsigned int y = 0, i = 0; y < (unsigned int)_resolutionY; ++y)
-            {
-                for (unsigned int x = 0; x < (unsigned int)_resolutionX; ++x, ++i)
-                {
-                    heights[i] = (data[y * _resolutionX + x] / 255.0f) * _worldSize.y;
-                }
-            }
+            heights[i] = ((data[i << 1] | (int)data[(i << 1) + 1] << 8) / 65535.0f) * source.heightScale;
         }
-
-        delete[] data;
     }
     else
     {
-        LOG(1, "Unsupported input heightmap file (must be a valid PNG or RAW file: %s.\n", _inputFile.c_str());
-        return;
+        // 8-bit (0-255)
+        for (int i = 0; i < count; ++i)
+        {
+            heights[i] = (data[i] / 255.0f) * source.heightScale;
+        }
     }
+    return true;
+}
 
-    ///////////////////////////////////////////////////////////////////////////////////////////////
-    //
-    // NOTE: This method assumes the heightmap geometry is generated as follows.
-    //
-    //   -----------
-    //  | / | / | / |
-    //  |-----------|
-    //  | / | / | / |
-    //  |-----------|
-    //  | / | / | / |
-    //   -----------
-    //
-    ///////////////////////////////////////////////////////////////////////////////////////////////
-
-    struct NormalPixel
-    {
-        unsigned char r, g, b;
-    };
-    NormalPixel* normalPixels = new NormalPixel[_resolutionX * _resolutionY];
-
-    struct Face
-    {
-        Vector3 normal1;
-        Vector3 normal2;
-    };
-
-    int progressMax = (_resolutionX-1) * (_resolutionY-1) + _resolutionX * _resolutionY;
-    int progress = 0;
-
-    Vector2 scale(_worldSize.x / (_resolutionX-1), _worldSize.z / (_resolutionY-1));
-
-    // First calculate all face normals for the heightmap
-    LOG(1, "Calculating normals... 0%%");
-    Face* faceNormals = new Face[(_resolutionX - 1) * (_resolutionY - 1)];
-    Vector3 v1, v2;
-    for (int z = 0; z < _resolutionY-1; z++)
+/**
+ * Computes the normals of a band of rows. This is the entry point of each thread of NormalMapGenerator::generate().
+ *
+ * @param data The NormalMapBand to compute.
+ */
+static int generateNormalMapBand(void* data)
+{
+    const NormalMapBand* band = static_cast<const NormalMapBand*>(data);
+    const int width = band->width;
+    const int height = band->height;
+    const Vector2& scale = band->scale;
+    if (band->firstRow >= band->endRow)
+        return 0;
+
+    // First calculate the face normals of the cells on each side of the rows of the band.
+    const int faceFirstRow = std::max(0, band->firstRow - 1);
+    const int faceEndRow = std::min(height - 1, band->endRow);
+    NormalMapFace* faceNormals = new NormalMapFace[std::max(1, (faceEndRow - faceFirstRow) * (width - 1))];
+    for (int z = faceFirstRow; z < faceEndRow; z++)
     {
-        for (int x = 0; x < _resolutionX-1; x++)
+        const int row = z - band->heightsFirstRow;
+        for (int x = 0; x < width-1; x++)
         {
-            float topLeftHeight = getHeight(heights, _resolutionX, _resolutionY, x, z);
-            float bottomLeftHeight = getHeight(heights, _resolutionX, _resolutionY, x, z + 1);
-            float bottomRightHeight = getHeight(heights, _resolutionX, _resolutionY, x + 1, z + 1);
-            float topRightHeight = getHeight(heights, _resolutionX, _resolutionY, x + 1, z);
+            float topLeftHeight = getHeight((float*)band->heights, width, band->heightsRowCount, x, row);
+            float bottomLeftHeight = getHeight((float*)band->heights, width, band->heightsRowCount, x, row + 1);
+            float bottomRightHeight = getHeight((float*)band->heights, width, band->heightsRowCount, x + 1, row + 1);
+            float topRightHeight = getHeight((float*)band->heights, width, band->heightsRowCount, x + 1, row);
+            NormalMapFace& face = faceNormals[(z - faceFirstRow)*(width-1)+x];
 
             // Triangle 1
             calculateNormal(
                 (float)x*scale.x, bottomLeftHeight, (float)(z + 1)*scale.y,
                 (float)x*scale.x, topLeftHeight, (float)z*scale.y,
                 (float)(x + 1)*scale.x, topRightHeight, (float)z*scale.y,
-                &faceNormals[z*(_resolutionX-1)+x].normal1);
+                &face.normal1);
 
             // Triangle 2
             calculateNormal(
                 (float)x*scale.x, bottomLeftHeight, (float)(z + 1)*scale.y,
                 (float)(x + 1)*scale.x, topRightHeight, (float)z*scale.y,
                 (float)(x + 1)*scale.x, bottomRightHeight, (float)(z + 1)*scale.y,
-                &faceNormals[z*(_resolutionX-1)+x].normal2);
-
-            ++progress;
-            LOG(1, "\rCalculating normals... %d%%", (int)(((float)progress / progressMax) * 100));
+                &face.normal2);
         }
     }
 
-    // Free height array
-    delete[] heights;
-    heights = NULL;
-
     // Smooth normals by taking an average for each vertex
     Vector3 normal;
-    for (int z = 0; z < _resolutionY; z++)
+    for (int z = band->firstRow; z < band->endRow; z++)
     {
-        for (int x = 0; x < _resolutionX; x++)
+        const NormalMapFace* above = faceNormals + (z - 1 - faceFirstRow)*(width-1);
+        const NormalMapFace* below = faceNormals + (z - faceFirstRow)*(width-1);
+        unsigned char* pixel = band->pixels + (size_t)(z - band->firstRow) * width * 3;
+        for (int x = 0; x < width; x++, pixel += 3)
         {
             // Reset normal sum
             normal.set(0, 0, 0);
@@ -269,30 +236,30 @@ void NormalMapGenerator::generate()
                 if (z > 0)
                 {
                     // Top left
-                    normal.add(faceNormals[(z-1)*(_resolutionX-1) + (x-1)].normal2);
+                    normal.add(above[x - 1].normal2);
                 }
 
-                if (z < (_resolutionY - 1))
+                if (z < (height - 1))
                 {
                     // Bottom left
-                    normal.add(faceNormals[z*(_resolutionX-1) + (x - 1)].normal1);
-                    normal.add(faceNormals[z*(_resolutionX-1) + (x - 1)].normal2);
+                    normal.add(below[x - 1].normal1);
+                    normal.add(below[x - 1].normal2);
                 }
             }
 
-            if (x < (_resolutionX - 1))
+            if (x < (width - 1))
             {
                 if (z > 0)
                 {
                     // Top right
-                    normal.add(faceNormals[(z-1)*(_resolutionX-1) + x].normal1);
-                    normal.add(faceNormals[(z-1)*(_resolutionX-1) + x].normal2);
+                    normal.add(above[x].normal1);
+                    normal.add(above[x].normal2);
                 }
 
-                if (z < (_resolutionY - 1))
+                if (z < (height - 1))
                 {
                     // Bottom right
-                    normal.add(faceNormals[z*(_resolutionX-1) + x].normal1);
+                    normal.add(below[x].normal1);
                 }
             }
 
@@ -302,28 +269,189 @@ void NormalMapGenerator::generate()
             normal.normalize();
 
             // Store this vertex normal
-            NormalPixel& pixel = normalPixels[z*_resolutionX + x];
-            pixel.r = (unsigned char)((normal.x + 1.0f) * 0.5f * 255.0f);
-            pixel.g = (unsigned char)((normal.y + 1.0f) * 0.5f * 255.0f);
-            pixel.b = (unsigned char)((normal.z + 1.0f) * 0.5f * 255.0f);
+            pixel[0] = (unsigned char)((normal.x + 1.0f) * 0.5f * 255.0f);
+            pixel[1] = (unsigned char)((normal.y + 1.0f) * 0.5f * 255.0f);
+            pixel[2] = (unsigned char)((normal.z + 1.0f) * 0.5f * 255.0f);
+        }
+    }
+
+    delete[] faceNormals;
+    return 0;
+}
+
+void NormalMapGenerator::generate()
+{
+    // Open the input heightmap
+    HeightmapSource source;
+    source.image = NULL;
+    source.file = NULL;
+    source.bits = 0;
+    source.heightScale = _worldSize.y;
+    size_t pos = _inputFile.find_last_of('.');
+    std::string ext = pos == std::string::npos ? "" : _inputFile.substr(pos, _inputFile.size()-pos);
+    if (equalsIgnoreCase(ext, ".png"))
+    {
+        // Load heights from PNG image
+        source.image = Image::create(_inputFile.c_str());
+        if (source.image == NULL)
+        {
+            LOG(1, "Failed to load input heightmap PNG: %s.\n", _inputFile.c_str());
+            return;
+        }
 
-            ++progress;
-            LOG(1, "\rCalculating normals... %d%%", (int)(((float)progress / progressMax) * 100));
+        _resolutionX = source.image->getWidth();
+        _resolutionY = source.image->getHeight();
+    }
+    else if (equalsIgnoreCase(ext, ".raw"))
+    {
+        // Load heights from RAW 8 or 16-bit file
+        if (_resolutionX <= 0 || _resolutionY <= 0)
+        {
+            LOG(1, "Missing resolution argument - must be explicitly specified for RAW heightmap files: %s.\n", _inputFile.c_str());
+            return;
+        }
+
+        // The file is read a band at a time, so that very large heightmaps don't have to fit in memory.
+        source.file = fopen(_inputFile.c_str(), "rb");
+        if (source.file == NULL)
+        {
+            LOG(1, "Failed to open input file: %s.\n", _inputFile.c_str());
+            return;
+        }
+
+        fseek(source.file, 0, SEEK_END);
+        long fileSize = ftell(source.file);
+        fseek(source.file, 0, SEEK_SET);
+
+        // Determine if the RAW file is 8-bit or 16-bit based on file size.
+        source.bits = (int)(fileSize / ((long)_resolutionX * _resolutionY)) * 8;
+        if (source.bits != 8 && source.bits != 16)
+        {
+            LOG(1, "Invalid RAW file - must be 8-bit or 16-bit, but found neither: %s.", _inputFile.c_str());
+            fclose(source.file);
+            return;
         }
     }
+    else
+    {
+        LOG(1, "Unsupported input heightmap file (must be a valid PNG or RAW file: %s.\n", _inputFile.c_str());
+        return;
+    }
+    source.width = _resolutionX;
+    source.height = _resolutionY;
+
+    // The normal map is written a row at a time as well.
+    FILE* fp = fopen(_outputFile.c_str(), "wb");
+    png_structp png_ptr = fp ? png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL) : NULL;
+    png_infop info_ptr = png_ptr ? png_create_info_struct(png_ptr) : NULL;
+    if (info_ptr == NULL)
+    {
+        LOG(1, "Error: Failed to open image for writing: %s\n", _outputFile.c_str());
+        if (png_ptr)
+            png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+        if (fp)
+            fclose(fp);
+        if (source.file)
+            fclose(source.file);
+        SAFE_DELETE(source.image);
+        return;
+    }
+    png_init_io(png_ptr, fp);
+    png_set_IHDR(png_ptr, info_ptr, _resolutionX, _resolutionY, 8, PNG_COLOR_TYPE_RGB, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+    png_write_info(png_ptr, info_ptr);
 
-    LOG(1, "\rCalculating normals... Done.\n");
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+    //
+    // NOTE: This method assumes the heightmap geometry is generated as follows.
+    //
+    //   -----------
+    //  | / | / | / |
+    //  |-----------|
+    //  | / | / | / |
+    //  |-----------|
+    //  | / | / | / |
+    //   -----------
+    //
+    ///////////////////////////////////////////////////////////////////////////////////////////////
+
+    Vector2 scale(_worldSize.x / (_resolutionX-1), _worldSize.z / (_resolutionY-1));
+
+    // Each chunk of rows is split into a band per thread. Its heights are read, its normals
+    // computed in parallel and its rows written before the next chunk is read.
+    const int threadCount = (int)getProcessorCount();
+    const int chunkRows = threadCount * NORMAL_MAP_BAND_ROWS;
+    float* heights = new float[(size_t)(chunkRows + 2) * _resolutionX];
+    unsigned char* pixels = new unsigned char[(size_t)chunkRows * _resolutionX * 3];
+    std::vector<NormalMapBand> bands(threadCount);
+    std::vector<THREAD_HANDLE> threads;
+    bool result = true;
+
+    LOG(1, "Calculating normals... 0%%");
+    for (int chunkFirstRow = 0; chunkFirstRow < _resolutionY && result; chunkFirstRow += chunkRows)
+    {
+        const int chunkEndRow = std::min(_resolutionY, chunkFirstRow + chunkRows);
+        const int heightsFirstRow = std::max(0, chunkFirstRow - 1);
+        const int heightsRowCount = std::min(_resolutionY, chunkEndRow + 1) - heightsFirstRow;
+        if (!readHeights(source, heightsFirstRow, heightsRowCount, heights))
+        {
+            LOG(1, "\nFailed to read bytes from input file: %s.\n", _inputFile.c_str());
+            result = false;
+            break;
+        }
+
+        // The first band is computed on this thread, as is any band that a thread couldn't be started for.
+        threads.clear();
+        for (int i = threadCount - 1; i >= 0; --i)
+        {
+            NormalMapBand& band = bands[i];
+            band.heights = heights;
+            band.heightsFirstRow = heightsFirstRow;
+            band.heightsRowCount = heightsRowCount;
+            band.width = _resolutionX;
+            band.height = _resolutionY;
+            band.firstRow = std::min(chunkEndRow, chunkFirstRow + i * NORMAL_MAP_BAND_ROWS);
+            band.endRow = std::min(chunkEndRow, band.firstRow + NORMAL_MAP_BAND_ROWS);
+            band.scale = scale;
+            band.pixels = pixels + (size_t)(band.firstRow - chunkFirstRow) * _resolutionX * 3;
+
+            THREAD_HANDLE thread;
+            if (i > 0 && band.firstRow < band.endRow && createThread(&thread, &generateNormalMapBand, &band))
+                threads.push_back(thread);
+            else
+                generateNormalMapBand(&band);
+        }
+        if (!threads.empty())
+        {
+            waitForThreads((int)threads.size(), &threads[0]);
+            for (size_t i = 0, count = threads.size(); i < count; ++i)
+                closeThread(threads[i]);
+        }
 
-    // Create and save an image for the normal map
-    Image* normalMap = Image::create(Image::RGB, _resolutionX, _resolutionY);
-    normalMap->setData(normalPixels);
-    normalMap->save(_outputFile.c_str());
+        for (int row = 0; row < chunkEndRow - chunkFirstRow; ++row)
+        {
+            png_write_row(png_ptr, pixels + (size_t)row * _resolutionX * 3);
+        }
+        LOG(1, "\rCalculating normals... %d%%", (int)(((float)chunkEndRow / _resolutionY) * 100));
+    }
 
-    LOG(1, "Normal map saved to '%s'.\n", _outputFile.c_str());
+    if (result)
+    {
+        png_write_end(png_ptr, NULL);
+        LOG(1, "\rCalculating normals... Done.\n");
+        LOG(1, "Normal map saved to '%s'.\n", _outputFile.c_str());
+    }
 
     // Free temp data
-    delete[] normalPixels;
-    normalPixels = NULL;
+    png_free_data(png_ptr, info_ptr, PNG_FREE_ALL, -1);
+    png_destroy_write_struct(&png_ptr, (png_infopp)NULL);
+    fclose(fp);
+    if (!result)
+        remove(_outputFile.c_str());
+    if (source.file)
+        fclose(source.file);
+    SAFE_DELETE(source.image);
+    delete[] heights;
+    delete[] pixels;
 }
 
 }
@@ -0,0 +1,261 @@
+#include "Base.h"
+#include "PackEncoder.h"
+#include "FileIO.h"
+
+#ifdef WIN32
+    #include <windows.h>
+#else
+    #include <dirent.h>
+#endif
+
+#define PACK_ALIGNMENT 16
+#define PACK_COMPRESSION_NONE 0
+#define PACK_COMPRESSION_LZ4 1
+
+namespace gameplay
+{
+
+// The identifier and version of pack files, read by FileSystem::mountArchive.
+static const char PACK_IDENTIFIER[] = { '\xAB', 'G', 'P', 'K', '\xBB', '\r', '\n', '\x1A', '\n' };
+static const unsigned char PACK_VERSION[2] = { 1, 0 };
+
+/**
+ * Writes a length of an LZ4 sequence that didn't fit in its token.
+ */
+static void writeLZ4Length(size_t length, std::vector<unsigned char>& dst)
+{
+    while (length >= 255)
+    {
+        dst.push_back(255);
+        length -= 255;
+    }
+    dst.push_back((unsigned char)length);
+}
+
+/**
+ * Writes an LZ4 sequence of literals, followed by a match unless it is the last sequence.
+ */
+static void writeLZ4Sequence(const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength, std::vector<unsigned char>& dst)
+{
+    size_t matchCode = matchLength > 0 ? matchLength - 4 : 0;
+    dst.push_back((unsigned char)((std::min(literalLength, (size_t)15) << 4) | std::min(matchCode, (size_t)15)));
+    if (literalLength >= 15)
+        writeLZ4Length(literalLength - 15, dst);
+    dst.insert(dst.end(), literals, literals + literalLength);
+    if (matchLength > 0)
+    {
+        dst.push_back((unsigned char)(offset & 0xFF));
+        dst.push_back((unsigned char)(offset >> 8));
+        if (matchCode >= 15)
+            writeLZ4Length(matchCode - 15, dst);
+    }
+}
+
+/**
+ * Compresses data into an LZ4 block, finding matches with a hash table of the last position of each four bytes.
+ */
+static void compressLZ4(const unsigned char* src, size_t size, std::vector<unsigned char>& dst)
+{
+    const unsigned int HASH_BITS = 16;
+    std::vector<int> positions(1 << HASH_BITS, -1);
+
+    // The format requires the last five bytes to be literals, and the last match to start
+    // at least twelve bytes before the end.
+    size_t anchor = 0;
+    size_t position = 0;
+    size_t matchEnd = size > 5 ? size - 5 : 0;
+    size_t matchStartEnd = size > 12 ? size - 12 : 0;
+    while (position < matchStartEnd)
+    {
+        unsigned int sequence;
+        memcpy(&sequence, src + position, 4);
+        unsigned int hash = (sequence * 2654435761u) >> (32 - HASH_BITS);
+        int candidate = positions[hash];
+        positions[hash] = (int)position;
+
+        if (candidate >= 0 && position - (size_t)candidate <= 65535 && memcmp(src + candidate, src + position, 4) == 0)
+        {
+            size_t length = 4;
+            while (position + length < matchEnd && src[candidate + length] == src[position + length])
+                ++length;
+            writeLZ4Sequence(src + anchor, position - anchor, position - (size_t)candidate, length, dst);
+            position += length;
+            anchor = position;
+        }
+        else
+        {
+            ++position;
+        }
+    }
+    writeLZ4Sequence(src + anchor, size - anchor, 0, 0, dst);
+}
+
+PackEncoder::PackEncoder()
+{
+}
+
+PackEncoder::~PackEncoder()
+{
+}
+
+void PackEncoder::addFiles(const std::string& directory, const std::string& prefix)
+{
+    std::vector<std::string> directories;
+#ifdef WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "/*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        std::string name(data.cFileName);
+        if (name == "." || name == "..")
+            continue;
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+        {
+            directories.push_back(name);
+        }
+        else
+        {
+            Entry entry = { prefix + name, directory + "/" + name, PACK_COMPRESSION_NONE, 0, 0, 0 };
+            _entries.push_back(entry);
+        }
+    } while (FindNextFileA(find, &data) != 0);
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return;
+    struct dirent* dp;
+    while ((dp = readdir(dir)) != NULL)
+    {
+        std::string name(dp->d_name);
+        if (name == "." || name == "..")
+            continue;
+        std::string path = directory + "/" + name;
+        struct stat buf;
+        if (stat(path.c_str(), &buf) != 0)
+            continue;
+        if (S_ISDIR(buf.st_mode))
+        {
+            directories.push_back(name);
+        }
+        else
+        {
+            Entry entry = { prefix + name, path, PACK_COMPRESSION_NONE, 0, 0, 0 };
+            _entries.push_back(entry);
+        }
+    }
+    closedir(dir);
+#endif
+
+    for (size_t i = 0, count = directories.size(); i < count; ++i)
+    {
+        addFiles(directory + "/" + directories[i], prefix + directories[i] + "/");
+    }
+}
+
+void PackEncoder::writeDirectory(FILE* file)
+{
+    gameplay::write((unsigned int)_entries.size(), file);
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        const Entry& entry = _entries[i];
+        gameplay::write(entry.name, file);
+        gameplay::write(entry.compression, file);
+        size_t r = fwrite(&entry.offset, sizeof(unsigned long long), 1, file);
+        assert(r == 1);
+        gameplay::write(entry.size, file);
+        gameplay::write(entry.originalSize, file);
+    }
+}
+
+bool PackEncoder::write(const std::string& inputDirectory, const std::string& outputFile, bool compress)
+{
+    _entries.clear();
+    addFiles(inputDirectory, "");
+
+    // A pack written into the directory it packs doesn't pack itself.
+    for (size_t i = 0; i < _entries.size(); ++i)
+    {
+        if (_entries[i].path == outputFile)
+        {
+            _entries.erase(_entries.begin() + i);
+            break;
+        }
+    }
+    std::sort(_entries.begin(), _entries.end());
+
+    FILE* file = fopen(outputFile.c_str(), "wb");
+    if (!file)
+    {
+        LOG(1, "Error: Failed to open file: %s\n", outputFile.c_str());
+        return false;
+    }
+    fwrite(PACK_IDENTIFIER, 1, sizeof(PACK_IDENTIFIER), file);
+    fwrite(PACK_VERSION, 1, sizeof(PACK_VERSION), file);
+
+    // The directory is written once the offsets and sizes of the entries are known.
+    long directoryPosition = ftell(file);
+    writeDirectory(file);
+
+    size_t totalSize = 0;
+    size_t packedSize = 0;
+    std::vector<unsigned char> data;
+    std::vector<unsigned char> compressed;
+    for (size_t i = 0, count = _entries.size(); i < count; ++i)
+    {
+        Entry& entry = _entries[i];
+        FILE* input = fopen(entry.path.c_str(), "rb");
+        if (!input)
+        {
+            LOG(1, "Error: Failed to open file: %s\n", entry.path.c_str());
+            fclose(file);
+            return false;
+        }
+        fseek(input, 0, SEEK_END);
+        long length = ftell(input);
+        fseek(input, 0, SEEK_SET);
+        data.resize(length > 0 ? (size_t)length : 0);
+        if (length > 0 && fread(&data[0], 1, data.size(), input) != data.size())
+        {
+            LOG(1, "Error: Failed to read file: %s\n", entry.path.c_str());
+            fclose(input);
+            fclose(file);
+            return false;
+        }
+        fclose(input);
+
+        entry.originalSize = (unsigned int)data.size();
+        const std::vector<unsigned char>* contents = &data;
+        if (compress && data.size() > 0)
+        {
+            compressed.clear();
+            compressLZ4(&data[0], data.size(), compressed);
+            if (compressed.size() < data.size())
+            {
+                entry.compression = PACK_COMPRESSION_LZ4;
+                contents = &compressed;
+            }
+        }
+        entry.size = (unsigned int)contents->size();
+
+        writePadding(PACK_ALIGNMENT, file);
+        entry.offset = (unsigned long long)ftell(file);
+        if (entry.size > 0)
+            fwrite(&(*contents)[0], 1, entry.size, file);
+
+        totalSize += entry.originalSize;
+        packedSize += entry.size;
+        LOG(2, "  %s (%u bytes%s)\n", entry.name.c_str(), entry.size, entry.compression == PACK_COMPRESSION_LZ4 ? ", LZ4" : "");
+    }
+
+    fseek(file, directoryPosition, SEEK_SET);
+    writeDirectory(file);
+    fclose(file);
+
+    LOG(1, "Packed %u files (%lu bytes into %lu bytes).\n", (unsigned int)_entries.size(), (unsigned long)totalSize, (unsigned long)packedSize);
+    return true;
+}
+
+}
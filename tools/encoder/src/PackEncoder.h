@@ -0,0 +1,77 @@
+#ifndef PACKENCODER_H_
+#define PACKENCODER_H_
+
+namespace gameplay
+{
+
+/**
+ * Writes the files of a directory into a pack file, which games mount with FileSystem::mountArchive
+ * to open many small files without opening each of them on disk.
+ *
+ * A pack starts with its identifier and version, followed by the number of entries and the
+ * directory, which holds the path, compression, offset and sizes of each entry. The paths are
+ * relative to the packed directory, with forward slashes. The data of each entry is aligned to
+ * 16 bytes, so that bundles stored uncompressed can be used in place when the pack is mapped.
+ */
+class PackEncoder
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    PackEncoder();
+
+    /**
+     * Destructor.
+     */
+    ~PackEncoder();
+
+    /**
+     * Writes the pack file.
+     *
+     * @param inputDirectory The directory whose files, including those of its subdirectories, are packed.
+     * @param outputFile The path of the pack file to write.
+     * @param compress true to compress each entry with LZ4 where that makes it smaller.
+     *
+     * @return True if the pack file was written; false otherwise.
+     */
+    bool write(const std::string& inputDirectory, const std::string& outputFile, bool compress);
+
+private:
+
+    struct Entry
+    {
+        std::string name;
+        std::string path;
+        unsigned int compression;
+        unsigned long long offset;
+        unsigned int size;
+        unsigned int originalSize;
+
+        bool operator<(const Entry& other) const { return name < other.name; }
+    };
+
+    // Hidden copy/assignment
+    PackEncoder(const PackEncoder&);
+    PackEncoder& operator=(const PackEncoder&);
+
+    /**
+     * Adds the files in the given directory and its subdirectories to the entries.
+     *
+     * @param directory The path of the directory.
+     * @param prefix The path of the directory relative to the packed one, with a trailing slash.
+     */
+    void addFiles(const std::string& directory, const std::string& prefix);
+
+    /**
+     * Writes the directory of the pack at the current position of the file.
+     */
+    void writeDirectory(FILE* file);
+
+    std::vector<Entry> _entries;
+};
+
+}
+
+#endif
@@ -28,6 +28,11 @@ Object* ReferenceTable::get(const std::string& xref)
     return NULL;
 }
 
+void ReferenceTable::remove(const std::string& xref)
+{
+    _table.erase(xref);
+}
+
 void ReferenceTable::writeBinary(FILE* file)
 {
     write((unsigned int)_table.size(), file);
@@ -35,6 +35,13 @@ public:
 
     Object* get(const std::string& xref);
 
+    /**
+     * Removes the object with the given xref, such as one that is no longer written to the file.
+     * 
+     * @param xref The xref of the object.
+     */
+    void remove(const std::string& xref);
+
     void writeBinary(FILE* file);
     void writeText(FILE* file);
 
@@ -37,6 +37,23 @@ void Sampler::set(const string& name, const string& value)
     props[name] = value;
 }
 
+bool Sampler::equals(const Sampler& sampler, bool ignorePath) const
+{
+    if (_id != sampler._id)
+        return false;
+    if (!ignorePath)
+        return props == sampler.props;
+
+    map<string, string> a(props), b(sampler.props);
+    const char* paths[] = { "path", "absolutePath", "relativePath" };
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+        a.erase(paths[i]);
+        b.erase(paths[i]);
+    }
+    return a == b;
+}
+
 void Sampler::writeMaterial(FILE* file, unsigned int indent, Sampler* parent)
 {
     writeIndent(indent, file);
@@ -26,6 +26,14 @@ public:
     const char* getString(const std::string& name);
     void set(const std::string& name, const std::string& value);
 
+    /**
+     * Returns true if this sampler has the same ID and properties as the given one.
+     *
+     * @param sampler The sampler to compare to.
+     * @param ignorePath true to compare all properties except the path of the texture.
+     */
+    bool equals(const Sampler& sampler, bool ignorePath) const;
+
     /**
      * Writes this sampler to a material file.
      * 
@@ -56,6 +56,11 @@ void Scene::writeText(FILE* file)
     fprintElementEnd(file);
 }
 
+const std::list<Node*>& Scene::getNodes() const
+{
+    return _nodes;
+}
+
 void Scene::add(Node* node)
 {
     _nodes.push_back(node);
@@ -34,6 +34,11 @@ public:
      */
     void add(Node* node);
 
+    /**
+     * Returns the nodes that were added to this scene, which are the roots of its node hierarchies.
+     */
+    const std::list<Node*>& getNodes() const;
+
     /**
      * Sets the activate camera node. This node should contain a camera.
      */
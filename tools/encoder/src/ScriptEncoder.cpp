@@ -0,0 +1,277 @@
+#include "Base.h"
+#include "ScriptEncoder.h"
+#include <lua/lua.hpp>
+
+// The version of Lua whose bytecode can be stripped, and the size of its header
+#define LUA_BYTECODE_VERSION 0x52
+#define LUA_BYTECODE_HEADER_SIZE 18
+
+namespace gameplay
+{
+
+/**
+ * Copies Lua 5.2 bytecode without its debug information.
+ *
+ * The Lua 5.2 library has no option to dump functions without their debug information, so the
+ * dumped functions are rewritten with an empty source name, line info, and local variable and
+ * upvalue names, which is the bytecode that luac -s writes.
+ */
+class BytecodeStripper
+{
+public:
+
+    BytecodeStripper(const std::vector<unsigned char>& src, std::vector<unsigned char>* dst) :
+        _src(src), _dst(dst), _position(0), _valid(true), _intSize(0), _sizeSize(0), _instructionSize(0), _numberSize(0)
+    {
+    }
+
+    bool strip()
+    {
+        if (_src.size() < LUA_BYTECODE_HEADER_SIZE || memcmp(&_src[0], LUA_SIGNATURE, 4) != 0 || _src[4] != LUA_BYTECODE_VERSION)
+            return false;
+
+        // The dump was written by this process, so its sizes are the native ones.
+        _intSize = _src[7];
+        _sizeSize = _src[8];
+        _instructionSize = _src[9];
+        _numberSize = _src[10];
+        if (_intSize != sizeof(int) || _sizeSize != sizeof(size_t))
+            return false;
+
+        copy(LUA_BYTECODE_HEADER_SIZE);
+        stripFunction();
+        return _valid && _position == _src.size();
+    }
+
+private:
+
+    void stripFunction()
+    {
+        // Line defined, last line defined, parameter count, vararg flag and maximum stack size.
+        copy(_intSize * 2 + 3);
+
+        // Code.
+        int count = copyInt();
+        copy((size_t)count * _instructionSize);
+
+        // Constants, followed by the nested functions.
+        count = copyInt();
+        for (int i = 0; i < count && _valid; ++i)
+        {
+            int type = read(1) ? _src[_position] : LUA_TNIL;
+            copy(1);
+            switch (type)
+            {
+            case LUA_TNIL:
+                break;
+            case LUA_TBOOLEAN:
+                copy(1);
+                break;
+            case LUA_TNUMBER:
+                copy(_numberSize);
+                break;
+            case LUA_TSTRING:
+                copyString();
+                break;
+            default:
+                _valid = false;
+                break;
+            }
+        }
+        count = copyInt();
+        for (int i = 0; i < count && _valid; ++i)
+            stripFunction();
+
+        // Upvalues, as their stack flag and index.
+        count = copyInt();
+        copy((size_t)count * 2);
+
+        // Debug information: the source name, line info, local variables and upvalue names.
+        skipString();
+        writeSize(0);
+        count = readInt();
+        skip((size_t)count * _intSize);
+        writeInt(0);
+        count = readInt();
+        for (int i = 0; i < count && _valid; ++i)
+        {
+            skipString();
+            skip(_intSize * 2);
+        }
+        writeInt(0);
+        count = readInt();
+        for (int i = 0; i < count && _valid; ++i)
+            skipString();
+        writeInt(0);
+    }
+
+    bool read(size_t size)
+    {
+        if (!_valid || _position + size > _src.size())
+        {
+            _valid = false;
+            return false;
+        }
+        return true;
+    }
+
+    void copy(size_t size)
+    {
+        if (read(size))
+        {
+            _dst->insert(_dst->end(), _src.begin() + _position, _src.begin() + _position + size);
+            _position += size;
+        }
+    }
+
+    void skip(size_t size)
+    {
+        if (read(size))
+            _position += size;
+    }
+
+    int readInt()
+    {
+        int value = 0;
+        if (read(sizeof(int)))
+        {
+            memcpy(&value, &_src[_position], sizeof(int));
+            _position += sizeof(int);
+        }
+        if (value < 0)
+            _valid = false;
+        return _valid ? value : 0;
+    }
+
+    int copyInt()
+    {
+        int value = readInt();
+        writeInt(value);
+        return value;
+    }
+
+    size_t readSize()
+    {
+        size_t value = 0;
+        if (read(sizeof(size_t)))
+        {
+            memcpy(&value, &_src[_position], sizeof(size_t));
+            _position += sizeof(size_t);
+        }
+        return value;
+    }
+
+    void skipString()
+    {
+        skip(readSize());
+    }
+
+    void copyString()
+    {
+        size_t size = readSize();
+        writeSize(size);
+        copy(size);
+    }
+
+    void writeInt(int value)
+    {
+        const unsigned char* bytes = (const unsigned char*)&value;
+        _dst->insert(_dst->end(), bytes, bytes + sizeof(int));
+    }
+
+    void writeSize(size_t value)
+    {
+        const unsigned char* bytes = (const unsigned char*)&value;
+        _dst->insert(_dst->end(), bytes, bytes + sizeof(size_t));
+    }
+
+    const std::vector<unsigned char>& _src;
+    std::vector<unsigned char>* _dst;
+    size_t _position;
+    bool _valid;
+    size_t _intSize;
+    size_t _sizeSize;
+    size_t _instructionSize;
+    size_t _numberSize;
+};
+
+/**
+ * Appends the chunks of the dumped bytecode to a buffer.
+ */
+static int writeBytecode(lua_State* state, const void* data, size_t size, void* buffer)
+{
+    std::vector<unsigned char>* bytecode = (std::vector<unsigned char>*)buffer;
+    bytecode->insert(bytecode->end(), (const unsigned char*)data, (const unsigned char*)data + size);
+    return 0;
+}
+
+ScriptEncoder::ScriptEncoder()
+{
+}
+
+ScriptEncoder::~ScriptEncoder()
+{
+}
+
+bool ScriptEncoder::write(const std::string& input, const std::string& output, bool strip)
+{
+    std::ifstream in(input.c_str(), std::ios::in | std::ios::binary);
+    if (!in)
+    {
+        LOG(1, "Error: Failed to open file: %s\n", input.c_str());
+        return false;
+    }
+    std::string source((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    in.close();
+
+    // The chunk is named like the scripts that ScriptController loads from source, which is the
+    // name that errors raised by the script report.
+    std::string chunkName("@");
+    chunkName.append(getBaseName(input));
+    chunkName.append(".lua");
+
+    lua_State* state = luaL_newstate();
+    if (luaL_loadbuffer(state, source.c_str(), source.size(), chunkName.c_str()) != LUA_OK)
+    {
+        LOG(1, "Error: Failed to compile script: %s\n", lua_tostring(state, -1));
+        lua_close(state);
+        return false;
+    }
+    std::vector<unsigned char> bytecode;
+    int result = lua_dump(state, &writeBytecode, &bytecode);
+    lua_close(state);
+    if (result != 0 || bytecode.empty())
+    {
+        LOG(1, "Error: Failed to write the bytecode of script: %s\n", input.c_str());
+        return false;
+    }
+
+    if (strip)
+    {
+        std::vector<unsigned char> stripped;
+        BytecodeStripper stripper(bytecode, &stripped);
+        if (stripper.strip())
+            bytecode.swap(stripped);
+        else
+            LOG(1, "Warning: Failed to strip the debug information of script: %s\n", input.c_str());
+    }
+
+    FILE* file = fopen(output.c_str(), "wb");
+    if (!file)
+    {
+        LOG(1, "Error: Failed to open file: %s\n", output.c_str());
+        return false;
+    }
+    size_t written = fwrite(&bytecode[0], 1, bytecode.size(), file);
+    fclose(file);
+    if (written != bytecode.size())
+    {
+        LOG(1, "Error: Failed to write file: %s\n", output.c_str());
+        return false;
+    }
+
+    LOG(1, "Wrote %u bytes of bytecode.\n", (unsigned int)bytecode.size());
+    return true;
+}
+
+}
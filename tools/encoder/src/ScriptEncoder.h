@@ -0,0 +1,49 @@
+#ifndef SCRIPTENCODER_H_
+#define SCRIPTENCODER_H_
+
+namespace gameplay
+{
+
+/**
+ * Compiles Lua scripts into bytecode, which ScriptController loads without parsing the source.
+ *
+ * The bytecode is that of the Lua library the encoder links, so it must be loaded by the same
+ * version of Lua as the game. Games built with LuaJIT compile their scripts with luajit -b instead.
+ */
+class ScriptEncoder
+{
+public:
+
+    /**
+     * Constructor.
+     */
+    ScriptEncoder();
+
+    /**
+     * Destructor.
+     */
+    ~ScriptEncoder();
+
+    /**
+     * Compiles a script and writes its bytecode.
+     *
+     * @param input The Lua script to compile.
+     * @param output The path of the bytecode file to write.
+     * @param strip true to remove the debug information, which holds the line numbers and the names
+     *        of local variables and upvalues, from the bytecode. Errors of stripped scripts do not
+     *        report where they occurred, but the bytecode is smaller and uses less memory once loaded.
+     *
+     * @return True if the bytecode was written; false otherwise.
+     */
+    bool write(const std::string& input, const std::string& output, bool strip);
+
+private:
+
+    // Hidden copy/assignment
+    ScriptEncoder(const ScriptEncoder&);
+    ScriptEncoder& operator=(const ScriptEncoder&);
+};
+
+}
+
+#endif
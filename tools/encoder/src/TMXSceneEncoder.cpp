@@ -3,6 +3,7 @@
 #include <zlib.h>
 
 #include "TMXSceneEncoder.h"
+#include "BuildCache.h"
 
 using namespace gameplay;
 using namespace tinyxml2;
@@ -16,6 +17,10 @@ using std::string;
 
 #define BUFFER_SIZE 256
 
+// The number of tiles along each side of the chunks that tiles are written in, which must
+// match the size of the chunks that TileSet draws
+#define TMX_CHUNK_SIZE 16u
+
 #ifdef WIN32
 #define snprintf(s, n, fmt, ...) sprintf((s), (fmt), __VA_ARGS__)
 #endif
@@ -111,6 +116,7 @@ bool TMXSceneEncoder::parseTmx(const XMLDocument& xmlDoc, TMXMap& map, const str
         {
             XMLError err;
             string tsxLocation = buildFilePath(inputDirectory, attValue);
+            BuildCache::addDependency(tsxLocation);
             if ((err = sourceXmlDoc.LoadFile(tsxLocation.c_str())) != XML_NO_ERROR)
             {
                 LOG(1, "Could not load tileset's source TSX.\n");
@@ -205,6 +211,7 @@ bool TMXSceneEncoder::parseTmx(const XMLDocument& xmlDoc, TMXMap& map, const str
                 return false;
             }
 
+            BuildCache::addDependency(imageLocation);
             Image* img = Image::create(imageLocation.c_str());
             if (!img)
             {
@@ -439,6 +446,7 @@ bool TMXSceneEncoder::buildTileGutterTileset(const TMXTileSet& tileset, const st
     (sx), (sy), (dx), (dy), (w), (h))
 
     // Setup images
+    BuildCache::addDependency(inputFile);
     const Image* inputImage = Image::create(inputFile.c_str());
     if (!inputImage)
     {
@@ -708,32 +716,65 @@ void TMXSceneEncoder::writeSoloTileset(const TMXMap& map, const gameplay::TMXTil
         WRITE_PROPERTY_NEWLINE();
     }
 
-    // Write tiles
+    // Write tiles in the chunks that the runtime draws them in, each with the bounds of its
+    // tiles and the runs of adjacent tiles along its rows, so that large maps load without
+    // a namespace per tile and empty chunks are never built.
+    snprintf(buffer, BUFFER_SIZE, "chunkSize = %u", TMX_CHUNK_SIZE);
+    WRITE_PROPERTY_DIRECT(buffer);
     unsigned int tilesetHeight = tileset.getHeight();
     unsigned int tilesetWidth = tileset.getWidth();
-    for (unsigned int y = 0; y < tilesetHeight; y++)
+    for (unsigned int chunkY = 0; chunkY < tilesetHeight; chunkY += TMX_CHUNK_SIZE)
     {
-        bool tilesWritten = false;
-        for (unsigned int x = 0; x < tilesetWidth; x++)
+        for (unsigned int chunkX = 0; chunkX < tilesetWidth; chunkX += TMX_CHUNK_SIZE)
         {
-            Vector2 startPos = tileset.getTileStart(x, y, map, resultOnlyForTileset);
-            if (startPos.x < 0 || startPos.y < 0)
+            unsigned int endX = std::min(chunkX + TMX_CHUNK_SIZE, tilesetWidth);
+            unsigned int endY = std::min(chunkY + TMX_CHUNK_SIZE, tilesetHeight);
+            unsigned int minX = endX, minY = endY, maxX = chunkX, maxY = chunkY;
+            std::vector<string> runs;
+            for (unsigned int y = chunkY; y < endY; y++)
+            {
+                string run;
+                for (unsigned int x = chunkX; x <= endX; x++)
+                {
+                    Vector2 startPos = x < endX ? tileset.getTileStart(x, y, map, resultOnlyForTileset) : Vector2(-1, -1);
+                    if (startPos.x < 0 || startPos.y < 0)
+                    {
+                        if (!run.empty())
+                        {
+                            runs.push_back(run);
+                            run.clear();
+                        }
+                        continue;
+                    }
+
+                    if (run.empty())
+                    {
+                        snprintf(buffer, BUFFER_SIZE, "run = %u, %u", x, y);
+                        run = buffer;
+                    }
+                    snprintf(buffer, BUFFER_SIZE, ", %u, %u", static_cast<unsigned int>(startPos.x), static_cast<unsigned int>(startPos.y));
+                    run += buffer;
+                    minX = std::min(minX, x);
+                    minY = std::min(minY, y);
+                    maxX = std::max(maxX, x);
+                    maxY = std::max(maxY, y);
+                }
+            }
+            if (runs.empty())
             {
                 continue;
             }
 
-            tilesWritten = true;
-            WRITE_PROPERTY_BLOCK_START("tile");
-            snprintf(buffer, BUFFER_SIZE, "cell = %u, %u", x, y);
-            WRITE_PROPERTY_DIRECT(buffer);
-            snprintf(buffer, BUFFER_SIZE, "source = %u, %u", static_cast<unsigned int>(startPos.x), static_cast<unsigned int>(startPos.y));
+            WRITE_PROPERTY_NEWLINE();
+            WRITE_PROPERTY_BLOCK_START("chunk");
+            snprintf(buffer, BUFFER_SIZE, "bounds = %u, %u, %u, %u", minX, minY, maxX, maxY);
             WRITE_PROPERTY_DIRECT(buffer);
+            for (size_t i = 0; i < runs.size(); i++)
+            {
+                WRITE_PROPERTY_DIRECT(runs[i]);
+            }
             WRITE_PROPERTY_BLOCK_END();
         }
-        if (tilesWritten && ((y + 1) != tilesetHeight))
-        {
-            WRITE_PROPERTY_NEWLINE();
-        }
     }
 
     WRITE_PROPERTY_BLOCK_END();
@@ -2,6 +2,13 @@
 #include "TTFFontEncoder.h"
 #include "GPBFile.h"
 #include "StringUtil.h"
+#include "Thread.h"
+
+// The number of rows on each side of a band of a distance field that are computed along with it.
+#define DISTANCE_FIELD_MARGIN 16
+
+// The fewest rows that a distance field is split into bands of.
+#define DISTANCE_FIELD_MIN_BAND_ROWS 64
 
 namespace gameplay
 {
@@ -34,7 +41,11 @@ static void writeString(FILE* fp, const char* str)
     }
 }
 
-unsigned char* createDistanceFields(unsigned char* img, unsigned int width, unsigned int height)
+/**
+ * Computes the distance field of an image into out. The levels of the image are rescaled by the
+ * given minimum and maximum, so that the bands of one image are rescaled the same way.
+ */
+static void createDistanceField(const unsigned char* img, unsigned int width, unsigned int height, double imgMin, double imgMax, unsigned char* out)
 {
     short* xDistance = (short*)malloc(width * height * sizeof(short));
     short* yDistance = (short*)malloc(width * height * sizeof(short));
@@ -45,18 +56,6 @@ unsigned char* createDistanceFields(unsigned char* img, unsigned int width, unsi
     double* inside = (double*)calloc(width * height, sizeof(double));
     unsigned int i;
 
-    // Convert img into double (data)
-    double imgMin = 255;
-    double imgMax = -255;
-    for (i = 0; i < width * height; ++i)
-    {
-        double v = img[i];
-        data[i] = v;
-        if (v > imgMax) 
-            imgMax = v;
-        if (v < imgMin) 
-            imgMin = v;
-    }
     // Rescale image levels between 0 and 1
     for (i = 0; i < width * height; ++i)
     {
@@ -64,7 +63,7 @@ unsigned char* createDistanceFields(unsigned char* img, unsigned int width, unsi
     }
     // Compute outside = edtaa3(bitmap); % Transform background (0's)
     computegradient(data, width, height, gx, gy);
-    edtaa3(data, gx, gy, height, width, xDistance, yDistance, outside);
+    edtaa3(data, gx, gy, width, height, xDistance, yDistance, outside);
     for (i = 0; i < width * height; ++i)
     {
         if (outside[i] < 0 )
@@ -78,14 +77,13 @@ unsigned char* createDistanceFields(unsigned char* img, unsigned int width, unsi
         data[i] = 1 - data[i];
     }
     computegradient(data, width, height, gx, gy);
-    edtaa3(data, gx, gy, height, width, xDistance, yDistance, inside);
+    edtaa3(data, gx, gy, width, height, xDistance, yDistance, inside);
     for (i = 0; i < width * height; ++i)
     {
         if( inside[i] < 0 )
             inside[i] = 0.0;
     }
     // distmap = outside - inside; % Bipolar distance field
-    unsigned char* out = (unsigned char*)malloc(sizeof(unsigned char) * width * height);
     for (i = 0; i < width * height; ++i)
     {
         outside[i] -= inside[i];
@@ -103,7 +101,92 @@ unsigned char* createDistanceFields(unsigned char* img, unsigned int width, unsi
     free(data);
     free(outside);
     free(inside);
+}
+
+/**
+ * The rows of an image that one thread computes the distance field of.
+ */
+struct DistanceFieldBand
+{
+    const unsigned char* img;
+    unsigned int width;
+    unsigned int height;
+    unsigned int firstRow;
+    unsigned int endRow;
+    double imgMin;
+    double imgMax;
+    unsigned char* out;
+};
 
+/**
+ * Computes the distance field of a band of rows. This is the entry point of each thread of createDistanceFields().
+ *
+ * @param data The DistanceFieldBand to compute.
+ */
+static int createDistanceFieldBand(void* data)
+{
+    // The band is computed with DISTANCE_FIELD_MARGIN rows of its neighbours on each side. Distances
+    // saturate well within the margin, so the rows of the band come out as if the whole image was computed.
+    const DistanceFieldBand* band = static_cast<const DistanceFieldBand*>(data);
+    unsigned int top = band->firstRow > DISTANCE_FIELD_MARGIN ? band->firstRow - DISTANCE_FIELD_MARGIN : 0;
+    unsigned int bottom = std::min(band->height, band->endRow + DISTANCE_FIELD_MARGIN);
+    unsigned char* out = (unsigned char*)malloc(band->width * (bottom - top));
+    createDistanceField(band->img + top * band->width, band->width, bottom - top, band->imgMin, band->imgMax, out);
+    memcpy(band->out + band->firstRow * band->width, out + (band->firstRow - top) * band->width, (band->endRow - band->firstRow) * band->width);
+    free(out);
+    return 0;
+}
+
+/**
+ * Returns the distance field of an image, which is computed in bands of rows on a thread per processor.
+ */
+unsigned char* createDistanceFields(unsigned char* img, unsigned int width, unsigned int height)
+{
+    double imgMin = 255;
+    double imgMax = -255;
+    for (unsigned int i = 0; i < width * height; ++i)
+    {
+        double v = img[i];
+        if (v > imgMax) 
+            imgMax = v;
+        if (v < imgMin) 
+            imgMin = v;
+    }
+
+    unsigned int bandCount = std::max(1u, std::min(getProcessorCount(), height / DISTANCE_FIELD_MIN_BAND_ROWS));
+    unsigned int bandRows = (height + bandCount - 1) / bandCount;
+    unsigned char* out = (unsigned char*)malloc(sizeof(unsigned char) * width * height);
+    std::vector<DistanceFieldBand> bands(bandCount);
+    for (unsigned int i = 0; i < bandCount; ++i)
+    {
+        DistanceFieldBand& band = bands[i];
+        band.img = img;
+        band.width = width;
+        band.height = height;
+        band.firstRow = std::min(height, i * bandRows);
+        band.endRow = std::min(height, (i + 1) * bandRows);
+        band.imgMin = imgMin;
+        band.imgMax = imgMax;
+        band.out = out;
+    }
+
+    // The first band is computed on this thread, as is any band that a thread couldn't be started for.
+    std::vector<THREAD_HANDLE> threads;
+    for (unsigned int i = 1; i < bandCount; ++i)
+    {
+        THREAD_HANDLE thread;
+        if (createThread(&thread, &createDistanceFieldBand, &bands[i]))
+            threads.push_back(thread);
+        else
+            createDistanceFieldBand(&bands[i]);
+    }
+    createDistanceFieldBand(&bands[0]);
+    if (!threads.empty())
+    {
+        waitForThreads((int)threads.size(), &threads[0]);
+        for (size_t i = 0, count = threads.size(); i < count; ++i)
+            closeThread(threads[i]);
+    }
     return out;
 }
 
@@ -388,6 +471,9 @@ int writeFont(const char* inFilePath, const char* outFilePath, std::vector<unsig
     fwrite(fileHeader, sizeof(char), 9, gpbFp);
     fwrite(gameplay::GPB_VERSION, sizeof(char), 2, gpbFp);
 
+    // No string table, since the few strings of a font are written inline.
+    writeUint(gpbFp, 0);
+
     // Write Ref table (for a single font)
     writeUint(gpbFp, 1);                // Ref[] count
     writeString(gpbFp, id);             // Ref id
@@ -446,8 +532,7 @@ int writeFont(const char* inFilePath, const char* outFilePath, std::vector<unsig
 
         if (fontFormat == Font::DISTANCE_FIELD)
         {
-            // Flip height and width since the distance field map generator is column-wise.
-            unsigned char* distanceFieldBuffer = createDistanceFields(font->imageBuffer, font->imageHeight, font->imageWidth);
+            unsigned char* distanceFieldBuffer = createDistanceFields(font->imageBuffer, font->imageWidth, font->imageHeight);
 
             fwrite(distanceFieldBuffer, sizeof(unsigned char), imageSize, gpbFp);
             writeUint(gpbFp, Font::DISTANCE_FIELD);
@@ -0,0 +1,724 @@
+#include "Base.h"
+#include "TextureEncoder.h"
+#include "Image.h"
+#include "StringUtil.h"
+#include "Thread.h"
+#include <climits>
+
+#ifdef WIN32
+    #include <windows.h>
+    #include <direct.h>
+    #define mkdir(path, mode) _mkdir(path)
+#else
+    #include <dirent.h>
+#endif
+
+// Number of threads to spawn for encoding the textures of a directory
+#define THREAD_COUNT 8
+
+// The values of the KTX header, read by Texture::createCompressedKTX
+#define KTX_ENDIANNESS 0x04030201
+#define GL_UNSIGNED_BYTE 0x1401
+#define GL_RGB 0x1907
+#define GL_RGBA 0x1908
+#define GL_ETC1_RGB8_OES 0x8D64
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+
+namespace gameplay
+{
+
+static const unsigned char KTX_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n' };
+
+// The intensity modifiers of each ETC1 table, for the small and large positive offsets.
+static const int ETC1_MODIFIERS[8][2] = { { 2, 8 }, { 5, 17 }, { 9, 29 }, { 13, 42 }, { 18, 60 }, { 24, 80 }, { 33, 106 }, { 47, 183 } };
+
+/**
+ * A level of a texture, as RGBA bytes.
+ */
+struct TextureLevel
+{
+    unsigned int width;
+    unsigned int height;
+    std::vector<unsigned char> pixels;
+
+    const unsigned char* getPixel(unsigned int x, unsigned int y) const
+    {
+        // Blocks that overlap the edge of the level repeat its last row and column.
+        x = min(x, width - 1);
+        y = min(y, height - 1);
+        return &pixels[(y * width + x) * 4];
+    }
+};
+
+/**
+ * Returns the next level of the mipmap chain, where each pixel is the average of the 2x2 pixels it covers.
+ */
+static void downsample(const TextureLevel& src, TextureLevel* dst)
+{
+    dst->width = max(src.width / 2, 1u);
+    dst->height = max(src.height / 2, 1u);
+    dst->pixels.resize(dst->width * dst->height * 4);
+    for (unsigned int y = 0; y < dst->height; ++y)
+    {
+        for (unsigned int x = 0; x < dst->width; ++x)
+        {
+            const unsigned char* p0 = src.getPixel(x * 2, y * 2);
+            const unsigned char* p1 = src.getPixel(x * 2 + 1, y * 2);
+            const unsigned char* p2 = src.getPixel(x * 2, y * 2 + 1);
+            const unsigned char* p3 = src.getPixel(x * 2 + 1, y * 2 + 1);
+            unsigned char* p = &dst->pixels[(y * dst->width + x) * 4];
+            for (unsigned int c = 0; c < 4; ++c)
+            {
+                p[c] = (unsigned char)((p0[c] + p1[c] + p2[c] + p3[c] + 2) / 4);
+            }
+        }
+    }
+}
+
+/**
+ * Reads the 4x4 block of pixels whose top left pixel is at the given position.
+ */
+static void readBlock(const TextureLevel& level, unsigned int x, unsigned int y, unsigned char block[16][4])
+{
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        memcpy(block[i], level.getPixel(x + (i % 4), y + (i / 4)), 4);
+    }
+}
+
+static inline int clampByte(int value)
+{
+    return value < 0 ? 0 : (value > 255 ? 255 : value);
+}
+
+static inline int colorDistance(const unsigned char* a, const int* b)
+{
+    int r = a[0] - b[0];
+    int g = a[1] - b[1];
+    int bl = a[2] - b[2];
+    return r * r + g * g + bl * bl;
+}
+
+/**
+ * Finds the ETC1 table that fits the pixels of a subblock best around its base color.
+ *
+ * @return The squared error of the subblock, with its table and the modifier of each pixel.
+ */
+static int encodeETC1Subblock(unsigned char block[16][4], const unsigned int* pixels, const int* base, unsigned int* table, unsigned int* modifiers)
+{
+    int bestError = INT_MAX;
+    for (unsigned int t = 0; t < 8; ++t)
+    {
+        // The modifiers are stored as +small, +large, -small, -large.
+        const int offsets[4] = { ETC1_MODIFIERS[t][0], ETC1_MODIFIERS[t][1], -ETC1_MODIFIERS[t][0], -ETC1_MODIFIERS[t][1] };
+        int error = 0;
+        unsigned int selected[8];
+        for (unsigned int i = 0; i < 8 && error < bestError; ++i)
+        {
+            int best = INT_MAX;
+            for (unsigned int m = 0; m < 4; ++m)
+            {
+                int color[3] = { clampByte(base[0] + offsets[m]), clampByte(base[1] + offsets[m]), clampByte(base[2] + offsets[m]) };
+                int distance = colorDistance(block[pixels[i]], color);
+                if (distance < best)
+                {
+                    best = distance;
+                    selected[i] = m;
+                }
+            }
+            error += best;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            *table = t;
+            memcpy(modifiers, selected, sizeof(selected));
+        }
+    }
+    return bestError;
+}
+
+/**
+ * Encodes a 4x4 block of pixels into an ETC1 block, trying both subblock orientations in individual and differential mode.
+ */
+static void encodeETC1(unsigned char block[16][4], unsigned char* dst)
+{
+    unsigned long long bestBits = 0;
+    int bestError = INT_MAX;
+    for (unsigned int flip = 0; flip < 2; ++flip)
+    {
+        // Without flip the subblocks are the left and right 2x4 pixels, with flip the top and bottom 4x2 pixels.
+        unsigned int pixels[2][8];
+        unsigned int counts[2] = { 0, 0 };
+        int average[2][3] = { { 0, 0, 0 }, { 0, 0, 0 } };
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            unsigned int x = i % 4;
+            unsigned int y = i / 4;
+            unsigned int subblock = flip ? (y >= 2) : (x >= 2);
+            pixels[subblock][counts[subblock]++] = i;
+            for (unsigned int c = 0; c < 3; ++c)
+                average[subblock][c] += block[i][c];
+        }
+
+        for (unsigned int diff = 0; diff < 2; ++diff)
+        {
+            int quantized[2][3];
+            int base[2][3];
+            bool valid = true;
+            for (unsigned int s = 0; s < 2; ++s)
+            {
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    float value = average[s][c] / 8.0f;
+                    if (diff)
+                    {
+                        quantized[s][c] = (int)(value * 31.0f / 255.0f + 0.5f);
+                        base[s][c] = (quantized[s][c] << 3) | (quantized[s][c] >> 2);
+                    }
+                    else
+                    {
+                        quantized[s][c] = (int)(value * 15.0f / 255.0f + 0.5f);
+                        base[s][c] = (quantized[s][c] << 4) | quantized[s][c];
+                    }
+                }
+            }
+            if (diff)
+            {
+                // The second color is stored as a three bit signed offset from the first.
+                for (unsigned int c = 0; c < 3; ++c)
+                {
+                    int delta = quantized[1][c] - quantized[0][c];
+                    valid = valid && delta >= -4 && delta <= 3;
+                }
+            }
+            if (!valid)
+                continue;
+
+            unsigned int tables[2];
+            unsigned int modifiers[2][8];
+            int error = encodeETC1Subblock(block, pixels[0], base[0], &tables[0], modifiers[0]);
+            if (error >= bestError)
+                continue;
+            error += encodeETC1Subblock(block, pixels[1], base[1], &tables[1], modifiers[1]);
+            if (error >= bestError)
+                continue;
+
+            unsigned long long bits = 0;
+            for (unsigned int c = 0; c < 3; ++c)
+            {
+                unsigned int shift = 56 - c * 8;
+                if (diff)
+                    bits |= ((unsigned long long)quantized[0][c] << (shift + 3)) | ((unsigned long long)((quantized[1][c] - quantized[0][c]) & 7) << shift);
+                else
+                    bits |= ((unsigned long long)quantized[0][c] << (shift + 4)) | ((unsigned long long)quantized[1][c] << shift);
+            }
+            bits |= ((unsigned long long)tables[0] << 37) | ((unsigned long long)tables[1] << 34) | ((unsigned long long)diff << 33) | ((unsigned long long)flip << 32);
+
+            // The pixel indices are stored by column, with the high bits of all pixels before the low bits.
+            for (unsigned int s = 0; s < 2; ++s)
+            {
+                for (unsigned int i = 0; i < 8; ++i)
+                {
+                    unsigned int pixel = pixels[s][i];
+                    unsigned int index = (pixel % 4) * 4 + pixel / 4;
+                    bits |= ((unsigned long long)(modifiers[s][i] >> 1) << (index + 16)) | ((unsigned long long)(modifiers[s][i] & 1) << index);
+                }
+            }
+            bestError = error;
+            bestBits = bits;
+        }
+    }
+
+    for (unsigned int i = 0; i < 8; ++i)
+    {
+        dst[i] = (unsigned char)(bestBits >> (56 - i * 8));
+    }
+}
+
+static inline unsigned short packRGB565(const float* color)
+{
+    int r = (int)(clampByte((int)(color[0] + 0.5f)) * 31.0f / 255.0f + 0.5f);
+    int g = (int)(clampByte((int)(color[1] + 0.5f)) * 63.0f / 255.0f + 0.5f);
+    int b = (int)(clampByte((int)(color[2] + 0.5f)) * 31.0f / 255.0f + 0.5f);
+    return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+static inline void unpackRGB565(unsigned short value, int* color)
+{
+    int r = (value >> 11) & 31;
+    int g = (value >> 5) & 63;
+    int b = value & 31;
+    color[0] = (r << 3) | (r >> 2);
+    color[1] = (g << 2) | (g >> 4);
+    color[2] = (b << 3) | (b >> 2);
+}
+
+/**
+ * Encodes the colors of a 4x4 block of pixels into a BC1 block, with the endpoints at the extremes
+ * of the principal axis of the colors.
+ */
+static void encodeBC1(unsigned char block[16][4], unsigned char* dst)
+{
+    float mean[3] = { 0.0f, 0.0f, 0.0f };
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        for (unsigned int c = 0; c < 3; ++c)
+            mean[c] += block[i][c] / 16.0f;
+    }
+    float covariance[6] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        float r = block[i][0] - mean[0];
+        float g = block[i][1] - mean[1];
+        float b = block[i][2] - mean[2];
+        covariance[0] += r * r;
+        covariance[1] += r * g;
+        covariance[2] += r * b;
+        covariance[3] += g * g;
+        covariance[4] += g * b;
+        covariance[5] += b * b;
+    }
+
+    // Find the principal axis by power iteration.
+    float axis[3] = { 1.0f, 1.0f, 1.0f };
+    for (unsigned int iteration = 0; iteration < 8; ++iteration)
+    {
+        float x = covariance[0] * axis[0] + covariance[1] * axis[1] + covariance[2] * axis[2];
+        float y = covariance[1] * axis[0] + covariance[3] * axis[1] + covariance[4] * axis[2];
+        float z = covariance[2] * axis[0] + covariance[4] * axis[1] + covariance[5] * axis[2];
+        float length = max(max(fabsf(x), fabsf(y)), fabsf(z));
+        if (length < MATH_EPSILON)
+            break;
+        axis[0] = x / length;
+        axis[1] = y / length;
+        axis[2] = z / length;
+    }
+
+    float minProjection = FLT_MAX;
+    float maxProjection = -FLT_MAX;
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        float projection = (block[i][0] - mean[0]) * axis[0] + (block[i][1] - mean[1]) * axis[1] + (block[i][2] - mean[2]) * axis[2];
+        minProjection = min(minProjection, projection);
+        maxProjection = max(maxProjection, projection);
+    }
+    float axisLength = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+    float color0[3];
+    float color1[3];
+    for (unsigned int c = 0; c < 3; ++c)
+    {
+        color0[c] = mean[c] + axis[c] * maxProjection / axisLength;
+        color1[c] = mean[c] + axis[c] * minProjection / axisLength;
+    }
+    unsigned short endpoint0 = packRGB565(color0);
+    unsigned short endpoint1 = packRGB565(color1);
+
+    // The first endpoint must be the greater one to select the four color mode, which has no transparent color.
+    if (endpoint0 < endpoint1)
+        std::swap(endpoint0, endpoint1);
+
+    unsigned int indices = 0;
+    if (endpoint0 != endpoint1)
+    {
+        int palette[4][3];
+        unpackRGB565(endpoint0, palette[0]);
+        unpackRGB565(endpoint1, palette[1]);
+        for (unsigned int c = 0; c < 3; ++c)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            unsigned int best = 0;
+            int bestDistance = INT_MAX;
+            for (unsigned int p = 0; p < 4; ++p)
+            {
+                int distance = colorDistance(block[i], palette[p]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= best << (i * 2);
+        }
+    }
+
+    dst[0] = (unsigned char)(endpoint0 & 0xFF);
+    dst[1] = (unsigned char)(endpoint0 >> 8);
+    dst[2] = (unsigned char)(endpoint1 & 0xFF);
+    dst[3] = (unsigned char)(endpoint1 >> 8);
+    for (unsigned int i = 0; i < 4; ++i)
+        dst[4 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+/**
+ * Encodes the alpha of a 4x4 block of pixels into the alpha block of a BC3 block, with the endpoints
+ * at the minimum and maximum alpha.
+ */
+static void encodeBC3Alpha(unsigned char block[16][4], unsigned char* dst)
+{
+    int alpha0 = 0;
+    int alpha1 = 255;
+    for (unsigned int i = 0; i < 16; ++i)
+    {
+        alpha0 = max(alpha0, (int)block[i][3]);
+        alpha1 = min(alpha1, (int)block[i][3]);
+    }
+
+    unsigned long long indices = 0;
+    if (alpha0 != alpha1)
+    {
+        // The first endpoint is the greater one to select the mode of eight interpolated values.
+        int palette[8] = { alpha0, alpha1 };
+        for (int i = 1; i < 7; ++i)
+            palette[i + 1] = ((7 - i) * alpha0 + i * alpha1) / 7;
+        for (unsigned int i = 0; i < 16; ++i)
+        {
+            unsigned int best = 0;
+            int bestDistance = INT_MAX;
+            for (unsigned int p = 0; p < 8; ++p)
+            {
+                int distance = abs(block[i][3] - palette[p]);
+                if (distance < bestDistance)
+                {
+                    bestDistance = distance;
+                    best = p;
+                }
+            }
+            indices |= (unsigned long long)best << (i * 3);
+        }
+    }
+
+    dst[0] = (unsigned char)alpha0;
+    dst[1] = (unsigned char)alpha1;
+    for (unsigned int i = 0; i < 6; ++i)
+        dst[2 + i] = (unsigned char)(indices >> (i * 8));
+}
+
+/**
+ * Writes a level of the texture in the given format.
+ */
+static void encodeLevel(const TextureLevel& level, TextureEncoder::Format format, bool alpha, std::vector<unsigned char>* data)
+{
+    data->clear();
+    if (format == TextureEncoder::UNCOMPRESSED)
+    {
+        // Rows are padded to four bytes.
+        unsigned int bpp = alpha ? 4 : 3;
+        unsigned int stride = (level.width * bpp + 3) & ~3u;
+        data->resize(stride * level.height, 0);
+        for (unsigned int y = 0; y < level.height; ++y)
+        {
+            for (unsigned int x = 0; x < level.width; ++x)
+            {
+                memcpy(&(*data)[y * stride + x * bpp], level.getPixel(x, y), bpp);
+            }
+        }
+        return;
+    }
+
+    unsigned int blockSize = format == TextureEncoder::BC3 ? 16 : 8;
+    unsigned int blocksX = (level.width + 3) / 4;
+    unsigned int blocksY = (level.height + 3) / 4;
+    data->resize(blocksX * blocksY * blockSize);
+    unsigned char* dst = &(*data)[0];
+    unsigned char block[16][4];
+    for (unsigned int y = 0; y < blocksY; ++y)
+    {
+        for (unsigned int x = 0; x < blocksX; ++x)
+        {
+            readBlock(level, x * 4, y * 4, block);
+            switch (format)
+            {
+            case TextureEncoder::ETC1:
+                encodeETC1(block, dst);
+                break;
+            case TextureEncoder::BC1:
+                encodeBC1(block, dst);
+                break;
+            case TextureEncoder::BC3:
+                encodeBC3Alpha(block, dst);
+                encodeBC1(block, dst + 8);
+                break;
+            default:
+                break;
+            }
+            dst += blockSize;
+        }
+    }
+}
+
+static void writeUInt(unsigned int value, FILE* file)
+{
+    fwrite(&value, sizeof(unsigned int), 1, file);
+}
+
+/**
+ * Creates the directories of the given file path that don't exist yet.
+ */
+static void createDirectories(const std::string& path)
+{
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1))
+    {
+        mkdir(path.substr(0, pos).c_str(), 0777);
+    }
+}
+
+TextureEncoder::TextureEncoder()
+{
+}
+
+TextureEncoder::~TextureEncoder()
+{
+}
+
+void TextureEncoder::addFiles(const std::string& directory, const std::string& output)
+{
+    std::vector<std::string> names;
+    std::vector<std::string> directories;
+#ifdef WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "/*").c_str(), &data);
+    if (find == INVALID_HANDLE_VALUE)
+        return;
+    do
+    {
+        std::string name(data.cFileName);
+        if (name == "." || name == "..")
+            continue;
+        if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+            directories.push_back(name);
+        else
+            names.push_back(name);
+    } while (FindNextFileA(find, &data) != 0);
+    FindClose(find);
+#else
+    DIR* dir = opendir(directory.c_str());
+    if (!dir)
+        return;
+    struct dirent* dp;
+    while ((dp = readdir(dir)) != NULL)
+    {
+        std::string name(dp->d_name);
+        if (name == "." || name == "..")
+            continue;
+        struct stat buf;
+        if (stat((directory + "/" + name).c_str(), &buf) != 0)
+            continue;
+        if (S_ISDIR(buf.st_mode))
+            directories.push_back(name);
+        else
+            names.push_back(name);
+    }
+    closedir(dir);
+#endif
+
+    for (size_t i = 0, count = names.size(); i < count; ++i)
+    {
+        const std::string& name = names[i];
+        if (name.size() > 4 && (endsWith(name.c_str(), ".png") || endsWith(name.c_str(), ".PNG")))
+        {
+            Job job;
+            job.input = directory + "/" + name;
+            job.output = output + "/" + name.substr(0, name.size() - 4) + ".ktx";
+            _jobs.push_back(job);
+        }
+    }
+    for (size_t i = 0, count = directories.size(); i < count; ++i)
+    {
+        addFiles(directory + "/" + directories[i], output + "/" + directories[i]);
+    }
+}
+
+bool TextureEncoder::write(const std::string& input, const std::string& output, Format format, bool premultiplyAlpha)
+{
+    _jobs.clear();
+    struct stat buf;
+    if (stat(input.c_str(), &buf) == 0 && (buf.st_mode & S_IFDIR) != 0)
+    {
+        addFiles(input, output);
+    }
+    else
+    {
+        Job job;
+        job.input = input;
+        job.output = output;
+        _jobs.push_back(job);
+    }
+    for (size_t i = 0, count = _jobs.size(); i < count; ++i)
+    {
+        _jobs[i].format = format;
+        _jobs[i].premultiplyAlpha = premultiplyAlpha;
+        _jobs[i].result = false;
+    }
+    if (_jobs.empty())
+    {
+        LOG(1, "Warning: No PNG files found in: %s\n", input.c_str());
+        return true;
+    }
+
+    // Each thread encodes every THREAD_COUNT'th texture.
+    unsigned int threadCount = min((unsigned int)THREAD_COUNT, (unsigned int)_jobs.size());
+    ThreadData* threadData = new ThreadData[threadCount];
+    THREAD_HANDLE* threads = new THREAD_HANDLE[threadCount];
+    unsigned int started = 0;
+    for (unsigned int i = 0; i < threadCount; ++i)
+    {
+        ThreadData& data = threadData[i];
+        data.jobs = &_jobs;
+        data.index = i;
+        data.count = threadCount;
+        if (!createThread(&threads[i], &encodeJobs, &data))
+        {
+            LOG(1, "Error: Failed to spawn worker thread for encoding textures.\n");
+            break;
+        }
+        ++started;
+    }
+
+    // Wait for all threads to terminate
+    waitForThreads(started, threads);
+    for (unsigned int i = 0; i < started; ++i)
+        closeThread(threads[i]);
+    delete[] threads;
+    delete[] threadData;
+
+    unsigned int written = 0;
+    for (size_t i = 0, count = _jobs.size(); i < count; ++i)
+    {
+        if (_jobs[i].result)
+            ++written;
+    }
+    LOG(1, "Wrote %u of %u textures.\n", written, (unsigned int)_jobs.size());
+    return written == _jobs.size();
+}
+
+int TextureEncoder::encodeJobs(void* data)
+{
+    ThreadData* threadData = static_cast<ThreadData*>(data);
+    std::vector<Job>& jobs = *threadData->jobs;
+    for (size_t i = threadData->index, count = jobs.size(); i < count; i += threadData->count)
+    {
+        jobs[i].result = encode(jobs[i]);
+    }
+    return 0;
+}
+
+bool TextureEncoder::encode(const Job& job)
+{
+    Image* image = Image::create(job.input.c_str());
+    if (image == NULL)
+        return false;
+
+    // Expand the image to RGBA.
+    TextureLevel level;
+    level.width = image->getWidth();
+    level.height = image->getHeight();
+    level.pixels.resize(level.width * level.height * 4);
+    const unsigned char* src = (const unsigned char*)image->getData();
+    unsigned int bpp = image->getBpp();
+    bool alpha = image->getFormat() == Image::RGBA;
+    for (unsigned int i = 0, count = level.width * level.height; i < count; ++i)
+    {
+        unsigned char* p = &level.pixels[i * 4];
+        const unsigned char* s = src + i * bpp;
+        p[0] = s[0];
+        p[1] = bpp >= 3 ? s[1] : s[0];
+        p[2] = bpp >= 3 ? s[2] : s[0];
+        p[3] = alpha ? s[3] : 255;
+        if (alpha && job.premultiplyAlpha)
+        {
+            for (unsigned int c = 0; c < 3; ++c)
+                p[c] = (unsigned char)((p[c] * p[3] + 127) / 255);
+        }
+    }
+    delete image;
+
+    if (alpha && (job.format == ETC1 || job.format == BC1))
+    {
+        LOG(2, "Warning: The alpha of '%s' is dropped by the texture format; use -tex:bc3 to keep it.\n", job.input.c_str());
+    }
+
+    unsigned int glType = 0;
+    unsigned int glFormat = 0;
+    unsigned int glInternalFormat;
+    unsigned int glBaseInternalFormat;
+    switch (job.format)
+    {
+    case ETC1:
+        glInternalFormat = GL_ETC1_RGB8_OES;
+        glBaseInternalFormat = GL_RGB;
+        break;
+    case BC1:
+        glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        glBaseInternalFormat = GL_RGB;
+        break;
+    case BC3:
+        glInternalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        glBaseInternalFormat = GL_RGBA;
+        break;
+    default:
+        glType = GL_UNSIGNED_BYTE;
+        glFormat = alpha ? GL_RGBA : GL_RGB;
+        glInternalFormat = glFormat;
+        glBaseInternalFormat = glFormat;
+        break;
+    }
+
+    unsigned int levelCount = 1;
+    for (unsigned int size = max(level.width, level.height); size > 1; size /= 2)
+        ++levelCount;
+
+    createDirectories(job.output);
+    FILE* file = fopen(job.output.c_str(), "wb");
+    if (!file)
+    {
+        LOG(1, "Error: Failed to open file: %s\n", job.output.c_str());
+        return false;
+    }
+    fwrite(KTX_IDENTIFIER, 1, sizeof(KTX_IDENTIFIER), file);
+    writeUInt(KTX_ENDIANNESS, file);
+    writeUInt(glType, file);
+    writeUInt(1, file);
+    writeUInt(glFormat, file);
+    writeUInt(glInternalFormat, file);
+    writeUInt(glBaseInternalFormat, file);
+    writeUInt(level.width, file);
+    writeUInt(level.height, file);
+    writeUInt(0, file);
+    writeUInt(0, file);
+    writeUInt(1, file);
+    writeUInt(levelCount, file);
+    writeUInt(0, file);
+
+    size_t size = 0;
+    std::vector<unsigned char> data;
+    TextureLevel next;
+    for (unsigned int i = 0; i < levelCount; ++i)
+    {
+        encodeLevel(level, job.format, alpha, &data);
+        writeUInt((unsigned int)data.size(), file);
+        fwrite(&data[0], 1, data.size(), file);
+        size += data.size();
+
+        // Each level is padded to four bytes.
+        static const unsigned char padding[3] = { 0, 0, 0 };
+        fwrite(padding, 1, (4 - data.size() % 4) % 4, file);
+
+        if (i + 1 < levelCount)
+        {
+            downsample(level, &next);
+            std::swap(level, next);
+        }
+    }
+    fclose(file);
+
+    LOG(2, "  %s (%u levels, %lu bytes)\n", job.output.c_str(), levelCount, (unsigned long)size);
+    return true;
+}
+
+}
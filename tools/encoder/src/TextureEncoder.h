@@ -0,0 +1,112 @@
+#ifndef TEXTUREENCODER_H_
+#define TEXTUREENCODER_H_
+
+namespace gameplay
+{
+
+/**
+ * Writes PNG images into KTX textures with their full mipmap chain, which Texture::create
+ * uploads level by level without decoding the image or generating mipmaps at load time.
+ *
+ * The input is either a PNG file or a directory, in which case every PNG file in it and in its
+ * subdirectories is written into the same relative path of the output directory. The files of
+ * a directory are encoded in parallel.
+ */
+class TextureEncoder
+{
+public:
+
+    /**
+     * Defines the formats that textures can be written in.
+     */
+    enum Format
+    {
+        /** Uncompressed RGB or RGBA bytes, depending on whether the image has alpha. */
+        UNCOMPRESSED,
+        /** ETC1 (RGB, 4 bits per pixel), which all OpenGL ES 2 devices support. */
+        ETC1,
+        /** BC1, also known as DXT1 (RGB, 4 bits per pixel). */
+        BC1,
+        /** BC3, also known as DXT5 (RGBA, 8 bits per pixel). */
+        BC3
+    };
+
+    /**
+     * Constructor.
+     */
+    TextureEncoder();
+
+    /**
+     * Destructor.
+     */
+    ~TextureEncoder();
+
+    /**
+     * Writes the texture, or the textures of a directory.
+     *
+     * @param input The PNG file, or the directory of PNG files, to encode.
+     * @param output The KTX file to write, or the directory to write the textures into.
+     * @param format The format to write the textures in.
+     * @param premultiplyAlpha true to multiply the color of each pixel by its alpha before the
+     *        mipmaps are generated, for textures drawn with premultiplied alpha blending.
+     *
+     * @return True if every texture was written; false otherwise.
+     */
+    bool write(const std::string& input, const std::string& output, Format format, bool premultiplyAlpha);
+
+private:
+
+    /**
+     * A texture to encode, which is the work done by one of the threads.
+     */
+    struct Job
+    {
+        std::string input;
+        std::string output;
+        Format format;
+        bool premultiplyAlpha;
+        bool result;
+    };
+
+    /**
+     * The jobs of a thread.
+     */
+    struct ThreadData
+    {
+        std::vector<Job>* jobs;
+        unsigned int index;
+        unsigned int count;
+    };
+
+    // Hidden copy/assignment
+    TextureEncoder(const TextureEncoder&);
+    TextureEncoder& operator=(const TextureEncoder&);
+
+    /**
+     * Adds a job for each PNG file in the given directory and its subdirectories.
+     *
+     * @param directory The path of the input directory.
+     * @param output The path of the output directory.
+     */
+    void addFiles(const std::string& directory, const std::string& output);
+
+    /**
+     * Encodes every job of a thread, whose index is the index of the job modulo the thread count.
+     *
+     * @param data The ThreadData of the thread.
+     */
+    static int encodeJobs(void* data);
+
+    /**
+     * Encodes a single texture.
+     *
+     * @return True if the texture was written; false otherwise.
+     */
+    static bool encode(const Job& job);
+
+    std::vector<Job> _jobs;
+};
+
+}
+
+#endif
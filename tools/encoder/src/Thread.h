@@ -1,6 +1,10 @@
 #ifndef THREAD_H_
 #define THREAD_H_
 
+#ifndef WIN32
+#include <unistd.h>
+#endif
+
 namespace gameplay
 {
 
@@ -16,7 +20,7 @@ namespace gameplay
         void* arg;
     };
 
-    DWORD WINAPI WindowsThreadProc(LPVOID lpParam)
+    static DWORD WINAPI WindowsThreadProc(LPVOID lpParam)
     {
         WindowsThreadData* data = (WindowsThreadData*)lpParam;
         int(*threadFunction)(void*) = data->threadFunction;
@@ -45,6 +49,35 @@ namespace gameplay
         CloseHandle(thread);
     }
 
+    typedef CRITICAL_SECTION MUTEX_HANDLE;
+
+    static void createMutex(MUTEX_HANDLE* mutex)
+    {
+        InitializeCriticalSection(mutex);
+    }
+
+    static void lockMutex(MUTEX_HANDLE* mutex)
+    {
+        EnterCriticalSection(mutex);
+    }
+
+    static void unlockMutex(MUTEX_HANDLE* mutex)
+    {
+        LeaveCriticalSection(mutex);
+    }
+
+    static void destroyMutex(MUTEX_HANDLE* mutex)
+    {
+        DeleteCriticalSection(mutex);
+    }
+
+    static unsigned int getProcessorCount()
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        return info.dwNumberOfProcessors > 0 ? (unsigned int)info.dwNumberOfProcessors : 1;
+    }
+
 #else
 
     #include <pthread.h>
@@ -57,7 +90,7 @@ namespace gameplay
         void* arg;
     };
 
-    void* PThreadProc(void* threadData)
+    static void* PThreadProc(void* threadData)
     {
         PThreadData* data = (PThreadData*)threadData;
         int(*threadFunction)(void*) = data->threadFunction;
@@ -92,6 +125,34 @@ namespace gameplay
         // nothing to do... waitForThreads (which calls join) cleans up
     }
 
+    typedef pthread_mutex_t MUTEX_HANDLE;
+
+    static void createMutex(MUTEX_HANDLE* mutex)
+    {
+        pthread_mutex_init(mutex, NULL);
+    }
+
+    static void lockMutex(MUTEX_HANDLE* mutex)
+    {
+        pthread_mutex_lock(mutex);
+    }
+
+    static void unlockMutex(MUTEX_HANDLE* mutex)
+    {
+        pthread_mutex_unlock(mutex);
+    }
+
+    static void destroyMutex(MUTEX_HANDLE* mutex)
+    {
+        pthread_mutex_destroy(mutex);
+    }
+
+    static unsigned int getProcessorCount()
+    {
+        long count = sysconf(_SC_NPROCESSORS_ONLN);
+        return count > 0 ? (unsigned int)count : 1;
+    }
+
 #endif
 
 }
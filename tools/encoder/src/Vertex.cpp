@@ -110,6 +110,42 @@ void Vertex::writeText(FILE* file) const
     }
 }
 
+void Vertex::getValues(unsigned int usage, float* values) const
+{
+    values[0] = values[1] = values[2] = values[3] = 0.0f;
+    switch (usage)
+    {
+        case POSITION:
+            values[0] = position.x; values[1] = position.y; values[2] = position.z; values[3] = 1.0f;
+            break;
+        case NORMAL:
+            values[0] = normal.x; values[1] = normal.y; values[2] = normal.z;
+            break;
+        case TANGENT:
+            values[0] = tangent.x; values[1] = tangent.y; values[2] = tangent.z;
+            break;
+        case BINORMAL:
+            values[0] = binormal.x; values[1] = binormal.y; values[2] = binormal.z;
+            break;
+        case COLOR:
+            values[0] = diffuse.x; values[1] = diffuse.y; values[2] = diffuse.z; values[3] = diffuse.w;
+            break;
+        case BLENDWEIGHTS:
+            values[0] = blendWeights.x; values[1] = blendWeights.y; values[2] = blendWeights.z; values[3] = blendWeights.w;
+            break;
+        case BLENDINDICES:
+            values[0] = blendIndices.x; values[1] = blendIndices.y; values[2] = blendIndices.z; values[3] = blendIndices.w;
+            break;
+        default:
+            if (usage >= TEXCOORD0 && usage <= TEXCOORD7)
+            {
+                values[0] = texCoord[usage - TEXCOORD0].x;
+                values[1] = texCoord[usage - TEXCOORD0].y;
+            }
+            break;
+    }
+}
+
 void Vertex::normalizeBlendWeight()
 {
     float total = blendWeights.x + blendWeights.y + blendWeights.z + blendWeights.w;
@@ -122,4 +158,52 @@ void Vertex::normalizeBlendWeight()
     }   
 }
 
+/**
+ * Mixes the bits of a float into the hash. Adding zero turns -0.0 into 0.0, since the two compare equal.
+ */
+static inline void hashFloat(size_t& h, float value)
+{
+    value += 0.0f;
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    h ^= bits + 0x9e3779b9 + (h << 6) + (h >> 2);
+}
+
+size_t VertexHash::operator()(const Vertex& vertex) const
+{
+    // Vertices are welded after all of their attributes are loaded, so every attribute
+    // takes part even though most meshes differ in position alone.
+    size_t h = 0;
+    hashFloat(h, vertex.position.x);
+    hashFloat(h, vertex.position.y);
+    hashFloat(h, vertex.position.z);
+    hashFloat(h, vertex.normal.x);
+    hashFloat(h, vertex.normal.y);
+    hashFloat(h, vertex.normal.z);
+    hashFloat(h, vertex.tangent.x);
+    hashFloat(h, vertex.tangent.y);
+    hashFloat(h, vertex.tangent.z);
+    hashFloat(h, vertex.binormal.x);
+    hashFloat(h, vertex.binormal.y);
+    hashFloat(h, vertex.binormal.z);
+    for (unsigned int i = 0; i < MAX_UV_SETS; ++i)
+    {
+        hashFloat(h, vertex.texCoord[i].x);
+        hashFloat(h, vertex.texCoord[i].y);
+    }
+    hashFloat(h, vertex.diffuse.x);
+    hashFloat(h, vertex.diffuse.y);
+    hashFloat(h, vertex.diffuse.z);
+    hashFloat(h, vertex.diffuse.w);
+    hashFloat(h, vertex.blendWeights.x);
+    hashFloat(h, vertex.blendWeights.y);
+    hashFloat(h, vertex.blendWeights.z);
+    hashFloat(h, vertex.blendWeights.w);
+    hashFloat(h, vertex.blendIndices.x);
+    hashFloat(h, vertex.blendIndices.y);
+    hashFloat(h, vertex.blendIndices.z);
+    hashFloat(h, vertex.blendIndices.w);
+    return h;
+}
+
 }
@@ -111,11 +111,30 @@ public:
      */
     void writeText(FILE* file) const;
 
+    /**
+     * Copies the values of the attribute with the given usage into values, padded
+     * to four components. Vectors are padded with w = 1 for positions and w = 0 otherwise.
+     *
+     * @param usage The vertex usage, such as POSITION or TEXCOORD0.
+     * @param values Receives four values.
+     */
+    void getValues(unsigned int usage, float* values) const;
+
     /**
      * Normalizes the blend weights of this vertex so that they add up to 1.0.
      */
     void normalizeBlendWeight();
 };
+
+/**
+ * Hashes a Vertex for the tables that weld equal vertices together. Vertices that
+ * compare equal with operator== have the same hash.
+ */
+struct VertexHash
+{
+    size_t operator()(const Vertex& vertex) const;
+};
+
 }
 
 #endif
@@ -4,9 +4,54 @@
 namespace gameplay
 {
 
-VertexElement::VertexElement(unsigned int t, unsigned int c) :
+/**
+ * Converts a float to a half float, rounding to nearest.
+ */
+static unsigned short floatToHalf(float value)
+{
+    unsigned int f;
+    memcpy(&f, &value, sizeof(float));
+    unsigned int sign = (f >> 16) & 0x8000;
+    int exponent = (int)((f >> 23) & 0xff) - 127 + 15;
+    unsigned int mantissa = f & 0x7fffff;
+
+    if (((f >> 23) & 0xff) == 0xff)
+        return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31)
+        return (unsigned short)(sign | 0x7c00);
+    if (exponent <= 0)
+    {
+        if (exponent < -10)
+            return (unsigned short)sign;
+        mantissa |= 0x800000;
+        unsigned int shift = (unsigned int)(14 - exponent);
+        unsigned int half = mantissa >> shift;
+        if ((mantissa >> (shift - 1)) & 1)
+            half++;
+        return (unsigned short)(sign | half);
+    }
+
+    unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+    if (mantissa & 0x1000)
+        half++;
+    return (unsigned short)half;
+}
+
+/**
+ * Scales, rounds and clamps a float to an integer range.
+ */
+static int floatToInteger(float value, float scale, int min, int max)
+{
+    float v = value * scale;
+    int i = (int)(v < 0.0f ? v - 0.5f : v + 0.5f);
+    return i < min ? min : (i > max ? max : i);
+}
+
+VertexElement::VertexElement(unsigned int t, unsigned int c, Type type, bool normalized) :
     usage(t),
-    size(c)
+    size(c),
+    type(type),
+    normalized(normalized)
 {
 }
 
@@ -23,15 +68,91 @@ void VertexElement::writeBinary(FILE* file)
     Object::writeBinary(file);
     write(usage, file);
     write(size, file);
+    write((unsigned int)type, file);
+    write((unsigned int)(normalized ? 1 : 0), file);
 }
 void VertexElement::writeText(FILE* file)
 {
     fprintElementStart(file);
     fprintfElement(file, "usage", usageStr(usage));
     fprintfElement(file, "size", size);
+    fprintfElement(file, "type", typeStr(type));
+    fprintfElement(file, "normalized", normalized ? "true" : "false");
     fprintElementEnd(file);
 }
 
+unsigned int VertexElement::byteSize() const
+{
+    switch (type)
+    {
+        case HALF_FLOAT:
+        case SHORT:
+        case UNSIGNED_SHORT:
+            return size * 2;
+        case BYTE:
+        case UNSIGNED_BYTE:
+            return size;
+        case INT_2_10_10_10_REV:
+            return 4;
+        default:
+            return size * sizeof(float);
+    }
+}
+
+void VertexElement::writeValues(const float* values, FILE* file) const
+{
+    unsigned char data[16];
+    switch (type)
+    {
+        case HALF_FLOAT:
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                unsigned short h = floatToHalf(values[i]);
+                memcpy(data + i * 2, &h, 2);
+            }
+            break;
+        case BYTE:
+            for (unsigned int i = 0; i < size; ++i)
+                data[i] = (unsigned char)(signed char)floatToInteger(values[i], normalized ? 127.0f : 1.0f, -128, 127);
+            break;
+        case UNSIGNED_BYTE:
+            for (unsigned int i = 0; i < size; ++i)
+                data[i] = (unsigned char)floatToInteger(values[i], normalized ? 255.0f : 1.0f, 0, 255);
+            break;
+        case SHORT:
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                short v = (short)floatToInteger(values[i], normalized ? 32767.0f : 1.0f, -32768, 32767);
+                memcpy(data + i * 2, &v, 2);
+            }
+            break;
+        case UNSIGNED_SHORT:
+            for (unsigned int i = 0; i < size; ++i)
+            {
+                unsigned short v = (unsigned short)floatToInteger(values[i], normalized ? 65535.0f : 1.0f, 0, 65535);
+                memcpy(data + i * 2, &v, 2);
+            }
+            break;
+        case INT_2_10_10_10_REV:
+            {
+                unsigned int packed = 0;
+                for (unsigned int i = 0; i < 4; ++i)
+                {
+                    unsigned int bits = i < 3 ? 10 : 2;
+                    int max = (1 << (bits - 1)) - 1;
+                    int v = floatToInteger(values[i], normalized ? (float)max : 1.0f, -max - 1, max);
+                    packed |= ((unsigned int)v & ((1u << bits) - 1)) << (i * 10);
+                }
+                memcpy(data, &packed, 4);
+            }
+            break;
+        default:
+            memcpy(data, values, size * sizeof(float));
+            break;
+    }
+    fwrite(data, 1, byteSize(), file);
+}
+
 const char* VertexElement::usageStr(unsigned int usage)
 {
     switch (usage)
@@ -73,4 +194,27 @@ const char* VertexElement::usageStr(unsigned int usage)
     }
 }
 
+const char* VertexElement::typeStr(Type type)
+{
+    switch (type)
+    {
+        case FLOAT:
+            return "FLOAT";
+        case HALF_FLOAT:
+            return "HALF_FLOAT";
+        case BYTE:
+            return "BYTE";
+        case UNSIGNED_BYTE:
+            return "UNSIGNED_BYTE";
+        case SHORT:
+            return "SHORT";
+        case UNSIGNED_SHORT:
+            return "UNSIGNED_SHORT";
+        case INT_2_10_10_10_REV:
+            return "INT_2_10_10_10_REV";
+        default:
+            return "";
+    }
+}
+
 }
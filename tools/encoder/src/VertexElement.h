@@ -10,10 +10,24 @@ class VertexElement : public Object
 {
 public:
 
+    /**
+     * Component types of a vertex element. These match VertexFormat::Type in the runtime.
+     */
+    enum Type
+    {
+        FLOAT = 0,
+        HALF_FLOAT = 1,
+        BYTE = 2,
+        UNSIGNED_BYTE = 3,
+        SHORT = 4,
+        UNSIGNED_SHORT = 5,
+        INT_2_10_10_10_REV = 6
+    };
+
     /**
      * Constructor.
      */
-    VertexElement(unsigned int t, unsigned int c);
+    VertexElement(unsigned int t, unsigned int c, Type type = FLOAT, bool normalized = false);
 
     /**
      * Destructor.
@@ -24,10 +38,26 @@ public:
     virtual void writeBinary(FILE* file);
     virtual void writeText(FILE* file);
 
+    /**
+     * Returns the number of bytes this element takes up in a vertex.
+     */
+    unsigned int byteSize() const;
+
+    /**
+     * Converts the given float values to this element's type and writes them to the file.
+     *
+     * @param values The values to write, at least size of them.
+     * @param file The file to write to.
+     */
+    void writeValues(const float* values, FILE* file) const;
+
     static const char* usageStr(unsigned int usage);
+    static const char* typeStr(Type type);
 
     unsigned int usage;
     unsigned int size;
+    Type type;
+    bool normalized;
 };
 
 }
@@ -5,6 +5,11 @@
 #include "GPBDecoder.h"
 #include "EncoderArguments.h"
 #include "NormalMapGenerator.h"
+#include "PackEncoder.h"
+#include "TextureEncoder.h"
+#include "ScriptEncoder.h"
+#include "BatchEncoder.h"
+#include "BuildCache.h"
 #include "Font.h"
 
 using namespace gameplay;
@@ -67,37 +72,12 @@ static std::vector<unsigned int> promptUserFontSize()
 
 
 /**
- * Main application entry point.
- *
- * @param argc The number of command line arguments
- * @param argv The array of command line arguments.
- *
- * usage:   gameplay-encoder[options] <file_list>
- * example: gameplay-encoder C:/assets/duck.fbx
- * example: gameplay-encoder -i boy duck.fbx
+ * Encodes the input file with the given arguments.
  *
- * @stod: Improve argument parsing.
+ * @return Zero if the output was written; -1 otherwise.
  */
-int main(int argc, const char** argv)
+static int encode(const EncoderArguments& arguments, const char* executable)
 {
-    EncoderArguments arguments(argc, argv);
-
-    if (arguments.parseErrorOccured())
-    {
-        arguments.printUsage();
-        return 0;
-    }
-
-    // Check if the file exists.
-    if (!arguments.fileExists())
-    {
-        LOG(1, "Error: File not found: %s\n", arguments.getFilePathPointer());
-        return -1;
-    }
-
-    // File exists
-    LOG(1, "Encoding file: %s\n", arguments.getFilePathPointer());
-
     switch (arguments.getFileFormat())
     {
     case EncoderArguments::FILEFORMAT_FBX:
@@ -133,6 +113,11 @@ int main(int argc, const char** argv)
                 {
                     fontSizes.push_back(FONT_SIZE_DISTANCEFIELD);
                 }
+                else if (arguments.singleDistanceFieldEnabled())
+                {
+                    unsigned int largest = *std::max_element(fontSizes.begin(), fontSizes.end());
+                    fontSizes.assign(1, largest);
+                }
             }
             std::string id = getBaseName(arguments.getFilePath());
             writeFont(arguments.getFilePath().c_str(), arguments.getOutputFilePath().c_str(), fontSizes, id.c_str(), arguments.fontPreviewEnabled(), fontFormat);
@@ -142,7 +127,10 @@ int main(int argc, const char** argv)
         {
             std::string realpath(arguments.getFilePath());
             GPBDecoder decoder;
-            decoder.readBinary(realpath);
+            if (!decoder.readBinary(realpath, arguments.jsonOutputEnabled()))
+            {
+                return -1;
+            }
             break;
         }
     case EncoderArguments::FILEFORMAT_PNG:
@@ -162,6 +150,42 @@ int main(int argc, const char** argv)
             }
             break;
         }
+    case EncoderArguments::FILEFORMAT_PACK:
+        {
+            PackEncoder packEncoder;
+            if (!packEncoder.write(arguments.getFilePath(), arguments.getOutputFilePath(), arguments.packCompressionEnabled()))
+            {
+                return -1;
+            }
+            break;
+        }
+    case EncoderArguments::FILEFORMAT_TEXTURE:
+        {
+            TextureEncoder textureEncoder;
+            if (!textureEncoder.write(arguments.getFilePath(), arguments.getOutputFilePath(), arguments.getTextureFormat(), arguments.premultipliedAlphaEnabled()))
+            {
+                return -1;
+            }
+            break;
+        }
+    case EncoderArguments::FILEFORMAT_LUA:
+        {
+            ScriptEncoder scriptEncoder;
+            if (!scriptEncoder.write(arguments.getFilePath(), arguments.getOutputFilePath(), arguments.stripDebugEnabled()))
+            {
+                return -1;
+            }
+            break;
+        }
+    case EncoderArguments::FILEFORMAT_BATCH:
+        {
+            BatchEncoder batchEncoder;
+            if (!batchEncoder.write(executable, arguments.getFilePath(), arguments.getOutputFilePath(), arguments.getOptions(), arguments.getBatchThreadCount()))
+            {
+                return -1;
+            }
+            break;
+        }
    default:
         {
             LOG(1, "Error: Unsupported file format: %s\n", arguments.getFilePathPointer());
@@ -171,3 +195,57 @@ int main(int argc, const char** argv)
 
     return 0;
 }
+
+/**
+ * Main application entry point.
+ *
+ * @param argc The number of command line arguments
+ * @param argv The array of command line arguments.
+ *
+ * usage:   gameplay-encoder[options] <file_list>
+ * example: gameplay-encoder C:/assets/duck.fbx
+ * example: gameplay-encoder -i boy duck.fbx
+ * example: gameplay-encoder -batch:8 -oa C:/assets C:/build/res
+ *
+ * @stod: Improve argument parsing.
+ */
+int main(int argc, const char** argv)
+{
+    EncoderArguments arguments(argc, argv);
+
+    if (arguments.parseErrorOccured())
+    {
+        arguments.printUsage();
+        return 0;
+    }
+
+    // Check if the file exists.
+    if (!arguments.fileExists())
+    {
+        LOG(1, "Error: File not found: %s\n", arguments.getFilePathPointer());
+        return -1;
+    }
+
+    // Inputs that are directories are not cached, since every file in them would have to be hashed.
+    struct stat buf;
+    bool directory = stat(arguments.getFilePath().c_str(), &buf) == 0 && (buf.st_mode & S_IFDIR) != 0;
+    if (arguments.incrementalEnabled() && !directory && arguments.getFileFormat() != EncoderArguments::FILEFORMAT_BATCH &&
+        arguments.getFileFormat() != EncoderArguments::FILEFORMAT_GPB)
+    {
+        BuildCache cache(arguments);
+        if (cache.isUpToDate())
+        {
+            LOG(1, "Up to date: %s\n", arguments.getOutputFilePath().c_str());
+            return 0;
+        }
+        LOG(1, "Encoding file: %s\n", arguments.getFilePathPointer());
+        int result = encode(arguments, argv[0]);
+        if (result == 0)
+            cache.write();
+        return result;
+    }
+
+    // File exists
+    LOG(1, "Encoding file: %s\n", arguments.getFilePathPointer());
+    return encode(arguments, argv[0]);
+}
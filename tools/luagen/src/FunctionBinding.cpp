@@ -7,11 +7,13 @@ static inline void outputLuaTypeCheckInstance(ostream& o);
 static inline void outputLuaTypeCheck(ostream& o, int index, const FunctionBinding::Param& p = 
     FunctionBinding::Param(FunctionBinding::Param::TYPE_OBJECT, FunctionBinding::Param::KIND_POINTER));
 static inline void indent(ostream& o, int indentLevel);
-static inline void outputBindingInvocation(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings);
+static inline void outputBindingInvocation(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings, bool outParam = false);
 static inline void outputGetParam(ostream& o, const FunctionBinding::Param& p, int i, int indentLevel, bool offsetIndex, int numBindings);
-static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings);
+static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings, bool outParam = false);
 static inline void outputReturnValue(ostream& o, const FunctionBinding& b, int indentLevel);
 static inline std::string getTypeName(const FunctionBinding::Param& param);
+static inline bool isValueReturn(const FunctionBinding::Param& param);
+static inline void outputPushValue(ostream& o, const FunctionBinding::Param& param);
 
 FunctionBinding::Param::Param(FunctionBinding::Param::Type type, Kind kind, const string& info) : 
     type(type), kind(kind), info(info), hasDefaultValue(false), levelsOfIndirection(0)
@@ -128,6 +130,13 @@ void FunctionBinding::write(ostream& o, const vector<FunctionBinding>& bindings)
                 o << "        void* returnPtr = (void*)instance->" << bindings[0].name << ";\n";
                 break;
             case FunctionBinding::Param::KIND_VALUE:
+                if (isValueReturn(bindings[0].returnParam))
+                {
+                    o << "        ";
+                    outputPushValue(o, bindings[0].returnParam);
+                    o << "instance->" << bindings[0].name << ", \"" << Generator::getInstance()->getUniqueNameFromRef(bindings[0].returnParam.info) << "\");\n";
+                    break;
+                }
                 o << "        void* returnPtr = (void*)new " << bindings[0].returnParam << "(instance->" << bindings[0].name << ");\n";
                 break;
             case FunctionBinding::Param::KIND_REFERENCE:
@@ -202,6 +211,15 @@ void FunctionBinding::write(ostream& o, const vector<FunctionBinding>& bindings)
                 o << bindings[0].name << ");\n";
                 break;
             case FunctionBinding::Param::KIND_VALUE:
+                if (isValueReturn(bindings[0].returnParam))
+                {
+                    o << "        ";
+                    outputPushValue(o, bindings[0].returnParam);
+                    if (bindings[0].classname.size() > 0)
+                        o << bindings[0].classname << "::";
+                    o << bindings[0].name << ", \"" << Generator::getInstance()->getUniqueNameFromRef(bindings[0].returnParam.info) << "\");\n";
+                    break;
+                }
                 o << "        void* returnPtr = (void*)new " << bindings[0].returnParam << "(";
                 if (bindings[0].classname.size() > 0)
                     o << bindings[0].classname << "::";
@@ -248,6 +266,13 @@ void FunctionBinding::write(ostream& o, const vector<FunctionBinding>& bindings)
                 o << "    void* returnPtr = (void*)instance->" << bindings[0].name << ";\n";
                 break;
             case FunctionBinding::Param::KIND_VALUE:
+                if (isValueReturn(bindings[0].returnParam))
+                {
+                    o << "    ";
+                    outputPushValue(o, bindings[0].returnParam);
+                    o << "instance->" << bindings[0].name << ", \"" << Generator::getInstance()->getUniqueNameFromRef(bindings[0].returnParam.info) << "\");\n";
+                    break;
+                }
                 o << "    void* returnPtr = (void*)new " << bindings[0].returnParam << "(instance->" << bindings[0].name << ");\n";
                 break;
             case FunctionBinding::Param::KIND_REFERENCE:
@@ -288,6 +313,15 @@ void FunctionBinding::write(ostream& o, const vector<FunctionBinding>& bindings)
                 o << bindings[0].name << ");\n";
                 break;
             case FunctionBinding::Param::KIND_VALUE:
+                if (isValueReturn(bindings[0].returnParam))
+                {
+                    o << "    ";
+                    outputPushValue(o, bindings[0].returnParam);
+                    if (bindings[0].classname.size() > 0)
+                        o << bindings[0].classname << "::";
+                    o << bindings[0].name << ", \"" << Generator::getInstance()->getUniqueNameFromRef(bindings[0].returnParam.info) << "\");\n";
+                    break;
+                }
                 o << "    void* returnPtr = (void*)new " << bindings[0].returnParam << "(";
                 if (bindings[0].classname.size() > 0)
                     o << bindings[0].classname << "::";
@@ -333,6 +367,28 @@ void FunctionBinding::write(ostream& o, const vector<FunctionBinding>& bindings)
             }
         }
 
+        // Functions that return value types can also be passed an existing object to
+        // copy their result into, as an extra parameter, unless an overload already
+        // takes that many parameters.
+        set<unsigned int> outParamCounts;
+        for (unsigned int i = 0, count = bindings.size(); i < count; i++)
+        {
+            if (bindings[i].type != FunctionBinding::MEMBER_FUNCTION &&
+                bindings[i].type != FunctionBinding::STATIC_FUNCTION &&
+                bindings[i].type != FunctionBinding::GLOBAL_FUNCTION)
+                continue;
+            if (!isValueReturn(bindings[i].returnParam))
+                continue;
+
+            paramCountOffset = (bindings[i].type == FunctionBinding::MEMBER_FUNCTION) ? 1 : 0;
+            unsigned int outParamCount = bindings[i].paramTypes.size() + paramCountOffset + 1;
+            if (paramCounts.find(outParamCount) != paramCounts.end() && outParamCounts.find(outParamCount) == outParamCounts.end())
+                continue;
+
+            outParamCounts.insert(outParamCount);
+            paramCounts[outParamCount].push_back(&bindings[i]);
+        }
+
         // Get the parameter count.
         o << "    // Get the number of parameters.\n";
         o << "    int paramCount = lua_gettop(state);\n\n";
@@ -355,7 +411,7 @@ void FunctionBinding::write(ostream& o, const vector<FunctionBinding>& bindings)
                 if (iter->first > 0)
                     indent(o, 3);
 
-                outputMatchedBinding(o, *(iter->second[i]), iter->first, 3, bindings.size());
+                outputMatchedBinding(o, *(iter->second[i]), iter->first, 3, bindings.size(), outParamCounts.find(iter->first) != outParamCounts.end());
             }
 
             // Only print an else clause with error report if there are parameters.
@@ -483,6 +539,18 @@ static inline std::string getTypeName(const FunctionBinding::Param& param)
     }
 }
 
+static inline bool isValueReturn(const FunctionBinding::Param& param)
+{
+    return param.type == FunctionBinding::Param::TYPE_OBJECT &&
+        param.kind == FunctionBinding::Param::KIND_VALUE &&
+        Generator::getInstance()->isValueType(Generator::getInstance()->getUniqueNameFromRef(param.info));
+}
+
+static inline void outputPushValue(ostream& o, const FunctionBinding::Param& param)
+{
+    o << SCRIPT_UTIL << "::pushValueObject<" << param << ">(";
+}
+
 ostream& operator<<(ostream& o, const FunctionBinding::Param& param)
 {
     o << getTypeName(param);
@@ -567,10 +635,15 @@ static inline void indent(ostream& o, int indentLevel)
         o << "    ";
 }
 
-static inline void outputBindingInvocation(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings)
+static inline void outputBindingInvocation(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings, bool outParam)
 {
     bool isNonStatic = (b.type == FunctionBinding::MEMBER_FUNCTION && b.returnParam.type != FunctionBinding::Param::TYPE_CONSTRUCTOR);
 
+    // The object to copy the return value into is not passed to the function.
+    unsigned int outParamIndex = paramCount;
+    if (outParam)
+        paramCount--;
+
     // Get the passed in parameters.
     for (unsigned int i = 0, count = paramCount - (isNonStatic ? 1 : 0); i < count; i++)
     {
@@ -626,7 +699,16 @@ static inline void outputBindingInvocation(ostream& o, const FunctionBinding& b,
 
         // For functions that return objects, create the appropriate user data in Lua.
         bool needsExtraClosingBrace = false;
-        if (b.returnParam.type == FunctionBinding::Param::TYPE_CONSTRUCTOR || b.returnParam.type == FunctionBinding::Param::TYPE_OBJECT)
+        if (isValueReturn(b.returnParam))
+        {
+            // Value types are copied into the given object, or into a new userdata.
+            indent(o, indentLevel);
+            if (outParam)
+                o << "if (" << SCRIPT_UTIL << "::setValueObject<" << b.returnParam << ">(" << outParamIndex << ", ";
+            else
+                outputPushValue(o, b.returnParam);
+        }
+        else if (b.returnParam.type == FunctionBinding::Param::TYPE_CONSTRUCTOR || b.returnParam.type == FunctionBinding::Param::TYPE_OBJECT)
         {
             needsExtraClosingBrace = true;
             indent(o, indentLevel);
@@ -688,7 +770,23 @@ static inline void outputBindingInvocation(ostream& o, const FunctionBinding& b,
         if (needsExtraClosingBrace)
             o << ")";
 
-        o << ");\n";
+        if (isValueReturn(b.returnParam))
+        {
+            o << "), \"" << Generator::getInstance()->getUniqueNameFromRef(b.returnParam.info) << "\")";
+            if (outParam)
+            {
+                // Fall through to the next binding if the object is of another type.
+                o << ")\n";
+                indent(o, indentLevel + 1);
+                o << "return 1;\n";
+                return;
+            }
+            o << ";\n";
+        }
+        else
+        {
+            o << ");\n";
+        }
     }
 
     outputReturnValue(o, b, indentLevel);
@@ -858,7 +956,7 @@ static inline void outputGetParam(ostream& o, const FunctionBinding::Param& p, i
     o << "\n";
 }
 
-static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings)
+static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, unsigned int paramCount, unsigned int indentLevel, int numBindings, bool outParam)
 {
     bool isNonStatic = (b.type == FunctionBinding::MEMBER_FUNCTION && b.returnParam.type != FunctionBinding::Param::TYPE_CONSTRUCTOR);
 
@@ -891,6 +989,11 @@ static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, un
                 // This is always the "this / self" pointer for a member function
                 outputLuaTypeCheckInstance(o);
             }
+            else if (outParam && i == count - 1)
+            {
+                // The object to copy the return value into
+                o << "lua_type(state, " << i + 1 << ") == LUA_TUSERDATA";
+            }
             else
             {
                 // Function parameter
@@ -908,7 +1011,7 @@ static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, un
         indent(o, indentLevel);
         o << "{\n";
             
-        outputBindingInvocation(o, b, paramCount, indentLevel + 1, numBindings);
+        outputBindingInvocation(o, b, paramCount, indentLevel + 1, numBindings, outParam);
 
         indent(o, indentLevel);
         o << "}\n";
@@ -925,6 +1028,15 @@ static inline void outputMatchedBinding(ostream& o, const FunctionBinding& b, un
 
 static inline void outputReturnValue(ostream& o, const FunctionBinding& b, int indentLevel)
 {
+    // Value types have already been pushed onto the stack.
+    if (isValueReturn(b.returnParam))
+    {
+        o << "\n";
+        indent(o, indentLevel);
+        o << "return 1;\n";
+        return;
+    }
+
     // Pass the return value back to Lua.
     if (!(b.returnParam.type == FunctionBinding::Param::TYPE_CONSTRUCTOR || 
         b.returnParam.type == FunctionBinding::Param::TYPE_DESTRUCTOR ||
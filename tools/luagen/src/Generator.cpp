@@ -150,6 +150,17 @@ bool Generator::isRef(string classname)
     return classname == REF_CLASS_NAME;
 }
 
+bool Generator::isValueType(string classname)
+{
+    static const char* valueTypes[] = { "Matrix", "Quaternion", "Vector2", "Vector3", "Vector4", NULL };
+    for (unsigned int i = 0; valueTypes[i]; i++)
+    {
+        if (classname == valueTypes[i])
+            return true;
+    }
+    return false;
+}
+
 string Generator::getCompoundName(XMLElement* node)
 {
     // Get the name of the namespace, class, struct, or file that we are processing.
@@ -108,6 +108,17 @@ public:
      */
     bool isRef(string classname);
 
+    /**
+     * Retrieves whether the given class is a small value type, whose objects are returned
+     * to Lua stored inline in their userdata instead of being allocated on the heap.
+     *
+     * Value types must be copyable with memcpy and must not need to be destroyed.
+     *
+     * @param classname The unique name of the class.
+     * @return True if the class is a value type; false otherwise.
+     */
+    bool isValueType(string classname);
+
     /**
      * Checks whether the given class ref ID has any public derived classes.
      *